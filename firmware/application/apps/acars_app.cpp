@@ -31,36 +31,41 @@ using namespace acars;
 #include "string_format.hpp"
 #include "utility.hpp"
 
-void ACARSLogger::log_raw_data(const acars::Packet& packet, const uint32_t frequency) {
-	(void)frequency;
-	std::string entry { };	//= "Raw: F:" + to_string_dec_uint(frequency) + "Hz ";
-	entry.reserve(256);
-	
-	// Raw hex dump of all the bytes
-	//for (size_t c = 0; c < packet.length(); c += 32)
-	//	entry += to_string_hex(packet.read(c, 32), 8) + " ";
-	
-	for (size_t c = 0; c < 256; c += 32)
-		entry += to_string_bin(packet.read(c, 32), 32);
-	
-	log_file.write_entry(packet.received_at(), entry);
-}
+namespace {
 
-/*void ACARSLogger::log_decoded(
-	const acars::Packet& packet,
-	const std::string text) {
-	
-	log_file.write_entry(packet.timestamp(), text);
-}*/
+/* The capture spans 4.9152MHz, but only the channelizer's first stage
+ * passband (+/-150kHz around center) is usable, so a plan's channels must
+ * sit within 300kHz of each other.
+ */
+struct ChannelPlan {
+	rf::Frequency center;
+	std::array<int32_t, ACARSConfigureMessage::channels_max> offsets_hz;
+	size_t channel_count;
+};
 
-namespace ui {
+constexpr std::array<ChannelPlan, 3> channel_plans { {
+	{ 131675000, { { -150000, 50000, 150000 } }, 3 },	// 131.525, 131.725, 131.825
+	{ 130437500, { { -12500, 12500, 0 } }, 2 },			// 130.425, 130.450
+	{ 131550000, { { 0, 0, 0 } }, 1 },
+} };
+
+constexpr uint32_t sampling_rate = 4915200;
+
+} /* namespace */
+
+void ACARSLogger::log_decoded(const acars::Packet& packet, const uint32_t frequency) {
+	std::string entry = "F:" + to_string_dec_uint(frequency) + "Hz ";
+	entry += packet.mode();
+	entry += " " + packet.registration_number() + " " + packet.label() + " ";
+	entry += packet.block_id();
+	entry += " " + packet.text();
 
-void ACARSAppView::update_freq(rf::Frequency f) {
-	set_target_frequency(f);
-	portapack::persistent_memory::set_tuned_frequency(f);	// Maybe not ?
+	log_file.write_entry(packet.received_at(), entry);
 }
 
-ACARSAppView::ACARSAppView(NavigationView& nav) {
+namespace ui {
+
+ACARSAppView::ACARSAppView(NavigationView&) {
 	baseband::run_image(portapack::spi_flash::image_tag_acars);
 
 	add_children({
@@ -69,29 +74,22 @@ ACARSAppView::ACARSAppView(NavigationView& nav) {
 		&field_rf_amp,
 		&field_lna,
 		&field_vga,
-		&field_frequency,
+		&options_plan,
+		&text_counts,
 		&check_log,
 		&console
 	});
 	
-	receiver_model.set_sampling_rate(2457600);
-	receiver_model.set_baseband_bandwidth(1750000);
+	receiver_model.set_sampling_rate(sampling_rate);
+	receiver_model.set_baseband_bandwidth(3500000);
 	receiver_model.enable();
+	receiver_model.set_gain_control(true);
 	
-	field_frequency.set_value(receiver_model.tuning_frequency());
-	update_freq(receiver_model.tuning_frequency());
-	field_frequency.set_step(receiver_model.frequency_step());
-	field_frequency.on_change = [this](rf::Frequency f) {
-		update_freq(f);
-	};
-	field_frequency.on_edit = [this, &nav]() {
-		// TODO: Provide separate modal method/scheme?
-		auto new_view = nav.push<FrequencyKeypadView>(receiver_model.tuning_frequency());
-		new_view->on_changed = [this](rf::Frequency f) {
-			update_freq(f);
-			field_frequency.set_value(f);
-		};
+	options_plan.on_change = [this](size_t, OptionsField::value_t v) {
+		on_plan_changed(v);
 	};
+	options_plan.set_selected_index(0);
+	on_plan_changed(0);
 	
 	check_log.set_value(logging);
 	check_log.on_select = [this](Checkbox&, bool v) {
@@ -109,41 +107,52 @@ ACARSAppView::~ACARSAppView() {
 }
 
 void ACARSAppView::focus() {
-	field_frequency.focus();
+	options_plan.focus();
 }
 
-void ACARSAppView::on_packet(const acars::Packet& packet) {
-	std::string console_info;
-	
-	/*if (!packet.is_valid()) {
-		console_info = to_string_datetime(packet.received_at(), HMS);
-		console_info += " INVALID";
-		
-		console.writeln(console_info);
-	} else {
-		console_info = to_string_datetime(packet.received_at(), HMS);
-		console_info += ":" + to_string_bin(packet.read(0, 32), 32);
-		//console_info += " REG:" + packet.registration_number();
-		
-		console.writeln(console_info);
-	}*/
-	
-	packet_counter++;
-	if (packet_counter % 10 == 0)
-		console.writeln("Block #" + to_string_dec_uint(packet_counter));
-	
-	// Log raw data whatever it contains
-	if (logger && logging)
-		logger->log_raw_data(packet, target_frequency());
+void ACARSAppView::on_plan_changed(const size_t new_index) {
+	plan_index = new_index;
+	const auto& plan = channel_plans[plan_index];
+
+	// The baseband channelizer works around the FS/4-shifted center.
+	receiver_model.set_tuning_frequency(plan.center - sampling_rate / 4);
+	baseband::set_acars(plan.offsets_hz, plan.channel_count);
+
+	block_counts.fill(0);
+	update_counts();
 }
 
-void ACARSAppView::set_target_frequency(const uint32_t new_value) {
-	target_frequency_ = new_value;
-	receiver_model.set_tuning_frequency(new_value);
+uint32_t ACARSAppView::channel_frequency(const size_t channel) const {
+	const auto& plan = channel_plans[plan_index];
+	return plan.center + plan.offsets_hz[channel];
 }
 
-uint32_t ACARSAppView::target_frequency() const {
-	return target_frequency_;
+void ACARSAppView::update_counts() {
+	const auto& plan = channel_plans[plan_index];
+	std::string counts = "Blocks:";
+	for (size_t i = 0; i < plan.channel_count; i++)
+		counts += " " + to_string_dec_uint(block_counts[i]);
+	text_counts.set(counts);
+}
+
+void ACARSAppView::on_packet(const acars::Packet& packet, const size_t channel) {
+	if (channel >= channel_plans[plan_index].channel_count)
+		return;
+
+	block_counts[channel]++;
+	update_counts();
+
+	const auto frequency = channel_frequency(channel);
+
+	std::string console_info = to_string_datetime(packet.received_at(), HMS);
+	console_info += " " + to_string_short_freq(frequency);
+	console_info += " " + packet.registration_number();
+	console_info += " " + packet.label();
+	console_info += " " + packet.text();
+	console.writeln(console_info);
+	
+	if (logger && logging)
+		logger->log_decoded(packet, frequency);
 }
 
 } /* namespace ui */
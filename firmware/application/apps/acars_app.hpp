@@ -31,14 +31,15 @@
 
 #include "acars_packet.hpp"
 
+#include <array>
+
 class ACARSLogger {
 public:
 	Optional<File::Error> append(const std::string& filename) {
 		return log_file.append(filename);
 	}
 	
-	void log_raw_data(const acars::Packet& packet, const uint32_t frequency);
-	//void log_decoded(const acars::Packet& packet, const std::string text);
+	void log_decoded(const acars::Packet& packet, const uint32_t frequency);
 
 private:
 	LogFile log_file { };
@@ -57,7 +58,8 @@ public:
 
 private:
 	bool logging { false };
-	uint32_t packet_counter { 0 };
+	size_t plan_index { 0 };
+	std::array<uint32_t, ACARSConfigureMessage::channels_max> block_counts { };
 
 	RFAmpField field_rf_amp {
 		{ 13 * 8, 0 * 16 }
@@ -75,8 +77,18 @@ private:
 		{ 21 * 8, 5, 6 * 8, 4 },
 	};
 	
-	FrequencyField field_frequency {
-		{ 0 * 8, 0 * 8 },
+	OptionsField options_plan {
+		{ 0 * 8, 0 * 16 },
+		12,
+		{
+			{ "EU 3ch     ", 0 },
+			{ "US 2ch     ", 1 },
+			{ "131.550 1ch", 2 }
+		}
+	};
+	Text text_counts {
+		{ 0 * 8, 21, 21 * 8, 16 },
+		""
 	};
 	Checkbox check_log {
 		{ 22 * 8, 21 },
@@ -91,21 +103,17 @@ private:
 
 	std::unique_ptr<ACARSLogger> logger { };
 
-	uint32_t target_frequency_ { };
-	
-	void update_freq(rf::Frequency f);
+	void on_plan_changed(const size_t new_index);
+	uint32_t channel_frequency(const size_t channel) const;
+	void update_counts();
 
-	void on_packet(const acars::Packet& packet);
+	void on_packet(const acars::Packet& packet, const size_t channel);
 
-	uint32_t target_frequency() const;
-	void set_target_frequency(const uint32_t new_value);
-	
 	MessageHandlerRegistration message_handler_packet {
 		Message::ID::ACARSPacket,
 		[this](Message* const p) {
 			const auto message = static_cast<const ACARSPacketMessage*>(p);
-			const acars::Packet packet { message->packet };
-			this->on_packet(packet);
+			this->on_packet(message->packet, message->channel);
 		}
 	};
 
@@ -25,10 +25,14 @@
 
 #include "baseband_api.hpp"
 
+#include "rtc_time.hpp"
+#include "sample_clock.hpp"
+
 #include "portapack.hpp"
 using namespace portapack;
 
 #include <algorithm>
+#include <cmath>
 
 namespace ais {
 namespace format {
@@ -126,10 +130,95 @@ static std::string true_heading(const TrueHeading value) {
 	}
 }
 
+static std::string ship_type(const uint8_t value) {
+	switch(value / 10) {
+	case 2: return "wing in ground";
+	case 3:
+		switch(value) {
+		case 30: return "fishing";
+		case 31: case 32: return "towing";
+		case 33: return "dredging";
+		case 34: return "diving";
+		case 35: return "military";
+		case 36: return "sailing";
+		case 37: return "pleasure craft";
+		default: return "reserved";
+		}
+	case 4: return "high speed craft";
+	case 5:
+		switch(value) {
+		case 50: return "pilot";
+		case 51: return "search and rescue";
+		case 52: return "tug";
+		case 53: return "port tender";
+		case 54: return "anti-pollution";
+		case 55: return "law enforcement";
+		case 58: return "medical transport";
+		default: return "special craft";
+		}
+	case 6: return "passenger";
+	case 7: return "cargo";
+	case 8: return "tanker";
+	case 9: return "other";
+	default: return (value == 0) ? "not available" : "reserved";
+	}
+}
+
 } /* namespace format */
 } /* namespace ais */
 
+namespace {
+
+// Latitude and Longitude are in 1/10000 minutes.
+constexpr float degrees_per_unit = 1.0f / 600000.0f;
+// SpeedOverGround is in 1/10 knots, a knot a minute of latitude per hour.
+constexpr float degrees_per_second_per_unit = 1.0f / (10.0f * 60.0f * 3600.0f);
+
+} /* namespace */
+
+void AISRecentEntry::set_position(const Timestamp timestamp, const ais::Latitude latitude, const ais::Longitude longitude) {
+	last_position.timestamp = timestamp;
+	last_position.latitude = latitude;
+	last_position.longitude = longitude;
+	if( !latitude.is_valid() || !longitude.is_valid() ) {
+		return;
+	}
+
+	lat = latitude.normalized() * degrees_per_unit;
+	lon = longitude.normalized() * degrees_per_unit;
+	position_age = 0;
+
+	// Trigonometry once per report, the per second updates only add.
+	const auto sog = last_position.speed_over_ground;
+	const auto cog = last_position.course_over_ground;
+	if( (sog > 0) && (sog < 1022) && (cog < 3600) ) {
+		const float course = cog * (3.14159265f / 1800.0f);
+		const float speed = sog * degrees_per_second_per_unit;
+		const float lat_scale = std::cos(lat * (3.14159265f / 180.0f));
+		lat_rate = speed * std::cos(course);
+		lon_rate = (lat_scale > 0.01f) ? (speed * std::sin(course) / lat_scale) : 0.0f;
+	} else {
+		lat_rate = 0.0f;
+		lon_rate = 0.0f;
+	}
+}
+
+uint16_t AISRecentEntry::heading() const {
+	if( last_position.true_heading < 360 ) {
+		return last_position.true_heading;
+	}
+	if( last_position.course_over_ground < 3600 ) {
+		return last_position.course_over_ground / 10;
+	}
+	return GeoMarkers::heading_unknown;
+}
+
 void AISLogger::on_packet(const ais::Packet& packet) {
+	if( log_file.is_binary() ) {
+		log_file.write_record(packet.received_at(), LogRecordType::AIS, 0, packet.raw());
+		return;
+	}
+
 	// TODO: Unstuff here, not in baseband!
 	std::string entry;
 	entry.reserve((packet.length() + 3) / 4);
@@ -139,11 +228,21 @@ void AISLogger::on_packet(const ais::Packet& packet) {
 		entry += (nibble >= 10) ? ('W' + nibble) : ('0' + nibble);
 	}
 
-	log_file.write_entry(packet.received_at(), entry);
+	sample_clock::Time time;
+	if( sample_clock::time(packet.sample_index(), time) ) {
+		entry += " us=" + to_string_dec_uint(time.microseconds, 6, '0');
+		log_file.write_entry(time.datetime, entry);
+	} else {
+		log_file.write_entry(packet.received_at(), entry);
+	}
 }	
 
-void AISRecentEntry::update(const ais::Packet& packet) {
+bool AISRecentEntry::update(const ais::Packet& packet, const uint8_t channel) {
 	received_count++;
+	last_channel = channel;
+
+	const auto had_position = position_age;
+	position_age = position_age_none;
 
 	switch(packet.message_id()) {
 	case 1:
@@ -152,35 +251,61 @@ void AISRecentEntry::update(const ais::Packet& packet) {
 		navigational_status = packet.read(38, 4);
 		last_position.rate_of_turn = packet.read(42, 8);
 		last_position.speed_over_ground = packet.read(50, 10);
-		last_position.timestamp = packet.received_at();
-		last_position.latitude = packet.latitude(89);
-		last_position.longitude = packet.longitude(61);
 		last_position.course_over_ground = packet.read(116, 12);
 		last_position.true_heading = packet.read(128, 9);
+		set_position(packet.received_at(), packet.latitude(89), packet.longitude(61));
 		break;
 
 	case 4:
-		last_position.timestamp = packet.received_at();
-		last_position.latitude = packet.latitude(107);
-		last_position.longitude = packet.longitude(79);
+		last_position.speed_over_ground = 1023;
+		set_position(packet.received_at(), packet.latitude(107), packet.longitude(79));
 		break;
 
 	case 5:
 		call_sign = packet.text(70, 7);
 		name = packet.text(112, 20);
+		ship_type = packet.read(232, 8);
 		destination = packet.text(302, 20);
 		break;
 
+	case 18:
+	case 19:
+		// Class B, 19 with static data too.
+		last_position.speed_over_ground = packet.read(46, 10);
+		last_position.course_over_ground = packet.read(112, 12);
+		last_position.true_heading = packet.read(124, 9);
+		set_position(packet.received_at(), packet.latitude(85), packet.longitude(57));
+		if( packet.message_id() == 19 ) {
+			name = packet.text(143, 20);
+			ship_type = packet.read(263, 8);
+		}
+		break;
+
 	case 21:
 		name = packet.text(43, 20);
-		last_position.timestamp = packet.received_at();
-		last_position.latitude = packet.latitude(192);
-		last_position.longitude = packet.longitude(164);
+		last_position.speed_over_ground = 1023;
+		set_position(packet.received_at(), packet.latitude(192), packet.longitude(164));
+		break;
+
+	case 24:
+		// Class B static data, in two parts sent separately.
+		if( packet.read(38, 2) == 0 ) {
+			name = packet.text(40, 20);
+		} else {
+			ship_type = packet.read(40, 8);
+			call_sign = packet.text(90, 7);
+		}
 		break;
 
 	default:
 		break;
 	}
+
+	if( has_position() ) {
+		return true;
+	}
+	position_age = had_position;
+	return false;
 }
 
 namespace ui {
@@ -199,13 +324,14 @@ void RecentEntriesTable<AISRecentEntries>::draw(
 		line += entry.call_sign;
 	}
 
-	line.resize(target_rect.width() / 8, ' ');
+	line.resize(target_rect.width() / style.font.char_width(), ' ');
 	painter.draw_string(target_rect.location(), style, line);
 }
 
 AISRecentEntryDetailView::AISRecentEntryDetailView() {
 	add_children({
 		&button_done,
+		&button_map,
 	});
 
 	button_done.on_select = [this](const ui::Button&) {
@@ -213,6 +339,11 @@ AISRecentEntryDetailView::AISRecentEntryDetailView() {
 			this->on_close();
 		}
 	};
+	button_map.on_select = [this](const ui::Button&) {
+		if( this->on_map ) {
+			this->on_map();
+		}
+	};
 }
 
 void AISRecentEntryDetailView::focus() {
@@ -246,6 +377,7 @@ void AISRecentEntryDetailView::paint(Painter& painter) {
 	field_rect = draw_field(painter, field_rect, s, "Name", entry_.name);
 	field_rect = draw_field(painter, field_rect, s, "Call", entry_.call_sign);
 	field_rect = draw_field(painter, field_rect, s, "Dest", entry_.destination);
+	field_rect = draw_field(painter, field_rect, s, "Type", ais::format::ship_type(entry_.ship_type));
 	field_rect = draw_field(painter, field_rect, s, "Last", to_string_datetime(entry_.last_position.timestamp));
 	field_rect = draw_field(painter, field_rect, s, "Pos ", ais::format::latlon(entry_.last_position.latitude, entry_.last_position.longitude));
 	field_rect = draw_field(painter, field_rect, s, "Stat", ais::format::navigational_status(entry_.navigational_status));
@@ -254,6 +386,7 @@ void AISRecentEntryDetailView::paint(Painter& painter) {
 	field_rect = draw_field(painter, field_rect, s, "CoG ", ais::format::course_over_ground(entry_.last_position.course_over_ground));
 	field_rect = draw_field(painter, field_rect, s, "Head", ais::format::true_heading(entry_.last_position.true_heading));
 	field_rect = draw_field(painter, field_rect, s, "Rx #", to_string_dec_uint(entry_.received_count));
+	field_rect = draw_field(painter, field_rect, s, "Chan", entry_.last_channel ? "88B" : "87B");
 }
 
 void AISRecentEntryDetailView::set_entry(const AISRecentEntry& entry) {
@@ -261,22 +394,27 @@ void AISRecentEntryDetailView::set_entry(const AISRecentEntry& entry) {
 	set_dirty();
 }
 
-AISAppView::AISAppView(NavigationView&) {
+AISAppView::AISAppView(
+	NavigationView& nav
+) : nav_ { nav }
+{
 	baseband::run_image(portapack::spi_flash::image_tag_ais);
 
 	add_children({
 		&label_channel,
-		&options_channel,
 		&field_rf_amp,
 		&field_lna,
 		&field_vga,
 		&rssi,
 		&channel,
+		&button_map,
+		&button_file,
 		&recent_entries_view,
 		&recent_entry_detail_view,
 	});
 
 	recent_entry_detail_view.hidden(true);
+	recent_entries_view.set_style(&style_compact);
 
 	target_frequency_ = initial_target_frequency;
 
@@ -289,11 +427,7 @@ AISAppView::AISAppView(NavigationView&) {
 		static_cast<int8_t>(receiver_model.lna()),
 		static_cast<int8_t>(receiver_model.vga()),
 	});
-
-	options_channel.on_change = [this](size_t, OptionsField::value_t v) {
-		this->on_frequency_changed(v);
-	};
-	options_channel.set_by_value(target_frequency());
+	receiver_model.set_gain_control(true);
 
 	recent_entries_view.on_select = [this](const AISRecentEntry& entry) {
 		this->on_show_detail(entry);
@@ -301,6 +435,22 @@ AISAppView::AISAppView(NavigationView&) {
 	recent_entry_detail_view.on_close = [this]() {
 		this->on_show_list();
 	};
+	recent_entry_detail_view.on_map = [this]() {
+		this->on_show_map(this->recent_entry_detail_view.entry());
+	};
+	button_map.on_select = [this](Button&) {
+		// Centered on the vessel heard from last that gave a position.
+		const auto found = std::find_if(recent.begin(), recent.end(), [](const AISRecentEntry& entry) {
+			return entry.has_position();
+		});
+		if( found != recent.end() ) {
+			this->on_show_map(*found);
+		}
+	};
+
+	signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+		this->on_tick_second();
+	};
 
 	logger = std::make_unique<AISLogger>();
 	if( logger ) {
@@ -309,13 +459,15 @@ AISAppView::AISAppView(NavigationView&) {
 }
 
 AISAppView::~AISAppView() {
+	rtc_time::signal_tick_second -= signal_token_tick_second;
+	receiver_model.set_gain_control(false);
 	radio::disable();
 
 	baseband::shutdown();
 }
 
 void AISAppView::focus() {
-	options_channel.focus();
+	field_rf_amp.focus();
 }
 
 void AISAppView::set_parent_rect(const Rect new_parent_rect) {
@@ -325,14 +477,17 @@ void AISAppView::set_parent_rect(const Rect new_parent_rect) {
 	recent_entry_detail_view.set_parent_rect(content_rect);
 }
 
-void AISAppView::on_packet(const ais::Packet& packet) {
+void AISAppView::on_packet(const ais::Packet& packet, const uint8_t channel) {
 	if( logger ) {
 		logger->on_packet(packet);
 	}
 
 	auto& entry = ::on_packet(recent, packet.source_id());
-	entry.update(packet);
-	recent_entries_view.set_dirty();
+	if( entry.update(packet, channel) ) {
+		markers.update(entry.mmsi, entry.lat, entry.lon, entry.heading());
+		tracks.add(entry.mmsi, entry.lat, entry.lon);
+	}
+	recent_entries_view.update();
 
 	// TODO: Crude hack, should be a more formal listener arrangement...
 	if( entry.key() == recent_entry_detail_view.entry().key() ) {
@@ -340,6 +495,59 @@ void AISAppView::on_packet(const ais::Packet& packet) {
 	}
 }
 
+void AISAppView::on_tick_second() {
+	markers.tick();
+
+	for(auto& entry : recent) {
+		if( !entry.has_position() ) {
+			continue;
+		}
+		if( entry.position_age < marker_timeout ) {
+			entry.position_age++;
+			if( (entry.lat_rate != 0.0f) || (entry.lon_rate != 0.0f) ) {
+				markers.reposition(entry.mmsi, entry.predicted_lat(), entry.predicted_lon());
+			}
+		} else if( entry.position_age == marker_timeout ) {
+			// Stops here, the entry keeps its last position for the details.
+			entry.position_age++;
+			markers.remove(entry.mmsi);
+			tracks.remove(entry.mmsi);
+		}
+	}
+}
+
+void AISAppView::on_show_map(const AISRecentEntry& entry) {
+	if( !entry.has_position() ) {
+		return;
+	}
+
+	auto geomap_view = nav_.push<GeoMapView>(
+		marker_label(entry.mmsi),
+		0,
+		GeoPos::alt_unit::METERS,
+		entry.predicted_lat(),
+		entry.predicted_lon(),
+		(entry.heading() == GeoMarkers::heading_unknown) ? 0 : entry.heading()
+	);
+	geomap_view->set_markers(&markers, [this](const GeoMarkers::Id id) {
+		return this->marker_label(id);
+	});
+	geomap_view->set_tracks(&tracks);
+}
+
+std::string AISAppView::marker_label(const GeoMarkers::Id id) const {
+	const auto found = find(recent, id);
+	if( found != recent.end() ) {
+		if( !found->name.empty() ) {
+			return found->name;
+		}
+		if( !found->call_sign.empty() ) {
+			return found->call_sign;
+		}
+	}
+	return ais::format::mmsi(id);
+}
+
 void AISAppView::on_show_list() {
 	recent_entries_view.hidden(false);
 	recent_entry_detail_view.hidden(true);
@@ -353,15 +561,6 @@ void AISAppView::on_show_detail(const AISRecentEntry& entry) {
 	recent_entry_detail_view.focus();
 }
 
-void AISAppView::on_frequency_changed(const uint32_t new_target_frequency) {
-	set_target_frequency(new_target_frequency);
-}
-
-void AISAppView::set_target_frequency(const uint32_t new_value) {
-	target_frequency_ = new_value;
-	radio::set_tuning_frequency(tuning_frequency());
-}
-
 uint32_t AISAppView::target_frequency() const {
 	return target_frequency_;
 }
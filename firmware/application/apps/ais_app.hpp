@@ -27,12 +27,15 @@
 #include "ui_receiver.hpp"
 #include "ui_rssi.hpp"
 #include "ui_channel.hpp"
+#include "ui_geomap.hpp"
 
 #include "event_m0.hpp"
 
 #include "log_file.hpp"
 
 #include "ais_packet.hpp"
+#include "geo_markers.hpp"
+#include "offline_decoder.hpp"
 
 #include "lpc43xx_cpp.hpp"
 using namespace lpc43xx;
@@ -46,6 +49,7 @@ using namespace lpc43xx;
 #include <iterator>
 
 #include "recent_entries.hpp"
+#include "ui_font_fixed_6x8.hpp"
 
 struct AISPosition {
 	rtc::RTC timestamp { };
@@ -57,10 +61,14 @@ struct AISPosition {
 	ais::TrueHeading true_heading { 511 };
 };
 
+/* One vessel, merged from every message type that mentions it: positions
+ * from 1-4, 18, 19 and 21, static and voyage data from 5, 19, 21 and 24.
+ */
 struct AISRecentEntry {
 	using Key = ais::MMSI;
 
 	static constexpr Key invalid_key = 0xffffffff;
+	static constexpr uint16_t position_age_none = 0xffff;
 
 	ais::MMSI mmsi;
 	std::string name;
@@ -69,6 +77,15 @@ struct AISRecentEntry {
 	AISPosition last_position;
 	size_t received_count;
 	int8_t navigational_status;
+	uint8_t last_channel;
+	uint8_t ship_type;				// 0: not available
+	uint16_t position_age;			// Seconds since last_position was reported
+	// last_position in degrees, and its drift per second at the reported
+	// speed and course, for dead reckoning between reports.
+	float lat;
+	float lon;
+	float lat_rate;
+	float lon_rate;
 
 	AISRecentEntry(
 	) : AISRecentEntry { 0 }
@@ -83,7 +100,14 @@ struct AISRecentEntry {
 		destination { },
 		last_position { },
 		received_count { 0 },
-		navigational_status { -1 }
+		navigational_status { -1 },
+		last_channel { 0 },
+		ship_type { 0 },
+		position_age { position_age_none },
+		lat { 0 },
+		lon { 0 },
+		lat_rate { 0 },
+		lon_rate { 0 }
 	{
 	}
 
@@ -91,15 +115,36 @@ struct AISRecentEntry {
 		return mmsi;
 	}
 
-	void update(const ais::Packet& packet);
+	bool has_position() const {
+		return position_age != position_age_none;
+	}
+
+	/* Where the vessel should be by now. */
+	float predicted_lat() const {
+		return lat + lat_rate * position_age;
+	}
+
+	float predicted_lon() const {
+		return lon + lon_rate * position_age;
+	}
+
+	/* Degrees, or GeoMarkers::heading_unknown. */
+	uint16_t heading() const;
+
+	/* Returns true if the packet carried a valid position. */
+	bool update(const ais::Packet& packet, const uint8_t channel);
+
+private:
+	void set_position(const Timestamp timestamp, const ais::Latitude latitude, const ais::Longitude longitude);
 };
 
-using AISRecentEntries = RecentEntries<AISRecentEntry>;
+// Busy harbours hold more vessels than a list scan per packet should visit.
+using AISRecentEntries = RecentEntries<AISRecentEntry, 128, HashIndex<AISRecentEntry::Key, 256>>;
 
 class AISLogger {
 public:
 	Optional<File::Error> append(const std::filesystem::path& filename) {
-		return log_file.append(filename);
+		return log_file.append_packets(filename);
 	}
 	
 	void on_packet(const ais::Packet& packet);
@@ -115,6 +160,7 @@ using AISRecentEntriesView = RecentEntriesView<AISRecentEntries>;
 class AISRecentEntryDetailView : public View {
 public:
 	std::function<void(void)> on_close { };
+	std::function<void(void)> on_map { };
 
 	AISRecentEntryDetailView();
 
@@ -128,10 +174,15 @@ private:
 	AISRecentEntry entry_ { };
 
 	Button button_done {
-		{ 72, 216, 96, 24 },
+		{ 16, 240, 96, 24 },
 		"Done"
 	};
 
+	Button button_map {
+		{ 128, 240, 96, 24 },
+		"Map"
+	};
+
 	Rect draw_field(
 		Painter& painter,
 		const Rect& draw_rect,
@@ -157,13 +208,27 @@ public:
 	std::string title() const override { return "AIS"; };
 
 private:
-	static constexpr uint32_t initial_target_frequency = 162025000;
+	// Midway between 87B and 88B, the baseband decodes both at once.
+	static constexpr uint32_t initial_target_frequency = 162000000;
 	static constexpr uint32_t sampling_rate = 2457600;
 	static constexpr uint32_t baseband_bandwidth = 1750000;
 
+	// Vessels not heard from for this long are taken off the map.
+	static constexpr uint16_t marker_timeout = 10 * 60;
+
+	NavigationView& nav_;
 	AISRecentEntries recent { };
+	GeoMarkers markers { };
+	GeoTrackStore<32, 16> tracks { };
 	std::unique_ptr<AISLogger> logger { };
+	SignalToken signal_token_tick_second { };
 
+	// Twice the rows of the 8x16 font.
+	const Style style_compact {
+		.font = font::fixed_6x8,
+		.background = Color::black(),
+		.foreground = Color::white(),
+	};
 	const RecentEntriesColumns columns { {
 		{ "MMSI", 9 },
 		{ "Name/Call", 20 },
@@ -174,17 +239,8 @@ private:
 	static constexpr auto header_height = 1 * 16;
 
 	Text label_channel {
-		{ 0 * 8, 0 * 16, 2 * 8, 1 * 16 },
-		"Ch"
-	};
-
-	OptionsField options_channel {
-		{ 3 * 8, 0 * 16 },
-		3,
-		{
-			{ "87B", 161975000 },
-			{ "88B", 162025000 },
-		}
+		{ 0 * 8, 0 * 16, 10 * 8, 1 * 16 },
+		"Ch 87B+88B"
 	};
 
 	RFAmpField field_rf_amp {
@@ -207,27 +263,38 @@ private:
 		{ 21 * 8, 5, 6 * 8, 4 },
 	};
 
+	Button button_map {
+		{ 27 * 8, 0 * 16, 3 * 8, 1 * 16 },
+		"Map"
+	};
+
+	OfflineDecodeButton button_file {
+		nav_,
+		{ 10 * 8, 0 * 16, 3 * 8, 1 * 16 },
+		sampling_rate
+	};
+
 	MessageHandlerRegistration message_handler_packet {
 		Message::ID::AISPacket,
 		[this](Message* const p) {
 			const auto message = static_cast<const AISPacketMessage*>(p);
 			const ais::Packet packet { message->packet };
 			if( packet.is_valid() ) {
-				this->on_packet(packet);
+				this->on_packet(packet, message->channel);
 			}
 		}
 	};
 
 	uint32_t target_frequency_ = initial_target_frequency;
 
-	void on_packet(const ais::Packet& packet);
+	void on_packet(const ais::Packet& packet, const uint8_t channel);
+	void on_tick_second();
 	void on_show_list();
 	void on_show_detail(const AISRecentEntry& entry);
-
-	void on_frequency_changed(const uint32_t new_target_frequency);
+	void on_show_map(const AISRecentEntry& entry);
+	std::string marker_label(const GeoMarkers::Id id) const;
 
 	uint32_t target_frequency() const;
-	void set_target_frequency(const uint32_t new_value);
 
 	uint32_t tuning_frequency() const;
 };
@@ -36,6 +36,8 @@ using namespace tonekey;
 
 #include "string_format.hpp"
 
+#include <algorithm>
+
 namespace ui {
 
 /* AMOptionsView *********************************************************/
@@ -83,6 +85,74 @@ NBFMOptionsView::NBFMOptionsView(
 	};
 }
 
+/* WFMOptionsView ********************************************************/
+
+WFMOptionsView::WFMOptionsView(
+	const Rect parent_rect, const Style* const style
+) : View { parent_rect }
+{
+	set_style(style);
+
+	add_children({
+		&options_config,
+	});
+
+	options_config.set_selected_index(receiver_model.wfm_configuration());
+	options_config.on_change = [this](size_t n, OptionsField::value_t) {
+		receiver_model.set_wfm_configuration(n);
+	};
+}
+
+/* SpectrumOptionsView ***************************************************/
+
+SpectrumOptionsView::SpectrumOptionsView(
+	const Rect parent_rect, const Style* const style
+) : View { parent_rect }
+{
+	set_style(style);
+
+	add_children({
+		&options_trace,
+		&options_zoom,
+		&check_log,
+	});
+	
+	check_log.on_select = [this](Checkbox&, bool v) {
+		if (this->on_change_log)
+			this->on_change_log(v);
+	};
+
+	options_zoom.on_change = [this](size_t, OptionsField::value_t v) {
+		if (this->on_change_zoom)
+			this->on_change_zoom(v);
+	};
+
+	options_trace.on_change = [this](size_t, OptionsField::value_t v) {
+		const auto trace = static_cast<SpectrumStreamingConfigMessage::Trace>(v);
+		uint32_t trace_param = 0;
+		if (trace == SpectrumStreamingConfigMessage::Trace::Average)
+			trace_param = 8;		// Frames
+		else if (trace == SpectrumStreamingConfigMessage::Trace::Exponential)
+			trace_param = 2;		// 1/4 smoothing
+		
+		if (this->on_change_trace)
+			this->on_change_trace(trace, trace_param);
+	};
+}
+
+void SpectrumOptionsView::set_trace(const SpectrumStreamingConfigMessage::Trace trace) {
+	options_trace.set_by_value(toUType(trace));
+}
+
+void SpectrumOptionsView::set_log(const bool enabled) {
+	// Without on_change_log yet, so this doesn't reopen the log.
+	check_log.set_value(enabled);
+}
+
+void SpectrumOptionsView::set_zoom(const size_t zoom) {
+	options_zoom.set_by_value(zoom);
+}
+
 /* AnalogAudioView *******************************************************/
 
 AnalogAudioView::AnalogAudioView(
@@ -99,6 +169,7 @@ AnalogAudioView::AnalogAudioView(
 		&options_modulation,
 		&field_volume,
 		&text_ctcss,
+		&text_rds,
 		&record_view,
 		&waterfall
 	});
@@ -148,7 +219,11 @@ AnalogAudioView::AnalogAudioView(
 	};
 	
 	waterfall.on_select = [this](int32_t offset) {
-		field_frequency.set_value(receiver_model.tuning_frequency() + offset);
+		// Zoomed, the waterfall's centre is the zoom's, and it moves instead
+		if (spectrum_zoom > 1)
+			set_spectrum_zoom(spectrum_zoom, spectrum_zoom_offset + offset);
+		else
+			field_frequency.set_value(receiver_model.tuning_frequency() + offset);
 	};
 
 	audio::output::start();
@@ -186,6 +261,10 @@ void AnalogAudioView::focus() {
 
 void AnalogAudioView::on_tuning_frequency_changed(rf::Frequency f) {
 	receiver_model.set_tuning_frequency(f);
+
+	// Another station
+	rds_ps.fill(' ');
+	text_rds.set("");
 }
 
 void AnalogAudioView::on_baseband_bandwidth_changed(uint32_t bandwidth_hz) {
@@ -224,6 +303,37 @@ void AnalogAudioView::set_options_widget(std::unique_ptr<Widget> new_widget) {
 	add_child(options_widget.get());
 }
 
+void AnalogAudioView::set_spectrum_log(const bool enabled) {
+	waterfall.on_spectrum = nullptr;
+	spectrum_log.reset();
+	
+	if (enabled) {
+		spectrum_log = std::make_unique<SpectrumLog>();
+		if (spectrum_log->append("SPECTRUM.BIN").is_valid()) {
+			spectrum_log.reset();
+			nav_.display_modal("Error", "Can't open SPECTRUM.BIN");
+			return;
+		}
+		waterfall.on_spectrum = [this](const ChannelSpectrum& spectrum) {
+			this->spectrum_log->on_channel_spectrum(spectrum, receiver_model.tuning_frequency() + this->spectrum_zoom_offset);
+		};
+	}
+}
+
+void AnalogAudioView::set_spectrum_zoom(const size_t zoom, const int32_t offset) {
+	// x16 and x32 are a 1024 point FFT, shown 256 bins of, after x4 and x8
+	const size_t fft_size = (zoom > 8) ? 1024 : 256;
+	const size_t decimation = (zoom > 8) ? (zoom / 4) : zoom;
+
+	// The zoomed span stays inside the baseband filter's 12MHz
+	const int32_t span = 20000000 / zoom;
+	const int32_t offset_max = (12000000 - span) / 2;
+
+	spectrum_zoom = zoom;
+	spectrum_zoom_offset = (zoom > 1) ? std::max(-offset_max, std::min(offset, offset_max)) : 0;
+	baseband::set_spectrum_zoom(spectrum_zoom_offset, decimation, fft_size);
+}
+
 void AnalogAudioView::on_show_options_frequency() {
 	auto widget = std::make_unique<FrequencyOptionsView>(options_view_rect, &style_options_group);
 
@@ -235,6 +345,10 @@ void AnalogAudioView::on_show_options_frequency() {
 	widget->on_change_reference_ppm_correction = [this](int32_t v) {
 		this->on_reference_ppm_correction_changed(v);
 	};
+	widget->set_frequency_tracking(receiver_model.frequency_tracking());
+	widget->on_change_frequency_tracking = [](bool enabled) {
+		receiver_model.set_frequency_tracking(enabled);
+	};
 
 	set_options_widget(std::move(widget));
 	field_frequency.set_style(&style_options_group);
@@ -256,22 +370,43 @@ void AnalogAudioView::on_show_options_modulation() {
 		widget = std::make_unique<AMOptionsView>(options_view_rect, &style_options_group);
 		waterfall.show_audio_spectrum_view(false);
 		text_ctcss.hidden(true);
+		text_rds.hidden(true);
 		break;
 
 	case ReceiverModel::Mode::NarrowbandFMAudio:
 		widget = std::make_unique<NBFMOptionsView>(nbfm_view_rect, &style_options_group);
 		waterfall.show_audio_spectrum_view(false);
 		text_ctcss.hidden(false);
+		text_rds.hidden(true);
 		break;
 	
 	case ReceiverModel::Mode::WidebandFMAudio:
+		widget = std::make_unique<WFMOptionsView>(wfm_view_rect, &style_options_group);
 		waterfall.show_audio_spectrum_view(true);
 		text_ctcss.hidden(true);
+		text_rds.hidden(false);
 		break;
 	
 	case ReceiverModel::Mode::SpectrumAnalysis:
+		{
+			auto spectrum_widget = std::make_unique<SpectrumOptionsView>(spectrum_view_rect, &style_options_group);
+			spectrum_widget->set_trace(waterfall.trace());
+			spectrum_widget->on_change_trace = [this](SpectrumStreamingConfigMessage::Trace trace, uint32_t trace_param) {
+				this->waterfall.set_trace(trace, trace_param);
+			};
+			spectrum_widget->set_log((bool)spectrum_log);
+			spectrum_widget->on_change_log = [this](bool enabled) {
+				this->set_spectrum_log(enabled);
+			};
+			spectrum_widget->set_zoom(spectrum_zoom);
+			spectrum_widget->on_change_zoom = [this](size_t zoom) {
+				this->set_spectrum_zoom(zoom, this->spectrum_zoom_offset);
+			};
+			widget = std::move(spectrum_widget);
+		}
 		waterfall.show_audio_spectrum_view(false);
 		text_ctcss.hidden(true);
+		text_rds.hidden(true);
 		break;
 		
 	default:
@@ -300,8 +435,6 @@ void AnalogAudioView::update_modulation(const ReceiverModel::Mode modulation) {
 	audio::output::mute();
 	record_view.stop();
 
-	baseband::shutdown();
-
 	portapack::spi_flash::image_tag_t image_tag;
 	switch(modulation) {
 	case ReceiverModel::Mode::AMAudio:				image_tag = portapack::spi_flash::image_tag_am_audio;			break;
@@ -312,11 +445,20 @@ void AnalogAudioView::update_modulation(const ReceiverModel::Mode modulation) {
 		return;
 	}
 
-	baseband::run_image(image_tag);
+	// AM and NFM share one image, switching between them keeps RF streaming.
+	if( (modulation == ReceiverModel::Mode::AMAudio) || (modulation == ReceiverModel::Mode::NarrowbandFMAudio) ) {
+		baseband::run_processor(portapack::spi_flash::image_tag_narrowband_audio, image_tag);
+	} else {
+		baseband::shutdown();
+		baseband::run_image(image_tag);
+	}
 	
 	if (modulation == ReceiverModel::Mode::SpectrumAnalysis) {
 		baseband::set_spectrum(20000000, 127);
 	}
+	// A new image starts unzoomed, as does the new SpectrumOptionsView
+	spectrum_zoom = 1;
+	spectrum_zoom_offset = 0;
 
 	const auto is_wideband_spectrum_mode = (modulation == ReceiverModel::Mode::SpectrumAnalysis);
 	receiver_model.set_modulation(modulation);
@@ -344,25 +486,48 @@ void AnalogAudioView::update_modulation(const ReceiverModel::Mode modulation) {
 	if (exit_on_squelch) nav_.pop();
 }*/
 
-void AnalogAudioView::handle_coded_squelch(const uint32_t value) {
-	float diff, min_diff = value;
-	size_t min_idx { 0 };
-	size_t c;
-	
-	// Find nearest match
-	for (c = 0; c < tone_keys.size(); c++) {
-		diff = abs(((float)value / 100.0) - tone_keys[c].second);
-		if (diff < min_diff) {
-			min_idx = c;
-			min_diff = diff;
+void AnalogAudioView::on_rds_group(const RDSGroupMessage& message) {
+	// Group 0A/0B carries the station name two characters at a time in
+	// block D, at the address in block B's low bits.
+	if( (message.valid & 0b1010) != 0b1010 ) return;
+	if( (message.blocks[1] >> 12) != 0 ) return;
+
+	const size_t address = message.blocks[1] & 3;
+	const std::array<char, 2> chars { { (char)(message.blocks[3] >> 8), (char)(message.blocks[3] & 0xFF) } };
+	for (size_t c = 0; c < chars.size(); c++)
+		rds_ps[address * 2 + c] = ((chars[c] >= 0x20) && (chars[c] < 0x7F)) ? chars[c] : ' ';
+
+	text_rds.set(std::string(rds_ps.data(), rds_ps.size()));
+}
+
+void AnalogAudioView::handle_coded_squelch(const CodedSquelch& coded_squelch) {
+	switch(coded_squelch.type) {
+	case CodedSquelch::Type::CTCSS:
+		// Baseband reports the tone_keys frequencies exactly.
+		for (size_t c = 1; c < 51; c++) {
+			if ((uint32_t)(tone_keys[c].second * 100 + 0.5f) == coded_squelch.value) {
+				text_ctcss.set("CTCSS " + tone_keys[c].first);
+				return;
+			}
 		}
-	}
-	
-	// Arbitrary confidence threshold
-	if (min_diff < 40)
-		text_ctcss.set("CTCSS " + tone_keys[min_idx].first);
-	else
 		text_ctcss.set("???");
+		break;
+
+	case CodedSquelch::Type::DCS:
+	case CodedSquelch::Type::DCSInverted:
+		{
+			std::string name = "DCS ";
+			for (int32_t shift = 6; shift >= 0; shift -= 3)
+				name += '0' + ((coded_squelch.value >> shift) & 7);
+			name += (coded_squelch.type == CodedSquelch::Type::DCSInverted) ? 'I' : 'N';
+			text_ctcss.set(name);
+		}
+		break;
+
+	default:
+		text_ctcss.set("");
+		break;
+	}
 }
 
 } /* namespace ui */
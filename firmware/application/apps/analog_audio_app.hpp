@@ -32,6 +32,7 @@
 #include "ui_font_fixed_8x16.hpp"
 
 #include "tone_key.hpp"
+#include "spectrum_log.hpp"
 
 namespace ui {
 
@@ -78,6 +79,7 @@ private:
 			{ " 8k5", 0 },
 			{ "11k ", 0 },
 			{ "16k ", 0 },
+			{ "20k ", 0 },
 		}
 	};
 	
@@ -94,6 +96,68 @@ private:
 	};
 };
 
+class WFMOptionsView : public View {
+public:
+	WFMOptionsView(const Rect parent_rect, const Style* const style);
+
+private:
+	OptionsField options_config {
+		{ 0 * 8, 0 * 16 },
+		6,
+		{
+			{ "Stereo", 0 },
+			{ "Mono  ", 0 },
+		}
+	};
+};
+
+class SpectrumOptionsView : public View {
+public:
+	std::function<void(SpectrumStreamingConfigMessage::Trace, uint32_t)> on_change_trace { };
+	std::function<void(bool)> on_change_log { };
+	/* Zoom factor, 1 for the full span. */
+	std::function<void(size_t)> on_change_zoom { };
+
+	SpectrumOptionsView(const Rect parent_rect, const Style* const style);
+
+	void set_trace(const SpectrumStreamingConfigMessage::Trace trace);
+	void set_log(const bool enabled);
+	void set_zoom(const size_t zoom);
+
+private:
+	OptionsField options_trace {
+		{ 0 * 8, 0 * 16 },
+		6,
+		{
+			{ "Live  ", toUType(SpectrumStreamingConfigMessage::Trace::Instant) },
+			{ "Avg 8 ", toUType(SpectrumStreamingConfigMessage::Trace::Average) },
+			{ "Smooth", toUType(SpectrumStreamingConfigMessage::Trace::Exponential) },
+			{ "Peak  ", toUType(SpectrumStreamingConfigMessage::Trace::PeakHold) },
+			{ "Min   ", toUType(SpectrumStreamingConfigMessage::Trace::MinHold) },
+		}
+	};
+	// Zoom FFT around the waterfall's selected offset, see set_spectrum_zoom()
+	OptionsField options_zoom {
+		{ 7 * 8, 0 * 16 },
+		3,
+		{
+			{ "x1 ", 1 },
+			{ "x2 ", 2 },
+			{ "x4 ", 4 },
+			{ "x8 ", 8 },
+			{ "x16", 16 },
+			{ "x32", 32 },
+		}
+	};
+	// Rows to SPECTRUM.BIN, see SpectrumLog
+	Checkbox check_log {
+		{ 11 * 8, 0 * 16 },
+		3,
+		"Log",
+		true
+	};
+};
+
 class AnalogAudioView : public View {
 public:
 	AnalogAudioView(NavigationView& nav);
@@ -112,6 +176,8 @@ private:
 
 	const Rect options_view_rect { 0 * 8, 1 * 16, 30 * 8, 1 * 16 };
 	const Rect nbfm_view_rect { 0 * 8, 1 * 16, 18 * 8, 1 * 16 };
+	const Rect spectrum_view_rect { 0 * 8, 1 * 16, 18 * 8, 1 * 16 };
+	const Rect wfm_view_rect { 0 * 8, 1 * 16, 18 * 8, 1 * 16 };
 
 	NavigationView& nav_;
 	//bool exit_on_squelch { false };
@@ -164,11 +230,22 @@ private:
 		""
 	};
 
+	// RDS station name, in WFM
+	Text text_rds {
+		{ 19 * 8, 1 * 16, 11 * 8, 1 * 16 },
+		""
+	};
+	std::array<char, 8> rds_ps { { ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ' } };
+
 	std::unique_ptr<Widget> options_widget { };
+	std::unique_ptr<SpectrumLog> spectrum_log { };
+	// Zoom factor and centre, from the receiver's tuning, in SPEC mode
+	size_t spectrum_zoom { 1 };
+	int32_t spectrum_zoom_offset { 0 };
 
 	RecordView record_view {
 		{ 0 * 8, 2 * 16, 30 * 8, 1 * 16 },
-		u"AUD_????", RecordView::FileType::WAV, 4096, 4
+		u"AUD_????", RecordView::FileType::WAV, 8192, 4
 	};
 
 	spectrum::WaterfallWidget waterfall { true };
@@ -177,6 +254,8 @@ private:
 	void on_baseband_bandwidth_changed(uint32_t bandwidth_hz);
 	void on_modulation_changed(const ReceiverModel::Mode modulation);
 	void on_show_options_frequency();
+	void set_spectrum_log(const bool enabled);
+	void set_spectrum_zoom(const size_t zoom, const int32_t offset);
 	void on_show_options_rf_gain();
 	void on_show_options_modulation();
 	void on_frequency_step_changed(rf::Frequency f);
@@ -190,7 +269,8 @@ private:
 	void update_modulation(const ReceiverModel::Mode modulation);
 	
 	//void squelched();
-	void handle_coded_squelch(const uint32_t value);
+	void handle_coded_squelch(const CodedSquelch& coded_squelch);
+	void on_rds_group(const RDSGroupMessage& message);
 	
 	/*MessageHandlerRegistration message_handler_squelch_signal {
 		Message::ID::RequestSignal,
@@ -200,11 +280,27 @@ private:
 		}
 	};*/
 	
-	MessageHandlerRegistration message_handler_coded_squelch {
+	MessageHandlerRegistration message_handler_rds_group {
+		Message::ID::RDSGroup,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const RDSGroupMessage*>(p);
+			this->on_rds_group(message);
+		}
+	};
+
+	MessageHandlerRegistration message_handler_frequency_offset {
+		Message::ID::FrequencyOffset,
+		[](const Message* const p) {
+			const auto message = *reinterpret_cast<const FrequencyOffsetMessage*>(p);
+			portapack::receiver_model.on_frequency_offset(message.offset_hz);
+		}
+	};
+
+		MessageHandlerRegistration message_handler_coded_squelch {
 		Message::ID::CodedSquelch,
 		[this](const Message* const p) {
 			const auto message = *reinterpret_cast<const CodedSquelchMessage*>(p);
-			this->handle_coded_squelch(message.value);
+			this->handle_coded_squelch(message.coded_squelch);
 		}
 	};
 };
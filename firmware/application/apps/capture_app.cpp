@@ -45,6 +45,10 @@ CaptureAppView::CaptureAppView(NavigationView& nav) {
 		&field_lna,
 		&field_vga,
 		&option_bandwidth,
+		&option_decimation,
+		&option_format,
+		&option_trigger,
+		&option_destination,
 		&record_view,
 		&waterfall,
 	});
@@ -79,6 +83,24 @@ CaptureAppView::CaptureAppView(NavigationView& nav) {
 		waterfall.on_show();
 	};
 
+	option_decimation.on_change = [this](size_t, OptionsField::value_t v) {
+		decimation = v;
+		record_view.set_capture_format(decimation, capture_format);
+	};
+
+	option_format.on_change = [this](size_t, OptionsField::value_t v) {
+		capture_format = static_cast<CaptureConfig::Format>(v);
+		record_view.set_capture_format(decimation, capture_format);
+	};
+
+	option_trigger.on_change = [this](size_t, OptionsField::value_t v) {
+		record_view.set_trigger({ v, pre_trigger_ms, post_trigger_ms });
+	};
+
+	option_destination.on_change = [this](size_t, OptionsField::value_t v) {
+		record_view.set_destination(static_cast<RecordView::Destination>(v));
+	};
+
 	radio::enable({
 		tuning_frequency(),
 		sampling_rate,
@@ -90,6 +112,7 @@ CaptureAppView::CaptureAppView(NavigationView& nav) {
 	});
 	
 	option_bandwidth.set_selected_index(7);		// 500k
+	record_view.set_capture_format(decimation, capture_format);
 
 	record_view.on_error = [&nav](std::string message) {
 		nav.display_modal("Error", message);
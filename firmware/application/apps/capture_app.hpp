@@ -51,6 +51,10 @@ private:
 	static constexpr ui::Dim header_height = 3 * 16;
 
 	uint32_t sampling_rate = 0;
+	size_t decimation = 8;
+	CaptureConfig::Format capture_format = CaptureConfig::Format::C16;
+	static constexpr uint32_t pre_trigger_ms = 10;
+	static constexpr uint32_t post_trigger_ms = 200;
 	static constexpr uint32_t baseband_bandwidth = 2500000;
 
 	void on_target_frequency_changed(rf::Frequency f);
@@ -106,7 +110,51 @@ private:
 			{ "500k ", 500000 }
 		}
 	};
+
+	OptionsField option_decimation {
+		{ 11 * 8, 1 * 16 },
+		3,
+		{
+			{ " /8", 8 },
+			{ " /4", 4 },
+			{ "raw", 1 },
+		}
+	};
+
+	OptionsField option_format {
+		{ 15 * 8, 1 * 16 },
+		3,
+		{
+			{ "C16", toUType(CaptureConfig::Format::C16) },
+			{ "C8 ", toUType(CaptureConfig::Format::C8) },
+			{ "RIQ", toUType(CaptureConfig::Format::C16Rice) },
+		}
+	};
 	
+	/* Burst mode trigger level, dBFS of the channel peak. */
+	OptionsField option_trigger {
+		{ 19 * 8, 1 * 16 },
+		4,
+		{
+			{ "Cont", 0 },
+			{ " -60", -60 },
+			{ " -50", -50 },
+			{ " -40", -40 },
+			{ " -30", -30 },
+			{ " -20", -20 },
+		}
+	};
+	
+	/* USB streams to a host, see usb_stream.hpp. */
+	OptionsField option_destination {
+		{ 25 * 8, 1 * 16 },
+		3,
+		{
+			{ "SD ", toUType(RecordView::Destination::SD) },
+			{ "USB", toUType(RecordView::Destination::USB) },
+		}
+	};
+
 	RecordView record_view {
 		{ 0 * 8, 2 * 16, 30 * 8, 1 * 16 },
 		u"BBD_????", RecordView::FileType::RawS16, 16384, 3
@@ -61,16 +61,28 @@ std::string commodity_type(CommodityType value) {
 } /* namespace ert */
 
 void ERTLogger::on_packet(const ert::Packet& packet) {
+	if( log_file.is_binary() ) {
+		log_file.write_record(packet.received_at(), LogRecordType::ERT, 0, packet.raw());
+		return;
+	}
+
 	const auto formatted = packet.symbols_formatted();
 	log_file.write_entry(packet.received_at(), formatted.data + "/" + formatted.errors);
 }
 
 const ERTRecentEntry::Key ERTRecentEntry::invalid_key { };
 
-void ERTRecentEntry::update(const ert::Packet& packet) {
+bool ERTRecentEntry::update(const ert::Packet& packet) {
+	const auto now = chTimeNow();
+	if( (received_count > 0) && (packet.consumption() == last_consumption) && ((now - last_received) < duplicate_window) ) {
+		return false;
+	}
+
 	received_count++;
 
 	last_consumption = packet.consumption();
+	last_received = now;
+	return true;
 }
 
 namespace ui {
@@ -94,14 +106,19 @@ void RecentEntriesTable<ERTRecentEntries>::draw(
 	painter.draw_string(target_rect.location(), style, line);
 }
 
-ERTAppView::ERTAppView(NavigationView&) {
+ERTAppView::ERTAppView(
+	NavigationView& nav
+) : nav_ { nav }
+{
 	baseband::run_image(portapack::spi_flash::image_tag_ert);
 
 	add_children({
+		&options_mode,
 		&field_rf_amp,
 		&field_lna,
 		&field_vga,
 		&rssi,
+		&button_file,
 		&recent_entries_view,
 	});
 
@@ -114,6 +131,11 @@ ERTAppView::ERTAppView(NavigationView&) {
 		static_cast<int8_t>(receiver_model.lna()),
 		static_cast<int8_t>(receiver_model.vga()),
 	});
+	receiver_model.set_gain_control(true);
+
+	options_mode.on_change = [this](size_t, OptionsField::value_t v) {
+		on_mode_changed(v);
+	};
 
 	logger = std::make_unique<ERTLogger>();
 	if( logger ) {
@@ -122,6 +144,7 @@ ERTAppView::ERTAppView(NavigationView&) {
 }
 
 ERTAppView::~ERTAppView() {
+	receiver_model.set_gain_control(false);
 	radio::disable();
 
 	baseband::shutdown();
@@ -137,15 +160,22 @@ void ERTAppView::set_parent_rect(const Rect new_parent_rect) {
 }
 
 void ERTAppView::on_packet(const ert::Packet& packet) {
+	if( packet.crc_ok() ) {
+		auto& entry = ::on_packet(recent, ERTRecentEntry::Key { packet.id(), packet.commodity_type() });
+		if( !entry.update(packet) ) {
+			return;
+		}
+		recent_entries_view.update();
+	}
+
 	if( logger ) {
 		logger->on_packet(packet);
 	}
+}
 
-	if( packet.crc_ok() ) {
-		auto& entry = ::on_packet(recent, ERTRecentEntry::Key { packet.id(), packet.commodity_type() });
-		entry.update(packet);
-		recent_entries_view.set_dirty();
-	}
+void ERTAppView::on_mode_changed(const bool channelized) {
+	radio::set_tuning_frequency(channelized ? channelized_target_frequency : initial_target_frequency);
+	baseband::set_ert(channelized);
 }
 
 void ERTAppView::on_show_list() {
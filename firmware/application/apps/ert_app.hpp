@@ -32,6 +32,7 @@
 #include "log_file.hpp"
 
 #include "ert_packet.hpp"
+#include "offline_decoder.hpp"
 
 #include "recent_entries.hpp"
 
@@ -59,6 +60,15 @@ struct ERTKey {
 	bool operator==(const ERTKey& other) const {
 		return (id == other.id) && (commodity_type == other.commodity_type);
 	}
+
+	bool operator!=(const ERTKey& other) const {
+		return !(*this == other);
+	}
+
+	// Hash for HashIndex.
+	explicit operator uint32_t() const {
+		return id ^ (commodity_type << 24);
+	}
 };
 
 struct ERTRecentEntry {
@@ -73,6 +83,7 @@ struct ERTRecentEntry {
 	size_t received_count { 0 };
 
 	ert::Consumption last_consumption { };
+	systime_t last_received { 0 };
 
 	ERTRecentEntry(
 		const Key& key
@@ -85,13 +96,19 @@ struct ERTRecentEntry {
 		return { id, commodity_type };
 	}
 
-	void update(const ert::Packet& packet);
+	/* False for a repeat of the last reading within duplicate_window, the
+	 * same transmission heard on a neighbouring slice.
+	 */
+	bool update(const ert::Packet& packet);
+
+private:
+	static constexpr systime_t duplicate_window = MS2ST(250);
 };
 
 class ERTLogger {
 public:
 	Optional<File::Error> append(const std::filesystem::path& filename) {
-		return log_file.append(filename);
+		return log_file.append_packets(filename);
 	}
 	
 	void on_packet(const ert::Packet& packet);
@@ -100,7 +117,7 @@ private:
 	LogFile log_file { };
 };
 
-using ERTRecentEntries = RecentEntries<ERTRecentEntry>;
+using ERTRecentEntries = RecentEntries<ERTRecentEntry, 64, HashIndex<ERTRecentEntry::Key, 128>>;
 
 namespace ui {
 
@@ -109,6 +126,8 @@ using ERTRecentEntriesView = RecentEntriesView<ERTRecentEntries>;
 class ERTAppView : public View {
 public:
 	static constexpr uint32_t initial_target_frequency = 911600000;
+	// Channelized, the slices sit around the FS/4 shifted center.
+	static constexpr uint32_t channelized_target_frequency = initial_target_frequency - 4194304 / 4;
 	static constexpr uint32_t sampling_rate = 4194304;
 	static constexpr uint32_t baseband_bandwidth = 2500000;
 
@@ -126,6 +145,8 @@ public:
 	std::string title() const override { return "ERT"; };
 
 private:
+	NavigationView& nav_;
+
 	ERTRecentEntries recent { };
 	std::unique_ptr<ERTLogger> logger { };
 
@@ -139,6 +160,15 @@ private:
 
 	static constexpr auto header_height = 1 * 16;
 
+	OptionsField options_mode {
+		{ 0 * 8, 0 * 16 },
+		4,
+		{
+			{ "Wide", 0 },
+			{ "4ch ", 1 },
+		}
+	};
+
 	RFAmpField field_rf_amp {
 		{ 13 * 8, 0 * 16 }
 	};
@@ -155,6 +185,12 @@ private:
 		{ 21 * 8, 0, 6 * 8, 4 },
 	};
 
+	OfflineDecodeButton button_file {
+		nav_,
+		{ 10 * 8, 0 * 16, 3 * 8, 1 * 16 },
+		sampling_rate
+	};
+
 	MessageHandlerRegistration message_handler_packet {
 		Message::ID::ERTPacket,
 		[this](Message* const p) {
@@ -166,6 +202,7 @@ private:
 
 	void on_packet(const ert::Packet& packet);
 	void on_show_list();
+	void on_mode_changed(const bool channelized);
 };
 
 } /* namespace ui */
@@ -56,7 +56,10 @@ void POCSAGAppView::update_freq(rf::Frequency f) {
 	portapack::persistent_memory::set_tuned_frequency(f);	// Maybe not ?
 }
 
-POCSAGAppView::POCSAGAppView(NavigationView& nav) {
+POCSAGAppView::POCSAGAppView(
+	NavigationView& nav
+) : nav_ { nav }
+{
 	uint32_t ignore_address;
 	
 	baseband::run_image(portapack::spi_flash::image_tag_pocsag);
@@ -68,16 +71,19 @@ POCSAGAppView::POCSAGAppView(NavigationView& nav) {
 		&field_lna,
 		&field_vga,
 		&field_frequency,
+		&button_file,
 		&options_bitrate,
 		&check_log,
 		&check_ignore,
 		&sym_ignore,
 		&console
 	});
+	console.set_style(&style_console);
 	
-	receiver_model.set_sampling_rate(3072000);
+	receiver_model.set_sampling_rate(sampling_rate);
 	receiver_model.set_baseband_bandwidth(1750000);
 	receiver_model.enable();
+	receiver_model.set_gain_control(true);
 	
 	field_frequency.set_value(receiver_model.tuning_frequency());
 	field_frequency.set_step(receiver_model.frequency_step());
@@ -101,7 +107,7 @@ POCSAGAppView::POCSAGAppView(NavigationView& nav) {
 	options_bitrate.on_change = [this](size_t, OptionsField::value_t v) {
 		on_bitrate_changed(v);
 	};
-	options_bitrate.set_selected_index(1);	// 1200bps
+	options_bitrate.set_selected_index(3);	// All rates
 	
 	check_ignore.set_value(ignore);
 	check_ignore.on_select = [this](Checkbox&, bool v) {
@@ -136,69 +142,107 @@ void POCSAGAppView::set_parent_rect(const Rect new_parent_rect) {
 	View::set_parent_rect(new_parent_rect);
 }
 
-void POCSAGAppView::on_packet(const POCSAGPacketMessage * message) {
-	std::string alphanum_text = "";
-	
-	if (message->packet.flag() != NORMAL)
-		console.writeln("\n\x1B\x0CRC ERROR: " + pocsag::flag_str(message->packet.flag()));
+void POCSAGAppView::on_packet(const pocsag::POCSAGPacket& packet) {
+	if (packet.flag() != NORMAL)
+		console.writeln("\n\x1B\x0CRC ERROR: " + pocsag::flag_str(packet.flag()));
 	else {
-		pocsag_decode_batch(message->packet, &pocsag_state);
-
-		if ((ignore) && (pocsag_state.address == sym_ignore.value_dec_u32())) {
-			// Ignore (inform, but no log)
-			//console.write("\n\x1B\x03" + to_string_time(message->packet.timestamp()) +
-			//			" Ignored address " + to_string_dec_uint(pocsag_state.address));
-			return;
-		}
-
-		std::string console_info;
+		size_t rate_index = 0;
+		while ((rate_index < 2) && (pocsag_bitrates[rate_index] != packet.bitrate()))
+			rate_index++;
 		
-		console_info = "\n" + to_string_datetime(message->packet.timestamp(), HM);
-		console_info += " " + pocsag::bitrate_str(message->packet.bitrate());
-		console_info += " ADDR:" + to_string_dec_uint(pocsag_state.address);
-		console_info += " F" + to_string_dec_uint(pocsag_state.function);
-
-		// Store last received address for POCSAG TX
-		persistent_memory::set_pocsag_last_address(pocsag_state.address);
+		auto& decoder = decoders[rate_index];
+		auto& reception = receptions[rate_index];
 		
-		if (pocsag_state.out_type == ADDRESS) {
-			// Address only
-			
-			console.write(console_info);
+		for (size_t i = 0; i < 16; i++) {
+			const auto events = decoder.feed(packet[i], i);
 			
-			if (logger && logging) {
-				logger->log_decoded(message->packet, to_string_dec_uint(pocsag_state.address) +
-													" F" + to_string_dec_uint(pocsag_state.function) +
-													" Address only");
+			if (events & MessageDecoder::EVENT_END) {
+				log_message(packet, reception);
 			}
-			
-			last_address = pocsag_state.address;
-		} else if (pocsag_state.out_type == MESSAGE) {
-			if (pocsag_state.address != last_address) {
-				// New message
-				console.writeln(console_info);
-				console.write(pocsag_state.output);
-				
-				last_address = pocsag_state.address;
-			} else {
-				// Message continues...
-				console.write(pocsag_state.output);
+			if (events & MessageDecoder::EVENT_ADDRESS) {
+				reception.address = decoder.address();
+				reception.function = decoder.function();
+				on_message_start(packet, reception);
+			}
+			if (events & MessageDecoder::EVENT_TEXT) {
+				on_message_text(decoder, reception);
 			}
-			
-			if (logger && logging)
-				logger->log_decoded(message->packet, to_string_dec_uint(pocsag_state.address) +
-													" F" + to_string_dec_uint(pocsag_state.function) +
-													" Alpha: " + pocsag_state.output);
 		}
+		
+		// Log what this batch had of a message that goes on in the next
+		if (decoder.active() && reception.has_text)
+			log_message(packet, reception);
 	}
 	
 	// Log raw data whatever it contains
 	if (logger && logging)
-		logger->log_raw_data(message->packet, target_frequency());
+		logger->log_raw_data(packet, target_frequency());
+}
+
+void POCSAGAppView::on_message_start(const pocsag::POCSAGPacket& packet, Reception& reception) {
+	reception.has_text = false;
+	reception.log_text.clear();
+	
+	// Ignore (no console, no log)
+	reception.ignored = ignore && (reception.address == sym_ignore.value_dec_u32());
+	if (reception.ignored)
+		return;
+	
+	std::string console_info;
+	
+	console_info = "\n" + to_string_datetime(packet.timestamp(), HM);
+	console_info += " " + pocsag::bitrate_str(packet.bitrate());
+	console_info += " ADDR:" + to_string_dec_uint(reception.address);
+	console_info += " F" + to_string_dec_uint(reception.function);
+	console.write(console_info);
+	
+	// Store last received address for POCSAG TX
+	persistent_memory::set_pocsag_last_address(reception.address);
+}
+
+void POCSAGAppView::on_message_text(pocsag::MessageDecoder& decoder, Reception& reception) {
+	std::array<char, 8> chars;
+	std::string text;
+	
+	// At most 3 characters a codeword
+	const auto count = decoder.read(chars.data(), chars.size());
+	for (size_t i = 0; i < count; i++)
+		text += pocsag::char_str(chars[i]);
+	
+	if (reception.ignored || text.empty())
+		return;
+	
+	// The text starts on the line after the address
+	if (!reception.has_text)
+		console.write("\n");
+	reception.has_text = true;
+	
+	console.write(text);
+	
+	if (logger && logging)
+		reception.log_text += text;
+}
+
+/* Once at the end of a message, and at the end of every batch it spans,
+ * so a log line never holds more than a batch of text.
+ */
+void POCSAGAppView::log_message(const pocsag::POCSAGPacket& packet, Reception& reception) {
+	if (reception.ignored || !logger || !logging)
+		return;
+	
+	const auto header = to_string_dec_uint(reception.address) + " F" + to_string_dec_uint(reception.function);
+	
+	if (!reception.has_text) {
+		logger->log_decoded(packet, header + " Address only");
+	} else if (!reception.log_text.empty()) {
+		logger->log_decoded(packet, header + " Alpha: " + reception.log_text);
+		reception.log_text.clear();
+	}
 }
 
 void POCSAGAppView::on_bitrate_changed(const uint32_t new_bitrate) {
-	baseband::set_pocsag(pocsag_bitrates[new_bitrate]);
+	// Past the fixed rates is "Auto"
+	baseband::set_pocsag((new_bitrate < 3) ? pocsag_bitrates[new_bitrate] : BitRate::UNKNOWN);
 }
 
 void POCSAGAppView::set_target_frequency(const uint32_t new_value) {
@@ -26,8 +26,10 @@
 #include "ui_widget.hpp"
 #include "ui_receiver.hpp"
 #include "ui_rssi.hpp"
+#include "ui_font_fixed_6x8.hpp"
 
 #include "log_file.hpp"
+#include "offline_decoder.hpp"
 
 #include "pocsag.hpp"
 #include "pocsag_packet.hpp"
@@ -59,11 +61,24 @@ public:
 
 private:
 	static constexpr uint32_t initial_target_frequency = 466175000;
+	static constexpr uint32_t sampling_rate = 3072000;
+
+	NavigationView& nav_;
 
 	bool logging { true };
 	bool ignore { false };
-	uint32_t last_address = 0xFFFFFFFF;
-	pocsag::POCSAGState pocsag_state { };
+	// What the console and log have of a rate's open message
+	struct Reception {
+		uint32_t address { 0 };
+		uint32_t function { 0 };
+		bool ignored { false };
+		bool has_text { false };
+		std::string log_text { };
+	};
+
+	// Baseband decodes all rates at once, messages are reassembled per rate
+	std::array<pocsag::MessageDecoder, 3> decoders { };
+	std::array<Reception, 3> receptions { };
 
 	RFAmpField field_rf_amp {
 		{ 13 * 8, 0 * 16 }
@@ -84,13 +99,20 @@ private:
 	FrequencyField field_frequency {
 		{ 0 * 8, 0 * 8 },
 	};
+
+	OfflineDecodeButton button_file {
+		nav_,
+		{ 10 * 8, 0 * 16, 3 * 8, 1 * 16 },
+		sampling_rate
+	};
 	OptionsField options_bitrate {
 		{ 12 * 8, 21 },
 		7,
 		{
 			{ "512bps ", 0 },
 			{ "1200bps", 1 },
-			{ "2400bps", 2 }
+			{ "2400bps", 2 },
+			{ "Auto   ", 3 }
 		}
 	};
 	Checkbox check_log {
@@ -112,6 +134,12 @@ private:
 		SymField::SYMFIELD_DEC
 	};
 
+	// Twice the lines of the 8x16 font.
+	const Style style_console {
+		.font = font::fixed_6x8,
+		.background = Color::black(),
+		.foreground = Color::white(),
+	};
 	Console console {
 		{ 0, 4 * 16, 240, 240 }
 	};
@@ -122,7 +150,10 @@ private:
 	
 	void update_freq(rf::Frequency f);
 
-	void on_packet(const POCSAGPacketMessage * message);
+	void on_packet(const pocsag::POCSAGPacket& packet);
+	void on_message_start(const pocsag::POCSAGPacket& packet, Reception& reception);
+	void on_message_text(pocsag::MessageDecoder& decoder, Reception& reception);
+	void log_message(const pocsag::POCSAGPacket& packet, Reception& reception);
 
 	void on_bitrate_changed(const uint32_t new_bitrate);
 
@@ -133,7 +164,8 @@ private:
 		Message::ID::POCSAGPacket,
 		[this](Message* const p) {
 			const auto message = static_cast<const POCSAGPacketMessage*>(p);
-			this->on_packet(message);
+			for (size_t i = 0; i < message->count; i++)
+				this->on_packet(message->packets[i]);
 		}
 	};
 };
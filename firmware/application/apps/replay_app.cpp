@@ -25,6 +25,7 @@
 
 #include "ui_fileman.hpp"
 #include "io_file.hpp"
+#include "capture_info.hpp"
 
 #include "baseband_api.hpp"
 #include "portapack.hpp"
@@ -34,62 +35,85 @@ using namespace portapack;
 
 namespace ui {
 
-void ReplayAppView::set_ready() {
-	ready_signal = true;
+/* Baseband upsamples files to at least 4MHz, by a power of two up to 64
+ * (CompensatedCICInterpolator::interpolation_max). Past 1MHz its half rate
+ * FIR would take too much of the M4, and files go out at their own rate.
+ */
+static size_t interpolation_for(const uint32_t sample_rate) {
+	size_t interpolation = 1;
+	if( sample_rate <= 1000000 ) {
+		while( (sample_rate * interpolation < 4000000) && (interpolation < 64) ) {
+			interpolation *= 2;
+		}
+	}
+	return interpolation;
 }
 
 void ReplayAppView::on_file_changed(std::filesystem::path new_file_path) {
-	File data_file, info_file;
-	char file_data[257];
-	
-	// Get file size
-	auto data_open_error = data_file.open("/" + new_file_path.string());
-	if (data_open_error.is_valid()) {
+	CaptureInfo info;
+	if( !read_capture_info(new_file_path, info) ) {
 		file_error();
 		return;
 	}
 	
-	file_path = new_file_path;
+	playlist = { new_file_path };
+	playlist_size = info.size;
+	sample_rate = info.sample_rate;
+	format = info.format;
+	if( info.center_frequency ) {
+		field_frequency.set_value(info.center_frequency);
+	}
+	update_playlist();
 	
-	// Get original record frequency if available
-	std::filesystem::path info_file_path = file_path;
-	info_file_path.replace_extension(u".TXT");
+	button_play.focus();
+}
+
+void ReplayAppView::on_file_added(std::filesystem::path new_file_path) {
+	if( playlist.empty() ) {
+		on_file_changed(new_file_path);
+		return;
+	}
 	
-	sample_rate = 500000;
+	CaptureInfo info;
+	if( !read_capture_info(new_file_path, info) ) {
+		file_error();
+		return;
+	}
 	
-	auto info_open_error = info_file.open("/" + info_file_path.string());
-	if (!info_open_error.is_valid()) {
-		memset(file_data, 0, 257);
-		auto read_size = info_file.read(file_data, 256);
-		if (!read_size.is_error()) {
-			auto pos1 = strstr(file_data, "center_frequency=");
-			if (pos1) {
-				pos1 += 17;
-				field_frequency.set_value(strtoll(pos1, nullptr, 10));
-			}
-			
-			auto pos2 = strstr(file_data, "sample_rate=");
-			if (pos2) {
-				pos2 += 12;
-				sample_rate = strtoll(pos2, nullptr, 10);
-			}
-		}
+	// Queued files play back to back as one stream, so they can't differ
+	// in anything baseband is configured for.
+	if( (info.sample_rate != sample_rate) || (info.format != format) ) {
+		nav_.display_modal("Error", "Sample rate or format\ndiffers from the first\nfile.");
+		return;
 	}
 	
+	playlist.push_back(new_file_path);
+	playlist_size += info.size;
+	update_playlist();
+}
+
+void ReplayAppView::update_playlist() {
 	text_sample_rate.set(unit_auto_scale(sample_rate, 3, 0) + "Hz");
 	
-	auto file_size = data_file.size();
-	auto duration = (file_size * 1000) / (2 * 2 * sample_rate);
+	auto duration = (playlist_size * 1000) / (sample_size() * sample_rate);
 	
-	progressbar.set_max(file_size);
-	text_filename.set(file_path.filename().string().substr(0, 12));
+	progressbar.set_max(playlist_size);
+	const auto name = playlist.front().filename().string();
+	if( playlist.size() > 1 ) {
+		text_filename.set(name.substr(0, 8) + " +" + to_string_dec_uint(playlist.size() - 1));
+	} else {
+		text_filename.set(name.substr(0, 12));
+	}
 	text_duration.set(to_string_time_ms(duration));
-	
-	button_play.focus();
+}
+
+size_t ReplayAppView::sample_size() const {
+	return (format == ReplayConfig::Format::C8) ? sizeof(complex8_t) : sizeof(complex16_t);
 }
 
 void ReplayAppView::on_tx_progress(const uint32_t progress) {
-	progressbar.set_value(progress);
+	// Looping goes on counting from the start of the first pass.
+	progressbar.set_value(playlist_size ? (progress % playlist_size) : progress);
 }
 
 void ReplayAppView::focus() {
@@ -115,34 +139,30 @@ void ReplayAppView::toggle() {
 void ReplayAppView::start() {
 	stop(false);
 
+	const size_t interpolation = interpolation_for(sample_rate);
 	std::unique_ptr<stream::Reader> reader;
-	
-	auto p = std::make_unique<FileReader>();
-	auto open_error = p->open(file_path);
-	if( open_error.is_valid() ) {
-		file_error();
-	} else {
-		reader = std::move(p);
+	if( !playlist.empty() ) {
+		reader = std::make_unique<PlaylistReader>(playlist, sample_size(), check_loop.value());
 	}
 
 	if( reader ) {
 		button_play.set_bitmap(&bitmap_stop);
-		baseband::set_sample_rate(sample_rate * 8);
+		baseband::set_sample_rate(sample_rate * interpolation, interpolation);
 		
 		replay_thread = std::make_unique<ReplayThread>(
 			std::move(reader),
 			read_size, buffer_count,
-			&ready_signal,
 			[](uint32_t return_code) {
 				ReplayThreadDoneMessage message { return_code };
 				EventDispatcher::send_message(message);
-			}
+			},
+			format
 		);
 	}
 	
 	radio::enable({
 		receiver_model.tuning_frequency(),
-		sample_rate * 8 ,
+		sample_rate * interpolation,
 		baseband_bandwidth,
 		rf::Direction::Transmit,
 		receiver_model.rf_amp(),
@@ -161,8 +181,6 @@ void ReplayAppView::stop(const bool do_loop) {
 		radio::disable();
 		button_play.set_bitmap(&bitmap_play);
 	}
-	
-	ready_signal = false;
 }
 
 void ReplayAppView::handle_replay_thread_done(const uint32_t return_code) {
@@ -185,6 +203,7 @@ ReplayAppView::ReplayAppView(
 	add_children({
 		&labels,
 		&button_open,
+		&button_add,
 		&text_filename,
 		&text_sample_rate,
 		&text_duration,
@@ -218,11 +237,18 @@ ReplayAppView::ReplayAppView(
 	};
 	
 	button_open.on_select = [this, &nav](Button&) {
-		auto new_view = nav.push<FileLoadView>(".C16");
+		auto new_view = nav.push<FileLoadView>(".C16|.C8|.RIQ");
 		new_view->on_changed = [this](std::filesystem::path new_file_path) {
 			on_file_changed(new_file_path);
 		};
 	};
+	
+	button_add.on_select = [this, &nav](Button&) {
+		auto new_view = nav.push<FileLoadView>(".C16|.C8|.RIQ");
+		new_view->on_changed = [this](std::filesystem::path new_file_path) {
+			on_file_added(new_file_path);
+		};
+	};
 }
 
 ReplayAppView::~ReplayAppView() {
@@ -31,6 +31,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace ui {
 
@@ -51,11 +52,15 @@ private:
 	static constexpr ui::Dim header_height = 3 * 16;
 	
 	uint32_t sample_rate = 0;
+	ReplayConfig::Format format { ReplayConfig::Format::C16 };
 	static constexpr uint32_t baseband_bandwidth = 2500000;
 	const size_t read_size { 16384 };
 	const size_t buffer_count { 3 };
 
 	void on_file_changed(std::filesystem::path new_file_path);
+	void on_file_added(std::filesystem::path new_file_path);
+	void update_playlist();
+	size_t sample_size() const;
 	void on_target_frequency_changed(rf::Frequency f);
 	void on_tx_progress(const uint32_t progress);
 	
@@ -66,22 +71,26 @@ private:
 	void start();
 	void stop(const bool do_loop);
 	bool is_active() const;
-	void set_ready();
 	void handle_replay_thread_done(const uint32_t return_code);
 	void file_error();
 
-	std::filesystem::path file_path { };
+	/* Played back to back; all share sample_rate and format. */
+	std::vector<std::filesystem::path> playlist { };
+	uint64_t playlist_size { 0 };
 	std::unique_ptr<ReplayThread> replay_thread { };
-	bool ready_signal { false };
 
 	Labels labels {
 		{ { 10 * 8, 2 * 16 }, "LNA:   A:", Color::light_grey() }
 	};
 	
 	Button button_open {
-		{ 0 * 8, 0 * 16, 10 * 8, 2 * 16 },
+		{ 0 * 8, 0 * 16, 10 * 8, 1 * 16 },
 		"Open file"
 	};
+	Button button_add {
+		{ 0 * 8, 1 * 16, 10 * 8, 1 * 16 },
+		"Add file"
+	};
 	
 	Text text_filename {
 		{ 11 * 8, 0 * 16, 12 * 8, 16 },
@@ -132,16 +141,6 @@ private:
 		}
 	};
 	
-	MessageHandlerRegistration message_handler_fifo_signal {
-		Message::ID::RequestSignal,
-		[this](const Message* const p) {
-			const auto message = static_cast<const RequestSignalMessage*>(p);
-			if (message->signal == RequestSignalMessage::Signal::FillRequest) {
-				this->set_ready();
-			}
-		}
-	};
-	
 	MessageHandlerRegistration message_handler_tx_progress {
 		Message::ID::TXProgress,
 		[this](const Message* const p) {
@@ -68,6 +68,12 @@ static std::string signal_type(SignalType signal_type) {
 } /* namespace tpms */
 
 void TPMSLogger::on_packet(const tpms::Packet& packet, const uint32_t target_frequency) {
+	if( log_file.is_binary() ) {
+		const uint32_t tag = (packet.signal_type() << 24) | ((target_frequency / 1000) & 0xffffff);
+		log_file.write_record(packet.received_at(), LogRecordType::TPMS, tag, packet.raw());
+		return;
+	}
+
 	const auto hex_formatted = packet.symbols_formatted();
 
 	// TODO: function doesn't take uint64_t, so when >= 1<<32, weirdness will ensue!
@@ -77,7 +83,7 @@ void TPMSLogger::on_packet(const tpms::Packet& packet, const uint32_t target_fre
 	log_file.write_entry(packet.received_at(), entry);
 }
 
-const TPMSRecentEntry::Key TPMSRecentEntry::invalid_key = { tpms::Reading::Type::None, 0 };
+const TPMSRecentEntry::Key TPMSRecentEntry::invalid_key { };
 
 void TPMSRecentEntry::update(const tpms::Reading& reading) {
 	received_count++;
@@ -132,7 +138,10 @@ void RecentEntriesTable<TPMSRecentEntries>::draw(
 	painter.draw_string(target_rect.location(), style, line);
 }
 
-TPMSAppView::TPMSAppView(NavigationView&) {
+TPMSAppView::TPMSAppView(
+	NavigationView& nav
+) : nav_ { nav }
+{
 	baseband::run_image(portapack::spi_flash::image_tag_tpms);
 
 	add_children({
@@ -142,6 +151,7 @@ TPMSAppView::TPMSAppView(NavigationView&) {
 		&field_rf_amp,
 		&field_lna,
 		&field_vga,
+		&button_file,
 		&recent_entries_view,
 	});
 
@@ -154,6 +164,7 @@ TPMSAppView::TPMSAppView(NavigationView&) {
 		static_cast<int8_t>(receiver_model.lna()),
 		static_cast<int8_t>(receiver_model.vga()),
 	});
+	receiver_model.set_gain_control(true);
 
 	options_band.on_change = [this](size_t, OptionsField::value_t v) {
 		this->on_band_changed(v);
@@ -167,6 +178,7 @@ TPMSAppView::TPMSAppView(NavigationView&) {
 }
 
 TPMSAppView::~TPMSAppView() {
+	receiver_model.set_gain_control(false);
 	radio::disable();
 
 	baseband::shutdown();
@@ -191,7 +203,7 @@ void TPMSAppView::on_packet(const tpms::Packet& packet) {
 		const auto reading = reading_opt.value();
 		auto& entry = ::on_packet(recent, TPMSRecentEntry::Key { reading.type(), reading.id() });
 		entry.update(reading);
-		recent_entries_view.set_dirty();
+		recent_entries_view.update();
 	}
 }
 
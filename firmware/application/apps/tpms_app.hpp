@@ -35,22 +35,41 @@
 #include "recent_entries.hpp"
 
 #include "tpms_packet.hpp"
+#include "offline_decoder.hpp"
 
-namespace std {
+struct TPMSKey {
+	tpms::Reading::Type type;
+	tpms::TransponderID id;
 
-constexpr bool operator==(const tpms::TransponderID& lhs, const tpms::TransponderID& rhs) {
-	return (lhs.value() == rhs.value());
-}
+	constexpr TPMSKey(
+		tpms::Reading::Type type = tpms::Reading::Type::None,
+		tpms::TransponderID id = 0
+	) : type { type },
+		id { id }
+	{
+	}
+
+	bool operator==(const TPMSKey& other) const {
+		return (type == other.type) && (id.value() == other.id.value());
+	}
 
-} /* namespace std */
+	bool operator!=(const TPMSKey& other) const {
+		return !(*this == other);
+	}
+
+	// Hash for HashIndex.
+	explicit operator uint32_t() const {
+		return id.value() ^ (static_cast<uint32_t>(type) << 28);
+	}
+};
 
 struct TPMSRecentEntry {
-	using Key = std::pair<tpms::Reading::Type, tpms::TransponderID>;
+	using Key = TPMSKey;
 
 	static const Key invalid_key;
 
-	tpms::Reading::Type type { invalid_key.first };
-	tpms::TransponderID id { invalid_key.second };
+	tpms::Reading::Type type { invalid_key.type };
+	tpms::TransponderID id { invalid_key.id };
 
 	size_t received_count { 0 };
 
@@ -60,8 +79,8 @@ struct TPMSRecentEntry {
 
 	TPMSRecentEntry(
 		const Key& key
-	) : type { key.first },
-		id { key.second }
+	) : type { key.type },
+		id { key.id }
 	{
 	}
 
@@ -72,12 +91,12 @@ struct TPMSRecentEntry {
 	void update(const tpms::Reading& reading);
 };
 
-using TPMSRecentEntries = RecentEntries<TPMSRecentEntry>;
+using TPMSRecentEntries = RecentEntries<TPMSRecentEntry, 64, HashIndex<TPMSRecentEntry::Key, 128>>;
 
 class TPMSLogger {
 public:
 	Optional<File::Error> append(const std::filesystem::path& filename) {
-		return log_file.append(filename);
+		return log_file.append_packets(filename);
 	}
 	
 	void on_packet(const tpms::Packet& packet, const uint32_t target_frequency);
@@ -110,6 +129,8 @@ private:
 	static constexpr uint32_t sampling_rate = 2457600;
 	static constexpr uint32_t baseband_bandwidth = 1750000;
 
+	NavigationView& nav_;
+
 	MessageHandlerRegistration message_handler_packet {
 		Message::ID::TPMSPacket,
 		[this](Message* const p) {
@@ -150,6 +171,12 @@ private:
 		{ 18 * 8, 0 * 16 }
 	};
 
+	OfflineDecodeButton button_file {
+		nav_,
+		{ 10 * 8, 0 * 16, 3 * 8, 1 * 16 },
+		sampling_rate
+	};
+
 	TPMSRecentEntries recent { };
 	std::unique_ptr<TPMSLogger> logger { };
 
@@ -23,7 +23,10 @@
 #include "ui_adsb_rx.hpp"
 #include "ui_alphanum.hpp"
 
+#include <cstring>
+
 #include "rtc_time.hpp"
+#include "sample_clock.hpp"
 #include "string_format.hpp"
 #include "baseband_api.hpp"
 #include "portapack_persistent_memory.hpp"
@@ -55,27 +58,45 @@ void RecentEntriesTable<AircraftRecentEntries>::draw(
 		target_color = Color::dark_grey();
 	}
 	
-	std::string entry_string = "\x1B";
+	// The position icon needs a 16 pixel row, compact rows get a marker.
+	const bool icon_fits = style.font.line_height() >= bitmap_target.size.height();
+	const bool marker = entry.pos.valid && !icon_fits;
+
+	// Redrawn for every row on every repaint, so built without the heap.
+	FixedString<48> entry_string;
+	entry_string += '\x1B';
 	entry_string += aged_color;
-	entry_string += to_string_hex(entry.ICAO_address, 6) + " " +
-		entry.callsign + "  " +
-		(entry.hits <= 999 ? to_string_dec_uint(entry.hits, 4) : "999+") + " " + 
-		entry.time_string;
+	entry_string.extend(to_string_hex(entry_string.end(), entry_string.available(), entry.ICAO_address, 6));
+	entry_string += ' ';
+	entry_string += entry.callsign.c_str();
+	entry_string += marker ? "* " : "  ";
+	if( entry.hits <= 999 ) {
+		entry_string.extend(to_string_dec_uint(entry_string.end(), entry_string.available(), entry.hits, 4));
+	} else {
+		entry_string += "999+";
+	}
+	entry_string += ' ';
+	entry_string += entry.time_string.c_str();
+	// Pad to the row width, past the two escape bytes, to overwrite what was there.
+	entry_string.resize(2 + target_rect.width() / style.font.char_width(), ' ');
 	
 	painter.draw_string(
 		target_rect.location(),
 		style,
-		entry_string
+		entry_string.c_str(),
+		entry_string.size()
 	);
 	
-	if (entry.pos.valid)
-		painter.draw_bitmap(target_rect.location() + Point(15 * 8, 0), bitmap_target, target_color, style.background);
+	if (entry.pos.valid && icon_fits)
+		painter.draw_bitmap(target_rect.location() + Point(15 * style.font.char_width(), 0), bitmap_target, target_color, style.background);
 }
 
-void ADSBLogger::log_str(std::string& logline) {
-	rtc::RTC datetime;
-	rtcGetTime(&RTCD1, &datetime);
-	log_file.write_entry(datetime,logline);
+void ADSBLogger::log_str(const rtc::RTC& datetime, const std::string& logline) {
+	log_file.write_entry(datetime, logline);
+}
+
+void ADSBLogger::log_frame(const rtc::RTC& datetime, const ADSBFrame& frame) {
+	log_file.write_record(datetime, LogRecordType::ADSB, 0, frame.get_raw_data(), 112);
 }
 
 void ADSBRxDetailsView::focus() {
@@ -91,7 +112,7 @@ void ADSBRxDetailsView::update(const AircraftRecentEntry& entry) {
 	else
 		text_last_seen.set(to_string_dec_uint(age / 60) + " minutes ago");
 	
-	text_infos.set(entry_copy.info_string);
+	text_infos.set(entry_copy.info_string());
 	
 	text_frame_pos_even.set(to_string_hex_array(entry_copy.frame_pos_even.get_raw_data(), 14));
 	text_frame_pos_odd.set(to_string_hex_array(entry_copy.frame_pos_odd.get_raw_data(), 14));
@@ -104,18 +125,83 @@ ADSBRxDetailsView::~ADSBRxDetailsView() {
 	on_close_();
 }
 
+/* airlines.db: a sorted table of up to 2048 4-byte ICAO airline codes,
+ * zero terminated, then at 0x2000 a 64-byte record (name, country) per
+ * code. See tools/adsb_db.py.
+ */
+static constexpr File::Offset airlines_db_records_offset = 0x2000;
+static constexpr size_t airlines_db_codes_max = airlines_db_records_offset / 4;
+
+// Most recently used first; the same few airlines tend to come up.
+static std::array<AirlineInfo, 4> airline_cache { };
+
+static bool read_airline_code(File& db_file, const size_t index, char (&code)[4]) {
+	return !db_file.seek(index * 4).is_error() && !db_file.read(code, 4).is_error();
+}
+
+static bool find_airline(File& db_file, const std::string& airline_code, AirlineInfo& info) {
+	char code[4] { 0 };
+	strncpy(code, airline_code.c_str(), 3);
+
+	for (size_t i = 0; i < airline_cache.size(); i++) {
+		if (airline_cache[i].code[0] && !strncmp(airline_cache[i].code, code, 4)) {
+			info = airline_cache[i];
+			std::copy_backward(&airline_cache[0], &airline_cache[i], &airline_cache[i + 1]);
+			airline_cache[0] = info;
+			return true;
+		}
+	}
+
+	// Binary search, the terminator and anything after it sorting last.
+	size_t lo = 0;
+	size_t hi = airlines_db_codes_max;
+	bool found = false;
+	while (lo < hi) {
+		const size_t mid = (lo + hi) / 2;
+		char probe[4];
+		if (!read_airline_code(db_file, mid, probe))
+			return false;
+		
+		const int order = probe[0] ? strncmp(probe, code, 4) : 1;
+		if (order == 0) {
+			lo = mid;
+			found = true;
+			break;
+		} else if (order < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (!found)
+		return false;
+
+	memcpy(info.code, code, sizeof(info.code));
+	if (db_file.seek(airlines_db_records_offset + (lo << 6)).is_error() ||
+		db_file.read(info.airline, sizeof(info.airline)).is_error() ||
+		db_file.read(info.country, sizeof(info.country)).is_error())
+		return false;
+	info.airline[sizeof(info.airline) - 1] = 0;
+	info.country[sizeof(info.country) - 1] = 0;
+
+	std::copy_backward(&airline_cache[0], &airline_cache[airline_cache.size() - 1], &airline_cache[airline_cache.size()]);
+	airline_cache[0] = info;
+	return true;
+}
+
 ADSBRxDetailsView::ADSBRxDetailsView(
 	NavigationView& nav,
 	const AircraftRecentEntry& entry,
+	const GeoMarkers* const markers,
+	const GeoTracks* const tracks,
+	std::function<std::string(GeoMarkers::Id)> marker_label,
 	const std::function<void(void)> on_close
 ) : entry_copy(entry),
+	markers(markers),
+	tracks(tracks),
+	marker_label(marker_label),
 	on_close_(on_close)
 {
-	char file_buffer[32] { 0 };
-	bool found = false;
-	std::string airline_code;
-	size_t c;
-	
 	add_children({
 		&labels,
 		&text_callsign,
@@ -135,25 +221,10 @@ ADSBRxDetailsView::ADSBRxDetailsView(
 	// Try getting the airline's name from airlines.db
 	auto result = db_file.open("ADSB/airlines.db");
 	if (!result.is_valid()) {
-		// Search for 3-letter code in 0x0000~0x2000
-		airline_code = entry_copy.callsign.substr(0, 3);
-		c = 0;
-		do {
-			db_file.read(file_buffer, 4);
-			if (!file_buffer[0])
-				break;
-			if (!airline_code.compare(0, 4, file_buffer))
-				found = true;
-			else
-				c++;
-		} while (!found);
-		
-		if (found) {
-			db_file.seek(0x2000 + (c << 6));
-			db_file.read(file_buffer, 32);
-			text_airline.set(file_buffer);
-			db_file.read(file_buffer, 32);
-			text_country.set(file_buffer);
+		AirlineInfo info;
+		if (find_airline(db_file, entry_copy.callsign.substr(0, 3), info)) {
+			text_airline.set(info.airline);
+			text_country.set(info.country);
 		} else {
 			text_airline.set("Unknown");
 			text_country.set("Unknown");
@@ -176,6 +247,8 @@ ADSBRxDetailsView::ADSBRxDetailsView(
 			[this]() {
 				send_updates = false;
 			});
+		geomap_view->set_markers(this->markers, this->marker_label);
+		geomap_view->set_tracks(this->tracks);
 		send_updates = true;
 	};
 };
@@ -190,14 +263,12 @@ ADSBRxView::~ADSBRxView() {
 	baseband::shutdown();
 }
 
-void ADSBRxView::on_frame(const ADSBFrameMessage * message) {
+void ADSBRxView::on_frame(ADSBFrame frame) {
 	rtc::RTC datetime;
 	std::string str_timestamp;
 	std::string callsign;
-	std::string str_info;
 	std::string logentry;
 
-	auto frame = message->frame;
 	uint32_t ICAO_address = frame.get_ICAO_address();
 	
 	if (frame.check_CRC() && frame.get_ICAO_address()) {
@@ -209,8 +280,11 @@ void ADSBRxView::on_frame(const ADSBFrameMessage * message) {
 		entry.set_time_string(str_timestamp);
 
 		entry.inc_hit();
-		logentry += to_string_hex_array(frame.get_raw_data(), 14) + " ";
-		logentry += "ICAO:" + to_string_hex(ICAO_address, 6) + " ";
+		const bool log_text = logger && !logger->is_binary();
+		if (log_text) {
+			logentry += to_string_hex_array(frame.get_raw_data(), 14) + " ";
+			logentry += "ICAO:" + to_string_hex(ICAO_address, 6) + " ";
+		}
 		
 		if (frame.get_DF() == DF_ADSB) {
 			uint8_t msg_type = frame.get_msg_type();
@@ -219,40 +293,49 @@ void ADSBRxView::on_frame(const ADSBFrameMessage * message) {
 			if ((msg_type >= 1) && (msg_type <= 4)) {
 				callsign = decode_frame_id(frame);
 				entry.set_callsign(callsign);
-				logentry+=callsign+" ";
+				if (log_text)
+					logentry+=callsign+" ";
 			} else if ((msg_type >= 9) && (msg_type <= 18)) {
 				entry.set_frame_pos(frame, raw_data[6] & 4);
 				
 				if (entry.pos.valid) {
-					str_info = "Alt:" + to_string_dec_uint(entry.pos.altitude) +
-						" Lat" + to_string_dec_int(entry.pos.latitude) +
-						"." + to_string_dec_int((int)(entry.pos.latitude * 1000) % 100) +
-						" Lon" + to_string_dec_int(entry.pos.longitude) +
-						"." + to_string_dec_int((int)(entry.pos.longitude * 1000) % 100);
+					markers.update(ICAO_address, entry.pos.latitude, entry.pos.longitude);
+					tracks.add(ICAO_address, entry.pos.latitude, entry.pos.longitude);
 					
-					entry.set_info_string(str_info);
-					logentry+=str_info+ " ";
+					if (log_text)
+						logentry+=entry.info_string()+ " ";
 
 					if (send_updates)
 						details_view->update(entry);
 				}
 			}
 		}
-		recent_entries_view.set_dirty(); 
+		recent_entries_view.update();
 		
-		logger = std::make_unique<ADSBLogger>();
-        if (logger) {
-                logger->append(u"adsb.txt");
-                // will log each frame in format:
-                // 20171103100227 8DADBEEFDEADBEEFDEADBEEFDEADBEEF ICAO:nnnnnn callsign Alt:nnnnnn Latnnn.nn Lonnnn.nn
-				logger->log_str(logentry);
-        }
+		if (logger) {
+			if (logger->is_binary()) {
+				logger->log_frame(datetime, frame);
+			} else {
+				// will log each frame in format:
+				// 20171103100227 8DADBEEFDEADBEEFDEADBEEFDEADBEEF ICAO:nnnnnn callsign Alt:nnnnnn Latnnn.nn Lonnnn.nn
+				sample_clock::Time time;
+				if( sample_clock::time(frame.get_sample_index(), time) ) {
+					logentry += " us=" + to_string_dec_uint(time.microseconds, 6, '0');
+					logger->log_str(time.datetime, logentry);
+				} else {
+					logger->log_str(datetime, logentry);
+				}
+			}
+		}
 	}
 }
 
 void ADSBRxView::on_tick_second() {
+	markers.tick();
+	
 	// Decay and refresh if needed
-	for (auto& entry : recent) {
+	for (auto it = recent.begin(); it != recent.end(); ) {
+		auto& entry = *it;
 		entry.inc_age();
 		
 		if (details_view) {
@@ -260,13 +343,28 @@ void ADSBRxView::on_tick_second() {
 				details_view->update(entry);
 		} else {
 			if ((entry.age == ADSB_DECAY_A) || (entry.age == ADSB_DECAY_B))
-				recent_entries_view.set_dirty();
+				recent_entries_view.update();
+		}
+		
+		// The details view keeps its own copy, so it's safe to drop here.
+		if (entry.age >= ADSB_DECAY_C) {
+			markers.remove(entry.key());
+			tracks.remove(entry.key());
+			it = recent.erase(it);
+			recent_entries_view.update();
+		} else {
+			it++;
 		}
 	}
 }
 
 ADSBRxView::ADSBRxView(NavigationView& nav) {
 	baseband::run_image(portapack::spi_flash::image_tag_adsb_rx);
+	
+	logger = std::make_unique<ADSBLogger>();
+	if (logger)
+		logger->append(u"adsb.txt");
+	
 	add_children({
 		&labels,
 		&field_lna,
@@ -276,11 +374,21 @@ ADSBRxView::ADSBRxView(NavigationView& nav) {
 		&recent_entries_view
 	});
 	
+	recent_entries_view.set_style(&style_compact);
 	recent_entries_view.set_parent_rect({ 0, 16, 240, 272 });
 	recent_entries_view.on_select = [this, &nav](const AircraftRecentEntry& entry) {
 		detailed_entry_key = entry.key();
 		details_view = nav.push<ADSBRxDetailsView>(
 			entry,
+			&markers,
+			&tracks,
+			[this](const GeoMarkers::Id id) {
+				// Callsigns come in their own frames, some aircraft never send one
+				const auto found = find(recent, id);
+				if ((found != recent.end()) && (found->callsign[0] != ' '))
+					return found->callsign;
+				return to_string_hex(id, 6);
+			},
 			[this]() {
 				send_updates = false;
 			});
@@ -300,6 +408,7 @@ ADSBRxView::ADSBRxView(NavigationView& nav) {
 	receiver_model.set_sampling_rate(2000000);
 	receiver_model.set_baseband_bandwidth(2500000);
 	receiver_model.enable();
+	receiver_model.set_gain_control(true);
 }
 
 } /* namespace ui */
@@ -25,12 +25,14 @@
 #include "ui_receiver.hpp"
 #include "ui_geomap.hpp"
 #include "ui_font_fixed_8x16.hpp"
+#include "ui_font_fixed_6x8.hpp"
 
 #include "file.hpp"
 #include "recent_entries.hpp"
 #include "log_file.hpp"
 #include "adsb.hpp"
 #include "message.hpp"
+#include "string_format.hpp"
 
 using namespace adsb;
 
@@ -38,7 +40,7 @@ namespace ui {
 
 #define ADSB_DECAY_A 10		// In seconds
 #define ADSB_DECAY_B 30
-#define ADSB_DECAY_C 60		// Can be used for removing old entries, RecentEntries already caps to 64
+#define ADSB_DECAY_C 60		// Aircraft not heard from for this long are removed
 
 struct AircraftRecentEntry {
 	using Key = uint32_t;
@@ -49,13 +51,16 @@ struct AircraftRecentEntry {
 	uint16_t hits { 0 };
 	uint32_t age { 0 };
 	adsb_pos pos { false, 0, 0, 0 };
+	cpr_fix cpr_reference { false, 0, 0 };
+	uint8_t cpr_local_count { 0 };
+	
+	static constexpr uint8_t cpr_local_max = 32;
 	
 	ADSBFrame frame_pos_even { };
 	ADSBFrame frame_pos_odd { };
 	
 	std::string callsign { "        " };
 	std::string time_string { "" };
-	std::string info_string { "" };
 	
 	AircraftRecentEntry(
 		const uint32_t ICAO_address
@@ -81,14 +86,31 @@ struct AircraftRecentEntry {
 		else
 			frame_pos_odd = frame;
 		
-		if (!frame_pos_even.empty() && !frame_pos_odd.empty()) {
-			if (abs(frame_pos_even.get_rx_timestamp() - frame_pos_odd.get_rx_timestamp()) < 20)
-				pos = decode_frame_pos(frame_pos_even, frame_pos_odd);
+		const bool pair = !frame_pos_even.empty() && !frame_pos_odd.empty() &&
+			(abs(frame_pos_even.get_rx_timestamp() - frame_pos_odd.get_rx_timestamp()) < 20);
+		
+		// Once there's a fix, each frame decodes on its own from the last
+		// position. A fresh pair still re-anchors it now and then, so one bad
+		// frame can't lead the track astray for good.
+		if (pair && (!cpr_reference.valid || (cpr_local_count >= cpr_local_max))) {
+			pos = decode_frame_pos(frame_pos_even, frame_pos_odd, cpr_reference);
+			if (pos.valid)
+				cpr_local_count = 0;
+		} else if (cpr_reference.valid) {
+			pos = decode_frame_pos_local(frame, parity != 0, cpr_reference);
+			cpr_local_count++;
 		}
 	}
 	
-	void set_info_string(std::string& new_info_string) {
-		info_string = new_info_string;
+	std::string info_string() const {
+		if (!pos.valid)
+			return "";
+		
+		return "Alt:" + to_string_dec_uint(pos.altitude) +
+			" Lat" + to_string_dec_int(pos.latitude) +
+			"." + to_string_dec_int((int)(pos.latitude * 1000) % 100) +
+			" Lon" + to_string_dec_int(pos.longitude) +
+			"." + to_string_dec_int((int)(pos.longitude * 1000) % 100);
 	}
 	
 	void set_time_string(std::string& new_time_string) {
@@ -104,14 +126,24 @@ struct AircraftRecentEntry {
 	}
 };
 
-using AircraftRecentEntries = RecentEntries<AircraftRecentEntry>;
+// A few KB of slots, and hashed, as busy airspace easily tops 64 aircraft.
+using AircraftRecentEntries = RecentEntries<AircraftRecentEntry, 128, HashIndex<AircraftRecentEntry::Key, 256>>;
+
+struct AirlineInfo {
+	char code[4];
+	char airline[32];
+	char country[32];
+};
 
 class ADSBLogger {
 public:
 	Optional<File::Error> append(const std::filesystem::path& filename) {
-		return log_file.append(filename);
+		return log_file.append_packets(filename);
 	}
-	void log_str(std::string& logline);
+	void log_str(const rtc::RTC& datetime, const std::string& logline);
+	void log_frame(const rtc::RTC& datetime, const ADSBFrame& frame);
+
+	bool is_binary() const { return log_file.is_binary(); }
 
 private:
 	LogFile log_file { };
@@ -120,7 +152,14 @@ private:
 
 class ADSBRxDetailsView : public View {
 public:
-	ADSBRxDetailsView(NavigationView&, const AircraftRecentEntry& entry, const std::function<void(void)> on_close);
+	ADSBRxDetailsView(
+		NavigationView&,
+		const AircraftRecentEntry& entry,
+		const GeoMarkers* const markers,
+		const GeoTracks* const tracks,
+		std::function<std::string(GeoMarkers::Id)> marker_label,
+		const std::function<void(void)> on_close
+	);
 	~ADSBRxDetailsView();
 
 	ADSBRxDetailsView(const ADSBRxDetailsView&) = delete;
@@ -136,6 +175,9 @@ public:
 	
 private:
 	AircraftRecentEntry entry_copy { 0 };
+	const GeoMarkers* const markers;
+	const GeoTracks* const tracks;
+	std::function<std::string(GeoMarkers::Id)> marker_label;
 	std::function<void(void)> on_close_ { };
 	GeoMapView* geomap_view { nullptr };
 	bool send_updates { false };
@@ -205,7 +247,7 @@ public:
 
 private:
 	std::unique_ptr<ADSBLogger> logger { };
-	void on_frame(const ADSBFrameMessage * message);
+	void on_frame(ADSBFrame frame);
 	void on_tick_second();
 	
 	const RecentEntriesColumns columns { {
@@ -214,8 +256,17 @@ private:
 		{ "Hits", 4 },
 		{ "Time", 8 }
 	} };
+	// Twice the rows of the 8x16 font.
+	const Style style_compact {
+		.font = font::fixed_6x8,
+		.background = Color::black(),
+		.foreground = Color::white(),
+	};
 	AircraftRecentEntries recent { };
-	RecentEntriesView<RecentEntries<AircraftRecentEntry>> recent_entries_view { columns, recent };
+	// Every aircraft with a position, for the map, and where the latest were.
+	GeoMarkers markers { };
+	GeoTrackStore<32, 16> tracks { };
+	RecentEntriesView<AircraftRecentEntries> recent_entries_view { columns, recent };
 	
 	SignalToken signal_token_tick_second { };
 	ADSBRxDetailsView* details_view { nullptr };
@@ -246,7 +297,8 @@ private:
 		Message::ID::ADSBFrame,
 		[this](Message* const p) {
 			const auto message = static_cast<const ADSBFrameMessage*>(p);
-			this->on_frame(message);
+			for (size_t i = 0; i < message->count; i++)
+				this->on_frame(message->packets[i]);
 		}
 	};
 };
@@ -224,6 +224,7 @@ ADSBTXThread::~ADSBTXThread() {
 }
 
 msg_t ADSBTXThread::static_fn(void* arg) {
+	chRegSetThreadName("adsbtx");
 	auto obj = static_cast<ADSBTXThread*>(arg);
 	obj->run();
 	return 0;
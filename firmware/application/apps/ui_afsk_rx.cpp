@@ -24,6 +24,7 @@
 #include "ui_modemsetup.hpp"
 
 #include "modems.hpp"
+#include "aprs.hpp"
 #include "audio.hpp"
 #include "rtc_time.hpp"
 #include "baseband_api.hpp"
@@ -62,6 +63,8 @@ AFSKRxView::AFSKRxView(NavigationView& nav) {
 		&field_frequency,
 		&text_debug,
 		&button_modem_setup,
+		&options_mode,
+		&button_see_map,
 		&record_view,
 		&console
 	});
@@ -76,6 +79,8 @@ AFSKRxView::AFSKRxView(NavigationView& nav) {
 	update_freq(467225500);	// 462713300
 	auto def_bell202 = &modem_defs[0];
 	persistent_memory::set_modem_baudrate(def_bell202->baudrate);
+	persistent_memory::set_afsk_mark(def_bell202->mark_freq);
+	persistent_memory::set_afsk_space(def_bell202->space_freq);
 	serial_format_t serial_format;
 	serial_format.data_bits = 7;
 	serial_format.parity = EVEN;
@@ -100,12 +105,32 @@ AFSKRxView::AFSKRxView(NavigationView& nav) {
 		nav.push<ModemSetupView>();
 	};
 	
+	options_mode.on_change = [this](size_t, int32_t v) {
+		set_mode(v == 1);
+	};
+	
+	button_see_map.hidden(true);
+	button_see_map.on_select = [this, &nav](Button&) {
+		geomap_view = nav.push<GeoMapView>(
+			map_callsign,
+			0,
+			GeoPos::alt_unit::METERS,
+			map_lat,
+			map_lon,
+			0,
+			[this]() {
+				send_updates = false;
+			});
+		send_updates = true;
+	};
+	
 	logger = std::make_unique<AFSKLogger>();
 	if (logger)
 		logger->append("AFSK_LOG.TXT");
 	
 	// Auto-configure modem for LCR RX (will be removed later)
-	baseband::set_afsk(persistent_memory::modem_baudrate(), 8, 0, false);
+	baseband::set_afsk(persistent_memory::modem_baudrate(), persistent_memory::afsk_mark_freq(),
+		persistent_memory::afsk_space_freq(), 8, 0, false);
 	
 	audio::set_rate(audio::Rate::Hz_24000);
 	audio::output::start();
@@ -116,6 +141,48 @@ AFSKRxView::AFSKRxView(NavigationView& nav) {
 	receiver_model.enable();
 }
 
+void AFSKRxView::set_mode(const bool aprs) {
+	if (aprs) {
+		update_freq(aprs_frequency);
+		field_frequency.set_value(aprs_frequency);
+		baseband::set_ax25();
+	} else {
+		baseband::set_afsk(persistent_memory::modem_baudrate(), persistent_memory::afsk_mark_freq(),
+			persistent_memory::afsk_space_freq(), 8, 0, false);
+	}
+	button_modem_setup.hidden(aprs);
+	set_dirty();
+}
+
+void AFSKRxView::on_packet(const ax25::Packet& packet) {
+	const auto source = packet.source();
+	std::string str_packet = source + ">" + packet.destination();
+	
+	if (!packet.path().empty())
+		str_packet += "," + packet.path();
+	
+	const auto info = packet.info();
+	str_packet += ":" + info;
+	
+	console.writeln(str_packet);
+	
+	if (logger) logger->log_raw_data(str_packet);
+	
+	aprs::aprs_position position;
+	if (aprs::decode_position(info, position)) {
+		if (send_updates && (source == map_callsign))
+			geomap_view->update_position(position.latitude, position.longitude);
+		
+		if (!send_updates) {
+			map_callsign = source;
+			map_lat = position.latitude;
+			map_lon = position.longitude;
+			button_see_map.hidden(false);
+			set_dirty();
+		}
+	}
+}
+
 void AFSKRxView::on_data(uint32_t value, bool is_data) {
 	std::string str_console = "\x1B";
 	std::string str_byte = "";
@@ -26,6 +26,7 @@
 #include "ui.hpp"
 #include "ui_navigation.hpp"
 #include "ui_receiver.hpp"
+#include "ui_geomap.hpp"
 #include "ui_record_view.hpp"	// DEBUG
 
 #include "log_file.hpp"
@@ -56,6 +57,17 @@ public:
 	
 private:
 	void on_data(uint32_t value, bool is_data);
+	void on_packet(const ax25::Packet& packet);
+	void set_mode(const bool aprs);
+	
+	static constexpr rf::Frequency aprs_frequency = 144390000;
+	
+	GeoMapView* geomap_view { nullptr };
+	bool send_updates { false };
+	// Last station heard with a position
+	std::string map_callsign { };
+	float map_lat { 0 };
+	float map_lon { 0 };
 	
 	uint8_t console_color { 0 };
 	uint32_t prev_value { 0 };
@@ -92,6 +104,20 @@ private:
 		"Modem setup"
 	};
 	
+	OptionsField options_mode {
+		{ 0 * 8, 2 * 16 },
+		5,
+		{
+			{ "Modem", 0 },
+			{ "APRS ", 1 }
+		}
+	};
+	
+	Button button_see_map {
+		{ 25 * 8, 1 * 16, 5 * 8, 24 },
+		"Map"
+	};
+	
 	// DEBUG
 	RecordView record_view {
 		{ 0 * 8, 3 * 16, 30 * 8, 1 * 16 },
@@ -114,6 +140,14 @@ private:
 			this->on_data(message->value, message->is_data);
 		}
 	};
+	
+	MessageHandlerRegistration message_handler_ax25 {
+		Message::ID::AX25Packet,
+		[this](Message* const p) {
+			const auto message = static_cast<const AX25PacketMessage*>(p);
+			this->on_packet(message->packet);
+		}
+	};
 };
 
 } /* namespace ui */
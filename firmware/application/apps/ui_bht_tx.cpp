@@ -59,7 +59,7 @@ void BHTView::start_tx() {
 		for (size_t c = 0; c < ccir_deltas.size(); c++)
 			baseband::set_tone(c, ccir_deltas[c], XY_TONE_DURATION);
 		
-		baseband::set_tones_config(transmitter_model.channel_bandwidth(), XY_SILENCE, XY_TONE_COUNT, false, false);
+		baseband::set_tones_config(transmitter_model.channel_bandwidth(), XY_SILENCE, false, false);
 		
 	} else if (target_system == EPAR) {
 		
@@ -22,13 +22,23 @@
 #include "ui_debug.hpp"
 
 #include "ch.h"
+#include "chibios_cpp.hpp"
 
 #include "radio.hpp"
+#include "baseband_api.hpp"
 #include "string_format.hpp"
+#include "rtc_time.hpp"
 
 #include "audio.hpp"
+#include "core_control.hpp"
+#include "memory_map.hpp"
+#include "thread_registry.hpp"
+#include "trace_file.hpp"
 
-// #include "ui_sd_card_debug.hpp"
+#include <cstring>
+#include <algorithm>
+
+#include "ui_sd_card_debug.hpp"
 
 namespace ui {
 
@@ -36,28 +46,708 @@ namespace ui {
 
 DebugMemoryView::DebugMemoryView(NavigationView& nav) {
 	add_children({
-		&text_title,
-		&text_label_m0_core_free,
-		&text_label_m0_core_free_value,
-		&text_label_m0_heap_fragmented_free,
-		&text_label_m0_heap_fragmented_free_value,
-		&text_label_m0_heap_fragments,
-		&text_label_m0_heap_fragments_value,
+		&memory_map,
+		&text_core_free,
+		&text_heap_high_water,
+		&text_heap_free,
+		&text_arenas,
+		&heap_histogram,
 		&button_done
 	});
 
-	const auto m0_core_free = chCoreStatus();
-	text_label_m0_core_free_value.set(to_string_dec_uint(m0_core_free, 5));
+	button_done.on_select = [&nav](Button&){ nav.pop(); };
+
+	signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+		this->update();
+	};
+
+	update();
+}
+
+DebugMemoryView::~DebugMemoryView() {
+	rtc_time::signal_tick_second -= signal_token_tick_second;
+}
+
+void DebugMemoryView::update() {
+	text_core_free.set("M0 Core Free Bytes  " + to_string_dec_uint(chCoreStatus(), 6));
+	text_heap_high_water.set("M0 Heap High-Water  " + to_string_dec_uint(chibios::heap_high_water(), 6));
 
 	size_t m0_fragmented_free_space = 0;
 	const auto m0_fragments = chHeapStatus(NULL, &m0_fragmented_free_space);
-	text_label_m0_heap_fragmented_free_value.set(to_string_dec_uint(m0_fragmented_free_space, 5));
-	text_label_m0_heap_fragments_value.set(to_string_dec_uint(m0_fragments, 5));
+	text_heap_free.set(
+		"M0 Heap Free " + to_string_dec_uint(m0_fragmented_free_space, 6) +
+		" in " + to_string_dec_uint(m0_fragments)
+	);
+
+	// Every view on the navigation stack has one, this one included.
+	text_arenas.set(
+		"Arenas " + to_string_dec_uint(chibios::Arena::count()) + ", " +
+		to_string_dec_uint(chibios::Arena::total_used()) + "/" +
+		to_string_dec_uint(chibios::Arena::total_size()) + " used"
+	);
+
+	memory_map.set_dirty();
+	heap_histogram.set_dirty();
+}
+
+void DebugMemoryView::focus() {
+	button_done.focus();
+}
+
+/* MemoryMapWidget *******************************************************/
+
+namespace {
+
+struct MapRow {
+	const char* name;
+	portapack::memory::region_t region;
+};
+
+constexpr std::array<MapRow, 5> map_rows { {
+	{ "LS0",	portapack::memory::map::local_sram_0 },
+	{ "LS1",	portapack::memory::map::local_sram_1 },
+	{ "AHB0",	portapack::memory::map::ahb_ram_0 },
+	{ "AHB1",	portapack::memory::map::ahb_ram_1 },
+	{ "AHB2",	portapack::memory::map::ahb_ram_2 },
+} };
+
+struct MapLegend {
+	const char* name;
+	Color color;
+};
+
+constexpr std::array<MapLegend, 8> map_legend { {
+	{ "M4 img",	Color::orange() },
+	{ "Shared",	Color::magenta() },
+	{ "Stacks",	Color::yellow() },
+	{ "Data",	Color::cyan() },
+	{ "Heap",	Color::blue() },
+	{ "Free",	Color::green() },
+	{ "Core",	Color::dark_green() },
+	{ "Other",	Color::dark_grey() },
+} };
+
+constexpr Color color_m4_image = map_legend[0].color;
+constexpr Color color_shared = map_legend[1].color;
+constexpr Color color_stacks = map_legend[2].color;
+constexpr Color color_data = map_legend[3].color;
+constexpr Color color_heap = map_legend[4].color;
+constexpr Color color_free = map_legend[5].color;
+constexpr Color color_core = map_legend[6].color;
+constexpr Color color_other = map_legend[7].color;
+
+} /* namespace */
+
+void MemoryMapWidget::paint(Painter& painter) {
+	const auto r = screen_rect();
+	painter.fill_rectangle(r, style().background);
+
+	for(size_t i=0; i<map_rows.size(); i++) {
+		const Coord y = r.top() + i * row_height;
+		painter.draw_string({ r.left(), y }, style(), map_rows[i].name);
+		painter.fill_rectangle({ r.left() + bar_left, y + 2, bar_width, row_height - 4 }, color_other);
+	}
+
+	// Later ranges paint over earlier ones.
+	const auto draw = [&painter, &r](const uint32_t base, const uint32_t end, const Color color) {
+		for(size_t i=0; i<map_rows.size(); i++) {
+			const auto& region = map_rows[i].region;
+			const auto b = std::max(base, region.base());
+			const auto e = std::min(end, region.end());
+			if( b < e ) {
+				const Coord x0 = (b - region.base()) * bar_width / region.size();
+				const Coord x1 = std::max<Coord>(x0 + 1, (e - region.base()) * bar_width / region.size());
+				const Coord y = r.top() + i * row_height;
+				painter.fill_rectangle({ r.left() + bar_left + x0, y + 2, x1 - x0, row_height - 4 }, color);
+			}
+		}
+	};
+
+	const auto draw_layout = [&draw](const chibios::RAMLayout& layout) {
+		if( layout.heap_end == 0 ) {
+			return;
+		}
+		draw(layout.stacks_base, layout.stacks_end, color_stacks);
+		draw(layout.data_base, layout.bss_end, color_data);
+		draw(layout.heap_base, layout.heap_end - layout.core_free, color_heap);
+		draw(layout.heap_end - layout.core_free, layout.heap_end, color_core);
+	};
+
+	using namespace portapack::memory;
+
+	draw(map::m4_code.base(), map::m4_code.base() + m4_image_size(), color_m4_image);
+	draw(map::shared_memory.base(), map::shared_memory.base() + sizeof(SharedMemory), color_shared);
+	draw_layout(shared_memory.m4_ram_layout);
+	draw_layout(chibios::ram_layout());
+
+	std::array<chibios::HeapBlock, blocks_max> blocks;
+	const auto blocks_count = std::min(chibios::heap_free_blocks(blocks.data(), blocks.size()), blocks.size());
+	for(size_t i=0; i<blocks_count; i++) {
+		draw(blocks[i].base, blocks[i].base + blocks[i].size, color_free);
+	}
+
+	// Thread working areas are heap blocks too.
+	std::array<thread_registry::Statistics, 8> threads;
+	const auto threads_count = thread_registry::capture(threads.data(), threads.size());
+	for(size_t i=0; i<threads_count; i++) {
+		if( threads[i].heap ) {
+			draw(threads[i].id, threads[i].id + threads[i].heap, color_stacks);
+		}
+	}
+
+	const Coord legend_top = r.top() + map_rows.size() * row_height + 4;
+	for(size_t i=0; i<map_legend.size(); i++) {
+		const Point p {
+			r.left() + static_cast<Coord>((i % 4) * legend_slot_width),
+			legend_top + static_cast<Coord>((i / 4) * row_height)
+		};
+		painter.fill_rectangle({ p.x(), p.y() + 4, 8, 8 }, map_legend[i].color);
+		painter.draw_string({ p.x() + 10, p.y() }, style(), map_legend[i].name);
+	}
+}
+
+/* HeapHistogramWidget ***************************************************/
+
+void HeapHistogramWidget::paint(Painter& painter) {
+	static constexpr std::array<const char*, bins> labels { {
+		"16", "32", "64", "128", "256", "512", "1K", "2K", "4K", "8K+"
+	} };
+
+	std::array<chibios::HeapBlock, blocks_max> blocks;
+	const auto count = std::min(chibios::heap_free_blocks(blocks.data(), blocks.size()), blocks.size());
+
+	std::array<uint32_t, bins> histogram { };
+	for(size_t i=0; i<count; i++) {
+		size_t bin = 0;
+		while( (bin < (bins - 1)) && (blocks[i].size >= (bin_min << (bin + 1))) ) {
+			bin++;
+		}
+		histogram[bin]++;
+	}
+	const auto peak = std::max<uint32_t>(*std::max_element(histogram.begin(), histogram.end()), 1);
+
+	const auto r = screen_rect();
+	painter.fill_rectangle(r, style().background);
+
+	for(size_t i=0; i<bins; i++) {
+		const Coord x = r.left() + i * bin_width;
+		const Coord bottom = r.top() + 16 + bar_height_max;
+		const Dim height = histogram[i] * bar_height_max / peak;
+		if( histogram[i] ) {
+			painter.draw_string({ x, r.top() }, style(), to_string_dec_uint(histogram[i]));
+		}
+		painter.fill_rectangle({ x + 2, bottom - height, bin_width - 4, height }, color_free);
+		painter.draw_string({ x, bottom }, style(), labels[i]);
+	}
+}
+
+/* BasebandProfileView ***************************************************/
+
+BasebandProfileView::BasebandProfileView(NavigationView& nav) {
+	add_children({
+		&text_title,
+		&text_header,
+		&button_reset,
+		&button_done
+	});
+
+	for(size_t i=0; i<text_stages.size(); i++) {
+		text_stages[i].set_parent_rect({ 0, static_cast<Coord>(64 + i * 16), 240, 16 });
+		add_child(&text_stages[i]);
+	}
+
+	button_reset.on_select = [this](Button&) {
+		shared_memory.profiler.reset_sequence++;
+	};
 
 	button_done.on_select = [&nav](Button&){ nav.pop(); };
+
+	signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+		this->update();
+	};
+
+	update();
 }
 
-void DebugMemoryView::focus() {
+BasebandProfileView::~BasebandProfileView() {
+	rtc_time::signal_tick_second -= signal_token_tick_second;
+}
+
+void BasebandProfileView::update() {
+	for(size_t i=0; i<text_stages.size(); i++) {
+		// Copy first, the baseband keeps updating the table underneath.
+		const auto stage = shared_memory.profiler.stages[i];
+		if( (stage.name[0] == 0) || (stage.count == 0) ) {
+			text_stages[i].set("");
+			continue;
+		}
+
+		std::string name { stage.name, strnlen(stage.name, sizeof(stage.name)) };
+		name.resize(8, ' ');
+		text_stages[i].set(
+			name +
+			to_string_dec_uint(stage.cycles_min, 7) +
+			to_string_dec_uint(stage.cycles_total / stage.count, 7) +
+			to_string_dec_uint(stage.cycles_max, 7)
+		);
+	}
+}
+
+void BasebandProfileView::focus() {
+	button_done.focus();
+}
+
+/* ThreadsView ***********************************************************/
+
+namespace {
+
+std::string to_string_thread(const thread_registry::Statistics& entry, const uint32_t share) {
+	std::string name { entry.name, strnlen(entry.name, sizeof(entry.name)) };
+	name.resize(8, ' ');
+	return name +
+		to_string_dec_uint(entry.stack_peak, 5) + "/" +
+		to_string_dec_uint(entry.stack_size, 5) +
+		to_string_dec_uint(share, 4) + "%" +
+		(entry.heap ? to_string_dec_uint(entry.heap, 6) : std::string(6, ' '));
+}
+
+uint32_t to_share(const uint32_t ticks, const uint32_t ticks_total) {
+	return ticks_total ? (static_cast<uint64_t>(ticks) * 100 / ticks_total) : 0;
+}
+
+} /* namespace */
+
+ThreadsView::ThreadsView(NavigationView& nav) {
+	add_children({
+		&text_header_m0,
+		&text_header_m4,
+		&button_done
+	});
+
+	for(size_t i=0; i<text_m0.size(); i++) {
+		text_m0[i].set_parent_rect({ 0, static_cast<Coord>(16 + i * 16), 240, 16 });
+		add_child(&text_m0[i]);
+	}
+	for(size_t i=0; i<text_m4.size(); i++) {
+		text_m4[i].set_parent_rect({ 0, static_cast<Coord>(152 + i * 16), 240, 16 });
+		add_child(&text_m4[i]);
+	}
+
+	button_done.on_select = [&nav](Button&){ nav.pop(); };
+
+	signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+		this->update();
+	};
+
+	update();
+}
+
+ThreadsView::~ThreadsView() {
+	rtc_time::signal_tick_second -= signal_token_tick_second;
+}
+
+void ThreadsView::update() {
+	std::array<thread_registry::Statistics, m0_rows> m0;
+	const auto m0_count = thread_registry::capture(m0.data(), m0.size());
+
+	// Ticks since the last sample, for threads that were there for it.
+	std::array<uint32_t, m0_rows> m0_ticks { };
+	uint32_t m0_ticks_total = 0;
+	for(size_t i=0; i<m0_count; i++) {
+		for(size_t j=0; j<m0_previous_count; j++) {
+			if( m0[i].id && (m0_previous[j].id == m0[i].id) ) {
+				m0_ticks[i] = m0[i].ticks - m0_previous[j].ticks;
+				m0_ticks_total += m0_ticks[i];
+				break;
+			}
+		}
+	}
+
+	for(size_t i=0; i<text_m0.size(); i++) {
+		text_m0[i].set((i < m0_count) ? to_string_thread(m0[i], to_share(m0_ticks[i], m0_ticks_total)) : "");
+	}
+
+	m0_previous = m0;
+	m0_previous_count = m0_count;
+
+	// Copy first, a baseband shutting down may be rewriting it.
+	const auto m4 = shared_memory.threads;
+	const size_t m4_count = (m4.count < m4_rows) ? m4.count : m4_rows;
+	uint32_t m4_ticks_total = 0;
+	for(size_t i=0; i<m4_count; i++) {
+		m4_ticks_total += m4.threads[i].ticks;
+	}
+
+	for(size_t i=0; i<text_m4.size(); i++) {
+		text_m4[i].set((i < m4_count) ? to_string_thread(m4.threads[i], to_share(m4.threads[i].ticks, m4_ticks_total)) : "");
+	}
+	if( m4_count == 0 ) {
+		text_m4[0].set("No baseband image run yet");
+	}
+}
+
+void ThreadsView::focus() {
+	button_done.focus();
+}
+
+/* QueueDropsView ********************************************************/
+
+namespace {
+
+std::string to_string_message_id(const Message::ID id) {
+	switch(id) {
+	case Message::ID::TPMSPacket:	return "TPMS packet";
+	case Message::ID::ACARSPacket:	return "ACARS packet";
+	case Message::ID::AISPacket:	return "AIS packet";
+	case Message::ID::ERTPacket:	return "ERT packet";
+	case Message::ID::SondePacket:	return "Sonde packet";
+	case Message::ID::POCSAGPacket:	return "POCSAG packet";
+	case Message::ID::ADSBFrame:	return "ADS-B frames";
+	case Message::ID::AX25Packet:	return "AX.25 packet";
+	default:						return "ID " + to_string_dec_uint(static_cast<uint32_t>(id));
+	}
+}
+
+} /* namespace */
+
+QueueDropsView::QueueDropsView(NavigationView& nav) {
+	add_children({
+		&text_header,
+		&text_total,
+		&button_done
+	});
+
+	for(size_t i=0; i<text_rows.size(); i++) {
+		text_rows[i].set_parent_rect({ 0, static_cast<Coord>(16 + i * 16), 240, 16 });
+		add_child(&text_rows[i]);
+	}
+
+	button_done.on_select = [&nav](Button&){ nav.pop(); };
+
+	signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+		this->update();
+	};
+
+	update();
+}
+
+QueueDropsView::~QueueDropsView() {
+	rtc_time::signal_tick_second -= signal_token_tick_second;
+}
+
+void QueueDropsView::update() {
+	const auto& drops = shared_memory.application_queue_drops;
+
+	std::array<size_t, static_cast<size_t>(Message::ID::MAX)> order;
+	size_t count = 0;
+	for(size_t i=0; i<order.size(); i++) {
+		if( drops.by_id[i] ) {
+			order[count++] = i;
+		}
+	}
+	std::sort(order.begin(), order.begin() + count, [&drops](const size_t a, const size_t b) {
+		return drops.by_id[a] > drops.by_id[b];
+	});
+
+	for(size_t i=0; i<text_rows.size(); i++) {
+		if( i < count ) {
+			std::string line { to_string_message_id(static_cast<Message::ID>(order[i])) };
+			line.resize(14, ' ');
+			text_rows[i].set(line + to_string_dec_uint(drops.by_id[order[i]], 10));
+		} else {
+			text_rows[i].set((i == 0) ? "None" : "");
+		}
+	}
+
+	text_total.set("Total         " + to_string_dec_uint(drops.total, 10));
+}
+
+void QueueDropsView::focus() {
+	button_done.focus();
+}
+
+/* BootTimelineView ******************************************************/
+
+BootTimelineView::BootTimelineView(NavigationView& nav) {
+	add_children({
+		&text_header,
+		&button_done
+	});
+
+	uint32_t previous = 0;
+	for(size_t i=0; i<text_marks.size(); i++) {
+		const auto m = static_cast<boot_timeline::Mark>(i);
+		const auto t = boot_timeline::time(m);
+
+		std::string line { boot_timeline::name(m) };
+		line.resize(8, ' ');
+		if( t ) {
+			line += to_string_dec_uint(t, 10) + to_string_dec_uint(t - previous, 10);
+			previous = t;
+		} else {
+			line += "         -         -";
+		}
+
+		text_marks[i].set_parent_rect({ 0, static_cast<Coord>(16 + i * 16), 240, 16 });
+		text_marks[i].set(line);
+		add_child(&text_marks[i]);
+	}
+
+	button_done.on_select = [&nav](Button&){ nav.pop(); };
+}
+
+void BootTimelineView::focus() {
+	button_done.focus();
+}
+
+/* TraceView *************************************************************/
+
+TraceView::TraceView(NavigationView& nav) {
+	add_children({
+		&text_m0,
+		&text_m4,
+		&text_status,
+		&button_dump,
+		&button_done
+	});
+
+	button_dump.on_select = [this](Button&){ this->dump(); };
+	button_done.on_select = [&nav](Button&){ nav.pop(); };
+
+	signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+		this->update();
+	};
+
+	update();
+}
+
+TraceView::~TraceView() {
+	rtc_time::signal_tick_second -= signal_token_tick_second;
+}
+
+void TraceView::update() {
+	text_m0.set("M0 records  " + to_string_dec_uint(trace::ring.count, 10));
+
+	const auto m4 = shared_memory.m4_trace;
+	text_m4.set("M4 records  " + (m4 ? to_string_dec_uint(m4->count, 10) : std::string { "         -" }));
+}
+
+void TraceView::dump() {
+	auto path = next_filename_stem_matching_pattern(u"TRC_????");
+	if( path.empty() ) {
+		text_status.set("No free file name");
+		return;
+	}
+	path.replace_extension(u".TRC");
+
+	const auto error = trace::write_file(path);
+	text_status.set(error.is_valid() ? error.value().what() : path.string());
+}
+
+void TraceView::focus() {
+	button_dump.focus();
+}
+
+/* BenchmarkView *********************************************************/
+
+namespace {
+
+// Tenths of a cycle
+std::string to_string_cycles_per_sample(const uint32_t cycles, const uint32_t samples) {
+	const uint32_t tenths = samples ? (static_cast<uint64_t>(cycles) * 10 / samples) : 0;
+	return to_string_dec_uint(tenths / 10, 6) + "." + to_string_dec_uint(tenths % 10);
+}
+
+} /* namespace */
+
+BenchmarkView::BenchmarkView(NavigationView& nav) {
+	add_children({
+		&text_title,
+		&text_header,
+		&button_page,
+		&button_done
+	});
+
+	for(size_t i=0; i<text_rows.size(); i++) {
+		text_rows[i].set_parent_rect({ 0, static_cast<Coord>(64 + i * 16), 240, 16 });
+		add_child(&text_rows[i]);
+	}
+
+	button_page.on_select = [this](Button&) {
+		const size_t pages = (results_count + rows_per_page - 1) / rows_per_page;
+		this->page = (pages > 1) ? ((this->page + 1) % pages) : 0;
+		this->update();
+	};
+
+	button_done.on_select = [&nav](Button&){ nav.pop(); };
+
+	baseband::run_image(portapack::spi_flash::image_tag_benchmark);
+}
+
+BenchmarkView::~BenchmarkView() {
+	baseband::shutdown();
+}
+
+void BenchmarkView::on_result(const BenchmarkResultMessage& message) {
+	if( message.index >= results.size() ) {
+		return;
+	}
+
+	results_count = std::min<size_t>(message.count, results.size());
+	results[message.index] = {
+		{ message.name, strnlen(message.name, sizeof(message.name)) },
+		message.samples,
+		message.cycles_min,
+		message.cycles_mean
+	};
+
+	if( (message.index / rows_per_page) == page ) {
+		update();
+	}
+}
+
+void BenchmarkView::update() {
+	for(size_t i=0; i<text_rows.size(); i++) {
+		const size_t index = page * rows_per_page + i;
+		if( (index >= results_count) || (results[index].samples == 0) ) {
+			text_rows[i].set("");
+			continue;
+		}
+
+		const auto& result = results[index];
+
+		auto name = result.name;
+		name.resize(8, ' ');
+		text_rows[i].set(
+			name +
+			to_string_cycles_per_sample(result.cycles_min, result.samples) +
+			to_string_cycles_per_sample(result.cycles_mean, result.samples)
+		);
+	}
+}
+
+void BenchmarkView::focus() {
+	button_done.focus();
+}
+
+/* FrameTimingView *******************************************************/
+
+FrameTimingView::FrameTimingView(NavigationView& nav) {
+	add_children({
+		&text_title,
+		&text_header,
+		&text_frames,
+		&text_max,
+		&button_reset,
+		&button_done
+	});
+
+	for(size_t i=0; i<text_buckets.size(); i++) {
+		text_buckets[i].set_parent_rect({ 0, static_cast<Coord>(64 + i * 16), 240, 16 });
+		add_child(&text_buckets[i]);
+	}
+
+	button_reset.on_select = [this](Button&) {
+		debug::reset_frame_statistics();
+		this->update();
+	};
+
+	button_done.on_select = [&nav](Button&){ nav.pop(); };
+
+	signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+		this->update();
+	};
+
+	update();
+}
+
+FrameTimingView::~FrameTimingView() {
+	rtc_time::signal_tick_second -= signal_token_tick_second;
+}
+
+void FrameTimingView::update() {
+	const auto& statistics = debug::frame_statistics();
+	const auto& limits = statistics.bucket_limits_us;
+
+	for(size_t i=0; i<text_buckets.size(); i++) {
+		const std::string range = (i < limits.size())
+			? ("<" + to_string_dec_uint(limits[i] / 1000, 2))
+			: (">=" + to_string_dec_uint(limits[i - 1] / 1000));
+		text_buckets[i].set(
+			range + std::string(8 - range.size(), ' ') +
+			to_string_dec_uint(statistics.paint_us_histogram[i], 10)
+		);
+	}
+
+	text_frames.set(
+		to_string_dec_uint(statistics.frames) + " frames, " +
+		to_string_dec_uint(statistics.late_starts) + " late, " +
+		to_string_dec_uint(statistics.deferred) + " split"
+	);
+	text_max.set(
+		"Max: paint " + to_string_dec_uint(statistics.max_paint_us) +
+		"us, start " + to_string_dec_uint(statistics.max_start_us) + "us"
+	);
+}
+
+void FrameTimingView::focus() {
+	button_done.focus();
+}
+
+/* RadioStateView ********************************************************/
+
+RadioStateView::RadioStateView(NavigationView& nav) {
+	add_children({
+		&text_title,
+		&text_header,
+		&text_full,
+		&text_table,
+		&text_last,
+		&button_reset,
+		&button_done
+	});
+
+	button_reset.on_select = [this](Button&) {
+		radio::debug::reset_retune_statistics();
+		this->update();
+	};
+
+	button_done.on_select = [&nav](Button&){ nav.pop(); };
+
+	signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+		this->update();
+	};
+
+	update();
+}
+
+RadioStateView::~RadioStateView() {
+	rtc_time::signal_tick_second -= signal_token_tick_second;
+}
+
+void RadioStateView::update() {
+	const auto format = [](const std::string& name, const radio::debug::RetuneStatistics& statistics) {
+		if( statistics.count == 0 ) {
+			return name + "      -";
+		}
+		return name +
+			to_string_dec_uint(statistics.count, 7) +
+			to_string_dec_uint(statistics.min_us, 6) +
+			to_string_dec_uint(statistics.total_us / statistics.count, 6) +
+			to_string_dec_uint(statistics.max_us, 6);
+	};
+
+	const auto& full = radio::debug::retune_statistics(false);
+	const auto& table = radio::debug::retune_statistics(true);
+	text_full.set(format("Full ", full));
+	text_table.set(format("Table", table));
+	text_last.set(
+		"Last: full " + to_string_dec_uint(full.last_us) +
+		"us, table " + to_string_dec_uint(table.last_us) + "us"
+	);
+}
+
+void RadioStateView::focus() {
 	button_done.focus();
 }
 
@@ -270,14 +960,23 @@ DebugPeripheralsMenuView::DebugPeripheralsMenuView(NavigationView& nav) {
 
 /* DebugMenuView *********************************************************/
 
+static constexpr MenuEntry debug_menu[] {
+	{ "Memory", 		ui::Color::white(),	nullptr,	menu_push<DebugMemoryView> },
+	{ "Baseband Prof.",	ui::Color::white(),	nullptr,	menu_push<BasebandProfileView> },
+	{ "Threads",		ui::Color::white(),	nullptr,	menu_push<ThreadsView> },
+	{ "Queue drops",	ui::Color::white(),	nullptr,	menu_push<QueueDropsView> },
+	{ "Boot",			ui::Color::white(),	nullptr,	menu_push<BootTimelineView> },
+	{ "Trace",			ui::Color::white(),	nullptr,	menu_push<TraceView> },
+	{ "DSP Benchmark",	ui::Color::white(),	nullptr,	menu_push<BenchmarkView> },
+	{ "Radio State",	ui::Color::white(),	nullptr,	menu_push<RadioStateView> },
+	{ "Frame timing",	ui::Color::white(),	nullptr,	menu_push<FrameTimingView> },
+	{ "SD Card",		ui::Color::white(),	nullptr,	menu_push<SDCardDebugView> },
+	{ "Peripherals",	ui::Color::white(),	nullptr,	menu_push<DebugPeripheralsMenuView> },
+	{ "Temperature",	ui::Color::white(),	nullptr,	menu_push<TemperatureView> },
+};
+
 DebugMenuView::DebugMenuView(NavigationView& nav) {
-	add_items({
-		{ "Memory", 		ui::Color::white(),	nullptr,	[&nav](){ nav.push<DebugMemoryView>(); } },
-		{ "Radio State",	ui::Color::white(),	nullptr,	[&nav](){ nav.push<NotImplementedView>(); } },
-		//{ "SD Card",		ui::Color::white(),	nullptr,	[&nav](){ nav.push<SDCardDebugView>(); } },
-		{ "Peripherals",	ui::Color::white(),	nullptr,	[&nav](){ nav.push<DebugPeripheralsMenuView>(); } },
-		{ "Temperature",	ui::Color::white(),	nullptr,	[&nav](){ nav.push<TemperatureView>(); } },
-	});
+	set_entries(debug_menu, nav);
 	on_left = [&nav](){ nav.pop(); };
 }
 
@@ -31,53 +31,425 @@
 #include "rffc507x.hpp"
 #include "max2837.hpp"
 #include "portapack.hpp"
+#include "portapack_shared_memory.hpp"
+#include "signal.hpp"
+#include "event_m0.hpp"
+#include "message.hpp"
+#include "boot_timeline.hpp"
 
 #include <functional>
 #include <utility>
+#include <array>
+#include <string>
 
 namespace ui {
 
+/* Both cores' RAM, a bar per region of memory_map.hpp scaled to its size:
+ * the M4 image and shared_memory, each core's stacks, .data/.bss and heap,
+ * and the M0 heap's free blocks. The M4's RAM is as the baseband last
+ * reported it, blank before any has run.
+ */
+class MemoryMapWidget : public Widget {
+public:
+	explicit MemoryMapWidget(
+		Rect parent_rect
+	) : Widget { parent_rect }
+	{
+	}
+
+	void paint(Painter& painter) override;
+
+private:
+	static constexpr size_t blocks_max = 48;
+	static constexpr Coord bar_left = 40;
+	static constexpr Dim bar_width = 200;
+	static constexpr Dim row_height = 16;
+	static constexpr Dim legend_slot_width = 60;
+};
+
+/* The M0 heap's free blocks by size, in powers of two from 16 bytes. */
+class HeapHistogramWidget : public Widget {
+public:
+	explicit HeapHistogramWidget(
+		Rect parent_rect
+	) : Widget { parent_rect }
+	{
+	}
+
+	void paint(Painter& painter) override;
+
+private:
+	static constexpr size_t bins = 10;
+	static constexpr size_t blocks_max = 48;
+	static constexpr uint32_t bin_min = 16;
+	static constexpr Dim bin_width = 24;
+	static constexpr Dim bar_height_max = 40;
+};
+
 class DebugMemoryView : public View {
 public:
 	DebugMemoryView(NavigationView& nav);
+	~DebugMemoryView();
+
+	void focus() override;
+
+	std::string title() const override { return "Memory"; };
+
+private:
+	SignalToken signal_token_tick_second { };
+
+	void update();
+
+	MemoryMapWidget memory_map {
+		{ 0, 0, 240, 112 },
+	};
+
+	Text text_core_free {
+		{ 0, 120, 240, 16 },
+	};
+
+	Text text_heap_high_water {
+		{ 0, 136, 240, 16 },
+	};
+
+	Text text_heap_free {
+		{ 0, 152, 240, 16 },
+	};
+
+	Text text_arenas {
+		{ 0, 168, 240, 16 },
+	};
+
+	HeapHistogramWidget heap_histogram {
+		{ 0, 192, 240, 72 },
+	};
+
+	Button button_done {
+		{ 72, 272, 96, 24 },
+		"Done"
+	};
+};
+
+class BasebandProfileView : public View {
+public:
+	BasebandProfileView(NavigationView& nav);
+	~BasebandProfileView();
 
 	void focus() override;
 
 private:
+	SignalToken signal_token_tick_second { };
+
+	void update();
+
 	Text text_title {
-		{ 96, 96, 48, 16 },
-		"Memory",
+		{ 64, 16, 112, 16 },
+		"Stage cycles",
 	};
 
-	Text text_label_m0_core_free {
-		{ 0, 128, 144, 16 },
-		"M0 Core Free Bytes",
+	Text text_header {
+		{ 0, 48, 240, 16 },
+		"Stage       min   mean    max",
+	};
+
+	std::array<Text, ProfilerTable::stages_max> text_stages { };
+
+	Button button_reset {
+		{ 16, 264, 96, 24 },
+		"Reset"
+	};
+
+	Button button_done {
+		{ 128, 264, 96, 24 },
+		"Done"
+	};
+};
+
+/* Stack watermarks, CPU share and heap held per thread. M0 threads are
+ * sampled every second, CPU share being over that second; the M4 table is
+ * from the last baseband image, its share over that image's lifetime.
+ */
+class ThreadsView : public View {
+public:
+	ThreadsView(NavigationView& nav);
+	~ThreadsView();
+
+	void focus() override;
+
+private:
+	static constexpr size_t m0_rows = 7;
+	static constexpr size_t m4_rows = 6;
+
+	SignalToken signal_token_tick_second { };
+
+	std::array<thread_registry::Statistics, m0_rows> m0_previous { };
+	size_t m0_previous_count { 0 };
+
+	void update();
+
+	Text text_header_m0 {
+		{ 0, 0, 240, 16 },
+		"M0       peak/ size  cpu  heap",
+	};
+
+	std::array<Text, m0_rows> text_m0 { };
+
+	Text text_header_m4 {
+		{ 0, 136, 240, 16 },
+		"M4       peak/ size  cpu  heap",
+	};
+
+	std::array<Text, m4_rows> text_m4 { };
+
+	Button button_done {
+		{ 72, 264, 96, 24 },
+		"Done"
+	};
+};
+
+/* Messages the baseband couldn't queue for the application this boot,
+ * busiest first, from shared_memory.application_queue_drops.
+ */
+class QueueDropsView : public View {
+public:
+	QueueDropsView(NavigationView& nav);
+	~QueueDropsView();
+
+	void focus() override;
+
+private:
+	static constexpr size_t rows = 13;
+
+	SignalToken signal_token_tick_second { };
+
+	void update();
+
+	Text text_header {
+		{ 0, 0, 240, 16 },
+		"Message          dropped",
+	};
+
+	Text text_total {
+		{ 0, 232, 240, 16 },
+	};
+
+	std::array<Text, rows> text_rows { };
+
+	Button button_done {
+		{ 72, 264, 96, 24 },
+		"Done"
+	};
+};
+
+/* Milestones of this boot, from boot_timeline: time since the kernel
+ * started and since the previous milestone.
+ */
+class BootTimelineView : public View {
+public:
+	BootTimelineView(NavigationView& nav);
+
+	void focus() override;
+
+private:
+	Text text_header {
+		{ 0, 0, 240, 16 },
+		"Boot         at ms   step ms",
+	};
+
+	std::array<Text, static_cast<size_t>(boot_timeline::Mark::Count)> text_marks { };
+
+	Button button_done {
+		{ 72, 264, 96, 24 },
+		"Done"
+	};
+};
+
+/* Record counts of the trace rings (trace.hpp), and Dump to write them to
+ * TRC_????.TRC for tools/trace_to_json.py.
+ */
+class TraceView : public View {
+public:
+	TraceView(NavigationView& nav);
+	~TraceView();
+
+	void focus() override;
+
+private:
+	SignalToken signal_token_tick_second { };
+
+	void update();
+	void dump();
+
+	Text text_m0 {
+		{ 0, 16, 240, 16 },
+	};
+
+	Text text_m4 {
+		{ 0, 32, 240, 16 },
+	};
+
+	Text text_status {
+		{ 0, 64, 240, 16 },
+	};
+
+	Button button_dump {
+		{ 72, 224, 96, 24 },
+		"Dump"
+	};
+
+	Button button_done {
+		{ 72, 264, 96, 24 },
+		"Done"
+	};
+};
+
+/* Runs the benchmark baseband image and lists cycles per sample for each
+ * DSP kernel, best and mean, as the results come in.
+ */
+class BenchmarkView : public View {
+public:
+	BenchmarkView(NavigationView& nav);
+	~BenchmarkView();
+
+	void focus() override;
+
+private:
+	static constexpr size_t rows_per_page = 12;
+
+	struct Result {
+		std::string name;
+		uint32_t samples;
+		uint32_t cycles_min;
+		uint32_t cycles_mean;
+	};
+
+	std::array<Result, 32> results { };
+	size_t results_count { 0 };
+	size_t page { 0 };
+
+	void on_result(const BenchmarkResultMessage& message);
+	void update();
+
+	Text text_title {
+		{ 64, 16, 112, 16 },
+		"Cycles/sample",
+	};
+
+	Text text_header {
+		{ 0, 48, 240, 16 },
+		"Kernel      best    mean",
+	};
+
+	std::array<Text, rows_per_page> text_rows { };
+
+	Button button_page {
+		{ 16, 264, 96, 24 },
+		"Page"
+	};
+
+	Button button_done {
+		{ 128, 264, 96, 24 },
+		"Done"
+	};
+
+	MessageHandlerRegistration message_handler_result {
+		Message::ID::BenchmarkResult,
+		[this](Message* const p) {
+			this->on_result(*static_cast<const BenchmarkResultMessage*>(p));
+		}
+	};
+};
+
+/* Repaint times per frame, from debug::frame_statistics(). */
+class FrameTimingView : public View {
+public:
+	FrameTimingView(NavigationView& nav);
+	~FrameTimingView();
+
+	void focus() override;
+
+private:
+	SignalToken signal_token_tick_second { };
+
+	void update();
+
+	Text text_title {
+		{ 32, 16, 176, 16 },
+		"Repaint time per frame",
+	};
+
+	Text text_header {
+		{ 0, 48, 240, 16 },
+		"Paint (ms)   frames",
+	};
+
+	std::array<Text, debug::FrameStatistics::bucket_count> text_buckets { };
+
+	Text text_frames {
+		{ 0, 184, 240, 16 },
+		"",
+	};
+
+	Text text_max {
+		{ 0, 200, 240, 16 },
+		"",
+	};
+
+	Button button_reset {
+		{ 16, 264, 96, 24 },
+		"Reset"
+	};
+
+	Button button_done {
+		{ 128, 264, 96, 24 },
+		"Done"
+	};
+};
+
+class RadioStateView : public View {
+public:
+	RadioStateView(NavigationView& nav);
+	~RadioStateView();
+
+	void focus() override;
+
+private:
+	SignalToken signal_token_tick_second { };
+
+	void update();
+
+	Text text_title {
+		{ 32, 16, 176, 16 },
+		"Retune latency (us)",
 	};
 
-	Text text_label_m0_core_free_value {
-		{ 200, 128, 40, 16 },
+	Text text_header {
+		{ 0, 48, 240, 16 },
+		"Path   count   min  mean   max",
 	};
 
-	Text text_label_m0_heap_fragmented_free {
-		{ 0, 144, 184, 16 },
-		"M0 Heap Fragmented Free",
+	Text text_full {
+		{ 0, 64, 240, 16 },
+		"",
 	};
 
-	Text text_label_m0_heap_fragmented_free_value {
-		{ 200, 144, 40, 16 },
+	Text text_table {
+		{ 0, 80, 240, 16 },
+		"",
 	};
 
-	Text text_label_m0_heap_fragments {
-		{ 0, 160, 136, 16 },
-		"M0 Heap Fragments",
+	Text text_last {
+		{ 0, 112, 240, 16 },
+		"",
 	};
 
-	Text text_label_m0_heap_fragments_value {
-		{ 200, 160, 40, 16 },
+	Button button_reset {
+		{ 16, 264, 96, 24 },
+		"Reset"
 	};
 
 	Button button_done {
-		{ 72, 192, 96, 24 },
+		{ 128, 264, 96, 24 },
 		"Done"
 	};
 };
@@ -137,16 +137,20 @@ void EncodersConfigView::draw_waveform() {
 
 void EncodersConfigView::generate_frame() {
 	size_t i = 0;
-	
-	frame_fragments.clear();
+	std::string fragments;
 	
 	for (auto c : encoder_def->word_format) {
 		if (c == 'S')
-			frame_fragments += encoder_def->sync;
+			fragments += encoder_def->sync;
 		else
-			frame_fragments += encoder_def->bit_format[symfield_word.get_sym(i++)];
+			fragments += encoder_def->bit_format[symfield_word.get_sym(i++)];
 	}
 	
+	// Kept for start_tx(), redrawn only when an edit changed the frame.
+	if (fragments == frame_fragments)
+		return;
+	
+	frame_fragments = std::move(fragments);
 	draw_waveform();
 }
 
@@ -155,7 +159,9 @@ uint8_t EncodersConfigView::repeat_min() {
 }
 
 uint32_t EncodersConfigView::samples_per_bit() {
-	return OOK_SAMPLERATE / ((field_clk.value() * 1000) / encoder_def->clk_per_fragment);
+	// Rounded, in one division: clk_per_fragment clock periods at field_clk kHz
+	const uint32_t clk_hz = field_clk.value() * 1000;
+	return (OOK_SAMPLERATE * encoder_def->clk_per_fragment + clk_hz / 2) / clk_hz;
 }
 
 uint32_t EncodersConfigView::pause_symbols() {
@@ -303,21 +309,31 @@ void EncodersView::start_tx(const bool scan) {
 		update_progress();
 	//}
 	
-	view_config.generate_frame();
-	
-	bitstream_length = make_bitstream(view_config.frame_fragments);
+	// The frame is current, generated on each edit.
+	const size_t run_count = make_runs(view_config.frame_fragments);
+	if (!run_count)
+		bitstream_length = make_bitstream(view_config.frame_fragments);
 
 	transmitter_model.set_sampling_rate(OOK_SAMPLERATE);
 	transmitter_model.set_rf_amp(true);
 	transmitter_model.set_baseband_bandwidth(1750000);
 	transmitter_model.enable();
 	
-	baseband::set_ook_data(
-		bitstream_length,
-		view_config.samples_per_bit(),
-		repeat_min,
-		view_config.pause_symbols()
-	);
+	if (run_count) {
+		baseband::set_ook_runs(
+			run_count,
+			view_config.samples_per_bit(),
+			repeat_min,
+			view_config.pause_symbols()
+		);
+	} else {
+		baseband::set_ook_data(
+			bitstream_length,
+			view_config.samples_per_bit(),
+			repeat_min,
+			view_config.pause_symbols()
+		);
+	}
 }
 
 EncodersView::EncodersView(
@@ -35,11 +35,28 @@ void FileManBaseView::load_directory_contents(const std::filesystem::path& dir_p
 	text_current.set(dir_path.string().substr(0, 30 - 8));
 	
 	entry_list.clear();
+	directory_count = 0;
 	
+	dir_iterator = std::make_unique<std::filesystem::directory_iterator>(dir_path, u"*");
+	load_entries(first_page_entries);
+}
+
+bool FileManBaseView::is_loading() const {
+	return dir_iterator && (*dir_iterator != std::filesystem::directory_iterator());
+}
+
+// Returns true if a directory was found, which goes above files already listed
+bool FileManBaseView::load_entries(const size_t count) {
 	auto filtering = (bool)extension_filter.size();
+	bool directory_found = false;
+	size_t added = 0;
+	size_t scanned = 0;
 	
 	// List directories and files, put directories up top
-	for (const auto& entry : std::filesystem::directory_iterator(dir_path, u"*")) {
+	while (is_loading() && (added < count) && (scanned < count * scan_max_factor)) {
+		const auto& entry = **dir_iterator;
+		scanned++;
+		
 		if (std::filesystem::is_regular_file(entry.status())) {
 			if (entry.path().string().length()) {
 				auto entry_extension = entry.path().extension().string();
@@ -47,12 +64,44 @@ void FileManBaseView::load_directory_contents(const std::filesystem::path& dir_p
 				for (auto &c: entry_extension)
 					c = toupper(c);
 				
-				if ((entry_extension == extension_filter) || !filtering)
+				// The filter may list several extensions, e.g. ".C16|.RIQ".
+				const auto match = ("|" + extension_filter + "|").find("|" + entry_extension + "|");
+				if ((match != std::string::npos) || !filtering) {
 					entry_list.push_back({ entry.path(), (uint32_t)entry.size(), false });
+					added++;
+				}
 			}
 		} else if (std::filesystem::is_directory(entry.status())) {
-			entry_list.insert(entry_list.begin(), { entry.path(), 0, true });
+			entry_list.insert(entry_list.begin() + directory_count, { entry.path(), 0, true });
+			directory_count++;
+			directory_found = true;
+			added++;
 		}
+		
+		++(*dir_iterator);
+	}
+	
+	if (!is_loading())
+		dir_iterator.reset();
+	
+	return directory_found;
+}
+
+void FileManBaseView::on_frame_sync() {
+	if (!is_loading())
+		return;
+	
+	const size_t listed = entry_list.size();
+	const bool directory_found = load_entries(entries_per_frame);
+	
+	if (directory_found || (!listed && entry_list.size())) {
+		// Entries shifted (or the list was showing as empty), redo the menu
+		const auto highlighted = menu_view.highlighted_index();
+		refresh_list();
+		menu_view.set_highlighted(highlighted);
+	} else {
+		for (size_t n = listed; n < entry_list.size(); n++)
+			add_menu_item(entry_list[n]);
 	}
 }
 
@@ -74,7 +123,7 @@ FileManBaseView::FileManBaseView(
 {
 	load_directory_contents(current_path);
 	
-	if (!entry_list.size())
+	if (!entry_list.size() && !is_loading())
 		empty_root = true;
 	
 	add_children({
@@ -118,61 +167,63 @@ void FileManBaseView::refresh_list() {
 	
 		menu_view.clear();
 		
-		for (size_t n = 0; n < entry_list.size(); n++) {
-			auto entry = &entry_list[n];
-			auto entry_name = entry->entry_path.filename().string().substr(0, 20);
-			
-			if (entry->is_directory) {
-				
-				menu_view.add_item({
-					entry_name,
-					ui::Color::yellow(),
-					&bitmap_icon_dir,
-					[this](){
-						if (on_select_entry)
-							on_select_entry();
-					}
-				});
-				
-			} else {
-				
-				auto file_size = entry->size;
-				size_t suffix_index = 0;
-				
-				while (file_size >= 1024) {
-					file_size /= 1024;
-					suffix_index++;
-				}
-				if (suffix_index > 4)
-					suffix_index = 4;
-				
-				std::string size_str = to_string_dec_uint(file_size) + suffix[suffix_index];
-				
-				auto entry_extension = entry->entry_path.extension().string();
-				for (auto &c: entry_extension)
-					c = toupper(c);
-				
-				// Associate extension to icon and color
-				size_t c;
-				for (c = 0; c < file_types.size() - 1; c++) {
-					if (entry_extension == file_types[c].extension)
-						break;
-				}
-				
-				menu_view.add_item({
-					entry_name + std::string(21 - entry_name.length(), ' ') + size_str,
-					file_types[c].color,
-					file_types[c].icon,
-					[this](){
-						if (on_select_entry)
-							on_select_entry();
-					}
-				});
-				
+		for (const auto& entry : entry_list)
+			add_menu_item(entry);
+		
+		menu_view.set_highlighted(0);	// Refresh
+	}
+}
+
+void FileManBaseView::add_menu_item(const fileman_entry& entry) {
+	auto entry_name = entry.entry_path.filename().string().substr(0, 20);
+	
+	if (entry.is_directory) {
+		
+		menu_view.add_item({
+			entry_name,
+			ui::Color::yellow(),
+			&bitmap_icon_dir,
+			[this](){
+				if (on_select_entry)
+					on_select_entry();
 			}
+		});
+		
+	} else {
+		
+		auto file_size = entry.size;
+		size_t suffix_index = 0;
+		
+		while (file_size >= 1024) {
+			file_size /= 1024;
+			suffix_index++;
 		}
+		if (suffix_index > 4)
+			suffix_index = 4;
+		
+		std::string size_str = to_string_dec_uint(file_size) + suffix[suffix_index];
+		
+		auto entry_extension = entry.entry_path.extension().string();
+		for (auto &c: entry_extension)
+			c = toupper(c);
+		
+		// Associate extension to icon and color
+		size_t c;
+		for (c = 0; c < file_types.size() - 1; c++) {
+			if (entry_extension == file_types[c].extension)
+				break;
+		}
+		
+		menu_view.add_item({
+			entry_name + std::string(21 - entry_name.length(), ' ') + size_str,
+			file_types[c].color,
+			file_types[c].icon,
+			[this](){
+				if (on_select_entry)
+					on_select_entry();
+			}
+		});
 		
-		menu_view.set_highlighted(0);	// Refresh
 	}
 }
 
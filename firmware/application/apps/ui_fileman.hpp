@@ -27,6 +27,7 @@
 #include "file.hpp"
 #include "ui_navigation.hpp"
 #include "ui_textentry.hpp"
+#include "event_m0.hpp"
 
 namespace ui {
 
@@ -68,6 +69,8 @@ protected:
 		{ ".PNG", &bitmap_icon_file_image, ui::Color::green() },
 		{ ".BMP", &bitmap_icon_file_image, ui::Color::green() },
 		{ ".C16", &bitmap_icon_file_iq, ui::Color::blue() },
+		{ ".C8", &bitmap_icon_file_iq, ui::Color::blue() },
+		{ ".RIQ", &bitmap_icon_file_iq, ui::Color::blue() },
 		{ ".WAV", &bitmap_icon_speaker, ui::Color::dark_magenta() },
 		{ "", &bitmap_icon_file, ui::Color::light_grey() }
 	};
@@ -79,6 +82,18 @@ protected:
 	std::filesystem::path current_path { u"" };
 	std::string extension_filter { "" };
 	
+	// Directories are listed a page at a time: the first one before the
+	// view shows, the rest a few entries per frame.
+	static constexpr size_t first_page_entries = 16;
+	static constexpr size_t entries_per_frame = 8;
+	static constexpr size_t scan_max_factor = 4;	// Entries looked at per entry wanted, filtered out or not
+	std::unique_ptr<std::filesystem::directory_iterator> dir_iterator { };
+	size_t directory_count { 0 };
+	
+	bool is_loading() const;
+	bool load_entries(const size_t count);
+	void on_frame_sync();
+	void add_menu_item(const fileman_entry& entry);
 	void change_category(int32_t category_id);
 	void refresh_list();
 	
@@ -103,6 +118,13 @@ protected:
 		{ 20 * 8, 34 * 8, 10 * 8, 4 * 8 },
 		"Exit"
 	};
+	
+	MessageHandlerRegistration message_handler_frame_sync {
+		Message::ID::DisplayFrameSync,
+		[this](const Message* const) {
+			this->on_frame_sync();
+		}
+	};
 };
 
 /*class FileSaveView : public FileManBaseView {
@@ -24,6 +24,7 @@
 
 #include "portapack.hpp"
 #include "event_m0.hpp"
+#include "string_format.hpp"
 
 using namespace portapack;
 
@@ -112,7 +113,7 @@ void FreqManBaseView::refresh_list() {
 		
 		for (size_t n = 0; n < database.size(); n++) {
 			menu_view.add_item({
-				freqman_item_string(database[n], 30),
+				freqman_item_string(database, n, 30),
 				ui::Color::white(),
 				nullptr,
 				[this](){
@@ -133,7 +134,7 @@ void FrequencySaveView::save_current_file() {
 			YESNO,
 			[this](bool choice) {
 				if (choice) {
-					database.resize(FREQMAN_MAX_PER_FILE);
+					database.truncate(FREQMAN_MAX_PER_FILE);
 					save_freqman_file(file_list[categories[current_category_id].second], database);
 				}
 				nav_.pop();
@@ -198,22 +199,108 @@ void FrequencyLoadView::refresh_widgets(const bool v) {
 	set_dirty();
 }
 
+namespace {
+
+/* "446.00625", or the like, to Hz; false for anything but digits and one point. */
+bool parse_mhz(const std::string& text, rf::Frequency& frequency) {
+	rf::Frequency hz = 0;
+	rf::Frequency scale = 1000000;
+	bool point = false;
+	bool digits = false;
+	
+	for (const char c : text) {
+		if ((c >= '0') && (c <= '9')) {
+			digits = true;
+			if (!point) {
+				hz = (hz * 10) + ((c - '0') * 1000000);
+			} else if (scale > 1) {
+				scale /= 10;
+				hz += (c - '0') * scale;
+			}
+		} else if ((c == '.') && !point) {
+			point = true;
+		} else {
+			return false;
+		}
+	}
+	
+	frequency = hz;
+	return digits;
+}
+
+} /* namespace */
+
+void FrequencyLoadView::on_find() {
+	if (!list_index.size() && !list_index.open()) {
+		FreqmanIndex::build_in_background();
+		nav_.display_modal("Find", "Indexing the lists,\ntry again shortly.", INFO, nullptr);
+		return;
+	}
+	
+	text_prompt(nav_, &find_buffer, 28, [this](std::string* buffer) {
+		rf::Frequency frequency;
+		if (parse_mhz(*buffer, frequency))
+			found = list_index.near_frequency(frequency, 20);
+		else
+			found = list_index.search(*buffer, 20);
+		show_found();
+	});
+}
+
+void FrequencyLoadView::show_found() {
+	showing_found = true;
+	refresh_widgets(found.empty());
+	menu_view.clear();
+	
+	for (const auto& result : found) {
+		std::string item_string = (result.type == SINGLE)
+			? to_string_short_freq(result.frequency_a) + "M: " + result.description
+			: std::string("Range: ") + result.description;
+		item_string = result.file_stem.substr(0, 4) + " " + item_string;
+		if (item_string.size() > 30)
+			item_string = item_string.substr(0, 27) + "...";
+		
+		menu_view.add_item({
+			item_string,
+			ui::Color::white(),
+			nullptr,
+			[this](){
+				if (on_select_frequency)
+					on_select_frequency();
+			}
+		});
+	}
+	
+	if (!found.empty())
+		menu_view.set_highlighted(0);
+}
+
 FrequencyLoadView::FrequencyLoadView(
 	NavigationView& nav
 ) : FreqManBaseView(nav)
 {
 	on_refresh_widgets = [this](bool v) {
+		showing_found = false;
 		refresh_widgets(v);
 	};
 	
 	add_children({
 		&menu_view,
-		&text_empty
+		&text_empty,
+		&button_find
 	});
 	
 	// Resize menu view to fill screen
 	menu_view.set_parent_rect({ 0, 3 * 8, 240, 30 * 8 });
 	
+	// Lists changed since the index was made: rebuild it while they're browsed.
+	if (!list_index.open())
+		FreqmanIndex::build_in_background();
+	
+	button_find.on_select = [this](Button&) {
+		on_find();
+	};
+	
 	// Just to allow exit on left
 	menu_view.on_left = [&nav, this]() {
 		nav.pop();
@@ -225,32 +312,41 @@ FrequencyLoadView::FrequencyLoadView(
 	on_select_frequency = [&nav, this]() {
 		nav_.pop();
 		
-		auto& entry = database[menu_view.highlighted_index()];
+		const auto index = menu_view.highlighted_index();
+		
+		if (showing_found) {
+			const auto& result = found[index];
+			if ((result.type == RANGE) && on_range_loaded)
+				on_range_loaded(result.frequency_a, result.frequency_b);
+			else if (on_frequency_loaded)
+				on_frequency_loaded(result.frequency_a);
+			return;
+		}
 		
-		if (entry.type == RANGE) {
+		if (database.type(index) == RANGE) {
 			// User chose a frequency range entry
 			if (on_range_loaded)
-				on_range_loaded(entry.frequency_a, entry.frequency_b);
+				on_range_loaded(database.frequency_a(index), database.frequency_b(index));
 			else if (on_frequency_loaded)
-				on_frequency_loaded(entry.frequency_a);
+				on_frequency_loaded(database.frequency_a(index));
 			// TODO: Maybe return center of range if user choses a range when the app needs a unique frequency, instead of frequency_a ?
 		} else {
 			// User chose an unique frequency entry
 			if (on_frequency_loaded)
-				on_frequency_loaded(entry.frequency_a);
+				on_frequency_loaded(database.frequency_a(index));
 		}
 	};
 }
 
 void FrequencyManagerView::on_edit_freq(rf::Frequency f) {
-	database[menu_view.highlighted_index()].frequency_a = f;
+	database.set_frequency_a(menu_view.highlighted_index(), f);
 	save_freqman_file(file_list[categories[current_category_id].second], database);
 	refresh_list();
 }
 
 void FrequencyManagerView::on_edit_desc(NavigationView& nav) {
 	text_prompt(nav, &desc_buffer, 28, [this](std::string * buffer) {
-		database[menu_view.highlighted_index()].description = *buffer;
+		database.set_description(menu_view.highlighted_index(), *buffer);
 		refresh_list();
 		save_freqman_file(file_list[categories[current_category_id].second], database);
 	});
@@ -266,7 +362,7 @@ void FrequencyManagerView::on_new_category(NavigationView& nav) {
 }
 
 void FrequencyManagerView::on_delete() {
-	database.erase(database.begin() + menu_view.highlighted_index());
+	database.erase(menu_view.highlighted_index());
 	save_freqman_file(file_list[categories[current_category_id].second], database);
 	refresh_list();
 }
@@ -321,14 +417,14 @@ FrequencyManagerView::FrequencyManagerView(
 	};
 	
 	button_edit_freq.on_select = [this, &nav](Button&) {
-		auto new_view = nav.push<FrequencyKeypadView>(database[menu_view.highlighted_index()].frequency_a);
+		auto new_view = nav.push<FrequencyKeypadView>(database.frequency_a(menu_view.highlighted_index()));
 		new_view->on_changed = [this](rf::Frequency f) {
 			on_edit_freq(f);
 		};
 	};
 	
 	button_edit_desc.on_select = [this, &nav](Button&) {
-		desc_buffer = database[menu_view.highlighted_index()].description;
+		desc_buffer = database.description(menu_view.highlighted_index());
 		on_edit_desc(nav);
 	};
 	
@@ -28,6 +28,7 @@
 #include "ui_receiver.hpp"
 #include "ui_textentry.hpp"
 #include "freqman.hpp"
+#include "freqman_index.hpp"
 
 namespace ui {
 	
@@ -129,7 +130,21 @@ public:
 	std::string title() const override { return "Load frequency"; };
 	
 private:
+	// Across all lists: a frequency in MHz jumps there, anything else
+	// searches the descriptions.
+	FreqmanIndex list_index { };
+	std::vector<FreqmanIndex::Result> found { };
+	bool showing_found { false };
+	std::string find_buffer { };
+	
 	void refresh_widgets(const bool v);
+	void on_find();
+	void show_found();
+	
+	Button button_find {
+		{ 0, 34 * 8, 10 * 8, 4 * 8 },
+		"Find"
+	};
 };
 
 class FrequencyManagerView : public FreqManBaseView {
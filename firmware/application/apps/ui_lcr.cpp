@@ -73,43 +73,38 @@ void LCRView::on_tx_progress(const uint32_t progress, const bool done) {
 	if (!done) {
 		// Repeating...
 		repeat_index = progress + 1;
-		
-		if (tx_mode == SCAN)
-			scan_progress++;
 	} else {
 		// Done transmitting
 		tx_view.set_transmitting(false);
 		transmitter_model.disable();
-		
-		if ((tx_mode == SCAN) && (scan_index < (scan_count - 1))) {
-			// Next address
-			scan_index++;
-			scan_progress++;
-			repeat_index = 1;
-			start_tx(true);
-		} else {
-			tx_mode = IDLE;
-		}
+		tx_mode = IDLE;
 	}
 	
 	update_progress();
 }
 
+std::string LCRView::message(const std::string& address) const {
+	std::vector<std::string> litterals_list;
+	
+	for (size_t i = 0; i < LCR_MAX_AM; i++) {
+		if (checkboxes[i].value())
+			litterals_list.push_back(litteral[i]);
+	}
+	
+	return lcr::generate_message(address, litterals_list, options_ec.selected_index());
+}
+
 void LCRView::start_tx(const bool scan) {
 	uint32_t repeats = persistent_memory::modem_repeat();
 	
 	if (scan) {
-		if (tx_mode != SCAN) {
-			scan_index = 0;
-			scan_count = scan_list[options_scanlist.selected_index()].count;
-			scan_progress = 1;
-			repeat_index = 1;
-			tx_mode = SCAN;
-			progress.set_max(scan_count * repeats);
-			update_progress();
-		}
-		rgsb = scan_list[options_scanlist.selected_index()].addresses[scan_index];
-		button_set_rgsb.set_text(rgsb);
+		scan_index = 0;
+		scan_count = scan_list[options_scanlist.selected_index()].count;
+		scan_progress = 1;
+		repeat_index = 1;
+		tx_mode = SCAN;
+		progress.set_max(scan_count * repeats);
+		update_progress();
 	} else {
 		tx_mode = SINGLE;
 		repeat_index = 1;
@@ -117,22 +112,20 @@ void LCRView::start_tx(const bool scan) {
 		scan_index = 0;
 		progress.set_max(repeats);
 		update_progress();
+		
+		modems::generate_data(message(rgsb), lcr_message_data);
 	}
-	
-	std::vector<std::string> litterals_list;
-	
-	for (size_t i = 0; i < LCR_MAX_AM; i++) {
-		if (checkboxes[i].value())
-			litterals_list.push_back(litteral[i]);
-	}
-	
-	modems::generate_data(lcr::generate_message(rgsb, litterals_list, options_ec.selected_index()), lcr_message_data);
 
 	transmitter_model.set_tuning_frequency(persistent_memory::tuned_frequency());
 	transmitter_model.set_sampling_rate(AFSK_TX_SAMPLERATE);
 	transmitter_model.set_rf_amp(true);
 	transmitter_model.set_baseband_bandwidth(1750000);
 	transmitter_model.enable();
+	
+	if (scan) {
+		start_scan_chunk();
+		return;
+	}
 
 	memcpy(shared_memory.bb_data.data, lcr_message_data, sizeof(lcr_message_data));
 	
@@ -146,6 +139,87 @@ void LCRView::start_tx(const bool scan) {
 	);
 }
 
+/* Packs as many of the scan list's next messages as fit into bb_data and
+ * has the baseband send them, and their repeats, back to back: no retune
+ * or reconfiguration between addresses, and only one round trip here per
+ * chunk. More repeats than the sequencer has steps go one address at a
+ * time, as cycles of a single step.
+ */
+void LCRView::start_scan_chunk() {
+	const auto& list = scan_list[options_scanlist.selected_index()];
+	const uint32_t repeats = persistent_memory::modem_repeat();
+	const bool cycled = (repeats > TxSequencer::steps_max);
+	const size_t words_max = sizeof(shared_memory.bb_data.data) / sizeof(uint16_t);
+	auto bb_words = reinterpret_cast<uint16_t*>(shared_memory.bb_data.data);
+	std::vector<TxSequencer::Step> steps { };
+	size_t offset = 0;
+	
+	steps_per_address = cycled ? 1 : repeats;
+	chunk_first = scan_index;
+	chunk_count = 0;
+	
+	while (chunk_first + chunk_count < scan_count) {
+		if (chunk_count && (cycled || (steps.size() + steps_per_address > TxSequencer::steps_max)))
+			break;
+		
+		modems::generate_data(message(list.addresses[chunk_first + chunk_count]), lcr_message_data);
+		size_t length = 1;		// End marker
+		while (lcr_message_data[length - 1])
+			length++;
+		if (offset + length > words_max)
+			break;
+		
+		memcpy(&bb_words[offset], lcr_message_data, length * sizeof(uint16_t));
+		for (size_t r = 0; r < steps_per_address; r++)
+			steps.push_back({ persistent_memory::tuned_frequency(), static_cast<uint32_t>(offset), 0 });
+		
+		offset += length;
+		chunk_count++;
+	}
+	
+	rgsb = list.addresses[chunk_first];
+	button_set_rgsb.set_text(rgsb);
+	
+	sequencer.set_steps(steps, AFSK_TX_SAMPLERATE);
+	sequencer.start(cycled ? repeats : 1, 0);
+	
+	baseband::set_afsk_data(
+		AFSK_TX_SAMPLERATE / persistent_memory::modem_baudrate(),
+		persistent_memory::afsk_mark_freq(),
+		persistent_memory::afsk_space_freq(),
+		1,
+		transmitter_model.channel_bandwidth(),
+		serializer::symbol_count(persistent_memory::serial_format())
+	);
+}
+
+void LCRView::on_scan_step(const size_t index, const uint32_t cycle, const bool done) {
+	if (tx_mode != SCAN)
+		return;
+	
+	scan_progress++;
+	
+	if (!done) {
+		scan_index = chunk_first + (index / steps_per_address);
+		repeat_index = (steps_per_address > 1) ? (index % steps_per_address) + 1 : cycle + 1;
+		if (rgsb != scan_list[options_scanlist.selected_index()].addresses[scan_index]) {
+			rgsb = scan_list[options_scanlist.selected_index()].addresses[scan_index];
+			button_set_rgsb.set_text(rgsb);
+		}
+	} else if (chunk_first + chunk_count < scan_count) {
+		// Next chunk, the transmitter left on
+		scan_index = chunk_first + chunk_count;
+		repeat_index = 1;
+		start_scan_chunk();
+	} else {
+		tx_view.set_transmitting(false);
+		transmitter_model.disable();
+		tx_mode = IDLE;
+	}
+	
+	update_progress();
+}
+
 void LCRView::on_button_set_am(NavigationView& nav, int16_t button_id) {
 	text_prompt(
 		nav,
@@ -176,6 +250,10 @@ LCRView::LCRView(NavigationView& nav) {
 	
 	options_scanlist.set_selected_index(0);
 	
+	sequencer.on_step = [this](const size_t index, const uint32_t cycle, const bool done) {
+		on_scan_step(index, cycle, done);
+	};
+	
 	const auto button_set_am_fn = [this, &nav](Button& button) {
 		on_button_set_am(nav, button.id);
 	};
@@ -261,6 +339,7 @@ LCRView::LCRView(NavigationView& nav) {
 				tx_view.set_transmitting(true);
 			} else {
 				// Kill scan process
+				sequencer.stop();
 				baseband::kill_afsk();
 				tx_view.set_transmitting(false);
 				transmitter_model.disable();
@@ -277,6 +356,8 @@ LCRView::LCRView(NavigationView& nav) {
 	};
 	
 	tx_view.on_stop = [this]() {
+		if (tx_mode == SCAN)
+			sequencer.stop();
 		tx_view.set_transmitting(false);
 		transmitter_model.disable();
 		tx_mode = IDLE;
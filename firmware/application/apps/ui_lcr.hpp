@@ -27,6 +27,7 @@
 
 #include "message.hpp"
 #include "transmitter_model.hpp"
+#include "tx_sequencer.hpp"
 
 namespace ui {
 	
@@ -83,6 +84,11 @@ private:
 	
 	tx_modes tx_mode = IDLE;
 	uint8_t scan_count { 0 }, scan_index { 0 };
+	// The addresses in bb_data for the sequencer, each steps_per_address
+	// steps in a row
+	uint8_t chunk_first { 0 }, chunk_count { 0 };
+	uint32_t steps_per_address { 1 };
+	TxSequencer sequencer { };
 	uint32_t scan_progress { 0 };
 	std::array<std::string, LCR_MAX_AM> litteral { { "       " } };
 	std::string rgsb { "AI10" };
@@ -90,7 +96,10 @@ private:
 	uint8_t repeat_index { 0 };
 	
 	void update_progress();
+	std::string message(const std::string& address) const;
 	void start_tx(const bool scan);
+	void start_scan_chunk();
+	void on_scan_step(const size_t index, const uint32_t cycle, const bool done);
 	void on_tx_progress(const uint32_t progress, const bool done);
 	void on_button_set_am(NavigationView& nav, int16_t button_id);
 	
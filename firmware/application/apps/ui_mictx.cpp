@@ -36,12 +36,29 @@ using namespace portapack;
 
 namespace ui {
 
+namespace {
+
+// Keys of MicTXView's settings, don't renumber
+enum MicTXSetting : uint16_t {
+	setting_gain_index = 0,
+	setting_bandwidth_khz = 1,
+	setting_modulation_index = 2,
+	setting_va_enabled = 3,
+	setting_va_level = 4,
+	setting_va_attack_ms = 5,
+	setting_va_decay_ms = 6,
+	setting_tone_key_index = 7,
+	setting_rogerbeep = 8,
+};
+
+} /* namespace */
+
 void MicTXView::focus() {
 	field_frequency.focus();
 }
 
 void MicTXView::update_vumeter() {
-	vumeter.set_value(audio_level);
+	vumeter.set_value(audio_peak);
 }
 
 void MicTXView::on_tx_progress(const bool done) {
@@ -55,7 +72,8 @@ void MicTXView::configure_baseband() {
 		sampling_rate / 20,		// Update vu-meter at 20Hz
 		transmitting ? transmitter_model.channel_bandwidth() : 0,
 		mic_gain,
-		TONES_F2D(tone_key_frequency(tone_key_index), sampling_rate)
+		TONES_F2D(tone_key_frequency(tone_key_index), sampling_rate),
+		modulation
 	);
 }
 
@@ -141,6 +159,7 @@ MicTXView::MicTXView(
 		&field_va_attack,
 		&field_va_decay,
 		&field_bw,
+		&options_modulation,
 		&field_frequency,
 		&options_tone_key,
 		&check_rogerbeep,
@@ -151,13 +170,13 @@ MicTXView::MicTXView(
 	options_tone_key.on_change = [this](size_t i, int32_t) {
 		tone_key_index = i;
 	};
-	options_tone_key.set_selected_index(0);
+	options_tone_key.set_selected_index(settings.get_int(setting_tone_key_index, 0));
 	
 	options_gain.on_change = [this](size_t, int32_t v) {
 		mic_gain = v / 10.0;
 		configure_baseband();
 	};
-	options_gain.set_selected_index(1);		// x1.0
+	options_gain.set_selected_index(settings.get_int(setting_gain_index, 1));		// x1.0
 	
 	field_frequency.set_value(transmitter_model.tuning_frequency());
 	field_frequency.set_step(receiver_model.frequency_step());
@@ -176,35 +195,41 @@ MicTXView::MicTXView(
 	field_bw.on_change = [this](uint32_t v) {
 		transmitter_model.set_channel_bandwidth(v * 1000);
 	};
-	field_bw.set_value(10);
+	field_bw.set_value(settings.get_int(setting_bandwidth_khz, 10));
+	
+	options_modulation.on_change = [this](size_t, int32_t v) {
+		modulation = static_cast<AudioTXConfigMessage::Modulation>(v);
+		configure_baseband();
+	};
+	options_modulation.set_selected_index(settings.get_int(setting_modulation_index, 0));		// FM
 	
 	check_va.on_select = [this](Checkbox&, bool v) {
 		va_enabled = v;
 		text_ptt.hidden(v);
 		set_dirty();
 	};
-	check_va.set_value(false);
+	check_va.set_value(settings.get_bool(setting_va_enabled, false));
 	
 	check_rogerbeep.on_select = [this](Checkbox&, bool v) {
 		rogerbeep_enabled = v;
 	};
-	check_rogerbeep.set_value(false);
+	check_rogerbeep.set_value(settings.get_bool(setting_rogerbeep, false));
 	
 	field_va_level.on_change = [this](int32_t v) {
 		va_level = v;
 		vumeter.set_mark(v);
 	};
-	field_va_level.set_value(40);
+	field_va_level.set_value(settings.get_int(setting_va_level, 40));
 	
 	field_va_attack.on_change = [this](int32_t v) {
 		attack_ms = v;
 	};
-	field_va_attack.set_value(500);
+	field_va_attack.set_value(settings.get_int(setting_va_attack_ms, 500));
 	
 	field_va_decay.on_change = [this](int32_t v) {
 		decay_ms = v;
 	};
-	field_va_decay.set_value(1000);
+	field_va_decay.set_value(settings.get_int(setting_va_decay_ms, 1000));
 	
 	transmitter_model.set_sampling_rate(sampling_rate);
 	transmitter_model.set_rf_amp(false);
@@ -217,6 +242,17 @@ MicTXView::MicTXView(
 }
 
 MicTXView::~MicTXView() {
+	// Written out as settings goes
+	settings.set_int(setting_gain_index, options_gain.selected_index());
+	settings.set_int(setting_bandwidth_khz, field_bw.value());
+	settings.set_int(setting_modulation_index, options_modulation.selected_index());
+	settings.set_bool(setting_va_enabled, va_enabled);
+	settings.set_int(setting_va_level, va_level);
+	settings.set_int(setting_va_attack_ms, attack_ms);
+	settings.set_int(setting_va_decay_ms, decay_ms);
+	settings.set_int(setting_tone_key_index, tone_key_index);
+	settings.set_bool(setting_rogerbeep, rogerbeep_enabled);
+	
 	audio::input::stop();
 	transmitter_model.disable();
 	baseband::shutdown();
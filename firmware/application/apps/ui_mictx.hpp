@@ -30,6 +30,7 @@
 #include "transmitter_model.hpp"
 #include "tone_key.hpp"
 #include "message.hpp"
+#include "settings_store.hpp"
 
 namespace ui {
 
@@ -72,17 +73,22 @@ private:
 	bool rogerbeep_enabled { };
 	uint32_t tone_key_index { };
 	float mic_gain { 1.0 };
-	uint32_t audio_level { 0 };
+	AudioTXConfigMessage::Modulation modulation { AudioTXConfigMessage::Modulation::FM };
+	uint32_t audio_level { 0 };		// RMS, for voice activation
+	uint32_t audio_peak { 0 };		// Shown
 	uint32_t va_level { };
 	uint32_t attack_ms { };
 	uint32_t decay_ms { };
 	uint32_t attack_timer { 0 };
 	uint32_t decay_timer { 0 };
 	
+	SettingsStore settings { "MICTX" };
+	
 	Labels labels {
 		{ { 7 * 8, 1 * 8 }, "Mic. gain:", Color::light_grey() },
 		{ { 7 * 8, 4 * 8 }, "Frequency:", Color::light_grey() },
 		{ { 7 * 8, 6 * 8 }, "Bandwidth:   kHz", Color::light_grey() },
+		{ { 7 * 8, 8 * 8 }, "Mode:", Color::light_grey() },
 		{ { 9 * 8, 13 * 8 }, "Level:   /255", Color::light_grey() },
 		{ { 9 * 8, 15 * 8 }, "Attack:   ms", Color::light_grey() },
 		{ { 9 * 8, 17 * 8 }, "Decay:    ms", Color::light_grey() },
@@ -117,6 +123,19 @@ private:
 		' '
 	};
 	
+	// Bandwidth is the FM deviation, other modes are 3kHz wide
+	OptionsField options_modulation {
+		{ 17 * 8, 8 * 8 },
+		3,
+		{
+			{ "FM ", static_cast<int32_t>(AudioTXConfigMessage::Modulation::FM) },
+			{ "AM ", static_cast<int32_t>(AudioTXConfigMessage::Modulation::AM) },
+			{ "USB", static_cast<int32_t>(AudioTXConfigMessage::Modulation::USB) },
+			{ "LSB", static_cast<int32_t>(AudioTXConfigMessage::Modulation::LSB) },
+			{ "DSB", static_cast<int32_t>(AudioTXConfigMessage::Modulation::DSB) }
+		}
+	};
+	
 	Checkbox check_va {
 		{ 7 * 8, 10 * 8 },
 		7,
@@ -177,6 +196,7 @@ private:
 		[this](const Message* const p) {
 			const auto message = static_cast<const AudioLevelReportMessage*>(p);
 			this->audio_level = message->value;
+			this->audio_peak = message->peak;
 		}
 	};
 	
@@ -30,6 +30,8 @@
 #include "string_format.hpp"
 
 #include <cstring>
+#include <algorithm>
+#include <array>
 #include <stdio.h>
 
 using namespace portapack;
@@ -42,17 +44,14 @@ static WORKING_AREA(ookthread_wa, 256);
 
 static msg_t ookthread_fn(void * arg) {
 	uint32_t v = 0, delay = 0;
-	uint8_t * message_symbols = shared_memory.bb_data.tones_data.message;
 	uint8_t symbol;
 	MorseView * arg_c = (MorseView*)arg;
 	
 	chRegSetThreadName("ookthread");
 	
-	for (uint32_t i = 0; i < arg_c->symbol_count; i++) {
+	for (uint32_t i = 0; arg_c->encoder.read(&symbol, 1); i++) {
 		if (chThdShouldTerminate()) break;
 		
-		symbol = message_symbols[i];
-		
 		v = (symbol < 2) ? 1 : 0;	// TX on for dot or dash, off for pause
 		delay = morse_symbols[symbol];
 		
@@ -93,31 +92,50 @@ bool MorseView::start_tx() {
 	update_tx_duration();
 	
 	if (!symbol_count) {
-		nav_.display_modal("Error", "Message too long,\nmust be < 256 symbols.", INFO, nullptr);
+		nav_.display_modal("Error", "Message is empty.", INFO, nullptr);
 		return false;
 	}
 	
-	progressbar.set_max(symbol_count);
+	// Symbols on the GPIO, time units through the keyer
+	progressbar.set_max((modulation == CW) ? symbol_count : time_units);
 	
 	transmitter_model.set_sampling_rate(1536000U);
 	transmitter_model.set_rf_amp(true);
 	transmitter_model.set_baseband_bandwidth(1750000);
 	transmitter_model.enable();
 	
+	encoder = Encoder { message };
+	
 	if (modulation == CW) {
 		ookthread = chThdCreateStatic(ookthread_wa, sizeof(ookthread_wa), NORMALPRIO + 10, ookthread_fn, this);
 	} else if (modulation == FM) {
-		baseband::set_tones_config(transmitter_model.channel_bandwidth(), 0, symbol_count, false, false);
+		baseband::tones_reset();
+		queue_symbols();
+		baseband::set_morse_keyer(transmitter_model.channel_bandwidth(), field_tone.value(), time_unit_ms, false);
 	}
 	
 	return true;
 }
 
+void MorseView::queue_symbols() {
+	std::array<uint8_t, 32> symbols;
+	size_t n;
+	
+	// Top up the baseband's ring, it asks for more with each TXProgress
+	do {
+		n = encoder.read_units(symbols.data(), std::min(symbols.size(), baseband::tones_space()));
+		baseband::tones_queue(symbols.data(), n);
+	} while (n);
+	
+	if (encoder.done())
+		baseband::tones_end();
+}
+
 void MorseView::update_tx_duration() {
 	uint32_t duration_ms;
 	
 	time_unit_ms = field_time_unit.value();
-	symbol_count = morse_encode(message, time_unit_ms, field_tone.value(), &time_units);
+	symbol_count = morse_encode(message, &time_units);
 	
 	if (symbol_count) {
 		duration_ms = time_units * time_unit_ms;
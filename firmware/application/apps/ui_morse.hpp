@@ -59,6 +59,7 @@ public:
 	
 	uint32_t time_unit_ms { 0 };
 	size_t symbol_count { 0 };
+	Encoder encoder { };
 private:
 	NavigationView& nav_;
 	std::string buffer { "PORTAPACK" };
@@ -72,6 +73,7 @@ private:
 	modulation_t modulation { CW };
 	
 	bool start_tx();
+	void queue_symbols();
 	void update_tx_duration();
 	void on_set_text(NavigationView& nav);
 	void set_foxhunt(size_t i);
@@ -163,6 +165,7 @@ private:
 		Message::ID::TXProgress,
 		[this](const Message* const p) {
 			const auto message = *reinterpret_cast<const TXProgressMessage*>(p);
+			if (!message.done) this->queue_symbols();
 			this->on_tx_progress(message.progress, message.done);
 		}
 	};
@@ -56,6 +56,7 @@ void NuoptixView::transmit(bool setup) {
 	uint8_t mod, tone_code;
 	uint8_t c;
 	uint8_t dtmf_message[6];
+	uint8_t tone_symbols[6 * 2];
 	rtc::RTC datetime;
 	
 	if (!tx_mode) {
@@ -127,8 +128,8 @@ void NuoptixView::transmit(bool setup) {
 		else if (tone_code == '*')
 			tone_code = 15;
 		
-		shared_memory.bb_data.tones_data.message[c * 2] = tone_code;
-		shared_memory.bb_data.tones_data.message[c * 2 + 1] = 0xFF;		// Silence
+		tone_symbols[c * 2] = tone_code;
+		tone_symbols[c * 2 + 1] = 0xFF;		// Silence
 	}
 	
 	for (c = 0; c < 16; c++) {
@@ -138,7 +139,8 @@ void NuoptixView::transmit(bool setup) {
 	shared_memory.bb_data.tones_data.silence = NUOPTIX_TONE_LENGTH;		// 49ms tone, 49ms space
 	
 	audio::set_rate(audio::Rate::Hz_24000);
-	baseband::set_tones_config(transmitter_model.channel_bandwidth(), 0, 6 * 2, true, true);	
+	baseband::set_tones_symbols(tone_symbols, 6 * 2);
+	baseband::set_tones_config(transmitter_model.channel_bandwidth(), 0, true, true);
 	
 	timecode++;
 }
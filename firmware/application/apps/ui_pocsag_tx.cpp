@@ -72,7 +72,7 @@ bool POCSAGTXView::start_tx() {
 		}
 	}
 	
-	pocsag_encode(type, BCH_code, options_function.selected_index_value(), message, address, codewords);
+	pocsag_encode(type, options_function.selected_index_value(), message, address, codewords);
 	
 	total_frames = codewords.size() / 2;
 	
@@ -57,11 +57,6 @@ private:
 	std::string message { };
 	NavigationView& nav_;
 
-	BCHCode BCH_code {
-		{ 1, 0, 1, 0, 0, 1 },
-		5, 31, 21, 2
-	};
-	
 	void on_set_text(NavigationView& nav);
 	void on_tx_progress(const uint32_t progress, const bool done);
 	bool start_tx();
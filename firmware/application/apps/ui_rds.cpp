@@ -24,7 +24,7 @@
 
 #include "portapack.hpp"
 #include "baseband_api.hpp"
-#include "portapack_shared_memory.hpp"
+#include "io_generator.hpp"
 
 #include <cstring>
 
@@ -122,52 +122,31 @@ RDSAudioView::RDSAudioView(
 	});
 }
 
-RDSThread::RDSThread(
-	std::vector<RDSGroup>** frames
-) : frames_ { std::move(frames) }
-{
-	thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO + 10, RDSThread::static_fn, this);
-}
-
-RDSThread::~RDSThread() {
-	if( thread ) {
-		chThdTerminate(thread);
-		chThdWait(thread);
-		thread = nullptr;
-	}
-}
-
-msg_t RDSThread::static_fn(void* arg) {
-	auto obj = static_cast<RDSThread*>(arg);
-	obj->run();
-	return 0;
-}
-
-void RDSThread::run() {
-	std::vector<RDSGroup>* frame_ptr;
-	size_t block_count, c;
-	uint32_t * tx_data_u32 = (uint32_t*)shared_memory.bb_data.data;
-	uint32_t frame_index = 0;
+size_t RDSView::fill_blocks(uint8_t* const buffer, const size_t bytes) {
+	// 32-bit words, 26 bit blocks right aligned. Buffer sizes are multiples
+	// of 4, so a word never straddles two.
+	size_t count = 0;
+	size_t empty_frames = 0;
 	
-	while( !chThdShouldTerminate() ) {
-
-		do {
-			frame_ptr = frames_[frame_index];
-			
-			if (frame_index == 2) {
-				frame_index = 0;
-			} else {
-				frame_index++;
-			}
-		} while(!(block_count = frame_ptr->size() * 4));
+	while( (count + sizeof(uint32_t)) <= bytes ) {
+		const auto frame = frames[stream_frame];
+		if (stream_block >= frame->size() * 4) {
+			stream_block = 0;
+			stream_frame = (stream_frame + 1) % 3;
+			// Nothing to send at all ends the stream
+			if (++empty_frames > 3)
+				break;
+			continue;
+		}
 		
-		for (c = 0; c < block_count; c++)
-			tx_data_u32[c] = frame_ptr->at(c >> 2).block[c & 3];
-	
-		baseband::set_rds_data(block_count * 26);
-		
-		chThdSleepMilliseconds(1000);
+		const uint32_t block = (*frame)[stream_block >> 2].block[stream_block & 3];
+		memcpy(&buffer[count], &block, sizeof(block));
+		count += sizeof(block);
+		stream_block++;
+		empty_frames = 0;
 	}
+	
+	return count;
 }
 
 void RDSView::focus() {
@@ -175,11 +154,14 @@ void RDSView::focus() {
 }
 
 RDSView::~RDSView() {
+	tx_thread.reset();
 	transmitter_model.disable();
 	baseband::shutdown();
 }
 
 void RDSView::start_tx() {
+	tx_thread.reset();
+	
 	rds_flags.PI_code = sym_pi_code.value_hex_u64();
 	rds_flags.PTY = options_pty.selected_index_value();
 	rds_flags.DI = view_PSN.mono_stereo ? 1 : 0;
@@ -208,7 +190,16 @@ void RDSView::start_tx() {
 	transmitter_model.set_baseband_bandwidth(1750000);
 	transmitter_model.enable();
 	
-	tx_thread = std::make_unique<RDSThread>(frames);
+	stream_frame = 0;
+	stream_block = 0;
+	baseband::set_rds_data(0);
+	tx_thread = std::make_unique<ReplayThread>(
+		std::make_unique<GeneratorReader>([this](uint8_t* const buffer, const size_t bytes) {
+			return fill_blocks(buffer, bytes);
+		}),
+		stream_buffer_size, stream_buffer_count,
+		nullptr
+	);
 }
 
 RDSView::RDSView(
@@ -260,7 +251,7 @@ RDSView::RDSView(
 	};
 	
 	tx_view.on_stop = [this]() {
-		// Kill tx_thread here ?
+		tx_thread.reset();
 		tx_view.set_transmitting(false);
 		transmitter_model.disable();
 		txing = false;
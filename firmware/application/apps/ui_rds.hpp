@@ -26,6 +26,7 @@
 #include "ui_tabview.hpp"
 
 #include "rds.hpp"
+#include "replay_thread.hpp"
 
 using namespace rds;
 
@@ -113,25 +114,6 @@ private:
 	};
 };
 
-class RDSThread {
-public:
-	RDSThread(std::vector<RDSGroup>** frames);
-	~RDSThread();
-
-	RDSThread(const RDSThread&) = delete;
-	RDSThread(RDSThread&&) = delete;
-	RDSThread& operator=(const RDSThread&) = delete;
-	RDSThread& operator=(RDSThread&&) = delete;
-
-private:
-	std::vector<RDSGroup>** frames_ { };
-	Thread* thread { nullptr };
-
-	static msg_t static_fn(void* arg);
-	
-	void run();
-};
-
 class RDSView : public View {
 public:
 	RDSView(NavigationView& nav);
@@ -150,10 +132,10 @@ private:
 	NavigationView& nav_;
 	RDS_flags rds_flags { };
 	
-	std::vector<RDSGroup> frame_psn { };
-	std::vector<RDSGroup> frame_radiotext { };
-	std::vector<RDSGroup> frame_datetime { };
-	std::vector<RDSGroup>* frames[3] { &frame_psn, &frame_radiotext, &frame_datetime };
+	RDSFrame frame_psn { };
+	RDSFrame frame_radiotext { };
+	RDSFrame frame_datetime { };
+	RDSFrame* frames[3] { &frame_psn, &frame_radiotext, &frame_datetime };
 	
 	bool txing = false;
 	
@@ -331,7 +313,15 @@ private:
 		9
 	};
 	
-	std::unique_ptr<RDSThread> tx_thread { };
+	// Groups are streamed to the baseband, cycling through the frames
+	static constexpr size_t stream_buffer_size = 512;
+	static constexpr size_t stream_buffer_count = 4;
+	
+	std::unique_ptr<ReplayThread> tx_thread { };
+	size_t stream_frame { 0 };
+	size_t stream_block { 0 };
+	
+	size_t fill_blocks(uint8_t* const buffer, const size_t bytes);
 };
 
 } /* namespace ui */
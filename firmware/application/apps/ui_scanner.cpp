@@ -25,15 +25,41 @@
 #include "baseband_api.hpp"
 #include "string_format.hpp"
 #include "audio.hpp"
+#include "freqman.hpp"
+#include "tone_key.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <cstdlib>
 
 using namespace portapack;
 
 namespace ui {
 
+static constexpr auto EVT_MASK_SCAN_DWELL = EVENT_MASK(0);
+
 ScannerThread::ScannerThread(
-	std::vector<rf::Frequency> frequency_list
-) : frequency_list_ {  std::move(frequency_list) }
+	std::vector<rf::Frequency> frequency_list,
+	const std::vector<uint16_t>& revisit_ms,
+	const uint32_t sampling_rate,
+	const uint32_t baseband_bandwidth
+) : frequency_list_ {  std::move(frequency_list) },
+	sampling_rate_ { sampling_rate }
 {
+	// Divider math for every channel up front, receiver must already be
+	// in its scanning mode and sampling rate.
+	tuning_table_.reserve(frequency_list_.size());
+	for(const auto f : frequency_list_) {
+		tuning_table_.push_back(receiver_model.tuning_settings(f));
+	}
+	build_groups(baseband_bandwidth);
+
+	channels_.reserve(frequency_list_.size());
+	const auto now = chTimeNow();
+	for(size_t i=0; i<frequency_list_.size(); i++) {
+		channels_.push_back({ now, (i < revisit_ms.size()) ? revisit_ms[i] : static_cast<uint16_t>(0), 0 });
+	}
+
 	thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO + 10, ScannerThread::static_fn, this);
 }
 
@@ -49,31 +75,227 @@ void ScannerThread::set_scanning(const bool v) {
 	_scanning = v;
 }
 
+bool ScannerThread::is_scanning() const {
+	return _scanning;
+}
+
+void ScannerThread::set_threshold(const int32_t db) {
+	threshold_db = db;
+}
+
+void ScannerThread::on_dwell_result(const ScanDwellResultMessage& message) {
+	result_sequence = message.sequence;
+	result_busy = message.busy;
+	if( thread ) {
+		chEvtSignal(thread, EVT_MASK_SCAN_DWELL);
+	}
+}
+
+void ScannerThread::on_group_result(const ScanGroupResultMessage& message) {
+	group_result_sequence = message.sequence;
+	group_levels_db = message.levels_db;
+	if( thread ) {
+		chEvtSignal(thread, EVT_MASK_SCAN_DWELL);
+	}
+}
+
 msg_t ScannerThread::static_fn(void* arg) {
+	chRegSetThreadName("scanner");
 	auto obj = static_cast<ScannerThread*>(arg);
 	obj->run();
 	return 0;
 }
 
-void ScannerThread::run() {
+void ScannerThread::build_groups(const uint32_t baseband_bandwidth) {
+	// Receivers tune a quarter of the sampling rate above the LO.
+	const int32_t lo_offset = sampling_rate_ / 4;
+	const int64_t span = static_cast<int64_t>(baseband_bandwidth) - 2 * edge_guard_hz;
+
+	std::vector<uint16_t> order(frequency_list_.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [this](const uint16_t a, const uint16_t b) {
+		return frequency_list_[a] < frequency_list_[b];
+	});
+
+	for(size_t i=0; i<order.size(); ) {
+		const rf::Frequency low = frequency_list_[order[i]];
+		rf::Frequency high = low;
+		size_t end = i + 1;
+		while( (end < order.size()) && ((end - i) < group_channels_max) ) {
+			const auto f = frequency_list_[order[end]];
+			if( (f - low) > span ) {
+				break;
+			}
+			high = f;
+			end++;
+		}
+
+		// Those too close to the LO are hopped to on their own.
+		const rf::Frequency lo = (low + high) / 2;
+		const size_t first = members_.size();
+		for(size_t n=i; n<end; n++) {
+			if( std::abs(frequency_list_[order[n]] - lo) >= dc_guard_hz ) {
+				members_.push_back(order[n]);
+			}
+		}
+		const size_t count = members_.size() - first;
+		if( count < 2 ) {
+			members_.resize(first);
+		} else {
+			add_group(lo + lo_offset, first, count);
+		}
+		for(size_t n=i; n<end; n++) {
+			if( (count < 2) || (std::abs(frequency_list_[order[n]] - lo) < dc_guard_hz) ) {
+				members_.push_back(order[n]);
+				add_group(frequency_list_[order[n]], members_.size() - 1, 1);
+			}
+		}
+
+		i = end;
+	}
+}
+
+void ScannerThread::add_group(const rf::Frequency tuning, const size_t first, const size_t count) {
+	groups_.push_back({
+		tuning,
+		(count == 1) ? tuning_table_[members_[first]] : receiver_model.tuning_settings(tuning),
+		static_cast<uint16_t>(first),
+		static_cast<uint8_t>(count)
+	});
+}
+
+bool ScannerThread::dwell(const size_t index) {
+	receiver_model.set_tuning_frequency(frequency_list_[index], tuning_table_[index]);
+	sequence++;
+	chEvtGetAndClearEvents(EVT_MASK_SCAN_DWELL);
+	baseband::set_scan_dwell(sequence, index, settle_buffers, dwell_buffers, threshold_db, noise_threshold);
+
+	RetuneMessage message { };
+	message.range = index;
+	EventDispatcher::send_message(message);
+
+	// Stale results (timed out hops) don't count
+	const auto events = chEvtWaitAnyTimeout(EVT_MASK_SCAN_DWELL, MS2ST(dwell_timeout_ms));
+	if( !events || (result_sequence != sequence) ) {
+		return false;
+	}
+	visited(index, result_busy);
+	return result_busy;
+}
+
+bool ScannerThread::screen(const Group& group) {
+	receiver_model.set_tuning_frequency(group.tuning, group.settings);
+	sequence++;
+	chEvtGetAndClearEvents(EVT_MASK_SCAN_DWELL);
+
+	const rf::Frequency lo = group.tuning - sampling_rate_ / 4;
+	std::array<int32_t, group_channels_max> offsets { };
+	for(size_t n=0; n<group.count; n++) {
+		offsets[n] = frequency_list_[members_[group.first + n]] - lo;
+	}
+	baseband::set_scan_group(sequence, settle_buffers, group_dwell_buffers, group.count, offsets);
+
 	RetuneMessage message { };
-	uint32_t frequency_index = 0;
+	message.range = members_[group.first];
+	EventDispatcher::send_message(message);
+
+	const auto events = chEvtWaitAnyTimeout(EVT_MASK_SCAN_DWELL, MS2ST(dwell_timeout_ms));
+	if( !events || (group_result_sequence != sequence) ) {
+		return false;
+	}
+
+	// Loudest first, each given a proper dwell.
+	std::array<uint8_t, group_channels_max> order { };
+	size_t candidates = 0;
+	for(size_t n=0; n<group.count; n++) {
+		if( group_levels_db[n] >= (threshold_db - group_margin_db) ) {
+			order[candidates++] = n;
+		} else {
+			visited(members_[group.first + n], false);
+		}
+	}
+	std::sort(order.begin(), order.begin() + candidates, [this](const uint8_t a, const uint8_t b) {
+		return group_levels_db[a] > group_levels_db[b];
+	});
+
+	for(size_t n=0; (n<candidates) && !chThdShouldTerminate(); n++) {
+		if( dwell(members_[group.first + order[n]]) ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void ScannerThread::visited(const size_t index, const bool busy) {
+	auto& channel = channels_[index];
+	channel.last_visit = chTimeNow();
+	channel.history = (channel.history << 1) | (busy ? 1 : 0);
+}
+
+int32_t ScannerThread::overdue_channel() const {
+	const auto now = chTimeNow();
+	int32_t due = -1;
+	systime_t due_late = 0;
+	for(size_t i=0; i<channels_.size(); i++) {
+		const auto& channel = channels_[i];
+		uint16_t revisit_ms = channel.revisit_ms;
+		if( channel.history ) {
+			revisit_ms = revisit_ms ? std::min(revisit_ms, active_revisit_ms) : active_revisit_ms;
+		}
+		if( revisit_ms == 0 ) {
+			continue;
+		}
+
+		const systime_t elapsed = now - channel.last_visit;
+		const systime_t interval = MS2ST(revisit_ms);
+		if( (elapsed >= interval) && ((due < 0) || ((elapsed - interval) > due_late)) ) {
+			due = i;
+			due_late = elapsed - interval;
+		}
+	}
+	return due;
+}
+
+void ScannerThread::run() {
+	size_t group_index = 0;
+	bool up = true;
+	// Revisits take turns with the sweep, which would starve otherwise.
+	bool revisit_turn = true;
+	
+	if( groups_.empty() ) {
+		return;
+	}
 	
 	while( !chThdShouldTerminate() ) {
 		if (_scanning) {
-			// Retune
-			receiver_model.set_tuning_frequency(frequency_list_[frequency_index]);
-			
-			message.range = frequency_index;
-			EventDispatcher::send_message(message);
-			
+			const int32_t due = revisit_turn ? overdue_channel() : -1;
+			if( due >= 0 ) {
+				revisit_turn = false;
+				if( dwell(due) ) {
+					_scanning = false;
+				}
+				continue;
+			}
+			revisit_turn = true;
+
+			const auto& group = groups_[group_index];
+			const bool busy = (group.count == 1) ? dwell(members_[group.first]) : screen(group);
+			if( busy ) {
+				// Stay here, the view resumes once the channel goes quiet
+				_scanning = false;
+				continue;
+			}
 			
-			frequency_index++;
-			if (frequency_index >= frequency_list_.size())
-				frequency_index = 0;
+			// Back and forth, not jumping from the top to the bottom.
+			if( groups_.size() > 1 ) {
+				if( up ? (group_index + 1 >= groups_.size()) : (group_index == 0) ) {
+					up = !up;
+				}
+				group_index = up ? (group_index + 1) : (group_index - 1);
+			}
+		} else {
+			chThdSleepMilliseconds(10);
 		}
-		
-		chThdSleepMilliseconds(50);
 	}
 }
 
@@ -81,11 +303,77 @@ void ScannerView::handle_retune(uint32_t i) {
 	text_cycle.set(to_string_dec_uint(i) + "/" + to_string_dec_uint(frequency_list.size()));
 }
 
+void ScannerView::handle_scan_dwell(const ScanDwellResultMessage& message) {
+	if( !scan_thread ) {
+		return;
+	}
+	
+	scan_thread->on_dwell_result(message);
+	
+	if( message.busy && (message.index < frequency_list.size()) ) {
+		set_recorded_channel(frequency_list[message.index], recording_preroll_bytes);
+
+		text_cycle.set(
+			to_string_dec_uint(message.index) + "/" + to_string_dec_uint(frequency_list.size()) + " " +
+			to_string_short_freq(frequency_list[message.index]) + " " +
+			to_string_dec_int(message.max_db) + "dB"
+		);
+	}
+}
+
 void ScannerView::focus() {
 	field_lna.focus();
 }
 
+void ScannerView::resume_scanning() {
+	set_recorded_channel(0);
+	scan_thread->set_scanning(true);
+}
+
+void ScannerView::set_recording(const bool enabled) {
+	if( enabled == (bool)capture_thread ) {
+		return;
+	}
+
+	if( enabled ) {
+		auto recorder = std::make_unique<ChannelRecorder>(recording_sampling_rate);
+		channel_recorder = recorder.get();
+		recorded_offset = 0;
+		// Squelch stays open for the scanner, the recorder drops what
+		// comes in between channels.
+		capture_thread = std::make_unique<CaptureThread>(
+			std::move(recorder),
+			8192, 4,
+			8, CaptureConfig::Format::C16,
+			nullptr,
+			[](File::Error error) {
+				CaptureThreadDoneMessage message { error.code() };
+				EventDispatcher::send_message(message);
+			}
+		);
+	} else {
+		capture_thread.reset();
+		channel_recorder = nullptr;
+	}
+	check_record.set_value(enabled);
+}
+
+void ScannerView::set_recorded_channel(const rf::Frequency frequency, const uint64_t preroll) {
+	if( !capture_thread ) {
+		return;
+	}
+
+	// Not back past the previous switch, that audio is another channel's.
+	const auto& state = capture_thread->state();
+	const uint64_t offset = state.baseband_bytes_received - state.baseband_bytes_dropped;
+	recorded_offset = std::max(recorded_offset, (offset > preroll) ? (offset - preroll) : 0);
+	channel_recorder->set_channel(recorded_offset, frequency);
+}
+
 ScannerView::~ScannerView() {
+	// Stop recording and hopping before the radio goes away under the threads
+	set_recording(false);
+	scan_thread.reset();
 	audio::output::stop();
 	receiver_model.disable();
 	baseband::shutdown();
@@ -102,23 +390,40 @@ ScannerView::ScannerView(
 		&field_rf_amp,
 		&field_volume,
 		&field_squelch,
+		&field_tone,
+		&check_record,
 		//&record_view,
 		&text_cycle,
+		&text_snr,
 		//&waterfall,
 	});
 	
-	// DEBUG
-	frequency_list.push_back(466025000);
-	frequency_list.push_back(466050000);
-	frequency_list.push_back(466075000);
-	frequency_list.push_back(466175000);
-	frequency_list.push_back(466206250);
-	frequency_list.push_back(466231250);
+	load_frequency_list();
 	
 	field_squelch.on_change = [this](int32_t v) {
 		squelch = v;
+		if( scan_thread ) {
+			scan_thread->set_threshold(-squelch);
+		}
 	};
 	field_squelch.set_value(30);
+	
+	// Decoded by the NFM baseband and reported with the channel statistics.
+	OptionsField::options_t tone_options { { "Any", 0 } };
+	for (size_t c = 1; c < 51; c++) {
+		const auto f = tonekey::tone_keys[c].second;
+		tone_options.emplace_back(to_string_dec_uint(f) + "." + to_string_dec_uint((uint32_t)(f * 10 + 0.5f) % 10), (int32_t)(f * 100 + 0.5f));
+	}
+	field_tone.set_options(tone_options);
+	field_tone.on_change = [this](size_t, int32_t v) {
+		tone = v;
+		tone_timer = 0;
+	};
+	field_tone.set_selected_index(0);
+
+	check_record.on_select = [this](Checkbox&, bool v) {
+		this->set_recording(v);
+	};
 
 	field_volume.set_value((receiver_model.headphone_volume() - audio::headphone::volume_range().max).decibel() + 99);
 	field_volume.on_change = [this](int32_t v) {
@@ -137,24 +442,70 @@ ScannerView::ScannerView(
 	receiver_model.set_nbfm_configuration(2);	// 16k
 	audio::output::unmute();
 	
-	// TODO: Scanning thread here
-	scan_thread = std::make_unique<ScannerThread>(frequency_list);
+	scan_thread = std::make_unique<ScannerThread>(frequency_list, revisit_list, receiver_model.sampling_rate(), receiver_model.baseband_bandwidth());
+	scan_thread->set_threshold(-squelch);
+}
+
+void ScannerView::load_frequency_list() {
+	// Streamed, so a large list costs no more memory than the channels kept.
+	for_each_freqman_entry("SCANNER", [this](const freqman_entry& entry) {
+		if( entry.type == RANGE ) {
+			for(auto f = entry.frequency_a; (f <= entry.frequency_b) && (frequency_list.size() < frequency_list_max); f += receiver_model.frequency_step()) {
+				frequency_list.push_back(f);
+				revisit_list.push_back(entry.revisit_ms);
+			}
+		} else {
+			frequency_list.push_back(entry.frequency_a);
+			revisit_list.push_back(entry.revisit_ms);
+		}
+		return frequency_list.size() < frequency_list_max;
+	});
+	
+	if( frequency_list.empty() ) {
+		// DEBUG
+		frequency_list.push_back(466025000);
+		frequency_list.push_back(466050000);
+		frequency_list.push_back(466075000);
+		frequency_list.push_back(466175000);
+		frequency_list.push_back(466206250);
+		frequency_list.push_back(466231250);
+	}
 }
 
 void ScannerView::on_statistics_update(const ChannelStatistics& statistics) {
-	int32_t max_db = statistics.max_db;
+	// Hop decisions are made by the baseband, statistics only matter while
+	// parked on a busy channel.
+	if (scan_thread->is_scanning()) {
+		timer = 0;
+		tone_timer = 0;
+		text_snr.set("");
+		return;
+	}
+
+	text_snr.set(
+		"Avg " + to_string_dec_int(statistics.average_db) + "dB SNR " +
+		to_string_dec_int(statistics.snr_db) + "dB"
+	);
 	
-	if (timer < 6)
-		timer++;
+	// Wrong or no tone: give the decoder a couple of its 0.5s blocks.
+	const auto& coded_squelch = statistics.coded_squelch;
+	if (tone && ((coded_squelch.type != CodedSquelch::Type::CTCSS) || (coded_squelch.value != tone))) {
+		if (++tone_timer >= 10) {
+			resume_scanning();
+			tone_timer = 0;
+			timer = 0;
+			return;
+		}
+	} else {
+		tone_timer = 0;
+	}
 	
-	if (max_db < -squelch) {
-		if (timer == 5) {
-			//audio::output::stop();
-			scan_thread->set_scanning(true);
+	if (statistics.max_db < -squelch) {
+		if (++timer >= 5) {
+			resume_scanning();
+			timer = 0;
 		}
 	} else {
-		//audio::output::start();
-		scan_thread->set_scanning(false);
 		timer = 0;
 	}
 }
@@ -21,18 +21,49 @@
  */
 
 #include "receiver_model.hpp"
+#include "radio.hpp"
 
 #include "ui_receiver.hpp"
 #include "ui_font_fixed_8x16.hpp"
 
+#include "capture_thread.hpp"
+#include "channel_recorder.hpp"
+
 namespace ui {
 
+/* Hops through a precomputed tuning table. After each retune the baseband
+ * measures the channel and reports back whether it is busy, as soon as a
+ * signal shows up or after a few buffers of quiet. A hop costs a handful of
+ * SPI writes plus a few milliseconds of dwell rather than the full tuning
+ * math and a fixed sleep.
+ */
 class ScannerThread {
 public:
-	ScannerThread(std::vector<rf::Frequency> frequency_list);
+	/* Channels are swept in frequency order, up then down, so the PLL
+	 * steps are short. Those that fit in the baseband span together (clear
+	 * of the DC offset) are screened at once from one tuning, see
+	 * ScanGroupConfigMessage; only those that screen busy get a dwell.
+	 *
+	 * Between sweep steps, the most overdue channel with a revisit
+	 * interval (revisit_ms, 0 for none, in list order) gets a dwell of
+	 * its own. Channels busy on any of their last 8 visits get one of
+	 * active_revisit_ms at most.
+	 */
+	ScannerThread(
+		std::vector<rf::Frequency> frequency_list,
+		const std::vector<uint16_t>& revisit_ms,
+		const uint32_t sampling_rate,
+		const uint32_t baseband_bandwidth
+	);
 	~ScannerThread();
 	
 	void set_scanning(const bool v);
+	bool is_scanning() const;
+	void set_threshold(const int32_t db);
+
+	/* Called from the event loop with the baseband's dwell verdict. */
+	void on_dwell_result(const ScanDwellResultMessage& message);
+	void on_group_result(const ScanGroupResultMessage& message);
 
 	ScannerThread(const ScannerThread&) = delete;
 	ScannerThread(ScannerThread&&) = delete;
@@ -40,13 +71,65 @@ public:
 	ScannerThread& operator=(ScannerThread&&) = delete;
 
 private:
+	// Covers the DMA buffers already in flight at the retune plus PLL lock.
+	static constexpr uint32_t settle_buffers = 4;
+	static constexpr uint32_t dwell_buffers = 3;
+	static constexpr uint32_t dwell_timeout_ms = 20;
+	// FM noise squelch on top of the level threshold, as the NFM app's default
+	static constexpr float noise_threshold = 0.8f;
+
+	static constexpr size_t group_channels_max = ScanGroupConfigMessage::channels_max;
+	static constexpr uint32_t group_dwell_buffers = 3;
+	// FFT bins aren't the channel filter: screen a little below the
+	// threshold so nothing busy is missed, the dwell has the last word.
+	static constexpr int32_t group_margin_db = 6;
+	// Channels kept this far from the LO's DC offset, and from the edges
+	// of the baseband filter.
+	static constexpr int32_t dc_guard_hz = 8000;
+	static constexpr int32_t edge_guard_hz = 100000;
+	static constexpr uint16_t active_revisit_ms = 1000;
+
+	/* members_[first, first + count) tuned together; a group of one is an
+	 * ordinary hop.
+	 */
+	struct Group {
+		rf::Frequency tuning;
+		radio::TuningSettings settings;
+		uint16_t first;
+		uint8_t count;
+	};
+
 	std::vector<rf::Frequency> frequency_list_ { };
+	std::vector<radio::TuningSettings> tuning_table_ { };
+	struct Channel {
+		systime_t last_visit;
+		uint16_t revisit_ms;
+		// Busy on each of the last visits, newest in bit 0.
+		uint8_t history;
+	};
+
+	std::vector<Group> groups_ { };
+	std::vector<uint16_t> members_ { };
+	std::vector<Channel> channels_ { };
+	uint32_t sampling_rate_;
 	Thread* thread { nullptr };
 	
 	bool _scanning { true };
+	int32_t threshold_db { -30 };
+	uint32_t sequence { 0 };
+	uint32_t result_sequence { 0 };
+	bool result_busy { false };
+	uint32_t group_result_sequence { 0 };
+	std::array<int8_t, group_channels_max> group_levels_db { };
 
 	static msg_t static_fn(void* arg);
 	
+	void build_groups(const uint32_t baseband_bandwidth);
+	void add_group(const rf::Frequency tuning, const size_t first, const size_t count);
+	bool dwell(const size_t index);
+	bool screen(const Group& group);
+	void visited(const size_t index, const bool busy);
+	int32_t overdue_channel() const;
 	void run();
 };
 
@@ -60,17 +143,38 @@ public:
 	std::string title() const override { return "Scanner"; };
 
 private:
+	static constexpr size_t frequency_list_max = 256;
+
+	void load_frequency_list();
 	void on_statistics_update(const ChannelStatistics& statistics);
 	void on_headphone_volume_changed(int32_t v);
 	void handle_retune(uint32_t i);
+	void handle_scan_dwell(const ScanDwellResultMessage& message);
+	void resume_scanning();
+	void set_recording(const bool enabled);
+	void set_recorded_channel(const rf::Frequency frequency, const uint64_t preroll = 0);
 	
 	std::vector<rf::Frequency> frequency_list { };
+	std::vector<uint16_t> revisit_list { };
 	int32_t squelch { 0 };
 	uint32_t timer { 0 };
+	// CTCSS tone to stop on in 1/100Hz, 0 for any signal.
+	uint32_t tone { 0 };
+	uint32_t tone_timer { 0 };
+
+	// Audio sample rate of the NFM 16k configuration
+	static constexpr size_t recording_sampling_rate = 24000;
+	// Audio from before the busy dwell was reported, so the segment has the
+	// dwell's (the first syllable).
+	static constexpr uint64_t recording_preroll_bytes = recording_sampling_rate * sizeof(int16_t) * 20 / 1000;
+	std::unique_ptr<CaptureThread> capture_thread { };
+	// Owned by capture_thread
+	ChannelRecorder* channel_recorder { nullptr };
+	uint64_t recorded_offset { 0 };
 	
 	Labels labels {
 		{ { 0 * 8, 0 * 16 }, "LNA:   VGA:   AMP:  VOL:", Color::light_grey() },
-		{ { 0 * 8, 1 * 16 }, "SQUELCH:  /99", Color::light_grey() },
+		{ { 0 * 8, 1 * 16 }, "SQUELCH:  /99 TONE:", Color::light_grey() },
 		{ { 0 * 8, 3 * 16 }, "Work in progress...", Color::light_grey() }
 	};
 	
@@ -102,10 +206,30 @@ private:
 		' ',
 	};
 	
+	OptionsField field_tone {
+		{ 19 * 8, 1 * 16 },
+		5,
+		{ }
+	};
+	
+	// Each visit to a channel into SCANNER/<frequency>.WAV, see ChannelRecorder
+	Checkbox check_record {
+		{ 0 * 8, 2 * 16 },
+		6,
+		"Record",
+		true
+	};
+
 	Text text_cycle {
 		{ 0, 5 * 16, 240, 16 },
 		"--/--"
 	};
+
+	// While parked, from ChannelStatistics
+	Text text_snr {
+		{ 0, 6 * 16, 240, 16 },
+		""
+	};
 	
 	std::unique_ptr<ScannerThread> scan_thread { };
 	
@@ -117,6 +241,33 @@ private:
 		}
 	};
 	
+	MessageHandlerRegistration message_handler_scan_dwell {
+		Message::ID::ScanDwellResult,
+		[this](const Message* const p) {
+			this->handle_scan_dwell(*reinterpret_cast<const ScanDwellResultMessage*>(p));
+		}
+	};
+	
+	MessageHandlerRegistration message_handler_scan_group {
+		Message::ID::ScanGroupResult,
+		[this](const Message* const p) {
+			if( this->scan_thread ) {
+				this->scan_thread->on_group_result(*reinterpret_cast<const ScanGroupResultMessage*>(p));
+			}
+		}
+	};
+	
+	MessageHandlerRegistration message_handler_capture_done {
+		Message::ID::CaptureThreadDone,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const CaptureThreadDoneMessage*>(p);
+			if( message.error ) {
+				this->set_recording(false);
+				this->text_cycle.set(File::Error { message.error }.what());
+			}
+		}
+	};
+
 	MessageHandlerRegistration message_handler_stats {
 		Message::ID::ChannelStatistics,
 		[this](const Message* const p) {
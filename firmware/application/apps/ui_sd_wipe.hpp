@@ -47,6 +47,7 @@ private:
 	static Thread* thread;
 	
 	static msg_t static_fn(void* arg) {
+		chRegSetThreadName("sdwipe");
 		auto obj = static_cast<WipeSDView*>(arg);
 		obj->run();
 		return 0;
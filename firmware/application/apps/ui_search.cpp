@@ -25,6 +25,8 @@
 #include "baseband_api.hpp"
 #include "string_format.hpp"
 
+#include <algorithm>
+
 using namespace portapack;
 
 namespace ui {
@@ -53,18 +55,78 @@ void SearchView::focus() {
 }
 
 SearchView::~SearchView() {
+	stop_sweep();
 	receiver_model.disable();
 	baseband::shutdown();
 }
 
-void SearchView::do_detection() {
-	uint8_t power_max = 0;
-	int32_t bin_max = -1;
-	uint32_t slice_max = 0;
-	uint32_t snap_value;
-	uint8_t power;
+rf::Frequency SearchView::bin_frequency(const size_t bin) const {
+	// Stitched bins are the middle 240 of the slice's 256 (128 = slice center)
+	const size_t slice = bin / SweepSpectrum::bins_per_slice;
+	const int32_t fft_bin = (bin % SweepSpectrum::bins_per_slice) + (SEARCH_BIN_NB - SEARCH_BIN_NB_NO_DC) / 2;
+	return slices[slice].center_frequency + (SEARCH_BIN_WIDTH * (fft_bin - 128));
+}
+
+void SearchView::track(const SweepSpectrum::Detection& detection) {
+	const auto frequency = bin_frequency(detection.bin);
+	const auto low = bin_frequency(detection.first) - 2 * SEARCH_BIN_WIDTH;
+	const auto high = bin_frequency(detection.first + detection.width - 1) + 2 * SEARCH_BIN_WIDTH;
+	
+	for (size_t i = 0; i < signals_nb; i++) {
+		auto& signal = signals[i];
+		if ((signal.frequency >= low) && (signal.frequency <= high)) {
+			signal.frequency = frequency;
+			signal.power = detection.power;
+			signal.last_seen = ticks;
+			signal.seen = true;
+			return;
+		}
+	}
+	
+	if (signals_nb < signals.size())
+		signals[signals_nb++] = { frequency, 0, ticks, ticks, 0, detection.power, true, false, false };
+}
+
+void SearchView::lock(signal_t& signal) {
 	rtc::RTC datetime;
-	std::string str_approx, str_timestamp;
+	std::string str_timestamp;
+	
+	signal.locked = true;
+	signal.locked_at = ticks;
+	signal.resolved_frequency = signal.frequency;
+	
+	if (check_snap.value()) {
+		const auto snap_value = options_snap.selected_index_value();
+		signal.resolved_frequency = round(signal.resolved_frequency / snap_value) * snap_value;
+	}
+	
+	// Check range
+	signal.in_range = (signal.resolved_frequency >= f_min) && (signal.resolved_frequency <= f_max);
+	if (!signal.in_range)
+		return;
+	
+	auto& entry = ::on_packet(recent, signal.resolved_frequency);
+	
+	rtcGetTime(&RTCD1, &datetime);
+	str_timestamp = to_string_dec_uint(datetime.hour(), 2, '0') + ":" +
+					to_string_dec_uint(datetime.minute(), 2, '0') + ":" +
+					to_string_dec_uint(datetime.second(), 2, '0');
+	entry.set_time(str_timestamp);
+	entry.set_duration(0);
+	recent_entries_view.update();
+}
+
+void SearchView::release(const signal_t& signal) {
+	if (!signal.in_range)
+		return;
+	
+	auto& entry = ::on_packet(recent, signal.resolved_frequency);
+	entry.set_duration(ticks - signal.locked_at);
+	recent_entries_view.update();
+}
+
+void SearchView::do_detection(const SweepSpectrum& spectrum) {
+	size_t count = std::min<size_t>(spectrum.detection_count, detections.size());
 	
 	// Display spectrum
 	bin_skip_acc = 0;
@@ -74,96 +136,63 @@ void SearchView::do_detection() {
 		spectrum_row
 	);
 	
-	mean_power = mean_acc / (SEARCH_BIN_NB_NO_DC * slices_nb);
-	mean_acc = 0;
+	mean_power = spectrum.mean;
+	overall_power_max = spectrum.max;
+	
+	// The baseband lists detections slice by slice, but keeps the strongest
+	// ones out of order when its list fills up
+	std::copy(spectrum.detections.begin(), spectrum.detections.begin() + count, detections.begin());
+	std::sort(detections.begin(), detections.begin() + count,
+		[](const SweepSpectrum::Detection& a, const SweepSpectrum::Detection& b) {
+			return a.first < b.first;
+		}
+	);
 	
-	overall_power_max = 0;
+	for (size_t i = 0; i < signals_nb; i++)
+		signals[i].seen = false;
 	
-	// Find max power over threshold for all slices
-	for (size_t slice = 0; slice < slices_nb; slice++) {
-		power = slices[slice].max_power;
-		if (power > overall_power_max)
-			overall_power_max = power;
+	int32_t bin_max = -1;
+	uint8_t power_max = 0;
+	for (size_t i = 0; i < count; ) {
+		// Join signals cut by a slice edge
+		auto detection = detections[i++];
+		while ((i < count) && (detections[i].first <= detection.first + detection.width + 1)) {
+			const auto& next = detections[i++];
+			detection.width = std::max<size_t>(detection.width, next.first + next.width - detection.first);
+			if (next.power > detection.power) {
+				detection.power = next.power;
+				detection.bin = next.bin;
+			}
+		}
+		
+		track(detection);
 		
-		if ((power >= mean_power + power_threshold) && (power > power_max)) {
-			power_max = power;
-			bin_max = slices[slice].max_index;
-			slice_max = slice;
+		if (detection.power > power_max) {
+			power_max = detection.power;
+			bin_max = detection.bin;
 		}
 	}
 	
 	// Lock / release
-	if ((bin_max >= last_bin - 2) && (bin_max <= last_bin + 2) && (bin_max > -1) && (slice_max == last_slice)) {
+	for (size_t i = 0; i < signals_nb; ) {
+		auto& signal = signals[i];
 		
-		// Staying around the same bin
-		if (detect_timer >= DETECT_DELAY) {
-			if ((bin_max != locked_bin) || (!locked)) {
-				
-				if (!locked) {
-					resolved_frequency = slices[slice_max].center_frequency + (SEARCH_BIN_WIDTH * (bin_max - 128));
-					
-					if (check_snap.value()) {
-						snap_value = options_snap.selected_index_value();
-						resolved_frequency = round(resolved_frequency / snap_value) * snap_value;
-					}
-					
-					// Check range
-					if ((resolved_frequency >= f_min) && (resolved_frequency <= f_max)) {
-						
-						duration = 0;
-						
-						auto& entry = ::on_packet(recent, resolved_frequency);
-						
-						rtcGetTime(&RTCD1, &datetime);
-						str_timestamp = to_string_dec_uint(datetime.hour(), 2, '0') + ":" +
-										to_string_dec_uint(datetime.minute(), 2, '0') + ":" +
-										to_string_dec_uint(datetime.second(), 2, '0');
-						entry.set_time(str_timestamp);
-						recent_entries_view.set_dirty();
-
-						text_infos.set("Locked ! ");
-						big_display.set_style(&style_locked);
-						
-						locked = true;
-						locked_bin = bin_max;
-						
-						// TODO
-						/*nav_.pop();
-						receiver_model.disable();
-						baseband::shutdown();
-						nav_.pop();*/
-
-						/*if (options_goto.selected_index() == 1)
-							nav_.push<AnalogAudioView>(false);
-						else if (options_goto.selected_index() == 2)
-							nav_.push<POCSAGAppView>();
-						*/
-					} else
-						text_infos.set("Out of range");
-				}
-				
-				big_display.set(resolved_frequency);
-			}
-		}
-		release_timer = 0;
-	} else {
-		detect_timer = 0;
-		if (locked) {
-			if (release_timer >= RELEASE_DELAY) {
-				locked = false;
-				
-				auto& entry = ::on_packet(recent, resolved_frequency);
-				entry.set_duration(duration);
-				recent_entries_view.set_dirty();
-				
-				text_infos.set("Listening");
-				big_display.set_style(&style_grey);
-			}
+		const bool drop = signal.locked ?
+			((ticks - signal.last_seen) >= RELEASE_DELAY) :
+			!signal.seen;		// Locking needs an unbroken run
+		if (drop) {
+			if (signal.locked)
+				release(signal);
+			signal = signals[--signals_nb];
+			continue;
 		}
+		
+		if (!signal.locked && ((ticks - signal.first_seen) >= DETECT_DELAY))
+			lock(signal);
+		i++;
 	}
 	
-	last_bin = bin_max;
-	last_slice = slice_max;
+	update_status();
 	search_counter++;
 	
 	// Refresh red tick
@@ -174,6 +203,46 @@ void SearchView::do_detection() {
 	}
 }
 
+void SearchView::update_status() {
+	// Strongest locked signal, or strongest signal
+	const signal_t* shown = nullptr;
+	size_t locked_nb = 0;
+	for (size_t i = 0; i < signals_nb; i++) {
+		const auto& signal = signals[i];
+		if (signal.locked)
+			locked_nb++;
+		if (!shown || (signal.locked > shown->locked) ||
+			((signal.locked == shown->locked) && (signal.power > shown->power)))
+			shown = &signal;
+	}
+	
+	if (!shown) {
+		progress_timers.set_max(DETECT_DELAY);
+		progress_timers.set_value(0);
+	} else if (shown->locked) {
+		progress_timers.set_max(RELEASE_DELAY);
+		progress_timers.set_value(RELEASE_DELAY - std::min<uint32_t>(ticks - shown->last_seen, RELEASE_DELAY));
+	} else {
+		progress_timers.set_max(DETECT_DELAY);
+		progress_timers.set_value(std::min<uint32_t>(ticks - shown->first_seen, DETECT_DELAY));
+	}
+	
+	if (!locked_nb) {
+		text_infos.set("Listening");
+		big_display.set_style(&style_grey);
+		return;
+	}
+	
+	if (!shown->in_range)
+		text_infos.set("Out of range");
+	else if (locked_nb == 1)
+		text_infos.set("Locked ! ");
+	else
+		text_infos.set("Locked x" + to_string_dec_uint(locked_nb));
+	big_display.set_style(&style_locked);
+	big_display.set(shown->resolved_frequency);
+}
+
 void SearchView::add_spectrum_pixel(Color color) {
 	// Is avoiding floats really necessary ?
 	bin_skip_acc += bin_skip_frac;
@@ -186,63 +255,60 @@ void SearchView::add_spectrum_pixel(Color color) {
 		spectrum_row[pixel_index++] = color;
 }
 
-void SearchView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
-	uint8_t max_power = 0;
-	int16_t max_bin = 0;
-	uint8_t power;
-	size_t bin;
-	
-	baseband::spectrum_streaming_stop();
+void SearchView::on_sweep_retune(const uint32_t slice) {
+	if (!sweeping || (slice >= slices_nb))
+		return;
 	
-	// Add pixels to spectrum display and find max power for this slice
-	// Center 12 bins are ignored (DC spike is blanked)
-	// Leftmost and rightmost 2 bins are ignored
-	for (bin = 0; bin < 256; bin++) {
+	receiver_model.set_tuning_frequency(slices[slice].center_frequency, slices[slice].tuning);
+	baseband::sweep_retuned(slice);
+}
 
-		if ((bin < 2) || (bin > 253) || ((bin >= 122) && (bin < 134))) {
-			power = 0;
-		} else {
-			if (bin < 128)
-				power = spectrum.db[128 + bin];
-			else
-				power = spectrum.db[bin - 128];
-		}
+void SearchView::on_sweep_spectrum(const SweepSpectrum& spectrum) {
+	size_t slice, bin;
+	
+	if (!sweeping || (spectrum.slice_count != slices_nb))
+		return;
+	
+	// Add pixels to spectrum display
+	// The baseband only sends the middle 240 bins (ascending frequency, DC spike interpolated)
+	for (slice = 0; slice < slices_nb; slice++) {
+		const auto slice_db = &spectrum.db[slice * SweepSpectrum::bins_per_slice];
 		
-		add_spectrum_pixel(spectrum_rgb3_lut[power]);
+		for (bin = 0; bin < SweepSpectrum::bins_per_slice; bin++)
+			add_spectrum_pixel(spectrum_rgb3_lut[slice_db[bin]]);
 		
-		mean_acc += power;
-		if (power > max_power) {
-			max_power = power;
-			max_bin = bin;
-		}
+		if (spectrum_log)
+			spectrum_log->on_sweep_slice(slice, slices_nb, slices[slice].center_frequency, SEARCH_BIN_WIDTH,
+				slice_db, SweepSpectrum::bins_per_slice);
 	}
 	
-	slices[slice_counter].max_power = max_power;
-	slices[slice_counter].max_index = max_bin;
-	
-	if (slices_nb > 1) {
-		// Slice sequence
-		if (slice_counter >= slices_nb) {
-			do_detection();
-			slice_counter = 0;
-		} else
-			slice_counter++;
-		receiver_model.set_tuning_frequency(slices[slice_counter].center_frequency);
-		baseband::set_spectrum(SEARCH_SLICE_WIDTH, 31);	// Clear
-	} else {
-		// Unique slice
-		do_detection();
-	}
+	do_detection(spectrum);
 	
-	baseband::spectrum_streaming_start();
+	// Spectrum has been consumed, let the baseband start the next sweep
+	on_sweep_retune(0);
+}
+
+void SearchView::start_sweep() {
+	sweeping = true;
+	receiver_model.set_tuning_frequency(slices[0].center_frequency, slices[0].tuning);
+	baseband::set_sweep(sweep_spectrum.get(), slices_nb,
+		(slices_nb > 1) ? SEARCH_SETTLE_BUFFERS : 0, SEARCH_FFTS_PER_SLICE, power_threshold);
+}
+
+void SearchView::stop_sweep() {
+	if (!sweeping)
+		return;
+	
+	sweeping = false;
+	baseband::set_sweep(nullptr, 0, 0, 0, 0);
 }
 
 void SearchView::on_show() {
-	baseband::spectrum_streaming_start();
+	start_sweep();
 }
 
 void SearchView::on_hide() {
-	baseband::spectrum_streaming_stop();
+	stop_sweep();
 }
 
 void SearchView::on_range_changed() {
@@ -256,36 +322,45 @@ void SearchView::on_range_changed() {
 	
 	if (search_span > SEARCH_SLICE_WIDTH) {
 		// ex: 100M~115M (15M span):
-		// slices_nb = (115M-100M)/2.5M = 6
-		slices_nb = (search_span + SEARCH_SLICE_WIDTH - 1) / SEARCH_SLICE_WIDTH;
-		if (slices_nb > 32) {
+		// slices_nb = (115M-100M)/2.34M = 7
+		slices_nb = (search_span + SEARCH_SLICE_STEP - 1) / SEARCH_SLICE_STEP;
+		if (slices_nb > SweepSpectrum::slices_max) {
 			text_slices.set("!!");
-			slices_nb = 32;
+			slices_nb = SweepSpectrum::slices_max;
 		} else {
 			text_slices.set(to_string_dec_uint(slices_nb, 2, ' '));
 		}
-		// slices_span = 6 * 2.5M = 15M
-		slices_span = slices_nb * SEARCH_SLICE_WIDTH;
-		// offset = 0 + 2.5/2 = 1.25M
-		offset = ((search_span - slices_span) / 2) + (SEARCH_SLICE_WIDTH / 2);
-		// slice_start = 100M + 1.25M = 101.25M
+		// slices_span = 7 * 2.34M = 16.4M
+		slices_span = slices_nb * SEARCH_SLICE_STEP;
+		// offset = -0.7M + 2.34/2 = 0.47M
+		offset = ((search_span - slices_span) / 2) + (SEARCH_SLICE_STEP / 2);
+		// slice_start = 100M + 0.47M = 100.47M
 		center_frequency = std::min(f_min, f_max) + offset;
 		
 		for (slice = 0; slice < slices_nb; slice++) {
 			slices[slice].center_frequency = center_frequency;
-			center_frequency += SEARCH_SLICE_WIDTH;
+			center_frequency += SEARCH_SLICE_STEP;
 		}
 	} else {
 		slices[0].center_frequency = (f_max + f_min) / 2;
-		receiver_model.set_tuning_frequency(slices[0].center_frequency);
 
 		slices_nb = 1;
 		text_slices.set(" 1");
 	}
 	
-	bin_skip_frac = 0xF000 / slices_nb;
+	// Tuning is precomputed so that each hop only pushes synthesizer registers
+	for (slice = 0; slice < slices_nb; slice++)
+		slices[slice].tuning = receiver_model.tuning_settings(slices[slice].center_frequency);
+	
+	bin_skip_frac = 0x10000 / slices_nb;
+	bin_skip_acc = 0;
+	pixel_index = 0;
+	signals_nb = 0;
 
 	slice_counter = 0;
+	
+	if (sweeping)
+		start_sweep();
 }
 
 void SearchView::on_lna_changed(int32_t v_db) {
@@ -320,21 +395,7 @@ void SearchView::do_timers() {
 	
 	if (timing_div % 6 == 0) {
 		// ~10Hz
-		
-		// Update timing indicator
-		if (locked) {
-			progress_timers.set_max(RELEASE_DELAY);
-			progress_timers.set_value(RELEASE_DELAY - release_timer);
-		} else {
-			progress_timers.set_max(DETECT_DELAY);
-			progress_timers.set_value(detect_timer);
-		}
-		
-		// Increment timers
-		if (detect_timer < DETECT_DELAY) detect_timer++;
-		if (release_timer < RELEASE_DELAY) release_timer++;
-		
-		if (locked) duration++;
+		ticks++;
 	}
 
 	timing_div++;
@@ -360,6 +421,7 @@ SearchView::SearchView(
 		&vu_max,
 		&progress_timers,
 		&check_snap,
+		&check_log,
 		&options_snap,
 		&big_display,
 		&recent_entries_view
@@ -381,9 +443,23 @@ SearchView::SearchView(
 	check_snap.set_value(true);
 	options_snap.set_selected_index(1);		// 12.5kHz
 	
+	check_log.on_select = [this, &nav](Checkbox&, bool v) {
+		spectrum_log.reset();
+		if (v) {
+			spectrum_log = std::make_unique<SpectrumLog>();
+			if (spectrum_log->append("SWEEP.BIN").is_valid()) {
+				spectrum_log.reset();
+				nav.display_modal("Error", "Can't open SWEEP.BIN");
+			}
+		}
+	};
+	
 	field_threshold.set_value(80);
 	field_threshold.on_change = [this](int32_t value) {
 		power_threshold = value;
+		// The baseband applies it
+		if (sweeping)
+			start_sweep();
 	};
 
 	field_frequency_min.set_value(receiver_model.tuning_frequency() - 1000000);
@@ -422,11 +498,12 @@ SearchView::SearchView(
 	
 	progress_timers.set_max(DETECT_DELAY);
 	
-	on_range_changed();
-
 	receiver_model.set_modulation(ReceiverModel::Mode::SpectrumAnalysis);
 	receiver_model.set_sampling_rate(SEARCH_SLICE_WIDTH);
 	receiver_model.set_baseband_bandwidth(2500000);
+	
+	on_range_changed();
+
 	receiver_model.enable();
 }
 
@@ -21,12 +21,16 @@
  */
 
 #include "receiver_model.hpp"
+#include "radio.hpp"
 
 #include "spectrum_color_lut.hpp"
 
 #include "ui_receiver.hpp"
 #include "ui_font_fixed_8x16.hpp"
 #include "recent_entries.hpp"
+#include "spectrum_log.hpp"
+
+#include <memory>
 
 namespace ui {
 
@@ -34,9 +38,13 @@ namespace ui {
 #define SEARCH_BIN_NB			256					// FFT power bins
 #define SEARCH_BIN_NB_NO_DC	(SEARCH_BIN_NB - 16)	// Bins after trimming
 #define SEARCH_BIN_WIDTH		(SEARCH_SLICE_WIDTH / SEARCH_BIN_NB)
+#define SEARCH_SLICE_STEP		(SEARCH_BIN_WIDTH * SEARCH_BIN_NB_NO_DC)	// Slices overlap by the trimmed bins
+#define SEARCH_SETTLE_BUFFERS	4		// Baseband buffers dropped after each retune
+#define SEARCH_FFTS_PER_SLICE	2		// Peak-held FFTs per slice
 
 #define DETECT_DELAY		5	// In 100ms units
 #define RELEASE_DELAY		6
+#define SIGNALS_MAX			8	// Tracked at once
 
 struct SearchRecentEntry {
 	using Key = rf::Frequency;
@@ -106,36 +114,57 @@ private:
 	
 	struct slice_t {
 		rf::Frequency center_frequency;
-		uint8_t max_power;
-		int16_t max_index;
+		radio::TuningSettings tuning;
+	} slices[SweepSpectrum::slices_max];
+	
+	// Built from the baseband's detections, a signal locks once it has been
+	// seen in every sweep for DETECT_DELAY, and is released when it hasn't
+	// been seen for RELEASE_DELAY
+	struct signal_t {
+		rf::Frequency frequency;			// Peak, as last seen
+		rf::Frequency resolved_frequency;	// Snapped, once locked
+		uint32_t first_seen;				// In 100ms units
+		uint32_t last_seen;
+		uint32_t locked_at;
 		uint8_t power;
-		int16_t index;
-	} slices[32];
+		bool seen;							// In the last sweep
+		bool locked;
+		bool in_range;						// Has an entry in recent
+	};
+	std::array<signal_t, SIGNALS_MAX> signals { };
+	size_t signals_nb { 0 };
+	std::array<SweepSpectrum::Detection, SweepSpectrum::detections_max> detections { };
 	
 	uint32_t bin_skip_acc { 0 }, bin_skip_frac { };
 	uint32_t pixel_index { 0 };
 	std::array<Color, 240> spectrum_row = { 0 };
-	ChannelSpectrumFIFO* fifo { nullptr };
+	std::unique_ptr<SweepSpectrum> sweep_spectrum { std::make_unique<SweepSpectrum>() };
+	std::unique_ptr<SpectrumLog> spectrum_log { };
+	bool sweeping { false };
 	rf::Frequency f_min { 0 }, f_max { 0 };
-	uint8_t detect_timer { 0 }, release_timer { 0 }, timing_div { 0 };
+	uint8_t timing_div { 0 };
+	uint32_t ticks { 0 };				// In 100ms units
 	uint8_t overall_power_max { 0 };
-	uint32_t mean_power { 0 }, mean_acc { 0 };
-	uint32_t duration { 0 };
+	uint32_t mean_power { 0 };
 	uint32_t power_threshold { 80 };	// Todo: Put this in persistent / settings
 	rf::Frequency slice_start { 0 };
 	uint8_t slices_nb { 0 };
 	uint8_t slice_counter { 0 };
-	int16_t last_bin { 0 };
-	uint32_t last_slice { 0 };
 	Coord last_tick_pos { 0 };
-	rf::Frequency search_span { 0 }, resolved_frequency { 0 };
-	uint16_t locked_bin { 0 };
+	rf::Frequency search_span { 0 };
 	uint8_t search_counter { 0 };
-	bool locked { false };
 	
-	void on_channel_spectrum(const ChannelSpectrum& spectrum);
+	void on_sweep_retune(const uint32_t slice);
+	void on_sweep_spectrum(const SweepSpectrum& spectrum);
+	void start_sweep();
+	void stop_sweep();
 	void on_range_changed();
-	void do_detection();
+	void do_detection(const SweepSpectrum& spectrum);
+	rf::Frequency bin_frequency(const size_t bin) const;
+	void track(const SweepSpectrum::Detection& detection);
+	void lock(signal_t& signal);
+	void release(const signal_t& signal);
+	void update_status();
 	void on_lna_changed(int32_t v_db);
 	void on_vga_changed(int32_t v_db);
 	void do_timers();
@@ -221,27 +250,36 @@ private:
 		}
 	};
 	
+	// Sweeps to SWEEP.BIN, see SpectrumLog
+	Checkbox check_log {
+		{ 25 * 8, 15 * 8 },
+		3,
+		"Log",
+		true
+	};
+	
 	BigFrequency big_display {
 		{ 4, 9 * 16, 28 * 8, 52 },
 		0
 	};
 	
-	MessageHandlerRegistration message_handler_spectrum_config {
-		Message::ID::ChannelSpectrumConfig,
+	MessageHandlerRegistration message_handler_sweep_retune {
+		Message::ID::SweepRetune,
+		[this](const Message* const p) {
+			const auto message = static_cast<const SweepRetuneMessage*>(p);
+			this->on_sweep_retune(message->slice);
+		}
+	};
+	MessageHandlerRegistration message_handler_sweep_spectrum {
+		Message::ID::SweepSpectrum,
 		[this](const Message* const p) {
-			const auto message = *reinterpret_cast<const ChannelSpectrumConfigMessage*>(p);
-			this->fifo = message.fifo;
+			const auto message = static_cast<const SweepSpectrumMessage*>(p);
+			this->on_sweep_spectrum(*message->spectrum);
 		}
 	};
 	MessageHandlerRegistration message_handler_frame_sync {
 		Message::ID::DisplayFrameSync,
 		[this](const Message* const) {
-			if( this->fifo ) {
-				ChannelSpectrum channel_spectrum;
-				while( fifo->out(channel_spectrum) ) {
-					this->on_channel_spectrum(channel_spectrum);
-				}
-			}
 			this->do_timers();
 		}
 	};
@@ -213,11 +213,17 @@ SetUIView::SetUIView(NavigationView& nav) {
 		&checkbox_bloff,
 		&options_bloff,
 		&checkbox_showsplash,
+		&checkbox_binary_logs,
+		&checkbox_usb_remote,
+		&checkbox_capture_segment,
+		&options_capture_segment,
 		&button_ok
 	});
 	
 	checkbox_showsplash.set_value(persistent_memory::config_splash());
 	checkbox_login.set_value(persistent_memory::config_login());
+	checkbox_binary_logs.set_value(persistent_memory::config_binary_logs());
+	checkbox_usb_remote.set_value(persistent_memory::config_usb_remote());
 	
 	uint32_t backlight_timer = persistent_memory::config_backlight_timer();
 	
@@ -228,14 +234,29 @@ SetUIView::SetUIView(NavigationView& nav) {
 		options_bloff.set_selected_index(0);
 	}
 
+	const uint32_t capture_segment = persistent_memory::config_capture_segment();
+	if (capture_segment) {
+		checkbox_capture_segment.set_value(true);
+		options_capture_segment.set_by_value(capture_segment);
+	} else {
+		options_capture_segment.set_selected_index(0);
+	}
+
 	button_ok.on_select = [&nav, this](Button&) {
 		if (checkbox_bloff.value())
 			persistent_memory::set_config_backlight_timer(options_bloff.selected_index() + 1);
 		else
 			persistent_memory::set_config_backlight_timer(0);
 		
+		if (checkbox_capture_segment.value())
+			persistent_memory::set_config_capture_segment(options_capture_segment.selected_index() + 1);
+		else
+			persistent_memory::set_config_capture_segment(0);
+		
 		persistent_memory::set_config_splash(checkbox_showsplash.value());
 		persistent_memory::set_config_login(checkbox_login.value());
+		persistent_memory::set_config_binary_logs(checkbox_binary_logs.value());
+		persistent_memory::set_config_usb_remote(checkbox_usb_remote.value());
 		nav.pop();
 	};
 }
@@ -441,16 +462,18 @@ void ModInfoView::focus() {
 		button_ok.focus();
 }*/
 
+static constexpr MenuEntry settings_menu[] {
+	{ "Audio", 			ui::Color::white(), &bitmap_icon_speaker,	menu_push<SetAudioView> },
+	{ "Radio",			ui::Color::white(), nullptr,	menu_push<SetRadioView> },
+	{ "UI", 			ui::Color::white(), nullptr,	menu_push<SetUIView> },
+	//{ "SD card modules", ui::Color::white(), [&nav](){ nav.push<ModInfoView>(); } },
+	{ "Date/Time",		ui::Color::white(), nullptr,	menu_push<SetDateTimeView> },
+	{ "Touch screen",	ui::Color::white(), nullptr,	menu_push<TouchCalibrationView> },
+	{ "Play dead",		ui::Color::white(), &bitmap_icon_playdead,	menu_push<SetPlayDeadView> },
+};
+
 SettingsMenuView::SettingsMenuView(NavigationView& nav) {
-	add_items({
-		{ "Audio", 			ui::Color::white(), &bitmap_icon_speaker,	[&nav](){ nav.push<SetAudioView>(); } },
-		{ "Radio",			ui::Color::white(), nullptr,	[&nav](){ nav.push<SetRadioView>(); } },
-		{ "UI", 			ui::Color::white(), nullptr,	[&nav](){ nav.push<SetUIView>(); } },
-		//{ "SD card modules", ui::Color::white(), [&nav](){ nav.push<ModInfoView>(); } },
-		{ "Date/Time",		ui::Color::white(), nullptr,	[&nav](){ nav.push<SetDateTimeView>(); } },
-		{ "Touch screen",	ui::Color::white(), nullptr,	[&nav](){ nav.push<TouchCalibrationView>(); } },
-		{ "Play dead",		ui::Color::white(), &bitmap_icon_playdead,	[&nav](){ nav.push<SetPlayDeadView>(); } }
-	});
+	set_entries(settings_menu, nav);
 	on_left = [&nav](){ nav.pop(); };
 }
 
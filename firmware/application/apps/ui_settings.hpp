@@ -195,11 +195,40 @@ private:
 	};
 	
 	Checkbox checkbox_showsplash {
-		{ 3 * 8, 9 * 16 },
+		{ 3 * 8, 8 * 16 + 8 },
 		11,
 		"Show splash"
 	};
 	
+	Checkbox checkbox_binary_logs {
+		{ 3 * 8, 10 * 16 },
+		18,
+		"Binary packet logs"
+	};
+	
+	Checkbox checkbox_usb_remote {
+		{ 3 * 8, 11 * 16 + 8 },
+		18,
+		"USB remote control"
+	};
+	
+	Checkbox checkbox_capture_segment {
+		{ 3 * 8, 13 * 16 },
+		21,
+		"Split captures every:"
+	};
+
+	OptionsField options_capture_segment {
+		{ 52, 14 * 16 + 8 },
+		10,
+		{
+			{ "1 minute", 60 },
+			{ "5 minutes", 300 },
+			{ "15 minutes", 900 },
+			{ "1 hour", 3600 }
+		}
+	};
+	
 	Button button_ok {
 		{ 2 * 8, 16 * 16, 12 * 8, 32 },
 		"OK"
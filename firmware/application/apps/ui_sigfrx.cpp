@@ -63,11 +63,11 @@ void SIGFRXView::paint(Painter& painter) {
 		painter.draw_string({ (ui::Coord)sigfrx_marks[(i*3)+1], 144-20 }, style_white, to_string_dec_uint(sigfrx_marks[(i*3)+2]) );
 		portapack::display.draw_line({xp, 144-4}, {xp, 144}, ui::Color::black());
 	}
+	// The fill above took the marker with it.
+	marker_x = -1;
 }
 
 void SIGFRXView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
-	portapack::display.fill_rectangle({0, 144, 240, 4},ui::Color::white());
-	
 	uint8_t xmax = 0, imax = 0;
 	size_t i;
 	
@@ -97,7 +97,15 @@ void SIGFRXView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
 	
 	last_channel = imax;
 	
-	portapack::display.fill_rectangle({(ui::Coord)(imax-2), 144, 4, 4}, ui::Color::red());
+	// Only the marker's old and new spots change, the rest of the strip stays.
+	const ui::Coord x = imax - 2;
+	if( x != marker_x ) {
+		if( marker_x >= 0 ) {
+			portapack::display.fill_rectangle({ marker_x, 144, 4, 4 }, ui::Color::white());
+		}
+		portapack::display.fill_rectangle({ x, 144, 4, 4 }, ui::Color::red());
+		marker_x = x;
+	}
 }
 
 void SIGFRXView::on_show() {
@@ -49,6 +49,7 @@ public:
 private:	
 	uint8_t last_channel;
 	uint8_t detect_counter = 0;
+	ui::Coord marker_x { -1 };
 	
 	const Style style_white {
 		.font = font::fixed_8x16,
@@ -25,6 +25,7 @@
 #include "tonesets.hpp"
 #include "portapack.hpp"
 #include "baseband_api.hpp"
+#include "freqman.hpp"
 
 #include <cstring>
 #include <stdio.h>
@@ -42,13 +43,40 @@ SigGenView::~SigGenView() {
 	baseband::shutdown();
 }
 
+bool SigGenView::load_hops() {
+	if (hop_files.empty())
+		return false;
+	
+	const uint32_t tone_delta = TONES_F2D(symfield_tone.value_dec_u32(), TONES_SAMPLERATE);
+	const uint32_t dwell_ms = field_dwell.value();
+	std::vector<TxSequencer::Step> hops { };
+	
+	for_each_freqman_entry(hop_files[options_hop_file.selected_index()], [&hops, tone_delta, dwell_ms](const freqman_entry& entry) {
+		if (entry.type == SINGLE)
+			hops.push_back({ entry.frequency_a, tone_delta, dwell_ms });
+		return hops.size() < TxSequencer::steps_max;
+	});
+	
+	return !hops.empty() && sequencer.set_steps(hops, TONES_SAMPLERATE);
+}
+
 void SigGenView::start_tx() {
+	const bool hop = checkbox_hop.value() && load_hops();
+	
 	transmitter_model.set_sampling_rate(1536000);
 	transmitter_model.set_rf_amp(true);
 	transmitter_model.set_baseband_bandwidth(1750000);
 	transmitter_model.enable();
 	
-	baseband::set_siggen_tone(symfield_tone.value_dec_u32());
+	update_tone();
+	
+	if (hop) {
+		// 1ms of silence covers the PLLs' lock
+		sequencer.start(0, 1000);
+		text_hop.set("1/" + to_string_dec_uint(sequencer.size()));
+	} else {
+		text_hop.set("");
+	}
 	
 	auto duration = field_stop.value();
 	if (!checkbox_auto.value())
@@ -57,7 +85,25 @@ void SigGenView::start_tx() {
 }
 
 void SigGenView::update_tone() {
-	baseband::set_siggen_tone(symfield_tone.value_dec_u32());
+	const uint32_t tones[2] = { symfield_tone.value_dec_u32(), symfield_tone2.value_dec_u32() };
+	
+	switch (options_mode.selected_index_value()) {
+		case MODE_TWO_TONES:
+			baseband::set_siggen_tones(tones, 2);
+			break;
+		case MODE_LINEAR:
+			baseband::set_siggen_sweep(SigGenSweepMessage::LINEAR, tones[0], tones[1], field_period.value());
+			break;
+		case MODE_LOG:
+			baseband::set_siggen_sweep(SigGenSweepMessage::LOG, tones[0], tones[1], field_period.value());
+			break;
+		case MODE_CHIRP:
+			baseband::set_siggen_sweep(SigGenSweepMessage::CHIRP, tones[0], tones[1], field_period.value());
+			break;
+		default:
+			baseband::set_siggen_tone(tones[0]);
+			break;
+	}
 }
 
 void SigGenView::on_tx_progress(const uint32_t progress, const bool done) {
@@ -80,11 +126,30 @@ SigGenView::SigGenView(
 		&symfield_tone,
 		&button_update,
 		&checkbox_auto,
+		&options_mode,
+		&symfield_tone2,
+		&field_period,
 		&checkbox_stop,
 		&field_stop,
+		&checkbox_hop,
+		&options_hop_file,
+		&field_dwell,
+		&text_hop,
 		&tx_view
 	});
 	
+	hop_files = get_freqman_files();
+	OptionsField::options_t hop_options { };
+	for (size_t n = 0; n < hop_files.size(); n++)
+		hop_options.emplace_back(hop_files[n].substr(0, 8), n);
+	options_hop_file.set_options(hop_options);
+	field_dwell.set_value(100);
+	
+	sequencer.on_step = [this](const size_t index, const uint32_t, const bool done) {
+		if (!done)
+			text_hop.set(to_string_dec_uint(index + 1) + "/" + to_string_dec_uint(sequencer.size()));
+	};
+	
 	options_shape.on_change = [this](size_t, OptionsField::value_t v) {
 		text_shape.set(shape_strings[v]);
 	};
@@ -97,6 +162,21 @@ SigGenView::SigGenView(
 			update_tone();
 	};
 	
+	symfield_tone2.set_sym(1, 3);			// 3000 Hz, the top of a voice channel
+	symfield_tone2.on_change = symfield_tone.on_change;
+	
+	options_mode.set_selected_index(0);
+	options_mode.on_change = [this](size_t, OptionsField::value_t) {
+		if (auto_update)
+			update_tone();
+	};
+	
+	field_period.set_value(1000);
+	field_period.on_change = [this](int32_t) {
+		if (auto_update)
+			update_tone();
+	};
+	
 	button_update.on_select = [this](Button&) {
 		update_tone();
 	};
@@ -118,6 +198,7 @@ SigGenView::SigGenView(
 	};
 	
 	tx_view.on_stop = [this]() {
+		sequencer.stop();
 		transmitter_model.disable();
 		tx_view.set_transmitting(false);
 	};
@@ -27,6 +27,7 @@
 #include "ui_widget.hpp"
 #include "ui_navigation.hpp"
 #include "ui_transmitter.hpp"
+#include "tx_sequencer.hpp"
 
 #include "portapack.hpp"
 #include "message.hpp"
@@ -46,6 +47,18 @@ private:
 	void start_tx();
 	void update_tone();
 	void on_tx_progress(const uint32_t progress, const bool done);
+	bool load_hops();
+	
+	std::vector<std::string> hop_files { };
+	TxSequencer sequencer { };
+	
+	enum Mode : int32_t {
+		MODE_TONE = 0,
+		MODE_TWO_TONES,
+		MODE_LINEAR,
+		MODE_LOG,
+		MODE_CHIRP
+	};
 	
 	const std::string shape_strings[7] = {
 		"CW",
@@ -63,7 +76,10 @@ private:
 		{ { 6 * 8, 4 + 10 }, "Shape:", Color::light_grey() },
 		{ { 7 * 8, 7 * 8 }, "Tone:      Hz", Color::light_grey() },
 		{ { 22 * 8, 15 * 8 + 4 }, "s.", Color::light_grey() },
-		{ { 8 * 8, 20 * 8 }, "Modulation: FM", Color::light_grey() }
+		{ { 7 * 8, 17 * 8 + 4 }, "Mode:", Color::light_grey() },
+		{ { 5 * 8, 20 * 8 }, "Tone 2:      Hz", Color::light_grey() },
+		{ { 25 * 8, 20 * 8 }, "ms", Color::light_grey() },
+		{ { 6 * 8, 25 * 8 }, "Dwell:     ms", Color::light_grey() }
 	};
 	
 	ImageOptionsField options_shape {
@@ -103,6 +119,34 @@ private:
 		"Auto"
 	};
 	
+	// Two tones sum at the same total level; sweeps run from Tone to
+	// Tone 2 in the period, over and over, chirps back down again.
+	OptionsField options_mode {
+		{ 13 * 8, 17 * 8 + 4 },
+		9,
+		{
+			{ "Tone", MODE_TONE },
+			{ "2 tones", MODE_TWO_TONES },
+			{ "Lin sweep", MODE_LINEAR },
+			{ "Log sweep", MODE_LOG },
+			{ "Chirp", MODE_CHIRP }
+		}
+	};
+	
+	SymField symfield_tone2 {
+		{ 13 * 8, 20 * 8 },
+		5,
+		SymField::SYMFIELD_DEC
+	};
+	
+	NumberField field_period {
+		{ 21 * 8, 20 * 8 },
+		4,
+		{ 1, 9999 },
+		1,
+		' '
+	};
+	
 	Checkbox checkbox_stop {
 		{ 5 * 8, 15 * 8 },
 		10,
@@ -117,6 +161,33 @@ private:
 		' '
 	};
 	
+	// Hops through a frequency list's single frequencies, the baseband
+	// keeping time
+	Checkbox checkbox_hop {
+		{ 5 * 8, 22 * 8 },
+		3,
+		"Hop"
+	};
+	
+	OptionsField options_hop_file {
+		{ 14 * 8, 22 * 8 + 4 },
+		8,
+		{ }
+	};
+	
+	NumberField field_dwell {
+		{ 13 * 8, 25 * 8 },
+		4,
+		{ 10, 9990 },
+		10,
+		' '
+	};
+	
+	Text text_hop {
+		{ 20 * 8, 25 * 8, 9 * 8, 16 },
+		""
+	};
+	
 	TransmitterView tx_view {
 		16 * 16,
 		10000,
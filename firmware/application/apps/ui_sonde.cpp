@@ -28,6 +28,14 @@ using namespace portapack;
 
 #include "string_format.hpp"
 
+#include <cmath>
+
+static std::string degrees_formatted(const float value, const char suffixes[2]) {
+	const auto suffix = suffixes[(value < 0) ? 0 : 1];
+	const uint32_t value_abs = std::abs(value) * 10000.0f + 0.5f;
+	return to_string_dec_uint(value_abs / 10000) + "." + to_string_dec_uint(value_abs % 10000, 4, '0') + suffix;
+}
+
 void SondeLogger::on_packet(const sonde::Packet& packet) {
 	const auto formatted = packet.symbols_formatted();
 	log_file.write_entry(packet.received_at(), formatted.data);
@@ -49,8 +57,12 @@ SondeView::SondeView(NavigationView& nav) {
 		&text_signature,
 		&text_serial,
 		&text_voltage,
+		&text_fec,
 		&geopos,
-		&button_see_map
+		&button_see_map,
+		&text_rate,
+		&text_landing,
+		&text_landing_time
 	});
 
 	field_frequency.set_value(target_frequency_);
@@ -83,15 +95,17 @@ SondeView::SondeView(NavigationView& nav) {
 		static_cast<int8_t>(receiver_model.lna()),
 		static_cast<int8_t>(receiver_model.vga()),
 	});
+	receiver_model.set_gain_control(true);
 
 	button_see_map.on_select = [this, &nav](Button&) {
-		nav.push<GeoMapView>(
+		auto geomap_view = nav.push<GeoMapView>(
 			"",
 			altitude,
 			GeoPos::alt_unit::METERS,
 			latitude,
 			longitude,
 			0);
+		geomap_view->set_tracks(&track);
 	};
 	
 	logger = std::make_unique<SondeLogger>();
@@ -101,6 +115,7 @@ SondeView::SondeView(NavigationView& nav) {
 }
 
 SondeView::~SondeView() {
+	receiver_model.set_gain_control(false);
 	radio::disable();
 	baseband::shutdown();
 }
@@ -113,16 +128,34 @@ void SondeView::on_packet(const sonde::Packet& packet) {
 	//const auto hex_formatted = packet.symbols_formatted();
 	
 	text_signature.set(packet.type_string());
-	text_serial.set(packet.serial_number());
-	text_voltage.set(unit_auto_scale(packet.battery_voltage(), 2, 3) + "V");
-	
-	altitude = packet.GPS_altitude();
-	latitude = packet.GPS_latitude();
-	longitude = packet.GPS_longitude();
-	
-	geopos.set_altitude(altitude);
-	geopos.set_lat(latitude);
-	geopos.set_lon(longitude);
+
+	if (packet.type() == sonde::Packet::Type::Vaisala_RS41_SG) {
+		const auto corrected = packet.fec_corrected();
+		text_fec.set((corrected < 0) ? "Failed" : (to_string_dec_int(corrected) + " fixed"));
+	} else {
+		text_fec.set("-");
+	}
+
+	// A damaged block leaves the last good values up.
+	if (packet.status_valid()) {
+		text_serial.set(packet.serial_number());
+		text_voltage.set(unit_auto_scale(packet.battery_voltage(), 2, 3) + "V");
+	}
+
+	if (packet.GPS_valid()) {
+		altitude = packet.GPS_altitude();
+		latitude = packet.GPS_latitude();
+		longitude = packet.GPS_longitude();
+
+		geopos.set_altitude(altitude);
+		geopos.set_lat(latitude);
+		geopos.set_lon(longitude);
+		track.add(0, latitude, longitude);
+		predictor.add_fix(altitude, latitude, longitude);
+	}
+
+	// The predictor works behind, this shows what it had from the last fix.
+	show_prediction();
 	
 	if (logger && logging) {
 		logger->on_packet(packet);
@@ -132,6 +165,26 @@ void SondeView::on_packet(const sonde::Packet& packet) {
 	}*/
 }
 
+void SondeView::show_prediction() {
+	const auto prediction = predictor.prediction();
+	if( !prediction.valid ) {
+		return;
+	}
+
+	const int32_t rate_dm = prediction.vertical_rate * 10.0f;
+	const auto rate_abs = std::abs(rate_dm);
+	text_rate.set(
+		std::string { (rate_dm < 0) ? "-" : "+" } +
+		to_string_dec_uint(rate_abs / 10) + "." + to_string_dec_uint(rate_abs % 10) + "m/s " +
+		(prediction.descending ? "down" : "up")
+	);
+	text_landing.set(degrees_formatted(prediction.lat, "SN") + " " + degrees_formatted(prediction.lon, "WE"));
+	text_landing_time.set(
+		to_string_dec_uint(prediction.seconds / 60) + "min" +
+		(prediction.descending ? "" : " (30km burst)")
+	);
+}
+
 void SondeView::set_target_frequency(const uint32_t new_value) {
 	target_frequency_ = new_value;
 	radio::set_tuning_frequency(tuning_frequency());
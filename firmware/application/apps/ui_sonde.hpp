@@ -33,6 +33,7 @@
 #include "log_file.hpp"
 
 #include "sonde_packet.hpp"
+#include "sonde_predictor.hpp"
 
 #include <cstddef>
 #include <string>
@@ -44,6 +45,7 @@ public:
 	}
 	
 	void on_packet(const sonde::Packet& packet);
+	void show_prediction();
 
 private:
 	LogFile log_file { };
@@ -70,11 +72,18 @@ private:
 	int32_t altitude { 0 };
 	float latitude { 0 };
 	float longitude { 0 };
+	// The flight so far, one sonde at a time.
+	GeoTrackStore<1, 64> track { };
+	SondePredictor predictor { };
 	
 	Labels labels {
 		{ { 0 * 8, 2 * 16 }, "Signature:", Color::light_grey() },
 		{ { 3 * 8, 3 * 16 }, "Serial:", Color::light_grey() },
-		{ { 4 * 8, 4 * 16 }, "Vbatt:", Color::light_grey() }
+		{ { 4 * 8, 4 * 16 }, "Vbatt:", Color::light_grey() },
+		{ { 6 * 8, 5 * 16 }, "FEC:", Color::light_grey() },
+		{ { 5 * 8, 14 * 16 }, "Rate:", Color::light_grey() },
+		{ { 5 * 8, 15 * 16 }, "Land:", Color::light_grey() },
+		{ { 7 * 8, 16 * 16 }, "In:", Color::light_grey() }
 	};
 
 	FrequencyField field_frequency {
@@ -114,6 +123,11 @@ private:
 		{ 10 * 8, 4 * 16, 10 * 8, 16 },
 		"..."
 	};
+
+	Text text_fec {
+		{ 10 * 8, 5 * 16, 10 * 8, 16 },
+		"..."
+	};
 	
 	GeoPos geopos {
 		{ 0, 6 * 16 },
@@ -125,16 +139,30 @@ private:
 		"See on map"
 	};
 
+	Text text_rate {
+		{ 11 * 8, 14 * 16, 19 * 8, 16 },
+		"..."
+	};
+	Text text_landing {
+		{ 11 * 8, 15 * 16, 19 * 8, 16 },
+		"..."
+	};
+	Text text_landing_time {
+		{ 11 * 8, 16 * 16, 19 * 8, 16 },
+		"..."
+	};
+
 	MessageHandlerRegistration message_handler_packet {
 		Message::ID::SondePacket,
 		[this](Message* const p) {
 			const auto message = static_cast<const SondePacketMessage*>(p);
-			const sonde::Packet packet { message->packet, message->type };
+			const sonde::Packet packet { message->packet, message->type, message->fec_corrected };
 			this->on_packet(packet);
 		}
 	};
 
 	void on_packet(const sonde::Packet& packet);
+	void show_prediction();
 	void set_target_frequency(const uint32_t new_value);
 	uint32_t tuning_frequency() const;
 };
@@ -27,11 +27,49 @@
 #include "string_format.hpp"
 #include "tonesets.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 using namespace tonekey;
 using namespace portapack;
 
 namespace ui {
 
+SoundReader::SoundReader(
+	const std::filesystem::path& path,
+	const uint8_t* const head,
+	const size_t head_size
+) : path { path },
+	head_size { std::min(head_size, head_max) }
+{
+	memcpy(this->head.data(), head, this->head_size);
+}
+
+File::Result<File::Size> SoundReader::read(void* const buffer, const File::Size bytes) {
+	auto p = static_cast<uint8_t*>(buffer);
+	const size_t from_head = std::min<size_t>(bytes, head_size - head_offset);
+	memcpy(p, &head[head_offset], from_head);
+	head_offset += from_head;
+	if( from_head == bytes ) {
+		return { bytes };
+	}
+
+	if( !file_open ) {
+		if( !file.open(path) ) {
+			return File::Error { FR_NO_FILE };
+		}
+		// 8 bit mono, a sample per byte
+		file.data_seek(head_size);
+		file_open = true;
+	}
+
+	auto read_result = file.read(&p[from_head], bytes - from_head);
+	if( read_result.is_error() ) {
+		return read_result;
+	}
+	return { from_head + read_result.value() };
+}
+
 // TODO: Use Sharebrained's PRNG
 void SoundBoardView::do_random() {
 	uint32_t id;
@@ -61,9 +99,9 @@ void SoundBoardView::stop(const bool do_loop) {
 		play_sound(playing_id);
 	} else {
 		radio::disable();
+		tx_sample_rate = 0;
 		//button_play.set_bitmap(&bitmap_play);
 	}
-	ready_signal = false;
 }
 
 void SoundBoardView::handle_replay_thread_done(const uint32_t return_code) {
@@ -77,10 +115,6 @@ void SoundBoardView::handle_replay_thread_done(const uint32_t return_code) {
 	progressbar.set_value(0);
 }
 
-void SoundBoardView::set_ready() {
-	ready_signal = true;
-}
-
 void SoundBoardView::focus() {
 	buttons[0].focus();
 
@@ -97,37 +131,44 @@ void SoundBoardView::file_error() {
 }
 
 void SoundBoardView::play_sound(uint16_t id) {
-	uint32_t sample_rate = 0;
-	auto reader = std::make_unique<WAVFileReader>();
 	uint32_t tone_key_index = options_tone_key.selected_index();
 	
-	stop(false);
-
-	if (!reader->open(sounds[id].path)) {
+	if (id >= max_sound) {
+		stop(false);
 		file_error();
 		return;
 	}
 	
+	// Re-arm: replace the replay pipeline but leave the radio running if
+	// the new sound doesn't need a different sample rate.
+	if( is_active() )
+		replay_thread.reset();
+	
+	if (head.id != id)
+		cache_head(id);
+	
 	playing_id = id;
 	
-	progressbar.set_max(reader->sample_count());
-	sample_rate = reader->sample_rate() * 32;
+	progressbar.set_max(sounds[id].sample_count);
+	const uint32_t sample_rate = sounds[id].sample_rate * 32;
+	const bool rearm = (sample_rate == tx_sample_rate);
 	
-	if( reader ) {
-		//button_play.set_bitmap(&bitmap_stop);
+	if (!rearm) {
+		if (tx_sample_rate)
+			radio::disable();
 		baseband::set_sample_rate(sample_rate);
-		
-		replay_thread = std::make_unique<ReplayThread>(
-			std::move(reader),
-			read_size, buffer_count,
-			&ready_signal,
-			[](uint32_t return_code) {
-				ReplayThreadDoneMessage message { return_code };
-				EventDispatcher::send_message(message);
-			}
-		);
 	}
 	
+	//button_play.set_bitmap(&bitmap_stop);
+	replay_thread = std::make_unique<ReplayThread>(
+		std::make_unique<SoundReader>(sounds[id].path, head.data.data(), head.size),
+		read_size, buffer_count,
+		[](uint32_t return_code) {
+			ReplayThreadDoneMessage message { return_code };
+			EventDispatcher::send_message(message);
+		}
+	);
+	
 	baseband::set_audiotx_config(
 		0,	// Divider is unused
 		number_bw.value() * 1000,
@@ -135,21 +176,45 @@ void SoundBoardView::play_sound(uint16_t id) {
 		TONES_F2D(tone_key_frequency(tone_key_index), sample_rate)
 	);
 	
-	radio::enable({
-		receiver_model.tuning_frequency(),
-		sample_rate,
-		1750000,
-		rf::Direction::Transmit,
-		receiver_model.rf_amp(),
-		static_cast<int8_t>(receiver_model.lna()),
-		static_cast<int8_t>(receiver_model.vga())
-	});
+	if (!rearm) {
+		radio::enable({
+			receiver_model.tuning_frequency(),
+			sample_rate,
+			1750000,
+			rf::Direction::Transmit,
+			receiver_model.rf_amp(),
+			static_cast<int8_t>(receiver_model.lna()),
+			static_cast<int8_t>(receiver_model.vga())
+		});
+		tx_sample_rate = sample_rate;
+	}
+}
+
+// Reads the head of a sound into RAM, ahead of the key press that plays it
+void SoundBoardView::cache_head(uint16_t id) {
+	if (id == head.id)
+		return;
+	
+	head.id = id;
+	head.size = 0;
+	
+	if (id >= max_sound)
+		return;
+	
+	auto reader = std::make_unique<WAVFileReader>();
+	if (reader->open(sounds[id].path)) {
+		auto read_result = reader->read(head.data.data(), head.data.size());
+		if (!read_result.is_error())
+			head.size = read_result.value();
+	}
 }
 
 void SoundBoardView::show_infos(uint16_t id) {
 	text_duration.set(to_string_time_ms(sounds[id].ms_duration));
 	
 	text_title.set(sounds[id].title);
+	
+	cache_head(id);
 }
 
 void SoundBoardView::refresh_buttons(uint16_t id) {
@@ -210,6 +275,8 @@ SoundBoardView::SoundBoardView(
 			if (reader->open(u"WAV/" + entry.path().native())) {
 				if ((reader->channels() == 1) && (reader->bits_per_sample() == 8)) {
 					sounds[c].ms_duration = reader->ms_duration();
+					sounds[c].sample_rate = reader->sample_rate();
+					sounds[c].sample_count = reader->sample_count();
 					sounds[c].path = u"WAV/" + entry.path().native();
 					std::string title = reader->title().substr(0, 20);
 					if (title != "")
@@ -34,6 +34,28 @@
 
 namespace ui {
 
+/* Hands out the first head_size bytes of a sound from RAM, then opens the
+ * file and carries on from there. Replay prefill is served from the head
+ * alone, so playback starts without touching the SD card and the file is
+ * opened while the baseband plays out the prefilled buffers.
+ */
+class SoundReader : public stream::Reader {
+public:
+	static constexpr size_t head_max = 2048;
+
+	SoundReader(const std::filesystem::path& path, const uint8_t* const head, const size_t head_size);
+
+	File::Result<File::Size> read(void* const buffer, const File::Size bytes) override;
+
+private:
+	const std::filesystem::path path;
+	std::array<uint8_t, head_max> head { };
+	const size_t head_size;
+	size_t head_offset { 0 };
+	WAVFileReader file { };
+	bool file_open { false };
+};
+
 class SoundBoardView : public View {
 public:
 	SoundBoardView(NavigationView& nav);
@@ -62,6 +84,15 @@ private:
 		std::filesystem::path path { };
 		uint32_t ms_duration = 0;
 		std::string title { };
+		uint32_t sample_rate = 0;
+		uint32_t sample_count = 0;
+	};
+	
+	// Head of the highlighted sound, the one a key press will play
+	struct sound_head {
+		uint32_t id = 0xFFFFFFFF;
+		size_t size = 0;
+		std::array<uint8_t, SoundReader::head_max> data { };
 	};
 	
 	uint32_t sample_counter { 0 };
@@ -75,10 +106,12 @@ private:
 	uint8_t max_page { };
 	uint32_t playing_id { };
 
-	const size_t read_size { 2048 };	// Less ?
-	const size_t buffer_count { 3 };
+	static constexpr size_t read_size { 512 };
+	static constexpr size_t buffer_count { 4 };
+	static_assert(read_size * buffer_count == SoundReader::head_max, "Prefill must come from the sound head");
 	std::unique_ptr<ReplayThread> replay_thread { };
-	bool ready_signal { false };
+	sound_head head { };
+	uint32_t tx_sample_rate { 0 };		// Non-zero while the radio is on
 	
 	Style style_a {
 		.font = font::fixed_8x16,
@@ -108,13 +141,13 @@ private:
 	
 	void do_random();
 	void show_infos(uint16_t id);
+	void cache_head(uint16_t id);
 	bool change_page(Button& button, const KeyEvent key);
 	void refresh_buttons(uint16_t id);
 	void play_sound(uint16_t id);
 	void on_ctcss_changed(uint32_t v);
 	void stop(const bool do_loop);
 	bool is_active() const;
-	void set_ready();
 	void handle_replay_thread_done(const uint32_t return_code);
 	void file_error();
 	void on_tx_progress(const uint32_t progress);
@@ -183,16 +216,6 @@ private:
 		}
 	};
 	
-	MessageHandlerRegistration message_handler_fifo_signal {
-		Message::ID::RequestSignal,
-		[this](const Message* const p) {
-			const auto message = static_cast<const RequestSignalMessage*>(p);
-			if (message->signal == RequestSignalMessage::Signal::FillRequest) {
-				this->set_ready();
-			}
-		}
-	};
-	
 	MessageHandlerRegistration message_handler_tx_progress {
 		Message::ID::TXProgress,
 		[this](const Message* const p) {
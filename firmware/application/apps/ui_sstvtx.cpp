@@ -33,6 +33,63 @@ using namespace portapack;
 
 namespace ui {
 
+SSTVPrefetchThread::SSTVPrefetchThread(
+	const std::filesystem::path& path,
+	const uint32_t image_data,
+	const size_t line_count
+) : image_data { image_data },
+	line_count { line_count }
+{
+	file_ok = !file.open(path).is_valid();
+	// Need significant stack for FATFS
+	thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO + 10, SSTVPrefetchThread::static_fn, this);
+}
+
+SSTVPrefetchThread::~SSTVPrefetchThread() {
+	if( thread ) {
+		chThdTerminate(thread);
+		chThdWait(thread);
+		thread = nullptr;
+	}
+}
+
+const uint8_t* SSTVPrefetchThread::line(const size_t n) {
+	if( n > lines_released ) {
+		lines_released = n;
+	}
+	return (n < lines_read) ? lines[n % lines_max].data() : nullptr;
+}
+
+msg_t SSTVPrefetchThread::static_fn(void* arg) {
+	chRegSetThreadName("sstv");
+	auto obj = static_cast<SSTVPrefetchThread*>(arg);
+	obj->run();
+	return 0;
+}
+
+void SSTVPrefetchThread::run() {
+	while( !chThdShouldTerminate() && (lines_read < line_count) ) {
+		if( (lines_read - lines_released) >= lines_max ) {
+			chThdSleepMilliseconds(10);
+			continue;
+		}
+		
+		// Bitmaps are stored bottom-up. A line that can't be read goes out black.
+		const size_t n = lines_read;
+		auto& buffer = lines[n % lines_max];
+		bool read_ok = false;
+		if( file_ok ) {
+			file.seek(image_data + (line_count - 1 - n) * line_bytes);
+			const auto read_result = file.read(buffer.data(), line_bytes);
+			read_ok = read_result.is_ok() && (read_result.value() == line_bytes);
+		}
+		if( !read_ok ) {
+			buffer.fill(0);
+		}
+		lines_read = n + 1;
+	}
+}
+
 void SSTVTXView::focus() {
 	if (file_error)
 		nav_.display_modal("No files", "No valid bitmaps\nin /sstv directory.", ABORT, nullptr);
@@ -40,30 +97,6 @@ void SSTVTXView::focus() {
 		options_bitmaps.focus();
 }
 
-void SSTVTXView::read_boundary(uint8_t * const buffer, uint32_t position, uint32_t length) {
-	uint32_t to_read, split;
-	uint8_t * buffer_copy = buffer;
-	
-	bmp_file.seek(position);
-	
-	// FatFS bug workaround: we can't read across 512 byte boundaries ?!
-	while (length) {
-		to_read = (length <= 512) ? length : 512;
-		if ((position & 512) != ((position + to_read - 1) & 512)) {
-			// Crossing: do 2 reads before and after the boundary
-			split = 512 - (position & 511);
-			bmp_file.read(buffer_copy, split);
-			bmp_file.read(buffer_copy + split, to_read - split);
-		} else {
-			// No crossing, just read normally
-			bmp_file.read(buffer_copy, to_read);
-		}
-		position += to_read;
-		buffer_copy += to_read;
-		length -= to_read;
-	}
-}
-
 void SSTVTXView::paint(Painter&) {
 	ui::Color line_buffer[160];
 	Coord line;
@@ -74,7 +107,8 @@ void SSTVTXView::paint(Painter&) {
 	for (line = 0; line < (256 / 2); line++) {
 		
 		// Buffer a whole line
-		read_boundary(pixels_buffer, data_idx, sizeof(pixels_buffer));
+		bmp_file.seek(data_idx);
+		bmp_file.read(pixels_buffer, sizeof(pixels_buffer));
 		
 		for (bmp_px = 0; bmp_px < 160; bmp_px++) {
 			pixel_idx = bmp_px * 3 * 2;
@@ -88,6 +122,7 @@ void SSTVTXView::paint(Painter&) {
 }
 
 SSTVTXView::~SSTVTXView() {
+	prefetch_thread.reset();
 	transmitter_model.disable();
 	baseband::shutdown();
 }
@@ -97,11 +132,17 @@ void SSTVTXView::on_tuning_frequency_changed(rf::Frequency f) {
 }
 
 void SSTVTXView::prepare_scanline() {
-	sstv_scanline scanline_buffer;
+	sstv_scanline scanline_buffer { };
 	uint32_t component, pixel_idx;
 	uint8_t offset;
 	
 	if (scanline_counter >= (256 * 3)) {
+		// Asked two lines ahead: the first request past the end comes with
+		// the last line still to send
+		if (scanline_counter++ == (256 * 3))
+			return;
+		
+		prefetch_thread.reset();
 		progressbar.set_value(0);
 		transmitter_model.disable();
 		options_bitmaps.set_focusable(true);
@@ -109,6 +150,9 @@ void SSTVTXView::prepare_scanline() {
 		return;
 	}
 	
+	if (!prefetch_thread)
+		return;
+	
 	progressbar.set_value(scanline_counter);
 
 	// Scottie 2 scanline:
@@ -139,17 +183,15 @@ void SSTVTXView::prepare_scanline() {
 		}
 	}
 	
-	if (!component) {
-		// Read a new line
-		read_boundary(pixels_buffer,
-						bmp_header.image_data + ((255 - (scanline_counter / 3)) * sizeof(pixels_buffer)),
-						sizeof(pixels_buffer));
-	}
+	// Only waits before the first line, the prefetch thread runs lines ahead
+	const uint8_t* pixels;
+	while (!(pixels = prefetch_thread->line(scanline_counter / 3)))
+		chThdSleepMilliseconds(5);
 	
 	offset = component_map[component];
 	for (uint32_t bmp_px = 0; bmp_px < 320; bmp_px++) {
 		pixel_idx = bmp_px * 3;
-		scanline_buffer.luma[bmp_px] = pixels_buffer[pixel_idx + offset];
+		scanline_buffer.luma[bmp_px] = pixels[pixel_idx + offset];
 	}
 	
 	baseband::set_fifo_data((int8_t *)&scanline_buffer);
@@ -158,13 +200,16 @@ void SSTVTXView::prepare_scanline() {
 }
 
 void SSTVTXView::start_tx() {
-	// The baseband SSTV TX code (proc_sstv) has a 2-scanline buffer. It is preloaded before
-	// TX start, and asks for fill-up when a new scanline starts being read. This should
-	// leave enough time for the code in prepare_scanline() before it ends.
+	// The baseband SSTV TX code (proc_sstvtx) has a 2-scanline buffer. Both are loaded at
+	// TX start, and it asks for a fill-up each time it is done with a scanline. That leaves
+	// prepare_scanline() a whole scanline's time, late answers only repeat a line.
 	
 	scanline_counter = 0;
-	prepare_scanline();		// Preload one scanline
-	
+	prefetch_thread = std::make_unique<SSTVPrefetchThread>(
+		"/sstv/" + bitmaps[options_bitmaps.selected_index()].string(),
+		bmp_header.image_data,
+		256
+	);
 	transmitter_model.set_sampling_rate(3072000U);
 	transmitter_model.set_rf_amp(true);
 	transmitter_model.set_baseband_bandwidth(1750000);
@@ -172,9 +217,13 @@ void SSTVTXView::start_tx() {
 	
 	baseband::set_sstv_data(
 		tx_sstv_mode->vis_code,
-		tx_sstv_mode->samples_per_pixel
+		tx_sstv_mode->samples_per_pixel_q16
 	);
 	
+	// Well before the first scanline, calibration and VIS take 910ms
+	prepare_scanline();
+	prepare_scanline();
+	
 	// Todo: Find a better way to prevent user from changing bitmap during tx
 	options_bitmaps.set_focusable(false);
 	tx_view.focus();
@@ -288,6 +337,7 @@ SSTVTXView::SSTVTXView(
 	
 	tx_view.on_stop = [this]() {
 		baseband::set_sstv_data(0, 0);
+		prefetch_thread.reset();
 		tx_view.set_transmitting(false);
 		transmitter_model.disable();
 		options_bitmaps.set_focusable(true);
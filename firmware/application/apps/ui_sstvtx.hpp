@@ -39,6 +39,42 @@ using namespace sstv;
 
 namespace ui {
 
+/* Reads bitmap lines ahead of the scanlines being sent, from its own File,
+ * so pixel timing never waits on the SD card.
+ */
+class SSTVPrefetchThread {
+public:
+	static constexpr size_t line_bytes = 320 * 3;		// 320 pixels @ 24bpp
+	static constexpr size_t lines_max = 4;
+
+	SSTVPrefetchThread(const std::filesystem::path& path, const uint32_t image_data, const size_t line_count);
+	~SSTVPrefetchThread();
+
+	SSTVPrefetchThread(const SSTVPrefetchThread&) = delete;
+	SSTVPrefetchThread(SSTVPrefetchThread&&) = delete;
+	SSTVPrefetchThread& operator=(const SSTVPrefetchThread&) = delete;
+	SSTVPrefetchThread& operator=(SSTVPrefetchThread&&) = delete;
+
+	/* Line n, top first, BGR. Returns nullptr if it hasn't been read yet.
+	 * Releases the lines before n, don't go back.
+	 */
+	const uint8_t* line(const size_t n);
+
+private:
+	File file { };
+	bool file_ok { false };
+	const uint32_t image_data;
+	const size_t line_count;
+	std::array<std::array<uint8_t, line_bytes>, lines_max> lines { };
+	volatile size_t lines_read { 0 };
+	volatile size_t lines_released { 0 };
+	Thread* thread { nullptr };
+
+	static msg_t static_fn(void* arg);
+
+	void run();
+};
+
 class SSTVTXView : public View {
 public:
 	SSTVTXView(NavigationView& nav);
@@ -65,11 +101,11 @@ private:
 	std::vector<std::filesystem::path> bitmaps { };
 	uint32_t scanline_counter { 0 };
 	uint8_t pixels_buffer[320 * 3];		// 320 pixels @ 24bpp
+	std::unique_ptr<SSTVPrefetchThread> prefetch_thread { };
 	const sstv_mode * tx_sstv_mode { };
 	
 	uint8_t component_map[3] { };
 
-	void read_boundary(uint8_t * buffer, uint32_t position, uint32_t length);
 	void on_bitmap_changed(const size_t index);
 	void on_mode_changed(const size_t index);
 	void on_tuning_frequency_changed(rf::Frequency f);
@@ -111,7 +111,7 @@ void TouchTunesView::start_tx(const uint32_t button_index) {
 	// Sync and end pulse
 	fragments = "111111111111111100000000" + fragments + "1000";
 	
-	size_t bitstream_length = make_bitstream(fragments);
+	const size_t run_count = make_runs(fragments);
 	
 	transmitter_model.set_tuning_frequency(433920000);
 	transmitter_model.set_sampling_rate(OOK_SAMPLERATE);
@@ -119,8 +119,8 @@ void TouchTunesView::start_tx(const uint32_t button_index) {
 	transmitter_model.set_baseband_bandwidth(1750000);
 	transmitter_model.enable();
 	
-	baseband::set_ook_data(
-		bitstream_length,
+	baseband::set_ook_runs(
+		run_count,
 		OOK_SAMPLERATE / 1766,	// 560us
 		TOUCHTUNES_REPEATS,
 		100						// Pause
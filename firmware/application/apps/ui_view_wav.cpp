@@ -37,12 +37,41 @@ void ViewWavView::update_scale(int32_t new_scale) {
 }
 
 void ViewWavView::refresh_waveform() {
-	for (size_t i = 0; i < 240; i++) {
-		wav_reader->data_seek(position + (i * scale));
-		wav_reader->read(&waveform_buffer[i], sizeof(int16_t));
+	// One seek, then read straight through the window, each pixel the
+	// min and max of its scale samples
+	int16_t samples[128];
+	const uint64_t sample_count = wav_reader->sample_count();
+	uint64_t offset = 0;
+	size_t i = 0;
+	
+	wav_reader->data_seek(position);
+	while ((i < 240) && ((position + offset) < sample_count)) {
+		const auto to_read = std::min<uint64_t>(128, sample_count - (position + offset));
+		const auto read_result = wav_reader->read(samples, to_read * sizeof(int16_t));
+		if (read_result.is_error() || !read_result.value())
+			break;
+		
+		const size_t count = read_result.value() / sizeof(int16_t);
+		for (size_t n = 0; (n < count) && (i < 240); n++, offset++) {
+			auto& span = waveform_spans[i];
+			const size_t phase = offset % scale;
+			if (!phase) {
+				span = { samples[n], samples[n] };
+			} else {
+				span.min = std::min(span.min, samples[n]);
+				span.max = std::max(span.max, samples[n]);
+			}
+			if (phase == (size_t)scale - 1)
+				i++;
+		}
 	}
+	// A part filled last column counts too
+	if ((i < 240) && (offset % scale))
+		i++;
+	for ( ; i < 240; i++)
+		waveform_spans[i] = { 0, 0 };
 	
-	waveform.set_dirty();
+	waveform.set_spans(waveform_spans, 240);
 	
 	// Window
 	uint64_t w_start = (position * 240) / wav_reader->sample_count();
@@ -78,8 +107,6 @@ void ViewWavView::on_pos_changed() {
 }
 
 void ViewWavView::load_wav(std::filesystem::path file_path) {
-	int16_t sample;
-	uint32_t average;
 
 	if (!wav_reader->open(file_path)) {
 		nav_.display_modal("Error", "Couldn't open file.", INFO, nullptr);
@@ -100,25 +127,47 @@ void ViewWavView::load_wav(std::filesystem::path file_path) {
 	text_samplerate.set(to_string_dec_uint(wav_reader->sample_rate()) + "Hz");
 	text_title.set(wav_reader->title());
 	
-	// Fill amplitude buffer, world's worst downsampling
-	uint64_t skip = wav_reader->sample_count() / (240 * subsampling_factor);
+	// Overall amplitude view from the summary, building it on first open
+	for (size_t i = 0; i < 240; i++)
+		amplitude_buffer[i] = 0;
 	
-	for (size_t i = 0; i < 240; i++) {
-		average = 0;
-		
-		for (size_t s = 0; s < subsampling_factor; s++) {
-			wav_reader->data_seek(((i * subsampling_factor) + s) * skip);
-			wav_reader->read(&sample, 2);
-			average += (abs(sample) >> 8);
+	const auto summary_error = wav_summary.open(file_path, *wav_reader, [](const uint32_t percent) {
+		display.fill_rectangle({ 0, 11 * 16, (Dim)(percent * 240 / 100), 8 }, Color::grey());
+	});
+	const bool rendered = !summary_error.is_valid() &&
+		wav_summary.render(0, wav_reader->sample_count(), 240, [this](const size_t column, const WAVSummary::Entry& entry) {
+			set_amplitude(column, std::max<int32_t>(-entry.min, entry.max));
+		});
+	if (!rendered) {
+		// Too short for the summary (or it couldn't be written): one pass
+		// over the samples
+		int16_t samples[128];
+		const uint64_t sample_count = wav_reader->sample_count();
+		uint64_t index = 0;
+		wav_reader->data_seek(0);
+		while (index < sample_count) {
+			const auto to_read = std::min<uint64_t>(128, sample_count - index);
+			const auto read_result = wav_reader->read(samples, to_read * sizeof(int16_t));
+			if (read_result.is_error() || !read_result.value())
+				break;
+			
+			const size_t count = read_result.value() / sizeof(int16_t);
+			for (size_t n = 0; n < count; n++, index++)
+				set_amplitude(index * 240 / sample_count, abs(samples[n]));
 		}
-		
-		amplitude_buffer[i] = average / subsampling_factor;
 	}
+	set_dirty();
 	
 	reset_controls();
 	update_scale(1);
 }
 
+void ViewWavView::set_amplitude(const size_t column, const int32_t peak) {
+	// 0~127
+	const uint8_t value = std::min<int32_t>(peak >> 8, 127);
+	amplitude_buffer[column] = std::max(amplitude_buffer[column], value);
+}
+
 void ViewWavView::reset_controls() {
 	field_scale.set_value(1);
 	field_pos_seconds.set_value(0);
@@ -38,18 +38,18 @@ public:
 
 private:
 	NavigationView& nav_;
-	static constexpr uint32_t subsampling_factor = 8;
-	
 	void update_scale(int32_t new_scale);
 	void refresh_waveform();
 	void refresh_measurements();
 	void on_pos_changed();
 	void load_wav(std::filesystem::path file_path);
 	void reset_controls();
+	void set_amplitude(const size_t column, const int32_t peak);
 
 	std::unique_ptr<WAVFileReader> wav_reader { };
+	WAVSummary wav_summary { };
 	
-	int16_t waveform_buffer[240] { };
+	Waveform::Span waveform_spans[240] { };
 	uint8_t amplitude_buffer[240] { };
 	int32_t scale { 1 };
 	uint64_t ns_per_pixel { };
@@ -89,8 +89,8 @@ private:
 
 	Waveform waveform {
 		{ 0, 5 * 16, 240, 64 },
-		waveform_buffer,
-		240,
+		nullptr,
+		0,
 		0,
 		false,
 		Color::white()
@@ -31,11 +31,16 @@
 
 #include "core_control.hpp"
 
+#include <algorithm>
+
 using namespace portapack;
 
 namespace baseband {
 
 static void send_message(const Message* const message) {
+	// Image copy started by run_image() must be done before the M4 can listen.
+	m4_init_complete();
+
 	// If message is only sent by this function via one thread, no need to check if
 	// another message is present before setting new message.
 	shared_memory.baseband_message = message;
@@ -43,6 +48,19 @@ static void send_message(const Message* const message) {
 	while(shared_memory.baseband_message);
 }
 
+/* Fire-and-forget variant of send_message(), for messages carrying no
+ * pointers into the caller's stack. Falls back to waiting if the queue is
+ * full; ordering with send_message() is kept either way since the baseband
+ * drains the queue first.
+ */
+template<typename T>
+static void post_message(const T& message) {
+	m4_init_complete();
+	if( !shared_memory.baseband_queue.push(message) ) {
+		send_message(&message);
+	}
+}
+
 void AMConfig::apply() const {
 	const AMConfigureMessage message {
 		taps_6k0_decim_0,
@@ -78,7 +96,8 @@ void WFMConfig::apply() const {
 		taps_64_lp_156_198,
 		75000,
 		audio_48k_hpf_30hz_config,
-		audio_48k_deemph_2122_6_config
+		audio_48k_deemph_2122_6_config,
+		stereo
 	};
 	send_message(&message);
 	audio::set_rate(audio::Rate::Hz_48000);
@@ -89,23 +108,69 @@ void set_tone(const uint32_t index, const uint32_t delta, const uint32_t duratio
 	shared_memory.bb_data.tones_data.tone_defs[index].duration = duration;
 }
 
-void set_tones_config(const uint32_t bw, const uint32_t pre_silence, const uint16_t tone_count,
+void tones_reset() {
+	auto& tones = shared_memory.bb_data.tones_data;
+	tones.symbols_in = 0;
+	tones.symbols_out = 0;
+	tones.symbols_end = ToneData::symbols_open;
+}
+
+size_t tones_space() {
+	const auto& tones = shared_memory.bb_data.tones_data;
+	return (1U << ToneData::symbols_k) - (tones.symbols_in - tones.symbols_out);
+}
+
+size_t tones_queue(const uint8_t* const symbols, const size_t count) {
+	auto& tones = shared_memory.bb_data.tones_data;
+	const size_t n = std::min(count, tones_space());
+	uint32_t in = tones.symbols_in;
+	for(size_t i=0; i<n; i++) {
+		tones.symbols[in++ & ((1U << ToneData::symbols_k) - 1)] = symbols[i];
+	}
+	// Symbols before the index that hands them over
+	__DMB();
+	tones.symbols_in = in;
+	return n;
+}
+
+void tones_end() {
+	auto& tones = shared_memory.bb_data.tones_data;
+	tones.symbols_end = tones.symbols_in;
+}
+
+void set_tones_symbols(const uint8_t* const symbols, const size_t count) {
+	tones_reset();
+	tones_queue(symbols, count);
+	tones_end();
+}
+
+void set_tones_config(const uint32_t bw, const uint32_t pre_silence,
 					const bool dual_tone, const bool audio_out) {
 	const TonesConfigureMessage message {
 		bw,
 		pre_silence,
-		tone_count,
+		true,
 		dual_tone,
 		audio_out
 	};
 	send_message(&message);
 }
 
+void set_morse_keyer(const uint32_t bw, const uint32_t tone, const uint32_t time_unit_ms, const bool audio_out) {
+	const MorseKeyerConfigureMessage message {
+		bw,
+		TONES_F2D(tone, TONES_SAMPLERATE),
+		time_unit_ms * (TONES_SAMPLERATE / 1000),
+		audio_out
+	};
+	send_message(&message);
+}
+
 void kill_tone() {
 	const TonesConfigureMessage message {
 		0,
 		0,
-		0,
+		false,
 		false,
 		false
 	};
@@ -120,9 +185,12 @@ void set_sstv_data(const uint8_t vis_code, const uint32_t pixel_duration) {
 	send_message(&message);
 }
 
-void set_afsk(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word) {
+void set_afsk(const uint32_t baudrate, const uint32_t mark_frequency, const uint32_t space_frequency,
+					const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word) {
 	const AFSKRxConfigureMessage message {
 		baudrate,
+		mark_frequency,
+		space_frequency,
 		word_length,
 		trigger_value,
 		trigger_word
@@ -130,6 +198,30 @@ void set_afsk(const uint32_t baudrate, const uint32_t word_length, const uint32_
 	send_message(&message);
 }
 
+void set_ax25() {
+	const AFSKRxConfigureMessage message {
+		1200,
+		1200,
+		2200,
+		8,
+		0,
+		false,
+		true
+	};
+	send_message(&message);
+}
+
+void set_tx_sequence(const size_t count, const uint32_t cycles, const uint32_t guard,
+					const std::array<TxSequenceStep, TxSequenceConfigMessage::steps_max>& steps) {
+	const TxSequenceConfigMessage message {
+		count,
+		cycles,
+		guard,
+		steps
+	};
+	send_message(&message);
+}
+
 void set_afsk_data(const uint32_t afsk_samples_per_bit, const uint32_t afsk_phase_inc_mark, const uint32_t afsk_phase_inc_space,
 					const uint8_t afsk_repeat, const uint32_t afsk_bw, const uint8_t symbol_count) {
 	const AFSKTxConfigureMessage message {
@@ -156,13 +248,14 @@ void kill_afsk() {
 }
 
 void set_audiotx_config(const uint32_t divider, const float deviation_hz, const float audio_gain,
-					const uint32_t tone_key_delta) {
+					const uint32_t tone_key_delta, const AudioTXConfigMessage::Modulation modulation) {
 	const AudioTXConfigMessage message {
 		divider,
 		deviation_hz,
 		audio_gain,
 		tone_key_delta,
-		(float)persistent_memory::tone_mix() / 100.0f
+		(float)persistent_memory::tone_mix() / 100.0f,
+		modulation
 	};
 	send_message(&message);
 }
@@ -179,7 +272,85 @@ void set_pitch_rssi(int32_t avg, bool enabled) {
 		enabled,
 		avg
 	};
-	send_message(&message);	
+	post_message(message);
+}
+
+void set_frequency_correction(const bool tracking, const int32_t shift_hz) {
+	const FrequencyCorrectionMessage message {
+		tracking,
+		shift_hz
+	};
+	post_message(message);
+}
+
+void set_rx_gain_control(const bool enabled, const int32_t applied_db) {
+	const RxGainControlMessage message {
+		enabled,
+		static_cast<int8_t>(applied_db)
+	};
+	post_message(message);
+}
+
+void rssi_configure(const uint32_t statistics_interval_ms, const uint32_t history_decimation, const uint32_t burst_threshold) {
+	shared_memory.rssi.statistics_interval_ms = statistics_interval_ms;
+	shared_memory.rssi.history_decimation = history_decimation;
+	shared_memory.rssi.burst_threshold = burst_threshold;
+}
+
+uint32_t rssi_peak_hold() {
+	const uint32_t peak = shared_memory.rssi.peak_hold;
+	shared_memory.rssi.peak_sequence = shared_memory.rssi.peak_sequence + 1;
+	return peak;
+}
+
+size_t rssi_history(uint8_t* const dst, const size_t count) {
+	constexpr size_t history_size = 1U << RSSITable::history_k;
+	const uint32_t written = shared_memory.rssi.history_count;
+	// Leave the oldest quarter alone, baseband may be overwriting it.
+	const size_t n = std::min<size_t>({ count, written, history_size * 3 / 4 });
+	for(size_t i=0; i<n; i++) {
+		dst[i] = shared_memory.rssi.history[(written - n + i) & (history_size - 1)];
+	}
+	return n;
+}
+
+size_t rssi_bursts(RSSIBurst* const dst, const size_t max, uint32_t& burst_count) {
+	const uint32_t ended = shared_memory.rssi.burst_count;
+	if( ended < burst_count ) {
+		// The RSSI thread restarted.
+		burst_count = 0;
+	}
+	const size_t n = std::min<size_t>({ max, ended - burst_count, RSSITable::bursts_max - 1 });
+	for(size_t i=0; i<n; i++) {
+		dst[i] = shared_memory.rssi.bursts[(ended - n + i) % RSSITable::bursts_max];
+	}
+	burst_count = ended;
+	return n;
+}
+
+void set_scan_dwell(const uint32_t sequence, const uint32_t index, const uint32_t settle_buffers, const uint32_t dwell_buffers,
+					const int32_t threshold_db, const float noise_threshold) {
+	const ScanDwellConfigMessage message {
+		sequence,
+		index,
+		settle_buffers,
+		dwell_buffers,
+		threshold_db,
+		noise_threshold
+	};
+	post_message(message);
+}
+
+void set_scan_group(const uint32_t sequence, const uint32_t settle_buffers, const uint32_t dwell_buffers,
+					const size_t count, const std::array<int32_t, ScanGroupConfigMessage::channels_max>& offsets) {
+	const ScanGroupConfigMessage message {
+		sequence,
+		settle_buffers,
+		dwell_buffers,
+		count,
+		offsets
+	};
+	post_message(message);
 }
 
 void set_ook_data(const uint32_t stream_length, const uint32_t samples_per_bit, const uint8_t repeat,
@@ -193,6 +364,18 @@ void set_ook_data(const uint32_t stream_length, const uint32_t samples_per_bit,
 	send_message(&message);
 }
 
+void set_ook_runs(const uint32_t run_count, const uint32_t samples_per_bit, const uint8_t repeat,
+					const uint32_t pause_symbols) {
+	const OOKConfigureMessage message {
+		run_count,
+		samples_per_bit,
+		repeat,
+		pause_symbols,
+		true
+	};
+	send_message(&message);
+}
+
 void set_fsk_data(const uint32_t stream_length, const uint32_t samples_per_bit, const uint32_t shift,
 					const uint32_t progress_notice) {
 	const FSKConfigureMessage message {
@@ -211,6 +394,21 @@ void set_pocsag(const pocsag::BitRate bitrate) {
 	send_message(&message);
 }
 
+void set_acars(const std::array<int32_t, ACARSConfigureMessage::channels_max>& offsets_hz, const size_t channel_count) {
+	const ACARSConfigureMessage message {
+		offsets_hz,
+		channel_count
+	};
+	send_message(&message);
+}
+
+void set_ert(const bool channelized) {
+	const ERTConfigureMessage message {
+		channelized
+	};
+	send_message(&message);
+}
+
 void set_adsb() {
 	const ADSBConfigureMessage message {
 		1
@@ -234,18 +432,66 @@ void set_rds_data(const uint16_t message_length) {
 	send_message(&message);
 }
 
-void set_spectrum(const size_t sampling_rate, const size_t trigger) {
+void set_spectrum(const size_t sampling_rate, const size_t trigger, const size_t presum_taps) {
 	const WidebandSpectrumConfigMessage message {
-		sampling_rate, trigger
+		sampling_rate, trigger, presum_taps
 	};
 	send_message(&message);
 }
 
+void set_spectrum_zoom(const int32_t offset_hz, const size_t decimation, const size_t fft_size) {
+	const SpectrumZoomConfigMessage message {
+		offset_hz, decimation, fft_size
+	};
+	send_message(&message);
+}
+
+void set_sweep(SweepSpectrum* const spectrum, const uint32_t slice_count, const uint32_t settle_buffers,
+					const uint32_t ffts_per_slice, const uint32_t threshold) {
+	const SweepConfigMessage message {
+		spectrum,
+		slice_count,
+		settle_buffers,
+		ffts_per_slice,
+		threshold
+	};
+	send_message(&message);
+}
+
+void sweep_retuned(const uint32_t slice) {
+	const SweepRetunedMessage message {
+		slice
+	};
+	post_message(message);
+}
+
 void set_siggen_tone(const uint32_t tone) {
 	const SigGenToneMessage message {
 		TONES_F2D(tone, TONES_SAMPLERATE)
 	};
-	send_message(&message);
+	post_message(message);
+}
+
+void set_siggen_tones(const uint32_t* const tones, const size_t count) {
+	std::array<uint32_t, SigGenTonesMessage::tones_max> tone_deltas { };
+	const size_t n = std::min(count, tone_deltas.size());
+	for (size_t i = 0; i < n; i++)
+		tone_deltas[i] = TONES_F2D(tones[i], TONES_SAMPLERATE);
+	
+	const SigGenTonesMessage message {
+		static_cast<uint32_t>(n), tone_deltas
+	};
+	post_message(message);
+}
+
+void set_siggen_sweep(const SigGenSweepMessage::Kind kind, const uint32_t start, const uint32_t end, const uint32_t period_ms) {
+	const SigGenSweepMessage message {
+		kind,
+		TONES_F2D(start, TONES_SAMPLERATE),
+		TONES_F2D(end, TONES_SAMPLERATE),
+		period_ms * (TONES_SAMPLERATE / 1000)
+	};
+	post_message(message);
 }
 
 void set_siggen_config(const uint32_t bw, const uint32_t shape, const uint32_t duration) {
@@ -256,6 +502,7 @@ void set_siggen_config(const uint32_t bw, const uint32_t shape, const uint32_t d
 }
 
 static bool baseband_image_running = false;
+static portapack::spi_flash::image_tag_t baseband_image_tag { };
 
 void run_image(const portapack::spi_flash::image_tag_t image_tag) {
 	if( baseband_image_running ) {
@@ -264,12 +511,27 @@ void run_image(const portapack::spi_flash::image_tag_t image_tag) {
 
 	creg::m4txevent::clear();
 
-	m4_init(image_tag, portapack::memory::map::m4_code);
+	// Stages register themselves as the new image starts.
+	shared_memory.profiler = { };
+
+	// M4 is released on the first message, the copy overlaps view setup.
+	m4_init_start(image_tag, portapack::memory::map::m4_code);
 	baseband_image_running = true;
+	baseband_image_tag = image_tag;
 
 	creg::m4txevent::enable();
 }
 
+void run_processor(const portapack::spi_flash::image_tag_t image_tag, const portapack::spi_flash::image_tag_t processor_tag) {
+	if( !baseband_image_running || !(baseband_image_tag == image_tag) ) {
+		shutdown();
+		run_image(image_tag);
+	}
+
+	ProcessorSelectMessage message { processor_tag };
+	send_message(&message);
+}
+
 void shutdown() {
 	if( !baseband_image_running ) {
 		return;
@@ -281,13 +543,39 @@ void shutdown() {
 	send_message(&message);
 
 	shared_memory.application_queue.reset();
+	shared_memory.baseband_queue.reset();
+
+	for(auto& entry : shared_memory.rings.entries) {
+		if( entry.fifo ) {
+			chHeapFree(entry.fifo);
+		}
+		entry = { nullptr, 0, 0 };
+	}
 	
 	baseband_image_running = false;
 }
 
-void spectrum_streaming_start() {
+bool image_running() {
+	return baseband_image_running;
+}
+
+void spectrum_streaming_start(const SpectrumStreamingConfigMessage::FFT fft,
+					const SpectrumStreamingConfigMessage::Trace trace, const uint32_t trace_param,
+					const SpectrumStreamingConfigMessage::Colors colors,
+					const SpectrumStreamingConfigMessage::Delivery delivery, const size_t fifo_k) {
+	if( fifo_k > ChannelSpectrumConfigMessage::fifo_k_max ) {
+		// Too deep for the baseband's own, which it falls back to if this fails.
+		allocate_ring<ChannelSpectrum>(shared_rings::ID::Spectrum, fifo_k);
+	}
+
 	SpectrumStreamingConfigMessage message {
-		SpectrumStreamingConfigMessage::Mode::Running
+		SpectrumStreamingConfigMessage::Mode::Running,
+		fft,
+		trace,
+		trace_param,
+		colors,
+		delivery,
+		fifo_k
 	};
 	send_message(&message);
 }
@@ -299,8 +587,8 @@ void spectrum_streaming_stop() {
 	send_message(&message);
 }
 
-void set_sample_rate(const uint32_t sample_rate) {
-	SamplerateConfigMessage message { sample_rate };
+void set_sample_rate(const uint32_t sample_rate, const size_t interpolation) {
+	SamplerateConfigMessage message { sample_rate, interpolation };
 	send_message(&message);
 }
 
@@ -324,9 +612,29 @@ void replay_stop() {
 	send_message(&message);
 }
 
-void request_beep() {
-	RequestSignalMessage message { RequestSignalMessage::Signal::BeepRequest };
+void file_source_start(ReplayConfig* const config) {
+	FileSourceConfigMessage message { config };
+	send_message(&message);
+}
+
+void file_source_stop() {
+	FileSourceConfigMessage message { nullptr };
+	send_message(&message);
+}
+
+void synthetic_source_start(const SyntheticSourceConfig& config) {
+	const SyntheticSourceConfigMessage message { &config };
+	send_message(&message);
+}
+
+void synthetic_source_stop() {
+	const SyntheticSourceConfigMessage message { nullptr };
 	send_message(&message);
 }
 
+void request_beep() {
+	const RequestSignalMessage message { RequestSignalMessage::Signal::BeepRequest };
+	post_message(message);
+}
+
 } /* namespace baseband */
@@ -30,8 +30,13 @@
 #include "dsp_fir_taps.hpp"
 
 #include "spi_image.hpp"
+#include "portapack_shared_memory.hpp"
+#include "shared_rings.hpp"
 
 #include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
 
 namespace baseband {
 
@@ -52,47 +57,151 @@ struct NBFMConfig {
 };
 
 struct WFMConfig {
+	const bool stereo;
+
 	void apply() const;
 };
 
 void set_tone(const uint32_t index, const uint32_t delta, const uint32_t duration);
-void set_tones_config(const uint32_t bw, const uint32_t pre_silence, const uint16_t tone_count,
+/* Tone symbols, see ToneData. Reset and queue some before set_tones_config,
+ * then keep queueing as TXProgress comes in and end the stream once the
+ * last is in. set_tones_symbols does all three for a short sequence.
+ */
+void tones_reset();
+size_t tones_space();
+size_t tones_queue(const uint8_t* const symbols, const size_t count);
+void tones_end();
+void set_tones_symbols(const uint8_t* const symbols, const size_t count);
+void set_tones_config(const uint32_t bw, const uint32_t pre_silence,
 					const bool dual_tone, const bool audio_out);
+/* Morse from the same ring, packed key bits from morse::Encoder::read_units. */
+void set_morse_keyer(const uint32_t bw, const uint32_t tone, const uint32_t time_unit_ms, const bool audio_out);
 void kill_tone();
 void set_sstv_data(const uint8_t vis_code, const uint32_t pixel_duration);
 void set_audiotx_config(const uint32_t divider, const float deviation_hz, const float audio_gain,
-					const uint32_t tone_key_delta);
+					const uint32_t tone_key_delta,
+					const AudioTXConfigMessage::Modulation modulation = AudioTXConfigMessage::Modulation::FM);
 void set_fifo_data(const int8_t * data);
 void set_pitch_rssi(int32_t avg, bool enabled);
+/* NFM: track a known carrier with the fine (DSP) frequency correction.
+ * shift_hz tells the processor the reference was just trimmed that far.
+ */
+void set_frequency_correction(const bool tracking, const int32_t shift_hz = 0);
+/* The receive thread's RxGainControl; applied_db answers a step request. */
+void set_rx_gain_control(const bool enabled, const int32_t applied_db = 0);
+
+/* RSSITable in shared memory, kept by the RSSI thread of any receiving
+ * image; settings carry over from one image to the next.
+ */
+void rssi_configure(const uint32_t statistics_interval_ms, const uint32_t history_decimation, const uint32_t burst_threshold);
+/* Highest raw RSSI since the previous call. */
+uint32_t rssi_peak_hold();
+/* Copies up to count of the latest history entries, oldest first. */
+size_t rssi_history(uint8_t* const dst, const size_t count);
+/* Copies up to max bursts that ended since burst_count was last updated
+ * here, oldest first. Bursts overwritten in the meantime are skipped.
+ */
+size_t rssi_bursts(RSSIBurst* const dst, const size_t max, uint32_t& burst_count);
+void set_scan_dwell(const uint32_t sequence, const uint32_t index, const uint32_t settle_buffers, const uint32_t dwell_buffers,
+					const int32_t threshold_db, const float noise_threshold);
+void set_scan_group(const uint32_t sequence, const uint32_t settle_buffers, const uint32_t dwell_buffers,
+					const size_t count, const std::array<int32_t, ScanGroupConfigMessage::channels_max>& offsets);
+void set_tx_sequence(const size_t count, const uint32_t cycles, const uint32_t guard,
+					const std::array<TxSequenceStep, TxSequenceConfigMessage::steps_max>& steps);
 void set_afsk_data(const uint32_t afsk_samples_per_bit, const uint32_t afsk_phase_inc_mark, const uint32_t afsk_phase_inc_space,
 					const uint8_t afsk_repeat, const uint32_t afsk_bw, const uint8_t symbol_count);
 void kill_afsk();
-void set_afsk(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word);
+void set_afsk(const uint32_t baudrate, const uint32_t mark_frequency, const uint32_t space_frequency,
+					const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word);
+void set_ax25();
 void set_ook_data(const uint32_t stream_length, const uint32_t samples_per_bit, const uint8_t repeat,
 					const uint32_t pause_symbols);
+/* Same, bb_data holding run_count runs from encoders::make_runs(). */
+void set_ook_runs(const uint32_t run_count, const uint32_t samples_per_bit, const uint8_t repeat,
+					const uint32_t pause_symbols);
 void set_fsk_data(const uint32_t stream_length, const uint32_t samples_per_bit, const uint32_t shift,
 					const uint32_t progress_notice);
 void set_pocsag(const pocsag::BitRate bitrate);
 void set_adsb();
+void set_ert(const bool channelized);
+void set_acars(const std::array<int32_t, ACARSConfigureMessage::channels_max>& offsets_hz, const size_t channel_count);
 void set_jammer(const bool run, const jammer::JammerType type, const uint32_t speed);
 void set_rds_data(const uint16_t message_length);
-void set_spectrum(const size_t sampling_rate, const size_t trigger);
+void set_spectrum(const size_t sampling_rate, const size_t trigger, const size_t presum_taps = 4);
+/* See SpectrumZoomConfigMessage, decimation 1 for no zoom. */
+void set_spectrum_zoom(const int32_t offset_hz, const size_t decimation, const size_t fft_size);
+void set_sweep(SweepSpectrum* const spectrum, const uint32_t slice_count, const uint32_t settle_buffers,
+					const uint32_t ffts_per_slice, const uint32_t threshold);
+void sweep_retuned(const uint32_t slice);
 void set_siggen_tone(const uint32_t tone);
+void set_siggen_tones(const uint32_t* const tones, const size_t count);
+void set_siggen_sweep(const SigGenSweepMessage::Kind kind, const uint32_t start, const uint32_t end, const uint32_t period_ms);
 void set_siggen_config(const uint32_t bw, const uint32_t shape, const uint32_t duration);
 void request_beep();
 
+/* A FIFO of 2^k T in the application's heap, listed as id in
+ * shared_memory.rings for the image's processors, see shared_rings.hpp.
+ * Asking again for the same ring and depth gets the same one back. Its
+ * depth is fixed from then on: nullptr for another, or if the heap is
+ * short. shutdown() frees them all.
+ */
+template<typename T>
+FIFO<T>* allocate_ring(const shared_rings::ID id, const size_t k) {
+	static_assert(std::is_trivially_copyable<T>::value, "Ring elements are copied across cores");
+
+	auto& entry = shared_memory.rings.entries[static_cast<size_t>(id)];
+	if( entry.fifo ) {
+		const bool same = (entry.element_size == sizeof(T)) && (entry.k == k);
+		return same ? static_cast<FIFO<T>*>(entry.fifo) : nullptr;
+	}
+
+	constexpr size_t header_size = (sizeof(FIFO<T>) + alignof(T) - 1) & ~(alignof(T) - 1);
+	const size_t count = 1U << k;
+	void* const p = chHeapAlloc(0x0, header_size + count * sizeof(T));
+	if( p == nullptr ) {
+		return nullptr;
+	}
+
+	const auto data = reinterpret_cast<T*>(static_cast<uint8_t*>(p) + header_size);
+	std::uninitialized_fill_n(data, count, T { });
+	const auto fifo = new (p) FIFO<T> { data, k };
+	entry = { fifo, sizeof(T), static_cast<uint8_t>(k) };
+	return fifo;
+}
+
 void run_image(const portapack::spi_flash::image_tag_t image_tag);
+/* Runs one processor of a multi-processor image. If that image is already
+ * running, only the processor is swapped and RF keeps streaming.
+ */
+void run_processor(const portapack::spi_flash::image_tag_t image_tag, const portapack::spi_flash::image_tag_t processor_tag);
 void shutdown();
-
-void spectrum_streaming_start();
+/* Whether an image was started and not shut down since. */
+bool image_running();
+
+void spectrum_streaming_start(const SpectrumStreamingConfigMessage::FFT fft = SpectrumStreamingConfigMessage::FFT::Float,
+					const SpectrumStreamingConfigMessage::Trace trace = SpectrumStreamingConfigMessage::Trace::Instant,
+					const uint32_t trace_param = 0,
+					const SpectrumStreamingConfigMessage::Colors colors = { 0, 0 },
+					const SpectrumStreamingConfigMessage::Delivery delivery = SpectrumStreamingConfigMessage::Delivery::Latest,
+					const size_t fifo_k = ChannelSpectrumConfigMessage::fifo_k);
 void spectrum_streaming_stop();
 
-void set_sample_rate(const uint32_t sample_rate);
+void set_sample_rate(const uint32_t sample_rate, const size_t interpolation = 1);
 void capture_start(CaptureConfig* const config);
 void capture_stop();
 void replay_start(ReplayConfig* const config);
 void replay_stop();
 
+/* The running receive processor decodes config's stream instead of the
+ * radio, see FileSourceConfigMessage.
+ */
+void file_source_start(ReplayConfig* const config);
+void file_source_stop();
+
+/* Or from a test signal made on the M4, see SyntheticSourceConfigMessage. */
+void synthetic_source_start(const SyntheticSourceConfig& config);
+void synthetic_source_stop();
+
 } /* namespace baseband */
 
 #endif/*__BASEBAND_API_H__*/
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "boot_timeline.hpp"
+
+#include "ch.h"
+
+#include "portapack_persistent_memory.hpp"
+using namespace portapack;
+
+#include <array>
+
+namespace boot_timeline {
+
+static_assert(static_cast<size_t>(Mark::Count) <= persistent_memory::boot_times_count, "Too many boot marks for backup RAM");
+
+static constexpr std::array<const char*, static_cast<size_t>(Mark::Count)> names { {
+	"Init",
+	"Clocks",
+	"CPLD",
+	"Audio",
+	"Radio",
+	"Display",
+	"UI",
+} };
+
+void mark(const Mark m) {
+	const auto index = static_cast<size_t>(m);
+	if( m == Mark::Init ) {
+		for(size_t i=0; i<persistent_memory::boot_times_count; i++) {
+			persistent_memory::set_boot_time(i, 0);
+		}
+	}
+	// Never zero, which means "not reached".
+	const auto ms = chTimeNow() * 1000 / CH_FREQUENCY;
+	persistent_memory::set_boot_time(index, ms ? ms : 1);
+}
+
+uint32_t time(const Mark m) {
+	return persistent_memory::boot_time(static_cast<size_t>(m));
+}
+
+const char* name(const Mark m) {
+	const auto index = static_cast<size_t>(m);
+	return (index < names.size()) ? names[index] : "";
+}
+
+} /* namespace boot_timeline */
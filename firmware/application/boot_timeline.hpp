@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __BOOT_TIMELINE_H__
+#define __BOOT_TIMELINE_H__
+
+#include <cstdint>
+#include <cstddef>
+
+/* Boot milestones, as milliseconds since the kernel started. They live in
+ * backup RAM, so they survive a reset; a boot that hung shows where it got
+ * to until the next boot reaches Mark::Init. Shown in Debug > Boot.
+ */
+
+namespace boot_timeline {
+
+enum class Mark : uint8_t {
+	Init = 0,
+	Clocks,
+	CPLD,
+	Audio,
+	Radio,
+	Display,
+	UI,
+	Count
+};
+
+/* Mark::Init clears the rest, they belong to the last boot. */
+void mark(const Mark m);
+
+/* Zero if the mark wasn't reached. */
+uint32_t time(const Mark m);
+const char* name(const Mark m);
+
+} /* namespace boot_timeline */
+
+#endif/*__BOOT_TIMELINE_H__*/
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "capture_info.hpp"
+
+#include "iq_codec.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+/* Scales the file size by the compression ratio of the blocks at its start.
+ * Only used for the duration and progress bar, so an estimate will do.
+ */
+static uint64_t decoded_size_estimate(File& file, const uint64_t file_size) {
+	std::array<uint8_t, 2048> head;
+	const auto read_result = file.read(head.data(), head.size());
+	if( read_result.is_error() ) {
+		return file_size;
+	}
+
+	const size_t length = read_result.value();
+	size_t offset = 0;
+	uint64_t samples_total = 0;
+	while( offset + sizeof(iq_codec::Header) <= length ) {
+		size_t samples = 0;
+		const auto block_bytes = iq_codec::parse_header(&head[offset], samples);
+		if( (block_bytes == 0) || (offset + block_bytes > length) ) {
+			break;
+		}
+		samples_total += samples;
+		offset += block_bytes;
+	}
+
+	if( offset == 0 ) {
+		return file_size;
+	}
+	return file_size * samples_total * sizeof(complex16_t) / offset;
+}
+
+bool read_capture_info(const std::filesystem::path& path, CaptureInfo& info) {
+	File data_file, info_file;
+	char file_data[257];
+	
+	// Get file size
+	auto data_open_error = data_file.open("/" + path.string());
+	if (data_open_error.is_valid()) {
+		return false;
+	}
+	
+	// Get original record frequency if available
+	std::filesystem::path info_file_path = path;
+	info_file_path.replace_extension(u".TXT");
+	
+	info.sample_rate = 500000;
+	info.format = (path.extension().string() == ".C8") ? ReplayConfig::Format::C8 : ReplayConfig::Format::C16;
+	info.center_frequency = 0;
+	
+	auto info_open_error = info_file.open("/" + info_file_path.string());
+	if (!info_open_error.is_valid()) {
+		memset(file_data, 0, 257);
+		auto read_size = info_file.read(file_data, 256);
+		if (!read_size.is_error()) {
+			auto pos1 = strstr(file_data, "center_frequency=");
+			if (pos1) {
+				pos1 += 17;
+				info.center_frequency = strtoll(pos1, nullptr, 10);
+			}
+			
+			auto pos2 = strstr(file_data, "sample_rate=");
+			if (pos2) {
+				pos2 += 12;
+				info.sample_rate = strtoll(pos2, nullptr, 10);
+			}
+			
+			// Recorded by RecordView, overrides whatever the extension says.
+			auto pos3 = strstr(file_data, "format=");
+			if (pos3) {
+				pos3 += 7;
+				if (!strncmp(pos3, "C8", 2)) {
+					info.format = ReplayConfig::Format::C8;
+				} else if (!strncmp(pos3, "C16", 3) || !strncmp(pos3, "RIQ", 3)) {
+					info.format = ReplayConfig::Format::C16;
+				}
+			}
+		}
+	}
+	
+	info.size = data_file.size();
+	if( path.extension().string() == ".RIQ" ) {
+		info.size = decoded_size_estimate(data_file, info.size);
+	}
+	return true;
+}
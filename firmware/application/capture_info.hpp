@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CAPTURE_INFO_H__
+#define __CAPTURE_INFO_H__
+
+#include "file.hpp"
+#include "message.hpp"
+#include "rf_path.hpp"
+
+#include <cstdint>
+
+struct CaptureInfo {
+	uint32_t sample_rate;
+	ReplayConfig::Format format;
+	rf::Frequency center_frequency;
+	uint64_t size;
+};
+
+/* Sample rate, format and centre frequency from the capture's .TXT, when
+ * there is one, and its size in replayed (decoded) bytes. False when the
+ * data file can't be opened.
+ */
+bool read_capture_info(const std::filesystem::path& path, CaptureInfo& info);
+
+#endif/*__CAPTURE_INFO_H__*/
@@ -23,6 +23,7 @@
 
 #include "baseband_api.hpp"
 #include "buffer_exchange.hpp"
+#include "trace.hpp"
 
 struct BasebandCapture {
 	BasebandCapture(CaptureConfig* const config) {
@@ -40,15 +41,20 @@ CaptureThread::CaptureThread(
 	std::unique_ptr<stream::Writer> writer,
 	size_t write_size,
 	size_t buffer_count,
+	size_t decimation,
+	CaptureConfig::Format format,
 	std::function<void()> success_callback,
-	std::function<void(File::Error)> error_callback
-) : config { write_size, buffer_count },
+	std::function<void(File::Error)> error_callback,
+	const CaptureConfig::Trigger trigger,
+	const bool squelch_gate
+) : config { write_size, buffer_count, decimation, format, trigger, squelch_gate },
 	writer { std::move(writer) },
 	success_callback { std::move(success_callback) },
 	error_callback { std::move(error_callback) }
 {
-	// Need significant stack for FATFS
-	thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO + 10, CaptureThread::static_fn, this);
+	// Need significant stack for FATFS, and its LFN buffer for writers
+	// that open files as they go
+	thread = chThdCreateFromHeap(NULL, 2048, NORMALPRIO + 10, CaptureThread::static_fn, this);
 }
 
 CaptureThread::~CaptureThread() {
@@ -60,6 +66,7 @@ CaptureThread::~CaptureThread() {
 }
 
 msg_t CaptureThread::static_fn(void* arg) {
+	chRegSetThreadName("capture");
 	auto obj = static_cast<CaptureThread*>(arg);
 	const auto error = obj->run();
 	if( error.is_valid() && obj->error_callback ) {
@@ -76,14 +83,54 @@ Optional<File::Error> CaptureThread::run() {
 	BasebandCapture capture { &config };
 	BufferExchange buffers { &config };
 
+	StreamBuffer* next_buffer { nullptr };
+	systime_t last_sync = chTimeNow();
+
 	while( !chThdShouldTerminate() ) {
-		auto buffer = buffers.get();
-		auto write_result = writer->write(buffer->data(), buffer->size());
+		// Baseband allocates its StreamBuffers back to back, so when the card
+		// has fallen behind, consecutive full buffers can go out as one
+		// larger multi-sector write.
+		std::array<StreamBuffer*, write_buffers_max> pending { };
+		size_t pending_count = 0;
+		pending[pending_count++] = next_buffer ? next_buffer : buffers.get();
+		next_buffer = nullptr;
+
+		auto write_data = static_cast<uint8_t*>(pending[0]->data());
+		size_t write_bytes = pending[0]->size();
+		while( pending_count < pending.size() ) {
+			auto buffer = buffers.get_prefill();
+			if( !buffer ) {
+				break;
+			}
+			if( (buffer->data() != &write_data[write_bytes]) || ((write_bytes + buffer->size()) > write_block_max) ) {
+				next_buffer = buffer;
+				break;
+			}
+			pending[pending_count++] = buffer;
+			write_bytes += buffer->size();
+		}
+
+		const auto write_start = chTimeNow();
+		const auto trace_start = trace::now();
+		auto write_result = writer->write(write_data, write_bytes);
+		TRACE_COMPLETE(CaptureWrite, trace_start, write_bytes);
 		if( write_result.is_error() ) {
 			return write_result.error();
 		}
-		buffer->empty();
-		buffers.put(buffer);
+		config.statistics.record_latency((chTimeNow() - write_start) * 1000 / CH_FREQUENCY);
+
+		for(size_t i=0; i<pending_count; i++) {
+			pending[i]->empty();
+			buffers.put(pending[i]);
+		}
+
+		if( (chTimeNow() - last_sync) >= sync_interval ) {
+			const auto sync_error = writer->sync();
+			if( sync_error.is_valid() ) {
+				return sync_error;
+			}
+			last_sync = chTimeNow();
+		}
 	}
 
 	return { };
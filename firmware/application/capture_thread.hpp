@@ -32,6 +32,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <utility>
+#include <array>
 
 class CaptureThread {
 public:
@@ -39,8 +40,12 @@ public:
 		std::unique_ptr<stream::Writer> writer,
 		size_t write_size,
 		size_t buffer_count,
+		size_t decimation,
+		CaptureConfig::Format format,
 		std::function<void()> success_callback,
-		std::function<void(File::Error)> error_callback
+		std::function<void(File::Error)> error_callback,
+		const CaptureConfig::Trigger trigger = { 0, 0, 0 },
+		const bool squelch_gate = true
 	);
 	~CaptureThread();
 
@@ -54,6 +59,11 @@ public:
 	}
 
 private:
+	static constexpr size_t write_buffers_max = 8;
+	static constexpr size_t write_block_max = 65536;
+	// Writer syncs, at the first write after each interval.
+	static constexpr systime_t sync_interval = MS2ST(10000);
+
 	CaptureConfig config;
 	std::unique_ptr<stream::Writer> writer;
 	std::function<void()> success_callback;
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "channel_recorder.hpp"
+
+#include "string_format.hpp"
+
+#include <algorithm>
+
+ChannelRecorder::ChannelRecorder(
+	const size_t sampling_rate
+) : sampling_rate { sampling_rate }
+{
+	chMtxInit(&mutex);
+
+	make_new_directory(u"SCANNER");
+	if( !index.append(u"SCANNER/SEGMENTS.TXT").is_valid() && (index.size() == 0) ) {
+		index.write_line("frequency,sample_offset,datetime");
+	}
+}
+
+void ChannelRecorder::set_channel(const uint64_t offset, const rf::Frequency frequency) {
+	Switch next { offset, frequency, { } };
+	rtcGetTime(&RTCD1, &next.datetime);
+
+	chMtxLock(&mutex);
+	// Full: the newest replaces the last, which never got to start anyway.
+	if( (switches_in - switches_out) == switches.size() ) {
+		switches_in--;
+	}
+	switches[switches_in++ % switches.size()] = next;
+	chMtxUnlock();
+}
+
+bool ChannelRecorder::next_switch(Switch& next) {
+	chMtxLock(&mutex);
+	const bool pending = (switches_in != switches_out);
+	if( pending ) {
+		next = switches[switches_out % switches.size()];
+	}
+	chMtxUnlock();
+	return pending;
+}
+
+File::Result<File::Size> ChannelRecorder::write(const void* const buffer, const File::Size bytes) {
+	auto data = static_cast<const uint8_t*>(buffer);
+	const auto end = offset + bytes;
+
+	while( offset < end ) {
+		// Switches at or before here apply now, a later one splits the write.
+		uint64_t piece_end = end;
+		Switch next;
+		if( next_switch(next) ) {
+			if( next.offset <= offset ) {
+				switches_out++;
+				const auto segment_error = begin_segment(next);
+				if( segment_error.is_valid() ) {
+					return segment_error.value();
+				}
+				continue;
+			}
+			piece_end = std::min(piece_end, next.offset);
+		}
+
+		const File::Size piece = piece_end - offset;
+		if( current ) {
+			const auto write_result = current->writer->write(data, piece);
+			if( write_result.is_error() ) {
+				return write_result.error();
+			}
+		}
+		data += piece;
+		offset = piece_end;
+	}
+
+	return { bytes };
+}
+
+Optional<File::Error> ChannelRecorder::sync() {
+	for(auto& channel : channels) {
+		if( channel.writer ) {
+			const auto sync_error = channel.writer->sync();
+			if( sync_error.is_valid() ) {
+				return sync_error;
+			}
+		}
+	}
+	return index.sync();
+}
+
+Optional<File::Error> ChannelRecorder::begin_segment(const Switch& next) {
+	current = nullptr;
+	if( next.frequency == 0 ) {
+		return { };
+	}
+
+	const auto open_error = open_channel(next.frequency);
+	if( open_error.is_valid() ) {
+		return open_error;
+	}
+
+	return index.write_line(
+		to_string_dec_uint(next.frequency) + "," +
+		to_string_dec_uint64(current->writer->data_size() / sizeof(int16_t)) + "," +
+		to_string_datetime(next.datetime)
+	);
+}
+
+Optional<File::Error> ChannelRecorder::open_channel(const rf::Frequency frequency) {
+	uses++;
+
+	auto hit = std::find_if(channels.begin(), channels.end(),
+		[frequency](const Channel& channel) { return channel.writer && (channel.frequency == frequency); }
+	);
+	if( hit == channels.end() ) {
+		// Least recently used (or unused) slot, closing finalizes its file.
+		hit = std::min_element(channels.begin(), channels.end(),
+			[](const Channel& a, const Channel& b) { return a.last_used < b.last_used; }
+		);
+		hit->writer.reset();
+
+		std::filesystem::path path { u"SCANNER/" };
+		path += to_string_dec_uint(frequency);
+		path.replace_extension(u".WAV");
+		auto writer = std::make_unique<WAVFileWriter>();
+		auto open_error = writer->append(path, sampling_rate);
+		if( open_error.is_valid() ) {
+			writer = std::make_unique<WAVFileWriter>();
+			open_error = writer->create(path, sampling_rate, "", reserve_size);
+			if( open_error.is_valid() ) {
+				return open_error;
+			}
+		}
+		hit->frequency = frequency;
+		hit->writer = std::move(writer);
+	}
+
+	hit->last_used = uses;
+	current = &*hit;
+	return { };
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CHANNEL_RECORDER_H__
+#define __CHANNEL_RECORDER_H__
+
+#include "io.hpp"
+#include "io_wave.hpp"
+#include "rf_path.hpp"
+
+#include "ch.h"
+#include "lpc43xx_cpp.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <memory>
+
+/* Audio stream writer that sorts a scanner's audio into one WAV per channel,
+ * SCANNER/<frequency in Hz>.WAV, each visit to a channel appended to its
+ * file as a segment and listed in SCANNER/SEGMENTS.TXT as
+ * "frequency,sample_offset,datetime". Runs on the CaptureThread. The last
+ * few channels' files are kept open, new ones are preallocated, so a
+ * segment start is at most a header update away.
+ */
+class ChannelRecorder : public stream::Writer {
+public:
+	ChannelRecorder(const size_t sampling_rate);
+
+	ChannelRecorder(const ChannelRecorder&) = delete;
+	ChannelRecorder(ChannelRecorder&&) = delete;
+	ChannelRecorder& operator=(const ChannelRecorder&) = delete;
+	ChannelRecorder& operator=(ChannelRecorder&&) = delete;
+
+	/* From the UI: stream bytes from offset (the capture's bytes received
+	 * less dropped) on are frequency's, or discarded for 0.
+	 */
+	void set_channel(const uint64_t offset, const rf::Frequency frequency);
+
+	File::Result<File::Size> write(const void* const buffer, const File::Size bytes) override;
+	Optional<File::Error> sync() override;
+
+private:
+	static constexpr size_t files_max = 4;
+	// About 90s of NFM audio.
+	static constexpr File::Size reserve_size = 4 * 1024 * 1024;
+	static constexpr size_t switches_max = 8;
+
+	struct Switch {
+		uint64_t offset;
+		rf::Frequency frequency;
+		lpc43xx::rtc::RTC datetime;
+	};
+
+	struct Channel {
+		rf::Frequency frequency;
+		std::unique_ptr<WAVFileWriter> writer;
+		uint32_t last_used;
+	};
+
+	const size_t sampling_rate;
+
+	Mutex mutex { };
+	std::array<Switch, switches_max> switches { };
+	size_t switches_in { 0 };
+	size_t switches_out { 0 };
+
+	std::array<Channel, files_max> channels { };
+	Channel* current { nullptr };
+	uint64_t offset { 0 };
+	uint32_t uses { 0 };
+	File index { };
+
+	bool next_switch(Switch& next);
+	Optional<File::Error> begin_segment(const Switch& next);
+	Optional<File::Error> open_channel(const rf::Frequency frequency);
+};
+
+#endif/*__CHANNEL_RECORDER_H__*/
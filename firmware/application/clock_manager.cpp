@@ -27,6 +27,8 @@ using namespace hackrf::one;
 #include "lpc43xx_cpp.hpp"
 using namespace lpc43xx;
 
+#include <algorithm>
+
 static void set_clock(LPC_CGU_BASE_CLK_Type& clk, const cgu::CLK_SEL clock_source) {
 	clk.AUTOBLOCK = 1;
 	clk.CLK_SEL = toUType(clock_source);
@@ -279,6 +281,7 @@ void ClockManager::init(const bool use_clkin) {
 	clock_generator.write(si5351_pll_a_xtal_reg);
 	clock_generator.write(si5351_pll_b_clkin_reg);
 	clock_generator.write(si5351_ms_0_8m_reg);
+	codec_ms_reg = si5351_ms_0_8m_reg;
 	clock_generator.write(si5351_ms_1_group_reg);
 	clock_generator.write(si5351_ms_2_group_reg);
 	clock_generator.write(si5351_ms_3_10m_reg);
@@ -357,7 +360,37 @@ void ClockManager::set_sampling_frequency(const uint32_t frequency) {
 	 * necessary to change the MS0 synth frequency, and ensure the output
 	 * is divided by two.
 	 */
-	clock_generator.set_ms_frequency(clock_generator_output_codec, frequency * 2, si5351_vco_f, 1);
+	const uint32_t ms_frequency = frequency * 2;
+	auto clock = std::find_if(sampling_clocks.begin(), sampling_clocks.end(),
+		[ms_frequency](const SamplingClock& c) { return c.frequency == ms_frequency; }
+	);
+	if( clock == sampling_clocks.end() ) {
+		clock = &sampling_clocks[sampling_clocks_next];
+		sampling_clocks_next = (sampling_clocks_next + 1) % sampling_clocks.size();
+		*clock = { ms_frequency, si5351::ms_frequency_reg(clock_generator_output_codec, ms_frequency, si5351_vco_f, 1) };
+	}
+
+	/* Only the span of registers that differ from what's in the chip, in
+	 * one burst. Rates are often set again unchanged, on every app switch.
+	 */
+	const auto& reg = clock->reg;
+	size_t first = 1;
+	while( (first < reg.size()) && (reg[first] == codec_ms_reg[first]) ) {
+		first++;
+	}
+	if( first == reg.size() ) {
+		return;
+	}
+	size_t last = reg.size() - 1;
+	while( reg[last] == codec_ms_reg[last] ) {
+		last--;
+	}
+
+	si5351::MultisynthFractionalReg burst;
+	burst[0] = reg[0] + (first - 1);
+	std::copy(&reg[first], &reg[last + 1], &burst[1]);
+	clock_generator.write(burst.data(), last - first + 2);
+	codec_ms_reg = reg;
 }
 
 void ClockManager::set_reference_ppb(const int32_t ppb) {
@@ -535,6 +568,44 @@ void ClockManager::stop_audio_pll() {
 	while( cgu::pll0audio::is_locked() );
 }
 
+void ClockManager::start_usb_pll() {
+	LPC_CGU->PLL0USB_CTRL.PD = 1;
+	LPC_CGU->PLL0USB_CTRL.AUTOBLOCK = 1;
+	LPC_CGU->PLL0USB_CTRL.CLK_SEL = toUType(cgu::CLK_SEL::GP_CLKIN);
+
+	/* For 40MHz clock source, 480MHz USB0 clock, direct in and out:
+	 *		Fcco=480MHz, NSEL=1, MSEL=6
+	 *		NDEC=0x302, MDEC=0x000f, SELP=4, SELI=8
+	 */
+	LPC_CGU->PLL0USB_MDIV =
+		  (0x000fU <<  0)	// MDEC
+		| (4U << 17)		// SELP
+		| (8U << 22)		// SELI
+		;
+	LPC_CGU->PLL0USB_NP_DIV = (0x302U << 12);
+	LPC_CGU->PLL0USB_CTRL.DIRECTI = 1;
+	LPC_CGU->PLL0USB_CTRL.DIRECTO = 1;
+	LPC_CGU->PLL0USB_CTRL.CLKEN = 1;
+
+	LPC_CGU->PLL0USB_CTRL.PD = 0;
+	while( !LPC_CGU->PLL0USB_STAT.LOCK );
+
+	LPC_CGU->BASE_USB0_CLK.PD = 0;
+	set_clock(LPC_CGU->BASE_USB0_CLK, cgu::CLK_SEL::PLL0USB);
+	LPC_CCU1->CLK_M4_USB0_CFG.RUN = 1;
+	LPC_CCU1->CLK_USB0_CFG.RUN = 1;
+}
+
+void ClockManager::stop_usb_pll() {
+	LPC_CCU1->CLK_USB0_CFG.RUN = 0;
+	LPC_CCU1->CLK_M4_USB0_CFG.RUN = 0;
+	LPC_CGU->BASE_USB0_CLK.PD = 1;
+
+	LPC_CGU->PLL0USB_CTRL.CLKEN = 0;
+	LPC_CGU->PLL0USB_CTRL.PD = 1;
+	while( LPC_CGU->PLL0USB_STAT.LOCK );
+}
+
 void ClockManager::stop_peripherals() {
 	i2c0.stop();
 }
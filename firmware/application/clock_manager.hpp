@@ -31,6 +31,9 @@
 #include "lpc43xx_cpp.hpp"
 using namespace lpc43xx;
 
+#include <cstdint>
+#include <array>
+
 class ClockManager {
 public:
 	constexpr ClockManager(
@@ -53,6 +56,9 @@ public:
 
 	void set_base_audio_clock_divider(const size_t divisor);
 
+	void start_usb_pll();
+	void stop_usb_pll();
+
 	void enable_codec_clocks();
 	void disable_codec_clocks();
 
@@ -67,10 +73,21 @@ public:
 	void set_reference_ppb(const int32_t ppb);
 
 private:
+	struct SamplingClock {
+		uint32_t frequency;
+		si5351::MultisynthFractionalReg reg;
+	};
+
 	I2C& i2c0;
 	si5351::Si5351& clock_generator;
 	//uint32_t _clock_f;
 
+	// Register sets of the sampling rates seen so far, replaced round-robin.
+	std::array<SamplingClock, 8> sampling_clocks { };
+	size_t sampling_clocks_next { 0 };
+	// The codec multisynth's registers as last written.
+	si5351::MultisynthFractionalReg codec_ms_reg { };
+
 	void change_clock_configuration(const cgu::CLK_SEL clk_sel);
 
 	void enable_gp_clkin_source();
@@ -28,8 +28,89 @@ using namespace lpc43xx;
 
 #include "message.hpp"
 #include "baseband_api.hpp"
+#include "sd_modules.hpp"
+
+#include "gpdma.hpp"
+#include "portapack_dma.hpp"
+
+#include "lz4.hpp"
 
 #include <cstring>
+#include <array>
+#include <algorithm>
+
+namespace {
+
+constexpr auto& m4_image_gpdma_channel = gpdma::channels[portapack::m4_image_gpdma_channel_number];
+
+// 32KiB images in 8KiB blocks, below the 4095 transfers limit of one LLI
+constexpr size_t m4_image_lli_words = 2048;
+std::array<gpdma::channel::LLI, portapack::memory::map::m4_code.size() / (m4_image_lli_words * 4)> m4_image_lli;
+
+uint32_t m4_image_pending_base { 0 };
+size_t m4_image_length { 0 };
+
+constexpr gpdma::channel::Control m4_image_control(const size_t number_of_words) {
+	return {
+		.transfersize = number_of_words,
+		.sbsize = 1,  /* Burst size: 4 transfers */
+		.dbsize = 1,  /* Burst size: 4 transfers */
+		.swidth = 2,  /* Source transfer width: word (32 bits) */
+		.dwidth = 2,  /* Destination transfer width: word (32 bits) */
+		.s = 0,
+		.d = 1,
+		.si = 1,
+		.di = 1,
+		.prot1 = 0,
+		.prot2 = 0,
+		.prot3 = 0,
+		.i = 0,
+	};
+}
+
+constexpr gpdma::channel::Config m4_image_config() {
+	return {
+		.e = 0,
+		.srcperipheral = 0,
+		.destperipheral = 0,
+		.flowcntrl = gpdma::FlowControl::MemoryToMemory_DMAControl,
+		.ie = 0,
+		.itc = 0,
+		.l = 0,
+		.a = 0,
+		.h = 0,
+	};
+}
+
+const portapack::spi_flash::chunk_t* find_chunk(const portapack::spi_flash::image_tag_t image_tag) {
+	const auto images_base = reinterpret_cast<uint32_t>(portapack::spi_flash::images.base());
+	const portapack::spi_flash::chunk_t* chunk = reinterpret_cast<const portapack::spi_flash::chunk_t*>(images_base);
+
+	if( chunk->tag == portapack::spi_flash::image_tag_directory ) {
+		const auto entries = reinterpret_cast<const portapack::spi_flash::directory_entry_t*>(&chunk->data[0]);
+		const auto entries_end = entries + (chunk->length / sizeof(portapack::spi_flash::directory_entry_t));
+		const auto entry = std::lower_bound(entries, entries_end, image_tag,
+			[](const portapack::spi_flash::directory_entry_t& e, const portapack::spi_flash::image_tag_t& tag) {
+				return e.tag < tag;
+			}
+		);
+		if( (entry != entries_end) && (entry->tag == image_tag) ) {
+			return reinterpret_cast<const portapack::spi_flash::chunk_t*>(images_base + entry->offset);
+		}
+		return nullptr;
+	}
+
+	// No directory (older image): walk the chunks
+	while(chunk->tag) {
+		if( chunk->tag == image_tag ) {
+			return chunk;
+		}
+		chunk = chunk->next();
+	}
+	return nullptr;
+}
+
+} /* namespace */
 
 /* TODO: OK, this is cool, but how do I put the M4 to sleep so I can switch to
  * a different image? Other than asking the old image to sleep while the M0
@@ -38,27 +119,101 @@ using namespace lpc43xx;
  * I suppose I could force M4MEMMAP to an invalid memory reason which would
  * cause an exception and effectively halt the M4. But that feels gross.
  */
+static void m4_copy(const portapack::spi_flash::chunk_t* const chunk, const portapack::memory::region_t to) {
+	const auto dst = reinterpret_cast<uint8_t*>(to.base());
+	m4_image_length = chunk->image_length();
+	if( chunk->compressed() ) {
+		// Straight from SPIFI into M4 RAM, no staging buffer.
+		const size_t header_length = sizeof(uint32_t);
+		if( (chunk->image_length() > to.size()) ||
+			!lz4::decompress_block(&chunk->data[header_length], chunk->data_length() - header_length, dst, chunk->image_length()) ) {
+			chDbgPanic("BadImg");
+		}
+	} else {
+		std::memcpy(dst, &chunk->data[0], chunk->length);
+	}
+}
+
+static void m4_reset(const portapack::memory::region_t to) {
+	/* M4 core is assumed to be sleeping with interrupts off, so we can mess
+	 * with its address space and RAM without concern.
+	 */
+	LPC_CREG->M4MEMMAP = to.base();
+
+	/* Reset M4 core */
+	LPC_RGU->RESET_CTRL[0] = (1 << 13);
+}
+
 void m4_init(const portapack::spi_flash::image_tag_t image_tag, const portapack::memory::region_t to) {
-	const portapack::spi_flash::chunk_t* chunk = reinterpret_cast<const portapack::spi_flash::chunk_t*>(portapack::spi_flash::images.base());
-	while(chunk->tag) {
-		if( chunk->tag == image_tag ) {
-			/* Initialize M4 code RAM */
-			std::memcpy(reinterpret_cast<void*>(to.base()), &chunk->data[0], chunk->length);
+	const auto chunk = find_chunk(image_tag);
+	if( !chunk ) {
+		chDbgPanic("NoImg");
+	}
+
+	/* Initialize M4 code RAM. Also used after portapack::shutdown(), with
+	 * GPDMA off, so no DMA here.
+	 */
+	m4_copy(chunk, to);
+	m4_reset(to);
+}
+
+void m4_init_start(const portapack::spi_flash::image_tag_t image_tag, const portapack::memory::region_t to) {
+	// A copy on the SD card wins, it's there to replace the one in flash.
+	const auto sd_length = sd_modules::load(image_tag, to);
+	if( sd_length ) {
+		m4_image_pending_base = to.base();
+		m4_image_length = sd_length;
+		return;
+	}
 
-			/* M4 core is assumed to be sleeping with interrupts off, so we can mess
-			 * with its address space and RAM without concern.
-			 */
-			LPC_CREG->M4MEMMAP = to.base();
+	const auto chunk = find_chunk(image_tag);
+	if( !chunk ) {
+		chDbgPanic("NoImg");
+	}
 
-			/* Reset M4 core */
-			LPC_RGU->RESET_CTRL[0] = (1 << 13);
+	m4_image_pending_base = to.base();
+	if( chunk->compressed() || (chunk->length > (m4_image_lli.size() * m4_image_lli_words * 4)) ) {
+		m4_copy(chunk, to);
+		return;
+	}
 
-			return;
+	/* Initialize M4 code RAM in the background (see m4_reset()). */
+	m4_image_length = chunk->length;
+	const size_t words = chunk->length / 4;
+	size_t lli_count = 0;
+	for(size_t offset=0; offset<words; offset+=m4_image_lli_words) {
+		auto& lli = m4_image_lli[lli_count++];
+		lli.srcaddr = reinterpret_cast<uint32_t>(&chunk->data[offset * 4]);
+		lli.destaddr = to.base() + (offset * 4);
+		lli.lli = 0;
+		lli.control = m4_image_control(std::min(m4_image_lli_words, words - offset));
+		if( lli_count > 1 ) {
+			m4_image_lli[lli_count - 2].lli = reinterpret_cast<uint32_t>(&lli);
 		}
-		chunk = chunk->next();
 	}
 
-	chDbgPanic("NoImg");
+	if( lli_count == 0 ) {
+		return;
+	}
+
+	m4_image_gpdma_channel.configure(m4_image_lli[0], m4_image_config());
+	m4_image_gpdma_channel.enable();
+}
+
+void m4_init_complete() {
+	if( !m4_image_pending_base ) {
+		return;
+	}
+
+	// The channel disables itself after the last LLI
+	while( m4_image_gpdma_channel.is_enabled() );
+
+	m4_reset({ m4_image_pending_base, 0 });
+	m4_image_pending_base = 0;
+}
+
+size_t m4_image_size() {
+	return m4_image_length;
 }
 
 void m4_request_shutdown() {
@@ -28,6 +28,13 @@
 #include "spi_image.hpp"
 
 void m4_init(const portapack::spi_flash::image_tag_t image_tag, const portapack::memory::region_t to);
+/* Starts copying the image with GPDMA and returns, the M4 is reset into it
+ * by m4_init_complete(). Nothing else may touch the M4 in between.
+ */
+void m4_init_start(const portapack::spi_flash::image_tag_t image_tag, const portapack::memory::region_t to);
+void m4_init_complete();
+/* Bytes of code and initialized data the last image loaded took. */
+size_t m4_image_size();
 void m4_request_shutdown();
 
 void m0_halt();
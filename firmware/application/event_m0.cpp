@@ -26,20 +26,29 @@
 
 #include "sd_card.hpp"
 #include "rtc_time.hpp"
+#include "sample_clock.hpp"
 
 #include "message.hpp"
 #include "message_queue.hpp"
 
 #include "irq_controls.hpp"
+#include "irq_lcd_frame.hpp"
 
 #include "buffer_exchange.hpp"
 
+#include "core_control.hpp"
+#include "baseband_api.hpp"
+#include "remote_control.hpp"
+#include "trace.hpp"
+
 #include "ch.h"
 
 #include "lpc43xx_cpp.hpp"
 using namespace lpc43xx;
 
+#include <algorithm>
 #include <array>
+#include <cstring>
 
 #include "ui_font_fixed_8x16.hpp"
 
@@ -62,17 +71,15 @@ CH_IRQ_HANDLER(M4Core_IRQHandler) {
 
 class MessageHandlerMap {
 public:
-	using MessageHandler = std::function<void(Message* const p)>;
-
 	void register_handler(const Message::ID id, MessageHandler&& handler) {
-		if( map_[toUType(id)] != nullptr ) {
+		if( map_[toUType(id)] ) {
 			chDbgPanic("MsgDblReg");
 		}
-		map_[toUType(id)] = std::move(handler);
+		map_[toUType(id)] = handler;
 	}
 
 	void unregister_handler(const Message::ID id) {
-		map_[toUType(id)] = nullptr;
+		map_[toUType(id)] = { };
 	}
 
 	void send(Message* const message) {
@@ -90,9 +97,109 @@ private:
 };
 
 static MessageHandlerMap message_map;
+
+namespace {
+
+/* Reports of current state, where only the newest of a burst matters.
+ * These are held back to the end of an application queue pass and
+ * delivered once each.
+ */
+struct CoalescedType {
+	Message::ID id;
+	size_t size;
+};
+
+constexpr CoalescedType coalesced_types[] {
+	{ Message::ID::RSSIStatistics, sizeof(RSSIStatisticsMessage) },
+	{ Message::ID::BasebandStatistics, sizeof(BasebandStatisticsMessage) },
+	{ Message::ID::ChannelStatistics, sizeof(ChannelStatisticsMessage) },
+	{ Message::ID::AudioStatistics, sizeof(AudioStatisticsMessage) },
+	{ Message::ID::AudioLevelReport, sizeof(AudioLevelReportMessage) },
+	{ Message::ID::ProcessorStatistics, sizeof(ProcessorStatisticsMessage) },
+};
+
+constexpr size_t coalesced_count = sizeof(coalesced_types) / sizeof(coalesced_types[0]);
+constexpr size_t coalesced_size_max = 40;
+
+constexpr bool coalesced_types_fit() {
+	for(const auto& type : coalesced_types) {
+		if( type.size > coalesced_size_max ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static_assert(coalesced_types_fit(), "coalesced_size_max too small for a coalesced message");
+
+struct alignas(8) CoalescedSlot {
+	uint8_t data[coalesced_size_max];
+};
+
+std::array<CoalescedSlot, coalesced_count> coalesced_slots;
+uint32_t coalesced_pending { 0 };
+
+bool coalesce(const Message* const message) {
+	for(size_t i=0; i<coalesced_count; i++) {
+		if( coalesced_types[i].id == message->id ) {
+			memcpy(coalesced_slots[i].data, message, coalesced_types[i].size);
+			coalesced_pending |= (1U << i);
+			return true;
+		}
+	}
+	return false;
+}
+
+void send_coalesced() {
+	for(size_t i=0; coalesced_pending && (i<coalesced_count); i++) {
+		if( coalesced_pending & (1U << i) ) {
+			coalesced_pending &= ~(1U << i);
+			message_map.send(reinterpret_cast<Message*>(coalesced_slots[i].data));
+		}
+	}
+}
+
+debug::FrameStatistics frame_stats { };
+
+void record_frame(const uint32_t start_us, const uint32_t paint_us, const bool late, const bool complete) {
+	auto& s = frame_stats;
+	s.frames++;
+	if( late ) {
+		s.late_starts++;
+	}
+	if( !complete ) {
+		s.deferred++;
+	}
+	s.max_paint_us = std::max(s.max_paint_us, paint_us);
+	s.max_start_us = std::max(s.max_start_us, start_us);
+
+	size_t bucket = 0;
+	while( (bucket < s.bucket_limits_us.size()) && (paint_us >= s.bucket_limits_us[bucket]) ) {
+		bucket++;
+	}
+	s.paint_us_histogram[bucket]++;
+}
+
+} /* namespace */
+
+namespace debug {
+
+constexpr std::array<uint32_t, FrameStatistics::bucket_count - 1> FrameStatistics::bucket_limits_us;
+
+const FrameStatistics& frame_statistics() {
+	return frame_stats;
+}
+
+void reset_frame_statistics() {
+	frame_stats = { };
+}
+
+} /* namespace debug */
+
 Thread* EventDispatcher::thread_event_loop = nullptr;
 bool EventDispatcher::is_running = false;
 bool EventDispatcher::display_sleep = false;
+bool EventDispatcher::low_power = false;
 
 EventDispatcher::EventDispatcher(
 	ui::Widget* const top_widget,
@@ -105,9 +212,6 @@ EventDispatcher::EventDispatcher(
 
 	thread_event_loop = chThdSelf();
 	is_running = true;
-	touch_manager.on_event = [this](const ui::TouchEvent event) {
-		this->on_touch_event(event);
-	};
 }
 
 void EventDispatcher::run() {
@@ -124,11 +228,30 @@ void EventDispatcher::request_stop() {
 void EventDispatcher::set_display_sleep(const bool sleep) {
 	// TODO: Distribute display sleep message more broadly, shut down data generation
 	// on baseband side, since all that data is being discarded during sleep.
+	if( sleep == EventDispatcher::display_sleep ) {
+		// The backlight timer asks again every second.
+		return;
+	}
+
 	if( sleep ) {
 		portapack::backlight()->off();
 		portapack::display.sleep();
+		lcd_frame_sync_disable();
+
+		// Both cores share BASE_M4_CLK, so this can only slow down when the
+		// baseband has nothing to do. Audio and RF need PLL1 otherwise.
+		if( !baseband::image_running() ) {
+			portapack::clock_manager.run_from_irc();
+			low_power = true;
+		}
 	} else {
+		if( low_power ) {
+			portapack::clock_manager.run_at_full_speed();
+			low_power = false;
+		}
+
 		portapack::display.wake();
+		lcd_frame_sync_enable();
 		// Don't turn on backlight here.
 		// Let frame sync handler turn on backlight after repaint.
 	}
@@ -140,6 +263,11 @@ eventmask_t EventDispatcher::wait() {
 }
 
 void EventDispatcher::dispatch(const eventmask_t events) {
+	TRACE_SCOPE(M0Dispatch, events);
+
+	// Release the M4 once its image is in, for views that never message it.
+	m4_init_complete();
+
 	if( shared_memory.m4_panic_msg[0] != 0 ) {
 		halt = true;
 	}
@@ -174,8 +302,23 @@ void EventDispatcher::dispatch(const eventmask_t events) {
 		return;
 	}
 
-	if( events & EVT_MASK_APPLICATION ) {
-		handle_application_queue();
+	// Input first, so a flood of baseband messages can't delay it.
+	if( events & EVT_MASK_SWITCHES ) {
+		handle_switches();
+	}
+
+	if( !EventDispatcher::display_sleep ) {
+		if( events & EVT_MASK_ENCODER ) {
+			handle_encoder();
+		}
+	}
+
+	if( events & EVT_MASK_TOUCH ) {
+		handle_touch();
+	}
+
+	if( events & EVT_MASK_USB_SERIAL ) {
+		RemoteControl::on_serial_rx();
 	}
 
 	if( events & EVT_MASK_LOCAL ) {
@@ -185,34 +328,44 @@ void EventDispatcher::dispatch(const eventmask_t events) {
 	if( events & EVT_MASK_RTC_TICK ) {
 		handle_rtc_tick();
 	}
-	
-	if( events & EVT_MASK_SWITCHES ) {
-		handle_switches();
+
+	if( events & EVT_MASK_APPLICATION ) {
+		const bool frame_due = (events & EVT_MASK_LCD_FRAME_SYNC) && !EventDispatcher::display_sleep;
+		handle_application_queue(frame_due ? application_queue_frame_budget : application_queue_budget);
 	}
-	
+
 	/*if( events & EVT_MASK_LCD_FRAME_SYNC ) {
 		blink_timer();
 	}*/
 
+	// Last, to paint what the messages above changed.
 	if( !EventDispatcher::display_sleep ) {
 		if( events & EVT_MASK_LCD_FRAME_SYNC ) {
 			handle_lcd_frame_sync();
 		}
+	}
+}
 
-		if( events & EVT_MASK_ENCODER ) {
-			handle_encoder();
+void EventDispatcher::handle_application_queue(const systime_t budget) {
+	const auto start = chTimeNow();
+	const bool drained = shared_memory.application_queue.handle_while(
+		[](Message* const message) {
+			if( !coalesce(message) ) {
+				message_map.send(message);
+			}
+		},
+		[start, budget]() {
+			return (systime_t)(chTimeNow() - start) < budget;
 		}
+	);
 
-		if( events & EVT_MASK_TOUCH ) {
-			handle_touch();
-		}
-	}
-}
+	send_coalesced();
 
-void EventDispatcher::handle_application_queue() {
-	shared_memory.application_queue.handle([](Message* const message) {
-		message_map.send(message);
-	});
+	if( !drained ) {
+		// The baseband only rings when the queue was empty, so come back
+		// for the rest ourselves once input and repaint had their turn.
+		events_flag(EVT_MASK_APPLICATION);
+	}
 }
 
 void EventDispatcher::handle_local_queue() {
@@ -226,7 +379,9 @@ void EventDispatcher::handle_rtc_tick() {
 	
 	portapack::poll_ext_clock();
 
-	portapack::temperature_logger.second_tick();
+	if( portapack::temperature_logger.second_tick() ) {
+		portapack::receiver_model.on_temperature(portapack::temperature_logger.latest());
+	}
 	
 	uint32_t backlight_timer = portapack::persistent_memory::config_backlight_timer();
 	if (backlight_timer) {
@@ -236,6 +391,7 @@ void EventDispatcher::handle_rtc_tick() {
 			portapack::bl_tick_counter++;
 	}
 
+	sample_clock::update();
 	rtc_time::on_tick_second();
 }
 
@@ -284,7 +440,20 @@ void EventDispatcher::on_touch_event(ui::TouchEvent event) {
 void EventDispatcher::handle_lcd_frame_sync() {
 	DisplayFrameSyncMessage message;
 	message_map.send(&message);
-	painter.paint_widget_tree(top_widget);
+
+	const uint32_t ticks_per_us = halGetCounterFrequency() / 1000000U;
+	const auto frame_start = lcd_frame_sync_time();
+	const auto start = halGetCounterValue();
+	const uint32_t start_us = (start - frame_start) / ticks_per_us;
+	const bool late = (start_us > late_start_us);
+	// Too late for this frame, tearing or not: at least paint it all.
+	const auto deadline = (late ? start : frame_start) + paint_budget_us * ticks_per_us;
+
+	if( ui::is_dirty() ) {
+		const bool complete = painter.paint_widget_tree(top_widget, deadline);
+		record_frame(start_us, (halGetCounterValue() - start) / ticks_per_us, late, complete);
+		TRACE_COMPLETE(Paint, start, start_us);
+	}
 
 	portapack::backlight()->on();
 }
@@ -330,7 +499,13 @@ void EventDispatcher::handle_encoder() {
 }
 
 void EventDispatcher::handle_touch() {
-	touch_manager.feed(get_touch_frame());
+	ui::TouchEvent event;
+	while( get_touch_event(event) ) {
+		// Drained while asleep too, or waking would replay stale touches.
+		if( !EventDispatcher::display_sleep ) {
+			on_touch_event(event);
+		}
+	}
 }
 
 bool EventDispatcher::event_bubble_key(const ui::KeyEvent event) {
@@ -356,7 +531,7 @@ void EventDispatcher::init_message_queues() {
 
 MessageHandlerRegistration::MessageHandlerRegistration(
 	const Message::ID message_id,
-	MessageHandlerMap::MessageHandler&& callback
+	MessageHandler&& callback
 ) : message_id { message_id }
 {
 	message_map.register_handler(message_id, std::move(callback));
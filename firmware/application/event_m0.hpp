@@ -37,15 +37,47 @@
 #include "ch.h"
 
 #include <cstdint>
+#include <array>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 constexpr auto EVT_MASK_RTC_TICK        = EVENT_MASK(0);
 constexpr auto EVT_MASK_LCD_FRAME_SYNC  = EVENT_MASK(1);
+constexpr auto EVT_MASK_USB_SERIAL      = EVENT_MASK(2);
 constexpr auto EVT_MASK_SWITCHES		= EVENT_MASK(3);
 constexpr auto EVT_MASK_ENCODER			= EVENT_MASK(4);
 constexpr auto EVT_MASK_TOUCH			= EVENT_MASK(5);
 constexpr auto EVT_MASK_APPLICATION     = EVENT_MASK(6);
 constexpr auto EVT_MASK_LOCAL           = EVENT_MASK(7);
 
+namespace debug {
+
+/* Repaints, timed from the frame sync edge before them. Frames with nothing
+ * to paint aren't counted.
+ */
+struct FrameStatistics {
+	// Paint time, bucket n below bucket_limits_us[n], the last above them all.
+	static constexpr size_t bucket_count = 7;
+	static constexpr std::array<uint32_t, bucket_count - 1> bucket_limits_us { {
+		1000, 2000, 4000, 8000, 12000, 16000
+	} };
+
+	uint32_t frames;
+	// Started more than late_start_us after frame sync, tearing likely.
+	uint32_t late_starts;
+	// Hit the paint budget, leaving widgets for the next frame.
+	uint32_t deferred;
+	uint32_t max_paint_us;
+	uint32_t max_start_us;
+	std::array<uint32_t, bucket_count> paint_us_histogram;
+};
+
+const FrameStatistics& frame_statistics();
+void reset_frame_statistics();
+
+} /* namespace debug */
+
 class EventDispatcher {
 public:
 	EventDispatcher(
@@ -88,9 +120,23 @@ public:
 	}
 
 private:
+	/* Longest stretch spent on the application queue per pass, leaving the
+	 * rest for after input and the next repaint.
+	 */
+	static constexpr systime_t application_queue_budget = MS2ST(8);
+	/* With a repaint due in the same pass, so it starts close to frame
+	 * sync, while the display's scan out is still above what it draws.
+	 */
+	static constexpr systime_t application_queue_frame_budget = MS2ST(2);
+
+	/* Painting past this, from frame sync, races scan out of the next frame
+	 * (~70Hz); what's left waits for it instead.
+	 */
+	static constexpr uint32_t paint_budget_us = 10000;
+	static constexpr uint32_t late_start_us = 4000;
+
 	static Thread* thread_event_loop;
 
-	touch::Manager touch_manager { };
 	ui::Widget* const top_widget;
 	ui::Painter painter;
 	ui::Context& context;
@@ -98,12 +144,14 @@ private:
 	static bool is_running;
 	bool sd_card_present = false;
 	static bool display_sleep;
+	// Running from the IRC while the display sleeps.
+	static bool low_power;
 	bool halt = false;
 
 	eventmask_t wait();
 	void dispatch(const eventmask_t events);
 
-	void handle_application_queue();
+	void handle_application_queue(const systime_t budget);
 	void handle_local_queue();
 	void handle_rtc_tick();
 
@@ -125,11 +173,64 @@ private:
 	void init_message_queues();
 };
 
+/* A message callback held in place, without std::function's heap and
+ * manager: a call is one indirect call into code specialized for the bound
+ * callable. Takes callables copyable as plain bytes that fit storage_size,
+ * which covers the usual [this] and [this, &nav] lambdas.
+ */
+class MessageHandler {
+public:
+	static constexpr size_t storage_size = 2 * sizeof(void*);
+
+	constexpr MessageHandler() = default;
+
+	template<typename F, typename Fn = typename std::decay<F>::type,
+		typename = typename std::enable_if<!std::is_same<Fn, MessageHandler>::value>::type>
+	MessageHandler(F&& f) : invoke_ { &invoke<Fn> } {
+		static_assert(sizeof(Fn) <= storage_size, "MessageHandler: capture too big, capture this and reach the rest through it");
+		static_assert(alignof(Fn) <= alignof(Storage), "MessageHandler: capture alignment");
+		static_assert(std::is_trivially_copyable<Fn>::value && std::is_trivially_destructible<Fn>::value,
+			"MessageHandler: capture must be trivially copyable, capture this instead of objects");
+		new (&storage) Fn(std::forward<F>(f));
+	}
+
+	/* Binds a member function at compile time. */
+	template<typename T, void (T::*Method)(const Message* const)>
+	static MessageHandler bind(T* const object) {
+		return [object](Message* const p) { (object->*Method)(p); };
+	}
+
+	/* Same, for a member taking the concrete message type. */
+	template<typename M, typename T, void (T::*Method)(const M&)>
+	static MessageHandler bind(T* const object) {
+		return [object](Message* const p) { (object->*Method)(*static_cast<const M*>(p)); };
+	}
+
+	explicit operator bool() const {
+		return invoke_ != nullptr;
+	}
+
+	void operator()(Message* const p) {
+		invoke_(&storage, p);
+	}
+
+private:
+	using Storage = typename std::aligned_storage<storage_size, alignof(void*)>::type;
+
+	Storage storage { };
+	void (*invoke_)(void* const, Message* const) { nullptr };
+
+	template<typename Fn>
+	static void invoke(void* const storage, Message* const p) {
+		(*static_cast<Fn*>(storage))(p);
+	}
+};
+
 class MessageHandlerRegistration {
 public:
 	MessageHandlerRegistration(
 		const Message::ID message_id,
-		std::function<void(Message* const p)>&& callback
+		MessageHandler&& callback
 	);
 
 	~MessageHandlerRegistration();
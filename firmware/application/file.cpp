@@ -22,6 +22,8 @@
 
 #include "file.hpp"
 
+#include "diskio.h"
+
 #include <algorithm>
 #include <locale>
 #include <codecvt>
@@ -61,6 +63,10 @@ File::~File() {
 }
 
 File::Result<File::Size> File::read(void* const data, const Size bytes_to_read) {
+	if( reinterpret_cast<uintptr_t>(data) & 3 ) {
+		return read_unaligned(data, bytes_to_read);
+	}
+
 	UINT bytes_read = 0;
 	const auto result = f_read(&f, data, bytes_to_read, &bytes_read);
 	if( result == FR_OK ) {
@@ -70,6 +76,35 @@ File::Result<File::Size> File::read(void* const data, const Size bytes_to_read)
 	}
 }
 
+File::Result<File::Size> File::read_unaligned(void* const data, const Size bytes_to_read) {
+	constexpr Size sector_size = _MAX_SS;
+
+	// FatFs reads whole sectors straight into the caller's buffer, but the SD
+	// card DMA can only write words. Never asking for a whole sector makes it
+	// go through its own sector window instead: still one disk read per
+	// sector, the tail byte comes from the window.
+	auto p = static_cast<uint8_t*>(data);
+	Size total = 0;
+	while( total < bytes_to_read ) {
+		const Size to_boundary = sector_size - (f_tell(&f) % sector_size);
+		auto chunk = std::min(bytes_to_read - total, to_boundary);
+		if( chunk == sector_size ) {
+			chunk--;
+		}
+
+		UINT bytes_read = 0;
+		const auto result = f_read(&f, &p[total], chunk, &bytes_read);
+		if( result != FR_OK ) {
+			return { static_cast<Error>(result) };
+		}
+		total += bytes_read;
+		if( bytes_read < chunk ) {
+			break;
+		}
+	}
+	return { total };
+}
+
 File::Result<File::Size> File::write(const void* const data, const Size bytes_to_write) {
 	UINT bytes_written = 0;
 	const auto result = f_write(&f, data, bytes_to_write, &bytes_written);
@@ -84,6 +119,26 @@ File::Result<File::Size> File::write(const void* const data, const Size bytes_to
 	}
 }
 
+bool File::is_block_aligned(const void* const data, const Size bytes) {
+	return ((reinterpret_cast<uintptr_t>(data) & 3) == 0)
+		&& ((bytes % block_size) == 0)
+		&& ((f_tell(&f) % block_size) == 0);
+}
+
+File::Result<File::Size> File::read_blocks(void* const data, const Size bytes_to_read) {
+	if( !is_block_aligned(data, bytes_to_read) ) {
+		return { static_cast<Error>(FR_INVALID_PARAMETER) };
+	}
+	return read(data, bytes_to_read);
+}
+
+File::Result<File::Size> File::write_blocks(const void* const data, const Size bytes_to_write) {
+	if( !is_block_aligned(data, bytes_to_write) ) {
+		return { static_cast<Error>(FR_INVALID_PARAMETER) };
+	}
+	return write(data, bytes_to_write);
+}
+
 File::Result<File::Offset> File::seek(const Offset new_position) {
 	/* NOTE: Returns *old* position, not new position */
 	const auto old_position = f_tell(&f);
@@ -115,6 +170,53 @@ Optional<File::Error> File::write_line(const std::string& s) {
 	return { };
 }
 
+Optional<File::Error> File::preallocate(const Size size) {
+	const auto result = f_expand(&f, size, 1);
+	if( result == FR_OK ) {
+		return { };
+	} else {
+		return { result };
+	}
+}
+
+File::Result<File::Size> File::write_sectors(const Offset offset, const void* const data, const Size bytes_to_write) {
+	constexpr Size sector_size = _MAX_SS;
+
+	FATFS* const fs = f.obj.fs;
+	if( (fs == nullptr) || (f.obj.sclust < 2) ) {
+		return { static_cast<Error>(FR_INVALID_OBJECT) };
+	}
+	if( (offset % sector_size) || (bytes_to_write % sector_size) || ((offset + bytes_to_write) > f_size(&f)) ) {
+		return { static_cast<Error>(FR_INVALID_PARAMETER) };
+	}
+
+	// Contiguous chain, so the sector is a fixed offset from the first cluster.
+	const DWORD sector = fs->database + (f.obj.sclust - 2) * fs->csize + (offset / sector_size);
+	const UINT count = bytes_to_write / sector_size;
+
+	// Take the volume lock so raw access can't interleave with other FatFs calls.
+	if( !ff_req_grant(fs->sobj) ) {
+		return { static_cast<Error>(FR_TIMEOUT) };
+	}
+	const auto result = disk_write(fs->drv, static_cast<const BYTE*>(data), sector, count);
+	ff_rel_grant(fs->sobj);
+
+	if( result == RES_OK ) {
+		return { bytes_to_write };
+	} else {
+		return { static_cast<Error>(FR_DISK_ERR) };
+	}
+}
+
+Optional<File::Error> File::truncate() {
+	const auto result = f_truncate(&f);
+	if( result == FR_OK ) {
+		return { };
+	} else {
+		return { result };
+	}
+}
+
 Optional<File::Error> File::sync() {
 	const auto result = f_sync(&f);
 	if( result == FR_OK ) {
@@ -246,6 +348,7 @@ std::string filesystem_error::what() const {
 	case FR_DISK_FULL:				return "disk full";
 	case FR_BAD_SEEK:				return "bad seek";
 	case FR_UNEXPECTED:				return "unexpected";
+	case FR_USB_DISCONNECTED:		return "USB not connected";
 	default:						return "unknown";
 	}
 }
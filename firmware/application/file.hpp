@@ -256,6 +256,7 @@ static_assert(sizeof(FIL::err) == 1, "FatFs FIL::err size not expected.");
 #define FR_EOF          (0x101)
 #define FR_BAD_SEEK		(0x102)
 #define FR_UNEXPECTED	(0x103)
+#define FR_USB_DISCONNECTED	(0x104)
 
 class File {
 public:
@@ -326,9 +327,22 @@ public:
 	Optional<Error> append(const std::filesystem::path& filename);
 	Optional<Error> create(const std::filesystem::path& filename);
 
+	/* Any buffer alignment and length; unaligned buffers cost a copy. */
 	Result<Size> read(void* const data, const Size bytes_to_read);
 	Result<Size> write(const void* const data, const Size bytes_to_write);
 	
+	/* Zero-copy transfers: data word aligned, bytes a multiple of
+	 * block_size and the file pointer on a block boundary, so FatFs moves
+	 * every whole sector by SD card DMA straight to or from data, never
+	 * through its sector window. Anything else returns
+	 * FR_INVALID_PARAMETER rather than quietly taking the copying path.
+	 * Only a short final sector at end of file is still copied.
+	 */
+	static constexpr Size block_size = _MAX_SS;
+
+	Result<Size> read_blocks(void* const data, const Size bytes_to_read);
+	Result<Size> write_blocks(const void* const data, const Size bytes_to_write);
+
 	Result<Offset> seek(const uint64_t Offset);
 	Timestamp created_date();
 	Size size();
@@ -340,6 +354,20 @@ public:
 
 	Optional<Error> write_line(const std::string& s);
 
+	/* Reserve a contiguous cluster chain for a newly created, empty file.
+	 * File size becomes `size` until truncated.
+	 */
+	Optional<Error> preallocate(const Size size);
+
+	/* Write whole sectors at a sector-aligned offset straight to the card,
+	 * bypassing the FatFs sector cache. Only valid within a region reserved
+	 * by preallocate(). Does not move the file pointer.
+	 */
+	Result<Size> write_sectors(const Offset offset, const void* const data, const Size bytes_to_write);
+
+	/* Discard everything after the current file pointer. */
+	Optional<Error> truncate();
+
 	// TODO: Return Result<>.
 	Optional<Error> sync();
 
@@ -347,6 +375,8 @@ private:
 	FIL f { };
 
 	Optional<Error> open_fatfs(const std::filesystem::path& filename, BYTE mode);
+	bool is_block_aligned(const void* const data, const Size bytes);
+	Result<Size> read_unaligned(void* const data, const Size bytes_to_read);
 };
 
 #endif/*__FILE_H__*/
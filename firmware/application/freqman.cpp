@@ -35,94 +35,378 @@ std::vector<std::string> get_freqman_files() {
 	return file_list;
 };
 
-bool load_freqman_file(std::string& file_stem, freqman_db &db) {
+namespace {
+
+/* FREQMAN/<stem>.FMB is an FMBHeader followed by, per entry, frequency_a and
+ * frequency_b (8 bytes each), the type, the description's length, the
+ * revisit interval (2 bytes) and the description, all in the M0's byte
+ * order. Recording the source's size and FAT time stamp tells when the
+ * .TXT was edited since.
+ */
+constexpr uint32_t fmb_magic = 0x32424d46;	// "FMB2"
+
+struct FMBHeader {
+	uint32_t magic;
+	uint32_t source_size;
+	uint16_t source_date;
+	uint16_t source_time;
+	uint32_t count;
+};
+
+constexpr size_t fmb_record_fixed_length = 8 + 8 + 1 + 1 + 2;
+constexpr size_t fmb_record_length_max = fmb_record_fixed_length + FREQMAN_DESC_MAX_LEN;
+
+/* Multiples of the sector size at sector aligned offsets, so FatFs reads
+ * straight into the buffer instead of through its sector window.
+ */
+constexpr size_t read_buffer_size = 1024;
+constexpr size_t write_buffer_size = 512;
+
+std::filesystem::path freqman_path(const std::string& file_stem, const std::string& extension) {
+	return "FREQMAN/" + file_stem + extension;
+}
+
+bool header_matches(const FMBHeader& a, const FMBHeader& b) {
+	return (a.magic == b.magic) && (a.source_size == b.source_size)
+		&& (a.source_date == b.source_date) && (a.source_time == b.source_time);
+}
+
+rf::Frequency parse_frequency(const char* p, const char* const end) {
+	rf::Frequency value = 0;
+	for(; (p < end) && (*p >= '0') && (*p <= '9'); p++) {
+		value = (value * 10) + (*p - '0');
+	}
+	return value;
+}
+
+/* One line, without its line ending: comma separated f=, a=, b=, d= and
+ * p= fields. Lines without a frequency aren't entries.
+ */
+bool parse_line(const char* p, const char* const end, freqman_entry& entry) {
+	bool has_frequency = false;
+	entry = { 0, 0, "-", SINGLE };
+
+	while( p < end ) {
+		const char* const field_end = std::find(p, end, ',');
+		if( ((field_end - p) >= 2) && (p[1] == '=') ) {
+			const char* const value = p + 2;
+			switch(p[0]) {
+			case 'f':
+				entry.frequency_a = parse_frequency(value, field_end);
+				entry.type = SINGLE;
+				has_frequency = true;
+				break;
+
+			case 'a':
+				entry.frequency_a = parse_frequency(value, field_end);
+				entry.type = RANGE;
+				has_frequency = true;
+				break;
+
+			case 'b':
+				entry.frequency_b = parse_frequency(value, field_end);
+				break;
+
+			case 'd':
+				entry.description.assign(value, std::min(static_cast<size_t>(field_end - value), static_cast<size_t>(FREQMAN_DESC_MAX_LEN)));
+				break;
+
+			case 'p':
+				entry.revisit_ms = std::min(parse_frequency(value, field_end), static_cast<rf::Frequency>(UINT16_MAX));
+				break;
+
+			default:
+				break;
+			}
+		}
+		p = (field_end < end) ? (field_end + 1) : end;
+	}
+
+	return has_frequency;
+}
+
+class FMBWriter {
+public:
+	FMBWriter(
+		const std::filesystem::path& path,
+		const FMBHeader& header
+	) : path_ { path },
+		header_ { header }
+	{
+		ok = !file->create(path_).is_valid();
+		if( ok ) {
+			// Invalid until finish() writes the real header.
+			FMBHeader placeholder = header_;
+			placeholder.magic = 0;
+			ok = !file->write(&placeholder, sizeof(placeholder)).is_error();
+		}
+	}
+
+	FMBWriter(const FMBWriter&) = delete;
+	FMBWriter& operator=(const FMBWriter&) = delete;
+
+	void add(const freqman_entry& entry) {
+		if( !ok ) {
+			return;
+		}
+		if( (write_buffer_size - used) < fmb_record_length_max ) {
+			flush();
+		}
+
+		const int64_t frequency_a = entry.frequency_a;
+		const int64_t frequency_b = entry.frequency_b;
+		const size_t description_length = std::min(entry.description.size(), static_cast<size_t>(FREQMAN_DESC_MAX_LEN));
+		auto p = &buffer[used];
+		memcpy(&p[0], &frequency_a, 8);
+		memcpy(&p[8], &frequency_b, 8);
+		p[16] = entry.type;
+		p[17] = description_length;
+		memcpy(&p[18], &entry.revisit_ms, 2);
+		memcpy(&p[fmb_record_fixed_length], entry.description.data(), description_length);
+		used += fmb_record_fixed_length + description_length;
+		header_.count++;
+	}
+
+	void finish() {
+		flush();
+		ok = ok && !file->seek(0).is_error() && !file->write(&header_, sizeof(header_)).is_error();
+		file.reset();
+		if( !ok ) {
+			delete_file(path_);
+		}
+	}
+
+private:
+	std::unique_ptr<File> file { std::make_unique<File>() };
+	const std::filesystem::path path_;
+	FMBHeader header_;
+	std::unique_ptr<uint8_t[]> buffer { std::make_unique<uint8_t[]>(write_buffer_size) };
+	size_t used { 0 };
+	bool ok { false };
+
+	void flush() {
+		ok = ok && !file->write(buffer.get(), used).is_error();
+		used = 0;
+	}
+};
+
+/* Returns false if there's no up to date cache. */
+bool read_cache(
+	const std::filesystem::path& path,
+	const FMBHeader& expected,
+	uint8_t* const buffer,
+	const std::function<bool(const freqman_entry&)>& on_entry
+) {
+	File file;
+	if( file.open(path).is_valid() ) {
+		return false;
+	}
+
+	auto read_size = file.read(buffer, read_buffer_size);
+	if( read_size.is_error() || (read_size.value() < sizeof(FMBHeader)) ) {
+		return false;
+	}
+
+	FMBHeader header;
+	memcpy(&header, buffer, sizeof(header));
+	if( !header_matches(header, expected) ) {
+		return false;
+	}
+
+	size_t used = read_size.value();
+	size_t position = sizeof(header);
+	freqman_entry entry { };
+	for(uint32_t n=0; n<header.count; n++) {
+		if( (used - position) < fmb_record_length_max ) {
+			// Keep the partial record, top up the buffer behind it.
+			memmove(buffer, &buffer[position], used - position);
+			used -= position;
+			position = 0;
+			read_size = file.read(&buffer[used], read_buffer_size - used);
+			if( read_size.is_error() ) {
+				break;
+			}
+			used += read_size.value();
+		}
+
+		const auto p = &buffer[position];
+		if( ((used - position) < fmb_record_fixed_length)
+		 || ((used - position) < (fmb_record_fixed_length + p[17])) ) {
+			break;
+		}
+
+		int64_t frequency_a;
+		int64_t frequency_b;
+		memcpy(&frequency_a, &p[0], 8);
+		memcpy(&frequency_b, &p[8], 8);
+		entry.frequency_a = frequency_a;
+		entry.frequency_b = frequency_b;
+		entry.type = static_cast<freqman_entry_type>(p[16]);
+		memcpy(&entry.revisit_ms, &p[18], 2);
+		entry.description.assign(reinterpret_cast<const char*>(&p[fmb_record_fixed_length]), p[17]);
+		position += fmb_record_fixed_length + p[17];
+
+		if( !on_entry(entry) ) {
+			break;
+		}
+	}
+
+	return true;
+}
+
+} /* namespace */
+
+bool for_each_freqman_entry(const std::string& file_stem, const std::function<bool(const freqman_entry&)>& on_entry) {
+	const auto text_path = freqman_path(file_stem, ".TXT");
+	const auto cache_path = freqman_path(file_stem, ".FMB");
+
 	File freqman_file;
-	size_t length, n = 0, file_position = 0;
-	char * pos;
-	char * line_start;
-	char * line_end;
-	std::string description;
-	rf::Frequency frequency_a, frequency_b;
-	char file_data[257];
-	freqman_entry_type type;
-	
-	db.clear();
-	
-	auto result = freqman_file.open("FREQMAN/" + file_stem + ".TXT");
-	if (result.is_valid())
+	if( freqman_file.open(text_path).is_valid() ) {
 		return false;
-	
-	while (1) {
-		// Read a 256 bytes block from file
-		freqman_file.seek(file_position);
-		
-		memset(file_data, 0, 257);
-		auto read_size = freqman_file.read(file_data, 256);
-		if (read_size.is_error())
-			return false;	// Read error
-		
-		file_position += 256;
-		
-		// Reset line_start to beginning of buffer
-		line_start = file_data;
-		
-		if (!strstr(file_data, "f=") && !strstr(file_data, "a="))
+	}
+
+	const auto timestamp = file_created_date(text_path);
+	const FMBHeader expected {
+		fmb_magic,
+		static_cast<uint32_t>(freqman_file.size()),
+		timestamp.FAT_date, timestamp.FAT_time,
+		0
+	};
+
+	auto buffer = std::make_unique<uint8_t[]>(read_buffer_size);
+	if( read_cache(cache_path, expected, buffer.get(), on_entry) ) {
+		return true;
+	}
+
+	// Parse the whole file even if on_entry is done early, to complete the cache.
+	FMBWriter cache { cache_path, expected };
+	bool wanted = true;
+	std::array<char, FREQMAN_LINE_MAX_LEN> line;
+	size_t line_length = 0;
+	freqman_entry entry { };
+
+	const auto end_line = [&]() {
+		if( line_length && (line[line_length - 1] == '\r') ) {
+			line_length--;
+		}
+		if( parse_line(line.data(), line.data() + line_length, entry) ) {
+			cache.add(entry);
+			wanted = wanted && on_entry(entry);
+		}
+		line_length = 0;
+	};
+
+	while( true ) {
+		const auto read_size = freqman_file.read(buffer.get(), read_buffer_size);
+		if( read_size.is_error() ) {
+			return false;
+		}
+		if( read_size.value() == 0 ) {
 			break;
-		
-		// Look for complete lines in buffer
-		while ((line_end = strstr(line_start, "\x0A"))) {
-			// Read frequency
-			pos = strstr(line_start, "f=");
-			frequency_b = 0;
-			type = SINGLE;
-			if (pos) {
-				pos += 2;
-				frequency_a = strtoll(pos, nullptr, 10);
-			} else {
-				// ...or range
-				pos = strstr(line_start, "a=");
-				if (pos) {
-					pos += 2;
-					frequency_a = strtoll(pos, nullptr, 10);
-					type = RANGE;
-					pos = strstr(line_start, "b=");
-					if (pos) {
-						pos += 2;
-						frequency_b = strtoll(pos, nullptr, 10);
-					} else
-						frequency_b = 0;
-				} else
-					frequency_a = 0;
+		}
+
+		const auto data = reinterpret_cast<const char*>(buffer.get());
+		for(size_t i=0; i<read_size.value(); i++) {
+			const char c = data[i];
+			if( c == '\n' ) {
+				end_line();
+			} else if( line_length < line.size() ) {
+				// Overlong lines are cut short.
+				line[line_length++] = c;
 			}
-			
-			// Read description until , or LF
-			pos = strstr(line_start, "d=");
-			if (pos) {
-				pos += 2;
-				length = std::min(strcspn(pos, ",\x0A"), (size_t)FREQMAN_DESC_MAX_LEN);
-				description = string(pos, length);
-			} else
-				description = "-";
-			
-			db.push_back({ frequency_a, frequency_b, description, type });
-			n++;
-			
-			if (n >= FREQMAN_MAX_PER_FILE) return true;
-			
-			line_start = line_end + 1;
-			if (line_start - file_data >= 256) break;
 		}
-		
-		if (read_size.value() != 256)
-			break;	// End of file
-		
-		// Restart at beginning of last incomplete line
-		file_position -= (file_data + 256 - line_start);
 	}
-	
+	end_line();
+
+	cache.finish();
+	return true;
+}
+
+void freqman_db::clear() {
+	frequencies_a.clear();
+	frequencies_b.clear();
+	types.clear();
+	revisits.clear();
+	offsets.clear();
+	pool.clear();
+}
+
+bool freqman_db::pool_append(const std::string& description, uint16_t& offset) {
+	const size_t length = std::min(description.size(), static_cast<size_t>(FREQMAN_DESC_MAX_LEN));
+	if( (pool.size() + length + 1) > pool_size_max ) {
+		return false;
+	}
+
+	offset = pool.size();
+	pool.insert(pool.end(), description.begin(), description.begin() + length);
+	pool.push_back(0);
+	return true;
+}
+
+void freqman_db::pool_remove(const uint16_t start) {
+	const auto length = strlen(&pool[start]) + 1;
+	pool.erase(pool.begin() + start, pool.begin() + start + length);
+	for(auto& offset : offsets) {
+		if( offset > start ) {
+			offset -= length;
+		}
+	}
+}
+
+bool freqman_db::push_back(const freqman_entry& entry) {
+	uint16_t offset;
+	if( !pool_append(entry.description, offset) ) {
+		return false;
+	}
+
+	frequencies_a.push_back(entry.frequency_a);
+	frequencies_b.push_back(entry.frequency_b);
+	types.push_back(entry.type);
+	revisits.push_back(entry.revisit_ms);
+	offsets.push_back(offset);
 	return true;
 }
 
+bool freqman_db::set_description(const size_t index, const std::string& description) {
+	const auto previous = offsets[index];
+	uint16_t offset;
+	if( !pool_append(description, offset) ) {
+		return false;
+	}
+
+	// Point at the new copy, then close the old one's gap.
+	offsets[index] = offset;
+	pool_remove(previous);
+	return true;
+}
+
+void freqman_db::set_frequency_a(const size_t index, const rf::Frequency frequency) {
+	frequencies_a[index] = frequency;
+}
+
+void freqman_db::erase(const size_t index) {
+	pool_remove(offsets[index]);
+	frequencies_a.erase(frequencies_a.begin() + index);
+	frequencies_b.erase(frequencies_b.begin() + index);
+	types.erase(types.begin() + index);
+	revisits.erase(revisits.begin() + index);
+	offsets.erase(offsets.begin() + index);
+}
+
+void freqman_db::truncate(const size_t count) {
+	while( size() > count ) {
+		erase(size() - 1);
+	}
+}
+
+bool load_freqman_file(std::string& file_stem, freqman_db &db) {
+	db.clear();
+	
+	return for_each_freqman_entry(file_stem, [&db](const freqman_entry& entry) {
+		return db.push_back(entry) && (db.size() < FREQMAN_MAX_PER_FILE);
+	});
+}
+
 bool save_freqman_file(std::string& file_stem, freqman_db &db) {
 	File freqman_file;
 	std::string item_string;
@@ -132,11 +416,9 @@ bool save_freqman_file(std::string& file_stem, freqman_db &db) {
 		return false;
 	
 	for (size_t n = 0; n < db.size(); n++) {
-		auto& entry = db[n];
-
-		frequency_a = entry.frequency_a;
+		frequency_a = db.frequency_a(n);
 		
-		if (entry.type == SINGLE) {
+		if (db.type(n) == SINGLE) {
 			// Single
 			
 			// TODO: Make to_string_dec_uint be able to return uint64_t's
@@ -145,14 +427,17 @@ bool save_freqman_file(std::string& file_stem, freqman_db &db) {
 			
 		} else {
 			// Range
-			frequency_b = entry.frequency_b;
+			frequency_b = db.frequency_b(n);
 			
 			item_string = "a=" + to_string_dec_uint(frequency_a / 1000) + to_string_dec_uint(frequency_a % 1000UL, 3, '0');
 			item_string += ",b=" + to_string_dec_uint(frequency_b / 1000) + to_string_dec_uint(frequency_b % 1000UL, 3, '0');
 		}
 		
-		if (entry.description.size())
-			item_string += ",d=" + entry.description;
+		if (db.description(n)[0])
+			item_string += std::string(",d=") + db.description(n);
+
+		if (db.revisit_ms(n))
+			item_string += ",p=" + to_string_dec_uint(db.revisit_ms(n));
 		
 		freqman_file.write_line(item_string);
 	}
@@ -161,6 +446,9 @@ bool save_freqman_file(std::string& file_stem, freqman_db &db) {
 }
 
 bool create_freqman_file(std::string& file_stem, File& freqman_file) {
+	// The cache is out of date as soon as the file is rewritten.
+	delete_file(freqman_path(file_stem, ".FMB"));
+	
 	auto result = freqman_file.create("FREQMAN/" + file_stem + ".TXT");
 	if (result.is_valid())
 		return false;
@@ -168,13 +456,13 @@ bool create_freqman_file(std::string& file_stem, File& freqman_file) {
 	return true;
 }
 
-std::string freqman_item_string(freqman_entry &entry, size_t max_length) {
+std::string freqman_item_string(const freqman_db& db, const size_t index, const size_t max_length) {
 	std::string item_string;
 
-	if (entry.type == SINGLE) {
-		item_string = to_string_short_freq(entry.frequency_a) + "M: " + entry.description;
+	if (db.type(index) == SINGLE) {
+		item_string = to_string_short_freq(db.frequency_a(index)) + "M: " + db.description(index);
 	} else {
-		item_string = "Range: " + entry.description;
+		item_string = std::string("Range: ") + db.description(index);
 	}
 	
 	if (item_string.size() > max_length)
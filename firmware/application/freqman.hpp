@@ -22,6 +22,7 @@
 
 #include <cstring>
 #include <string>
+#include <functional>
 #include "file.hpp"
 #include "ui_receiver.hpp"
 #include "string_format.hpp"
@@ -30,6 +31,7 @@
 #define __FREQMAN_H__
 
 #define FREQMAN_DESC_MAX_LEN 30
+#define FREQMAN_LINE_MAX_LEN 128
 #define FREQMAN_MAX_PER_FILE 99
 #define FREQMAN_MAX_PER_FILE_STR "99"
 
@@ -53,14 +55,61 @@ struct freqman_entry {
 	rf::Frequency frequency_b { 0 };
 	std::string description { };
 	freqman_entry_type type { };
+	// p=, ms: the scanner's promised longest gap between visits, 0 for none.
+	uint16_t revisit_ms { 0 };
 };
 
-using freqman_db = std::vector<freqman_entry>;
+/* Entries stored as a structure of arrays, with the descriptions NUL
+ * terminated in one pool and found by 16-bit offsets: 19 bytes per entry
+ * plus the description, and no allocation of its own. Reading it back
+ * through the accessors doesn't allocate either.
+ */
+class freqman_db {
+public:
+	size_t size() const { return types.size(); }
+	bool empty() const { return types.empty(); }
+	void clear();
+
+	rf::Frequency frequency_a(const size_t index) const { return frequencies_a[index]; }
+	rf::Frequency frequency_b(const size_t index) const { return frequencies_b[index]; }
+	freqman_entry_type type(const size_t index) const { return static_cast<freqman_entry_type>(types[index]); }
+	const char* description(const size_t index) const { return &pool[offsets[index]]; }
+	uint16_t revisit_ms(const size_t index) const { return revisits[index]; }
+
+	/* Both return false, changing nothing, once the pool is full. */
+	bool push_back(const freqman_entry& entry);
+	bool set_description(const size_t index, const std::string& description);
+
+	void set_frequency_a(const size_t index, const rf::Frequency frequency);
+	void erase(const size_t index);
+	void truncate(const size_t count);
+
+private:
+	static constexpr size_t pool_size_max = 65536;
+
+	std::vector<rf::Frequency> frequencies_a { };
+	std::vector<rf::Frequency> frequencies_b { };
+	std::vector<uint8_t> types { };
+	std::vector<uint16_t> revisits { };
+	std::vector<uint16_t> offsets { };
+	std::vector<char> pool { };
+
+	bool pool_append(const std::string& description, uint16_t& offset);
+	void pool_remove(const uint16_t start);
+};
 
 std::vector<std::string> get_freqman_files();
+
+/* Calls on_entry for every entry of FREQMAN/<file_stem>.TXT, in order, until
+ * it returns false. Reads the compiled FREQMAN/<file_stem>.FMB beside it when
+ * that is up to date, otherwise parses the text in one pass and rebuilds it.
+ * Unlike load_freqman_file(), there's no limit on the number of entries.
+ */
+bool for_each_freqman_entry(const std::string& file_stem, const std::function<bool(const freqman_entry&)>& on_entry);
+
 bool load_freqman_file(std::string& file_stem, freqman_db& db);
 bool save_freqman_file(std::string& file_stem, freqman_db& db);
 bool create_freqman_file(std::string& file_stem, File& freqman_file);
-std::string freqman_item_string(freqman_entry &item, size_t max_length);
+std::string freqman_item_string(const freqman_db& db, const size_t index, const size_t max_length);
 
 #endif/*__FREQMAN_H__*/
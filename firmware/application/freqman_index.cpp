@@ -0,0 +1,610 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "freqman_index.hpp"
+
+#include "ch.h"
+
+#include <cstring>
+#include <algorithm>
+#include <array>
+
+namespace {
+
+/* FREQMAN/INDEX.FMI is an FMIHeader, an FMIFile per list (the size and
+ * FAT time stamp its entries were read at), count FMIEntry sorted by
+ * frequency_a, count signatures (uint64_t) in the same order, then the
+ * descriptions, NUL terminated, that FMIEntry::description points into.
+ */
+constexpr uint32_t fmi_magic = 0x31494d46;	// "FMI1"
+
+struct FMIHeader {
+	uint32_t magic;
+	uint32_t files;
+	uint32_t count;
+	uint32_t pool_size;
+};
+
+struct FMIFile {
+	char stem[32];
+	uint32_t source_size;
+	uint16_t source_date;
+	uint16_t source_time;
+};
+
+struct FMIEntry {
+	int64_t frequency_a;
+	int64_t frequency_b;
+	uint32_t description;
+	uint16_t index;
+	uint8_t file;
+	uint8_t type;
+};
+
+static_assert(sizeof(FMIHeader) == 16, "FMIHeader size");
+static_assert(sizeof(FMIFile) == 40, "FMIFile size");
+static_assert(sizeof(FMIEntry) == 24, "FMIEntry size");
+
+// Sorted in runs of run_records_max, then merged a pair of runs at a time.
+struct BuildRecord {
+	FMIEntry entry;
+	uint64_t signature;
+};
+
+constexpr size_t files_max = 255;
+constexpr uint32_t entries_max = 65535;
+constexpr size_t run_records_max = 256;
+constexpr size_t candidates_max = 64;
+constexpr size_t trigrams_max = FREQMAN_DESC_MAX_LEN;
+constexpr size_t io_buffer_size = 512;
+
+std::filesystem::path freqman_path(const char* const name) {
+	return std::string("FREQMAN/") + name;
+}
+
+/* a-z (either case) and 0-9; everything else is a space. */
+uint8_t trigram_code(const char c) {
+	if( (c >= 'a') && (c <= 'z') ) {
+		return c - 'a' + 1;
+	}
+	if( (c >= 'A') && (c <= 'Z') ) {
+		return c - 'A' + 1;
+	}
+	if( (c >= '0') && (c <= '9') ) {
+		return c - '0' + 27;
+	}
+	return 0;
+}
+
+/* The text's distinct trigrams, spaces collapsed and one at either end,
+ * as base 37 numbers. Only the first trigrams_max characters count.
+ */
+size_t trigrams(const char* const text, const size_t length, uint16_t* const dst) {
+	std::array<uint8_t, trigrams_max + 2> codes;
+	size_t n = 0;
+	codes[n++] = 0;
+	for(size_t i=0; (i<length) && (n < codes.size() - 1); i++) {
+		const auto code = trigram_code(text[i]);
+		if( code || codes[n - 1] ) {
+			codes[n++] = code;
+		}
+	}
+	if( codes[n - 1] ) {
+		codes[n++] = 0;
+	}
+
+	size_t count = 0;
+	for(size_t i=0; (i + 2) < n; i++) {
+		const uint16_t trigram = (codes[i] * 37 + codes[i + 1]) * 37 + codes[i + 2];
+		if( std::find(dst, dst + count, trigram) == (dst + count) ) {
+			dst[count++] = trigram;
+		}
+	}
+	return count;
+}
+
+/* Two bits per trigram. */
+uint64_t signature_bits(const uint16_t trigram) {
+	const uint32_t h = trigram * 2654435761U;
+	return (1ULL << (h >> 26)) | (1ULL << ((h >> 20) & 63));
+}
+
+uint64_t signature(const uint16_t* const trigrams, const size_t count) {
+	uint64_t result = 0;
+	for(size_t i=0; i<count; i++) {
+		result |= signature_bits(trigrams[i]);
+	}
+	return result;
+}
+
+bool read_exact(File& file, void* const data, const size_t size) {
+	const auto result = file.read(data, size);
+	return result.is_ok() && (result.value() == size);
+}
+
+class RecordWriter {
+public:
+	bool create(const std::filesystem::path& path) {
+		return !file->create(path).is_valid();
+	}
+
+	bool write(const void* const data, const size_t size) {
+		auto p = static_cast<const uint8_t*>(data);
+		for(size_t remaining = size; remaining; ) {
+			const size_t n = std::min(remaining, io_buffer_size - used);
+			memcpy(&buffer[used], p, n);
+			used += n;
+			p += n;
+			remaining -= n;
+			if( (used == io_buffer_size) && !flush() ) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/* Writes start over the file's first bytes, once the rest is out. */
+	bool finish(const void* const start = nullptr, const size_t start_size = 0) {
+		bool ok = flush();
+		if( ok && start ) {
+			ok = !file->seek(0).is_error() && !file->write(start, start_size).is_error();
+		}
+		file.reset();
+		return ok;
+	}
+
+private:
+	std::unique_ptr<File> file { std::make_unique<File>() };
+	std::unique_ptr<uint8_t[]> buffer { std::make_unique<uint8_t[]>(io_buffer_size) };
+	size_t used { 0 };
+
+	bool flush() {
+		const bool ok = !used || !file->write(buffer.get(), used).is_error();
+		used = 0;
+		return ok;
+	}
+};
+
+class RecordReader {
+public:
+	bool open(const std::filesystem::path& path, const uint32_t offset) {
+		return !file->open(path).is_valid() && !file->seek(offset).is_error();
+	}
+
+	bool read(void* const data, const size_t size) {
+		auto p = static_cast<uint8_t*>(data);
+		for(size_t remaining = size; remaining; ) {
+			if( position == used ) {
+				const auto result = file->read(buffer.get(), io_buffer_size);
+				if( result.is_error() || (result.value() == 0) ) {
+					return false;
+				}
+				used = result.value();
+				position = 0;
+			}
+			const size_t n = std::min(remaining, used - position);
+			memcpy(p, &buffer[position], n);
+			position += n;
+			p += n;
+			remaining -= n;
+		}
+		return true;
+	}
+
+private:
+	std::unique_ptr<File> file { std::make_unique<File>() };
+	std::unique_ptr<uint8_t[]> buffer { std::make_unique<uint8_t[]>(io_buffer_size) };
+	size_t used { 0 };
+	size_t position { 0 };
+};
+
+std::vector<std::string> index_files() {
+	auto files = get_freqman_files();
+	std::sort(files.begin(), files.end());
+	if( files.size() > files_max ) {
+		files.resize(files_max);
+	}
+	return files;
+}
+
+FMIFile file_record(const std::string& stem) {
+	FMIFile record { };
+	strncpy(record.stem, stem.c_str(), sizeof(record.stem) - 1);
+
+	const auto text_path = std::string("FREQMAN/") + stem + ".TXT";
+	File text;
+	if( !text.open(text_path).is_valid() ) {
+		record.source_size = text.size();
+	}
+	const auto timestamp = file_created_date(text_path);
+	record.source_date = timestamp.FAT_date;
+	record.source_time = timestamp.FAT_time;
+	return record;
+}
+
+/* Merges neighbouring pairs of runs from one file into the other. */
+bool merge_pass(const std::filesystem::path& in, const std::filesystem::path& out, std::vector<uint32_t>& runs) {
+	RecordWriter writer;
+	if( !writer.create(out) ) {
+		return false;
+	}
+
+	std::vector<uint32_t> merged;
+	uint32_t start = 0;
+	bool ok = true;
+	for(size_t r=0; ok && (r<runs.size()); r+=2) {
+		uint32_t a_left = runs[r];
+		uint32_t b_left = ((r + 1) < runs.size()) ? runs[r + 1] : 0;
+		merged.push_back(a_left + b_left);
+
+		RecordReader a;
+		RecordReader b;
+		ok = a.open(in, start * sizeof(BuildRecord)) && b.open(in, (start + a_left) * sizeof(BuildRecord));
+		start += a_left + b_left;
+
+		BuildRecord record_a;
+		BuildRecord record_b;
+		bool have_a = ok && a_left && a.read(&record_a, sizeof(record_a));
+		bool have_b = ok && b_left && b.read(&record_b, sizeof(record_b));
+		while( ok && (have_a || have_b) ) {
+			if( have_a && (!have_b || (record_a.entry.frequency_a <= record_b.entry.frequency_a)) ) {
+				ok = writer.write(&record_a, sizeof(record_a));
+				have_a = --a_left && a.read(&record_a, sizeof(record_a));
+			} else {
+				ok = writer.write(&record_b, sizeof(record_b));
+				have_b = --b_left && b.read(&record_b, sizeof(record_b));
+			}
+		}
+	}
+
+	runs = merged;
+	return writer.finish() && ok;
+}
+
+bool build_index() {
+	const auto files = index_files();
+	std::vector<FMIFile> table;
+	std::vector<uint32_t> runs;
+	std::vector<BuildRecord> run;
+	uint32_t count = 0;
+	uint32_t pool_size = 0;
+
+	RecordWriter run_writer;
+	RecordWriter pool_writer;
+	bool ok = run_writer.create(freqman_path("INDEX.T0")) && pool_writer.create(freqman_path("INDEX.TP"));
+
+	const auto end_run = [&]() {
+		std::sort(run.begin(), run.end(), [](const BuildRecord& a, const BuildRecord& b) {
+			return a.entry.frequency_a < b.entry.frequency_a;
+		});
+		if( !run.empty() ) {
+			ok = ok && run_writer.write(run.data(), run.size() * sizeof(BuildRecord));
+			runs.push_back(run.size());
+		}
+		run.clear();
+	};
+
+	run.reserve(run_records_max);
+	for(size_t f=0; ok && (f<files.size()); f++) {
+		table.push_back(file_record(files[f]));
+
+		uint16_t index = 0;
+		for_each_freqman_entry(files[f], [&](const freqman_entry& entry) {
+			if( count >= entries_max ) {
+				return false;
+			}
+
+			std::array<uint16_t, trigrams_max> description_trigrams;
+			const auto length = std::min(entry.description.size(), static_cast<size_t>(FREQMAN_DESC_MAX_LEN));
+			const auto n = trigrams(entry.description.data(), length, description_trigrams.data());
+			run.push_back({
+				{
+					entry.frequency_a, entry.frequency_b,
+					pool_size, index++,
+					static_cast<uint8_t>(f), static_cast<uint8_t>(entry.type)
+				},
+				signature(description_trigrams.data(), n)
+			});
+			ok = ok && pool_writer.write(entry.description.data(), length);
+			ok = ok && pool_writer.write("", 1);
+			pool_size += length + 1;
+			count++;
+
+			if( run.size() == run_records_max ) {
+				end_run();
+			}
+			return ok;
+		});
+	}
+	end_run();
+	ok = run_writer.finish() && ok;
+	ok = pool_writer.finish() && ok;
+
+	const char* sorted = "INDEX.T0";
+	const char* spare = "INDEX.T1";
+	while( ok && (runs.size() > 1) ) {
+		ok = merge_pass(freqman_path(sorted), freqman_path(spare), runs);
+		std::swap(sorted, spare);
+	}
+	if( !ok ) {
+		return false;
+	}
+
+	// Invalid until finish() writes the real header.
+	FMIHeader header { 0, static_cast<uint32_t>(table.size()), count, pool_size };
+	RecordWriter index;
+	ok = index.create(freqman_path("INDEX.TMN"))
+		&& index.write(&header, sizeof(header))
+		&& index.write(table.data(), table.size() * sizeof(FMIFile));
+
+	// Entries, then a second pass for their signatures.
+	for(size_t pass=0; ok && (pass<2); pass++) {
+		RecordReader reader;
+		ok = reader.open(freqman_path(sorted), 0);
+		for(uint32_t n=0; ok && (n<count); n++) {
+			BuildRecord record;
+			ok = reader.read(&record, sizeof(record));
+			ok = ok && ((pass == 0)
+				? index.write(&record.entry, sizeof(record.entry))
+				: index.write(&record.signature, sizeof(record.signature)));
+		}
+	}
+
+	RecordReader pool;
+	ok = ok && pool.open(freqman_path("INDEX.TP"), 0);
+	std::array<uint8_t, 64> chunk;
+	for(uint32_t left=pool_size; ok && left; ) {
+		const size_t n = std::min(static_cast<size_t>(left), chunk.size());
+		ok = pool.read(chunk.data(), n) && index.write(chunk.data(), n);
+		left -= n;
+	}
+
+	header.magic = fmi_magic;
+	ok = index.finish(&header, sizeof(header)) && ok;
+	if( ok ) {
+		delete_file(freqman_path("INDEX.FMI"));
+		rename_file(freqman_path("INDEX.TMN"), freqman_path("INDEX.FMI"));
+	}
+	return ok;
+}
+
+class IndexBuilder {
+public:
+	IndexBuilder() {
+		// FatFs, the .FMB reader and a run being sorted; the run itself is on the heap.
+		thread = chThdCreateFromHeap(NULL, 3072, LOWPRIO, IndexBuilder::static_fn, this);
+	}
+
+	~IndexBuilder() {
+		if( thread ) {
+			chThdWait(thread);
+			thread = nullptr;
+		}
+	}
+
+	IndexBuilder(const IndexBuilder&) = delete;
+	IndexBuilder& operator=(const IndexBuilder&) = delete;
+
+	bool is_done() const {
+		return done || !thread;
+	}
+
+private:
+	Thread* thread { nullptr };
+	volatile bool done { false };
+
+	static msg_t static_fn(void* arg) {
+		chRegSetThreadName("freqidx");
+		auto obj = static_cast<IndexBuilder*>(arg);
+		if( !build_index() ) {
+			delete_file(freqman_path("INDEX.TMN"));
+		}
+		delete_file(freqman_path("INDEX.T0"));
+		delete_file(freqman_path("INDEX.T1"));
+		delete_file(freqman_path("INDEX.TP"));
+		obj->done = true;
+		return 0;
+	}
+};
+
+std::unique_ptr<IndexBuilder> builder { };
+
+} /* namespace */
+
+bool FreqmanIndex::open() {
+	count = 0;
+	stems.clear();
+	file = std::make_unique<File>();
+
+	FMIHeader header;
+	const auto files = index_files();
+	bool ok = !file->open(freqman_path("INDEX.FMI")).is_valid()
+		&& read_exact(*file, &header, sizeof(header))
+		&& (header.magic == fmi_magic)
+		&& (header.files == files.size());
+
+	for(size_t f=0; ok && (f<files.size()); f++) {
+		FMIFile record;
+		const auto current = file_record(files[f]);
+		ok = read_exact(*file, &record, sizeof(record))
+			&& (strncmp(record.stem, current.stem, sizeof(record.stem)) == 0)
+			&& (record.source_size == current.source_size)
+			&& (record.source_date == current.source_date)
+			&& (record.source_time == current.source_time);
+		stems.emplace_back(record.stem);
+	}
+
+	if( !ok ) {
+		file.reset();
+		stems.clear();
+		return false;
+	}
+
+	count = header.count;
+	entries_offset = sizeof(FMIHeader) + header.files * sizeof(FMIFile);
+	signatures_offset = entries_offset + count * sizeof(FMIEntry);
+	pool_offset = signatures_offset + count * sizeof(uint64_t);
+	return true;
+}
+
+bool FreqmanIndex::read_result(const uint32_t position, Result& result) {
+	FMIEntry entry;
+	if( file->seek(entries_offset + position * sizeof(FMIEntry)).is_error()
+	 || !read_exact(*file, &entry, sizeof(entry))
+	 || file->seek(pool_offset + entry.description).is_error() ) {
+		return false;
+	}
+
+	std::array<char, FREQMAN_DESC_MAX_LEN + 1> description;
+	const auto read_size = file->read(description.data(), description.size());
+	if( read_size.is_error() ) {
+		return false;
+	}
+
+	result = {
+		entry.frequency_a,
+		entry.frequency_b,
+		static_cast<freqman_entry_type>(entry.type),
+		(entry.file < stems.size()) ? stems[entry.file] : std::string { },
+		std::string(description.data(), strnlen(description.data(), read_size.value()))
+	};
+	return true;
+}
+
+std::vector<FreqmanIndex::Result> FreqmanIndex::near_frequency(const rf::Frequency frequency, const size_t max) {
+	std::vector<Result> results;
+	if( !file || !count || !max ) {
+		return results;
+	}
+
+	// Lower bound, one entry read per step.
+	uint32_t low = 0;
+	uint32_t high = count;
+	while( low < high ) {
+		const uint32_t middle = low + (high - low) / 2;
+		int64_t middle_frequency;
+		if( file->seek(entries_offset + middle * sizeof(FMIEntry)).is_error()
+		 || !read_exact(*file, &middle_frequency, sizeof(middle_frequency)) ) {
+			return results;
+		}
+		if( middle_frequency < frequency ) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	const uint32_t last = std::min(count, low + static_cast<uint32_t>((max + 1) / 2));
+	const uint32_t first = (last > max) ? (last - max) : 0;
+	for(uint32_t position=first; position<last; position++) {
+		Result result;
+		if( !read_result(position, result) ) {
+			break;
+		}
+		results.push_back(std::move(result));
+	}
+	return results;
+}
+
+std::vector<FreqmanIndex::Result> FreqmanIndex::search(const std::string& text, const size_t max) {
+	std::vector<Result> results;
+	std::array<uint16_t, trigrams_max> query;
+	const auto query_count = trigrams(text.data(), text.size(), query.data());
+	if( !file || !count || !query_count ) {
+		return results;
+	}
+	const size_t needed = (query_count + 1) / 2;
+
+	// The signatures give candidates, best kept; their descriptions decide.
+	struct Candidate {
+		uint32_t position;
+		size_t hits;
+	};
+	std::vector<Candidate> candidates;
+	auto signatures = std::make_unique<uint64_t[]>(io_buffer_size / sizeof(uint64_t));
+	if( file->seek(signatures_offset).is_error() ) {
+		return results;
+	}
+	for(uint32_t position=0; position<count; ) {
+		const size_t n = std::min(static_cast<size_t>(count - position), io_buffer_size / sizeof(uint64_t));
+		if( !read_exact(*file, signatures.get(), n * sizeof(uint64_t)) ) {
+			break;
+		}
+		for(size_t i=0; i<n; i++, position++) {
+			size_t hits = 0;
+			for(size_t q=0; q<query_count; q++) {
+				const auto bits = signature_bits(query[q]);
+				hits += ((signatures[i] & bits) == bits) ? 1 : 0;
+			}
+			if( hits < needed ) {
+				continue;
+			}
+			if( candidates.size() < candidates_max ) {
+				candidates.push_back({ position, hits });
+			} else {
+				auto worst = std::min_element(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+					return a.hits < b.hits;
+				});
+				if( hits > worst->hits ) {
+					*worst = { position, hits };
+				}
+			}
+		}
+	}
+
+	std::vector<std::pair<size_t, Result>> matches;
+	for(const auto& candidate : candidates) {
+		Result result;
+		if( !read_result(candidate.position, result) ) {
+			continue;
+		}
+		std::array<uint16_t, trigrams_max> description_trigrams;
+		const auto n = trigrams(result.description.data(), result.description.size(), description_trigrams.data());
+		size_t score = 0;
+		for(size_t q=0; q<query_count; q++) {
+			score += (std::find(description_trigrams.begin(), description_trigrams.begin() + n, query[q]) != (description_trigrams.begin() + n)) ? 1 : 0;
+		}
+		if( score >= needed ) {
+			matches.emplace_back(score, std::move(result));
+		}
+	}
+
+	std::sort(matches.begin(), matches.end(), [](const std::pair<size_t, Result>& a, const std::pair<size_t, Result>& b) {
+		return (a.first != b.first) ? (a.first > b.first) : (a.second.frequency_a < b.second.frequency_a);
+	});
+	for(size_t i=0; (i<matches.size()) && (i<max); i++) {
+		results.push_back(std::move(matches[i].second));
+	}
+	return results;
+}
+
+void FreqmanIndex::build_in_background() {
+	if( !building() ) {
+		builder = std::make_unique<IndexBuilder>();
+	}
+}
+
+bool FreqmanIndex::building() {
+	if( builder && builder->is_done() ) {
+		builder.reset();
+	}
+	return builder != nullptr;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __FREQMAN_INDEX_H__
+#define __FREQMAN_INDEX_H__
+
+#include "freqman.hpp"
+#include "file.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+
+/* One index over every list in FREQMAN, in FREQMAN/INDEX.FMI: all entries
+ * sorted by frequency, a 64-bit trigram signature of each description, and
+ * the descriptions. Lookups read it in place, a binary search for a
+ * frequency and one pass over the signatures for a description, so the
+ * size of the lists costs SD card reads rather than RAM.
+ *
+ * Descriptions match fuzzily: lowercased, punctuation as spaces, a result
+ * shares at least half the query's trigrams, best first.
+ *
+ * build_in_background() makes it from the lists' .FMB caches on a low
+ * priority thread; open() refuses an index older than any list.
+ */
+class FreqmanIndex {
+public:
+	struct Result {
+		rf::Frequency frequency_a;
+		rf::Frequency frequency_b;
+		freqman_entry_type type;
+		std::string file_stem;
+		std::string description;
+	};
+
+	bool open();
+
+	size_t size() const {
+		return count;
+	}
+
+	/* Up to max entries around frequency, in frequency order. */
+	std::vector<Result> near_frequency(const rf::Frequency frequency, const size_t max);
+	std::vector<Result> search(const std::string& text, const size_t max);
+
+	static void build_in_background();
+	static bool building();
+
+private:
+	std::unique_ptr<File> file { };
+	std::vector<std::string> stems { };
+	uint32_t count { 0 };
+	uint32_t entries_offset { 0 };
+	uint32_t signatures_offset { 0 };
+	uint32_t pool_offset { 0 };
+
+	bool read_result(const uint32_t position, Result& result);
+};
+
+#endif/*__FREQMAN_INDEX_H__*/
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "geo_markers.hpp"
+
+size_t GeoMarkers::find(const Id id) const {
+	for(size_t i=0; i<count; i++) {
+		if( id_[i] == id ) {
+			return i;
+		}
+	}
+	return count;
+}
+
+void GeoMarkers::link(const size_t i) {
+	const auto c = row_of(lat_[i]) * cols + col_of(lon_[i]);
+	cell[i] = c;
+	next[i] = head[c];
+	head[c] = i;
+}
+
+void GeoMarkers::unlink(const size_t i) {
+	auto* p = &head[cell[i]];
+	while( *p != i ) {
+		p = &next[*p];
+	}
+	*p = next[i];
+}
+
+void GeoMarkers::move(const size_t from, const size_t to) {
+	unlink(from);
+	lat_[to] = lat_[from];
+	lon_[to] = lon_[from];
+	heading_[to] = heading_[from];
+	age_[to] = age_[from];
+	id_[to] = id_[from];
+	link(to);
+}
+
+void GeoMarkers::update(const Id id, const float lat, const float lon, const uint16_t heading) {
+	auto i = find(id);
+	if( i < count ) {
+		unlink(i);
+	} else if( count < capacity ) {
+		count++;
+	} else {
+		i = 0;
+		for(size_t j=1; j<count; j++) {
+			if( age_[j] > age_[i] ) {
+				i = j;
+			}
+		}
+		unlink(i);
+	}
+
+	lat_[i] = lat;
+	lon_[i] = lon;
+	heading_[i] = heading;
+	age_[i] = 0;
+	id_[i] = id;
+	link(i);
+	revision_++;
+}
+
+void GeoMarkers::reposition(const Id id, const float lat, const float lon) {
+	const auto i = find(id);
+	if( i < count ) {
+		unlink(i);
+		lat_[i] = lat;
+		lon_[i] = lon;
+		link(i);
+		revision_++;
+	}
+}
+
+void GeoMarkers::remove(const Id id) {
+	const auto i = find(id);
+	if( i < count ) {
+		unlink(i);
+		count--;
+		if( i != count ) {
+			// Keep the arrays dense, the last marker fills the hole.
+			move(count, i);
+		}
+		revision_++;
+	}
+}
+
+void GeoMarkers::clear() {
+	head = make_heads();
+	count = 0;
+	revision_++;
+}
+
+void GeoMarkers::tick() {
+	for(size_t i=0; i<count; i++) {
+		if( age_[i] < 0xffff ) {
+			age_[i]++;
+		}
+	}
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GEO_MARKERS_H__
+#define __GEO_MARKERS_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Positions of many targets at once, for GeoMap to draw over the map.
+ * Decoders update their targets in place, keyed by an ID of their choosing
+ * (an ICAO address, an MMSI...), and the map reads the same storage when it
+ * paints; nothing is copied per target.
+ *
+ * Stored as parallel arrays, densely packed, with each marker also chained
+ * into a coarse grid cell so the map only visits the cells it shows.
+ */
+
+class GeoMarkers {
+public:
+	using Id = uint32_t;
+
+	static constexpr size_t capacity = 128;
+	static constexpr uint16_t heading_unknown = 0xffff;
+
+	/* Adds the marker if new, resetting its age. When full, the oldest
+	 * marker makes room.
+	 */
+	void update(const Id id, const float lat, const float lon, const uint16_t heading = heading_unknown);
+	/* Moves a marker that's already there, keeping its age: for positions
+	 * predicted between reports.
+	 */
+	void reposition(const Id id, const float lat, const float lon);
+	void remove(const Id id);
+	void clear();
+
+	/* Ages every marker by one, saturating. Once a second, by convention. */
+	void tick();
+
+	size_t size() const { return count; }
+
+	/* Changes whenever a marker is added, moved or removed. */
+	uint32_t revision() const { return revision_; }
+
+	float lat(const size_t i) const { return lat_[i]; }
+	float lon(const size_t i) const { return lon_[i]; }
+	uint16_t heading(const size_t i) const { return heading_[i]; }
+	uint16_t age(const size_t i) const { return age_[i]; }
+	Id id(const size_t i) const { return id_[i]; }
+
+	/* Calls f(i) for the markers in the cells overlapping the area, which
+	 * may include some just outside it.
+	 */
+	template<typename F>
+	void for_each_in(const float lat_min, const float lat_max, const float lon_min, const float lon_max, F f) const {
+		const size_t col_min = col_of(lon_min);
+		const size_t col_max = col_of(lon_max);
+		const size_t row_min = row_of(lat_min);
+		const size_t row_max = row_of(lat_max);
+		for(size_t row=row_min; row<=row_max; row++) {
+			for(size_t col=col_min; col<=col_max; col++) {
+				for(auto i=head[row * cols + col]; i!=none; i=next[i]) {
+					f(i);
+				}
+			}
+		}
+	}
+
+private:
+	/* 22.5 degree cells. Zoomed in, the map spans one to four of them. */
+	static constexpr size_t cols = 16;
+	static constexpr size_t rows = 8;
+	static constexpr uint8_t none = 0xff;
+
+	static_assert(capacity < none, "GeoMarkers indices must fit in a cell chain");
+
+	std::array<float, capacity> lat_ { };
+	std::array<float, capacity> lon_ { };
+	std::array<uint16_t, capacity> heading_ { };
+	std::array<uint16_t, capacity> age_ { };
+	std::array<Id, capacity> id_ { };
+
+	std::array<uint8_t, capacity> cell { };
+	std::array<uint8_t, capacity> next { };
+	std::array<uint8_t, cols * rows> head { make_heads() };
+
+	size_t count { 0 };
+	uint32_t revision_ { 0 };
+
+	static constexpr std::array<uint8_t, cols * rows> make_heads() {
+		std::array<uint8_t, cols * rows> heads { };
+		for(auto& h : heads) {
+			h = none;
+		}
+		return heads;
+	}
+
+	static constexpr size_t col_of(const float lon) {
+		return (lon <= -180.0f) ? 0 : ((lon >= 180.0f) ? (cols - 1) : static_cast<size_t>((lon + 180.0f) * cols / 360.0f));
+	}
+
+	static constexpr size_t row_of(const float lat) {
+		return (lat <= -90.0f) ? 0 : ((lat >= 90.0f) ? (rows - 1) : static_cast<size_t>((lat + 90.0f) * rows / 180.0f));
+	}
+
+	size_t find(const Id id) const;
+	void link(const size_t i);
+	void unlink(const size_t i);
+	void move(const size_t from, const size_t to);
+};
+
+#endif/*__GEO_MARKERS_H__*/
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2013 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "geo_tracks.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// About a meter: a target that hasn't moved adds nothing to its path.
+constexpr float same_position_deg = 0.00001f;
+
+} /* namespace */
+
+size_t GeoTracks::find(const Id id) const {
+	for(size_t i=0; i<tracks_max; i++) {
+		if( tracks[i].count && (tracks[i].id == id) ) {
+			return i;
+		}
+	}
+	return tracks_max;
+}
+
+size_t GeoTracks::take_oldest() {
+	size_t oldest = 0;
+	for(size_t i=0; i<tracks_max; i++) {
+		if( tracks[i].count == 0 ) {
+			return i;
+		}
+		// Revisions wrap, compare how long ago rather than the values.
+		if( (revision_ - tracks[i].updated) > (revision_ - tracks[oldest].updated) ) {
+			oldest = i;
+		}
+	}
+	return oldest;
+}
+
+void GeoTracks::decimate(Point* const track, const size_t count) {
+	// Squared distance of each inner point of the older half from the
+	// chord between its neighbours, relative to that chord's length.
+	size_t best = 1;
+	float best_error = -1.0f;
+	for(size_t i=1; i<(count / 2); i++) {
+		const auto& a = track[i - 1];
+		const auto& p = track[i];
+		const auto& b = track[i + 1];
+		const float dx = b.lon - a.lon;
+		const float dy = b.lat - a.lat;
+		const float cross = (dx * (p.lat - a.lat)) - (dy * (p.lon - a.lon));
+		const float length2 = (dx * dx) + (dy * dy);
+		const float error = (length2 > 0.0f)
+			? ((cross * cross) / length2)
+			: (((p.lon - a.lon) * (p.lon - a.lon)) + ((p.lat - a.lat) * (p.lat - a.lat)));
+		if( (best_error < 0.0f) || (error < best_error) ) {
+			best = i;
+			best_error = error;
+		}
+	}
+	std::copy(&track[best + 1], &track[count], &track[best]);
+}
+
+void GeoTracks::add(const Id id, const float lat, const float lon) {
+	auto i = find(id);
+	if( i == tracks_max ) {
+		i = take_oldest();
+		tracks[i] = { id, revision_, 0 };
+	}
+
+	auto& track = tracks[i];
+	Point* const p = &points[i * points_max];
+	if( track.count ) {
+		const auto& last = p[track.count - 1];
+		if( (std::abs(last.lat - lat) < same_position_deg) && (std::abs(last.lon - lon) < same_position_deg) ) {
+			return;
+		}
+	}
+
+	if( track.count == points_max ) {
+		decimate(p, track.count);
+		track.count--;
+	}
+	p[track.count++] = { lat, lon };
+	track.updated = ++revision_;
+}
+
+void GeoTracks::remove(const Id id) {
+	const auto i = find(id);
+	if( i < tracks_max ) {
+		tracks[i].count = 0;
+		revision_++;
+	}
+}
+
+void GeoTracks::clear() {
+	for(size_t i=0; i<tracks_max; i++) {
+		tracks[i].count = 0;
+	}
+	revision_++;
+}
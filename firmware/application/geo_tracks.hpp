@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2013 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GEO_TRACKS_H__
+#define __GEO_TRACKS_H__
+
+#include "geo_markers.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Recent positions of targets, for GeoMap to draw as breadcrumb paths
+ * behind their GeoMarkers. Fixed memory, see GeoTrackStore: a new target
+ * takes over the track updated longest ago, and a full track makes room
+ * by dropping a point from its older half, the one whose removal bends
+ * the path least (a single Douglas-Peucker step, run backwards). Old
+ * stretches thin out, recent ones keep every fix.
+ */
+class GeoTracks {
+public:
+	using Id = GeoMarkers::Id;
+
+	struct Point {
+		float lat;
+		float lon;
+	};
+
+	GeoTracks(const GeoTracks&) = delete;
+	GeoTracks& operator=(const GeoTracks&) = delete;
+
+	void add(const Id id, const float lat, const float lon);
+	void remove(const Id id);
+	void clear();
+
+	/* Changes whenever a point is added or removed. */
+	uint32_t revision() const { return revision_; }
+
+	/* Calls f(points, count) for each track, oldest point first. */
+	template<typename F>
+	void for_each(F f) const {
+		for(size_t i=0; i<tracks_max; i++) {
+			if( tracks[i].count ) {
+				f(&points[i * points_max], tracks[i].count);
+			}
+		}
+	}
+
+	struct Track {
+		Id id;
+		uint32_t updated;	// revision_ at the last add()
+		uint8_t count;		// Zero if the track is free
+	};
+
+protected:
+	/* Only keeps the pointers, GeoTrackStore owns the storage. */
+	GeoTracks(
+		Track* const tracks,
+		const size_t tracks_max,
+		Point* const points,
+		const size_t points_max
+	) : tracks { tracks },
+		points { points },
+		tracks_max { tracks_max },
+		points_max { points_max }
+	{
+	}
+
+private:
+	Track* const tracks;
+	Point* const points;
+	const size_t tracks_max;
+	const size_t points_max;
+	uint32_t revision_ { 0 };
+
+	size_t find(const Id id) const;
+	size_t take_oldest();
+	void decimate(Point* const track, const size_t count);
+};
+
+template<size_t Tracks, size_t Points>
+struct GeoTrackStorage {
+	std::array<GeoTracks::Track, Tracks> tracks_ { };
+	std::array<GeoTracks::Point, Tracks * Points> points_ { };
+};
+
+/* The storage comes first, so it's there before GeoTracks points at it. */
+template<size_t Tracks, size_t Points>
+class GeoTrackStore : private GeoTrackStorage<Tracks, Points>, public GeoTracks {
+	static_assert(Points >= 4, "Decimation needs a few points to choose from");
+	static_assert(Points <= 255, "Point counts are a byte");
+
+public:
+	GeoTrackStore(
+	) : GeoTracks { this->tracks_.data(), Tracks, this->points_.data(), Points }
+	{
+	}
+};
+
+#endif/*__GEO_TRACKS_H__*/
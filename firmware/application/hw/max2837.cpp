@@ -146,13 +146,27 @@ void MAX2837::set_mode(const Mode mode) {
 	gpio_max2837_txenable.write(toUType(mode) & toUType(Mode::Mask_TxEnable));
 }
 
+static constexpr uint16_t write_frame(const address_t reg_num, const reg_t value) {
+	return (0U << 15) | (reg_num << 10) | (value & 0x3ffU);
+}
+
 void MAX2837::flush() {
 	if( _dirty ) {
+		/* One transaction for everything dirty. Low FRDIV goes last, as it
+		 * commits a synthesizer divider change.
+		 */
+		constexpr auto frdiv_lo = toUType(Register::SYN_FR_DIV_1);
+		std::array<uint16_t, reg_count> frames;
+		size_t count = 0;
 		for(size_t n=0; n<reg_count; n++) {
-			if( _dirty[n] ) {
-				write(n, _map.w[n]);
+			if( _dirty[n] && (n != frdiv_lo) ) {
+				frames[count++] = write_frame(n, _map.w[n]);
 			}
 		}
+		if( _dirty[frdiv_lo] ) {
+			frames[count++] = write_frame(frdiv_lo, _map.w[frdiv_lo]);
+		}
+		_target.transfer_frames(frames.data(), count);
 		_dirty.clear();
 	}
 }
@@ -164,13 +178,13 @@ void MAX2837::flush_one(const Register reg) {
 }
 
 void MAX2837::write(const address_t reg_num, const reg_t value) {
-	uint16_t t = (0U << 15) | (reg_num << 10) | (value & 0x3ffU);
-	_target.transfer(&t, 1);
+	uint16_t t = write_frame(reg_num, value);
+	_target.transfer_frames(&t, 1);
 }
 
 reg_t MAX2837::read(const address_t reg_num) {
 	uint16_t t = (1U << 15) | (reg_num << 10);
-	_target.transfer(&t, 1U);
+	_target.transfer_frames(&t, 1U);
 	return t & 0x3ffU;
 }
 
@@ -200,43 +214,108 @@ void MAX2837::set_vga_gain(const int_fast8_t db) {
 	flush();
 }
 
+void MAX2837::set_rx_gains(const int_fast8_t lna_db, const int_fast8_t vga_db) {
+	_map.r.rxrf_2.L = lna::gain_ordinal(lna_db);
+	_dirty[Register::RXRF_2] = 1;
+	_map.r.vga_2.VGA = vga::gain_ordinal(vga_db);
+	_dirty[Register::VGA_2] = 1;
+	flush();
+}
+
 void MAX2837::set_lpf_rf_bandwidth(const uint32_t bandwidth_minimum) {
 	_map.r.lpf_1.FT = filter::bandwidth_ordinal(bandwidth_minimum);
 	_dirty[Register::LPF_1] = 1;
 	flush();
 }
 
-bool MAX2837::set_frequency(const rf::Frequency lo_frequency) {
+Synth Synth::calculate(const rf::Frequency lo_frequency) {
 	/* TODO: This is a sad implementation. Refactor. */
+	uint8_t logen_bsw;
+	uint8_t lna_band;
 	if( lo::band[0].contains(lo_frequency) ) {
-		_map.r.syn_int_div.LOGEN_BSW = 0b00;	/* 2300 - 2399.99MHz */
-		_map.r.rxrf_1.LNAband = 0;				/* 2.3 - 2.5GHz */
+		logen_bsw = 0b00;	/* 2300 - 2399.99MHz */
+		lna_band = 0;		/* 2.3 - 2.5GHz */
 	} else if( lo::band[1].contains(lo_frequency)  ) {
-		_map.r.syn_int_div.LOGEN_BSW = 0b01;	/* 2400 - 2499.99MHz */
-		_map.r.rxrf_1.LNAband = 0;				/* 2.3 - 2.5GHz */
+		logen_bsw = 0b01;	/* 2400 - 2499.99MHz */
+		lna_band = 0;		/* 2.3 - 2.5GHz */
 	} else if( lo::band[2].contains(lo_frequency) ) {
-		_map.r.syn_int_div.LOGEN_BSW = 0b10;	/* 2500 - 2599.99MHz */
-		_map.r.rxrf_1.LNAband = 1;				/* 2.5 - 2.7GHz */
+		logen_bsw = 0b10;	/* 2500 - 2599.99MHz */
+		lna_band = 1;		/* 2.5 - 2.7GHz */
 	} else if( lo::band[3].contains(lo_frequency) ) {
-		_map.r.syn_int_div.LOGEN_BSW = 0b11;	/* 2600 - 2700Hz */
-		_map.r.rxrf_1.LNAband = 1;				/* 2.5 - 2.7GHz */
+		logen_bsw = 0b11;	/* 2600 - 2700Hz */
+		lna_band = 1;		/* 2.5 - 2.7GHz */
 	} else {
+		return { false, 0, 0, 0, 0, 0 };
+	}
+
+	const uint64_t div_q20 = (lo_frequency * (1 << 20)) / pll_factor;
+
+	return {
+		true,
+		logen_bsw,
+		lna_band,
+		static_cast<uint16_t>(div_q20 >> 20),
+		static_cast<uint16_t>((div_q20 >> 10) & 0x3ff),
+		static_cast<uint16_t>(div_q20 & 0x3ff),
+	};
+}
+
+bool MAX2837::set_frequency(const rf::Frequency lo_frequency) {
+	const auto synth = Synth::calculate(lo_frequency);
+	if( !synth.valid ) {
 		return false;
 	}
+
+	_map.r.syn_int_div.LOGEN_BSW = synth.logen_bsw;
+	_map.r.rxrf_1.LNAband = synth.lna_band;
 	_dirty[Register::SYN_INT_DIV] = 1;
 	_dirty[Register::RXRF_1] = 1;
 
-	const uint64_t div_q20 = (lo_frequency * (1 << 20)) / pll_factor;
-
-	_map.r.syn_int_div.SYN_INTDIV = div_q20 >> 20;
+	_map.r.syn_int_div.SYN_INTDIV = synth.int_div;
 	_dirty[Register::SYN_INT_DIV] = 1;
-	_map.r.syn_fr_div_2.SYN_FRDIV_19_10 = (div_q20 >> 10) & 0x3ff;
+	_map.r.syn_fr_div_2.SYN_FRDIV_19_10 = synth.frac_div_hi;
 	_dirty[Register::SYN_FR_DIV_2] = 1;
-	/* flush to commit high FRDIV first, as low FRDIV commits the change */
+	/* flush() sends low FRDIV last, which commits the change */
+	_map.r.syn_fr_div_1.SYN_FRDIV_9_0 = synth.frac_div_lo;
+	_dirty[Register::SYN_FR_DIV_1] = 1;
 	flush();
 
-	_map.r.syn_fr_div_1.SYN_FRDIV_9_0 = (div_q20 & 0x3ff);
-	_dirty[Register::SYN_FR_DIV_1] = 1;
+	return true;
+}
+
+bool MAX2837::set_synth(const Synth& synth) {
+	if( !synth.valid ) {
+		return false;
+	}
+
+	const auto syn_int_div = _map.w[toUType(Register::SYN_INT_DIV)];
+	const auto rxrf_1 = _map.w[toUType(Register::RXRF_1)];
+	const auto syn_fr_div_2 = _map.w[toUType(Register::SYN_FR_DIV_2)];
+	const auto syn_fr_div_1 = _map.w[toUType(Register::SYN_FR_DIV_1)];
+
+	_map.r.syn_int_div.LOGEN_BSW = synth.logen_bsw;
+	_map.r.rxrf_1.LNAband = synth.lna_band;
+	_map.r.syn_int_div.SYN_INTDIV = synth.int_div;
+	_map.r.syn_fr_div_2.SYN_FRDIV_19_10 = synth.frac_div_hi;
+	_map.r.syn_fr_div_1.SYN_FRDIV_9_0 = synth.frac_div_lo;
+
+	const bool changed = (_map.w[toUType(Register::SYN_INT_DIV)] != syn_int_div)
+		|| (_map.w[toUType(Register::SYN_FR_DIV_2)] != syn_fr_div_2)
+		|| (_map.w[toUType(Register::SYN_FR_DIV_1)] != syn_fr_div_1);
+
+	if( _map.w[toUType(Register::RXRF_1)] != rxrf_1 ) {
+		_dirty[Register::RXRF_1] = 1;
+	}
+	if( _map.w[toUType(Register::SYN_INT_DIV)] != syn_int_div ) {
+		_dirty[Register::SYN_INT_DIV] = 1;
+	}
+	if( _map.w[toUType(Register::SYN_FR_DIV_2)] != syn_fr_div_2 ) {
+		_dirty[Register::SYN_FR_DIV_2] = 1;
+	}
+	/* Low FRDIV commits any divider change, flush() sends it last */
+	if( changed ) {
+		_dirty[Register::SYN_FR_DIV_1] = 1;
+	}
 	flush();
 
 	return true;
@@ -826,6 +826,27 @@ constexpr RegisterMap initial_register_values { Register_Type {
 	},
 } };
 
+/* Synthesizer settings for one LO frequency, see rffc507x::Synth. */
+struct Synth {
+	bool valid;
+	uint8_t logen_bsw;
+	uint8_t lna_band;
+	uint16_t int_div;
+	uint16_t frac_div_hi;
+	uint16_t frac_div_lo;
+
+	static Synth calculate(const rf::Frequency lo_frequency);
+
+	bool operator==(const Synth& other) const {
+		return (valid == other.valid)
+			&& (logen_bsw == other.logen_bsw)
+			&& (lna_band == other.lna_band)
+			&& (int_div == other.int_div)
+			&& (frac_div_hi == other.frac_div_hi)
+			&& (frac_div_lo == other.frac_div_lo);
+	}
+};
+
 class MAX2837 {
 public:
 	constexpr MAX2837(
@@ -840,6 +861,8 @@ public:
 	void set_tx_vga_gain(const int_fast8_t db);
 	void set_lna_gain(const int_fast8_t db);
 	void set_vga_gain(const int_fast8_t db);
+	/* Both RX gains in one SPI transaction. */
+	void set_rx_gains(const int_fast8_t lna_db, const int_fast8_t vga_db);
 	void set_lpf_rf_bandwidth(const uint32_t bandwidth_minimum);
 #if 0
 	void rx_cal() {
@@ -883,6 +906,8 @@ public:
 #endif
 
 	bool set_frequency(const rf::Frequency lo_frequency);
+	/* Only writes the registers that differ from the current settings. */
+	bool set_synth(const Synth& synth);
 
 	void set_rx_lo_iq_calibration(const size_t v);
 	void set_rx_bias_trim(const size_t v);
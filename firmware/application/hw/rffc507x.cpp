@@ -232,30 +232,61 @@ void RFFC507x::set_mixer_current(const uint8_t value) {
 	flush_one(Register::MIX_CONT);
 }
 
-void RFFC507x::set_frequency(const rf::Frequency lo_frequency) {
+Synth Synth::calculate(const rf::Frequency lo_frequency) {
 	const SynthConfig synth_config = SynthConfig::calculate(lo_frequency);
 
-	/* Boost charge pump leakage if VCO frequency > 3.2GHz, indicated by
-	 * prescaler divider set to 4 (log2=2) instead of 2 (log2=1).
-	 */
-	if( synth_config.prescaler_divider_log2 == 2 ) {
-		_map.r.lf.pllcpl = 3;
-	} else {
-		_map.r.lf.pllcpl = 2;
-	}
+	return {
+		/* Boost charge pump leakage if VCO frequency > 3.2GHz, indicated by
+		 * prescaler divider set to 4 (log2=2) instead of 2 (log2=1).
+		 */
+		static_cast<uint8_t>((synth_config.prescaler_divider_log2 == 2) ? 3 : 2),
+		static_cast<uint8_t>(synth_config.lo_divider_log2),
+		static_cast<uint8_t>(synth_config.prescaler_divider_log2),
+		static_cast<uint8_t>(synth_config.n_divider_q24 & 0xff),
+		static_cast<uint16_t>(synth_config.n_divider_q24 >> 24),
+		static_cast<uint16_t>((synth_config.n_divider_q24 >> 8) & 0xffff),
+	};
+}
+
+void RFFC507x::apply_synth(const Synth& synth) {
+	_map.r.lf.pllcpl = synth.pllcpl;
+	_map.r.p2_freq1.p2n = synth.n;
+	_map.r.p2_freq1.p2lodiv = synth.lo_divider_log2;
+	_map.r.p2_freq1.p2presc = synth.prescaler_divider_log2;
+	_map.r.p2_freq2.p2nmsb = synth.n_frac_msb;
+	_map.r.p2_freq3.p2nlsb = synth.n_frac_lsb;
+}
+
+void RFFC507x::set_frequency(const rf::Frequency lo_frequency) {
+	apply_synth(Synth::calculate(lo_frequency));
 	flush_one(Register::LF);
 
-	_map.r.p2_freq1.p2n = synth_config.n_divider_q24 >> 24;
-	_map.r.p2_freq1.p2lodiv = synth_config.lo_divider_log2;
-	_map.r.p2_freq1.p2presc = synth_config.prescaler_divider_log2;
-	_map.r.p2_freq2.p2nmsb = (synth_config.n_divider_q24 >> 8) & 0xffff;
-	_map.r.p2_freq3.p2nlsb = synth_config.n_divider_q24 & 0xff;
 	_dirty[Register::P2_FREQ1] = 1;
 	_dirty[Register::P2_FREQ2] = 1;
 	_dirty[Register::P2_FREQ3] = 1;
 	flush();
 }
 
+void RFFC507x::set_synth(const Synth& synth) {
+	constexpr std::array<Register, 4> synth_registers { {
+		Register::LF, Register::P2_FREQ1, Register::P2_FREQ2, Register::P2_FREQ3,
+	} };
+
+	std::array<reg_t, synth_registers.size()> previous;
+	for(size_t i=0; i<synth_registers.size(); i++) {
+		previous[i] = _map.w[toUType(synth_registers[i])];
+	}
+
+	apply_synth(synth);
+
+	for(size_t i=0; i<synth_registers.size(); i++) {
+		if( _map.w[toUType(synth_registers[i])] != previous[i] ) {
+			_dirty[synth_registers[i]] = 1;
+		}
+	}
+	flush();
+}
+
 void RFFC507x::set_gpo1(const bool new_value) {
 	if( new_value ) {
 		_map.r.gpo.p2gpo |= 1;
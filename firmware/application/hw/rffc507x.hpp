@@ -796,6 +796,29 @@ constexpr RegisterMap default_hackrf_one { Register_Type {
 	},
 } };
 
+/* Synthesizer settings for one LO frequency. Computing these is the slow
+ * part of a retune, so scanners build a table of them up front.
+ */
+struct Synth {
+	uint8_t pllcpl;
+	uint8_t lo_divider_log2;
+	uint8_t prescaler_divider_log2;
+	uint8_t n_frac_lsb;
+	uint16_t n;
+	uint16_t n_frac_msb;
+
+	static Synth calculate(const rf::Frequency lo_frequency);
+
+	bool operator==(const Synth& other) const {
+		return (pllcpl == other.pllcpl)
+			&& (lo_divider_log2 == other.lo_divider_log2)
+			&& (prescaler_divider_log2 == other.prescaler_divider_log2)
+			&& (n_frac_lsb == other.n_frac_lsb)
+			&& (n == other.n)
+			&& (n_frac_msb == other.n_frac_msb);
+	}
+};
+
 class RFFC507x {
 public:
 	void init();
@@ -808,6 +831,8 @@ public:
 
 	void set_mixer_current(const uint8_t value);
 	void set_frequency(const rf::Frequency lo_frequency);
+	/* Only writes the registers that differ from the current settings. */
+	void set_synth(const Synth& synth);
 	void set_gpo1(const bool new_value);
 	
 	reg_t read(const address_t reg_num);
@@ -827,6 +852,8 @@ private:
 
 	reg_t readback(const Readback readback);
 
+	void apply_synth(const Synth& synth);
+
 	void init_for_best_performance();
 };
 
@@ -74,15 +74,12 @@ Si5351::regvalue_t Si5351::read_register(const uint8_t reg) {
 	return rx[0];
 }
 
-void Si5351::set_ms_frequency(
+MultisynthFractionalReg ms_frequency_reg(
 	const size_t ms_number,
 	const uint32_t frequency,
 	const uint32_t vco_frequency,
 	const size_t r_div
 ) {
-	/* TODO: Factor out the VCO frequency, which should be an attribute held
-	 * by the Si5351 object.
-	 */
 	const uint32_t a = vco_frequency / frequency;
 	const uint32_t remainder = vco_frequency - (frequency * a);
 	const uint32_t denom = gcd(remainder, frequency);
@@ -99,8 +96,19 @@ void Si5351::set_ms_frequency(
 		.c = c,
 		.r_div = r_div,
 	};
-	const auto regs = ms.reg(ms_number);
-	write(regs);
+	return ms.reg(ms_number);
+}
+
+void Si5351::set_ms_frequency(
+	const size_t ms_number,
+	const uint32_t frequency,
+	const uint32_t vco_frequency,
+	const size_t r_div
+) {
+	/* TODO: Factor out the VCO frequency, which should be an attribute held
+	 * by the Si5351 object.
+	 */
+	write(ms_frequency_reg(ms_number, frequency, vco_frequency, r_div));
 }
 
 } /* namespace si5351 */
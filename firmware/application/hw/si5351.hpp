@@ -283,6 +283,14 @@ constexpr Multisynth6And7Reg ms6_7_reg(
 	};
 }
 
+/* Registers setting ms_number to frequency, up to r_div, from vco_frequency. */
+MultisynthFractionalReg ms_frequency_reg(
+	const size_t ms_number,
+	const uint32_t frequency,
+	const uint32_t vco_frequency,
+	const size_t r_div
+);
+
 class Si5351 {
 public:
 	using regvalue_t = uint8_t;
@@ -321,6 +329,11 @@ public:
 		_bus.transmit(_address, values.data(), values.size());
 	}
 
+	/* data[0] is the first register, as with the arrays. */
+	void write(const uint8_t* const data, const size_t count) {
+		_bus.transmit(_address, data, count);
+	}
+
 	void write_register(const uint8_t reg, const regvalue_t value) {
 		write(std::array<uint8_t, 2>{
 			reg, value
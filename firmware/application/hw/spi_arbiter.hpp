@@ -47,6 +47,15 @@ public:
 		_bus.transfer(data, count);
 	}
 
+	void transfer_frames(const SPIConfig* const config, uint16_t* const frames, const size_t count) {
+		if( config != _config ) {
+			_bus.stop();
+			_bus.start(*config);
+			_config = config;
+		}
+		_bus.transfer_frames(frames, count);
+	}
+
 private:
 	SPI& _bus;
 	const SPIConfig* _config;
@@ -66,6 +75,10 @@ public:
 		_arbiter.transfer(&_config, data, count);
 	}
 
+	void transfer_frames(uint16_t* const frames, const size_t count) {
+		_arbiter.transfer_frames(&_config, frames, count);
+	}
+
 private:
 	Arbiter& _arbiter;
 	const SPIConfig _config;
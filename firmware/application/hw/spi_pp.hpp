@@ -49,6 +49,20 @@ public:
 		spiReleaseBus(_driver);
 	}
 
+	/* Exchanges count 16-bit frames in one bus acquisition, each framed by its
+	 * own chip select, polled. For register writes this short, the interrupt
+	 * and thread wakeup of spiExchange() cost more than the transfer.
+	 */
+	void transfer_frames(uint16_t* const frames, const size_t count) {
+		spiAcquireBus(_driver);
+		for(size_t i=0; i<count; i++) {
+			spiSelect(_driver);
+			frames[i] = spiPolledExchange(_driver, frames[i]);
+			spiUnselect(_driver);
+		}
+		spiReleaseBus(_driver);
+	}
+
 private:
 	SPIDriver* const _driver;
 };
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "file.hpp"
+#include "optional.hpp"
 
 namespace stream {
 
@@ -34,6 +35,8 @@ public:
 class Writer {
 public:
 	virtual File::Result<File::Size> write(const void* const buffer, const File::Size bytes) = 0;
+	/* Called now and then between writes, to make them durable. */
+	virtual Optional<File::Error> sync() { return { }; }
 	virtual ~Writer() = default;
 };
 
@@ -21,6 +21,12 @@
 
 #include "io_file.hpp"
 
+#include "string_format.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 File::Result<File::Size> FileReader::read(void* const buffer, const File::Size bytes) {
 	auto read_result = file.read(buffer, bytes) ;
 	if( read_result.is_ok() ) {
@@ -29,6 +35,138 @@ File::Result<File::Size> FileReader::read(void* const buffer, const File::Size b
 	return read_result;
 }
 
+File::Result<File::Size> FileReader::read_blocks(void* const buffer, const File::Size bytes) {
+	auto read_result = file.read_blocks(buffer, bytes);
+	if( read_result.is_ok() ) {
+		bytes_read += read_result.value();
+	}
+	return read_result;
+}
+
+File::Result<File::Size> RiceIQFileReader::read(void* const buffer, const File::Size bytes) {
+	auto p = static_cast<uint8_t*>(buffer);
+	File::Size written = 0;
+
+	while( written < bytes ) {
+		if( block_offset < block_size ) {
+			const size_t n = std::min<File::Size>(block_size - block_offset, bytes - written);
+			memcpy(&p[written], &reinterpret_cast<const uint8_t*>(block.data())[block_offset], n);
+			block_offset += n;
+			written += n;
+			continue;
+		}
+
+		size_t consumed = 0;
+		const auto samples = iq_codec::decode(&input[input_begin], input_end - input_begin, block.data(), consumed);
+		input_begin += consumed;
+		if( samples ) {
+			block_offset = 0;
+			block_size = samples * sizeof(complex16_t);
+			continue;
+		}
+		if( consumed ) {
+			continue;
+		}
+
+		// Not a whole block left, top up the input.
+		const size_t leftover = input_end - input_begin;
+		const size_t read_start = (leftover + File::block_size - 1) & ~(File::block_size - 1);
+		memmove(&input[read_start - leftover], &input[input_begin], leftover);
+		input_begin = read_start - leftover;
+		input_end = read_start;
+
+		const size_t read_bytes = (input.size() - read_start) & ~(File::block_size - 1);
+		auto read_result = (bytes_read % File::block_size)
+			? FileReader::read(&input[input_end], read_bytes)
+			: FileReader::read_blocks(&input[input_end], read_bytes);
+		if( read_result.is_error() ) {
+			return read_result;
+		}
+		if( read_result.value() == 0 ) {
+			// End of file; a trailing partial block is dropped.
+			break;
+		}
+		input_end += read_result.value();
+	}
+
+	return written;
+}
+
+PlaylistReader::PlaylistReader(
+	std::vector<std::filesystem::path> items,
+	const size_t sample_size,
+	const bool loop
+) : items(std::move(items)),
+	sample_size { sample_size },
+	loop { loop }
+{
+}
+
+Optional<File::Error> PlaylistReader::open_next(bool& opened) {
+	reader.reset();
+	opened = false;
+	if( (next_item == items.size()) && loop ) {
+		next_item = 0;
+	}
+	if( next_item == items.size() ) {
+		return { };
+	}
+
+	const auto& path = items[next_item++];
+	const bool compressed = (path.extension().string() == ".RIQ");
+	std::unique_ptr<FileReader> p;
+	if( compressed ) {
+		p = std::make_unique<RiceIQFileReader>();
+	} else {
+		p = std::make_unique<FileReader>();
+	}
+	const auto open_error = p->open(path);
+	if( open_error.is_valid() ) {
+		return open_error;
+	}
+
+	const auto size = p->size();
+	remaining = compressed ? std::numeric_limits<File::Size>::max() : (size - (size % sample_size));
+	reader = std::move(p);
+	opened = true;
+	return { };
+}
+
+File::Result<File::Size> PlaylistReader::read(void* const buffer, const File::Size bytes) {
+	auto p = static_cast<uint8_t*>(buffer);
+	File::Size written = 0;
+
+	// An empty file in the list doesn't end it, a whole pass of them does.
+	size_t empty_count = 0;
+	while( written < bytes ) {
+		if( !reader || (remaining == 0) ) {
+			bool opened = false;
+			const auto open_error = open_next(opened);
+			if( open_error.is_valid() ) {
+				return open_error.value();
+			}
+			if( !opened || (empty_count > items.size()) ) {
+				break;
+			}
+		}
+
+		const auto read_result = reader->read(&p[written], std::min(bytes - written, remaining));
+		if( read_result.is_error() ) {
+			return read_result;
+		}
+		if( read_result.value() == 0 ) {
+			remaining = 0;
+			empty_count++;
+			continue;
+		}
+		empty_count = 0;
+		remaining -= read_result.value();
+		written += read_result.value();
+	}
+
+	return written;
+}
+
 File::Result<File::Size> FileWriter::write(const void* const buffer, const File::Size bytes) {
 	auto write_result = file.write(buffer, bytes) ;
 	if( write_result.is_ok() ) {
@@ -36,3 +174,271 @@ File::Result<File::Size> FileWriter::write(const void* const buffer, const File:
 	}
 	return write_result;
 }
+
+File::Result<File::Size> FileWriter::write_blocks(const void* const buffer, const File::Size bytes) {
+	auto write_result = file.write_blocks(buffer, bytes);
+	if( write_result.is_ok() ) {
+		bytes_written += write_result.value();
+	}
+	return write_result;
+}
+
+ContiguousFileWriter::~ContiguousFileWriter() {
+	finish_contiguous();
+}
+
+Optional<File::Error> ContiguousFileWriter::create(const std::filesystem::path& filename, const File::Size capacity) {
+	const auto create_error = file.create(filename);
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+
+	// Free space is usually fragmented somewhere, back off until a
+	// contiguous run is found.
+	auto size = capacity - (capacity % sector_size);
+	while( size >= capacity_min ) {
+		const auto expand_error = file.preallocate(size);
+		if( !expand_error.is_valid() ) {
+			contiguous_size = size;
+			contiguous = true;
+			break;
+		}
+		if( expand_error.value().code() != FR_DENIED ) {
+			return expand_error;
+		}
+		size /= 2;
+		size -= size % sector_size;
+	}
+
+	return { };
+}
+
+File::Result<File::Size> ContiguousFileWriter::write(const void* const buffer, const File::Size bytes) {
+	if( contiguous ) {
+		if( ((bytes % sector_size) == 0) && ((bytes_written + bytes) <= contiguous_size) ) {
+			auto write_result = file.write_sectors(bytes_written, buffer, bytes);
+			if( write_result.is_ok() ) {
+				bytes_written += write_result.value();
+			}
+			return write_result;
+		}
+
+		// Out of reserved space (or an odd-sized write): continue with
+		// regular FatFs writes after the data written so far.
+		finish_contiguous();
+	}
+
+	// Contiguous writes were whole sectors, so the file pointer usually
+	// still is on a block boundary.
+	if( ((reinterpret_cast<uintptr_t>(buffer) & 3) == 0) && ((bytes % File::block_size) == 0) && ((bytes_written % File::block_size) == 0) ) {
+		return FileWriter::write_blocks(buffer, bytes);
+	}
+	return FileWriter::write(buffer, bytes);
+}
+
+void ContiguousFileWriter::finish_contiguous() {
+	if( contiguous ) {
+		contiguous = false;
+		file.seek(bytes_written);
+		file.truncate();
+	}
+}
+
+SegmentedFileWriter::SegmentedFileWriter(
+	const std::filesystem::path& filename,
+	const File::Size segment_size,
+	std::vector<std::string> sidecar_lines
+) : stem { filename },
+	extension { filename.extension() },
+	segment_size { segment_size },
+	sidecar_lines { std::move(sidecar_lines) }
+{
+	stem.replace_extension();
+	chSemInit(&request, 0);
+	chMtxInit(&mutex);
+}
+
+SegmentedFileWriter::~SegmentedFileWriter() {
+	if( thread ) {
+		chThdTerminate(thread);
+		chSemSignal(&request);
+		chThdWait(thread);
+		thread = nullptr;
+	}
+
+	retired.reset();
+	current.reset();
+	if( next ) {
+		// Reserved, but never written to.
+		next.reset();
+		delete_file(segment_path(current_index + 1));
+	}
+}
+
+Optional<File::Error> SegmentedFileWriter::create() {
+	const auto create_error = create_segment(0, current);
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+
+	// Needs FatFs's stack, as CaptureThread does.
+	thread = chThdCreateFromHeap(NULL, 2048, NORMALPRIO + 5, SegmentedFileWriter::static_fn, this);
+	post_job();
+	return { };
+}
+
+File::Result<File::Size> SegmentedFileWriter::write(const void* const buffer, const File::Size bytes) {
+	chMtxLock(&mutex);
+	const auto error = helper_error;
+	bool swap = false;
+	if( !error.is_valid() && current_bytes && ((current_bytes + bytes) > segment_size) && next_ready ) {
+		retired = std::move(current);
+		current = std::move(next);
+		next_ready = false;
+		swap = true;
+	}
+	chMtxUnlock();
+
+	if( error.is_valid() ) {
+		return { error.value() };
+	}
+	if( swap ) {
+		current_index++;
+		current_offset += current_bytes;
+		current_bytes = 0;
+		post_job();
+	}
+
+	auto write_result = current->write(buffer, bytes);
+	if( write_result.is_ok() ) {
+		current_bytes += write_result.value();
+	}
+	return write_result;
+}
+
+msg_t SegmentedFileWriter::static_fn(void* arg) {
+	chRegSetThreadName("segments");
+	static_cast<SegmentedFileWriter*>(arg)->run();
+	return 0;
+}
+
+void SegmentedFileWriter::post_job() {
+	chMtxLock(&mutex);
+	job_index = current_index;
+	job_offset = current_offset;
+	chMtxUnlock();
+	chSemSignal(&request);
+}
+
+void SegmentedFileWriter::run() {
+	while( true ) {
+		chSemWait(&request);
+		if( chThdShouldTerminate() ) {
+			break;
+		}
+
+		chMtxLock(&mutex);
+		auto finished = std::move(retired);
+		const auto index = job_index;
+		const auto offset = job_offset;
+		chMtxUnlock();
+
+		// Truncating the finished segment's reserved tail walks its chain.
+		finished.reset();
+
+		std::unique_ptr<ContiguousFileWriter> segment;
+		auto error = write_sidecar(index, offset);
+		if( !error.is_valid() ) {
+			error = create_segment(index + 1, segment);
+		}
+
+		chMtxLock(&mutex);
+		if( error.is_valid() ) {
+			helper_error = error;
+		} else {
+			next = std::move(segment);
+			next_ready = true;
+		}
+		chMtxUnlock();
+	}
+}
+
+std::filesystem::path SegmentedFileWriter::segment_path(const size_t index) const {
+	auto path = stem;
+	if( index ) {
+		path += std::filesystem::path { "_" + to_string_dec_uint(index, 3, '0') };
+	}
+	path += extension;
+	return path;
+}
+
+Optional<File::Error> SegmentedFileWriter::create_segment(const size_t index, std::unique_ptr<ContiguousFileWriter>& segment) {
+	// The current segment still holds its reservation, so this one may
+	// come up short and go on with regular writes.
+	const auto space_info = std::filesystem::space(u"");
+	const File::Size capacity = std::min<File::Size>(space_info.free, segment_size);
+
+	auto p = std::make_unique<ContiguousFileWriter>();
+	const auto create_error = p->create(segment_path(index), capacity);
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+	segment = std::move(p);
+	return { };
+}
+
+Optional<File::Error> SegmentedFileWriter::write_sidecar(const size_t index, const uint64_t offset) {
+	auto path = segment_path(index);
+	File file;
+	const auto create_error = file.create(path.replace_extension(u".TXT"));
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+
+	for(const auto& line : sidecar_lines) {
+		const auto error = file.write_line(line);
+		if( error.is_valid() ) {
+			return error;
+		}
+	}
+	const auto error_segment = file.write_line("segment=" + to_string_dec_uint(index));
+	if( error_segment.is_valid() ) {
+		return error_segment;
+	}
+	return file.write_line("segment_offset=" + to_string_dec_uint64(offset));
+}
+
+MetadataFileWriter::~MetadataFileWriter() {
+	flush();
+}
+
+Optional<File::Error> MetadataFileWriter::create(const std::filesystem::path& filename, const std::string& global_fields) {
+	const auto create_error = file.create(filename);
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+
+	pending = "{\"global\":{" + global_fields + "}}\r\n";
+	return flush();
+}
+
+Optional<File::Error> MetadataFileWriter::append(const uint64_t sample_start, const std::string& fields) {
+	pending += "{\"core:sample_start\":" + to_string_dec_uint64(sample_start) + "," + fields + "}\r\n";
+	if( pending.size() >= flush_size ) {
+		return flush();
+	}
+	return { };
+}
+
+Optional<File::Error> MetadataFileWriter::flush() {
+	if( pending.empty() ) {
+		return { };
+	}
+
+	const auto write_result = file.write(pending.data(), pending.size());
+	pending.clear();
+	if( write_result.is_error() ) {
+		return { write_result.error() };
+	}
+	return { };
+}
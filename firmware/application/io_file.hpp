@@ -21,12 +21,20 @@
 
 #pragma once
 
+#include "ch.h"
+
 #include "io.hpp"
 
 #include "file.hpp"
 #include "optional.hpp"
+#include "iq_codec.hpp"
+#include "complex.hpp"
 
 #include <cstdint>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
 
 class FileReader : public stream::Reader {
 public:
@@ -42,12 +50,72 @@ public:
 	}
 	
 	File::Result<File::Size> read(void* const buffer, const File::Size bytes) override;
+
+	/* See File::read_blocks(). */
+	File::Result<File::Size> read_blocks(void* const buffer, const File::Size bytes);
+
+	File::Size size() {
+		return file.size();
+	}
 	
 protected:
 	File file { };
 	uint64_t bytes_read { 0 };
 };
 
+/* Reader for iq_codec compressed captures (.RIQ): hands out the decoded
+ * complex int16 samples, so replay sees the same stream as from a .C16.
+ * A damaged block is skipped up to the next sync word.
+ */
+class RiceIQFileReader : public FileReader {
+public:
+	RiceIQFileReader() = default;
+
+	File::Result<File::Size> read(void* const buffer, const File::Size bytes) override;
+
+private:
+	// Top-ups are whole blocks read straight into input, the leftover
+	// partial block is moved down to end on a block boundary first.
+	alignas(4) std::array<uint8_t, 4096> input { };
+	size_t input_begin { 0 };
+	size_t input_end { 0 };
+	std::array<complex16_t, iq_codec::block_samples_max> block { };
+	size_t block_offset { 0 };
+	size_t block_size { 0 };
+};
+
+/* Reads captures back to back as one stream: when a file runs out, the
+ * next is opened within the same read, so replay goes from one to the next
+ * without a gap or restart. .RIQ files are decoded as they go. Raw files
+ * are cut to whole samples of sample_size bytes, so a ragged end can't
+ * swap the next file's I and Q. With loop, the list starts over after the
+ * last file. The files must share a sample rate and format.
+ */
+class PlaylistReader : public stream::Reader {
+public:
+	PlaylistReader(
+		std::vector<std::filesystem::path> items,
+		const size_t sample_size,
+		const bool loop
+	);
+
+	PlaylistReader(const PlaylistReader&) = delete;
+	PlaylistReader& operator=(const PlaylistReader&) = delete;
+
+	File::Result<File::Size> read(void* const buffer, const File::Size bytes) override;
+
+private:
+	const std::vector<std::filesystem::path> items;
+	const size_t sample_size;
+	const bool loop;
+	size_t next_item { 0 };
+	std::unique_ptr<FileReader> reader { };
+	File::Size remaining { 0 };
+
+	/* Leaves opened false at the end of the list. */
+	Optional<File::Error> open_next(bool& opened);
+};
+
 class FileWriter : public stream::Writer {
 public:
 	FileWriter() = default;
@@ -62,6 +130,9 @@ public:
 	}
 
 	File::Result<File::Size> write(const void* const buffer, const File::Size bytes) override;
+
+	/* See File::write_blocks(). */
+	File::Result<File::Size> write_blocks(const void* const buffer, const File::Size bytes);
 	
 protected:
 	File file { };
@@ -69,3 +140,125 @@ protected:
 };
 
 using RawFileWriter = FileWriter;
+
+/* Writer for high-rate captures. Reserves a contiguous region up front and
+ * writes sector-aligned blocks into it with raw multi-sector transfers, so
+ * the FatFs cache and cluster chain walk are out of the streaming path.
+ * Falls back to regular writes if no contiguous space is found, the region
+ * fills up, or a write is not sector-aligned. Trims the reserved tail when
+ * destroyed.
+ */
+class ContiguousFileWriter : public FileWriter {
+public:
+	ContiguousFileWriter() = default;
+	~ContiguousFileWriter();
+
+	Optional<File::Error> create(const std::filesystem::path& filename, const File::Size capacity);
+
+	File::Result<File::Size> write(const void* const buffer, const File::Size bytes) override;
+
+private:
+	static constexpr File::Size sector_size = 512;
+	static constexpr File::Size capacity_min = 1024 * 1024;
+
+	File::Size contiguous_size { 0 };
+	bool contiguous { false };
+
+	void finish_contiguous();
+};
+
+/* Writer for long captures, rotated into segments of about segment_size
+ * bytes, so no file nears the FAT32 limit and damage to one loses only
+ * that segment. The first segment is filename, the others its stem plus
+ * "_001", "_002"... Each is a ContiguousFileWriter with a .TXT sidecar:
+ * sidecar_lines, then the segment's number and its byte offset in the
+ * whole capture. A helper thread closes out the finished segment, writes
+ * the new one's sidecar and creates and reserves the next while the
+ * current one fills, so at a boundary the writer only swaps them over.
+ * A segment ends before the write that would take it past segment_size;
+ * if the next one isn't ready by then, the current one runs on until it
+ * is.
+ */
+class SegmentedFileWriter : public stream::Writer {
+public:
+	SegmentedFileWriter(
+		const std::filesystem::path& filename,
+		const File::Size segment_size,
+		std::vector<std::string> sidecar_lines
+	);
+	~SegmentedFileWriter();
+
+	SegmentedFileWriter(const SegmentedFileWriter&) = delete;
+	SegmentedFileWriter& operator=(const SegmentedFileWriter&) = delete;
+	SegmentedFileWriter(SegmentedFileWriter&&) = delete;
+	SegmentedFileWriter& operator=(SegmentedFileWriter&&) = delete;
+
+	/* The first segment, then the helper starts on the second. */
+	Optional<File::Error> create();
+
+	File::Result<File::Size> write(const void* const buffer, const File::Size bytes) override;
+
+private:
+	std::filesystem::path stem;
+	const std::filesystem::path extension;
+	const File::Size segment_size;
+	const std::vector<std::string> sidecar_lines;
+
+	Thread* thread { nullptr };
+	Semaphore request;
+	Mutex mutex;
+
+	// The writer's
+	std::unique_ptr<ContiguousFileWriter> current { };
+	size_t current_index { 0 };
+	uint64_t current_offset { 0 };
+	File::Size current_bytes { 0 };
+
+	// Shared, under mutex. next belongs to the helper until next_ready.
+	std::unique_ptr<ContiguousFileWriter> next { };
+	std::unique_ptr<ContiguousFileWriter> retired { };
+	bool next_ready { false };
+	size_t job_index { 0 };
+	uint64_t job_offset { 0 };
+	Optional<File::Error> helper_error { };
+
+	static msg_t static_fn(void* arg);
+	void run();
+
+	/* Starts the helper on the job for the current segment. */
+	void post_job();
+
+	std::filesystem::path segment_path(const size_t index) const;
+	Optional<File::Error> create_segment(const size_t index, std::unique_ptr<ContiguousFileWriter>& segment);
+	Optional<File::Error> write_sidecar(const size_t index, const uint64_t offset);
+};
+
+/* Streaming sidecar for capture annotations, one SigMF-style JSON object
+ * per line, each keyed by the sample offset in the data file it applies
+ * to. Records are queued in memory and written out a sector at a time, so
+ * annotating does not compete with the data file for the card on every
+ * event.
+ */
+class MetadataFileWriter {
+public:
+	MetadataFileWriter() = default;
+	~MetadataFileWriter();
+
+	MetadataFileWriter(const MetadataFileWriter&) = delete;
+	MetadataFileWriter& operator=(const MetadataFileWriter&) = delete;
+	MetadataFileWriter(MetadataFileWriter&&) = delete;
+	MetadataFileWriter& operator=(MetadataFileWriter&&) = delete;
+
+	Optional<File::Error> create(const std::filesystem::path& filename, const std::string& global_fields);
+
+	/* `fields` are comma-separated "key":value pairs, without braces. */
+	Optional<File::Error> append(const uint64_t sample_start, const std::string& fields);
+
+	Optional<File::Error> flush();
+
+private:
+	static constexpr size_t flush_size = 512;
+
+	File file { };
+	std::string pending { };
+};
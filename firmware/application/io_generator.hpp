@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "io.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+/* Reader for symbols synthesized on the fly rather than read from a file,
+ * so a ReplayThread can stream them to a TX processor (see BitStream in
+ * the baseband). fill writes up to bytes into buffer and returns how many
+ * it wrote; zero ends the stream.
+ */
+class GeneratorReader : public stream::Reader {
+public:
+	using FillFunc = std::function<size_t(uint8_t* const buffer, const size_t bytes)>;
+
+	GeneratorReader(FillFunc fill) : fill { std::move(fill) } { }
+
+	/* Only ever short at the end of the stream: the replay thread takes an
+	 * empty buffer as the end.
+	 */
+	File::Result<File::Size> read(void* const buffer, const File::Size bytes) override {
+		auto p = static_cast<uint8_t*>(buffer);
+		File::Size count = 0;
+		while( !ended && (count < bytes) ) {
+			const auto filled = fill(&p[count], bytes - count);
+			ended = (filled == 0);
+			count += filled;
+		}
+		return count;
+	}
+
+private:
+	FillFunc fill;
+	bool ended { false };
+};
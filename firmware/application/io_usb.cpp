@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "io_usb.hpp"
+
+#include "usb_stream.hpp"
+
+#include <algorithm>
+
+File::Result<File::Size> USBStreamWriter::write(const void* const buffer, const File::Size bytes) {
+	const auto p = static_cast<const uint8_t*>(buffer);
+	File::Size written = 0;
+	while( written < bytes ) {
+		const size_t chunk = std::min<File::Size>(bytes - written, usb_stream::transfer_size_max);
+		if( !usb_stream::transmit_start(&p[written], chunk) ) {
+			return { File::Error { FR_USB_DISCONNECTED } };
+		}
+
+		auto result = usb_stream::transmit_wait(poll_interval);
+		while( result == usb_stream::Result::Timeout ) {
+			if( chThdShouldTerminate() ) {
+				// Stop the DMA before the buffers go back to the baseband.
+				usb_stream::transmit_cancel();
+				return { written };
+			}
+			result = usb_stream::transmit_wait(poll_interval);
+		}
+		if( result == usb_stream::Result::Disconnected ) {
+			return { File::Error { FR_USB_DISCONNECTED } };
+		}
+
+		written += chunk;
+	}
+	return { written };
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "io.hpp"
+
+#include "file.hpp"
+
+#include "ch.h"
+
+/* Capture writer to the USB bulk stream, see usb_stream.hpp. Each write
+ * goes out straight from the caller's buffer, and returns once the host
+ * has read it. While the host isn't reading, writes wait, and the baseband
+ * drops buffers as it does for a stalled SD card. Fails with
+ * FR_USB_DISCONNECTED if the host goes away.
+ */
+class USBStreamWriter : public stream::Writer {
+public:
+	USBStreamWriter() = default;
+
+	USBStreamWriter(const USBStreamWriter&) = delete;
+	USBStreamWriter& operator=(const USBStreamWriter&) = delete;
+	USBStreamWriter(USBStreamWriter&&) = delete;
+	USBStreamWriter& operator=(USBStreamWriter&&) = delete;
+
+	File::Result<File::Size> write(const void* const buffer, const File::Size bytes) override;
+
+private:
+	// How often a write waiting on the host checks for the thread stopping.
+	static constexpr systime_t poll_interval = MS2ST(100);
+};
@@ -22,6 +22,10 @@
 
 #include "io_wave.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 bool WAVFileReader::open(const std::filesystem::path& path) {
 	size_t i = 0;
 	char ch;
@@ -44,6 +48,18 @@ bool WAVFileReader::open(const std::filesystem::path& path) {
 		riff_size = header.cksize + 8;
 		data_start = header.fmt.cksize + 28;
 		data_size_ = header.data.cksize;
+
+		// Skip chunks ahead of the data chunk, like the JUNK padding of
+		// WAVFileWriter's files.
+		for(size_t chunks=0; (memcmp(header.data.ckID, "data", 4) != 0) && (chunks < 8); chunks++) {
+			const uint32_t next_chunk = data_start + header.data.cksize + (header.data.cksize & 1);
+			file.seek(next_chunk);
+			if( file.read((void*)&header.data, sizeof(header.data)).is_error() ) {
+				break;
+			}
+			data_start = next_chunk + sizeof(header.data);
+			data_size_ = header.data.cksize;
+		}
 		data_end = data_start + data_size_ + 1;
 		
 		// Look for INAM (title) tag
@@ -133,21 +149,94 @@ uint16_t WAVFileReader::bits_per_sample() {
 Optional<File::Error> WAVFileWriter::create(
 	const std::filesystem::path& filename,
 	size_t sampling_rate_set,
-	const std::string& title_set
+	const std::string& title_set,
+	const File::Size reserve
 ) {
 	sampling_rate = sampling_rate_set;
 	title = title_set;
 	const auto create_error = FileWriter::create(filename);
 	if( create_error.is_valid() ) {
 		return create_error;
-	} else {
-		return update_header();
 	}
+
+	if( reserve ) {
+		const auto reserve_error = file.preallocate(wav_data_offset + reserve);
+		if( reserve_error.is_valid() ) {
+			return reserve_error;
+		}
+	}
+
+	const auto header_error = update_header();
+	if( header_error.is_valid() ) {
+		return header_error;
+	}
+
+	// The JUNK payload is whatever seeking past the end leaves there.
+	const auto seek_result = file.seek(wav_data_offset);
+	if( seek_result.is_error() ) {
+		return seek_result.error();
+	}
+	return { };
+}
+
+Optional<File::Error> WAVFileWriter::append(
+	const std::filesystem::path& filename,
+	size_t sampling_rate_set
+) {
+	sampling_rate = sampling_rate_set;
+	title = "";
+
+	// The header, not the file size: that may be a reservation left by a
+	// power loss.
+	data_t data { 0 };
+	{
+		File reader;
+		const auto open_error = reader.open(filename);
+		if( open_error.is_valid() ) {
+			return open_error;
+		}
+		const auto seek_result = reader.seek(wav_data_offset - sizeof(data));
+		if( seek_result.is_error() ) {
+			return seek_result.error();
+		}
+		const auto read_result = reader.read(&data, sizeof(data));
+		if( read_result.is_error() ) {
+			return read_result.error();
+		}
+	}
+	bytes_written = data.size();
+
+	const auto append_error = file.append(filename);
+	if( append_error.is_valid() ) {
+		return append_error;
+	}
+	const auto seek_result = file.seek(wav_data_offset + bytes_written);
+	if( seek_result.is_error() ) {
+		return seek_result.error();
+	}
+	return file.truncate();
+}
+
+File::Result<File::Size> WAVFileWriter::write(const void* const buffer, const File::Size bytes) {
+	if( ((reinterpret_cast<uintptr_t>(buffer) & 3) == 0) && ((bytes % File::block_size) == 0) && ((bytes_written % File::block_size) == 0) ) {
+		return FileWriter::write_blocks(buffer, bytes);
+	}
+	return FileWriter::write(buffer, bytes);
+}
+
+Optional<File::Error> WAVFileWriter::sync() {
+	const auto header_error = update_header();
+	if( header_error.is_valid() ) {
+		return header_error;
+	}
+	return file.sync();
 }
 
 Optional<File::Error> WAVFileWriter::update_header() {
-	header_t header { sampling_rate, (uint32_t)bytes_written - sizeof(header_t), info_chunk_size };
-	
+	// Only samples go through write(), so bytes_written is the data size.
+	const header_t header { sampling_rate, (uint32_t)bytes_written, info_chunk_size };
+	const data_t data { (uint32_t)bytes_written };
+
 	const auto seek_0_result = file.seek(0);
 	if( seek_0_result.is_error() ) {
 		return seek_0_result.error();
@@ -159,6 +248,16 @@ Optional<File::Error> WAVFileWriter::update_header() {
 	if( write_result.is_error() ) {
 		return write_result.error();
 	}
+
+	const auto seek_data_result = file.seek(wav_data_offset - sizeof(data));
+	if( seek_data_result.is_error() ) {
+		return seek_data_result.error();
+	}
+
+	const auto write_data_result = file.write(&data, sizeof(data));
+	if( write_data_result.is_error() ) {
+		return write_data_result.error();
+	}
 	
 	const auto seek_old_result = file.seek(old_position);
 	if( seek_old_result.is_error() ) {
@@ -169,6 +268,10 @@ Optional<File::Error> WAVFileWriter::update_header() {
 }
 
 Optional<File::Error> WAVFileWriter::write_tags() {
+	if( title.empty() ) {
+		return { };
+	}
+
 	tags_t tags { title };
 	
 	const auto write_result = file.write(&tags, sizeof(tags));
@@ -180,3 +283,281 @@ Optional<File::Error> WAVFileWriter::write_tags() {
 	
 	return { };
 }
+
+namespace {
+
+struct SummaryAccumulator {
+	int16_t min { INT16_MAX };
+	int16_t max { INT16_MIN };
+	uint64_t sum_squares { 0 };
+	uint32_t samples { 0 };
+	uint32_t children { 0 };
+
+	void add(const int16_t sample) {
+		min = std::min(min, sample);
+		max = std::max(max, sample);
+		sum_squares += static_cast<int32_t>(sample) * sample;
+		samples++;
+	}
+
+	void merge(const SummaryAccumulator& other) {
+		min = std::min(min, other.min);
+		max = std::max(max, other.max);
+		sum_squares += other.sum_squares;
+		samples += other.samples;
+		children++;
+	}
+
+	/* For merging stored entries, which have lost their sums. */
+	void merge(const WAVSummary::Entry& entry) {
+		min = std::min(min, entry.min);
+		max = std::max(max, entry.max);
+		sum_squares += static_cast<uint32_t>(entry.rms) * entry.rms;
+		samples++;
+	}
+
+	WAVSummary::Entry entry() const {
+		const float mean_square = samples ? (static_cast<float>(sum_squares) / samples) : 0.0f;
+		return { min, max, static_cast<uint16_t>(std::sqrt(mean_square)) };
+	}
+};
+
+} /* namespace */
+
+WAVSummary::Header WAVSummary::layout(const uint32_t sample_count) {
+	Header result { };
+	result.magic = magic;
+	result.sample_count = sample_count;
+	result.block_samples = block_samples;
+	result.level_factor = level_factor;
+
+	uint32_t entries = (sample_count + block_samples - 1) / block_samples;
+	result.level_entries[0] = entries;
+	result.level_count = 1;
+	while( (entries > top_entries_max) && (result.level_count < levels_max) ) {
+		entries = (entries + level_factor - 1) / level_factor;
+		result.level_entries[result.level_count++] = entries;
+	}
+	return result;
+}
+
+uint64_t WAVSummary::level_offset(const size_t level) const {
+	uint64_t offset = sizeof(Header);
+	for(size_t n=0; n<level; n++) {
+		offset += header.level_entries[n] * sizeof(Entry);
+	}
+	return offset;
+}
+
+uint64_t WAVSummary::samples_per_entry(const size_t level) const {
+	uint64_t samples = block_samples;
+	for(size_t n=0; n<level; n++) {
+		samples *= level_factor;
+	}
+	return samples;
+}
+
+Optional<File::Error> WAVSummary::open(const std::filesystem::path& path, WAVFileReader& reader, ProgressFunc progress) {
+	auto summary_path = path;
+	summary_path.replace_extension(u".WVS");
+
+	header = layout(reader.sample_count());
+	const auto expected = header;
+
+	file = std::make_unique<File>();
+	if( !file->open(summary_path).is_valid() ) {
+		const auto read_result = file->read(&header, sizeof(header));
+		if( read_result.is_ok() && (read_result.value() == sizeof(header))
+			&& (memcmp(&header, &expected, sizeof(header)) == 0)
+			&& (file->size() >= level_offset(header.level_count)) ) {
+			return { };
+		}
+	}
+
+	header = expected;
+	file = std::make_unique<File>();
+	const auto build_error = build(summary_path, reader, progress);
+	if( build_error.is_valid() ) {
+		file.reset();
+		return build_error;
+	}
+
+	file = std::make_unique<File>();
+	return file->open(summary_path);
+}
+
+Optional<File::Error> WAVSummary::build(const std::filesystem::path& path, WAVFileReader& reader, ProgressFunc progress) {
+	struct Level {
+		SummaryAccumulator accumulator { };
+		std::array<Entry, 16> pending { };
+		size_t pending_count { 0 };
+		size_t written { 0 };
+	};
+
+	struct Builder {
+		std::array<Level, levels_max> levels { };
+		std::array<int16_t, 1024> samples { };
+	};
+
+	const auto create_error = file->create(path);
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+
+	// Magic goes in last, so an interrupted build isn't taken for a summary.
+	Header incomplete = header;
+	incomplete.magic = 0;
+	const auto header_result = file->write(&incomplete, sizeof(incomplete));
+	if( header_result.is_error() ) {
+		return header_result.error();
+	}
+
+	// Off this thread's stack.
+	auto builder = std::make_unique<Builder>();
+	auto& levels = builder->levels;
+	Optional<File::Error> write_error { };
+
+	auto flush = [this, &levels, &write_error](const size_t level) {
+		auto& l = levels[level];
+		if( l.pending_count && !write_error.is_valid() ) {
+			const auto seek_result = file->seek(level_offset(level) + l.written * sizeof(Entry));
+			const auto write_result = file->write(l.pending.data(), l.pending_count * sizeof(Entry));
+			if( seek_result.is_error() ) {
+				write_error = seek_result.error();
+			} else if( write_result.is_error() ) {
+				write_error = write_result.error();
+			}
+		}
+		l.written += l.pending_count;
+		l.pending_count = 0;
+	};
+
+	// Emits level's entry and carries it up, completing the levels above
+	// as they fill up.
+	std::function<void(const size_t)> complete = [this, &levels, &flush, &complete](const size_t level) {
+		auto& l = levels[level];
+		l.pending[l.pending_count++] = l.accumulator.entry();
+		if( l.pending_count == l.pending.size() ) {
+			flush(level);
+		}
+		if( (level + 1) < header.level_count ) {
+			auto& above = levels[level + 1].accumulator;
+			above.merge(l.accumulator);
+			if( above.children == level_factor ) {
+				complete(level + 1);
+			}
+		}
+		l.accumulator = { };
+	};
+
+	const uint32_t sample_count = header.sample_count;
+	uint32_t samples_done = 0;
+	uint32_t percent_reported = 0;
+	reader.data_seek(0);
+	while( samples_done < sample_count ) {
+		const size_t to_read = std::min<size_t>(builder->samples.size(), sample_count - samples_done);
+		const auto read_result = reader.read(builder->samples.data(), to_read * sizeof(int16_t));
+		if( read_result.is_error() ) {
+			return read_result.error();
+		}
+		const size_t count = read_result.value() / sizeof(int16_t);
+		if( count == 0 ) {
+			break;
+		}
+
+		for(size_t n=0; n<count; n++) {
+			levels[0].accumulator.add(builder->samples[n]);
+			if( levels[0].accumulator.samples == block_samples ) {
+				complete(0);
+			}
+		}
+		samples_done += count;
+
+		const uint32_t percent = static_cast<uint64_t>(samples_done) * 100 / sample_count;
+		if( progress && (percent != percent_reported) ) {
+			percent_reported = percent;
+			progress(percent);
+		}
+	}
+
+	// Partial entries at the end of each level.
+	for(size_t level=0; level<header.level_count; level++) {
+		if( levels[level].accumulator.samples ) {
+			complete(level);
+		}
+	}
+	for(size_t level=0; level<header.level_count; level++) {
+		flush(level);
+	}
+	if( write_error.is_valid() ) {
+		return write_error;
+	}
+
+	const auto seek_result = file->seek(0);
+	if( seek_result.is_error() ) {
+		return seek_result.error();
+	}
+	const auto write_result = file->write(&header, sizeof(header));
+	if( write_result.is_error() ) {
+		return write_result.error();
+	}
+	return file->sync();
+}
+
+bool WAVSummary::render(const uint64_t first, const uint64_t span, const size_t columns, ColumnFunc on_column) {
+	if( !file || !columns || !span ) {
+		return false;
+	}
+
+	const uint64_t samples_per_column = span / columns;
+	if( samples_per_column < block_samples ) {
+		return false;
+	}
+	size_t level = 0;
+	while( ((level + 1) < header.level_count) && (samples_per_entry(level + 1) <= samples_per_column) ) {
+		level++;
+	}
+	const uint64_t entry_samples = samples_per_entry(level);
+
+	const uint64_t entry_first = first / entry_samples;
+	const uint64_t entry_end = std::min<uint64_t>((first + span + entry_samples - 1) / entry_samples, header.level_entries[level]);
+	if( entry_first >= entry_end ) {
+		return false;
+	}
+
+	const auto seek_result = file->seek(level_offset(level) + entry_first * sizeof(Entry));
+	if( seek_result.is_error() ) {
+		return false;
+	}
+
+	// One sequential read of the level; entries go to the column holding
+	// their midpoint.
+	std::array<Entry, 32> entries;
+	SummaryAccumulator accumulator { };
+	size_t column = 0;
+	uint64_t index = entry_first;
+	while( index < entry_end ) {
+		const size_t to_read = std::min<uint64_t>(entries.size(), entry_end - index);
+		const auto read_result = file->read(entries.data(), to_read * sizeof(Entry));
+		if( read_result.is_error() || (read_result.value() != to_read * sizeof(Entry)) ) {
+			return false;
+		}
+
+		for(size_t n=0; n<to_read; n++, index++) {
+			const uint64_t middle = index * entry_samples + entry_samples / 2;
+			const size_t entry_column = (middle <= first) ? 0
+				: std::min<uint64_t>((middle - first) * columns / span, columns - 1);
+			if( (entry_column != column) && accumulator.samples ) {
+				on_column(column, accumulator.entry());
+				accumulator = { };
+			}
+			column = entry_column;
+			accumulator.merge(entries[n]);
+		}
+	}
+	if( accumulator.samples ) {
+		on_column(column, accumulator.entry());
+	}
+
+	return true;
+}
@@ -27,6 +27,10 @@
 #include "file.hpp"
 #include "optional.hpp"
 
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <string.h>
 
 struct fmt_pcm_t {
@@ -55,19 +59,41 @@ struct data_t {
 	{
 	}
 
+	uint32_t size() const {
+		return cksize;
+	}
+
 private:
 	uint8_t ckID[4] { 'd', 'a', 't', 'a' };
 	uint32_t cksize { 0 };
 };
 
+struct junk_t {
+	constexpr junk_t(
+		const uint32_t size
+	) : cksize { size }
+	{
+	}
+
+private:
+	uint8_t ckID[4] { 'J', 'U', 'N', 'K' };
+	uint32_t cksize { 0 };
+};
+
+/* Samples of written WAVs start here, a card sector in, so whole sector
+ * writes of them stay sector aligned. The header is padded out by a JUNK
+ * chunk, with the data chunk's header right before the samples.
+ */
+constexpr uint32_t wav_data_offset = 512;
+
 struct header_t {
 	constexpr header_t(
 		const uint32_t sampling_rate,
 		const uint32_t data_chunk_size,
 		const uint32_t info_chunk_size
-	) : cksize { sizeof(header_t) + data_chunk_size + info_chunk_size - 8 },
+	) : cksize { wav_data_offset + data_chunk_size + info_chunk_size - 8 },
 		fmt { sampling_rate },
-		data { data_chunk_size }
+		junk { wav_data_offset - sizeof(header_t) - sizeof(data_t) }
 	{
 	}
 
@@ -76,7 +102,7 @@ private:
 	uint32_t cksize { 0 };
 	uint8_t wave_id[4] { 'W', 'A', 'V', 'E' };
 	fmt_pcm_t fmt;
-	data_t data;
+	junk_t junk;
 };
 
 struct tags_t {
@@ -158,6 +184,62 @@ private:
 	std::filesystem::path last_path { };
 };
 
+/* Min/max/RMS decimation pyramid of a 16 bit mono WAV, so views of long
+ * files read only the summary level they need instead of seeking for every
+ * pixel. Level 0 entries cover block_samples samples, each level above
+ * level_factor entries of the one below, up to a level of no more than
+ * top_entries_max. Built in a single pass over the samples and cached next
+ * to the WAV as a .WVS file, rebuilt if that doesn't match the WAV.
+ */
+class WAVSummary {
+public:
+	struct Entry {
+		int16_t min;
+		int16_t max;
+		uint16_t rms;
+	};
+
+	static constexpr size_t block_samples = 256;
+	static constexpr size_t level_factor = 4;
+	static constexpr size_t top_entries_max = 256;
+	static constexpr size_t levels_max = 12;
+
+	using ProgressFunc = std::function<void(const uint32_t percent)>;
+	using ColumnFunc = std::function<void(const size_t column, const Entry& entry)>;
+
+	/* Loads the summary of the WAV at path, or builds it with reader (which
+	 * is left at an arbitrary position).
+	 */
+	Optional<File::Error> open(const std::filesystem::path& path, WAVFileReader& reader, ProgressFunc progress = nullptr);
+
+	/* Splits samples [first, first + span) in columns equal slices and
+	 * reports each slice's merged entries, from the coarsest level still
+	 * finer than a slice. Returns false when slices are smaller than a
+	 * level 0 entry: read the samples instead.
+	 */
+	bool render(const uint64_t first, const uint64_t span, const size_t columns, ColumnFunc on_column);
+
+private:
+	struct Header {
+		uint32_t magic;
+		uint32_t sample_count;
+		uint32_t block_samples;
+		uint32_t level_factor;
+		uint32_t level_count;
+		uint32_t level_entries[levels_max];
+	};
+
+	static constexpr uint32_t magic = 0x31535657;		// "WVS1"
+
+	std::unique_ptr<File> file { };
+	Header header { };
+
+	static Header layout(const uint32_t sample_count);
+	uint64_t level_offset(const size_t level) const;
+	uint64_t samples_per_entry(const size_t level) const;
+	Optional<File::Error> build(const std::filesystem::path& path, WAVFileReader& reader, ProgressFunc progress);
+};
+
 class WAVFileWriter : public FileWriter {
 public:
 	WAVFileWriter() = default;
@@ -170,14 +252,38 @@ public:
 	~WAVFileWriter() {
 		write_tags();
 		update_header();
+		// Trims a reservation.
+		file.truncate();
 	}
 
+	/* With reserve, that many bytes are preallocated in one contiguous run,
+	 * so writes within it don't touch the FAT or directory entry.
+	 */
 	Optional<File::Error> create(
 		const std::filesystem::path& filename,
 		size_t sampling_rate,
-		const std::string& title_set
+		const std::string& title_set,
+		const File::Size reserve = 0
+	);
+
+	/* Continues an untitled file of ours after its last synced sample. */
+	Optional<File::Error> append(
+		const std::filesystem::path& filename,
+		size_t sampling_rate
 	);
 
+	File::Size data_size() const {
+		return bytes_written;
+	}
+
+	/* Sector multiples go out with File::write_blocks(). */
+	File::Result<File::Size> write(const void* const buffer, const File::Size bytes) override;
+
+	/* Rewrites the header for the samples so far and syncs, so the file
+	 * plays up to here after a power loss.
+	 */
+	Optional<File::Error> sync() override;
+
 private:
 	uint32_t sampling_rate { 0 };
 	uint32_t info_chunk_size { 0 };
@@ -70,6 +70,30 @@ static std::array<portapack::IO::TouchPinsConfig, 3> touch_pins_configs {
 static touch::Frame temp_frame;
 static touch::Frame touch_frame;
 
+static touch::Manager touch_manager;
+
+/* Written by timer0_callback, read by the event loop under chSysLock. */
+static std::array<ui::TouchEvent, 4> touch_events;
+static size_t touch_events_read { 0 };
+static size_t touch_events_write { 0 };
+
+static void touch_event_push(const ui::TouchEvent event) {
+	const auto pending = touch_events_write - touch_events_read;
+	if( pending > 0 ) {
+		auto& last = touch_events[(touch_events_write - 1) % touch_events.size()];
+		if( (last.type == ui::TouchEvent::Type::Move) && (event.type == ui::TouchEvent::Type::Move) ) {
+			last.point = event.point;
+			return;
+		}
+	}
+	if( pending >= touch_events.size() ) {
+		// Lose the oldest, the event loop is far behind anyway.
+		touch_events_read++;
+	}
+	touch_events[touch_events_write % touch_events.size()] = event;
+	touch_events_write++;
+}
+
 static uint32_t touch_debounce = 0;
 static uint32_t touch_debounce_mask = (1U << 4) - 1;
 static bool touch_detected = false;
@@ -148,7 +172,11 @@ static bool encoder_read() {
 
 void timer0_callback(GPTDriver* const) {
 	eventmask_t event_mask = 0;
-	if( touch_update() ) event_mask |= EVT_MASK_TOUCH;
+	if( touch_update() ) {
+		const auto touch_events_before = touch_events_write;
+		touch_manager.feed(touch_frame);
+		if( touch_events_write != touch_events_before ) event_mask |= EVT_MASK_TOUCH;
+	}
 	const auto switches_raw = portapack::io.io_update(touch_pins_configs[touch_phase]);
 	if( switches_update(switches_raw) ) {
 		event_mask |= EVT_MASK_SWITCHES;
@@ -180,6 +208,8 @@ static GPTConfig timer0_config {
 void controls_init() {
 	thread_controls_event = chThdSelf();
 
+	touch_manager.on_event = touch_event_push;
+
 	touch::adc::start();
 
 	/* GPT timer 0 is used to scan user interface controls -- touch screen,
@@ -206,3 +236,14 @@ EncoderPosition get_encoder_position() {
 touch::Frame get_touch_frame() {
 	return touch_frame;
 }
+
+bool get_touch_event(ui::TouchEvent& event) {
+	chSysLock();
+	const bool available = (touch_events_read != touch_events_write);
+	if( available ) {
+		event = touch_events[touch_events_read % touch_events.size()];
+		touch_events_read++;
+	}
+	chSysUnlock();
+	return available;
+}
@@ -44,4 +44,11 @@ SwitchesState get_switches_state();
 EncoderPosition get_encoder_position();
 touch::Frame get_touch_frame();
 
+/* Touches are filtered in the scan interrupt, which only signals
+ * EVT_MASK_TOUCH when there's an event to take. Moves coalesce, so a busy
+ * event loop sees the latest point rather than a backlog. Returns false
+ * once none are left.
+ */
+bool get_touch_event(ui::TouchEvent& event);
+
 #endif/*__IRQ_CONTROLS_H__*/
@@ -29,6 +29,7 @@
 #include "portapack_hal.hpp"
 
 static Thread* thread_lcd_frame_event = NULL;
+static volatile halrtcnt_t frame_sync_time = 0;
 
 static void pin_int4_interrupt_enable() {
 	thread_lcd_frame_event = chThdSelf();
@@ -51,11 +52,27 @@ void lcd_frame_sync_configure() {
 	pin_int4_interrupt_enable();
 }
 
+void lcd_frame_sync_enable() {
+	// Drop an edge latched while disabled, it's long stale.
+	LPC_GPIO_INT->IST = (1U << 4);
+	nvicEnableVector(PIN_INT4_IRQn, CORTEX_PRIORITY_MASK(LPC43XX_PIN_INT4_IRQ_PRIORITY));
+}
+
+void lcd_frame_sync_disable() {
+	nvicDisableVector(PIN_INT4_IRQn);
+}
+
+uint32_t lcd_frame_sync_time() {
+	return frame_sync_time;
+}
+
 extern "C" {
 
 CH_IRQ_HANDLER(PIN_INT4_IRQHandler) {
 	CH_IRQ_PROLOGUE();
 
+	frame_sync_time = halGetCounterValue();
+
 	chSysLockFromIsr();
 	chEvtSignalI(thread_lcd_frame_event, EVT_MASK_LCD_FRAME_SYNC);
 	chSysUnlockFromIsr();
@@ -22,6 +22,19 @@
 #ifndef __IRQ_LCD_FRAME_H__
 #define __IRQ_LCD_FRAME_H__
 
+#include <cstdint>
+
 void lcd_frame_sync_configure();
 
+/* Display sleep has nothing to repaint, so frame interrupts only cost
+ * wakeups until the display is back.
+ */
+void lcd_frame_sync_enable();
+void lcd_frame_sync_disable();
+
+/* halGetCounterValue() at the latest frame sync (TE) edge, the start of the
+ * display's scan out.
+ */
+uint32_t lcd_frame_sync_time();
+
 #endif/*__IRQ_LCD_FRAME_H__*/
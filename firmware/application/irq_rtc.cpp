@@ -27,6 +27,7 @@
 using namespace lpc43xx;
 
 #include "event_m0.hpp"
+#include "sample_clock.hpp"
 
 static Thread* thread_rtc_event = NULL;
 
@@ -41,6 +42,8 @@ extern "C" {
 CH_IRQ_HANDLER(RTC_IRQHandler) {
 	CH_IRQ_PROLOGUE();
 
+	sample_clock::capture();
+
 	chSysLockFromIsr();
 	chEvtSignalI(thread_rtc_event, EVT_MASK_RTC_TICK);
 	chSysUnlockFromIsr();
@@ -22,16 +22,141 @@
 #include "log_file.hpp"
 
 #include "string_format.hpp"
+#include "portapack_persistent_memory.hpp"
+#include "remote_control.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+LogFile::LogFile(
+	const size_t queue_k
+) : queue_data { std::make_unique<uint8_t[]>(1 << queue_k) },
+	queue { queue_data.get(), queue_k }
+{
+}
+
+LogFile::~LogFile() {
+	if( thread ) {
+		// The thread commits what's left before it exits.
+		chThdTerminate(thread);
+		chThdWait(thread);
+		thread = nullptr;
+	}
+}
+
+Optional<File::Error> LogFile::append(const std::filesystem::path& filename) {
+	const auto error = file.append(filename);
+	if( !error.is_valid() && !thread ) {
+		// Need significant stack for FATFS
+		thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO - 10, LogFile::static_fn, this);
+	}
+	return error;
+}
+
+Optional<File::Error> LogFile::append_packets(const std::filesystem::path& filename) {
+	binary = portapack::persistent_memory::config_binary_logs();
+	if( binary ) {
+		return append(std::filesystem::path { filename }.replace_extension(u".BIN"));
+	} else {
+		return append(filename);
+	}
+}
+
+Optional<File::Error> LogFile::append_records(const std::filesystem::path& filename) {
+	binary = true;
+	return append(filename);
+}
 
 Optional<File::Error> LogFile::write_entry(const rtc::RTC& datetime, const std::string& entry) {
-	std::string timestamp = to_string_timestamp(datetime);
-	return write_line(timestamp + " " + entry);
+	if( thread && !binary ) {
+		auto line = to_string_timestamp(datetime) + " " + entry;
+		line.resize(std::min(line.size(), static_cast<size_t>(line_length_max)));
+		line += "\r\n";
+		if( !queue.in_r(line.data(), line.size()) ) {
+			dropped_++;
+		}
+	}
+	return { };
+}
+
+LogRecordHeader LogFile::record_header(const rtc::RTC& datetime, const LogRecordType type, const uint32_t tag, const size_t bits) {
+	const uint32_t packed =
+		  ((datetime.year() - 2000) << 26)
+		| (datetime.month() << 22)
+		| (datetime.day() << 17)
+		| (datetime.hour() << 12)
+		| (datetime.minute() << 6)
+		| datetime.second();
+	return { log_record_sync, static_cast<uint8_t>(type), static_cast<uint16_t>(bits), packed, tag };
 }
 
-Optional<File::Error> LogFile::write_line(const std::string& message) {
-	auto error = file.write_line(message);
-	if( !error.is_valid() ) {
+Optional<File::Error> LogFile::write_record(const rtc::RTC& datetime, const LogRecordType type, const uint32_t tag, const baseband::Packet& packet) {
+	if( binary ) {
+		std::array<uint8_t, record_length_max> record { };
+		const auto header = record_header(datetime, type, tag, packet.size());
+		memcpy(record.data(), &header, sizeof(header));
+
+		auto payload = &record[sizeof(header)];
+		for(size_t i=0; i<packet.size(); i+=8) {
+			payload[i >> 3] = packet.read(i, 8);
+		}
+		const size_t length = sizeof(header) + (packet.size() + 7) / 8;
+		RemoteControl::forward_record(record.data(), length);
+		if( thread && !queue.in_r(record.data(), length) ) {
+			dropped_++;
+		}
+	}
+	return { };
+}
+
+Optional<File::Error> LogFile::write_record(const rtc::RTC& datetime, const LogRecordType type, const uint32_t tag, const uint8_t* const data, const size_t bits) {
+	if( binary ) {
+		std::array<uint8_t, record_length_max> record { };
+		const size_t length = std::min((bits + 7) / 8, record.size() - sizeof(LogRecordHeader));
+		const auto header = record_header(datetime, type, tag, std::min(bits, length * 8));
+		memcpy(record.data(), &header, sizeof(header));
+		memcpy(&record[sizeof(header)], data, length);
+		RemoteControl::forward_record(record.data(), sizeof(header) + length);
+		if( thread && !queue.in_r(record.data(), sizeof(header) + length) ) {
+			dropped_++;
+		}
+	}
+	return { };
+}
+
+msg_t LogFile::static_fn(void* arg) {
+	chRegSetThreadName("log");
+	auto obj = static_cast<LogFile*>(arg);
+	obj->run();
+	return 0;
+}
+
+void LogFile::run() {
+	while( !chThdShouldTerminate() ) {
+		chThdSleepMilliseconds(commit_interval_ms);
+		commit();
+	}
+	commit();
+}
+
+void LogFile::commit() {
+	if( queue.is_empty() ) {
+		return;
+	}
+
+	// Pack entries into write_buffer, writing whenever the next might not fit.
+	size_t used = 0;
+	while( !queue.is_empty() ) {
+		if( (write_buffer.size() - used) < record_length_max ) {
+			if( file.write(write_buffer.data(), used).is_error() ) {
+				return;
+			}
+			used = 0;
+		}
+		used += queue.out_r(&write_buffer[used], record_length_max);
+	}
+
+	if( !file.write(write_buffer.data(), used).is_error() ) {
 		file.sync();
 	}
-	return error;
 }
@@ -22,25 +22,100 @@
 #ifndef __LOG_FILE_H__
 #define __LOG_FILE_H__
 
+#include <array>
 #include <string>
+#include <memory>
+
+#include "ch.h"
 
 #include "file.hpp"
+#include "fifo.hpp"
+#include "baseband_packet.hpp"
 
 #include "lpc43xx_cpp.hpp"
 using namespace lpc43xx;
 
+enum class LogRecordType : uint8_t {
+	AIS = 1,
+	ERT = 2,
+	TPMS = 3,
+	ADSB = 4,
+	Spectrum = 5,	// SpectrumLog rows, see spectrum_log.hpp
+};
+
+constexpr uint8_t log_record_sync = 0xa5;
+
+/* A binary log is a sequence of these, little-endian, each followed by
+ * (bits + 7) / 8 bytes holding the packet's bits, first bit in the MSB.
+ * tools/decode_log.py turns one back into CSV or JSON.
+ */
+struct LogRecordHeader {
+	uint8_t sync;
+	uint8_t type;
+	uint16_t bits;
+	/* Years since 2000, month, day, hour, minute, second in 6, 4, 5, 5, 6
+	 * and 6 bits, MSB first. */
+	uint32_t datetime;
+	/* TPMS: signal type << 24 | tuning frequency in kHz. Otherwise zero. */
+	uint32_t tag;
+};
+
+static_assert(sizeof(LogRecordHeader) == 12, "LogRecordHeader must be packed");
+
+/* Entries are queued and written by a background thread, a batch at a time
+ * with one sync per batch, so the SD card never stalls the caller. If the
+ * queue fills up faster than the card takes it, entries are dropped.
+ */
 class LogFile {
 public:
-	Optional<File::Error> append(const std::filesystem::path& filename) {
-		return file.append(filename);
-	}
+	/* Queue of 2^queue_k bytes, 2KiB suits a decoder's packets. */
+	explicit LogFile(const size_t queue_k = 11);
+	LogFile(const LogFile&) = delete;
+	LogFile& operator=(const LogFile&) = delete;
+	~LogFile();
 
+	Optional<File::Error> append(const std::filesystem::path& filename);
+
+	/* For decoders that can log raw packets: with the binary logs setting on,
+	 * opens filename with a .BIN extension for write_record() instead.
+	 */
+	Optional<File::Error> append_packets(const std::filesystem::path& filename);
+
+	/* Binary regardless of the setting, for logs that only have records. */
+	Optional<File::Error> append_records(const std::filesystem::path& filename);
+
+	bool is_binary() const { return binary; }
+
+	/* Entries and records that didn't fit in the queue, since opening. */
+	uint32_t dropped() const { return dropped_; }
+
+	/* Write errors happen later, on the writer thread, and aren't reported.
+	 * Text entries are ignored by a binary log, and records by a text log.
+	 * Records are copied to RemoteControl too, with or without an SD card.
+	 */
 	Optional<File::Error> write_entry(const rtc::RTC& datetime, const std::string& entry);
+	Optional<File::Error> write_record(const rtc::RTC& datetime, const LogRecordType type, const uint32_t tag, const baseband::Packet& packet);
+	Optional<File::Error> write_record(const rtc::RTC& datetime, const LogRecordType type, const uint32_t tag, const uint8_t* const data, const size_t bits);
 
 private:
+	static constexpr uint32_t commit_interval_ms = 250;
+	static constexpr size_t line_length_max = 254;
+	static constexpr size_t record_length_max = sizeof(LogRecordHeader) + 2560 / 8;
+
 	File file { };
+	bool binary { false };
+	uint32_t dropped_ { 0 };
+
+	std::unique_ptr<uint8_t[]> queue_data;
+	FIFO<uint8_t> queue;
+	std::array<uint8_t, 512> write_buffer { };
+
+	Thread* thread { nullptr };
 
-	Optional<File::Error> write_line(const std::string& message);
+	static msg_t static_fn(void* arg);
+	void run();
+	static LogRecordHeader record_header(const rtc::RTC& datetime, const LogRecordType type, const uint32_t tag, const size_t bits);
+	void commit();
 };
 
 #endif/*__LOG_FILE_H__*/
@@ -126,6 +126,7 @@ Continuous (Fox-oring)
 #include "irq_rtc.hpp"
 
 #include "event_m0.hpp"
+#include "boot_timeline.hpp"
 
 #include "core_control.hpp"
 #include "spi_image.hpp"
@@ -153,13 +154,23 @@ static void event_loop() {
 			event_dispatcher.set_display_sleep(true);
 		}
 	};
+	// Here rather than in each decoder: ReceiverModel ignores it unless
+	// an app has turned gain control on.
+	MessageHandlerRegistration message_handler_gain_step {
+		Message::ID::RxGainStep,
+		[](const Message* const p) {
+			portapack::receiver_model.on_gain_step(reinterpret_cast<const RxGainStepMessage*>(p)->direction);
+		}
+	};
 
+	boot_timeline::mark(boot_timeline::Mark::UI);
 	event_dispatcher.run();
 }
 
 int main(void) {
 	if( portapack::init() ) {
 		portapack::display.init();
+		boot_timeline::mark(boot_timeline::Mark::Display);
 
 		sdcStart(&SDCD1, nullptr);
 
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "offline_decoder.hpp"
+
+#include "capture_info.hpp"
+#include "io_file.hpp"
+#include "string_format.hpp"
+
+#include "ui_fileman.hpp"
+
+#include <utility>
+#include <vector>
+
+bool OfflineDecoder::start(const std::filesystem::path& path, const uint32_t sampling_rate, std::string& error) {
+	stop();
+
+	CaptureInfo info;
+	if( !read_capture_info(path, info) ) {
+		error = "File read error.";
+		return false;
+	}
+	if( info.sample_rate != sampling_rate ) {
+		error = "Recorded at " + unit_auto_scale(info.sample_rate, 3, 1) + "Hz,\nthis decodes at\n" + unit_auto_scale(sampling_rate, 3, 1) + "Hz.";
+		return false;
+	}
+
+	const size_t sample_size = (info.format == ReplayConfig::Format::C8) ? sizeof(complex8_t) : sizeof(complex16_t);
+	std::vector<std::filesystem::path> items { path };
+	auto reader = std::make_unique<PlaylistReader>(std::move(items), sample_size, false);
+
+	size = info.size;
+	thread = std::make_unique<ReplayThread>(
+		std::move(reader),
+		read_size, buffer_count,
+		[](uint32_t return_code) {
+			ReplayThreadDoneMessage message { return_code };
+			EventDispatcher::send_message(message);
+		},
+		info.format,
+		ReplayThread::Sink::Decode
+	);
+	return true;
+}
+
+void OfflineDecoder::stop() {
+	thread.reset();
+}
+
+void OfflineDecoder::on_thread_done(const uint32_t return_code) {
+	// stop() itself ends in TERMINATED, nothing to report.
+	if( !thread || (return_code == ReplayThread::TERMINATED) ) {
+		return;
+	}
+
+	const bool ok = (return_code == ReplayThread::END_OF_FILE);
+	if( ok ) {
+		// The file's all read, the last few buffers are still going through
+		// the M4, a few milliseconds at most.
+		for(size_t i=0; (i < 100) && (thread->state().baseband_bytes_received < size); i++) {
+			chThdSleepMilliseconds(1);
+		}
+	}
+
+	stop();
+	if( on_done ) {
+		on_done(ok);
+	}
+}
+
+namespace ui {
+
+OfflineDecodeButton::OfflineDecodeButton(
+	NavigationView& nav,
+	const Rect parent_rect,
+	const uint32_t sampling_rate
+) : Button { parent_rect, "SD" },
+	nav { nav },
+	sampling_rate { sampling_rate }
+{
+	on_select = [this](Button&) {
+		if( decoder.is_active() ) {
+			decoder.stop();
+			update_text();
+			return;
+		}
+
+		auto open_view = this->nav.push<FileLoadView>(".C16|.C8|.RIQ");
+		open_view->on_changed = [this](std::filesystem::path path) {
+			on_file(path);
+		};
+	};
+
+	decoder.on_done = [this](bool ok) {
+		update_text();
+		if( !ok ) {
+			this->nav.display_modal("Error", "File read error.");
+		}
+	};
+}
+
+void OfflineDecodeButton::on_file(const std::filesystem::path& path) {
+	std::string error;
+	if( !decoder.start(path, sampling_rate, error) ) {
+		nav.display_modal("Error", error);
+	}
+	update_text();
+}
+
+void OfflineDecodeButton::update_text() {
+	set_text(decoder.is_active() ? "Stp" : "SD");
+}
+
+} /* namespace ui */
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __OFFLINE_DECODER_H__
+#define __OFFLINE_DECODER_H__
+
+#include "ui_widget.hpp"
+#include "ui_navigation.hpp"
+
+#include "replay_thread.hpp"
+#include "event_m0.hpp"
+#include "file.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+/* Runs a capture from the SD card through the open app's receive
+ * processor instead of the radio, as fast as the M4 gets through it (see
+ * BasebandThread::set_file_source()), so packets come out as they would
+ * have live. The capture must be at the processor's sampling rate and
+ * recorded at the app's tuning: a C8 capture at full rate, typically.
+ * The radio stays configured; the processor goes back to it after.
+ */
+class OfflineDecoder {
+public:
+	/* On the event loop, once the file has gone through (true) or failed
+	 * to read (false). The decoder has stopped by then.
+	 */
+	std::function<void(bool ok)> on_done { };
+
+	/* False, with the reason in error, if the capture can't be used. */
+	bool start(const std::filesystem::path& path, const uint32_t sampling_rate, std::string& error);
+	void stop();
+
+	bool is_active() const {
+		return (bool)thread;
+	}
+
+private:
+	static constexpr size_t read_size = 4096;
+	static constexpr size_t buffer_count = 4;
+
+	std::unique_ptr<ReplayThread> thread { };
+	uint64_t size { 0 };
+
+	MessageHandlerRegistration message_handler_done {
+		Message::ID::ReplayThreadDone,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const ReplayThreadDoneMessage*>(p);
+			this->on_thread_done(message.return_code);
+		}
+	};
+
+	void on_thread_done(const uint32_t return_code);
+};
+
+namespace ui {
+
+/* "SD" in a receiver's header: picks a capture and decodes it with
+ * OfflineDecoder, or stops one that's going.
+ */
+class OfflineDecodeButton : public Button {
+public:
+	OfflineDecodeButton(
+		NavigationView& nav,
+		const Rect parent_rect,
+		const uint32_t sampling_rate
+	);
+
+private:
+	NavigationView& nav;
+	const uint32_t sampling_rate;
+	OfflineDecoder decoder { };
+
+	void on_file(const std::filesystem::path& path);
+	void update_text();
+};
+
+} /* namespace ui */
+
+#endif/*__OFFLINE_DECODER_H__*/
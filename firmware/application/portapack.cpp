@@ -24,6 +24,7 @@
 #include "portapack_dma.hpp"
 #include "portapack_cpld_data.hpp"
 #include "portapack_persistent_memory.hpp"
+#include "boot_timeline.hpp"
 
 #include "hackrf_hal.hpp"
 #include "hackrf_gpio.hpp"
@@ -256,6 +257,8 @@ static void shutdown_base() {
 }
 
 bool init() {
+	boot_timeline::mark(boot_timeline::Mark::Init);
+
 	for(const auto& pin : pins) {
 		pin.init();
 	}
@@ -299,6 +302,7 @@ bool init() {
 	clock_manager.init(false);
 	clock_manager.set_reference_ppb(persistent_memory::correction_ppb());
 	clock_manager.run_at_full_speed();
+	boot_timeline::mark(boot_timeline::Mark::Clocks);
 
 	if( !portapack::cpld::update_if_necessary(portapack_cpld_config()) ) {
 		shutdown_base();
@@ -310,13 +314,19 @@ bool init() {
 	}
 
 	portapack::io.init();
+	boot_timeline::mark(boot_timeline::Mark::CPLD);
+
+	// The LCD settles while the codec and radio come up.
+	display.reset_start();
 
 	audio::init(portapack_audio_codec());
+	boot_timeline::mark(boot_timeline::Mark::Audio);
 	
 	clock_manager.enable_first_if_clock();
 	clock_manager.enable_second_if_clock();
 	clock_manager.enable_codec_clocks();
 	radio::init();
+	boot_timeline::mark(boot_timeline::Mark::Radio);
 
 	touch::adc::init();
 
@@ -45,4 +45,95 @@ void make_aprs_frame(const char * src_address, const uint32_t src_ssid,
 	frame.make_ui_frame(address, 0x03, protocol_id_t::NO_LAYER3, payload);
 }
 
+// Digits, or spaces for position ambiguity
+static bool decode_digits(const char * p, const size_t count, uint32_t& value) {
+	value = 0;
+	for (size_t i = 0; i < count; i++) {
+		value *= 10;
+		if ((p[i] >= '0') && (p[i] <= '9'))
+			value += p[i] - '0';
+		else if (p[i] != ' ')
+			return false;
+	}
+	return true;
+}
+
+// DDMM.mmH for latitude, DDDMM.mmH for longitude
+static bool decode_coordinate(const char * p, const size_t degree_digits, const char positive, const char negative, float& value) {
+	uint32_t degrees, minutes, hundredths;
+	
+	if (!decode_digits(p, degree_digits, degrees) ||
+		!decode_digits(p + degree_digits, 2, minutes) ||
+		(p[degree_digits + 2] != '.') ||
+		!decode_digits(p + degree_digits + 3, 2, hundredths) ||
+		(minutes >= 60))
+		return false;
+	
+	value = degrees + (minutes + hundredths / 100.0f) / 60.0f;
+	
+	if (p[degree_digits + 5] == negative)
+		value = -value;
+	else if (p[degree_digits + 5] != positive)
+		return false;
+	
+	return true;
+}
+
+static bool decode_base91(const char * p, uint32_t& value) {
+	value = 0;
+	for (size_t i = 0; i < 4; i++) {
+		if ((p[i] < '!') || (p[i] > '{'))
+			return false;
+		value = value * 91 + (p[i] - '!');
+	}
+	return true;
+}
+
+bool decode_position(const std::string& info, aprs_position& position) {
+	size_t start;
+	
+	if (info.empty())
+		return false;
+	
+	// Timestamped reports have 7 characters of time first
+	if ((info[0] == '!') || (info[0] == '='))
+		start = 1;
+	else if ((info[0] == '/') || (info[0] == '@'))
+		start = 8;
+	else
+		return false;
+	
+	if (info.length() < start + 13)
+		return false;
+	
+	const char * p = &info[start];
+	
+	if ((p[0] >= '0') && (p[0] <= '9')) {
+		// Uncompressed: latitude, symbol table, longitude, symbol
+		if (info.length() < start + 19)
+			return false;
+		
+		if (!decode_coordinate(&p[0], 2, 'N', 'S', position.latitude) ||
+			!decode_coordinate(&p[9], 3, 'E', 'W', position.longitude))
+			return false;
+		
+		position.symbol_table = p[8];
+		position.symbol = p[18];
+	} else {
+		// Compressed: symbol table, base 91 latitude and longitude, symbol
+		uint32_t y, x;
+		
+		if (!decode_base91(&p[1], y) || !decode_base91(&p[5], x))
+			return false;
+		
+		position.latitude = 90.0f - y / 380926.0f;
+		position.longitude = -180.0f + x / 190463.0f;
+		position.symbol_table = p[0];
+		position.symbol = p[9];
+	}
+	
+	return (position.latitude >= -90.0f) && (position.latitude <= 90.0f) &&
+		(position.longitude >= -180.0f) && (position.longitude <= 180.0f);
+}
+
 } /* namespace aprs */
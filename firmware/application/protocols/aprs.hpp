@@ -28,10 +28,21 @@
 
 namespace aprs {
 
+	struct aprs_position {
+		float latitude;
+		float longitude;
+		char symbol_table;
+		char symbol;
+	};
+
 	void make_aprs_frame(
 		const char * src_address, const uint32_t src_ssid,
 		const char * dest_address, const uint32_t dest_ssid,
 		const std::string& payload);
+	
+	// Position reports ('!', '=', '/' and '@'), plain or compressed.
+	// Returns false for anything else, or a malformed position.
+	bool decode_position(const std::string& info, aprs_position& position);
 
 } /* namespace aprs */
 
@@ -55,6 +55,29 @@ size_t make_bitstream(std::string& fragments) {
 	return bitstream_length;
 }
 
+size_t make_runs(const std::string& fragments) {
+	uint8_t * runs = shared_memory.bb_data.data;
+	const size_t runs_max = sizeof(shared_memory.bb_data.data);
+	const size_t fragments_length = fragments.length();
+	size_t run_count = 0;
+	size_t i = 0;
+	
+	while (i < fragments_length) {
+		const bool level = (fragments[i] != '0');
+		size_t length = 1;
+		while ((i + length < fragments_length) && (length < 128) && ((fragments[i + length] != '0') == level))
+			length++;
+		
+		if (run_count == runs_max)
+			return 0;
+		
+		runs[run_count++] = (level ? 0x80 : 0x00) | (length - 1);
+		i += length;
+	}
+	
+	return run_count;
+}
+
 void bitstream_append(size_t& bitstream_length, uint32_t bit_count, uint32_t bits) {
 	uint8_t * bitstream = shared_memory.bb_data.data;
 	uint32_t bit_mask = 1 << (bit_count - 1);
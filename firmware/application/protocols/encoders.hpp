@@ -35,6 +35,11 @@ namespace encoders {
 	#define ENCODER_UM3750	8
 	
 	size_t make_bitstream(std::string& fragments);
+	/* fragments as runs of one level, for set_ook_runs(): a byte each in
+	 * bb_data, the level in bit 7 and the length less one below. Returns
+	 * the run count, 0 if they don't fit.
+	 */
+	size_t make_runs(const std::string& fragments);
 	void bitstream_append(size_t& bitstream_length, uint32_t bit_count, uint32_t bits);
 
 	struct encoder_def_t {
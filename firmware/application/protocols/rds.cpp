@@ -24,6 +24,9 @@
 
 #include "portapack_shared_memory.hpp"
 
+#include <utility>
+#include <algorithm>
+
 // RDS infos:
 // One frame = X groups (as necessary)
 // One group = 4 blocks = 4 * 26 bits
@@ -32,17 +35,34 @@
 
 namespace rds {
 
+namespace {
+
+// Checkword of 16 data bits, one at a time, g(x) = x^10+x^8+x^7+x^5+x^4+x^3+1
+constexpr uint16_t checkword_bitwise(const uint32_t data) {
+	uint16_t CRC = 0;
+	for (size_t i = 0; i < 16; i++) {
+		const uint16_t bit = (((data << i) & 0x8000) >> 15) ^ (CRC >> 9);
+		if (bit) CRC ^= 0b0011011100;
+		CRC = ((CRC << 1) | bit) & 0x3FF;
+	}
+	return CRC;
+}
+
+template<size_t... I>
+constexpr std::array<uint16_t, 256> make_checkword_table(const size_t shift, std::index_sequence<I...>) {
+	return { { checkword_bitwise(I << shift)... } };
+}
+
+// Checkwords of the high data byte, and of the low
+constexpr std::array<uint16_t, 256> checkword_high = make_checkword_table(8, std::make_index_sequence<256>());
+constexpr std::array<uint16_t, 256> checkword_low = make_checkword_table(0, std::make_index_sequence<256>());
+
+} /* namespace */
+
 uint32_t make_block(uint32_t data, uint16_t offset) {
-    uint16_t CRC = 0;
-    uint8_t bit;
-    
-    for (uint8_t i = 0; i < 16; i++) {
-        bit = (((data << i) & 0x8000) >> 15) ^ (CRC >> 9);
-        if (bit) CRC ^= 0b0011011100;
-        CRC = ((CRC << 1) | bit) & 0x3FF;
-    }
-    
-    return (data << 10) | (CRC ^ offset);
+	data &= 0xFFFF;
+	const uint16_t CRC = checkword_high[data >> 8] ^ checkword_low[data & 0xFF];
+	return (data << 10) | (CRC ^ offset);
 }
 
 // Boolean to binary
@@ -55,7 +75,7 @@ uint8_t b2b(const bool in) {
 
 // Type 0B groups are like 0A groups but without alternative frequency data
 RDSGroup make_0B_group(const uint16_t PI_code, const bool TP, const uint8_t PTY, const bool TA,
-							const bool MS, const bool DI, const uint8_t C, const std::string chars) {
+							const bool MS, const bool DI, const uint8_t C, const char* const chars) {
 	RDSGroup group;
 	
 	group.block[0] = PI_code;
@@ -68,7 +88,7 @@ RDSGroup make_0B_group(const uint16_t PI_code, const bool TP, const uint8_t PTY,
 
 // For RadioText, up to 64 chars with 2A, 32 chars with 2B
 RDSGroup make_2A_group(const uint16_t PI_code, const bool TP, const uint8_t PTY, const bool AB,
-							const uint8_t segment, const std::string chars) {
+							const uint8_t segment, const char* const chars) {
 	RDSGroup group;
 	
 	group.block[0] = PI_code;
@@ -99,51 +119,58 @@ RDSGroup make_4A_group(const uint16_t PI_code, const bool TP, const uint8_t PTY,
 	return group;
 }
 
-void gen_PSN(std::vector<RDSGroup>& frame, const std::string& psname, const RDS_flags * rds_flags) {
+void gen_PSN(RDSFrame& frame, const std::string& psname, const RDS_flags * rds_flags) {
 	uint8_t c;
 	RDSGroup group;
+	// Space padded to the 8 characters
+	char chars[8];
+	
+	for (c = 0; c < 8; c++)
+		chars[c] = (c < psname.length()) ? psname[c] : ' ';
 	
 	frame.clear();
 	
 	// 4 groups with 2 PSN characters in each
 	for (c = 0; c < 4; c++) {
-		group = make_0B_group(rds_flags->PI_code, rds_flags->TP, rds_flags->PTY, rds_flags->TA, rds_flags->MS, rds_flags->DI, c, psname.substr(c * 2, 2));
+		group = make_0B_group(rds_flags->PI_code, rds_flags->TP, rds_flags->PTY, rds_flags->TA, rds_flags->MS, rds_flags->DI, c, &chars[c * 2]);
 		group.block[0] = make_block(group.block[0], RDS_OFFSET_A);
 		group.block[1] = make_block(group.block[1], RDS_OFFSET_B);
 		group.block[2] = make_block(group.block[2], RDS_OFFSET_Cp);	// C' !
 		group.block[3] = make_block(group.block[3], RDS_OFFSET_D);
-		frame.emplace_back(group);
+		frame.push_back(group);
 	}
 }
 
-void gen_RadioText(std::vector<RDSGroup>& frame, const std::string& text, const bool AB, const RDS_flags * rds_flags) {
+void gen_RadioText(RDSFrame& frame, const std::string& text, const bool AB, const RDS_flags * rds_flags) {
+	constexpr size_t rt_length_max = RDSFrame::groups_max * 4;
 	size_t c;
-	//RDSGroup * groups_ptr;
-	std::string radiotext_buffer = text;
+	// Up to 64 characters, a CR after shorter ones, space padded to a segment
+	char radiotext_buffer[rt_length_max];
 	size_t rt_length, group_count;
 	RDSGroup group;
 
-	radiotext_buffer += 0x0D;
-	rt_length = radiotext_buffer.length();
-	rt_length = (rt_length + 3) & 0xFC;
-	
-	group_count = rt_length >> 2;	// 4 characters per group
-
-	//groups_ptr = (RDSGroup*)chHeapAlloc(0, group_count * sizeof(RDSGroup));
+	rt_length = std::min(text.length(), rt_length_max);
+	for (c = 0; c < rt_length; c++)
+		radiotext_buffer[c] = text[c];
+	if (rt_length < rt_length_max)
+		radiotext_buffer[rt_length++] = 0x0D;
+	group_count = (rt_length + 3) >> 2;	// 4 characters per group
+	for (c = rt_length; c < group_count * 4; c++)
+		radiotext_buffer[c] = ' ';
 
 	frame.clear();
 	
 	for (c = 0; c < group_count; c++) {
-		group = make_2A_group(rds_flags->PI_code, rds_flags->TP, rds_flags->PTY, AB, c, radiotext_buffer.substr(c * 4, 4));
+		group = make_2A_group(rds_flags->PI_code, rds_flags->TP, rds_flags->PTY, AB, c, &radiotext_buffer[c * 4]);
 		group.block[0] = make_block(group.block[0], RDS_OFFSET_A);
 		group.block[1] = make_block(group.block[1], RDS_OFFSET_B);
 		group.block[2] = make_block(group.block[2], RDS_OFFSET_C);
 		group.block[3] = make_block(group.block[3], RDS_OFFSET_D);
-		frame.emplace_back(group);
+		frame.push_back(group);
 	}
 }
 
-void gen_ClockTime(std::vector<RDSGroup>& frame, const RDS_flags * rds_flags,
+void gen_ClockTime(RDSFrame& frame, const RDS_flags * rds_flags,
 						const uint16_t year, const uint8_t month, const uint8_t day,
 						const uint8_t hour, const uint8_t minute, const int8_t local_offset) {
 	RDSGroup group;
@@ -157,7 +184,7 @@ void gen_ClockTime(std::vector<RDSGroup>& frame, const RDS_flags * rds_flags,
 	group.block[3] = make_block(group.block[3], RDS_OFFSET_D);
 	
 	frame.clear();
-	frame.emplace_back(group);		
+	frame.push_back(group);
 }
 
 } /* namespace rds */
@@ -21,7 +21,8 @@
  */
 
 #include <string>
-#include <vector>
+#include <array>
+#include <cstddef>
 #include "ch.h"
 
 #ifndef __RDS_H__
@@ -48,20 +49,53 @@ struct RDSGroup {
 	uint32_t block[4];
 };
 
+/* The groups of one gen_*() call, in place. 16 is the most: 2A
+ * RadioText's 64 characters, 4 to a segment.
+ */
+class RDSFrame {
+public:
+	static constexpr size_t groups_max = 16;
+
+	void clear() {
+		count = 0;
+	}
+
+	void push_back(const RDSGroup& group) {
+		if (count < groups_max)
+			groups[count++] = group;
+	}
+
+	size_t size() const {
+		return count;
+	}
+
+	const RDSGroup& operator[](const size_t i) const {
+		return groups[i];
+	}
+
+private:
+	std::array<RDSGroup, groups_max> groups { };
+	size_t count { 0 };
+};
+
+/* 16 data bits, then the 10 bit checkword plus the offset word. The
+ * checkword is linear in the data, so it's two table lookups, one per
+ * data byte, XORed.
+ */
 uint32_t make_block(uint32_t blockdata, uint16_t offset);
 uint8_t b2b(const bool in);
 
 RDSGroup make_0B_group(const uint16_t PI_code, const bool TP, const uint8_t PTY, const bool TA,
-							const bool MS, const bool DI, const uint8_t C, const std::string chars);
+							const bool MS, const bool DI, const uint8_t C, const char* const chars);
 RDSGroup make_2A_group(const uint16_t PI_code, const bool TP, const uint8_t PTY, const bool AB,
-							const uint8_t segment, const std::string chars);
+							const uint8_t segment, const char* const chars);
 RDSGroup make_4A_group(const uint16_t PI_code, const bool TP, const uint8_t PTY,
 							const uint16_t year, const uint8_t month, const uint8_t day,
 							const uint8_t hour, const uint8_t minute, const int8_t local_offset);
 
-void gen_PSN(std::vector<RDSGroup>& frame, const std::string& psname, const RDS_flags * rds_flags);
-void gen_RadioText(std::vector<RDSGroup>& frame, const std::string& text, const bool AB, const RDS_flags * rds_flags);
-void gen_ClockTime(std::vector<RDSGroup>& frame, const RDS_flags * rds_flags,
+void gen_PSN(RDSFrame& frame, const std::string& psname, const RDS_flags * rds_flags);
+void gen_RadioText(RDSFrame& frame, const std::string& text, const bool AB, const RDS_flags * rds_flags);
+void gen_ClockTime(RDSFrame& frame, const RDS_flags * rds_flags,
 						const uint16_t year, const uint8_t month, const uint8_t day,
 						const uint8_t hour, const uint8_t minute, const int8_t local_offset);
 
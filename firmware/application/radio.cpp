@@ -39,6 +39,9 @@ using namespace hackrf::one;
 #include "cpld_update.hpp"
 
 #include "portapack.hpp"
+#include "trace.hpp"
+
+#include <array>
 
 namespace radio {
 
@@ -134,10 +137,34 @@ void set_direction(const rf::Direction new_direction) {
 		led_tx.on();
 }
 
+/* First LO currently programmed, 0 when the first IF is bypassed. */
+static rf::Frequency first_lo_frequency_current { 0 };
+
+static std::array<debug::RetuneStatistics, 2> retune_stats { };
+
+static void record_retune(const bool table, const halrtcnt_t start) {
+	TRACE_COMPLETE(Retune, start, table ? 1 : 0);
+	const halrtcnt_t ticks = halGetCounterValue() - start;
+	const uint32_t us = ticks / (halGetCounterFrequency() / 1000000U);
+
+	auto& statistics = retune_stats[table ? 1 : 0];
+	if( (statistics.count == 0) || (us < statistics.min_us) ) {
+		statistics.min_us = us;
+	}
+	if( us > statistics.max_us ) {
+		statistics.max_us = us;
+	}
+	statistics.last_us = us;
+	statistics.total_us += us;
+	statistics.count++;
+}
+
 bool set_tuning_frequency(const rf::Frequency frequency) {
+	const halrtcnt_t start = halGetCounterValue();
 	const auto tuning_config = tuning::config::create(frequency);
 	if( tuning_config.is_valid() ) {
 		first_if.disable();
+		first_lo_frequency_current = tuning_config.first_lo_frequency;
 
 		if( tuning_config.first_lo_frequency ) {
 			first_if.set_frequency(tuning_config.first_lo_frequency);
@@ -149,12 +176,57 @@ bool set_tuning_frequency(const rf::Frequency frequency) {
 		rf_path.set_band(tuning_config.rf_path_band);
 		baseband_cpld.set_invert(tuning_config.baseband_invert);
 
+		record_retune(false, start);
 		return result_second_if;
 	} else {
 		return false;
 	}
 }
 
+TuningSettings tuning_settings(const rf::Frequency frequency) {
+	const auto tuning_config = tuning::config::create(frequency);
+	if( !tuning_config.is_valid() ) {
+		return { 0, { }, { }, rf::path::Band::Mid, false, false };
+	}
+
+	return {
+		tuning_config.first_lo_frequency,
+		tuning_config.first_lo_frequency ? rffc507x::Synth::calculate(tuning_config.first_lo_frequency) : rffc507x::Synth { },
+		max2837::Synth::calculate(tuning_config.second_lo_frequency),
+		tuning_config.rf_path_band,
+		tuning_config.baseband_invert,
+		true
+	};
+}
+
+bool set_tuning(const TuningSettings& settings) {
+	if( !settings.valid ) {
+		return false;
+	}
+
+	const halrtcnt_t start = halGetCounterValue();
+
+	// Leave the first IF running (and calibrated) if its LO doesn't move,
+	// common when scanning within one band.
+	if( settings.first_lo_frequency != first_lo_frequency_current ) {
+		first_if.disable();
+		first_lo_frequency_current = settings.first_lo_frequency;
+
+		if( settings.first_lo_frequency ) {
+			first_if.set_synth(settings.first_if);
+			first_if.enable();
+		}
+	}
+
+	const auto result_second_if = second_if.set_synth(settings.second_if);
+
+	rf_path.set_band(settings.rf_path_band);
+	baseband_cpld.set_invert(settings.baseband_invert);
+
+	record_retune(true, start);
+	return result_second_if;
+}
+
 void set_rf_amp(const bool rf_amp) {
 	rf_path.set_rf_amp(rf_amp);
 	
@@ -174,6 +246,10 @@ void set_vga_gain(const int_fast8_t db) {
 	second_if.set_vga_gain(db);
 }
 
+void set_rx_gains(const int_fast8_t lna_db, const int_fast8_t vga_db) {
+	second_if.set_rx_gains(lna_db, vga_db);
+}
+
 void set_tx_gain(const int_fast8_t db) {
 	second_if.set_tx_vga_gain(db);
 }
@@ -196,6 +272,7 @@ void disable() {
 	baseband_codec.set_mode(max5864::Mode::Shutdown);
 	second_if.set_mode(max2837::Mode::Standby);
 	first_if.disable();
+	first_lo_frequency_current = 0;
 	set_rf_amp(false);
 	
 	led_rx.off();
@@ -218,6 +295,14 @@ void configure(Configuration configuration) {
 
 namespace debug {
 
+const RetuneStatistics& retune_statistics(const bool table) {
+	return radio::retune_stats[table ? 1 : 0];
+}
+
+void reset_retune_statistics() {
+	radio::retune_stats = { };
+}
+
 namespace first_if {
 
 uint32_t register_read(const size_t register_number) {
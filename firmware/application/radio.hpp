@@ -24,6 +24,9 @@
 
 #include "rf_path.hpp"
 
+#include "rffc507x.hpp"
+#include "max2837.hpp"
+
 #include <cstdint>
 #include <cstddef>
 
@@ -39,13 +42,28 @@ struct Configuration {
 	int8_t vga_gain;
 };
 
+/* Everything set_tuning_frequency() works out for one frequency, so a
+ * table of channels can be retuned with only the SPI writes that differ.
+ */
+struct TuningSettings {
+	rf::Frequency first_lo_frequency;
+	rffc507x::Synth first_if;
+	max2837::Synth second_if;
+	rf::path::Band rf_path_band;
+	bool baseband_invert;
+	bool valid;
+};
+
 void init();
 
 void set_direction(const rf::Direction new_direction);
 bool set_tuning_frequency(const rf::Frequency frequency);
+TuningSettings tuning_settings(const rf::Frequency frequency);
+bool set_tuning(const TuningSettings& settings);
 void set_rf_amp(const bool rf_amp);
 void set_lna_gain(const int_fast8_t db);
 void set_vga_gain(const int_fast8_t db);
+void set_rx_gains(const int_fast8_t lna_db, const int_fast8_t vga_db);
 void set_tx_gain(const int_fast8_t db);
 void set_baseband_filter_bandwidth(const uint32_t bandwidth_minimum);
 void set_baseband_rate(const uint32_t rate);
@@ -57,6 +75,18 @@ void disable();
 
 namespace debug {
 
+struct RetuneStatistics {
+	uint32_t count;
+	uint32_t last_us;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t total_us;
+};
+
+/* Time spent in set_tuning_frequency() (full) or set_tuning() (table). */
+const RetuneStatistics& retune_statistics(const bool table);
+void reset_retune_statistics();
+
 namespace first_if {
 
 uint32_t register_read(const size_t register_number);
@@ -36,22 +36,27 @@ using namespace portapack;
 #include "dsp_iir.hpp"
 #include "dsp_iir_config.hpp"
 
+#include <cstdlib>
+#include <algorithm>
+
 namespace {
 
 static constexpr std::array<baseband::AMConfig, 3> am_configs { {
 	{ taps_6k0_dsb_channel, AMConfigureMessage::Modulation::DSB },
-	{ taps_2k8_usb_channel, AMConfigureMessage::Modulation::SSB },
-	{ taps_2k8_lsb_channel, AMConfigureMessage::Modulation::SSB },	
+	{ taps_2k8_usb_channel, AMConfigureMessage::Modulation::USB },
+	{ taps_2k8_lsb_channel, AMConfigureMessage::Modulation::LSB },
 } };
 
-static constexpr std::array<baseband::NBFMConfig, 3> nbfm_configs { {
+static constexpr std::array<baseband::NBFMConfig, 4> nbfm_configs { {
 	{ taps_4k25_decim_0, taps_4k25_decim_1, taps_4k25_channel, 2500 },
 	{ taps_11k0_decim_0, taps_11k0_decim_1, taps_11k0_channel, 2500 },
 	{ taps_16k0_decim_0, taps_16k0_decim_1, taps_16k0_channel, 5000 },
+	{ taps_20k0_decim_0, taps_20k0_decim_1, taps_20k0_channel, 7000 },
 } };
 
-static constexpr std::array<baseband::WFMConfig, 1> wfm_configs { {
-	{ },
+static constexpr std::array<baseband::WFMConfig, 2> wfm_configs { {
+	{ true },
+	{ false },
 } };
 
 } /* namespace */
@@ -65,6 +70,15 @@ void ReceiverModel::set_tuning_frequency(rf::Frequency f) {
 	update_tuning_frequency();
 }
 
+radio::TuningSettings ReceiverModel::tuning_settings(rf::Frequency f) {
+	return radio::tuning_settings(f + tuning_offset());
+}
+
+void ReceiverModel::set_tuning_frequency(rf::Frequency f, const radio::TuningSettings& settings) {
+	persistent_memory::set_tuned_frequency(f);
+	radio::set_tuning(settings);
+}
+
 rf::Frequency ReceiverModel::frequency_step() const {
 	return frequency_step_;
 }
@@ -158,6 +172,113 @@ void ReceiverModel::set_squelch_level(uint8_t v) {
 	update_modulation();
 }
 
+bool ReceiverModel::frequency_tracking() const {
+	return frequency_tracking_;
+}
+
+void ReceiverModel::set_frequency_tracking(const bool enabled) {
+	frequency_tracking_ = enabled;
+	if( modulation() == Mode::NarrowbandFMAudio ) {
+		baseband::set_frequency_correction(frequency_tracking_);
+	}
+}
+
+void ReceiverModel::on_frequency_offset(const int32_t offset_hz) {
+	// The Si5351 trims in whole ppm; DSP takes the rest, and the margin
+	// over half a step keeps one trim from undoing the last.
+	constexpr int64_t reference_step_ppb = 1000;
+	constexpr int64_t threshold_ppb = reference_step_ppb * 3 / 2;
+
+	const int64_t f = persistent_memory::tuned_frequency();
+	if( !frequency_tracking_ || (f <= 0) ) {
+		return;
+	}
+
+	// Seen above the channel centre, so the reference runs slow.
+	const int64_t error_ppb = offset_hz * 1000000000LL / f;
+	if( portapack::temperature_logger.size() ) {
+		temperature_compensation.observe(
+			portapack::temperature_logger.latest(),
+			persistent_memory::correction_ppb() + error_ppb
+		);
+	}
+
+	if( std::abs(error_ppb) < threshold_ppb ) {
+		return;
+	}
+
+	const int64_t steps = (error_ppb + ((error_ppb >= 0) ? (reference_step_ppb / 2) : -(reference_step_ppb / 2))) / reference_step_ppb;
+	const auto previous_ppb = persistent_memory::correction_ppb();
+	persistent_memory::set_correction_ppb(previous_ppb + steps * reference_step_ppb);
+	const int64_t applied_ppb = persistent_memory::correction_ppb() - previous_ppb;
+	if( applied_ppb != 0 ) {
+		baseband::set_frequency_correction(true, applied_ppb * f / 1000000000LL);
+	}
+}
+
+bool ReceiverModel::gain_control() const {
+	return gain_control_;
+}
+
+void ReceiverModel::set_gain_control(const bool enabled) {
+	gain_control_ = enabled;
+	lna_reduction_db_ = 0;
+	vga_reduction_db_ = 0;
+	radio::set_rx_gains(lna_applied(), vga_applied());
+	baseband::set_rx_gain_control(enabled);
+}
+
+void ReceiverModel::on_gain_step(const int32_t direction) {
+	if( !gain_control_ ) {
+		return;
+	}
+
+	constexpr int32_t step_db = max2837::lna::gain_db_step;
+	const int32_t before = lna_applied() + vga_applied();
+	if( direction < 0 ) {
+		if( vga_applied() > 0 ) {
+			vga_reduction_db_ += step_db;
+		} else if( lna_applied() > 0 ) {
+			lna_reduction_db_ += step_db;
+		}
+	} else if( direction > 0 ) {
+		if( lna_reduction_db_ > 0 ) {
+			lna_reduction_db_ = std::max(lna_reduction_db_ - step_db, static_cast<int32_t>(0));
+		} else if( vga_reduction_db_ > 0 ) {
+			vga_reduction_db_ = std::max(vga_reduction_db_ - step_db, static_cast<int32_t>(0));
+		}
+	}
+
+	const int32_t applied_db = (lna_applied() + vga_applied()) - before;
+	if( applied_db != 0 ) {
+		radio::set_rx_gains(lna_applied(), vga_applied());
+	}
+	baseband::set_rx_gain_control(true, applied_db);
+}
+
+void ReceiverModel::on_temperature(const TemperatureLogger::sample_t temperature) {
+	// The sensor only reads right with the MAX2837 out of shutdown.
+	if( !enabled_ ) {
+		return;
+	}
+	temperature_compensation.flush();
+	if( frequency_tracking_ ) {
+		return;
+	}
+
+	// A step at a time, each sample (5s), like the drift it follows.
+	constexpr int32_t step_ppb = 1000;
+	const auto target = temperature_compensation.correction_ppb(temperature);
+	if( target.is_valid() ) {
+		const auto current = persistent_memory::correction_ppb();
+		const auto error = target.value() - current;
+		// The reference only trims in whole ppm, so within most of a step is close enough.
+		if( std::abs(error) >= (step_ppb * 3 / 4) ) {
+			persistent_memory::set_correction_ppb(current + ((error > 0) ? step_ppb : -step_ppb));
+		}
+	}
+}
+
 void ReceiverModel::enable() {
 	enabled_ = true;
 	radio::set_direction(rf::Direction::Receive);
@@ -176,6 +297,9 @@ void ReceiverModel::enable() {
 
 void ReceiverModel::disable() {
 	enabled_ = false;
+	gain_control_ = false;
+	lna_reduction_db_ = 0;
+	vga_reduction_db_ = 0;
 	radio::set_antenna_bias(false);
 
 	// TODO: Responsibility for enabling/disabling the radio is muddy.
@@ -206,7 +330,7 @@ void ReceiverModel::update_rf_amp() {
 }
 
 void ReceiverModel::update_lna() {
-	radio::set_lna_gain(lna_gain_db_);
+	radio::set_lna_gain(lna_applied());
 }
 
 void ReceiverModel::update_baseband_bandwidth() {
@@ -214,7 +338,15 @@ void ReceiverModel::update_baseband_bandwidth() {
 }
 
 void ReceiverModel::update_vga() {
-	radio::set_vga_gain(vga_gain_db_);
+	radio::set_vga_gain(vga_applied());
+}
+
+int32_t ReceiverModel::lna_applied() const {
+	return std::max(lna_gain_db_ - lna_reduction_db_, static_cast<int32_t>(0));
+}
+
+int32_t ReceiverModel::vga_applied() const {
+	return std::max(vga_gain_db_ - vga_reduction_db_, static_cast<int32_t>(0));
 }
 
 void ReceiverModel::update_tx_gain() {
@@ -293,6 +425,7 @@ size_t ReceiverModel::nbfm_configuration() const {
 
 void ReceiverModel::update_nbfm_configuration() {
 	nbfm_configs[nbfm_config_index].apply(squelch_level_);
+	baseband::set_frequency_correction(frequency_tracking_);
 }
 
 size_t ReceiverModel::wfm_configuration() const {
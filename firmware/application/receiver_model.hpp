@@ -28,7 +28,9 @@
 #include "message.hpp"
 #include "rf_path.hpp"
 #include "max2837.hpp"
+#include "radio.hpp"
 #include "volume.hpp"
+#include "temperature_compensation.hpp"
 
 class ReceiverModel {
 public:
@@ -42,6 +44,12 @@ public:
 	rf::Frequency tuning_frequency() const;
 	void set_tuning_frequency(rf::Frequency f);
 
+	/* For scanners: compute a channel's settings once with tuning_settings(),
+	 * then retune to it cheaply. Valid until the mode or sampling rate changes.
+	 */
+	radio::TuningSettings tuning_settings(rf::Frequency f);
+	void set_tuning_frequency(rf::Frequency f, const radio::TuningSettings& settings);
+
 	rf::Frequency frequency_step() const;
 	void set_frequency_step(rf::Frequency f);
 
@@ -74,6 +82,27 @@ public:
 	uint8_t squelch_level() const;
 	void set_squelch_level(uint8_t v);
 
+	/* NFM: tune out the offset of a known carrier, first in the DSP, then
+	 * by trimming the reference once it's worth a whole step of that.
+	 */
+	bool frequency_tracking() const;
+	void set_frequency_tracking(const bool enabled);
+	void on_frequency_offset(const int32_t offset_hz);
+
+	/* Packet decoders: let the M4's RxGainControl take the VGA, then the
+	 * LNA, down from their settings while the ADC clips, and back up in
+	 * the reverse order once it's quiet. Steps are 8dB either way. The
+	 * settings themselves don't change; disable() turns this off.
+	 */
+	bool gain_control() const;
+	void set_gain_control(const bool enabled);
+	void on_gain_step(const int32_t direction);
+
+	/* Learns the reference against temperature while AFC holds a carrier,
+	 * and without AFC, walks the reference to what was learned.
+	 */
+	void on_temperature(const TemperatureLogger::sample_t temperature);
+
 	void enable();
 	void disable();
 
@@ -101,6 +130,11 @@ private:
 	size_t wfm_config_index = 0;
 	volume_t headphone_volume_ { -43.0_dB };
 	uint8_t squelch_level_ { 80 };
+	bool frequency_tracking_ { false };
+	bool gain_control_ { false };
+	int32_t lna_reduction_db_ { 0 };
+	int32_t vga_reduction_db_ { 0 };
+	TemperatureCompensation temperature_compensation { };
 
 	int32_t tuning_offset();
 
@@ -110,6 +144,8 @@ private:
 	void update_lna();
 	void update_baseband_bandwidth();
 	void update_vga();
+	int32_t lna_applied() const;
+	int32_t vga_applied() const;
 	void update_tx_gain();
 	void update_sampling_rate();
 	void update_headphone_volume();
@@ -54,7 +54,7 @@ void RecentEntriesHeader::paint(Painter& painter) {
 		}
 
 		painter.draw_string(p, style, text);
-		p += { static_cast<Coord>((width * 8) + 8), 0 };
+		p += { static_cast<Coord>((width + 1) * style.font.char_width()), 0 };
 	}
 }
 
@@ -27,43 +27,262 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <list>
+#include <array>
+#include <new>
+#include <type_traits>
 #include <utility>
 #include <functional>
 #include <iterator>
 #include <algorithm>
 
-template<class Entry>
-using RecentEntries = std::list<Entry>;
+/* RecentEntries index that isn't: lookups scan the entries. */
+struct NoIndex {
+	static constexpr bool enabled = false;
 
-template<typename ContainerType, typename Key>
-typename ContainerType::const_iterator find(const ContainerType& entries, const Key key) {
-	return std::find_if(
-		std::begin(entries), std::end(entries),
-		[key](typename ContainerType::const_reference e) { return e.key() == key; }
-	);
-}
+	template<typename Key> int lookup(const Key) const { return -1; }
+	template<typename Key> void insert(const Key, const size_t) { }
+	template<typename Key> void erase(const Key) { }
+};
 
-template<typename ContainerType>
-static void truncate_entries(ContainerType& entries, const size_t entries_max = 64) {
-	while(entries.size() > entries_max) {
-		entries.pop_back();
+/* Open addressing index from integer keys to RecentEntries slots, for
+ * containers too big to scan per packet. Linear probing, with deletions
+ * shifting later probes back rather than leaving tombstones. Capacity, a
+ * power of two, should be at least twice the entry count.
+ */
+template<typename KeyType, size_t Capacity>
+class HashIndex {
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	static constexpr bool enabled = true;
+
+	HashIndex() {
+		slots.fill(static_cast<uint16_t>(empty));
+	}
+
+	int lookup(const KeyType key) const {
+		for(size_t i=home(key); slots[i] != empty; i=(i + 1) & mask) {
+			if( keys[i] == key ) {
+				return slots[i];
+			}
+		}
+		return -1;
+	}
+
+	void insert(const KeyType key, const size_t slot) {
+		size_t i = home(key);
+		while( slots[i] != empty ) {
+			i = (i + 1) & mask;
+		}
+		keys[i] = key;
+		slots[i] = slot;
+	}
+
+	void erase(const KeyType key) {
+		size_t i = home(key);
+		while( (slots[i] != empty) && (keys[i] != key) ) {
+			i = (i + 1) & mask;
+		}
+		if( slots[i] == empty ) {
+			return;
+		}
+
+		slots[i] = empty;
+		for(size_t j=(i + 1) & mask; slots[j] != empty; j=(j + 1) & mask) {
+			// Move back any probe that the hole would otherwise cut off.
+			if( ((j - home(keys[j])) & mask) >= ((j - i) & mask) ) {
+				keys[i] = keys[j];
+				slots[i] = slots[j];
+				slots[j] = empty;
+				i = j;
+			}
+		}
+	}
+
+private:
+	static constexpr size_t mask = Capacity - 1;
+	static constexpr uint16_t empty = 0xffff;
+
+	std::array<KeyType, Capacity> keys { };
+	std::array<uint16_t, Capacity> slots { };
+
+	static size_t home(const KeyType key) {
+		return ((static_cast<uint32_t>(key) * 2654435761U) >> 16) & mask;
+	}
+};
+
+/* Most recent first, holding up to N entries in fixed slots: an entry stays
+ * in its slot for as long as it's kept, and moving it to the front or
+ * evicting the oldest only shuffles a byte-wide slot order. No heap use or
+ * entry copies per packet, unlike the std::list this replaces. With a
+ * HashIndex, finding an entry by key doesn't scan either.
+ */
+template<class Entry, size_t N = 64, class Index = NoIndex>
+class RecentEntries {
+	static_assert(N <= 256, "slot indices are a byte");
+
+	template<typename Container, typename Value>
+	class Iterator {
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = Entry;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Value*;
+		using reference = Value&;
+
+		Iterator(Container* const entries, const size_t position) : entries { entries }, position { position } { }
+
+		/* iterator to const_iterator. */
+		template<typename C, typename V, typename = typename std::enable_if<std::is_const<Value>::value && !std::is_const<V>::value>::type>
+		Iterator(const Iterator<C, V>& other) : entries { other.entries }, position { other.position } { }
+
+		reference operator*() const { return entries->slot(entries->order[position]); }
+		pointer operator->() const { return &**this; }
+		Iterator& operator++() { position++; return *this; }
+		Iterator& operator--() { position--; return *this; }
+		Iterator operator++(int) { auto p = *this; position++; return p; }
+		Iterator operator--(int) { auto p = *this; position--; return p; }
+		friend bool operator==(const Iterator& a, const Iterator& b) { return a.position == b.position; }
+		friend bool operator!=(const Iterator& a, const Iterator& b) { return a.position != b.position; }
+
+		size_t index() const { return position; }
+
+	private:
+		template<typename, typename> friend class Iterator;
+
+		Container* entries;
+		size_t position;
+	};
+
+public:
+	using value_type = Entry;
+	using reference = Entry&;
+	using const_reference = const Entry&;
+	using iterator = Iterator<RecentEntries, Entry>;
+	using const_iterator = Iterator<const RecentEntries, const Entry>;
+
+	RecentEntries() {
+		for(size_t i=0; i<N; i++) {
+			order[i] = i;
+			position_of[i] = i;
+		}
 	}
+
+	RecentEntries(const RecentEntries&) = delete;
+	RecentEntries& operator=(const RecentEntries&) = delete;
+
+	~RecentEntries() {
+		clear();
+	}
+
+	iterator begin() { return { this, 0 }; }
+	iterator end() { return { this, count }; }
+	const_iterator begin() const { return { this, 0 }; }
+	const_iterator end() const { return { this, count }; }
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	reference front() { return slot(order[0]); }
+	const_reference front() const { return slot(order[0]); }
+
+	/* Evicts the oldest entry if full. */
+	template<typename... Args>
+	reference emplace_front(Args&&... args) {
+		if( count == N ) {
+			pop_back();
+		}
+		new (&slots[order[count]]) Entry(std::forward<Args>(args)...);
+		index.insert(slot(order[count]).key(), order[count]);
+		rotate_to_front(count++);
+		return front();
+	}
+
+	void move_to_front(const const_iterator item) {
+		rotate_to_front(item.index());
+	}
+
+	void pop_back() {
+		destroy(order[--count]);
+	}
+
+	/* Returns the entry that took its place. */
+	iterator erase(const const_iterator item) {
+		const auto position = item.index();
+		const auto n = order[position];
+		destroy(n);
+		std::copy(&order[position + 1], &order[count], &order[position]);
+		order[--count] = n;
+		for(size_t i=position; i<=count; i++) {
+			position_of[order[i]] = i;
+		}
+		return { this, position };
+	}
+
+	template<typename Key>
+	const_iterator find(const Key key) const {
+		if( Index::enabled ) {
+			const auto n = index.lookup(key);
+			return { this, (n < 0) ? count : position_of[n] };
+		}
+		return std::find_if(
+			begin(), end(),
+			[key](const_reference e) { return e.key() == key; }
+		);
+	}
+
+	void clear() {
+		while( count ) {
+			pop_back();
+		}
+	}
+
+private:
+	using Storage = typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type;
+
+	std::array<Storage, N> slots { };
+	/* order[0..count) are the live slots, most recent first; the rest
+	 * are free.
+	 */
+	std::array<uint8_t, N> order { };
+	std::array<uint8_t, N> position_of { };
+	size_t count { 0 };
+	Index index { };
+
+	Entry& slot(const size_t n) { return *reinterpret_cast<Entry*>(&slots[n]); }
+	const Entry& slot(const size_t n) const { return *reinterpret_cast<const Entry*>(&slots[n]); }
+
+	void destroy(const size_t n) {
+		index.erase(slot(n).key());
+		slot(n).~Entry();
+	}
+
+	void rotate_to_front(const size_t position) {
+		const auto n = order[position];
+		for(size_t i=position; i>0; i--) {
+			order[i] = order[i - 1];
+			position_of[order[i]] = i;
+		}
+		order[0] = n;
+		position_of[n] = 0;
+	}
+};
+
+template<class Entry, size_t N, class Index, typename Key>
+typename RecentEntries<Entry, N, Index>::const_iterator find(const RecentEntries<Entry, N, Index>& entries, const Key key) {
+	return entries.find(key);
 }
 
 template<typename ContainerType, typename Key>
 typename ContainerType::reference on_packet(ContainerType& entries, const Key key) {
 	auto matching_recent = find(entries, key);
 	if( matching_recent != std::end(entries) ) {
-		// Found within. Move to front of list, increment counter.
-		entries.push_front(*matching_recent);
-		entries.erase(matching_recent);
+		// Found within. Move to front of list.
+		entries.move_to_front(matching_recent);
+		return entries.front();
 	} else {
-		entries.emplace_front(key);
-		truncate_entries(entries);
+		return entries.emplace_front(key);
 	}
-
-	return entries.front();
 }
 
 template<typename ContainerType>
@@ -247,8 +466,16 @@ public:
 		_table.on_select = [this](const Entry& entry) { if( this->on_select ) { this->on_select(entry); } };
 	}
 
+	/* After entries change: repaints the table's rows, leaving the header
+	 * alone. Rows whose text is unchanged skip the LCD write.
+	 */
+	void update() {
+		_table.set_dirty();
+	}
+
 	void set_parent_rect(const Rect new_parent_rect) override {
-		constexpr Dim scale_height = 16;
+		// A line of the table's font, as the header is.
+		const Dim scale_height = style().font.line_height();
 
 		View::set_parent_rect(new_parent_rect);
 		_header.set_parent_rect({ 0, 0, new_parent_rect.width(), scale_height });
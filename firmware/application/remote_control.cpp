@@ -0,0 +1,415 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "remote_control.hpp"
+
+#include "ui_navigation.hpp"
+#include "usb_stream.hpp"
+#include "event_m0.hpp"
+#include "rtc_time.hpp"
+#include "string_format.hpp"
+#include "portapack.hpp"
+#include "portapack_persistent_memory.hpp"
+#include "baseband_api.hpp"
+
+#include <array>
+#include <cstdlib>
+
+using namespace portapack;
+
+RemoteControl* RemoteControl::instance { nullptr };
+bool RemoteControl::packets { false };
+Signal<bool> RemoteControl::signal_record { };
+
+const RemoteControl::Command RemoteControl::commands[] {
+	{ "help",		&RemoteControl::on_help },
+	{ "status",		&RemoteControl::on_status },
+	{ "freq",		&RemoteControl::on_freq },
+	{ "lna",		&RemoteControl::on_lna },
+	{ "vga",		&RemoteControl::on_vga },
+	{ "amp",		&RemoteControl::on_amp },
+	{ "app",		&RemoteControl::on_app },
+	{ "home",		&RemoteControl::on_home },
+	{ "key",		&RemoteControl::on_key },
+	{ "record",		&RemoteControl::on_record },
+	{ "packets",	&RemoteControl::on_packets },
+	{ "source",		&RemoteControl::on_source },
+	{ "stats",		&RemoteControl::on_stats },
+};
+
+static bool parse_int(const std::string& s, int64_t& value) {
+	if( s.empty() ) {
+		return false;
+	}
+	char* end = nullptr;
+	value = strtoll(s.c_str(), &end, 10);
+	return *end == 0;
+}
+
+static bool parse_hex(const std::string& s, std::array<uint8_t, 32>& bytes) {
+	if( s.empty() || (s.size() > (bytes.size() * 2)) ) {
+		return false;
+	}
+	bytes.fill(0);
+	for(size_t i=0; i<s.size(); i++) {
+		const char c = s[i];
+		uint8_t nibble;
+		if( (c >= '0') && (c <= '9') ) {
+			nibble = c - '0';
+		} else if( (c >= 'a') && (c <= 'f') ) {
+			nibble = c - 'a' + 10;
+		} else if( (c >= 'A') && (c <= 'F') ) {
+			nibble = c - 'A' + 10;
+		} else {
+			return false;
+		}
+		bytes[i >> 1] |= nibble << ((i & 1) ? 0 : 4);
+	}
+	return true;
+}
+
+RemoteControl::RemoteControl(
+	ui::NavigationView& nav,
+	ui::Widget& root
+) : nav(nav),
+	root(root)
+{
+	instance = this;
+
+	// Follows the setting, so it takes effect without a restart.
+	signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+		this->update_enabled();
+	};
+	update_enabled();
+}
+
+RemoteControl::~RemoteControl() {
+	rtc_time::signal_tick_second -= signal_token_tick_second;
+	if( enabled ) {
+		usb_stream::stop();
+	}
+	packets = false;
+	instance = nullptr;
+}
+
+void RemoteControl::on_serial_rx() {
+	if( instance && instance->enabled ) {
+		instance->receive();
+	}
+}
+
+void RemoteControl::forward_record(const void* const record, const size_t bytes) {
+	if( packets ) {
+		// Dropped whole when the host doesn't keep up.
+		usb_stream::serial_write(record, bytes);
+	}
+}
+
+void RemoteControl::update_enabled() {
+	const bool wanted = persistent_memory::config_usb_remote();
+	if( wanted == enabled ) {
+		return;
+	}
+
+	enabled = wanted;
+	if( enabled ) {
+		usb_stream::start();
+	} else {
+		usb_stream::stop();
+		packets = false;
+		line.clear();
+		overflow = false;
+	}
+}
+
+void RemoteControl::receive() {
+	std::array<char, 64> buffer;
+	size_t count;
+	while( (count = usb_stream::serial_read(buffer.data(), buffer.size())) > 0 ) {
+		for(size_t i=0; i<count; i++) {
+			const char c = buffer[i];
+			if( (c == '\r') || (c == '\n') ) {
+				if( overflow ) {
+					reply_error("line too long");
+				} else if( !line.empty() ) {
+					execute(line);
+				}
+				line.clear();
+				overflow = false;
+			} else if( line.size() < line_length_max ) {
+				line += c;
+			} else {
+				overflow = true;
+			}
+		}
+	}
+}
+
+void RemoteControl::execute(const std::string& command_line) {
+	const auto name_end = command_line.find(' ');
+	const auto name = command_line.substr(0, name_end);
+	const auto args_start = command_line.find_first_not_of(' ', name_end);
+	const auto args = (args_start == std::string::npos) ? std::string { } : command_line.substr(args_start);
+
+	for(const auto& command : commands) {
+		if( name == command.name ) {
+			(this->*command.handler)(args);
+			return;
+		}
+	}
+	reply_error("unknown command " + name);
+}
+
+void RemoteControl::reply_ok(const std::string& result) {
+	const auto reply = result.empty() ? "OK\r\n" : "OK " + result + "\r\n";
+	usb_stream::serial_write(reply.data(), reply.size());
+}
+
+void RemoteControl::reply_error(const std::string& reason) {
+	const auto reply = "ERR " + reason + "\r\n";
+	usb_stream::serial_write(reply.data(), reply.size());
+}
+
+void RemoteControl::on_help(const std::string&) {
+	std::string names;
+	for(const auto& command : commands) {
+		names += names.empty() ? "" : " ";
+		names += command.name;
+	}
+	reply_ok(names);
+}
+
+void RemoteControl::on_status(const std::string&) {
+	reply_ok(
+		"app=" + app_title +
+		" freq=" + to_string_dec_uint64(receiver_model.tuning_frequency()) +
+		" lna=" + to_string_dec_int(receiver_model.lna()) +
+		" vga=" + to_string_dec_int(receiver_model.vga()) +
+		" amp=" + (receiver_model.rf_amp() ? "1" : "0")
+	);
+}
+
+void RemoteControl::on_freq(const std::string& args) {
+	int64_t value;
+	if( !parse_int(args, value) || (value <= 0) ) {
+		reply_error("freq <Hz>");
+		return;
+	}
+	receiver_model.set_tuning_frequency(value);
+	reply_ok();
+}
+
+void RemoteControl::on_lna(const std::string& args) {
+	int64_t value;
+	if( !parse_int(args, value) || (value < 0) || (value > 40) ) {
+		reply_error("lna <0-40 dB>");
+		return;
+	}
+	receiver_model.set_lna(value);
+	reply_ok();
+}
+
+void RemoteControl::on_vga(const std::string& args) {
+	int64_t value;
+	if( !parse_int(args, value) || (value < 0) || (value > 62) ) {
+		reply_error("vga <0-62 dB>");
+		return;
+	}
+	receiver_model.set_vga(value);
+	reply_ok();
+}
+
+void RemoteControl::on_amp(const std::string& args) {
+	if( (args != "0") && (args != "1") ) {
+		reply_error("amp <0|1>");
+		return;
+	}
+	receiver_model.set_rf_amp(args == "1");
+	reply_ok();
+}
+
+void RemoteControl::on_app(const std::string& args) {
+	if( !ui::launch_app(nav, args) ) {
+		reply_error("no app " + args);
+		return;
+	}
+	reply_ok(app_title);
+}
+
+void RemoteControl::on_home(const std::string&) {
+	while( !nav.is_top() ) {
+		nav.pop();
+	}
+	reply_ok();
+}
+
+void RemoteControl::on_key(const std::string& args) {
+	static constexpr std::array<const char*, 5> key_names { { "right", "left", "down", "up", "select" } };
+
+	size_t i = 0;
+	while( (i < key_names.size()) && (args != key_names[i]) ) {
+		i++;
+	}
+	if( i == key_names.size() ) {
+		reply_error("key <up|down|left|right|select>");
+		return;
+	}
+
+	// Delivered as the switches would, waking the display without swallowing the key.
+	bl_tick_counter = 0;
+	EventDispatcher::set_display_sleep(false);
+
+	const auto event = static_cast<ui::KeyEvent>(i);
+	auto target = root.context().focus_manager().focus_widget();
+	while( (target != nullptr) && !target->on_key(event) ) {
+		target = target->parent();
+	}
+	if( target == nullptr ) {
+		root.context().focus_manager().update(&root, event);
+	}
+	reply_ok();
+}
+
+void RemoteControl::on_record(const std::string& args) {
+	if( (args != "start") && (args != "stop") ) {
+		reply_error("record <start|stop>");
+		return;
+	}
+	signal_record.emit(args == "start");
+	reply_ok();
+}
+
+void RemoteControl::on_packets(const std::string& args) {
+	if( (args != "on") && (args != "off") ) {
+		reply_error("packets <on|off>");
+		return;
+	}
+	packets = (args == "on");
+	reply_ok(persistent_memory::config_binary_logs() ? std::string { } : "binary packet logs are off");
+}
+
+void RemoteControl::on_source(const std::string& args) {
+	static constexpr char usage[] = "source <radio|tone|noise|fsk|ook> [key=value ...]";
+
+	const auto kind_end = args.find(' ');
+	const auto kind = args.substr(0, kind_end);
+
+	if( kind == "radio" ) {
+		baseband::synthetic_source_stop();
+		statistics = { };
+		reply_ok();
+		return;
+	}
+
+	SyntheticSourceConfig config { };
+	if( kind == "tone" ) {
+		config.mode = SyntheticSourceConfig::Mode::Tone;
+	} else if( kind == "noise" ) {
+		config.mode = SyntheticSourceConfig::Mode::Noise;
+	} else if( kind == "fsk" ) {
+		config.mode = SyntheticSourceConfig::Mode::FSK;
+	} else if( kind == "ook" ) {
+		config.mode = SyntheticSourceConfig::Mode::OOK;
+	} else {
+		reply_error(usage);
+		return;
+	}
+
+	bool bits_given = false;
+	size_t start = (kind_end == std::string::npos) ? args.size() : kind_end;
+	while( start < args.size() ) {
+		const auto token_start = args.find_first_not_of(' ', start);
+		if( token_start == std::string::npos ) {
+			break;
+		}
+		const auto token_end = args.find(' ', token_start);
+		const auto token = args.substr(token_start, token_end - token_start);
+		start = (token_end == std::string::npos) ? args.size() : token_end;
+
+		const auto equals = token.find('=');
+		const auto key = token.substr(0, equals);
+		const auto text = (equals == std::string::npos) ? std::string { } : token.substr(equals + 1);
+
+		if( key == "pattern" ) {
+			if( !parse_hex(text, config.pattern) ) {
+				reply_error("bad " + token);
+				return;
+			}
+			if( !bits_given ) {
+				config.pattern_length = text.size() * 4;
+			}
+			continue;
+		}
+
+		int64_t value;
+		bool valid = parse_int(text, value);
+		if( key == "freq" ) {
+			valid = valid && (value >= -10000000) && (value <= 10000000);
+			config.frequency = value;
+		} else if( key == "amp" ) {
+			valid = valid && (value >= 0) && (value <= 127);
+			config.amplitude = value;
+		} else if( key == "noise" ) {
+			valid = valid && (value >= 0) && (value <= 127);
+			config.noise = value;
+		} else if( key == "bits" ) {
+			valid = valid && (value >= 0) && (value <= static_cast<int64_t>(config.pattern.size() * 8));
+			config.pattern_length = value;
+			bits_given = true;
+		} else {
+			valid = valid && (value >= 0) && (value <= UINT32_MAX);
+			if( key == "dev" ) {
+				config.deviation = value;
+			} else if( key == "baud" ) {
+				config.symbol_rate = value;
+			} else if( key == "gap" ) {
+				config.gap_ms = value;
+			} else if( key == "secs" ) {
+				config.seconds = value;
+			} else if( key == "seed" ) {
+				config.seed = value;
+			} else {
+				valid = false;
+			}
+		}
+		if( !valid ) {
+			reply_error("bad " + token);
+			return;
+		}
+	}
+
+	statistics = { };
+	baseband::synthetic_source_start(config);
+	reply_ok();
+}
+
+void RemoteControl::on_stats(const std::string&) {
+	reply_ok(
+		"buffers=" + to_string_dec_uint(statistics.buffers) +
+		" avg=" + to_string_dec_uint(statistics.cycles_average) +
+		" max=" + to_string_dec_uint(statistics.cycles_max) +
+		" budget=" + to_string_dec_uint(statistics.cycles_budget) +
+		" overruns=" + to_string_dec_uint(statistics.overruns) +
+		" decodes=" + to_string_dec_uint(statistics.decodes) +
+		" sent=" + to_string_dec_uint(statistics.packets) +
+		" ended=" + (statistics.ended ? "1" : "0")
+	);
+}
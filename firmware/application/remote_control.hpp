@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __REMOTE_CONTROL_H__
+#define __REMOTE_CONTROL_H__
+
+#include "signal.hpp"
+#include "message.hpp"
+#include "event_m0.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace ui {
+class NavigationView;
+class Widget;
+}
+
+/* Line based commands over the USB serial port, for test rigs, while the
+ * "USB remote control" UI setting is on. A command is a line, CR or LF
+ * ended; each gets one "OK[ <result>]" or "ERR <reason>" line back:
+ *
+ *   help                          command names
+ *   status                        app, freq, lna, vga, amp
+ *   freq <Hz>                     receiver tuning frequency
+ *   lna <dB> / vga <dB>           receiver gains
+ *   amp <0|1>                     RF amplifier
+ *   app <name>                    launch_app(), e.g. "app ads-b"
+ *   home                          back to the system menu
+ *   key <up|down|left|right|select>
+ *   record <start|stop>           the open app's RecordView
+ *   packets <on|off>              copy binary log records to the port
+ *   source radio                  the open receiver's samples from the radio
+ *   source <tone|noise|fsk|ook> [key=value ...]
+ *                                 or from a test signal, see below
+ *   stats                         the processor's ProcessorStatistics
+ *
+ * source's keys are SyntheticSourceConfig's: freq=<Hz> amp=<0-127>
+ * noise=<0-127> dev=<Hz> baud=<symbols/s> gap=<ms> secs=<s> seed=<n>
+ * pattern=<hex, MSB first> bits=<n, default all of pattern>. It takes
+ * effect in a receiving app, as fast as the processor goes; a new app
+ * goes back to the radio. stats are totals since the last source command,
+ * ended=1 once secs of samples are through:
+ *   buffers avg max budget (cycles per buffer) overruns decodes sent ended
+ * so a benchmark is an app, a source with secs, then stats until ended.
+ *
+ * Packet records are those the decoders write to their LogFile, with the
+ * "Binary packet logs" setting on: LogRecordHeader and payload, as in the
+ * .BIN files. Their 0xa5 sync byte never starts a reply line.
+ * tools/remote.py sends commands and splits the two apart.
+ *
+ * Everything runs on the event loop, from EVT_MASK_USB_SERIAL.
+ */
+class RemoteControl {
+public:
+	RemoteControl(ui::NavigationView& nav, ui::Widget& root);
+	~RemoteControl();
+
+	RemoteControl(const RemoteControl&) = delete;
+	RemoteControl(RemoteControl&&) = delete;
+	RemoteControl& operator=(const RemoteControl&) = delete;
+	RemoteControl& operator=(RemoteControl&&) = delete;
+
+	void set_app_title(const std::string& title) {
+		app_title = title;
+	}
+
+	static void on_serial_rx();
+	static void forward_record(const void* const record, const size_t bytes);
+
+	/* true to start recording, false to stop. */
+	static Signal<bool> signal_record;
+
+private:
+	struct Command {
+		const char* name;
+		void (RemoteControl::*handler)(const std::string& args);
+	};
+
+	static constexpr size_t line_length_max = 80;
+	static const Command commands[];
+
+	static RemoteControl* instance;
+	static bool packets;
+
+	ui::NavigationView& nav;
+	ui::Widget& root;
+	bool enabled { false };
+	bool overflow { false };
+	std::string line { };
+	std::string app_title { };
+	SignalToken signal_token_tick_second { };
+	ProcessorStatistics statistics { };
+
+	MessageHandlerRegistration message_handler_statistics {
+		Message::ID::ProcessorStatistics,
+		[this](Message* const p) {
+			this->statistics = static_cast<const ProcessorStatisticsMessage*>(p)->statistics;
+		}
+	};
+
+	void update_enabled();
+	void receive();
+	void execute(const std::string& command_line);
+
+	void reply_ok(const std::string& result = { });
+	void reply_error(const std::string& reason);
+
+	void on_help(const std::string& args);
+	void on_status(const std::string& args);
+	void on_freq(const std::string& args);
+	void on_lna(const std::string& args);
+	void on_vga(const std::string& args);
+	void on_amp(const std::string& args);
+	void on_app(const std::string& args);
+	void on_home(const std::string& args);
+	void on_key(const std::string& args);
+	void on_record(const std::string& args);
+	void on_packets(const std::string& args);
+	void on_source(const std::string& args);
+	void on_stats(const std::string& args);
+};
+
+#endif/*__REMOTE_CONTROL_H__*/
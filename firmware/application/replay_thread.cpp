@@ -25,14 +25,31 @@
 #include "baseband_api.hpp"
 #include "buffer_exchange.hpp"
 
+#include <algorithm>
+
 struct BasebandReplay {
-	BasebandReplay(ReplayConfig* const config) {
-		baseband::replay_start(config);
+	BasebandReplay(
+		ReplayConfig* const config,
+		const ReplayThread::Sink sink
+	) : sink { sink }
+	{
+		if( sink == ReplayThread::Sink::Decode ) {
+			baseband::file_source_start(config);
+		} else {
+			baseband::replay_start(config);
+		}
 	}
 
 	~BasebandReplay() {
-		baseband::replay_stop();
+		if( sink == ReplayThread::Sink::Decode ) {
+			baseband::file_source_stop();
+		} else {
+			baseband::replay_stop();
+		}
 	}
+
+private:
+	const ReplayThread::Sink sink;
 };
 
 // ReplayThread ///////////////////////////////////////////////////////////
@@ -41,11 +58,12 @@ ReplayThread::ReplayThread(
 	std::unique_ptr<stream::Reader> reader,
 	size_t read_size,
 	size_t buffer_count,
-	bool* ready_signal,
-	std::function<void(uint32_t return_code)> terminate_callback
-) : config { read_size, buffer_count },
+	std::function<void(uint32_t return_code)> terminate_callback,
+	ReplayConfig::Format format,
+	const Sink sink
+) : config { read_size, buffer_count, format },
+	sink { sink },
 	reader { std::move(reader) },
-	ready_sig { ready_signal },
 	terminate_callback { std::move(terminate_callback) }
 {
 	// Need significant stack for FATFS
@@ -61,6 +79,7 @@ ReplayThread::~ReplayThread() {
 }
 
 msg_t ReplayThread::static_fn(void* arg) {
+	chRegSetThreadName("replay");
 	auto obj = static_cast<ReplayThread*>(arg);
 	const auto return_code = obj->run();
 	if( obj->terminate_callback ) {
@@ -70,45 +89,37 @@ msg_t ReplayThread::static_fn(void* arg) {
 }
 
 uint32_t ReplayThread::run() {
-	BasebandReplay replay { &config };
+	BasebandReplay replay { &config, sink };
 	BufferExchange buffers { &config };
-	
-	StreamBuffer* prefill_buffer { nullptr };
-	
-	// Wait for FIFOs to be allocated in baseband
-	// Wait for ui_replay_view to tell us that the buffers are ready (awful :( )
-	while (!(*ready_sig)) {
-		chThdSleep(100);
-	};
-	
-	// While empty buffers fifo is not empty...
-	while (!buffers.empty()) {
-		prefill_buffer = buffers.get_prefill();
-		
-		if (prefill_buffer == nullptr) {
-			buffers.put_app(prefill_buffer);
-		} else {
-			size_t blocks = config.read_size / 512;
-			
-			for (size_t c = 0; c < blocks; c++) {
-				auto read_result = reader->read(&((uint8_t*)prefill_buffer->data())[c * 512], 512);
-				if( read_result.is_error() ) {
-					return READ_ERROR;
-				}
-			}
-			
-			prefill_buffer->set_size(config.read_size);
-			
-			buffers.put(prefill_buffer);
+
+	// The baseband handles ReplayConfigMessage before send_message() returns,
+	// so its buffers and FIFOs are already in place here.
+	if( !config.fifo_buffers_empty || !config.fifo_buffers_full ) {
+		return READ_ERROR;
+	}
+
+	// Fill every buffer before letting the baseband start.
+	StreamBuffer* buffer = buffers.get_prefill();
+	while( buffer ) {
+		StreamBuffer* next_buffer { nullptr };
+		auto read_result = read_run(buffers, buffer, next_buffer);
+		if( read_result.is_error() ) {
+			return READ_ERROR;
 		}
-	};
-	
-	baseband::set_fifo_data(nullptr);
+		buffer = next_buffer ? next_buffer : buffers.get_prefill();
+	}
 
+	// The decoder just reads what's there, no go-ahead needed.
+	if( sink == Sink::Transmit ) {
+		baseband::set_fifo_data(nullptr);
+	}
+
+	StreamBuffer* next_buffer { nullptr };
 	while( !chThdShouldTerminate() ) {
-		auto buffer = buffers.get();
-		
-		auto read_result = reader->read(buffer->data(), buffer->capacity());
+		buffer = next_buffer ? next_buffer : buffers.get();
+		next_buffer = nullptr;
+
+		auto read_result = read_run(buffers, buffer, next_buffer);
 		if( read_result.is_error() ) {
 			return READ_ERROR;
 		} else {
@@ -116,11 +127,48 @@ uint32_t ReplayThread::run() {
 				return END_OF_FILE;
 			}
 		}
-		
-		buffer->set_size(buffer->capacity());
-		
-		buffers.put(buffer);
 	}
 
 	return TERMINATED;
 }
+
+File::Result<File::Size> ReplayThread::read_run(BufferExchange& buffers, StreamBuffer* const first, StreamBuffer*& next) {
+	// Baseband allocates its StreamBuffers back to back, so empty buffers
+	// that are adjacent in memory are refilled with a single large read.
+	std::array<StreamBuffer*, read_buffers_max> pending { };
+	size_t pending_count = 0;
+	pending[pending_count++] = first;
+
+	auto read_data = static_cast<uint8_t*>(first->data());
+	size_t read_bytes = first->capacity();
+	while( pending_count < pending.size() ) {
+		auto buffer = buffers.get_prefill();
+		if( !buffer ) {
+			break;
+		}
+		if( (buffer->data() != &read_data[read_bytes]) || ((read_bytes + buffer->capacity()) > read_block_max) ) {
+			next = buffer;
+			break;
+		}
+		pending[pending_count++] = buffer;
+		read_bytes += buffer->capacity();
+	}
+
+	const auto read_start = chTimeNow();
+	auto read_result = reader->read(read_data, read_bytes);
+	if( read_result.is_error() ) {
+		return read_result;
+	}
+	config.statistics.record_latency((chTimeNow() - read_start) * 1000 / CH_FREQUENCY);
+
+	// A short read at end of file leaves the trailing buffers empty.
+	auto remaining = read_result.value();
+	for(size_t i=0; i<pending_count; i++) {
+		const auto size = std::min<File::Size>(remaining, pending[i]->capacity());
+		pending[i]->set_size(size);
+		remaining -= size;
+		buffers.put(pending[i]);
+	}
+
+	return read_result;
+}
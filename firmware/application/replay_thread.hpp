@@ -33,15 +33,27 @@
 #include <cstdint>
 #include <cstddef>
 #include <utility>
+#include <array>
+
+class BufferExchange;
 
 class ReplayThread {
 public:
+	/* Where the stream goes: the replay image's transmitter, or the running
+	 * receive processor for offline decoding (baseband::file_source_start()).
+	 */
+	enum class Sink {
+		Transmit,
+		Decode,
+	};
+
 	ReplayThread(
 		std::unique_ptr<stream::Reader> reader,
 		size_t read_size,
 		size_t buffer_count,
-		bool* ready_signal,
-		std::function<void(uint32_t return_code)> terminate_callback
+		std::function<void(uint32_t return_code)> terminate_callback,
+		ReplayConfig::Format format = ReplayConfig::Format::C16,
+		const Sink sink = Sink::Transmit
 	);
 	~ReplayThread();
 
@@ -61,15 +73,20 @@ public:
 	};
 
 private:
+	static constexpr size_t read_buffers_max = 8;
+	static constexpr size_t read_block_max = 65536;
+
 	ReplayConfig config;
+	const Sink sink;
 	std::unique_ptr<stream::Reader> reader;
-	bool* ready_sig;
 	std::function<void(uint32_t return_code)> terminate_callback;
 	Thread* thread { nullptr };
 
 	static msg_t static_fn(void* arg);
 
 	uint32_t run();
+
+	File::Result<File::Size> read_run(BufferExchange& buffers, StreamBuffer* const first, StreamBuffer*& next);
 };
 
 #endif/*__REPLAY_THREAD_H__*/
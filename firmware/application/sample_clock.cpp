@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "sample_clock.hpp"
+
+#include "portapack_shared_memory.hpp"
+
+#include "ch.h"
+#include "hal.h"
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+namespace sample_clock {
+
+namespace {
+
+struct Capture {
+	uint32_t tick;
+	uint32_t generation;
+	uint64_t sample_index;
+	bool live;
+};
+
+struct Point {
+	uint32_t tick;
+	uint64_t sample_index;
+};
+
+constexpr size_t points_min = 4;
+
+Capture captured { 0, 0, 0, false };
+
+std::array<Point, 16> history { };
+size_t history_count { 0 };
+size_t history_next { 0 };
+uint32_t history_generation { 0 };
+
+rtc::RTC tick_datetime { };
+bool fit_valid { false };
+uint64_t fit_index { 0 };	// Sample index of the newest point
+double fit_offset { 0 };	// Fitted index at the newest tick, relative to fit_index
+double fit_rate { 0 };		// Samples per second
+
+/* Days since 1970-01-01, proleptic Gregorian. */
+int32_t days_from_civil(int32_t y, const int32_t m, const int32_t d) {
+	y -= (m <= 2) ? 1 : 0;
+	const int32_t era = y / 400;
+	const int32_t yoe = y - era * 400;
+	const int32_t doy = (153 * (m + ((m > 2) ? -3 : 9)) + 2) / 5 + d - 1;
+	const int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + doe - 719468;
+}
+
+rtc::RTC civil_from_seconds(const int64_t seconds) {
+	const int32_t z = seconds / 86400 + 719468;
+	const int32_t second_of_day = seconds % 86400;
+	const int32_t era = z / 146097;
+	const int32_t doe = z - era * 146097;
+	const int32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	const int32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	const int32_t mp = (5 * doy + 2) / 153;
+	const int32_t d = doy - (153 * mp + 2) / 5 + 1;
+	const int32_t m = (mp < 10) ? (mp + 3) : (mp - 9);
+	const int32_t y = yoe + era * 400 + ((m <= 2) ? 1 : 0);
+	return {
+		static_cast<uint32_t>(y), static_cast<uint32_t>(m), static_cast<uint32_t>(d),
+		static_cast<uint32_t>(second_of_day / 3600),
+		static_cast<uint32_t>((second_of_day / 60) % 60),
+		static_cast<uint32_t>(second_of_day % 60)
+	};
+}
+
+int64_t seconds_from_civil(const rtc::RTC& datetime) {
+	return static_cast<int64_t>(days_from_civil(datetime.year(), datetime.month(), datetime.day())) * 86400
+		+ datetime.hour() * 3600 + datetime.minute() * 60 + datetime.second();
+}
+
+/* Least squares, index against tick, relative to the newest point. */
+void fit() {
+	fit_valid = false;
+	if( history_count < points_min ) {
+		return;
+	}
+
+	const auto& newest = history[(history_next + history.size() - 1) % history.size()];
+	double sx = 0, sy = 0, sxx = 0, sxy = 0;
+	for(size_t i=0; i<history_count; i++) {
+		const auto& p = history[i];
+		const double x = -static_cast<double>(newest.tick - p.tick);
+		const double y = -static_cast<double>(newest.sample_index - p.sample_index);
+		sx += x;
+		sy += y;
+		sxx += x * x;
+		sxy += x * y;
+	}
+	const double n = history_count;
+	const double d = n * sxx - sx * sx;
+	if( d <= 0 ) {
+		return;
+	}
+
+	fit_rate = (n * sxy - sx * sy) / d;
+	fit_offset = (sy - fit_rate * sx) / n;
+	fit_index = newest.sample_index;
+	fit_valid = (fit_rate > 0);
+}
+
+} /* namespace */
+
+void capture() {
+	const auto& clock = shared_memory.sample_clock;
+	const uint32_t generation = clock.generation;
+	__DMB();
+	const uint32_t sequence = clock.sequence;
+	const uint64_t base = clock.base;
+	const uint32_t transfer_samples = clock.transfer_samples;
+	const uint32_t sampling_rate = clock.sampling_rate;
+	__DMB();
+
+	captured.tick++;
+	captured.generation = generation;
+	captured.live = ((generation & 1) == 0) && (clock.generation == generation)
+		&& sampling_rate && (sequence != 0xffffffff);
+	// The newest transfer completed somewhere in the last transfer period,
+	// on average half of one ago.
+	captured.sample_index = base + static_cast<uint64_t>(sequence + 1) * transfer_samples + transfer_samples / 2;
+}
+
+void update() {
+	chSysLock();
+	const auto c = captured;
+	chSysUnlock();
+
+	if( !c.live || (c.generation != history_generation) ) {
+		history_count = 0;
+		history_next = 0;
+		history_generation = c.generation;
+		fit_valid = false;
+	}
+	if( !c.live ) {
+		return;
+	}
+	if( history_count && (history[(history_next + history.size() - 1) % history.size()].tick == c.tick) ) {
+		return;
+	}
+
+	rtcGetTime(&RTCD1, &tick_datetime);
+	history[history_next] = { c.tick, c.sample_index };
+	history_next = (history_next + 1) % history.size();
+	history_count = std::min(history_count + 1, history.size());
+	fit();
+}
+
+bool time(const uint64_t sample_index, Time& result) {
+	if( !fit_valid || (sample_index == 0) ) {
+		return false;
+	}
+
+	// Seconds from the start of the newest tick's RTC second
+	const double relative = static_cast<double>(static_cast<int64_t>(sample_index - fit_index));
+	const double seconds = (relative - fit_offset) / fit_rate;
+	const double whole = std::floor(seconds);
+	const uint32_t microseconds = (seconds - whole) * 1000000.0;
+
+	result.datetime = civil_from_seconds(seconds_from_civil(tick_datetime) + static_cast<int64_t>(whole));
+	result.microseconds = std::min(microseconds, static_cast<uint32_t>(999999));
+	return true;
+}
+
+} /* namespace sample_clock */
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SAMPLE_CLOCK_H__
+#define __SAMPLE_CLOCK_H__
+
+#include "lpc43xx_cpp.hpp"
+using namespace lpc43xx;
+
+#include <cstdint>
+
+/* Baseband sample indices (buffer_t::sample_index, stamped on decoded
+ * packets) to wall clock time, to well under a millisecond. Each RTC
+ * second the M4's published SampleClockState is sampled, and a line fit
+ * over the last 16 seconds of (second, sample index) pairs maps indices
+ * back to RTC seconds plus microseconds. Restarted whenever the M4 starts
+ * a new stream or changes rate.
+ */
+namespace sample_clock {
+
+struct Time {
+	rtc::RTC datetime;
+	uint32_t microseconds;
+};
+
+/* From RTC_IRQHandler, at the start of the second. */
+void capture();
+
+/* From the event loop's RTC tick, after capture(). */
+void update();
+
+/* false until a few seconds into a stream, and for index 0 (a packet
+ * from a decoder that doesn't track sample indices).
+ */
+bool time(const uint64_t sample_index, Time& result);
+
+} /* namespace sample_clock */
+
+#endif/*__SAMPLE_CLOCK_H__*/
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "screenshot_thread.hpp"
+
+#include "portapack.hpp"
+#include "png_writer.hpp"
+
+#include <array>
+
+using namespace ui;
+
+namespace {
+
+constexpr int screen_width = 240;
+constexpr int screen_height = 320;
+
+using Scanline = std::array<ColorRGB888, screen_width>;
+
+bool same_color(const ColorRGB888& a, const ColorRGB888& b) {
+	return (a.r == b.r) && (a.g == b.g) && (a.b == b.b);
+}
+
+} /* namespace */
+
+std::unique_ptr<ScreenshotThread> ScreenshotThread::capture(const std::filesystem::path& path) {
+	// Take what the heap can spare; a smaller buffer only means more screens
+	// fall back to the direct path.
+	std::unique_ptr<uint8_t[]> runs;
+	size_t runs_capacity = runs_size_max;
+	for(; runs_capacity >= runs_size_min; runs_capacity /= 2) {
+		runs = std::make_unique<uint8_t[]>(runs_capacity);
+		if( runs ) {
+			break;
+		}
+	}
+	if( !runs ) {
+		return nullptr;
+	}
+
+	size_t used = 0;
+	for(int y = 0; y < screen_height; y++) {
+		Scanline row;
+		portapack::display.read_pixels({ 0, y, screen_width, 1 }, row);
+
+		for(size_t x = 0; x < row.size(); ) {
+			size_t length = 1;
+			while( (x + length < row.size()) && (length < 256) && same_color(row[x + length], row[x]) ) {
+				length++;
+			}
+			if( used + run_size > runs_capacity ) {
+				return nullptr;
+			}
+			runs[used++] = length - 1;
+			runs[used++] = row[x].r;
+			runs[used++] = row[x].g;
+			runs[used++] = row[x].b;
+			x += length;
+		}
+	}
+
+	return std::make_unique<ScreenshotThread>(path, std::move(runs), used);
+}
+
+ScreenshotThread::ScreenshotThread(
+	const std::filesystem::path& path,
+	std::unique_ptr<uint8_t[]> runs,
+	const size_t runs_size
+) : path { path },
+	runs { std::move(runs) },
+	runs_size { runs_size }
+{
+	// Room for FatFs and PNGWriter's match search.
+	thread = chThdCreateFromHeap(NULL, 2048, LOWPRIO, ScreenshotThread::static_fn, this);
+}
+
+ScreenshotThread::~ScreenshotThread() {
+	if( thread ) {
+		// Let a pending PNG finish, cutting it short would leave a broken file.
+		chThdWait(thread);
+		thread = nullptr;
+	}
+}
+
+msg_t ScreenshotThread::static_fn(void* arg) {
+	chRegSetThreadName("screen");
+	auto obj = static_cast<ScreenshotThread*>(arg);
+	obj->run();
+	return 0;
+}
+
+void ScreenshotThread::run() {
+	// Holds its compression buffers, too big for the stack
+	auto png = std::make_unique<PNGWriter>();
+	if( png && !png->create(path).is_valid() ) {
+		size_t offset = 0;
+		for(int y = 0; y < screen_height; y++) {
+			Scanline row;
+			for(size_t x = 0; (x < row.size()) && (offset + run_size <= runs_size); offset += run_size) {
+				const size_t length = runs[offset] + 1;
+				const ColorRGB888 color { runs[offset + 1], runs[offset + 2], runs[offset + 3] };
+				for(size_t n = 0; n < length; n++) {
+					row[x++] = color;
+				}
+			}
+			png->write_scanline(row);
+		}
+	}
+
+	// Finishes the file before anyone sees done.
+	png.reset();
+	runs.reset();
+	done = true;
+}
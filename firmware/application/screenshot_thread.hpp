@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SCREENSHOT_THREAD_H__
+#define __SCREENSHOT_THREAD_H__
+
+#include "ch.h"
+
+#include "file.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+/* Writes a screenshot without holding up the UI thread: capture() copies the
+ * LCD into run-length coded rows, a few milliseconds, and a low priority
+ * thread then compresses them into a PNG on the SD card while the event loop
+ * carries on.
+ *
+ * Runs are (length - 1, r, g, b) and never cross a row. Busy screens (a full
+ * waterfall) don't fit in runs_size_max; capture() returns nullptr for those
+ * and the caller writes the PNG directly instead.
+ */
+
+class ScreenshotThread {
+public:
+	static std::unique_ptr<ScreenshotThread> capture(const std::filesystem::path& path);
+
+	ScreenshotThread(
+		const std::filesystem::path& path,
+		std::unique_ptr<uint8_t[]> runs,
+		const size_t runs_size
+	);
+	~ScreenshotThread();
+
+	ScreenshotThread(const ScreenshotThread&) = delete;
+	ScreenshotThread(ScreenshotThread&&) = delete;
+	ScreenshotThread& operator=(const ScreenshotThread&) = delete;
+	ScreenshotThread& operator=(ScreenshotThread&&) = delete;
+
+	bool is_done() const {
+		return done;
+	}
+
+private:
+	static constexpr size_t runs_size_max = 32768;
+	static constexpr size_t runs_size_min = 8192;
+	static constexpr size_t run_size = 4;
+
+	const std::filesystem::path path;
+	std::unique_ptr<uint8_t[]> runs;
+	const size_t runs_size;
+	volatile bool done { false };
+	Thread* thread { nullptr };
+
+	static msg_t static_fn(void* arg);
+
+	void run();
+};
+
+#endif/*__SCREENSHOT_THREAD_H__*/
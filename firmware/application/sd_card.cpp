@@ -25,6 +25,8 @@
 
 #include "ff.h"
 
+#include "portapack_persistent_memory.hpp"
+
 namespace sd_card {
 
 FATFS fs;
@@ -54,6 +56,9 @@ void poll_inserted() {
 			if( sdcConnect(&SDCD1) == CH_SUCCESS ) {
 				if( mount() == FR_OK ) {
 					new_status = Status::Mounted;
+					if( portapack::persistent_memory::sd_card_high_speed(card_id()) ) {
+						set_high_speed(true);
+					}
 				} else {
 					new_status = Status::MountError;
 				}
@@ -73,4 +78,28 @@ Status status() {
 	return status_;
 }
 
+uint32_t card_id() {
+	const uint32_t id = SDCD1.cid[0] ^ SDCD1.cid[1] ^ SDCD1.cid[2] ^ SDCD1.cid[3];
+	return id ? id : 1;
+}
+
+bool set_high_speed(const bool enable) {
+	if( !card_present ) {
+		return false;
+	}
+
+	// Keep FatFs off the bus while the clock changes.
+	if( !ff_req_grant(fs.sobj) ) {
+		return false;
+	}
+	const auto result = sdc_lld_set_high_speed(&SDCD1, enable ? TRUE : FALSE);
+	ff_rel_grant(fs.sobj);
+
+	return result == CH_SUCCESS;
+}
+
+uint32_t clock_frequency() {
+	return sdc_lld_get_clk_frequency(&SDCD1);
+}
+
 } /* namespace sd_card */
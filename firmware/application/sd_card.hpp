@@ -45,6 +45,15 @@ extern Signal<Status> status_signal;
 void poll_inserted();
 Status status();
 
+/* Folded CID, to tell cards apart in persistent settings. Never zero. */
+uint32_t card_id();
+
+/* CMD6 high speed (50MHz clock) if the card supports it, or back to default
+ * speed. Returns false if the card couldn't switch.
+ */
+bool set_high_speed(const bool enable);
+uint32_t clock_frequency();
+
 } /* namespace sd_card */
 
 #endif/*__SD_CARD_H__*/
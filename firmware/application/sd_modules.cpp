@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "sd_modules.hpp"
+
+#include "file.hpp"
+#include "sd_card.hpp"
+#include "crc.hpp"
+
+#include <cstring>
+#include <memory>
+
+namespace sd_modules {
+
+namespace {
+
+constexpr size_t header_size = 512;
+constexpr uint16_t version = 3;
+// Tags and the odd comment, a few dozen lines.
+constexpr size_t index_size_max = 2048;
+
+struct Header {
+	char magic[4];
+	uint16_t version;
+	uint32_t length;
+	char name[16];
+	char tag[4];
+	uint32_t crc;
+} __attribute__((packed));
+
+static_assert(sizeof(Header) == 34, "sd_modules::Header layout");
+
+bool find_file(const portapack::spi_flash::image_tag_t image_tag, std::filesystem::path& path) {
+	File index;
+	if( index.open(u"/APPS/INDEX.TXT").is_valid() ) {
+		return false;
+	}
+
+	auto text = std::make_unique<char[]>(index_size_max);
+	if( !text ) {
+		return false;
+	}
+	const auto read_result = index.read(text.get(), index_size_max);
+	if( read_result.is_error() ) {
+		return false;
+	}
+	const size_t text_size = read_result.value();
+
+	for(size_t line=0; line<text_size; ) {
+		size_t end = line;
+		while( (end < text_size) && (text[end] != '\n') ) {
+			end++;
+		}
+
+		// "<tag> <file>", CR LF or LF.
+		size_t name_end = end;
+		while( (name_end > line) && ((text[name_end - 1] == '\r') || (text[name_end - 1] == ' ')) ) {
+			name_end--;
+		}
+		if( (text[line] != '#') && (name_end > line + 5) && (text[line + 4] == ' ') ) {
+			const portapack::spi_flash::image_tag_t tag { text[line + 0], text[line + 1], text[line + 2], text[line + 3] };
+			if( tag == image_tag ) {
+				path = u"/APPS/";
+				path += std::filesystem::path { &text[line + 5], &text[name_end] };
+				return true;
+			}
+		}
+
+		line = end + 1;
+	}
+	return false;
+}
+
+} /* namespace */
+
+size_t load(const portapack::spi_flash::image_tag_t image_tag, const portapack::memory::region_t to) {
+	if( sd_card::status() != sd_card::Status::Mounted ) {
+		return 0;
+	}
+
+	std::filesystem::path path;
+	if( !find_file(image_tag, path) ) {
+		return 0;
+	}
+
+	File file;
+	if( file.open(path).is_valid() ) {
+		return 0;
+	}
+
+	Header header;
+	const auto header_result = file.read(&header, sizeof(header));
+	if( header_result.is_error() || (header_result.value() != sizeof(header)) ) {
+		return 0;
+	}
+	const portapack::spi_flash::image_tag_t header_tag { header.tag[0], header.tag[1], header.tag[2], header.tag[3] };
+	if( (std::memcmp(header.magic, "PPM ", 4) != 0) ||
+		(header.version != version) ||
+		!(header_tag == image_tag) ||
+		(header.length == 0) || (header.length > to.size()) ) {
+		return 0;
+	}
+
+	// Whole sectors, the last maybe short at end of file; M4 RAM is a
+	// multiple of them, so rounding up never runs past it.
+	const File::Size blocks_size = (header.length + File::block_size - 1) & ~(File::block_size - 1);
+	if( file.seek(header_size).is_error() ) {
+		return 0;
+	}
+	const auto data = reinterpret_cast<uint8_t*>(to.base());
+	const auto read_result = file.read_blocks(data, blocks_size);
+	if( read_result.is_error() || (read_result.value() < header.length) ) {
+		return 0;
+	}
+
+	TableCRC<32, 0x04c11db7, true, true, 4> crc { 0xffffffff, 0xffffffff };
+	crc.process_bytes(data, header.length);
+	if( crc.checksum() != header.crc ) {
+		return 0;
+	}
+
+	return header.length;
+}
+
+} /* namespace sd_modules */
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SD_MODULES_H__
+#define __SD_MODULES_H__
+
+#include "memory_map.hpp"
+#include "spi_image.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+/* Baseband images on the SD card, which run_image() prefers to those in
+ * SPI flash: a new or rebuilt processor goes on the card without
+ * reflashing.
+ *
+ * /APPS/INDEX.TXT lists them, one "<tag> <file>" line each, e.g.
+ * "PSON proc_sonde.ppm", files relative to /APPS/; '#' starts a comment. Each
+ * file is a 512 byte header, little endian:
+ *
+ *   0   "PPM "
+ *   4   version (u16), 3
+ *   6   image length (u32)
+ *   10  name, zero padded (16)
+ *   26  tag (4)
+ *   30  CRC-32 of the image, as PNG and zlib's (u32)
+ *
+ * then the image, uncompressed, from the second sector on. That is read in
+ * one go straight into M4 RAM, whole sectors by SD card DMA, then checked
+ * against the header's CRC. tools/make_sd_modules.py writes both.
+ */
+namespace sd_modules {
+
+/* Copies the tag's image into to, returning its length; 0 when the card
+ * has none, or a bad one, and SPI flash should be used instead.
+ */
+size_t load(const portapack::spi_flash::image_tag_t image_tag, const portapack::memory::region_t to);
+
+} /* namespace sd_modules */
+
+#endif/*__SD_MODULES_H__*/
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "settings_store.hpp"
+
+#include "msgpack.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Past a snapshot and a commit of everything, the file isn't ours
+constexpr File::Size read_max = 32768;
+
+} /* namespace */
+
+SettingsStore::SettingsStore(
+	const std::string& name
+) : name { name }
+{
+}
+
+SettingsStore::~SettingsStore() {
+	commit();
+}
+
+std::filesystem::path SettingsStore::path(const std::string& extension) const {
+	return "SETTINGS/" + name + extension;
+}
+
+int64_t SettingsStore::get_int(const uint16_t key, const int64_t default_value) {
+	const auto entry = find(key);
+	return (entry && (entry->type == Type::Int)) ? entry->value : default_value;
+}
+
+bool SettingsStore::get_bool(const uint16_t key, const bool default_value) {
+	const auto entry = find(key);
+	return (entry && (entry->type == Type::Bool)) ? (entry->value != 0) : default_value;
+}
+
+std::string SettingsStore::get_string(const uint16_t key, const std::string& default_value) {
+	const auto entry = find(key);
+	return (entry && (entry->type == Type::String)) ? entry->string : default_value;
+}
+
+void SettingsStore::set_int(const uint16_t key, const int64_t value) {
+	auto entry = set(key, Type::Int);
+	if( entry && (entry->value != value) ) {
+		entry->value = value;
+		entry->dirty = true;
+	}
+}
+
+void SettingsStore::set_bool(const uint16_t key, const bool value) {
+	auto entry = set(key, Type::Bool);
+	if( entry && (entry->value != value) ) {
+		entry->value = value;
+		entry->dirty = true;
+	}
+}
+
+void SettingsStore::set_string(const uint16_t key, const std::string& value) {
+	auto entry = set(key, Type::String);
+	const auto truncated = value.substr(0, string_length_max);
+	if( entry && (entry->string != truncated) ) {
+		entry->string = truncated;
+		entry->dirty = true;
+	}
+}
+
+SettingsStore::Entry* SettingsStore::find(const uint16_t key) {
+	if( !loaded ) {
+		load();
+	}
+
+	const auto it = std::find_if(entries.begin(), entries.end(),
+		[key](const Entry& entry) { return entry.key == key; });
+	return (it != entries.end()) ? &*it : nullptr;
+}
+
+/* The key's entry, made or retyped as needed. A type change always counts
+ * as a change, so it reaches the file.
+ */
+SettingsStore::Entry* SettingsStore::set(const uint16_t key, const Type type) {
+	auto entry = find(key);
+	if( !entry ) {
+		if( entries.size() >= entries_max ) {
+			return nullptr;
+		}
+		entries.push_back({ key, type, true, 0, { } });
+		return &entries.back();
+	}
+	if( entry->type != type ) {
+		*entry = { key, type, true, 0, { } };
+	}
+	return entry;
+}
+
+void SettingsStore::load() {
+	loaded = true;
+
+	File file;
+	auto error = file.open(path(".SET"));
+	if( error.is_valid() ) {
+		// Power lost between a snapshot's delete and rename
+		error = file.open(path(".TMP"));
+		if( error.is_valid() ) {
+			return;
+		}
+	}
+
+	const size_t size = std::min(file.size(), read_max);
+	std::vector<uint8_t> data(size);
+	const auto result = file.read(data.data(), size);
+	if( result.is_error() ) {
+		return;
+	}
+
+	replay(data.data(), result.value());
+}
+
+void SettingsStore::replay(const uint8_t* const data, const size_t size) {
+	MsgPack msgpack;
+	size_t offset = 0;
+
+	while( offset < size ) {
+		const size_t length = msgpack.msgpack_length(&data[offset], size - offset);
+		if( length == 0 ) {
+			break;
+		}
+
+		const auto map = &data[offset];
+		uint16_t key;
+		msgpack.msgpack_begin(map, length);
+		while( msgpack.msgpack_next(map, &key) ) {
+			bool flag;
+			int64_t value;
+			const char* chars;
+			size_t chars_length;
+
+			Entry* entry = nullptr;
+			if( msgpack.msgpack_value(map, &flag) ) {
+				entry = set(key, Type::Bool);
+				if( entry ) entry->value = flag;
+			} else if( msgpack.msgpack_value(map, &value) ) {
+				entry = set(key, Type::Int);
+				if( entry ) entry->value = value;
+			} else if( msgpack.msgpack_value(map, &chars, &chars_length) ) {
+				entry = set(key, Type::String);
+				if( entry ) entry->string.assign(chars, chars_length);
+			}
+			if( entry ) {
+				entry->dirty = false;
+			}
+		}
+
+		offset += length;
+	}
+
+	journal_size = offset;
+	snapshot_due = (offset == 0) || (offset < size);
+}
+
+std::vector<uint8_t> SettingsStore::encode(const bool dirty_only) const {
+	size_t size = 3;
+	for(const auto& entry : entries) {
+		if( dirty_only && !entry.dirty ) {
+			continue;
+		}
+		switch(entry.type) {
+		case Type::Bool:	size += 3 + 1;						break;
+		case Type::Int:		size += 3 + 9;						break;
+		case Type::String:	size += 3 + 2 + entry.string.size();	break;
+		}
+	}
+
+	MsgPack msgpack;
+	std::vector<uint8_t> buffer(size);
+	size_t ptr;
+	msgpack.msgpack_init(buffer.data(), &ptr);
+	for(const auto& entry : entries) {
+		if( dirty_only && !entry.dirty ) {
+			continue;
+		}
+		switch(entry.type) {
+		case Type::Bool:	msgpack.msgpack_add(buffer.data(), &ptr, entry.key, entry.value != 0);	break;
+		case Type::Int:		msgpack.msgpack_add(buffer.data(), &ptr, entry.key, entry.value);		break;
+		case Type::String:	msgpack.msgpack_add(buffer.data(), &ptr, entry.key, entry.string);		break;
+		}
+	}
+	buffer.resize(ptr);
+
+	return buffer;
+}
+
+Optional<File::Error> SettingsStore::commit() {
+	const bool dirty = std::any_of(entries.begin(), entries.end(),
+		[](const Entry& entry) { return entry.dirty; });
+	if( !dirty ) {
+		return { };
+	}
+
+	const auto error = (snapshot_due || (journal_size >= journal_max)) ? write_snapshot() : append_changes();
+	if( error.is_valid() ) {
+		return error;
+	}
+
+	for(auto& entry : entries) {
+		entry.dirty = false;
+	}
+	return { };
+}
+
+Optional<File::Error> SettingsStore::append_changes() {
+	const auto map = encode(true);
+
+	File file;
+	const auto error = file.append(path(".SET"));
+	if( error.is_valid() ) {
+		return error;
+	}
+	const auto result = file.write(map.data(), map.size());
+	if( result.is_error() ) {
+		return { result.error() };
+	}
+
+	journal_size += map.size();
+	return { };
+}
+
+Optional<File::Error> SettingsStore::write_snapshot() {
+	const auto map = encode(false);
+
+	make_new_directory("SETTINGS");
+	{
+		File file;
+		const auto error = file.create(path(".TMP"));
+		if( error.is_valid() ) {
+			return error;
+		}
+		const auto result = file.write(map.data(), map.size());
+		if( result.is_error() ) {
+			return { result.error() };
+		}
+	}
+	delete_file(path(".SET"));
+	rename_file(path(".TMP"), path(".SET"));
+
+	journal_size = map.size();
+	snapshot_due = false;
+	return { };
+}
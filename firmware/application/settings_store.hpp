@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __SETTINGS_STORE_H__
+#define __SETTINGS_STORE_H__
+
+#include "file.hpp"
+#include "optional.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/* Key-value settings for one app, in SETTINGS/<name>.SET on the SD card,
+ * for state that doesn't belong in persistent_memory's 256 bytes of backup
+ * RAM. Nothing is read until the first get or set, so an app pays for its
+ * settings when it opens rather than everyone at boot.
+ *
+ * Changes stay in RAM until commit(), or the store going away. The file is
+ * a journal of MsgPack map16s: a snapshot of every key, then a map per
+ * commit of just the keys it changed. Loading replays them in order, later
+ * values winning, and stops at a map cut short by a power loss. Appends
+ * touch a sector or two; once the journal reaches journal_max, the next
+ * commit writes a fresh snapshot through a .TMP file instead.
+ */
+class SettingsStore {
+public:
+	explicit SettingsStore(const std::string& name);
+	~SettingsStore();
+
+	SettingsStore(const SettingsStore&) = delete;
+	SettingsStore& operator=(const SettingsStore&) = delete;
+
+	int64_t get_int(const uint16_t key, const int64_t default_value);
+	bool get_bool(const uint16_t key, const bool default_value);
+	std::string get_string(const uint16_t key, const std::string& default_value);
+
+	void set_int(const uint16_t key, const int64_t value);
+	void set_bool(const uint16_t key, const bool value);
+	/* Strings longer than string_length_max are cut short. */
+	void set_string(const uint16_t key, const std::string& value);
+
+	Optional<File::Error> commit();
+
+private:
+	static constexpr size_t entries_max = 64;
+	static constexpr size_t string_length_max = 255;
+	static constexpr File::Size journal_max = 4096;
+
+	enum class Type : uint8_t {
+		Bool,
+		Int,
+		String,
+	};
+
+	struct Entry {
+		uint16_t key;
+		Type type;
+		bool dirty;
+		int64_t value;
+		std::string string;
+	};
+
+	const std::string name;
+	bool loaded { false };
+	// Snapshot before the next append: no file yet, or junk after the last map
+	bool snapshot_due { true };
+	File::Size journal_size { 0 };
+	std::vector<Entry> entries { };
+
+	std::filesystem::path path(const std::string& extension) const;
+	void load();
+	void replay(const uint8_t* const data, const size_t size);
+	Entry* find(const uint16_t key);
+	Entry* set(const uint16_t key, const Type type);
+	std::vector<uint8_t> encode(const bool dirty_only) const;
+	Optional<File::Error> write_snapshot();
+	Optional<File::Error> append_changes();
+};
+
+#endif/*__SETTINGS_STORE_H__*/
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "sonde_predictor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float meters_per_degree = 111320.0f;
+constexpr float pi = 3.14159265358979323846f;
+// Twice the atmosphere's scale height: drag goes with density, speed with its square root.
+constexpr float density_height_2 = 14000.0f;
+// Slower than this either way is a float, or GPS noise.
+constexpr float descending_rate = -1.0f;
+constexpr float ascent_rate_min = 1.0f;
+
+float meters_per_degree_lon(const float lat) {
+	return meters_per_degree * std::max(std::cos(lat * (pi / 180.0f)), 0.01f);
+}
+
+} /* namespace */
+
+SondePredictor::SondePredictor() {
+	chMtxInit(&mutex);
+	chSemInit(&pending, 0);
+	// A few floats deep, no file I/O.
+	thread = chThdCreateFromHeap(NULL, 1024, LOWPRIO, SondePredictor::static_fn, this);
+}
+
+SondePredictor::~SondePredictor() {
+	if( thread ) {
+		stop = true;
+		chSemSignal(&pending);
+		chThdWait(thread);
+		thread = nullptr;
+	}
+}
+
+void SondePredictor::add_fix(const int32_t altitude, const float lat, const float lon) {
+	const Fix fix { chTimeNow(), altitude, lat, lon };
+
+	chMtxLock(&mutex);
+	// Full: the thread is behind, the oldest goes.
+	if( (fixes_in - fixes_out) == fixes.size() ) {
+		fixes_out++;
+	}
+	fixes[fixes_in++ % fixes.size()] = fix;
+	chMtxUnlock();
+
+	chSemSignal(&pending);
+}
+
+SondePredictor::Prediction SondePredictor::prediction() {
+	chMtxLock(&mutex);
+	const auto copy = result;
+	chMtxUnlock();
+	return copy;
+}
+
+msg_t SondePredictor::static_fn(void* arg) {
+	chRegSetThreadName("sonde");
+	auto obj = static_cast<SondePredictor*>(arg);
+	obj->run();
+	return 0;
+}
+
+void SondePredictor::run() {
+	while( !stop ) {
+		chSemWait(&pending);
+
+		bool updated = false;
+		Fix fix;
+		while( next_fix(fix) ) {
+			update(fix);
+			updated = true;
+		}
+
+		if( updated && have_rate ) {
+			const auto next = predict();
+			chMtxLock(&mutex);
+			result = next;
+			chMtxUnlock();
+		}
+	}
+}
+
+bool SondePredictor::next_fix(Fix& next) {
+	chMtxLock(&mutex);
+	const bool available = (fixes_in != fixes_out);
+	if( available ) {
+		next = fixes[fixes_out++ % fixes.size()];
+	}
+	chMtxUnlock();
+	return available;
+}
+
+void SondePredictor::update(const Fix& fix) {
+	if( !have_last ) {
+		// Heard from the launch site, it's the ground; picked up in flight, sea level will do.
+		ground_altitude = ((fix.altitude >= 0) && (fix.altitude < 2000)) ? fix.altitude : 0;
+		max_altitude = fix.altitude;
+		last = fix;
+		have_last = true;
+		return;
+	}
+
+	const float dt = (fix.time - last.time) / static_cast<float>(CH_FREQUENCY);
+	if( dt <= 0.0f ) {
+		return;
+	}
+
+	const float rate = (fix.altitude - last.altitude) / dt;
+	vertical_rate = have_rate ? (vertical_rate + 0.25f * (rate - vertical_rate)) : rate;
+	have_rate = true;
+
+	const int32_t mid_altitude = (fix.altitude + last.altitude) / 2;
+	const float mid_lat = (fix.lat + last.lat) * 0.5f;
+	const float north = (fix.lat - last.lat) * meters_per_degree / dt;
+	const float east = (fix.lon - last.lon) * meters_per_degree_lon(mid_lat) / dt;
+
+	const size_t index = std::min<size_t>(std::max<int32_t>(mid_altitude, 0) / layer_height, layer_count - 1);
+	auto& layer = layers[index];
+	// A plain mean of the first few crossings, then a running one: ascent and descent both count.
+	const float weight = 1.0f / std::min<uint16_t>(layer.samples + 1, 8);
+	layer.east += weight * (east - layer.east);
+	layer.north += weight * (north - layer.north);
+	if( layer.samples < 0xffff ) {
+		layer.samples++;
+	}
+
+	if( vertical_rate < descending_rate ) {
+		const float v0 = -rate * std::exp(-mid_altitude / density_height_2);
+		if( v0 > 0.0f ) {
+			descent_rate_sea_level = descent_measured ? (descent_rate_sea_level + 0.25f * (v0 - descent_rate_sea_level)) : v0;
+			descent_measured = true;
+		}
+	}
+
+	max_altitude = std::max(max_altitude, fix.altitude);
+	last = fix;
+}
+
+SondePredictor::Prediction SondePredictor::predict() const {
+	const bool descending = (vertical_rate < descending_rate);
+	float t = 0.0f;
+	float lat = last.lat;
+	float lon = last.lon;
+	int32_t h = last.altitude;
+
+	const auto drift = [this, &t, &lat, &lon](const int32_t altitude, const float dt) {
+		const auto layer = wind_at(altitude);
+		if( layer ) {
+			lon += layer->east * dt / meters_per_degree_lon(lat);
+			lat += layer->north * dt / meters_per_degree;
+		}
+		t += dt;
+	};
+
+	if( !descending ) {
+		const int32_t top = std::max(burst_altitude, h);
+		const float rate = std::max(vertical_rate, ascent_rate_min);
+		while( h < top ) {
+			const int32_t next = std::min(top, (h / layer_height + 1) * layer_height);
+			drift((h + next) / 2, (next - h) / rate);
+			h = next;
+		}
+	}
+
+	while( h > ground_altitude ) {
+		const int32_t next = std::max(ground_altitude, ((h - 1) / layer_height) * layer_height);
+		const int32_t mid = (h + next) / 2;
+		const float rate = descent_rate_sea_level * std::exp(mid / density_height_2);
+		drift(mid, (h - next) / rate);
+		h = next;
+	}
+
+	return { true, descending, vertical_rate, lat, lon, static_cast<uint32_t>(t) };
+}
+
+const SondePredictor::Layer* SondePredictor::wind_at(const int32_t altitude) const {
+	const int32_t index = std::min<int32_t>(std::max<int32_t>(altitude, 0) / layer_height, layer_count - 1);
+	for(int32_t d=0; d<static_cast<int32_t>(layer_count); d++) {
+		if( (index - d >= 0) && layers[index - d].samples ) {
+			return &layers[index - d];
+		}
+		if( (index + d < static_cast<int32_t>(layer_count)) && layers[index + d].samples ) {
+			return &layers[index + d];
+		}
+	}
+	return nullptr;
+}
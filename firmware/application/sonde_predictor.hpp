@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SONDE_PREDICTOR_H__
+#define __SONDE_PREDICTOR_H__
+
+#include "ch.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Vertical rate and landing point of a radiosonde, worked out by a low
+ * priority thread so the UI only copies fixes in and results out.
+ *
+ * Each GPS fix updates, in O(1), a smoothed vertical rate and the wind of
+ * the 500m layer the sonde just crossed (horizontal drift between fixes).
+ * The flight is then flown forward through those layers: while ascending,
+ * at the current rate up to burst_altitude (or the current altitude, when
+ * higher); then down at a descent rate that grows with altitude as the air
+ * thins (v = v0 * e^(h / 2H)), v0 from the measured descent once there is
+ * one. Layers never crossed take the wind of the nearest one that was.
+ */
+class SondePredictor {
+public:
+	struct Prediction {
+		bool valid;
+		bool descending;
+		float vertical_rate;		// m/s, up positive
+		float lat;
+		float lon;
+		uint32_t seconds;			// to landing
+	};
+
+	SondePredictor();
+	~SondePredictor();
+
+	SondePredictor(const SondePredictor&) = delete;
+	SondePredictor(SondePredictor&&) = delete;
+	SondePredictor& operator=(const SondePredictor&) = delete;
+	SondePredictor& operator=(SondePredictor&&) = delete;
+
+	/* From the UI, per GPS fix. */
+	void add_fix(const int32_t altitude, const float lat, const float lon);
+
+	/* The latest, invalid until two fixes have been through. */
+	Prediction prediction();
+
+private:
+	static constexpr int32_t layer_height = 500;
+	static constexpr size_t layer_count = 80;
+	static constexpr size_t fixes_max = 8;
+	static constexpr int32_t burst_altitude = 30000;
+	// Parachute descent at sea level, until one is measured.
+	static constexpr float descent_rate_default = 5.0f;
+
+	struct Fix {
+		systime_t time;
+		int32_t altitude;
+		float lat;
+		float lon;
+	};
+
+	struct Layer {
+		float east;
+		float north;
+		uint16_t samples;
+	};
+
+	// Shared with the UI, under mutex.
+	Mutex mutex { };
+	std::array<Fix, fixes_max> fixes { };
+	size_t fixes_in { 0 };
+	size_t fixes_out { 0 };
+	Prediction result { false, false, 0, 0, 0, 0 };
+
+	Semaphore pending { };
+	volatile bool stop { false };
+	Thread* thread { nullptr };
+
+	// The thread's own.
+	std::array<Layer, layer_count> layers { };
+	Fix last { 0, 0, 0, 0 };
+	bool have_last { false };
+	bool have_rate { false };
+	float vertical_rate { 0 };
+	bool descent_measured { false };
+	float descent_rate_sea_level { descent_rate_default };
+	int32_t ground_altitude { 0 };
+	int32_t max_altitude { 0 };
+
+	static msg_t static_fn(void* arg);
+
+	void run();
+	bool next_fix(Fix& next);
+	void update(const Fix& fix);
+	Prediction predict() const;
+	const Layer* wind_at(const int32_t altitude) const;
+};
+
+#endif/*__SONDE_PREDICTOR_H__*/
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "spectrum_log.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+/* Packs db as SpectrumLogRow::Encoding::Delta into dst, which has room for
+ * bins bytes. Returns the length, or 0 if it wouldn't be any shorter.
+ */
+static size_t delta_encode(const uint8_t* const db, const size_t bins, uint8_t* const dst) {
+	size_t nibbles = 0;
+	const size_t nibbles_max = bins * 2 - 1;
+	auto put = [&](const uint8_t nibble) {
+		if( nibbles & 1 ) {
+			dst[nibbles >> 1] |= nibble;
+		} else {
+			dst[nibbles >> 1] = nibble << 4;
+		}
+		nibbles++;
+	};
+
+	int32_t previous = 0;
+	for(size_t i=0; i<bins; i++) {
+		const int32_t step = db[i] - previous;
+		if( (step >= -7) && (step <= 7) ) {
+			if( nibbles + 1 > nibbles_max ) {
+				return 0;
+			}
+			put(step & 0xf);
+		} else {
+			if( nibbles + 3 > nibbles_max ) {
+				return 0;
+			}
+			put(0x8);
+			put(db[i] >> 4);
+			put(db[i] & 0xf);
+		}
+		previous = db[i];
+	}
+	return (nibbles + 1) >> 1;
+}
+
+Optional<File::Error> SpectrumLog::append(const std::filesystem::path& filename) {
+	return log_file.append_records(filename);
+}
+
+bool SpectrumLog::is_due() {
+	const auto now = chTimeNow();
+	if( (now - last_row) < MS2ST(interval_ms) ) {
+		return false;
+	}
+	last_row = now;
+	rtcGetTime(&RTCD1, &datetime);
+	return true;
+}
+
+void SpectrumLog::on_channel_spectrum(const ChannelSpectrum& spectrum, const rf::Frequency center_frequency) {
+	// Ascending frequency: negative bins (128~255) first.
+	constexpr size_t half = bins_max / 2;
+	for(size_t i=0; i<bins_max; i++) {
+		const auto v = spectrum.db[(i + half) & (bins_max - 1)];
+		peak[i] = peak_valid ? std::max(peak[i], v) : v;
+	}
+	peak_valid = true;
+
+	if( is_due() ) {
+		write_row(0, 1, center_frequency, spectrum.sampling_rate / bins_max, peak.data(), peak.size());
+		peak_valid = false;
+		sequence++;
+	}
+}
+
+void SpectrumLog::on_sweep_slice(
+	const size_t slice,
+	const size_t slice_count,
+	const rf::Frequency center_frequency,
+	const uint32_t bin_width,
+	const uint8_t* const db,
+	const size_t bins
+) {
+	if( slice == 0 ) {
+		if( sweep_due ) {
+			sequence++;
+		}
+		sweep_due = is_due();
+	}
+	if( sweep_due ) {
+		write_row(slice, slice_count, center_frequency, bin_width, db, bins);
+	}
+}
+
+void SpectrumLog::write_row(
+	const uint8_t slice,
+	const uint8_t slice_count,
+	const rf::Frequency center_frequency,
+	const uint32_t bin_width,
+	const uint8_t* const db,
+	const size_t bins
+) {
+	std::array<uint8_t, sizeof(SpectrumLogRow) + bins_max> payload;
+	const size_t count = std::min(bins, bins_max);
+
+	SpectrumLogRow row {
+		static_cast<uint8_t>(SpectrumLogRow::Encoding::Delta),
+		slice, slice_count, 0,
+		static_cast<uint16_t>(count), 0,
+		bin_width,
+		sequence
+	};
+	auto data = &payload[sizeof(row)];
+	size_t length = delta_encode(db, count, data);
+	if( length == 0 ) {
+		row.encoding = static_cast<uint8_t>(SpectrumLogRow::Encoding::Raw);
+		memcpy(data, db, count);
+		length = count;
+	}
+	memcpy(payload.data(), &row, sizeof(row));
+
+	const uint32_t tag = center_frequency / 1000;
+	log_file.write_record(datetime, LogRecordType::Spectrum, tag, payload.data(), (sizeof(row) + length) * 8);
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SPECTRUM_LOG_H__
+#define __SPECTRUM_LOG_H__
+
+#include "log_file.hpp"
+#include "message.hpp"
+#include "rf_path.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Header of the payload of a LogRecordType::Spectrum record, whose tag is
+ * the row's centre frequency in kHz. Followed by bins dB bytes in order of
+ * ascending frequency, bin i at centre + (i - bins / 2) * bin_width, on the
+ * ChannelSpectrum::db scale (5 per dB, 255 = 0dBFS):
+ * - Raw: as is.
+ * - Delta: 4 bit two's complement steps from the previous bin, the first
+ *   from 0, high nibble first. Step -8 escapes the next two nibbles, an
+ *   absolute value.
+ * tools/render_spectrum_log.py turns a log into an image.
+ */
+struct SpectrumLogRow {
+	enum class Encoding : uint8_t {
+		Raw = 0,
+		Delta = 1,
+	};
+
+	uint8_t encoding;
+	uint8_t slice;			// Sweeps: slice of sequence, 0 to slice_count - 1
+	uint8_t slice_count;	// 1 for channel spectra
+	uint8_t reserved;
+	uint16_t bins;
+	uint16_t reserved2;
+	uint32_t bin_width;		// Hz
+	uint32_t sequence;		// Row (channel) or sweep number since opening
+};
+
+static_assert(sizeof(SpectrumLogRow) == 16, "SpectrumLogRow must be packed");
+
+/* Spectrum rows for long term occupancy surveys, through a LogFile's
+ * background writer. Channel spectra are peak-held between rows, so a row
+ * shows everything seen during its interval; sweeps are written a whole
+ * sweep at a time, one record per slice.
+ */
+class SpectrumLog {
+public:
+	Optional<File::Error> append(const std::filesystem::path& filename);
+
+	void set_interval_ms(const uint32_t new_interval_ms) {
+		interval_ms = new_interval_ms;
+	}
+
+	void on_channel_spectrum(const ChannelSpectrum& spectrum, const rf::Frequency center_frequency);
+
+	/* Call for each slice of a sweep in turn, the first starts the sweep. */
+	void on_sweep_slice(
+		const size_t slice,
+		const size_t slice_count,
+		const rf::Frequency center_frequency,
+		const uint32_t bin_width,
+		const uint8_t* const db,
+		const size_t bins
+	);
+
+private:
+	static constexpr size_t bins_max = 256;
+	// A 32 slice sweep in the queue at once, as long as it compresses a bit.
+	static constexpr size_t queue_k = 13;
+
+	LogFile log_file { queue_k };
+	uint32_t interval_ms { 1000 };
+	systime_t last_row { 0 };
+	bool sweep_due { false };
+	uint32_t sequence { 0 };
+	rtc::RTC datetime { };
+
+	std::array<uint8_t, bins_max> peak { };
+	bool peak_valid { false };
+
+	bool is_due();
+	void write_row(
+		const uint8_t slice,
+		const uint8_t slice_count,
+		const rf::Frequency center_frequency,
+		const uint32_t bin_width,
+		const uint8_t* const db,
+		const size_t bins
+	);
+};
+
+#endif/*__SPECTRUM_LOG_H__*/
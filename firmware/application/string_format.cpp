@@ -21,6 +21,8 @@
 
 #include "string_format.hpp"
 
+#include <cmath>
+
 static char* to_string_dec_uint_internal(
 	char* p,
 	uint32_t n
@@ -55,6 +57,18 @@ static char* to_string_dec_uint_pad_internal(
 	return q;
 }
 
+static size_t copy_out(char* const dst, const size_t size, const char* const src, const size_t length) {
+	if( size == 0 ) {
+		return 0;
+	}
+	const size_t n = std::min(length, size - 1);
+	for(size_t i=0; i<n; i++) {
+		dst[i] = src[i];
+	}
+	dst[n] = 0;
+	return n;
+}
+
 std::string to_string_bin(
 	const uint32_t n,
 	const uint8_t l)
@@ -70,7 +84,9 @@ std::string to_string_bin(
 	return p;
 }
 
-std::string to_string_dec_uint(
+size_t to_string_dec_uint(
+	char* const dst,
+	const size_t size,
 	const uint32_t n,
 	const int32_t l,
 	const char fill
@@ -84,10 +100,31 @@ std::string to_string_dec_uint(
 		*(--q) = ' ';
 	}
 
-	return q;
+	return copy_out(dst, size, q, term - q);
 }
 
-std::string to_string_dec_int(
+std::string to_string_dec_uint(
+	const uint32_t n,
+	const int32_t l,
+	const char fill
+) {
+	char p[16];
+	to_string_dec_uint(p, sizeof(p), n, l, fill);
+	return p;
+}
+
+std::string to_string_dec_uint64(const uint64_t n) {
+	constexpr uint32_t split = 1000000000U;
+	if( n < split ) {
+		return to_string_dec_uint(n);
+	} else {
+		return to_string_dec_uint64(n / split) + to_string_dec_uint(n % split, 9, '0');
+	}
+}
+
+size_t to_string_dec_int(
+	char* const dst,
+	const size_t size,
 	const int32_t n,
 	const int32_t l,
 	const char fill
@@ -109,12 +146,30 @@ std::string to_string_dec_int(
 		*(--q) = ' ';
 	}
 
-	return q;
+	return copy_out(dst, size, q, term - q);
+}
+
+std::string to_string_dec_int(
+	const int32_t n,
+	const int32_t l,
+	const char fill
+) {
+	char p[16];
+	to_string_dec_int(p, sizeof(p), n, l, fill);
+	return p;
+}
+
+size_t to_string_short_freq(char* const dst, const size_t size, const uint64_t f) {
+	size_t length = to_string_dec_int(dst, size, f / 1000000, 4);
+	length += copy_out(&dst[length], size - length, ".", 1);
+	length += to_string_dec_int(&dst[length], size - length, (f / 100) % 10000, 4, '0');
+	return length;
 }
 
 std::string to_string_short_freq(const uint64_t f) {
-	auto final_str = to_string_dec_int(f / 1000000, 4) + "." + to_string_dec_int((f / 100) % 10000, 4, '0');
-	return final_str;
+	char p[16];
+	to_string_short_freq(p, sizeof(p), f);
+	return p;
 }
 
 std::string to_string_time_ms(const uint32_t ms) {
@@ -142,12 +197,19 @@ static void to_string_hex_internal(char* p, const uint64_t n, const int32_t l) {
 	}
 }
 
-std::string to_string_hex(const uint64_t n, int32_t l) {
+size_t to_string_hex(char* const dst, const size_t size, const uint64_t n, int32_t l) {
 	char p[32];
 	
-	l = std::min(l, 31L);
-	to_string_hex_internal(p, n, l - 1);
-	p[l] = 0;
+	l = std::max<int32_t>(std::min<int32_t>(l, 31), 0);
+	if( l > 0 ) {
+		to_string_hex_internal(p, n, l - 1);
+	}
+	return copy_out(dst, size, p, l);
+}
+
+std::string to_string_hex(const uint64_t n, int32_t l) {
+	char p[32];
+	to_string_hex(p, sizeof(p), n, l);
 	return p;
 }
 
@@ -161,22 +223,36 @@ std::string to_string_hex_array(uint8_t * const array, const int32_t l) {
 	return str_return;
 }
 
-std::string to_string_datetime(const rtc::RTC& value, const TimeFormat format) {
-	std::string string { "" };
+size_t to_string_datetime(char* const dst, const size_t size, const rtc::RTC& value, const TimeFormat format) {
+	size_t length = 0;
+	const auto field = [&](const uint32_t n, const int32_t l, const char fill, const char separator) {
+		length += to_string_dec_uint(&dst[length], size - length, n, l, fill);
+		if( separator ) {
+			length += copy_out(&dst[length], size - length, &separator, 1);
+		}
+	};
 	
 	if (format == YMDHMS) {
-		string += to_string_dec_uint(value.year(), 4) + "/" +
-					to_string_dec_uint(value.month(), 2, '0') + "/" +
-					to_string_dec_uint(value.day(), 2, '0') + " ";
+		field(value.year(), 4, ' ', '/');
+		field(value.month(), 2, '0', '/');
+		field(value.day(), 2, '0', ' ');
 	}
 	
-	string += to_string_dec_uint(value.hour(), 2, '0') + ":" +
-	string += to_string_dec_uint(value.minute(), 2, '0');
+	field(value.hour(), 2, '0', ':');
+	field(value.minute(), 2, '0', 0);
 	
-	if ((format == YMDHMS) || (format == HMS))
-		string += ":" + to_string_dec_uint(value.second(), 2, '0');
+	if ((format == YMDHMS) || (format == HMS)) {
+		length += copy_out(&dst[length], size - length, ":", 1);
+		field(value.second(), 2, '0', 0);
+	}
 	
-	return string;
+	return length;
+}
+
+std::string to_string_datetime(const rtc::RTC& value, const TimeFormat format) {
+	char p[24];
+	to_string_datetime(p, sizeof(p), value, format);
+	return p;
 }
 
 std::string to_string_timestamp(const rtc::RTC& value) {
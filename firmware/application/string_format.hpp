@@ -23,7 +23,9 @@
 #define __STRING_FORMAT_H__
 
 #include <cstdint>
+#include <cstddef>
 #include <string>
+#include <algorithm>
 
 #include "file.hpp"
 
@@ -39,9 +41,71 @@ enum TimeFormat {
 
 const char unit_prefix[7] { 'n', 'u', 'm', 0, 'k', 'M', 'G' };
 
+/* Fixed capacity string for building text on the stack, e.g. table rows
+ * redrawn on every repaint, without going through the heap. Appends past
+ * the capacity are dropped.
+ */
+template<size_t N>
+class FixedString {
+public:
+	const char* c_str() const { return data_; }
+	size_t size() const { return size_; }
+
+	/* For the buffer overloads below: append with
+	 * s.extend(to_string_...(s.end(), s.available(), ...)).
+	 */
+	char* end() { return &data_[size_]; }
+	size_t available() const { return N + 1 - size_; }
+
+	FixedString& extend(const size_t n) {
+		size_ = std::min(size_ + n, N);
+		data_[size_] = 0;
+		return *this;
+	}
+
+	FixedString& operator+=(const char c) {
+		if( size_ < N ) {
+			data_[size_++] = c;
+			data_[size_] = 0;
+		}
+		return *this;
+	}
+
+	FixedString& operator+=(const char* s) {
+		while( *s && (size_ < N) ) {
+			data_[size_++] = *(s++);
+		}
+		data_[size_] = 0;
+		return *this;
+	}
+
+	void resize(const size_t n, const char fill) {
+		while( (size_ < n) && (size_ < N) ) {
+			data_[size_++] = fill;
+		}
+		size_ = std::min(n, size_);
+		data_[size_] = 0;
+	}
+
+private:
+	char data_[N + 1] { 0 };
+	size_t size_ { 0 };
+};
+
+/* Buffer overloads: write into dst (size bytes, always NUL terminated,
+ * truncated if short) and return the length written. The std::string
+ * versions are built on these.
+ */
+size_t to_string_dec_uint(char* const dst, const size_t size, const uint32_t n, const int32_t l = 0, const char fill = ' ');
+size_t to_string_dec_int(char* const dst, const size_t size, const int32_t n, const int32_t l = 0, const char fill = 0);
+size_t to_string_hex(char* const dst, const size_t size, const uint64_t n, const int32_t l = 0);
+size_t to_string_short_freq(char* const dst, const size_t size, const uint64_t f);
+size_t to_string_datetime(char* const dst, const size_t size, const rtc::RTC& value, const TimeFormat format = YMDHMS);
+
 // TODO: Allow l=0 to not fill/justify? Already using this way in ui_spectrum.hpp...
 std::string to_string_bin(const uint32_t n, const uint8_t l = 0);
 std::string to_string_dec_uint(const uint32_t n, const int32_t l = 0, const char fill = ' ');
+std::string to_string_dec_uint64(const uint64_t n);
 std::string to_string_dec_int(const int32_t n, const int32_t l = 0, const char fill = 0);
 std::string to_string_hex(const uint64_t n, const int32_t l = 0);
 std::string to_string_hex_array(uint8_t * const array, const int32_t l = 0);
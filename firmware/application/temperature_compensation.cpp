@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "temperature_compensation.hpp"
+
+#include <cstdlib>
+
+void TemperatureCompensation::load() {
+	if( loaded ) {
+		return;
+	}
+	loaded = true;
+
+	// Keys are sensor codes. Loaded entries count as half learned, so this
+	// session's observations still move them quickly.
+	for(size_t i=0; i<sensor_codes; i++) {
+		const auto value = settings.get_int(i, INT64_MIN);
+		if( value != INT64_MIN ) {
+			ppb[i] = ppb_saved[i] = value;
+			weight[i] = weight_max / 2;
+		}
+	}
+}
+
+void TemperatureCompensation::observe(const sample_t temperature, const int32_t correction_ppb) {
+	if( temperature >= sensor_codes ) {
+		return;
+	}
+	load();
+
+	// Running mean of the first weight_max observations, a moving average after.
+	if( weight[temperature] < weight_max ) {
+		weight[temperature]++;
+	}
+	auto& value = ppb[temperature];
+	value += (correction_ppb - value) / static_cast<int32_t>(weight[temperature]);
+
+	if( std::abs(value - ppb_saved[temperature]) >= change_min_ppb ) {
+		dirty = true;
+	}
+}
+
+Optional<int32_t> TemperatureCompensation::correction_ppb(const sample_t temperature) {
+	if( temperature >= sensor_codes ) {
+		return { };
+	}
+	load();
+
+	if( weight[temperature] ) {
+		return ppb[temperature];
+	}
+
+	int32_t below = -1;
+	for(int32_t i=temperature - 1; i>=0; i--) {
+		if( weight[i] ) {
+			below = i;
+			break;
+		}
+	}
+	int32_t above = -1;
+	for(size_t i=temperature + 1; i<sensor_codes; i++) {
+		if( weight[i] ) {
+			above = i;
+			break;
+		}
+	}
+
+	if( (below >= 0) && (above >= 0) && (static_cast<size_t>(above - below) <= span_max) ) {
+		return ppb[below] + (ppb[above] - ppb[below]) * (temperature - below) / (above - below);
+	}
+	if( (below >= 0) && (static_cast<size_t>(temperature - below) <= extrapolation_max) ) {
+		return ppb[below];
+	}
+	if( (above >= 0) && (static_cast<size_t>(above - temperature) <= extrapolation_max) ) {
+		return ppb[above];
+	}
+	return { };
+}
+
+void TemperatureCompensation::flush() {
+	const auto now = chTimeNow();
+	if( !dirty || ((now - last_commit) < S2ST(commit_interval_s)) ) {
+		return;
+	}
+
+	for(size_t i=0; i<sensor_codes; i++) {
+		if( weight[i] && (ppb[i] != ppb_saved[i]) ) {
+			settings.set_int(i, ppb[i]);
+			ppb_saved[i] = ppb[i];
+		}
+	}
+	// On an error (no card), try again next interval.
+	if( !settings.commit().is_valid() ) {
+		dirty = false;
+	}
+	last_commit = now;
+}
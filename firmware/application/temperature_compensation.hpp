@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __TEMPERATURE_COMPENSATION_H__
+#define __TEMPERATURE_COMPENSATION_H__
+
+#include "temperature_logger.hpp"
+#include "settings_store.hpp"
+#include "optional.hpp"
+
+#include "ch.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Reference correction against temperature, one entry per MAX2837 sensor
+ * code (5C). Learned from the corrections AFC settles on while it holds a
+ * carrier, so a cold receiver without one (POCSAG, sondes) starts out near
+ * where it'll end up warm. Kept in SETTINGS/TEMPCOMP.SET, written at most
+ * once a commit_interval_s.
+ */
+class TemperatureCompensation {
+public:
+	using sample_t = TemperatureLogger::sample_t;
+
+	static constexpr size_t sensor_codes = 32;
+
+	/* correction_ppb put a carrier on frequency at temperature. */
+	void observe(const sample_t temperature, const int32_t correction_ppb);
+
+	/* Learned, or interpolated between learned codes at most span_max apart,
+	 * or from one within extrapolation_max. None otherwise.
+	 */
+	Optional<int32_t> correction_ppb(const sample_t temperature);
+
+	/* Commits what's been learned if it's due. */
+	void flush();
+
+private:
+	static constexpr size_t weight_max = 16;
+	static constexpr size_t span_max = 6;
+	static constexpr size_t extrapolation_max = 1;
+	// Smaller changes aren't worth an SD write.
+	static constexpr int32_t change_min_ppb = 100;
+	static constexpr systime_t commit_interval_s = 60;
+
+	SettingsStore settings { "TEMPCOMP" };
+	bool loaded { false };
+	bool dirty { false };
+	systime_t last_commit { 0 };
+
+	std::array<int32_t, sensor_codes> ppb { };
+	std::array<int32_t, sensor_codes> ppb_saved { };
+	std::array<uint8_t, sensor_codes> weight { };
+
+	void load();
+};
+
+#endif/*__TEMPERATURE_COMPENSATION_H__*/
@@ -25,11 +25,13 @@
 
 #include <algorithm>
 
-void TemperatureLogger::second_tick() {
+bool TemperatureLogger::second_tick() {
 	sample_phase++;
 	if( sample_phase >= sample_interval ) {
 		push_sample(read_sample());
+		return true;
 	}
+	return false;
 }
 
 size_t TemperatureLogger::size() const {
@@ -52,6 +54,10 @@ std::vector<TemperatureLogger::sample_t> TemperatureLogger::history() const {
 	return result;
 }
 
+TemperatureLogger::sample_t TemperatureLogger::latest() const {
+	return samples.back();
+}
+
 TemperatureLogger::sample_t TemperatureLogger::read_sample() {
 	// MAX2837 does not return a valid temperature if in "shutdown" mode.
 	return radio::debug::second_if::temp_sense();
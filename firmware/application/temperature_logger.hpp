@@ -31,12 +31,15 @@ class TemperatureLogger {
 public:	
 	using sample_t = uint8_t;
 
-	void second_tick();
+	/* True when it took a sample. */
+	bool second_tick();
 
 	size_t size() const;
 	size_t capacity() const;
 	
 	std::vector<sample_t> history() const;
+	/* Only valid once size() is non-zero. */
+	sample_t latest() const;
 
 private:
 	std::array<sample_t, 128> samples { };
@@ -224,6 +224,7 @@ private:
 	//Debounce touch_debounce;
 
 	State state { State::NoTouch };
+	ui::Point last_point { };
 
 	bool point_stable() const {
 		return filter_x.stable(touch_stable_bound)
@@ -237,7 +238,11 @@ private:
 	}
 
 	void touch_moved() {
-		fire_event(ui::TouchEvent::Type::Move);
+		// A resting finger isn't news.
+		const auto point = filtered_point();
+		if( (point.x() != last_point.x()) || (point.y() != last_point.y()) ) {
+			fire_event(ui::TouchEvent::Type::Move);
+		}
 	}
 
 	void touch_ended() {
@@ -245,8 +250,9 @@ private:
 	}
 
 	void fire_event(ui::TouchEvent::Type type) {
+		last_point = filtered_point();
 		if( on_event ) {
-			on_event({ filtered_point(), type });
+			on_event({ last_point, type });
 		}
 	}
 };
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "trace_file.hpp"
+
+#include "portapack_shared_memory.hpp"
+
+#include "hal.h"
+
+#include <algorithm>
+
+namespace trace {
+
+std::vector<Record> snapshot(const Ring* const ring) {
+	if( !ring || (ring->magic != Ring::magic_value) ) {
+		return { };
+	}
+
+	std::vector<Record> records(Ring::records_max);
+	const uint32_t count_before = ring->count;
+	std::copy(&ring->records[0], &ring->records[Ring::records_max], records.begin());
+	const uint32_t count_after = ring->count;
+
+	// Kept: the last n before the copy, less those written over during it.
+	const uint32_t available = std::min(count_before, static_cast<uint32_t>(Ring::records_max));
+	const uint32_t overwritten = count_after - count_before;
+	const uint32_t n = (available > overwritten) ? (available - overwritten) : 0;
+
+	const size_t first = (count_before - n) & (Ring::records_max - 1);
+	std::rotate(records.begin(), records.begin() + first, records.end());
+	records.erase(records.begin(), records.end() - n);
+	return records;
+}
+
+Optional<File::Error> write_file(const std::filesystem::path& path) {
+	const auto m0 = snapshot(&ring);
+	const auto m4 = snapshot(shared_memory.m4_trace);
+
+	const FileHeader header {
+		FileHeader::magic_value,
+		FileHeader::version_value,
+		halGetCounterFrequency(),
+		now(),
+		static_cast<uint32_t>(m0.size()),
+		static_cast<uint32_t>(m4.size())
+	};
+
+	File file;
+	const auto create_error = file.create(path);
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+
+	const auto header_result = file.write(&header, sizeof(header));
+	if( header_result.is_error() ) {
+		return header_result.error();
+	}
+	for(const auto records : { &m0, &m4 }) {
+		if( records->empty() ) {
+			continue;
+		}
+		const auto result = file.write(records->data(), records->size() * sizeof(Record));
+		if( result.is_error() ) {
+			return result.error();
+		}
+	}
+
+	return file.sync();
+}
+
+} /* namespace trace */
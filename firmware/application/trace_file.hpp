@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __TRACE_FILE_H__
+#define __TRACE_FILE_H__
+
+#include "trace.hpp"
+#include "file.hpp"
+#include "optional.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace trace {
+
+/* A .TRC file: this header, then m0_records and m4_records Records, each
+ * oldest first. now is the timer when the rings were read, to turn the
+ * wrapping timestamps into times before it.
+ */
+struct FileHeader {
+	static constexpr uint32_t magic_value = Ring::magic_value;
+	static constexpr uint32_t version_value = 1;
+
+	uint32_t magic;
+	uint32_t version;
+	uint32_t timer_frequency;
+	uint32_t now;
+	uint32_t m0_records;
+	uint32_t m4_records;
+};
+
+/* What's left of a ring that may be written while it's copied: records
+ * overwritten before they were read are dropped. null is empty.
+ */
+std::vector<Record> snapshot(const Ring* const ring);
+
+/* Both rings, the baseband's if an image is running. */
+Optional<File::Error> write_file(const std::filesystem::path& path);
+
+} /* namespace trace */
+
+#endif/*__TRACE_FILE_H__*/
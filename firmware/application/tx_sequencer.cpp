@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "tx_sequencer.hpp"
+
+#include "baseband_api.hpp"
+
+bool TxSequencer::set_steps(const std::vector<Step>& new_steps, const uint32_t new_sampling_rate) {
+	count = 0;
+	tuned = 0;
+	sampling_rate = new_sampling_rate;
+
+	if( new_steps.size() > steps_max ) {
+		return false;
+	}
+
+	for(size_t i=0; i<new_steps.size(); i++) {
+		const auto& step = new_steps[i];
+		tunings[i] = radio::tuning_settings(step.frequency);
+		if( !tunings[i].valid ) {
+			return false;
+		}
+		frequencies[i] = step.frequency;
+		steps[i] = {
+			static_cast<uint32_t>((static_cast<uint64_t>(step.duration_ms) * sampling_rate) / 1000),
+			step.payload
+		};
+	}
+
+	count = new_steps.size();
+	return true;
+}
+
+void TxSequencer::start(const uint32_t cycles, const uint32_t guard_us) {
+	if( count == 0 ) {
+		return;
+	}
+
+	tuned = 0;
+	tune(0);
+
+	const uint32_t guard = (static_cast<uint64_t>(guard_us) * sampling_rate) / 1000000;
+	baseband::set_tx_sequence(count, cycles, guard, steps);
+}
+
+void TxSequencer::stop() {
+	baseband::set_tx_sequence(0, 0, 0, { });
+}
+
+void TxSequencer::on_message(const TxSequenceStepMessage& message) {
+	if( !message.done && (message.index < count) ) {
+		tune(message.index);
+	}
+
+	if( on_step ) {
+		on_step(message.index, message.cycle, message.done);
+	}
+}
+
+void TxSequencer::tune(const size_t index) {
+	if( frequencies[index] != tuned ) {
+		radio::set_tuning(tunings[index]);
+		tuned = frequencies[index];
+	}
+}
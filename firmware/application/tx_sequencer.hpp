@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __TX_SEQUENCER_H__
+#define __TX_SEQUENCER_H__
+
+#include "radio.hpp"
+#include "message.hpp"
+#include "event_m0.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <functional>
+
+/* Hops a transmitter through (frequency, payload, duration) steps with the
+ * baseband keeping time, see TxSequencer on the M4. Every step's synth
+ * settings are worked out in set_steps(), so a hop is only the SPI writes,
+ * made straight from the baseband's step message; a step on the same
+ * frequency as the last doesn't retune at all. The processor's
+ * TxSequenceConfig handling says what a payload is.
+ */
+class TxSequencer {
+public:
+	static constexpr size_t steps_max = TxSequenceConfigMessage::steps_max;
+
+	struct Step {
+		rf::Frequency frequency;
+		uint32_t payload;
+		// 0: until the processor ends it, e.g. with its data
+		uint32_t duration_ms;
+	};
+
+	/* As each step ends, with the next step's index; done after the last. */
+	std::function<void(const size_t index, const uint32_t cycle, const bool done)> on_step { };
+
+	/* Returns false, leaving no steps, if there are more than steps_max or
+	 * a frequency can't be tuned.
+	 */
+	bool set_steps(const std::vector<Step>& new_steps, const uint32_t sampling_rate);
+
+	size_t size() const {
+		return count;
+	}
+
+	/* With the transmitter enabled, before the processor's own configuration.
+	 * cycles 0 repeats until stop(); guard_us of silence covers each retune.
+	 */
+	void start(const uint32_t cycles, const uint32_t guard_us);
+	void stop();
+
+private:
+	std::array<rf::Frequency, steps_max> frequencies { };
+	std::array<radio::TuningSettings, steps_max> tunings { };
+	std::array<TxSequenceStep, steps_max> steps { };
+	size_t count { 0 };
+	uint32_t sampling_rate { 0 };
+	rf::Frequency tuned { 0 };
+
+	MessageHandlerRegistration message_handler_step {
+		Message::ID::TxSequenceStep,
+		[this](const Message* const p) {
+			this->on_message(*static_cast<const TxSequenceStepMessage*>(p));
+		}
+	};
+
+	void on_message(const TxSequenceStepMessage& message);
+	void tune(const size_t index);
+};
+
+#endif/*__TX_SEQUENCER_H__*/
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "ui_font_fixed_6x8.hpp"
+
+#include <cstdint>
+
+namespace ui {
+namespace font {
+
+namespace {
+
+const uint8_t fixed_6x8_glyph_data[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x04, 0x41, 0x10, 0x04, 0x40, 0x00,
+	0x8a, 0xa2, 0x00, 0x00, 0x00, 0x00,
+	0x8a, 0xf2, 0x29, 0x9f, 0xa2, 0x00,
+	0x84, 0x57, 0x38, 0xd4, 0x43, 0x00,
+	0xc3, 0x84, 0x10, 0x42, 0x86, 0x01,
+	0x46, 0x52, 0x08, 0x55, 0x62, 0x01,
+	0x06, 0x21, 0x00, 0x00, 0x00, 0x00,
+	0x08, 0x21, 0x08, 0x02, 0x81, 0x00,
+	0x02, 0x81, 0x20, 0x08, 0x21, 0x00,
+	0x00, 0x51, 0x39, 0x15, 0x01, 0x00,
+	0x00, 0x41, 0x7c, 0x04, 0x01, 0x00,
+	0x00, 0x00, 0x00, 0x06, 0x21, 0x00,
+	0x00, 0x00, 0x7c, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x80, 0x61, 0x00,
+	0x00, 0x84, 0x10, 0x42, 0x00, 0x00,
+	0x4e, 0x94, 0x55, 0x53, 0xe4, 0x00,
+	0x84, 0x41, 0x10, 0x04, 0xe1, 0x00,
+	0x4e, 0x04, 0x21, 0x84, 0xf0, 0x01,
+	0x1f, 0x42, 0x20, 0x50, 0xe4, 0x00,
+	0x08, 0xa3, 0x24, 0x1f, 0x82, 0x00,
+	0x5f, 0xf0, 0x40, 0x50, 0xe4, 0x00,
+	0x8c, 0x10, 0x3c, 0x51, 0xe4, 0x00,
+	0x1f, 0x84, 0x10, 0x82, 0x20, 0x00,
+	0x4e, 0x14, 0x39, 0x51, 0xe4, 0x00,
+	0x4e, 0x14, 0x79, 0x10, 0x62, 0x00,
+	0x80, 0x61, 0x00, 0x86, 0x01, 0x00,
+	0x80, 0x61, 0x00, 0x06, 0x21, 0x00,
+	0x08, 0x21, 0x04, 0x02, 0x81, 0x00,
+	0x00, 0xf0, 0x01, 0x1f, 0x00, 0x00,
+	0x02, 0x81, 0x40, 0x08, 0x21, 0x00,
+	0x4e, 0x04, 0x21, 0x04, 0x40, 0x00,
+	0x4e, 0x04, 0x59, 0x55, 0xe5, 0x00,
+	0x4e, 0x14, 0x45, 0x5f, 0x14, 0x01,
+	0x4f, 0x14, 0x3d, 0x51, 0xf4, 0x00,
+	0x4e, 0x14, 0x04, 0x41, 0xe4, 0x00,
+	0x47, 0x12, 0x45, 0x51, 0x72, 0x00,
+	0x5f, 0x10, 0x3c, 0x41, 0xf0, 0x01,
+	0x5f, 0x10, 0x3c, 0x41, 0x10, 0x00,
+	0x4e, 0x14, 0x74, 0x51, 0xe4, 0x01,
+	0x51, 0x14, 0x7d, 0x51, 0x14, 0x01,
+	0x0e, 0x41, 0x10, 0x04, 0xe1, 0x00,
+	0x1c, 0x82, 0x20, 0x48, 0x62, 0x00,
+	0x51, 0x52, 0x0c, 0x45, 0x12, 0x01,
+	0x41, 0x10, 0x04, 0x41, 0xf0, 0x01,
+	0xd1, 0x56, 0x55, 0x51, 0x14, 0x01,
+	0x51, 0x34, 0x55, 0x59, 0x14, 0x01,
+	0x4e, 0x14, 0x45, 0x51, 0xe4, 0x00,
+	0x4f, 0x14, 0x3d, 0x41, 0x10, 0x00,
+	0x4e, 0x14, 0x45, 0x55, 0x62, 0x01,
+	0x4f, 0x14, 0x3d, 0x45, 0x12, 0x01,
+	0x5e, 0x10, 0x38, 0x10, 0xf4, 0x00,
+	0x1f, 0x41, 0x10, 0x04, 0x41, 0x00,
+	0x51, 0x14, 0x45, 0x51, 0xe4, 0x00,
+	0x51, 0x14, 0x45, 0x91, 0x42, 0x00,
+	0x51, 0x14, 0x55, 0x55, 0xa5, 0x00,
+	0x51, 0xa4, 0x10, 0x4a, 0x14, 0x01,
+	0x51, 0x14, 0x29, 0x04, 0x41, 0x00,
+	0x1f, 0x84, 0x10, 0x42, 0xf0, 0x01,
+	0x8e, 0x20, 0x08, 0x82, 0xe0, 0x00,
+	0x40, 0x20, 0x10, 0x08, 0x04, 0x00,
+	0x0e, 0x82, 0x20, 0x08, 0xe2, 0x00,
+	0x84, 0x12, 0x01, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0xf0, 0x01,
+	0x02, 0x81, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0xe0, 0x40, 0x5e, 0xe4, 0x01,
+	0x41, 0xd0, 0x4c, 0x51, 0xf4, 0x00,
+	0x00, 0xe0, 0x04, 0x41, 0xe4, 0x00,
+	0x10, 0x64, 0x65, 0x51, 0xe4, 0x01,
+	0x00, 0xe0, 0x44, 0x5f, 0xe0, 0x00,
+	0x8c, 0x24, 0x1c, 0x82, 0x20, 0x00,
+	0x80, 0x17, 0x45, 0x1e, 0xe4, 0x00,
+	0x41, 0xd0, 0x4c, 0x51, 0x14, 0x01,
+	0x04, 0x60, 0x10, 0x04, 0xe1, 0x00,
+	0x08, 0xc0, 0x20, 0x48, 0x62, 0x00,
+	0x41, 0x90, 0x14, 0x43, 0x91, 0x00,
+	0x06, 0x41, 0x10, 0x04, 0xe1, 0x00,
+	0x00, 0xb0, 0x54, 0x55, 0x14, 0x01,
+	0x00, 0xd0, 0x4c, 0x51, 0x14, 0x01,
+	0x00, 0xe0, 0x44, 0x51, 0xe4, 0x00,
+	0x00, 0xf0, 0x44, 0x4f, 0x10, 0x00,
+	0x00, 0x60, 0x65, 0x1e, 0x04, 0x01,
+	0x00, 0xd0, 0x4c, 0x41, 0x10, 0x00,
+	0x00, 0xe0, 0x04, 0x0e, 0xf4, 0x00,
+	0x82, 0x70, 0x08, 0x82, 0xc4, 0x00,
+	0x00, 0x10, 0x45, 0x51, 0x66, 0x01,
+	0x00, 0x10, 0x45, 0x91, 0x42, 0x00,
+	0x00, 0x10, 0x45, 0x55, 0xa5, 0x00,
+	0x00, 0x10, 0x29, 0x84, 0x12, 0x01,
+	0x00, 0x10, 0x45, 0x1e, 0xe4, 0x00,
+	0x00, 0xf0, 0x21, 0x84, 0xf0, 0x01,
+	0x08, 0x41, 0x08, 0x04, 0x81, 0x00,
+	0x04, 0x41, 0x10, 0x04, 0x41, 0x00,
+	0x02, 0x41, 0x20, 0x04, 0x21, 0x00,
+	0x00, 0x20, 0x54, 0x08, 0x00, 0x00
+};
+
+}
+
+const ui::Font fixed_6x8 {
+	6, 8,
+	fixed_6x8_glyph_data,
+	0x20, 95,
+};
+
+} /* namespace font */
+} /* namespace ui */
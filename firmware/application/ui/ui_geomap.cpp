@@ -25,11 +25,13 @@
 #include "portapack.hpp"
 
 #include <cstring>
+#include <algorithm>
 #include <stdio.h>
 
 using namespace portapack;
 
 #include "string_format.hpp"
+#include "rtc_time.hpp"
 
 namespace ui {
 
@@ -135,26 +137,86 @@ GeoMap::GeoMap(
 	Rect parent_rect
 ) : Widget { parent_rect }
 {
-	//set_focusable(true);
+	set_focusable(true);	// Encoder zooms
 }
 
-void GeoMap::paint(Painter& painter) {
+void GeoMap::draw_lines(const Rect r) {
 	Coord line;
 	std::array<ui::Color, 240> map_line_buffer;
-	const auto r = screen_rect();
 	
-	// Ony redraw map if it moved by at least 1 pixel
-	if ((x_pos != prev_x_pos) || (y_pos != prev_y_pos)) {
-		for (line = 0; line < r.height(); line++) {
-			map_file.seek(4 + ((x_pos + (map_width * (y_pos + line))) << 1));
-			map_file.read(map_line_buffer.data(), r.width() << 1);
-			display.draw_pixels({ 0, r.top() + line, r.width(), 1 }, map_line_buffer);
+	for (line = 0; line < r.height(); line++) {
+		map_file.seek(4 + ((x_pos + (map_width * (y_pos + line))) << 1));
+		map_file.read(map_line_buffer.data(), r.width() << 1);
+		display.draw_pixels({ 0, r.top() + line, r.width(), 1 }, map_line_buffer);
+	}
+}
+
+void GeoMap::draw_tiles(const Rect r) {
+	std::array<ui::Color, map_tile_size * map_tile_size> tile_buffer;
+	
+	const int32_t tile_x_first = std::max<int32_t>(x_pos / map_tile_size, 0);
+	const int32_t tile_x_last = std::min<int32_t>((x_pos + r.width() - 1) / map_tile_size, map_tiles_x - 1);
+	const int32_t tile_y_first = std::max<int32_t>(y_pos / map_tile_size, 0);
+	const int32_t tile_y_last = std::min<int32_t>((y_pos + r.height() - 1) / map_tile_size, map_tiles_y - 1);
+	
+	// Anything outside of the map stays black
+	if ((x_pos < 0) || (y_pos < 0) || (x_pos + r.width() > map_width) || (y_pos + r.height() > map_height))
+		display.fill_rectangle(r, Color::black());
+	
+	for (int32_t tile_y = tile_y_first; tile_y <= tile_y_last; tile_y++) {
+		// Visible tiles of a row are contiguous, only one seek per row
+		map_file.seek(map_tiles_offset + (((tile_y * map_tiles_x) + tile_x_first) * sizeof(tile_buffer)));
+		
+		for (int32_t tile_x = tile_x_first; tile_x <= tile_x_last; tile_x++) {
+			map_file.read(tile_buffer.data(), sizeof(tile_buffer));
+			
+			const Rect tile_rect {
+				r.left() + (tile_x * map_tile_size) - x_pos,
+				r.top() + (tile_y * map_tile_size) - y_pos,
+				map_tile_size, map_tile_size
+			};
+			const auto clipped = tile_rect.intersect(r);
+			
+			if ((clipped.width() == map_tile_size) && (clipped.height() == map_tile_size)) {
+				display.draw_pixels(tile_rect, tile_buffer);
+			} else {
+				for (Coord y = clipped.top(); y < clipped.bottom(); y++) {
+					display.render_line(
+						{ clipped.left(), y },
+						clipped.width(),
+						&tile_buffer[((y - tile_rect.top()) * map_tile_size) + (clipped.left() - tile_rect.left())]
+					);
+				}
+			}
 		}
+	}
+}
+
+void GeoMap::paint(Painter& painter) {
+	const auto r = screen_rect();
+	
+	// Ony redraw map if it moved by at least 1 pixel, or markers or tracks
+	// moved off what they were drawn over
+	if ((x_pos != prev_x_pos) || (y_pos != prev_y_pos) || overlays_changed()) {
+		if (map_tiled)
+			draw_tiles(r);
+		else
+			draw_lines(r);
 		
 		prev_x_pos = x_pos;
 		prev_y_pos = y_pos;
 	}
 	
+	if (tracks_) {
+		draw_tracks(r);
+		tracks_revision = tracks_->revision();
+	}
+	
+	if (markers_) {
+		draw_markers(painter, r);
+		markers_revision = markers_->revision();
+	}
+	
 	if (mode_ == PROMPT) {
 		// Cross
 		display.fill_rectangle({ r.center() - Point(16, 1), { 32, 2 } }, Color::red());
@@ -185,7 +247,7 @@ void GeoMap::move(const float lon, const float lat) {
 	
 	// Map is in Equidistant "Plate Carrée" projection
 	x_pos = map_center_x - (map_rect.width() / 2) + (lon_ / lon_ratio);
-	y_pos = map_center_y - (map_rect.height() / 2) + (lat_ / lat_ratio) + 16;
+	y_pos = map_center_y - (map_rect.height() / 2) + (lat_ / lat_ratio) + (16 >> map_level_);
 	
 	// Cap position
 	if (x_pos > (map_width - map_rect.width()))
@@ -195,19 +257,61 @@ void GeoMap::move(const float lon, const float lat) {
 }
 
 bool GeoMap::init() {
+	map_header_t header;
+	
 	auto result = map_file.open("ADSB/world_map.bin");
 	if (result.is_valid())
 		return false;
 	
-	map_file.read(&map_width, 2);
-	map_file.read(&map_height, 2);
+	map_file.read(&header, sizeof(header));
+	map_tiled = (memcmp(header.magic, "PPMT", 4) == 0);
+	
+	if (map_tiled) {
+		if ((header.tile_size != map_tile_size) || (header.level_count == 0))
+			return false;
+		
+		// Level 0 is full resolution, each following level halves it
+		map_level_count = std::min<uint16_t>(header.level_count, map_levels_max);
+		map_file.read(map_levels.data(), map_level_count * sizeof(map_level_t));
+	} else {
+		// Legacy raster: width, height, then RGB565 lines
+		map_file.seek(0);
+		map_file.read(&map_levels[0].width, 2);
+		map_file.read(&map_levels[0].height, 2);
+		map_level_count = 1;
+	}
+	
+	set_level(0);
+	
+	return true;
+}
+
+void GeoMap::set_level(const uint16_t level) {
+	const auto& map_level = map_levels[level];
+	
+	map_level_ = level;
+	map_width = map_level.width;
+	map_height = map_level.height;
+	map_tiles_offset = map_level.offset;
+	map_tiles_x = (map_width + map_tile_size - 1) / map_tile_size;
+	map_tiles_y = (map_height + map_tile_size - 1) / map_tile_size;
 	
 	map_center_x = map_width >> 1;
 	map_center_y = map_height >> 1;
 	
 	lon_ratio = 180.0 / map_center_x;
 	lat_ratio = -90.0 / map_center_y;
+}
+
+bool GeoMap::on_encoder(const EncoderEvent delta) {
+	// Clockwise zooms in (towards level 0)
+	const int32_t level = map_level_ - delta;
+	if ((level < 0) || (level >= map_level_count) || (level == map_level_))
+		return false;
 	
+	set_level(level);
+	move(lon_, lat_);
+	set_dirty();
 	return true;
 }
 
@@ -215,6 +319,72 @@ void GeoMap::set_mode(GeoMapMode mode) {
 	mode_ = mode;
 }
 
+// Screen position of (0, 0), as move() puts (lon_, lat_) at the center
+Point GeoMap::map_origin(const Rect r) const {
+	return {
+		static_cast<Coord>(r.left() + map_center_x - x_pos),
+		static_cast<Coord>(r.top() + map_center_y + (16 >> map_level_) - y_pos)
+	};
+}
+
+void GeoMap::draw_tracks(const Rect r) {
+	const auto origin = map_origin(r);
+	const auto to_screen = [this, origin](const GeoTracks::Point& point) {
+		return Point {
+			static_cast<Coord>(origin.x() + (point.lon / lon_ratio)),
+			static_cast<Coord>(origin.y() + (point.lat / lat_ratio))
+		};
+	};
+	
+	tracks_->for_each([&](const GeoTracks::Point* const points, const size_t count) {
+		auto a = to_screen(points[0]);
+		for (size_t i = 1; i < count; i++) {
+			const auto b = to_screen(points[i]);
+			// Segments leaving the map are left out rather than clipped
+			if (r.contains(a) && r.contains(b) && ((a.x() != b.x()) || (a.y() != b.y())))
+				display.draw_line(a, b, Color::cyan());
+			a = b;
+		}
+	});
+}
+
+void GeoMap::draw_markers(Painter& painter, const Rect r) {
+	const auto origin = map_origin(r);
+	const int32_t origin_x = origin.x();
+	const int32_t origin_y = origin.y();
+	
+	const float lon_min = (r.left() - origin_x) * lon_ratio;
+	const float lon_max = (r.right() - origin_x) * lon_ratio;
+	// lat_ratio is negative, the top edge is the northern one
+	const float lat_max = (r.top() - origin_y) * lat_ratio;
+	const float lat_min = (r.bottom() - origin_y) * lat_ratio;
+	
+	markers_->for_each_in(lat_min, lat_max, lon_min, lon_max, [&](const size_t i) {
+		const Point p {
+			static_cast<Coord>(origin_x + (markers_->lon(i) / lon_ratio)),
+			static_cast<Coord>(origin_y + (markers_->lat(i) / lat_ratio))
+		};
+		// Room for the arrow, so it never draws over the banner
+		if (!r.contains(p - Point(8, 8)) || !r.contains(p + Point(8, 8)))
+			return;
+		
+		const auto age = markers_->age(i);
+		const Color color = (age < 10) ? Color::yellow() : ((age < 30) ? Color::light_grey() : Color::dark_grey());
+		const auto heading = markers_->heading(i);
+		if (heading == GeoMarkers::heading_unknown)
+			display.fill_rectangle({ p - Point(2, 2), { 5, 5 } }, color);
+		else
+			draw_bearing(p, heading, 6, color);
+		
+		if (marker_label) {
+			const auto label = marker_label(markers_->id(i));
+			const Point label_pos = p + Point(-(int)label.length() * 4, 8);
+			if (r.contains(label_pos) && r.contains(label_pos + Point(label.length() * 8, 16)))
+				painter.draw_string(label_pos, style(), label);
+		}
+	});
+}
+
 void GeoMap::draw_bearing(const Point origin, const uint32_t angle, uint32_t size, const Color color) {
 	Point arrow_a, arrow_b, arrow_c;
 	
@@ -232,7 +402,11 @@ void GeoMap::draw_bearing(const Point origin, const uint32_t angle, uint32_t siz
 }
 
 void GeoMapView::focus() {
-	geopos.focus();
+	// Read-only position, the encoder zooms the map instead
+	if (mode_ == DISPLAY)
+		geomap.focus();
+	else
+		geopos.focus();
 	
 	if (!map_opened)
 		nav_.display_modal("No map", "No world_map.bin file in\n/ADSB/ directory", ABORT, nullptr);
@@ -250,6 +424,12 @@ void GeoMapView::update_position(float lat, float lon) {
 void GeoMapView::setup() {
 	add_child(&geomap);
 	
+	// Targets move on their own, between the owner's updates
+	signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+		if (geomap.overlays_changed())
+			geomap.set_dirty();
+	};
+	
 	geopos.set_altitude(altitude_);
 	geopos.set_lat(lat_);
 	geopos.set_lon(lon_);
@@ -279,6 +459,7 @@ void GeoMapView::setup() {
 
 
 GeoMapView::~GeoMapView() {
+	rtc_time::signal_tick_second -= signal_token_tick_second;
 	if (on_close_)
 		on_close_();
 }
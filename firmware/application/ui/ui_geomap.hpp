@@ -29,6 +29,8 @@
 #include "ui_font_fixed_8x16.hpp"
 
 #include "portapack.hpp"
+#include "geo_markers.hpp"
+#include "geo_tracks.hpp"
 
 namespace ui {
 
@@ -121,6 +123,7 @@ public:
 	void paint(Painter& painter) override;
 
 	bool on_touch(const TouchEvent event) override;
+	bool on_encoder(const EncoderEvent delta) override;
 	
 	bool init();
 	void set_mode(GeoMapMode mode);
@@ -129,11 +132,65 @@ public:
 		tag_ = new_tag;
 	}
 
+	/* Draws every marker on screen over the map, with its label if given.
+	 * The markers must outlive the map.
+	 */
+	void set_markers(const GeoMarkers* const markers, std::function<std::string(GeoMarkers::Id)> label = nullptr) {
+		markers_ = markers;
+		marker_label = label;
+		set_dirty();
+	}
+
+	/* Draws the tracks on screen under the markers. The tracks must outlive
+	 * the map.
+	 */
+	void set_tracks(const GeoTracks* const tracks) {
+		tracks_ = tracks;
+		set_dirty();
+	}
+
+	/* Whether markers or tracks changed since the last paint. */
+	bool overlays_changed() const {
+		return (markers_ && (markers_->revision() != markers_revision)) ||
+			(tracks_ && (tracks_->revision() != tracks_revision));
+	}
+
 private:
+	// Tiled map file header, followed by one level_t per level and padded to
+	// a sector. Tiles are RGB565, stored row by row from the level's offset.
+	struct map_header_t {
+		char magic[4];			// "PPMT"
+		uint16_t version;
+		uint16_t tile_size;
+		uint16_t level_count;
+		uint16_t reserved;
+	};
+	
+	struct map_level_t {
+		uint16_t width;
+		uint16_t height;
+		uint32_t offset;
+	};
+	
+	static constexpr uint16_t map_tile_size = 16;	// One tile per SD sector
+	static constexpr uint16_t map_levels_max = 8;
+	
 	void draw_bearing(const Point origin, const uint32_t angle, uint32_t size, const Color color);
+	void draw_tiles(const Rect r);
+	void draw_lines(const Rect r);
+	void draw_markers(Painter& painter, const Rect r);
+	void draw_tracks(const Rect r);
+	Point map_origin(const Rect r) const;
+	void set_level(const uint16_t level);
 	
 	GeoMapMode mode_ { };
 	File map_file { };
+	bool map_tiled { false };
+	std::array<map_level_t, map_levels_max> map_levels { };
+	uint16_t map_level_count { 0 };
+	uint16_t map_level_ { 0 };
+	uint32_t map_tiles_offset { 0 };
+	int32_t map_tiles_x { 0 }, map_tiles_y { 0 };
 	uint16_t map_width { }, map_height { };
 	int32_t map_center_x { }, map_center_y { };
 	float lon_ratio { }, lat_ratio { };
@@ -143,6 +200,12 @@ private:
 	float lon_ { };
 	float angle_ { };
 	std::string tag_ { };
+	
+	const GeoMarkers* markers_ { nullptr };
+	std::function<std::string(GeoMarkers::Id)> marker_label { };
+	uint32_t markers_revision { 0 };
+	const GeoTracks* tracks_ { nullptr };
+	uint32_t tracks_revision { 0 };
 };
 
 class GeoMapView : public View {
@@ -174,6 +237,12 @@ public:
 	void focus() override;
 	
 	void update_position(float lat, float lon);
+	void set_markers(const GeoMarkers* const markers, std::function<std::string(GeoMarkers::Id)> label = nullptr) {
+		geomap.set_markers(markers, label);
+	}
+	void set_tracks(const GeoTracks* const tracks) {
+		geomap.set_tracks(tracks);
+	}
 	
 	std::string title() const override { return "Map view"; };
 
@@ -194,6 +263,7 @@ private:
 	std::function<void(void)> on_close_ { nullptr };
 	
 	bool map_opened { };
+	SignalToken signal_token_tick_second { };
 	
 	GeoPos geopos {
 		{ 0, 0 },
@@ -23,12 +23,25 @@
 #include "ui_menu.hpp"
 #include "rtc_time.hpp"
 
+#include <cstring>
+#include <algorithm>
+
 namespace ui {
 
 /* MenuItemView **********************************************************/
 
 void MenuItemView::set_item(MenuItem* item_) {
 	item = item_;
+	entry = nullptr;
+}
+
+void MenuItemView::set_entry(const MenuEntry* entry_) {
+	entry = entry_;
+	item = nullptr;
+}
+
+void MenuItemView::set_keep_highlight(const bool v) {
+	keep_highlight = v;
 }
 
 void MenuItemView::highlight() {
@@ -44,7 +57,10 @@ void MenuItemView::unhighlight() {
 void MenuItemView::paint(Painter& painter) {
 	Coord offset_x { };
 	
-	if (!item) return;
+	if (!item && !entry) return;
+
+	const auto item_color = item ? item->color : entry->color;
+	const auto item_bitmap = item ? item->bitmap : entry->bitmap;
 	
 	const auto r = screen_rect();
 
@@ -52,8 +68,8 @@ void MenuItemView::paint(Painter& painter) {
 
 	const auto font_height = paint_style.font.line_height();
 	
-	ui::Color final_item_color = (highlighted() && (parent()->has_focus() || keep_highlight)) ? paint_style.foreground : item->color;
-	ui::Color final_bg_color = (highlighted() && (parent()->has_focus() || keep_highlight)) ? item->color : paint_style.background;
+	ui::Color final_item_color = (highlighted() && (parent()->has_focus() || keep_highlight)) ? paint_style.foreground : item_color;
+	ui::Color final_bg_color = (highlighted() && (parent()->has_focus() || keep_highlight)) ? item_color : paint_style.background;
 
 	if (final_item_color.v == final_bg_color.v) final_item_color = paint_style.foreground;
 
@@ -62,10 +78,10 @@ void MenuItemView::paint(Painter& painter) {
 		final_bg_color
 	);
 	
-	if (item->bitmap) {
+	if (item_bitmap) {
 		painter.draw_bitmap(
 			{ r.location().x() + 4, r.location().y() + 4 },
-			*item->bitmap,
+			*item_bitmap,
 			final_item_color,
 			final_bg_color
 		);
@@ -79,11 +95,12 @@ void MenuItemView::paint(Painter& painter) {
 		.foreground = final_item_color
 	};
 
-	painter.draw_string(
-		{ r.location().x() + offset_x, r.location().y() + (r.size().height() - font_height) / 2 },
-		text_style,
-		item->text
-	);
+	const Point text_position { r.location().x() + offset_x, r.location().y() + (r.size().height() - font_height) / 2 };
+	if (item) {
+		painter.draw_string(text_position, text_style, item->text);
+	} else {
+		painter.draw_string(text_position, text_style, entry->text, strlen(entry->text));
+	}
 }
 
 /* MenuView **************************************************************/
@@ -108,36 +125,25 @@ MenuView::MenuView(
 
 MenuView::~MenuView() {
 	rtc_time::signal_tick_second -= signal_token_tick_second;
-	
-	for (auto item : menu_item_views) {
-		delete item;
-	}
 }
 
 void MenuView::set_parent_rect(const Rect new_parent_rect) {
 	View::set_parent_rect(new_parent_rect);
 	
-	displayed_max = (parent_rect().size().height() / item_height);
-	arrow_more.set_parent_rect( { 228, (Coord)(displayed_max * item_height), 8, 8 } );
-	
-	// TODO: Clean this up :(
-	if (menu_item_views.size()) {
-	
-		for (auto item : menu_item_views) {
-			remove_child(item);
-			delete item;
-		}
-		
-		menu_item_views.clear();
+	for (size_t c = 0; c < displayed_max; c++) {
+		remove_child(&menu_item_views[c]);
 	}
+
+	displayed_max = std::min(parent_rect().size().height() / item_height, displayed_max_max);
+	arrow_more.set_parent_rect( { 228, (Coord)(displayed_max * item_height), 8, 8 } );
 	
 	for (size_t c = 0; c < displayed_max; c++) {
-		auto item = new MenuItemView { keep_highlight };
-		menu_item_views.push_back(item);
-		add_child(item);
+		auto& item = menu_item_views[c];
+		item.set_keep_highlight(keep_highlight);
+		add_child(&item);
 		
 		Coord y_pos = c * item_height;
-		item->set_parent_rect({
+		item.set_parent_rect({
 			{ 0, y_pos },
 			{ size().width(), (Coord)item_height }
 		});
@@ -158,11 +164,36 @@ void MenuView::on_tick_second() {
 }
 
 void MenuView::clear() {
-	for (auto item : menu_item_views) {
-		item->set_item(nullptr);
+	for (auto& item : menu_item_views) {
+		item.set_item(nullptr);
 	}
 	
 	menu_items.clear();
+	entries = nullptr;
+	entry_count = 0;
+}
+
+void MenuView::set_entries(const MenuEntry* const new_entries, const size_t count, NavigationView& nav) {
+	clear();
+	entries = new_entries;
+	entry_count = count;
+	entries_nav = &nav;
+
+	update_items();
+}
+
+size_t MenuView::item_count() const {
+	return entries ? entry_count : menu_items.size();
+}
+
+void MenuView::select_item(const size_t index) {
+	if (entries) {
+		if (entries[index].on_select) {
+			entries[index].on_select(*entries_nav);
+		}
+	} else if (menu_items[index].on_select) {
+		menu_items[index].on_select();
+	}
 }
 
 void MenuView::add_item(MenuItem new_item) {
@@ -180,40 +211,46 @@ void MenuView::add_items(std::initializer_list<MenuItem> new_items) {
 void MenuView::update_items() {
 	size_t i = 0;
 	
-	if (menu_items.size() > displayed_max + offset) {
+	const size_t count = item_count();
+	if (count > displayed_max + offset) {
 		more = true;
 		blink = true;
 	} else
 		more = false;
 	
-	for (auto item : menu_item_views) {
-		if (i >= menu_items.size()) break;
+	for (size_t c = 0; c < displayed_max; c++) {
+		auto& item = menu_item_views[c];
+		if (i + offset >= count) break;
 		
 		// Assign item data to MenuItemViews according to offset
-		item->set_item(&menu_items[i + offset]);
-		item->set_dirty();
+		if (entries) {
+			item.set_entry(&entries[i + offset]);
+		} else {
+			item.set_item(&menu_items[i + offset]);
+		}
+		item.set_dirty();
 		
 		if (highlighted_item == (i + offset)) {
-			item->highlight();
+			item.highlight();
 		} else
-			item->unhighlight();
+			item.unhighlight();
 		
 		i++;
 	}
 }
 
 MenuItemView* MenuView::item_view(size_t index) const {
-	return menu_item_views[index];
+	return const_cast<MenuItemView*>(&menu_item_views[index]);
 }
 
 bool MenuView::set_highlighted(int32_t new_value) {
-	int32_t item_count = (int32_t)menu_items.size();
+	const int32_t count = (int32_t)item_count();
 	
 	if (new_value < 0)
 		return false;
 	
-	if (new_value >= item_count)
-		new_value = item_count - 1;
+	if (new_value >= count)
+		new_value = count - 1;
 	
 	if (((uint32_t)new_value > offset) && ((new_value - offset) >= displayed_max)) {
 		// Shift MenuView up
@@ -261,8 +298,8 @@ bool MenuView::on_key(const KeyEvent key) {
 
 	case KeyEvent::Select:
 	case KeyEvent::Right:
-		if( menu_items[highlighted_item].on_select ) {
-			menu_items[highlighted_item].on_select();
+		if( highlighted_item < item_count() ) {
+			select_item(highlighted_item);
 		}
 		return true;
 
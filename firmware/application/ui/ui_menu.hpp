@@ -32,9 +32,22 @@
 #include <cstddef>
 #include <string>
 #include <functional>
+#include <array>
 
 namespace ui {
 
+class NavigationView;
+
+/* Fixed menu item, for menus laid out at compile time: constexpr tables of
+ * these stay in flash and MenuView renders straight from them.
+ */
+struct MenuEntry {
+	const char* text;
+	ui::Color color;
+	const Bitmap* bitmap;
+	void (*on_select)(NavigationView& nav);
+};
+
 struct MenuItem {
 	std::string text;
 	ui::Color color;
@@ -49,7 +62,7 @@ struct MenuItem {
 class MenuItemView : public Widget {
 public:
 	MenuItemView(
-		bool keep_highlight
+		bool keep_highlight = false
 	) : keep_highlight { keep_highlight }
 	{
 	}
@@ -62,12 +75,15 @@ public:
 	void paint(Painter& painter) override;
 	
 	void set_item(MenuItem* item_);
+	void set_entry(const MenuEntry* entry_);
+	void set_keep_highlight(const bool v);
 
 	void highlight();
 	void unhighlight();
 
 private:
 	MenuItem* item { nullptr };
+	const MenuEntry* entry { nullptr };
 	bool keep_highlight = false;
 };
 
@@ -83,6 +99,15 @@ public:
 	void add_item(MenuItem new_item);
 	void add_items(std::initializer_list<MenuItem> new_items);
 	void clear();
+
+	/* Shows a fixed table instead of added items, entries must outlive the
+	 * view. Selecting one calls it with nav.
+	 */
+	void set_entries(const MenuEntry* const new_entries, const size_t count, NavigationView& nav);
+	template<size_t N>
+	void set_entries(const MenuEntry (&new_entries)[N], NavigationView& nav) {
+		set_entries(new_entries, N, nav);
+	}
 	
 	MenuItemView* item_view(size_t index) const;
 
@@ -96,6 +121,11 @@ public:
 	bool on_encoder(const EncoderEvent event) override;
 	
 private:
+	static constexpr size_t item_height = 24;
+	static constexpr size_t displayed_max_max = 320 / item_height;
+
+	size_t item_count() const;
+	void select_item(const size_t index);
 	void update_items();
 	void on_tick_second();
 	
@@ -103,7 +133,11 @@ private:
 	
 	SignalToken signal_token_tick_second { };
 	std::vector<MenuItem> menu_items { };
-	std::vector<MenuItemView*> menu_item_views { };
+	const MenuEntry* entries { nullptr };
+	size_t entry_count { 0 };
+	NavigationView* entries_nav { nullptr };
+	// As many as fit on screen, the slots are reassigned as the menu scrolls.
+	std::array<MenuItemView, displayed_max_max> menu_item_views { };
 	
 	Image arrow_more {
 		{ 228, 320 - 8, 8, 8 },
@@ -112,7 +146,6 @@ private:
 		Color::black()
 	};
 
-	const size_t item_height = 24;
 	bool blink = false;
 	bool more = false;
 	size_t displayed_max { 0 };
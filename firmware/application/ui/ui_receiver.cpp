@@ -247,9 +247,17 @@ FrequencyOptionsView::FrequencyOptionsView(
 		this->on_reference_ppm_correction_changed(v);
 	};
 
+	field_tracking.on_change = [this](int32_t v) {
+		if( this->on_change_frequency_tracking ) {
+			this->on_change_frequency_tracking(v);
+		}
+	};
+
 	add_children({
 		&text_step,
 		&field_step,
+		&text_tracking,
+		&field_tracking,
 		&field_ppm,
 		&text_ppm,
 	});
@@ -263,6 +271,10 @@ void FrequencyOptionsView::set_reference_ppm_correction(int32_t v) {
 	field_ppm.set_value(v);
 }
 
+void FrequencyOptionsView::set_frequency_tracking(bool enabled) {
+	field_tracking.set_value(enabled);
+}
+
 void FrequencyOptionsView::on_step_changed(rf::Frequency v) {
 	if( on_change_step ) {
 		on_change_step(v);
@@ -267,11 +267,13 @@ class FrequencyOptionsView : public View {
 public:
 	std::function<void(rf::Frequency)> on_change_step { };
 	std::function<void(int32_t)> on_change_reference_ppm_correction { };
+	std::function<void(bool)> on_change_frequency_tracking { };
 
 	FrequencyOptionsView(const Rect parent_rect, const Style* const style);
 
 	void set_step(rf::Frequency f);
 	void set_reference_ppm_correction(int32_t v);
+	void set_frequency_tracking(bool enabled);
 
 private:
 	Text text_step {
@@ -286,6 +288,19 @@ private:
 	void on_step_changed(rf::Frequency v);
 	void on_reference_ppm_correction_changed(int32_t v);
 
+	Text text_tracking {
+		{ 14 * 8, 0 * 16, 3 * 8, 1 * 16 },
+		"AFC"
+	};
+
+	NumberField field_tracking {
+		{ 18 * 8, 0 * 16 },
+		1,
+		{ 0, 1 },
+		1,
+		' ',
+	};
+
 	NumberField field_ppm {
 		{ 23 * 8, 0 * 16 },
 		3,
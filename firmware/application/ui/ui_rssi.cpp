@@ -75,6 +75,15 @@ void RSSI::paint(Painter& painter) {
 		Color::black()
 	);
 	
+	// Peak hold: bursts too short to move max_ much still leave a mark.
+	const auto x_peak = x_max_range.clip((peak_ - raw_min) * r.width() / raw_delta);
+	if( x_peak > x_max ) {
+		painter.fill_rectangle(
+			{ r.left() + x_peak - 1, r.top(), 1, r.height() },
+			Color::yellow()
+		);
+	}
+	
 	if (pitch_rssi_enabled)
 		baseband::set_pitch_rssi((avg_ - raw_min) * 2000 / raw_delta, true);
 }
@@ -88,6 +97,15 @@ void RSSI::on_statistics_update(const RSSIStatistics& statistics) {
 	min_ = statistics.min;
 	avg_ = statistics.accumulator / statistics.count;
 	max_ = statistics.max;
+	const int32_t peak = baseband::rssi_peak_hold();
+	if( peak >= peak_ ) {
+		peak_ = peak;
+		peak_hold_ = peak_hold_updates;
+	} else if( peak_hold_ ) {
+		peak_hold_--;
+	} else {
+		peak_ = std::max(peak, peak_ - 4);
+	}
 	set_dirty();
 }
 
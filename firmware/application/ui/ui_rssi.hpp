@@ -41,7 +41,8 @@ public:
 	) : Widget { parent_rect },
 		min_ { 0 },
 		avg_ { 0 },
-		max_ { 0 }
+		max_ { 0 },
+		peak_ { 0 }
 	{
 	}
 
@@ -51,6 +52,12 @@ private:
 	int32_t min_;
 	int32_t avg_;
 	int32_t max_;
+	/* Peak hold, from every RSSI sample: held for peak_hold_updates, then
+	 * falling back towards max_.
+	 */
+	int32_t peak_;
+	size_t peak_hold_ { 0 };
+	static constexpr size_t peak_hold_updates = 10;
 	
 	bool pitch_rssi_enabled = false;
 
@@ -47,7 +47,7 @@ AudioSpectrumView::AudioSpectrumView(
 	add_children({
 		&labels,
 		&field_frequency,
-		&waveform
+		&bar_graph
 	});
 	
 	field_frequency.on_change = [this](int32_t) {
@@ -75,9 +75,7 @@ void AudioSpectrumView::paint(Painter& painter) {
 }
 
 void AudioSpectrumView::on_audio_spectrum(const AudioSpectrum* spectrum) {
-	for (size_t i = 0; i < spectrum->db.size(); i++)
-		audio_spectrum[i] = ((int16_t)spectrum->db[i] - 127) * 256;
-	waveform.set_dirty();
+	bar_graph.set_values(spectrum->db.data(), spectrum->db.size());
 }
 
 /* FrequencyScale ********************************************************/
@@ -293,25 +291,12 @@ void WaterfallView::paint(Painter& painter) {
 void WaterfallView::on_channel_spectrum(
 	const ChannelSpectrum& spectrum
 ) {
-	/* TODO: static_assert that message.spectrum.db.size() >= pixel_row.size() */
-
-	std::array<Color, 240> pixel_row;
-	for(size_t i=0; i<120; i++) {
-		const auto pixel_color = spectrum_rgb3_lut[spectrum.db[256 - 120 + i]];
-		pixel_row[i] = pixel_color;
-	}
-
-	for(size_t i=120; i<240; i++) {
-		const auto pixel_color = spectrum_rgb3_lut[spectrum.db[i - 120]];
-		pixel_row[i] = pixel_color;
+	if( spectrum.row_valid ) {
+		display.scroll_draw_line(spectrum.row);
+	} else {
+		// Negative frequency bins (136~255) on the left, then 0~119.
+		display.scroll_draw_line(spectrum.db, 256 - 120, spectrum_rgb3_lut);
 	}
-
-	const auto draw_y = display.scroll(1);
-
-	display.draw_pixels(
-		{ { 0, draw_y }, { pixel_row.size(), 1 } },
-		pixel_row
-	);
 }
 
 void WaterfallView::clear() {
@@ -338,13 +323,39 @@ WaterfallWidget::WaterfallWidget(const bool cursor) {
 }
 
 void WaterfallWidget::on_show() {
-	baseband::spectrum_streaming_start();
+	streaming = true;
+	start_streaming();
+}
+
+void WaterfallWidget::start_streaming() {
+	baseband::spectrum_streaming_start(SpectrumStreamingConfigMessage::FFT::Float, trace_, trace_param, colors_, delivery_, fifo_k_);
 }
 
 void WaterfallWidget::on_hide() {
+	streaming = false;
 	baseband::spectrum_streaming_stop();
 }
 
+void WaterfallWidget::set_trace(const SpectrumStreamingConfigMessage::Trace new_trace, const uint32_t new_trace_param) {
+	trace_ = new_trace;
+	trace_param = new_trace_param;
+	if (streaming)
+		start_streaming();
+}
+
+void WaterfallWidget::set_delivery(const SpectrumStreamingConfigMessage::Delivery new_delivery, const size_t new_fifo_k) {
+	delivery_ = new_delivery;
+	fifo_k_ = new_fifo_k;
+	if (streaming)
+		start_streaming();
+}
+
+void WaterfallWidget::set_color_range(const int32_t ref_level_db, const uint32_t range_db) {
+	colors_ = { ref_level_db, range_db };
+	if (streaming)
+		start_streaming();
+}
+
 void WaterfallWidget::show_audio_spectrum_view(const bool show) {
 	if ((audio_spectrum_view && show) || (!audio_spectrum_view && !show)) return;
 	
@@ -387,6 +398,8 @@ void WaterfallWidget::paint(Painter& painter) {
 
 void WaterfallWidget::on_channel_spectrum(const ChannelSpectrum& spectrum) {
 	waterfall_view.on_channel_spectrum(spectrum);
+	if (on_spectrum)
+		on_spectrum(spectrum);
 	sampling_rate = spectrum.sampling_rate;
 	frequency_scale.set_spectrum_sampling_rate(sampling_rate);
 	frequency_scale.set_channel_filter(
@@ -46,8 +46,6 @@ public:
 private:
 	static constexpr int cursor_band_height = 4;
 	
-	int16_t audio_spectrum[128] { 0 };
-	
 	Labels labels {
 		{ { 6 * 8, 0 * 16 }, "Hz", Color::light_grey() }
 	};
@@ -60,12 +58,9 @@ private:
 		' '
 	};
 	
-	Waveform waveform {
+	BarGraph bar_graph {
 		{ 0, 1 * 16 + cursor_band_height, 30 * 8, 2 * 16 },
-		audio_spectrum,
 		128,
-		0,
-		false,
 		Color::white()
 	};
 };
@@ -122,6 +117,8 @@ private:
 class WaterfallWidget : public View {
 public:
 	std::function<void(int32_t offset)> on_select { };
+	// Every frame drawn, for loggers.
+	std::function<void(const ChannelSpectrum& spectrum)> on_spectrum { };
 	
 	WaterfallWidget(const bool cursor = false);
 
@@ -136,11 +133,26 @@ public:
 	void set_parent_rect(const Rect new_parent_rect) override;
 	
 	void show_audio_spectrum_view(const bool show);
+	
+	/* Select the trace painted as waterfall rows, restarting its accumulation. */
+	void set_trace(const SpectrumStreamingConfigMessage::Trace new_trace, const uint32_t new_trace_param);
+	SpectrumStreamingConfigMessage::Trace trace() const { return trace_; };
+	
+	/* Colour scale top (dBFS) and span, mapped on the baseband. A range of
+	 * 0 has the rows coloured here instead.
+	 */
+	void set_color_range(const int32_t ref_level_db, const uint32_t range_db);
+	
+	/* FIFO depth 2^fifo_k against latency, frames lost are reported in
+	 * ChannelSpectrum::dropped.
+	 */
+	void set_delivery(const SpectrumStreamingConfigMessage::Delivery new_delivery, const size_t new_fifo_k);
 
 	void paint(Painter& painter) override;
 
 private:
 	void update_widgets_rect();
+	void start_streaming();
 	
 	const Rect audio_spectrum_view_rect { 0 * 8, 0 * 16, 30 * 8, 2 * 16 + 20 };
 	static constexpr Dim audio_spectrum_height = 16 * 2 + 20;
@@ -152,6 +164,13 @@ private:
 	ChannelSpectrumFIFO* channel_fifo { nullptr };
 	AudioSpectrum* audio_spectrum_data { nullptr };
 	bool audio_spectrum_update { false };
+	bool streaming { false };
+	SpectrumStreamingConfigMessage::Trace trace_ { SpectrumStreamingConfigMessage::Trace::Instant };
+	uint32_t trace_param { 0 };
+	// Same scale as the db byte, as rows looked up here used to be drawn.
+	SpectrumStreamingConfigMessage::Colors colors_ { 0, 51 };
+	SpectrumStreamingConfigMessage::Delivery delivery_ { SpectrumStreamingConfigMessage::Delivery::Latest };
+	size_t fifo_k_ { ChannelSpectrumConfigMessage::fifo_k };
 	
 	std::unique_ptr<AudioSpectrumView> audio_spectrum_view { };
 	
@@ -37,7 +37,7 @@
 #include "ui_aprs_tx.hpp"
 #include "ui_bht_tx.hpp"
 #include "ui_coasterp.hpp"
-//#include "ui_debug.hpp"
+#include "ui_debug.hpp"
 #include "ui_encoders.hpp"
 #include "ui_fileman.hpp"
 #include "ui_freqman.hpp"
@@ -80,6 +80,9 @@
 #include "file.hpp"
 #include "png_writer.hpp"
 
+#include <algorithm>
+#include <cctype>
+
 using portapack::receiver_model;
 using portapack::transmitter_model;
 
@@ -87,16 +90,33 @@ namespace ui {
 
 /* SystemStatusView ******************************************************/
 
+namespace {
+
+constexpr Style style_systemstatus {
+	.font = font::fixed_8x16,
+	.background = Color::dark_grey(),
+	.foreground = Color::white(),
+};
+
+// The title, while the baseband sheds optional work to keep up.
+constexpr Style style_systemstatus_shedding {
+	.font = font::fixed_8x16,
+	.background = Color::dark_grey(),
+	.foreground = Color::yellow(),
+};
+
+constexpr Style style_systemstatus_shedding_max {
+	.font = font::fixed_8x16,
+	.background = Color::dark_grey(),
+	.foreground = Color::red(),
+};
+
+} /* namespace */
+
 SystemStatusView::SystemStatusView(
 	NavigationView& nav
 ) : nav_ (nav)
 {
-	static constexpr Style style_systemstatus {
-		.font = font::fixed_8x16,
-		.background = Color::dark_grey(),
-		.foreground = Color::white(),
-	};
-	
 	add_children({
 		&backdrop,
 		&button_back,
@@ -168,6 +188,16 @@ void SystemStatusView::refresh() {
 	}
 }
 
+void SystemStatusView::on_load_shedding(const LoadSheddingMessage& message) {
+	if( message.level == 0 ) {
+		title.set_style(&style_systemstatus);
+	} else if( message.level < 3 ) {
+		title.set_style(&style_systemstatus_shedding);
+	} else {
+		title.set_style(&style_systemstatus_shedding_max);
+	}
+}
+
 void SystemStatusView::set_back_enabled(bool new_value) {
 	button_back.set_foreground(new_value ? Color::white() : Color::dark_grey());
 	button_back.set_focusable(new_value);
@@ -222,13 +252,27 @@ void SystemStatusView::on_bias_tee() {
 }*/
 
 void SystemStatusView::on_camera() {
+	if( screenshot && !screenshot->is_done() ) {
+		// Still writing the last one.
+		return;
+	}
+	screenshot.reset();
+
 	auto path = next_filename_stem_matching_pattern(u"SCR_????");
 	if( path.empty() ) {
 		return;
 	}
+	path.replace_extension(u".PNG");
 
-	PNGWriter png;
-	auto create_error = png.create(path.replace_extension(u".PNG"));
+	screenshot = ScreenshotThread::capture(path);
+	if( screenshot ) {
+		return;
+	}
+
+	// Too busy for the run buffer, write it from here instead.
+	// Holds its compression buffers, too big for the stack
+	auto png = std::make_unique<PNGWriter>();
+	auto create_error = png->create(path);
 	if( create_error.is_valid() ) {
 		return;
 	}
@@ -236,7 +280,7 @@ void SystemStatusView::on_camera() {
 	for(int i = 0; i < 320; i++) {
 		std::array<ColorRGB888, 240> row;
 		portapack::display.read_pixels({ 0, i, 240, 1 }, row);
-		png.write_scanline(row);
+		png->write_scanline(row);
 	}
 }
 
@@ -246,11 +290,11 @@ bool NavigationView::is_top() const {
 	return view_stack.size() == 1;
 }
 
-View* NavigationView::push_view(std::unique_ptr<View> new_view) {
+View* NavigationView::push_view(std::unique_ptr<View> new_view, std::unique_ptr<chibios::Arena> arena) {
 	free_view();
 
 	const auto p = new_view.get();
-	view_stack.emplace_back(std::move(new_view));
+	view_stack.push_back({ std::move(arena), std::move(new_view) });
 
 	update_view();
 
@@ -312,7 +356,7 @@ void NavigationView::free_view() {
 }
 
 void NavigationView::update_view() {
-	const auto new_view = view_stack.back().get();
+	const auto new_view = view_stack.back().view.get();
 	
 	add_child(new_view);
 	new_view->set_parent_rect({ {0, 0}, size() });
@@ -337,24 +381,26 @@ void NavigationView::focus() {
 
 /* ReceiversMenuView *****************************************************/
 
+static constexpr MenuEntry receivers_menu[] {
+	{ "ADS-B: Planes", 			ui::Color::green(),	&bitmap_icon_adsb,	menu_replace<ADSBRxView> },
+	{ "ACARS: Planes", 			ui::Color::yellow(),&bitmap_icon_adsb,	menu_replace<ACARSAppView> },
+	{ "AIS:   Boats", 			ui::Color::green(),	&bitmap_icon_ais,	menu_replace<AISAppView> },
+	{ "AFSK", 					ui::Color::yellow(),&bitmap_icon_receivers,	menu_replace<AFSKRxView> },
+	{ "Audio", 					ui::Color::green(),	&bitmap_icon_speaker,	menu_replace<AnalogAudioView> },
+	{ "ERT:   Utility Meters", 	ui::Color::green(), &bitmap_icon_ert,	menu_replace<ERTAppView> },
+	{ "POCSAG", 				ui::Color::green(),	&bitmap_icon_pocsag,	menu_replace<POCSAGAppView> },
+	{ "Radiosondes", 			ui::Color::yellow(),&bitmap_icon_sonde,	menu_replace<SondeView> },
+	{ "TPMS:  Cars", 			ui::Color::green(),	&bitmap_icon_tpms,	menu_replace<TPMSAppView> },
+	{ "APRS", 					ui::Color::grey(),	&bitmap_icon_aprs,	menu_replace<NotImplementedView> },
+	{ "DMR framing", 			ui::Color::grey(),	&bitmap_icon_dmr,	menu_replace<NotImplementedView> },
+	{ "SIGFOX", 				ui::Color::grey(),	&bitmap_icon_fox,	menu_replace<NotImplementedView> }, // SIGFRXView
+	{ "LoRa", 					ui::Color::grey(),	&bitmap_icon_lora,	menu_replace<NotImplementedView> },
+	{ "SSTV", 					ui::Color::grey(), 	&bitmap_icon_sstv,	menu_replace<NotImplementedView> },
+	{ "TETRA framing", 			ui::Color::grey(),	&bitmap_icon_tetra,	menu_replace<NotImplementedView> },
+};
+
 ReceiversMenuView::ReceiversMenuView(NavigationView& nav) {
-	add_items({
-		{ "ADS-B: Planes", 			ui::Color::green(),	&bitmap_icon_adsb,	[&nav](){ nav.replace<ADSBRxView>(); }, },
-		{ "ACARS: Planes", 			ui::Color::yellow(),&bitmap_icon_adsb,	[&nav](){ nav.replace<ACARSAppView>(); }, },
-		{ "AIS:   Boats", 			ui::Color::green(),	&bitmap_icon_ais,	[&nav](){ nav.replace<AISAppView>(); } },
-		{ "AFSK", 					ui::Color::yellow(),&bitmap_icon_receivers,	[&nav](){ nav.replace<AFSKRxView>(); } },
-		{ "Audio", 					ui::Color::green(),	&bitmap_icon_speaker,	[&nav](){ nav.replace<AnalogAudioView>(); } },
-		{ "ERT:   Utility Meters", 	ui::Color::green(), &bitmap_icon_ert,	[&nav](){ nav.replace<ERTAppView>(); } },
-		{ "POCSAG", 				ui::Color::green(),	&bitmap_icon_pocsag,	[&nav](){ nav.replace<POCSAGAppView>(); } },
-		{ "Radiosondes", 			ui::Color::yellow(),&bitmap_icon_sonde,	[&nav](){ nav.replace<SondeView>(); } },
-		{ "TPMS:  Cars", 			ui::Color::green(),	&bitmap_icon_tpms,	[&nav](){ nav.replace<TPMSAppView>(); } },
-		{ "APRS", 					ui::Color::grey(),	&bitmap_icon_aprs,	[&nav](){ nav.replace<NotImplementedView>(); } },
-		{ "DMR framing", 			ui::Color::grey(),	&bitmap_icon_dmr,	[&nav](){ nav.replace<NotImplementedView>(); } },
-		{ "SIGFOX", 				ui::Color::grey(),	&bitmap_icon_fox,	[&nav](){ nav.replace<NotImplementedView>(); } }, // SIGFRXView
-		{ "LoRa", 					ui::Color::grey(),	&bitmap_icon_lora,	[&nav](){ nav.replace<NotImplementedView>(); } },
-		{ "SSTV", 					ui::Color::grey(), 	&bitmap_icon_sstv,	[&nav](){ nav.replace<NotImplementedView>(); } },
-		{ "TETRA framing", 			ui::Color::grey(),	&bitmap_icon_tetra,	[&nav](){ nav.replace<NotImplementedView>(); } },
-	});
+	set_entries(receivers_menu, nav);
 	on_left = [&nav](){ nav.pop(); };
 	
 	set_highlighted(4);		// Default selection is "Audio"
@@ -362,51 +408,55 @@ ReceiversMenuView::ReceiversMenuView(NavigationView& nav) {
 
 /* TransmittersMenuView **************************************************/
 
+static constexpr MenuEntry transmitters_menu[] {
+	{ "ADS-B Mode S", 			ui::Color::yellow(), 	&bitmap_icon_adsb,		menu_push<ADSBTxView> },
+	{ "APRS", 					ui::Color::orange(),	&bitmap_icon_aprs,		menu_push<APRSTXView> },
+	{ "BHT Xy/EP", 				ui::Color::green(), 	&bitmap_icon_bht,		menu_push<BHTView> },
+	{ "Jammer", 				ui::Color::yellow(),	&bitmap_icon_jammer,	menu_push<JammerView> },
+	{ "Key fob", 				ui::Color::orange(),	&bitmap_icon_keyfob,	menu_push<KeyfobView> },
+	{ "Microphone", 			ui::Color::green(),		&bitmap_icon_microphone,	menu_push<MicTXView> },
+	{ "Morse code", 			ui::Color::green(),		&bitmap_icon_morse,		menu_push<MorseView> },
+	{ "NTTWorks burger pager", 	ui::Color::yellow(), 	&bitmap_icon_burger,	menu_push<CoasterPagerView> },
+	//{ "Nuoptix DTMF timecode", 	ui::Color::green(),		&bitmap_icon_nuoptix,	menu_push<NuoptixView> },
+	{ "OOK encoders", 			ui::Color::yellow(),	&bitmap_icon_remote,	menu_push<EncodersView> },
+	{ "POCSAG", 				ui::Color::green(),		&bitmap_icon_pocsag,	menu_push<POCSAGTXView> },
+	{ "RDS",					ui::Color::green(),		&bitmap_icon_rds,		menu_push<RDSView> },
+	{ "Soundboard", 			ui::Color::green(), 	&bitmap_icon_soundboard,	menu_push<SoundBoardView> },
+	{ "SSTV", 					ui::Color::green(), 	&bitmap_icon_sstv,		menu_push<SSTVTXView> },
+	{ "TEDI/LCR AFSK", 			ui::Color::yellow(), 	&bitmap_icon_lcr,		menu_push<LCRView> },
+	{ "TouchTunes remote",		ui::Color::yellow(),	&bitmap_icon_remote,	menu_push<TouchTunesView> },
+	{ "Custom remote", 			ui::Color::grey(),		&bitmap_icon_remote,	menu_push<RemoteView> },
+};
+
 TransmittersMenuView::TransmittersMenuView(NavigationView& nav) {
-	add_items({
-		{ "ADS-B Mode S", 			ui::Color::yellow(), 	&bitmap_icon_adsb,		[&nav](){ nav.push<ADSBTxView>(); } },
-		{ "APRS", 					ui::Color::orange(),	&bitmap_icon_aprs,		[&nav](){ nav.push<APRSTXView>(); } },
-		{ "BHT Xy/EP", 				ui::Color::green(), 	&bitmap_icon_bht,		[&nav](){ nav.push<BHTView>(); } },
-		{ "Jammer", 				ui::Color::yellow(),	&bitmap_icon_jammer,	[&nav](){ nav.push<JammerView>(); } },
-		{ "Key fob", 				ui::Color::orange(),	&bitmap_icon_keyfob,	[&nav](){ nav.push<KeyfobView>(); } },
-		{ "Microphone", 			ui::Color::green(),		&bitmap_icon_microphone,	[&nav](){ nav.push<MicTXView>(); } },
-		{ "Morse code", 			ui::Color::green(),		&bitmap_icon_morse,		[&nav](){ nav.push<MorseView>(); } },
-		{ "NTTWorks burger pager", 	ui::Color::yellow(), 	&bitmap_icon_burger,	[&nav](){ nav.push<CoasterPagerView>(); } },
-		//{ "Nuoptix DTMF timecode", 	ui::Color::green(),		&bitmap_icon_nuoptix,	[&nav](){ nav.push<NuoptixView>(); } },
-		{ "OOK encoders", 			ui::Color::yellow(),	&bitmap_icon_remote,	[&nav](){ nav.push<EncodersView>(); } },
-		{ "POCSAG", 				ui::Color::green(),		&bitmap_icon_pocsag,	[&nav](){ nav.push<POCSAGTXView>(); } },
-		{ "RDS",					ui::Color::green(),		&bitmap_icon_rds,		[&nav](){ nav.push<RDSView>(); } },
-		{ "Soundboard", 			ui::Color::green(), 	&bitmap_icon_soundboard,	[&nav](){ nav.push<SoundBoardView>(); } },
-		{ "SSTV", 					ui::Color::green(), 	&bitmap_icon_sstv,		[&nav](){ nav.push<SSTVTXView>(); } },
-		{ "TEDI/LCR AFSK", 			ui::Color::yellow(), 	&bitmap_icon_lcr,		[&nav](){ nav.push<LCRView>(); } },
-		{ "TouchTunes remote",		ui::Color::yellow(),	&bitmap_icon_remote,	[&nav](){ nav.push<TouchTunesView>(); } },
-		{ "Custom remote", 			ui::Color::grey(),		&bitmap_icon_remote,	[&nav](){ nav.push<RemoteView>(); } },
-	});
+	set_entries(transmitters_menu, nav);
 	on_left = [&nav](){ nav.pop(); };
 }
 
 /* UtilitiesMenuView *****************************************************/
 
+static constexpr MenuEntry utilities_menu[] {
+	//{ "Test app", 				ui::Color::grey(), 		nullptr,				menu_push<TestView> },
+	{ "Frequency manager", 		ui::Color::green(), 	&bitmap_icon_freqman,	menu_push<FrequencyManagerView> },
+	{ "File manager", 			ui::Color::yellow(),	&bitmap_icon_file,		menu_push<FileManagerView> },
+	{ "Notepad",				ui::Color::grey(),		&bitmap_icon_notepad,	menu_push<NotImplementedView> },
+	{ "Signal generator", 		ui::Color::green(), 	&bitmap_icon_cwgen,		menu_push<SigGenView> },
+	//{ "Tone search", 			ui::Color::grey(), 		nullptr,				menu_push<ToneSearchView> },
+	{ "Wave file viewer", 		ui::Color::blue(),		nullptr,				menu_push<ViewWavView> },
+	{ "Whip antenna length",	ui::Color::yellow(),	nullptr,				menu_push<WhipCalcView> },
+	{ "Wipe SD card",			ui::Color::red(),		nullptr,				menu_push<WipeSDView> },
+};
+
 UtilitiesMenuView::UtilitiesMenuView(NavigationView& nav) {
-	add_items({
-		//{ "Test app", 				ui::Color::grey(), 		nullptr,				[&nav](){ nav.push<TestView>(); } },
-		{ "Frequency manager", 		ui::Color::green(), 	&bitmap_icon_freqman,	[&nav](){ nav.push<FrequencyManagerView>(); } },
-		{ "File manager", 			ui::Color::yellow(),	&bitmap_icon_file,		[&nav](){ nav.push<FileManagerView>(); } },
-		{ "Notepad",				ui::Color::grey(),		&bitmap_icon_notepad,	[&nav](){ nav.push<NotImplementedView>(); } },
-		{ "Signal generator", 		ui::Color::green(), 	&bitmap_icon_cwgen,		[&nav](){ nav.push<SigGenView>(); } },
-		//{ "Tone search", 			ui::Color::grey(), 		nullptr,				[&nav](){ nav.push<ToneSearchView>(); } },
-		{ "Wave file viewer", 		ui::Color::blue(),		nullptr,				[&nav](){ nav.push<ViewWavView>(); } },
-		{ "Whip antenna length",	ui::Color::yellow(),	nullptr,				[&nav](){ nav.push<WhipCalcView>(); } },
-		{ "Wipe SD card",			ui::Color::red(),		nullptr,				[&nav](){ nav.push<WipeSDView>(); } },
-	});
+	set_entries(utilities_menu, nav);
 	on_left = [&nav](){ nav.pop(); };
 }
 
 /* SystemMenuView ********************************************************/
 
-void SystemMenuView::hackrf_mode(NavigationView& nav) {
+static void hackrf_mode(NavigationView& nav) {
 	nav.push<ModalMessageView>("Confirm", "Switch to HackRF mode ?", YESNO,
-		[this](bool choice) {
+		[](bool choice) {
 			if (choice) {
 				EventDispatcher::request_stop();
 			}
@@ -414,25 +464,78 @@ void SystemMenuView::hackrf_mode(NavigationView& nav) {
 	);
 }
 
+static constexpr MenuEntry system_menu[] {
+	{ "Play dead",				ui::Color::red(),		&bitmap_icon_playdead,	menu_push<PlayDeadView> },
+	{ "Receivers", 				ui::Color::cyan(),		&bitmap_icon_receivers,	menu_push<ReceiversMenuView> },
+	{ "Transmitters", 			ui::Color::green(),		&bitmap_icon_transmit,	menu_push<TransmittersMenuView> },
+	{ "Capture",				ui::Color::blue(),		&bitmap_icon_capture,	menu_push<CaptureAppView> },
+	{ "Replay",					ui::Color::purple(),	&bitmap_icon_replay,	menu_push<ReplayAppView> },
+	{ "Search/Close call",		ui::Color::yellow(),	&bitmap_icon_closecall,	menu_push<SearchView> },
+	{ "Scanner",				ui::Color::grey(),		&bitmap_icon_scanner,	menu_push<ScannerView> },
+	{ "Utilities",				ui::Color::light_grey(),	&bitmap_icon_utilities,	menu_push<UtilitiesMenuView> },
+	{ "Settings", 				ui::Color::white(),		&bitmap_icon_setup,		menu_push<SettingsMenuView> },
+	{ "Debug", 					ui::Color::white(),		nullptr,				menu_push<DebugMenuView> },
+	{ "HackRF mode", 			ui::Color::white(),		&bitmap_icon_hackrf,	hackrf_mode },
+	{ "About", 					ui::Color::white(),		nullptr,				menu_push<AboutView> },
+};
+
 SystemMenuView::SystemMenuView(NavigationView& nav) {
-	add_items({
-		{ "Play dead",				ui::Color::red(),		&bitmap_icon_playdead,	[&nav](){ nav.push<PlayDeadView>(); } },
-		{ "Receivers", 				ui::Color::cyan(),		&bitmap_icon_receivers,	[&nav](){ nav.push<ReceiversMenuView>(); } },
-		{ "Transmitters", 			ui::Color::green(),		&bitmap_icon_transmit,	[&nav](){ nav.push<TransmittersMenuView>(); } },
-		{ "Capture",				ui::Color::blue(),		&bitmap_icon_capture,	[&nav](){ nav.push<CaptureAppView>(); } },
-		{ "Replay",					ui::Color::purple(),	&bitmap_icon_replay,	[&nav](){ nav.push<ReplayAppView>(); } },
-		{ "Search/Close call",		ui::Color::yellow(),	&bitmap_icon_closecall,	[&nav](){ nav.push<SearchView>(); } },
-		{ "Scanner",				ui::Color::grey(),		&bitmap_icon_scanner,	[&nav](){ nav.push<ScannerView>(); } },
-		{ "Utilities",				ui::Color::light_grey(),	&bitmap_icon_utilities,	[&nav](){ nav.push<UtilitiesMenuView>(); } },
-		{ "Settings", 				ui::Color::white(),		&bitmap_icon_setup,		[&nav](){ nav.push<SettingsMenuView>(); } },
-		//{ "Debug", 					ui::Color::white(), nullptr,   				[&nav](){ nav.push<DebugMenuView>(); } },
-		{ "HackRF mode", 			ui::Color::white(),		&bitmap_icon_hackrf,	[this, &nav](){ hackrf_mode(nav); } },
-		{ "About", 					ui::Color::white(),		nullptr,				[&nav](){ nav.push<AboutView>(); } }
-	});
+	set_entries(system_menu, nav);
 	
 	set_highlighted(1);		// Startup selection is "Receivers"
 }
 
+/* launch_app ************************************************************/
+
+/* Label up to any ':', lower case, without the padding. */
+static std::string menu_name(const char* const text) {
+	std::string name { text };
+	name = name.substr(0, name.find(':'));
+	name.erase(name.find_last_not_of(' ') + 1);
+	std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+	return name;
+}
+
+template<size_t N>
+static const MenuEntry* find_entry(const MenuEntry (&menu)[N], const std::string& name) {
+	for(const auto& entry : menu) {
+		if( menu_name(entry.text) == name ) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+template<class SubmenuView, size_t N>
+static bool launch_from(NavigationView& nav, const MenuEntry (&menu)[N], const std::string& name) {
+	const auto entry = find_entry(menu, name);
+	if( entry ) {
+		// As if picked by hand: receivers replace their menu, others stack on it.
+		nav.push<SubmenuView>();
+		entry->on_select(nav);
+	}
+	return entry != nullptr;
+}
+
+bool launch_app(NavigationView& nav, const std::string& name) {
+	auto key = name;
+	std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+
+	while( !nav.is_top() ) {
+		nav.pop();
+	}
+
+	const auto entry = find_entry(system_menu, key);
+	if( entry ) {
+		entry->on_select(nav);
+		return true;
+	}
+
+	return launch_from<ReceiversMenuView>(nav, receivers_menu, key)
+	    || launch_from<TransmittersMenuView>(nav, transmitters_menu, key)
+	    || launch_from<UtilitiesMenuView>(nav, utilities_menu, key);
+}
+
 /* SystemView ************************************************************/
 
 static constexpr ui::Style style_default {
@@ -468,6 +571,7 @@ SystemView::SystemView(
 	navigation_view.on_view_changed = [this](const View& new_view) {
 		this->status_view.set_back_enabled(!this->navigation_view.is_top());
 		this->status_view.set_title(new_view.title());
+		this->remote_control.set_app_title(new_view.title());
 	};
 
 	// portapack::persistent_memory::set_playdead_sequence(0x8D1);
@@ -38,9 +38,14 @@
 #include "diskio.h"
 #include "lfsr_random.hpp"
 #include "sd_card.hpp"
+#include "screenshot_thread.hpp"
+#include "chibios_cpp.hpp"
+#include "remote_control.hpp"
 
 #include <vector>
 #include <utility>
+#include <memory>
+#include <string>
 
 using namespace sd_card;
 
@@ -66,14 +71,28 @@ public:
 
 	bool is_top() const;
 
+	/* The view and whatever its constructor allocates (labels, callbacks,
+	 * menu items) go into an arena released with the view, so switching
+	 * apps doesn't leave the heap fragmented.
+	 */
 	template<class T, class... Args>
 	T* push(Args&&... args) {
-		return reinterpret_cast<T*>(push_view(std::unique_ptr<View>(new T(*this, std::forward<Args>(args)...))));
+		// A view pushed from another view's constructor mustn't end up in
+		// that view's arena, nor must the stack.
+		chibios::Arena::Scope heap_scope { nullptr };
+
+		auto arena = std::make_unique<chibios::Arena>(sizeof(T) + arena_slack);
+		std::unique_ptr<View> new_view;
+		{
+			chibios::Arena::Scope arena_scope { arena.get() };
+			new_view.reset(new T(*this, std::forward<Args>(args)...));
+		}
+		return reinterpret_cast<T*>(push_view(std::move(new_view), std::move(arena)));
 	}
 	template<class T, class... Args>
 	T* replace(Args&&... args) {
 		pop();
-		return reinterpret_cast<T*>(push_view(std::unique_ptr<View>(new T(*this, std::forward<Args>(args)...))));
+		return push<T>(std::forward<Args>(args)...);
 	}
 	
 	void push(View* v);
@@ -88,16 +107,35 @@ public:
 	void focus() override;
 
 private:
-	std::vector<std::unique_ptr<View>> view_stack { };
+	static constexpr size_t arena_slack = 1024;
+
+	struct StackedView {
+		// Declared first so it outlives the view.
+		std::unique_ptr<chibios::Arena> arena;
+		std::unique_ptr<View> view;
+	};
+
+	std::vector<StackedView> view_stack { };
 	Widget* modal_view { nullptr };
 
 	Widget* view() const;
 
 	void free_view();
 	void update_view();
-	View* push_view(std::unique_ptr<View> new_view);
+	View* push_view(std::unique_ptr<View> new_view, std::unique_ptr<chibios::Arena> arena);
 };
 
+/* MenuEntry::on_select targets. */
+template<class T>
+void menu_push(NavigationView& nav) {
+	nav.push<T>();
+}
+
+template<class T>
+void menu_replace(NavigationView& nav) {
+	nav.replace<T>();
+}
+
 class SystemStatusView : public View {
 public:
 	std::function<void(void)> on_back { };
@@ -175,11 +213,14 @@ private:
 		{ 28 * 8, 0 * 16,  2 * 8, 1 * 16 }
 	};
 
+	std::unique_ptr<ScreenshotThread> screenshot { };
+
 	void on_stealth();
 	void on_bias_tee();
 	//void on_textentry();
 	void on_camera();
 	void refresh();
+	void on_load_shedding(const LoadSheddingMessage& message);
 	
 	MessageHandlerRegistration message_handler_refresh {
 		Message::ID::StatusRefresh,
@@ -188,6 +229,13 @@ private:
 			this->refresh();
 		}
 	};
+
+	MessageHandlerRegistration message_handler_load_shedding {
+		Message::ID::LoadShedding,
+		[this](const Message* const p) {
+			this->on_load_shedding(*static_cast<const LoadSheddingMessage*>(p));
+		}
+	};
 };
 
 class BMPView : public View {
@@ -229,10 +277,14 @@ public:
 class SystemMenuView : public MenuView {
 public:
 	SystemMenuView(NavigationView& nav);
-private:
-	void hackrf_mode(NavigationView& nav);
 };
 
+/* Opens the app with menu label name (up to any ':', ignoring case) from
+ * the system menu or its Receivers, Transmitters or Utilities submenus,
+ * on top of the system menu. False if there's none.
+ */
+bool launch_app(NavigationView& nav, const std::string& name);
+
 class SystemView : public View {
 public:
 	SystemView(
@@ -245,6 +297,7 @@ public:
 private:
 	SystemStatusView status_view { navigation_view };
 	NavigationView navigation_view { };
+	RemoteControl remote_control { navigation_view, *this };
 	Context& context_;
 };
 
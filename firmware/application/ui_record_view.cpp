@@ -22,20 +22,57 @@
 #include "ui_record_view.hpp"
 
 #include "portapack.hpp"
+#include "portapack_persistent_memory.hpp"
 using namespace portapack;
 
 #include "io_file.hpp"
+#include "io_usb.hpp"
 #include "io_wave.hpp"
+#include "usb_stream.hpp"
+#include "remote_control.hpp"
 
 #include "baseband_api.hpp"
 #include "rtc_time.hpp"
 #include "string_format.hpp"
 #include "utility.hpp"
+#include "complex.hpp"
 
 #include <cstdint>
+#include <array>
 
 namespace ui {
 
+static std::string to_string_iso8601(const rtc::RTC& value) {
+	return to_string_dec_uint(value.year(), 4, '0') + "-" +
+		to_string_dec_uint(value.month(), 2, '0') + "-" +
+		to_string_dec_uint(value.day(), 2, '0') + "T" +
+		to_string_dec_uint(value.hour(), 2, '0') + ":" +
+		to_string_dec_uint(value.minute(), 2, '0') + ":" +
+		to_string_dec_uint(value.second(), 2, '0');
+}
+
+static std::string capture_format_name(const CaptureConfig::Format format) {
+	switch(format) {
+	case CaptureConfig::Format::C8:
+		return "C8";
+	case CaptureConfig::Format::C16Rice:
+		return "RIQ";
+	default:
+		return "C16";
+	}
+}
+
+static const char16_t* capture_format_extension(const CaptureConfig::Format format) {
+	switch(format) {
+	case CaptureConfig::Format::C8:
+		return u".C8";
+	case CaptureConfig::Format::C16Rice:
+		return u".RIQ";
+	default:
+		return u".C16";
+	}
+}
+
 /*void RecordView::toggle_pitch_rssi() {
 	pitch_rssi_enabled = !pitch_rssi_enabled;
 	
@@ -69,6 +106,8 @@ RecordView::RecordView(
 		&rect_background,
 		//&button_pitch_rssi,
 		&button_record,
+		&text_record_format,
+		&options_squelch_gate,
 		&text_record_filename,
 		&text_record_dropped,
 		&text_time_available,
@@ -84,13 +123,33 @@ RecordView::RecordView(
 		this->toggle();
 	};
 
+	options_squelch_gate.hidden(file_type != FileType::WAV);
+	options_squelch_gate.set_selected_index(0);
+	options_squelch_gate.on_change = [this](size_t, OptionsField::value_t v) {
+		// Takes effect at the next start.
+		this->squelch_gate = (v != 0);
+	};
+
 	signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
 		this->on_tick_second();
 	};
+
+	signal_token_record = RemoteControl::signal_record += [this](const bool record) {
+		if( record ) {
+			this->start();
+		} else {
+			this->stop();
+		}
+	};
 }
 
 RecordView::~RecordView() {
+	RemoteControl::signal_record -= signal_token_record;
 	rtc_time::signal_tick_second -= signal_token_tick_second;
+	if( destination == Destination::USB ) {
+		capture_thread.reset();
+		usb_stream::stop();
+	}
 }
 
 void RecordView::focus() {
@@ -105,6 +164,8 @@ void RecordView::set_sampling_rate(const size_t new_sampling_rate) {
 		baseband::set_sample_rate(sampling_rate);
 
 		button_record.hidden(sampling_rate == 0);
+		text_record_format.hidden((sampling_rate == 0) || (file_type != FileType::RawS16));
+		options_squelch_gate.hidden((sampling_rate == 0) || (file_type != FileType::WAV));
 		text_record_filename.hidden(sampling_rate == 0);
 		text_record_dropped.hidden(sampling_rate == 0);
 		text_time_available.hidden(sampling_rate == 0);
@@ -114,6 +175,52 @@ void RecordView::set_sampling_rate(const size_t new_sampling_rate) {
 	}
 }
 
+void RecordView::set_trigger(const CaptureConfig::Trigger new_trigger) {
+	trigger = new_trigger;
+}
+
+void RecordView::set_destination(const Destination new_destination) {
+	if( new_destination == destination ) {
+		return;
+	}
+	stop();
+
+	destination = new_destination;
+	if( destination == Destination::USB ) {
+		usb_stream::start();
+	} else {
+		usb_stream::stop();
+	}
+	update_status_display();
+}
+
+void RecordView::set_capture_format(const size_t new_decimation, const CaptureConfig::Format new_format) {
+	if( (new_decimation != decimation) || (new_format != capture_format) ) {
+		stop();
+
+		decimation = new_decimation;
+		capture_format = new_format;
+	}
+
+	text_record_format.set(
+		capture_format_name(capture_format) + "/" + to_string_dec_uint(decimation)
+	);
+	update_status_display();
+}
+
+size_t RecordView::bytes_per_sample() const {
+	// Compressed captures are at most C16 sized, so that's what time left
+	// is estimated from.
+	return (capture_format == CaptureConfig::Format::C8) ? sizeof(complex8_t) : sizeof(complex16_t);
+}
+
+rf::Frequency RecordView::center_frequency() const {
+	// Raw samples skip the fs/4 translation, so they're centred on the LO,
+	// which the capture app tunes fs/4 below the target frequency.
+	const rf::Frequency f = receiver_model.tuning_frequency();
+	return (decimation == 1) ? (f - sampling_rate / 4) : f;
+}
+
 bool RecordView::is_active() const {
 	return (bool)capture_thread;
 }
@@ -136,57 +243,111 @@ void RecordView::start() {
 		return;
 	}
 
-	auto base_path = next_filename_stem_matching_pattern(filename_stem_pattern);
-	if( base_path.empty() ) {
-		return;
-	}
-
 	std::unique_ptr<stream::Writer> writer;
-	switch(file_type) {
-	case FileType::WAV:
-		{
-			auto p = std::make_unique<WAVFileWriter>();
-			auto create_error = p->create(
-				base_path.replace_extension(u".WAV"),
-				sampling_rate,
-				to_string_dec_uint(receiver_model.tuning_frequency()) + "Hz"
-			);
-			if( create_error.is_valid() ) {
-				handle_error(create_error.value());
-			} else {
-				writer = std::move(p);
-			}
+	std::filesystem::path base_path;
+	if( destination == Destination::USB ) {
+		if( usb_stream::is_configured() ) {
+			writer = std::make_unique<USBStreamWriter>();
+		} else {
+			handle_error(File::Error { FR_USB_DISCONNECTED });
+		}
+	} else {
+		base_path = next_filename_stem_matching_pattern(filename_stem_pattern);
+		if( base_path.empty() ) {
+			return;
 		}
-		break;
-
-	case FileType::RawS16:
-		{
-			const auto metadata_file_error = write_metadata_file(base_path.replace_extension(u".TXT"));
-			if( metadata_file_error.is_valid() ) {
-				handle_error(metadata_file_error.value());
-				return;
-			}
 
-			auto p = std::make_unique<RawFileWriter>();
-			auto create_error = p->create(base_path.replace_extension(u".C16"));
-			if( create_error.is_valid() ) {
-				handle_error(create_error.value());
-			} else {
-				writer = std::move(p);
+		switch(file_type) {
+		case FileType::WAV:
+			{
+				auto p = std::make_unique<WAVFileWriter>();
+				auto create_error = p->create(
+					base_path.replace_extension(u".WAV"),
+					sampling_rate,
+					to_string_dec_uint(receiver_model.tuning_frequency()) + "Hz"
+				);
+				if( create_error.is_valid() ) {
+					handle_error(create_error.value());
+				} else {
+					writer = std::move(p);
+				}
 			}
-		}
-		break;
+			break;
+
+		case FileType::RawS16:
+			{
+				const uint64_t segment_seconds = persistent_memory::config_capture_segment();
+				const uint64_t segment_size = std::min(
+					segment_seconds * (sampling_rate / decimation) * bytes_per_sample(),
+					segment_size_max
+				);
+
+				Optional<File::Error> create_error;
+				if( segment_size ) {
+					// Segments write their own .TXT sidecars.
+					auto p = std::make_unique<SegmentedFileWriter>(
+						base_path.replace_extension(capture_format_extension(capture_format)),
+						segment_size,
+						metadata_lines()
+					);
+					create_error = p->create();
+					if( !create_error.is_valid() ) {
+						writer = std::move(p);
+					}
+				} else {
+					const auto metadata_file_error = write_metadata_file(base_path.replace_extension(u".TXT"));
+					if( metadata_file_error.is_valid() ) {
+						handle_error(metadata_file_error.value());
+						return;
+					}
+
+					// Reserve up to 1GiB contiguous; larger runs take too long to find.
+					const auto space_info = std::filesystem::space(u"");
+					const File::Size capacity = std::min<File::Size>(space_info.free, capacity_contiguous_max);
+
+					auto p = std::make_unique<ContiguousFileWriter>();
+					create_error = p->create(base_path.replace_extension(capture_format_extension(capture_format)), capacity);
+					if( !create_error.is_valid() ) {
+						writer = std::move(p);
+					}
+				}
+
+				if( create_error.is_valid() ) {
+					handle_error(create_error.value());
+				} else {
+
+					if( trigger.level_db ) {
+						const auto index_error = start_burst_index(base_path.replace_extension(u".IDX"));
+						if( index_error.is_valid() ) {
+							handle_error(index_error.value());
+						}
+					}
+
+					// SigMF has no datatype for compressed samples, and their
+					// byte offsets don't map to sample offsets anyway.
+					if( capture_format != CaptureConfig::Format::C16Rice ) {
+						const auto annotations_error = start_annotations(base_path.replace_extension(u".META"));
+						if( annotations_error.is_valid() ) {
+							handle_error(annotations_error.value());
+						}
+					}
+				}
+			}
+			break;
 
-	default:
-		break;
-	};
+		default:
+			break;
+		}
+	}
 
 	if( writer ) {
-		text_record_filename.set(base_path.replace_extension().string());
+		capture_base_path = base_path.replace_extension();
+		text_record_filename.set((destination == Destination::USB) ? "USB" : capture_base_path.string());
 		button_record.set_bitmap(&bitmap_stop);
 		capture_thread = std::make_unique<CaptureThread>(
 			std::move(writer),
 			write_size, buffer_count,
+			decimation, capture_format,
 			[]() {
 				CaptureThreadDoneMessage message { };
 				EventDispatcher::send_message(message);
@@ -194,7 +355,9 @@ void RecordView::start() {
 			[](File::Error error) {
 				CaptureThreadDoneMessage message { error.code() };
 				EventDispatcher::send_message(message);
-			}
+			},
+			(file_type == FileType::RawS16) ? trigger : CaptureConfig::Trigger { 0, 0, 0 },
+			squelch_gate
 		);
 	}
 
@@ -203,40 +366,208 @@ void RecordView::start() {
 
 void RecordView::stop() {
 	if( is_active() ) {
+		// Keep a copy, the thread owns the config the baseband was filling in.
+		const CaptureConfig final_state = capture_thread->state();
 		capture_thread.reset();
 		button_record.set_bitmap(&bitmap_record);
+
+		burst_index.reset();
+
+		if( metadata_writer ) {
+			const auto flush_error = metadata_writer->flush();
+			metadata_writer.reset();
+			if( flush_error.is_valid() ) {
+				handle_error(flush_error.value());
+			}
+		}
+
+		if( destination == Destination::SD ) {
+			auto statistics_path = capture_base_path;
+			const auto statistics_file_error = write_statistics_file(statistics_path.replace_extension(u".STA"), final_state);
+			if( statistics_file_error.is_valid() ) {
+				handle_error(statistics_file_error.value());
+			}
+		}
 	}
 
 	update_status_display();
 }
 
+std::vector<std::string> RecordView::metadata_lines() const {
+	return {
+		"sample_rate=" + to_string_dec_uint(sampling_rate / decimation),
+		"center_frequency=" + to_string_dec_uint(center_frequency()),
+		"format=" + capture_format_name(capture_format),
+	};
+}
+
 Optional<File::Error> RecordView::write_metadata_file(const std::filesystem::path& filename) {
 	File file;
 	const auto create_error = file.create(filename);
 	if( create_error.is_valid() ) {
 		return create_error;
-	} else {
-		const auto error_line1 = file.write_line("sample_rate=" + to_string_dec_uint(sampling_rate / 8));
-		if( error_line1.is_valid() ) {
-			return error_line1;
+	}
+
+	for(const auto& line : metadata_lines()) {
+		const auto error_line = file.write_line(line);
+		if( error_line.is_valid() ) {
+			return error_line;
 		}
-		const auto error_line2 = file.write_line("center_frequency=" + to_string_dec_uint(receiver_model.tuning_frequency()));
-		if( error_line2.is_valid() ) {
-			return error_line2;
+	}
+	return { };
+}
+
+Optional<File::Error> RecordView::write_statistics_file(const std::filesystem::path& filename, const CaptureConfig& state) {
+	File file;
+	const auto create_error = file.create(filename);
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+
+	const auto& statistics = state.statistics;
+	std::array<std::string, 6 + StreamStatistics::latency_bins> lines { {
+		"bytes_received=" + to_string_dec_uint64(state.baseband_bytes_received),
+		"bytes_dropped=" + to_string_dec_uint64(state.baseband_bytes_dropped),
+		"buffers_dropped=" + to_string_dec_uint(statistics.buffers_dropped),
+		"fifo_high_water=" + to_string_dec_uint(statistics.fifo_high_water),
+		"fifo_buffers=" + to_string_dec_uint(state.buffer_count),
+		"write_latency_max_ms=" + to_string_dec_uint(statistics.latency_max_ms),
+	} };
+	for(size_t i=0; i<StreamStatistics::latency_bins; i++) {
+		const auto limit = StreamStatistics::latency_bin_limit_ms(i);
+		const std::string bin_name = (i < StreamStatistics::latency_bins - 1) ?
+			("write_latency_lt_" + to_string_dec_uint(limit) + "ms=") :
+			("write_latency_ge_" + to_string_dec_uint(limit >> 1) + "ms=");
+		lines[6 + i] = bin_name + to_string_dec_uint(statistics.latency_histogram[i]);
+	}
+
+	for(const auto& line : lines) {
+		const auto error_line = file.write_line(line);
+		if( error_line.is_valid() ) {
+			return error_line;
 		}
-		return { };
+	}
+	return { };
+}
+
+Optional<File::Error> RecordView::start_burst_index(const std::filesystem::path& filename) {
+	auto p = std::make_unique<File>();
+	const auto create_error = p->create(filename);
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+	const auto write_error = p->write_line("offset,length,datetime");
+	if( write_error.is_valid() ) {
+		return write_error;
+	}
+	burst_index = std::move(p);
+	return { };
+}
+
+void RecordView::handle_capture_burst(const uint64_t offset, const uint64_t length) {
+	if( !burst_index ) {
+		return;
+	}
+
+	// Stamped on arrival, so up to a post-trigger time after the burst.
+	rtc::RTC datetime;
+	rtcGetTime(&RTCD1, &datetime);
+	const auto write_error = burst_index->write_line(
+		to_string_dec_uint64(offset) + "," + to_string_dec_uint64(length) + "," + to_string_iso8601(datetime)
+	);
+	if( write_error.is_valid() ) {
+		burst_index.reset();
+		handle_error(write_error.value());
+	}
+}
+
+Optional<File::Error> RecordView::start_annotations(const std::filesystem::path& filename) {
+	auto p = std::make_unique<MetadataFileWriter>();
+	const auto create_error = p->create(filename,
+		std::string("\"core:datatype\":\"") + ((capture_format == CaptureConfig::Format::C8) ? "ci8" : "ci16_le") + "\","
+		"\"core:sample_rate\":" + to_string_dec_uint(sampling_rate / decimation) + ","
+		"\"core:version\":\"0.0.2\""
+	);
+	if( create_error.is_valid() ) {
+		return create_error;
+	}
+	metadata_writer = std::move(p);
+
+	// Force the first update to record every field at sample 0.
+	annotated_frequency = 0;
+	annotated_lna = -1;
+	annotated_vga = -1;
+	annotated_rf_amp = !receiver_model.rf_amp();
+	annotated_bytes_dropped = 0;
+	return { };
+}
+
+void RecordView::update_annotations() {
+	if( !metadata_writer || !capture_thread ) {
+		return;
+	}
+
+	// Polled once a second, retune and gain records are placed at the first
+	// buffer boundary after the change.
+	const auto& state = capture_thread->state();
+	const uint64_t sample_start = (state.baseband_bytes_received - state.baseband_bytes_dropped) / bytes_per_sample();
+
+	rtc::RTC datetime;
+	rtcGetTime(&RTCD1, &datetime);
+	std::string fields = "\"core:datetime\":\"" + to_string_iso8601(datetime) + "\"";
+
+	const auto frequency = center_frequency();
+	if( frequency != annotated_frequency ) {
+		annotated_frequency = frequency;
+		fields += ",\"core:frequency\":" + to_string_dec_uint64(frequency);
+	}
+
+	const auto lna = receiver_model.lna();
+	const auto vga = receiver_model.vga();
+	const auto rf_amp = receiver_model.rf_amp();
+	if( (lna != annotated_lna) || (vga != annotated_vga) || (rf_amp != annotated_rf_amp) ) {
+		annotated_lna = lna;
+		annotated_vga = vga;
+		annotated_rf_amp = rf_amp;
+		fields += ",\"portapack:lna_db\":" + to_string_dec_int(lna) +
+			",\"portapack:vga_db\":" + to_string_dec_int(vga) +
+			",\"portapack:rf_amp\":" + (rf_amp ? "true" : "false");
+	}
+
+	if( state.baseband_bytes_dropped != annotated_bytes_dropped ) {
+		const auto dropped_samples = (state.baseband_bytes_dropped - annotated_bytes_dropped) / bytes_per_sample();
+		annotated_bytes_dropped = state.baseband_bytes_dropped;
+		fields += ",\"portapack:dropped_samples\":" + to_string_dec_uint64(dropped_samples);
+	}
+
+	const auto append_error = metadata_writer->append(sample_start, fields);
+	if( append_error.is_valid() ) {
+		metadata_writer.reset();
+		handle_error(append_error.value());
 	}
 }
 
 void RecordView::on_tick_second() {
+	update_annotations();
+	show_statistics = !show_statistics;
 	update_status_display();
 }
 
 void RecordView::update_status_display() {
 	if( is_active() ) {
-		const auto dropped_percent = std::min(99U, capture_thread->state().dropped_percent());
+		const auto& state = capture_thread->state();
+		const auto dropped_percent = std::min(99U, state.dropped_percent());
 		const auto s = to_string_dec_uint(dropped_percent, 2, ' ') + "\%";
 		text_record_dropped.set(s);
+
+		if( show_statistics ) {
+			// Alternate with time available: FIFO high water and worst SD write
+			text_time_available.set(
+				"Q" + to_string_dec_uint(std::min<uint32_t>(9, state.statistics.fifo_high_water), 1) +
+				to_string_dec_uint(std::min<uint32_t>(99999, state.statistics.latency_max_ms), 5, ' ') + "ms"
+			);
+			return;
+		}
 	}
 	
 	/*if (pitch_rssi_enabled) {
@@ -244,8 +575,14 @@ void RecordView::update_status_display() {
 	}*/
 
 	if( sampling_rate ) {
+		const uint32_t bytes_per_second = file_type == FileType::WAV ? (sampling_rate * 2) : (sampling_rate / decimation * bytes_per_sample());
+		if( destination == Destination::USB ) {
+			// No end to a stream, show its rate instead.
+			text_time_available.set(to_string_dec_uint(bytes_per_second / 1000, 5, ' ') + "kB/s");
+			return;
+		}
+
 		const auto space_info = std::filesystem::space(u"");
-		const uint32_t bytes_per_second = file_type == FileType::WAV ? (sampling_rate * 2) : (sampling_rate / 8 * 4);
 		const uint32_t available_seconds = space_info.free / bytes_per_second;
 		const uint32_t seconds = available_seconds % 60;
 		const uint32_t available_minutes = available_seconds / 60;
@@ -25,6 +25,7 @@
 #include "ui_widget.hpp"
 
 #include "capture_thread.hpp"
+#include "io_file.hpp"
 #include "signal.hpp"
 
 #include "bitmap.hpp"
@@ -32,6 +33,7 @@
 #include <cstddef>
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace ui {
 
@@ -44,6 +46,11 @@ public:
 		WAV = 3,
 	};
 
+	enum class Destination {
+		SD,
+		USB,
+	};
+
 	RecordView(
 		const Rect parent_rect,
 		std::filesystem::path filename_stem_pattern,
@@ -56,6 +63,15 @@ public:
 	void focus() override;
 
 	void set_sampling_rate(const size_t new_sampling_rate);
+	void set_capture_format(const size_t new_decimation, const CaptureConfig::Format new_format);
+	/* Burst mode for RawS16 captures, see CaptureConfig::Trigger. Takes
+	 * effect at the next start.
+	 */
+	void set_trigger(const CaptureConfig::Trigger new_trigger);
+	/* USB streams captures to a host instead of files, see usb_stream.hpp.
+	 * The device is on the bus for as long as USB is selected.
+	 */
+	void set_destination(const Destination new_destination);
 
 	void start();
 	void stop();
@@ -65,21 +81,54 @@ public:
 private:
 	void toggle();
 	//void toggle_pitch_rssi();
+	std::vector<std::string> metadata_lines() const;
 	Optional<File::Error> write_metadata_file(const std::filesystem::path& filename);
+	Optional<File::Error> write_statistics_file(const std::filesystem::path& filename, const CaptureConfig& state);
+	Optional<File::Error> start_annotations(const std::filesystem::path& filename);
+	Optional<File::Error> start_burst_index(const std::filesystem::path& filename);
+	void update_annotations();
+
+	size_t bytes_per_sample() const;
+	rf::Frequency center_frequency() const;
 
 	void on_tick_second();
 	void update_status_display();
 
 	void handle_capture_thread_done(const File::Error error);
+	void handle_capture_burst(const uint64_t offset, const uint64_t length);
 	void handle_error(const File::Error error);
 
 	//bool pitch_rssi_enabled = false;
+	static constexpr uint64_t capacity_contiguous_max = 1024ULL * 1024 * 1024;
+	/* Split captures' segments hold the setting's time at the full capture
+	 * rate, up to a contiguous reservation. Compressed and burst captures
+	 * fill them more slowly.
+	 */
+	static constexpr uint64_t segment_size_max = capacity_contiguous_max;
+
 	const std::filesystem::path filename_stem_pattern;
 	const FileType file_type;
 	const size_t write_size;
 	const size_t buffer_count;
 	size_t sampling_rate { 0 };
+	size_t decimation { 8 };
+	CaptureConfig::Format capture_format { CaptureConfig::Format::C16 };
+	CaptureConfig::Trigger trigger { 0, 0, 0 };
+	bool squelch_gate { true };
+	Destination destination { Destination::SD };
+	/* Burst mode: one "offset,length,datetime" line per burst. */
+	std::unique_ptr<File> burst_index { };
 	SignalToken signal_token_tick_second { };
+	SignalToken signal_token_record { };
+	std::filesystem::path capture_base_path { };
+	bool show_statistics { false };
+
+	std::unique_ptr<MetadataFileWriter> metadata_writer { };
+	rf::Frequency annotated_frequency { 0 };
+	int32_t annotated_lna { 0 };
+	int32_t annotated_vga { 0 };
+	bool annotated_rf_amp { false };
+	uint64_t annotated_bytes_dropped { 0 };
 
 	Rectangle rect_background {
 		Color::black()
@@ -100,6 +149,21 @@ private:
 		Color::black()
 	};
 
+	Text text_record_format {
+		{ 2 * 8, 0 * 16, 4 * 8, 16 },
+		"",
+	};
+
+	// WAV: record only while the squelch is open, or everything.
+	OptionsField options_squelch_gate {
+		{ 2 * 8, 0 * 16 },
+		4,
+		{
+			{ "Sql ", 1 },
+			{ "All ", 0 },
+		}
+	};
+
 	Text text_record_filename {
 		{ 7 * 8, 0 * 16, 8 * 8, 16 },
 		"",
@@ -124,6 +188,14 @@ private:
 			this->handle_capture_thread_done(message.error);
 		}
 	};
+
+	MessageHandlerRegistration message_handler_capture_burst {
+		Message::ID::CaptureBurst,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const CaptureBurstMessage*>(p);
+			this->handle_capture_burst(message.offset, message.length);
+		}
+	};
 };
 
 } /* namespace ui */
@@ -25,6 +25,8 @@
 
 #include "file.hpp"
 #include "lfsr_random.hpp"
+#include "portapack.hpp"
+#include "portapack_persistent_memory.hpp"
 
 #include "ff.h"
 #include "diskio.h"
@@ -89,6 +91,7 @@ private:
 	Stats _stats { };
 
 	static msg_t static_fn(void* arg) {
+		chRegSetThreadName("sdtest");
 		auto obj = static_cast<SDCardTestThread*>(arg);
 		obj->_result = obj->run();
 		return 0;
@@ -227,6 +230,110 @@ private:
 
 Thread* SDCardTestThread::thread { nullptr };
 
+class SDCardLiveThread {
+public:
+	SDCardLiveThread(
+	) {
+		thread = chThdCreateFromHeap(NULL, 3072, NORMALPRIO + 10, SDCardLiveThread::static_fn, this);
+	}
+
+	~SDCardLiveThread() {
+		chThdTerminate(thread);
+		chThdWait(thread);
+	}
+
+	SDCardLiveThread(const SDCardLiveThread&) = delete;
+	SDCardLiveThread(SDCardLiveThread&&) = delete;
+	SDCardLiveThread& operator=(const SDCardLiveThread&) = delete;
+	SDCardLiveThread& operator=(SDCardLiveThread&&) = delete;
+
+	/* Wraps, take differences. */
+	uint32_t bytes_written() const {
+		return _bytes_written;
+	}
+
+	/* Longest write since the last call, in counter ticks. */
+	halrtcnt_t take_write_duration_max() {
+		chSysLock();
+		const halrtcnt_t value = _write_duration_max;
+		_write_duration_max = 0;
+		chSysUnlock();
+		return value;
+	}
+
+	bool failed() const {
+		return _failed;
+	}
+
+private:
+	static constexpr File::Size write_size = 16384;
+	static constexpr File::Size file_size = 4 * 1024 * 1024;
+
+	Thread* thread { nullptr };
+	volatile uint32_t _bytes_written { 0 };
+	volatile halrtcnt_t _write_duration_max { 0 };
+	volatile bool _failed { false };
+
+	static msg_t static_fn(void* arg) {
+		chRegSetThreadName("sdlive");
+		auto obj = static_cast<SDCardLiveThread*>(arg);
+		obj->_failed = !obj->run();
+		return 0;
+	}
+
+	bool run() {
+		const std::filesystem::path filename { u"_PPLIVE_.DAT" };
+
+		const auto buffer = std::make_unique<std::array<uint8_t, write_size>>();
+		if( !buffer ) {
+			return false;
+		}
+
+		lfsr_word_t v = 1;
+		lfsr_fill(v,
+			reinterpret_cast<lfsr_word_t*>(buffer->data()),
+			sizeof(*buffer.get()) / sizeof(lfsr_word_t)
+		);
+
+		bool ok = true;
+		{
+			File file;
+			if( file.create(filename).is_valid() ) {
+				return false;
+			}
+
+			// Overwrite the same few MB over and over, so this can run
+			// indefinitely on a nearly full card.
+			File::Size offset = 0;
+			while( !chThdShouldTerminate() ) {
+				if( offset >= file_size ) {
+					file.seek(0);
+					offset = 0;
+				}
+
+				const halrtcnt_t write_start = halGetCounterValue();
+				const auto result_write = file.write(buffer->data(), buffer->size());
+				if( result_write.is_error() ) {
+					ok = false;
+					break;
+				}
+				const halrtcnt_t write_duration = halGetCounterValue() - write_start;
+				offset += buffer->size();
+				_bytes_written += buffer->size();
+
+				chSysLock();
+				if( write_duration > _write_duration_max ) {
+					_write_duration_max = write_duration;
+				}
+				chSysUnlock();
+			}
+		}
+
+		f_unlink(reinterpret_cast<const TCHAR*>(filename.c_str()));
+		return ok;
+	}
+};
+
 namespace ui {
 
 SDCardDebugView::SDCardDebugView(NavigationView& nav) {
@@ -241,12 +348,15 @@ SDCardDebugView::SDCardDebugView(NavigationView& nav) {
 		&text_bus_width_value,
 		&text_card_type_title,
 		&text_card_type_value,
+		&text_clock_title,
+		&text_clock_value,
 		&text_block_size_title,
 		&text_block_size_value,
 		&text_block_count_title,
 		&text_block_count_value,
 		&text_capacity_title,
 		&text_capacity_value,
+		&check_high_speed,
 		&text_test_write_time_title,
 		&text_test_write_time_value,
 		&text_test_write_rate_title,
@@ -256,10 +366,13 @@ SDCardDebugView::SDCardDebugView(NavigationView& nav) {
 		&text_test_read_rate_title,
 		&text_test_read_rate_value,
 		&button_test,
+		&button_live,
 		&button_ok,
 	});
 
+	check_high_speed.on_select = [this](Checkbox&, bool v) { this->on_high_speed(v); };
 	button_test.on_select = [this](Button&){ this->on_test(); };
+	button_live.on_select = [&nav](Button&){ nav.push<SDCardLiveView>(); };
 	button_ok.on_select = [&nav](Button&){ nav.pop(); };
 }
 
@@ -305,6 +418,7 @@ void SDCardDebugView::on_status(const sd_card::Status) {
 	text_csd_value_1.set("");
 	text_csd_value_2.set("");
 	text_csd_value_3.set("");
+	text_clock_value.set("");
 	text_block_size_value.set("");
 	text_block_count_value.set("");
 	text_capacity_value.set("");
@@ -343,6 +457,8 @@ void SDCardDebugView::on_status(const sd_card::Status) {
 		}
 		text_card_type_value.set(formatted_card_type);
 
+		update_clock();
+
 		std::array<uint32_t, 4> csd;
 		disk_ioctl(0, MMC_GET_CSD, csd.data());
 		text_csd_value_3.set(to_string_hex(csd[3], 8));
@@ -360,6 +476,32 @@ void SDCardDebugView::on_status(const sd_card::Status) {
 	}
 }
 
+static bool is_high_speed() {
+	return sd_card::clock_frequency() > 25000000U;
+}
+
+void SDCardDebugView::update_clock() {
+	text_clock_value.set(to_string_dec_uint(sd_card::clock_frequency() / 1000000U, 2) + " MHz");
+	check_high_speed.set_value(is_high_speed());
+}
+
+void SDCardDebugView::on_high_speed(const bool enable) {
+	// Also called back when update_clock() shows the current state.
+	if( enable == is_high_speed() ) {
+		return;
+	}
+
+	const bool ok = sd_card::set_high_speed(enable);
+	if( ok ) {
+		portapack::persistent_memory::set_sd_card_high_speed(sd_card::card_id(), enable);
+	}
+
+	update_clock();
+	if( !ok ) {
+		text_clock_value.set("No HS");
+	}
+}
+
 static std::string format_ticks_as_ms(const halrtcnt_t value) {
 	const uint32_t us = uint64_t(value) * 1000000U / halGetCounterFrequency();
 	return format_3dot3_string(us);
@@ -427,4 +569,77 @@ void SDCardDebugView::on_test() {
 	}
 }
 
+/* SDCardLiveView ********************************************************/
+
+SDCardLiveView::SDCardLiveView(
+	NavigationView& nav
+) : thread { std::make_unique<SDCardLiveThread>() }
+{
+	add_children({
+		&text_rate_title,
+		&text_rate_value,
+		&text_rate_min_title,
+		&text_rate_min_value,
+		&text_latency_title,
+		&text_latency_value,
+		&button_ok,
+	});
+
+	button_ok.on_select = [&nav](Button&){ nav.pop(); };
+}
+
+SDCardLiveView::~SDCardLiveView() {
+	thread.reset();
+}
+
+void SDCardLiveView::focus() {
+	button_ok.focus();
+}
+
+void SDCardLiveView::on_frame_sync() {
+	if( ++frame_count < interval_frames ) {
+		return;
+	}
+	frame_count = 0;
+
+	if( thread->failed() ) {
+		text_rate_value.set("Fail");
+		return;
+	}
+
+	const uint32_t bytes = thread->bytes_written();
+	const uint32_t interval_ms = interval_frames * 1000 / 60;
+	const uint32_t rate_kbps = (bytes - bytes_last) / interval_ms;		// bytes/ms = kB/s
+	bytes_last = bytes;
+	const uint32_t latency_ms = uint64_t(thread->take_write_duration_max()) * 1000U / halGetCounterFrequency();
+
+	if( (rate_min == 0) || (rate_kbps < rate_min) ) {
+		rate_min = rate_kbps;
+	}
+	latency_peak = std::max(latency_peak, latency_ms);
+
+	text_rate_value.set(format_3dot3_string(rate_kbps));
+	text_rate_min_value.set(format_3dot3_string(rate_min));
+	text_latency_value.set(to_string_dec_uint(latency_peak, 7));
+
+	plot(rate_kbps, latency_ms);
+}
+
+void SDCardLiveView::plot(const uint32_t rate_kbps, const uint32_t latency_ms) {
+	const auto height = graph_rect.height();
+	const Coord x = graph_rect.left() + column;
+	const Coord bottom = graph_rect.bottom();
+
+	const Dim rate_height = std::min<uint32_t>(rate_kbps * height / graph_rate_max, height);
+	const Dim latency_y = std::min<uint32_t>(latency_ms * height / graph_latency_max, height - 2);
+
+	portapack::display.fill_rectangle({ x, graph_rect.top(), 1, height }, Color::black());
+	portapack::display.fill_rectangle({ x, bottom - rate_height, 1, rate_height }, Color::green());
+	portapack::display.fill_rectangle({ x, bottom - latency_y - 2, 1, 2 }, Color::red());
+
+	// Cursor ahead of the newest column
+	column = (column + 1) % graph_rect.width();
+	portapack::display.fill_rectangle({ graph_rect.left() + column, graph_rect.top(), 1, height }, Color::white());
+}
+
 } /* namespace ui */
@@ -27,6 +27,10 @@
 
 #include "sd_card.hpp"
 
+#include <memory>
+
+class SDCardLiveThread;
+
 namespace ui {
 
 class SDCardDebugView : public View {
@@ -43,6 +47,8 @@ private:
 
 	void on_status(const sd_card::Status status);
 	void on_test();
+	void on_high_speed(const bool enable);
+	void update_clock();
 
 	Text text_title {
 		{ (240 - (7 * 8)) / 2, 1 * 16, (7 * 8), 16 },
@@ -98,6 +104,18 @@ private:
 		"",
 	};
 
+	static constexpr size_t clock_characters = 6;
+
+	Text text_clock_title {
+		{ 0, 7 * 16, (9 * 8), 16 },
+		"Bus clock",
+	};
+
+	Text text_clock_value {
+		{ 240 - (clock_characters * 8), 7 * 16, (clock_characters * 8), 16 },
+		"",
+	};
+
 	static constexpr size_t block_size_characters = 5;
 
 	Text text_block_size_title {
@@ -134,6 +152,13 @@ private:
 		"",
 	};
 
+	Checkbox check_high_speed {
+		{ 0, 11 * 16 },
+		10,
+		"High speed",
+		true
+	};
+
 	///////////////////////////////////////////////////////////////////////
 
 	static constexpr size_t test_write_time_characters = 23;
@@ -189,16 +214,93 @@ private:
 	///////////////////////////////////////////////////////////////////////
 
 	Button button_test {
-		{ 16, 17 * 16, 96, 24 },
+		{ 8, 17 * 16, 64, 24 },
 		"Test"
 	};
 
+	Button button_live {
+		{ 88, 17 * 16, 64, 24 },
+		"Live"
+	};
+
 	Button button_ok {
-		{ 240 - 96 - 16, 17 * 16, 96, 24 },
+		{ 240 - 64 - 8, 17 * 16, 64, 24 },
 		"OK"
 	};
 };
 
+/* Writes continuously and plots throughput (green) and the longest write
+ * (red) for each quarter second, a rolling minute across the screen. For
+ * telling which cards keep up with high-rate capture.
+ */
+class SDCardLiveView : public View {
+public:
+	SDCardLiveView(NavigationView& nav);
+	~SDCardLiveView();
+
+	void focus() override;
+
+	std::string title() const override { return "SD Card Live"; };
+
+private:
+	static constexpr size_t interval_frames = 15;			// 250ms at 60Hz
+	static constexpr uint32_t graph_rate_max = 10000;		// kB/s at the top
+	static constexpr uint32_t graph_latency_max = 200;		// ms at the top
+	const Rect graph_rect { 0, 4 * 16, 240, 12 * 16 };
+
+	std::unique_ptr<SDCardLiveThread> thread;
+	size_t frame_count { 0 };
+	uint32_t bytes_last { 0 };
+	Coord column { 0 };
+	uint32_t rate_min { 0 };
+	uint32_t latency_peak { 0 };
+
+	void on_frame_sync();
+	void plot(const uint32_t rate_kbps, const uint32_t latency_ms);
+
+	Text text_rate_title {
+		{ 0, 1 * 16, (12 * 8), 16 },
+		"W MB/s now",
+	};
+
+	Text text_rate_value {
+		{ 240 - (7 * 8), 1 * 16, (7 * 8), 16 },
+		"",
+	};
+
+	Text text_rate_min_title {
+		{ 0, 2 * 16, (12 * 8), 16 },
+		"W MB/s min",
+	};
+
+	Text text_rate_min_value {
+		{ 240 - (7 * 8), 2 * 16, (7 * 8), 16 },
+		"",
+	};
+
+	Text text_latency_title {
+		{ 0, 3 * 16, (12 * 8), 16 },
+		"Max write ms",
+	};
+
+	Text text_latency_value {
+		{ 240 - (7 * 8), 3 * 16, (7 * 8), 16 },
+		"",
+	};
+
+	Button button_ok {
+		{ (240 - 96) / 2, 17 * 16, 96, 24 },
+		"OK"
+	};
+
+	MessageHandlerRegistration message_handler_frame_sync {
+		Message::ID::DisplayFrameSync,
+		[this](const Message* const) {
+			this->on_frame_sync();
+		}
+	};
+};
+
 } /* namespace ui */
 
 #endif/*__UI_SD_CARD_DEBUG_H__*/
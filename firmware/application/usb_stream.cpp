@@ -0,0 +1,800 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "usb_stream.hpp"
+
+#include "hal.h"
+
+#include "event_m0.hpp"
+#include "portapack.hpp"
+#include "hackrf_gpio.hpp"
+#include "fifo.hpp"
+
+#include <cstring>
+#include <algorithm>
+#include <array>
+
+namespace usb_stream {
+
+namespace {
+
+/* USB0 device mode registers, UM10503 chapter 23. */
+struct Registers {
+	uint32_t reserved0[80];
+	volatile uint32_t USBCMD_D;
+	volatile uint32_t USBSTS_D;
+	volatile uint32_t USBINTR_D;
+	volatile uint32_t FRINDEX_D;
+	uint32_t reserved1;
+	volatile uint32_t DEVICEADDR;
+	volatile uint32_t ENDPOINTLISTADDR;
+	uint32_t reserved2[10];
+	volatile uint32_t PORTSC1_D;
+	uint32_t reserved3[7];
+	volatile uint32_t OTGSC;
+	volatile uint32_t USBMODE_D;
+	volatile uint32_t ENDPTSETUPSTAT;
+	volatile uint32_t ENDPTPRIME;
+	volatile uint32_t ENDPTFLUSH;
+	volatile uint32_t ENDPTSTAT;
+	volatile uint32_t ENDPTCOMPLETE;
+	volatile uint32_t ENDPTCTRL[6];
+};
+
+static_assert(offsetof(Registers, USBCMD_D) == 0x140, "USBCMD_D offset wrong");
+static_assert(offsetof(Registers, DEVICEADDR) == 0x154, "DEVICEADDR offset wrong");
+static_assert(offsetof(Registers, PORTSC1_D) == 0x184, "PORTSC1_D offset wrong");
+static_assert(offsetof(Registers, OTGSC) == 0x1a4, "OTGSC offset wrong");
+static_assert(offsetof(Registers, ENDPTCOMPLETE) == 0x1bc, "ENDPTCOMPLETE offset wrong");
+static_assert(offsetof(Registers, ENDPTCTRL) == 0x1c0, "ENDPTCTRL offset wrong");
+
+Registers& usb0() {
+	return *reinterpret_cast<Registers*>(LPC_USB0_BASE);
+}
+
+constexpr uint32_t usbcmd_rs = (1U << 0);
+constexpr uint32_t usbcmd_rst = (1U << 1);
+constexpr uint32_t usbcmd_sutw = (1U << 13);
+
+constexpr uint32_t usbsts_ui = (1U << 0);
+constexpr uint32_t usbsts_uei = (1U << 1);
+constexpr uint32_t usbsts_uri = (1U << 6);
+constexpr uint32_t usbsts_sli = (1U << 8);
+
+constexpr uint32_t otgsc_ot = (1U << 3);
+constexpr uint32_t otgsc_bsv = (1U << 11);
+
+constexpr uint32_t usbmode_cm_device = (2U << 0);
+constexpr uint32_t usbmode_slom = (1U << 3);
+
+constexpr uint32_t deviceaddr_usbadra = (1U << 24);
+
+constexpr uint32_t endptctrl_rxs = (1U << 0);
+constexpr uint32_t endptctrl_rxt_bulk = (2U << 2);
+constexpr uint32_t endptctrl_rxr = (1U << 6);
+constexpr uint32_t endptctrl_rxe = (1U << 7);
+constexpr uint32_t endptctrl_txs = (1U << 16);
+constexpr uint32_t endptctrl_txt_bulk = (2U << 18);
+constexpr uint32_t endptctrl_txt_interrupt = (3U << 18);
+constexpr uint32_t endptctrl_txr = (1U << 22);
+constexpr uint32_t endptctrl_txe = (1U << 23);
+
+/* Device queue head, one per endpoint direction, and transfer descriptor. */
+struct QueueHead {
+	volatile uint32_t capabilities;
+	volatile uint32_t current_td;
+	volatile uint32_t next_td;
+	volatile uint32_t token;
+	volatile uint32_t buffer[5];
+	uint32_t reserved;
+	volatile uint32_t setup[2];
+	uint32_t padding[4];
+};
+
+struct TransferDescriptor {
+	volatile uint32_t next_td;
+	volatile uint32_t token;
+	volatile uint32_t buffer[5];
+	uint32_t reserved;
+};
+
+static_assert(sizeof(QueueHead) == 64, "QueueHead size wrong");
+static_assert(sizeof(TransferDescriptor) == 32, "TransferDescriptor size wrong");
+
+constexpr uint32_t qh_ios = (1U << 15);
+constexpr uint32_t qh_zlt = (1U << 29);
+
+constexpr uint32_t td_terminate = (1U << 0);
+constexpr uint32_t td_ioc = (1U << 15);
+constexpr uint32_t td_active = (1U << 7);
+constexpr uint32_t td_halted = (1U << 6);
+
+// Five 4KiB pages, of which the first can start anywhere.
+constexpr size_t td_bytes_max = 16384;
+
+/* EP1 IN is the capture stream. EP2 IN, the serial port's notifications,
+ * is never used but has to be there. EP3 is the serial port's data.
+ */
+enum QueueIndex {
+	EP0_OUT = 0,
+	EP0_IN = 1,
+	EP1_OUT = 2,
+	EP1_IN = 3,
+	EP2_OUT = 4,
+	EP2_IN = 5,
+	EP3_OUT = 6,
+	EP3_IN = 7,
+};
+
+constexpr uint32_t endpoint_bit(const size_t index) {
+	return (1U << ((index >> 1) + ((index & 1) ? 16 : 0)));
+}
+
+constexpr uint32_t ep0_bits = endpoint_bit(EP0_OUT) | endpoint_bit(EP0_IN);
+constexpr uint32_t bulk_in_bit = endpoint_bit(EP1_IN);
+constexpr uint32_t serial_out_bit = endpoint_bit(EP3_OUT);
+constexpr uint32_t serial_in_bit = endpoint_bit(EP3_IN);
+
+constexpr size_t ep0_packet_size = 64;
+constexpr size_t usb0_endpoints = 4;
+
+alignas(2048) std::array<QueueHead, 8> queue_heads;
+alignas(32) std::array<TransferDescriptor, 2> ep0_tds;
+alignas(32) std::array<TransferDescriptor, transfer_size_max / td_bytes_max> bulk_tds;
+alignas(32) std::array<TransferDescriptor, 2> serial_tds;
+// Big enough for the configuration descriptor.
+alignas(4) std::array<uint8_t, 128> ep0_buffer;
+
+alignas(4) std::array<uint8_t, 512> serial_rx_buffer;
+alignas(4) std::array<uint8_t, 512> serial_tx_buffer;
+std::array<uint8_t, 1024> serial_rx_data;
+std::array<uint8_t, 4096> serial_tx_data;
+FIFO<uint8_t> serial_rx_fifo { serial_rx_data.data(), 10 };
+FIFO<uint8_t> serial_tx_fifo { serial_tx_data.data(), 12 };
+size_t serial_rx_requested = 0;
+bool serial_rx_busy = false;
+bool serial_tx_busy = false;
+volatile bool serial_dtr = false;
+// CDC line coding, which means nothing here but is kept for the host.
+std::array<uint8_t, 7> line_coding { { 0x00, 0xc2, 0x01, 0x00, 0, 0, 8 } };
+
+enum class TransferState {
+	Idle,
+	Busy,
+	Done,
+	Aborted,
+};
+
+size_t users = 0;
+volatile uint8_t configuration = 0;
+volatile TransferState transfer_state = TransferState::Idle;
+Thread* transfer_thread = nullptr;
+// Class request waiting on its data stage from the host.
+uint8_t ep0_out_request = 0;
+
+/* Descriptors **********************************************************/
+
+constexpr uint16_t vendor_id = 0x1209;
+constexpr uint16_t product_id = 0x0001;
+
+constexpr std::array<uint8_t, 18> device_descriptor { {
+	18, 0x01,
+	0x00, 0x02,			// USB 2.00
+	0xef, 0x02, 0x01,	// Interface association
+	ep0_packet_size,
+	vendor_id & 0xff, vendor_id >> 8,
+	product_id & 0xff, product_id >> 8,
+	0x00, 0x02,			// Device 2.00
+	1, 2, 0,			// Manufacturer, product, no serial number
+	1,
+} };
+
+constexpr std::array<uint8_t, 10> device_qualifier_descriptor { {
+	10, 0x06,
+	0x00, 0x02,
+	0xef, 0x02, 0x01,
+	ep0_packet_size,
+	1,
+	0,
+} };
+
+/* Interface 0 is the capture stream, 1 and 2 a CDC ACM serial port. Bulk
+ * max packet sizes are filled in for the bus speed.
+ */
+constexpr std::array<uint8_t, 91> configuration_descriptor { {
+	9, 0x02, 91, 0, 3, 1, 0, 0x80, 250,
+
+	9, 0x04, 0, 0, 1, 0xff, 0x00, 0x00, 0,
+	7, 0x05, 0x81, 0x02, 0x00, 0x00, 0,
+
+	8, 0x0b, 1, 2, 0x02, 0x02, 0x01, 0,
+
+	9, 0x04, 1, 0, 1, 0x02, 0x02, 0x01, 0,
+	5, 0x24, 0x00, 0x10, 0x01,			// Header, CDC 1.10
+	5, 0x24, 0x01, 0x00, 2,				// Call management
+	4, 0x24, 0x02, 0x02,				// ACM: line coding, line state
+	5, 0x24, 0x06, 1, 2,				// Union
+	7, 0x05, 0x82, 0x03, 16, 0, 8,
+
+	9, 0x04, 2, 0, 2, 0x0a, 0x00, 0x00, 0,
+	7, 0x05, 0x03, 0x02, 0x00, 0x00, 0,
+	7, 0x05, 0x83, 0x02, 0x00, 0x00, 0,
+} };
+
+constexpr std::array<size_t, 3> bulk_packet_size_offsets { { 22, 81, 88 } };
+
+constexpr std::array<const char*, 3> strings { {
+	nullptr,
+	"PortaPack",
+	"PortaPack",
+} };
+
+/* Transfers ************************************************************/
+
+bool is_high_speed() {
+	return ((usb0().PORTSC1_D >> 26) & 3) == 2;
+}
+
+size_t bulk_packet_size() {
+	return is_high_speed() ? 512 : 64;
+}
+
+void flush(const uint32_t bits) {
+	do {
+		usb0().ENDPTFLUSH = bits;
+		while( usb0().ENDPTFLUSH & bits );
+	} while( usb0().ENDPTSTAT & bits );
+}
+
+void td_fill(TransferDescriptor& td, const void* const data, const size_t bytes, const bool last) {
+	const auto p = reinterpret_cast<uint32_t>(data);
+	td.next_td = last ? td_terminate : reinterpret_cast<uint32_t>(&td + 1);
+	td.token = (bytes << 16) | (last ? td_ioc : 0) | td_active;
+	td.buffer[0] = p;
+	for(size_t i=1; i<5; i++) {
+		td.buffer[i] = (p & ~0xfffU) + i * 0x1000;
+	}
+}
+
+void prime(const size_t index, TransferDescriptor& td) {
+	auto& qh = queue_heads[index];
+	qh.next_td = reinterpret_cast<uint32_t>(&td);
+	qh.token &= ~(td_active | td_halted);
+	usb0().ENDPTPRIME = endpoint_bit(index);
+}
+
+/* flags: qh_ios, for setup packet interrupts, and qh_zlt, to not end
+ * transfers of whole packets with a zero length one.
+ */
+void queue_head_init(const size_t index, const size_t packet_size, const uint32_t flags) {
+	auto& qh = queue_heads[index];
+	qh.capabilities = flags | (packet_size << 16);
+	qh.current_td = 0;
+	qh.next_td = td_terminate;
+	qh.token = 0;
+}
+
+/* With interrupts off, from thread or ISR. */
+void transfer_abort() {
+	flush(bulk_in_bit);
+	if( transfer_state == TransferState::Busy ) {
+		transfer_state = TransferState::Aborted;
+		if( transfer_thread ) {
+			transfer_thread->p_u.rdymsg = RDY_RESET;
+			chSchReadyI(transfer_thread);
+			transfer_thread = nullptr;
+		}
+	}
+}
+
+void transfer_complete() {
+	if( transfer_state == TransferState::Busy ) {
+		transfer_state = TransferState::Done;
+		if( transfer_thread ) {
+			transfer_thread->p_u.rdymsg = RDY_OK;
+			chSchReadyI(transfer_thread);
+			transfer_thread = nullptr;
+		}
+	}
+}
+
+size_t td_bytes_left(const TransferDescriptor& td) {
+	return (td.token >> 16) & 0x7fff;
+}
+
+/* Serial port ***********************************************************/
+
+/* Received data is held off, the host NAKed, until there's room for a
+ * whole packet of it.
+ */
+void serial_rx_prime() {
+	serial_rx_requested = bulk_packet_size();
+	if( configuration && !serial_rx_busy && (serial_rx_fifo.unused() >= serial_rx_requested) ) {
+		td_fill(serial_tds[0], serial_rx_buffer.data(), serial_rx_requested, true);
+		prime(EP3_OUT, serial_tds[0]);
+		serial_rx_busy = true;
+	}
+}
+
+void serial_rx_complete() {
+	serial_rx_busy = false;
+	const size_t received = serial_rx_requested - td_bytes_left(serial_tds[0]);
+	serial_rx_fifo.in(serial_rx_buffer.data(), received);
+	serial_rx_prime();
+	EventDispatcher::events_flag_isr(EVT_MASK_USB_SERIAL);
+}
+
+void serial_tx_kick() {
+	if( configuration && !serial_tx_busy && !serial_tx_fifo.is_empty() ) {
+		const size_t bytes = serial_tx_fifo.out(serial_tx_buffer.data(), serial_tx_buffer.size());
+		td_fill(serial_tds[1], serial_tx_buffer.data(), bytes, true);
+		prime(EP3_IN, serial_tds[1]);
+		serial_tx_busy = true;
+	}
+}
+
+void serial_tx_complete() {
+	serial_tx_busy = false;
+	serial_tx_kick();
+}
+
+void serial_reset() {
+	flush(serial_out_bit | serial_in_bit);
+	serial_rx_busy = false;
+	serial_tx_busy = false;
+	serial_dtr = false;
+	serial_rx_fifo.reset();
+	serial_tx_fifo.reset();
+}
+
+void set_configuration(const uint8_t value) {
+	transfer_abort();
+	serial_reset();
+	configuration = value;
+	if( value ) {
+		const auto packet_size = bulk_packet_size();
+		queue_head_init(EP1_IN, packet_size, qh_zlt);
+		queue_head_init(EP2_IN, 16, qh_zlt);
+		queue_head_init(EP3_OUT, packet_size, qh_zlt);
+		queue_head_init(EP3_IN, packet_size, 0);
+		// A direction left unused still needs a type other than control.
+		usb0().ENDPTCTRL[1] = endptctrl_txe | endptctrl_txr | endptctrl_txt_bulk | endptctrl_rxt_bulk;
+		usb0().ENDPTCTRL[2] = endptctrl_txe | endptctrl_txr | endptctrl_txt_interrupt | endptctrl_rxt_bulk;
+		usb0().ENDPTCTRL[3] =
+			  endptctrl_txe | endptctrl_txr | endptctrl_txt_bulk
+			| endptctrl_rxe | endptctrl_rxr | endptctrl_rxt_bulk
+			;
+		serial_rx_prime();
+	} else {
+		usb0().ENDPTCTRL[1] = 0;
+		usb0().ENDPTCTRL[2] = 0;
+		usb0().ENDPTCTRL[3] = 0;
+	}
+	hackrf::one::led_usb.write(value != 0);
+}
+
+/* Control endpoint *****************************************************/
+
+struct Setup {
+	uint8_t request_type;
+	uint8_t request;
+	uint16_t value;
+	uint16_t index;
+	uint16_t length;
+};
+
+void ep0_stall() {
+	usb0().ENDPTCTRL[0] |= endptctrl_rxs | endptctrl_txs;
+}
+
+/* Status stage only, host to device. */
+void ep0_status_in() {
+	td_fill(ep0_tds[1], nullptr, 0, true);
+	prime(EP0_IN, ep0_tds[1]);
+}
+
+/* From ep0_buffer, cut to what the host asked for, then the status stage. */
+void ep0_transmit(const size_t bytes, const Setup& setup) {
+	td_fill(ep0_tds[1], ep0_buffer.data(), std::min<size_t>(bytes, setup.length), true);
+	prime(EP0_IN, ep0_tds[1]);
+	td_fill(ep0_tds[0], nullptr, 0, true);
+	prime(EP0_OUT, ep0_tds[0]);
+}
+
+template<size_t N>
+void ep0_transmit(const std::array<uint8_t, N>& descriptor, const Setup& setup) {
+	std::copy(descriptor.begin(), descriptor.end(), ep0_buffer.begin());
+	ep0_transmit(N, setup);
+}
+
+bool get_descriptor(const Setup& setup) {
+	const uint8_t type = setup.value >> 8;
+	const uint8_t index = setup.value & 0xff;
+
+	switch(type) {
+	case 0x01:
+		ep0_transmit(device_descriptor, setup);
+		return true;
+
+	case 0x02:
+		{
+			std::copy(configuration_descriptor.begin(), configuration_descriptor.end(), ep0_buffer.begin());
+			const auto packet_size = bulk_packet_size();
+			for(const auto offset : bulk_packet_size_offsets) {
+				ep0_buffer[offset + 0] = packet_size & 0xff;
+				ep0_buffer[offset + 1] = packet_size >> 8;
+			}
+			ep0_transmit(configuration_descriptor.size(), setup);
+		}
+		return true;
+
+	case 0x03:
+		if( index == 0 ) {
+			ep0_transmit(std::array<uint8_t, 4> { { 4, 0x03, 0x09, 0x04 } }, setup);
+			return true;
+		}
+		if( index < strings.size() ) {
+			// ASCII to UTF-16LE
+			const size_t length = std::min(strlen(strings[index]), (ep0_buffer.size() - 2) / 2);
+			ep0_buffer[0] = 2 + length * 2;
+			ep0_buffer[1] = 0x03;
+			for(size_t i=0; i<length; i++) {
+				ep0_buffer[2 + i * 2] = strings[index][i];
+				ep0_buffer[3 + i * 2] = 0;
+			}
+			ep0_transmit(ep0_buffer[0], setup);
+			return true;
+		}
+		return false;
+
+	case 0x06:
+		ep0_transmit(device_qualifier_descriptor, setup);
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+bool standard_request(const Setup& setup) {
+	switch(setup.request) {
+	case 0x00:	// GET_STATUS
+		ep0_buffer[0] = 0;
+		ep0_buffer[1] = 0;
+		if( ((setup.request_type & 0x1f) == 0x02) && ((setup.index & 0x7f) < usb0_endpoints) ) {
+			const uint32_t stall = (setup.index & 0x80) ? endptctrl_txs : endptctrl_rxs;
+			ep0_buffer[0] = (usb0().ENDPTCTRL[setup.index & 0x7f] & stall) ? 1 : 0;
+		}
+		ep0_transmit(2, setup);
+		return true;
+
+	case 0x01:	// CLEAR_FEATURE, ENDPOINT_HALT
+		if( ((setup.request_type & 0x1f) == 0x02) && (setup.value == 0) &&
+			((setup.index & 0x7f) > 0) && ((setup.index & 0x7f) < usb0_endpoints) ) {
+			auto& ctrl = usb0().ENDPTCTRL[setup.index & 0x7f];
+			ctrl = (setup.index & 0x80)
+				? ((ctrl & ~endptctrl_txs) | endptctrl_txr)
+				: ((ctrl & ~endptctrl_rxs) | endptctrl_rxr);
+			ep0_status_in();
+			return true;
+		}
+		return false;
+
+	case 0x05:	// SET_ADDRESS, takes effect after the status stage
+		usb0().DEVICEADDR = ((setup.value & 0x7fU) << 25) | deviceaddr_usbadra;
+		ep0_status_in();
+		return true;
+
+	case 0x06:	// GET_DESCRIPTOR
+		return get_descriptor(setup);
+
+	case 0x08:	// GET_CONFIGURATION
+		ep0_buffer[0] = configuration;
+		ep0_transmit(1, setup);
+		return true;
+
+	case 0x09:	// SET_CONFIGURATION
+		if( setup.value > 1 ) {
+			return false;
+		}
+		set_configuration(setup.value);
+		ep0_status_in();
+		return true;
+
+	case 0x0a:	// GET_INTERFACE
+		ep0_buffer[0] = 0;
+		ep0_transmit(1, setup);
+		return true;
+
+	case 0x0b:	// SET_INTERFACE
+		if( setup.value != 0 ) {
+			return false;
+		}
+		ep0_status_in();
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+/* CDC ACM, on the serial port's control interface. */
+bool class_request(const Setup& setup) {
+	if( (setup.request_type & 0x1f) != 0x01 ) {
+		return false;
+	}
+
+	switch(setup.request) {
+	case 0x20:	// SET_LINE_CODING, data stage first
+		ep0_out_request = setup.request;
+		td_fill(ep0_tds[0], ep0_buffer.data(), std::min<size_t>(line_coding.size(), setup.length), true);
+		prime(EP0_OUT, ep0_tds[0]);
+		return true;
+
+	case 0x21:	// GET_LINE_CODING
+		ep0_transmit(line_coding, setup);
+		return true;
+
+	case 0x22:	// SET_CONTROL_LINE_STATE
+		serial_dtr = (setup.value & 1) != 0;
+		if( !serial_dtr ) {
+			// Nobody's listening, drop what was waiting for them.
+			serial_tx_fifo.reset();
+		}
+		ep0_status_in();
+		return true;
+
+	case 0x23:	// SEND_BREAK
+		ep0_status_in();
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+void ep0_out_complete() {
+	if( ep0_out_request == 0x20 ) {
+		std::copy(ep0_buffer.begin(), ep0_buffer.begin() + line_coding.size(), line_coding.begin());
+		ep0_status_in();
+	}
+	ep0_out_request = 0;
+}
+
+void handle_setup() {
+	Setup setup;
+	std::array<uint32_t, 2> words;
+	// The tripwire is cleared if a new setup packet lands while copying.
+	do {
+		usb0().USBCMD_D |= usbcmd_sutw;
+		words[0] = queue_heads[EP0_OUT].setup[0];
+		words[1] = queue_heads[EP0_OUT].setup[1];
+	} while( !(usb0().USBCMD_D & usbcmd_sutw) );
+	usb0().USBCMD_D &= ~usbcmd_sutw;
+	memcpy(&setup, words.data(), sizeof(setup));
+
+	usb0().ENDPTSETUPSTAT = endpoint_bit(EP0_OUT);
+	while( usb0().ENDPTSETUPSTAT & endpoint_bit(EP0_OUT) );
+
+	// A new setup packet ends whatever was left of the last transfer.
+	flush(ep0_bits);
+	ep0_out_request = 0;
+
+	bool handled = false;
+	switch(setup.request_type & 0x60) {
+	case 0x00:	handled = standard_request(setup);	break;
+	case 0x20:	handled = class_request(setup);		break;
+	default:	break;
+	}
+	if( !handled ) {
+		ep0_stall();
+	}
+}
+
+void bus_reset() {
+	usb0().ENDPTSETUPSTAT = usb0().ENDPTSETUPSTAT;
+	usb0().ENDPTCOMPLETE = usb0().ENDPTCOMPLETE;
+	while( usb0().ENDPTPRIME );
+	flush(0xffffffffU);
+
+	usb0().DEVICEADDR = 0;
+	set_configuration(0);
+}
+
+void bus_suspend() {
+	// Suspended with VBUS gone is the cable pulled, no reset follows.
+	if( !(usb0().OTGSC & otgsc_bsv) ) {
+		set_configuration(0);
+	}
+}
+
+void controller_reset() {
+	usb0().USBCMD_D &= ~usbcmd_rs;
+	usb0().USBCMD_D = usbcmd_rst;
+	while( usb0().USBCMD_D & usbcmd_rst );
+}
+
+} /* namespace */
+
+void start() {
+	if( users++ ) {
+		return;
+	}
+
+	portapack::clock_manager.start_usb_pll();
+	LPC_CREG->CREG0 &= ~(1U << 5);	// Enable USB0 PHY
+
+	controller_reset();
+	usb0().USBMODE_D = usbmode_cm_device | usbmode_slom;
+	usb0().OTGSC = otgsc_ot;
+
+	for(size_t i=0; i<queue_heads.size(); i++) {
+		queue_head_init(i, 0, 0);
+	}
+	queue_head_init(EP0_OUT, ep0_packet_size, qh_ios | qh_zlt);
+	queue_head_init(EP0_IN, ep0_packet_size, qh_zlt);
+	usb0().ENDPOINTLISTADDR = reinterpret_cast<uint32_t>(queue_heads.data());
+
+	usb0().USBSTS_D = 0xffffffffU;
+	usb0().USBINTR_D = usbsts_ui | usbsts_uei | usbsts_uri | usbsts_sli;
+	nvicEnableVector(USB0_IRQn, CORTEX_PRIORITY_MASK(LPC43XX_USB0_IRQ_PRIORITY));
+
+	// Run, interrupt threshold 0: completions are seen at once, not a
+	// microframe boundary later. Connects the D+ pull-up.
+	usb0().USBCMD_D = usbcmd_rs;
+}
+
+void stop() {
+	if( (users == 0) || --users ) {
+		return;
+	}
+
+	usb0().USBCMD_D &= ~usbcmd_rs;
+	nvicDisableVector(USB0_IRQn);
+
+	chSysLock();
+	set_configuration(0);
+	chSysUnlock();
+
+	controller_reset();
+	LPC_CREG->CREG0 |= (1U << 5);	// Disable USB0 PHY
+	portapack::clock_manager.stop_usb_pll();
+}
+
+bool is_configured() {
+	return configuration != 0;
+}
+
+bool transmit_start(const void* const data, const size_t bytes) {
+	chSysLock();
+	if( !configuration || (transfer_state == TransferState::Busy) ) {
+		chSysUnlock();
+		return false;
+	}
+
+	const auto p = static_cast<const uint8_t*>(data);
+	const size_t count = std::max<size_t>(1, (std::min(bytes, transfer_size_max) + td_bytes_max - 1) / td_bytes_max);
+	for(size_t i=0; i<count; i++) {
+		const size_t offset = i * td_bytes_max;
+		td_fill(bulk_tds[i], &p[offset], std::min(bytes - offset, td_bytes_max), i == (count - 1));
+	}
+	transfer_state = TransferState::Busy;
+	prime(EP1_IN, bulk_tds[0]);
+	chSysUnlock();
+	return true;
+}
+
+Result transmit_wait(const systime_t timeout) {
+	chSysLock();
+	if( transfer_state == TransferState::Busy ) {
+		transfer_thread = chThdSelf();
+		chSchGoSleepTimeoutS(THD_STATE_SUSPENDED, timeout);
+		transfer_thread = nullptr;
+	}
+
+	Result result = Result::Timeout;
+	if( transfer_state == TransferState::Done ) {
+		result = Result::Complete;
+		transfer_state = TransferState::Idle;
+	} else if( transfer_state == TransferState::Aborted ) {
+		result = Result::Disconnected;
+		transfer_state = TransferState::Idle;
+	}
+	chSysUnlock();
+	return result;
+}
+
+void transmit_cancel() {
+	chSysLock();
+	flush(bulk_in_bit);
+	transfer_state = TransferState::Idle;
+	chSysUnlock();
+}
+
+bool serial_is_open() {
+	return configuration && serial_dtr;
+}
+
+size_t serial_read(void* const data, const size_t bytes) {
+	chSysLock();
+	const size_t count = serial_rx_fifo.out(static_cast<uint8_t*>(data), bytes);
+	serial_rx_prime();
+	chSysUnlock();
+	return count;
+}
+
+size_t serial_write(const void* const data, const size_t bytes) {
+	chSysLock();
+	size_t count = 0;
+	if( configuration && serial_dtr && (serial_tx_fifo.unused() >= bytes) ) {
+		count = serial_tx_fifo.in(static_cast<const uint8_t*>(data), bytes);
+		serial_tx_kick();
+	}
+	chSysUnlock();
+	return count;
+}
+
+} /* namespace usb_stream */
+
+extern "C" {
+
+CH_IRQ_HANDLER(USB0_IRQHandler) {
+	CH_IRQ_PROLOGUE();
+
+	using namespace usb_stream;
+
+	const uint32_t status = usb0().USBSTS_D & usb0().USBINTR_D;
+	usb0().USBSTS_D = status;
+
+	chSysLockFromIsr();
+	if( status & usbsts_uri ) {
+		bus_reset();
+	}
+	if( status & usbsts_sli ) {
+		bus_suspend();
+	}
+	if( status & (usbsts_ui | usbsts_uei) ) {
+		if( usb0().ENDPTSETUPSTAT & endpoint_bit(EP0_OUT) ) {
+			handle_setup();
+		}
+
+		const uint32_t complete = usb0().ENDPTCOMPLETE;
+		usb0().ENDPTCOMPLETE = complete;
+		if( (complete & endpoint_bit(EP0_OUT)) && ep0_out_request ) {
+			ep0_out_complete();
+		}
+		if( complete & bulk_in_bit ) {
+			transfer_complete();
+		}
+		if( complete & serial_out_bit ) {
+			serial_rx_complete();
+		}
+		if( complete & serial_in_bit ) {
+			serial_tx_complete();
+		}
+	}
+	chSysUnlockFromIsr();
+
+	CH_IRQ_EPILOGUE();
+}
+
+}
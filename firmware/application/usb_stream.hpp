@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __USB_STREAM_H__
+#define __USB_STREAM_H__
+
+#include "ch.h"
+
+#include <cstdint>
+#include <cstddef>
+
+/* USB0 as a composite device: a vendor class bulk IN endpoint (0x81), to
+ * stream captures to a host without leaving the application, and a CDC ACM
+ * serial port, for remote control (see remote_control.hpp). Enumerates as
+ * 1209:0001, the pid.codes test PID, at high speed (512 byte packets) or
+ * full speed (64). tools/usb_stream.py reads the stream into a file.
+ *
+ * The controller's DMA reads transmit data where it lies, so a transfer
+ * goes straight out of the baseband's StreamBuffers.
+ */
+namespace usb_stream {
+
+/* Four 16KiB transfer descriptors, chained. */
+constexpr size_t transfer_size_max = 65536;
+
+enum class Result {
+	Complete,
+	Timeout,
+	Disconnected,
+};
+
+/* Counted: the device is on the bus from the first start until the last
+ * matching stop.
+ */
+void start();
+void stop();
+
+bool is_configured();
+
+/* One transfer at a time, of up to transfer_size_max bytes, which must stay
+ * put until it completes or is cancelled. False if the host hasn't
+ * configured the device.
+ */
+bool transmit_start(const void* const data, const size_t bytes);
+Result transmit_wait(const systime_t timeout);
+void transmit_cancel();
+
+/* Serial port, buffered both ways; neither blocks. Arrivals flag
+ * EVT_MASK_USB_SERIAL to the event loop. A write goes in whole or not at
+ * all, returning 0: when the buffer's full, or no host has the port open.
+ */
+bool serial_is_open();
+size_t serial_read(void* const data, const size_t bytes);
+size_t serial_write(const void* const data, const size_t bytes);
+
+} /* namespace usb_stream */
+
+#endif/*__USB_STREAM_H__*/
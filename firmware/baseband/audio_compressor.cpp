@@ -21,6 +21,10 @@
 
 #include "audio_compressor.hpp"
 
+#include "hal.h"
+
+#include <algorithm>
+
 float GainComputer::operator()(const float x) const {
 	const auto abs_x = std::abs(x);
 	const auto db = (abs_x < lin_floor) ? db_floor : log2_db_k * fast_log2(abs_x);
@@ -50,3 +54,58 @@ float FeedForwardCompressor::execute_once(const float x) {
 	const auto gain = fast_pow2(peak_db * (3.321928094887362f / 20.0f));
 	return x * gain;
 }
+
+void CompressorQ15::configure(const Config& config, const uint32_t sampling_rate) {
+	for(size_t i=0; i<curve.size(); i++) {
+		// A step's upper edge, 2^octave * (1 + (step + 1) / steps_per_octave) in
+		// Q15, so no level in it ends up over the ceiling
+		const size_t octave = i / steps_per_octave;
+		const float level = (1 << octave) * (1.0f + float(i % steps_per_octave + 1) / steps_per_octave) / 32768.0f;
+		const float level_db = 20.0f * std::log10(level);
+		const float over_db = std::max(level_db - config.threshold_db, 0.0f);
+		const float out_db = std::min(level_db - over_db + over_db / config.ratio + config.makeup_db, config.ceiling_db);
+		const float gain_q10 = std::pow(10.0f, (out_db - level_db) / 20.0f) * 1024.0f;
+		curve[i] = static_cast<uint16_t>(std::min(gain_q10, 65535.0f));
+	}
+
+	release_k = std::max<uint32_t>((1.0f - std::exp(-1.0f / (config.release_s * sampling_rate))) * 65536.0f, 1);
+	ceiling = std::min(std::pow(10.0f, config.ceiling_db / 20.0f) * 32768.0f, 32767.0f);
+
+	reset();
+}
+
+void CompressorQ15::reset() {
+	delay.fill(0);
+	delay_index = 0;
+	envelope = 0;
+	gain = curve[0] << 12;
+}
+
+size_t CompressorQ15::curve_index(const uint32_t level) {
+	if( level == 0 ) {
+		return 0;
+	}
+	const size_t octave = std::min<size_t>(31 - __CLZ(level), 14);
+	// The four bits under the leading one
+	const size_t step = ((octave >= 4) ? (level >> (octave - 4)) : (level << (4 - octave))) & 15;
+	return octave * steps_per_octave + step;
+}
+
+void CompressorQ15::execute_in_place(const buffer_s16_t& buffer) {
+	for(size_t i=0; i<buffer.count; i++) {
+		const int32_t x = buffer.p[i];
+
+		const uint32_t peak = static_cast<uint32_t>(std::abs(x)) << 16;
+		envelope = std::max(peak, envelope - (envelope >> 16) * release_k);
+
+		const int32_t target = curve[curve_index(envelope >> 16)] << 12;
+		gain += (target - gain) >> attack_shift;
+
+		const int32_t delayed = delay[delay_index];
+		delay[delay_index] = x;
+		delay_index = (delay_index + 1) & (lookahead - 1);
+
+		const int32_t y = (delayed * (gain >> 12)) >> 10;
+		buffer.p[i] = std::max(-ceiling, std::min(ceiling, y));
+	}
+}
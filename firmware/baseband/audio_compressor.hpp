@@ -25,6 +25,9 @@
 #include "dsp_types.hpp"
 #include "utility.hpp"
 
+#include <cstdint>
+#include <cstddef>
+#include <array>
 #include <cmath>
 
 /* Code based on article in Journal of the Audio Engineering Society
@@ -99,4 +102,50 @@ private:
 	}
 };
 
+/* Q15 compressor and limiter, a block at a time: a peak envelope (instant
+ * attack, exponential release) looks its gain up in a curve of 16 steps
+ * an octave, made in configure(). The gain, smoothed, is applied to the
+ * audio lookahead samples late, so it's down by the time a peak gets
+ * there; the little still over the ceiling is clipped. Integer only, one
+ * table lookup a sample.
+ */
+class CompressorQ15 {
+public:
+	static constexpr size_t lookahead = 32;
+	static_assert((lookahead & (lookahead - 1)) == 0, "lookahead must be a power of two");
+
+	struct Config {
+		float threshold_db;		// dBFS, compressed above by ratio
+		float ratio;
+		float makeup_db;
+		float ceiling_db;		// dBFS, limited to after makeup
+		float release_s;
+	};
+
+	void configure(const Config& config, const uint32_t sampling_rate);
+	void reset();
+
+	void execute_in_place(const buffer_s16_t& buffer);
+
+private:
+	static constexpr size_t steps_per_octave = 16;
+	static constexpr size_t curve_size = 15 * steps_per_octave;
+	// Gain smoothing time constant, 2^n samples: e^-4 left at lookahead.
+	static constexpr size_t attack_shift = 3;
+
+	// Gain, Q10 (up to 36dB), by envelope level.
+	std::array<uint16_t, curve_size> curve { };
+	std::array<int16_t, lookahead> delay { };
+	size_t delay_index { 0 };
+
+	// |x| peak, Q15 << 16, and its release per sample, Q16.
+	uint32_t envelope { 0 };
+	uint32_t release_k { 0 };
+	// Q10 << 12
+	int32_t gain { 1 << 22 };
+	int32_t ceiling { 32767 };
+
+	static size_t curve_index(const uint32_t level);
+};
+
 #endif/*__AUDIO_COMPRESSOR_H__*/
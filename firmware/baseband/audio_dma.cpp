@@ -122,9 +122,10 @@ constexpr gpdma::channel::Config config_rx() {
 
 /* TODO: Clean up terminology around "buffer", "transfer", "samples" */
 
-constexpr size_t buffer_samples_log2n = 7;
+// Eight transfers a direction, room to run a few transfers off the DMA.
+constexpr size_t buffer_samples_log2n = 8;
 constexpr size_t buffer_samples = (1 << buffer_samples_log2n);
-constexpr size_t transfers_per_buffer_log2n = 2;
+constexpr size_t transfers_per_buffer_log2n = 3;
 constexpr size_t transfers_per_buffer = (1 << transfers_per_buffer_log2n);
 constexpr size_t transfer_samples = buffer_samples / transfers_per_buffer;
 constexpr size_t transfers_mask = transfers_per_buffer - 1;
@@ -144,8 +145,38 @@ static constexpr auto& gpdma_channel_i2s0_rx = gpdma::channels[portapack::i2s0_r
 static volatile const gpdma::channel::LLI* tx_next_lli = nullptr;
 static volatile const gpdma::channel::LLI* rx_next_lli = nullptr;
 
+/* Transfers are numbered as they complete. The LLI register is two past
+ * the transfer that just completed, and the sequence advances by the
+ * distance moved, as in baseband::dma.
+ */
+struct Completion {
+	volatile uint32_t sequence;
+	volatile size_t index;
+
+	void reset() {
+		sequence = 0xffffffff;
+		index = transfers_per_buffer - 1;
+	}
+
+	void update(const size_t next_index) {
+		const size_t completed_index = (next_index + transfers_per_buffer - 2) & transfers_mask;
+		const size_t advance = (completed_index - index) & transfers_mask;
+		index = completed_index;
+		sequence += advance ? advance : transfers_per_buffer;
+	}
+
+	size_t index_of(const uint32_t transfer_sequence) const {
+		return (index + (transfer_sequence - sequence)) & transfers_mask;
+	}
+};
+
+static Completion tx_completion;
+static Completion rx_completion;
+
 static void tx_transfer_complete() {
-	tx_next_lli = gpdma_channel_i2s0_tx.next_lli();
+	const auto next_lli = gpdma_channel_i2s0_tx.next_lli();
+	tx_completion.update(next_lli - &lli_tx_loop[0]);
+	tx_next_lli = next_lli;
 }
 
 static void tx_error() {
@@ -153,7 +184,9 @@ static void tx_error() {
 }
 
 static void rx_transfer_complete() {
-	rx_next_lli = gpdma_channel_i2s0_rx.next_lli();
+	const auto next_lli = gpdma_channel_i2s0_rx.next_lli();
+	rx_completion.update(next_lli - &lli_rx_loop[0]);
+	rx_next_lli = next_lli;
 }
 
 static void rx_error() {
@@ -204,6 +237,12 @@ void enable() {
 	gpdma_channel_i2s0_tx.configure(lli_tx_loop[0], gpdma_config_tx);
 	gpdma_channel_i2s0_rx.configure(lli_rx_loop[0], gpdma_config_rx);
 
+	// The first transfer to complete (descriptor 0) gets sequence 0.
+	tx_next_lli = nullptr;
+	rx_next_lli = nullptr;
+	tx_completion.reset();
+	rx_completion.reset();
+
 	gpdma_channel_i2s0_tx.enable();
 	gpdma_channel_i2s0_rx.enable();
 }
@@ -213,26 +252,50 @@ void disable() {
 	gpdma_channel_i2s0_rx.disable();
 }
 
-buffer_t tx_empty_buffer() {
-	const auto next_lli = tx_next_lli;
-	if( next_lli ) {
-		const size_t next_index = next_lli - &lli_tx_loop[0];
-		const size_t free_index = (next_index + transfers_per_buffer - 2) & transfers_mask;
-		return { reinterpret_cast<sample_t*>(lli_tx_loop[free_index].srcaddr), transfer_samples };
-	} else {
-		return { nullptr, 0 };
-	}
+bool tx_started() {
+	return tx_next_lli != nullptr;
 }
 
-buffer_t rx_empty_buffer() {
-	const auto next_lli = rx_next_lli;
-	if( next_lli ) {
-		const size_t next_index = next_lli - &lli_rx_loop[0];
-		const size_t free_index = (next_index + transfers_per_buffer - 2) & transfers_mask;
-		return { reinterpret_cast<sample_t*>(lli_rx_loop[free_index].destaddr), transfer_samples };
-	} else {
-		return { nullptr, 0 };
-	}
+size_t tx_lead_min() {
+	// The transfer after the one in progress may already be loaded.
+	return 2;
+}
+
+size_t tx_lead_max() {
+	return transfers_per_buffer;
+}
+
+uint32_t tx_completed_sequence() {
+	return tx_completion.sequence;
+}
+
+buffer_t tx_buffer(const uint32_t sequence) {
+	chSysLock();
+	const auto index = tx_completion.index_of(sequence);
+	chSysUnlock();
+
+	return { reinterpret_cast<sample_t*>(lli_tx_loop[index].srcaddr), transfer_samples };
+}
+
+bool rx_started() {
+	return rx_next_lli != nullptr;
+}
+
+size_t rx_max_lag() {
+	// The transfer in progress and the one loaded after it are off limits.
+	return transfers_per_buffer - 2;
+}
+
+uint32_t rx_completed_sequence() {
+	return rx_completion.sequence;
+}
+
+buffer_t rx_buffer(const uint32_t sequence) {
+	chSysLock();
+	const auto index = rx_completion.index_of(sequence);
+	chSysUnlock();
+
+	return { reinterpret_cast<sample_t*>(lli_rx_loop[index].destaddr), transfer_samples };
 }
 
 } /* namespace dma */
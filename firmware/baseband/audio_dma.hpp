@@ -24,6 +24,7 @@
 #define __AUDIO_DMA_H__
 
 #include <cstdint>
+#include <cstddef>
 
 #include "buffer.hpp"
 
@@ -48,8 +49,26 @@ void configure();
 void enable();
 void disable();
 
-audio::buffer_t tx_empty_buffer();
-audio::buffer_t rx_empty_buffer();
+/* Transfers are numbered as they complete, with a free-running sequence
+ * per direction.
+ *
+ * TX: tx_buffer(sequence) can be filled for sequences tx_lead_min() to
+ * tx_lead_max() past the newest completed one. What isn't refilled in
+ * time plays again.
+ */
+bool tx_started();
+size_t tx_lead_min();
+size_t tx_lead_max();
+uint32_t tx_completed_sequence();
+audio::buffer_t tx_buffer(const uint32_t sequence);
+
+/* RX: the newest rx_max_lag() can be read in place, older ones are being
+ * filled again.
+ */
+bool rx_started();
+size_t rx_max_lag();
+uint32_t rx_completed_sequence();
+audio::buffer_t rx_buffer(const uint32_t sequence);
 
 } /* namespace dma */
 } /* namespace audio */
@@ -31,10 +31,46 @@
 #include <cstdint>
 #include <cstddef>
 #include <array>
+#include <algorithm>
+
+bool AudioInput::read(Block& block) {
+	if( !audio::dma::rx_started() ) {
+		underflows_++;
+		return false;
+	}
+
+	const auto completed = audio::dma::rx_completed_sequence();
+	if( !started ) {
+		next_sequence = completed - 1;
+		started = true;
+	}
+
+	const int32_t behind = completed - next_sequence;
+	if( behind < 0 ) {
+		underflows_++;
+		return false;
+	}
+	if( static_cast<size_t>(behind) >= audio::dma::rx_max_lag() ) {
+		// Overwritten by now, or about to be. Drop back to one behind.
+		overflows_ += behind - 1;
+		next_sequence = completed - 1;
+	}
+
+	const auto buffer = audio::dma::rx_buffer(next_sequence);
+	block = { buffer.p, buffer.count, next_sequence, next_sequence * static_cast<uint32_t>(buffer.count) };
+	next_sequence++;
+	return true;
+}
 
 void AudioInput::read_audio_buffer(buffer_s16_t& audio) {
-	auto audio_buffer = audio::dma::rx_empty_buffer();
-	
-	for (size_t i=0; i<audio_buffer.count; i++)
-		audio.p[i] = audio_buffer.p[i].right;
+	Block block;
+	if( !read(block) ) {
+		std::fill(&audio.p[0], &audio.p[audio.count], 0);
+		return;
+	}
+
+	const size_t count = std::min(block.count, audio.count);
+	for(size_t i=0; i<count; i++) {
+		audio.p[i] = block.p[i].right;
+	}
 }
@@ -24,24 +24,48 @@
 #define __AUDIO_INPUT_H__
 
 #include "dsp_types.hpp"
-
-#include "dsp_iir.hpp"
-#include "dsp_squelch.hpp"
-
-#include "stream_input.hpp"
+#include "audio_dma.hpp"
 
 #include <cstdint>
-#include <memory>
+#include <cstddef>
 
+/* Line/mic input off the I2S RX DMA ring, one transfer (block) at a time
+ * and in order. A reader more than rx_max_lag() blocks behind loses the
+ * oldest (an overflow) and one that gets ahead finds nothing (an
+ * underflow); either way it carries on in step, one block behind the DMA
+ * from the first read.
+ */
 class AudioInput {
 public:
+	struct Block {
+		const audio::sample_t* p;
+		size_t count;
+		uint32_t sequence;
+		// Index of the first sample since the DMA started, wrapping.
+		uint32_t first_sample;
+	};
+
+	/* Next block in place, valid for another rx_max_lag() blocks. False on
+	 * underflow.
+	 */
+	bool read(Block& block);
+
+	/* Right channel of the next block, silence on underflow. */
 	void read_audio_buffer(buffer_s16_t& audio);
 
-private:
-	/*static constexpr float k = 32768.0f;
-	static constexpr float ki = 1.0f / k;
+	uint32_t underflows() const {
+		return underflows_;
+	}
 
-	IIRBiquadFilter hpf { };*/
+	uint32_t overflows() const {
+		return overflows_;
+	}
+
+private:
+	bool started { false };
+	uint32_t next_sequence { 0 };
+	uint32_t underflows_ { 0 };
+	uint32_t overflows_ { 0 };
 };
 
 #endif/*__AUDIO_INPUT_H__*/
@@ -31,6 +31,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <array>
+#include <algorithm>
 
 void AudioOutput::configure(
 	const bool do_proc
@@ -43,44 +44,71 @@ void AudioOutput::configure(
 	const iir_biquad_config_t& deemph_config,
 	const float squelch_threshold
 ) {
-	hpf.configure(hpf_config);
-	deemph.configure(deemph_config);
+	filters.configure({ { hpf_config, deemph_config } });
 	squelch.set_threshold(squelch_threshold);
 }
 
-void AudioOutput::write(
-	const buffer_s16_t& audio
+void AudioOutput::configure_compressor(
+	const CompressorQ15::Config& config,
+	const uint32_t sampling_rate
 ) {
-	std::array<float, 32> audio_f;
-	for(size_t i=0; i<audio.count; i++) {
-		audio_f[i] = audio.p[i] * ki;
-	}
-	write(buffer_f32_t {
-		audio_f.data(),
-		audio.count,
-		audio.sampling_rate
-	});
+	compressor.configure(config, sampling_rate);
+	compressing = true;
 }
 
 void AudioOutput::write(
-	const buffer_f32_t& audio
+	const buffer_s16_t& audio
 ) {
 	block_buffer.feed(
 		audio,
-		[this](const buffer_f32_t& buffer) {
+		[this](const buffer_s16_t& buffer) {
 			this->on_block(buffer);
 		}
 	);
 }
 
-void AudioOutput::on_block(
+void AudioOutput::write(
 	const buffer_f32_t& audio
+) {
+	std::array<int16_t, 32> audio_int;
+	for(size_t offset=0; offset<audio.count; offset+=audio_int.size()) {
+		const size_t count = std::min(audio.count - offset, audio_int.size());
+		for(size_t i=0; i<count; i++) {
+			const int32_t sample_int = audio.p[offset + i] * k;
+			audio_int[i] = __SSAT(sample_int, 16);
+		}
+		write(buffer_s16_t {
+			audio_int.data(),
+			count,
+			audio.sampling_rate
+		});
+	}
+}
+
+void AudioOutput::write(
+	const buffer_s16_t& mid,
+	const buffer_s16_t& side
+) {
+	// Already DMA buffer sized, so block_buffer is bypassed.
+	on_block(mid, &side);
+}
+
+void AudioOutput::on_block(
+	const buffer_s16_t& audio,
+	const buffer_s16_t* const side
 ) {
 	if (do_processing) {
 		const auto audio_present_now = squelch.execute(audio);
 
-		hpf.execute_in_place(audio);
-		deemph.execute_in_place(audio);
+		// Linear, so filtering mid and side is filtering left and right.
+		if( side ) {
+			filters.execute_in_place(audio, *side);
+		} else {
+			filters.execute_in_place(audio);
+			if( compressing ) {
+				compressor.execute_in_place(audio);
+			}
+		}
 
 		audio_present_history = (audio_present_history << 1) | (audio_present_now ? 1 : 0);
 		audio_present = (audio_present_history != 0);
@@ -89,35 +117,101 @@ void AudioOutput::on_block(
 			for(size_t i=0; i<audio.count; i++) {
 				audio.p[i] = 0;
 			}
+			if( side ) {
+				for(size_t i=0; i<side->count; i++) {
+					side->p[i] = 0;
+				}
+			}
 		}
 	} else
 		audio_present = true;
 
-	fill_audio_buffer(audio, audio_present);
+	fill_audio_buffer(audio, side, audio_present);
 }
 
 bool AudioOutput::is_squelched() {
 	return !audio_present;
 }
 
-void AudioOutput::fill_audio_buffer(const buffer_f32_t& audio, const bool send_to_fifo) {
-	std::array<int16_t, 32> audio_int;
-
-	auto audio_buffer = audio::dma::tx_empty_buffer();
-	for(size_t i=0; i<audio_buffer.count; i++) {
-		const int32_t sample_int = audio.p[i] * k;
-		const int32_t sample_saturated = __SSAT(sample_int, 16);
-		audio_buffer.p[i].left = audio_buffer.p[i].right = sample_saturated;
-		audio_int[i] = sample_saturated;
+void AudioOutput::fill_audio_buffer(const buffer_s16_t& audio, const buffer_s16_t* const side, const bool send_to_fifo) {
+	if( side ) {
+		for(size_t i=0; i<audio.count; i++) {
+			const int32_t mid = audio.p[i];
+			const int32_t difference = side->p[i];
+			audio::sample_t sample;
+			sample.left = __SSAT(mid + difference, 16);
+			sample.right = __SSAT(mid - difference, 16);
+			play(sample);
+		}
+	} else {
+		for(size_t i=0; i<audio.count; i++) {
+			audio::sample_t sample;
+			sample.left = sample.right = audio.p[i];
+			play(sample);
+		}
 	}
-	if( stream && send_to_fifo ) {
-		stream->write(audio_int.data(), audio_buffer.count * sizeof(audio_int[0]));
+	if( stream && (send_to_fifo || !stream->squelch_gate()) ) {
+		stream->write(audio.p, audio.count * sizeof(audio.p[0]));
 	}
 
 	feed_audio_stats(audio);
 }
 
-void AudioOutput::feed_audio_stats(const buffer_f32_t& audio) {
+void AudioOutput::play(const audio::sample_t sample) {
+	// Output samples between the last input and this one, mu (in input
+	// samples) past the last.
+	const int32_t left_delta = sample.left - last.left;
+	const int32_t right_delta = sample.right - last.right;
+	while( mu < 1.0f ) {
+		auto& out = transfer[transfer_count];
+		out.left = last.left + static_cast<int32_t>(left_delta * mu);
+		out.right = last.right + static_cast<int32_t>(right_delta * mu);
+		mu += ratio;
+		if( ++transfer_count == transfer.size() ) {
+			play_transfer();
+			transfer_count = 0;
+		}
+	}
+	mu -= 1.0f;
+	last = sample;
+}
+
+void AudioOutput::play_transfer() {
+	if( !audio::dma::tx_started() ) {
+		return;
+	}
+
+	const auto completed = audio::dma::tx_completed_sequence();
+	if( !playing ) {
+		next_sequence = completed + lead_target;
+		playing = true;
+	}
+
+	const size_t lead = next_sequence - completed;
+	if( (lead < audio::dma::tx_lead_min()) || (lead > audio::dma::tx_lead_max()) ) {
+		next_sequence = completed + lead_target;
+		fill_error = 0.0f;
+		slips++;
+	}
+
+	const auto buffer = audio::dma::tx_buffer(next_sequence);
+	std::copy(transfer.begin(), transfer.end(), buffer.p);
+	next_sequence++;
+
+	// Samples queued ahead of the transfer just written: more than the target means
+	// audio is coming in fast, so take bigger steps through it.
+	fill = (next_sequence - 1 - completed) * transfer_samples;
+	fill_error += ((fill - fill_target) / fill_target - fill_error) * fill_alpha;
+	const float deviation = std::max(-ratio_deviation_max, std::min(ratio_deviation_max, fill_error * ratio_gain));
+	ratio = 1.0f + deviation;
+}
+
+void AudioOutput::feed_audio_stats(const buffer_s16_t& audio) {
+	audio_stats.set_playout(
+		fill,
+		slips,
+		(ratio - 1.0f) * 1e6f
+	);
 	audio_stats.feed(
 		audio,
 		[](const AudioStatistics& statistics) {
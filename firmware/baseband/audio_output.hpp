@@ -27,12 +27,16 @@
 
 #include "dsp_iir.hpp"
 #include "dsp_squelch.hpp"
+#include "audio_compressor.hpp"
 
 #include "stream_input.hpp"
 #include "block_decimator.hpp"
 #include "audio_stats_collector.hpp"
+#include "audio_dma.hpp"
 
 #include <cstdint>
+#include <cstddef>
+#include <array>
 #include <memory>
 
 class AudioOutput {
@@ -45,9 +49,17 @@ public:
 		const float squelch_threshold = 0.0f
 	);
 
+	/* Mono audio's dynamics, after the filters; off until configured. */
+	void configure_compressor(const CompressorQ15::Config& config, const uint32_t sampling_rate);
+
 	void write(const buffer_s16_t& audio);
 	void write(const buffer_f32_t& audio);
 
+	/* Stereo as mid (L+R)/2 and side (L-R)/2, one full audio DMA buffer of
+	 * each. Squelch, statistics and the stream only see mid.
+	 */
+	void write(const buffer_s16_t& mid, const buffer_s16_t& side);
+
 	void set_stream(std::unique_ptr<StreamInput> new_stream) {
 		stream = std::move(new_stream);
 	}
@@ -56,13 +68,15 @@ public:
 
 private:
 	static constexpr float k = 32768.0f;
-	static constexpr float ki = 1.0f / k;
 
-	BlockDecimator<float, 32> block_buffer { 1 };	
+	// Everything past write() is Q15, float audio is converted once here.
+	BlockDecimator<int16_t, 32> block_buffer { 1 };	
 
-	IIRBiquadFilter hpf { };
-	IIRBiquadFilter deemph { };
+	// High-pass then de-emphasis, on mid and side.
+	IIRBiquadCascadeQ15<2, 2> filters { };
 	FMSquelch squelch { };
+	CompressorQ15 compressor { };
+	bool compressing { false };
 
 	std::unique_ptr<StreamInput> stream { };
 
@@ -73,9 +87,36 @@ private:
 	bool audio_present = false;
 	bool do_processing = true;
 
-	void on_block(const buffer_f32_t& audio);
-	void fill_audio_buffer(const buffer_f32_t& audio, const bool send_to_fifo);
-	void feed_audio_stats(const buffer_f32_t& audio);
+	/* Playout: audio is linearly resampled into whole DMA transfers, written
+	 * a few transfers ahead of the codec. The ratio follows the lead
+	 * (fill), so the audio rate is locked to the codec's rather than
+	 * slipping a transfer every so often. A slip (lead out of range)
+	 * resets the lead to the target.
+	 */
+	static constexpr size_t transfer_samples = 32;
+	static constexpr size_t lead_target = 5;
+	static constexpr float fill_target = lead_target * transfer_samples;
+	// Per transfer: fill error smoothing, and ratio per unit fill error.
+	static constexpr float fill_alpha = 1.0f / 256.0f;
+	static constexpr float ratio_gain = 0.005f;
+	static constexpr float ratio_deviation_max = 0.001f;
+
+	bool playing { false };
+	uint32_t next_sequence { 0 };
+	std::array<audio::sample_t, transfer_samples> transfer { };
+	size_t transfer_count { 0 };
+	audio::sample_t last { };
+	float mu { 0.0f };
+	float ratio { 1.0f };
+	uint32_t fill { 0 };
+	float fill_error { 0.0f };
+	uint32_t slips { 0 };
+
+	void on_block(const buffer_s16_t& audio, const buffer_s16_t* const side = nullptr);
+	void fill_audio_buffer(const buffer_s16_t& audio, const buffer_s16_t* const side, const bool send_to_fifo);
+	void play(const audio::sample_t sample);
+	void play_transfer();
+	void feed_audio_stats(const buffer_s16_t& audio);
 };
 
 #endif/*__AUDIO_OUTPUT_H__*/
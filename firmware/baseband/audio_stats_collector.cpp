@@ -22,24 +22,36 @@
 #include "audio_stats_collector.hpp"
 
 #include "utility.hpp"
+#include "load_shedding.hpp"
 
-void AudioStatsCollector::consume_audio_buffer(const buffer_f32_t& src) {
+#include <algorithm>
+
+void AudioStatsCollector::consume_audio_buffer(const buffer_s16_t& src) {
+	// Integer per block, normalized to full scale once per block
+	constexpr float k = 1.0f / (32768.0f * 32768.0f);
+
+	uint64_t block_squared_sum = 0;
+	uint32_t block_max_squared = 0;
 	auto src_p = src.p;
 	const auto src_end = &src.p[src.count];
 	while(src_p < src_end) {
-		const auto sample = *(src_p++);
-		const auto sample_squared = sample * sample;
-		squared_sum += sample_squared;
-		if( sample_squared > max_squared ) {
-			max_squared = sample_squared;
+		const int32_t sample = *(src_p++);
+		const uint32_t sample_squared = sample * sample;
+		block_squared_sum += sample_squared;
+		if( sample_squared > block_max_squared ) {
+			block_max_squared = sample_squared;
 		}
 	}
+
+	squared_sum += block_squared_sum * k;
+	max_squared = std::max(max_squared, block_max_squared * k);
 }
 
 bool AudioStatsCollector::update_stats(const size_t sample_count, const size_t sampling_rate) {
 	count += sample_count;
 
-	const size_t samples_per_update = sampling_rate * update_interval;
+	// Only the audio meter reads these, so they're first to slow down.
+	const size_t samples_per_update = static_cast<size_t>(sampling_rate * update_interval) << LoadShedding::level();
 
 	if( count >= samples_per_update ) {
 		statistics.rms_db = mag2_to_dbv_norm(squared_sum / count);
@@ -56,7 +68,7 @@ bool AudioStatsCollector::update_stats(const size_t sample_count, const size_t s
 	}
 }
 
-bool AudioStatsCollector::feed(const buffer_f32_t& src) {
+bool AudioStatsCollector::feed(const buffer_s16_t& src) {
 	consume_audio_buffer(src);
 
 	return update_stats(src.count, src.sampling_rate);
@@ -31,7 +31,7 @@
 class AudioStatsCollector {
 public:
 	template<typename Callback>
-	void feed(const buffer_f32_t& src, Callback callback) {
+	void feed(const buffer_s16_t& src, Callback callback) {
 		if( feed(src) ) {
 			callback(statistics);
 		}
@@ -44,6 +44,13 @@ public:
 		}
 	}
 
+	/* Reported with the next statistics. */
+	void set_playout(const uint32_t fill, const uint32_t slips, const int32_t ratio_ppm) {
+		statistics.playout_fill = fill;
+		statistics.playout_slips = slips;
+		statistics.playout_ratio_ppm = ratio_ppm;
+	}
+
 private:
 	static constexpr float update_interval { 0.1f };
 	float squared_sum { 0 };
@@ -52,11 +59,11 @@ private:
 
 	AudioStatistics statistics { };
 
-	void consume_audio_buffer(const buffer_f32_t& src);
+	void consume_audio_buffer(const buffer_s16_t& src);
 
 	bool update_stats(const size_t sample_count, const size_t sampling_rate);
 
-	bool feed(const buffer_f32_t& src);
+	bool feed(const buffer_s16_t& src);
 	bool mute(const size_t sample_count, const size_t sampling_rate);
 };
 
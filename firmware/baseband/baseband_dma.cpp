@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <array>
+#include <algorithm>
 
 #include "hal.h"
 #include "gpdma.hpp"
@@ -32,8 +33,12 @@ using namespace lpc43xx;
 
 #include "portapack_dma.hpp"
 
+#include "gpdma_lli.hpp"
+
 #include "thread_wait.hpp"
 
+#include "portapack_shared_memory.hpp"
+
 namespace baseband {
 namespace dma {
 
@@ -86,26 +91,32 @@ constexpr gpdma::channel::Config config(const baseband::Direction direction) {
 	};
 }
 
-constexpr size_t buffer_samples_log2n = 13;
-constexpr size_t buffer_samples = (1 << buffer_samples_log2n);
-constexpr size_t transfers_per_buffer_log2n = 2;
-constexpr size_t transfers_per_buffer = (1 << transfers_per_buffer_log2n);
-constexpr size_t transfer_samples = buffer_samples / transfers_per_buffer;
-constexpr size_t transfers_mask = transfers_per_buffer - 1;
-
-constexpr size_t buffer_bytes = buffer_samples * sizeof(baseband::sample_t);
-constexpr size_t transfer_bytes = transfer_samples * sizeof(baseband::sample_t);
-
-constexpr size_t msg_count = transfers_per_buffer - 1;
-
-static std::array<gpdma::channel::LLI, transfers_per_buffer> lli_loop;
+static gpdma::lli::Chain<transfers_max * descriptors_per_transfer_max> lli_loop;
+static size_t transfers = 0;
+static size_t descriptors_per_transfer = 1;
+static size_t transfer_samples = 0;
 static constexpr auto& gpdma_channel_sgpio = gpdma::channels[portapack::sgpio_gpdma_channel_number];
 
 static ThreadWait thread_wait;
 
+static volatile uint32_t transfer_sequence = 0;
+static volatile size_t last_completed_index = 0;
+
 static void transfer_complete() {
-	const auto next_lli_index = gpdma_channel_sgpio.next_lli() - &lli_loop[0];
-	thread_wait.wake_from_interrupt(next_lli_index);
+	// Channel has already loaded the following descriptor, so the LLI
+	// register points two past the one that just completed. Advancing the
+	// sequence by the distance moved (rather than by one) keeps it in step
+	// with the hardware even if completion interrupts were coalesced.
+	// A transfer only counts as completed with its last descriptor done.
+	const auto n = lli_loop.length();
+	const auto next_index = lli_loop.index_of(gpdma_channel_sgpio.next_lli());
+	const auto completed_descriptor = (next_index + n - 2) % n;
+	const auto completed_index = ((completed_descriptor + 1) / descriptors_per_transfer + transfers - 1) % transfers;
+	const auto advance = (completed_index + transfers - last_completed_index) % transfers;
+	last_completed_index = completed_index;
+	transfer_sequence += (advance == 0) ? transfers : advance;
+	shared_memory.sample_clock.sequence = transfer_sequence;
+	thread_wait.wake_from_interrupt(0);
 }
 
 static void dma_error() {
@@ -129,22 +140,37 @@ void init() {
 
 void configure(
 	baseband::sample_t* const buffer_base,
-	const baseband::Direction direction
+	const baseband::Direction direction,
+	const size_t transfer_count,
+	const size_t transfer_samples
 ) {
+	dma::descriptors_per_transfer = (std::min(transfer_samples, transfer_samples_max) + descriptor_samples_max - 1) / descriptor_samples_max;
+	// Whole words in each descriptor.
+	const size_t granularity = descriptors_per_transfer * 4 / sizeof(baseband::sample_t);
+	dma::transfer_samples = std::min(transfer_samples, transfer_samples_max) / granularity * granularity;
+	dma::transfers = std::min(std::max(transfer_count, static_cast<size_t>(3)), transfers_max);
+	const auto descriptor_bytes = dma::transfer_samples * sizeof(baseband::sample_t) / descriptors_per_transfer;
 	const auto peripheral = reinterpret_cast<uint32_t>(&LPC_SGPIO->REG_SS[0]);
-	const auto control_value = control(direction, gpdma::buffer_words(transfer_bytes, 4));
-	for(size_t i=0; i<lli_loop.size(); i++) {
-		const auto memory = reinterpret_cast<uint32_t>(&buffer_base[i * transfer_samples]);
-		lli_loop[i].srcaddr = (direction == Direction::Transmit) ? memory : peripheral;
-		lli_loop[i].destaddr = (direction == Direction::Transmit) ? peripheral : memory;
-		lli_loop[i].lli = lli_pointer(&lli_loop[(i + 1) % lli_loop.size()]);
-		lli_loop[i].control = control_value;
-	}
+	const auto control_value = control(direction, gpdma::buffer_words(descriptor_bytes, 4));
+	lli_loop.configure(
+		gpdma::lli::ChainType::Loop,
+		transfers * descriptors_per_transfer,
+		peripheral,
+		buffer_base,
+		descriptor_bytes,
+		direction == Direction::Receive,
+		control_value,
+		descriptors_per_transfer
+	);
+
+	// First completed transfer (descriptor 0) gets sequence 0.
+	last_completed_index = transfers - 1;
+	transfer_sequence = 0xffffffff;
 }
 
 void enable(const baseband::Direction direction) {
 	const auto gpdma_config = config(direction);
-	gpdma_channel_sgpio.configure(lli_loop[0], gpdma_config);
+	gpdma_channel_sgpio.configure(lli_loop.first(), gpdma_config);
 	gpdma_channel_sgpio.enable();
 }
 
@@ -156,15 +182,47 @@ void disable() {
 	gpdma_channel_sgpio.disable();
 }
 
+size_t transfer_count() {
+	return transfers;
+}
+
+size_t samples_per_transfer() {
+	return transfer_samples;
+}
+
+size_t max_lag() {
+	// The transfer after the one in progress must not be touched either: the
+	// DMA will be writing (or reading) it before a slow consumer is done.
+	return transfers - 2;
+}
+
+uint32_t completed_sequence() {
+	return transfer_sequence;
+}
+
+bool wait_for_transfer() {
+	return thread_wait.sleep() >= 0;
+}
+
+baseband::buffer_t buffer(const uint32_t sequence) {
+	// Locate by distance from the last completed transfer, so the mapping
+	// stays right across sequence wrap-around for any ring length.
+	chSysLock();
+	const auto behind = transfer_sequence - sequence;
+	const auto completed_index = last_completed_index;
+	chSysUnlock();
+
+	const auto n = transfers;
+	const auto index = (completed_index + n - (behind % n)) % n;
+	return {
+		reinterpret_cast<sample_t*>(lli_loop.memory(index * descriptors_per_transfer)),
+		transfer_samples
+	};
+}
+
 baseband::buffer_t wait_for_buffer() {
-	const auto next_index = thread_wait.sleep();
-	
-	if( next_index >= 0 ) {
-		const size_t free_index = (next_index + transfers_per_buffer - 2) & transfers_mask;
-		const auto src = lli_loop[free_index].srcaddr;
-		const auto dst = lli_loop[free_index].destaddr;
-		const auto p = (src == reinterpret_cast<uint32_t>(&LPC_SGPIO->REG_SS[0])) ? dst : src;
-		return { reinterpret_cast<sample_t*>(p), transfer_samples };
+	if( wait_for_transfer() ) {
+		return buffer(completed_sequence());
 	} else {
 		return { };
 	}
@@ -22,6 +22,7 @@
 #ifndef __BASEBAND_DMA_H__
 #define __BASEBAND_DMA_H__
 
+#include <cstdint>
 #include <cstddef>
 #include <array>
 
@@ -31,10 +32,26 @@
 namespace baseband {
 namespace dma {
 
+/* Buffers are handed out straight from a ring of transfer_count DMA
+ * transfers of transfer_samples each. Completed transfers are numbered with
+ * a free-running sequence; the newest max_lag() completed buffers are safe
+ * to use, older ones are about to be reused by the DMA.
+ *
+ * A transfer over one descriptor's 4095 words is split evenly over two,
+ * interrupting only on the second, so larger buffers cost fewer interrupts
+ * at the top sampling rates.
+ */
+constexpr size_t transfers_max = 8;
+constexpr size_t descriptor_samples_max = 4095 * 4 / sizeof(baseband::sample_t);
+constexpr size_t descriptors_per_transfer_max = 2;
+constexpr size_t transfer_samples_max = 8192;
+
 void init();
 void configure(
 	baseband::sample_t* const buffer_base,
-	const baseband::Direction direction
+	const baseband::Direction direction,
+	const size_t transfer_count = 4,
+	const size_t transfer_samples = 2048
 );
 
 void enable(const baseband::Direction direction);
@@ -42,6 +59,18 @@ bool is_enabled();
 
 void disable();
 
+size_t transfer_count();
+size_t samples_per_transfer();
+size_t max_lag();
+
+/* Sequence number of the most recently completed transfer. */
+uint32_t completed_sequence();
+
+/* Sleeps until the next transfer completes. Returns false on DMA error. */
+bool wait_for_transfer();
+
+baseband::buffer_t buffer(const uint32_t sequence);
+
 baseband::buffer_t wait_for_buffer();
 
 } /* namespace dma */
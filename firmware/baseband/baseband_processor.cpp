@@ -25,12 +25,35 @@
 
 #include "message.hpp"
 
+volatile uint32_t BasebandProcessor::decode_count = 0;
+
+static void send_scan_dwell_result(const uint32_t sequence, const uint32_t index, const int32_t max_db, const bool busy) {
+	const ScanDwellResultMessage message { sequence, index, max_db, busy };
+	shared_memory.application_queue.push(message);
+}
+
 void BasebandProcessor::feed_channel_stats(const buffer_c16_t& channel) {
+	// One pass over the channel for both
+	const auto power = ChannelStatsCollector::block_power(channel);
 	channel_stats.feed(
-		channel,
+		power, channel.sampling_rate,
 		[](const ChannelStatistics& statistics) {
 			const ChannelStatisticsMessage channel_stats_message { statistics };
 			shared_memory.application_queue.push(channel_stats_message);
 		}
 	);
+
+	scan_dwell.feed(power, send_scan_dwell_result);
+}
+
+void BasebandProcessor::set_coded_squelch(const CodedSquelch& coded_squelch) {
+	channel_stats.set_coded_squelch(coded_squelch);
+}
+
+void BasebandProcessor::feed_scan_dwell_audio(const buffer_s16_t& audio) {
+	scan_dwell.feed_audio(audio, send_scan_dwell_result);
+}
+
+void BasebandProcessor::configure_scan_dwell(const ScanDwellConfigMessage& message) {
+	scan_dwell.configure(message);
 }
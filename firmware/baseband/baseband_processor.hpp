@@ -25,6 +25,7 @@
 #include "dsp_types.hpp"
 
 #include "channel_stats_collector.hpp"
+#include "scan_dwell_collector.hpp"
 
 #include "message.hpp"
 
@@ -34,13 +35,50 @@ public:
 
 	virtual void execute(const buffer_c8_t& buffer) = 0;
 
+	/* Receive processors that need to look past the end of a buffer (e.g. a
+	 * preamble straddling a buffer boundary) return true from
+	 * needs_lookahead(), and get execute_lookahead() with the following,
+	 * already complete, DMA buffer instead of execute(). No samples are
+	 * copied, but delivery lags the DMA by one buffer.
+	 */
+	virtual bool needs_lookahead() const { return false; }
+
+	virtual void execute_lookahead(const buffer_c8_t& buffer, const buffer_c8_t&) {
+		execute(buffer);
+	}
+
+	/* Called with each buffer ahead of execute(). Receive processors that
+	 * want the DC offset and IQ imbalance taken out hold an
+	 * IQCorrectionStage and run it from here; the default leaves the
+	 * corrector out of the images of processors that don't.
+	 */
+	virtual void correct_iq(const buffer_c8_t&) { }
+
 	virtual void on_message(const Message* const) { };
 
+	/* Called wherever a decoder passes a packet on to the application, for
+	 * ProcessorStatistics. Wraps around; the baseband thread reports the
+	 * difference.
+	 */
+	static void count_decode() {
+		decode_count = decode_count + 1;
+	}
+
+	static uint32_t decodes() {
+		return decode_count;
+	}
+
 protected:
 	void feed_channel_stats(const buffer_c16_t& channel);
+	void feed_scan_dwell_audio(const buffer_s16_t& audio);
+	void configure_scan_dwell(const ScanDwellConfigMessage& message);
+	void set_coded_squelch(const CodedSquelch& coded_squelch);
 
 private:
+	static volatile uint32_t decode_count;
+
 	ChannelStatsCollector channel_stats { };
+	ScanDwellCollector scan_dwell { };
 };
 
 #endif/*__BASEBAND_PROCESSOR_H__*/
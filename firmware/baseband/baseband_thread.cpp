@@ -31,73 +31,436 @@
 #include "i2s.hpp"
 using namespace lpc43xx;
 
+#include "sample_generator.hpp"
+#include "rx_gain_control.hpp"
+#include "cycle_counter.hpp"
+#include "load_shedding.hpp"
+
 #include "portapack_shared_memory.hpp"
+#include "trace.hpp"
+#include "hackrf_hal.hpp"
 
 #include "utility.hpp"
 
 #include <array>
+#include <algorithm>
+#include <utility>
 
 static baseband::SGPIO baseband_sgpio;
 
 WORKING_AREA(baseband_thread_wa, 4096);
 
+// Held by the thread while it runs the processor, so detaching one waits
+// for the buffer in progress.
+static MUTEX_DECL(processor_mutex);
+
+static SampleGenerator generator;
+
+// Ahead of whichever processor runs, for the radio only.
+static RxGainControl gain_control;
+
+// Free running: every sample streamed or pulled so far, by any thread.
+static uint64_t sample_count = 0;
+
+static void publish_sample_clock(const uint64_t base, const uint32_t transfer_samples, const uint32_t sampling_rate) {
+	auto& clock = shared_memory.sample_clock;
+	clock.generation = clock.generation + 1;
+	__DMB();
+	clock.base = base;
+	clock.transfer_samples = transfer_samples;
+	clock.sampling_rate = sampling_rate;
+	__DMB();
+	clock.generation = clock.generation + 1;
+}
+
+// What ProcessorStatistics counts from, reset as the thread starts.
+static CycleCounter cycles;
+static uint32_t report_buffers = 0;
+static uint32_t decodes_start = 0;
+
 Thread* BasebandThread::thread = nullptr;
+BasebandThread* BasebandThread::owner = nullptr;
+tprio_t BasebandThread::priority = NORMALPRIO;
+
+BasebandThread::Settings BasebandThread::running { };
+BasebandProcessor* BasebandThread::baseband_processor = nullptr;
+uint32_t BasebandThread::sampling_rate = 0;
+volatile uint32_t BasebandThread::overrun_count = 0;
+
+BasebandThread::Source BasebandThread::source = BasebandThread::Source::Radio;
+std::unique_ptr<StreamOutput> BasebandThread::file_source { };
+ReplayConfig::Format BasebandThread::file_format { ReplayConfig::Format::C8 };
+
+bool BasebandThread::handover = false;
+BasebandProcessor* BasebandThread::adopter = nullptr;
+uint32_t BasebandThread::adopter_sampling_rate = 0;
 
 BasebandThread::BasebandThread(
 	uint32_t sampling_rate,
 	BasebandProcessor* const baseband_processor,
 	const tprio_t priority,
-	baseband::Direction direction
-) : baseband_processor { baseband_processor },
-	_direction { direction },
-	sampling_rate { sampling_rate }
+	baseband::Direction direction,
+	const size_t buffer_count,
+	const size_t buffer_samples
+) : _direction { direction }
 {
-	thread = chThdCreateStatic(baseband_thread_wa, sizeof(baseband_thread_wa),
-		priority, ThreadBase::fn,
-		this
-	);
+	const Settings settings {
+		direction,
+		buffer_count,
+		buffer_samples,
+		baseband_processor
+			&& (direction == baseband::Direction::Receive)
+			&& baseband_processor->needs_lookahead()
+	};
+
+	owner = this;
+
+	if( handover && thread && (settings == running) ) {
+		adopter = baseband_processor;
+		adopter_sampling_rate = sampling_rate;
+		return;
+	}
+
+	stop();
+	source = Source::Radio;
+	file_source.reset();
+
+	running = settings;
+	BasebandThread::baseband_processor = baseband_processor;
+	BasebandThread::sampling_rate = sampling_rate;
+	BasebandThread::priority = priority;
+	overrun_count = 0;
+
+	start();
 }
 
 BasebandThread::~BasebandThread() {
-	chThdTerminate(thread);
-	chThdWait(thread);
-	thread = nullptr;
+	if( !handover ) {
+		stop();
+		source = Source::Radio;
+		file_source.reset();
+	}
+	if( owner == this ) {
+		owner = nullptr;
+	}
 }
 
 void BasebandThread::set_sampling_rate(uint32_t new_sampling_rate) {
 	sampling_rate = new_sampling_rate;
 }
 
+void BasebandThread::begin_handover() {
+	attach(nullptr, sampling_rate);
+	adopter = nullptr;
+	handover = true;
+}
+
+void BasebandThread::end_handover() {
+	handover = false;
+
+	if( adopter ) {
+		attach(adopter, adopter_sampling_rate);
+		adopter = nullptr;
+	} else if( !baseband_processor ) {
+		stop();
+	}
+}
+
+void BasebandThread::attach(BasebandProcessor* const processor, const uint32_t new_sampling_rate) {
+	chMtxLock(&processor_mutex);
+	baseband_processor = processor;
+	sampling_rate = new_sampling_rate;
+	reset_shedding();
+	const auto& clock = shared_memory.sample_clock;
+	if( clock.sampling_rate && (clock.sampling_rate != sampling_rate) ) {
+		publish_sample_clock(clock.base, clock.transfer_samples, sampling_rate);
+	}
+	chMtxUnlock();
+}
+
+void BasebandThread::set_file_source(ReplayConfig* const config) {
+	if( !owner || (running.direction != baseband::Direction::Receive) ) {
+		return;
+	}
+
+	stop();
+	source = Source::Radio;
+	file_source.reset();
+	if( config ) {
+		// Before returning: the application's ReplayThread looks for the FIFOs next.
+		file_source = std::make_unique<StreamOutput>(config);
+		file_format = config->format;
+		source = Source::File;
+	}
+	start();
+}
+
+void BasebandThread::set_synthetic_source(const SyntheticSourceConfig* const config) {
+	if( !owner || (running.direction != baseband::Direction::Receive) ) {
+		return;
+	}
+
+	stop();
+	source = Source::Radio;
+	file_source.reset();
+	if( config ) {
+		generator.configure(*config, sampling_rate);
+		source = Source::Synthetic;
+	}
+	start();
+}
+
+void BasebandThread::set_gain_control(const RxGainControlMessage& message) {
+	chMtxLock(&processor_mutex);
+	gain_control.configure(message);
+	chMtxUnlock();
+}
+
+void BasebandThread::start() {
+	CycleCounter::enable();
+	cycles.reset();
+	report_buffers = 0;
+	decodes_start = BasebandProcessor::decodes();
+	reset_shedding();
+
+	// Flat out would starve the event loop otherwise.
+	thread = chThdCreateStatic(baseband_thread_wa, sizeof(baseband_thread_wa),
+		(source != Source::Radio) ? (NORMALPRIO - 1) : priority, ThreadBase::fn,
+		owner
+	);
+}
+
+void BasebandThread::stop() {
+	if( thread ) {
+		chThdTerminate(thread);
+		chThdWait(thread);
+		thread = nullptr;
+		reset_shedding();
+	}
+}
+
 void BasebandThread::run() {
+	chRegSetThreadName("baseband");
+
+	if( source != Source::Radio ) {
+		run_pull();
+		return;
+	}
+
 	baseband_sgpio.init();
 	baseband::dma::init();
 
-	const auto baseband_buffer = std::make_unique<std::array<baseband::sample_t, 8192>>();
+	const bool lookahead = running.lookahead;
+
+	// Lookahead holds two buffers, which needs at least four in the ring.
+	const size_t count = lookahead ? std::max(running.buffer_count, static_cast<size_t>(4)) : running.buffer_count;
+	const auto baseband_buffer = std::make_unique<baseband::sample_t[]>(count * running.buffer_samples);
 	baseband::dma::configure(
-		baseband_buffer->data(),
-		direction()
+		baseband_buffer.get(),
+		running.direction,
+		count,
+		running.buffer_samples
 	);
-	//baseband::dma::allocate(4, 2048);
 
-	baseband_sgpio.configure(direction());
-	baseband::dma::enable(direction());
+	const uint32_t max_lag = baseband::dma::max_lag();
+	const uint32_t min_available = lookahead ? 2 : 1;
+
+	const size_t transfer_samples = baseband::dma::samples_per_transfer();
+	shared_memory.sample_clock.sequence = baseband::dma::completed_sequence();
+	if( running.direction == baseband::Direction::Receive ) {
+		publish_sample_clock(sample_count, transfer_samples, sampling_rate);
+	}
+
+	baseband_sgpio.configure(running.direction);
+	baseband::dma::enable(running.direction);
 	baseband_sgpio.streaming_enable();
 
+	uint32_t next_sequence = 0;
+
 	while( !chThdShouldTerminate() ) {
-		// TODO: Place correct sampling rate into buffer returned here:
-		const auto buffer_tmp = baseband::dma::wait_for_buffer();
-		if( buffer_tmp ) {
+		if( !baseband::dma::wait_for_transfer() ) {
+			continue;
+		}
+
+		// Work through every completed buffer still safe to touch, so short
+		// stalls are absorbed by the ring instead of dropping samples.
+		while( true ) {
+			const uint32_t available = baseband::dma::completed_sequence() - next_sequence + 1;
+			if( available < min_available ) {
+				break;
+			}
+			if( available > max_lag ) {
+				const uint32_t dropped = available - max_lag;
+				overrun_count += dropped;
+				next_sequence += dropped;
+				TRACE_INSTANT(Overrun, dropped);
+			}
+
+			chMtxLock(&processor_mutex);
+
+			// TODO: Place correct sampling rate into buffer returned here:
+			const auto buffer_tmp = baseband::dma::buffer(next_sequence);
 			buffer_c8_t buffer {
-				buffer_tmp.p, buffer_tmp.count, sampling_rate
+				buffer_tmp.p, buffer_tmp.count, sampling_rate, { },
+				sample_count + static_cast<uint64_t>(next_sequence) * transfer_samples
 			};
 
-			if( baseband_processor ) {
-				baseband_processor->execute(buffer);
+			if( lookahead ) {
+				const auto next_tmp = baseband::dma::buffer(next_sequence + 1);
+				const buffer_c8_t next {
+					next_tmp.p, next_tmp.count, sampling_rate, { },
+					buffer.sample_index + transfer_samples
+				};
+				execute(buffer, next);
+			} else {
+				execute(buffer, buffer);
 			}
+
+			chMtxUnlock();
+
+			next_sequence++;
 		}
 	}
 
 	i2s::i2s0::tx_mute();
 	baseband::dma::disable();
 	baseband_sgpio.streaming_disable();
+
+	sample_count += static_cast<uint64_t>(baseband::dma::completed_sequence() + 1) * transfer_samples;
+	publish_sample_clock(sample_count, 0, 0);
+}
+
+void BasebandThread::execute(const buffer_c8_t& buffer, const buffer_c8_t& next) {
+	// With processor_mutex held.
+	if( !baseband_processor ) {
+		return;
+	}
+
+	TRACE_SCOPE(Baseband, static_cast<uint32_t>(buffer.sample_index));
+	cycles.start();
+	baseband_processor->correct_iq(buffer);
+	if( source == Source::Radio ) {
+		gain_control.execute(buffer);
+	}
+	if( running.lookahead ) {
+		baseband_processor->execute_lookahead(buffer, next);
+	} else {
+		baseband_processor->execute(buffer);
+	}
+	const auto cycles_used = cycles.stop();
+
+	// Reading a file or generator runs flat out, there's no period to keep up with.
+	if( (source == Source::Radio) && LoadShedding::update(cycles_used, cycles_budget()) ) {
+		report_shedding();
+	}
+
+	if( ++report_buffers >= std::max(sampling_rate / buffer.count, static_cast<size_t>(1)) ) {
+		report(false);
+	}
+}
+
+void BasebandThread::report(const bool ended) {
+	ProcessorStatistics statistics;
+	statistics.buffers = cycles.samples();
+	statistics.cycles_average = cycles.average();
+	statistics.cycles_max = cycles.max();
+	statistics.cycles_budget = cycles_budget();
+	statistics.overruns = overrun_count;
+	statistics.decodes = BasebandProcessor::decodes() - decodes_start;
+	statistics.packets = (source == Source::Synthetic) ? generator.packets() : 0;
+	statistics.ended = ended;
+
+	const ProcessorStatisticsMessage message { statistics };
+	shared_memory.application_queue.push(message);
+
+	report_buffers = 0;
+}
+
+uint32_t BasebandThread::cycles_budget() {
+	return sampling_rate
+		? (static_cast<uint64_t>(running.buffer_samples) * hackrf::one::base_m4_clk_f) / sampling_rate
+		: 0;
+}
+
+void BasebandThread::reset_shedding() {
+	if( LoadShedding::reset() ) {
+		report_shedding();
+	}
+}
+
+void BasebandThread::report_shedding() {
+	const LoadSheddingMessage message { LoadShedding::level(), LoadShedding::load_percent() };
+	shared_memory.application_queue.push(message);
+}
+
+void BasebandThread::run_pull() {
+	const size_t samples = running.buffer_samples;
+	const auto storage = std::make_unique<complex8_t[]>(running.lookahead ? (samples * 2) : samples);
+	complex8_t* current = storage.get();
+	complex8_t* next = running.lookahead ? &storage[samples] : current;
+
+	// With lookahead, a buffer waits for the one after it.
+	bool primed = !running.lookahead;
+	while( !chThdShouldTerminate() && pull(next) ) {
+		if( !primed ) {
+			std::swap(current, next);
+			primed = true;
+			continue;
+		}
+
+		chMtxLock(&processor_mutex);
+		if( running.lookahead ) {
+			execute({ current, samples, sampling_rate, { }, sample_count - samples }, { next, samples, sampling_rate, { }, sample_count });
+		} else {
+			execute({ next, samples, sampling_rate, { }, sample_count }, { next, samples, sampling_rate, { }, sample_count });
+		}
+		chMtxUnlock();
+		sample_count += samples;
+
+		std::swap(current, next);
+	}
+
+	if( !chThdShouldTerminate() ) {
+		chMtxLock(&processor_mutex);
+		report(true);
+		chMtxUnlock();
+	}
+}
+
+bool BasebandThread::pull(complex8_t* const dst) {
+	if( source == Source::Synthetic ) {
+		return generator.execute({ dst, running.buffer_samples, sampling_rate });
+	}
+	return read_file(dst);
+}
+
+bool BasebandThread::read_file(complex8_t* const dst) {
+	// False at the end of the stream; a short last buffer isn't worth decoding.
+	const size_t sample_size = (file_format == ReplayConfig::Format::C8) ? sizeof(complex8_t) : sizeof(complex16_t);
+	std::array<complex16_t, 128> wide;
+
+	size_t count = 0;
+	while( count < running.buffer_samples ) {
+		const size_t wanted = (file_format == ReplayConfig::Format::C8)
+			? (running.buffer_samples - count)
+			: std::min(wide.size(), running.buffer_samples - count);
+		void* const p = (file_format == ReplayConfig::Format::C8) ? static_cast<void*>(&dst[count]) : static_cast<void*>(wide.data());
+		const size_t got = file_source->read_some(p, wanted * sample_size) / sample_size;
+
+		if( file_format == ReplayConfig::Format::C16 ) {
+			for(size_t i=0; i<got; i++) {
+				dst[count + i] = { static_cast<int8_t>(wide[i].real() >> 8), static_cast<int8_t>(wide[i].imag() >> 8) };
+			}
+		}
+		count += got;
+
+		if( got < wanted ) {
+			if( file_source->end_of_stream() || chThdShouldTerminate() ) {
+				return false;
+			}
+			// The application's reads are behind.
+			chThdSleep(1);
+		}
+	}
+	return true;
 }
@@ -25,16 +25,21 @@
 #include "thread_base.hpp"
 #include "message.hpp"
 #include "baseband_processor.hpp"
+#include "stream_output.hpp"
 
 #include <ch.h>
 
+#include <memory>
+
 class BasebandThread : public ThreadBase {
 public:
 	BasebandThread(
 		uint32_t sampling_rate,
 		BasebandProcessor* const baseband_processor,
 		const tprio_t priority,
-		const baseband::Direction direction = baseband::Direction::Receive
+		const baseband::Direction direction = baseband::Direction::Receive,
+		const size_t buffer_count = 4,
+		const size_t buffer_samples = 2048
 	);
 	~BasebandThread();
 
@@ -51,14 +56,99 @@ public:
 	
 	void set_sampling_rate(uint32_t new_sampling_rate);
 
+	// Buffers dropped because the processor fell too far behind the DMA.
+	uint32_t overruns() const {
+		return overrun_count;
+	}
+
+	/* Warm swap of the processor within one image. begin_handover() detaches
+	 * the current processor, which may then be destroyed without stopping
+	 * DMA or SGPIO. A BasebandThread constructed with the same direction and
+	 * buffering meanwhile adopts the running thread, and gets its processor
+	 * attached by end_handover(), once fully constructed. Any other one
+	 * restarts streaming as usual; if no processor adopted the thread,
+	 * end_handover() stops it.
+	 */
+	static void begin_handover();
+	static void end_handover();
+
+	/* Offline decoding: a receive thread's buffers come from config's
+	 * stream (see FileSourceConfigMessage) in place of the radio, at
+	 * whatever rate the processor gets through them, from a thread below
+	 * the event loop so messages still get in. nullptr, or a new thread
+	 * that doesn't adopt this one, goes back to the radio. When the stream
+	 * ends, the thread stops until the next call.
+	 */
+	static void set_file_source(ReplayConfig* const config);
+
+	/* The same, from a SampleGenerator made from a copy of config, for
+	 * benchmarks on repeatable input. Its stream ends after config's
+	 * seconds, if any.
+	 */
+	static void set_synthetic_source(const SyntheticSourceConfig* const config);
+
+	/* RxGainControl on the radio's buffers, each adjusted before the
+	 * processor gets it. Lookahead sees the next buffer unadjusted.
+	 */
+	static void set_gain_control(const RxGainControlMessage& message);
+
 private:
+	enum class Source {
+		Radio,
+		File,
+		Synthetic,
+	};
+
+	struct Settings {
+		baseband::Direction direction;
+		size_t buffer_count;
+		size_t buffer_samples;
+		bool lookahead;
+
+		bool operator==(const Settings& other) const {
+			return (direction == other.direction)
+				&& (buffer_count == other.buffer_count)
+				&& (buffer_samples == other.buffer_samples)
+				&& (lookahead == other.lookahead);
+		}
+	};
+
 	static Thread* thread;
+	static BasebandThread* owner;
+	static tprio_t priority;
+
+	/* The thread outlives its owner across a handover, so everything it
+	 * touches once streaming is static.
+	 */
+	static Settings running;
+	static BasebandProcessor* baseband_processor;
+	static uint32_t sampling_rate;
+	static volatile uint32_t overrun_count;
+
+	static Source source;
+	static std::unique_ptr<StreamOutput> file_source;
+	static ReplayConfig::Format file_format;
+
+	static bool handover;
+	static BasebandProcessor* adopter;
+	static uint32_t adopter_sampling_rate;
 
-	BasebandProcessor* baseband_processor { nullptr };
 	baseband::Direction _direction { baseband::Direction::Receive };
-	uint32_t sampling_rate { 0 };
+
+	static void attach(BasebandProcessor* const processor, const uint32_t new_sampling_rate);
+	static void start();
+	static void stop();
+
+	static void execute(const buffer_c8_t& buffer, const buffer_c8_t& next);
+	static void report(const bool ended);
+	static uint32_t cycles_budget();
+	static void reset_shedding();
+	static void report_shedding();
 
 	void run() override;
+	void run_pull();
+	bool pull(complex8_t* const dst);
+	bool read_file(complex8_t* const dst);
 };
 
 #endif/*__BASEBAND_THREAD_H__*/
@@ -33,7 +33,7 @@ buffer_c16_t ChannelDecimator::execute_decimation(const buffer_c8_t& buffer) {
 	};
 
 	/* 3.072MHz complex<int8_t>[2048], [-128, 127]
-	 * -> Shift by -fs/4
+	 * -> Shift by -fs/4, or by the NCO offset
 	 * -> 3rd order CIC: -0.1dB @ 0.028fs, -1dB @ 0.088fs, -60dB @ 0.468fs
 	 *                   -0.1dB @ 86kHz,   -1dB @ 270kHz,  -60dB @ 1.44MHz
 	 * -> gain of 256
@@ -83,7 +83,9 @@ buffer_c16_t ChannelDecimator::execute_stage_0(
 	const buffer_c8_t& buffer,
 	const buffer_c16_t& work_baseband_buffer
 ) {
-	if( fs_over_4_downconvert ) {
+	if( nco_downconvert ) {
+		return nco.execute(buffer, work_baseband_buffer);
+	} else if( fs_over_4_downconvert ) {
 		return translate.execute(buffer, work_baseband_buffer);
 	} else {
 		return cic_0.execute(buffer, work_baseband_buffer);
@@ -51,6 +51,14 @@ public:
 		decimation_factor = f;
 	}
 
+	/* Brings offset_hz, anywhere in the input span, to 0Hz in the first
+	 * stage instead of the fixed FS/4 shift. Can be called while running.
+	 */
+	void set_offset(const int32_t offset_hz, const uint32_t sampling_rate) {
+		nco.configure(offset_hz, sampling_rate);
+		nco_downconvert = true;
+	}
+
 	buffer_c16_t execute(const buffer_c8_t& buffer) {
 		auto decimated = execute_decimation(buffer);
 
@@ -62,6 +70,7 @@ private:
 
 	dsp::decimate::TranslateByFSOver4AndDecimateBy2CIC3 translate { };
 	dsp::decimate::Complex8DecimateBy2CIC3 cic_0 { };
+	dsp::decimate::NCOTranslateAndDecimateBy2CIC3 nco { };
 	dsp::decimate::DecimateBy2CIC3 cic_1 { };
 	dsp::decimate::DecimateBy2CIC3 cic_2 { };
 	dsp::decimate::DecimateBy2CIC3 cic_3 { };
@@ -69,6 +78,7 @@ private:
 
 	DecimationFactor decimation_factor { DecimationFactor::By32 };
 	const bool fs_over_4_downconvert { true };
+	bool nco_downconvert { false };
 
 	buffer_c16_t execute_decimation(const buffer_c8_t& buffer);
 
@@ -28,39 +28,120 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <algorithm>
 
 #include <hal.h>
 
+/* Peak and mean power of the channel, every update_interval. The SNR is
+ * the mean over a noise floor that follows each lower mean down at once
+ * and creeps back up half a dB an update, so it settles on the
+ * quietest recent update: a carrier's height over the channel's noise
+ * after a gap, or over the band's quieter channels while scanning.
+ */
 class ChannelStatsCollector {
 public:
+	/* |sample|^2 over a block. */
+	struct BlockPower {
+		uint32_t max_squared;
+		uint64_t sum_squared;
+		size_t count;
+	};
+
 	template<typename Callback>
 	void feed(const buffer_c16_t& src, Callback callback) {
-		auto src_p = src.p;
-		while(src_p < &src.p[src.count]) {
-			const uint32_t sample = *__SIMD32(src_p)++;
-			const uint32_t mag_sq = __SMUAD(sample, sample);
-			if( mag_sq > max_squared ) {
-				max_squared = mag_sq;
-			}
-		}
-		count += src.count;
+		feed(block_power(src), src.sampling_rate, callback);
+	}
 
-		const size_t samples_per_update = src.sampling_rate * update_interval;
+	/* For a block_power() the caller shares, e.g. with ScanDwellCollector. */
+	template<typename Callback>
+	void feed(const BlockPower& power, const uint32_t sampling_rate, Callback callback) {
+		max_squared = std::max(max_squared, power.max_squared);
+		sum_squared += power.sum_squared;
+		count += power.count;
+
+		const size_t samples_per_update = sampling_rate * update_interval;
 
 		if( count >= samples_per_update ) {
-			const float max_squared_f = max_squared;
-			const int32_t max_db = mag2_to_dbv_norm(max_squared_f * (1.0f / (32768.0f * 32768.0f)));
-			callback({ max_db, count });
+			const auto average_db_q8 = mag2_to_db_q8(static_cast<uint32_t>(sum_squared / count), 30);
+			if( (average_db_q8 < noise_floor_db_q8) || (noise_floor_db_q8 == noise_floor_unset) ) {
+				noise_floor_db_q8 = average_db_q8;
+			} else {
+				noise_floor_db_q8 += floor_rise_db_q8;
+			}
+			const auto snr_db = std::max(0, average_db_q8 - noise_floor_db_q8) / 256;
+
+			callback({ peak_db(max_squared), count, coded_squelch, average_db_q8 / 256, snr_db });
 
 			max_squared = 0;
+			sum_squared = 0;
 			count = 0;
 		}
 	}
 
+	/* Two samples an iteration: SMUAD for each |sample|^2, SMLALD adding
+	 * them to the 64 bit sum. A full scale sample's 2^31 wraps SMUAD's
+	 * signed result, but is right as unsigned.
+	 */
+	static BlockPower block_power(const buffer_c16_t& src) {
+		uint32_t max_squared = 0;
+		uint64_t sum_squared = 0;
+		auto src_p = reinterpret_cast<const uint32_t*>(src.p);
+		const auto src_end = src_p + src.count;
+		const auto pairs_end = src_p + (src.count & ~1U);
+		while(src_p < pairs_end) {
+			const uint32_t sample_0 = *(src_p++);
+			const uint32_t sample_1 = *(src_p++);
+			const uint32_t mag_sq_0 = __SMUAD(sample_0, sample_0);
+			const uint32_t mag_sq_1 = __SMUAD(sample_1, sample_1);
+			sum_squared = __SMLALD(sample_0, sample_0, sum_squared);
+			sum_squared = __SMLALD(sample_1, sample_1, sum_squared);
+			max_squared = std::max(max_squared, std::max(mag_sq_0, mag_sq_1));
+		}
+		if( src_p < src_end ) {
+			const uint32_t sample = *src_p;
+			const uint32_t mag_sq = __SMUAD(sample, sample);
+			sum_squared += mag_sq;
+			max_squared = std::max(max_squared, mag_sq);
+		}
+		return { max_squared, sum_squared, src.count };
+	}
+
+	/* Largest |sample|^2 in src, or max_squared if that's larger. */
+	static uint32_t peak_squared(const buffer_c16_t& src, uint32_t max_squared) {
+		auto src_p = reinterpret_cast<const uint32_t*>(src.p);
+		const auto src_end = src_p + src.count;
+		const auto pairs_end = src_p + (src.count & ~1U);
+		while(src_p < pairs_end) {
+			const uint32_t sample_0 = *(src_p++);
+			const uint32_t sample_1 = *(src_p++);
+			max_squared = std::max(max_squared, std::max<uint32_t>(__SMUAD(sample_0, sample_0), __SMUAD(sample_1, sample_1)));
+		}
+		if( src_p < src_end ) {
+			const uint32_t sample = *src_p;
+			max_squared = std::max<uint32_t>(max_squared, __SMUAD(sample, sample));
+		}
+		return max_squared;
+	}
+
+	/* Carried in every update from here on, for processors that decode it. */
+	void set_coded_squelch(const CodedSquelch& new_value) {
+		coded_squelch = new_value;
+	}
+
+	static int32_t peak_db(const uint32_t max_squared) {
+		return mag2_to_db_q8(max_squared, 30) / 256;
+	}
+
 private:
 	static constexpr float update_interval { 0.1f };
+	static constexpr int32_t noise_floor_unset { INT32_MIN };
+	static constexpr int32_t floor_rise_db_q8 { 128 };
+
 	uint32_t max_squared { 0 };
+	uint64_t sum_squared { 0 };
+	int32_t noise_floor_db_q8 { noise_floor_unset };
 	size_t count { 0 };
+	CodedSquelch coded_squelch { };
 };
 
 #endif/*__CHANNEL_STATS_COLLECTOR_H__*/
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "channelizer.hpp"
+
+#include <cmath>
+
+void FrequencyShift::configure(const int32_t offset_hz, const uint32_t sampling_rate) {
+	const float angle = -2.0f * pi * offset_hz / sampling_rate;
+	step = { std::cos(angle), std::sin(angle) };
+	phasor = { 1.0f, 0.0f };
+}
+
+buffer_c16_t FrequencyShift::execute(
+	const buffer_c16_t& src,
+	const buffer_c16_t& dst
+) {
+	auto p = phasor;
+	for(size_t i=0; i<src.count; i++) {
+		const std::complex<float> in { static_cast<float>(src.p[i].real()), static_cast<float>(src.p[i].imag()) };
+		const auto out = in * p;
+		dst.p[i] = { static_cast<int16_t>(out.real()), static_cast<int16_t>(out.imag()) };
+		p *= step;
+	}
+	phasor = p / std::abs(p);
+
+	return { dst.p, src.count, src.sampling_rate, src.timestamp };
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CHANNELIZER_H__
+#define __CHANNELIZER_H__
+
+#include "buffer.hpp"
+#include "complex.hpp"
+
+#include "dsp_decimate.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Complex mixer moving a channel at offset_hz down to 0 Hz. The phasor is
+ * renormalized once per buffer, so it doesn't drift over long runs.
+ */
+class FrequencyShift {
+public:
+	void configure(const int32_t offset_hz, const uint32_t sampling_rate);
+
+	buffer_c16_t execute(
+		const buffer_c16_t& src,
+		const buffer_c16_t& dst
+	);
+
+private:
+	std::complex<float> phasor { 1.0f, 0.0f };
+	std::complex<float> step { 1.0f, 0.0f };
+};
+
+/* Front end for several narrowband decoders sharing one baseband stream.
+ * The full rate input goes through the FS/4 shift and first decimate-by-8
+ * (the one expensive stage) once; each of the K channels then gets its own
+ * frequency shift and second decimation (by 8 unless Decim1 says otherwise)
+ * from that shared output.
+ */
+template<size_t K, typename Decim1 = dsp::decimate::FIRC16xR16x32Decim8>
+class Channelizer {
+public:
+	using decim_0_taps_t = std::array<dsp::decimate::FIRC8xR16x24FS4Decim8::tap_t, dsp::decimate::FIRC8xR16x24FS4Decim8::taps_count>;
+	using decim_1_taps_t = std::array<typename Decim1::tap_t, Decim1::taps_count>;
+
+	/* Offsets are from the FS/4-shifted center, at the decim_0 output rate.
+	 * Only the first active_count channels are computed.
+	 */
+	void configure(
+		const decim_0_taps_t& decim_0_taps, const int32_t decim_0_scale,
+		const decim_1_taps_t& decim_1_taps, const int32_t decim_1_scale,
+		const std::array<int32_t, K>& offsets_hz,
+		const uint32_t sampling_rate,
+		const size_t active_count = K
+	) {
+		active = (active_count < K) ? active_count : K;
+		decim_0.configure(decim_0_taps, decim_0_scale);
+		for(size_t i=0; i<K; i++) {
+			channels[i].shift.configure(offsets_hz[i], sampling_rate / decim_0.decimation_factor);
+			channels[i].decim_1.configure(decim_1_taps, decim_1_scale);
+		}
+	}
+
+	/* Calls consume(channel index, channel samples) once per active channel. The
+	 * channel buffer is only valid during the call.
+	 */
+	template<typename F>
+	void execute(const buffer_c8_t& buffer, F consume) {
+		const auto shared_out = decim_0.execute(buffer, shared_buffer);
+		for(size_t i=0; i<active; i++) {
+			auto& channel = channels[i];
+			const auto shifted = channel.shift.execute(shared_out, work_buffer);
+			const auto channel_out = channel.decim_1.execute(shifted, work_buffer);
+			consume(i, channel_out);
+		}
+	}
+
+private:
+	struct Channel {
+		FrequencyShift shift { };
+		Decim1 decim_1 { };
+	};
+
+	dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0 { };
+	std::array<Channel, K> channels { };
+	size_t active { K };
+
+	std::array<complex16_t, 256> shared { };
+	const buffer_c16_t shared_buffer {
+		shared.data(),
+		shared.size()
+	};
+	std::array<complex16_t, 256> work { };
+	const buffer_c16_t work_buffer {
+		work.data(),
+		work.size()
+	};
+};
+
+#endif/*__CHANNELIZER_H__*/
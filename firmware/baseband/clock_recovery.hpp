@@ -23,10 +23,12 @@
 #define __CLOCK_RECOVERY_H__
 
 #include <cstddef>
+#include <cstdint>
 #include <array>
 #include <functional>
 
 #include "linear_resampler.hpp"
+#include "dsp_types.hpp"
 
 namespace clock_recovery {
 
@@ -113,12 +115,33 @@ private:
 	float weight_ { 1.0f / 16.0f };
 };
 
-template<typename ErrorFilter>
-class ClockRecovery {
+/* Calls Owner::Handler on each symbol. Known at compile time, so the
+ * whole resampler/detector/handler chain inlines into the caller.
+ */
+template<typename Owner, void (Owner::*Handler)(const float)>
+class MemberSymbolHandler {
 public:
-	using SymbolHandler = std::function<void(const float)>;
+	constexpr MemberSymbolHandler(
+		Owner* const owner
+	) : owner { owner }
+	{
+	}
+
+	void operator()(const float symbol) const {
+		(owner->*Handler)(symbol);
+	}
+
+private:
+	Owner* const owner;
+};
 
-	ClockRecovery(
+/* Resampler is LinearResampler, configured from the rates at run time, or
+ * a FixedRateLinearResampler, see FixedRateClockRecovery.
+ */
+template<typename ErrorFilter, typename SymbolHandler, typename Resampler = dsp::interpolation::LinearResampler>
+class StaticClockRecovery {
+public:
+	StaticClockRecovery(
 		const float sampling_rate,
 		const float symbol_rate,
 		ErrorFilter error_filter,
@@ -128,19 +151,28 @@ public:
 		configure(sampling_rate, symbol_rate, error_filter);
 	}
 
-	ClockRecovery(
+	StaticClockRecovery(
 		SymbolHandler symbol_handler
 	) : symbol_handler { std::move(symbol_handler) }
 	{
 	}
 
+	/* For a Resampler with its rates built in. */
+	StaticClockRecovery(
+		ErrorFilter error_filter,
+		SymbolHandler symbol_handler
+	) : error_filter { error_filter },
+		symbol_handler { std::move(symbol_handler) }
+	{
+	}
+
 	void configure(
 		const float sampling_rate,
 		const float symbol_rate,
 		ErrorFilter error_filter
 	) {
 		resampler.configure(sampling_rate, symbol_rate * timing_error_detector.samples_per_symbol);
-		error_filter = error_filter;
+		this->error_filter = error_filter;
 	}
 
 	void operator()(
@@ -148,38 +180,65 @@ public:
 	) {
 		resampler(baseband_sample,
 			[this](const float interpolated_sample) {
-				this->resampler_callback(interpolated_sample);
+				this->timing_error_detector(interpolated_sample,
+					[this](const float symbol, const float lateness) {
+						this->symbol_handler(symbol);
+						this->resampler.advance(this->error_filter(lateness));
+					}
+				);
 			}
 		);
 	}
 
+	void execute(const buffer_f32_t& buffer) {
+		for(size_t i=0; i<buffer.count; i++) {
+			(*this)(buffer.p[i]);
+		}
+	}
+
 private:
-	dsp::interpolation::LinearResampler resampler { };
+	Resampler resampler { };
 	GardnerTimingErrorDetector timing_error_detector { };
 	ErrorFilter error_filter { };
 	const SymbolHandler symbol_handler;
+};
 
-	void resampler_callback(const float interpolated_sample) {
-		timing_error_detector(interpolated_sample,
-			[this](const float symbol, const float lateness) {
-				this->symbol_callback(symbol, lateness);
-			}
-		);
+/* Handler set at run time. Skips empty handlers, which also keeps
+ * std::function's throwing call path (and "_ZSt25__throw_bad_function_callv")
+ * out of the image.
+ */
+class FunctionSymbolHandler {
+public:
+	template<typename F>
+	FunctionSymbolHandler(
+		F&& handler
+	) : handler { std::forward<F>(handler) }
+	{
 	}
 
-	void symbol_callback(const float symbol, const float lateness) {
-		// NOTE: This check is to avoid std::function nullptr check, which
-		// brings in "_ZSt25__throw_bad_function_callv" and a lot of extra code.
-		// TODO: Make symbol_handler known at compile time.
-		if( symbol_handler) {
-			symbol_handler(symbol);
+	void operator()(const float symbol) const {
+		if( handler ) {
+			handler(symbol);
 		}
-
-		const float adjustment = error_filter(lateness);
-		resampler.advance(adjustment);
 	}
+
+private:
+	std::function<void(const float)> handler;
 };
 
+template<typename ErrorFilter>
+using ClockRecovery = StaticClockRecovery<ErrorFilter, FunctionSymbolHandler>;
+
+/* Rates fixed at compile time, for a decoder that only runs at one.
+ * Constructed from just the error filter and the handler.
+ */
+template<uint32_t SamplingRate, uint32_t SymbolRate, typename ErrorFilter, typename SymbolHandler>
+using FixedRateClockRecovery = StaticClockRecovery<
+	ErrorFilter,
+	SymbolHandler,
+	dsp::interpolation::FixedRateLinearResampler<SamplingRate, SymbolRate * GardnerTimingErrorDetector::samples_per_symbol>
+>;
+
 } /* namespace clock_recovery */
 
 #endif/*__CLOCK_RECOVERY_H__*/
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2018 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CYCLE_COUNTER_H__
+#define __CYCLE_COUNTER_H__
+
+#include "hal.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/* Thin wrapper around the Cortex-M4 DWT cycle counter. Used to measure how
+ * much of the per-buffer cycle budget a processor actually consumes.
+ */
+class CycleCounter {
+public:
+	static void enable() {
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CYCCNT = 0;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+
+	static uint32_t now() {
+		return DWT->CYCCNT;
+	}
+
+	void start() {
+		t_start = now();
+	}
+
+	uint32_t stop() {
+		const uint32_t cycles = now() - t_start;
+		cycles_last = cycles;
+		cycles_max = std::max(cycles_max, cycles);
+		cycles_total += cycles;
+		count++;
+		return cycles;
+	}
+
+	void reset() {
+		cycles_last = 0;
+		cycles_max = 0;
+		cycles_total = 0;
+		count = 0;
+	}
+
+	uint32_t last() const {
+		return cycles_last;
+	}
+
+	uint32_t max() const {
+		return cycles_max;
+	}
+
+	uint32_t average() const {
+		return count ? (cycles_total / count) : 0;
+	}
+
+	size_t samples() const {
+		return count;
+	}
+
+private:
+	uint32_t t_start { 0 };
+	uint32_t cycles_last { 0 };
+	uint32_t cycles_max { 0 };
+	uint64_t cycles_total { 0 };
+	size_t count { 0 };
+};
+
+#endif/*__CYCLE_COUNTER_H__*/
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_coded_squelch.hpp"
+
+#include "complex.hpp"
+
+#include <cmath>
+
+/* In 1/100Hz, as application/tone_key.cpp entries 1 to 50. */
+static constexpr std::array<uint16_t, CodedSquelchDecoder::tone_count> ctcss_tones { {
+	 6700,  6940,  7190,  7440,  7700,  7970,  8250,  8540,  8850,  9150,
+	 9480,  9740, 10000, 10350, 10720, 11090, 11480, 11880, 12300, 12730,
+	13180, 13650, 14130, 14620, 15140, 15670, 15980, 16220, 16550, 16790,
+	17130, 17380, 17730, 17990, 18350, 18620, 18990, 19280, 19660, 19950,
+	20350, 20650, 21070, 21810, 22570, 22910, 23360, 24180, 25030, 25410,
+} };
+
+/* x^11 + x^10 + x^6 + x^5 + x^4 + x^2 + 1, matches application/protocols/dcs.cpp */
+static constexpr uint32_t golay_polynomial = 0xc75;
+
+static uint32_t golay_parity(const uint32_t data) {
+	uint32_t remainder = data << 11;
+	for(size_t bit=22; bit>=11; bit--) {
+		if( remainder & (1U << bit) ) {
+			remainder ^= golay_polynomial << (bit - 11);
+		}
+	}
+	return remainder;
+}
+
+/* Bits in order received (first in bit 0): 9 bit code, 0b100, 11 bit parity.
+ * -1 if word isn't a DCS word.
+ */
+static int32_t dcs_code(const uint32_t word) {
+	const uint32_t data = word & 0xfff;
+	if( (data >> 9) != 0b100 ) {
+		return -1;
+	}
+	return (golay_parity(data) == (word >> 12)) ? (data & 0x1ff) : -1;
+}
+
+CodedSquelchDecoder::CodedSquelchDecoder() {
+	for(size_t i=0; i<tone_count; i++) {
+		coefficients[i] = 2.0f * std::cos(2.0f * pi * ctcss_tones[i] / (100.0f * fs));
+	}
+}
+
+void CodedSquelchDecoder::execute(const buffer_s16_t& src) {
+	for(size_t i=0; i<src.count; i++) {
+		decim_acc += src.p[i];
+		if( ++decim_count == decimation ) {
+			process(decim_acc * (1.0f / decimation));
+			decim_acc = 0;
+			decim_count = 0;
+		}
+	}
+}
+
+CodedSquelch CodedSquelchDecoder::result() const {
+	return dcs_hold ? dcs : tone;
+}
+
+void CodedSquelchDecoder::process(const float sample) {
+	// Frequency error shows up as DC, which would bias the DCS slicer.
+	const float y = sample - dc_x + dc_pole * dc_y;
+	dc_x = sample;
+	dc_y = y;
+
+	block_energy += y * y;
+	for(size_t i=0; i<tone_count; i++) {
+		const float s0 = y + coefficients[i] * s1[i] - s2[i];
+		s2[i] = s1[i];
+		s1[i] = s0;
+	}
+	if( ++block_count == block_length ) {
+		tone_block_end();
+	}
+
+	// Sample bits as the phase wraps, keep transitions at half a bit.
+	const bool level = (y > 0.0f);
+	if( level != dcs_level ) {
+		dcs_phase += (0.5f - dcs_phase) * dcs_clock_gain;
+		dcs_level = level;
+	}
+	dcs_phase += dcs_bit_rate / fs;
+	if( dcs_phase >= 1.0f ) {
+		dcs_phase -= 1.0f;
+		dcs_bit(level);
+	}
+}
+
+void CodedSquelchDecoder::tone_block_end() {
+	size_t best = 0;
+	float best_power = 0.0f;
+	float second_power = 0.0f;
+	for(size_t i=0; i<tone_count; i++) {
+		const float power = s1[i] * s1[i] + s2[i] * s2[i] - coefficients[i] * s1[i] * s2[i];
+		if( power > best_power ) {
+			second_power = best_power;
+			best_power = power;
+			best = i;
+		} else if( power > second_power ) {
+			second_power = power;
+		}
+		s1[i] = 0.0f;
+		s2[i] = 0.0f;
+	}
+
+	// A lone tone's bin power is its energy * N / 2.
+	const bool found =
+		(best_power >= tone_fraction_min * block_energy * block_length * 0.5f) &&
+		(best_power >= tone_ratio_min * second_power);
+	if( found ) {
+		tone = { CodedSquelch::Type::CTCSS, ctcss_tones[best] };
+		tone_misses = 0;
+	} else if( tone_misses < tone_misses_max ) {
+		// Rides out a block lost to a voice peak.
+		if( ++tone_misses == tone_misses_max ) {
+			tone = { };
+		}
+	}
+
+	block_energy = 0.0f;
+	block_count = 0;
+}
+
+void CodedSquelchDecoder::dcs_bit(const bool bit) {
+	dcs_register = (dcs_register >> 1) | ((bit ? 1U : 0U) << (dcs_word_length - 1));
+	if( dcs_hold ) {
+		if( --dcs_hold == 0 ) {
+			dcs = { };
+		}
+	}
+
+	int32_t code = dcs_code(dcs_register);
+	if( code < 0 ) {
+		code = dcs_code(~dcs_register & ((1U << dcs_word_length) - 1));
+		if( code >= 0 ) {
+			code |= 0x200;
+		}
+	}
+
+	// Cyclic code: rotations of a word may pass as other codes as well, the
+	// first one confirmed is reported.
+	auto& matched = dcs_matched[dcs_bit_index];
+	if( code < 0 ) {
+		matched = 0;
+	} else {
+		if( matched == (code + 1) ) {
+			const CodedSquelch candidate {
+				(code & 0x200) ? CodedSquelch::Type::DCSInverted : CodedSquelch::Type::DCS,
+				static_cast<uint16_t>(code & 0x1ff)
+			};
+			if( !dcs_hold || (candidate == dcs) ) {
+				dcs = candidate;
+				dcs_hold = dcs_hold_bits;
+			}
+		}
+		matched = code + 1;
+	}
+
+	if( ++dcs_bit_index == dcs_word_length ) {
+		dcs_bit_index = 0;
+	}
+}
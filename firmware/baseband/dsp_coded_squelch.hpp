@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_CODED_SQUELCH_H__
+#define __DSP_CODED_SQUELCH_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* CTCSS and DCS decoder for demodulated NFM audio, already low-passed below
+ * 300Hz and at 12kHz. Boxcar decimates to 1.5kHz, then runs a Goertzel bank
+ * over the 50 CTCSS tones in 0.5s blocks (2Hz bins) and a 134.4bps slicer
+ * looking for Golay(23,12) words with the DCS "100" marker.
+ */
+class CodedSquelchDecoder {
+public:
+	CodedSquelchDecoder();
+
+	void execute(const buffer_s16_t& src);
+
+	/* DCS wins over CTCSS: its NRZ spectrum lights up random tone bins. */
+	CodedSquelch result() const;
+
+	static constexpr size_t tone_count = 50;
+
+private:
+	static constexpr uint32_t input_fs = 12000;
+	static constexpr size_t decimation = 8;
+	static constexpr uint32_t fs = input_fs / decimation;
+
+	static constexpr size_t block_length = fs / 2;
+	// Bin power over what a pure tone of the block's energy would give.
+	static constexpr float tone_fraction_min = 0.1f;
+	// 3dB over the runner up, adjacent tones are 2.4Hz (-16dB) apart.
+	static constexpr float tone_ratio_min = 2.0f;
+	static constexpr size_t tone_misses_max = 2;
+
+	static constexpr float dcs_bit_rate = 134.4f;
+	static constexpr float dcs_clock_gain = 0.25f;
+	static constexpr size_t dcs_word_length = 23;
+	// Three words, as the decoder confirms on the second sighting.
+	static constexpr size_t dcs_hold_bits = 3 * dcs_word_length;
+
+	static constexpr float dc_pole = 0.995f;
+
+	int32_t decim_acc { 0 };
+	size_t decim_count { 0 };
+	float dc_x { 0.0f };
+	float dc_y { 0.0f };
+
+	std::array<float, tone_count> coefficients { };
+	std::array<float, tone_count> s1 { };
+	std::array<float, tone_count> s2 { };
+	float block_energy { 0.0f };
+	size_t block_count { 0 };
+	size_t tone_misses { tone_misses_max };
+	CodedSquelch tone { };
+
+	float dcs_phase { 0.0f };
+	bool dcs_level { false };
+	uint32_t dcs_register { 0 };
+	size_t dcs_bit_index { 0 };
+	// Code (plus 0x200 when inverted) + 1 matched at each bit of the word,
+	// a code is confirmed by rematching at the same offset one word later.
+	std::array<uint16_t, dcs_word_length> dcs_matched { };
+	size_t dcs_hold { 0 };
+	CodedSquelch dcs { };
+
+	void process(const float sample);
+	void tone_block_end();
+	void dcs_bit(const bool bit);
+};
+
+#endif/*__DSP_CODED_SQUELCH_H__*/
@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_DDS_H__
+#define __DSP_DDS_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+#include "sine_table_int8.hpp"
+
+namespace dsp {
+namespace dds {
+
+/* Same values as SigGenConfigMessage's shape. */
+enum class Shape : uint32_t {
+	CW = 0,
+	Sine = 1,
+	Triangle = 2,
+	SawUp = 3,
+	SawDown = 4,
+	Square = 5,
+	Noise = 6
+};
+
+/* Same values as SigGenSweepMessage's kind. Chirps go up and back down,
+ * the others start over at the start tone.
+ */
+enum class Sweep : uint32_t {
+	None = 0,
+	Linear = 1,
+	Log = 2,
+	Chirp = 3
+};
+
+/* Block DDS for the signal generator: up to tones_max summed tones of one
+ * shape, the first swept if asked, or noise, as Q15 at half scale. Phase
+ * deltas are in 1/2^32 turns a sample.
+ *
+ * The shape is picked once a block, not per sample. A sweep's delta ramps
+ * linearly inside ramp_length sample blocks, so a log sweep is a float
+ * multiply per block. Noise is xorshift32, four samples a word.
+ */
+class Generator {
+public:
+	static constexpr size_t tones_max = 4;
+
+	void set_shape(const Shape new_shape) {
+		shape = new_shape;
+	}
+
+	void set_tones(const uint32_t* const deltas, const size_t count) {
+		tone_count = std::max<size_t>(std::min(count, tones_max), 1);
+		for (size_t n = 0; n < tone_count; n++)
+			delta[n] = deltas[n];
+		sweep = Sweep::None;
+		ramp = 0;
+	}
+
+	/* period in samples, start to end, or start to end and back for chirps. */
+	void set_sweep(const Sweep kind, const uint32_t start_delta, const uint32_t end_delta, const uint32_t period) {
+		sweep = kind;
+		tone_count = 1;
+		sweep_start = start_delta;
+		sweep_end = end_delta;
+		sweep_blocks = std::max<uint32_t>(period / ramp_length, 1);
+		if (kind == Sweep::Log) {
+			// Per block ratio, log sweeps need start and end above 0
+			const float ratio = (float)std::max<uint32_t>(end_delta, 1) / std::max<uint32_t>(start_delta, 1);
+			sweep_step = std::pow(ratio, 1.0f / sweep_blocks);
+		} else {
+			sweep_step = ((float)end_delta - (float)start_delta) / sweep_blocks;
+		}
+		restart_sweep();
+	}
+
+	bool sweeping() const {
+		return sweep != Sweep::None;
+	}
+
+	void seed(const uint32_t value) {
+		noise = value ? value : 0x54DF0119;
+		noise_left = 0;
+	}
+
+	void execute(int16_t* const dst, const size_t count) {
+		if (shape == Shape::Noise) {
+			execute_noise(dst, count);
+			return;
+		}
+
+		for (size_t i = 0; i < count; ) {
+			const size_t n = sweeping() ? std::min(count - i, ramp_left) : (count - i);
+
+			switch (shape) {
+				case Shape::Sine:
+					render(&dst[i], n, [](const uint32_t phase) -> int8_t {
+						return sine_table_i8[phase >> 24];
+					});
+					break;
+				case Shape::Triangle:
+					render(&dst[i], n, [](const uint32_t phase) -> int8_t {
+						const int8_t a = phase >> 24;
+						return (a & 0x80) ? ((a << 1) ^ 0xFF) - 0x80 : (a << 1) + 0x80;
+					});
+					break;
+				case Shape::SawUp:
+					render(&dst[i], n, [](const uint32_t phase) -> int8_t {
+						return phase >> 24;
+					});
+					break;
+				case Shape::SawDown:
+					render(&dst[i], n, [](const uint32_t phase) -> int8_t {
+						return (phase >> 24) ^ 0xFF;
+					});
+					break;
+				case Shape::Square:
+					render(&dst[i], n, [](const uint32_t phase) -> int8_t {
+						return (phase & 0x80000000U) ? 127 : -128;
+					});
+					break;
+				default:
+					std::fill(&dst[i], &dst[i + n], 0);
+					break;
+			}
+
+			i += n;
+			if (sweeping()) {
+				ramp_left -= n;
+				if (!ramp_left)
+					next_ramp();
+			}
+		}
+	}
+
+private:
+	static constexpr size_t ramp_length = 64;
+
+	Shape shape { Shape::CW };
+	size_t tone_count { 1 };
+	std::array<uint32_t, tones_max> phase { };
+	std::array<uint32_t, tones_max> delta { };
+
+	Sweep sweep { Sweep::None };
+	uint32_t sweep_start { 0 };
+	uint32_t sweep_end { 0 };
+	uint32_t sweep_blocks { 1 };
+	uint32_t sweep_block { 0 };
+	float sweep_step { 0 };
+	float sweep_delta { 0 };			// At the start of the current block
+	bool sweep_down { false };
+	int32_t ramp { 0 };					// Delta change a sample, in this block
+	size_t ramp_left { ramp_length };
+
+	uint32_t noise { 0x54DF0119 };
+	uint32_t noise_word { 0 };			// Bytes not yet out, MSB first
+	size_t noise_left { 0 };
+
+	template<typename Wave>
+	void render(int16_t* const dst, const size_t count, Wave wave) {
+		if (tone_count == 1) {
+			// int8 shapes at half scale, as they always were
+			for (size_t i = 0; i < count; i++) {
+				dst[i] = wave(phase[0]) << 7;
+				phase[0] += delta[0];
+				delta[0] += ramp;
+			}
+		} else {
+			// Summed, the total at the same half scale
+			const int32_t gain = 32768 / tone_count;
+			for (size_t i = 0; i < count; i++) {
+				int32_t sum = 0;
+				for (size_t n = 0; n < tone_count; n++) {
+					sum += wave(phase[n]);
+					phase[n] += delta[n];
+				}
+				dst[i] = (sum * gain) >> 8;
+			}
+		}
+	}
+
+	void execute_noise(int16_t* const dst, const size_t count) {
+		size_t i = 0;
+
+		// What's left of the last word, then whole words
+		for (; noise_left && (i < count); i++)
+			dst[i] = next_noise_byte();
+		for (; i + 4 <= count; i += 4) {
+			const uint32_t word = next_noise_word();
+			dst[i + 0] = (int8_t)(word >> 24) << 7;
+			dst[i + 1] = (int8_t)(word >> 16) << 7;
+			dst[i + 2] = (int8_t)(word >> 8) << 7;
+			dst[i + 3] = (int8_t)word << 7;
+		}
+		for (; i < count; i++) {
+			if (!noise_left) {
+				noise_word = next_noise_word();
+				noise_left = 4;
+			}
+			dst[i] = next_noise_byte();
+		}
+	}
+
+	uint32_t next_noise_word() {
+		// Never 0 from a non-zero seed
+		noise ^= noise << 13;
+		noise ^= noise >> 17;
+		noise ^= noise << 5;
+		return noise;
+	}
+
+	int16_t next_noise_byte() {
+		const int16_t sample = (int8_t)(noise_word >> 24) << 7;
+		noise_word <<= 8;
+		noise_left--;
+		return sample;
+	}
+
+	void restart_sweep() {
+		sweep_block = 0;
+		sweep_down = false;
+		sweep_delta = sweep_start;
+		start_ramp();
+	}
+
+	/* Sets the block's ramp from sweep_delta to the next block's. */
+	void start_ramp() {
+		float next;
+		if (sweep == Sweep::Log)
+			next = sweep_down ? sweep_delta / sweep_step : sweep_delta * sweep_step;
+		else
+			next = sweep_down ? sweep_delta - sweep_step : sweep_delta + sweep_step;
+
+		delta[0] = sweep_delta;
+		ramp = ((int32_t)next - (int32_t)sweep_delta) / (int32_t)ramp_length;
+		sweep_delta = next;
+		ramp_left = ramp_length;
+	}
+
+	void next_ramp() {
+		if (++sweep_block < sweep_blocks) {
+			start_ramp();
+		} else if (sweep == Sweep::Chirp) {
+			// Turn around where the last ramp ended
+			sweep_block = 0;
+			sweep_down = !sweep_down;
+			sweep_delta = sweep_down ? sweep_end : sweep_start;
+			start_ramp();
+		} else {
+			restart_sweep();
+		}
+	}
+};
+
+} /* namespace dds */
+} /* namespace dsp */
+
+#endif/*__DSP_DDS_H__*/
@@ -21,6 +21,8 @@
 
 #include "dsp_decimate.hpp"
 
+#include "sine_table_int8.hpp"
+
 #include <hal.h>
 
 namespace dsp {
@@ -259,41 +261,43 @@ void FIRC8xR16x24FS4Decim8::configure(
 	z_.fill({});
 }
 
-buffer_c16_t FIRC8xR16x24FS4Decim8::execute(
-	const buffer_c8_t& src,
-	const buffer_c16_t& dst
-) {
+inline uint32_t FIRC8xR16x24FS4Decim8::execute_one(const vec4_s8* const in) {
 	vec2_s16* const z = static_cast<vec2_s16*>(__builtin_assume_aligned(z_.data(), 4));
 	const vec2_s16* const t = static_cast<vec2_s16*>(__builtin_assume_aligned(taps_.data(), 4));
-	uint32_t* const d = static_cast<uint32_t*>(__builtin_assume_aligned(dst.p, 4));
 
-	const auto k = output_scale;
+	complex32_t accum;
 
-	const size_t count = src.count / decimation_factor;
-	for(size_t i=0; i<count; i++) {
-		const vec4_s8* const in = static_cast<const vec4_s8*>(__builtin_assume_aligned(&src.p[i * decimation_factor], 4));
+	// Oldest samples are discarded.
+	accum = mac_fs4_shift(z, t, 0, accum);
+	accum = mac_fs4_shift(z, t, 1, accum);
+	accum = mac_fs4_shift(z, t, 2, accum);
+	accum = mac_fs4_shift(z, t, 3, accum);
 
-		complex32_t accum;
+	// Middle samples are shifted earlier in the "z" delay buffer.
+	accum = mac_fs4_shift_and_store(z, t, decimation_factor, 0, accum);
+	accum = mac_fs4_shift_and_store(z, t, decimation_factor, 1, accum);
+	accum = mac_fs4_shift_and_store(z, t, decimation_factor, 2, accum);
+	accum = mac_fs4_shift_and_store(z, t, decimation_factor, 3, accum);
 
-		// Oldest samples are discarded.
-		accum = mac_fs4_shift(z, t, 0, accum);
-		accum = mac_fs4_shift(z, t, 1, accum);
-		accum = mac_fs4_shift(z, t, 2, accum);
-		accum = mac_fs4_shift(z, t, 3, accum);
+	// Newest samples come from "in" buffer, are copied to "z" delay buffer.
+	accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 0, taps_count, accum);
+	accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 1, taps_count, accum);
+	accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 2, taps_count, accum);
+	accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 3, taps_count, accum);
 
-		// Middle samples are shifted earlier in the "z" delay buffer.
-		accum = mac_fs4_shift_and_store(z, t, decimation_factor, 0, accum);
-		accum = mac_fs4_shift_and_store(z, t, decimation_factor, 1, accum);
-		accum = mac_fs4_shift_and_store(z, t, decimation_factor, 2, accum);
-		accum = mac_fs4_shift_and_store(z, t, decimation_factor, 3, accum);
+	return scale_round_and_pack(accum, output_scale);
+}
 
-		// Newest samples come from "in" buffer, are copied to "z" delay buffer.
-		accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 0, taps_count, accum);
-		accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 1, taps_count, accum);
-		accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 2, taps_count, accum);
-		accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 3, taps_count, accum);
+buffer_c16_t FIRC8xR16x24FS4Decim8::execute(
+	const buffer_c8_t& src,
+	const buffer_c16_t& dst
+) {
+	uint32_t* const d = static_cast<uint32_t*>(__builtin_assume_aligned(dst.p, 4));
 
-		d[i] = scale_round_and_pack(accum, k);
+	const size_t count = src.count / decimation_factor;
+	for(size_t i=0; i<count; i++) {
+		const vec4_s8* const in = static_cast<const vec4_s8*>(__builtin_assume_aligned(&src.p[i * decimation_factor], 4));
+		d[i] = execute_one(in);
 	}
 
 	return {
@@ -365,45 +369,79 @@ void FIRC16xR16x32Decim8::configure(
 	z_.fill({});
 }
 
+inline uint32_t FIRC16xR16x32Decim8::execute_one(const vec2_s16* const in) {
+	vec2_s16* const z = static_cast<vec2_s16*>(__builtin_assume_aligned(z_.data(), 4));
+	const vec2_s16* const t = static_cast<vec2_s16*>(__builtin_assume_aligned(taps_.data(), 4));
+
+	complex32_t accum;
+
+	// Oldest samples are discarded.
+	accum = mac_shift(z, t, 0, accum);
+	accum = mac_shift(z, t, 1, accum);
+	accum = mac_shift(z, t, 2, accum);
+	accum = mac_shift(z, t, 3, accum);
+
+	// Middle samples are shifted earlier in the "z" delay buffer.
+	accum = mac_shift_and_store(z, t, decimation_factor, 0, accum);
+	accum = mac_shift_and_store(z, t, decimation_factor, 1, accum);
+	accum = mac_shift_and_store(z, t, decimation_factor, 2, accum);
+	accum = mac_shift_and_store(z, t, decimation_factor, 3, accum);
+	accum = mac_shift_and_store(z, t, decimation_factor, 4, accum);
+	accum = mac_shift_and_store(z, t, decimation_factor, 5, accum);
+	accum = mac_shift_and_store(z, t, decimation_factor, 6, accum);
+	accum = mac_shift_and_store(z, t, decimation_factor, 7, accum);
+
+	// Newest samples come from "in" buffer, are copied to "z" delay buffer.
+	accum = mac_shift_and_store_new_c16_samples(z, t, in, decimation_factor, 0, taps_count, accum);
+	accum = mac_shift_and_store_new_c16_samples(z, t, in, decimation_factor, 1, taps_count, accum);
+	accum = mac_shift_and_store_new_c16_samples(z, t, in, decimation_factor, 2, taps_count, accum);
+	accum = mac_shift_and_store_new_c16_samples(z, t, in, decimation_factor, 3, taps_count, accum);
+
+	return scale_round_and_pack(accum, output_scale);
+}
+
 buffer_c16_t FIRC16xR16x32Decim8::execute(
 	const buffer_c16_t& src,
 	const buffer_c16_t& dst
 ) {
-	vec2_s16* const z = static_cast<vec2_s16*>(__builtin_assume_aligned(z_.data(), 4));
-	const vec2_s16* const t = static_cast<vec2_s16*>(__builtin_assume_aligned(taps_.data(), 4));
 	uint32_t* const d = static_cast<uint32_t*>(__builtin_assume_aligned(dst.p, 4));
 
-	const auto k = output_scale;
-
 	const size_t count = src.count / decimation_factor;
 	for(size_t i=0; i<count; i++) {
 		const vec2_s16* const in = static_cast<const vec2_s16*>(__builtin_assume_aligned(&src.p[i * decimation_factor], 4));
+		d[i] = execute_one(in);
+	}
 
-		complex32_t accum;
+	return {
+		dst.p,
+		count,
+		src.sampling_rate / decimation_factor
+	};
+}
 
-		// Oldest samples are discarded.
-		accum = mac_shift(z, t, 0, accum);
-		accum = mac_shift(z, t, 1, accum);
-		accum = mac_shift(z, t, 2, accum);
-		accum = mac_shift(z, t, 3, accum);
+// FIRC8xR16x24FS4Decim8 -> FIRC16xR16x32Decim8 ///////////////////////////
 
-		// Middle samples are shifted earlier in the "z" delay buffer.
-		accum = mac_shift_and_store(z, t, decimation_factor, 0, accum);
-		accum = mac_shift_and_store(z, t, decimation_factor, 1, accum);
-		accum = mac_shift_and_store(z, t, decimation_factor, 2, accum);
-		accum = mac_shift_and_store(z, t, decimation_factor, 3, accum);
-		accum = mac_shift_and_store(z, t, decimation_factor, 4, accum);
-		accum = mac_shift_and_store(z, t, decimation_factor, 5, accum);
-		accum = mac_shift_and_store(z, t, decimation_factor, 6, accum);
-		accum = mac_shift_and_store(z, t, decimation_factor, 7, accum);
+buffer_c16_t execute_decim_64(
+	FIRC8xR16x24FS4Decim8& decim_0,
+	FIRC16xR16x32Decim8& decim_1,
+	const buffer_c8_t& src,
+	const buffer_c16_t& dst
+) {
+	constexpr size_t tile_length = FIRC16xR16x32Decim8::decimation_factor;
+	constexpr size_t decimation_factor = FIRC8xR16x24FS4Decim8::decimation_factor * tile_length;
 
-		// Newest samples come from "in" buffer, are copied to "z" delay buffer.
-		accum = mac_shift_and_store_new_c16_samples(z, t, in, decimation_factor, 0, taps_count, accum);
-		accum = mac_shift_and_store_new_c16_samples(z, t, in, decimation_factor, 1, taps_count, accum);
-		accum = mac_shift_and_store_new_c16_samples(z, t, in, decimation_factor, 2, taps_count, accum);
-		accum = mac_shift_and_store_new_c16_samples(z, t, in, decimation_factor, 3, taps_count, accum);
+	uint32_t* const d = static_cast<uint32_t*>(__builtin_assume_aligned(dst.p, 4));
 
-		d[i] = scale_round_and_pack(accum, k);
+	const size_t count = src.count / decimation_factor;
+	for(size_t i=0; i<count; i++) {
+		// Same per-output kernels as the two-pass chain, in the same order,
+		// so the result is bit-identical. Only the intermediate block is gone.
+		std::array<vec2_s16, tile_length> tile;
+		for(size_t j=0; j<tile_length; j++) {
+			const vec4_s8* const in = static_cast<const vec4_s8*>(__builtin_assume_aligned(&src.p[(i * tile_length + j) * FIRC8xR16x24FS4Decim8::decimation_factor], 4));
+			tile[j].w = decim_0.execute_one(in);
+		}
+		d[i] = decim_1.execute_one(tile.data());
 	}
 
 	return {
@@ -554,6 +592,66 @@ buffer_c16_t TranslateByFSOver4AndDecimateBy2CIC3::execute(const buffer_c8_t& sr
 	return { dst.p, src.count / 2, src.sampling_rate / 2 };
 }
 
+void NCOTranslateAndDecimateBy2CIC3::configure(const int32_t offset_hz, const uint32_t sampling_rate) {
+	// Phase runs forwards for a positive offset, and the mixer rotates backwards.
+	phase_inc = static_cast<uint32_t>((static_cast<int64_t>(offset_hz) << 32) / sampling_rate);
+}
+
+buffer_c16_t NCOTranslateAndDecimateBy2CIC3::execute(const buffer_c8_t& src, const buffer_c16_t& dst) {
+	/* Each sample is multiplied by the conjugate of the NCO, s:c packed
+	 * against q:i:
+	 *	I = i * c + q * s				SMUAD
+	 *	Q = q * c - i * s				SMUSDX
+	 *
+	 * then decimated by the 1, 3, 3, 1 CIC, scaled down by 4 (the mixer
+	 * already has a gain of 127, the CIC 8):
+	 *	D0 = m3 * 1 + m2 * 3 + m1 * 3 + m0 * 1
+	 */
+	uint32_t p = phase;
+	const uint32_t inc = phase_inc;
+	int32_t i0 = _i0, q0 = _q0;
+	int32_t i1 = _i1, q1 = _q1;
+
+	const uint32_t* src_p = reinterpret_cast<const uint32_t*>(&src.p[0]);
+	const uint32_t* const src_end = reinterpret_cast<const uint32_t*>(&src.p[src.count]);
+	uint32_t* dst_p = reinterpret_cast<uint32_t*>(&dst.p[0]);
+	while(src_p < src_end) {
+		const uint32_t q3_i3_q2_i2 = *(src_p++);
+		const uint32_t i3_i2 = __SXTB16(q3_i3_q2_i2, 0);
+		const uint32_t q3_q2 = __SXTB16(q3_i3_q2_i2, 8);
+		const uint32_t q2_i2 = __PKHBT(i3_i2, q3_q2, 16);
+		const uint32_t q3_i3 = __PKHTB(q3_q2, i3_i2, 16);
+
+		const uint32_t s2_c2 = __PKHBT(
+			static_cast<uint16_t>(sine_table_i8[((p >> 24) + 64) & 0xff]),
+			sine_table_i8[p >> 24], 16
+		);
+		p += inc;
+		const uint32_t s3_c3 = __PKHBT(
+			static_cast<uint16_t>(sine_table_i8[((p >> 24) + 64) & 0xff]),
+			sine_table_i8[p >> 24], 16
+		);
+		p += inc;
+
+		const int32_t i2 = __SMUAD(q2_i2, s2_c2);
+		const int32_t q2 = __SMUSDX(s2_c2, q2_i2);
+		const int32_t i3 = __SMUAD(q3_i3, s3_c3);
+		const int32_t q3 = __SMUSDX(s3_c3, q3_i3);
+
+		const int32_t d_i = (i3 + 3 * (i2 + i1) + i0) >> 2;
+		const int32_t d_q = (q3 + 3 * (q2 + q1) + q0) >> 2;
+		*(dst_p++) = __PKHBT(__SSAT(d_i, 16), __SSAT(d_q, 16), 16);
+
+		i0 = i2; q0 = q2;
+		i1 = i3; q1 = q3;
+	}
+	phase = p;
+	_i0 = i0; _q0 = q0;
+	_i1 = i1; _q1 = q1;
+
+	return { dst.p, src.count / 2, src.sampling_rate / 2 };
+}
+
 buffer_c16_t DecimateBy2CIC3::execute(
 	const buffer_c16_t& src,
 	const buffer_c16_t& dst
@@ -610,6 +708,23 @@ void FIR64AndDecimateBy2Real::configure(
 	const std::array<int16_t, taps_count>& new_taps
 ) {
 	std::copy(new_taps.cbegin(), new_taps.cend(), taps.begin());
+
+	const auto symmetric = [this](const size_t length) {
+		for(size_t j=0; j<length/2; j++) {
+			if( taps[j] != taps[length - 1 - j] ) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	if( symmetric(taps_count) ) {
+		symmetric_length = taps_count;
+	} else if( (taps[taps_count - 1] == 0) && symmetric(taps_count - 1) ) {
+		symmetric_length = taps_count - 1;
+	} else {
+		symmetric_length = 0;
+	}
 }
 
 buffer_s16_t FIR64AndDecimateBy2Real::execute(
@@ -623,6 +738,28 @@ buffer_s16_t FIR64AndDecimateBy2Real::execute(
 	auto src_p = src.p;
 	auto dst_p = dst.p;
 	int32_t n = src.count;
+
+	if( symmetric_length ) {
+		const size_t length = symmetric_length;
+		for(; n>0; n-=2) {
+			z[taps_count-2] = *(src_p++);
+			z[taps_count-1] = *(src_p++);
+
+			int32_t t = 0;
+			for(size_t j=0; j<length/2; j++) {
+				t += (z[j] + z[length - 1 - j]) * taps[j];
+			}
+			if( length & 1 ) {
+				t += z[length / 2] * taps[length / 2];
+			}
+
+			std::copy(&z[2], &z[taps_count], &z[0]);
+			*(dst_p++) = t / 65536;
+		}
+
+		return { dst.p, src.count / 2, src.sampling_rate / 2 };
+	}
+
 	for(; n>0; n-=2) {
 		z[taps_count-2] = *(src_p++);
 		z[taps_count-1] = *(src_p++);
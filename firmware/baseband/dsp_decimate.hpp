@@ -60,6 +60,30 @@ private:
 	uint32_t _q0_i1 { 0 };
 };
 
+/* Translates incoming complex<int8_t> samples by any offset with a
+ * sine_table_i8 NCO, then decimates by two with the same third-order CIC
+ * and gain of 256 as the fixed FS/4 version, so a channel anywhere in the
+ * captured span can be brought to 0Hz without retuning. The NCO phase
+ * carries over reconfigurations, so an offset can change on the fly.
+ */
+class NCOTranslateAndDecimateBy2CIC3 {
+public:
+	/* Moves offset_hz down to 0Hz; sampling_rate is the input rate. */
+	void configure(const int32_t offset_hz, const uint32_t sampling_rate);
+
+	buffer_c16_t execute(
+		const buffer_c8_t& src,
+		const buffer_c16_t& dst
+	);
+
+private:
+	uint32_t phase { 0 };
+	uint32_t phase_inc { 0 };
+	// Last two mixed samples, for the CIC
+	int32_t _i0 { 0 }, _q0 { 0 };
+	int32_t _i1 { 0 }, _q1 { 0 };
+};
+
 class DecimateBy2CIC3 {
 public:
 	buffer_c16_t execute(
@@ -72,6 +96,10 @@ private:
 	uint32_t _iq1 { 0 };
 };
 
+/* Symmetric taps, either all 64 or 63 padded with a trailing zero (as
+ * tools/fir_lpf.py and fir_design pad odd lengths), are folded: the two
+ * samples sharing a tap are added first, halving the multiplies.
+ */
 class FIR64AndDecimateBy2Real {
 public:
 	static constexpr size_t taps_count = 64;
@@ -88,6 +116,7 @@ public:
 private:
 	std::array<int16_t, taps_count + 2> z { };
 	std::array<int16_t, taps_count> taps { };
+	size_t symmetric_length { 0 };
 };
 
 class FIRC8xR16x24FS4Decim4 {
@@ -143,6 +172,9 @@ public:
 		const buffer_c8_t& src,
 		const buffer_c16_t& dst
 	);
+
+	/* One output (packed complex16) from the next decimation_factor samples. */
+	uint32_t execute_one(const vec4_s8* const in);
 	
 private:
 	std::array<vec2_s16, taps_count - decimation_factor> z_ { };
@@ -191,6 +223,9 @@ public:
 		const buffer_c16_t& src,
 		const buffer_c16_t& dst
 	);
+
+	/* One output (packed complex16) from the next decimation_factor samples. */
+	uint32_t execute_one(const vec2_s16* const in);
 	
 private:
 	std::array<vec2_s16, taps_count - decimation_factor> z_ { };
@@ -198,6 +233,18 @@ private:
 	int32_t output_scale = 0;
 };
 
+/* FIRC8xR16x24FS4Decim8 followed by FIRC16xR16x32Decim8 in a single pass:
+ * each decim_1 output is computed as soon as its eight decim_0 outputs
+ * exist, so the 1/8-rate intermediate block never goes through memory.
+ * Bit-identical to running the two execute()s back to back.
+ */
+buffer_c16_t execute_decim_64(
+	FIRC8xR16x24FS4Decim8& decim_0,
+	FIRC16xR16x32Decim8& decim_1,
+	const buffer_c8_t& src,
+	const buffer_c16_t& dst
+);
+
 class FIRAndDecimateComplex {
 public:
 	using sample_t = complex16_t;
@@ -258,6 +305,140 @@ private:
 	int16_t _dummy { };	// TODO: Addresses GCC bug when constructing a class that's not sizeof() % 4 == 0?
 };
 
+/* Recursive (Hogenauer) CIC: Stages integrators at the input rate, then
+ * Stages combs of differential delay Delay at the output rate, for any
+ * power of two Decimation in one pass. The (Decimation * Delay)^Stages
+ * gain comes back out as a shift, to the same scale as the other complex8
+ * and complex16 decimators, and a three tap FIR at the output rate
+ * flattens the sinc^Stages droop over the lower part of the output band.
+ *
+ * Integrators are left to wrap: two's complement makes the combs'
+ * differences exact regardless, as long as a register holds the output's
+ * full width. The static_asserts check that the input's 8 or 16 bits plus
+ * the growth fit in 32. That leaves I and Q a 32 bit register each, so
+ * only memory is packed: complex8 pairs are read a word at a time, and
+ * each output goes out as one Q:I word.
+ */
+template<size_t Stages, size_t Decimation, size_t Delay = 1>
+class CIC {
+public:
+	static constexpr size_t decimation_factor = Decimation;
+
+	buffer_c16_t execute(
+		const buffer_c8_t& src,
+		const buffer_c16_t& dst
+	) {
+		static_assert(8 + growth <= 32, "CIC bit growth too large for complex8 input");
+		static_assert((Decimation % 2) == 0, "complex8 input is read two samples at a time");
+
+		const uint32_t* src_p = reinterpret_cast<const uint32_t*>(src.p);
+		uint32_t* dst_p = reinterpret_cast<uint32_t*>(dst.p);
+		for(size_t n=0; n<src.count/Decimation; n++) {
+			for(size_t k=0; k<Decimation/2; k++) {
+				const uint32_t q1_i1_q0_i0 = *(src_p++);
+				integrate(
+					static_cast<int8_t>(q1_i1_q0_i0 >>  0),
+					static_cast<int8_t>(q1_i1_q0_i0 >>  8)
+				);
+				integrate(
+					static_cast<int8_t>(q1_i1_q0_i0 >> 16),
+					static_cast<int8_t>(q1_i1_q0_i0 >> 24)
+				);
+			}
+			*(dst_p++) = output(growth - 8);
+		}
+
+		return { dst.p, src.count / Decimation, src.sampling_rate / Decimation };
+	}
+
+	buffer_c16_t execute(
+		const buffer_c16_t& src,
+		const buffer_c16_t& dst
+	) {
+		static_assert(16 + growth <= 32, "CIC bit growth too large for complex16 input");
+
+		const uint32_t* src_p = reinterpret_cast<const uint32_t*>(src.p);
+		uint32_t* dst_p = reinterpret_cast<uint32_t*>(dst.p);
+		for(size_t n=0; n<src.count/Decimation; n++) {
+			for(size_t k=0; k<Decimation; k++) {
+				const uint32_t q_i = *(src_p++);
+				integrate(
+					static_cast<int16_t>(q_i >>  0),
+					static_cast<int16_t>(q_i >> 16)
+				);
+			}
+			*(dst_p++) = output(growth);
+		}
+
+		return { dst.p, src.count / Decimation, src.sampling_rate / Decimation };
+	}
+
+private:
+	static constexpr size_t log2(const size_t v) {
+		return (v > 1) ? (1 + log2(v / 2)) : 0;
+	}
+
+	static_assert(Stages > 0, "CIC needs at least one stage");
+	static_assert(((Decimation * Delay) & (Decimation * Delay - 1)) == 0, "CIC gain must be a power of two");
+
+	static constexpr size_t growth = Stages * log2(Decimation * Delay);
+
+	/* Matches the first terms of 1 / sinc^Stages(Delay * f): a centre tap of
+	 * 1 + 2a and side taps of -a, a = Stages * Delay^2 / 24, Q15, DC gain
+	 * exactly unity.
+	 */
+	static constexpr int32_t compensation_side = (Stages * Delay * Delay * 32768 + 12) / 24;
+	static constexpr int32_t compensation_centre = 32768 + 2 * compensation_side;
+	static_assert(compensation_centre + 2 * compensation_side < 65536, "CIC compensator would overflow");
+
+	struct Lane {
+		std::array<uint32_t, Stages> integrator;
+		std::array<std::array<uint32_t, Delay>, Stages> comb;
+		std::array<int32_t, 2> compensation;
+	};
+
+	Lane i_ { };
+	Lane q_ { };
+	size_t comb_index { 0 };
+
+	static void integrate_lane(Lane& lane, const int32_t x) {
+		uint32_t v = x;
+		for(size_t s=0; s<Stages; s++) {
+			v = lane.integrator[s] += v;
+		}
+	}
+
+	void integrate(const int32_t i, const int32_t q) {
+		integrate_lane(i_, i);
+		integrate_lane(q_, q);
+	}
+
+	int16_t output_lane(Lane& lane, const size_t shift) {
+		uint32_t v = lane.integrator[Stages - 1];
+		for(size_t s=0; s<Stages; s++) {
+			const uint32_t delayed = lane.comb[s][comb_index];
+			lane.comb[s][comb_index] = v;
+			v -= delayed;
+		}
+
+		// Back to Q15 scale before the compensator, which delays by one sample.
+		const int32_t c0 = static_cast<int32_t>(v) >> shift;
+		const int32_t y = (compensation_centre * lane.compensation[0]
+			- compensation_side * (c0 + lane.compensation[1])) >> 15;
+		lane.compensation[1] = lane.compensation[0];
+		lane.compensation[0] = c0;
+
+		return __SSAT(y, 16);
+	}
+
+	uint32_t output(const size_t shift) {
+		const int16_t i = output_lane(i_, shift);
+		const int16_t q = output_lane(q_, shift);
+		comb_index = (comb_index + 1) % Delay;
+		return __PKHBT(static_cast<uint16_t>(i), q, 16);
+	}
+};
+
 } /* namespace decimate */
 } /* namespace dsp */
 
@@ -22,7 +22,6 @@
 #include "dsp_demodulate.hpp"
 
 #include "complex.hpp"
-#include "fxpt_atan2.hpp"
 #include "utility_m4.hpp"
 
 #include <hal.h>
@@ -53,78 +52,95 @@ buffer_f32_t SSB::execute(
 	const buffer_c16_t& src,
 	const buffer_f32_t& dst
 ) {
-	const complex16_t* src_p = src.p;
-	const auto src_end = &src.p[src.count];
-	auto dst_p = dst.p;
-	while(src_p < src_end) {
-		*(dst_p++) = (src_p++)->real() * k;
-		*(dst_p++) = (src_p++)->real() * k;
-		*(dst_p++) = (src_p++)->real() * k;
-		*(dst_p++) = (src_p++)->real() * k;
+	for(size_t i=0; i<src.count; i++) {
+		const int32_t q = hilbert.execute(src.p[i].imag());
+		const int32_t in_phase = i_delay[i_index];
+		i_delay[i_index] = src.p[i].real();
+		i_index = (i_index + 1 == i_delay.size()) ? 0 : (i_index + 1);
+
+		dst.p[i] = (upper_ ? (in_phase - q) : (in_phase + q)) * k;
 	}
 
 	return { dst.p, src.count, src.sampling_rate };
 }
-/*
-static inline float angle_approx_4deg0(const complex32_t t) {
-	const auto x = static_cast<float>(t.imag()) / static_cast<float>(t.real());
-	return 16384.0f * x;
+namespace {
+
+template<FM::Precision P>
+inline float atan_first_octant(const float x);
+
+// x in [0, 1]
+template<>
+inline float atan_first_octant<FM::Precision::Fast>(const float x) {
+	const float x2 = x * x;
+	return x * (0.97239411f - 0.19194795f * x2);
 }
-*/
-static inline float angle_approx_0deg27(const complex32_t t) {
-	if( t.real() ) {
-		const auto x = static_cast<float>(t.imag()) / static_cast<float>(t.real());
-		return x / (1.0f + 0.28086f * x * x);
-	} else {
-		return (t.imag() < 0) ? -1.5707963268f : 1.5707963268f;
-	}
+
+// Abramowitz & Stegun 4.4.49
+template<>
+inline float atan_first_octant<FM::Precision::Precise>(const float x) {
+	const float x2 = x * x;
+	return x * (0.9998660f + x2 * (-0.3302995f + x2 * (0.1801410f + x2 * (-0.0851330f + x2 * 0.0208351f))));
 }
 
-static inline float angle_precise(const complex32_t t) {
-	return atan2f(t.imag(), t.real());
+template<FM::Precision P>
+inline float angle(const complex32_t t) {
+	const float re = t.real();
+	const float im = t.imag();
+	const float re_abs = __builtin_fabsf(re);
+	const float im_abs = __builtin_fabsf(im);
+	const bool steep = im_abs > re_abs;
+
+	// Nonzero magnitudes are >= 1, so the bias only matters for (0, 0).
+	const float num = steep ? re_abs : im_abs;
+	const float den = (steep ? im_abs : re_abs) + 1e-30f;
+	float a = atan_first_octant<P>(num / den);
+	if( steep ) {
+		a = 1.5707963268f - a;
+	}
+	if( re < 0.0f ) {
+		a = 3.1415926536f - a;
+	}
+	return (im < 0.0f) ? -a : a;
 }
 
-buffer_f32_t FM::execute(
+template<FM::Precision P>
+void demodulate_f32(
 	const buffer_c16_t& src,
-	const buffer_f32_t& dst
+	float* dst_p,
+	complex16_t::rep_type& z,
+	const float k
 ) {
-	auto z = z_;
-
 	const void* src_p = src.p;
 	const auto src_end = &src.p[src.count];
-	auto dst_p = dst.p;
 	while(src_p < src_end) {
 		const auto s0 = *__SIMD32(src_p)++;
 		const auto s1 = *__SIMD32(src_p)++;
-		const auto t0 = multiply_conjugate_s16_s32(s0, z);
-		const auto t1 = multiply_conjugate_s16_s32(s1, s0);
+		const auto t0 = multiply_conjugate_s16_s32_fast(s0, z);
+		const auto t1 = multiply_conjugate_s16_s32_fast(s1, s0);
 		z = s1;
-		*(dst_p++) = angle_precise(t0) * kf;
-		*(dst_p++) = angle_precise(t1) * kf;
+		*(dst_p++) = angle<P>(t0) * k;
+		*(dst_p++) = angle<P>(t1) * k;
 	}
-	z_ = z;
-
-	return { dst.p, src.count, src.sampling_rate };
 }
 
-buffer_s16_t FM::execute(
+template<FM::Precision P>
+void demodulate_s16(
 	const buffer_c16_t& src,
-	const buffer_s16_t& dst
+	void* dst_p,
+	complex16_t::rep_type& z,
+	const float k
 ) {
-	auto z = z_;
-
 	const void* src_p = src.p;
 	const auto src_end = &src.p[src.count];
-	void* dst_p = dst.p;
 	while(src_p < src_end) {
 		const auto s0 = *__SIMD32(src_p)++;
 		const auto s1 = *__SIMD32(src_p)++;
-		const auto t0 = multiply_conjugate_s16_s32(s0, z);
-		const auto t1 = multiply_conjugate_s16_s32(s1, s0);
+		const auto t0 = multiply_conjugate_s16_s32_fast(s0, z);
+		const auto t1 = multiply_conjugate_s16_s32_fast(s1, s0);
 		z = s1;
-		const int32_t theta0_int = angle_approx_0deg27(t0) * ks16;
+		const int32_t theta0_int = angle<P>(t0) * k;
 		const int32_t theta0_sat = __SSAT(theta0_int, 16);
-		const int32_t theta1_int = angle_approx_0deg27(t1) * ks16;
+		const int32_t theta1_int = angle<P>(t1) * k;
 		const int32_t theta1_sat = __SSAT(theta1_int, 16);
 		*__SIMD32(dst_p)++ = __PKHBT(
 			theta0_sat,
@@ -132,12 +148,41 @@ buffer_s16_t FM::execute(
 			16
 		);
 	}
-	z_ = z;
+}
+
+} /* namespace */
+
+buffer_f32_t FM::execute(
+	const buffer_c16_t& src,
+	const buffer_f32_t& dst
+) {
+	if( precision_ == Precision::Precise ) {
+		demodulate_f32<Precision::Precise>(src, dst.p, z_, kf);
+	} else {
+		demodulate_f32<Precision::Fast>(src, dst.p, z_, kf);
+	}
+
+	return { dst.p, src.count, src.sampling_rate };
+}
+
+buffer_s16_t FM::execute(
+	const buffer_c16_t& src,
+	const buffer_s16_t& dst
+) {
+	if( precision_ == Precision::Precise ) {
+		demodulate_s16<Precision::Precise>(src, dst.p, z_, ks16);
+	} else {
+		demodulate_s16<Precision::Fast>(src, dst.p, z_, ks16);
+	}
 
 	return { dst.p, src.count, src.sampling_rate };
 }
 
-void FM::configure(const float sampling_rate, const float deviation_hz) {
+void FM::configure(
+	const float sampling_rate,
+	const float deviation_hz,
+	const Precision precision
+) {
 	/*
 	 * angle: -pi to pi. output range: -32768 to 32767.
 	 * Maximum delta-theta (output of atan2) at maximum deviation frequency:
@@ -145,6 +190,7 @@ void FM::configure(const float sampling_rate, const float deviation_hz) {
 	 */
 	kf = static_cast<float>(1.0f / (2.0 * pi * deviation_hz / sampling_rate));
 	ks16 = 32767.0f * kf;
+	precision_ = precision;
 }
 
 }
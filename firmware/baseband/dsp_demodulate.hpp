@@ -23,6 +23,9 @@
 #define __DSP_DEMODULATE_H__
 
 #include "dsp_types.hpp"
+#include "dsp_hilbert.hpp"
+
+#include <array>
 
 namespace dsp {
 namespace demodulate {
@@ -38,19 +41,42 @@ private:
 	static constexpr float k = 1.0f / 32768.0f;
 };
 
+/* Phasing demodulator, I delayed minus (USB) or plus (LSB) the Hilbert
+ * transform of Q: the opposite sideband cancels. x = e^(jwt) with w > 0
+ * gives Q = sin(wt), H(Q) = -cos(wt), so I - H(Q) = 2cos(wt) and
+ * I + H(Q) = 0.
+ */
 class SSB {
 public:
+	void configure(const bool upper) {
+		upper_ = upper;
+	}
+
 	buffer_f32_t execute(
 		const buffer_c16_t& src,
 		const buffer_f32_t& dst
 	);
 
 private:
-	static constexpr float k = 1.0f / 32768.0f;
+	static constexpr float k = 0.5f / 32768.0f;
+
+	bool upper_ { true };
+	HilbertTransform hilbert { };
+	std::array<int16_t, HilbertTransform::delay> i_delay { };
+	size_t i_index { 0 };
 };
 
+/* Conjugate-product discriminator. The angle is folded into the first
+ * octant and taken from an odd polynomial in min/max, so both precisions
+ * are good around the whole circle and cost one division per sample.
+ */
 class FM {
 public:
+	enum class Precision {
+		Fast,		// 0.28 degree
+		Precise,	// 0.0007 degree
+	};
+
 	buffer_f32_t execute(
 		const buffer_c16_t& src,
 		const buffer_f32_t& dst
@@ -61,12 +87,17 @@ public:
 		const buffer_s16_t& dst
 	);
 
-	void configure(const float sampling_rate, const float deviation_hz);
+	void configure(
+		const float sampling_rate,
+		const float deviation_hz,
+		const Precision precision = Precision::Fast
+	);
 
 private:
 	complex16_t::rep_type z_ { 0 };
 	float kf { 0 };
 	float ks16 { 0 };
+	Precision precision_ { Precision::Fast };
 };
 
 } /* namespace demodulate */
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_frequency_correction.hpp"
+
+#include "complex.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void FrequencyCorrector::configure(const uint32_t sampling_rate, const int32_t range_hz) {
+	fs = sampling_rate;
+	range = range_hz;
+	offset = std::max(-range, std::min(range, offset));
+	block_length = fs * block_seconds;
+	block_count = 0;
+	acc_re = acc_im = acc_power = 0.0f;
+	update_step();
+}
+
+void FrequencyCorrector::set_tracking(const bool enabled) {
+	tracking = enabled;
+	if( !tracking ) {
+		offset = 0.0f;
+		phase_re = 1.0f;
+		phase_im = 0.0f;
+		update_step();
+	}
+}
+
+void FrequencyCorrector::shift(const int32_t hz) {
+	offset -= hz;
+	update_step();
+}
+
+void FrequencyCorrector::update_step() {
+	const float w = (fs == 0) ? 0.0f : (-2.0f * pi * offset / fs);
+	step_re = std::cos(w);
+	step_im = std::sin(w);
+}
+
+bool FrequencyCorrector::execute(const buffer_c16_t& buffer) {
+	if( !tracking || (block_length == 0) ) {
+		return false;
+	}
+
+	bool report = false;
+	for(size_t i=0; i<buffer.count; i++) {
+		const float x_re = buffer.p[i].real();
+		const float x_im = buffer.p[i].imag();
+		const float y_re = x_re * phase_re - x_im * phase_im;
+		const float y_im = x_re * phase_im + x_im * phase_re;
+		buffer.p[i] = { static_cast<int16_t>(y_re), static_cast<int16_t>(y_im) };
+
+		const float next_re = phase_re * step_re - phase_im * step_im;
+		phase_im = phase_re * step_im + phase_im * step_re;
+		phase_re = next_re;
+
+		// y[n] * conj(y[n-1]): the phase step, weighted by signal power.
+		const float p_re = y_re * previous_re + y_im * previous_im;
+		const float p_im = y_im * previous_re - y_re * previous_im;
+		acc_re += p_re;
+		acc_im += p_im;
+		acc_power += y_re * y_re + y_im * y_im;
+		previous_re = y_re;
+		previous_im = y_im;
+
+		if( ++block_count >= block_length ) {
+			report = block_end();
+		}
+	}
+
+	// Keep the phasor on the unit circle, rounding walks it off slowly.
+	const float gain = 1.5f - 0.5f * (phase_re * phase_re + phase_im * phase_im);
+	phase_re *= gain;
+	phase_im *= gain;
+
+	return report;
+}
+
+bool FrequencyCorrector::block_end() {
+	const float magnitude = std::sqrt(acc_re * acc_re + acc_im * acc_im);
+	const bool locked = (acc_power > 0.0f) && (magnitude >= coherence_min * acc_power);
+	if( locked ) {
+		const float residual = std::atan2(acc_im, acc_re) * fs / (2.0f * pi);
+		offset = std::max(-range, std::min(range, offset + loop_gain * residual));
+		update_step();
+	}
+
+	block_count = 0;
+	acc_re = acc_im = acc_power = 0.0f;
+	return locked;
+}
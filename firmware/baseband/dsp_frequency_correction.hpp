@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_FREQUENCY_CORRECTION_H__
+#define __DSP_FREQUENCY_CORRECTION_H__
+
+#include "dsp_types.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+/* Fine frequency correction of a channel, below the resolution of the
+ * Si5351 reference trim (1ppm, 433Hz at 433MHz). Rotates the channel in
+ * place by -offset, and while tracking, measures what's left from the mean
+ * phase step of the rotated channel in 0.25s blocks, lag-1 autocorrelation.
+ * Noise averages out of the sum, so a block only counts if it's coherent
+ * enough to be a steady carrier (or FM on one).
+ */
+class FrequencyCorrector {
+public:
+	void configure(const uint32_t sampling_rate, const int32_t range_hz);
+
+	/* Off, the channel passes through and the correction is cleared. */
+	void set_tracking(const bool enabled);
+
+	/* The reference moved the channel down by hz, e.g. once the application
+	 * pushed a coarse correction to the Si5351.
+	 */
+	void shift(const int32_t hz);
+
+	/* True at the end of a locked block, offset_hz() is then worth reporting. */
+	bool execute(const buffer_c16_t& buffer);
+
+	int32_t offset_hz() const {
+		return offset;
+	}
+
+private:
+	static constexpr float block_seconds = 0.25f;
+	// |sum y[n]conj(y[n-1])| / sum |y|^2, noise alone gives ~1/sqrt(block_length).
+	static constexpr float coherence_min = 0.5f;
+	static constexpr float loop_gain = 0.5f;
+
+	bool tracking { false };
+	uint32_t fs { 0 };
+	float range { 0.0f };
+	float offset { 0.0f };
+
+	float phase_re { 1.0f };
+	float phase_im { 0.0f };
+	float step_re { 1.0f };
+	float step_im { 0.0f };
+
+	float previous_re { 0.0f };
+	float previous_im { 0.0f };
+	float acc_re { 0.0f };
+	float acc_im { 0.0f };
+	float acc_power { 0.0f };
+	size_t block_length { 0 };
+	size_t block_count { 0 };
+
+	void update_step();
+	bool block_end();
+};
+
+#endif/*__DSP_FREQUENCY_CORRECTION_H__*/
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2018 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_fsk_correlator.hpp"
+
+#include "constexpr_math.hpp"
+#include "utility.hpp"
+
+#include <utility>
+
+namespace dsp {
+
+namespace {
+
+constexpr size_t lo_table_log2 = 8;
+constexpr size_t lo_table_shift = 32 - lo_table_log2;
+constexpr uint32_t quarter_turn = 0x40000000;
+
+template<size_t... I>
+constexpr std::array<int16_t, sizeof...(I)> make_cosine(std::index_sequence<I...>) {
+	return { { constexpr_math::to_q15(constexpr_math::cos(2.0 * constexpr_math::pi * I / sizeof...(I)))... } };
+}
+
+LOCATE_IN_DATA_RAM constexpr std::array<int16_t, 1 << lo_table_log2> cosine_q15 {
+	make_cosine(std::make_index_sequence<1 << lo_table_log2>())
+};
+
+inline int32_t lo_cos(const uint32_t phase) {
+	return cosine_q15[phase >> lo_table_shift];
+}
+
+inline int32_t lo_sin(const uint32_t phase) {
+	return cosine_q15[(phase - quarter_turn) >> lo_table_shift];
+}
+
+} /* namespace */
+
+void FSKCorrelator::Tone::configure(const uint32_t sampling_rate, const uint32_t frequency, const size_t window) {
+	phase_inc = (static_cast<uint64_t>(frequency) << 32) / sampling_rate;
+	phase = window * phase_inc;
+	phase_delayed = 0;
+	i = 0;
+	q = 0;
+}
+
+void FSKCorrelator::Tone::update(const int32_t sample_in, const int32_t sample_out) {
+	// The leaving product is computed exactly as it was on entry, so the
+	// sums never drift.
+	i += ((sample_in * lo_cos(phase)) >> 15) - ((sample_out * lo_cos(phase_delayed)) >> 15);
+	q += ((sample_in * lo_sin(phase)) >> 15) - ((sample_out * lo_sin(phase_delayed)) >> 15);
+	phase += phase_inc;
+	phase_delayed += phase_inc;
+}
+
+int64_t FSKCorrelator::Tone::energy() const {
+	return static_cast<int64_t>(i) * i + static_cast<int64_t>(q) * q;
+}
+
+void FSKCorrelator::configure(
+	const uint32_t sampling_rate,
+	const uint32_t mark_frequency,
+	const uint32_t space_frequency,
+	const uint32_t baudrate
+) {
+	const size_t samples_per_bit = baudrate ? (sampling_rate / baudrate) : window_max;
+	window = (samples_per_bit > window_max) ? window_max : ((samples_per_bit < 1) ? 1 : samples_per_bit);
+	index = 0;
+	history.fill(0);
+
+	mark.configure(sampling_rate, mark_frequency, window);
+	space.configure(sampling_rate, space_frequency, window);
+}
+
+void FSKCorrelator::execute(const buffer_s16_t& src, uint8_t* const symbols) {
+	for(size_t n=0; n<src.count; n++) {
+		const int32_t sample_in = src.p[n];
+		const int32_t sample_out = history[index];
+		history[index] = sample_in;
+		if( ++index == window ) {
+			index = 0;
+		}
+
+		mark.update(sample_in, sample_out);
+		space.update(sample_in, sample_out);
+
+		symbols[n] = (mark.energy() > space.energy()) ? 1 : 0;
+	}
+}
+
+} /* namespace dsp */
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2018 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_FSK_CORRELATOR_H__
+#define __DSP_FSK_CORRELATOR_H__
+
+#include "dsp_types.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace dsp {
+
+/* Two tone FSK detection with a pair of quadrature correlators, each summed
+ * over a sliding window of one bit. Every sample adds its product with the
+ * tone's Q15 local oscillator and takes away the one leaving the window,
+ * recomputed from the delayed input and a second, lagging oscillator phase,
+ * so the sums are exact and the cost per sample doesn't depend on the
+ * window length.
+ *
+ * Windows are capped at window_max samples: 300 bauds at 24kHz.
+ */
+class FSKCorrelator {
+public:
+	static constexpr size_t window_max = 80;
+
+	void configure(
+		const uint32_t sampling_rate,
+		const uint32_t mark_frequency,
+		const uint32_t space_frequency,
+		const uint32_t baudrate
+	);
+
+	/* One symbol per sample into symbols: 1 where mark is the stronger
+	 * tone over the window ending at that sample.
+	 */
+	void execute(const buffer_s16_t& src, uint8_t* const symbols);
+
+private:
+	struct Tone {
+		uint32_t phase { 0 };
+		uint32_t phase_inc { 0 };
+		// Oscillator phase of the sample leaving the window
+		uint32_t phase_delayed { 0 };
+		int32_t i { 0 };
+		int32_t q { 0 };
+
+		void configure(const uint32_t sampling_rate, const uint32_t frequency, const size_t window);
+		void update(const int32_t sample_in, const int32_t sample_out);
+		int64_t energy() const;
+	};
+
+	std::array<int16_t, window_max> history { };
+	size_t window { 1 };
+	size_t index { 0 };
+
+	Tone mark { };
+	Tone space { };
+};
+
+} /* namespace dsp */
+
+#endif/*__DSP_FSK_CORRELATOR_H__*/
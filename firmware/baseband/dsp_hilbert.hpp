@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_HILBERT_H__
+#define __DSP_HILBERT_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <utility>
+
+#include "constexpr_math.hpp"
+#include "dsp_fir_design.hpp"
+
+#include "hal.h"
+
+namespace dsp {
+
+namespace detail {
+
+/* Type III Hilbert transformer, Kaiser windowed: h[k] = 2 / (pi * k) for
+ * odd k, zero for even. Only k = 1, 3, ... are stored, h[-k] = -h[k].
+ */
+constexpr size_t hilbert_length = 127;
+constexpr size_t hilbert_half = hilbert_length / 2;
+
+constexpr int16_t hilbert_tap(const size_t i, const double beta) {
+	return constexpr_math::to_q15(
+		2.0 / (constexpr_math::pi * (2 * i + 1)) *
+		fir_design::detail::kaiser(hilbert_half + 2 * i + 1, hilbert_length, beta)
+	);
+}
+
+template<size_t... I>
+constexpr std::array<int16_t, sizeof...(I)> make_hilbert(const double beta, std::index_sequence<I...>) {
+	return { { hilbert_tap(I, beta)... } };
+}
+
+constexpr std::array<int16_t, (hilbert_half + 1) / 2> hilbert_taps() {
+	return make_hilbert(
+		fir_design::detail::kaiser_beta(50.0),
+		std::make_index_sequence<(hilbert_half + 1) / 2>()
+	);
+}
+
+constexpr auto hilbert_q15 = hilbert_taps();
+
+} /* namespace detail */
+
+/* 127 tap Q15 Hilbert transform, 32 multiplies a sample. The output lags
+ * by delay samples, delayed() is the input lined up with it. Paired up as
+ * a phasing SSB (de)modulator, the opposite sideband is ~60dB down from
+ * fs / 80 to fs / 2 - fs / 80: 300Hz up at 24kHz, 150Hz at 12kHz.
+ */
+class HilbertTransform {
+public:
+	static constexpr size_t delay = detail::hilbert_half;
+
+	int16_t execute(const int16_t x) {
+		history[index] = x;
+		history[index + detail::hilbert_length] = x;
+		index = (index + 1 == detail::hilbert_length) ? 0 : (index + 1);
+
+		// Oldest to newest from history[index]
+		const int16_t* const center = &history[index + delay];
+		int32_t q = 1 << 14;
+		for(size_t t=0; t<detail::hilbert_q15.size(); t++) {
+			const size_t k = 2 * t + 1;
+			q += detail::hilbert_q15[t] * (center[-static_cast<int32_t>(k)] - center[k]);
+		}
+		return __SSAT(q >> 15, 16);
+	}
+
+	int16_t delayed() const {
+		return history[index + delay];
+	}
+
+private:
+	std::array<int16_t, detail::hilbert_length * 2> history { };
+	size_t index { 0 };
+};
+
+} /* namespace dsp */
+
+#endif/*__DSP_HILBERT_H__*/
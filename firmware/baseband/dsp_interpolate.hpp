@@ -0,0 +1,349 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_INTERPOLATE_H__
+#define __DSP_INTERPOLATE_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <utility>
+
+#include "dsp_types.hpp"
+#include "complex.hpp"
+#include "constexpr_math.hpp"
+#include "dsp_fir_design.hpp"
+#include "utility.hpp"
+
+#include "hal.h"
+
+namespace dsp {
+namespace interpolate {
+
+/* Integer upsampling of complex16 to complex8, for sending captures at a
+ * baseband rate above their own: a polyphase FIR doubles the rate, then a
+ * Stages deep CIC interpolator (combs at its input rate, integrators at
+ * its output rate, differential delay 1) does the remaining power of
+ * two. The FIR's pass band is shaped to the inverse of the CIC's
+ * sinc^Stages droop, so the lower 80% of the input band comes out flat,
+ * and its stop band above the input's Nyquist keeps the first image out
+ * before the CIC's nulls take care of the rest.
+ *
+ * The CIC's gain of interpolation^(Stages - 1) comes back out as a shift.
+ * As in the decimating CIC, registers are left to wrap; only the output's
+ * width has to fit in 32 bits.
+ *
+ * An interpolation of one is a plain conversion, two is the FIR alone
+ * (its compensation then peaks the pass band edge slightly).
+ */
+
+namespace detail {
+
+/* In cycles per FIR output sample: the input's Nyquist. */
+constexpr double cutoff = 0.25;
+constexpr double pass_edge = 0.2;
+constexpr double stop_edge = 0.3;
+
+/* Twice (for the zero stuffing) the inverse CIC droop, for the asymptotic
+ * sinc^Stages response; a small interpolation droops a little less.
+ */
+template<size_t Stages>
+constexpr double response(const double f) {
+	const double s = constexpr_math::sinc(f);
+	double d = 2.0;
+	for(size_t k=0; k<Stages; k++) {
+		d /= s;
+	}
+	return d;
+}
+
+/* Inverse transform of response() cut off at cutoff, by Simpson's rule. */
+template<size_t Stages>
+constexpr double impulse(const double t) {
+	constexpr size_t steps = 32;
+	const double step = cutoff / steps;
+	double sum = 0.0;
+	for(size_t k=0; k<=steps; k++) {
+		const double f = k * step;
+		const double weight = ((k == 0) || (k == steps)) ? 1.0 : ((k & 1) ? 4.0 : 2.0);
+		sum += weight * response<Stages>(f) * constexpr_math::cos(2.0 * constexpr_math::pi * f * t);
+	}
+	return 2.0 * sum * step / 3.0;
+}
+
+template<size_t Stages>
+constexpr double prototype(const size_t n, const size_t length, const double beta) {
+	return impulse<Stages>(n - (length - 1) / 2.0) * fir_design::detail::kaiser(n, length, beta);
+}
+
+template<size_t Stages>
+constexpr double prototype_sum(const size_t length, const double beta) {
+	double sum = 0.0;
+	for(size_t n=0; n<length; n++) {
+		sum += prototype<Stages>(n, length, beta);
+	}
+	return sum;
+}
+
+/* Stored by phase, each row reversed to run oldest to newest sample, as
+ * in resample::design(): row p, element r is h[p + (TapsPerPhase - 1 - r) * 2].
+ * Q14, each phase summing to unity.
+ */
+template<size_t Stages, size_t TapsPerPhase>
+constexpr int16_t coefficient(const size_t index, const double beta, const double scale) {
+	const size_t p = index / TapsPerPhase;
+	const size_t r = index % TapsPerPhase;
+	const size_t n = p + (TapsPerPhase - 1 - r) * 2;
+	return fir_design::detail::to_tap(prototype<Stages>(n, TapsPerPhase * 2, beta) * scale);
+}
+
+template<size_t Stages, size_t TapsPerPhase, size_t... I>
+constexpr std::array<int16_t, sizeof...(I)> make_taps(const double beta, std::index_sequence<I...>) {
+	return { { coefficient<Stages, TapsPerPhase>(I, beta, 2.0 * 16384.0 / prototype_sum<Stages>(TapsPerPhase * 2, beta))... } };
+}
+
+/* Comb and integrator registers for one stream. */
+template<size_t Stages>
+struct CICLane {
+	std::array<uint32_t, Stages> combs;
+	std::array<uint32_t, Stages> integrators;
+
+	uint32_t comb(const int32_t x) {
+		uint32_t v = x;
+		for(size_t s=0; s<Stages; s++) {
+			const uint32_t delayed = combs[s];
+			combs[s] = v;
+			v -= delayed;
+		}
+		return v;
+	}
+
+	int32_t integrate(const uint32_t x) {
+		uint32_t v = x;
+		for(size_t s=0; s<Stages; s++) {
+			v = integrators[s] += v;
+		}
+		return static_cast<int32_t>(v);
+	}
+};
+
+constexpr size_t cic_factor(const size_t interpolation) {
+	return (interpolation > 1) ? (interpolation / 2) : 1;
+}
+
+} /* namespace detail */
+
+template<size_t Stages, size_t TapsPerPhase>
+constexpr std::array<int16_t, 2 * TapsPerPhase> design() {
+	return detail::make_taps<Stages, TapsPerPhase>(
+		fir_design::detail::kaiser_beta(fir_design::detail::kaiser_attenuation(
+			TapsPerPhase * 2, detail::stop_edge - detail::pass_edge
+		)),
+		std::make_index_sequence<2 * TapsPerPhase>()
+	);
+}
+
+template<size_t Stages, size_t TapsPerPhase>
+class CompensatedCICInterpolator {
+public:
+	static constexpr size_t interpolation_max = 64;
+
+	static_assert(Stages > 0, "CIC needs at least one stage");
+	static_assert(16 + (Stages - 1) * log_2(interpolation_max / 2) <= 32, "CIC bit growth too large");
+
+	using taps_t = std::array<int16_t, 2 * TapsPerPhase>;
+
+	CompensatedCICInterpolator(
+		const taps_t& taps
+	) : taps_ { taps }
+	{
+	}
+
+	/* interpolation is a power of two up to interpolation_max. */
+	void configure(const size_t interpolation) {
+		interpolation_ = interpolation;
+		cic_factor = detail::cic_factor(interpolation);
+		shift = (Stages - 1) * log_2(cic_factor) + 8;
+		i_ = { };
+		q_ = { };
+		history_ = { };
+		index = 0;
+	}
+
+	/* dst must hold src.count * interpolation samples. */
+	buffer_c8_t execute(
+		const buffer_c16_t& src,
+		const buffer_c8_t& dst
+	) {
+		complex8_t* dst_p = dst.p;
+		if( interpolation_ == 1 ) {
+			for(size_t i=0; i<src.count; i++) {
+				*(dst_p++) = {
+					static_cast<int8_t>(__SSAT(src.p[i].real() >> 8, 8)),
+					static_cast<int8_t>(__SSAT(src.p[i].imag() >> 8, 8))
+				};
+			}
+		} else {
+			for(size_t i=0; i<src.count; i++) {
+				history_[index] = src.p[i];
+				history_[index + TapsPerPhase] = src.p[i];
+				index = (index + 1 == TapsPerPhase) ? 0 : (index + 1);
+
+				dst_p = cic(phase(0), dst_p);
+				dst_p = cic(phase(1), dst_p);
+			}
+		}
+
+		return { dst.p, src.count * interpolation_, src.sampling_rate * interpolation_ };
+	}
+
+private:
+	using Lane = detail::CICLane<Stages>;
+
+	const taps_t& taps_;
+	std::array<complex16_t, TapsPerPhase * 2> history_ { };
+	size_t index { 0 };
+	size_t interpolation_ { 1 };
+	size_t cic_factor { 1 };
+	size_t shift { 8 };
+	Lane i_ { };
+	Lane q_ { };
+
+	complex16_t phase(const size_t p) const {
+		const complex16_t* const s = &history_[index];
+		const int16_t* const h = &taps_[p * TapsPerPhase];
+		int32_t re = 1 << 13;
+		int32_t im = 1 << 13;
+		for(size_t r=0; r<TapsPerPhase; r++) {
+			re += s[r].real() * h[r];
+			im += s[r].imag() * h[r];
+		}
+		return {
+			static_cast<int16_t>(__SSAT(re >> 14, 16)),
+			static_cast<int16_t>(__SSAT(im >> 14, 16))
+		};
+	}
+
+	/* One comb step, then cic_factor integrator steps on it and the
+	 * stuffed zeros after.
+	 */
+	complex8_t* cic(const complex16_t x, complex8_t* dst_p) {
+		uint32_t ci = i_.comb(x.real());
+		uint32_t cq = q_.comb(x.imag());
+		for(size_t k=0; k<cic_factor; k++) {
+			*(dst_p++) = {
+				static_cast<int8_t>(__SSAT(i_.integrate(ci) >> shift, 8)),
+				static_cast<int8_t>(__SSAT(q_.integrate(cq) >> shift, 8))
+			};
+			ci = 0;
+			cq = 0;
+		}
+		return dst_p;
+	}
+};
+
+/* The same for real int16 streams, int16 out: audio on its way to a
+ * modulator. Taps are the same design(). An interpolation of one is a
+ * plain copy.
+ */
+template<size_t Stages, size_t TapsPerPhase>
+class CompensatedCICInterpolatorReal {
+public:
+	static constexpr size_t interpolation_max = 64;
+
+	static_assert(Stages > 0, "CIC needs at least one stage");
+	static_assert(16 + (Stages - 1) * log_2(interpolation_max / 2) <= 32, "CIC bit growth too large");
+
+	using taps_t = std::array<int16_t, 2 * TapsPerPhase>;
+
+	CompensatedCICInterpolatorReal(
+		const taps_t& taps
+	) : taps_ { taps }
+	{
+	}
+
+	/* interpolation is a power of two up to interpolation_max. */
+	void configure(const size_t interpolation) {
+		interpolation_ = interpolation;
+		cic_factor = detail::cic_factor(interpolation);
+		shift = (Stages - 1) * log_2(cic_factor);
+		lane = { };
+		history_ = { };
+		index = 0;
+	}
+
+	/* dst must hold src.count * interpolation samples. */
+	buffer_s16_t execute(
+		const buffer_s16_t& src,
+		const buffer_s16_t& dst
+	) {
+		int16_t* dst_p = dst.p;
+		if( interpolation_ == 1 ) {
+			for(size_t i=0; i<src.count; i++) {
+				*(dst_p++) = src.p[i];
+			}
+		} else {
+			for(size_t i=0; i<src.count; i++) {
+				history_[index] = src.p[i];
+				history_[index + TapsPerPhase] = src.p[i];
+				index = (index + 1 == TapsPerPhase) ? 0 : (index + 1);
+
+				dst_p = cic(phase(0), dst_p);
+				dst_p = cic(phase(1), dst_p);
+			}
+		}
+
+		return { dst.p, src.count * interpolation_, src.sampling_rate * interpolation_ };
+	}
+
+private:
+	const taps_t& taps_;
+	std::array<int16_t, TapsPerPhase * 2> history_ { };
+	size_t index { 0 };
+	size_t interpolation_ { 1 };
+	size_t cic_factor { 1 };
+	size_t shift { 0 };
+	detail::CICLane<Stages> lane { };
+
+	int16_t phase(const size_t p) const {
+		const int16_t* const s = &history_[index];
+		const int16_t* const h = &taps_[p * TapsPerPhase];
+		int32_t acc = 1 << 13;
+		for(size_t r=0; r<TapsPerPhase; r++) {
+			acc += s[r] * h[r];
+		}
+		return __SSAT(acc >> 14, 16);
+	}
+
+	int16_t* cic(const int16_t x, int16_t* dst_p) {
+		uint32_t c = lane.comb(x);
+		for(size_t k=0; k<cic_factor; k++) {
+			*(dst_p++) = __SSAT(lane.integrate(c) >> shift, 16);
+			c = 0;
+		}
+		return dst_p;
+	}
+};
+
+} /* namespace interpolate */
+} /* namespace dsp */
+
+#endif/*__DSP_INTERPOLATE_H__*/
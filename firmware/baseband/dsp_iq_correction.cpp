@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_iq_correction.hpp"
+
+#include <hal.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+uint32_t pack_lanes(const int32_t i, const int32_t q) {
+	const uint32_t pair = (static_cast<uint8_t>(q) << 8) | static_cast<uint8_t>(i);
+	return (pair << 16) | pair;
+}
+
+} /* namespace */
+
+void IQCorrector::reset() {
+	*this = { };
+}
+
+void IQCorrector::execute(const buffer_c8_t& buffer) {
+	estimate(buffer);
+	update_coefficients();
+	correct(buffer);
+}
+
+void IQCorrector::estimate(const buffer_c8_t& buffer) {
+	// Raw sums from the start of the buffer, two samples a word.
+	const size_t count = std::min(buffer.count, estimate_samples) & ~1U;
+	if( count == 0 ) {
+		return;
+	}
+
+	const uint32_t* p = reinterpret_cast<const uint32_t*>(buffer.p);
+	const uint32_t* const end = reinterpret_cast<const uint32_t*>(&buffer.p[count]);
+	constexpr uint32_t ones = 0x00010001;
+	int32_t sum_i = 0;
+	int32_t sum_q = 0;
+	int32_t sum_ii = 0;
+	int32_t sum_qq = 0;
+	int32_t sum_iq = 0;
+	while(p < end) {
+		const uint32_t q1_i1_q0_i0 = *(p++);
+		const uint32_t i1_i0 = __SXTB16(q1_i1_q0_i0, 0);
+		const uint32_t q1_q0 = __SXTB16(q1_i1_q0_i0, 8);
+		sum_i = __SMLAD(i1_i0, ones, sum_i);
+		sum_q = __SMLAD(q1_q0, ones, sum_q);
+		sum_ii = __SMLAD(i1_i0, i1_i0, sum_ii);
+		sum_qq = __SMLAD(q1_q0, q1_q0, sum_qq);
+		sum_iq = __SMLAD(i1_i0, q1_q0, sum_iq);
+	}
+
+	const float k = 1.0f / count;
+	const float mean_i = sum_i * k;
+	const float mean_q = sum_q * k;
+	dc_i += (mean_i - dc_i) * dc_alpha;
+	dc_q += (mean_q - dc_q) * dc_alpha;
+	var_i += ((sum_ii * k - mean_i * mean_i) - var_i) * iq_alpha;
+	var_q += ((sum_qq * k - mean_q * mean_q) - var_q) * iq_alpha;
+	cov_iq += ((sum_iq * k - mean_i * mean_q) - cov_iq) * iq_alpha;
+}
+
+void IQCorrector::update_coefficients() {
+	const float floor_i = std::max(std::min(std::floor(dc_i), 126.0f), -128.0f);
+	const float floor_q = std::max(std::min(std::floor(dc_q), 126.0f), -128.0f);
+	dc_floor = pack_lanes(floor_i, floor_q);
+	dc_ceiling = pack_lanes(floor_i + 1, floor_q + 1);
+	dc_fraction = pack_lanes(
+		std::min((dc_i - floor_i) * 256.0f, 255.0f),
+		std::min((dc_q - floor_q) * 256.0f, 255.0f)
+	);
+
+	// Too little signal to tell, keep what there was.
+	constexpr float var_min = 1.0f;
+	if( (var_i < var_min) || (var_q < var_min) ) {
+		return;
+	}
+
+	// Q minus its projection on I, scaled back to I's power.
+	const float p = cov_iq / var_i;
+	const float var_orthogonal = var_q - p * cov_iq;
+	if( (std::abs(p) > 0.5f) || (var_orthogonal < (var_q * 0.25f)) ) {
+		return;
+	}
+	const float a = std::sqrt(var_i / var_orthogonal);
+	const float b = -a * p;
+
+	constexpr float unity = 1 << coefficient_shift;
+	const int32_t a_q12 = std::round(a * unity);
+	const int32_t b_q12 = std::round(b * unity);
+	coefficients = (static_cast<uint32_t>(a_q12) << 16) | (static_cast<uint32_t>(b_q12) & 0xffff);
+
+	// Under half an LSB at full scale.
+	constexpr int32_t negligible = (1 << coefficient_shift) / 256;
+	imbalanced = (std::abs(a_q12 - (1 << coefficient_shift)) >= negligible) || (std::abs(b_q12) >= negligible);
+}
+
+void IQCorrector::correct(const buffer_c8_t& buffer) {
+	uint32_t* p = reinterpret_cast<uint32_t*>(buffer.p);
+	uint32_t* const end = reinterpret_cast<uint32_t*>(&buffer.p[buffer.count & ~1U]);
+	constexpr int32_t round = 1 << (coefficient_shift - 1);
+	while(p < end) {
+		dither = __UADD8(dither, dc_fraction);
+		uint32_t q1_i1_q0_i0 = __QSUB8(*p, __SEL(dc_ceiling, dc_floor));
+
+		if( imbalanced ) {
+			const uint32_t i1_i0 = __SXTB16(q1_i1_q0_i0, 0);
+			const uint32_t q1_q0 = __SXTB16(q1_i1_q0_i0, 8);
+			const int32_t q0 = __SSAT(__SMLAD(coefficients, __PKHBT(i1_i0, q1_q0, 16), round) >> coefficient_shift, 8);
+			const int32_t q1 = __SSAT(__SMLAD(coefficients, __PKHTB(q1_q0, i1_i0, 16), round) >> coefficient_shift, 8);
+			q1_i1_q0_i0 = (q1_i1_q0_i0 & 0x00ff00ff)
+				| ((static_cast<uint32_t>(q0) & 0xff) << 8)
+				| ((static_cast<uint32_t>(q1) & 0xff) << 24);
+		}
+
+		*(p++) = q1_i1_q0_i0;
+	}
+}
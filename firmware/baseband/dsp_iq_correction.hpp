@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_IQ_CORRECTION_H__
+#define __DSP_IQ_CORRECTION_H__
+
+#include "dsp_types.hpp"
+#include "stage_profiler.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+/* DC offset and IQ imbalance removal on the raw baseband, in place, for
+ * processors that run an IQCorrectionStage from correct_iq().
+ * Blind and adaptive: each buffer's start gives the means and covariance
+ * of I and Q, smoothed over 16 buffers for DC and 128 for the imbalance
+ * (10ms and 85ms of 2048 samples at 3.072MHz).
+ *
+ * DC comes off with a saturating byte subtract. Its fraction of an LSB
+ * goes by per-lane sigma-delta (carries out of UADD8 pick floor or
+ * ceiling), which leaves no mean and moves the remainder away from DC.
+ * Q is then rebuilt as a * Q + b * I, orthogonal to I and of the same
+ * power, which cancels the mirror image; skipped while that's a change of
+ * under half an LSB.
+ */
+class IQCorrector {
+public:
+	void reset();
+	void execute(const buffer_c8_t& buffer);
+
+private:
+	static constexpr size_t estimate_samples = 512;
+	static constexpr float dc_alpha = 1.0f / 16.0f;
+	static constexpr float iq_alpha = 1.0f / 128.0f;
+	static constexpr int32_t coefficient_shift = 12;
+
+	float dc_i { 0.0f };
+	float dc_q { 0.0f };
+	float var_i { 0.0f };
+	float var_q { 0.0f };
+	float cov_iq { 0.0f };
+
+	// Packed [q1 i1 q0 i0] bytes.
+	uint32_t dc_floor { 0 };
+	uint32_t dc_ceiling { 0 };
+	uint32_t dc_fraction { 0 };
+	uint32_t dither { 0 };
+
+	// b in the low half, a in the high, Q12.
+	uint32_t coefficients { 1U << (16 + coefficient_shift) };
+	bool imbalanced { false };
+
+	void estimate(const buffer_c8_t& buffer);
+	void update_coefficients();
+	void correct(const buffer_c8_t& buffer);
+};
+
+/* A processor's IQCorrector, profiled as the "iq_corr" stage, the last row
+ * of the table; the processor numbers its own stages from 0. It starts
+ * over with each processor.
+ */
+class IQCorrectionStage {
+public:
+	void execute(const buffer_c8_t& buffer) {
+		const ProfilerScope scope { profile };
+		corrector.execute(buffer);
+	}
+
+private:
+	IQCorrector corrector { };
+	ProfilerStage profile { ProfilerTable::stages_max - 1, "iq_corr" };
+};
+
+#endif/*__DSP_IQ_CORRECTION_H__*/
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_MODULATE_H__
+#define __DSP_MODULATE_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <algorithm>
+#include <utility>
+
+#include "dsp_types.hpp"
+#include "complex.hpp"
+#include "dsp_hilbert.hpp"
+#include "dsp_interpolate.hpp"
+#include "sine_table_c8.hpp"
+
+#include "hal.h"
+
+namespace dsp {
+namespace modulate {
+
+/* Modulations of Q15 audio, for TxModulator. FM runs on the interpolated
+ * audio, at the baseband rate. The others make complex16 baseband at the
+ * audio rate, which is interpolated after.
+ */
+
+/* deviation_hz at Q15 full scale. */
+class FM {
+public:
+	static constexpr bool complex_baseband = false;
+
+	void configure(const float deviation_hz, const uint32_t sampling_rate) {
+		// Phase step of a full scale sample, in 1/2^32 turns
+		delta = deviation_hz * ((float)(1ULL << 17) / sampling_rate);
+	}
+
+	void execute(const buffer_s16_t& src, complex8_t* const dst) {
+		for(size_t i=0; i<src.count; i++) {
+			phase += src.p[i] * delta;
+			dst[i] = carrier[phase];
+		}
+	}
+
+private:
+	const ComplexSineTableI8 carrier { };
+	uint32_t delta { 0 };
+	uint32_t phase { 0 };
+};
+
+/* Carrier at half scale, depth (0 to 1) at Q15 full scale. */
+class AM {
+public:
+	static constexpr bool complex_baseband = true;
+
+	void configure(const float depth) {
+		depth_q15 = depth * 32767.0f;
+	}
+
+	void execute(const buffer_s16_t& src, complex16_t* const dst) {
+		for(size_t i=0; i<src.count; i++) {
+			dst[i] = { static_cast<int16_t>(16384 + ((src.p[i] * depth_q15) >> 16)), 0 };
+		}
+	}
+
+private:
+	int32_t depth_q15 { 32767 };
+};
+
+/* Suppressed carrier double sideband. */
+class DSB {
+public:
+	static constexpr bool complex_baseband = true;
+
+	void execute(const buffer_s16_t& src, complex16_t* const dst) {
+		for(size_t i=0; i<src.count; i++) {
+			dst[i] = { src.p[i], 0 };
+		}
+	}
+};
+
+/* I is the audio, Q its Hilbert transform (negated for the lower
+ * sideband), both delayed by 63 samples. At 24kHz the opposite sideband
+ * is ~60dB down from 300Hz, the bottom of the mic's band, up.
+ */
+template<bool Upper>
+class SSB {
+public:
+	static constexpr bool complex_baseband = true;
+
+	void execute(const buffer_s16_t& src, complex16_t* const dst) {
+		for(size_t i=0; i<src.count; i++) {
+			const auto q = hilbert.execute(src.p[i]);
+			dst[i] = { hilbert.delayed(), static_cast<int16_t>(Upper ? q : -q) };
+		}
+	}
+
+private:
+	HilbertTransform hilbert { };
+};
+
+using USB = SSB<true>;
+using LSB = SSB<false>;
+
+/* Audio to baseband, the TX back end shared by the audio processors:
+ * the modulation, and CompensatedCIC interpolation from the audio rate
+ * (a power of two below the baseband rate, up to 64) to the baseband's.
+ * The Modulation is picked at compile time, and with it on which side
+ * of the interpolator it runs.
+ */
+template<class Modulation, bool Complex = Modulation::complex_baseband>
+class TxModulator;
+
+template<class Modulation>
+class TxModulator<Modulation, false> {
+public:
+	TxModulator() {
+		upsampler.configure(interpolation_);
+	}
+
+	void configure(const size_t interpolation) {
+		interpolation_ = interpolation;
+		upsampler.configure(interpolation);
+	}
+
+	Modulation& modulation() {
+		return modulation_;
+	}
+
+	/* dst must hold audio.count * interpolation samples. */
+	void execute(const buffer_s16_t& audio, const buffer_c8_t& dst) {
+		const size_t step = block_max / interpolation_;
+		for(size_t n=0; n<audio.count; n+=step) {
+			const size_t count = std::min(step, audio.count - n);
+			const auto upsampled = upsampler.execute(
+				{ &audio.p[n], count, audio.sampling_rate },
+				{ block.data(), block.size(), audio.sampling_rate * interpolation_ }
+			);
+			modulation_.execute(upsampled, &dst.p[n * interpolation_]);
+		}
+	}
+
+private:
+	using Interpolator = interpolate::CompensatedCICInterpolatorReal<3, 8>;
+
+	static constexpr size_t block_max = 2048;
+	static constexpr Interpolator::taps_t taps = interpolate::design<3, 8>();
+
+	Modulation modulation_ { };
+	Interpolator upsampler { taps };
+	size_t interpolation_ { 1 };
+	std::array<int16_t, block_max> block { };
+};
+
+template<class Modulation>
+constexpr typename TxModulator<Modulation, false>::Interpolator::taps_t TxModulator<Modulation, false>::taps;
+
+template<class Modulation>
+class TxModulator<Modulation, true> {
+public:
+	TxModulator() {
+		upsampler.configure(interpolation_);
+	}
+
+	void configure(const size_t interpolation) {
+		interpolation_ = interpolation;
+		upsampler.configure(interpolation);
+	}
+
+	Modulation& modulation() {
+		return modulation_;
+	}
+
+	/* dst must hold audio.count * interpolation samples. */
+	void execute(const buffer_s16_t& audio, const buffer_c8_t& dst) {
+		for(size_t n=0; n<audio.count; n+=block.size()) {
+			const size_t count = std::min(block.size(), audio.count - n);
+			modulation_.execute({ &audio.p[n], count, audio.sampling_rate }, block.data());
+			upsampler.execute(
+				{ block.data(), count, audio.sampling_rate },
+				{ &dst.p[n * interpolation_], count * interpolation_, audio.sampling_rate * interpolation_ }
+			);
+		}
+	}
+
+private:
+	using Interpolator = interpolate::CompensatedCICInterpolator<3, 8>;
+
+	static constexpr Interpolator::taps_t taps = interpolate::design<3, 8>();
+
+	Modulation modulation_ { };
+	Interpolator upsampler { taps };
+	size_t interpolation_ { 1 };
+	std::array<complex16_t, 64> block { };
+};
+
+template<class Modulation>
+constexpr typename TxModulator<Modulation, true>::Interpolator::taps_t TxModulator<Modulation, true>::taps;
+
+} /* namespace modulate */
+} /* namespace dsp */
+
+#endif/*__DSP_MODULATE_H__*/
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_mpx.hpp"
+
+#include "sine_table.hpp"
+
+#include <hal.h>
+
+#include <algorithm>
+
+namespace dsp {
+namespace mpx {
+
+namespace {
+
+// 32 bit phase, 256 entry table with linear interpolation.
+inline void sin_cos(const uint32_t phase, float& s, float& c) {
+	constexpr float frac_k = 1.0f / (1 << 24);
+	const float frac = (phase & 0xffffff) * frac_k;
+
+	const size_t n_s = phase >> 24;
+	s = sine_table_f32[n_s] + frac * (sine_table_f32[n_s + 1] - sine_table_f32[n_s]);
+
+	const size_t n_c = (phase + 0x40000000) >> 24;
+	c = sine_table_f32[n_c] + frac * (sine_table_f32[n_c + 1] - sine_table_f32[n_c]);
+}
+
+} /* namespace */
+
+/* RDSDemodulator *******************************************************/
+
+bool RDSDemodulator::execute(const std::complex<float> z, uint_fast8_t& bit) {
+	if( chip_phase < 0x80000000U ) {
+		first_half += z;
+	} else {
+		second_half += z;
+	}
+
+	const auto last_phase = chip_phase;
+	chip_phase += chip_phase_inc;
+	if( chip_phase >= last_phase ) {
+		return false;
+	}
+
+	const auto chip = first_half + second_half;
+
+	// Gardner, on the integral straddling the previous chip boundary.
+	// Positive when late, so the clock is advanced.
+	const auto mid = prev_second_half + first_half;
+	const float energy = std::norm(chip) + std::norm(prev_chip) + 1e-12f;
+	const float error = std::real((chip - prev_chip) * std::conj(mid)) / energy;
+	const int32_t adjust = error * timing_gain * 4294967296.0f;
+	chip_phase = ((adjust < 0) && (chip_phase < static_cast<uint32_t>(-adjust))) ? 0 : chip_phase + adjust;
+
+	prev_second_half = second_half;
+	first_half = { };
+	second_half = { };
+
+	const bool ready = consume_chip(chip, bit);
+	prev_chip = chip;
+	return ready;
+}
+
+bool RDSDemodulator::consume_chip(const std::complex<float> chip, uint_fast8_t& bit) {
+	// Biphase: a symbol is a chip followed by its inverse. Only one of the
+	// two ways to pair chips always straddles that mid-symbol flip.
+	const auto symbol = prev_chip - chip;
+	chip_parity ^= 1;
+	pairing_energy[chip_parity] = pairing_energy[chip_parity] * 0.98f + std::norm(symbol);
+	if( pairing_energy[chip_parity] < pairing_energy[chip_parity ^ 1] ) {
+		return false;
+	}
+
+	// Differential coding: a 1 flips the carrier phase.
+	bit = (std::real(symbol * std::conj(prev_symbol)) < 0.0f) ? 1 : 0;
+	prev_symbol = symbol;
+	return true;
+}
+
+/* RDSBlockDecoder ******************************************************/
+
+bool RDSBlockDecoder::execute(const uint_fast8_t bit) {
+	shift_register = ((shift_register << 1) | bit) & ((1U << block_length) - 1);
+	bits++;
+
+	if( !synced ) {
+		const int offset = offset_index(shift_register);
+		if( offset < 0 ) {
+			return false;
+		}
+
+		// C' stands in for C.
+		const int index = (offset == 4) ? 2 : offset;
+		const bool in_sequence = (last_offset >= 0) && (bits == block_length) && (index == ((last_offset + 1) & 3));
+		last_offset = index;
+		bits = 0;
+		if( !in_sequence ) {
+			return false;
+		}
+
+		synced = true;
+		bad_blocks = 0;
+		valid_ = 0;
+		return end_block(index, true);
+	}
+
+	if( bits < block_length ) {
+		return false;
+	}
+	bits = 0;
+
+	const int offset = offset_index(shift_register);
+	const bool good = (offset == static_cast<int>(block_index)) || ((block_index == 2) && (offset == 4));
+	if( good ) {
+		bad_blocks = 0;
+	} else if( ++bad_blocks >= max_bad_blocks ) {
+		synced = false;
+		last_offset = -1;
+	}
+
+	return end_block(block_index, good);
+}
+
+bool RDSBlockDecoder::end_block(const size_t index, const bool good) {
+	if( index == 0 ) {
+		valid_ = 0;
+	}
+	group_[index] = shift_register >> 10;
+	if( good ) {
+		valid_ |= 1 << index;
+	}
+	block_index = (index + 1) & 3;
+
+	return (index == 3) && (valid_ != 0);
+}
+
+uint16_t RDSBlockDecoder::checkword(const uint16_t data) {
+	// g(x) = x^10 + x^8 + x^7 + x^5 + x^4 + x^3 + 1
+	constexpr uint32_t poly = 0x5b9;
+	uint32_t r = static_cast<uint32_t>(data) << 10;
+	for(size_t i=25; i>=10; i--) {
+		if( r & (1U << i) ) {
+			r ^= poly << (i - 10);
+		}
+	}
+	return r;
+}
+
+int RDSBlockDecoder::offset_index(const uint32_t block) {
+	// A, B, C, D, C'
+	constexpr std::array<uint16_t, 5> offsets { { 0x0fc, 0x198, 0x168, 0x1b4, 0x350 } };
+
+	const uint16_t syndrome = checkword(block >> 10) ^ (block & 0x3ff);
+	for(size_t i=0; i<offsets.size(); i++) {
+		if( syndrome == offsets[i] ) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/* MPXDecoder ***********************************************************/
+
+void MPXDecoder::configure(const bool stereo_enabled) {
+	stereo_enabled_ = stereo_enabled;
+}
+
+buffer_s16_t MPXDecoder::execute(const buffer_s16_t& mpx, const buffer_s16_t& side) {
+	constexpr float k = 1.0f / 32768.0f;
+	constexpr float phase_k = 4294967296.0f / (2.0f * pi);
+	constexpr float pilot_w = 2.0f * pi * 19000.0f / sampling_rate;
+
+	// ~10Hz loop bandwidth for a nominal 9% pilot (0.045 detector gain).
+	constexpr float kp = 0.0103f;
+	constexpr float ki = 2.4e-6f;
+	constexpr float freq_max = 2.0f * pi * 20.0f / sampling_rate;
+
+	// 2x to demodulate DSB, and about 1/0.82 for the droop of the first
+	// audio CIC at 38kHz, which L+R doesn't get.
+	constexpr float side_gain = 2.0f * 1.22f * 32768.0f;
+
+	float in_phase = 0.0f;
+
+	for(size_t i=0; i<mpx.count; i++) {
+		const float x = mpx.p[i] * k;
+
+		float s, c;
+		sin_cos(pilot_phase, s, c);
+
+		// cos() tracks the pilot: -x * sin() ~ sin(pilot - nco) * amplitude / 2
+		const float error = -x * s;
+		in_phase += x * c;
+		pilot_freq = std::max(-freq_max, std::min(freq_max, pilot_freq + ki * error));
+		pilot_phase += static_cast<int32_t>((pilot_w + pilot_freq + kp * error) * phase_k);
+
+		const float sin2 = 2.0f * s * c;
+		const float cos2 = c * c - s * s;
+
+		// Pilot is sin(wt) and the L-R carrier sin(2wt), which is -sin(2 * nco)
+		side.p[i] = __SSAT(static_cast<int32_t>(-x * sin2 * side_gain), 16);
+
+		const float sin3 = s * cos2 + c * sin2;
+		const float cos3 = c * cos2 - s * sin2;
+		const std::complex<float> z { x * cos3, -x * sin3 };
+
+		rds_sum += z;
+		rds_ramp += z * static_cast<float>(rds_index);
+		if( ++rds_index == rds_decimation ) {
+			// Triangular window: rising over the previous block, falling over this one.
+			const auto y = rds_prev_ramp + rds_prev_sum + rds_sum * static_cast<float>(rds_decimation - 1) - rds_ramp;
+			rds_prev_sum = rds_sum;
+			rds_prev_ramp = rds_ramp;
+			rds_sum = { };
+			rds_ramp = { };
+			rds_index = 0;
+
+			uint_fast8_t bit;
+			if( rds_demod.execute(y, bit) && rds_decoder.execute(bit) ) {
+				group_ready = true;
+			}
+		}
+	}
+
+	if( mpx.count ) {
+		pilot_level += 0.02f * (in_phase / mpx.count - pilot_level);
+	}
+	// Hysteresis around a third of the nominal level
+	pilot_locked = pilot_level > (pilot_locked ? 0.01f : 0.02f);
+
+	return { side.p, mpx.count, mpx.sampling_rate };
+}
+
+} /* namespace mpx */
+} /* namespace dsp */
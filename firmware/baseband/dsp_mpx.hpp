@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_MPX_H__
+#define __DSP_MPX_H__
+
+#include "dsp_types.hpp"
+#include "complex.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace dsp {
+namespace mpx {
+
+/* RDS biphase chips to differentially decoded data bits, from the 57kHz
+ * subcarrier mixed down to 0Hz at 12kHz. Chips are integrated and dumped
+ * with Gardner timing recovery, and chip pairs are aligned to symbols by
+ * energy. Comparing consecutive symbols makes the carrier phase (in phase
+ * or quadrature with the pilot's third harmonic) irrelevant.
+ */
+class RDSDemodulator {
+public:
+	static constexpr uint32_t sampling_rate = 12000;
+
+	// True when a data bit is ready in bit.
+	bool execute(const std::complex<float> z, uint_fast8_t& bit);
+
+private:
+	static constexpr uint32_t chip_rate = 2375;
+	static constexpr uint32_t chip_phase_inc = (uint64_t(chip_rate) << 32) / sampling_rate;
+	static constexpr float timing_gain = 0.02f;
+
+	uint32_t chip_phase { 0 };
+	std::complex<float> first_half { };
+	std::complex<float> second_half { };
+	std::complex<float> prev_second_half { };
+	std::complex<float> prev_chip { };
+	std::complex<float> prev_symbol { };
+	std::array<float, 2> pairing_energy { };
+	size_t chip_parity { 0 };
+
+	bool consume_chip(const std::complex<float> chip, uint_fast8_t& bit);
+};
+
+/* RDS block synchronization and group assembly. Blocks are 16 data bits
+ * and a 10 bit checkword XORed with the block's offset word. Sync is
+ * declared on two blocks in sequence 26 bits apart, and dropped after
+ * max_bad_blocks consecutive failed checks.
+ */
+class RDSBlockDecoder {
+public:
+	// True when a group is complete.
+	bool execute(const uint_fast8_t bit);
+
+	const std::array<uint16_t, 4>& group() const {
+		return group_;
+	}
+
+	// Bit n set when block n (A, B, C or C', D) passed its check.
+	uint8_t valid() const {
+		return valid_;
+	}
+
+private:
+	static constexpr size_t block_length = 26;
+	static constexpr size_t max_bad_blocks = 8;
+
+	uint32_t shift_register { 0 };
+	bool synced { false };
+	size_t bits { 0 };
+	size_t block_index { 0 };
+	size_t bad_blocks { 0 };
+	int last_offset { -1 };
+
+	std::array<uint16_t, 4> group_ { };
+	uint8_t valid_ { 0 };
+
+	bool end_block(const size_t index, const bool good);
+
+	static uint16_t checkword(const uint16_t data);
+	static int offset_index(const uint32_t block);
+};
+
+/* Stereo and RDS from one pass over the 192kHz MPX signal. A PLL locks
+ * to the 19kHz pilot; its doubled phase demodulates L-R at 38kHz and its
+ * tripled phase mixes the 57kHz RDS subcarrier to 0Hz. The RDS branch is
+ * decimated by 16 with a triangular (CIC2) window before the symbol
+ * demodulator.
+ */
+class MPXDecoder {
+public:
+	static constexpr uint32_t sampling_rate = 192000;
+
+	void configure(const bool stereo_enabled);
+
+	/* Writes L-R, same scale as MPX, into side (which must hold
+	 * mpx.count samples).
+	 */
+	buffer_s16_t execute(const buffer_s16_t& mpx, const buffer_s16_t& side);
+
+	bool stereo() const {
+		return stereo_enabled_ && pilot_locked;
+	}
+
+	// True once after execute() completed an RDS group.
+	bool rds_group_ready() {
+		const auto ready = group_ready;
+		group_ready = false;
+		return ready;
+	}
+
+	const RDSBlockDecoder& rds() const {
+		return rds_decoder;
+	}
+
+private:
+	static constexpr size_t rds_decimation = sampling_rate / RDSDemodulator::sampling_rate;
+
+	bool stereo_enabled_ { false };
+	bool pilot_locked { false };
+	bool group_ready { false };
+
+	uint32_t pilot_phase { 0 };
+	float pilot_freq { 0.0f };
+	float pilot_level { 0.0f };
+
+	std::complex<float> rds_sum { };
+	std::complex<float> rds_ramp { };
+	std::complex<float> rds_prev_sum { };
+	std::complex<float> rds_prev_ramp { };
+	size_t rds_index { 0 };
+
+	RDSDemodulator rds_demod { };
+	RDSBlockDecoder rds_decoder { };
+};
+
+} /* namespace mpx */
+} /* namespace dsp */
+
+#endif/*__DSP_MPX_H__*/
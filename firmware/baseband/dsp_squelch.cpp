@@ -23,23 +23,26 @@
 
 #include <cstdint>
 #include <array>
+#include <algorithm>
+#include <cmath>
 
-bool FMSquelch::execute(const buffer_f32_t& audio) {
-	if( threshold_squared == 0.0f ) {
+bool FMSquelch::execute(const buffer_s16_t& audio) {
+	if( threshold_squared == 0 ) {
 		return true;
 	}
 
 	// TODO: No hard-coded array size.
-	std::array<float, N> squelch_energy_buffer;
-	const buffer_f32_t squelch_energy {
+	std::array<int16_t, N> squelch_energy_buffer;
+	const buffer_s16_t squelch_energy {
 		squelch_energy_buffer.data(),
-		squelch_energy_buffer.size()
+		std::min(audio.count, N)
 	};
 	non_audio_hpf.execute(audio, squelch_energy);
 
-	float non_audio_max_squared = 0;
-	for(const auto sample : squelch_energy_buffer) {
-		const float sample_squared = sample * sample;
+	uint32_t non_audio_max_squared = 0;
+	for(size_t i=0; i<squelch_energy.count; i++) {
+		const int32_t sample = squelch_energy_buffer[i];
+		const uint32_t sample_squared = sample * sample;
 		if( sample_squared > non_audio_max_squared ) {
 			non_audio_max_squared = sample_squared;
 		}
@@ -49,5 +52,7 @@ bool FMSquelch::execute(const buffer_f32_t& audio) {
 }
 
 void FMSquelch::set_threshold(const float new_value) {
-	threshold_squared = new_value * new_value;
+	// Q15 to match the audio, full scale at most so the square fits
+	const float threshold = std::min(std::abs(new_value), 1.0f) * 32768.0f;
+	threshold_squared = threshold * threshold;
 }
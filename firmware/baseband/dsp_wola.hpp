@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2018 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_WOLA_H__
+#define __DSP_WOLA_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <utility>
+
+#include "complex.hpp"
+#include "constexpr_math.hpp"
+
+#include "hal.h"
+
+namespace dsp {
+namespace wola {
+
+/* Window-overlap-add (weighted presum) front end for a spectrum FFT.
+ *
+ * A window spanning several FFT lengths is applied to the input, and the
+ * windowed segments are folded (overlap-added) modulo the FFT length. The
+ * window is a Blackman-Harris tapered sinc, so each FFT bin behaves like a
+ * polyphase filter bank channel with far lower sidelobes than a plain
+ * rectangular or three-point frequency-domain window.
+ *
+ * Window tables are generated at compile time and only the first half of
+ * each (symmetric) window is stored, to keep M4 code RAM usage down.
+ */
+
+constexpr size_t fft_size = 256;
+constexpr size_t max_taps = 4;
+
+namespace detail {
+
+constexpr double blackman_harris(const size_t n, const size_t length) {
+	const double k = 2.0 * constexpr_math::pi * n / (length - 1);
+	return 0.35875
+		- 0.48829 * constexpr_math::cos(1.0 * k)
+		+ 0.14128 * constexpr_math::cos(2.0 * k)
+		- 0.01168 * constexpr_math::cos(3.0 * k);
+}
+
+constexpr int16_t coefficient(const size_t n, const size_t taps) {
+	const size_t length = taps * fft_size;
+	const double t = (n - (length - 1) / 2.0) / fft_size;
+	const double w = blackman_harris(n, length) * ((taps > 1) ? constexpr_math::sinc(t) : 1.0);
+	return constexpr_math::to_q15(w);
+}
+
+template<size_t Taps, size_t... I>
+constexpr std::array<int16_t, sizeof...(I)> make_half_window(std::index_sequence<I...>) {
+	return { { coefficient(I, Taps)... } };
+}
+
+} /* namespace detail */
+
+template<size_t Taps>
+struct Window {
+	static_assert((Taps > 0) && (Taps <= max_taps), "Unsupported WOLA tap count");
+
+	static constexpr size_t length = Taps * fft_size;
+	static constexpr size_t half_length = length / 2;
+
+	static constexpr std::array<int16_t, half_length> half {
+		detail::make_half_window<Taps>(std::make_index_sequence<half_length>())
+	};
+
+	static constexpr int16_t at(const size_t n) {
+		return half[(n < half_length) ? n : (length - 1 - n)];
+	}
+};
+
+template<size_t Taps>
+constexpr std::array<int16_t, Window<Taps>::half_length> Window<Taps>::half;
+
+/* Fold Taps * fft_size samples from src into dst, applying the window.
+ * Output is scaled so a full-scale complex8_t tone stays within int16_t.
+ */
+template<size_t Taps>
+void fold(const complex8_t* const src, std::array<complex16_t, fft_size>& dst) {
+	using W = Window<Taps>;
+	constexpr size_t output_shift = 8;
+
+	for(size_t i=0; i<fft_size; i++) {
+		int32_t re = 0;
+		int32_t im = 0;
+		for(size_t l=0; l<Taps; l++) {
+			const size_t n = l * fft_size + i;
+			const int32_t w = W::at(n);
+			re += src[n].real() * w;
+			im += src[n].imag() * w;
+		}
+		dst[i] = {
+			static_cast<int16_t>(__SSAT(re >> output_shift, 16)),
+			static_cast<int16_t>(__SSAT(im >> output_shift, 16))
+		};
+	}
+}
+
+} /* namespace wola */
+} /* namespace dsp */
+
+#endif/*__DSP_WOLA_H__*/
@@ -22,6 +22,8 @@
 #include "event_m4.hpp"
 
 #include "portapack_shared_memory.hpp"
+#include "trace.hpp"
+#include "chibios_cpp.hpp"
 
 #include "message_queue.hpp"
 
@@ -59,6 +61,8 @@ EventDispatcher::EventDispatcher(
 
 void EventDispatcher::run() {
 	thread_event_loop = chThdSelf();
+	shared_memory.m4_ram_layout = chibios::ram_layout();
+	shared_memory.m4_trace = &trace::ring;
 
 	lpc43xx::creg::m0apptxevent::enable();
 
@@ -79,6 +83,8 @@ eventmask_t EventDispatcher::wait() {
 }
 
 void EventDispatcher::dispatch(const eventmask_t events) {
+	TRACE_SCOPE(M4Dispatch, events);
+
 	if( events & EVT_MASK_BASEBAND ) {
 		handle_baseband_queue();
 	}
@@ -89,6 +95,12 @@ void EventDispatcher::dispatch(const eventmask_t events) {
 }
 
 void EventDispatcher::handle_baseband_queue() {
+	// Anything posted was queued before the synchronous message (if any)
+	// now waiting, so drain the queue first to keep M0 ordering.
+	shared_memory.baseband_queue.handle([this](Message* const message) {
+		this->on_message_default(message);
+	});
+
 	const auto message = shared_memory.baseband_message;
 	if( message ) {
 		on_message(message);
@@ -101,6 +113,21 @@ void EventDispatcher::on_message(const Message* const message) {
 		on_message_shutdown(*reinterpret_cast<const ShutdownMessage*>(message));
 		break;
 
+	case Message::ID::FileSourceConfig:
+		BasebandThread::set_file_source(reinterpret_cast<const FileSourceConfigMessage*>(message)->config);
+		shared_memory.baseband_message = nullptr;
+		break;
+
+	case Message::ID::SyntheticSourceConfig:
+		BasebandThread::set_synthetic_source(reinterpret_cast<const SyntheticSourceConfigMessage*>(message)->config);
+		shared_memory.baseband_message = nullptr;
+		break;
+
+	case Message::ID::ProcessorSelect:
+		on_message_processor_select(*reinterpret_cast<const ProcessorSelectMessage*>(message));
+		shared_memory.baseband_message = nullptr;
+		break;
+
 	default:
 		on_message_default(message);
 		shared_memory.baseband_message = nullptr;
@@ -109,14 +136,44 @@ void EventDispatcher::on_message(const Message* const message) {
 }
 
 void EventDispatcher::on_message_shutdown(const ShutdownMessage&) {
+	// While the image's threads are all still there.
+	shared_memory.threads.count = thread_registry::capture(
+		shared_memory.threads.threads, ThreadTable::threads_max
+	);
+	shared_memory.m4_ram_layout = chibios::ram_layout();
+	shared_memory.m4_trace = nullptr;
+
 	request_stop();
 }
 
+void EventDispatcher::on_message_processor_select(const ProcessorSelectMessage& message) {
+	for(size_t i=0; i<factories_count; i++) {
+		const auto& factory = factories[i];
+		if( factory.tag == message.tag ) {
+			BasebandThread::begin_handover();
+			baseband_processor.reset();
+			baseband_processor = factory.make();
+			BasebandThread::end_handover();
+			shared_memory.m4_ram_layout = chibios::ram_layout();
+			return;
+		}
+	}
+}
+
 void EventDispatcher::on_message_default(const Message* const message) {
-	baseband_processor->on_message(message);
+	if( message->id == Message::ID::RxGainControl ) {
+		BasebandThread::set_gain_control(*reinterpret_cast<const RxGainControlMessage*>(message));
+		return;
+	}
+
+	if( baseband_processor ) {
+		baseband_processor->on_message(message);
+	}
 }
 
 void EventDispatcher::handle_spectrum() {
-	const UpdateSpectrumMessage message;
-	baseband_processor->on_message(&message);
+	if( baseband_processor ) {
+		const UpdateSpectrumMessage message;
+		baseband_processor->on_message(&message);
+	}
 }
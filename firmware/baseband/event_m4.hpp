@@ -29,15 +29,46 @@
 
 #include "message.hpp"
 
+#include "spi_image.hpp"
+
 #include "ch.h"
 
+#include <cstddef>
+#include <memory>
+
 constexpr auto EVT_MASK_BASEBAND = EVENT_MASK(0);
 constexpr auto EVT_MASK_SPECTRUM = EVENT_MASK(1);
 
+/* One processor of a multi-processor image, selected from the application
+ * by ProcessorSelectMessage with the same tag.
+ */
+struct BasebandProcessorFactory {
+	const portapack::spi_flash::image_tag_t tag;
+	std::unique_ptr<BasebandProcessor> (* const make)();
+};
+
 class EventDispatcher {
 public:
 	EventDispatcher(std::unique_ptr<BasebandProcessor> baseband_processor);
 
+	/* Resident kernel for several processors, none running until the first
+	 * ProcessorSelectMessage. Swapping keeps the BasebandThread streaming
+	 * when both processors agree on its settings.
+	 */
+	template<size_t N>
+	EventDispatcher(
+		const std::array<BasebandProcessorFactory, N>& factories
+	) : baseband_processor { },
+		factories { factories.data() },
+		factories_count { N }
+	{
+	}
+
+	EventDispatcher(const EventDispatcher&) = delete;
+	EventDispatcher(EventDispatcher&&) = delete;
+	EventDispatcher& operator=(const EventDispatcher&) = delete;
+	EventDispatcher& operator=(EventDispatcher&&) = delete;
+
 	void run();
 	void request_stop();
 
@@ -54,6 +85,9 @@ private:
 
 	std::unique_ptr<BasebandProcessor> baseband_processor;
 
+	const BasebandProcessorFactory* const factories { nullptr };
+	const size_t factories_count { 0 };
+
 	bool is_running = true;
 
 	eventmask_t wait();
@@ -64,6 +98,7 @@ private:
 
 	void on_message(const Message* const message);
 	void on_message_shutdown(const ShutdownMessage&);
+	void on_message_processor_select(const ProcessorSelectMessage& message);
 	void on_message_default(const Message* const message);
 
 	void handle_spectrum();
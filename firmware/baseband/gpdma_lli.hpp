@@ -19,14 +19,16 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#ifndef __GPDMA_LLI_H__
+#define __GPDMA_LLI_H__
+
 #include <cstdint>
 #include <cstddef>
-
-#include <vector>
-#include <memory>
+#include <array>
+#include <algorithm>
 
 #include "gpdma.hpp"
-
+#include "utility.hpp"
 namespace lpc43xx {
 namespace gpdma {
 namespace lli {
@@ -87,7 +89,7 @@ struct ChannelConfig {
 	constexpr gpdma::channel::Control control(
 		const size_t transfer_size,
 		const bool last
-	) {
+	) const {
 		return {
 			.transfersize = transfer_size,
 			.sbsize = toUType(source.burst_size),
@@ -105,7 +107,7 @@ struct ChannelConfig {
 		};
 	}
 
-	constexpr gpdma::channel::Config config() {
+	constexpr gpdma::channel::Config config() const {
 		return {
 			.e = 0,
 			.srcperipheral = source.peripheral,
@@ -155,64 +157,77 @@ constexpr ChannelConfig channel_config_rssi {
 	{ 0x0e, BurstSize::Transfer1, TransferWidth::Word, Increment::Yes },
 };
 
+/* Fixed-capacity descriptor chain. Each descriptor moves one block between
+ * a fixed peripheral address and consecutive blocks of memory. Storage is
+ * static so descriptors stay put while the channel is walking them. With
+ * interrupt_every > 1, only every interrupt_every'th descriptor interrupts,
+ * for buffers spanning several descriptors.
+ */
+template<size_t MaxLength>
 class Chain {
 public:
-	using chain_t = std::vector<gpdma::channel::LLI>;
-	using chain_p = std::unique_ptr<chain_t>;
-
-	Chain(const ChannelConfig& cc) :
-		chain(std::make_unique<chain_t>(cc.chain.length))
-	{
-		set_lli_sequential(cc.chain_type);
-		set_source_address()...
+	static constexpr size_t max_length = MaxLength;
+
+	void configure(
+		const ChainType type,
+		const size_t length,
+		const uint32_t peripheral,
+		void* const memory,
+		const size_t block_bytes,
+		const bool peripheral_is_source,
+		const uint32_t control,
+		const size_t interrupt_every = 1
+	) {
+		constexpr uint32_t control_i = 1U << 31;
+		length_ = std::min(std::max(length, static_cast<size_t>(1)), max_length);
+		peripheral_is_source_ = peripheral_is_source;
+		for(size_t i=0; i<length_; i++) {
+			const auto block = reinterpret_cast<uint32_t>(memory) + i * block_bytes;
+			lli[i].srcaddr = peripheral_is_source ? peripheral : block;
+			lli[i].destaddr = peripheral_is_source ? block : peripheral;
+			lli[i].control = (((i + 1) % interrupt_every) == 0) ? control : (control & ~control_i);
+		}
+		set_lli_sequential(type);
 	}
 
-private:
-	chain_p chain;
-
-	void set_source_peripheral(void* const address) {
-		set_source_address(address, 0);
+	const gpdma::channel::LLI& first() const {
+		return lli[0];
 	}
 
-	void set_destination_peripheral(void* const address) {
-		set_destination_address(address, 0);
+	size_t length() const {
+		return length_;
 	}
 
-	void set_source_address(void* const address, const size_t increment) {
-		size_t offset = 0;
-		for(auto& item : *chain) {
-			item.srcaddr = (uint32_t)address + offset;
-			offset += increment;
-		}
+	/* Index of the descriptor a channel LLI register points at. */
+	size_t index_of(const gpdma::channel::LLI* const p) const {
+		const auto index = p - &lli[0];
+		return ((index >= 0) && (static_cast<size_t>(index) < length_)) ? index : 0;
 	}
 
-	void set_destination_address(void* const address, const size_t increment) {
-		size_t offset = 0;
-		for(auto& item : *chain) {
-			item.destaddr = (uint32_t)address + offset;
-			offset += increment;
-		}
+	/* Memory side address of a descriptor's block. */
+	void* memory(const size_t index) const {
+		const auto& item = lli[index % length_];
+		return reinterpret_cast<void*>(peripheral_is_source_ ? item.destaddr : item.srcaddr);
 	}
 
-	void set_control(const gpdma::channel::Control control) {
-		for(auto& item : *chain) {
-			item.control = control;
-		}
-	}
+private:
+	std::array<gpdma::channel::LLI, max_length> lli { };
+	size_t length_ { 0 };
+	bool peripheral_is_source_ { true };
 
-	void set_lli_sequential(ChainType chain_type) {
-		for(auto& item : *chain) {
-			item.lli = lli_pointer(&item + 1);
+	void set_lli_sequential(const ChainType chain_type) {
+		for(size_t i=0; (i + 1)<length_; i++) {
+			lli[i].lli = lli_pointer(&lli[i + 1]);
 		}
 		if( chain_type == ChainType::Loop ) {
-			chain[chain->size() - 1].lli = lli_pointer(&chain[0]);
+			lli[length_ - 1].lli = lli_pointer(&lli[0]);
 		} else {
-			chain[chain->size() - 1].lli = lli_pointer(nullptr);
+			lli[length_ - 1].lli = lli_pointer(nullptr);
 		}
 	}
 
-	gpdma::channel::LLIPointer lli_pointer(const void* lli) {
-		return {
+	static uint32_t lli_pointer(const void* lli) {
+		return gpdma::channel::LLIPointer {
 			.lm = 0,
 			.r = 0,
 			.lli = reinterpret_cast<uint32_t>(lli),
@@ -223,3 +238,5 @@ private:
 } /* namespace lli */
 } /* namespace gpdma */
 } /* namespace lpc43xx */
+
+#endif/*__GPDMA_LLI_H__*/
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __HDLC_DEFRAMER_H__
+#define __HDLC_DEFRAMER_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+#include "ax25_packet.hpp"
+#include "crc.hpp"
+
+/* NRZI HDLC receive for AX.25: flag hunt, bit destuffing, LSB first bytes
+ * and the X.25 FCS, all on the fly as bits come out of the clock recovery.
+ * Only frames whose FCS checks reach the payload handler, so noise and
+ * collisions on a busy channel never leave the M4.
+ *
+ * The last two bytes received are held back until the next byte or flag
+ * shows whether they were data or the FCS, so the CRC runs incrementally
+ * and the frame is never buffered twice.
+ */
+class HDLCDeframer {
+public:
+	using PayloadHandlerFunc = std::function<void(const ax25::Packet& packet)>;
+
+	/* Two addresses and a control byte. */
+	static constexpr size_t length_min = 2 * ax25::Packet::address_length + 1;
+
+	HDLCDeframer(
+		PayloadHandlerFunc payload_handler
+	) : payload_handler { std::move(payload_handler) }
+	{
+	}
+
+	void reset() {
+		history = 0;
+		previous_symbol = 0;
+		in_frame = false;
+	}
+
+	/* One sliced line symbol. Polarity doesn't matter, NRZI sends a zero as
+	 * a transition.
+	 */
+	void execute(const uint_fast8_t symbol) {
+		const uint_fast8_t bit = ((symbol ^ previous_symbol) & 1) ^ 1;
+		previous_symbol = symbol;
+		history = (history << 1) | bit;
+
+		if( (history & 0xff) == flag ) {
+			// The flag's first seven bits went into the byte being built.
+			if( in_frame && (bit_count == 7) && (held_count == 2) ) {
+				end_frame();
+			}
+			start_frame();
+			return;
+		}
+
+		if( (history & 0x7f) == 0x7f ) {
+			// Abort, or an idle line.
+			in_frame = false;
+			return;
+		}
+
+		if( !in_frame ) {
+			return;
+		}
+
+		if( (history & 0x3f) == 0x3e ) {
+			// Zero stuffed after five ones.
+			return;
+		}
+
+		byte = (byte >> 1) | (bit << 7);
+		if( ++bit_count == 8 ) {
+			add_byte(byte);
+			bit_count = 0;
+		}
+	}
+
+private:
+	static constexpr uint32_t flag = 0x7e;
+
+	const PayloadHandlerFunc payload_handler;
+
+	CRC<16, true, true> crc { 0x1021, 0xffff, 0xffff };
+	ax25::Packet packet { };
+
+	uint32_t history { 0 };
+	uint_fast8_t previous_symbol { 0 };
+	bool in_frame { false };
+	uint32_t byte { 0 };
+	size_t bit_count { 0 };
+	// Last two bytes, newest in the low byte, until they turn out to be data.
+	uint32_t held { 0 };
+	size_t held_count { 0 };
+
+	void start_frame() {
+		packet.clear();
+		crc.reset();
+		held_count = 0;
+		bit_count = 0;
+		in_frame = true;
+	}
+
+	void add_byte(const uint32_t value) {
+		if( held_count == 2 ) {
+			const uint8_t data = held >> 8;
+			if( !packet.push_back(data) ) {
+				in_frame = false;
+				return;
+			}
+			crc.process_byte(data);
+		} else {
+			held_count++;
+		}
+		held = ((held << 8) | value) & 0xffff;
+	}
+
+	void end_frame() {
+		// FCS goes out low byte first.
+		const uint32_t fcs = ((held & 0xff) << 8) | (held >> 8);
+		if( (packet.length() >= length_min) && (crc.checksum() == fcs) ) {
+			// NOTE: This check is to avoid std::function nullptr check, which
+			// brings in "_ZSt25__throw_bad_function_callv" and a lot of extra code.
+			if( payload_handler ) {
+				packet.set_timestamp(Timestamp::now());
+				payload_handler(packet);
+			}
+		}
+	}
+};
+
+#endif/*__HDLC_DEFRAMER_H__*/
@@ -22,6 +22,8 @@
 #ifndef __LINEAR_RESAMPLER_H__
 #define __LINEAR_RESAMPLER_H__
 
+#include <cstdint>
+
 namespace dsp {
 namespace interpolation {
 
@@ -63,6 +65,42 @@ private:
 	}
 };
 
+/* LinearResampler with the rates fixed at compile time, for decoders that
+ * only ever run at one: the increment is a constant, so the division is
+ * gone, advance()'s multiply folds, and at a ratio of one (twice the
+ * symbol rate in, as most are) the loop runs exactly once per sample.
+ */
+template<uint32_t InputRate, uint32_t OutputRate>
+class FixedRateLinearResampler {
+public:
+	static_assert((InputRate > 0) && (OutputRate > 0), "Rates must not be zero");
+
+	template<typename InterpolatedSampleHandler>
+	void operator()(
+		const float sample,
+		InterpolatedSampleHandler interpolated_sample_handler
+	) {
+		const float sample_delta = sample - last_sample;
+		while( phase < 1.0f ) {
+			const float interpolated_value = last_sample + phase * sample_delta;
+			interpolated_sample_handler(interpolated_value);
+			phase += phase_increment;
+		}
+		last_sample = sample;
+		phase -= 1.0f;
+	}
+
+	void advance(const float fraction) {
+		phase += (fraction * phase_increment);
+	}
+
+private:
+	static constexpr float phase_increment = static_cast<float>(InputRate) / OutputRate;
+
+	float last_sample { 0.0f };
+	float phase { 0.0f };
+};
+
 } /* namespace interpolation */
 } /* namespace dsp */
 
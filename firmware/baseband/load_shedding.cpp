@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "load_shedding.hpp"
+
+#include <algorithm>
+
+uint32_t LoadShedding::level_ = 0;
+uint32_t LoadShedding::load_q8 = 0;
+uint32_t LoadShedding::hold = 0;
+
+bool LoadShedding::update(const uint32_t cycles, const uint32_t budget) {
+	if( budget == 0 ) {
+		return false;
+	}
+
+	const uint32_t load = std::min<uint64_t>((static_cast<uint64_t>(cycles) << 8) / budget, 1024);
+	load_q8 = static_cast<uint32_t>(static_cast<int32_t>(load_q8) + ((static_cast<int32_t>(load) - static_cast<int32_t>(load_q8)) >> 3));
+
+	if( hold ) {
+		hold--;
+		return false;
+	}
+
+	if( (level_ < level_max) && ((load >= 256) || (load_q8 >= raise_q8)) ) {
+		level_++;
+		hold = hold_buffers;
+		return true;
+	}
+	if( (level_ > 0) && (load_q8 < lower_q8) ) {
+		level_--;
+		hold = hold_buffers;
+		return true;
+	}
+	return false;
+}
+
+bool LoadShedding::reset() {
+	const bool was_shedding = (level_ != 0);
+	level_ = 0;
+	load_q8 = 0;
+	hold = 0;
+	return was_shedding;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __LOAD_SHEDDING_H__
+#define __LOAD_SHEDDING_H__
+
+#include <cstdint>
+#include <cstddef>
+
+/* What a receiver does past decoding (the spectrum, the audio spectrum,
+ * statistics) gives way when the processor runs close to the buffer
+ * period, before the DMA gets ahead of it. The baseband thread measures
+ * each execute() against the period and sets a level; optional work runs
+ * one time in 1 << level. Only the baseband thread touches it.
+ */
+class LoadShedding {
+public:
+	static constexpr uint32_t level_max = 3;
+
+	static uint32_t level() {
+		return level_;
+	}
+
+	/* Whether optional work runs this time, phase counting its chances. */
+	static bool due(uint32_t& phase) {
+		return (phase++ & ((1U << level_) - 1)) == 0;
+	}
+
+	/* A buffer took cycles of budget. true when the level changed. */
+	static bool update(const uint32_t cycles, const uint32_t budget);
+
+	/* For a new processor or stream. true when it was shedding. */
+	static bool reset();
+
+	static uint32_t load_percent() {
+		return (load_q8 * 100) >> 8;
+	}
+
+private:
+	static constexpr uint32_t raise_q8 = 224;	// 87.5%, or any buffer over budget
+	static constexpr uint32_t lower_q8 = 128;	// 50%
+	static constexpr uint32_t hold_buffers = 32;	// after a change, for it to show
+
+	static uint32_t level_;
+	static uint32_t load_q8;	// cycles / budget, smoothed over ~8 buffers
+	static uint32_t hold;
+};
+
+#endif/*__LOAD_SHEDDING_H__*/
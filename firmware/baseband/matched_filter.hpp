@@ -22,9 +22,15 @@
 #ifndef __MATCHED_FILTER_H__
 #define __MATCHED_FILTER_H__
 
+#include "complex.hpp"
+#include "simd.hpp"
+
 #include <cstddef>
+#include <cstdint>
 #include <complex>
 #include <memory>
+#include <array>
+#include <cmath>
 
 namespace dsp {
 namespace matched_filter {
@@ -90,6 +96,91 @@ private:
 	);
 };
 
+/* Same filter (and output scale) as MatchedFilter, on complex16 samples
+ * and Q15 taps with the M4 dual 16-bit MACs into 64-bit accumulators. The
+ * history is stored twice, N apart, so the newest N samples are always
+ * contiguous and nothing is shifted per output. Still only computed at the
+ * decimated rate.
+ */
+template<size_t N>
+class MatchedFilterQ15 {
+public:
+	using sample_t = complex16_t;
+	using taps_t = std::array<std::complex<float>, N>;
+
+	MatchedFilterQ15(
+		const taps_t& taps,
+		const size_t decimation_factor = 1
+	) : decimation_factor_ { decimation_factor }
+	{
+		configure(taps);
+	}
+
+	void configure(const taps_t& taps) {
+		for(size_t n=0; n<N; n++) {
+			const auto tap = taps[N - 1 - n];
+			taps_reversed_[n] = { to_q15(tap.real()), to_q15(tap.imag()) };
+		}
+		history_.fill({ });
+		index = 0;
+		decimation_phase = 0;
+		output = 0;
+	}
+
+	bool execute_once(const sample_t input) {
+		const vec2_s16 v { input.real(), input.imag() };
+		history_[index] = v;
+		history_[index + N] = v;
+		index = (index + 1 == N) ? 0 : (index + 1);
+
+		decimation_phase++;
+		if( decimation_phase < decimation_factor_ ) {
+			return false;
+		}
+		decimation_phase = 0;
+
+		// Oldest to newest, against the reversed taps.
+		const vec2_s16* const s = &history_[index];
+		int64_t r_n = 0;
+		int64_t r_p = 0;
+		int64_t i_n = 0;	// Negated, doesn't matter for magnitude.
+		int64_t i_p = 0;
+		for(size_t n=0; n<N; n++) {
+			r_n = smlald(s[n], taps_reversed_[n], r_n);
+			r_p = smlsld(s[n], taps_reversed_[n], r_p);
+			i_n = smlsldx(s[n], taps_reversed_[n], i_n);
+			i_p = smlaldx(s[n], taps_reversed_[n], i_p);
+		}
+
+		const float mag_n = std::sqrt(square(r_n) + square(i_n));
+		const float mag_p = std::sqrt(square(r_p) + square(i_p));
+		output = (mag_p - mag_n) * (1.0f / 32768.0f);
+		return true;
+	}
+
+	float get_output() const {
+		return output;
+	}
+
+private:
+	std::array<vec2_s16, N * 2> history_ { };
+	std::array<vec2_s16, N> taps_reversed_ { };
+	size_t index { 0 };
+	const size_t decimation_factor_;
+	size_t decimation_phase { 0 };
+	float output { 0 };
+
+	static int16_t to_q15(const float x) {
+		const auto q = std::round(x * 32768.0f);
+		return (q > 32767.0f) ? 32767 : ((q < -32768.0f) ? -32768 : static_cast<int16_t>(q));
+	}
+
+	static float square(const int64_t x) {
+		const float f = x;
+		return f * f;
+	}
+};
+
 } /* namespace matched_filter */
 } /* namespace dsp */
 
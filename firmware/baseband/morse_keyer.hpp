@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __MORSE_KEYER_H__
+#define __MORSE_KEYER_H__
+
+#include "portapack_shared_memory.hpp"
+#include "constexpr_math.hpp"
+#include "sine_table_int8.hpp"
+#include "dsp_types.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace morse {
+
+namespace detail {
+
+constexpr uint32_t ramp_table_length = 128;		// 5.3ms at 24kHz
+
+struct RampTable {
+	int16_t gain[ramp_table_length];
+};
+
+constexpr RampTable make_ramp_table() {
+	RampTable table { };
+	for (size_t i = 0; i < ramp_table_length; i++)
+		table.gain[i] = constexpr_math::to_q15(0.5 - 0.5 * constexpr_math::cos(constexpr_math::pi * (i + 0.5) / ramp_table_length));
+	return table;
+}
+
+constexpr RampTable ramp_table = make_ramp_table();
+
+} /* namespace detail */
+
+/* Keys a tone from ToneData's ring, read as key down (1) / up (0) bits, a
+ * time unit each, MSB first. Key edges are raised cosine ramps, ~5ms or a
+ * quarter of a unit when that's shorter, so there are no key clicks at any
+ * speed. The ramp starts on the edge, and a unit is a whole number of
+ * audio samples, so element timing is exact. Runs between edges are a
+ * plain tone or silence.
+ */
+class Keyer {
+public:
+	void configure(const uint32_t tone_delta, const uint32_t unit_samples) {
+		delta = tone_delta;
+		unit_length = std::max<uint32_t>(unit_samples, 4);
+		ramp_length = std::min<uint32_t>(detail::ramp_table_length, unit_length / 4);
+		ramp_step = (detail::ramp_table_length << 16) / ramp_length;
+		
+		phase = 0;
+		key = false;
+		ended = false;
+		unit_left = 0;
+		ramp_left = 0;
+		bits_left = 0;
+		units = 0;
+	}
+
+	/* False once the stream has ended and the key is back up. */
+	bool execute(const buffer_s16_t& dst) {
+		for (size_t i = 0; i < dst.count; ) {
+			if (!unit_left)
+				start_unit(next_bit());
+			
+			const size_t n = std::min<size_t>(dst.count - i, unit_left);
+			size_t k = 0;
+			
+			if (ramp_left) {
+				const size_t m = std::min<size_t>(n, ramp_left);
+				if (key) {
+					for (; k < m; k++)
+						dst.p[i + k] = tone() * detail::ramp_table.gain[ramp_index(k)] >> 8;
+				} else {
+					for (; k < m; k++)
+						dst.p[i + k] = tone() * detail::ramp_table.gain[detail::ramp_table_length - 1 - ramp_index(k)] >> 8;
+				}
+				ramp_position += m * ramp_step;
+				ramp_left -= m;
+			}
+			
+			if (key) {
+				// int8 tone at half scale, as the tones always were
+				for (; k < n; k++)
+					dst.p[i + k] = tone() << 7;
+			} else {
+				std::fill(&dst.p[i + k], &dst.p[i + n], 0);
+			}
+			
+			i += n;
+			unit_left -= n;
+		}
+		
+		return !(ended && !key && !ramp_left);
+	}
+
+	uint32_t units_sent() const {
+		return units;
+	}
+
+private:
+	uint32_t delta { 0 };
+	uint32_t phase { 0 };
+	uint32_t unit_length { 1 };
+	uint32_t unit_left { 0 };
+	uint32_t ramp_length { 1 };
+	uint32_t ramp_step { 0 };			// Q16 table entries a sample
+	uint32_t ramp_position { 0 };		// Q16, at the start of the run
+	uint32_t ramp_left { 0 };
+	bool key { false };
+	bool ended { false };
+	uint8_t bits { 0 };
+	size_t bits_left { 0 };
+	uint32_t units { 0 };
+
+	int32_t tone() {
+		const int32_t sample = sine_table_i8[phase >> 24];
+		phase += delta;
+		return sample;
+	}
+
+	size_t ramp_index(const size_t k) const {
+		return (ramp_position + k * ramp_step) >> 16;
+	}
+
+	void start_unit(const bool down) {
+		unit_left = unit_length;
+		if (down != key) {
+			key = down;
+			ramp_position = 0;
+			ramp_left = ramp_length;
+		}
+	}
+
+	/* Key up when the ring is dry or done, the app may catch up. */
+	bool next_bit() {
+		if (!bits_left) {
+			auto& tones = shared_memory.bb_data.tones_data;
+			const uint32_t out = tones.symbols_out;
+			if (out == tones.symbols_end) {
+				ended = true;
+				return false;
+			}
+			if (out == tones.symbols_in)
+				return false;
+			
+			bits = tones.symbols[out & ((1U << ToneData::symbols_k) - 1)];
+			// Read before the slot is handed back
+			__DMB();
+			tones.symbols_out = out + 1;
+			bits_left = 8;
+		}
+		
+		const bool down = bits & 0x80;
+		bits <<= 1;
+		bits_left--;
+		units++;
+		return down;
+	}
+};
+
+} /* namespace morse */
+
+#endif/*__MORSE_KEYER_H__*/
@@ -44,6 +44,38 @@ struct FixedLength {
 	const size_t length;
 };
 
+/* Packs sliced symbols for the block PacketBuilder::execute(), oldest in
+ * the most significant used bit.
+ */
+class SymbolWord {
+public:
+	static constexpr size_t capacity = 32;
+
+	// True once the word is full and should be handed on.
+	bool add(const uint_fast8_t symbol) {
+		word_ = (word_ << 1) | (symbol & 1);
+		count_++;
+		return count_ == capacity;
+	}
+
+	uint32_t word() const {
+		return word_;
+	}
+
+	size_t count() const {
+		return count_;
+	}
+
+	void clear() {
+		word_ = 0;
+		count_ = 0;
+	}
+
+private:
+	uint32_t word_ { 0 };
+	size_t count_ { 0 };
+};
+
 template<typename PreambleMatcher, typename UnstuffMatcher, typename EndMatcher>
 class PacketBuilder {
 public:
@@ -71,6 +103,41 @@ public:
 		reset_state();
 	}
 
+	/* Baseband sample index of the symbols of the next execute(), for
+	 * decoders that track it (for the block variant, the newest symbol's).
+	 * A preamble match stamps the packet with it.
+	 */
+	void set_sample_index(const uint64_t value) {
+		sample_index = value;
+	}
+
+	/* Block variant: count symbols from a SymbolWord, oldest first. The
+	 * preamble hunt, where nearly all symbols go, is a tight shift and
+	 * correlate loop over the word.
+	 */
+	void execute(
+		const uint32_t symbols,
+		const size_t count
+	) {
+		size_t i = count;
+		while( i > 0 ) {
+			if( state == State::Preamble ) {
+				while( i > 0 ) {
+					i--;
+					bit_history.add((symbols >> i) & 1);
+					if( preamble(bit_history, packet.size()) ) {
+						packet.set_sample_index(sample_index);
+						state = State::Payload;
+						break;
+					}
+				}
+			} else {
+				i--;
+				execute_payload((symbols >> i) & 1);
+			}
+		}
+	}
+
 	void execute(
 		const uint_fast8_t symbol
 	) {
@@ -79,29 +146,13 @@ public:
 		switch(state) {
 		case State::Preamble:
 			if( preamble(bit_history, packet.size()) ) {
+				packet.set_sample_index(sample_index);
 				state = State::Payload;
 			}
 			break;
 
 		case State::Payload:
-			if( !unstuff(bit_history, packet.size()) ) {
-				packet.add(symbol);
-			}
-
-			if( end(bit_history, packet.size()) ) {
-				// NOTE: This check is to avoid std::function nullptr check, which
-				// brings in "_ZSt25__throw_bad_function_callv" and a lot of extra code.
-				// TODO: Make payload_handler known at compile time.
-				if( payload_handler ) {
-					packet.set_timestamp(Timestamp::now());
-					payload_handler(packet);
-				}
-				reset_state();
-			} else {
-				if( packet_truncated() ) {
-					reset_state();
-				}
-			}
+			payload(symbol);
 			break;
 
 		default:
@@ -129,6 +180,34 @@ private:
 
 	State state { State::Preamble };
 	baseband::Packet packet { };
+	uint64_t sample_index { 0 };
+
+	void execute_payload(const uint_fast8_t symbol) {
+		bit_history.add(symbol);
+		payload(symbol);
+	}
+
+	// Symbol already in bit_history.
+	void payload(const uint_fast8_t symbol) {
+		if( !unstuff(bit_history, packet.size()) ) {
+			packet.add(symbol);
+		}
+
+		if( end(bit_history, packet.size()) ) {
+			// NOTE: This check is to avoid std::function nullptr check, which
+			// brings in "_ZSt25__throw_bad_function_callv" and a lot of extra code.
+			// TODO: Make payload_handler known at compile time.
+			if( payload_handler ) {
+				packet.set_timestamp(Timestamp::now());
+				payload_handler(packet);
+			}
+			reset_state();
+		} else {
+			if( packet_truncated() ) {
+				reset_state();
+			}
+		}
+	}
 
 	void reset_state() {
 		packet.clear();
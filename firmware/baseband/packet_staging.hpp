@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2013 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __PACKET_STAGING_H__
+#define __PACKET_STAGING_H__
+
+#include "portapack_shared_memory.hpp"
+#include "message.hpp"
+
+#include <ch.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+/* Bytes of a message that go into the queue. */
+template<typename T>
+size_t queued_size(const T&) {
+	return sizeof(T);
+}
+
+template<typename T, Message::ID Id, size_t N>
+size_t queued_size(const PacketBatchMessage<T, Id, N>& message) {
+	return message.size();
+}
+
+/* Decoded packets on their way to the application. One that finds
+ * application_queue full waits here, in order with those after it, for a
+ * later push() or flush(): as the decoder's baseband buffers come at a
+ * steady rate, flush() once per buffer gives the application that long to
+ * catch up. Only a packet that finds the staging full too is dropped, and
+ * counted in shared_memory.application_queue_drops.
+ */
+template<typename T, size_t N>
+class PacketStaging {
+public:
+	static_assert(std::is_trivially_copyable<T>::value, "Staged messages are copied as they are");
+
+	/* false if the message was dropped. */
+	bool push(const T& message) {
+		flush();
+		if( (count == 0) && shared_memory.application_queue.try_push(message, queued_size(message)) ) {
+			return true;
+		}
+		if( count == N ) {
+			shared_memory.application_queue.count_drop(message.id);
+			return false;
+		}
+		new (&staged[(first + count) % N]) T { message };
+		count++;
+		return true;
+	}
+
+	void flush() {
+		while( (count > 0) && shared_memory.application_queue.try_push(at(first), queued_size(at(first))) ) {
+			first = (first + 1) % N;
+			count--;
+		}
+	}
+
+private:
+	typename std::aligned_storage<sizeof(T), alignof(T)>::type staged[N] { };
+	size_t first { 0 };
+	size_t count { 0 };
+
+	const T& at(const size_t index) const {
+		return *reinterpret_cast<const T*>(&staged[index]);
+	}
+};
+
+/* Packets gathered into a PacketBatchMessage, staged once it is full or
+ * its first packet has waited latency_ms, whichever comes first. poll()
+ * once per baseband buffer: the latency is only as fine as they come.
+ */
+template<typename Batch, size_t N = 2>
+class PacketBatcher {
+public:
+	using packet_t = typename Batch::packet_t;
+
+	PacketBatcher(
+		const uint32_t latency_ms = 50
+	) : latency { MS2ST(latency_ms) }
+	{
+	}
+
+	void push(const packet_t& packet) {
+		if( batch.count == 0 ) {
+			first_time = chTimeNow();
+		}
+		batch.add(packet);
+		if( batch.is_full() ) {
+			send();
+		}
+	}
+
+	void poll() {
+		if( (batch.count > 0) && ((chTimeNow() - first_time) >= latency) ) {
+			send();
+		} else {
+			staging.flush();
+		}
+	}
+
+private:
+	const systime_t latency;
+	systime_t first_time { 0 };
+	Batch batch { };
+	PacketStaging<Batch, N> staging { };
+
+	void send() {
+		staging.push(batch);
+		batch.clear();
+	}
+};
+
+#endif/*__PACKET_STAGING_H__*/
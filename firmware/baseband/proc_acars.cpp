@@ -25,53 +25,129 @@
 #include "portapack_shared_memory.hpp"
 
 #include "dsp_fir_taps.hpp"
+#include "crc.hpp"
 
 #include "event_m4.hpp"
 
-ACARSProcessor::ACARSProcessor() {
-	decim_0.configure(taps_11k0_decim_0.taps, 33554432);
-	decim_1.configure(taps_11k0_decim_1.taps, 131072);
-	packet.clear();
-}
+#include <cmath>
+#include <algorithm>
 
-void ACARSProcessor::execute(const buffer_c8_t& buffer) {
-	/* 2.4576MHz, 2048 samples */
+void ACARSDemodulator::execute(const buffer_c16_t& channel) {
+	/* 76.8kHz, 32 samples */
+	size_t audio_count = 0;
+	for(size_t i=0; i<channel.count; i++) {
+		const float re = channel.p[i].real();
+		const float im = channel.p[i].imag();
+		envelope_sum += std::sqrt(re * re + im * im);
+		if( ++envelope_count < envelope_decimation ) {
+			continue;
+		}
 
-	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-	const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
-	const auto decimator_out = decim_1_out;
+		const float envelope = envelope_sum * (1.0f / envelope_decimation);
+		envelope_sum = 0.0f;
+		envelope_count = 0;
 
-	/* 38.4kHz, 32 samples */
-	feed_channel_stats(decimator_out);
+		// Carrier out, then hold the tones at a fixed level for the Q15 filter.
+		dc += (envelope - dc) * (1.0f / 256.0f);
+		const float ac = envelope - dc;
+		level += (std::abs(ac) - level) * (1.0f / 256.0f);
+		const float gain = (level > 1.0f) ? (8192.0f / level) : 8192.0f;
+		const float sample = std::max(std::min(ac * gain, 32767.0f), -32768.0f);
+		audio[audio_count++] = { static_cast<int16_t>(sample), 0 };
+	}
 
-	for(size_t i=0; i<decimator_out.count; i++) {
-		if( mf.execute_once(decimator_out.p[i]) ) {
+	/* 19.2kHz, 8 samples */
+	const buffer_c16_t audio_buffer { audio.data(), audio_count, audio_fs };
+	const auto tones = tone_shift.execute(audio_buffer, audio_buffer);
+	for(size_t i=0; i<tones.count; i++) {
+		if( mf.execute_once(tones.p[i]) ) {
 			clock_recovery(mf.get_output());
 		}
 	}
 }
 
-void ACARSProcessor::consume_symbol(
+void ACARSDemodulator::consume_symbol(
 	const float raw_symbol
 ) {
+	// 2400Hz is a one.
 	const uint_fast8_t sliced_symbol = (raw_symbol >= 0.0f) ? 1 : 0;
-	//const auto decoded_symbol = acars_decode(sliced_symbol);
-
-	// DEBUG
-	packet.add(sliced_symbol);
-	if (packet.size() == 256) {
-		payload_handler(packet);
-		packet.clear();
-	}
+	const auto decoded_symbol = acars_decode(sliced_symbol);
 
-	//packet_builder.execute(decoded_symbol);
+	packet_builder.execute(decoded_symbol);
 }
 
-void ACARSProcessor::payload_handler(
+void ACARSDemodulator::payload_handler(
 	const baseband::Packet& packet
 ) {
-	const ACARSPacketMessage message { packet };
+	// Characters are sent LSB first.
+	const size_t length = packet.size() / 8;
+	if( (length < 3) || (length > acars::Packet::length_max + 2) ) {
+		return;
+	}
+
+	std::array<uint8_t, acars::Packet::length_max + 2> bytes;
+	for(size_t n=0; n<length; n++) {
+		uint8_t c = 0;
+		for(size_t bit=0; bit<8; bit++) {
+			c |= packet[n * 8 + bit] << bit;
+		}
+		bytes[n] = c;
+	}
+
+	CRC<16, true, true> bcs { 0x1021 };
+	bcs.process_bytes(bytes.data(), length - 2);
+	if( bcs.checksum() != static_cast<uint32_t>(bytes[length - 2] | (bytes[length - 1] << 8)) ) {
+		return;
+	}
+
+	acars::Packet block;
+	block.set_timestamp(packet.timestamp());
+	for(size_t n=0; n<length - 2; n++) {
+		block.push_back(bytes[n]);
+	}
+
+	const ACARSPacketMessage message { block, channel };
 	shared_memory.application_queue.push(message);
+	BasebandProcessor::count_decode();
+}
+
+ACARSProcessor::ACARSProcessor() {
+	for(size_t i=0; i<channels_max; i++) {
+		demodulators[i].set_channel(i);
+	}
+}
+
+void ACARSProcessor::execute(const buffer_c8_t& buffer) {
+	/* 4.9152MHz, 2048 samples */
+	if( !configured ) {
+		return;
+	}
+
+	channelizer.execute(buffer,
+		[this](const size_t index, const buffer_c16_t& channel) {
+			if( index == 0 ) {
+				this->feed_channel_stats(channel);
+			}
+			this->demodulators[index].execute(channel);
+		}
+	);
+}
+
+void ACARSProcessor::on_message(const Message* const message) {
+	if( message->id == Message::ID::ACARSConfigure ) {
+		configure(*reinterpret_cast<const ACARSConfigureMessage*>(message));
+	}
+}
+
+void ACARSProcessor::configure(const ACARSConfigureMessage& message) {
+	channelizer.configure(
+		taps_acars_decim_0.taps, 33554432,
+		taps_acars_decim_1.taps, 131072,
+		message.offsets_hz,
+		baseband_fs,
+		message.channel_count
+	);
+	configured = true;
 }
 
 int main() {
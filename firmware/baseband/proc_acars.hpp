@@ -27,17 +27,7 @@
 #include "baseband_thread.hpp"
 #include "rssi_thread.hpp"
 
-#include "dsp_decimate.hpp"
-
-#include "spectrum_collector.hpp"
-
-#include <cstdint>
-
-#include "baseband_processor.hpp"
-#include "baseband_thread.hpp"
-#include "rssi_thread.hpp"
-
-#include "channel_decimator.hpp"
+#include "channelizer.hpp"
 #include "matched_filter.hpp"
 
 #include "clock_recovery.hpp"
@@ -45,94 +35,127 @@
 #include "packet_builder.hpp"
 #include "baseband_packet.hpp"
 
+#include "constexpr_math.hpp"
 #include "message.hpp"
 
 #include <cstdint>
 #include <cstddef>
-#include <bitset>
-
-// AIS:
-// IN: 2457600/8/8 = 38400
-// Offset: 2457600/4 = 614400 (614400/8/8 = 9600)
-// Deviation: 2400
-// Symbol: 9600
-// Decimate: 2
-// 4 taps, 1 symbol, 1/4 cycle
-
-// TPMS:
-// IN: 2457600/4/2 = 307200
-// Offset: 2457600/4 = 614400 (614400/4/2 = 76800)
-// Deviation: 38400
-// Symbol: 19200
-// Decimate: 8
-// 16 taps, 1 symbol, 2 cycles
+#include <array>
 
 // ACARS:
-// IN: 2457600/8/8 = 38400
-// Offset: 2457600/4 = 614400 (614400/8/8 = 9600)
-// Deviation: ???
+// IN: 4915200/8/8 = 76800 per channel, AM
+// Envelope: /4 = 19200
+// Tones: 1200Hz and 2400Hz MSK, mixed down by 1800Hz to -600Hz and +600Hz
 // Symbol: 2400
-// Decimate: 8
-// 16 taps, 1 symbol, 2 cycles
-
-// Number of taps: size of one symbol in samples (in/symbol)
-// Cycles: 
-
-
-// Translate+rectangular filter
-// sample=38.4k, deviation=4800, symbol=2400
-// Length: 16 taps, 1 symbol, 2 cycles of sinusoid
-// This is actually the same as rect_taps_307k2_38k4_1t_19k2_p
-constexpr std::array<std::complex<float>, 16> rect_taps_38k4_4k8_1t_2k4_p { {
-	{  6.2500000000e-02f,  0.0000000000e+00f }, {  4.4194173824e-02f,  4.4194173824e-02f },
-	{  0.0000000000e+00f,  6.2500000000e-02f }, { -4.4194173824e-02f,  4.4194173824e-02f },
-	{ -6.2500000000e-02f,  0.0000000000e+00f }, { -4.4194173824e-02f, -4.4194173824e-02f },
-	{  0.0000000000e+00f, -6.2500000000e-02f }, {  4.4194173824e-02f, -4.4194173824e-02f },
-	{  6.2500000000e-02f,  0.0000000000e+00f }, {  4.4194173824e-02f,  4.4194173824e-02f },
-	{  0.0000000000e+00f,  6.2500000000e-02f }, { -4.4194173824e-02f,  4.4194173824e-02f },
-	{ -6.2500000000e-02f,  0.0000000000e+00f }, { -4.4194173824e-02f, -4.4194173824e-02f },
-	{  0.0000000000e+00f, -6.2500000000e-02f }, {  4.4194173824e-02f, -4.4194173824e-02f },
+// Matched filter: 8 taps, 1 symbol, decimate 2 to 9600 (4 samples per symbol)
+
+constexpr std::complex<float> acars_tone_tap(const size_t n) {
+	return {
+		static_cast<float>(constexpr_math::cos(2.0 * constexpr_math::pi * 600.0 * n / 19200.0) / 8.0),
+		static_cast<float>(constexpr_math::sin(2.0 * constexpr_math::pi * 600.0 * n / 19200.0) / 8.0)
+	};
+}
+
+// sample=19.2k, +600Hz (2400Hz before mixing), 1 symbol
+constexpr std::array<std::complex<float>, 8> acars_tone_taps_19k2_600_1t { {
+	acars_tone_tap(0), acars_tone_tap(1), acars_tone_tap(2), acars_tone_tap(3),
+	acars_tone_tap(4), acars_tone_tap(5), acars_tone_tap(6), acars_tone_tap(7),
 } };
 
-class ACARSProcessor : public BasebandProcessor {
+/* A block ends with ETX or ETB and the two BCS characters after it. The
+ * history holds characters bit reversed, since they're sent LSB first.
+ */
+struct ACARSBlockEnd {
+	bool operator()(const BitHistory& history, const size_t symbols_received) const {
+		if( symbols_received >= length_max_bits ) {
+			return true;
+		}
+		if( (symbols_received < 24) || (symbols_received & 7) ) {
+			return false;
+		}
+		const auto c = (history.value() >> 16) & 0xff;
+		return (c == etx_reversed) || (c == etb_reversed);
+	}
+
+	// With odd parity, ETX is 0x83 and ETB 0x17.
+	static constexpr uint64_t etx_reversed = 0xc1;
+	static constexpr uint64_t etb_reversed = 0xe8;
+	static constexpr size_t length_max_bits = (acars::Packet::length_max + 2) * 8;
+};
+
+/* Demodulator and block decoder for one ACARS channel at 76.8kHz. */
+class ACARSDemodulator {
 public:
-	ACARSProcessor();
+	void set_channel(const uint8_t new_channel) {
+		channel = new_channel;
+	}
 
-	void execute(const buffer_c8_t& buffer) override;
+	void execute(const buffer_c16_t& channel);
 
 private:
-	static constexpr size_t baseband_fs = 2457600;
+	static constexpr size_t envelope_decimation = 4;
+	static constexpr uint32_t audio_fs = 19200;
 
-	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
-	RSSIThread rssi_thread { NORMALPRIO + 10 };
+	uint8_t channel { 0 };
 
-	std::array<complex16_t, 512> dst { };
-	const buffer_c16_t dst_buffer {
-		dst.data(),
-		dst.size()
-	};
+	float envelope_sum { 0.0f };
+	size_t envelope_count { 0 };
+	float dc { 0.0f };
+	float level { 1.0f };
 
-	dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0 { };	// Translate already done here !
-	dsp::decimate::FIRC16xR16x32Decim8 decim_1 { };
-	dsp::matched_filter::MatchedFilter mf { rect_taps_38k4_4k8_1t_2k4_p, 8 };
+	std::array<complex16_t, 16> audio { };
+	FrequencyShift tone_shift { };
 
-	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery {
-		4800, 2400, { 0.0555f },
-		[this](const float symbol) { this->consume_symbol(symbol); }
-	};
+	dsp::matched_filter::MatchedFilterQ15<acars_tone_taps_19k2_600_1t.size()> mf { acars_tone_taps_19k2_600_1t, 2 };
+
+	void consume_symbol(const float symbol);
+
+	clock_recovery::FixedRateClockRecovery<
+		9600, 2400,
+		clock_recovery::FixedErrorFilter,
+		clock_recovery::MemberSymbolHandler<ACARSDemodulator, &ACARSDemodulator::consume_symbol>
+	> clock_recovery { { 0.0555f }, this };
 	symbol_coding::ACARSDecoder acars_decode { };
-	/*PacketBuilder<BitPattern, NeverMatch, FixedLength> packet_builder {
+	PacketBuilder<BitPattern, NeverMatch, ACARSBlockEnd> packet_builder {
 		{ 0b011010000110100010000000, 24, 1 },	// SYN, SYN, SOH
 		{ },
-		{ 128 },
+		{ },
 		[this](const baseband::Packet& packet) {
 			this->payload_handler(packet);
 		}
-	};*/
-	baseband::Packet packet { };
+	};
 
-	void consume_symbol(const float symbol);
 	void payload_handler(const baseband::Packet& packet);
+
+public:
+	ACARSDemodulator() {
+		tone_shift.configure(1800, audio_fs);
+	}
+};
+
+/* Up to three ACARS channels at once, within 150kHz of the capture's FS/4
+ * shifted center. The first decimation stage is shared.
+ */
+class ACARSProcessor : public BasebandProcessor {
+public:
+	ACARSProcessor();
+
+	void execute(const buffer_c8_t& buffer) override;
+
+	void on_message(const Message* const message) override;
+
+private:
+	static constexpr size_t baseband_fs = 4915200;
+	static constexpr size_t channels_max = ACARSConfigureMessage::channels_max;
+
+	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
+	RSSIThread rssi_thread { NORMALPRIO + 10 };
+
+	Channelizer<channels_max> channelizer { };
+	std::array<ACARSDemodulator, channels_max> demodulators { };
+	bool configured { false };
+
+	void configure(const ACARSConfigureMessage& message);
 };
 
 #endif/*__PROC_ACARS_H__*/
@@ -22,128 +22,186 @@
 
 #include "proc_adsbrx.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
 #include <cstddef>
+#include <algorithm>
 
 using namespace adsb;
+
+std::array<uint32_t, 256> ADSBRXProcessor::make_crc_table() {
+	// Mode S CRC-24, generator 0x1FFF409, MSB first
+	std::array<uint32_t, 256> table { };
+	for (size_t b = 0; b < table.size(); b++) {
+		uint32_t c = b << 16;
+		for (size_t i = 0; i < 8; i++)
+			c = (c & 0x800000) ? ((c << 1) ^ 0xFFF409) : (c << 1);
+		table[b] = c & 0xFFFFFF;
+	}
+	return table;
+}
+
+uint32_t ADSBRXProcessor::syndrome(const std::array<uint32_t, 256>& table, const uint8_t* const data, const size_t bits) {
+	// CRC of the data bits XOR the received parity, 0 if the frame is intact
+	const size_t data_bytes = (bits / 8) - 3;
+	uint32_t c = 0;
+	for (size_t i = 0; i < data_bytes; i++)
+		c = ((c << 8) ^ table[((c >> 16) ^ data[i]) & 0xFF]) & 0xFFFFFF;
+	return c ^ ((data[data_bytes] << 16) | (data[data_bytes + 1] << 8) | data[data_bytes + 2]);
+}
+
+std::array<ADSBRXProcessor::syndrome_t, ADSBRXProcessor::correctable_bits> ADSBRXProcessor::make_syndrome_table(
+	const std::array<uint32_t, 256>& table
+) {
+	// The CRC is linear: a frame's syndrome is the XOR of the syndromes of its
+	// wrong bits. Sorted so that single bit errors can be looked up.
+	std::array<syndrome_t, correctable_bits> syndromes { };
+	for (size_t i = 0; i < syndromes.size(); i++) {
+		uint8_t data[14] { };
+		const size_t bit = correctable_first_bit + i;
+		data[bit >> 3] = 0x80 >> (bit & 7);
+		syndromes[i] = { syndrome(table, data, long_frame_bits), bit };
+	}
+	std::sort(syndromes.begin(), syndromes.end(), [](const syndrome_t& a, const syndrome_t& b) {
+		return a.syndrome < b.syndrome;
+	});
+	return syndromes;
+}
+
+int32_t ADSBRXProcessor::find_syndrome(const uint32_t s) const {
+	const auto it = std::lower_bound(syndrome_table.begin(), syndrome_table.end(), s, [](const syndrome_t& a, const uint32_t v) {
+		return a.syndrome < v;
+	});
+	if ((it == syndrome_table.end()) || (it->syndrome != s))
+		return -1;
+	return it->bit;
+}
+
+bool ADSBRXProcessor::correct(uint8_t* const data, const uint32_t s) const {
+	// One bit
+	const auto bit = find_syndrome(s);
+	if (bit >= 0) {
+		data[bit >> 3] ^= 0x80 >> (bit & 7);
+		return true;
+	}
 	
-void ADSBRXProcessor::execute(const buffer_c8_t& buffer) {
-	int8_t re, im;
-	float mag;
-	uint32_t c;
-	uint8_t level, bit, byte { };
-	//bool confidence;
-	bool first_in_window, last_in_window;
+	// Two bits, each pair is tried once
+	for (const auto& entry : syndrome_table) {
+		const auto other = find_syndrome(s ^ entry.syndrome);
+		if (other > (int32_t)entry.bit) {
+			data[entry.bit >> 3] ^= 0x80 >> (entry.bit & 7);
+			data[other >> 3] ^= 0x80 >> (other & 7);
+			return true;
+		}
+	}
 	
-	// This is called at 2M/2048 = 977Hz
-	// One pulse = 500ns = 2 samples
-	// One bit = 2 pulses = 1us = 4 samples
+	return false;
+}
+
+bool ADSBRXProcessor::duplicate(const uint8_t* const data, const uint32_t sample) {
+	// Same frame decoded twice (multipath, overlapping preambles)
+	for (const auto& frame : recent) {
+		if (((sample - frame.sample) < dedup_samples) && !memcmp(frame.data, data, sizeof(frame.data)))
+			return true;
+	}
+	
+	auto& frame = recent[recent_index];
+	memcpy(frame.data, data, sizeof(frame.data));
+	frame.sample = sample;
+	recent_index = (recent_index + 1) % recent.size();
+	return false;
+}
+
+bool ADSBRXProcessor::detect_preamble(const uint16_t* const m) const {
+	// Pulses at samples 0, 2, 7 and 9
+	if (!((m[0] > m[1]) && (m[1] < m[2]) && (m[2] > m[3]) && (m[3] < m[0]) &&
+		(m[4] < m[0]) && (m[5] < m[0]) && (m[6] < m[0]) &&
+		(m[7] > m[8]) && (m[8] < m[9]) && (m[9] > m[6])))
+		return false;
 	
-	if (!configured) return;
+	const uint32_t high = (m[0] + m[2] + m[7] + m[9]) / 4;
+	if (high < mag2_min)
+		return false;
 	
+	// Gaps must be at least 3dB under the pulses
+	const uint32_t quiet = high / 2;
+	return (m[4] < quiet) && (m[5] < quiet) &&
+		(m[11] < quiet) && (m[12] < quiet) && (m[13] < quiet) && (m[14] < quiet);
+}
+
+size_t ADSBRXProcessor::decode(const uint16_t* const m, const uint32_t sample, const uint64_t sample_index) {
+	uint8_t data[14] { };
+	const uint16_t* bit_m = m + preamble_samples;
+	
+	// PPM: first half of the bit period stronger = 1
+	for (size_t bit = 0; bit < long_frame_bits; bit++) {
+		if (bit_m[bit * 2] > bit_m[bit * 2 + 1])
+			data[bit >> 3] |= 0x80 >> (bit & 7);
+	}
+	
+	const uint8_t df = data[0] >> 3;
+	const size_t bits = (df >= 16) ? long_frame_bits : short_frame_bits;
+	
+	// Only extended squitters have a plain CRC, the others have it merged
+	// with the address and can't be checked here
+	if ((df != df_extended_squitter) && (df != df_extended_squitter_non_transponder))
+		return 0;
+	
+	const uint32_t s = syndrome(crc_table, data, bits);
+	if (s && !correct(data, s))
+		return 0;
+	
+	if (!duplicate(data, sample)) {
+		ADSBFrame frame;
+		frame.clear();
+		frame.set_sample_index(sample_index);
+		for (size_t i = 0; i < (bits / 8); i++)
+			frame.push_byte(data[i]);
+		frames.push(frame);
+		BasebandProcessor::count_decode();
+	}
+	
+	return preamble_samples + (bits * 2);
+}
+
+void ADSBRXProcessor::execute(const buffer_c8_t& buffer) {
+	// This is called at 2M/2048 = 977Hz
+	if (!configured || (buffer.count > buffer_samples)) return;
+	
+	// Squared magnitudes, no need for sqrt as only comparisons are made
+	auto m = &mag2[history_samples];
 	for (size_t i = 0; i < buffer.count; i++) {
-		
-		// Compute sample's magnitude
-		re = buffer.p[i].real();
-		im = buffer.p[i].imag();
-		mag = __builtin_sqrtf((re * re) + (im * im)) * k;
-		
-		// Only used for preamble detection and visualisation
-		level = (mag < 0.3) ? 0 :		// Blank weak signals
-					(mag > prev_mag) ? 1 : 0;
-		
-		if (decoding) {
-			// Decode
-			
-			// 1 bit lasts 2 samples
-			if (sample_count & 1) {
-				if ((prev_mag < threshold_low) && (mag < threshold_low)) {
-					// Both under window, silence.
-					if (null_count > 3) {
-						const ADSBFrameMessage message(frame);
-						shared_memory.application_queue.push(message);
-							
-						decoding = false;
-					} else
-						null_count++;
-						
-					//confidence = false;
-					if (prev_mag > mag)
-						bit = 1;
-					else
-						bit = 0;
-					
-				} else {
-					
-					null_count = 0;
-				
-					first_in_window = ((prev_mag >= threshold_low) && (prev_mag <= threshold_high));
-					last_in_window = ((mag >= threshold_low) && (mag <= threshold_high));
-					
-					if ((first_in_window && !last_in_window) || (!first_in_window && last_in_window)) {
-						//confidence = true;
-						if (prev_mag > mag)
-							bit = 1;
-						else
-							bit = 0;
-					} else {
-						//confidence = false;
-						if (prev_mag > mag)
-							bit = 1;
-						else
-							bit = 0;
-					}
-				}
-				
-				byte = bit | (byte << 1);
-				bit_count++;
-				if (!(bit_count & 7)) {
-					// Got one byte
-					frame.push_byte(byte);
-				}
-			}
-			sample_count++;
-		} else {
-			// Look for preamble
-			
-			// Shift
-			for (c = 0; c < (ADSB_PREAMBLE_LENGTH - 1); c++)
-				shifter[c] = shifter[c + 1];
-			shifter[15] = std::make_pair(mag, level);
-			
-			// Compare
-			for (c = 0; c < ADSB_PREAMBLE_LENGTH; c++) {
-				if (shifter[c].second != adsb_preamble[c])
-					break;
-			}
-				
-			if (c == ADSB_PREAMBLE_LENGTH) {
-				decoding = true;
-				sample_count = 0;
-				null_count = 0;
-				bit_count = 0;
-				frame.clear();
-				
-				// Compute preamble pulses power to set thresholds
-				threshold = (shifter[0].first + shifter[2].first + shifter[7].first + shifter[9].first) / 4;
-				threshold_high = threshold * 1.414;		// +3dB
-				threshold_low = threshold * 0.707;		// -3dB
+		const int32_t re = buffer.p[i].real();
+		const int32_t im = buffer.p[i].imag();
+		m[i] = (re * re) + (im * im);
+	}
+	
+	// Every sample is tried once as a preamble start, frames starting near
+	// the end of the buffer are completed by the next one's samples
+	size_t i = skip;
+	while (i < buffer.count) {
+		if (detect_preamble(&mag2[i])) {
+			// mag2 lags the buffer by history_samples
+			const size_t length = decode(&mag2[i], sample_counter + i, buffer.sample_index - history_samples + i);
+			if (length) {
+				i += length;
+				continue;
 			}
 		}
-		
-		prev_mag = mag;
+		i++;
 	}
+	skip = i - buffer.count;
+	sample_counter += buffer.count;
+	
+	std::copy(&mag2[buffer.count], &mag2[buffer.count + history_samples], mag2.begin());
+	
+	frames.poll();
 }
 
 void ADSBRXProcessor::on_message(const Message* const message) {
 	if (message->id == Message::ID::ADSBConfigure) {
-		null_count = 0;
-		bit_count = 0;
-		sample_count = 0;
-		decoding = false;
+		skip = 0;
 		configured = true;
 	}
 }
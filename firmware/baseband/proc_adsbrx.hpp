@@ -28,10 +28,11 @@
 #include "rssi_thread.hpp"
 
 #include "adsb_frame.hpp"
+#include "packet_staging.hpp"
 
-using namespace adsb;
+#include <array>
 
-#define ADSB_PREAMBLE_LENGTH 16
+using namespace adsb;
 
 class ADSBRXProcessor : public BasebandProcessor {
 public:
@@ -40,25 +41,58 @@ public:
 	void on_message(const Message* const message) override;
 
 private:
-	static constexpr float k = 1.0f / 128.0f;
-	
 	static constexpr size_t baseband_fs = 2000000;
 	
+	// One pulse = 500ns = 1 sample, one bit = 2 samples
+	static constexpr size_t buffer_samples = 2048;
+	static constexpr size_t preamble_samples = 16;
+	static constexpr size_t long_frame_bits = 112;
+	static constexpr size_t short_frame_bits = 56;
+	static constexpr size_t history_samples = preamble_samples + (long_frame_bits * 2);
+	static constexpr uint32_t mag2_min = 1444;				// (0.3 * 128)^2, blanks weak signals
+	static constexpr uint8_t df_extended_squitter = 17;
+	static constexpr uint8_t df_extended_squitter_non_transponder = 18;
+	static constexpr size_t correctable_first_bit = 5;		// DF is never corrected
+	static constexpr size_t correctable_bits = long_frame_bits - correctable_first_bit;
+	static constexpr size_t dedup_frames = 8;
+	static constexpr uint32_t dedup_samples = baseband_fs / 4;	// 250ms, less than any squitter period
+	
+	struct syndrome_t {
+		uint32_t syndrome;
+		uint32_t bit;
+	};
+	
+	struct recent_frame_t {
+		uint8_t data[14];
+		uint32_t sample;
+	};
+	
+	// Built before the baseband thread starts
+	const std::array<uint32_t, 256> crc_table { make_crc_table() };
+	const std::array<syndrome_t, correctable_bits> syndrome_table { make_syndrome_table(crc_table) };
+	
+	// Magnitudes squared, the first history_samples are the end of the previous buffer
+	std::array<uint16_t, history_samples + buffer_samples> mag2 { };
+	size_t skip { 0 };
+	uint32_t sample_counter { 0 };
+	std::array<recent_frame_t, dedup_frames> recent { };
+	size_t recent_index { 0 };
+	PacketBatcher<ADSBFrameMessage> frames { };
+	
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 	
-	ADSBFrame frame { };
 	bool configured { false };
-	float prev_mag { 0 };
-	float threshold { }, threshold_low { }, threshold_high { };
-	size_t null_count { 0 }, bit_count { 0 }, sample_count { 0 };
-	std::pair<float, uint8_t> shifter[ADSB_PREAMBLE_LENGTH];
-	bool decoding { };
-	bool preamble { }, active { };
-    uint16_t bit_pos { 0 };
-    uint8_t cur_bit { 0 };
-	uint32_t sample { 0 };
-	int8_t re { }, im { };
+	
+	static std::array<uint32_t, 256> make_crc_table();
+	static std::array<syndrome_t, correctable_bits> make_syndrome_table(const std::array<uint32_t, 256>& table);
+	static uint32_t syndrome(const std::array<uint32_t, 256>& table, const uint8_t* const data, const size_t bits);
+	
+	bool detect_preamble(const uint16_t* const m) const;
+	size_t decode(const uint16_t* const m, const uint32_t sample, const uint64_t sample_index);
+	bool correct(uint8_t* const data, const uint32_t s) const;
+	int32_t find_syndrome(const uint32_t s) const;
+	bool duplicate(const uint8_t* const data, const uint32_t sample);
 };
 
 #endif
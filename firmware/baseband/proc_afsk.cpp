@@ -34,12 +34,35 @@ void AFSKProcessor::execute(const buffer_c8_t& buffer) {
 	if (!configured) return;
 	
 	for (size_t i = 0; i<buffer.count; i++) {
+		
+		if (sequencer.in_guard()) {
+			// Silent while the application retunes
+			buffer.p[i] = { 0, 0 };
+			if (sequencer.advance(1)) {
+				word_ptr = step_data();
+				bit_pos = 0;
+				sample_count = afsk_samples_per_bit;
+			}
+			continue;
+		}
 
 		if (sample_count >= afsk_samples_per_bit) {
-			if (configured) {
+			if (streamed) {
+				// One bit per word, see symbol_count
+				cur_word = next_stream_bit();
+			} else if (configured) {
 				cur_word = *word_ptr;
 				
-				if (!cur_word) {
+				if (!cur_word && sequencer.active()) {
+					// End of the step's data
+					bit_pos = 0;
+					if (sequencer.end_step()) {
+						word_ptr = step_data();
+						cur_word = *word_ptr;
+					} else if (!sequencer.active()) {
+						configured = false;
+					}
+				} else if (!cur_word) {
 					// End of data
 					if (repeat_counter < afsk_repeat) {
 						// Repeat
@@ -69,31 +92,60 @@ void AFSKProcessor::execute(const buffer_c8_t& buffer) {
 				bit_pos++;
 			}
 			
+			tone_phase_inc = cur_bit ? afsk_phase_inc_mark : afsk_phase_inc_space;
 			sample_count = 0;
 		} else {
 			sample_count++;
 		}
 		
-		if (cur_bit)
-			tone_phase += afsk_phase_inc_mark;
-		else
-			tone_phase += afsk_phase_inc_space;
-
-		tone_sample = sine_table_i8[(tone_phase & 0xFF000000U) >> 24];
+		tone_phase += tone_phase_inc;
+		phase += sine_table_i8[tone_phase >> 24] * fm_delta;
+		buffer.p[i] = carrier[phase];
+	}
+}
 
-		delta = tone_sample * fm_delta;
-		
-		phase += delta;
-		sphase = phase + (64 << 24);
+uint16_t* AFSKProcessor::step_data() const {
+	return (uint16_t*)shared_memory.bb_data.data + sequencer.payload();
+}
 
-		re = (sine_table_i8[(sphase & 0xFF000000U) >> 24]);
-		im = (sine_table_i8[(phase & 0xFF000000U) >> 24]);
-			
-		buffer.p[i] = {re, im};
+uint16_t AFSKProcessor::next_stream_bit() {
+	// Space tone until the application has prefilled, and through underruns.
+	uint8_t bit = 0;
+	if (!stream || !stream_ready)
+		return 0;
+	
+	if (!stream->read_bit(bit) && stream->is_done()) {
+		txprogress_message.done = true;
+		shared_memory.application_queue.push(txprogress_message);
+		configured = false;
+		streamed = false;
 	}
+	return bit;
 }
 
 void AFSKProcessor::on_message(const Message* const msg) {
+	if (msg->id == Message::ID::ReplayConfig) {
+		const auto message = *reinterpret_cast<const ReplayConfigMessage*>(msg);
+		stream_ready = false;
+		if (message.config)
+			stream = std::make_unique<BitStream>(message.config);
+		else
+			stream.reset();
+		return;
+	}
+	
+	// App has prefilled the buffers
+	if (msg->id == Message::ID::FIFOData) {
+		stream_ready = true;
+		return;
+	}
+	
+	// Before AFSKTxConfigure, which starts it
+	if (msg->id == Message::ID::TxSequenceConfig) {
+		sequencer.configure(*reinterpret_cast<const TxSequenceConfigMessage*>(msg));
+		return;
+	}
+	
 	const auto message = *reinterpret_cast<const AFSKTxConfigureMessage*>(msg);
 	
 	if (message.id == Message::ID::AFSKTxConfigure) {
@@ -103,14 +155,17 @@ void AFSKProcessor::on_message(const Message* const msg) {
 			afsk_phase_inc_space = message.phase_inc_space * AFSK_DELTA_COEF;
 			afsk_repeat = message.repeat - 1;
 			fm_delta = message.fm_delta * (0xFFFFFFULL / AFSK_SAMPLERATE);
-			symbol_count = message.symbol_count - 1;
+			// Streamed bits aren't packed in words
+			streamed = !message.repeat;
+			symbol_count = streamed ? 0 : (message.symbol_count - 1);
 
 			sample_count = afsk_samples_per_bit;
 			repeat_counter = 0;
 			bit_pos = 0;
-			word_ptr = (uint16_t*)shared_memory.bb_data.data;
+			word_ptr = sequencer.active() ? step_data() : (uint16_t*)shared_memory.bb_data.data;
 			cur_word = 0;
 			cur_bit = 0;
+			tone_phase_inc = afsk_phase_inc_space;
 			configured = true;
 		} else
 			configured = false;		// Kill
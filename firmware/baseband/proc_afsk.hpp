@@ -25,6 +25,11 @@
 
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
+#include "stream_bits.hpp"
+#include "sine_table_c8.hpp"
+#include "tx_sequencer.hpp"
+
+#include <memory>
 
 #define AFSK_SAMPLERATE 1536000
 #define AFSK_DELTA_COEF ((1ULL << 32) / AFSK_SAMPLERATE)
@@ -53,12 +58,23 @@ private:
     uint16_t cur_word { 0 };
     uint8_t cur_bit { 0 };
     uint32_t sample_count { 0 };
-	uint32_t tone_phase { 0 }, phase { 0 }, sphase { 0 };
-	int32_t tone_sample { 0 }, delta { 0 };
+	uint32_t tone_phase { 0 }, tone_phase_inc { 0 }, phase { 0 };
 	
-	int8_t re { 0 }, im { 0 };
+	const ComplexSineTableI8 carrier { };
 	
 	TXProgressMessage txprogress_message { };
+	
+	// Each step's payload is its data's offset in bb_data, in words; it
+	// ends with the data, and takes the place of afsk_repeat.
+	TxSequencer sequencer { };
+	
+	// A zero repeat takes the bits from here instead of bb_data
+	bool streamed { false };
+	std::unique_ptr<BitStream> stream { };
+	bool stream_ready { false };
+	
+	uint16_t next_stream_bit();
+	uint16_t* step_data() const;
 };
 
 #endif
@@ -25,6 +25,15 @@
 
 #include "event_m4.hpp"
 
+constexpr std::array<AFSKRxProcessor::TonePlan, AFSKRxProcessor::hdlc_plans_count> AFSKRxProcessor::hdlc_plans;
+
+void AFSKRxProcessor::Demodulator::configure(const TonePlan& plan) {
+	correlator.configure(audio_fs, plan.mark_frequency, plan.space_frequency, plan.baudrate);
+	phase_inc = (0x10000 * plan.baudrate) / audio_fs;
+	phase = 0;
+	sample_bits = 0;
+}
+
 void AFSKRxProcessor::execute(const buffer_c8_t& buffer) {
 	// This is called at 3072000 / 2048 = 1500Hz
 
@@ -43,104 +52,92 @@ void AFSKRxProcessor::execute(const buffer_c8_t& buffer) {
 
 	// Audio signal processing
 	for (size_t c = 0; c < audio.count; c++) {
-
 		const int32_t sample_int = audio.p[c] * 32768.0f;
-		int32_t current_sample = __SSAT(sample_int, 16);
-		
-		current_sample /= 128;
-		
-		// Delay line put
-		delay_line[delay_line_index & 0x3F] = current_sample;
+		audio_s16[c] = __SSAT(sample_int, 16);
+	}
+	const buffer_s16_t tones { audio_s16.data(), audio.count };
+	
+	if (hdlc) {
+		for (size_t n = 0; n < hdlc_plans_count; n++) {
+			auto& deframer = deframers[n];
+			hdlc_demods[n].execute(tones, [&deframer](const uint_fast8_t bit) {
+				deframer.execute(bit);
+			});
+		}
+	} else {
+		modem_demod.execute(tones, [this](const uint_fast8_t bit) {
+			this->on_bit(bit);
+		});
+	}
+}
+
+void AFSKRxProcessor::on_bit(const uint_fast8_t bit) {
+	if (trigger_word) {
 		
-		// Delay line get, and LPF
-		sample_mixed = (delay_line[(delay_line_index - (samples_per_bit/2)) & 0x3F] * current_sample) / 4;
-		sample_filtered = prev_mixed + sample_mixed + (prev_filtered / 2);
+		// Continuous-stream value-triggered mode (AX.25) - UNTESTED
+		word_bits <<= 1;
+		word_bits |= bit;
 		
-		delay_line_index++;
+		bit_counter++;
 		
-		prev_filtered = sample_filtered;
-		prev_mixed = sample_mixed;
+		if (triggered) {
+			if (bit_counter == word_length) {
+				bit_counter = 0;
+				
+				data_message.is_data = true;
+				data_message.value = word_bits & word_mask;
+				shared_memory.application_queue.push(data_message);
+			}
+		} else {
+			if ((word_bits & word_mask) == trigger_value) {
+				triggered = !triggered;
+				bit_counter = 0;
+				
+				data_message.is_data = true;
+				data_message.value = trigger_value;
+				shared_memory.application_queue.push(data_message);
+			}
+		}
 		
-		// Slice
-		sample_bits <<= 1;
-		sample_bits |= (sample_filtered < -20) ? 1 : 0;
+	} else {
 		
-		// Check for "clean" transition: either 0011 or 1100
-		if ((((sample_bits >> 2) ^ sample_bits) & 3) == 3) {
-			// Adjust phase
-			if (phase < 0x8000)
-				phase += 0x800;		// Is this a proper value ?
-			else
-				phase -= 0x800;
+		// RS232-like modem mode
+		if (state == WAIT_START) {
+			if (!bit) {
+				// Got start bit
+				state = RECEIVE;
+				bit_counter = 0;
+			}
+		} else if (state == WAIT_STOP) {
+			if (bit) {
+				// Got stop bit
+				state = WAIT_START;
+			}
+		} else {
+			word_bits <<= 1;
+			word_bits |= bit;
+			
+			bit_counter++;
 		}
 		
-		phase += phase_inc;
-		
-		if (phase >= 0x10000) {
-			phase &= 0xFFFF;
+		if (bit_counter == word_length) {
+			bit_counter = 0;
+			state = WAIT_STOP;
 			
-			if (trigger_word) {
-				
-				// Continuous-stream value-triggered mode (AX.25) - UNTESTED
-				word_bits <<= 1;
-				word_bits |= (sample_bits & 1);
-				
-				bit_counter++;
-				
-				if (triggered) {
-					if (bit_counter == word_length) {
-						bit_counter = 0;
-						
-						data_message.is_data = true;
-						data_message.value = word_bits & word_mask;
-						shared_memory.application_queue.push(data_message);
-					}
-				} else {
-					if ((word_bits & word_mask) == trigger_value) {
-						triggered = !triggered;
-						bit_counter = 0;
-						
-						data_message.is_data = true;
-						data_message.value = trigger_value;
-						shared_memory.application_queue.push(data_message);
-					}
-				}
-				
-			} else {
-				
-				// RS232-like modem mode
-				if (state == WAIT_START) {
-					if (!(sample_bits & 1)) {
-						// Got start bit
-						state = RECEIVE;
-						bit_counter = 0;
-					}
-				} else if (state == WAIT_STOP) {
-					if (sample_bits & 1) {
-						// Got stop bit
-						state = WAIT_START;
-					}
-				} else {
-					word_bits <<= 1;
-					word_bits |= (sample_bits & 1);
-					
-					bit_counter++;
-				}
-				
-				if (bit_counter == word_length) {
-					bit_counter = 0;
-					state = WAIT_STOP;
-					
-					data_message.is_data = true;
-					data_message.value = word_bits;
-					shared_memory.application_queue.push(data_message);
-				}
-				
-			}
+			data_message.is_data = true;
+			data_message.value = word_bits;
+			shared_memory.application_queue.push(data_message);
 		}
+		
 	}
 }
 
+void AFSKRxProcessor::on_frame(const ax25::Packet& packet) {
+	const AX25PacketMessage message { packet };
+	shared_memory.application_queue.push(message);
+	count_decode();
+}
+
 void AFSKRxProcessor::on_message(const Message* const message) {
 	if (message->id == Message::ID::AFSKRxConfigure)
 		configure(*reinterpret_cast<const AFSKRxConfigureMessage*>(message));
@@ -165,19 +162,18 @@ void AFSKRxProcessor::configure(const AFSKRxConfigureMessage& message) {
 
 	audio_output.configure(audio_24k_hpf_300hz_config, audio_24k_deemph_300_6_config, 0);
 	
-	samples_per_bit = audio_fs / message.baudrate;
-	
-	phase_inc = (0x10000 * message.baudrate) / audio_fs;
-	phase = 0;
+	hdlc = message.hdlc;
+	modem_demod.configure({ message.mark_frequency, message.space_frequency, message.baudrate });
+	for (size_t n = 0; n < hdlc_plans_count; n++) {
+		hdlc_demods[n].configure(hdlc_plans[n]);
+		deframers[n].reset();
+	}
 	
 	trigger_word = message.trigger_word;
 	word_length = message.word_length;
 	trigger_value = message.trigger_value;
 	word_mask = (1 << word_length) - 1;
 	
-	// Delay line
-	delay_line_index = 0;
-	
 	triggered = false;
 	state = WAIT_START;
 	
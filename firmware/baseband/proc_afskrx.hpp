@@ -29,6 +29,8 @@
 
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
+#include "dsp_fsk_correlator.hpp"
+#include "hdlc_deframer.hpp"
 
 #include "audio_output.hpp"
 
@@ -45,7 +47,58 @@ private:
 	static constexpr size_t baseband_fs = 3072000;
 	static constexpr size_t audio_fs = baseband_fs / 8 / 8 / 2;
 	
-	size_t samples_per_bit { };
+	struct TonePlan {
+		uint32_t mark_frequency;
+		uint32_t space_frequency;
+		uint32_t baudrate;
+	};
+	
+	/* Run side by side in HDLC mode, each into its own deframer: VHF
+	 * packet (Bell 202) and HF packet (300 bauds, 200Hz shift).
+	 */
+	static constexpr size_t hdlc_plans_count = 2;
+	static constexpr std::array<TonePlan, hdlc_plans_count> hdlc_plans { {
+		{ 1200, 2200, 1200 },
+		{ 1600, 1800, 300 }
+	} };
+	
+	// Correlator and bit clock for one tone plan
+	class Demodulator {
+	public:
+		void configure(const TonePlan& plan);
+		
+		/* Calls bit_handler with each bit, sampled mid-bit. */
+		template<typename BitHandler>
+		void execute(const buffer_s16_t& src, BitHandler bit_handler) {
+			correlator.execute(src, symbols.data());
+			
+			for (size_t c = 0; c < src.count; c++) {
+				sample_bits = (sample_bits << 1) | symbols[c];
+				
+				// Check for "clean" transition: either 0011 or 1100
+				if ((((sample_bits >> 2) ^ sample_bits) & 3) == 3) {
+					// Adjust phase
+					if (phase < 0x8000)
+						phase += 0x800;		// Is this a proper value ?
+					else
+						phase -= 0x800;
+				}
+				
+				phase += phase_inc;
+				
+				if (phase >= 0x10000) {
+					phase &= 0xFFFF;
+					bit_handler(sample_bits & 1);
+				}
+			}
+		}
+		
+	private:
+		dsp::FSKCorrelator correlator { };
+		std::array<uint8_t, 32> symbols { };
+		uint32_t sample_bits { 0 };
+		uint32_t phase { 0 }, phase_inc { 0 };
+	};
 	
 	enum State {
 		WAIT_START = 0,
@@ -66,9 +119,7 @@ private:
 		audio.data(),
 		audio.size()
 	};
-	
-	// Array size ok down to 375 bauds (24000 / 375)
-	std::array<int32_t, 64> delay_line { 0 };
+	std::array<int16_t, 32> audio_s16 { };
 	
 	dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0 { };
 	dsp::decimate::FIRC16xR16x32Decim8 decim_1 { };
@@ -78,26 +129,31 @@ private:
 	
 	AudioOutput audio_output { };
 
+	Demodulator modem_demod { };
+	std::array<Demodulator, hdlc_plans_count> hdlc_demods { };
+
 	State state { };
-	size_t delay_line_index { };
 	uint32_t bit_counter { 0 };
 	uint32_t word_bits { 0 };
-	uint32_t sample_bits { 0 };
-	uint32_t phase { }, phase_inc { };
-	int32_t sample_mixed { }, prev_mixed { }, sample_filtered { }, prev_filtered { };
 	uint32_t word_length { };
 	uint32_t word_mask { };
 	uint32_t trigger_value { };
 	
 	bool configured { false };
-	bool wait_start { };
-	bool bit_value { };
 	bool trigger_word { };
 	bool triggered { };
+	bool hdlc { };
 	
 	void configure(const AFSKRxConfigureMessage& message);
+	void on_bit(const uint_fast8_t bit);
+	void on_frame(const ax25::Packet& packet);
 	
 	AFSKDataMessage data_message { false, 0 };
+
+	std::array<HDLCDeframer, hdlc_plans_count> deframers { {
+		{ [this](const ax25::Packet& packet) { this->on_frame(packet); } },
+		{ [this](const ax25::Packet& packet) { this->on_frame(packet); } }
+	} };
 };
 
 #endif/*__PROC_TPMS_H__*/
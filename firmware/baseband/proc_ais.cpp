@@ -27,29 +27,43 @@
 
 #include "event_m4.hpp"
 
+constexpr std::array<int32_t, 2> AISProcessor::channel_offsets_hz;
+
 AISProcessor::AISProcessor() {
-	decim_0.configure(taps_11k0_decim_0.taps, 33554432);
-	decim_1.configure(taps_11k0_decim_1.taps, 131072);
+	channelizer.configure(
+		taps_11k0_decim_0.taps, 33554432,
+		taps_11k0_decim_1.taps, 131072,
+		channel_offsets_hz, baseband_fs
+	);
+	for(size_t i=0; i<demodulators.size(); i++) {
+		demodulators[i].set_channel(i);
+	}
 }
 
 void AISProcessor::execute(const buffer_c8_t& buffer) {
 	/* 2.4576MHz, 2048 samples */
 
-	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-	const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
-	const auto decimator_out = decim_1_out;
-
-	/* 38.4kHz, 32 samples */
-	feed_channel_stats(decimator_out);
+	channelizer.execute(buffer, [this, &buffer](const size_t index, const buffer_c16_t& channel) {
+		/* 38.4kHz, 32 samples */
+		// Stats follow one channel, they're about signal level at the antenna.
+		if( index == 0 ) {
+			this->feed_channel_stats(channel);
+		}
+		this->demodulators[index].execute(channel, buffer.sample_index, buffer.count / channel.count);
+	});
+}
 
-	for(size_t i=0; i<decimator_out.count; i++) {
-		if( mf.execute_once(decimator_out.p[i]) ) {
+void AISDemodulator::execute(const buffer_c16_t& channel, const uint64_t sample_index, const size_t stride) {
+	staging.flush();
+	for(size_t i=0; i<channel.count; i++) {
+		if( mf.execute_once(channel.p[i]) ) {
+			packet_builder.set_sample_index(sample_index + i * stride);
 			clock_recovery(mf.get_output());
 		}
 	}
 }
 
-void AISProcessor::consume_symbol(
+void AISDemodulator::consume_symbol(
 	const float raw_symbol
 ) {
 	const uint_fast8_t sliced_symbol = (raw_symbol >= 0.0f) ? 1 : 0;
@@ -58,11 +72,12 @@ void AISProcessor::consume_symbol(
 	packet_builder.execute(decoded_symbol);
 }
 
-void AISProcessor::payload_handler(
+void AISDemodulator::payload_handler(
 	const baseband::Packet& packet
 ) {
-	const AISPacketMessage message { packet };
-	shared_memory.application_queue.push(message);
+	const AISPacketMessage message { packet, channel };
+	staging.push(message);
+	BasebandProcessor::count_decode();
 }
 
 int main() {
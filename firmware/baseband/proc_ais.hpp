@@ -26,13 +26,14 @@
 #include "baseband_thread.hpp"
 #include "rssi_thread.hpp"
 
-#include "channel_decimator.hpp"
+#include "channelizer.hpp"
 #include "matched_filter.hpp"
 
 #include "clock_recovery.hpp"
 #include "symbol_coding.hpp"
 #include "packet_builder.hpp"
 #include "baseband_packet.hpp"
+#include "packet_staging.hpp"
 
 #include "message.hpp"
 
@@ -42,32 +43,31 @@
 
 #include "ais_baseband.hpp"
 
-class AISProcessor : public BasebandProcessor {
+/* Demodulator and packet decoder for one AIS channel at 38.4kHz. */
+class AISDemodulator {
 public:
-	AISProcessor();
+	void set_channel(const uint8_t new_channel) {
+		channel = new_channel;
+	}
 
-	void execute(const buffer_c8_t& buffer) override;
+	/* sample_index is the baseband's at channel.p[0], stride baseband
+	 * samples per channel sample; packets are stamped with it.
+	 */
+	void execute(const buffer_c16_t& channel, const uint64_t sample_index, const size_t stride);
 
 private:
-	static constexpr size_t baseband_fs = 2457600;
+	uint8_t channel { 0 };
+	PacketStaging<AISPacketMessage, 4> staging { };
 
-	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
-	RSSIThread rssi_thread { NORMALPRIO + 10 };
+	dsp::matched_filter::MatchedFilterQ15<baseband::ais::square_taps_38k4_1t_p.size()> mf { baseband::ais::square_taps_38k4_1t_p, 2 };
 
-	std::array<complex16_t, 512> dst { };
-	const buffer_c16_t dst_buffer {
-		dst.data(),
-		dst.size()
-	};
-
-	dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0 { };
-	dsp::decimate::FIRC16xR16x32Decim8 decim_1 { };
-	dsp::matched_filter::MatchedFilter mf { baseband::ais::square_taps_38k4_1t_p, 2 };
+	void consume_symbol(const float symbol);
 
-	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery {
-		19200, 9600, { 0.0555f },
-		[this](const float symbol) { this->consume_symbol(symbol); }
-	};
+	clock_recovery::FixedRateClockRecovery<
+		19200, 9600,
+		clock_recovery::FixedErrorFilter,
+		clock_recovery::MemberSymbolHandler<AISDemodulator, &AISDemodulator::consume_symbol>
+	> clock_recovery { { 0.0555f }, this };
 	symbol_coding::NRZIDecoder nrzi_decode { };
 	PacketBuilder<BitPattern, BitPattern, BitPattern> packet_builder {
 		{ 0b0101010101111110, 16, 1 },
@@ -78,8 +78,27 @@ private:
 		}
 	};
 
-	void consume_symbol(const float symbol);
 	void payload_handler(const baseband::Packet& packet);
 };
 
+/* Both AIS channels (87B 161.975MHz, 88B 162.025MHz) at once, around a
+ * 162.000MHz target. The first decimation stage is shared.
+ */
+class AISProcessor : public BasebandProcessor {
+public:
+	AISProcessor();
+
+	void execute(const buffer_c8_t& buffer) override;
+
+private:
+	static constexpr size_t baseband_fs = 2457600;
+	static constexpr std::array<int32_t, 2> channel_offsets_hz { { -25000, 25000 } };
+
+	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
+	RSSIThread rssi_thread { NORMALPRIO + 10 };
+
+	Channelizer<channel_offsets_hz.size()> channelizer { };
+	std::array<AISDemodulator, channel_offsets_hz.size()> demodulators { };
+};
+
 #endif/*__PROC_AIS_H__*/
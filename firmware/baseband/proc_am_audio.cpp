@@ -42,7 +42,6 @@ void NarrowbandAMAudio::execute(const buffer_c8_t& buffer) {
 	channel_spectrum.feed(channel_out, channel_filter_pass_f, channel_filter_stop_f);
 
 	auto audio = demodulate(channel_out);
-	audio_compressor.execute_in_place(audio);
 	audio_output.write(audio);
 }
 
@@ -94,8 +93,11 @@ void NarrowbandAMAudio::configure(const AMConfigureMessage& message) {
 	channel_filter_pass_f = message.channel_filter.pass_frequency_normalized * channel_filter_input_fs;
 	channel_filter_stop_f = message.channel_filter.stop_frequency_normalized * channel_filter_input_fs;
 	channel_spectrum.set_decimation_factor(std::floor(channel_filter_output_fs / (channel_filter_pass_f + channel_filter_stop_f)));
-	modulation_ssb = (message.modulation == AMConfigureMessage::Modulation::SSB);
+	modulation_ssb = (message.modulation != AMConfigureMessage::Modulation::DSB);
+	demod_ssb.configure(message.modulation == AMConfigureMessage::Modulation::USB);
 	audio_output.configure(message.audio_hpf_config);
+	// As the float compressor had it: 10:1 over -30dBFS, made up to full scale
+	audio_output.configure_compressor({ -30.0f, 10.0f, 27.0f, -1.0f, 0.300f }, channel_filter_output_fs);
 
 	configured = true;
 }
@@ -108,8 +110,10 @@ void NarrowbandAMAudio::capture_config(const CaptureConfigMessage& message) {
 	}
 }
 
+#ifndef BASEBAND_MULTI_PROCESSOR
 int main() {
 	EventDispatcher event_dispatcher { std::make_unique<NarrowbandAMAudio>() };
 	event_dispatcher.run();
 	return 0;
 }
+#endif
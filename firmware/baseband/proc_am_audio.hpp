@@ -24,11 +24,11 @@
 
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
+#include "dsp_iq_correction.hpp"
 #include "rssi_thread.hpp"
 
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
-#include "audio_compressor.hpp"
 
 #include "audio_output.hpp"
 #include "spectrum_collector.hpp"
@@ -38,6 +38,7 @@
 class NarrowbandAMAudio : public BasebandProcessor {
 public:
 	void execute(const buffer_c8_t& buffer) override;
+	void correct_iq(const buffer_c8_t& buffer) override { iq_correction.execute(buffer); }
 	
 	void on_message(const Message* const message) override;
 
@@ -46,6 +47,7 @@ private:
 	static constexpr size_t decim_2_decimation_factor = 4;
 	static constexpr size_t channel_filter_decimation_factor = 1;
 
+	IQCorrectionStage iq_correction { };
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 
@@ -70,7 +72,6 @@ private:
 	bool modulation_ssb = false;
 	dsp::demodulate::AM demod_am { };
 	dsp::demodulate::SSB demod_ssb { };
-	FeedForwardCompressor audio_compressor { };
 	AudioOutput audio_output { };
 
 	SpectrumCollector channel_spectrum { };
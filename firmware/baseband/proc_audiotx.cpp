@@ -22,39 +22,30 @@
 
 #include "proc_audiotx.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
-//#include "audio_output.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
+#include <algorithm>
+
+AudioTXProcessor::AudioTXProcessor() {
+	modulator.configure(interpolation);
+}
 
 void AudioTXProcessor::execute(const buffer_c8_t& buffer){
 	
 	if (!configured) return;
 	
+	const size_t count = std::min(audio.size(), buffer.count / interpolation);
+	
 	if( stream ) {
-		const size_t bytes_to_read = (buffer.count / 32);	// /32 (oversampling) should be == 64
-		bytes_read += stream->read(audio_buffer.p, bytes_to_read);
+		bytes_read += stream->read(audio.data(), count);
 	}
 	
-	// Fill and "stretch"
-	for (size_t i = 0; i < buffer.count; i++) {
-		if (!(i & 31))
-			audio_sample = audio_buffer.p[i >> 5] - 0x80;
-		
-		sample = tone_gen.process(audio_sample);
-		
-		// FM
-		delta = sample * fm_delta;
-		
-		phase += delta;
-		sphase = phase + (64 << 24);
-		
-		re = (sine_table_i8[(sphase & 0xFF000000U) >> 24]);
-		im = (sine_table_i8[(phase & 0xFF000000U) >> 24]);
-		
-		buffer.p[i] = { (int8_t)re, (int8_t)im };
-	}
+	// Unsigned 8 bit file samples, full scale at half deviation as they always were
+	for (size_t i = 0; i < count; i++)
+		samples[i] = __SSAT(tone_gen.process_q15((audio[i] - 0x80) << 7), 16);
+	
+	modulator.execute({ samples.data(), count, baseband_fs / interpolation }, buffer);
 	
 	spectrum_samples += buffer.count;
 	if( spectrum_samples >= spectrum_interval_samples ) {
@@ -64,8 +55,6 @@ void AudioTXProcessor::execute(const buffer_c8_t& buffer){
 		txprogress_message.done = false;
 		shared_memory.application_queue.push(txprogress_message);
 	}
-	
-	//AudioOutput::fill_audio_buffer(preview_audio_buffer, true);
 }
 
 void AudioTXProcessor::on_message(const Message* const message) {
@@ -94,23 +83,26 @@ void AudioTXProcessor::on_message(const Message* const message) {
 }
 
 void AudioTXProcessor::audio_config(const AudioTXConfigMessage& message) {
-	fm_delta = message.deviation_hz * (0xFFFFFFULL / baseband_fs);
-	tone_gen.configure(message.tone_key_delta, message.tone_key_mix_weight);
+	deviation_hz = message.deviation_hz;
+	if (baseband_fs)
+		modulator.modulation().configure(deviation_hz, baseband_fs);
+	// Tone deltas are for the baseband rate, the generator runs at the file's
+	tone_gen.configure(message.tone_key_delta * interpolation, message.tone_key_mix_weight);
 }
 
 void AudioTXProcessor::samplerate_config(const SamplerateConfigMessage& message) {
 	baseband_fs = message.sample_rate;
 	baseband_thread.set_sampling_rate(baseband_fs);
 	spectrum_interval_samples = baseband_fs / 20;
+	modulator.modulation().configure(deviation_hz, baseband_fs);
 }
 
 void AudioTXProcessor::replay_config(const ReplayConfigMessage& message) {
 	if( message.config ) {
 		
+		// Handled synchronously: FIFO pointers are valid once the app's
+		// send_message() returns, so the app can start prefilling then.
 		stream = std::make_unique<StreamOutput>(message.config);
-		
-		// Tell application that the buffers and FIFO pointers are ready, prefill
-		shared_memory.application_queue.push(sig_message);
 	} else {
 		stream.reset();
 	}
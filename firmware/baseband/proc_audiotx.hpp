@@ -27,44 +27,40 @@
 #include "baseband_thread.hpp"
 #include "tone_gen.hpp"
 #include "stream_output.hpp"
+#include "dsp_modulate.hpp"
+
+#include <array>
 
 class AudioTXProcessor : public BasebandProcessor {
 public:
+	AudioTXProcessor();
+	
 	void execute(const buffer_c8_t& buffer) override;
 	
 	void on_message(const Message* const msg) override;
 
 private:
+	// The file's rate, the app sets baseband_fs to match
+	static constexpr size_t interpolation = 32;
+	
 	size_t baseband_fs = 0;
 	
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Transmit };
 	
+	// 2048 / 32
 	std::array<uint8_t, 64> audio { };
-	const buffer_t<uint8_t> audio_buffer {
-		audio.data(),
-		audio.size(),
-		baseband_fs / 8
-	};
+	std::array<int16_t, 64> samples { };
 	
 	std::unique_ptr<StreamOutput> stream { };
 	
 	ToneGen tone_gen { };
 	
-	uint32_t fm_delta { 0 };
-	uint32_t phase { 0 }, sphase { 0 };
-	int8_t out_sample { };
-	int32_t sample { 0 }, audio_sample { 0 }, delta { };
-	int8_t re { 0 }, im { 0 };
+	dsp::modulate::TxModulator<dsp::modulate::FM> modulator { };
+	float deviation_hz { 0 };
 	
 	size_t spectrum_interval_samples = 0;
 	size_t spectrum_samples = 0;
 
-	//int16_t audio_data[64];
-	/*const buffer_s16_t preview_audio_buffer {
-		audio_data,
-		sizeof(int16_t)*64
-	};*/
-	
 	bool configured { false };
 	uint32_t bytes_read { 0 };
 	
@@ -73,7 +69,6 @@ private:
 	void replay_config(const ReplayConfigMessage& message);
 	
 	TXProgressMessage txprogress_message { };
-	RequestSignalMessage sig_message { RequestSignalMessage::Signal::FillRequest };
 };
 
 #endif
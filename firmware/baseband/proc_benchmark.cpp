@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "proc_benchmark.hpp"
+
+#include "cycle_counter.hpp"
+#include "dsp_fft.hpp"
+#include "dsp_fir_taps.hpp"
+#include "fxpt_atan2.hpp"
+#include "sine_table.hpp"
+
+#include "event_m4.hpp"
+
+#include "portapack_shared_memory.hpp"
+
+#include <algorithm>
+
+WORKING_AREA(benchmark_thread_wa, 1024);
+
+using FMPrecision = dsp::demodulate::FM::Precision;
+
+// 48kHz to 38.4kHz
+const dsp::resample::PolyphaseResampler<32, 16>::taps_t BenchmarkProcessor::resampler_taps =
+	dsp::resample::design<32, 16>(0.45 * 38400 / 48000);
+
+const std::array<BenchmarkProcessor::Kernel, 26> BenchmarkProcessor::kernels { {
+	{ "c8cic3", 2048, [](BenchmarkProcessor& p) {
+		p.c8_cic3.execute({ p.c8_in.data(), p.c8_in.size() }, { p.c16_out.data(), p.c16_out.size() });
+	} },
+	{ "fs4cic3", 2048, [](BenchmarkProcessor& p) {
+		p.c8_fs4_cic3.execute({ p.c8_in.data(), p.c8_in.size() }, { p.c16_out.data(), p.c16_out.size() });
+	} },
+	{ "ncocic3", 2048, [](BenchmarkProcessor& p) {
+		p.c8_nco_cic3.execute({ p.c8_in.data(), p.c8_in.size() }, { p.c16_out.data(), p.c16_out.size() });
+	} },
+	{ "c8dec4", 2048, [](BenchmarkProcessor& p) {
+		p.fir_c8_decim4.execute({ p.c8_in.data(), p.c8_in.size() }, { p.c16_out.data(), p.c16_out.size() });
+	} },
+	{ "c8dec8", 2048, [](BenchmarkProcessor& p) {
+		p.fir_c8_decim8.execute({ p.c8_in.data(), p.c8_in.size() }, { p.c16_out.data(), p.c16_out.size() });
+	} },
+	{ "dec64", 2048, [](BenchmarkProcessor& p) {
+		dsp::decimate::execute_decim_64(p.fir_c8_decim8, p.fir_c16_decim8,
+			{ p.c8_in.data(), p.c8_in.size() }, { p.c16_out.data(), p.c16_out.size() });
+	} },
+	{ "c8cic64", 2048, [](BenchmarkProcessor& p) {
+		p.c8_cic4_64.execute({ p.c8_in.data(), p.c8_in.size() }, { p.c16_out.data(), p.c16_out.size() });
+	} },
+	{ "c16cic3", 1024, [](BenchmarkProcessor& p) {
+		p.c16_cic3.execute({ p.c16_in.data(), p.c16_in.size() }, { p.c16_out.data(), p.c16_out.size() });
+	} },
+	{ "c16cic16", 1024, [](BenchmarkProcessor& p) {
+		p.c16_cic3_16.execute({ p.c16_in.data(), p.c16_in.size() }, { p.c16_out.data(), p.c16_out.size() });
+	} },
+	{ "c16dec2", 1024, [](BenchmarkProcessor& p) {
+		p.fir_c16_decim2.execute({ p.c16_in.data(), p.c16_in.size() }, { p.c16_out.data(), p.c16_out.size() });
+	} },
+	{ "c16dec8", 1024, [](BenchmarkProcessor& p) {
+		p.fir_c16_decim8.execute({ p.c16_in.data(), p.c16_in.size() }, { p.c16_out.data(), p.c16_out.size() });
+	} },
+	{ "firc", 1024, [](BenchmarkProcessor& p) {
+		p.fir_complex.execute({ p.c16_in.data(), p.c16_in.size() }, { p.c16_out.data(), p.c16_out.size() });
+	} },
+	{ "resamp", 1024, [](BenchmarkProcessor& p) {
+		p.resampler.execute({ p.c16_in.data(), p.c16_in.size() }, { p.c16_out.data(), p.c16_out.size() });
+	} },
+	{ "fir64r", 512, [](BenchmarkProcessor& p) {
+		p.fir64_real.execute({ p.s16_in.data(), p.s16_in.size() }, { p.s16_out.data(), p.s16_out.size() });
+	} },
+	{ "cic4r", 512, [](BenchmarkProcessor& p) {
+		p.cic4_real.execute({ p.s16_in.data(), p.s16_in.size() }, { p.s16_out.data(), p.s16_out.size() });
+	} },
+	{ "mf", 256, [](BenchmarkProcessor& p) {
+		for(size_t i=0; i<256; i++) {
+			const auto s = p.c16_in[i];
+			p.mf.execute_once({ static_cast<float>(s.real()), static_cast<float>(s.imag()) });
+		}
+	} },
+	{ "mf q15", 256, [](BenchmarkProcessor& p) {
+		for(size_t i=0; i<256; i++) {
+			p.mf_q15.execute_once(p.c16_in[i]);
+		}
+	} },
+	{ "clkrec", 256, [](BenchmarkProcessor& p) {
+		p.clock_recovery.execute({ p.f32.data(), p.f32.size() });
+	} },
+	{ "fft256", 256, [](BenchmarkProcessor& p) {
+		fft_swap({ p.c16_in.data(), p.fft.size() }, p.fft);
+		fft_c_preswapped(p.fft, 0, 8);
+	} },
+	{ "atan2", 256, [](BenchmarkProcessor& p) {
+		for(size_t i=0; i<256; i++) {
+			p.s16_out[i] = fxpt_atan2(p.c16_in[i].imag(), p.c16_in[i].real());
+		}
+	} },
+	{ "comp", 256, [](BenchmarkProcessor& p) {
+		p.compressor.execute_in_place({ p.f32.data(), p.f32.size() });
+	} },
+	{ "comp q15", 256, [](BenchmarkProcessor& p) {
+		p.compressor_q15.execute_in_place({ p.s16_out.data(), 256 });
+	} },
+	{ "fm s16f", 256, [](BenchmarkProcessor& p) {
+		p.fm_fast.execute({ p.c16_in.data(), 256 }, { p.s16_out.data(), 256 });
+	} },
+	{ "fm s16p", 256, [](BenchmarkProcessor& p) {
+		p.fm_precise.execute({ p.c16_in.data(), 256 }, { p.s16_out.data(), 256 });
+	} },
+	{ "fm f32f", 256, [](BenchmarkProcessor& p) {
+		p.fm_fast.execute({ p.c16_in.data(), 256 }, { p.f32.data(), 256 });
+	} },
+	{ "fm f32p", 256, [](BenchmarkProcessor& p) {
+		p.fm_precise.execute({ p.c16_in.data(), 256 }, { p.f32.data(), 256 });
+	} },
+} };
+
+BenchmarkProcessor::BenchmarkProcessor() {
+	// Offset tone with a little noise for the complex8 front end.
+	uint32_t phase = 0;
+	uint32_t noise = 1;
+	for(auto& s : c8_in) {
+		noise = noise * 1664525 + 1013904223;
+		const int8_t n = static_cast<int8_t>(noise >> 24) >> 4;
+		s = {
+			static_cast<int8_t>(sine_table_f32[(phase + 0x40000000) >> 24] * 100.0f + n),
+			static_cast<int8_t>(sine_table_f32[phase >> 24] * 100.0f + n)
+		};
+		phase += 0x01234567;
+	}
+
+	// Per-sample phase step rising from 0 to pi, so every octant is covered.
+	phase = 0;
+	for(size_t i=0; i<c16_in.size(); i++) {
+		c16_in[i] = {
+			static_cast<int16_t>(sine_table_f32[(phase + 0x40000000) >> 24] * 32767.0f),
+			static_cast<int16_t>(sine_table_f32[phase >> 24] * 32767.0f)
+		};
+		phase += i * (0x80000000U / c16_in.size());
+	}
+
+	for(size_t i=0; i<s16_in.size(); i++) {
+		s16_in[i] = c16_in[i].real();
+	}
+
+	// 9600 baud NRZ at 38.4kHz for the clock recovery, low enough for the
+	// compressor to leave alone.
+	for(size_t i=0; i<f32.size(); i++) {
+		f32[i] = ((c8_in[i / 4].real() >= 0) ? 0.01f : -0.01f);
+	}
+
+	c8_nco_cic3.configure(250000, 3072000);
+	fir_c8_decim4.configure(taps_11k0_decim_0.taps, 33554432);
+	fir_c8_decim8.configure(taps_11k0_decim_0.taps, 33554432);
+	fir_c16_decim2.configure(taps_200k_decim_1.taps, 131072);
+	fir_c16_decim8.configure(taps_11k0_decim_1.taps, 131072);
+	fir_complex.configure(taps_11k0_channel.taps, 2);
+	fir64_real.configure(taps_64_lp_025_025.taps);
+	resampler.configure(48000, 38400);
+
+	compressor_q15.configure({ -30.0f, 10.0f, 27.0f, -1.0f, 0.300f }, 12000);
+
+	fm_fast.configure(2, 1, FMPrecision::Fast);
+	fm_precise.configure(2, 1, FMPrecision::Precise);
+
+	CycleCounter::enable();
+
+	thread = chThdCreateStatic(benchmark_thread_wa, sizeof(benchmark_thread_wa),
+		NORMALPRIO - 10, ThreadBase::fn,
+		this
+	);
+}
+
+BenchmarkProcessor::~BenchmarkProcessor() {
+	chThdTerminate(thread);
+	chThdWait(thread);
+	thread = nullptr;
+}
+
+void BenchmarkProcessor::run() {
+	chRegSetThreadName("bench");
+
+	size_t index = 0;
+	while( !chThdShouldTerminate() ) {
+		measure(index);
+		index = (index + 1) % kernels.size();
+		chThdSleepMilliseconds(20);
+	}
+}
+
+void BenchmarkProcessor::measure(const size_t index) {
+	const auto& kernel = kernels[index];
+
+	uint32_t cycles_min = UINT32_MAX;
+	uint64_t cycles_total = 0;
+	for(size_t n=0; n<runs_per_report; n++) {
+		const auto t_start = CycleCounter::now();
+		kernel.run(*this);
+		const uint32_t cycles = CycleCounter::now() - t_start;
+		cycles_min = std::min(cycles_min, cycles);
+		cycles_total += cycles;
+	}
+
+	const BenchmarkResultMessage message {
+		index, kernels.size(), kernel.name, kernel.samples,
+		cycles_min, static_cast<uint32_t>(cycles_total / runs_per_report)
+	};
+	shared_memory.application_queue.push(message);
+}
+
+int main() {
+	EventDispatcher event_dispatcher { std::make_unique<BenchmarkProcessor>() };
+	event_dispatcher.run();
+	return 0;
+}
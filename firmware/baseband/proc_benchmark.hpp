@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PROC_BENCHMARK_H__
+#define __PROC_BENCHMARK_H__
+
+#include "baseband_processor.hpp"
+#include "thread_base.hpp"
+
+#include "dsp_decimate.hpp"
+#include "dsp_demodulate.hpp"
+#include "dsp_resample.hpp"
+#include "matched_filter.hpp"
+#include "clock_recovery.hpp"
+#include "audio_compressor.hpp"
+#include "ais_baseband.hpp"
+
+#include "ch.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <complex>
+
+/* Times the DSP kernels on synthetic buffers, with the radio idle. A low
+ * priority thread runs each kernel runs_per_report times back to back and
+ * reports the best and mean DWT cycle counts in a BenchmarkResultMessage,
+ * then moves on to the next one. Nothing else runs on the M4 meanwhile, so
+ * the best run is the kernel's own cost.
+ */
+class BenchmarkProcessor : public BasebandProcessor, public ThreadBase {
+public:
+	BenchmarkProcessor();
+	~BenchmarkProcessor();
+
+	BenchmarkProcessor(const BenchmarkProcessor&) = delete;
+	BenchmarkProcessor& operator=(const BenchmarkProcessor&) = delete;
+
+	void execute(const buffer_c8_t&) override { };
+
+private:
+	struct Kernel {
+		const char* const name;
+		const uint32_t samples;
+		void (* const run)(BenchmarkProcessor&);
+	};
+
+	static const std::array<Kernel, 26> kernels;
+
+	static constexpr size_t runs_per_report = 16;
+
+	Thread* thread { nullptr };
+
+	std::array<complex8_t, 2048> c8_in { };
+	std::array<complex16_t, 1024> c16_in { };
+	std::array<complex16_t, 1024> c16_out { };
+	std::array<int16_t, 512> s16_in { };
+	std::array<int16_t, 512> s16_out { };
+	std::array<float, 256> f32 { };
+	std::array<std::complex<float>, 256> fft { };
+
+	dsp::decimate::Complex8DecimateBy2CIC3 c8_cic3 { };
+	dsp::decimate::TranslateByFSOver4AndDecimateBy2CIC3 c8_fs4_cic3 { };
+	dsp::decimate::NCOTranslateAndDecimateBy2CIC3 c8_nco_cic3 { };
+	dsp::decimate::DecimateBy2CIC3 c16_cic3 { };
+	dsp::decimate::FIR64AndDecimateBy2Real fir64_real { };
+	dsp::decimate::FIRC8xR16x24FS4Decim4 fir_c8_decim4 { };
+	dsp::decimate::FIRC8xR16x24FS4Decim8 fir_c8_decim8 { };
+	dsp::decimate::FIRC16xR16x16Decim2 fir_c16_decim2 { };
+	dsp::decimate::FIRC16xR16x32Decim8 fir_c16_decim8 { };
+	dsp::decimate::FIRAndDecimateComplex fir_complex { };
+	dsp::decimate::DecimateBy2CIC4Real cic4_real { };
+	dsp::decimate::CIC<4, 64> c8_cic4_64 { };
+	dsp::decimate::CIC<3, 16> c16_cic3_16 { };
+
+	static const dsp::resample::PolyphaseResampler<32, 16>::taps_t resampler_taps;
+	dsp::resample::PolyphaseResampler<32, 16> resampler { resampler_taps };
+
+	dsp::matched_filter::MatchedFilter mf { baseband::ais::square_taps_38k4_1t_p, 2 };
+	dsp::matched_filter::MatchedFilterQ15<baseband::ais::square_taps_38k4_1t_p.size()> mf_q15 { baseband::ais::square_taps_38k4_1t_p, 2 };
+
+	size_t symbols { 0 };
+	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery {
+		38400, 9600, { 0.0555f },
+		[this](const float) { this->symbols++; }
+	};
+
+	dsp::demodulate::FM fm_fast { };
+	dsp::demodulate::FM fm_precise { };
+
+	FeedForwardCompressor compressor { };
+	CompressorQ15 compressor_q15 { };
+
+	void run() override;
+	void measure(const size_t index);
+};
+
+#endif/*__PROC_BENCHMARK_H__*/
@@ -25,9 +25,14 @@
 #include "dsp_fir_taps.hpp"
 
 #include "event_m4.hpp"
+#include "portapack_shared_memory.hpp"
 
 #include "utility.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 CaptureProcessor::CaptureProcessor() {
 	decim_0.configure(taps_200k_decim_0.taps, 33554432);
 	decim_1.configure(taps_200k_decim_1.taps, 131072);
@@ -37,18 +42,29 @@ CaptureProcessor::CaptureProcessor() {
 
 void CaptureProcessor::execute(const buffer_c8_t& buffer) {
 	/* 2.4576MHz, 2048 samples */
+	if( stream && (stream_decimation == 1) ) {
+		stream_write(buffer);
+	}
+
 	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-	const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
-	const auto& decimator_out = decim_1_out;
-	const auto& channel = decimator_out;
+	if( stream && (stream_decimation == 4) ) {
+		stream_write(decim_0_out);
+	}
 
-	if( stream ) {
-		const size_t bytes_to_write = sizeof(*decimator_out.p) * decimator_out.count;
-		const auto result = stream->write(decimator_out.p, bytes_to_write);
+	const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
+	if( stream && (stream_decimation == 8) ) {
+		stream_write(decim_1_out);
 	}
 
+	// The display follows the full decimation whatever is being recorded.
+	const auto& channel = decim_1_out;
+
 	feed_channel_stats(channel);
 
+	if( stream && pre_trigger ) {
+		trigger_update(channel);
+	}
+
 	spectrum_samples += channel.count;
 	if( spectrum_samples >= spectrum_interval_samples ) {
 		spectrum_samples -= spectrum_interval_samples;
@@ -56,6 +72,100 @@ void CaptureProcessor::execute(const buffer_c8_t& buffer) {
 	}
 }
 
+void CaptureProcessor::stream_write(const buffer_c8_t& buffer) {
+	if( stream_format == CaptureConfig::Format::C8 ) {
+		stream_put(buffer.p, buffer.count * sizeof(*buffer.p));
+		return;
+	}
+
+	// Widen through dst_buffer, which the decimators haven't used yet.
+	// (When compressing, the encoder drops the eight zero bits again.)
+	for(size_t offset=0; offset<buffer.count; offset+=dst_buffer.count) {
+		const size_t count = std::min(buffer.count - offset, dst_buffer.count);
+		for(size_t i=0; i<count; i++) {
+			const auto s = buffer.p[offset + i];
+			dst_buffer.p[i] = { static_cast<int16_t>(s.real() * 256), static_cast<int16_t>(s.imag() * 256) };
+		}
+		stream_write(buffer_c16_t { dst_buffer.p, count, buffer.sampling_rate });
+	}
+}
+
+void CaptureProcessor::stream_write(const buffer_c16_t& buffer) {
+	if( stream_format == CaptureConfig::Format::C16 ) {
+		stream_put(buffer.p, buffer.count * sizeof(*buffer.p));
+		return;
+	}
+
+	if( stream_format == CaptureConfig::Format::C16Rice ) {
+		for(size_t offset=0; offset<buffer.count; offset+=iq_codec::block_samples_max) {
+			const size_t count = std::min(buffer.count - offset, iq_codec::block_samples_max);
+			const size_t bytes = iq_codec::encode(&buffer.p[offset], count, stream_block.data());
+			stream_put(stream_block.data(), bytes);
+		}
+		return;
+	}
+
+	// Round to the top byte, as the ADC delivered it before filtering.
+	const size_t count = std::min(buffer.count, stream_c8.size());
+	for(size_t i=0; i<count; i++) {
+		const auto s = buffer.p[i];
+		stream_c8[i] = {
+			static_cast<int8_t>(__SSAT((s.real() + 128) >> 8, 8)),
+			static_cast<int8_t>(__SSAT((s.imag() + 128) >> 8, 8))
+		};
+	}
+	stream_put(stream_c8.data(), count * sizeof(stream_c8[0]));
+}
+
+void CaptureProcessor::stream_put(const void* const data, const size_t bytes) {
+	if( !pre_trigger ) {
+		stream_bytes += stream->write(data, bytes);
+		return;
+	}
+
+	// Burst mode: everything goes through the ring, trigger_update() then
+	// decides whether this block's output is streamed or held back.
+	auto p = static_cast<const uint8_t*>(data);
+	size_t remaining = bytes;
+	while( remaining ) {
+		const size_t n = std::min(remaining, pre_trigger_size - ring_in);
+		memcpy(&pre_trigger[ring_in], p, n);
+		ring_in = (ring_in + n == pre_trigger_size) ? 0 : (ring_in + n);
+		p += n;
+		remaining -= n;
+	}
+	ring_pending = std::min(ring_pending + bytes, pre_trigger_size);
+}
+
+void CaptureProcessor::trigger_update(const buffer_c16_t& channel) {
+	if( ChannelStatsCollector::peak_squared(channel, 0) >= trigger_squared ) {
+		post_trigger_remaining = post_trigger_samples;
+		if( !burst_active ) {
+			burst_active = true;
+			burst_offset = stream_bytes;
+		}
+	} else {
+		post_trigger_remaining -= std::min(post_trigger_remaining, channel.count);
+	}
+
+	if( burst_active ) {
+		// Oldest first: the pre-trigger history, then this block.
+		const size_t start = (ring_in + pre_trigger_size - ring_pending) % pre_trigger_size;
+		const size_t first = std::min(ring_pending, pre_trigger_size - start);
+		stream_bytes += stream->write(&pre_trigger[start], first);
+		stream_bytes += stream->write(&pre_trigger[0], ring_pending - first);
+		ring_pending = 0;
+
+		if( post_trigger_remaining == 0 ) {
+			burst_active = false;
+			const CaptureBurstMessage message { burst_offset, stream_bytes - burst_offset };
+			shared_memory.application_queue.push(message);
+		}
+	} else {
+		ring_pending = std::min(ring_pending, pre_trigger_keep);
+	}
+}
+
 void CaptureProcessor::on_message(const Message* const message) {
 	switch(message->id) {
 	case Message::ID::UpdateSpectrum:
@@ -94,12 +204,44 @@ void CaptureProcessor::samplerate_config(const SamplerateConfigMessage& message)
 
 void CaptureProcessor::capture_config(const CaptureConfigMessage& message) {
 	if( message.config ) {
+		const auto decimation = message.config->decimation;
+		stream_decimation = ((decimation == 1) || (decimation == 4)) ? decimation : 8;
+		stream_format = message.config->format;
+		trigger_config(message.config->trigger);
 		stream = std::make_unique<StreamInput>(message.config);
 	} else {
 		stream.reset();
+		pre_trigger.reset();
 	}
 }
 
+void CaptureProcessor::trigger_config(const CaptureConfig::Trigger& trigger) {
+	stream_bytes = 0;
+	ring_in = 0;
+	ring_pending = 0;
+	burst_active = false;
+	post_trigger_remaining = 0;
+	if( trigger.level_db == 0 ) {
+		pre_trigger.reset();
+		return;
+	}
+
+	// One baseband buffer's output, 2048 samples before decimation, has to
+	// fit behind what's kept. Rice blocks can come out a little larger
+	// than C16.
+	const size_t sample_bytes = (stream_format == CaptureConfig::Format::C8) ? sizeof(complex8_t) : sizeof(complex16_t);
+	const size_t block_bytes = 2048 / stream_decimation * sample_bytes + sizeof(iq_codec::Header) * 8;
+	const uint64_t pre_bytes = static_cast<uint64_t>(baseband_fs / stream_decimation) * sample_bytes * trigger.pre_ms / 1000;
+	pre_trigger_size = pre_trigger_bytes_max;
+	pre_trigger_keep = std::min<uint64_t>(pre_bytes, pre_trigger_size - block_bytes) & ~3U;
+	pre_trigger = std::make_unique<uint8_t[]>(pre_trigger_size);
+
+	const size_t channel_fs = baseband_fs / decim_0.decimation_factor / decim_1.decimation_factor;
+	post_trigger_samples = static_cast<uint64_t>(channel_fs) * trigger.post_ms / 1000;
+	const float level = std::pow(10.0f, trigger.level_db / 10.0f) * (32768.0f * 32768.0f);
+	trigger_squared = (level >= 4294967295.0f) ? 0xffffffffU : static_cast<uint32_t>(level);
+}
+
 int main() {
 	EventDispatcher event_dispatcher { std::make_unique<CaptureProcessor>() };
 	event_dispatcher.run();
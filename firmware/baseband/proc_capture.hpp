@@ -32,6 +32,7 @@
 #include "spectrum_collector.hpp"
 
 #include "stream_input.hpp"
+#include "iq_codec.hpp"
 
 #include <array>
 #include <memory>
@@ -64,11 +65,38 @@ private:
 	uint32_t channel_filter_stop_f = 0;
 
 	std::unique_ptr<StreamInput> stream { };
+	size_t stream_decimation { 8 };
+	CaptureConfig::Format stream_format { CaptureConfig::Format::C16 };
+	std::array<complex8_t, 512> stream_c8 { };
+	std::array<uint32_t, iq_codec::block_bytes_max / sizeof(uint32_t)> stream_block { };
+
+	/* Burst mode, see CaptureConfig::Trigger: stream output waits in the
+	 * pre_trigger ring until a block triggers. stream_bytes counts what
+	 * StreamInput accepted, i.e. file offsets.
+	 */
+	static constexpr size_t pre_trigger_bytes_max = 16384;
+	std::unique_ptr<uint8_t[]> pre_trigger { };
+	size_t pre_trigger_size { 0 };
+	size_t pre_trigger_keep { 0 };
+	size_t ring_in { 0 };
+	size_t ring_pending { 0 };
+	uint32_t trigger_squared { 0 };
+	size_t post_trigger_samples { 0 };
+	size_t post_trigger_remaining { 0 };
+	bool burst_active { false };
+	uint64_t stream_bytes { 0 };
+	uint64_t burst_offset { 0 };
 
 	SpectrumCollector channel_spectrum { };
 	size_t spectrum_interval_samples = 0;
 	size_t spectrum_samples = 0;
 
+	void stream_put(const void* const data, const size_t bytes);
+	void trigger_update(const buffer_c16_t& channel);
+	void trigger_config(const CaptureConfig::Trigger& trigger);
+	void stream_write(const buffer_c8_t& buffer);
+	void stream_write(const buffer_c16_t& buffer);
+
 	void samplerate_config(const SamplerateConfigMessage& message);
 	void capture_config(const CaptureConfigMessage& message);
 };
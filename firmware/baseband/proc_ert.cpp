@@ -23,6 +23,8 @@
 
 #include "portapack_shared_memory.hpp"
 
+#include "dsp_fir_taps.hpp"
+
 #include "event_m4.hpp"
 
 float ERTProcessor::abs(const complex8_t& v) {
@@ -40,9 +42,30 @@ float ERTProcessor::abs(const complex8_t& v) {
 	return std::sqrt(r2_i2);
 }
 
+ERTProcessor::ERTProcessor() {
+	channelizer.configure(
+		taps_ert_decim_0.taps, 33554432,
+		taps_ert_decim_1.taps, 131072,
+		{ { -150000, -50000, 50000, 150000 } },
+		baseband_sampling_rate
+	);
+}
+
 void ERTProcessor::execute(const buffer_c8_t& buffer) {
 	/* 4.194304MHz, 2048 samples */
 
+	if( channelized ) {
+		channelizer.execute(buffer,
+			[this](const size_t index, const buffer_c16_t& channel) {
+				this->execute_channel(this->channels[index], channel);
+			}
+		);
+	} else {
+		execute_wideband(buffer);
+	}
+}
+
+void ERTProcessor::execute_wideband(const buffer_c8_t& buffer) {
 	const complex8_t* src = &buffer.p[0];
 	const complex8_t* const src_end = &buffer.p[buffer.count];
 
@@ -57,51 +80,78 @@ void ERTProcessor::execute(const buffer_c8_t& buffer) {
 		average_count = 0;
 	}
 
-	const float gain = 128 * samples_per_symbol;
-	const float k = 1.0f / gain;
-
 	while(src < src_end) {
 		float sum = 0.0f;
 		for(size_t i=0; i<(samples_per_symbol / 2); i++) {
 			sum += abs(*(src++));
 		}
-		sum_half_period[1] = sum_half_period[0];
-		sum_half_period[0] = sum;
-
-		sum_period[2] = sum_period[1];
-		sum_period[1] = sum_period[0];
-		sum_period[0] = (sum_half_period[0] + sum_half_period[1]) * k;
+		wideband.execute(sum);
+	}
+}
 
-		manchester[2] = manchester[1];
-		manchester[1] = manchester[0];
-		manchester[0] = sum_period[2] - sum_period[0];
+void ERTProcessor::execute_channel(ERTDemodulator& demodulator, const buffer_c16_t& channel) {
+	/* 262.144kHz, 128 samples, 8 per symbol */
+	constexpr size_t half_period = channel_sampling_rate / ERTDemodulator::symbol_rate / 2;
 
-		const auto data = manchester[0] - manchester[2];
+	for(size_t n=0; n<channel.count; n+=half_period) {
+		float sum = 0.0f;
+		for(size_t i=0; i<half_period; i++) {
+			const float r = channel.p[n + i].real();
+			const float q = channel.p[n + i].imag();
+			sum += std::sqrt(r * r + q * q);
+		}
+		demodulator.execute(sum);
+	}
+}
 
-		clock_recovery(data);
+void ERTProcessor::on_message(const Message* const message) {
+	if( message->id == Message::ID::ERTConfigure ) {
+		channelized = reinterpret_cast<const ERTConfigureMessage*>(message)->channelized;
 	}
 }
 
-void ERTProcessor::consume_symbol(
+void ERTDemodulator::execute(const float half_period_sum) {
+	sum_half_period[1] = sum_half_period[0];
+	sum_half_period[0] = half_period_sum;
+
+	sum_period[2] = sum_period[1];
+	sum_period[1] = sum_period[0];
+	sum_period[0] = (sum_half_period[0] + sum_half_period[1]) * k;
+
+	manchester[2] = manchester[1];
+	manchester[1] = manchester[0];
+	manchester[0] = sum_period[2] - sum_period[0];
+
+	const auto data = manchester[0] - manchester[2];
+
+	clock_recovery(data);
+}
+
+void ERTDemodulator::consume_symbol(
 	const float raw_symbol
 ) {
 	const uint_fast8_t sliced_symbol = (raw_symbol >= 0.0f) ? 1 : 0;
-	scm_builder.execute(sliced_symbol);
-	idm_builder.execute(sliced_symbol);
+	if( symbols.add(sliced_symbol) ) {
+		scm_builder.execute(symbols.word(), symbols.count());
+		idm_builder.execute(symbols.word(), symbols.count());
+		symbols.clear();
+	}
 }
 
-void ERTProcessor::scm_handler(
+void ERTDemodulator::scm_handler(
 	const baseband::Packet& packet
 ) {
 	const ERTPacketMessage message { ert::Packet::Type::SCM, packet };
 	shared_memory.application_queue.push(message);
+	BasebandProcessor::count_decode();
 }
 
-void ERTProcessor::idm_handler(
+void ERTDemodulator::idm_handler(
 	const baseband::Packet& packet
 ) {
 	const ERTPacketMessage message { ert::Packet::Type::IDM, packet };
 	shared_memory.application_queue.push(message);
+	BasebandProcessor::count_decode();
 }
 
 int main() {
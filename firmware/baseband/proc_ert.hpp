@@ -27,6 +27,7 @@
 #include "rssi_thread.hpp"
 
 #include "channel_decimator.hpp"
+#include "channelizer.hpp"
 
 #include "clock_recovery.hpp"
 #include "symbol_coding.hpp"
@@ -38,6 +39,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <bitset>
+#include <array>
 
 // ''.join(['%d%d' % (c, 1-c) for c in map(int, bin(0x1f2a60)[2:].zfill(21))])
 constexpr uint64_t scm_preamble_and_sync_manchester { 0b101010101001011001100110010110100101010101 };
@@ -50,26 +52,35 @@ constexpr size_t idm_preamble_and_sync_length { 64 - 16 };
 
 constexpr size_t idm_payload_length_max { 1408 };
 
-class ERTProcessor : public BasebandProcessor {
+/* Manchester slicer, clock recovery and SCM/IDM framing for one envelope
+ * stream, fed one envelope sum per half symbol (65536 per second).
+ */
+class ERTDemodulator {
 public:
-	void execute(const buffer_c8_t& buffer) override;
+	static constexpr float symbol_rate = 32768;
+
+	/* Envelope sums are scaled by 1 / gain, their full scale. */
+	ERTDemodulator(const float gain) : k { 1.0f / gain } { }
+
+	void execute(const float half_period_sum);
 
 private:
-	const uint32_t baseband_sampling_rate = 4194304;
-	const size_t decimation = 1;
-	const float symbol_rate = 32768;
+	const float k;
 
-	const uint32_t channel_sampling_rate = baseband_sampling_rate / decimation;
-	const size_t samples_per_symbol = channel_sampling_rate / symbol_rate;
-	const float clock_recovery_rate = symbol_rate * 2;
+	float sum_half_period[2] { };
+	float sum_period[3] { };
+	float manchester[3] { };
 
-	BasebandThread baseband_thread { baseband_sampling_rate, this, NORMALPRIO + 20, baseband::Direction::Receive };
-	RSSIThread rssi_thread { NORMALPRIO + 10 };
+	void consume_symbol(const float symbol);
 
-	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery {
-		clock_recovery_rate, symbol_rate, { 1.0f / 18.0f },
-		[this](const float symbol) { this->consume_symbol(symbol); }
-	};
+	clock_recovery::FixedRateClockRecovery<
+		static_cast<uint32_t>(symbol_rate) * 2, static_cast<uint32_t>(symbol_rate),
+		clock_recovery::FixedErrorFilter,
+		clock_recovery::MemberSymbolHandler<ERTDemodulator, &ERTDemodulator::consume_symbol>
+	> clock_recovery { { 1.0f / 18.0f }, this };
+
+	// Both builders see the same symbols, a word at a time.
+	SymbolWord symbols { };
 
 	PacketBuilder<BitPattern, NeverMatch, FixedLength> scm_builder {
 		{ scm_preamble_and_sync_manchester, scm_preamble_and_sync_length, 1 },
@@ -89,13 +100,44 @@ private:
 		}
 	};
 
-	void consume_symbol(const float symbol);
 	void scm_handler(const baseband::Packet& packet);
 	void idm_handler(const baseband::Packet& packet);
+};
+
+/* Either one envelope over the whole capture, or (channelized) four 100kHz
+ * slices around the FS/4 shifted center, each with its own demodulator, so
+ * meters hopping onto nearby channels at the same time are all heard, with
+ * far less noise per decoder.
+ */
+class ERTProcessor : public BasebandProcessor {
+public:
+	ERTProcessor();
+
+	void execute(const buffer_c8_t& buffer) override;
+
+	void on_message(const Message* const message) override;
+
+private:
+	const uint32_t baseband_sampling_rate = 4194304;
+	const size_t samples_per_symbol = baseband_sampling_rate / ERTDemodulator::symbol_rate;
 
-	float sum_half_period[2];
-	float sum_period[3];
-	float manchester[3];
+	static constexpr size_t channels_count = 4;
+	static constexpr uint32_t channel_sampling_rate = 262144;
+
+	BasebandThread baseband_thread { baseband_sampling_rate, this, NORMALPRIO + 20, baseband::Direction::Receive };
+	RSSIThread rssi_thread { NORMALPRIO + 10 };
+
+	bool channelized { false };
+
+	ERTDemodulator wideband { 128.0f * samples_per_symbol };
+
+	Channelizer<channels_count, dsp::decimate::FIRC16xR16x16Decim2> channelizer { };
+	std::array<ERTDemodulator, channels_count> channels { {
+		{ 32768.0f * (channel_sampling_rate / ERTDemodulator::symbol_rate) },
+		{ 32768.0f * (channel_sampling_rate / ERTDemodulator::symbol_rate) },
+		{ 32768.0f * (channel_sampling_rate / ERTDemodulator::symbol_rate) },
+		{ 32768.0f * (channel_sampling_rate / ERTDemodulator::symbol_rate) },
+	} };
 
 	const size_t average_window { 2048 };
 	int32_t average_i { 0 };
@@ -105,6 +147,9 @@ private:
 	float offset_q { 0.0f };
 
 	float abs(const complex8_t& v);
+
+	void execute_wideband(const buffer_c8_t& buffer);
+	void execute_channel(ERTDemodulator& demodulator, const buffer_c16_t& channel);
 };
 
 #endif/*__PROC_ERT_H__*/
@@ -22,14 +22,12 @@
 
 #include "proc_fsk.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
+#include "sine_table_c8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
 
 void FSKProcessor::execute(const buffer_c8_t& buffer) {
-	int8_t re, im;
-	
 	// This is called at 2.28M/2048 = 1113Hz
 	
 	if (!configured) return;
@@ -37,15 +35,17 @@ void FSKProcessor::execute(const buffer_c8_t& buffer) {
 	for (size_t i = 0; i < buffer.count; i++) {
 
 		if (sample_count >= samples_per_bit) {
-			if (bit_pos > length) {
+			if (streamed ? !next_stream_bit() : (bit_pos > length)) {
 				// End of data
 				cur_bit = 0;
 				txprogress_message.done = true;
 				shared_memory.application_queue.push(txprogress_message);
 				configured = false;
 			} else {
-				cur_bit = (shared_memory.bb_data.data[bit_pos >> 3] << (bit_pos & 7)) & 0x80;
+				if (!streamed)
+					cur_bit = (shared_memory.bb_data.data[bit_pos >> 3] << (bit_pos & 7)) & 0x80;
 				bit_pos++;
+				phase_inc = cur_bit ? shift_one : shift_zero;
 				if (progress_count >= progress_notice) {
 					progress_count = 0;
 					txprogress_message.progress++;
@@ -61,30 +61,46 @@ void FSKProcessor::execute(const buffer_c8_t& buffer) {
 		}
 		
 		if (configured) {
-			if (cur_bit)
-				phase += shift_one;
-			else
-				phase += shift_zero;
-			
-			sphase = phase + (64 << 24);
-
-			re = (sine_table_i8[(sphase & 0xFF000000) >> 24]);
-			im = (sine_table_i8[(phase & 0xFF000000) >> 24]);
+			phase += phase_inc;
+			buffer.p[i] = carrier[phase];
 		} else {
-			re = 0;
-			im = 0;
+			buffer.p[i] = { 0, 0 };
 		}
-	
-		buffer.p[i] = {re, im};
 	}
 }
 
+bool FSKProcessor::next_stream_bit() {
+	// Space tone until the application has prefilled, and through underruns.
+	cur_bit = 0;
+	if (!stream || !stream_ready)
+		return true;
+	
+	return stream->read_bit(cur_bit) || !stream->is_done();
+}
+
 void FSKProcessor::on_message(const Message* const p) {
+	if (p->id == Message::ID::ReplayConfig) {
+		const auto message = *reinterpret_cast<const ReplayConfigMessage*>(p);
+		stream_ready = false;
+		if (message.config)
+			stream = std::make_unique<BitStream>(message.config);
+		else
+			stream.reset();
+		return;
+	}
+	
+	// App has prefilled the buffers
+	if (p->id == Message::ID::FIFOData) {
+		stream_ready = true;
+		return;
+	}
+	
 	const auto message = *reinterpret_cast<const FSKConfigureMessage*>(p);
 	
 	if (message.id == Message::ID::FSKConfigure) {
 		samples_per_bit = message.samples_per_bit;
 		length = message.stream_length + 4;			// Why 4 ?!
+		streamed = !message.stream_length;
 		
 		shift_zero = message.shift * (0xFFFFFFFFULL / 2280000);
 		shift_one = -shift_zero;
@@ -95,6 +111,7 @@ void FSKProcessor::on_message(const Message* const p) {
 		progress_count = 0;
 		bit_pos = 0;
 		cur_bit = 0;
+		phase_inc = shift_zero;
 		
 		txprogress_message.progress = 0;
 		txprogress_message.done = false;
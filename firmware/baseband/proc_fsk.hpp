@@ -25,6 +25,10 @@
 
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
+#include "stream_bits.hpp"
+#include "sine_table_c8.hpp"
+
+#include <memory>
 
 class FSKProcessor : public BasebandProcessor {
 public:
@@ -45,9 +49,18 @@ private:
     uint32_t progress_notice { }, progress_count { 0 };
     uint8_t cur_bit { 0 };
     uint32_t sample_count { 0 };
-	uint32_t phase { 0 }, sphase { 0 };
+	uint32_t phase { 0 }, phase_inc { 0 };
+	
+	const ComplexSineTableI8 carrier { };
 	
 	TXProgressMessage txprogress_message { };
+	
+	// A zero stream_length takes the bits from here instead of bb_data
+	bool streamed { false };
+	std::unique_ptr<BitStream> stream { };
+	bool stream_ready { false };
+	
+	bool next_stream_bit();
 };
 
 #endif
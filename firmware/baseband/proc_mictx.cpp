@@ -22,71 +22,120 @@
 
 #include "proc_mictx.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
+#include "dsp_iir_config.hpp"
 #include "tonesets.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+constexpr CompressorQ15::Config MicTXProcessor::compressor_config;
+
+MicTXProcessor::MicTXProcessor() {
+	preemph.configure(audio_24k_preemph_300_3000_config);
+	compressor.configure(compressor_config, audio_fs);
+	lpf.configure(audio_24k_lpf_3000hz_config);
+	fm.configure(interpolation);
+	am.configure(interpolation);
+	dsb.configure(interpolation);
+	usb.configure(interpolation);
+	lsb.configure(interpolation);
+}
 
 void MicTXProcessor::execute(const buffer_c8_t& buffer){
 
-	// This is called at 1536000/2048 = 750Hz
+	// This is called at 1536000/2048 = 750Hz, with 32 audio samples
 	
 	if (!configured) return;
 	
 	audio_input.read_audio_buffer(audio_buffer);
+	
+	if (!play_beep)
+		process_voice();
+	else
+		process_beep();
+	
+	for (size_t i = 0; i < audio_buffer.count; i++)
+		audio_buffer.p[i] = __SSAT(tone_gen.process_q15(audio_buffer.p[i]), 16);
+	
+	if (configured)
+		modulate(buffer);
+	else
+		std::fill(buffer.p, buffer.p + buffer.count, complex8_t { 0, 0 });
+}
 
-	for (size_t i = 0; i < buffer.count; i++) {
-		
-		if (!play_beep) {
-			sample = audio_buffer.p[i >> 6] >> 8;			// 1536000 / 64 = 24000
-			sample *= audio_gain;
-			
-			power_acc += (sample < 0) ? -sample : sample;	// Power average for UI vu-meter
-			
-			if (power_acc_count) {
-				power_acc_count--;
-			} else {
-				power_acc_count = divider;
-				level_message.value = power_acc / (divider / 4);	// Why ?
-				shared_memory.application_queue.push(level_message);
-				power_acc = 0;
-			}
+void MicTXProcessor::modulate(const buffer_c8_t& buffer) {
+	const buffer_s16_t audio {
+		audio_buffer.p,
+		std::min(audio_buffer.count, buffer.count / interpolation),
+		audio_fs
+	};
+	
+	switch (modulation) {
+		case Modulation::AM:	am.execute(audio, buffer);	break;
+		case Modulation::DSB:	dsb.execute(audio, buffer);	break;
+		case Modulation::USB:	usb.execute(audio, buffer);	break;
+		case Modulation::LSB:	lsb.execute(audio, buffer);	break;
+		default:
+		case Modulation::FM:	fm.execute(audio, buffer);	break;
+	}
+}
+
+void MicTXProcessor::process_voice() {
+	// Half scale at x1.0, as the old 8 bit path had
+	for (size_t i = 0; i < audio_buffer.count; i++)
+		audio_buffer.p[i] = __SSAT((audio_buffer.p[i] * audio_gain_q7) >> 8, 16);
+	
+	preemph.execute_in_place(audio_buffer);
+	
+	// Before the low-pass, so it takes off what the limiter's clip adds
+	compressor.execute_in_place(audio_buffer);
+	
+	lpf.execute_in_place(audio_buffer);
+	
+	update_level();
+}
+
+void MicTXProcessor::process_beep() {
+	for (size_t i = 0; i < audio_buffer.count; i++) {
+		if (beep_timer) {
+			beep_timer--;
 		} else {
-			if (beep_timer) {
-				beep_timer--;
+			beep_timer = audio_fs * 0.05;			// 50ms
+			
+			if (beep_index == BEEP_TONES_NB) {
+				configured = false;
+				shared_memory.application_queue.push(txprogress_message);
 			} else {
-				beep_timer = baseband_fs * 0.05;			// 50ms
-				
-				if (beep_index == BEEP_TONES_NB) {
-					configured = false;
-					shared_memory.application_queue.push(txprogress_message);
-				} else {
-					beep_gen.configure(beep_deltas[beep_index], 1.0);
-					beep_index++;
-				}
+				beep_gen.configure(beep_deltas[beep_index] * interpolation, 1.0);
+				beep_index++;
 			}
-			
-			sample = beep_gen.process(0);
 		}
 		
-		sample = tone_gen.process(sample);
-		
-		// FM
-		if (configured) {
-			delta = sample * fm_delta;
-			
-			phase += delta;
-			sphase = phase >> 24;
+		audio_buffer.p[i] = beep_gen.process_q15(0);
+	}
+}
 
-			re = (sine_table_i8[(sphase + 64) & 255]);
-			im = (sine_table_i8[sphase]);
-		} else {
-			re = 0;
-			im = 0;
-		}
+void MicTXProcessor::update_level() {
+	// RMS and peak for the UI vu-meter, at the rate asked for
+	for (size_t i = 0; i < audio_buffer.count; i++) {
+		const int32_t v = audio_buffer.p[i];
+		power_acc += v * v;
+		peak = std::max(peak, std::abs(v));
+	}
+	level_count += audio_buffer.count;
+	
+	if (level_count >= level_samples) {
+		// 0~255 for 0 to full scale (deviation)
+		const uint32_t rms = std::sqrt((float)power_acc / level_count);
+		level_message.value = std::min<uint32_t>(rms >> 7, 255);
+		level_message.peak = std::min<uint32_t>(peak >> 7, 255);
+		shared_memory.application_queue.push(level_message);
 		
-		buffer.p[i] = { re, im };
+		level_count = 0;
+		power_acc = 0;
+		peak = 0;
 	}
 }
 
@@ -96,13 +145,18 @@ void MicTXProcessor::on_message(const Message* const msg) {
 	
 	switch(msg->id) {
 		case Message::ID::AudioTXConfig:
-			fm_delta = config_message.deviation_hz * (0xFFFFFFUL / baseband_fs);
+			modulation = config_message.modulation;
+			fm.modulation().configure(config_message.deviation_hz, baseband_fs);
 			
-			audio_gain = config_message.audio_gain;
-			divider = config_message.divider;
-			power_acc_count = 0;
+			audio_gain_q7 = config_message.audio_gain * 128;
+			// Divider is in baseband samples
+			level_samples = std::max<size_t>(config_message.divider / interpolation, 1);
+			level_count = 0;
+			power_acc = 0;
+			peak = 0;
 			
-			tone_gen.configure(config_message.tone_key_delta, config_message.tone_key_mix_weight);
+			// Tone deltas are for the baseband rate, the generators run at the audio rate
+			tone_gen.configure(config_message.tone_key_delta * interpolation, config_message.tone_key_mix_weight);
 			
 			txprogress_message.done = true;
 
@@ -27,43 +27,81 @@
 #include "baseband_thread.hpp"
 #include "audio_input.hpp"
 #include "tone_gen.hpp"
+#include "dsp_iir.hpp"
+#include "dsp_modulate.hpp"
+#include "audio_compressor.hpp"
 
+#include <array>
+
+/* Mic audio is shaped at its own 24kHz in blocks: gain, pre-emphasis,
+ * compressor and limiter, and 3kHz low-pass, then the tone key or roger
+ * beep is mixed in. Q15 full scale is the configured deviation (FM) or full
+ * modulation. A TxModulator for each modulation takes it from there.
+ */
 class MicTXProcessor : public BasebandProcessor {
 public:
+	MicTXProcessor();
+	
 	void execute(const buffer_c8_t& buffer) override;
 	
 	void on_message(const Message* const msg) override;
 
 private:
 	static constexpr size_t baseband_fs = 1536000U;
+	static constexpr size_t audio_fs = 24000U;
+	static constexpr size_t interpolation = baseband_fs / audio_fs;
+	// 2048 baseband samples per buffer
+	static constexpr size_t audio_samples = 2048 / interpolation;
+	/* 3:1 over -20dBFS, so quiet and loud talkers end up closer, limited
+	 * to 90% of full scale for the low-pass' overshoot.
+	 */
+	static constexpr CompressorQ15::Config compressor_config { -20.0f, 3.0f, 4.0f, -0.92f, 0.200f };
 	
 	bool configured { false };
 	
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Transmit };
 	
-	int16_t audio_data[64];
+	std::array<int16_t, audio_samples> audio_data { };
 	buffer_s16_t audio_buffer {
-		audio_data,
-		sizeof(int16_t) * 64
+		audio_data.data(),
+		audio_data.size(),
+		audio_fs
 	};
 	
 	AudioInput audio_input { };
 	ToneGen tone_gen { };
 	ToneGen beep_gen { };
 	
-	uint32_t divider { }, audio_gain { };
+	IIRBiquadFilterQ15 preemph { };
+	CompressorQ15 compressor { };
+	IIRBiquadCascadeQ15<2> lpf { };
+	
+	using Modulation = AudioTXConfigMessage::Modulation;
+	
+	Modulation modulation { Modulation::FM };
+	dsp::modulate::TxModulator<dsp::modulate::FM> fm { };
+	dsp::modulate::TxModulator<dsp::modulate::AM> am { };
+	dsp::modulate::TxModulator<dsp::modulate::DSB> dsb { };
+	dsp::modulate::TxModulator<dsp::modulate::USB> usb { };
+	dsp::modulate::TxModulator<dsp::modulate::LSB> lsb { };
+	
+	int32_t audio_gain_q7 { 128 };		// x1.0 takes the mic to half scale
+	
+	size_t level_samples { 1 };
+	size_t level_count { 0 };
 	uint64_t power_acc { 0 };
-	uint32_t power_acc_count { 0 };
+	int32_t peak { 0 };
+	
 	bool play_beep { false };
-	uint32_t fm_delta { 0 };
-	uint32_t phase { 0 }, sphase { 0 };
-	int32_t sample { 0 }, delta { };
 	uint32_t beep_index { }, beep_timer { };
 	
-	int8_t re { 0 }, im { 0 };
-	
 	AudioLevelReportMessage level_message { };
 	TXProgressMessage txprogress_message { };
+	
+	void process_voice();
+	void process_beep();
+	void update_level();
+	void modulate(const buffer_c8_t& buffer);
 };
 
 #endif
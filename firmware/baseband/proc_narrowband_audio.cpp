@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "proc_am_audio.hpp"
+#include "proc_nfm_audio.hpp"
+
+#include "event_m4.hpp"
+
+#include <array>
+
+// AM and NFM share baseband rate and buffering, so switching between them
+// swaps the processor with RF still streaming.
+static const std::array<BasebandProcessorFactory, 2> processor_factories { {
+	{ portapack::spi_flash::image_tag_am_audio, []() -> std::unique_ptr<BasebandProcessor> { return std::make_unique<NarrowbandAMAudio>(); } },
+	{ portapack::spi_flash::image_tag_nfm_audio, []() -> std::unique_ptr<BasebandProcessor> { return std::make_unique<NarrowbandFMAudio>(); } },
+} };
+
+int main() {
+	EventDispatcher event_dispatcher { processor_factories };
+	event_dispatcher.run();
+	return 0;
+}
@@ -35,54 +35,48 @@ void NarrowbandFMAudio::execute(const buffer_c8_t& buffer) {
 	if( !configured ) {
 		return;
 	}
+
+	scan_group.feed(buffer, [](const uint32_t sequence, const size_t count, const std::array<int8_t, ScanGroupConfigMessage::channels_max>& levels_db) {
+		const ScanGroupResultMessage message { sequence, count, levels_db };
+		shared_memory.application_queue.push(message);
+	});
 	
-	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-	const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
-	const auto channel_out = channel_filter.execute(decim_1_out, dst_buffer);
+	// decim_0 and decim_1 fused, bit-identical to running them separately.
+	const auto decim_1_out = profile(profile_decim_01, [&]() { return dsp::decimate::execute_decim_64(decim_0, decim_1, buffer, dst_buffer); });
+	const auto channel_out = profile(profile_channel_filter, [&]() { return channel_filter.execute(decim_1_out, dst_buffer); });
+
+	if( frequency_correction.execute(channel_out) ) {
+		const FrequencyOffsetMessage message { frequency_correction.offset_hz() };
+		shared_memory.application_queue.push(message);
+	}
 
 	feed_channel_stats(channel_out);
 	channel_spectrum.feed(channel_out, channel_filter_pass_f, channel_filter_stop_f);
 
 	if (!pitch_rssi_enabled) {
 		// Normal mode, output demodulated audio
-		auto audio = demod.execute(channel_out, audio_buffer);
-		audio_output.write(audio);
+		auto audio = profile(profile_demod, [&]() { return demod.execute(channel_out, audio_buffer); });
+		feed_scan_dwell_audio(audio);
+		{
+			const ProfilerScope scope { profile_audio };
+			audio_output.write(audio);
+		}
 		
 		if (ctcss_detect_enabled) {
 			/* 24kHz int16_t[16]
 			 * -> FIR filter, <300Hz pass, >300Hz stop, gain of 1
 			 * -> 12kHz int16_t[8] */
 			auto audio_ctcss = ctcss_filter.execute(audio, work_audio_buffer);
+			coded_squelch.execute(audio_ctcss);
 			
-			// s16 to f32 for hpf
-			std::array<float, 8> audio_f;
-			for (size_t i = 0; i < audio_ctcss.count; i++) {
-				audio_f[i] = audio_ctcss.p[i] * ki;
-			}
-			
-			hpf.execute_in_place(buffer_f32_t {
-				audio_f.data(),
-				audio_ctcss.count,
-				audio_ctcss.sampling_rate
-				});
-			
-			// Zero-crossing detection
-			for (size_t c = 0; c < audio_ctcss.count; c++) {
-				cur_sample = audio_f[c];
-				if (cur_sample * prev_sample < 0.0) {
-					z_acc += z_timer;
-					z_timer = 0;
-					z_count++;
-				} else
-					z_timer++;
-				prev_sample = cur_sample;
-			}
-			
-			if (z_count >= 30) {
-				ctcss_message.value = (100 * 12000 / 2 * z_count) / z_acc;
-				shared_memory.application_queue.push(ctcss_message);
-				z_count = 0;
-				z_acc = 0;
+			// Goes out with every channel statistics update, and to the UI
+			// right away when it changes.
+			const auto result = coded_squelch.result();
+			if( result != coded_squelch_reported ) {
+				coded_squelch_reported = result;
+				set_coded_squelch(result);
+				const CodedSquelchMessage message { result };
+				shared_memory.application_queue.push(message);
 			}
 		}
 	} else {
@@ -118,9 +112,21 @@ void NarrowbandFMAudio::on_message(const Message* const message) {
 		capture_config(*reinterpret_cast<const CaptureConfigMessage*>(message));
 		break;
 	
+	case Message::ID::FrequencyCorrection:
+		frequency_correction_config(*reinterpret_cast<const FrequencyCorrectionMessage*>(message));
+		break;
+
 	case Message::ID::PitchRSSIConfigure:
 		pitch_rssi_config(*reinterpret_cast<const PitchRSSIConfigureMessage*>(message));
 		break;
+
+	case Message::ID::ScanDwellConfig:
+		configure_scan_dwell(*reinterpret_cast<const ScanDwellConfigMessage*>(message));
+		break;
+
+	case Message::ID::ScanGroupConfig:
+		scan_group.configure(*reinterpret_cast<const ScanGroupConfigMessage*>(message));
+		break;
 		
 	default:
 		break;
@@ -142,13 +148,14 @@ void NarrowbandFMAudio::configure(const NBFMConfigureMessage& message) {
 	decim_0.configure(message.decim_0_filter.taps, 33554432);
 	decim_1.configure(message.decim_1_filter.taps, 131072);
 	channel_filter.configure(message.channel_filter.taps, message.channel_decimation);
-	demod.configure(demod_input_fs, message.deviation);
+	demod.configure(demod_input_fs, message.deviation, dsp::demodulate::FM::Precision::Precise);
 	channel_filter_pass_f = message.channel_filter.pass_frequency_normalized * channel_filter_input_fs;
 	channel_filter_stop_f = message.channel_filter.stop_frequency_normalized * channel_filter_input_fs;
+	// Up to half the passband, the rest of the signal has to stay inside it.
+	frequency_correction.configure(channel_filter_output_fs, channel_filter_pass_f / 2);
 	channel_spectrum.set_decimation_factor(std::floor(channel_filter_output_fs / (channel_filter_pass_f + channel_filter_stop_f)));
 	audio_output.configure(message.audio_hpf_config, message.audio_deemph_config, (float)message.squelch_level / 100.0);
 	
-	hpf.configure(audio_24k_hpf_30hz_config);
 	ctcss_filter.configure(taps_64_lp_025_025.taps);
 
 	configured = true;
@@ -159,6 +166,11 @@ void NarrowbandFMAudio::pitch_rssi_config(const PitchRSSIConfigureMessage& messa
 	tone_delta = (message.rssi + 1000) * ((1ULL << 32) / 24000);
 }
 
+void NarrowbandFMAudio::frequency_correction_config(const FrequencyCorrectionMessage& message) {
+	frequency_correction.set_tracking(message.tracking);
+	frequency_correction.shift(message.shift_hz);
+}
+
 void NarrowbandFMAudio::capture_config(const CaptureConfigMessage& message) {
 	if( message.config ) {
 		audio_output.set_stream(std::make_unique<StreamInput>(message.config));
@@ -167,8 +179,10 @@ void NarrowbandFMAudio::capture_config(const CaptureConfigMessage& message) {
 	}
 }
 
+#ifndef BASEBAND_MULTI_PROCESSOR
 int main() {
 	EventDispatcher event_dispatcher { std::make_unique<NarrowbandFMAudio>() };
 	event_dispatcher.run();
 	return 0;
 }
+#endif
@@ -25,26 +25,32 @@
 
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
+#include "dsp_iq_correction.hpp"
 #include "rssi_thread.hpp"
 
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
-#include "dsp_iir.hpp"
+#include "dsp_coded_squelch.hpp"
+#include "dsp_frequency_correction.hpp"
 
 #include "audio_output.hpp"
 #include "spectrum_collector.hpp"
+#include "scan_group_collector.hpp"
+#include "stage_profiler.hpp"
 
 #include <cstdint>
 
 class NarrowbandFMAudio : public BasebandProcessor {
 public:
 	void execute(const buffer_c8_t& buffer) override;
+	void correct_iq(const buffer_c8_t& buffer) override { iq_correction.execute(buffer); }
 
 	void on_message(const Message* const message) override;
 
 private:
 	static constexpr size_t baseband_fs = 3072000;
 
+	IQCorrectionStage iq_correction { };
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 
@@ -75,34 +81,38 @@ private:
 	dsp::decimate::FIRAndDecimateComplex channel_filter { };
 	uint32_t channel_filter_pass_f = 0;
 	uint32_t channel_filter_stop_f = 0;
+	FrequencyCorrector frequency_correction { };
 	
-	// For CTCSS decoding
+	// For CTCSS/DCS decoding
 	dsp::decimate::FIR64AndDecimateBy2Real ctcss_filter { };
-	IIRBiquadFilter hpf { };
+	CodedSquelchDecoder coded_squelch { };
 
 	dsp::demodulate::FM demod { };
 
 	AudioOutput audio_output { };
 
 	SpectrumCollector channel_spectrum { };
+	ScanGroupCollector scan_group { };
+
+	ProfilerStage profile_decim_01 { 0, "decim01" };
+	ProfilerStage profile_channel_filter { 1, "chan_fl" };
+	ProfilerStage profile_demod { 2, "demod" };
+	ProfilerStage profile_audio { 3, "audio" };
 	
 	uint32_t tone_phase { 0 };
 	uint32_t tone_delta { 0 };
 	bool pitch_rssi_enabled { false };
 	
-	float cur_sample { }, prev_sample { };
-	uint32_t z_acc { 0}, z_timer { 0 }, z_count { 0 };
 	bool ctcss_detect_enabled { true };
-	static constexpr float k = 32768.0f;
-	static constexpr float ki = 1.0f / k;
 
 	bool configured { false };
 	void pitch_rssi_config(const PitchRSSIConfigureMessage& message);
 	void configure(const NBFMConfigureMessage& message);
 	void capture_config(const CaptureConfigMessage& message);
+	void frequency_correction_config(const FrequencyCorrectionMessage& message);
 	
 	//RequestSignalMessage sig_message { RequestSignalMessage::Signal::Squelched };
-	CodedSquelchMessage ctcss_message { 0 };
+	CodedSquelch coded_squelch_reported { };
 };
 
 #endif/*__PROC_NFM_AUDIO_H__*/
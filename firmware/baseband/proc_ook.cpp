@@ -26,6 +26,7 @@
 #include "event_m4.hpp"
 
 #include <cstdint>
+#include <algorithm>
 
 void OOKProcessor::execute(const buffer_c8_t& buffer) {
 	int8_t re, im;
@@ -34,6 +35,11 @@ void OOKProcessor::execute(const buffer_c8_t& buffer) {
 	
 	if (!configured) return;
 	
+	if (runs) {
+		execute_runs(buffer);
+		return;
+	}
+	
 	for (size_t i = 0; i < buffer.count; i++) {
 		
 		// Synthesis at 2.28M/10 = 228kHz
@@ -41,7 +47,9 @@ void OOKProcessor::execute(const buffer_c8_t& buffer) {
 			s = 10 - 1;
 			if (sample_count >= samples_per_bit) {
 				if (configured) {
-					if (bit_pos >= length) {
+					if (!length) {
+						next_stream_bit();
+					} else if (bit_pos >= length) {
 						// End of data
 						if (pause_counter == 0) {
 							pause_counter = pause;
@@ -95,14 +103,114 @@ void OOKProcessor::execute(const buffer_c8_t& buffer) {
 	}
 }
 
+/* A run at a time, a stretch of the buffer each, to the sample: no
+ * per-bit state, and no rounding of samples_per_bit to the synthesis rate.
+ */
+void OOKProcessor::execute_runs(const buffer_c8_t& buffer) {
+	size_t i = 0;
+	
+	while (i < buffer.count) {
+		if (!run_samples && !next_run()) {
+			synthesize(buffer, i, buffer.count - i, false);
+			return;
+		}
+		
+		const size_t count = std::min<size_t>(run_samples, buffer.count - i);
+		synthesize(buffer, i, count, run_level);
+		run_samples -= count;
+		i += count;
+	}
+}
+
+// The next run, the pause after the last or the first of a repeat. False when done.
+bool OOKProcessor::next_run() {
+	if (run_pos < length) {
+		const uint8_t run = shared_memory.bb_data.data[run_pos++];
+		run_level = run & 0x80;
+		run_samples = ((run & 0x7F) + 1) * samples_per_bit;
+		return true;
+	}
+	
+	if (!run_pause && pause_samples) {
+		run_pause = true;
+		run_level = false;
+		run_samples = pause_samples;
+		return true;
+	}
+	
+	if (repeat_counter < repeat) {
+		run_pos = 0;
+		run_pause = false;
+		txprogress_message.progress = repeat_counter + 1;
+		txprogress_message.done = false;
+		shared_memory.application_queue.push(txprogress_message);
+		repeat_counter++;
+		return next_run();
+	}
+	
+	txprogress_message.done = true;
+	shared_memory.application_queue.push(txprogress_message);
+	configured = false;
+	return false;
+}
+
+void OOKProcessor::synthesize(const buffer_c8_t& buffer, const size_t start, const size_t count, const bool on) {
+	if (!on) {
+		std::fill(&buffer.p[start], &buffer.p[start + count], complex8_t { 0, 0 });
+		return;
+	}
+	
+	for (size_t i = start; i < start + count; i++) {
+		phase = (phase + 200);
+		sphase = phase + (64 << 18);
+		buffer.p[i] = {
+			sine_table_i8[(sphase & 0x03FC0000) >> 18],
+			sine_table_i8[(phase & 0x03FC0000) >> 18]
+		};
+	}
+}
+
+void OOKProcessor::next_stream_bit() {
+	// Idle (carrier off) until the application has prefilled, and through
+	// underruns.
+	cur_bit = 0;
+	if (!stream || !stream_ready)
+		return;
+	
+	if (!stream->read_bit(cur_bit) && stream->is_done()) {
+		txprogress_message.done = true;
+		shared_memory.application_queue.push(txprogress_message);
+		configured = false;
+	}
+}
+
 void OOKProcessor::on_message(const Message* const p) {
+	if (p->id == Message::ID::ReplayConfig) {
+		const auto message = *reinterpret_cast<const ReplayConfigMessage*>(p);
+		stream_ready = false;
+		if (message.config)
+			stream = std::make_unique<BitStream>(message.config);
+		else
+			stream.reset();
+		return;
+	}
+	
+	// App has prefilled the buffers
+	if (p->id == Message::ID::FIFOData) {
+		stream_ready = true;
+		return;
+	}
+	
 	const auto message = *reinterpret_cast<const OOKConfigureMessage*>(p);
 	
 	if (message.id == Message::ID::OOKConfigure) {
-		samples_per_bit = message.samples_per_bit / 10;
+		runs = message.runs;
+		// The bit stream's counter runs at the synthesis rate, 1/10 of the runs'
+		samples_per_bit = runs ? message.samples_per_bit : (message.samples_per_bit / 10);
 		repeat = message.repeat - 1;
 		length = message.stream_length;
 		pause = message.pause_symbols + 1;
+		pause_samples = message.pause_symbols * message.samples_per_bit;
 	
 		pause_counter = 0;
 		s = 0;
@@ -110,6 +218,9 @@ void OOKProcessor::on_message(const Message* const p) {
 		repeat_counter = 0;
 		bit_pos = 0;
 		cur_bit = 0;
+		run_pos = 0;
+		run_samples = 0;
+		run_pause = false;
 		txprogress_message.progress = 0;
 		txprogress_message.done = false;
 		configured = true;
@@ -25,6 +25,9 @@
 
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
+#include "stream_bits.hpp"
+
+#include <memory>
 
 class OOKProcessor : public BasebandProcessor {
 public:
@@ -52,6 +55,23 @@ private:
 	int32_t tone_sample { 0 }, sig { 0 }, frq { 0 };
 	
 	TXProgressMessage txprogress_message { };
+	
+	// A zero stream_length takes the bits from here instead of bb_data
+	std::unique_ptr<BitStream> stream { };
+	bool stream_ready { false };
+	
+	// Runs from encoders::make_runs() instead, timed at the full rate
+	bool runs { false };
+	uint32_t run_pos { 0 };
+	uint32_t run_samples { 0 };
+	uint32_t pause_samples { 0 };
+	bool run_level { false };
+	bool run_pause { false };
+	
+	void next_stream_bit();
+	void execute_runs(const buffer_c8_t& buffer);
+	bool next_run();
+	void synthesize(const buffer_c8_t& buffer, const size_t start, const size_t count, const bool on);
 };
 
 #endif
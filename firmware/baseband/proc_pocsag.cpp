@@ -28,26 +28,46 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <algorithm>
 
-void POCSAGProcessor::execute(const buffer_c8_t& buffer) {
-	// This is called at 1500Hz
+void POCSAGDecoder::configure(const pocsag::BitRate new_bitrate) {
+	bitrate = new_bitrate;
+	sphase_delta = 0x10000u * bitrate / POCSAG_AUDIO_RATE;
+	sphase_delta_half = sphase_delta / 2;			// Just for speed
+	sphase_delta_eighth = sphase_delta / 8;
 	
-	if (!configured) return;
+	mf_length = std::min<size_t>(POCSAG_AUDIO_RATE / bitrate, mf_length_max);
+	mf_history.fill(0);
+	mf_index = 0;
+	mf_sum = 0;
 	
-	// Get 24kHz audio
-	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-	const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
-	const auto channel_out = channel_filter.execute(decim_1_out, dst_buffer);
-	auto audio = demod.execute(channel_out, audio_buffer);
-	//audio_output.write(audio);
+	rx_state = WAITING;
+	enabled = true;
+}
+
+void POCSAGDecoder::disable() {
+	enabled = false;
+}
+
+void POCSAGDecoder::execute(const buffer_f32_t& audio) {
+	if (!enabled) return;
+	
+	packets.poll();
 	
-	for (uint32_t c = 0; c < 16; c++) {
+	for (size_t c = 0; c < audio.count; c++) {
 		
 		const int32_t sample_int = audio.p[c] * 32768.0f;
 		const int32_t audio_sample = __SSAT(sample_int, 16);
 		
+		mf_sum += audio_sample - mf_history[mf_index];
+		mf_history[mf_index] = audio_sample;
+		if (++mf_index >= mf_length) mf_index = 0;
+		
+		// The filter delays zero crossings by half a symbol, same as the
+		// distance from a crossing to the best sampling point, so the
+		// clock recovery below is unchanged.
 		slicer_sr <<= 1;
-		slicer_sr |= (audio_sample < 0);		// Do we need hysteresis ?
+		slicer_sr |= (mf_sum < 0);
 
 		// Detect transitions to adjust clock
 		if ((slicer_sr ^ (slicer_sr >> 1)) & 1) {
@@ -62,80 +82,138 @@ void POCSAGProcessor::execute(const buffer_c8_t& buffer) {
 		// Symbol time elapsed
 		if (sphase >= 0x10000u) {
 			sphase &= 0xFFFFu;
-			
-			rx_data <<= 1;
-			rx_data |= (slicer_sr & 1);
-			
-			switch (rx_state) {
-				
-				case WAITING:
-					if (rx_data == 0xAAAAAAAA) {
-						rx_state = PREAMBLE;
-						sync_timeout = 0;
-					}
-					break;
+			consume_symbol();
+		}
+	}
+}
+
+void POCSAGDecoder::consume_symbol() {
+	rx_data <<= 1;
+	rx_data |= (slicer_sr & 1);
+	
+	switch (rx_state) {
+		
+		case WAITING:
+			if (sync_match(rx_data, 0xAAAAAAAA)) {
+				rx_state = PREAMBLE;
+				sync_timeout = 0;
+			}
+			break;
+		
+		case PREAMBLE:
+			if (sync_timeout < POCSAG_TIMEOUT) {
+				sync_timeout++;
+
+				if (sync_match(rx_data, POCSAG_SYNCWORD)) {
+					packet.clear();
+					codeword_count = 0;
+					rx_bit = 0;
+					msg_timeout = 0;
+					rx_state = SYNC;
+				}
 				
-				case PREAMBLE:
-					if (sync_timeout < POCSAG_TIMEOUT) {
-						sync_timeout++;
-
-						if (rx_data == POCSAG_SYNCWORD) {
-							packet.clear();
-							codeword_count = 0;
-							rx_bit = 0;
-							msg_timeout = 0;
-							rx_state = SYNC;
-						}
-						
-					} else {
-						// Timeout here is normal (end of message)
-						rx_state = WAITING;
-						//push_packet(pocsag::PacketFlag::TIMED_OUT);
-					}
-					break;
+			} else {
+				// Timeout here is normal (end of message)
+				rx_state = WAITING;
+				//push_packet(pocsag::PacketFlag::TIMED_OUT);
+			}
+			break;
+		
+		case SYNC:
+			if (msg_timeout < POCSAG_BATCH_LENGTH) {
+				msg_timeout++;
+				rx_bit++;
+				reliability[32 - rx_bit] = (mf_sum < 0) ? -mf_sum : mf_sum;
 				
-				case SYNC:
-					if (msg_timeout < POCSAG_BATCH_LENGTH) {
-						msg_timeout++;
-						rx_bit++;
-						
-						if (rx_bit >= 32) {
-							rx_bit = 0;
-							
-							// Got a complete codeword
-							
-							//pocsag_brute_repair(&s->l2.pocsag, &rx_data);
-							
-							packet.set(codeword_count, rx_data);
-							
-							if (codeword_count < 15) {
-								codeword_count++;
-							} else {
-								push_packet(pocsag::PacketFlag::NORMAL);
-								rx_state = PREAMBLE;
-								sync_timeout = 0;
-							}
-						}
+				if (rx_bit >= 32) {
+					rx_bit = 0;
+					
+					// Got a complete codeword
+					packet.set(codeword_count, correct_codeword(rx_data));
+					
+					if (codeword_count < 15) {
+						codeword_count++;
 					} else {
-						packet.set(0, codeword_count);	// Replace first codeword with count, for debug
-						push_packet(pocsag::PacketFlag::TIMED_OUT);
-						rx_state = WAITING;
+						push_packet(pocsag::PacketFlag::NORMAL);
+						rx_state = PREAMBLE;
+						sync_timeout = 0;
 					}
-					break;
-
-				default:
-					break;
+				}
+			} else {
+				packet.set(0, codeword_count);	// Replace first codeword with count, for debug
+				push_packet(pocsag::PacketFlag::TIMED_OUT);
+				rx_state = WAITING;
 			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+bool POCSAGDecoder::sync_match(const uint32_t data, const uint32_t code) {
+	return (size_t)__builtin_popcount(data ^ code) <= sync_max_errors;
+}
+
+uint32_t POCSAGDecoder::correct_codeword(const uint32_t codeword) const {
+	uint32_t result = codeword;
+	
+	if (bch::correct(result))
+		return result;
+	
+	// More than two errors: retry with the two least reliable bits flipped
+	// (Chase decoding), which gets one more error on faded codewords.
+	size_t weakest = 1, second = 2;
+	if (reliability[second] < reliability[weakest]) std::swap(weakest, second);
+	for (size_t n = 3; n < 32; n++) {
+		if (reliability[n] < reliability[weakest]) {
+			second = weakest;
+			weakest = n;
+		} else if (reliability[n] < reliability[second]) {
+			second = n;
 		}
 	}
+	
+	const uint32_t flips[3] = {
+		1U << weakest,
+		1U << second,
+		(1U << weakest) | (1U << second)
+	};
+	
+	for (const auto flip : flips) {
+		result = codeword ^ flip;
+		if (bch::correct(result))
+			return result;
+	}
+	
+	// Uncorrectable, pass on as received
+	return codeword;
 }
 
-void POCSAGProcessor::push_packet(pocsag::PacketFlag flag) {
+void POCSAGDecoder::push_packet(pocsag::PacketFlag flag) {
 	packet.set_bitrate(bitrate);
 	packet.set_flag(flag);
 	packet.set_timestamp(Timestamp::now());
-	const POCSAGPacketMessage message(packet);
-	shared_memory.application_queue.push(message);
+	packets.push(packet);
+	BasebandProcessor::count_decode();
+}
+
+void POCSAGProcessor::execute(const buffer_c8_t& buffer) {
+	// This is called at 1500Hz
+	
+	if (!configured) return;
+	
+	// Get 24kHz audio
+	const auto decim_0_out = profile(profile_decim_0, [&]() { return decim_0.execute(buffer, dst_buffer); });
+	const auto decim_1_out = profile(profile_decim_1, [&]() { return decim_1.execute(decim_0_out, dst_buffer); });
+	const auto channel_out = profile(profile_channel_filter, [&]() { return channel_filter.execute(decim_1_out, dst_buffer); });
+	auto audio = profile(profile_demod, [&]() { return demod.execute(channel_out, audio_buffer); });
+	//audio_output.write(audio);
+	
+	const ProfilerScope scope_decoder { profile_decoder };
+	
+	for (auto& decoder : decoders)
+		decoder.execute(audio);
 }
 
 void POCSAGProcessor::on_message(const Message* const message) {
@@ -161,12 +239,15 @@ void POCSAGProcessor::configure(const POCSAGConfigureMessage& message) {
 	demod.configure(demod_input_fs, 4500);
 	//audio_output.configure(false);
 
-	bitrate = message.bitrate;
-	sphase_delta = 0x10000u * bitrate / POCSAG_AUDIO_RATE;
-	sphase_delta_half = sphase_delta / 2;			// Just for speed
-	sphase_delta_eighth = sphase_delta / 8;
+	// BitRate::UNKNOWN runs every rate, each tagging its own packets
+	for (size_t i = 0; i < decoders.size(); i++) {
+		const auto rate = pocsag::pocsag_bitrates[i];
+		if ((message.bitrate == pocsag::BitRate::UNKNOWN) || (message.bitrate == rate))
+			decoders[i].configure(rate);
+		else
+			decoders[i].disable();
+	}
 	
-	rx_state = WAITING;
 	configured = true;
 }
 
@@ -38,14 +38,20 @@
 #include "message.hpp"
 #include "audio_output.hpp"
 #include "portapack_shared_memory.hpp"
+#include "packet_staging.hpp"
+#include "stage_profiler.hpp"
 
 #include <cstdint>
 
-class POCSAGProcessor : public BasebandProcessor {
+/* Slicer, clock recovery and framer for one bitrate, fed 24kHz
+ * discriminator audio.
+ */
+class POCSAGDecoder {
 public:
-	void execute(const buffer_c8_t& buffer) override;
-	
-	void on_message(const Message* const message) override;
+	void configure(const pocsag::BitRate new_bitrate);
+	void disable();
+
+	void execute(const buffer_f32_t& audio);
 
 private:
 	enum rx_states {
@@ -59,6 +65,54 @@ private:
 		//END_OF_MESSAGE = 69
 	};
 
+	static constexpr size_t sync_max_errors = 2;
+	// Longest symbol, at 512 bps
+	static constexpr size_t mf_length_max = (POCSAG_AUDIO_RATE + 511) / 512;
+
+	bool enabled { false };
+
+	// Integrate-and-dump over one symbol: the matched filter for NRZ FSK
+	std::array<int16_t, mf_length_max> mf_history { };
+	size_t mf_length { 0 };
+	size_t mf_index { 0 };
+	int32_t mf_sum { 0 };
+
+	// Soft value magnitudes of the codeword being received, by bit position
+	std::array<int32_t, 32> reliability { };
+
+	uint32_t sync_timeout { 0 };
+	uint32_t msg_timeout { 0 };
+
+	uint32_t slicer_sr { 0 };
+	uint32_t sphase { 0 };
+	uint32_t sphase_delta { 0 };
+	uint32_t sphase_delta_half { 0 };
+	uint32_t sphase_delta_eighth { 0 };
+	uint32_t rx_data { 0 };
+	uint32_t rx_bit { 0 };
+	rx_states rx_state { WAITING };
+	pocsag::BitRate bitrate { pocsag::BitRate::FSK1200 };
+	uint32_t codeword_count { 0 };
+	pocsag::POCSAGPacket packet { };
+	PacketBatcher<POCSAGPacketMessage, 1> packets { };
+
+	void consume_symbol();
+
+	static bool sync_match(const uint32_t data, const uint32_t code);
+	uint32_t correct_codeword(const uint32_t codeword) const;
+	void push_packet(pocsag::PacketFlag flag);
+};
+
+/* All three POCSAG bitrates decoded in parallel from one FM demodulator,
+ * unless the application asks for a single one.
+ */
+class POCSAGProcessor : public BasebandProcessor {
+public:
+	void execute(const buffer_c8_t& buffer) override;
+	
+	void on_message(const Message* const message) override;
+
+private:
 	static constexpr size_t baseband_fs = 3072000;
 
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
@@ -79,26 +133,18 @@ private:
 	dsp::decimate::FIRC16xR16x32Decim8 decim_1 { };
 	dsp::decimate::FIRAndDecimateComplex channel_filter { };
 	dsp::demodulate::FM demod { };
+
+	ProfilerStage profile_decim_0 { 0, "decim_0" };
+	ProfilerStage profile_decim_1 { 1, "decim_1" };
+	ProfilerStage profile_channel_filter { 2, "chan_fl" };
+	ProfilerStage profile_demod { 3, "demod" };
+	ProfilerStage profile_decoder { 4, "decoder" };
 	
 	//AudioOutput audio_output { };
 
-	uint32_t sync_timeout { 0 };
-	uint32_t msg_timeout { 0 };
-
-	uint32_t slicer_sr { 0 };
-	uint32_t sphase { 0 };
-	uint32_t sphase_delta { 0 };
-	uint32_t sphase_delta_half { 0 };
-	uint32_t sphase_delta_eighth { 0 };
-	uint32_t rx_data { 0 };
-	uint32_t rx_bit { 0 };
+	std::array<POCSAGDecoder, 3> decoders { };
 	bool configured = false;
-	rx_states rx_state { WAITING };
-	pocsag::BitRate bitrate { pocsag::BitRate::FSK1200 };
-	uint32_t codeword_count { 0 };
-	pocsag::POCSAGPacket packet { };
 	
-	void push_packet(pocsag::PacketFlag flag);
 	void configure(const POCSAGConfigureMessage& message);
 	
 };
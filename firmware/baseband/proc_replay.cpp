@@ -28,6 +28,11 @@
 
 #include "utility.hpp"
 
+#include <algorithm>
+
+const dsp::interpolate::CompensatedCICInterpolator<3, 8>::taps_t ReplayProcessor::upsampler_taps =
+	dsp::interpolate::design<3, 8>();
+
 ReplayProcessor::ReplayProcessor() {
 	channel_filter_pass_f = taps_200k_decim_1.pass_frequency_normalized * 1000000;	// 162760.416666667
 	channel_filter_stop_f = taps_200k_decim_1.stop_frequency_normalized * 1000000;	// 337239.583333333
@@ -40,37 +45,38 @@ ReplayProcessor::ReplayProcessor() {
 }
 
 void ReplayProcessor::execute(const buffer_c8_t& buffer) {
-	/* 4MHz, 2048 samples */
+	/* 2048 C8 samples at baseband_fs */
 	
 	if (!configured) return;
 	
-	// File data is in C16 format, we need C8
-	// File samplerate is 500kHz, we're at 4MHz
-	// iq_buffer can only be 512 C16 samples (RAM limitation)
-	// To fill up the 2048-sample C8 buffer, we need:
-	// 2048 samples * 2 bytes per sample = 4096 bytes
-	// Since we're oversampling by 4M/500k = 8, we only need 2048/8 = 256 samples from the file and duplicate them 8 times each
-	// So 256 * 4 bytes per sample (C16) = 1024 bytes from the file
-	if( stream ) {
-		const size_t bytes_to_read = sizeof(*buffer.p) * 2 * (buffer.count / 8);	// *2 (C16), /8 (oversampling) should be == 1024
-		bytes_read += stream->read(iq_buffer.p, bytes_to_read);
-	}
-	
-	// Fill and "stretch"
-	for (size_t i = 0; i < buffer.count; i++) {
-		if (i & 3) {
-			buffer.p[i] = buffer.p[i - 1];
-		} else {
-			auto re_out = iq_buffer.p[i >> 3].real() >> 8;
-			auto im_out = iq_buffer.p[i >> 3].imag() >> 8;
-			buffer.p[i] = { (int8_t)re_out, (int8_t)im_out };
+	size_t block_count = 0;
+	if( (format == ReplayConfig::Format::C8) && (interpolation == 1) ) {
+		// Already what the radio takes: straight from the FIFO into the buffer.
+		if( stream ) {
+			bytes_read += stream->read(buffer.p, buffer.count * sizeof(*buffer.p));
+		}
+		block_count = std::min(iq.size(), buffer.count);
+	} else {
+		// File data is at baseband_fs / interpolation. iq only holds 256 C16
+		// samples (RAM limitation), so the buffer is filled a block at a
+		// time, each block read from the file and upsampled straight into it.
+		for(size_t n=0; n<buffer.count; n+=block_count * interpolation) {
+			block_count = std::min(iq.size(), (buffer.count - n) / interpolation);
+			read_block(block_count);
+			upsampler.execute(
+				{ iq.data(), block_count, baseband_fs / interpolation },
+				{ &buffer.p[n], block_count * interpolation, baseband_fs }
+			);
 		}
 	}
 	
 	spectrum_samples += buffer.count;
 	if( spectrum_samples >= spectrum_interval_samples ) {
 		spectrum_samples -= spectrum_interval_samples;
-		channel_spectrum.feed(iq_buffer, channel_filter_pass_f, channel_filter_stop_f);
+		if( (format == ReplayConfig::Format::C8) && (interpolation == 1) ) {
+			widen(buffer.p, block_count);
+		}
+		channel_spectrum.feed({ iq.data(), block_count, baseband_fs / interpolation }, channel_filter_pass_f, channel_filter_stop_f);
 		
 		txprogress_message.progress = bytes_read;	// Inform UI about progress
 		txprogress_message.done = false;
@@ -78,6 +84,26 @@ void ReplayProcessor::execute(const buffer_c8_t& buffer) {
 	}
 }
 
+void ReplayProcessor::read_block(const size_t count) {
+	if( format == ReplayConfig::Format::C8 ) {
+		const auto p = reinterpret_cast<complex8_t*>(iq.data());
+		if( stream ) {
+			bytes_read += stream->read(p, count * sizeof(complex8_t));
+		}
+		widen(p, count);
+	} else if( stream ) {
+		bytes_read += stream->read(iq.data(), count * sizeof(complex16_t));
+	}
+}
+
+void ReplayProcessor::widen(const complex8_t* const src, const size_t count) {
+	// Backwards, so src may be the start of iq itself.
+	for(size_t i=count; i>0; i--) {
+		const complex8_t v = src[i - 1];
+		iq[i - 1] = { static_cast<int16_t>(v.real() * 256), static_cast<int16_t>(v.imag() * 256) };
+	}
+}
+
 void ReplayProcessor::on_message(const Message* const message) {
 	switch(message->id) {
 	case Message::ID::UpdateSpectrum:
@@ -107,17 +133,19 @@ void ReplayProcessor::on_message(const Message* const message) {
 
 void ReplayProcessor::samplerate_config(const SamplerateConfigMessage& message) {
 	baseband_fs = message.sample_rate;
+	interpolation = message.interpolation;
+	upsampler.configure(interpolation);
 	baseband_thread.set_sampling_rate(baseband_fs);
 	spectrum_interval_samples = baseband_fs / spectrum_rate_hz;
 }
 
 void ReplayProcessor::replay_config(const ReplayConfigMessage& message) {
 	if( message.config ) {
+		format = message.config->format;
 		
+		// Handled synchronously: FIFO pointers are valid once the app's
+		// send_message() returns, so the app can start prefilling then.
 		stream = std::make_unique<StreamOutput>(message.config);
-		
-		// Tell application that the buffers and FIFO pointers are ready, prefill
-		shared_memory.application_queue.push(sig_message);
 	} else {
 		stream.reset();
 	}
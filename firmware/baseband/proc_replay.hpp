@@ -29,6 +29,7 @@
 #include "spectrum_collector.hpp"
 
 #include "stream_output.hpp"
+#include "dsp_interpolate.hpp"
 
 #include <array>
 #include <memory>
@@ -48,11 +49,11 @@ private:
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Transmit };
 
 	std::array<complex16_t, 256> iq { };
-	const buffer_c16_t iq_buffer {
-		iq.data(),
-		iq.size(),
-		baseband_fs / 8
-	};
+	size_t interpolation = 1;
+	ReplayConfig::Format format { ReplayConfig::Format::C16 };
+
+	static const dsp::interpolate::CompensatedCICInterpolator<3, 8>::taps_t upsampler_taps;
+	dsp::interpolate::CompensatedCICInterpolator<3, 8> upsampler { upsampler_taps };
 	
 	uint32_t channel_filter_pass_f = 0;
 	uint32_t channel_filter_stop_f = 0;
@@ -68,9 +69,10 @@ private:
 
 	void samplerate_config(const SamplerateConfigMessage& message);
 	void replay_config(const ReplayConfigMessage& message);
+	void read_block(const size_t count);
+	void widen(const complex8_t* const src, const size_t count);
 	
 	TXProgressMessage txprogress_message { };
-	RequestSignalMessage sig_message { RequestSignalMessage::Signal::FillRequest };
 };
 
 #endif/*__PROC_REPLAY_HPP__*/
@@ -22,68 +22,58 @@
 
 #include "proc_siggen.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
+#include <algorithm>
 
 void SigGenProcessor::execute(const buffer_c8_t& buffer) {
 	if (!configured) return;
 	
-	for (size_t i = 0; i < buffer.count; i++) {
-		
-		if (!sample_count && auto_off) {
-			txprogress_message.done = true;
-			shared_memory.application_queue.push(txprogress_message);
-		} else
-			sample_count--;
+	const size_t count = std::min(buffer.count, samples.size());
+	
+	// In runs, so a hop lands on its sample
+	for (size_t i = 0; i < count; ) {
+		const size_t n = sequencer.active() ? sequencer.run(count - i) : (count - i);
 		
-		if (tone_shape == 0) {
-			// CW
-			re = 0;
-			im = 0;
+		if (sequencer.in_guard()) {
+			std::fill(&buffer.p[i], &buffer.p[i + n], complex8_t { 0, 0 });
 		} else {
+			make_shape(i, n);
 			
-			if (tone_shape == 1) {
-				// Sine
-				sample = (sine_table_i8[(tone_phase & 0xFF000000) >> 24]);
-			} else if (tone_shape == 2) {
-				// Tri
-				int8_t a = (tone_phase & 0xFF000000) >> 24;
-				sample = (a & 0x80) ? ((a << 1) ^ 0xFF) - 0x80 : (a << 1) + 0x80;
-			} else if (tone_shape == 3) {
-				// Saw up
-				sample = ((tone_phase & 0xFF000000) >> 24);
-			} else if (tone_shape == 4) {
-				// Saw down
-				sample = ((tone_phase & 0xFF000000) >> 24) ^ 0xFF;
-			} else if (tone_shape == 5) {
-				// Square
-				sample = (((tone_phase & 0xFF000000) >> 24) & 0x80) ? 127 : -128;
-			} else if (tone_shape == 6) {
-				// Noise
-				sample = (lfsr & 0xFF000000) >> 24;
-				feedback = ((lfsr >> 31) ^ (lfsr >> 29) ^ (lfsr >> 15) ^ (lfsr >> 11)) & 1;
-				lfsr = (lfsr << 1) | feedback;
-				if (!lfsr) lfsr = 0x1337;				// Shouldn't do this :(
+			if (tone_shape == 0) {
+				// CW
+				std::fill(&buffer.p[i], &buffer.p[i + n], complex8_t { 0, 0 });
+			} else {
+				fm.execute({ &samples[i], n, baseband_fs }, &buffer.p[i]);
 			}
-			
-			tone_phase += tone_delta;
-			
-			// Do FM
-			delta = sample * fm_delta;
-			
-			phase += delta;
-			sphase = phase + (64 << 24);
-
-			re = (sine_table_i8[(sphase & 0xFF000000) >> 24]);
-			im = (sine_table_i8[(phase & 0xFF000000) >> 24]);
 		}
-
-		buffer.p[i] = {re, im};
+		
+		i += n;
+		if (sequencer.advance(n))
+			set_tone(sequencer.payload());
 	}
 };
 
+void SigGenProcessor::make_shape(const size_t first, const size_t count) {
+	if (auto_off) {
+		if (sample_count <= count) {
+			// Once, the app stops TX
+			auto_off = false;
+			txprogress_message.done = true;
+			shared_memory.application_queue.push(txprogress_message);
+		} else
+			sample_count -= count;
+	}
+	
+	generator.execute(&samples[first], count);
+}
+
+void SigGenProcessor::set_tone(const uint32_t tone_delta) {
+	if (!generator.sweeping())
+		generator.set_tones(&tone_delta, 1);
+}
+
 void SigGenProcessor::on_message(const Message* const msg) {
 	const auto message = *reinterpret_cast<const SigGenConfigMessage*>(msg);
 	
@@ -100,16 +90,40 @@ void SigGenProcessor::on_message(const Message* const msg) {
 			} else
 				auto_off = false;
 			
-			fm_delta = message.bw * (0xFFFFFFULL / 1536000);
+			fm.configure(message.bw, baseband_fs);
 			tone_shape = message.shape;
-			
-			lfsr = 0x54DF0119;
+			generator.set_shape(static_cast<dsp::dds::Shape>(message.shape));
+			generator.seed(0x54DF0119);
 
 			configured = true;
 			break;
 		
 		case Message::ID::SigGenTone:
-			tone_delta = reinterpret_cast<const SigGenToneMessage*>(msg)->tone_delta;
+			{
+				const auto tone_delta = reinterpret_cast<const SigGenToneMessage*>(msg)->tone_delta;
+				generator.set_tones(&tone_delta, 1);
+			}
+			break;
+		
+		case Message::ID::SigGenTones:
+			{
+				const auto tones = reinterpret_cast<const SigGenTonesMessage*>(msg);
+				generator.set_tones(tones->tone_deltas.data(), tones->count);
+			}
+			break;
+		
+		case Message::ID::SigGenSweep:
+			{
+				const auto sweep = reinterpret_cast<const SigGenSweepMessage*>(msg);
+				generator.set_sweep(static_cast<dsp::dds::Sweep>(sweep->kind),
+					sweep->start_delta, sweep->end_delta, sweep->period);
+			}
+			break;
+		
+		case Message::ID::TxSequenceConfig:
+			sequencer.configure(*reinterpret_cast<const TxSequenceConfigMessage*>(msg));
+			if (sequencer.active())
+				set_tone(sequencer.payload());
 			break;
 
 		default:
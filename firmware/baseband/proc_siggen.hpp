@@ -26,6 +26,11 @@
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
 #include "portapack_shared_memory.hpp"
+#include "dsp_modulate.hpp"
+#include "dsp_dds.hpp"
+#include "tx_sequencer.hpp"
+
+#include <array>
 
 class SigGenProcessor : public BasebandProcessor {
 public:
@@ -34,19 +39,28 @@ public:
 	void on_message(const Message* const msg) override;
 
 private:
+	static constexpr size_t baseband_fs = 1536000;
+	
 	bool configured { false };
 	
-	BasebandThread baseband_thread { 1536000, this, NORMALPRIO + 20, baseband::Direction::Transmit };
+	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Transmit };
+	
+	// Shapes are made at the baseband rate, sharp edges and all
+	std::array<int16_t, 2048> samples { };
+	dsp::modulate::FM fm { };
 	
-	uint32_t tone_delta { 0 }, fm_delta { };
-	uint32_t lfsr { }, feedback { }, tone_shape { };
-    uint32_t sample_count { 0 };
-    bool auto_off { };
-	uint32_t tone_phase { 0 }, phase { 0 }, delta { 0 }, sphase { 0 };
-	int8_t sample { 0 };
-	int8_t re { 0 }, im { 0 };
+	dsp::dds::Generator generator { };
+	uint32_t tone_shape { };
+	uint32_t sample_count { 0 };
+	bool auto_off { };
+	
+	// Hops: each step's payload is its tone_delta, kept while sweeping
+	TxSequencer sequencer { };
 	
 	TXProgressMessage txprogress_message { };
+	
+	void make_shape(const size_t first, const size_t count);
+	void set_tone(const uint32_t tone_delta);
 };
 
 #endif
@@ -49,6 +49,75 @@ void SondeProcessor::execute(const buffer_c8_t& buffer) {
 	}
 }
 
+void SondeProcessor::consume_symbol_fsk_9600(const float raw_symbol) {
+	const uint_fast8_t sliced_symbol = (raw_symbol >= 0.0f) ? 1 : 0;
+	packet_builder_fsk_9600_Meteomodem.execute(sliced_symbol);
+}
+
+void SondeProcessor::consume_symbol_fsk_4800(const float raw_symbol) {
+	const uint_fast8_t sliced_symbol = (raw_symbol >= 0.0f) ? 1 : 0;
+	packet_builder_fsk_4800_Vaisala.execute(sliced_symbol);
+}
+
+/* The preamble matched the first four header bytes, so the packet holds the
+ * rest of the frame, each byte LSB first. It goes on to the M0 descrambled
+ * and corrected, a byte at a time MSB first.
+ */
+void SondeProcessor::vaisala_handler(const baseband::Packet& packet) {
+	const size_t matched = 4;
+	for(size_t i=0; i<sonde::rs41::frame_length; i++) {
+		if( i < matched ) {
+			rs41_frame[i] = sonde::rs41::header[i];
+		} else {
+			const uint8_t raw = __RBIT(packet.read((i - matched) * 8, 8)) >> 24;
+			rs41_frame[i] = raw ^ sonde::rs41::mask[i & 63];
+		}
+	}
+
+	const auto corrected = rs41_correct();
+
+	rs41_packet.clear();
+	rs41_packet.set_timestamp(packet.timestamp());
+	for(const auto byte : rs41_frame) {
+		for(size_t bit=0; bit<8; bit++) {
+			rs41_packet.add((byte >> (7 - bit)) & 1);
+		}
+	}
+
+	const SondePacketMessage message { sonde::Packet::Type::Vaisala_RS41_SG, rs41_packet, corrected };
+	shared_memory.application_queue.push(message);
+	count_decode();
+}
+
+int SondeProcessor::rs41_correct() {
+	const auto even = rs41_correct_codeword(0);
+	const auto odd = rs41_correct_codeword(1);
+	return ((even < 0) || (odd < 0)) ? -1 : (even + odd);
+}
+
+int SondeProcessor::rs41_correct_codeword(const size_t index) {
+	using namespace sonde::rs41;
+
+	rs41_codeword.fill(0);
+	for(size_t i=0; i<parity_length; i++) {
+		rs41_codeword[i] = rs41_frame[parity_position + index * parity_length + i];
+	}
+	for(size_t i=0; i<message_length; i++) {
+		rs41_codeword[parity_length + i] = rs41_frame[message_position + 2 * i + index];
+	}
+
+	const auto corrected = reed_solomon::decode(rs41_codeword, parity_length, parity_length + message_length);
+	if( corrected > 0 ) {
+		for(size_t i=0; i<parity_length; i++) {
+			rs41_frame[parity_position + index * parity_length + i] = rs41_codeword[i];
+		}
+		for(size_t i=0; i<message_length; i++) {
+			rs41_frame[message_position + 2 * i + index] = rs41_codeword[parity_length + i];
+		}
+	}
+	return corrected;
+}
+
 int main() {
 	EventDispatcher event_dispatcher { std::make_unique<SondeProcessor>() };
 	event_dispatcher.run();
@@ -85,12 +85,15 @@
 #include "packet_builder.hpp"
 #include "baseband_packet.hpp"
 
+#include "reed_solomon.hpp"
+
 #include "message.hpp"
 #include "portapack_shared_memory.hpp"
 
 #include <cstdint>
 #include <cstddef>
 #include <bitset>
+#include <array>
 
 class SondeProcessor : public BasebandProcessor {
 public:
@@ -112,16 +115,17 @@ private:
 
 	dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0 { };
 	dsp::decimate::FIRC16xR16x32Decim8 decim_1 { };
-	dsp::matched_filter::MatchedFilter mf { baseband::ais::square_taps_38k4_1t_p, 2 };
+	dsp::matched_filter::MatchedFilterQ15<baseband::ais::square_taps_38k4_1t_p.size()> mf { baseband::ais::square_taps_38k4_1t_p, 2 };
 
 	// Actually 4800bits/s but the Manchester coding doubles the symbol rate
-	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery_fsk_9600 {
-		19200, 9600, { 0.0555f },
-		[this](const float raw_symbol) {
-			const uint_fast8_t sliced_symbol = (raw_symbol >= 0.0f) ? 1 : 0;
-			this->packet_builder_fsk_9600_Meteomodem.execute(sliced_symbol);
-		}
-	};
+	void consume_symbol_fsk_9600(const float raw_symbol);
+	void consume_symbol_fsk_4800(const float raw_symbol);
+
+	clock_recovery::FixedRateClockRecovery<
+		19200, 9600,
+		clock_recovery::FixedErrorFilter,
+		clock_recovery::MemberSymbolHandler<SondeProcessor, &SondeProcessor::consume_symbol_fsk_9600>
+	> clock_recovery_fsk_9600 { { 0.0555f }, this };
 	PacketBuilder<BitPattern, NeverMatch, FixedLength> packet_builder_fsk_9600_Meteomodem {
 		{ 0b00110011001100110101100110110011, 32, 1 },
 		{ },
@@ -129,25 +133,32 @@ private:
 		[this](const baseband::Packet& packet) {
 			const SondePacketMessage message { sonde::Packet::Type::Meteomodem_unknown, packet };
 			shared_memory.application_queue.push(message);
+			count_decode();
 		}
 	};
 	
-	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery_fsk_4800 {
-		19200, 4800, { 0.0555f },
-		[this](const float raw_symbol) {
-			const uint_fast8_t sliced_symbol = (raw_symbol >= 0.0f) ? 1 : 0;
-			this->packet_builder_fsk_4800_Vaisala.execute(sliced_symbol);
-		}
-	};
+	clock_recovery::FixedRateClockRecovery<
+		19200, 4800,
+		clock_recovery::FixedErrorFilter,
+		clock_recovery::MemberSymbolHandler<SondeProcessor, &SondeProcessor::consume_symbol_fsk_4800>
+	> clock_recovery_fsk_4800 { { 0.0555f }, this };
 	PacketBuilder<BitPattern, NeverMatch, FixedLength> packet_builder_fsk_4800_Vaisala {
 		{ 0b00001000011011010101001110001000, 32, 1 },
 		{ },
 		{ 320 * 8 },
 		[this](const baseband::Packet& packet) {
-			const SondePacketMessage message { sonde::Packet::Type::Vaisala_RS41_SG, packet };
-			shared_memory.application_queue.push(message);
+			this->vaisala_handler(packet);
 		}
 	};
+
+	// Kept off the baseband thread's stack.
+	std::array<uint8_t, sonde::rs41::frame_length> rs41_frame { };
+	reed_solomon::codeword_t rs41_codeword { };
+	baseband::Packet rs41_packet { };
+
+	void vaisala_handler(const baseband::Packet& packet);
+	int rs41_correct();
+	int rs41_correct_codeword(const size_t index);
 };
 
 #endif/*__PROC_ERT_H__*/
@@ -26,6 +26,24 @@
 
 #include <cstdint>
 
+namespace {
+
+/* Pixel tones, 1500Hz black to 2300Hz white. */
+struct LumaTable {
+	uint32_t delta[256];
+};
+
+constexpr LumaTable make_luma_table() {
+	LumaTable table { };
+	for (size_t luma = 0; luma < 256; luma++)
+		table.delta[luma] = SSTV_F2D(1500.0 + luma * (800.0 / 256.0));
+	return table;
+}
+
+constexpr LumaTable luma_table = make_luma_table();
+
+} /* namespace */
+
 // This is called at 3072000/2048 = 1500Hz
 void SSTVTXProcessor::execute(const buffer_c8_t& buffer) {
 	
@@ -33,64 +51,10 @@ void SSTVTXProcessor::execute(const buffer_c8_t& buffer) {
 	
 	for (size_t i = 0; i < buffer.count; i++) {
 		
-		if (!sample_count) {
-			
-			// This FSM is a mess. It seems to do a lot where it shouldn't (I/Q loop),
-			// but it actually doesn't do much. Used for sequencing the different parts
-			// of the scanline. Todo: simplify !
-			
-			if (state == STATE_CALIBRATION) {
-				// Once per picture
-				tone_delta = calibration_sequence[substep].first;
-				sample_count = calibration_sequence[substep].second;
-				if (substep == 2) {
-					substep = 0;
-					state = STATE_VIS;
-				} else
-					substep++;
-			} else if (state == STATE_VIS) {
-				// Once per picture
-				if (substep == 10) {
-					current_scanline = &scanline_buffer[buffer_flip];
-					buffer_flip ^= 1;
-					// Ask application for a new scanline
-					shared_memory.application_queue.push(sig_message);
-					// Do we have to transmit a start tone ?
-					if (current_scanline->start_tone.duration) {
-						state = STATE_SYNC;
-						tone_delta = current_scanline->start_tone.frequency;
-						sample_count = current_scanline->start_tone.duration;
-					} else {
-						state = STATE_PIXELS;
-						tone_delta = current_scanline->gap_tone.frequency;
-						sample_count = current_scanline->gap_tone.duration;
-					}
-				} else {
-					tone_delta = vis_code_sequence[substep];
-					sample_count = SSTV_MS2S(30);	// A VIS code bit is 30ms
-					substep++;
-				}
-			} else if (state == STATE_SYNC) {
-				// Once per scanline, optional
-				state = STATE_PIXELS;
-				tone_delta = current_scanline->gap_tone.frequency;
-				sample_count = current_scanline->gap_tone.duration;
-			} else if (state == STATE_PIXELS) {
-				// Many times per scanline
-				tone_delta = SSTV_F2D(1500 + ((current_scanline->luma[pixel_index] * 800) / 256));
-				sample_count = pixel_duration;
-				pixel_index++;
-				
-				if (pixel_index >= 320) {
-					// Scanline done, (dirty) state jump
-					pixel_index = 0;
-					state = STATE_VIS;
-					substep = 10;
-				}
-			}
-		} else {
-			sample_count--;
-		}
+		// Segments of no length (no start or gap tone) pass straight through
+		while (!sample_count)
+			next_segment();
+		sample_count--;
 
 		// Tone synth
 		tone_sample = (sine_table_i8[(tone_phase & 0xFF000000U) >> 24]);
@@ -109,6 +73,72 @@ void SSTVTXProcessor::execute(const buffer_c8_t& buffer) {
 	}
 }
 
+/* Sets the tone and length of what comes next: calibration, VIS code,
+ * then per scanline the optional start tone, the gap tone and the pixels.
+ */
+void SSTVTXProcessor::next_segment() {
+	if (state == STATE_CALIBRATION) {
+		// Once per picture
+		tone_delta = calibration_sequence[substep].first;
+		sample_count = calibration_sequence[substep].second;
+		if (substep == 2) {
+			substep = 0;
+			state = STATE_VIS;
+		} else
+			substep++;
+	} else if (state == STATE_VIS) {
+		// Once per picture
+		if (substep == 10) {
+			start_scanline();
+			// Do we have to transmit a start tone ?
+			state = STATE_SYNC;
+			tone_delta = current_scanline->start_tone.frequency;
+			sample_count = current_scanline->start_tone.duration;
+		} else {
+			tone_delta = vis_code_sequence[substep];
+			sample_count = SSTV_MS2S(30);	// A VIS code bit is 30ms
+			substep++;
+		}
+	} else if (state == STATE_SYNC) {
+		// Once per scanline, optional
+		state = STATE_PIXELS;
+		tone_delta = current_scanline->gap_tone.frequency;
+		sample_count = current_scanline->gap_tone.duration;
+	} else if (state == STATE_PIXELS) {
+		// Many times per scanline, the fractions carried so a line is exact
+		tone_delta = luma_table.delta[current_scanline->luma[pixel_index]];
+		pixel_fraction += pixel_duration;
+		sample_count = pixel_fraction >> 16;
+		pixel_fraction &= 0xFFFF;
+		pixel_index++;
+		
+		if (pixel_index >= 320) {
+			// Scanline done, (dirty) state jump
+			end_scanline();
+			pixel_index = 0;
+			state = STATE_VIS;
+			substep = 10;
+		}
+	}
+}
+
+void SSTVTXProcessor::start_scanline() {
+	line_fresh = (lines_written != lines_read);
+	
+	// Late M0: send the last line again, the picture keeps its timing
+	if (line_fresh || !current_scanline)
+		current_scanline = &scanline_buffer[lines_read & 1];
+}
+
+void SSTVTXProcessor::end_scanline() {
+	if (!line_fresh)
+		return;
+	
+	// Its buffer is free, ask the application for the line after next
+	lines_read = lines_read + 1;
+	shared_memory.application_queue.push(sig_message);
+}
+
 void SSTVTXProcessor::on_message(const Message* const msg) {
 	const auto message = *reinterpret_cast<const SSTVConfigureMessage*>(msg);
 	uint8_t vis_code;
@@ -134,16 +164,24 @@ void SSTVTXProcessor::on_message(const Message* const msg) {
 			fm_delta = 9000 * (0xFFFFFFULL / 3072000);	// Fixed bw for now
 			
 			pixel_index = 0;
+			pixel_fraction = 0;
 			sample_count = 0;
 			tone_phase = 0;
 			state = STATE_CALIBRATION;
 			substep = 0;
+			current_scanline = nullptr;
+			lines_written = 0;
+			lines_read = 0;
 			
 			configured = true;
 			break;
 		
 		case Message::ID::FIFOData:
-			memcpy(&scanline_buffer[buffer_flip], static_cast<const FIFODataMessage*>(msg)->data, sizeof(sstv_scanline));
+			// Never more than the two requested, the other buffer is being sent
+			if ((lines_written - lines_read) < 2) {
+				memcpy(&scanline_buffer[lines_written & 1], static_cast<const FIFODataMessage*>(msg)->data, sizeof(sstv_scanline));
+				lines_written = lines_written + 1;
+			}
 			break;
 
 		default:
@@ -61,22 +61,32 @@ private:
 	BasebandThread baseband_thread { 3072000, this, NORMALPRIO + 20, baseband::Direction::Transmit };
 
 	uint32_t vis_code_sequence[10] { };
+	
+	// Two scanlines ahead: the M0 fills one while the other is sent, and
+	// gets a whole line's time to answer. Each count only moves on one side.
 	sstv_scanline scanline_buffer[2] { };
-	uint8_t buffer_flip { 0 }, substep { 0 };
-	uint32_t pixel_duration { };
+	volatile uint32_t lines_written { 0 };
+	volatile uint32_t lines_read { 0 };
+	bool line_fresh { false };
+	uint8_t substep { 0 };
+	uint32_t pixel_duration { };		// Q16 samples
+	uint32_t pixel_fraction { 0 };
 
 	sstv_scanline * current_scanline { };
 	
-	uint8_t pixel_luma { };
 	uint32_t fm_delta { 0 };
 	uint32_t tone_phase { 0 };
 	uint32_t tone_delta { 0 };
-    uint32_t pixel_index { 0 };
-    uint32_t sample_count { 0 };
+	uint32_t pixel_index { 0 };
+	uint32_t sample_count { 0 };
 	uint32_t phase { 0 }, sphase { 0 };
 	int32_t tone_sample { 0 }, delta { 0 };
 	int8_t re { }, im { };
 	
+	void next_segment();
+	void start_scanline();
+	void end_scanline();
+	
 	RequestSignalMessage sig_message { RequestSignalMessage::Signal::FillRequest };
 };
 
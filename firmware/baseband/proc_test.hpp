@@ -63,7 +63,7 @@ private:
 
 	dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0 { };
 	dsp::decimate::FIRC16xR16x32Decim8 decim_1 { };
-	dsp::matched_filter::MatchedFilter mf { baseband::ais::square_taps_38k4_1t_p, 2 };
+	dsp::matched_filter::MatchedFilterQ15<baseband::ais::square_taps_38k4_1t_p.size()> mf { baseband::ais::square_taps_38k4_1t_p, 2 };
 
 	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery_fsk_9600 {
 		38400, 19192, { 0.00555f },
@@ -79,6 +79,7 @@ private:
 		[this](const baseband::Packet& packet) {
 			const TestAppPacketMessage message { packet };
 			shared_memory.application_queue.push(message);
+			count_decode();
 		}
 	};
 };
@@ -25,113 +25,154 @@
 #include "event_m4.hpp"
 
 #include <cstdint>
+#include <algorithm>
+
+TonesProcessor::TonesProcessor() {
+	modulator.configure(interpolation);
+}
 
 // This is called at 1536000/2048 = 750Hz
 void TonesProcessor::execute(const buffer_c8_t& buffer) {
 	
 	if (!configured) return;
 	
-	ai = 0;
+	if (keying) {
+		execute_keyer(buffer);
+		return;
+	}
 	
-	for (size_t i = 0; i < buffer.count; i++) {
-		
-		// Tone generation at full samplerate
-		if (silence_count) {
-			// Just occupy channel with carrier
-			silence_count--;
-			if (!silence_count) {
-				sample_count = 0;
-				tone_a_phase = 0;
-				tone_b_phase = 0;
-			}
-			tone_sample = 0;
-			re = 0;
-			im = 0;
-		} else {
-			if (!sample_count) {
-				digit = shared_memory.bb_data.tones_data.message[digit_pos];
-				if (digit_pos >= message_length) {
-					configured = false;
-					txprogress_message.done = true;
-					shared_memory.application_queue.push(txprogress_message);
-					return;
-				} else {
-					txprogress_message.progress = digit_pos;	// Inform UI about progress
-					txprogress_message.done = false;
-					shared_memory.application_queue.push(txprogress_message);
-				}
-				
-				digit_pos++;
-				
-				if (digit >= 32) {	//  || (tone_deltas[digit] == 0)
-					sample_count = shared_memory.bb_data.tones_data.silence;
-				} else {
-					if (!dual_tone) {
-						tone_a_delta = tone_deltas[digit];
-					} else {
-						tone_a_delta = tone_deltas[digit << 1];
-						tone_b_delta = tone_deltas[(digit << 1) + 1];
-					}
-					sample_count = tone_durations[digit];
-				}
-			} else {
-				sample_count--;
-			}
-			
-			// Ugly
-			if ((digit >= 32) || (tone_deltas[digit] == 0)) {
-				tone_sample = 0;
-			} else {
-				if (!dual_tone) {
-					tone_sample = (sine_table_i8[(tone_a_phase & 0xFF000000U) >> 24]);
-					tone_a_phase += tone_a_delta;
-				} else {
-					tone_sample = sine_table_i8[(tone_a_phase & 0xFF000000U) >> 24] >> 1;
-					tone_sample += sine_table_i8[(tone_b_phase & 0xFF000000U) >> 24] >> 1;
-					
-					tone_a_phase += tone_a_delta;
-					tone_b_phase += tone_b_delta;
-				}
-			}
-		
-			// FM
-			delta = tone_sample * fm_delta;
-			
-			phase += delta;
-			sphase = phase + (64 << 24);
+	if (silence_count) {
+		// No carrier, counted off in whole buffers
+		silence_count -= std::min<uint32_t>(silence_count, audio_buffer.count);
+		if (!silence_count) {
+			sample_count = 0;
+			tone_a_phase = 0;
+			tone_b_phase = 0;
+		}
+		std::fill(buffer.p, buffer.p + buffer.count, complex8_t { 0, 0 });
+		return;
+	}
+	
+	for (size_t i = 0; i < audio_buffer.count; i++) {
+		// int8 tones at half scale, as they always were
+		audio_buffer.p[i] = configured ? (next_sample() << 7) : 0;
+	}
+	
+	modulator.execute(audio_buffer, buffer);
+	
+	if (audio_out) audio_output.write(audio_buffer);
+}
 
-			re = (sine_table_i8[(sphase & 0xFF000000U) >> 24]);
-			im = (sine_table_i8[(phase & 0xFF000000U) >> 24]);
+void TonesProcessor::execute_keyer(const buffer_c8_t& buffer) {
+	const uint32_t out = shared_memory.bb_data.tones_data.symbols_out;
+	
+	if (!keyer.execute(audio_buffer)) {
+		configured = false;
+		txprogress_message.done = true;
+		shared_memory.application_queue.push(txprogress_message);
+	} else if (shared_memory.bb_data.tones_data.symbols_out != out) {
+		// A byte taken, inform UI about progress, and to queue more
+		txprogress_message.progress = keyer.units_sent();
+		txprogress_message.done = false;
+		shared_memory.application_queue.push(txprogress_message);
+	}
+	
+	modulator.execute(audio_buffer, buffer);
+	
+	if (audio_out) audio_output.write(audio_buffer);
+}
+
+int32_t TonesProcessor::next_sample() {
+	int32_t tone_sample;
+	
+	if (!sample_count) {
+		auto& tones = shared_memory.bb_data.tones_data;
+		const uint32_t out = tones.symbols_out;
+		if (out == tones.symbols_end) {
+			configured = false;
+			txprogress_message.done = true;
+			shared_memory.application_queue.push(txprogress_message);
+			return 0;
+		}
+		if (out == tones.symbols_in) {
+			// Ran dry, stay quiet until the application catches up
+			digit = 0xFF;
+			return 0;
 		}
 		
-		// Headphone output sample generation: 1536000/24000 = 64
-		if (audio_out) {
-			if (!as) {
-				as = 64;
-				audio_buffer.p[ai++] = tone_sample * 128;
+		digit = tones.symbols[out & ((1U << ToneData::symbols_k) - 1)];
+		// Read before the slot is handed back
+		__DMB();
+		tones.symbols_out = out + 1;
+		
+		txprogress_message.progress = digit_pos;	// Inform UI about progress, and to queue more
+		txprogress_message.done = false;
+		shared_memory.application_queue.push(txprogress_message);
+		
+		digit_pos++;
+		
+		if (digit >= 32) {	//  || (tone_deltas[digit] == 0)
+			sample_count = shared_memory.bb_data.tones_data.silence / interpolation;
+		} else {
+			if (!dual_tone) {
+				tone_a_delta = tone_deltas[digit];
 			} else {
-				as--;
+				tone_a_delta = tone_deltas[digit << 1];
+				tone_b_delta = tone_deltas[(digit << 1) + 1];
 			}
+			sample_count = tone_durations[digit];
 		}
-		
-		buffer.p[i] = {re, im};
+	} else {
+		sample_count--;
 	}
 	
-	if (audio_out) audio_output.write(audio_buffer);
+	// Ugly
+	if ((digit >= 32) || (tone_deltas[digit] == 0)) {
+		tone_sample = 0;
+	} else {
+		if (!dual_tone) {
+			tone_sample = (sine_table_i8[(tone_a_phase & 0xFF000000U) >> 24]);
+			tone_a_phase += tone_a_delta;
+		} else {
+			tone_sample = sine_table_i8[(tone_a_phase & 0xFF000000U) >> 24] >> 1;
+			tone_sample += sine_table_i8[(tone_b_phase & 0xFF000000U) >> 24] >> 1;
+			
+			tone_a_phase += tone_a_delta;
+			tone_b_phase += tone_b_delta;
+		}
+	}
+	
+	return tone_sample;
 }
 
 void TonesProcessor::on_message(const Message* const p) {
+	if (p->id == Message::ID::MorseKeyerConfigure) {
+		const auto message = *reinterpret_cast<const MorseKeyerConfigureMessage*>(p);
+		keyer.configure(message.tone_delta * interpolation, message.unit_samples / interpolation);
+		modulator.modulation().configure(message.fm_delta, baseband_fs);
+		audio_out = message.audio_out;
+		
+		if (audio_out) audio_output.configure(false);
+		
+		txprogress_message.done = false;
+		txprogress_message.progress = 0;
+		
+		keying = true;
+		configured = true;
+		return;
+	}
+	
 	const auto message = *reinterpret_cast<const TonesConfigureMessage*>(p);
 	if (message.id == Message::ID::TonesConfigure) {
-		message_length = message.tone_count;
-		
-		if (message_length) {
-			silence_count = message.pre_silence;		// In samples
+		keying = false;
+		if (message.enabled) {
+			// All in baseband samples, tones are made at the audio rate
+			silence_count = message.pre_silence / interpolation;
 			for (uint8_t c = 0; c < 32; c++) {
-				tone_deltas[c] = shared_memory.bb_data.tones_data.tone_defs[c].delta;
-				tone_durations[c] = shared_memory.bb_data.tones_data.tone_defs[c].duration;
+				tone_deltas[c] = shared_memory.bb_data.tones_data.tone_defs[c].delta * interpolation;
+				tone_durations[c] = shared_memory.bb_data.tones_data.tone_defs[c].duration / interpolation;
 			}
-			fm_delta = message.fm_delta * (0xFFFFFFULL / 1536000);
+			modulator.modulation().configure(message.fm_delta, baseband_fs);
 			audio_out = message.audio_out;
 			dual_tone = message.dual_tone;
 			
@@ -144,7 +185,6 @@ void TonesProcessor::on_message(const Message* const p) {
 			sample_count = 0;
 			tone_a_phase = 0;
 			tone_b_phase = 0;
-			as = 0;
 			
 			configured = true;
 		} else {
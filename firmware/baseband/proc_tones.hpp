@@ -27,43 +27,57 @@
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
 #include "audio_output.hpp"
+#include "dsp_modulate.hpp"
+#include "morse_keyer.hpp"
 
+#include <array>
+
+/* Tones are made at 24kHz and go through a TxModulator's interpolator.
+ * Tone deltas and durations from the app are for the baseband rate.
+ */
 class TonesProcessor : public BasebandProcessor {
 public:
+	TonesProcessor();
+	
 	void execute(const buffer_c8_t& buffer) override;
 	
 	void on_message(const Message* const p) override;
 
 private:
+	static constexpr size_t baseband_fs = 1536000;
+	static constexpr size_t interpolation = 64;
+	
 	bool configured = false;
 	
-	BasebandThread baseband_thread { 1536000, this, NORMALPRIO + 20, baseband::Direction::Transmit };
+	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Transmit };
 	
 	std::array<int16_t, 32> audio { };		// 2048/64
 	const buffer_s16_t audio_buffer {
-		(int16_t*)audio.data(),
-		sizeof(audio) / sizeof(int16_t)
+		audio.data(),
+		audio.size(),
+		baseband_fs / interpolation
 	};
 
 	uint32_t tone_deltas[32];
 	uint32_t tone_durations[32];
 	
+	dsp::modulate::TxModulator<dsp::modulate::FM> modulator { };
+	
 	bool audio_out { false };
 	bool dual_tone { false };
-	uint32_t fm_delta { 0 };
+	bool keying { false };
+	morse::Keyer keyer { };
 	uint32_t tone_a_phase { 0 }, tone_b_phase { 0 };
 	uint32_t tone_a_delta { 0 }, tone_b_delta { 0 };
-    uint8_t digit_pos { 0 };
+    uint32_t digit_pos { 0 };
     uint8_t digit { 0 };
     uint32_t silence_count { 0 }, sample_count { 0 };
-    uint32_t message_length { 0 };
-	uint32_t phase { 0 }, sphase { 0 };
-	int32_t tone_sample { 0 }, delta { 0 };
-	int8_t re { 0 }, im { 0 };
-	uint8_t as { 0 }, ai { 0 };
 	
 	TXProgressMessage txprogress_message { };
 	AudioOutput audio_output { };
+	
+	int32_t next_sample();
+	void execute_keyer(const buffer_c8_t& buffer);
 };
 
 #endif
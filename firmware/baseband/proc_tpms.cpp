@@ -25,7 +25,26 @@
 
 #include "event_m4.hpp"
 
-TPMSProcessor::TPMSProcessor() {
+namespace {
+
+template<size_t... I>
+std::array<OOKClockRecovery, sizeof...(I)> make_ook_clocks(const float sample_rate, std::index_sequence<I...>) {
+	return { { OOKClockRecovery { sample_rate / tpms_clocks[I].symbol_rate }... } };
+}
+
+template<size_t... I>
+std::array<TPMSRecogniser, sizeof...(I)> make_recognisers(std::index_sequence<I...>) {
+	return { { TPMSRecogniser { tpms_protocols[I] }... } };
+}
+
+} /* namespace */
+
+static_assert((tpms_clocks[0].modulation == TPMSModulation::FSK) && (tpms_clocks[0].symbol_rate == 19200.0f), "clock 0 is the 19.2k FSK matched filter");
+
+TPMSProcessor::TPMSProcessor(
+) : ook_clocks(make_ook_clocks(channel_sample_rate, std::make_index_sequence<tpms_clocks.size()>())),
+	recognisers(make_recognisers(std::make_index_sequence<tpms_protocols.size()>()))
+{
 	decim_0.configure(taps_200k_decim_0.taps, 33554432);
 	decim_1.configure(taps_200k_decim_1.taps, 131072);
 }
@@ -49,12 +68,30 @@ void TPMSProcessor::execute(const buffer_c8_t& buffer) {
 		const auto sliced = ook_slicer_5sps(decimator_out.p[i]);
 		slicer_history = (slicer_history << 1) | sliced;
 
-		clock_recovery_ook_8k192(slicer_history, [this](const bool symbol) {
-			this->packet_builder_ook_8k192_schrader.execute(symbol);
-		});
-		clock_recovery_ook_8k4(slicer_history, [this](const bool symbol) {
-			this->packet_builder_ook_8k4_schrader.execute(symbol);
-		});
+		for(size_t c=0; c<tpms_clocks.size(); c++) {
+			if( tpms_clocks[c].modulation == TPMSModulation::OOK ) {
+				ook_clocks[c](slicer_history, [this, c](const bool symbol) {
+					this->consume_symbol(c, symbol);
+				});
+			}
+		}
+	}
+}
+
+void TPMSProcessor::consume_symbol_fsk_19k2(const float raw_symbol) {
+	const uint_fast8_t sliced_symbol = (raw_symbol >= 0.0f) ? 1 : 0;
+	consume_symbol(0, sliced_symbol);
+}
+
+void TPMSProcessor::consume_symbol(const size_t clock, const uint_fast8_t symbol) {
+	auto& word = symbols[clock];
+	if( word.add(symbol) ) {
+		for(auto& recogniser : recognisers) {
+			if( recogniser.clock == clock ) {
+				recogniser.execute(word.word(), word.count());
+			}
+		}
+		word.clear();
 	}
 }
 
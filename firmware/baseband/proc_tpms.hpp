@@ -42,6 +42,8 @@
 #include <cstdint>
 #include <cstddef>
 #include <bitset>
+#include <array>
+#include <utility>
 
 // Translate+rectangular filter
 // sample=307.2k, deviation=38400, symbol=19200
@@ -57,6 +59,79 @@ constexpr std::array<std::complex<float>, 16> rect_taps_307k2_38k4_1t_19k2_p { {
 	{  0.0000000000e+00f, -6.2500000000e-02f }, {  4.4194173824e-02f, -4.4194173824e-02f },
 } };
 
+/* Protocol registry. Each symbol clock is one shared demodulated stream
+ * and clock recovery; every protocol on a clock gets that clock's symbols,
+ * 32 at a time, and only needs its own preamble matcher and packet buffer.
+ * A new sensor type at an existing rate is one more tpms_protocols row.
+ */
+enum class TPMSModulation {
+	FSK,
+	OOK,
+};
+
+struct TPMSSymbolClock {
+	TPMSModulation modulation;
+	float symbol_rate;
+};
+
+// The FSK clock is the 19.2k matched filter below, and has to come first.
+constexpr std::array<TPMSSymbolClock, 3> tpms_clocks { {
+	{ TPMSModulation::FSK, 19200.0f },
+	{ TPMSModulation::OOK, 8192.0f },
+	{ TPMSModulation::OOK, 8400.0f },
+} };
+
+struct TPMSProtocol {
+	tpms::SignalType signal_type;
+	size_t clock;
+	uint64_t preamble;
+	size_t preamble_length;
+	size_t preamble_tolerance;
+	size_t payload_length;
+};
+
+constexpr std::array<TPMSProtocol, 3> tpms_protocols { {
+	{ tpms::SignalType::FSK_19k2_Schrader, 0, 0b010101010101010101010101010110, 30, 1, 160 },
+	/* Preamble: 11*2, 01*14, 11, 10
+	 * Payload: 37 Manchester-encoded bits
+	 * Bit rate: 4096 Hz
+	 */
+	{ tpms::SignalType::OOK_8k192_Schrader, 1, 0b010101010101010101011110, 24, 0, 37 * 2 },
+	/* Preamble: 01*40, 01, 10, 01, 01
+	 * Payload: 76 Manchester-encoded bits
+	 * Bit rate: 4200 Hz
+	 */
+	{ tpms::SignalType::OOK_8k4_Schrader, 2, 0b01010101010101010101010101100101, 32, 0, 76 * 2 },
+} };
+
+class TPMSRecogniser {
+public:
+	TPMSRecogniser(
+		const TPMSProtocol& protocol
+	) : clock { protocol.clock },
+		packet_builder {
+			{ protocol.preamble, protocol.preamble_length, protocol.preamble_tolerance },
+			{ },
+			{ protocol.payload_length },
+			[signal_type = protocol.signal_type](const baseband::Packet& packet) {
+				const TPMSPacketMessage message { signal_type, packet };
+				shared_memory.application_queue.push(message);
+				BasebandProcessor::count_decode();
+			}
+		}
+	{
+	}
+
+	const size_t clock;
+
+	void execute(const uint32_t symbols, const size_t count) {
+		packet_builder.execute(symbols, count);
+	}
+
+private:
+	PacketBuilder<BitPattern, NeverMatch, FixedLength> packet_builder;
+};
+
 class TPMSProcessor : public BasebandProcessor {
 public:
 	TPMSProcessor();
@@ -78,24 +153,15 @@ private:
 	dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0 { };
 	dsp::decimate::FIRC16xR16x16Decim2 decim_1 { };
 
-	dsp::matched_filter::MatchedFilter mf_38k4_1t_19k2 { rect_taps_307k2_38k4_1t_19k2_p, 8 };
+	dsp::matched_filter::MatchedFilterQ15<rect_taps_307k2_38k4_1t_19k2_p.size()> mf_38k4_1t_19k2 { rect_taps_307k2_38k4_1t_19k2_p, 8 };
 
-	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery_fsk_19k2 {
-		38400, 19200, { 0.0555f },
-		[this](const float raw_symbol) {
-			const uint_fast8_t sliced_symbol = (raw_symbol >= 0.0f) ? 1 : 0;
-			this->packet_builder_fsk_19k2_schrader.execute(sliced_symbol);
-		}
-	};
-	PacketBuilder<BitPattern, NeverMatch, FixedLength> packet_builder_fsk_19k2_schrader {
-		{ 0b010101010101010101010101010110, 30, 1 },
-		{ },
-		{ 160 },
-		[this](const baseband::Packet& packet) {
-			const TPMSPacketMessage message { tpms::SignalType::FSK_19k2_Schrader, packet };
-			shared_memory.application_queue.push(message);
-		}
-	};
+	void consume_symbol_fsk_19k2(const float raw_symbol);
+
+	clock_recovery::FixedRateClockRecovery<
+		38400, 19200,
+		clock_recovery::FixedErrorFilter,
+		clock_recovery::MemberSymbolHandler<TPMSProcessor, &TPMSProcessor::consume_symbol_fsk_19k2>
+	> clock_recovery_fsk_19k2 { { 0.0555f }, this };
 
 	static constexpr float channel_rate_in = 307200.0f;
 	static constexpr size_t channel_decimation = 2;
@@ -103,41 +169,12 @@ private:
 	OOKSlicerMagSquaredInt ook_slicer_5sps { channel_sample_rate / 8400 + 1};
 	uint32_t slicer_history { 0 };
 
-	OOKClockRecovery clock_recovery_ook_8k192 {
-		channel_sample_rate / 8192.0f
-	};
-
-	PacketBuilder<BitPattern, NeverMatch, FixedLength> packet_builder_ook_8k192_schrader {
-		/* Preamble: 11*2, 01*14, 11, 10
-		 * Payload: 37 Manchester-encoded bits
-		 * Bit rate: 4096 Hz
-		 */
-		{ 0b010101010101010101011110, 24, 0 },
-		{ },
-		{ 37 * 2 },
-		[](const baseband::Packet& packet) {
-			const TPMSPacketMessage message { tpms::SignalType::OOK_8k192_Schrader, packet };
-			shared_memory.application_queue.push(message);
-		}
-	};
+	// One per clock; the FSK clock's entry is unused.
+	std::array<OOKClockRecovery, tpms_clocks.size()> ook_clocks;
+	std::array<SymbolWord, tpms_clocks.size()> symbols { };
+	std::array<TPMSRecogniser, tpms_protocols.size()> recognisers;
 
-	OOKClockRecovery clock_recovery_ook_8k4 {
-		channel_sample_rate / 8400.0f
-	};
-
-	PacketBuilder<BitPattern, NeverMatch, FixedLength> packet_builder_ook_8k4_schrader {
-		/* Preamble: 01*40, 01, 10, 01, 01
-		 * Payload: 76 Manchester-encoded bits
-		 * Bit rate: 4200 Hz
-		 */
-		{ 0b01010101010101010101010101100101, 32, 0 },
-		{ },
-		{ 76 * 2 },
-		[](const baseband::Packet& packet) {
-			const TPMSPacketMessage message { tpms::SignalType::OOK_8k4_Schrader, packet };
-			shared_memory.application_queue.push(message);
-		}
-	};
+	void consume_symbol(const size_t clock, const uint_fast8_t symbol);
 };
 
 #endif/*__PROC_TPMS_H__*/
@@ -26,6 +26,7 @@
 #include "audio_output.hpp"
 #include "dsp_fft.hpp"
 #include "event_m4.hpp"
+#include "load_shedding.hpp"
 
 #include <cstdint>
 
@@ -60,62 +61,43 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 	 * -> 192kHz int16_t[128] */
 	auto audio_4fs = audio_dec_1.execute(audio_oversampled, work_audio_buffer);
 
+	/* 192kHz int16_t[128], before it is decimated in place
+	 * -> pilot PLL, 38kHz L-R demodulation, 57kHz RDS
+	 * -> 192kHz int16_t[128] L-R */
+	auto side_4fs = mpx.execute(audio_4fs, side_buffer);
+	if( mpx.rds_group_ready() ) {
+		const RDSGroupMessage message { mpx.rds().group(), mpx.rds().valid() };
+		shared_memory.application_queue.push(message);
+	}
+
 	/* 192kHz int16_t[128]
 	 * -> 4th order CIC decimation by 2, gain of 1
 	 * -> 96kHz int16_t[64] */
 	auto audio_2fs = audio_dec_2.execute(audio_4fs, work_audio_buffer);
 	
 	// Input: 96kHz int16_t[64]
-	// audio_spectrum_decimator piles up 256 samples before doing FFT computation
-	// This sends an AudioSpectrum every: sample rate/buffer size/refresh period = 3072000/2048/50 = 30 Hz
-	// When audio_spectrum_timer expires, the audio spectrum computation is triggered
-	
-	// 0~3: feed continuous audio
-	// 4~31: ignore, wrap at 31
-	
+	// audio_spectrum_decimator piles up 256 samples, which are handed to the
+	// event loop thread for the FFT (see post_message). This sends an
+	// AudioSpectrum every: sample rate/buffer size/refresh period = 3072000/2048/50 = 30 Hz,
+	// less while LoadShedding takes it down.
+
 	audio_spectrum_timer++;
-	if (audio_spectrum_timer == 50) {
+	if (audio_spectrum_timer >= (50U << LoadShedding::level())) {
 		audio_spectrum_timer = 0;
-		audio_spectrum_state = FEED;
+		audio_spectrum_feed = true;
 	}
-	
-	switch (audio_spectrum_state) {
-		case FEED:
-			// Convert audio to "complex" just so the FFT can be done :/
-			for (size_t i = 0; i < 64; i++) {
-				complex_audio[i] = { (int16_t)(work_audio_buffer.p[i] / 32), (int16_t)0 };
-			}
-			audio_spectrum_decimator.feed(
-				complex_audio_buffer,
-				[this](const buffer_c16_t& data) {
-					this->post_message(data);
-				}
-			);
-			break;
-		case FFT:
-			// Spread the FFT workload in time to avoid making the audio skip
-			// "8" comes from the log2() of the size of audio_spectrum: log2(256) = 8
-			if (fft_step < 8) {
-				fft_c_preswapped(audio_spectrum, fft_step, fft_step + 1);
-				fft_step++;
-			} else {
-				const size_t spectrum_end = spectrum.db.size();
-				for(size_t i=0; i<spectrum_end; i++) {
-					//const auto corrected_sample = spectrum_window_hamming_3(audio_spectrum, i);
-					const auto corrected_sample = audio_spectrum[i];
-					const auto mag2 = magnitude_squared(corrected_sample * (1.0f / 32768.0f));
-					const float db = mag2_to_dbv_norm(mag2);
-					constexpr float mag_scale = 5.0f;
-					const unsigned int v = (db * mag_scale) + 255.0f;
-					spectrum.db[i] = std::max(0U, std::min(255U, v));
-				}
-				AudioSpectrumMessage message { &spectrum };
-				shared_memory.application_queue.push(message);
-				audio_spectrum_state = IDLE;
+
+	if (audio_spectrum_feed) {
+		// Convert audio to "complex" just so the FFT can be done :/
+		for (size_t i = 0; i < 64; i++) {
+			complex_audio[i] = { (int16_t)(work_audio_buffer.p[i] / 32), (int16_t)0 };
+		}
+		audio_spectrum_decimator.feed(
+			complex_audio_buffer,
+			[this](const buffer_c16_t& data) {
+				this->post_message(data);
 			}
-			break;
-		default:
-			break;
+		);
 	}
 	
 	/* 96kHz int16_t[64]
@@ -123,21 +105,66 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 	 * -> 48kHz int16_t[32] */
 	auto audio = audio_filter.execute(audio_2fs, work_audio_buffer);
 
+	if( stereo_enabled ) {
+		/* L-R takes the same path as L+R: 192kHz -> CIC -> 96kHz -> FIR -> 48kHz int16_t[32] */
+		const auto side_2fs = side_dec.execute(side_4fs, side_buffer);
+		const auto side_audio = side_filter.execute(side_2fs, side_buffer);
+
+		if( mpx.stereo() ) {
+			audio_output.write(audio, side_audio);
+			return;
+		}
+	}
+
 	/* -> 48kHz int16_t[32] */
 	audio_output.write(audio);
 	
 }
 
 void WidebandFMAudio::post_message(const buffer_c16_t& data) {
-	// This is called when audio_spectrum_decimator is filled up to 256 samples
-	fft_swap(data, audio_spectrum);
-	audio_spectrum_state = FFT;
-	fft_step = 0;
+	// Called from baseband processing thread when audio_spectrum_decimator
+	// is filled up to 256 samples. If the last frame is still being
+	// computed, this one is dropped rather than waited for.
+	audio_spectrum_feed = false;
+	if( !audio_spectrum_request_update ) {
+		fft_swap(data, audio_spectrum);
+		audio_spectrum_request_update = true;
+		EventDispatcher::events_flag(EVT_MASK_SPECTRUM);
+	}
+}
+
+void WidebandFMAudio::update_audio_spectrum() {
+	// Called from the event loop thread, which the baseband thread preempts.
+	if( !audio_spectrum_request_update ) {
+		return;
+	}
+
+	fft_c_preswapped(audio_spectrum, 0, 8);
+
+	const size_t spectrum_end = spectrum.db.size();
+	for(size_t i=0; i<spectrum_end; i++) {
+		//const auto corrected_sample = spectrum_window_hamming_3(audio_spectrum, i);
+		const auto corrected_sample = audio_spectrum[i];
+		const int32_t db_q8 = mag2_to_db_q8(magnitude_squared(corrected_sample), 30);
+		constexpr int32_t mag_scale = 5;
+		const int32_t v = ((db_q8 * mag_scale) >> 8) + 255;
+		spectrum.db[i] = std::max(0, std::min(255, v));
+	}
+
+	// The previous frame has been delivered to M0 by the time the next one is
+	// requested (~30Hz), so spectrum can be reused.
+	AudioSpectrumMessage message { &spectrum };
+	shared_memory.application_queue.push(message);
+	audio_spectrum_request_update = false;
 }
 
 void WidebandFMAudio::on_message(const Message* const message) {
 	switch(message->id) {
 	case Message::ID::UpdateSpectrum:
+		channel_spectrum.on_message(message);
+		update_audio_spectrum();
+		break;
+
 	case Message::ID::SpectrumStreamingConfig:
 		channel_spectrum.on_message(message);
 		break;
@@ -171,8 +198,11 @@ void WidebandFMAudio::configure(const WFMConfigureMessage& message) {
 	decim_1.configure(message.decim_1_filter.taps, 131072);
 	channel_filter_pass_f = message.decim_1_filter.pass_frequency_normalized * decim_1_input_fs;
 	channel_filter_stop_f = message.decim_1_filter.stop_frequency_normalized * decim_1_input_fs;
-	demod.configure(demod_input_fs, message.deviation);
+	demod.configure(demod_input_fs, message.deviation, dsp::demodulate::FM::Precision::Precise);
 	audio_filter.configure(message.audio_filter.taps);
+	side_filter.configure(message.audio_filter.taps);
+	mpx.configure(message.stereo);
+	stereo_enabled = message.stereo;
 	audio_output.configure(message.audio_hpf_config, message.audio_deemph_config);
 
 	channel_spectrum.set_decimation_factor(1);
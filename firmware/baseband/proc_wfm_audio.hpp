@@ -25,11 +25,13 @@
 
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
+#include "dsp_iq_correction.hpp"
 #include "rssi_thread.hpp"
 
 #include "dsp_types.hpp"
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
+#include "dsp_mpx.hpp"
 #include "block_decimator.hpp"
 
 #include "audio_output.hpp"
@@ -38,6 +40,7 @@
 class WidebandFMAudio : public BasebandProcessor {
 public:
 	void execute(const buffer_c8_t& buffer) override;
+	void correct_iq(const buffer_c8_t& buffer) override { iq_correction.execute(buffer); }
 
 	void on_message(const Message* const message) override;
 
@@ -45,6 +48,7 @@ private:
 	static constexpr size_t baseband_fs = 3072000;
 	static constexpr auto spectrum_rate_hz = 50.0f;
 
+	IQCorrectionStage iq_correction { };
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 
@@ -75,20 +79,27 @@ private:
 	dsp::decimate::DecimateBy2CIC4Real audio_dec_2 { };
 	dsp::decimate::FIR64AndDecimateBy2Real audio_filter { };
 
+	// Pilot, L-R and RDS, all from the 192kHz MPX
+	dsp::mpx::MPXDecoder mpx { };
+	std::array<int16_t, 128> side { };
+	const buffer_s16_t side_buffer {
+		side.data(),
+		side.size()
+	};
+	dsp::decimate::DecimateBy2CIC4Real side_dec { };
+	dsp::decimate::FIR64AndDecimateBy2Real side_filter { };
+	bool stereo_enabled { false };
+
 	AudioOutput audio_output { };
 	
 	// For fs=96kHz FFT streaming
 	BlockDecimator<complex16_t, 256> audio_spectrum_decimator { 1 };
 	std::array<std::complex<float>, 256> audio_spectrum { };
 	uint32_t audio_spectrum_timer { 0 };
-	enum AudioSpectrumState {
-		IDLE = 0,
-		FEED,
-		FFT
-	};
-	AudioSpectrumState audio_spectrum_state { IDLE };
+	bool audio_spectrum_feed { false };
+	// Handed over to the event loop thread, which computes the FFT
+	volatile bool audio_spectrum_request_update { false };
 	AudioSpectrum spectrum { };
-	uint32_t fft_step { 0 };
 
 	SpectrumCollector channel_spectrum { };
 	size_t spectrum_interval_samples = 0;
@@ -98,6 +109,7 @@ private:
 	void configure(const WFMConfigureMessage& message);
 	void capture_config(const CaptureConfigMessage& message);
 	void post_message(const buffer_c16_t& data);
+	void update_audio_spectrum();
 };
 
 #endif/*__PROC_WFM_AUDIO_H__*/
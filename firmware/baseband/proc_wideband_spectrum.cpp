@@ -22,30 +22,43 @@
 #include "proc_wideband_spectrum.hpp"
 
 #include "event_m4.hpp"
+#include "portapack_shared_memory.hpp"
+
+#include "dsp_wola.hpp"
+#include "dsp_fft.hpp"
+#include "utility.hpp"
 
 #include <cstdint>
 #include <cstddef>
 
 #include <array>
+#include <algorithm>
 
 void WidebandSpectrum::execute(const buffer_c8_t& buffer) {
-	// 2048 complex8_t samples per buffer.
-	// 102.4us per buffer. 20480 instruction cycles per buffer.
+	// 8192 complex8_t samples per buffer.
+	// 409.6us per buffer. 81920 instruction cycles per buffer.
 	
 	if (!configured) return;
 
-	if( phase == 0 ) {
-		std::fill(spectrum.begin(), spectrum.end(), 0);
+	if( (zoom_decimation > 1) && (sweep_state == SweepState::Off) ) {
+		zoom_execute(buffer);
+		return;
 	}
 
-	for(size_t i=0; i<spectrum.size(); i++) {
-		// TODO: Removed window-presum windowing, due to lack of available code RAM.
-		// TODO: Apply window to improve spectrum bin sidelobes.
-		spectrum[i] += buffer.p[i +    0];
-		spectrum[i] += buffer.p[i + 1024];
+	if( buffer.count < unit_samples ) {
+		execute_unit(buffer);
+	}
+	for(size_t offset=0; (offset + unit_samples)<=buffer.count; offset+=unit_samples) {
+		execute_unit({ &buffer.p[offset], unit_samples, buffer.sampling_rate });
 	}
+}
+
+void WidebandSpectrum::execute_unit(const buffer_c8_t& buffer) {
+	if( sweep_state != SweepState::Off ) {
+		sweep_execute(buffer);
+	} else if( phase == trigger ) {
+		presum(buffer);
 
-	if( phase == trigger ) {
 		const buffer_c16_t buffer_c16 {
 			spectrum.data(),
 			spectrum.size(),
@@ -61,6 +74,265 @@ void WidebandSpectrum::execute(const buffer_c8_t& buffer) {
 	}
 }
 
+void WidebandSpectrum::presum(const buffer_c8_t& buffer) {
+	// Windowed presum of the first presum_taps * 256 samples of the buffer.
+	// Only the trigger buffer is folded, adding unrelated buffers together
+	// smears any tone that isn't periodic in the buffer length.
+	if( buffer.count < presum_taps * dsp::wola::fft_size ) return;
+
+	switch(presum_taps) {
+	case 1:	dsp::wola::fold<1>(buffer.p, spectrum);	break;
+	case 2:	dsp::wola::fold<2>(buffer.p, spectrum);	break;
+	default:
+	case 4:	dsp::wola::fold<4>(buffer.p, spectrum);	break;
+	}
+}
+
+void WidebandSpectrum::zoom_config(const SpectrumZoomConfigMessage& message) {
+	// The baseband thread skips zoom while this is 1
+	zoom_decimation = 1;
+	zoom_block.reset();
+
+	size_t decimation = 1;
+	while( ((decimation * 2) <= message.decimation) && (decimation < (2U << zoom_stages_max)) ) {
+		decimation *= 2;
+	}
+	const size_t fft_size = (message.fft_size >= 1024) ? 1024 : 256;
+	while( (decimation > 1) && ((decimation * fft_size) > SpectrumZoomConfigMessage::window_max) ) {
+		decimation /= 2;
+	}
+
+	zoom_nco.configure(message.offset_hz, baseband_fs);
+	zoom_fft_size = fft_size;
+	channel_spectrum.set_block_size((decimation > 1) ? fft_size : 256);
+	// No WOLA presum for zoomed frames
+	channel_spectrum.set_frequency_window(decimation > 1);
+	if( decimation > 1 ) {
+		zoom_block = std::make_unique<complex16_t[]>(fft_size);
+	}
+	phase = 0;
+	zoom_decimation = decimation;
+}
+
+void WidebandSpectrum::zoom_execute(const buffer_c8_t& buffer) {
+	constexpr size_t buffer_units = buffer_samples / unit_samples;
+	const size_t window = zoom_decimation * zoom_fft_size;
+	if( (phase < std::max(trigger, buffer_units)) || (buffer.count < window) ) {
+		phase += buffer.count / unit_samples;
+		return;
+	}
+	phase = 0;
+
+	// spectrum holds one chunk after the NCO stage, the rest halve it in place
+	size_t count = 0;
+	for(size_t offset=0; offset<window; offset+=zoom_chunk_samples) {
+		const auto translated = zoom_nco.execute(
+			{ &buffer.p[offset], zoom_chunk_samples, buffer.sampling_rate },
+			{ spectrum.data(), spectrum.size(), buffer.sampling_rate }
+		);
+		size_t chunk_count = translated.count;
+		uint32_t chunk_fs = translated.sampling_rate;
+		for(size_t stage=0; (2U << stage) < zoom_decimation; stage++) {
+			const buffer_c16_t chunk { spectrum.data(), chunk_count, chunk_fs };
+			const auto halved = zoom_stages[stage].execute(chunk, chunk);
+			chunk_count = halved.count;
+			chunk_fs = halved.sampling_rate;
+		}
+		std::copy(&spectrum[0], &spectrum[chunk_count], &zoom_block[count]);
+		count += chunk_count;
+	}
+
+	channel_spectrum.feed_block({ zoom_block.get(), count, buffer.sampling_rate / zoom_decimation });
+}
+
+void WidebandSpectrum::sweep_execute(const buffer_c8_t& buffer) {
+	switch(sweep_state) {
+	case SweepState::Settling:
+		// Buffers from before and during the retune are mixed or off-frequency
+		if( ++sweep_buffers >= sweep_settle_buffers ) {
+			sweep_buffers = 0;
+			sweep_peak.fill(0);
+			sweep_state = SweepState::Measuring;
+		}
+		break;
+
+	case SweepState::Measuring:
+		presum(buffer);
+		sweep_measure();
+		if( ++sweep_buffers < sweep_ffts_per_slice ) {
+			break;
+		}
+
+		sweep_stitch();
+		sweep_slice++;
+		sweep_state = SweepState::WaitRetune;
+		if( sweep_slice < sweep_slice_count ) {
+			const SweepRetuneMessage message { sweep_slice };
+			shared_memory.application_queue.push(message);
+		} else {
+			// Application retunes to slice 0 when it's done with the data
+			sweep_slice = 0;
+			sweep_spectrum->slice_count = sweep_slice_count;
+			sweep_spectrum->mean = sweep_sum / (sweep_slice_count * SweepSpectrum::bins_per_slice);
+			sweep_spectrum->sequence++;
+			const SweepSpectrumMessage message { sweep_spectrum };
+			shared_memory.application_queue.push(message);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void WidebandSpectrum::sweep_measure() {
+	fft_q15_radix4(spectrum, sweep_fft);
+
+	// Same scale as SpectrumCollector, undoing the Q15 FFT's 1/N: full
+	// scale is 2^30 of power, less N^2.
+	constexpr int32_t full_scale_log2 = 30 - 2 * log_2(std::tuple_size<decltype(sweep_fft)>::value);
+	for(size_t i=0; i<sweep_fft.size(); i++) {
+		const int32_t re = sweep_fft[i].real();
+		const int32_t im = sweep_fft[i].imag();
+		const uint32_t mag2 = static_cast<uint32_t>(re * re) + static_cast<uint32_t>(im * im);
+		const int32_t db_q8 = mag2_to_db_q8(mag2, full_scale_log2);
+		constexpr int32_t mag_scale = 5;
+		const int32_t v = std::max(0, ((db_q8 * mag_scale) >> 8) + 255);
+		sweep_peak[i] = std::max<uint8_t>(sweep_peak[i], std::min(255, v));
+	}
+}
+
+void WidebandSpectrum::sweep_stitch() {
+	// Reorder to ascending frequency and keep the middle bins_per_slice;
+	// the outer bins are in the baseband filter's roll-off.
+	constexpr size_t bins = SweepSpectrum::bins_per_slice;
+	constexpr size_t first_bin = (256 - bins) / 2;
+	auto dst = &sweep_spectrum->db[sweep_slice * bins];
+	for(size_t i=0; i<bins; i++) {
+		dst[i] = sweep_peak[(first_bin + i + 128) & 255];
+	}
+
+	// Replace the DC spike (and LO leakage either side) with a line between
+	// its neighbours. Signals within ~60kHz of a slice centre are lost.
+	constexpr size_t dc = 128 - first_bin;
+	constexpr size_t dc_half_width = 6;
+	const int32_t left = dst[dc - dc_half_width - 1];
+	const int32_t right = dst[dc + dc_half_width];
+	constexpr int32_t span = 2 * dc_half_width + 1;
+	for(int32_t i=1; i<span; i++) {
+		dst[dc - dc_half_width - 1 + i] = left + ((right - left) * i) / span;
+	}
+
+	if( sweep_slice == 0 ) {
+		sweep_spectrum->detection_count = 0;
+		sweep_spectrum->max = 0;
+		sweep_sum = 0;
+	}
+	sweep_detect(dst, sweep_slice * bins);
+}
+
+void WidebandSpectrum::sweep_detect(const uint8_t* const db, const size_t offset) {
+	constexpr size_t bins = SweepSpectrum::bins_per_slice;
+
+	uint8_t max = sweep_spectrum->max;
+	sweep_sums[0] = 0;
+	for(size_t i=0; i<bins; i++) {
+		sweep_sums[i + 1] = sweep_sums[i] + db[i];
+		max = std::max(max, db[i]);
+	}
+	sweep_spectrum->max = max;
+	sweep_sum += sweep_sums[bins];
+
+	// Mean of bins [first, last), or 255 (never the smallest) if empty.
+	const auto window_mean = [this](const size_t first, const size_t last) -> uint32_t {
+		return (last > first) ? (sweep_sums[last] - sweep_sums[first]) / (last - first) : 255;
+	};
+
+	SweepSpectrum::Detection run { };
+	bool in_run = false;
+	uint32_t run_threshold = 0;
+	size_t gap = 0;
+	for(size_t i=0; i<bins; i++) {
+		// Windows are cut short at slice edges
+		const size_t left_last = (i > cfar_guard) ? (i - cfar_guard) : 0;
+		const size_t left_first = (left_last > cfar_reference) ? (left_last - cfar_reference) : 0;
+		const size_t right_first = std::min(i + cfar_guard + 1, bins);
+		const size_t right_last = std::min(right_first + cfar_reference, bins);
+		const uint32_t noise = std::min(window_mean(left_first, left_last), window_mean(right_first, right_last));
+		uint32_t threshold = noise + sweep_threshold;
+		if( in_run ) {
+			// A wide signal fills the reference windows of its middle bins,
+			// hold the level found at its leading edge
+			threshold = std::min(threshold, run_threshold);
+		}
+
+		if( db[i] >= threshold ) {
+			const uint16_t bin = offset + i;
+			if( !in_run ) {
+				run = { bin, bin, 1, db[i] };
+				in_run = true;
+				run_threshold = threshold;
+			} else {
+				run.width = bin - run.first + 1;
+				if( db[i] > run.power ) {
+					run.bin = bin;
+					run.power = db[i];
+				}
+			}
+			gap = 0;
+		} else if( in_run && (++gap > cfar_guard) ) {
+			sweep_add_detection(run);
+			in_run = false;
+		}
+	}
+	if( in_run ) {
+		sweep_add_detection(run);
+	}
+}
+
+void WidebandSpectrum::sweep_add_detection(const SweepSpectrum::Detection& detection) {
+	auto& detections = sweep_spectrum->detections;
+	auto& count = sweep_spectrum->detection_count;
+	if( count < detections.size() ) {
+		detections[count++] = detection;
+		return;
+	}
+
+	// Full, keep the strongest
+	auto weakest = std::min_element(detections.begin(), detections.end(),
+		[](const SweepSpectrum::Detection& a, const SweepSpectrum::Detection& b) {
+			return a.power < b.power;
+		}
+	);
+	if( detection.power > weakest->power ) {
+		*weakest = detection;
+	}
+}
+
+void WidebandSpectrum::sweep_config(const SweepConfigMessage& message) {
+	if( (message.slice_count == 0) || (message.spectrum == nullptr) ) {
+		sweep_state = SweepState::Off;
+		return;
+	}
+
+	sweep_spectrum = message.spectrum;
+	sweep_slice_count = std::min<uint32_t>(message.slice_count, SweepSpectrum::slices_max);
+	sweep_settle_buffers = message.settle_buffers;
+	sweep_ffts_per_slice = std::max<uint32_t>(message.ffts_per_slice, 1);
+	sweep_threshold = message.threshold;
+	sweep_slice = 0;
+	sweep_buffers = 0;
+	// Application is already tuned to slice 0
+	sweep_state = SweepState::Settling;
+}
+
+void WidebandSpectrum::sweep_retuned(const SweepRetunedMessage& message) {
+	if( (sweep_state == SweepState::WaitRetune) && (message.slice == sweep_slice) ) {
+		sweep_buffers = 0;
+		sweep_state = SweepState::Settling;
+	}
+}
+
 void WidebandSpectrum::on_message(const Message* const msg) {
 	const WidebandSpectrumConfigMessage message = *reinterpret_cast<const WidebandSpectrumConfigMessage*>(msg);
 	
@@ -73,11 +345,25 @@ void WidebandSpectrum::on_message(const Message* const msg) {
 	case Message::ID::WidebandSpectrumConfig:
 		baseband_fs = message.sampling_rate;
 		trigger = message.trigger;
+		presum_taps = message.presum_taps;
 		baseband_thread.set_sampling_rate(baseband_fs);
+		channel_spectrum.set_frequency_window(zoom_decimation > 1);
 		phase = 0;
 		configured = true;
 		break;
 
+	case Message::ID::SpectrumZoomConfig:
+		zoom_config(*reinterpret_cast<const SpectrumZoomConfigMessage*>(msg));
+		break;
+
+	case Message::ID::SweepConfig:
+		sweep_config(*reinterpret_cast<const SweepConfigMessage*>(msg));
+		break;
+
+	case Message::ID::SweepRetuned:
+		sweep_retuned(*reinterpret_cast<const SweepRetunedMessage*>(msg));
+		break;
+
 	default:
 		break;
 	}
@@ -24,19 +24,23 @@
 
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
+#include "dsp_iq_correction.hpp"
 #include "rssi_thread.hpp"
 
 #include "spectrum_collector.hpp"
+#include "dsp_decimate.hpp"
 
 #include "message.hpp"
 
 #include <cstddef>
 #include <array>
 #include <complex>
+#include <memory>
 
 class WidebandSpectrum : public BasebandProcessor {
 public:
 	void execute(const buffer_c8_t& buffer) override;
+	void correct_iq(const buffer_c8_t& buffer) override { iq_correction.execute(buffer); }
 
 	void on_message(const Message* const message) override;
 
@@ -45,7 +49,19 @@ private:
 	
 	size_t baseband_fs = 20000000;
 
-	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20 };
+	/* Large buffers for a fraction of the per-buffer overhead at 20MHz;
+	 * 3 * 8192 samples is 48KiB. Each is processed as the 2048 sample units
+	 * the application's trigger, settle and FFT counts are in.
+	 */
+	static constexpr size_t buffer_count = 3;
+	static constexpr size_t buffer_samples = 8192;
+	static constexpr size_t unit_samples = 2048;
+
+	IQCorrectionStage iq_correction { };
+	BasebandThread baseband_thread {
+		baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive,
+		buffer_count, buffer_samples
+	};
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 
 	SpectrumCollector channel_spectrum { };
@@ -53,6 +69,60 @@ private:
 	std::array<complex16_t, 256> spectrum { };
 
 	size_t phase = 0, trigger = 127;
+	size_t presum_taps = 4;
+
+	/* Zoom, see SpectrumZoomConfigMessage. A frame takes the start of a
+	 * whole buffer: the NCO stage decimates by two, each further stage by
+	 * two again. Up to 8192 samples through the NCO cost about a buffer's
+	 * time, so at least one buffer goes by between frames.
+	 */
+	static constexpr size_t zoom_chunk_samples = 512;
+	static constexpr size_t zoom_stages_max = 4;
+	size_t zoom_decimation { 1 };
+	size_t zoom_fft_size { 256 };
+	dsp::decimate::NCOTranslateAndDecimateBy2CIC3 zoom_nco { };
+	std::array<dsp::decimate::DecimateBy2CIC3, zoom_stages_max> zoom_stages { };
+	std::unique_ptr<complex16_t[]> zoom_block { };
+
+	enum class SweepState {
+		Off,
+		WaitRetune,
+		Settling,
+		Measuring,
+	};
+
+	SweepState sweep_state { SweepState::Off };
+	SweepSpectrum* sweep_spectrum { nullptr };
+	uint32_t sweep_slice_count { 0 };
+	uint32_t sweep_settle_buffers { 0 };
+	uint32_t sweep_ffts_per_slice { 1 };
+	uint32_t sweep_slice { 0 };
+	uint32_t sweep_buffers { 0 };
+	uint32_t sweep_threshold { 80 };
+	std::array<complex16_t, 256> sweep_fft { };
+	std::array<uint8_t, 256> sweep_peak { };
+
+	// CA-CFAR, "smallest of" the two reference windows so a signal's
+	// neighbour doesn't hide it. In bins.
+	static constexpr size_t cfar_guard = 3;
+	static constexpr size_t cfar_reference = 12;
+	// 240 * 255 fits
+	std::array<uint16_t, SweepSpectrum::bins_per_slice + 1> sweep_sums { };
+	uint32_t sweep_sum { 0 };
+
+	void execute_unit(const buffer_c8_t& buffer);
+	void presum(const buffer_c8_t& buffer);
+
+	void zoom_config(const SpectrumZoomConfigMessage& message);
+	void zoom_execute(const buffer_c8_t& buffer);
+
+	void sweep_config(const SweepConfigMessage& message);
+	void sweep_retuned(const SweepRetunedMessage& message);
+	void sweep_execute(const buffer_c8_t& buffer);
+	void sweep_measure();
+	void sweep_stitch();
+	void sweep_detect(const uint8_t* const db, const size_t offset);
+	void sweep_add_detection(const SweepSpectrum::Detection& detection);
 };
 
 #endif/*__PROC_WIDEBAND_SPECTRUM_H__*/
@@ -24,12 +24,19 @@
 
 #include "rssi.hpp"
 #include "message.hpp"
+#include "portapack_shared_memory.hpp"
+
+#include "hal.h"
 
 #include <cstdint>
 #include <cstddef>
 
 class RSSIStatisticsCollector {
 public:
+	void set_update_interval_ms(const uint32_t interval_ms) {
+		update_interval_ms = interval_ms;
+	}
+
 	template<typename Callback>
 	void process(const rf::rssi::buffer_t& buffer, Callback callback) {
 		auto p = buffer.p;
@@ -58,7 +65,7 @@ public:
 		}
 		statistics.count += buffer.count;
 
-		const size_t samples_per_update = buffer.sampling_rate * update_interval;
+		const size_t samples_per_update = buffer.sampling_rate / 1000 * update_interval_ms;
 
 		if( statistics.count >= samples_per_update ) {
 			callback(statistics);
@@ -68,8 +75,94 @@ public:
 	}
 
 private:
-	static constexpr float update_interval { 0.1f };
+	uint32_t update_interval_ms { 100 };
 	RSSIStatistics statistics { };
 };
 
+/* Fills shared_memory.rssi (see RSSITable) from every sample: the peak
+ * hold, the decimated history ring, and bursts, which start at a sample
+ * at or above burst_threshold and end at the first one burst_hysteresis
+ * below it.
+ */
+class RSSIBurstCollector {
+public:
+	RSSIBurstCollector(
+		RSSITable& table,
+		const uint32_t sampling_rate
+	) : table { table }
+	{
+		table.peak_hold = 0;
+		table.history_count = 0;
+		table.burst_count = 0;
+		table.sampling_rate = sampling_rate;
+		peak_sequence_seen = table.peak_sequence;
+	}
+
+	void process(const rf::rssi::buffer_t& buffer) {
+		auto p = buffer.p;
+		if( p == nullptr ) {
+			return;
+		}
+
+		uint32_t peak = table.peak_hold;
+		if( table.peak_sequence != peak_sequence_seen ) {
+			peak_sequence_seen = table.peak_sequence;
+			peak = 0;
+		}
+		const uint32_t decimation = table.history_decimation ? table.history_decimation : 1;
+		const uint32_t threshold = table.burst_threshold;
+		if( threshold == 0 ) {
+			in_burst = false;
+		}
+
+		for(size_t i=0; i<buffer.count; i++) {
+			const uint32_t value = p[i];
+			if( peak < value ) {
+				peak = value;
+			}
+
+			if( history_max < value ) {
+				history_max = value;
+			}
+			if( ++history_samples >= decimation ) {
+				table.history[table.history_count & ((1U << RSSITable::history_k) - 1)] = history_max;
+				__DMB();
+				table.history_count = table.history_count + 1;
+				history_max = 0;
+				history_samples = 0;
+			}
+
+			if( in_burst ) {
+				if( burst.peak < value ) {
+					burst.peak = value;
+				}
+				if( value + burst_hysteresis < threshold ) {
+					burst.length = samples + i - burst.start;
+					table.bursts[table.burst_count % RSSITable::bursts_max] = burst;
+					__DMB();
+					table.burst_count = table.burst_count + 1;
+					in_burst = false;
+				}
+			} else if( threshold && (value >= threshold) ) {
+				burst = { samples + i, 0, value };
+				in_burst = true;
+			}
+		}
+
+		samples += buffer.count;
+		table.peak_hold = peak;
+	}
+
+private:
+	static constexpr uint32_t burst_hysteresis = 4;
+
+	RSSITable& table;
+	uint32_t peak_sequence_seen { 0 };
+	uint32_t samples { 0 };
+	uint32_t history_max { 0 };
+	uint32_t history_samples { 0 };
+	bool in_burst { false };
+	RSSIBurst burst { };
+};
+
 #endif/*__RSSI_STATS_COLLECTOR_H__*/
@@ -28,7 +28,7 @@
 #include "message.hpp"
 #include "portapack_shared_memory.hpp"
 
-WORKING_AREA(rssi_thread_wa, 128);
+WORKING_AREA(rssi_thread_wa, 256);
 
 Thread* RSSIThread::thread = nullptr;
 
@@ -46,10 +46,13 @@ RSSIThread::~RSSIThread() {
 }
 
 void RSSIThread::run() {
+	chRegSetThreadName("rssi");
+
 	rf::rssi::init();
 	rf::rssi::dma::allocate(4, 400);
 
 	RSSIStatisticsCollector stats;
+	RSSIBurstCollector bursts { shared_memory.rssi, sampling_rate };
 
 	rf::rssi::start();
 
@@ -60,6 +63,8 @@ void RSSIThread::run() {
 			buffer_tmp.p, buffer_tmp.count, sampling_rate
 		};
 
+		bursts.process(buffer);
+		stats.set_update_interval_ms(shared_memory.rssi.statistics_interval_ms);
 		stats.process(
 			buffer,
 			[](const RSSIStatistics& statistics) {
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "rx_gain_control.hpp"
+
+#include "portapack_shared_memory.hpp"
+#include "utility.hpp"
+
+#include <hal.h>
+
+#include <algorithm>
+#include <cmath>
+
+void RxGainControl::configure(const RxGainControlMessage& message) {
+	if( !message.enabled ) {
+		*this = { };
+		return;
+	}
+
+	if( !enabled ) {
+		*this = { };
+		enabled = true;
+	}
+
+	// Whatever was asked for has been dealt with.
+	pending = false;
+	waiting_for = 0;
+	holdoff = holdoff_ms / window_ms;
+	digital_db = std::max(std::min(digital_db - message.applied_db, digital_db_max), -digital_db_max);
+}
+
+void RxGainControl::execute(const buffer_c8_t& buffer) {
+	if( !enabled ) {
+		return;
+	}
+
+	measure(buffer);
+	if( window_samples >= samples(buffer.sampling_rate, window_ms) ) {
+		decide();
+	}
+
+	if( digital_db != 0.0f ) {
+		apply(buffer);
+
+		const float fade_db = fade_db_per_s * buffer.count / buffer.sampling_rate;
+		digital_db = (std::abs(digital_db) <= fade_db) ? 0.0f
+			: (digital_db - ((digital_db > 0.0f) ? fade_db : -fade_db));
+	}
+}
+
+void RxGainControl::measure(const buffer_c8_t& buffer) {
+	// Two samples a word: byte lane maxima and minima by GE flags and SEL,
+	// I^2 + Q^2 by sign extended halves.
+	const uint32_t* p = reinterpret_cast<const uint32_t*>(buffer.p);
+	const uint32_t* const end = reinterpret_cast<const uint32_t*>(&buffer.p[buffer.count & ~1U]);
+	uint32_t lane_max = 0x80808080;
+	uint32_t lane_min = 0x7f7f7f7f;
+	uint32_t power = 0;
+	while(p < end) {
+		const uint32_t q1_i1_q0_i0 = *(p++);
+		__SSUB8(q1_i1_q0_i0, lane_max);
+		lane_max = __SEL(q1_i1_q0_i0, lane_max);
+		__SSUB8(q1_i1_q0_i0, lane_min);
+		lane_min = __SEL(lane_min, q1_i1_q0_i0);
+
+		const uint32_t i1_i0 = __SXTB16(q1_i1_q0_i0, 0);
+		const uint32_t q1_q0 = __SXTB16(q1_i1_q0_i0, 8);
+		power = __SMLAD(i1_i0, i1_i0, power);
+		power = __SMLAD(q1_q0, q1_q0, power);
+	}
+
+	for(size_t n=0; n<4; n++) {
+		const int32_t high = static_cast<int8_t>(lane_max >> (n * 8));
+		const int32_t low = static_cast<int8_t>(lane_min >> (n * 8));
+		window_peak = std::max(window_peak, static_cast<uint32_t>(std::max(high, -low)));
+	}
+	window_power += power;
+	window_samples += buffer.count & ~1U;
+}
+
+void RxGainControl::decide() {
+	const uint32_t peak = window_peak;
+	const float rms_db = mag2_to_dbv_norm(window_power * (1.0f / (127.0f * 127.0f)) / window_samples);
+	window_samples = 0;
+	window_peak = 0;
+	window_power = 0;
+
+	quiet_for = (peak < quiet_peak) ? (quiet_for + 1) : 0;
+	if( holdoff ) {
+		holdoff--;
+	}
+
+	if( pending ) {
+		// Lost, or the app has gone; ask again when it next matters.
+		if( ++waiting_for >= (reply_timeout_ms / window_ms) ) {
+			pending = false;
+			waiting_for = 0;
+		}
+		return;
+	}
+
+	int8_t direction = 0;
+	if( (peak >= clip_peak) || (rms_db >= hot_rms_db) ) {
+		direction = -1;
+	} else if( quiet_for >= (release_ms / window_ms) ) {
+		direction = 1;
+	}
+
+	if( (direction == 0) || holdoff ) {
+		return;
+	}
+
+	const float peak_db = mag2_to_dbv_norm(peak * peak * (1.0f / (127.0f * 127.0f)));
+	const RxGainStepMessage message {
+		direction,
+		static_cast<int8_t>(std::max(peak_db, -128.0f)),
+		static_cast<int8_t>(std::max(rms_db, -128.0f))
+	};
+	shared_memory.application_queue.push(message);
+
+	pending = true;
+	quiet_for = 0;
+}
+
+void RxGainControl::apply(const buffer_c8_t& buffer) {
+	const int32_t gain_q8 = std::pow(10.0f, digital_db / 20.0f) * 256.0f;
+	for(size_t i=0; i<buffer.count; i++) {
+		const auto s = buffer.p[i];
+		buffer.p[i] = {
+			static_cast<int8_t>(__SSAT((s.real() * gain_q8) >> 8, 8)),
+			static_cast<int8_t>(__SSAT((s.imag() * gain_q8) >> 8, 8))
+		};
+	}
+}
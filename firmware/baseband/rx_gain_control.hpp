@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __RX_GAIN_CONTROL_H__
+#define __RX_GAIN_CONTROL_H__
+
+#include "message.hpp"
+#include "dsp_types.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+/* Closed loop receive gain for the packet decoders, on the raw baseband
+ * ahead of any decimation. Each 10ms window's peak and mean power decide
+ * on a MAX2837 step, asked of the M0 by RxGainStepMessage: down at once
+ * when the ADC clips or runs hot, up only once the peak has stayed a
+ * step and 6dB clear of clipping for a second, and only one step in
+ * flight, with a holdoff after each. That margin is the hysteresis which
+ * keeps a steady signal from trading steps.
+ *
+ * The M0 answers with the change it made, and the opposite digital gain
+ * takes it straight back out of the samples, fading to nothing at 40dB/s,
+ * so slicer thresholds and clock recovery mid-packet see no jump. The
+ * fade costs a multiply per sample, the measurement a few SIMD ops per
+ * two samples.
+ */
+class RxGainControl {
+public:
+	void configure(const RxGainControlMessage& message);
+
+	/* Measures buffer as received, then applies the digital gain in place. */
+	void execute(const buffer_c8_t& buffer);
+
+private:
+	static constexpr int32_t window_ms = 10;
+	static constexpr int32_t release_ms = 1000;
+	static constexpr int32_t holdoff_ms = 100;
+	static constexpr int32_t reply_timeout_ms = 500;
+	static constexpr float fade_db_per_s = 40.0f;
+	static constexpr float digital_db_max = 24.0f;
+
+	// Of 127, per component: -0.5dBFS, and -14dBFS to go up by 8dB.
+	static constexpr uint32_t clip_peak = 120;
+	static constexpr uint32_t quiet_peak = 25;
+	static constexpr float hot_rms_db = -6.0f;
+
+	bool enabled { false };
+	bool pending { false };
+	float digital_db { 0.0f };
+
+	uint32_t window_samples { 0 };
+	uint32_t window_peak { 0 };
+	uint64_t window_power { 0 };
+
+	// In windows.
+	uint32_t quiet_for { 0 };
+	uint32_t holdoff { 0 };
+	uint32_t waiting_for { 0 };
+
+	void measure(const buffer_c8_t& buffer);
+	void decide();
+	void apply(const buffer_c8_t& buffer);
+
+	static constexpr uint32_t samples(const uint32_t sampling_rate, const int32_t ms) {
+		return static_cast<uint64_t>(sampling_rate) * ms / 1000;
+	}
+};
+
+#endif/*__RX_GAIN_CONTROL_H__*/
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "sample_generator.hpp"
+
+#include <algorithm>
+
+static uint32_t phase_step(const int64_t frequency, const uint32_t sampling_rate) {
+	return static_cast<uint32_t>((frequency * (INT64_C(1) << 32)) / static_cast<int64_t>(sampling_rate));
+}
+
+static int8_t clip(const int32_t value) {
+	return std::max(-127, std::min(127, static_cast<int>(value)));
+}
+
+void SampleGenerator::configure(const SyntheticSourceConfig& new_config, const uint32_t sampling_rate) {
+	config = new_config;
+	config.pattern_length = std::min(config.pattern_length, static_cast<uint16_t>(config.pattern.size() * 8));
+
+	samples_left = static_cast<uint64_t>(config.seconds) * sampling_rate;
+	phase = 0;
+	step_centre = phase_step(config.frequency, sampling_rate);
+	step_mark = phase_step(static_cast<int64_t>(config.frequency) + config.deviation, sampling_rate);
+	step_space = phase_step(static_cast<int64_t>(config.frequency) - config.deviation, sampling_rate);
+	symbol_phase = 0;
+	symbol_step = (static_cast<uint64_t>(config.symbol_rate) << 32) / sampling_rate;
+	// At least a sample, so a packet always starts on a clean symbol clock.
+	gap_samples = std::max(static_cast<uint64_t>(1), (static_cast<uint64_t>(config.gap_ms) * sampling_rate) / 1000);
+	gap_left = gap_samples;
+	bit_index = 0;
+	packet_count = 0;
+	// xorshift32 sticks at zero.
+	rng = config.seed ? config.seed : 1;
+}
+
+bool SampleGenerator::execute(const buffer_c8_t& dst) {
+	if( config.seconds ) {
+		if( samples_left < dst.count ) {
+			return false;
+		}
+		samples_left -= dst.count;
+	}
+
+	const bool packets = (config.mode == SyntheticSourceConfig::Mode::FSK)
+		|| (config.mode == SyntheticSourceConfig::Mode::OOK);
+	const bool sending = packets && (config.pattern_length > 0) && (symbol_step > 0);
+
+	for(size_t i=0; i<dst.count; i++) {
+		complex8_t signal { 0, 0 };
+		if( config.mode == SyntheticSourceConfig::Mode::Tone ) {
+			signal = carrier[phase];
+			phase += step_centre;
+		} else if( sending ) {
+			signal = packet_sample();
+		}
+
+		int32_t re = (signal.real() * config.amplitude) >> 7;
+		int32_t im = (signal.imag() * config.amplitude) >> 7;
+		if( config.noise ) {
+			re += noise_sample();
+			im += noise_sample();
+		}
+		dst.p[i] = { clip(re), clip(im) };
+	}
+
+	return true;
+}
+
+complex8_t SampleGenerator::packet_sample() {
+	if( gap_left ) {
+		gap_left--;
+		return { 0, 0 };
+	}
+
+	const bool bit = pattern_bit(bit_index);
+	complex8_t result { 0, 0 };
+	if( config.mode == SyntheticSourceConfig::Mode::FSK ) {
+		phase += bit ? step_mark : step_space;
+		result = carrier[phase];
+	} else {
+		phase += step_centre;
+		result = bit ? carrier[phase] : complex8_t { 0, 0 };
+	}
+
+	const uint32_t symbol_phase_last = symbol_phase;
+	symbol_phase += symbol_step;
+	if( symbol_phase < symbol_phase_last ) {
+		if( ++bit_index == config.pattern_length ) {
+			bit_index = 0;
+			symbol_phase = 0;
+			gap_left = gap_samples;
+			packet_count++;
+		}
+	}
+
+	return result;
+}
+
+int32_t SampleGenerator::noise_sample() {
+	// Sum of four uniform bytes: near enough gaussian, sigma 0.58 noise.
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	const int32_t sum = static_cast<int8_t>(rng) + static_cast<int8_t>(rng >> 8)
+		+ static_cast<int8_t>(rng >> 16) + static_cast<int8_t>(rng >> 24);
+	return (sum * config.noise) >> 8;
+}
+
+bool SampleGenerator::pattern_bit(const size_t index) const {
+	return (config.pattern[index >> 3] >> (7 - (index & 7))) & 1;
+}
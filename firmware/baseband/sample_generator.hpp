@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SAMPLE_GENERATOR_H__
+#define __SAMPLE_GENERATOR_H__
+
+#include "message.hpp"
+#include "dsp_types.hpp"
+#include "sine_table_c8.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+/* Makes the complex8 baseband of a SyntheticSourceConfig, the same samples
+ * for the same config and sampling rate every time, a buffer at a time.
+ */
+class SampleGenerator {
+public:
+	void configure(const SyntheticSourceConfig& new_config, const uint32_t sampling_rate);
+
+	/* Fills all of dst; false, leaving it unfilled, once the config's
+	 * seconds of samples are out.
+	 */
+	bool execute(const buffer_c8_t& dst);
+
+	/* Packets sent in full since configure(). */
+	uint32_t packets() const {
+		return packet_count;
+	}
+
+private:
+	const ComplexSineTableI8 carrier { };
+	SyntheticSourceConfig config { };
+
+	uint64_t samples_left { 0 };
+	uint32_t phase { 0 };
+	uint32_t step_centre { 0 };
+	uint32_t step_mark { 0 };
+	uint32_t step_space { 0 };
+	uint32_t symbol_phase { 0 };
+	uint32_t symbol_step { 0 };
+	uint32_t gap_samples { 0 };
+	uint32_t gap_left { 0 };
+	size_t bit_index { 0 };
+	uint32_t packet_count { 0 };
+	uint32_t rng { 1 };
+
+	complex8_t packet_sample();
+	int32_t noise_sample();
+	bool pattern_bit(const size_t index) const;
+};
+
+#endif/*__SAMPLE_GENERATOR_H__*/
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2018 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SCAN_DWELL_COLLECTOR_H__
+#define __SCAN_DWELL_COLLECTOR_H__
+
+#include "dsp_types.hpp"
+#include "dsp_squelch.hpp"
+#include "channel_stats_collector.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <algorithm>
+
+/* Per-hop busy/clear detector for the scanner. Idle until configured after
+ * each retune; then, once settle_buffers have gone by, reports busy from
+ * the first buffer whose peak level reaches the threshold (and, when a
+ * receiver feeds demodulated audio, that the FM noise squelch opens), or
+ * clear after dwell_buffers. The noise squelch is only requested from
+ * receivers that call feed_audio() for every buffer.
+ */
+class ScanDwellCollector {
+public:
+	void configure(const ScanDwellConfigMessage& message) {
+		sequence = message.sequence;
+		index = message.index;
+		settle_buffers = message.settle_buffers;
+		dwell_buffers = message.dwell_buffers;
+		threshold_db = message.threshold_db;
+		squelch.set_threshold(message.noise_threshold);
+		noise_squelch = (message.noise_threshold > 0.0f);
+		buffers = 0;
+		max_squared = 0;
+		active = (dwell_buffers > 0);
+	}
+
+	template<typename Callback>
+	void feed(const buffer_c16_t& src, Callback callback) {
+		feed(ChannelStatsCollector::block_power(src), callback);
+	}
+
+	template<typename Callback>
+	void feed(const ChannelStatsCollector::BlockPower& power, Callback callback) {
+		if( !active ) {
+			return;
+		}
+
+		buffers++;
+		if( buffers <= settle_buffers ) {
+			return;
+		}
+
+		max_squared = std::max(max_squared, power.max_squared);
+		carrier = (ChannelStatsCollector::peak_db(max_squared) >= threshold_db);
+
+		// With the noise squelch on, the verdict waits for this buffer's audio
+		if( !noise_squelch ) {
+			decide(carrier, callback);
+		}
+	}
+
+	template<typename Callback>
+	void feed_audio(const buffer_s16_t& audio, Callback callback) {
+		if( !active || !noise_squelch ) {
+			return;
+		}
+
+		// Run the squelch filter through the settling buffers too, so its
+		// state belongs to the new channel by the time it counts.
+		const bool open = squelch.execute(audio);
+		if( buffers > settle_buffers ) {
+			decide(carrier && open, callback);
+		}
+	}
+
+private:
+	uint32_t sequence { 0 };
+	uint32_t index { 0 };
+	uint32_t settle_buffers { 0 };
+	uint32_t dwell_buffers { 0 };
+	int32_t threshold_db { 0 };
+	uint32_t buffers { 0 };
+	uint32_t max_squared { 0 };
+	FMSquelch squelch { };
+	bool noise_squelch { false };
+	bool carrier { false };
+	bool active { false };
+
+	template<typename Callback>
+	void decide(const bool busy, Callback callback) {
+		if( busy || (buffers >= (settle_buffers + dwell_buffers)) ) {
+			callback(sequence, index, ChannelStatsCollector::peak_db(max_squared), busy);
+			active = false;
+		}
+	}
+};
+
+#endif/*__SCAN_DWELL_COLLECTOR_H__*/
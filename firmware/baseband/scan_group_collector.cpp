@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "scan_group_collector.hpp"
+
+#include "dsp_fft.hpp"
+#include "sine_table_int8.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void ScanGroupCollector::configure(const ScanGroupConfigMessage& message) {
+	sequence = message.sequence;
+	settle_buffers = message.settle_buffers;
+	dwell_buffers = std::max(message.dwell_buffers, static_cast<uint32_t>(1));
+	count = std::min(message.count, offsets.size());
+	offsets = message.offsets;
+	peak.fill(0.0f);
+	buffers = 0;
+	active = (count > 0);
+}
+
+void ScanGroupCollector::measure(const buffer_c8_t& src) {
+	// sine_table_i8 is a turn in 256 steps, one per sample: the window is
+	// 0.5 - 0.5 cos, from the table's quarter turn on.
+	static_assert(fft_size == 256, "window assumes a 256 entry sine table");
+	for(size_t i=0; i<fft_size; i++) {
+		const float w = (127 - sine_table_i8[(i + 64) & 0xff]) * (1.0f / 254.0f);
+		const size_t i_rev = __RBIT(i) >> (32 - log_2(fft_size));
+		fft[i_rev] = { src.p[i].real() * w, src.p[i].imag() * w };
+	}
+	fft_c_preswapped(fft, 0, log_2(fft_size));
+
+	for(size_t n=0; n<count; n++) {
+		// Nearest bin; negative offsets are the top half.
+		const int32_t bin = std::lround(offsets[n] * static_cast<float>(fft_size) / src.sampling_rate);
+		const auto& value = fft[bin & (fft_size - 1)];
+		const float power = value.real() * value.real() + value.imag() * value.imag();
+		peak[n] = std::max(peak[n], power);
+	}
+}
+
+std::array<int8_t, ScanGroupConfigMessage::channels_max> ScanGroupCollector::levels_db() const {
+	// A full scale tone in the middle of a bin: 127, times the window's
+	// mean of a half, times the number of samples.
+	constexpr float full_scale = 127.0f * 0.5f * fft_size;
+	constexpr float normalize = 1.0f / (full_scale * full_scale);
+
+	std::array<int8_t, ScanGroupConfigMessage::channels_max> levels { };
+	levels.fill(-128);
+	for(size_t n=0; n<count; n++) {
+		const int32_t db = mag2_to_dbv_norm(peak[n] * normalize);
+		levels[n] = std::max(-128, std::min(0, static_cast<int>(db)));
+	}
+	return levels;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SCAN_GROUP_COLLECTOR_H__
+#define __SCAN_GROUP_COLLECTOR_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <complex>
+
+/* The scanner's in-band screen: after settle_buffers, a Hann windowed
+ * 256 point FFT of the start of each buffer, and the peak power of each
+ * configured channel's bin over dwell_buffers. At 3.072MHz a bin is 12kHz,
+ * about a narrowband channel. Fed the raw baseband, so it costs nothing
+ * but the FFT while a group is being screened, and nothing otherwise.
+ */
+class ScanGroupCollector {
+public:
+	void configure(const ScanGroupConfigMessage& message);
+
+	template<typename Callback>
+	void feed(const buffer_c8_t& src, Callback callback) {
+		if( !active ) {
+			return;
+		}
+
+		buffers++;
+		if( (buffers <= settle_buffers) || (src.count < fft_size) ) {
+			return;
+		}
+
+		measure(src);
+
+		if( buffers >= (settle_buffers + dwell_buffers) ) {
+			callback(sequence, count, levels_db());
+			active = false;
+		}
+	}
+
+private:
+	static constexpr size_t fft_size = 256;
+
+	uint32_t sequence { 0 };
+	uint32_t settle_buffers { 0 };
+	uint32_t dwell_buffers { 0 };
+	size_t count { 0 };
+	std::array<int32_t, ScanGroupConfigMessage::channels_max> offsets { };
+	std::array<float, ScanGroupConfigMessage::channels_max> peak { };
+	uint32_t buffers { 0 };
+	bool active { false };
+
+	std::array<std::complex<float>, fft_size> fft { };
+
+	void measure(const buffer_c8_t& src);
+	std::array<int8_t, ScanGroupConfigMessage::channels_max> levels_db() const;
+};
+
+#endif/*__SCAN_GROUP_COLLECTOR_H__*/
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2016 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SINE_TABLE_C8_H__
+#define __SINE_TABLE_C8_H__
+
+#include "sine_table_int8.hpp"
+#include "complex.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* sine_table_i8 as { cos, sin } pairs, indexed by the top byte of a 32 bit
+ * phase accumulator, so a TX oscillator gets its I/Q sample with one
+ * halfword load instead of two byte loads and the quarter turn offset.
+ * Same values as sine_table_i8 at (phase >> 24) + 64 and phase >> 24.
+ */
+class ComplexSineTableI8 {
+public:
+	ComplexSineTableI8() {
+		for(size_t i=0; i<table.size(); i++) {
+			table[i] = { sine_table_i8[(i + 64) & 0xff], sine_table_i8[i] };
+		}
+	}
+
+	complex8_t operator[](const uint32_t phase) const {
+		return table[phase >> 24];
+	}
+
+private:
+	std::array<complex8_t, 256> table { };
+};
+
+#endif/*__SINE_TABLE_C8_H__*/
@@ -26,6 +26,8 @@
 #include "utility.hpp"
 #include "event_m4.hpp"
 #include "portapack_shared_memory.hpp"
+#include "spectrum_color_lut.hpp"
+#include "load_shedding.hpp"
 
 #include "event_m4.hpp"
 
@@ -48,21 +50,56 @@ void SpectrumCollector::on_message(const Message* const message) {
 
 void SpectrumCollector::set_state(const SpectrumStreamingConfigMessage& message) {
 	if( message.mode == SpectrumStreamingConfigMessage::Mode::Running ) {
+		streaming = false;
+		fft = message.fft;
+		trace = message.trace;
+		trace_param = message.trace_param;
+		trace_frames = 0;
+		colors = message.colors;
+		build_row_lut();
+		delivery = message.delivery;
+		set_fifo_depth(message.fifo_k);
 		start();
 	} else {
 		stop();
 	}
 }
 
+void SpectrumCollector::set_fifo_depth(const size_t new_fifo_k) {
+	// The application only reads the FIFO from its event loop, which is
+	// waiting on this configuration message, and streaming is off for the
+	// baseband thread, so the old frames can go now.
+	const auto ring = shared_memory.rings.find<ChannelSpectrum>(shared_rings::ID::Spectrum);
+	if( ring ) {
+		// Kept until the image shuts down, whatever depth is asked for next.
+		fifo_data.reset();
+		fifo = ring;
+		fifo->reset();
+		return;
+	}
+
+	const auto k = std::min<size_t>(new_fifo_k, ChannelSpectrumConfigMessage::fifo_k_max);
+	if( !fifo_data || (k != fifo_k) ) {
+		fifo_data.reset();
+		fifo_data = std::make_unique<ChannelSpectrum[]>(1 << k);
+		fifo_k = k;
+	}
+	own_fifo.set_data(fifo_data.get(), fifo_k);
+	fifo = &own_fifo;
+}
+
 void SpectrumCollector::start() {
+	CycleCounter::enable();
 	streaming = true;
-	ChannelSpectrumConfigMessage message { &fifo };
+	pending_valid = false;
+	dropped = 0;
+	ChannelSpectrumConfigMessage message { fifo };
 	shared_memory.application_queue.push(message);
 }
 
 void SpectrumCollector::stop() {
 	streaming = false;
-	fifo.reset_in();
+	fifo->reset_in();
 }
 
 void SpectrumCollector::set_decimation_factor(
@@ -71,6 +108,10 @@ void SpectrumCollector::set_decimation_factor(
 	channel_spectrum_decimator.set_factor(decimation_factor);
 }
 
+void SpectrumCollector::set_frequency_window(const bool enabled) {
+	frequency_window = enabled;
+}
+
 /* TODO: Refactor to register task with idle thread?
  * It's sad that the idle thread has to call all the way back here just to
  * perform the deferred task on the buffer of data we prepared.
@@ -93,10 +134,64 @@ void SpectrumCollector::feed(
 	);
 }
 
+void SpectrumCollector::set_block_size(const size_t new_block_size) {
+	// A frame waiting for update() is of the old size.
+	channel_spectrum_request_update = false;
+
+	const bool new_zoom_block = (new_block_size == std::tuple_size<ZoomBlock>::value);
+	if( new_zoom_block && !zoom_in ) {
+		zoom_in = std::make_unique<ZoomBlock>();
+		zoom_out = std::make_unique<ZoomBlock>();
+	}
+	zoom_block = new_zoom_block;
+	if( !zoom_block ) {
+		zoom_in.reset();
+		zoom_out.reset();
+	}
+}
+
+void SpectrumCollector::feed_block(const buffer_c16_t& block) {
+	// Called from baseband processing thread.
+	if( !zoom_block ) {
+		post_message(block);
+		return;
+	}
+
+	if( (block.count == zoom_in->size()) && accept_block() ) {
+		std::copy(&block.p[0], &block.p[block.count], zoom_in->begin());
+		// The middle 256 bins span a quarter of the block's rate.
+		channel_spectrum_sampling_rate = block.sampling_rate / 4;
+		channel_spectrum_request_update = true;
+		EventDispatcher::events_flag(EVT_MASK_SPECTRUM);
+	}
+}
+
+bool SpectrumCollector::accept_block() {
+	if( !streaming || channel_spectrum_request_update ) {
+		return false;
+	}
+	if( !LoadShedding::due(shed_phase) ) {
+		return false;
+	}
+	if( (delivery == SpectrumStreamingConfigMessage::Delivery::Lossless) && fifo->is_full() ) {
+		// Skipping the input costs nothing, unlike an FFT that has
+		// nowhere to go.
+		dropped++;
+		return false;
+	}
+	return true;
+}
+
 void SpectrumCollector::post_message(const buffer_c16_t& data) {
 	// Called from baseband processing thread.
-	if( streaming && !channel_spectrum_request_update ) {
-		fft_swap(data, channel_spectrum);
+	if( accept_block() ) {
+		if( fft != SpectrumStreamingConfigMessage::FFT::FixedQ15 ) {
+			fft_swap(data, channel_spectrum);
+		}
+		if( fft != SpectrumStreamingConfigMessage::FFT::Float ) {
+			// Q15 FFT digit-reverses as it reads, a plain copy is enough.
+			std::copy(&data.p[0], &data.p[channel_spectrum_q15_in.size()], channel_spectrum_q15_in.begin());
+		}
 		channel_spectrum_sampling_rate = data.sampling_rate;
 		channel_spectrum_request_update = true;
 		EventDispatcher::events_flag(EVT_MASK_SPECTRUM);
@@ -128,26 +223,179 @@ static typename T::value_type spectrum_window_blackman_3(const T& s, const size_
 	return s[i] * alpha - (s[(i-1) & mask] + s[(i+1) & mask]) * beta + (s[(i-2) & mask] + s[(i+2) & mask]) * gamma;
 };
 
+uint32_t SpectrumCollector::compute_float() {
+	fft_cycles.start();
+	fft_c_preswapped(channel_spectrum, 0, 8);
+	return fft_cycles.stop();
+}
+
+uint32_t SpectrumCollector::compute_zoom() {
+	fft_cycles.start();
+	fft_q15_radix4(*zoom_in, *zoom_out);
+
+	// Middle 256 bins, in the same DC-first order as the 256 point FFTs.
+	constexpr size_t n = std::tuple_size<ZoomBlock>::value;
+	constexpr size_t half = std::tuple_size<decltype(channel_spectrum)>::value / 2;
+	constexpr float scale = n;
+	for(size_t i=0; i<half; i++) {
+		channel_spectrum[i] = std::complex<float>((*zoom_out)[i]) * scale;
+		channel_spectrum[half + i] = std::complex<float>((*zoom_out)[n - half + i]) * scale;
+	}
+	return fft_cycles.stop();
+}
+
+uint32_t SpectrumCollector::compute_q15() {
+	fft_cycles.start();
+	fft_q15_radix4(channel_spectrum_q15_in, channel_spectrum_q15_out);
+
+	// Q15 FFT output is scaled by 1/N, undo that so both paths share the
+	// same dB scaling below.
+	constexpr float scale = std::tuple_size<decltype(channel_spectrum_q15_out)>::value;
+	for(size_t i=0; i<channel_spectrum.size(); i++) {
+		channel_spectrum[i] = std::complex<float>(channel_spectrum_q15_out[i]) * scale;
+	}
+	return fft_cycles.stop();
+}
+
+void SpectrumCollector::accumulate_trace(ChannelSpectrum& spectrum) {
+	using Trace = SpectrumStreamingConfigMessage::Trace;
+
+	spectrum.trace = trace;
+	if( trace == Trace::Instant ) {
+		spectrum.trace_frames = 1;
+		return;
+	}
+
+	if( (trace == Trace::PeakHold) || (trace == Trace::MinHold) ) {
+		if( trace_param && (trace_frames >= trace_param) ) {
+			trace_frames = 0;
+		}
+	}
+	const bool first = (trace_frames == 0);
+	trace_frames++;
+
+	// Frame n is weighted 1/n up to trace_param frames, giving a true mean
+	// while the trace fills, then a 1/trace_param running average.
+	const int32_t average_n = std::min<uint32_t>(trace_frames, std::max<uint32_t>(trace_param, 1));
+	const int32_t exponential_div = 1 << std::min<uint32_t>(trace_param, 8);
+
+	for(size_t i=0; i<spectrum.db.size(); i++) {
+		const int32_t x = spectrum.db[i] << 8;
+		int32_t acc = trace_acc[i];
+
+		if( first ) {
+			acc = x;
+		} else {
+			switch(trace) {
+			case Trace::Average:		acc += (x - acc) / average_n; break;
+			case Trace::Exponential:	acc += (x - acc) / exponential_div; break;
+			case Trace::PeakHold:		acc = std::max(acc, x); break;
+			case Trace::MinHold:		acc = std::min(acc, x); break;
+			default:					acc = x; break;
+			}
+		}
+
+		trace_acc[i] = acc;
+		spectrum.db[i] = (acc + 128) >> 8;
+	}
+
+	spectrum.trace_frames = trace_frames;
+}
+
+void SpectrumCollector::build_row_lut() {
+	if( colors.range_db == 0 ) {
+		return;
+	}
+
+	// ChannelSpectrum::db is 5 steps per dB, 255 being 0dBFS.
+	const int32_t span = colors.range_db * 5;
+	const int32_t bottom = colors.ref_level_db * 5 + 255 - span;
+	for(size_t i=0; i<row_lut.size(); i++) {
+		const int32_t index = ((int32_t)i - bottom) * 255 / span;
+		row_lut[i] = spectrum_rgb3_lut[std::max<int32_t>(0, std::min<int32_t>(255, index))];
+	}
+}
+
+void SpectrumCollector::fill_row(ChannelSpectrum& spectrum) const {
+	constexpr size_t first = 256 - std::tuple_size<decltype(spectrum.row)>::value / 2;
+	for(size_t i=0; i<spectrum.row.size(); i++) {
+		spectrum.row[i] = row_lut[spectrum.db[(first + i) & 0xff]];
+	}
+	spectrum.row_valid = true;
+}
+
 void SpectrumCollector::update() {
 	// Called from idle thread (after EVT_MASK_SPECTRUM is flagged)
 	if( streaming && channel_spectrum_request_update ) {
 		/* Decimated buffer is full. Compute spectrum. */
-		fft_c_preswapped(channel_spectrum, 0, 8);
-
 		ChannelSpectrum spectrum;
+
+		if( zoom_block ) {
+			spectrum.fft_cycles = compute_zoom();
+		} else {
+			switch(fft) {
+			case SpectrumStreamingConfigMessage::FFT::FixedQ15:
+				spectrum.fft_cycles = compute_q15();
+				break;
+
+			case SpectrumStreamingConfigMessage::FFT::Benchmark:
+				spectrum.fft_reference_cycles = compute_float();
+				spectrum.fft_cycles = compute_q15();
+				break;
+
+			default:
+				spectrum.fft_cycles = compute_float();
+				break;
+			}
+		}
+
 		spectrum.sampling_rate = channel_spectrum_sampling_rate;
 		spectrum.channel_filter_pass_frequency = channel_filter_pass_frequency;
 		spectrum.channel_filter_stop_frequency = channel_filter_stop_frequency;
 		for(size_t i=0; i<spectrum.db.size(); i++) {
-			const auto corrected_sample = spectrum_window_hamming_3(channel_spectrum, i);
-			const auto mag2 = magnitude_squared(corrected_sample * (1.0f / 32768.0f));
-			const float db = mag2_to_dbv_norm(mag2);
-			constexpr float mag_scale = 5.0f;
-			const unsigned int v = (db * mag_scale) + 255.0f;
-			spectrum.db[i] = std::max(0U, std::min(255U, v));
+			const auto corrected_sample = frequency_window
+				? spectrum_window_hamming_3(channel_spectrum, i)
+				: spectrum_window_none(channel_spectrum, i);
+			// Q15 full scale is 2^30 of power
+			const int32_t db_q8 = mag2_to_db_q8(magnitude_squared(corrected_sample), 30);
+			constexpr int32_t mag_scale = 5;
+			const int32_t v = ((db_q8 * mag_scale) >> 8) + 255;
+			spectrum.db[i] = std::max(0, std::min(255, v));
+		}
+		// Accumulate even if the FIFO is full, so held traces include
+		// frames the application never sees.
+		accumulate_trace(spectrum);
+		if( colors.range_db ) {
+			fill_row(spectrum);
 		}
-		fifo.in(spectrum);
+		spectrum.dropped = dropped;
+		deliver(spectrum);
+	} else if( streaming && pending_valid && fifo->in(pending) ) {
+		pending_valid = false;
 	}
 
 	channel_spectrum_request_update = false;
 }
+
+void SpectrumCollector::deliver(const ChannelSpectrum& spectrum) {
+	if( pending_valid && fifo->in(pending) ) {
+		pending_valid = false;
+	}
+
+	if( !pending_valid && fifo->in(spectrum) ) {
+		return;
+	}
+
+	if( delivery == SpectrumStreamingConfigMessage::Delivery::Latest ) {
+		// A frame already waiting is superseded (and lost), this one waits
+		// for room in its place.
+		if( pending_valid ) {
+			dropped++;
+		}
+		pending = spectrum;
+		pending.dropped = dropped;
+		pending_valid = true;
+	} else {
+		dropped++;
+	}
+}
@@ -26,9 +26,11 @@
 #include "complex.hpp"
 
 #include "block_decimator.hpp"
+#include "cycle_counter.hpp"
 
 #include <cstdint>
 #include <array>
+#include <memory>
 
 #include "message.hpp"
 
@@ -38,20 +40,59 @@ public:
 
 	void set_decimation_factor(const size_t decimation_factor);
 
+	/* Disable the frequency-domain window when the producer has already
+	 * windowed the data in the time domain.
+	 */
+	void set_frequency_window(const bool enabled);
+
 	void feed(
 		const buffer_c16_t& channel,
 		const uint32_t filter_pass_frequency,
 		const uint32_t filter_stop_frequency
 	);
 
+	/* Zoom FFTs of block_size (256 or 1024) samples, fed whole to
+	 * feed_block() instead, of which the middle 256 bins are shown. 1024
+	 * always runs the Q15 FFT, there being no float twiddles for it. Set
+	 * while not feeding.
+	 */
+	void set_block_size(const size_t new_block_size);
+	void feed_block(const buffer_c16_t& block);
+
 private:
 	BlockDecimator<complex16_t, 256> channel_spectrum_decimator { 1 };
-	ChannelSpectrum fifo_data[1 << ChannelSpectrumConfigMessage::fifo_k] { };
-	ChannelSpectrumFIFO fifo { fifo_data, ChannelSpectrumConfigMessage::fifo_k };
+	// Reallocated when an app asks for a different depth, while stopped.
+	std::unique_ptr<ChannelSpectrum[]> fifo_data { };
+	size_t fifo_k { 0 };
+	ChannelSpectrumFIFO own_fifo { nullptr, 0 };
+	// own_fifo, or the application's shared ring when it made one.
+	ChannelSpectrumFIFO* fifo { &own_fifo };
+	SpectrumStreamingConfigMessage::Delivery delivery { SpectrumStreamingConfigMessage::Delivery::Latest };
+	// Latest delivery: newest frame that found the FIFO full.
+	ChannelSpectrum pending { };
+	bool pending_valid { false };
+	uint32_t dropped { 0 };
+	uint32_t shed_phase { 0 };
 
 	volatile bool channel_spectrum_request_update { false };
-	bool streaming { false };
+	volatile bool streaming { false };
+	bool frequency_window { true };
+	SpectrumStreamingConfigMessage::FFT fft { SpectrumStreamingConfigMessage::FFT::Float };
+	SpectrumStreamingConfigMessage::Trace trace { SpectrumStreamingConfigMessage::Trace::Instant };
+	uint32_t trace_param { 0 };
+	uint32_t trace_frames { 0 };
+	SpectrumStreamingConfigMessage::Colors colors { 0, 0 };
+	std::array<ui::Color, 256> row_lut { };	// db byte to colour, rebuilt on config
+	std::array<uint16_t, 256> trace_acc { };	// 8.8 fixed point, ChannelSpectrum::db scale
 	std::array<std::complex<float>, 256> channel_spectrum { };
+	std::array<complex16_t, 256> channel_spectrum_q15_in { };
+	std::array<complex16_t, 256> channel_spectrum_q15_out { };
+	// 1024 point zoom FFT, allocated while set_block_size() asks for it.
+	using ZoomBlock = std::array<complex16_t, 1024>;
+	std::unique_ptr<ZoomBlock> zoom_in { };
+	std::unique_ptr<ZoomBlock> zoom_out { };
+	bool zoom_block { false };
+	CycleCounter fft_cycles { };
 	uint32_t channel_spectrum_sampling_rate { 0 };
 	uint32_t channel_filter_pass_frequency { 0 };
 	uint32_t channel_filter_stop_frequency { 0 };
@@ -59,10 +100,19 @@ private:
 	void post_message(const buffer_c16_t& data);
 
 	void set_state(const SpectrumStreamingConfigMessage& message);
+	void set_fifo_depth(const size_t new_fifo_k);
+	void deliver(const ChannelSpectrum& spectrum);
 	void start();
 	void stop();
 
 	void update();
+	uint32_t compute_float();
+	uint32_t compute_q15();
+	uint32_t compute_zoom();
+	bool accept_block();
+	void accumulate_trace(ChannelSpectrum& spectrum);
+	void build_row_lut();
+	void fill_row(ChannelSpectrum& spectrum) const;
 };
 
 #endif/*__SPECTRUM_COLLECTOR_H__*/
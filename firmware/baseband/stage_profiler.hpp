@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2018 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __STAGE_PROFILER_H__
+#define __STAGE_PROFILER_H__
+
+#include "cycle_counter.hpp"
+#include "portapack_shared_memory.hpp"
+
+#include "ch.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+/* One row of the shared profiler table, fed with DWT cycle counts. Declare
+ * one per pipeline stage in the processor and wrap the stage with a
+ * ProfilerScope or profile():
+ *
+ *   const auto decim_0_out = profile(profile_decim_0, [&]() {
+ *       return decim_0.execute(buffer, dst_buffer);
+ *   });
+ */
+class ProfilerStage {
+public:
+	ProfilerStage(
+		const size_t index,
+		const char* const name
+	) {
+		if( index >= ProfilerTable::stages_max ) {
+			chDbgPanic("ProfStage");
+		}
+		entry = &shared_memory.profiler.stages[index];
+		strncpy(entry->name, name, sizeof(entry->name) - 1);
+		entry->name[sizeof(entry->name) - 1] = 0;
+		reset();
+
+		CycleCounter::enable();
+	}
+
+	ProfilerStage(const ProfilerStage&) = delete;
+	ProfilerStage& operator=(const ProfilerStage&) = delete;
+
+	void record(const uint32_t cycles) {
+		if( reset_sequence != shared_memory.profiler.reset_sequence ) {
+			reset();
+		}
+		entry->cycles_min = std::min(entry->cycles_min, cycles);
+		entry->cycles_max = std::max(entry->cycles_max, cycles);
+		entry->cycles_total += cycles;
+		entry->count++;
+	}
+
+private:
+	ProfilerStageStatistics* entry { nullptr };
+	uint32_t reset_sequence { 0 };
+
+	void reset() {
+		reset_sequence = shared_memory.profiler.reset_sequence;
+		entry->count = 0;
+		entry->cycles_min = UINT32_MAX;
+		entry->cycles_max = 0;
+		entry->cycles_total = 0;
+	}
+};
+
+class ProfilerScope {
+public:
+	explicit ProfilerScope(
+		ProfilerStage& stage
+	) : stage { stage },
+		t_start { CycleCounter::now() }
+	{
+	}
+
+	~ProfilerScope() {
+		stage.record(CycleCounter::now() - t_start);
+	}
+
+	ProfilerScope(const ProfilerScope&) = delete;
+	ProfilerScope& operator=(const ProfilerScope&) = delete;
+
+private:
+	ProfilerStage& stage;
+	const uint32_t t_start;
+};
+
+template<typename Fn>
+auto profile(ProfilerStage& stage, Fn fn) -> decltype(fn()) {
+	const ProfilerScope scope { stage };
+	return fn();
+}
+
+#endif/*__STAGE_PROFILER_H__*/
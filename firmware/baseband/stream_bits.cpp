@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2016 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "stream_bits.hpp"
+
+bool BitStream::read_bit(uint8_t& bit) {
+	if( bits_left == 0 ) {
+		if( !read_byte(byte) ) {
+			return false;
+		}
+		bits_left = 8;
+	}
+	bits_left--;
+	bit = (byte >> bits_left) & 1;
+	return true;
+}
+
+bool BitStream::read_bits(uint32_t& value, const size_t width) {
+	value = 0;
+	for(size_t n=0; n<width; n++) {
+		uint8_t bit;
+		if( !read_bit(bit) ) {
+			return false;
+		}
+		value = (value << 1) | bit;
+	}
+	return true;
+}
+
+bool BitStream::read_byte(uint8_t& value) {
+	if( cache_pos == cache_used ) {
+		if( stream.end_of_stream() ) {
+			return false;
+		}
+		cache_used = stream.read(cache.data(), cache.size());
+		cache_pos = 0;
+		if( cache_used == 0 ) {
+			return false;
+		}
+	}
+	value = cache[cache_pos++];
+	return true;
+}
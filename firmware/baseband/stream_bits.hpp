@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2016 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __STREAM_BITS_H__
+#define __STREAM_BITS_H__
+
+#include "stream_output.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Symbols for the TX processors streamed from the application through a
+ * ReplayConfig, instead of a payload in bb_data: the application keeps
+ * refilling buffers while the processor drains them, so there's no length
+ * limit and no gap between one burst and the next.
+ */
+class BitStream {
+public:
+	BitStream(ReplayConfig* const config) : stream { config } { }
+
+	/* Next bit, MSB first. */
+	bool read_bit(uint8_t& bit);
+
+	/* Next width bits (up to 32), MSB first. */
+	bool read_bits(uint32_t& value, const size_t width);
+
+	/* Next little-endian value, for word oriented payloads. */
+	template<typename T>
+	bool read(T& value) {
+		value = 0;
+		for(size_t n=0; n<sizeof(T); n++) {
+			uint8_t b;
+			if( !read_byte(b) ) {
+				return false;
+			}
+			value |= static_cast<T>(b) << (n * 8);
+		}
+		return true;
+	}
+
+	/* Reads fail on an underrun too; only this says the application is
+	 * done, rather than late.
+	 */
+	bool is_done() const {
+		return (cache_pos == cache_used) && stream.end_of_stream();
+	}
+
+private:
+	StreamOutput stream;
+	std::array<uint8_t, 32> cache { };
+	size_t cache_used { 0 };
+	size_t cache_pos { 0 };
+	uint8_t byte { 0 };
+	size_t bits_left { 0 };
+
+	bool read_byte(uint8_t& value);
+};
+
+#endif/*__STREAM_BITS_H__*/
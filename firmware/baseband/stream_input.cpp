@@ -65,12 +65,16 @@ size_t StreamInput::write(const void* const data, const size_t length) {
 				break;
 			}
 			active_buffer = nullptr;
+			config->statistics.record_fifo_level(fifo_buffers_full.len());
 			creg::m4txevent::assert();
 		}
 	}
 
 	config->baseband_bytes_received += length;
-	config->baseband_bytes_dropped += (length - written);
+	if( written < length ) {
+		config->baseband_bytes_dropped += (length - written);
+		config->statistics.buffers_dropped++;
+	}
 
 	return written;
 }
@@ -41,6 +41,10 @@ public:
 
 	size_t write(const void* const data, const size_t length);
 
+	bool squelch_gate() const {
+		return config->squelch_gate;
+	}
+
 private:
 	static constexpr size_t buffer_count_max_log2 = 3;
 	static constexpr size_t buffer_count_max = 1U << buffer_count_max_log2;
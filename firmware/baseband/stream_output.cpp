@@ -43,6 +43,24 @@ StreamOutput::StreamOutput(ReplayConfig* const config) :
 }
 
 size_t StreamOutput::read(void* const data, const size_t length) {
+	const auto read = transfer(data, length);
+
+	config->baseband_bytes_received += length;
+	if( read < length ) {
+		config->baseband_bytes_dropped += (length - read);
+		config->statistics.buffers_dropped++;
+	}
+
+	return read;
+}
+
+size_t StreamOutput::read_some(void* const data, const size_t length) {
+	const auto read = transfer(data, length);
+	config->baseband_bytes_received += read;
+	return read;
+}
+
+size_t StreamOutput::transfer(void* const data, const size_t length) {
 	uint8_t* p = static_cast<uint8_t*>(data);
 	size_t read = 0;
 
@@ -53,6 +71,9 @@ size_t StreamOutput::read(void* const data, const size_t length) {
 				// ...but none are available. Hole in transmission (inform app and stop ?)
 				break;
 			}
+			if( active_buffer->is_empty() ) {
+				ended = true;
+			}
 		}
 		
 		const auto remaining = length - read;
@@ -67,11 +88,10 @@ size_t StreamOutput::read(void* const data, const size_t length) {
 			}
 			// Tell M0 (IRQ) that a buffer has been consumed.
 			active_buffer = nullptr;
+			config->statistics.record_fifo_level(fifo_buffers_empty.len());
 			creg::m4txevent::assert();
 		}
 	}
 
-	config->baseband_bytes_received += length;
-
 	return read;
 }
@@ -42,6 +42,18 @@ public:
 
 	size_t read(void* const data, const size_t length);
 
+	/* As read(), for a reader that waits on the application rather than a
+	 * clock: what isn't there yet isn't counted as dropped.
+	 */
+	size_t read_some(void* const data, const size_t length);
+
+	/* The application ends a stream with an empty buffer (a short read of
+	 * its source); read() returns nothing more once that one is reached.
+	 */
+	bool end_of_stream() const {
+		return ended;
+	}
+
 private:
 	static constexpr size_t buffer_count_max_log2 = 3;
 	static constexpr size_t buffer_count_max = 1U << buffer_count_max_log2;
@@ -53,7 +65,10 @@ private:
 	std::array<StreamBuffer*, buffer_count_max> buffers_full { };
 	StreamBuffer* active_buffer { nullptr };
 	ReplayConfig* const config { nullptr };
+	bool ended { false };
 	std::unique_ptr<uint8_t[]> data { };
+
+	size_t transfer(void* const data, const size_t length);
 };
 
 #endif/*__STREAM_OUTPUT_H__*/
@@ -34,6 +34,8 @@ public:
 
 	void configure(const uint32_t delta, const float tone_mix_weight);
 	int32_t process(const int32_t sample_in);
+	/* The same with the tone at Q15 half scale, as sample_in << 7. */
+	int32_t process_q15(const int32_t sample_in);
 
 private:
 	//size_t sample_rate_;
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __TX_SEQUENCER_H__
+#define __TX_SEQUENCER_H__
+
+#include "message.hpp"
+#include "portapack_shared_memory.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <algorithm>
+
+/* Runs a TxSequenceConfigMessage's steps on the sample clock, so hops
+ * don't wait on the application: a processor makes its samples in runs
+ * of run() samples, silence while in_guard(), and reports them with
+ * advance(); a true return means a step has just started, payload() is
+ * its. Untimed steps (duration 0) last until the processor calls
+ * end_step(), typically at the end of its data. The application gets a
+ * TxSequenceStepMessage as each step ends, to tune to the next.
+ */
+class TxSequencer {
+public:
+	void configure(const TxSequenceConfigMessage& message) {
+		count = std::min(message.count, steps.size());
+		cycles = message.cycles;
+		guard = message.guard;
+		std::copy(message.steps.begin(), message.steps.begin() + count, steps.begin());
+		index = 0;
+		cycle = 0;
+		guarding = false;
+		remaining = (count > 0) ? steps[0].duration : 0;
+		active_ = (count > 0);
+	}
+
+	bool active() const {
+		return active_;
+	}
+
+	bool in_guard() const {
+		return guarding;
+	}
+
+	uint32_t payload() const {
+		return steps[index].payload;
+	}
+
+	size_t run(const size_t samples) const {
+		return (guarding || timed()) ? std::min<size_t>(samples, remaining) : samples;
+	}
+
+	bool advance(const size_t samples) {
+		if( !active_ || !(guarding || timed()) ) {
+			return false;
+		}
+
+		remaining -= std::min<size_t>(samples, remaining);
+		if( remaining > 0 ) {
+			return false;
+		}
+
+		if( guarding ) {
+			guarding = false;
+			remaining = steps[index].duration;
+			return true;
+		}
+		return next_step();
+	}
+
+	/* Returns true if the next step starts straight away, no guard. */
+	bool end_step() {
+		return active_ ? next_step() : false;
+	}
+
+private:
+	std::array<TxSequenceStep, TxSequenceConfigMessage::steps_max> steps { };
+	size_t count { 0 };
+	uint32_t cycles { 0 };
+	uint32_t guard { 0 };
+	size_t index { 0 };
+	uint32_t cycle { 0 };
+	uint32_t remaining { 0 };
+	bool guarding { false };
+	bool active_ { false };
+
+	bool timed() const {
+		return steps[index].duration > 0;
+	}
+
+	bool next_step() {
+		index++;
+		if( index >= count ) {
+			index = 0;
+			cycle++;
+			if( cycles && (cycle >= cycles) ) {
+				active_ = false;
+				const TxSequenceStepMessage message { static_cast<uint32_t>(count), cycle, true };
+				shared_memory.application_queue.push(message);
+				return false;
+			}
+		}
+
+		const TxSequenceStepMessage message { static_cast<uint32_t>(index), cycle, false };
+		shared_memory.application_queue.push(message);
+
+		guarding = (guard > 0);
+		remaining = guarding ? guard : steps[index].duration;
+		return !guarding;
+	}
+};
+
+#endif/*__TX_SEQUENCER_H__*/
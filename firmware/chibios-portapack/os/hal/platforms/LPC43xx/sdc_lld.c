@@ -47,6 +47,9 @@ SDCDriver SDCD1;
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+/* Card clock divider currently set, 0 for bypass, 255 while identifying. */
+static size_t cclk_divider = 255;
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -190,6 +193,7 @@ static void sdio_cclk_set(const size_t divider_value) {
 
   sdio_clkdiv_set(divider_value);
   sdio_update_clock_registers_only();
+  cclk_divider = divider_value;
 
   sdio_cclk_enable();
   sdio_update_clock_registers_only();
@@ -199,14 +203,22 @@ static void sdio_cclk_set_400khz(void) {
   sdio_cclk_set(255);
 }
 
-static void sdio_cclk_set_fast(void) {
-#if defined(PORTAPACK_FAST_SDIO)
+static void sdio_cclk_set_high_speed(void) {
   /* 200MHz / (2 * 2) = 50MHz */
   /* TODO: Adjust SCU pin configurations: pull-up/down, slew, glitch filter? */
   sdio_cclk_set(2);
-#else
+}
+
+static void sdio_cclk_set_default_speed(void) {
   /* 200MHz / (2 * 4) = 25MHz */
   sdio_cclk_set(4);
+}
+
+static void sdio_cclk_set_fast(void) {
+#if defined(PORTAPACK_FAST_SDIO)
+  sdio_cclk_set_high_speed();
+#else
+  sdio_cclk_set_default_speed();
 #endif
 }
 
@@ -523,6 +535,64 @@ static bool_t sdc_lld_prepare_write(SDCDriver *sdcp, uint32_t startblk,
   return CH_SUCCESS;
 }
 
+/**
+ * @brief   Sends CMD6 (SWITCH_FUNC) and reads back its 64 byte status.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] arg       mode and function selection
+ * @param[out] status   switch function status, 16 words
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   operation succeeded.
+ * @retval CH_FAILED    operation failed.
+ *
+ * @notapi
+ */
+static bool_t sdc_lld_switch_function(SDCDriver *sdcp, uint32_t arg,
+                                      uint32_t *status) {
+  const uint32_t status_bytes = 64;
+
+  if (_sdc_wait_for_transfer_state(sdcp))
+    return CH_FAILED;
+
+  sdio_reset_dma_and_fifo();
+
+  LPC_SDMMC_DESC_Type desc[1];
+  uint32_t resp[1];
+  if (sdc_llc_prepare_descriptors_chained(desc, 1, (uint8_t *)status, status_bytes) == TRUE)
+    goto error;
+
+  LPC_SDMMC->DBADDR = (uint32_t)&desc;
+
+  sdio_interrupts_clear();
+  sdio_interrupts_set_mask(
+      (1U <<  3)  /* DTO: Data transfer over */
+    | (1U <<  7)  /* DCRC: Data CRC error */
+    | (1U <<  9)  /* DRTO: Data read time-out */
+    | (1U << 10)  /* HTO: Data starvation-by-host time-out */
+    | (1U << 11)  /* FRUN: FIFO underrun/overrun */
+    | (1U << 13)  /* SBE: Start-bit error */
+    | (1U << 15)  /* EBE: End-bit error / write no CRC */
+  );
+
+  LPC_SDMMC->BLKSIZ = status_bytes;
+  LPC_SDMMC->BYTCNT = status_bytes;
+
+  /* Same index as ACMD6 SET_BUS_WIDTH, but without APP_CMD first. */
+  if (sdc_lld_send_cmd_data_read(sdcp, MMCSD_CMD_SET_BUS_WIDTH, arg, resp) || MMCSD_R1_ERROR(resp[0]))
+    goto error;
+  if (sdc_lld_wait_transaction_end(sdcp, 1, resp) == TRUE)
+    goto error;
+
+  LPC_SDMMC->BLKSIZ = MMCSD_BLOCK_SIZE;
+  return CH_SUCCESS;
+
+error:
+  sdc_lld_error_cleanup(sdcp, 1, resp);
+  LPC_SDMMC->BLKSIZ = MMCSD_BLOCK_SIZE;
+  return CH_FAILED;
+}
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -678,6 +748,66 @@ void sdc_lld_set_data_clk(SDCDriver *sdcp) {
   sdio_cclk_set_fast();
 }
 
+/**
+ * @brief   Negotiates high speed timing and sets the data clock to 50MHz,
+ *          or goes back to the 25MHz default speed clock.
+ * @details Uses CMD6 function group 1 (access mode), SD 1.10 and later.
+ *          Cards that don't support it are left at default speed. Call with
+ *          the card connected and no transfer in progress.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] enable    TRUE for high speed, FALSE for default speed
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the card runs at the requested speed.
+ * @retval CH_FAILED    the card can't switch, clock unchanged.
+ *
+ * @notapi
+ */
+bool_t sdc_lld_set_high_speed(SDCDriver *sdcp, bool_t enable) {
+  if (!enable) {
+    /* High speed timing still works at the lower clock, the card goes back
+     * to default speed at its next reset.
+     */
+    sdio_cclk_set_default_speed();
+    return CH_SUCCESS;
+  }
+
+  /* Status is big endian: bits 415:400 are the functions group 1 supports,
+   * bits 379:376 the function a switch selected (0xF for failed).
+   */
+  uint32_t status[16];
+  const uint8_t *const status_bytes = (const uint8_t *)status;
+
+  /* Check mode, query function 1 (high speed) of group 1. */
+  if (sdc_lld_switch_function(sdcp, 0x00FFFFF1, status))
+    return CH_FAILED;
+  if ((status_bytes[13] & 0x02) == 0)
+    return CH_FAILED;
+
+  /* Switch mode; takes effect 8 clocks after the status block. */
+  if (sdc_lld_switch_function(sdcp, 0x80FFFFF1, status))
+    return CH_FAILED;
+  if ((status_bytes[16] & 0x0F) != 1)
+    return CH_FAILED;
+
+  sdio_cclk_set_high_speed();
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Returns the current card clock frequency in Hz.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ *
+ * @notapi
+ */
+uint32_t sdc_lld_get_clk_frequency(SDCDriver *sdcp) {
+  (void)sdcp;
+  /* 200MHz base, divided by 2 * CLKDIV (bypassed for 0). */
+  return cclk_divider ? (200000000U / (2 * cclk_divider)) : 200000000U;
+}
+
 /**
  * @brief   Stops the SDIO clock.
  *
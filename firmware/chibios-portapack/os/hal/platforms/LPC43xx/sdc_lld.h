@@ -203,6 +203,8 @@ extern "C" {
   void sdc_lld_stop(SDCDriver *sdcp);
   void sdc_lld_start_clk(SDCDriver *sdcp);
   void sdc_lld_set_data_clk(SDCDriver *sdcp);
+  bool_t sdc_lld_set_high_speed(SDCDriver *sdcp, bool_t enable);
+  uint32_t sdc_lld_get_clk_frequency(SDCDriver *sdcp);
   void sdc_lld_stop_clk(SDCDriver *sdcp);
   void sdc_lld_set_bus_mode(SDCDriver *sdcp, sdcbusmode_t mode);
   void sdc_lld_send_cmd_none(SDCDriver *sdcp, uint8_t cmd, uint32_t arg);
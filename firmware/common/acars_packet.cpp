@@ -22,86 +22,69 @@
 
 #include "acars_packet.hpp"
 
-#include "crc.hpp"
-
-#include <cstdlib>
-
 namespace acars {
 
-size_t Packet::length() const {
-	return packet_.size();
-}
+namespace {
 
-bool Packet::is_valid() const {
-	return true;	//length_valid() && crc_ok();
-}
+constexpr size_t mode_index = 0;
+constexpr size_t address_index = 1;
+constexpr size_t acknowledge_index = 8;
+constexpr size_t label_index = 9;
+constexpr size_t block_id_index = 11;
+constexpr size_t stx_index = 12;
+constexpr size_t header_length = 12;
 
-Timestamp Packet::received_at() const {
-	return packet_.timestamp();
-}
+constexpr uint8_t stx = 0x02;
+
+} /* namespace */
 
-uint8_t Packet::block_id() const {
-	return field_.read(96, 8);
+char Packet::character(const size_t index) const {
+	return (index < length_) ? (data_[index] & 0x7f) : 0;
 }
 
-std::string Packet::registration_number() const {
+std::string Packet::characters(const size_t start, const size_t end) const {
 	std::string result;
-	result.reserve(7);
-	
-	const size_t character_length = 8;
-	for(size_t i=16; i<(16+7*character_length); i+=character_length) {
-		result += (field_.read(i, character_length) & 0x7F);
+	for(size_t i=start; (i<end) && (i<length_); i++) {
+		result += character(i);
 	}
-
 	return result;
 }
 
-uint32_t Packet::read(const size_t start_bit, const size_t length) const {
-	return field_.read(start_bit, length);
+char Packet::mode() const {
+	return character(mode_index);
 }
 
-/*std::string Packet::text(
-	const size_t start_bit,
-	const size_t character_count
-) const {
-	std::string result;
-	result.reserve(character_count);
-	
-	const size_t character_length = 6;
-	const size_t end_bit = start_bit + character_count * character_length;
-	for(size_t i=start_bit; i<end_bit; i+=character_length) {
-		result += char_to_ascii(field_.read(i, character_length));
-	} 
-
-	return result;
-}*/
-
-bool Packet::crc_ok() const {
-	CRCReader field_crc { packet_ };
-	CRC<16> acars_fcs { 0x1021, 0x0000, 0x0000 };
-	
-	for(size_t i=0; i<data_length(); i+=8) {
-		acars_fcs.process_byte(field_crc.read(i, 8));
-	}
+std::string Packet::registration_number() const {
+	return characters(address_index, address_index + 7);
+}
 
-	return (acars_fcs.checksum() == field_crc.read(data_length(), fcs_length));
+char Packet::acknowledge() const {
+	return character(acknowledge_index);
 }
 
-size_t Packet::data_and_fcs_length() const {
-	return length() - 8;
+std::string Packet::label() const {
+	return characters(label_index, label_index + 2);
 }
 
-size_t Packet::data_length() const {
-	return data_and_fcs_length() - fcs_length;
+char Packet::block_id() const {
+	return character(block_id_index);
 }
 
-bool Packet::length_valid() const {
-	const size_t extra_bits = data_and_fcs_length() & 7;
-	if( extra_bits != 0 ) {
-		return false;
+std::string Packet::text() const {
+	// Blocks without text end right after the header, at the ETX.
+	if( (length_ <= header_length) || (character(stx_index) != stx) ) {
+		return { };
 	}
+	return characters(stx_index + 1, length_ - 1);
+}
 
+bool Packet::parity_ok() const {
+	for(size_t i=0; i<length_; i++) {
+		if( (__builtin_popcount(data_[i]) & 1) == 0 ) {
+			return false;
+		}
+	}
 	return true;
 }
 
-} /* namespace ais */
+} /* namespace acars */
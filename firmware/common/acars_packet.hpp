@@ -23,51 +23,66 @@
 #ifndef __ACARS_PACKET_H__
 #define __ACARS_PACKET_H__
 
-#include "baseband_packet.hpp"
-#include "field_reader.hpp"
+#include "baseband.hpp"
 
 #include <cstdint>
 #include <cstddef>
+#include <array>
 #include <string>
 
 namespace acars {
 
+/* One ACARS block as the M4 checked it: the characters from the mode to the
+ * ETX or ETB (parity bits still set), without the SOH before or the BCS
+ * after. Compact enough to be queued whole.
+ */
 class Packet {
 public:
-	constexpr Packet(
-		const baseband::Packet& packet
-	) : packet_ { packet },
-		field_ { packet_ }
-	{
+	/* ARINC 618: SOH, mode, 7 address characters, technical acknowledgement,
+	 * 2 label characters, block ID, STX, up to 220 text characters, ETX/ETB,
+	 * 2 byte BCS.
+	 */
+	static constexpr size_t length_max = 1 + 7 + 1 + 2 + 1 + 1 + 220 + 1;
+
+	void set_timestamp(const Timestamp& value) {
+		timestamp_ = value;
 	}
 
-	size_t length() const;
-	
-	bool is_valid() const;
-
-	Timestamp received_at() const;
+	void push_back(const uint8_t c) {
+		if( length_ < data_.size() ) {
+			data_[length_++] = c;
+		}
+	}
 
-	uint8_t block_id() const;
-	std::string registration_number() const;
+	void clear() {
+		length_ = 0;
+	}
 
-	uint32_t read(const size_t start_bit, const size_t length) const;
-	//std::string text(const size_t start_bit, const size_t character_count) const;
+	size_t length() const {
+		return length_;
+	}
 
-	bool crc_ok() const;
+	Timestamp received_at() const {
+		return timestamp_;
+	}
 
-private:
-	using Reader = FieldReader<baseband::Packet, BitRemapByteReverse>;
-	using CRCReader = FieldReader<baseband::Packet, BitRemapNone>;
-	
-	const baseband::Packet packet_;
-	const Reader field_;
+	char mode() const;
+	std::string registration_number() const;
+	char acknowledge() const;
+	std::string label() const;
+	char block_id() const;
+	std::string text() const;
 
-	const size_t fcs_length = 16;
+	/* Odd parity on every character. */
+	bool parity_ok() const;
 
-	size_t data_and_fcs_length() const;
-	size_t data_length() const;
+private:
+	Timestamp timestamp_ { };
+	uint8_t length_ { 0 };
+	std::array<uint8_t, length_max> data_ { };
 
-	bool length_valid() const;
+	char character(const size_t index) const;
+	std::string characters(const size_t start, const size_t end) const;
 };
 
 } /* namespace acars */
@@ -24,6 +24,8 @@
 #include "sine_table.hpp"
 
 #include <math.h>
+#include <array>
+#include <utility>
 
 namespace adsb {
 
@@ -207,76 +209,153 @@ void encode_frame_pos(ADSBFrame& frame, const uint32_t ICAO_address, const int32
 	frame.make_CRC();
 }
 
-// Decoding method from dump1090
-adsb_pos decode_frame_pos(ADSBFrame& frame_even, ADSBFrame& frame_odd) {
-	uint8_t * raw_data;
-	uint32_t latcprE, latcprO, loncprE, loncprO;
-	float latE, latO, m, Dlon;
-	int ni;
-	adsb_pos position { false, 0, 0, 0 };
+namespace {
+
+constexpr uint32_t cpr_bits = 17;
+
+template<size_t... I>
+constexpr std::array<uint32_t, sizeof...(I)> make_nl_table(std::index_sequence<I...>) {
+	return { { static_cast<uint32_t>(adsb_lat_lut[I] / 360.0 * 4294967296.0)... } };
+}
+
+template<size_t... I>
+constexpr std::array<uint64_t, sizeof...(I)> make_zone_reciprocals(std::index_sequence<I...>) {
+	return { { (I ? (((1ULL << 32) + I / 2) / I) : 0)... } };
+}
+
+// adsb_lat_lut as binary angles
+constexpr auto nl_table = make_nl_table(std::make_index_sequence<58>());
+
+// 2^32 / n, the width of a zone for n zones to the turn
+constexpr auto zone_reciprocals = make_zone_reciprocals(std::make_index_sequence<61>());
+
+int cpr_nl_fixed(const int32_t lat) {
+	const uint32_t magnitude = (lat < 0) ? -static_cast<uint32_t>(lat) : lat;
 	
-	uint32_t time_even = frame_even.get_rx_timestamp();
-	uint32_t time_odd = frame_odd.get_rx_timestamp();
-	uint8_t * frame_data_even = frame_even.get_raw_data();
-	uint8_t * frame_data_odd = frame_odd.get_raw_data();
+	for (size_t c = 0; c < nl_table.size(); c++) {
+		if (magnitude < nl_table[c])
+			return 59 - c;
+	}
 	
-	// Return most recent altitude
-	if (time_even > time_odd)
-		raw_data = frame_data_even;
-	else
-		raw_data = frame_data_odd;
+	return 1;
+}
+
+int cpr_n_fixed(const int32_t lat, const bool odd) {
+	const int nl = cpr_nl_fixed(lat) - (odd ? 1 : 0);
+	return (nl < 1) ? 1 : nl;
+}
+
+int32_t cpr_mod_fixed(const int32_t a, const int32_t b) {
+	const int32_t r = a % b;
+	return (r < 0) ? (r + b) : r;
+}
+
+// Zone index plus a 17 bit fraction of a zone, to a binary angle
+int32_t zone_to_angle(const int32_t zone, const uint32_t cpr, const int n) {
+	const int64_t z = (static_cast<int64_t>(zone) << cpr_bits) + cpr;
+	return static_cast<uint32_t>((z * static_cast<int64_t>(zone_reciprocals[n])) >> cpr_bits);
+}
+
+// A binary angle, in zones with a 17 bit fraction
+int64_t angle_to_zones(const int32_t angle, const int n) {
+	return (static_cast<int64_t>(angle) * n) >> (32 - cpr_bits);
+}
+
+// floor(x / 2^17 + 0.5)
+int32_t round_zones(const int64_t x) {
+	return static_cast<int32_t>((x + (1 << (cpr_bits - 1))) >> cpr_bits);
+}
+
+bool latitude_ok(const int32_t lat) {
+	return (lat >= -(1 << 30)) && (lat <= (1 << 30));
+}
+
+uint32_t cpr_lat(const uint8_t* const raw_data) {
+	return ((raw_data[6] & 3) << 15) | (raw_data[7] << 7) | (raw_data[8] >> 1);
+}
+
+uint32_t cpr_lon(const uint8_t* const raw_data) {
+	return ((raw_data[8] & 1) << 16) | (raw_data[9] << 8) | raw_data[10];
+}
 
+adsb_pos to_position(const uint8_t* const raw_data, const cpr_fix& fix) {
+	adsb_pos position { false, 0, 0, 0 };
+	
 	// Q-bit must be present
 	if (raw_data[5] & 1)
 		position.altitude = ((((raw_data[5] & 0xFE) << 3) | ((raw_data[6] & 0xF0) >> 4)) * 25) - 1000;
-
-	// Position
-	latcprE = ((frame_data_even[6] & 3) << 15) | (frame_data_even[7] << 7) | (frame_data_even[8] >> 1);
-	loncprE = ((frame_data_even[8] & 1) << 16) | (frame_data_even[9] << 8) | frame_data_even[10];
 	
-	latcprO = ((frame_data_odd[6] & 3) << 15) | (frame_data_odd[7] << 7) | (frame_data_odd[8] >> 1);
-	loncprO = ((frame_data_odd[8] & 1) << 16) | (frame_data_odd[9] << 8) | frame_data_odd[10];
+	if (fix.valid) {
+		position.latitude = fix.latitude * (360.0f / 4294967296.0f);
+		position.longitude = fix.longitude * (360.0f / 4294967296.0f);
+		position.valid = true;
+	}
+	
+	return position;
+}
 
-	// Compute latitude index
-	float j = floor((((59.0 * latcprE) - (60.0 * latcprO)) / 131072.0) + 0.5);
-	latE = (360.0 / 60.0) * (cpr_mod(j, 60) + (latcprE / 131072.0));
-	latO = (360.0 / 59.0) * (cpr_mod(j, 59) + (latcprO / 131072.0));
+} /* namespace */
+
+// Decoding method from dump1090
+adsb_pos decode_frame_pos(ADSBFrame& frame_even, ADSBFrame& frame_odd, cpr_fix& reference) {
+	const uint8_t* const frame_data_even = frame_even.get_raw_data();
+	const uint8_t* const frame_data_odd = frame_odd.get_raw_data();
+	
+	// Most recent altitude and position
+	const bool odd = frame_odd.get_rx_timestamp() >= frame_even.get_rx_timestamp();
+	const uint8_t* const raw_data = odd ? frame_data_odd : frame_data_even;
+	cpr_fix fix { false, 0, 0 };
 
-	if (latE >= 270) latE -= 360;
-	if (latO >= 270) latO -= 360;
+	const uint32_t latcprE = cpr_lat(frame_data_even);
+	const uint32_t loncprE = cpr_lon(frame_data_even);
+	const uint32_t latcprO = cpr_lat(frame_data_odd);
+	const uint32_t loncprO = cpr_lon(frame_data_odd);
+
+	// Compute latitude index
+	const int32_t j = round_zones((59 * static_cast<int64_t>(latcprE)) - (60 * static_cast<int64_t>(latcprO)));
+	const int32_t latE = zone_to_angle(cpr_mod_fixed(j, 60), latcprE, 60);
+	const int32_t latO = zone_to_angle(cpr_mod_fixed(j, 59), latcprO, 59);
 
 	// Both frames must be in the same latitude zone
-	if (cpr_NL(latE) != cpr_NL(latO))
-		return position;
+	if (!latitude_ok(latE) || !latitude_ok(latO) || (cpr_nl_fixed(latE) != cpr_nl_fixed(latO)))
+		return to_position(raw_data, fix);
 
 	// Compute longitude
-	if (time_even > time_odd) {
-		// Use even frame
-		ni = cpr_N(latE, 0);
-		Dlon = 360.0 / ni;
-		
-		m = floor((((loncprE * (cpr_NL(latE) - 1)) - (loncprO * cpr_NL(latE))) / 131072.0) + 0.5);
-		
-		position.longitude = Dlon * (cpr_mod(m, ni) + loncprE / 131072.0);
-		
-		position.latitude = latE;
-	} else {
-		// Use odd frame
-		ni = cpr_N(latO, 1);
-		Dlon = 360.0 / ni;
-		
-		m = floor((((loncprE * (cpr_NL(latO) - 1)) - (loncprO * cpr_NL(latO))) / 131072.0) + 0.5);
-		
-		position.longitude = Dlon * (cpr_mod(m, ni) + loncprO / 131072.0);
-		
-		position.latitude = latO;
-	}
-	
-	if (position.longitude > 180) position.longitude -= 360;
-	
-	position.valid = true;
+	fix.latitude = odd ? latO : latE;
+	const int nl = cpr_nl_fixed(fix.latitude);
+	const int ni = cpr_n_fixed(fix.latitude, odd);
+	const int32_t m = round_zones((static_cast<int64_t>(loncprE) * (nl - 1)) - (static_cast<int64_t>(loncprO) * nl));
+	fix.longitude = zone_to_angle(cpr_mod_fixed(m, ni), odd ? loncprO : loncprE, ni);
+	fix.valid = true;
 
-	return position;
+	reference = fix;
+	return to_position(raw_data, fix);
+}
+
+adsb_pos decode_frame_pos_local(ADSBFrame& frame, const bool odd, cpr_fix& reference) {
+	const uint8_t* const raw_data = frame.get_raw_data();
+	cpr_fix fix { false, 0, 0 };
+
+	if (!reference.valid)
+		return to_position(raw_data, fix);
+
+	const uint32_t latcpr = cpr_lat(raw_data);
+	const uint32_t loncpr = cpr_lon(raw_data);
+
+	// The zone is the reference's, or a neighbour if it's closer
+	const int nz = odd ? 59 : 60;
+	const int32_t j = round_zones(angle_to_zones(reference.latitude, nz) - latcpr);
+	fix.latitude = zone_to_angle(j, latcpr, nz);
+	if (!latitude_ok(fix.latitude))
+		return to_position(raw_data, fix);
+
+	const int ni = cpr_n_fixed(fix.latitude, odd);
+	const int32_t m = round_zones(angle_to_zones(reference.longitude, ni) - loncpr);
+	fix.longitude = zone_to_angle(m, loncpr, ni);
+	fix.valid = true;
+
+	reference = fix;
+	return to_position(raw_data, fix);
 }
 
 // speed is in knots
@@ -56,7 +56,17 @@ struct adsb_pos {
 	int32_t altitude;
 };
 
-const float adsb_lat_lut[58] = {
+/* Positions as binary angles, 2^32 to the turn. CPR zones then wrap by
+ * themselves, and decoding needs no floating point.
+ */
+struct cpr_fix {
+	bool valid;
+	int32_t latitude;
+	int32_t longitude;
+};
+
+// NL zone transition latitudes, in degrees
+constexpr float adsb_lat_lut[58] = {
 	10.47047130,    14.82817437,    18.18626357,    21.02939493,
     23.54504487,    25.82924707,    27.93898710,    29.91135686,
     31.77209708,    33.53993436,    35.22899598,    36.85025108,
@@ -82,7 +92,15 @@ std::string decode_frame_id(ADSBFrame& frame);
 void encode_frame_pos(ADSBFrame& frame, const uint32_t ICAO_address, const int32_t altitude,
 	const float latitude, const float longitude, const uint32_t time_parity);
 
-adsb_pos decode_frame_pos(ADSBFrame& frame_even, ADSBFrame& frame_odd);
+/* Global decoding, from an even and an odd frame. Gives the position of
+ * the most recent one, and makes it the reference for local decoding.
+ */
+adsb_pos decode_frame_pos(ADSBFrame& frame_even, ADSBFrame& frame_odd, cpr_fix& reference);
+
+/* Local decoding, from a single frame and a reference fix less than half a
+ * zone away (about 180 NM). The reference moves to the new position.
+ */
+adsb_pos decode_frame_pos_local(ADSBFrame& frame, const bool odd, cpr_fix& reference);
 
 void encode_frame_velo(ADSBFrame& frame, const uint32_t ICAO_address, const uint32_t speed,
 	const float angle, const int32_t v_rate);
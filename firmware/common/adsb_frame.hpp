@@ -52,6 +52,14 @@ public:
 		return rx_timestamp;
 	}
 
+	// Baseband sample index of the preamble's first pulse.
+	void set_sample_index(const uint64_t value) {
+		sample_index = value;
+	}
+	uint64_t get_sample_index() const {
+		return sample_index;
+	}
+
 	void clear() {
 		index = 0;
 		memset(raw_data, 0, 14);
@@ -97,6 +105,7 @@ private:
 	alignas(4) uint8_t index { 0 };
 	alignas(4) uint8_t raw_data[14] { };	// 112 bits at most
 	uint32_t rx_timestamp { };
+	uint64_t sample_index { 0 };
 
 	uint32_t compute_CRC() {
 		uint8_t adsb_crc[14] = { 0 };	// Temp buffer
@@ -109,6 +109,8 @@ public:
 	bool is_valid() const;
 
 	Timestamp received_at() const;
+	uint64_t sample_index() const { return packet_.sample_index(); }
+	const baseband::Packet& raw() const { return packet_; }
 
 	uint32_t message_id() const;
 	MMSI user_id() const;
@@ -128,7 +128,10 @@ bool AK4951::reset() {
 
 void AK4951::set_digtal_volume_control(const reg_t value) {
 	map.r.l_ch_digital_volume_control.DV = value;
-	update(Register::LchDigitalVolumeControl);
+	// Queued, the UI sets it as the encoder turns.
+	const auto reg = toUType(Register::LchDigitalVolumeControl);
+	const std::array<uint8_t, 2> tx { reg, map.w[reg] };
+	bus.transmit_queued(bus_address, tx.data(), tx.size(), reg);
 }
 
 void AK4951::set_headphone_volume(const volume_t volume) {
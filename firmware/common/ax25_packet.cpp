@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2018 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "ax25_packet.hpp"
+
+namespace ax25 {
+
+namespace {
+
+constexpr uint8_t address_extension = 0x01;
+constexpr uint8_t repeated = 0x80;
+
+constexpr uint8_t control_ui = 0x03;
+constexpr uint8_t control_poll_final = 0x10;
+
+} /* namespace */
+
+size_t Packet::address_count() const {
+	// The last address has its extension bit set.
+	for(size_t n=0; n<addresses_max; n++) {
+		const size_t last = (n + 1) * address_length - 1;
+		if( last >= length_ ) {
+			break;
+		}
+		if( data_[last] & address_extension ) {
+			return n + 1;
+		}
+	}
+	return 0;
+}
+
+size_t Packet::information_index() const {
+	// Control, then PID.
+	const size_t count = address_count();
+	return (count >= 2) ? (count * address_length + 2) : length_;
+}
+
+std::string Packet::address(const size_t index) const {
+	const size_t start = index * address_length;
+	if( index >= address_count() ) {
+		return { };
+	}
+
+	std::string result;
+	for(size_t i=0; i<6; i++) {
+		const char c = data_[start + i] >> 1;
+		if( c != ' ' ) {
+			result += c;
+		}
+	}
+	const uint8_t ssid = (data_[start + 6] >> 1) & 0x0f;
+	if( ssid ) {
+		result += '-';
+		if( ssid >= 10 ) {
+			result += '1';
+		}
+		result += '0' + (ssid % 10);
+	}
+	return result;
+}
+
+std::string Packet::destination() const {
+	return address(0);
+}
+
+std::string Packet::source() const {
+	return address(1);
+}
+
+std::string Packet::path() const {
+	std::string result;
+	const size_t count = address_count();
+	for(size_t n=2; n<count; n++) {
+		if( n > 2 ) {
+			result += ',';
+		}
+		result += address(n);
+		if( data_[n * address_length + 6] & repeated ) {
+			result += '*';
+		}
+	}
+	return result;
+}
+
+uint8_t Packet::control() const {
+	const size_t index = address_count() * address_length;
+	return (index && (index < length_)) ? data_[index] : 0;
+}
+
+bool Packet::is_ui() const {
+	return (control() & ~control_poll_final) == control_ui;
+}
+
+std::string Packet::info() const {
+	if( !is_ui() ) {
+		return { };
+	}
+	const size_t start = information_index();
+	return (start < length_) ? std::string { reinterpret_cast<const char*>(&data_[start]), length_ - start } : std::string { };
+}
+
+} /* namespace ax25 */
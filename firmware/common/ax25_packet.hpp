@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2018 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __AX25_PACKET_H__
+#define __AX25_PACKET_H__
+
+#include "baseband.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <string>
+
+namespace ax25 {
+
+/* One AX.25 frame as the M4 deframed it: destuffed bytes from the first
+ * address to the end of the information field, FCS checked and stripped.
+ */
+class Packet {
+public:
+	/* Destination, source and up to 8 digipeaters, control, PID, and the
+	 * default 256 byte maximum information field.
+	 */
+	static constexpr size_t address_length = 7;
+	static constexpr size_t addresses_max = 10;
+	static constexpr size_t length_max = address_length * addresses_max + 1 + 1 + 256;
+
+	void set_timestamp(const Timestamp& value) {
+		timestamp_ = value;
+	}
+
+	/* Returns false once the frame is too long to be valid. */
+	bool push_back(const uint8_t c) {
+		if( length_ < data_.size() ) {
+			data_[length_++] = c;
+			return true;
+		}
+		return false;
+	}
+
+	void clear() {
+		length_ = 0;
+	}
+
+	size_t length() const {
+		return length_;
+	}
+
+	Timestamp received_at() const {
+		return timestamp_;
+	}
+
+	std::string destination() const;
+	std::string source() const;
+	/* Digipeaters, comma separated, "*" after those that repeated it. */
+	std::string path() const;
+	uint8_t control() const;
+	bool is_ui() const;
+	/* Information field of UI frames, empty for anything else. */
+	std::string info() const;
+
+private:
+	Timestamp timestamp_ { };
+	uint16_t length_ { 0 };
+	std::array<uint8_t, length_max> data_ { };
+
+	size_t address_count() const;
+	size_t information_index() const;
+	std::string address(const size_t index) const;
+};
+
+} /* namespace ax25 */
+
+#endif/*__AX25_PACKET_H__*/
@@ -24,8 +24,9 @@
 
 #include "baseband.hpp"
 
+#include <cstdint>
 #include <cstddef>
-#include <bitset>
+#include <array>
 
 namespace baseband {
 
@@ -39,14 +40,43 @@ public:
 		return timestamp_;
 	}
 
+	/* Baseband sample index at the end of the sync word, a fixed filter
+	 * delay late, for decoders that track it; 0 for the others. The M0's
+	 * sample_clock maps it to RTC time.
+	 */
+	void set_sample_index(const uint64_t value) {
+		sample_index_ = value;
+	}
+
+	uint64_t sample_index() const {
+		return sample_index_;
+	}
+
 	void add(const bool symbol) {
 		if( count < capacity() ) {
-			data[count++] = symbol;
+			const uint32_t bit = static_cast<uint32_t>(symbol) << (31 - (count & 31));
+			// A word's first bit resets it, so clear() needn't.
+			data[count >> 5] = (count & 31) ? (data[count >> 5] | bit) : bit;
+			count++;
 		}
 	}
 
 	uint_fast8_t operator[](const size_t index) const {
-		return (index < size()) ? data[index] : 0;
+		return (index < size()) ? ((data[index >> 5] >> (31 - (index & 31))) & 1) : 0;
+	}
+
+	/* length (up to 32) symbols from start, the first in the MSB of the
+	 * result, as FieldReader reads them. Symbols past the end read as zero.
+	 */
+	uint32_t read(const size_t start, const size_t length) const {
+		if( (length == 0) || (start >= size()) ) {
+			return 0;
+		}
+		const size_t n = start >> 5;
+		const uint64_t pair = (static_cast<uint64_t>(data[n]) << 32) | (((n + 1) < data.size()) ? data[n + 1] : 0);
+		const uint32_t value = (pair << (start & 31)) >> (64 - length);
+		const size_t past_end = (start + length > size()) ? (start + length - size()) : 0;
+		return (past_end >= 32) ? 0 : ((value >> past_end) << past_end);
 	}
 
 	size_t size() const {
@@ -54,7 +84,7 @@ public:
 	}
 
 	size_t capacity() const {
-		return data.size();
+		return data.size() * 32;
 	}
 
 	void clear() {
@@ -62,8 +92,10 @@ public:
 	}
 
 private:
-	std::bitset<2560> data { };
+	// Packed MSB first.
+	std::array<uint32_t, 2560 / 32> data { };
 	Timestamp timestamp_ { };
+	uint64_t sample_index_ { 0 };
 	size_t count { 0 };
 };
 
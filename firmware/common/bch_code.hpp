@@ -25,37 +25,27 @@
 #ifndef __BCHCODE_H__
 #define __BCHCODE_H__
 
-#include <vector>
-
-class BCHCode {
-public:
-	BCHCode(std::vector<int> p_init, int m, int n, int k, int t);
-	~BCHCode();
-	
-	BCHCode(const BCHCode&) = delete;
-	BCHCode(BCHCode&&) = delete;
-	BCHCode& operator=(const BCHCode&) = delete;
-	BCHCode& operator=(BCHCode&&) = delete;
-
-	int * encode(int data[]);
-	int decode(int recd[]);
-	
-private:
-	void gen_poly();
-	void generate_gf();
-	
-	bool valid { false };
-
-	int d { };
-	int * p { };			// coefficients of primitive polynomial used to generate GF(2**5)
-	int m { };				// order of the field GF(2**5) = 5
-	int n { };				// 2**5 - 1 = 31
-	int k { };				// n - deg(g(x)) = 21 = dimension
-	int t { };				// 2 = error correcting capability
-	int * alpha_to { };		// log table of GF(2**5)
-	int * index_of { };		// antilog table of GF(2**5)
-	int * g { };			// coefficients of generator polynomial, g(x) [n - k + 1]=[11]
-	int * bb { };			// coefficients of redundancy polynomial ( x**(10) i(x) ) modulo g(x)
-};
+#include <cstdint>
+
+/* POCSAG's BCH(31,21) code, t = 2, worked on whole 32-bit codewords: data
+ * in bits 31-11, checks in 10-1 (x^n is bit n + 1, generator
+ * x^10 + x^9 + x^8 + x^6 + x^5 + x^3 + 1), even parity in bit 0. Both ways
+ * go through one remainder table, a byte at a time; decoding then looks
+ * the syndrome up in a table of error patterns. All built at compile time.
+ */
+namespace bch {
+
+/* The codeword's data with its checks and parity filled in. */
+uint32_t encode(const uint32_t codeword);
+
+/* Bits 31-1 modulo the generator, 0 for a codeword. */
+uint32_t syndrome(const uint32_t codeword);
+
+/* Corrects up to two errors in bits 31-1 and sets the parity. Beyond
+ * that, returns false and leaves the codeword as it was.
+ */
+bool correct(uint32_t& codeword);
+
+} /* namespace bch */
 
 #endif/*__BCHCODE_H__*/
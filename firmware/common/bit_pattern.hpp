@@ -44,7 +44,8 @@ public:
 	constexpr BitPattern(
 	) : code_ { 0 },
 		mask_ { 0 },
-		maximum_hanning_distance_ { 0 }
+		maximum_hanning_distance_ { 0 },
+		narrow_ { true }
 	{
 	}
 	
@@ -54,13 +55,17 @@ public:
 		const size_t maximum_hanning_distance = 0
 	) : code_ { code },
 		mask_ { (1ULL << code_length) - 1ULL },
-		maximum_hanning_distance_ { maximum_hanning_distance }
+		maximum_hanning_distance_ { maximum_hanning_distance },
+		narrow_ { code_length <= 32 }
 	{
 	}
 
 	bool operator()(const BitHistory& history, const size_t) const {
 		const auto delta_bits = (history.value() ^ code_) & mask_;
-		const size_t count = __builtin_popcountll(delta_bits);
+		// Most sync words fit 32 bits, halving the (library) popcount on M4.
+		const size_t count = narrow_
+			? __builtin_popcount(static_cast<uint32_t>(delta_bits))
+			: __builtin_popcountll(delta_bits);
 		return (count <= maximum_hanning_distance_);
 	}
 
@@ -68,6 +73,7 @@ private:
 	uint64_t code_;
 	uint64_t mask_;
 	size_t maximum_hanning_distance_;
+	bool narrow_;
 };
 
 #endif/*__BIT_PATTERN_H__*/
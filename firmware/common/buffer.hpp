@@ -53,12 +53,15 @@ struct buffer_t {
 	const size_t count;
 	const uint32_t sampling_rate;
 	const Timestamp timestamp;
+	// Of the first sample, counted at the baseband rate (see BasebandThread).
+	const uint64_t sample_index;
 
 	constexpr buffer_t(
 	) : p { nullptr },
 		count { 0 },
 		sampling_rate { 0 },
-		timestamp { }
+		timestamp { },
+		sample_index { 0 }
 	{
 	}
 
@@ -67,7 +70,8 @@ struct buffer_t {
 	) : p { other.p },
 		count { other.count },
 		sampling_rate { other.sampling_rate },
-		timestamp { other.timestamp }
+		timestamp { other.timestamp },
+		sample_index { other.sample_index }
 	{
 	}
 
@@ -75,11 +79,13 @@ struct buffer_t {
 		T* const p,
 		const size_t count,
 		const uint32_t sampling_rate = 0,
-		const Timestamp timestamp = { }
+		const Timestamp timestamp = { },
+		const uint64_t sample_index = 0
 	) : p { p },
 		count { count },
 		sampling_rate { sampling_rate },
-		timestamp { timestamp }
+		timestamp { timestamp },
+		sample_index { sample_index }
 	{
 	}
 
@@ -26,19 +26,25 @@
 #include <ch.h>
 
 void* operator new(size_t size) {
-	return chHeapAlloc(0x0, size);
+	const auto p = chibios::Arena::allocate(size);
+	return p ? p : chHeapAlloc(0x0, size);
 }
 
 void* operator new[](size_t size) {
-	return chHeapAlloc(0x0, size);
+	const auto p = chibios::Arena::allocate(size);
+	return p ? p : chHeapAlloc(0x0, size);
 }
 
 void operator delete(void* p) noexcept {
-	chHeapFree(p);
+	if( !chibios::Arena::release(p) ) {
+		chHeapFree(p);
+	}
 }
 
 void operator delete[](void* p) noexcept {
-	chHeapFree(p);
+	if( !chibios::Arena::release(p) ) {
+		chHeapFree(p);
+	}
 }
 
 void operator delete(void* ptr, std::size_t) noexcept {
@@ -49,6 +55,10 @@ void operator delete[](void* ptr, std::size_t) noexcept {
 	::operator delete(ptr);
 }
 
+extern uint8_t __main_stack_base__[];
+extern uint8_t __process_stack_end__[];
+extern uint8_t _data[];
+extern uint8_t _bss_end[];
 extern uint8_t __heap_base__[];
 extern uint8_t __heap_end__[];
 
@@ -65,4 +75,170 @@ size_t heap_used() {
 	return heap_size() - (core_free + heap_free);
 }
 
+size_t heap_high_water() {
+	return heap_size() - chCoreStatus();
+}
+
+RAMLayout ram_layout() {
+	return {
+		reinterpret_cast<uint32_t>(__main_stack_base__),
+		reinterpret_cast<uint32_t>(__process_stack_end__),
+		reinterpret_cast<uint32_t>(_data),
+		reinterpret_cast<uint32_t>(_bss_end),
+		reinterpret_cast<uint32_t>(__heap_base__),
+		reinterpret_cast<uint32_t>(__heap_end__),
+		chCoreStatus()
+	};
+}
+
+/* chheap.c keeps the default heap to itself, but every block it hands out
+ * points back at its heap.
+ */
+static MemoryHeap* default_heap() {
+	static MemoryHeap* heap { nullptr };
+	if( !heap ) {
+		const auto p = chHeapAlloc(0x0, 1);
+		if( p ) {
+			heap = (static_cast<union heap_header*>(p) - 1)->h.u.heap;
+			chHeapFree(p);
+		}
+	}
+	return heap;
+}
+
+size_t heap_free_blocks(HeapBlock* const blocks, const size_t count_max) {
+	const auto heap = default_heap();
+	if( !heap ) {
+		return 0;
+	}
+
+	size_t count = 0;
+	chMtxLock(&heap->h_mtx);
+	for(auto qp = heap->h_free.h.u.next; qp; qp = qp->h.u.next) {
+		if( count < count_max ) {
+			blocks[count] = { reinterpret_cast<uint32_t>(qp + 1), qp->h.size };
+		}
+		count++;
+	}
+	chMtxUnlock();
+	return count;
+}
+
+/* Arena *****************************************************************/
+
+Arena* Arena::live { nullptr };
+Arena* Arena::active { nullptr };
+Thread* Arena::active_thread { nullptr };
+
+Arena::Scope::Scope(
+	Arena* const arena
+) : previous_arena { active },
+	previous_thread { active_thread }
+{
+	chSysLock();
+	active = arena;
+	active_thread = chThdSelf();
+	chSysUnlock();
+}
+
+Arena::Scope::~Scope() {
+	chSysLock();
+	active = previous_arena;
+	active_thread = previous_thread;
+	chSysUnlock();
+}
+
+Arena::Arena(
+	const size_t size
+) : base { static_cast<uint8_t*>(chHeapAlloc(0x0, size)) },
+	size_ { base ? MEM_ALIGN_NEXT(size) : 0 }
+{
+	chSysLock();
+	next = live;
+	live = this;
+	chSysUnlock();
+}
+
+Arena::~Arena() {
+	chSysLock();
+	for(auto p = &live; *p; p = &(*p)->next) {
+		if( *p == this ) {
+			*p = next;
+			break;
+		}
+	}
+	if( active == this ) {
+		active = nullptr;
+	}
+	chSysUnlock();
+
+	if( base ) {
+		chHeapFree(base);
+	}
+}
+
+size_t Arena::count() {
+	size_t n = 0;
+	chSysLock();
+	for(auto a = live; a; a = a->next) {
+		n++;
+	}
+	chSysUnlock();
+	return n;
+}
+
+size_t Arena::total_size() {
+	size_t n = 0;
+	chSysLock();
+	for(auto a = live; a; a = a->next) {
+		n += a->size_;
+	}
+	chSysUnlock();
+	return n;
+}
+
+size_t Arena::total_used() {
+	size_t n = 0;
+	chSysLock();
+	for(auto a = live; a; a = a->next) {
+		n += a->used_;
+	}
+	chSysUnlock();
+	return n;
+}
+
+void* Arena::allocate(const size_t size) {
+	void* p = nullptr;
+	const auto aligned_size = MEM_ALIGN_NEXT(size);
+
+	chSysLock();
+	const auto arena = active;
+	if( arena && (active_thread == chThdSelf()) && (aligned_size <= arena->size_ - arena->used_) ) {
+		arena->last = arena->used_;
+		arena->used_ += aligned_size;
+		p = arena->base + arena->last;
+	}
+	chSysUnlock();
+
+	return p;
+}
+
+bool Arena::release(void* const p) {
+	bool found = false;
+
+	chSysLock();
+	for(auto a = live; a; a = a->next) {
+		if( a->contains(p) ) {
+			if( p == a->base + a->last ) {
+				a->used_ = a->last;
+			}
+			found = true;
+			break;
+		}
+	}
+	chSysUnlock();
+
+	return found;
+}
+
 } /* namespace chibios */
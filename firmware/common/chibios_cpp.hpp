@@ -23,6 +23,7 @@
 #define __CHIBIOS_CPP_H__
 
 #include <cstddef>
+#include <cstdint>
 
 /* Override new/delete to use Chibi/OS heap functions */
 /* NOTE: Do not inline these, it doesn't work. ;-) */
@@ -33,11 +34,114 @@ void operator delete[](void* p);
 void operator delete(void* ptr, std::size_t);
 void operator delete[](void* ptr, std::size_t);
 
+struct Thread;
+
 namespace chibios {
 
 size_t heap_size();
 size_t heap_used();
 
+/* The most the heap has ever taken from core memory. The heap never gives
+ * memory back, so this is its high-water mark.
+ */
+size_t heap_high_water();
+
+/* The calling core's RAM, as its linker script lays it out: interrupt and
+ * main stacks, .data and .bss (DMA buffers included), then the heap. The
+ * core allocator hands the heap out from the bottom; core_free is what it
+ * has left at the top.
+ */
+struct RAMLayout {
+	uint32_t stacks_base;
+	uint32_t stacks_end;
+	uint32_t data_base;
+	uint32_t bss_end;
+	uint32_t heap_base;
+	uint32_t heap_end;
+	uint32_t core_free;
+};
+
+RAMLayout ram_layout();
+
+struct HeapBlock {
+	uint32_t base;
+	uint32_t size;
+};
+
+/* Copies up to count_max of the heap's free blocks, in address order, and
+ * returns how many there are in all. Sizes are as chHeapStatus() counts
+ * them, without the block header.
+ */
+size_t heap_free_blocks(HeapBlock* const blocks, const size_t count_max);
+
+/* One heap block that operator new bumps through while an Arena::Scope for
+ * it is active on the creating thread, released in one go with the Arena.
+ * Deleting an arena allocation does nothing, except that the most recent
+ * one is rolled back so construction temporaries don't pile up. Once the
+ * block is used up, allocations go to the heap as usual.
+ */
+class Arena {
+public:
+	class Scope {
+	public:
+		/* nullptr sends allocations back to the heap, e.g. for bookkeeping
+		 * that must outlive an enclosing scope's arena.
+		 */
+		Scope(Arena* const arena);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope(Scope&&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		Scope& operator=(Scope&&) = delete;
+
+	private:
+		Arena* const previous_arena;
+		Thread* const previous_thread;
+	};
+
+	Arena(const size_t size);
+	~Arena();
+
+	Arena(const Arena&) = delete;
+	Arena(Arena&&) = delete;
+	Arena& operator=(const Arena&) = delete;
+	Arena& operator=(Arena&&) = delete;
+
+	size_t size() const {
+		return size_;
+	}
+
+	size_t used() const {
+		return used_;
+	}
+
+	static size_t count();
+	static size_t total_size();
+	static size_t total_used();
+
+	/* nullptr when no arena is active on this thread, or it is full. */
+	static void* allocate(const size_t size);
+
+	/* false if p isn't in a live arena, and so came from the heap. */
+	static bool release(void* const p);
+
+private:
+	uint8_t* const base;
+	const size_t size_;
+	size_t used_ { 0 };
+	size_t last { 0 };
+	Arena* next { nullptr };
+
+	static Arena* live;
+	static Arena* active;
+	static Thread* active_thread;
+
+	bool contains(const void* const p) const {
+		return (p >= base) && (p < base + size_);
+	}
+};
+
 } /* namespace chibios */
 
 #endif/*__CHIBIOS_CPP_H__*/
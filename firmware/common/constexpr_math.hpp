@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2018 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CONSTEXPR_MATH_H__
+#define __CONSTEXPR_MATH_H__
+
+#include <cstddef>
+#include <cstdint>
+
+/* Compile-time trigonometry, roots and logarithms, for generating window,
+ * twiddle and filter tables without pasting numpy output into headers.
+ * Not for run-time use.
+ */
+
+namespace constexpr_math {
+
+constexpr double pi = 3.14159265358979323846;
+
+constexpr double sin(double x) {
+	while( x >  pi ) x -= 2.0 * pi;
+	while( x < -pi ) x += 2.0 * pi;
+
+	double term = x;
+	double sum = x;
+	for(size_t k=1; k<12; k++) {
+		term *= -x * x / ((2 * k) * (2 * k + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+constexpr double cos(const double x) {
+	return sin(x + pi / 2.0);
+}
+
+constexpr double sinc(const double x) {
+	return (x == 0.0) ? 1.0 : (sin(pi * x) / (pi * x));
+}
+
+constexpr double sqrt(const double x) {
+	if( x <= 0.0 ) {
+		return 0.0;
+	}
+	double r = (x > 1.0) ? x : 1.0;
+	for(size_t k=0; k<64; k++) {
+		const double next = 0.5 * (r + x / r);
+		if( next >= r ) {
+			break;
+		}
+		r = next;
+	}
+	return r;
+}
+
+constexpr double ln2 = 0.69314718055994530942;
+
+constexpr double exp(const double x) {
+	const int n = static_cast<int>((x >= 0.0) ? (x / ln2 + 0.5) : (x / ln2 - 0.5));
+	const double r = x - n * ln2;
+
+	double term = 1.0;
+	double sum = 1.0;
+	for(size_t k=1; k<20; k++) {
+		term *= r / k;
+		sum += term;
+	}
+	for(int i=0; i<n; i++) sum *= 2.0;
+	for(int i=0; i>n; i--) sum *= 0.5;
+	return sum;
+}
+
+/* x > 0 only. */
+constexpr double log(double x) {
+	int n = 0;
+	while( x > 1.5 ) { x *= 0.5; n++; }
+	while( x < 0.75 ) { x *= 2.0; n--; }
+
+	const double y = (x - 1.0) / (x + 1.0);
+	double term = y;
+	double sum = 0.0;
+	for(size_t k=1; k<40; k+=2) {
+		sum += term / k;
+		term *= y * y;
+	}
+	return 2.0 * sum + n * ln2;
+}
+
+constexpr double pow(const double x, const double y) {
+	return (x <= 0.0) ? 0.0 : exp(y * log(x));
+}
+
+constexpr int16_t to_q15(const double x) {
+	return (x >= 1.0) ? 32767
+		: ((x <= -1.0) ? -32768
+		: static_cast<int16_t>((x >= 0.0) ? (x * 32767.0 + 0.5) : (x * 32767.0 - 0.5)));
+}
+
+} /* namespace constexpr_math */
+
+#endif/*__CONSTEXPR_MATH_H__*/
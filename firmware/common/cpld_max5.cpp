@@ -108,10 +108,10 @@ bool CPLD::verify(
 	const std::array<uint16_t, 3328>& block_0,
 	const std::array<uint16_t, 512>& block_1
 ) {
-	/* Verify */
-	const auto block_0_success = verify_block(0x0000, block_0);
-	const auto block_1_success = verify_block(0x0001, block_1);
-	return block_0_success && block_1_success;
+	/* Verify, stopping at the first difference. A mismatch means a full
+	 * erase and program anyway, so there's nothing to gain reading on.
+	 */
+	return verify_block(0x0000, block_0) && verify_block(0x0001, block_1);
 }
 
 uint32_t CPLD::crc() {
@@ -194,21 +194,15 @@ bool CPLD::verify_block(
 	shift_ir(0x205);			// Read
 	jtag.runtest_tck(93);		// 5us
 
-	bool success = true;
 	for(size_t i=0; i<count; i++) {
 		const auto from_device = jtag.shift_dr(16, 0xffff);
-		if( (id == 0) && (i == 0) ) {
-			// Account for bit that indicates bitstream is valid.
-			if( (from_device & 0xfbff) != (data[i] & 0xfbff) ) {
-				success = false;
-			}
-		} else {
-			if( from_device != data[i] ) {
-				success = false;
-			}
+		// Account for bit that indicates bitstream is valid.
+		const uint16_t mask = ((id == 0) && (i == 0)) ? 0xfbff : 0xffff;
+		if( (from_device & mask) != (data[i] & mask) ) {
+			return false;
 		}
 	}
-	return success;
+	return true;
 }
 
 bool CPLD::is_blank_block(const uint16_t id, const size_t count) {
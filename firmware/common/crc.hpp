@@ -26,6 +26,7 @@
 #include <cstdint>
 #include <limits>
 #include <array>
+#include <type_traits>
 
 /* Inspired by
  * http://www.barrgroup.com/Embedded-Systems/How-To/CRC-Calculation-C-Code
@@ -153,6 +154,261 @@ private:
 	}
 };
 
+/* CRC<> with the polynomial fixed at compile time, so its tables can be:
+ * a byte at a time from one 256 entry table, or with Slices = 4 a 32-bit
+ * word at a time from four (slice-by-4, 4KB of flash an instantiation),
+ * from the first word aligned byte on. Checksums match CRC<> with the same
+ * parameters, for whole bytes; widths from 8 to 32 bits.
+ *
+ * The register is kept as the table lookups want it: reflected, in the low
+ * bits, when RevIn; otherwise left aligned in the 32 bits, which makes any
+ * width's update the same as CRC-32's.
+ *
+ * The checksum is linear in the data, so flipping some bits changes it by
+ * the XOR of their syndromes whatever the rest of the message is. Distances
+ * count back from the last bit processed (0), in the order bits go in:
+ * each byte LSB first when RevIn. A flipped bit in a received checksum is
+ * a syndrome of that bit alone. correct_single() and correct_double() look
+ * for the one or two data bits that explain a checksum mismatch, the first
+ * that does: past the message lengths a polynomial guarantees that for,
+ * others may too.
+ */
+template<size_t Width, uint32_t Polynomial, bool RevIn = false, bool RevOut = false, size_t Slices = 1>
+class TableCRC {
+public:
+	using value_type = uint32_t;
+
+	static_assert((Width >= 8) && (Width <= 32), "TableCRC width is 8 to 32 bits");
+	static_assert((Slices == 1) || (Slices == 4), "TableCRC is byte or slice-by-4");
+
+	constexpr TableCRC(
+		const value_type initial_remainder = 0,
+		const value_type final_xor_value = 0
+	) : initial_remainder { to_register(initial_remainder) },
+		final_xor_value { final_xor_value },
+		remainder { to_register(initial_remainder) }
+	{
+	}
+
+	void reset(value_type new_initial_remainder) {
+		remainder = to_register(new_initial_remainder);
+	}
+
+	void reset() {
+		remainder = initial_remainder;
+	}
+
+	void process_byte(const uint8_t byte) {
+		remainder = step_byte(remainder, byte);
+	}
+
+	void process_bytes(const void* const data, const size_t length) {
+		const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+		const uint8_t* const end = p + length;
+		p = process_words(p, end, std::integral_constant<bool, (Slices == 4)> { });
+		for(; p < end; p++) {
+			process_byte(*p);
+		}
+	}
+
+	template<size_t N>
+	void process_bytes(const std::array<uint8_t, N>& data) {
+		process_bytes(data.data(), data.size());
+	}
+
+	value_type checksum() const {
+		return to_checksum(remainder) ^ (final_xor_value & mask());
+	}
+
+	/* Syndromes of single bit errors, from distance 0 on back, one bit at a time. */
+	class BitErrors {
+	public:
+		value_type syndrome() const {
+			return to_checksum(s);
+		}
+
+		size_t distance() const {
+			return d;
+		}
+
+		void next() {
+			s = step_bit(s);
+			d++;
+		}
+
+	private:
+		friend class TableCRC;
+
+		value_type s { step_bit(RevIn ? 1 : top_bit()) };
+		size_t d { 0 };
+	};
+
+	static value_type bit_error(const size_t distance) {
+		// Whole zero bytes by table, the rest by bit.
+		value_type s = step_bit(RevIn ? 1 : top_bit());
+		for(size_t i=0; i<(distance / 8); i++) {
+			s = step_byte(s, 0);
+		}
+		for(size_t i=0; i<(distance % 8); i++) {
+			s = step_bit(s);
+		}
+		return to_checksum(s);
+	}
+
+	/* The data bit, in the last bit_count processed, whose flip accounts for
+	 * syndrome (computed ^ received checksum).
+	 */
+	static bool correct_single(const value_type syndrome, const size_t bit_count, size_t& distance) {
+		const auto target = from_checksum(syndrome);
+		BitErrors e;
+		for(; e.d<bit_count; e.next()) {
+			if( e.s == target ) {
+				distance = e.d;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/* As correct_single(), two bits, distance_0 < distance_1. bit_count^2 / 2
+	 * steps: a 112 bit ADS-B frame is ~6000.
+	 */
+	static bool correct_double(const value_type syndrome, const size_t bit_count, size_t& distance_0, size_t& distance_1) {
+		const auto target = from_checksum(syndrome);
+		for(BitErrors e0; e0.d<bit_count; e0.next()) {
+			const auto rest = target ^ e0.s;
+			BitErrors e1 = e0;
+			for(e1.next(); e1.d<bit_count; e1.next()) {
+				if( e1.s == rest ) {
+					distance_0 = e0.d;
+					distance_1 = e1.d;
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+private:
+	struct Tables {
+		value_type t[Slices][256];
+	};
+
+	static constexpr size_t shift = 32 - Width;
+
+	static const Tables tables;
+
+	const value_type initial_remainder;
+	const value_type final_xor_value;
+	value_type remainder;
+
+	static constexpr value_type top_bit() {
+		return 0x80000000U;
+	}
+
+	static constexpr value_type mask() {
+		return 0xffffffffU >> shift;
+	}
+
+	static constexpr value_type reflect(value_type x, const size_t width) {
+		value_type reflection = 0;
+		for(size_t i=0; i<width; ++i) {
+			reflection = (reflection << 1) | (x & 1);
+			x >>= 1;
+		}
+		return reflection;
+	}
+
+	static constexpr value_type polynomial() {
+		return RevIn ? reflect(Polynomial & mask(), Width) : (Polynomial << shift);
+	}
+
+	static constexpr value_type step_bit(const value_type r) {
+		return RevIn
+			? ((r >> 1) ^ ((r & 1) ? polynomial() : 0))
+			: ((r << 1) ^ ((r & top_bit()) ? polynomial() : 0));
+	}
+
+	static value_type step_byte(const value_type r, const uint8_t byte) {
+		return RevIn
+			? ((r >> 8) ^ tables.t[0][(r ^ byte) & 0xff])
+			: ((r << 8) ^ tables.t[0][(r >> 24) ^ byte]);
+	}
+
+	static constexpr Tables make_tables() {
+		Tables result { };
+		for(size_t i=0; i<256; i++) {
+			value_type r = RevIn ? i : (i << 24);
+			for(size_t n=0; n<8; n++) {
+				r = step_bit(r);
+			}
+			result.t[0][i] = r;
+		}
+		// Slice k: byte i followed by k zero bytes.
+		for(size_t k=1; k<Slices; k++) {
+			for(size_t i=0; i<256; i++) {
+				const auto r = result.t[k - 1][i];
+				result.t[k][i] = RevIn
+					? ((r >> 8) ^ result.t[0][r & 0xff])
+					: ((r << 8) ^ result.t[0][r >> 24]);
+			}
+		}
+		return result;
+	}
+
+	const uint8_t* process_words(const uint8_t* p, const uint8_t* const, std::false_type) {
+		return p;
+	}
+
+	const uint8_t* process_words(const uint8_t* p, const uint8_t* const end, std::true_type) {
+		// The M0 doesn't do unaligned loads.
+		for(; (p < end) && (reinterpret_cast<uintptr_t>(p) & 3); p++) {
+			process_byte(*p);
+		}
+		for(; (end - p) >= 4; p += 4) {
+			// Little endian: the first byte is the low one.
+			const auto word = *reinterpret_cast<const uint32_t*>(p);
+			if( RevIn ) {
+				const auto r = remainder ^ word;
+				remainder =
+					tables.t[3][(r >>  0) & 0xff] ^
+					tables.t[2][(r >>  8) & 0xff] ^
+					tables.t[1][(r >> 16) & 0xff] ^
+					tables.t[0][(r >> 24) & 0xff];
+			} else {
+				const auto r = remainder ^ __builtin_bswap32(word);
+				remainder =
+					tables.t[3][(r >> 24) & 0xff] ^
+					tables.t[2][(r >> 16) & 0xff] ^
+					tables.t[1][(r >>  8) & 0xff] ^
+					tables.t[0][(r >>  0) & 0xff];
+			}
+		}
+		return p;
+	}
+
+	static constexpr value_type to_register(const value_type value) {
+		return RevIn ? reflect(value & mask(), Width) : ((value & mask()) << shift);
+	}
+
+	static constexpr value_type to_checksum(const value_type r) {
+		// The register's orientation, then the output's.
+		return RevOut
+			? (RevIn ? r : reflect(r >> shift, Width))
+			: (RevIn ? reflect(r, Width) : (r >> shift));
+	}
+
+	static constexpr value_type from_checksum(const value_type value) {
+		const auto c = value & mask();
+		return RevOut
+			? (RevIn ? c : (reflect(c, Width) << shift))
+			: (RevIn ? reflect(c, Width) : (c << shift));
+	}
+};
+
+template<size_t Width, uint32_t Polynomial, bool RevIn, bool RevOut, size_t Slices>
+const typename TableCRC<Width, Polynomial, RevIn, RevOut, Slices>::Tables TableCRC<Width, Polynomial, RevIn, RevOut, Slices>::tables = make_tables();
+
 class Adler32 {
 public:
 	void feed(const uint8_t v) {
@@ -160,9 +416,20 @@ public:
 	}
 
 	void feed(const void* const data, const size_t n) {
-		const uint8_t* const p = reinterpret_cast<const uint8_t*>(data);
-		for(size_t i=0; i<n; i++) {
-			feed_one(p[i]);
+		// Reduce once per run of nmax bytes, the most that can't overflow
+		// 32 bits. The M0 has no divide instruction.
+		const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+		size_t remaining = n;
+		while( remaining ) {
+			const size_t run = (remaining < nmax) ? remaining : nmax;
+			for(size_t i=0; i<run; i++) {
+				a += p[i];
+				b += a;
+			}
+			a %= mod;
+			b %= mod;
+			p += run;
+			remaining -= run;
 		}
 	}
 
@@ -182,6 +449,7 @@ public:
 
 private:
 	static constexpr uint32_t mod = 65521;
+	static constexpr size_t nmax = 5552;
 
 	uint32_t a { 1 };
 	uint32_t b { 0 };
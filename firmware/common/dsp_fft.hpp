@@ -28,10 +28,13 @@
 #include <cmath>
 #include <type_traits>
 #include <array>
+#include <utility>
 
 #include "dsp_types.hpp"
 #include "complex.hpp"
+#include "constexpr_math.hpp"
 #include "hal.h"
+#include "simd.hpp"
 #include "utility.hpp"
 
 namespace std {
@@ -135,4 +138,118 @@ void fft_c_preswapped(std::array<T, N>& data, const size_t from, const size_t to
 	}
 }
 
+/* Q15 radix-4 decimation-in-time FFT.
+ *
+ * The first stage gathers its inputs in digit-reversed order straight from
+ * the source array, so there is no separate fft_swap() pass. Butterflies use
+ * the M4 halving SIMD instructions and scale by 1/4 per stage, so the output
+ * is DFT(src) / N and cannot overflow.
+ */
+
+namespace fft_q15 {
+
+/* W_N^m = exp(-2 pi j m / N), packed as Q15 (real low, imaginary high). */
+template<size_t N>
+constexpr uint32_t twiddle(const size_t m) {
+	return
+		  (static_cast<uint16_t>(constexpr_math::to_q15( constexpr_math::cos(2.0 * constexpr_math::pi * m / N))) <<  0)
+		| (static_cast<uint32_t>(static_cast<uint16_t>(constexpr_math::to_q15(-constexpr_math::sin(2.0 * constexpr_math::pi * m / N)))) << 16);
+}
+
+template<size_t N, size_t... I>
+constexpr std::array<uint32_t, sizeof...(I)> make_twiddles(std::index_sequence<I...>) {
+	return { { twiddle<N>(I)... } };
+}
+
+template<size_t N>
+struct Twiddles {
+	/* Radix-4 stages only ever need W^m for m < 3N/4. */
+	static constexpr std::array<uint32_t, 3 * N / 4> table {
+		make_twiddles<N>(std::make_index_sequence<3 * N / 4>())
+	};
+};
+
+template<size_t N>
+constexpr std::array<uint32_t, 3 * N / 4> Twiddles<N>::table;
+
+static inline void butterfly(vec2_s16& a, vec2_s16& b, vec2_s16& c, vec2_s16& d) {
+	const auto t0 = shadd16(a, c);
+	const auto t1 = shsub16(a, c);
+	const auto t2 = shadd16(b, d);
+	const auto t3 = shsub16(b, d);
+	a = shadd16(t0, t2);		// t0 + t2
+	b = shsax(t1, t3);			// t1 - j * t3
+	c = shsub16(t0, t2);		// t0 - t2
+	d = shasx(t1, t3);			// t1 + j * t3
+}
+
+static inline vec2_s16 load(const complex16_t& c) {
+	vec2_s16 result;
+	result.w = c.__rep();
+	return result;
+}
+
+static inline complex16_t store(const vec2_s16 v) {
+	return { v.v[0], v.v[1] };
+}
+
+/* Reverse the order of the base-4 digits of a value. */
+template<size_t Digits>
+static inline size_t digit_reverse(const size_t i) {
+	const uint32_t r = __RBIT(i) >> (32 - 2 * Digits);
+	return ((r & 0x55555555U) << 1) | ((r >> 1) & 0x55555555U);
+}
+
+} /* namespace fft_q15 */
+
+template<size_t N>
+void fft_q15_radix4(const std::array<complex16_t, N>& src, std::array<complex16_t, N>& dst) {
+	static_assert(power_of_two(N) && ((log_2(N) & 1) == 0), "only defined for N == power of four");
+	static_assert(N >= 16, "only defined for N >= 16");
+	constexpr size_t stages = log_2(N) / 2;
+	constexpr size_t quarter = N / 4;
+
+	using fft_q15::load;
+	using fft_q15::store;
+	const auto& tw = fft_q15::Twiddles<N>::table;
+
+	/* First stage: unit twiddles, digit-reversed gather. */
+	for(size_t q=0; q<quarter; q++) {
+		const size_t n = fft_q15::digit_reverse<stages - 1>(q);
+		vec2_s16 x0 = load(src[n + 0 * quarter]);
+		vec2_s16 x1 = load(src[n + 1 * quarter]);
+		vec2_s16 x2 = load(src[n + 2 * quarter]);
+		vec2_s16 x3 = load(src[n + 3 * quarter]);
+		fft_q15::butterfly(x0, x1, x2, x3);
+		dst[4 * q + 0] = store(x0);
+		dst[4 * q + 1] = store(x1);
+		dst[4 * q + 2] = store(x2);
+		dst[4 * q + 3] = store(x3);
+	}
+
+	/* Remaining stages, in place. */
+	for(size_t stage=1; stage<stages; stage++) {
+		const size_t lq = 1 << (2 * stage);
+		const size_t l = lq * 4;
+		const size_t tw_stride = N / l;
+		for(size_t k=0; k<lq; k++) {
+			vec2_s16 w1, w2, w3;
+			w1.w = tw[1 * k * tw_stride];
+			w2.w = tw[2 * k * tw_stride];
+			w3.w = tw[3 * k * tw_stride];
+			for(size_t g=k; g<N; g+=l) {
+				vec2_s16 x0 = load(dst[g + 0 * lq]);
+				vec2_s16 x1 = multiply_q15(load(dst[g + 1 * lq]), w1);
+				vec2_s16 x2 = multiply_q15(load(dst[g + 2 * lq]), w2);
+				vec2_s16 x3 = multiply_q15(load(dst[g + 3 * lq]), w3);
+				fft_q15::butterfly(x0, x1, x2, x3);
+				dst[g + 0 * lq] = store(x0);
+				dst[g + 1 * lq] = store(x1);
+				dst[g + 2 * lq] = store(x2);
+				dst[g + 3 * lq] = store(x3);
+			}
+		}
+	}
+}
+
 #endif/*__DSP_FFT_H__*/
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_FIR_DESIGN_H__
+#define __DSP_FIR_DESIGN_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <utility>
+
+#include "constexpr_math.hpp"
+
+/* Compile-time low-pass FIR design, the constexpr counterpart of
+ * tools/fir_lpf.py: a Kaiser windowed sinc with its cutoff midway between
+ * pass and stop. Beta comes from the attenuation Kaiser's formula predicts
+ * for the tap count and transition width, so a longer filter or a wider
+ * transition buys a deeper stop band without further parameters.
+ *
+ * Taps are symmetric and scaled to sum to unity, which is whatever the
+ * consuming filter treats as a gain of 1.0 (1 << 15 for the IFIR decimators,
+ * 1 << 16 for FIRAndDecimateComplex and FIR64AndDecimateBy2Real).
+ */
+
+namespace fir_design {
+
+namespace detail {
+
+/* 16 bit taps can't do much better than this anyway. */
+constexpr double attenuation_max = 96.0;
+
+constexpr double kaiser_attenuation(const size_t taps_count, const double transition_normalized) {
+	const double a = 2.285 * (taps_count - 1) * 2.0 * constexpr_math::pi * transition_normalized + 7.95;
+	return (a > attenuation_max) ? attenuation_max : a;
+}
+
+constexpr double kaiser_beta(const double attenuation) {
+	return (attenuation > 50.0) ? (0.1102 * (attenuation - 8.7))
+		: ((attenuation > 21.0) ? (0.5842 * constexpr_math::pow(attenuation - 21.0, 0.4) + 0.07886 * (attenuation - 21.0))
+		: 0.0);
+}
+
+/* Modified Bessel function of the first kind, order zero. */
+constexpr double bessel_i0(const double x) {
+	const double q = x * x / 4.0;
+	double term = 1.0;
+	double sum = 1.0;
+	for(size_t k=1; k<64; k++) {
+		term *= q / (k * k);
+		sum += term;
+		if( term < sum * 1e-15 ) {
+			break;
+		}
+	}
+	return sum;
+}
+
+constexpr double kaiser(const size_t n, const size_t length, const double beta) {
+	const double r = 2.0 * n / (length - 1) - 1.0;
+	return bessel_i0(beta * constexpr_math::sqrt(1.0 - r * r)) / bessel_i0(beta);
+}
+
+constexpr double prototype(const size_t n, const size_t length, const double cutoff, const double beta) {
+	const double t = n - (length - 1) / 2.0;
+	return 2.0 * cutoff * constexpr_math::sinc(2.0 * cutoff * t) * kaiser(n, length, beta);
+}
+
+constexpr double prototype_sum(const size_t length, const double cutoff, const double beta) {
+	double sum = 0.0;
+	for(size_t n=0; n<length; n++) {
+		sum += prototype(n, length, cutoff, beta);
+	}
+	return sum;
+}
+
+constexpr int16_t to_tap(const double x) {
+	return (x >= 32767.0) ? 32767
+		: ((x <= -32768.0) ? -32768
+		: static_cast<int16_t>((x >= 0.0) ? (x + 0.5) : (x - 0.5)));
+}
+
+template<size_t... I>
+constexpr std::array<int16_t, sizeof...(I)> make_lowpass(
+	const double cutoff, const double beta, const double scale, std::index_sequence<I...>
+) {
+	return { { to_tap(prototype(I, sizeof...(I), cutoff, beta) * scale)... } };
+}
+
+} /* namespace detail */
+
+template<size_t N>
+constexpr std::array<int16_t, N> kaiser_lowpass(
+	const double sampling_rate,
+	const double pass_frequency,
+	const double stop_frequency,
+	const double unity
+) {
+	const double cutoff = (pass_frequency + stop_frequency) / 2.0 / sampling_rate;
+	const double beta = detail::kaiser_beta(detail::kaiser_attenuation(N, (stop_frequency - pass_frequency) / sampling_rate));
+	return detail::make_lowpass(
+		cutoff, beta, unity / detail::prototype_sum(N, cutoff, beta),
+		std::make_index_sequence<N>()
+	);
+}
+
+} /* namespace fir_design */
+
+#endif/*__DSP_FIR_DESIGN_H__*/
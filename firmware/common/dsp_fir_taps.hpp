@@ -27,6 +27,7 @@
 #include <array>
 
 #include "complex.hpp"
+#include "dsp_fir_design.hpp"
 
 template<size_t N>
 struct fir_taps_real {
@@ -42,6 +43,31 @@ struct fir_taps_complex {
 	std::array<complex16_t, N> taps;
 };
 
+// NBFM 20K0F3E emission type /////////////////////////////////////////////
+
+/* Designed at compile time, see dsp_fir_design.hpp. */
+
+// IFIR image-reject filter: fs=3072000, pass=10000, stop=346000, decim=8, fout=384000
+constexpr fir_taps_real<24> taps_20k0_decim_0 {
+	.pass_frequency_normalized =  10000.0f / 3072000.0f,
+	.stop_frequency_normalized = 346000.0f / 3072000.0f,
+	.taps = fir_design::kaiser_lowpass<24>(3072000, 10000, 346000, 32768),
+};
+
+// IFIR prototype filter: fs=384000, pass=10000, stop=38000, decim=8, fout=48000
+constexpr fir_taps_real<32> taps_20k0_decim_1 {
+	.pass_frequency_normalized = 10000.0f / 384000.0f,
+	.stop_frequency_normalized = 38000.0f / 384000.0f,
+	.taps = fir_design::kaiser_lowpass<32>(384000, 10000, 38000, 32768),
+};
+
+// Channel filter: fs=48000, pass=10000, stop=14000, decim=1, fout=48000
+constexpr fir_taps_real<32> taps_20k0_channel {
+	.pass_frequency_normalized = 10000.0f / 48000.0f,
+	.stop_frequency_normalized = 14000.0f / 48000.0f,
+	.taps = fir_design::kaiser_lowpass<32>(48000, 10000, 14000, 65536),
+};
+
 // NBFM 16K0F3E emission type /////////////////////////////////////////////
 
 // IFIR image-reject filter: fs=3072000, pass=8000, stop=344000, decim=8, fout=384000
@@ -381,4 +407,44 @@ static constexpr fir_taps_real<16> taps_200k_decim_1 = {
 	} },
 };
 
+// ACARS multi-channel front end ///////////////////////////////////////////
+
+/* Channels up to 150 kHz either side of the span's center stay clear of the
+ * decim_0 aliases, so one capture covers 131.525/131.725/131.825MHz.
+ */
+
+// IFIR image-reject filter: fs=4915200, pass=155000, stop=459400, decim=8, fout=614400
+constexpr fir_taps_real<24> taps_acars_decim_0 {
+	.pass_frequency_normalized = 155000.0f / 4915200.0f,
+	.stop_frequency_normalized = 459400.0f / 4915200.0f,
+	.taps = fir_design::kaiser_lowpass<24>(4915200, 155000, 459400, 32768),
+};
+
+// IFIR prototype filter: fs=614400, pass=5000, stop=71800, decim=8, fout=76800
+constexpr fir_taps_real<32> taps_acars_decim_1 {
+	.pass_frequency_normalized = 5000.0f / 614400.0f,
+	.stop_frequency_normalized = 71800.0f / 614400.0f,
+	.taps = fir_design::kaiser_lowpass<32>(614400, 5000, 71800, 32768),
+};
+
+// ERT multi-channel front end /////////////////////////////////////////////
+
+/* Four 100 kHz slices, 150 kHz either side of the span's center at most. The
+ * slices' filters overlap, so a meter between two may decode on both.
+ */
+
+// IFIR image-reject filter: fs=4194304, pass=200000, stop=324288, decim=8, fout=524288
+constexpr fir_taps_real<24> taps_ert_decim_0 {
+	.pass_frequency_normalized = 200000.0f / 4194304.0f,
+	.stop_frequency_normalized = 324288.0f / 4194304.0f,
+	.taps = fir_design::kaiser_lowpass<24>(4194304, 200000, 324288, 32768),
+};
+
+// IFIR prototype filter: fs=524288, pass=50000, stop=212144, decim=2, fout=262144
+constexpr fir_taps_real<16> taps_ert_decim_1 {
+	.pass_frequency_normalized = 50000.0f / 524288.0f,
+	.stop_frequency_normalized = 212144.0f / 524288.0f,
+	.taps = fir_design::kaiser_lowpass<16>(524288, 50000, 212144, 32768),
+};
+
 #endif/*__DSP_FIR_TAPS_H__*/
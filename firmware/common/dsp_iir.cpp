@@ -23,6 +23,8 @@
 
 #include <hal.h>
 
+#include <cstdint>
+
 void IIRBiquadFilter::configure(const iir_biquad_config_t& new_config) {
 	config = new_config;
 }
@@ -55,3 +57,24 @@ void IIRBiquadFilter::execute(const buffer_f32_t& buffer_in, const buffer_f32_t&
 void IIRBiquadFilter::execute_in_place(const buffer_f32_t& buffer) {
 	execute(buffer, buffer);
 }
+
+void IIRBiquadFilterQ15::configure(const iir_biquad_config_t& new_config) {
+	coefficients = iir::quantize(new_config);
+}
+
+void IIRBiquadFilterQ15::execute(const buffer_s16_t& buffer_in, const buffer_s16_t& buffer_out) {
+	const auto c = coefficients;
+	auto s = state;
+
+	// TODO: Assert that buffer_out.count == buffer_in.count.
+	for(size_t i=0; i<buffer_out.count; i++) {
+		const int32_t y0 = iir::execute_section(c, s, iir::q30_from_q15(buffer_in.p[i]));
+		buffer_out.p[i] = iir::q15_from_q30(y0);
+	}
+
+	state = s;
+}
+
+void IIRBiquadFilterQ15::execute_in_place(const buffer_s16_t& buffer) {
+	execute(buffer, buffer);
+}
@@ -23,6 +23,7 @@
 #define __DSP_IIR_H__
 
 #include <array>
+#include <cstdint>
 
 #include "dsp_types.hpp"
 
@@ -67,4 +68,146 @@ private:
 	std::array<float, 3> y { { 0.0f, 0.0f, 0.0f } };
 };
 
+/* Biquad coefficients quantized for the fixed-point filters: Q29 (range
+ * +/-4), a0 dropped, a1 and a2 stored as they are subtracted.
+ */
+struct iir_biquad_q29_t {
+	std::array<int32_t, 3> b;
+	std::array<int32_t, 2> a;
+};
+
+namespace iir {
+
+constexpr int32_t q29(const float v) {
+	return v * (1 << 29) + ((v < 0.0f) ? -0.5f : 0.5f);
+}
+
+// Assume all coefficients are normalized so that a0=1.0
+constexpr iir_biquad_q29_t quantize(const iir_biquad_config_t& config) {
+	return {
+		{ { q29(config.b[0]), q29(config.b[1]), q29(config.b[2]) } },
+		{ { q29(config.a[1]), q29(config.a[2]) } }
+	};
+}
+
+/* Direct Form I history, Q30. */
+struct state_t {
+	std::array<int32_t, 2> x;
+	std::array<int32_t, 2> y;
+};
+
+/* One Q30 sample through one section. Products are Q29 * Q30, accumulated
+ * in 64 bits (SMLAL), which keeps low cut-off high-pass filters stable.
+ */
+inline int32_t execute_section(const iir_biquad_q29_t& c, state_t& s, const int32_t x0) {
+	int64_t acc = (int64_t)c.b[0] * x0;
+	acc += (int64_t)c.b[1] * s.x[0];
+	acc += (int64_t)c.b[2] * s.x[1];
+	acc -= (int64_t)c.a[0] * s.y[0];
+	acc -= (int64_t)c.a[1] * s.y[1];
+
+	const int64_t y_wide = (acc + (1LL << 28)) >> 29;
+	const int32_t y0 = (y_wide > INT32_MAX) ? INT32_MAX : ((y_wide < INT32_MIN) ? INT32_MIN : y_wide);
+
+	s.x[1] = s.x[0];
+	s.x[0] = x0;
+	s.y[1] = s.y[0];
+	s.y[0] = y0;
+
+	return y0;
+}
+
+inline int32_t q30_from_q15(const int16_t v) {
+	return static_cast<int32_t>(v) << 15;
+}
+
+// Rounded and saturated; GCC makes the clamp a single SSAT.
+inline int16_t q15_from_q30(const int32_t v) {
+	const int32_t r = ((v >> 14) + 1) >> 1;
+	return (r > INT16_MAX) ? INT16_MAX : ((r < INT16_MIN) ? INT16_MIN : r);
+}
+
+} /* namespace iir */
+
+/* Fixed-point Direct Form I biquad for Q15 audio. Coefficients are Q29
+ * (range +/-4), state is Q30 and the feedback sum is 64-bit (SMLAL),
+ * which keeps low cut-off high-pass filters stable.
+ */
+class IIRBiquadFilterQ15 {
+public:
+	constexpr IIRBiquadFilterQ15(
+	) : IIRBiquadFilterQ15(iir_config_no_pass)
+	{
+	}
+
+	// Assume all coefficients are normalized so that a0=1.0
+	constexpr IIRBiquadFilterQ15(
+		const iir_biquad_config_t& config
+	) : coefficients(iir::quantize(config))
+	{
+	}
+
+	void configure(const iir_biquad_config_t& new_config);
+
+	void execute(const buffer_s16_t& buffer_in, const buffer_s16_t& buffer_out);
+	void execute_in_place(const buffer_s16_t& buffer);
+
+private:
+	iir_biquad_q29_t coefficients;
+	iir::state_t state { { { 0, 0 } }, { { 0, 0 } } };
+};
+
+/* Sections biquads in series, on Channels streams with the same response
+ * (left and right, or mid and side). Samples stay Q30 between sections,
+ * and stereo pairs go through in one pass so each section's coefficients
+ * are loaded once per pair of samples.
+ */
+template<size_t Sections, size_t Channels = 1>
+class IIRBiquadCascadeQ15 {
+public:
+	void configure(const std::array<iir_biquad_config_t, Sections>& configs) {
+		for(size_t n=0; n<Sections; n++) {
+			coefficients[n] = iir::quantize(configs[n]);
+		}
+	}
+
+	/* First channel only. */
+	void execute_in_place(const buffer_s16_t& buffer) {
+		auto s = state[0];
+		for(size_t i=0; i<buffer.count; i++) {
+			int32_t v = iir::q30_from_q15(buffer.p[i]);
+			for(size_t n=0; n<Sections; n++) {
+				v = iir::execute_section(coefficients[n], s[n], v);
+			}
+			buffer.p[i] = iir::q15_from_q30(v);
+		}
+		state[0] = s;
+	}
+
+	/* First and second channels, buffers of the same length. */
+	void execute_in_place(const buffer_s16_t& buffer_0, const buffer_s16_t& buffer_1) {
+		static_assert(Channels >= 2, "Cascade has a single channel");
+
+		auto s0 = state[0];
+		auto s1 = state[1];
+		for(size_t i=0; i<buffer_0.count; i++) {
+			int32_t v0 = iir::q30_from_q15(buffer_0.p[i]);
+			int32_t v1 = iir::q30_from_q15(buffer_1.p[i]);
+			for(size_t n=0; n<Sections; n++) {
+				const auto& c = coefficients[n];
+				v0 = iir::execute_section(c, s0[n], v0);
+				v1 = iir::execute_section(c, s1[n], v1);
+			}
+			buffer_0.p[i] = iir::q15_from_q30(v0);
+			buffer_1.p[i] = iir::q15_from_q30(v1);
+		}
+		state[0] = s0;
+		state[1] = s1;
+	}
+
+private:
+	std::array<iir_biquad_q29_t, Sections> coefficients { };
+	std::array<std::array<iir::state_t, Sections>, Channels> state { };
+};
+
 #endif/*__DSP_IIR_H__*/
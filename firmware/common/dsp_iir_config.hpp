@@ -109,6 +109,28 @@ constexpr iir_biquad_config_t audio_8k_deemph_300_6_config {
 	{  1.00000000f, -0.78833643f,  0.00000000f }
 };
 
+// Voice pre-emphasis, +6dB/octave from 300Hz (the NFM de-emphasis above)
+// flattening out at 3kHz, unity at 1kHz.
+// zero exp(-2 * pi * 300 / 24000), pole exp(-2 * pi * 3000 / 24000)
+// NOTE: Technically, order-1 filter, b[2] = a[2] = 0.
+constexpr iir_biquad_config_t audio_24k_preemph_300_3000_config {
+	{  2.18185206f, -2.01704641f,  0.00000000f },
+	{  1.00000000f, -0.45593813f,  0.00000000f }
+};
+
+// 4th order Butterworth as two sections (bilinear, Q 0.541 and 1.307)
+// scipy.signal.butter(4, 3000 / 12000.0, 'lowpass', analog=False, output='sos')
+constexpr std::array<iir_biquad_config_t, 2> audio_24k_lpf_3000hz_config { {
+	{
+		{  0.08857936f,  0.17715871f,  0.08857936f },
+		{  1.00000000f, -0.85539793f,  0.20971536f }
+	},
+	{
+		{  0.11525802f,  0.23051603f,  0.11525802f },
+		{  1.00000000f, -1.11302985f,  0.57406192f }
+	}
+} };
+
 // 75us RC time constant, used in broadcast FM in Americas, South Korea
 // scipy.signal.butter(1, 2122 / 24000.0, 'lowpass', analog=False)
 // NOTE: Technically, order-1 filter, b[2] = a[2] = 0.
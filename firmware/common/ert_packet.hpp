@@ -62,6 +62,7 @@ public:
 	bool is_valid() const;
 
 	Timestamp received_at() const;
+	const baseband::Packet& raw() const { return packet_; }
 
 	Type type() const;
 	ID id() const;
@@ -62,4 +62,24 @@ private:
 	const BitRemap bit_remap { };
 };
 
+/* Without remapping, fields come from the source's packed read() in one go
+ * rather than a bit at a time. length is at most 32.
+ */
+template<typename T>
+class FieldReader<T, BitRemapNone> {
+public:
+	constexpr FieldReader(
+		const T& data
+	) : data { data }
+	{
+	}
+
+	uint32_t read(const size_t start_bit, const size_t length) const {
+		return data.read(start_bit, length);
+	}
+
+private:
+	const T& data;
+};
+
 #endif/*__FIELD_READER_H__*/
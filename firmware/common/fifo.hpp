@@ -48,6 +48,13 @@ public:
 		_in = _out = 0;
 	}
 
+	/* Only while neither side is using the FIFO. Leaves it empty. */
+	void set_data(T* data, size_t k) {
+		_data = data;
+		_size = 1U << k;
+		reset();
+	}
+
 	void reset_in() {
 		_in = _out;
 	}
@@ -56,6 +63,10 @@ public:
 		_out = _in;
 	}
 
+	static constexpr size_t record_size(const size_t len) {
+		return len + recsize();
+	}
+
 	size_t len() const {
 		return _in - _out;
 	}
@@ -230,8 +241,8 @@ private:
 		return buf_len;
 	}
 
-	T* const _data;
-	const size_t _size;
+	T* _data;
+	size_t _size;
 	volatile size_t _in;
 	volatile size_t _out;
 };
@@ -21,11 +21,20 @@
 
 #include "i2c_pp.hpp"
 
+#include <algorithm>
+
 void I2C::start(const I2CConfig& config) {
+	// Again on every clock change, by then there may be a worker waiting.
+	if( !queue_ready ) {
+		chMtxInit(&queue_mutex);
+		chCondInit(&queue_changed);
+		queue_ready = true;
+	}
 	i2cStart(_driver, &config);
 }
 
 void I2C::stop() {
+	flush();
 	i2cStop(_driver);
 }
 
@@ -48,6 +57,7 @@ bool I2C::receive(
 	uint8_t* const data, const size_t count,
 	systime_t timeout
 ) {
+	flush();
 	i2cAcquireBus(_driver);
 	const msg_t status = i2cMasterReceiveTimeout(
 		_driver, slave_address, data, count, timeout
@@ -61,5 +71,92 @@ bool I2C::transmit(
 	const uint8_t* const data, const size_t count,
 	systime_t timeout
 ) {
+	flush();
 	return transfer(slave_address, data, count, NULL, 0, timeout);
 }
+
+void I2C::transmit_queued(
+	const address_t slave_address,
+	const uint8_t* const data, const size_t count,
+	const int32_t coalesce_key,
+	const callback_t callback,
+	void* const context
+) {
+	if( !worker ) {
+		worker = chThdCreateFromHeap(NULL, 512, NORMALPRIO + 1, I2C::static_fn, this);
+	}
+
+	QueuedWrite entry {
+		slave_address,
+		static_cast<uint8_t>(std::min(count, queued_length_max)),
+		coalesce_key,
+		{ },
+		callback,
+		context
+	};
+	std::copy(data, data + entry.count, entry.data.begin());
+
+	chMtxLock(&queue_mutex);
+	if( coalesce_key != coalesce_none ) {
+		for(size_t i=0; i<queue_count; i++) {
+			auto& pending = queue[(queue_head + i) % queue.size()];
+			if( (pending.slave_address == slave_address) && (pending.coalesce_key == coalesce_key) ) {
+				pending = entry;
+				chMtxUnlock();
+				return;
+			}
+		}
+	}
+	while( queue_count == queue.size() ) {
+		chCondWait(&queue_changed);
+	}
+	queue[(queue_head + queue_count) % queue.size()] = entry;
+	queue_count++;
+	chCondBroadcast(&queue_changed);
+	chMtxUnlock();
+}
+
+void I2C::flush() {
+	// The worker's own callbacks may write, and with it gone nothing is queued.
+	if( !worker || (chThdSelf() == worker) ) {
+		return;
+	}
+
+	chMtxLock(&queue_mutex);
+	while( queue_count || queue_busy ) {
+		chCondWait(&queue_changed);
+	}
+	chMtxUnlock();
+}
+
+msg_t I2C::static_fn(void* arg) {
+	auto obj = static_cast<I2C*>(arg);
+	obj->run();
+	return 0;
+}
+
+void I2C::run() {
+	chRegSetThreadName("i2c");
+
+	while(true) {
+		chMtxLock(&queue_mutex);
+		while( queue_count == 0 ) {
+			chCondWait(&queue_changed);
+		}
+		const auto entry = queue[queue_head];
+		queue_head = (queue_head + 1) % queue.size();
+		queue_count--;
+		queue_busy = true;
+		chMtxUnlock();
+
+		const auto ok = transfer(entry.slave_address, entry.data.data(), entry.count, NULL, 0, TIME_INFINITE);
+		if( entry.callback ) {
+			entry.callback(ok, entry.context);
+		}
+
+		chMtxLock(&queue_mutex);
+		queue_busy = false;
+		chCondBroadcast(&queue_changed);
+		chMtxUnlock();
+	}
+}
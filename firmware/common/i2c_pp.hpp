@@ -23,6 +23,8 @@
 #define __I2C_PP_H__
 
 #include <cstdint>
+#include <cstddef>
+#include <array>
 
 #include "ch.h"
 #include "hal.h"
@@ -59,9 +61,19 @@ struct I2CClockConfig {
 	}
 };
 
+/* Blocking transfers, and a queue of writes a worker thread sends, for
+ * callers that shouldn't wait on the bus (volume from the UI). A queued
+ * write with a coalesce key replaces one still pending for the same slave
+ * and key, so an encoder spin ends up as one or two writes. Blocking
+ * transfers wait for the queue to drain first, so order is kept.
+ */
 class I2C {
 public:
 	using address_t = uint8_t;
+	using callback_t = void (*)(const bool ok, void* const context);
+
+	static constexpr size_t queued_length_max = 4;
+	static constexpr int32_t coalesce_none = -1;
 
 	constexpr I2C(I2CDriver* const driver) :
 		_driver(driver) {
@@ -82,15 +94,53 @@ public:
 		const systime_t timeout = TIME_INFINITE
 	);
 
+	/* Returns at once, unless the queue is full. count up to
+	 * queued_length_max; callback runs on the worker thread.
+	 */
+	void transmit_queued(
+		const address_t slave_address,
+		const uint8_t* const data, const size_t count,
+		const int32_t coalesce_key = coalesce_none,
+		const callback_t callback = nullptr,
+		void* const context = nullptr
+	);
+
+	/* Waits until all queued writes are on the bus. */
+	void flush();
+
 private:
+	struct QueuedWrite {
+		address_t slave_address;
+		uint8_t count;
+		int32_t coalesce_key;
+		std::array<uint8_t, queued_length_max> data;
+		callback_t callback;
+		void* context;
+	};
+
+	static constexpr size_t queue_size = 8;
+
 	I2CDriver* const _driver;
 
+	bool queue_ready { false };
+	Mutex queue_mutex { };
+	// Signalled on every change: a write queued, or one sent.
+	CondVar queue_changed { };
+	std::array<QueuedWrite, queue_size> queue { };
+	size_t queue_head { 0 };
+	size_t queue_count { 0 };
+	bool queue_busy { false };
+	Thread* worker { nullptr };
+
 	bool transfer(
 		const address_t slave_address,
 		const uint8_t* const data_tx, const size_t count_tx,
 		uint8_t* const data_rx, const size_t count_rx,
 		const systime_t timeout
 	);
+
+	static msg_t static_fn(void* arg);
+	void run();
 };
 
 #endif/*__I2C_PP_H__*/
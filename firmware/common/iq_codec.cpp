@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "iq_codec.hpp"
+
+#include <cstring>
+
+namespace iq_codec {
+
+namespace {
+
+constexpr size_t shift_max = 15;
+constexpr size_t escape_bits = 17;
+
+struct ChannelStats {
+	uint32_t sum_direct { 0 };
+	uint32_t sum_delta { 0 };
+	int32_t previous { 0 };
+
+	void add(const int32_t v) {
+		sum_direct += (v < 0) ? -v : v;
+		const int32_t d = v - previous;
+		sum_delta += (d < 0) ? -d : d;
+		previous = v;
+	}
+
+	uint8_t param(const size_t count) const {
+		const bool delta = sum_delta < sum_direct;
+		// Zigzag doubles the magnitude; k ~ log2 of the mean code value.
+		const uint32_t mean = ((delta ? sum_delta : sum_direct) * 2) / count;
+		const uint32_t k = (mean > 1) ? (31 - __builtin_clz(mean)) : 0;
+		return ((k > param_k_mask) ? param_k_mask : k) | (delta ? param_delta : 0);
+	}
+};
+
+class BitWriter {
+public:
+	BitWriter(uint32_t* const p, const size_t words_max) : p_ { p }, end_ { p + words_max } { }
+
+	/* bits <= 32. Returns false once words_max is exceeded. */
+	bool put(const uint32_t value, const size_t bits) {
+		acc |= static_cast<uint64_t>(value) << fill;
+		fill += bits;
+		if( fill >= 32 ) {
+			if( p_ == end_ ) {
+				return false;
+			}
+			*(p_++) = acc;
+			acc >>= 32;
+			fill -= 32;
+		}
+		return true;
+	}
+
+	bool flush() {
+		if( fill ) {
+			if( p_ == end_ ) {
+				return false;
+			}
+			*(p_++) = acc;
+		}
+		return true;
+	}
+
+	uint32_t* position() const { return p_; }
+
+private:
+	uint32_t* p_;
+	uint32_t* const end_;
+	uint64_t acc { 0 };
+	size_t fill { 0 };
+};
+
+class BitReader {
+public:
+	BitReader(const uint8_t* const p, const size_t length) : p_ { p }, end_ { p + length } { }
+
+	/* bits <= 32. Reads zeros past the end, so a corrupt block can't run
+	 * off its payload.
+	 */
+	uint32_t get(const size_t bits) {
+		while( fill < bits ) {
+			const uint8_t b = (p_ < end_) ? *(p_++) : 0;
+			acc |= static_cast<uint64_t>(b) << fill;
+			fill += 8;
+		}
+		const uint32_t value = acc & ((1ULL << bits) - 1);
+		acc >>= bits;
+		fill -= bits;
+		return value;
+	}
+
+private:
+	const uint8_t* p_;
+	const uint8_t* const end_;
+	uint64_t acc { 0 };
+	size_t fill { 0 };
+};
+
+class ChannelEncoder {
+public:
+	ChannelEncoder(const uint8_t param) : k { static_cast<size_t>(param & param_k_mask) }, delta { (param & param_delta) != 0 } { }
+
+	bool put(BitWriter& writer, const int32_t v) {
+		const int32_t d = delta ? (v - previous) : v;
+		previous = v;
+		const uint32_t u = (static_cast<uint32_t>(d) << 1) ^ static_cast<uint32_t>(d >> 31);
+		const uint32_t q = u >> k;
+		if( q < escape_quotient ) {
+			// q ones, a zero, then the k remainder bits.
+			const uint32_t r = u & ((1U << k) - 1);
+			return writer.put(((1U << q) - 1) | (r << (q + 1)), q + 1 + k);
+		} else {
+			return writer.put((1U << escape_quotient) - 1, escape_quotient)
+				&& writer.put(u, escape_bits);
+		}
+	}
+
+private:
+	const size_t k;
+	const bool delta;
+	int32_t previous { 0 };
+};
+
+class ChannelDecoder {
+public:
+	ChannelDecoder(const uint8_t param) : k { static_cast<size_t>(param & param_k_mask) }, delta { (param & param_delta) != 0 } { }
+
+	int32_t get(BitReader& reader) {
+		size_t q = 0;
+		while( (q < escape_quotient) && reader.get(1) ) {
+			q++;
+		}
+		const uint32_t u = (q < escape_quotient) ? ((q << k) | reader.get(k)) : reader.get(escape_bits);
+		const int32_t d = static_cast<int32_t>(u >> 1) ^ -static_cast<int32_t>(u & 1);
+		const int32_t v = delta ? (previous + d) : d;
+		previous = v;
+		return v;
+	}
+
+private:
+	const size_t k;
+	const bool delta;
+	int32_t previous { 0 };
+};
+
+uint16_t read_u16(const uint8_t* const p) {
+	return p[0] | (p[1] << 8);
+}
+
+} /* namespace */
+
+size_t encode(const complex16_t* const src, const size_t count, void* const dst) {
+	uint32_t bits = 0;
+	for(size_t n=0; n<count; n++) {
+		bits |= static_cast<uint16_t>(src[n].real()) | static_cast<uint16_t>(src[n].imag());
+	}
+	const size_t shift = bits ? __builtin_ctz(bits) : 0;
+	const size_t shift_used = (shift > shift_max) ? shift_max : shift;
+
+	ChannelStats stats_i;
+	ChannelStats stats_q;
+	for(size_t n=0; n<count; n++) {
+		stats_i.add(src[n].real() >> shift_used);
+		stats_q.add(src[n].imag() >> shift_used);
+	}
+
+	auto header = static_cast<Header*>(dst);
+	auto payload = reinterpret_cast<uint32_t*>(&header[1]);
+	header->sync = sync_word;
+	header->samples_minus_1 = count - 1;
+	header->shift = shift_used;
+	header->param_i = stats_i.param(count);
+	header->param_q = stats_q.param(count);
+
+	// Anything bigger than the samples themselves is stored raw instead.
+	BitWriter writer { payload, count };
+	ChannelEncoder encoder_i { header->param_i };
+	ChannelEncoder encoder_q { header->param_q };
+	bool fits = true;
+	for(size_t n=0; fits && (n<count); n++) {
+		fits = encoder_i.put(writer, src[n].real() >> shift_used)
+			&& encoder_q.put(writer, src[n].imag() >> shift_used);
+	}
+	fits = fits && writer.flush();
+
+	if( fits ) {
+		header->words = writer.position() - payload;
+	} else {
+		header->shift = 0;
+		header->param_i = param_raw;
+		header->param_q = param_raw;
+		header->words = count;
+		memcpy(payload, src, count * sizeof(complex16_t));
+	}
+
+	return sizeof(Header) + header->words * sizeof(uint32_t);
+}
+
+size_t parse_header(const uint8_t* const src, size_t& samples) {
+	if( read_u16(&src[offsetof(Header, sync)]) != sync_word ) {
+		return 0;
+	}
+
+	const size_t words = read_u16(&src[offsetof(Header, words)]);
+	const size_t count = src[offsetof(Header, samples_minus_1)] + 1;
+	const uint8_t param_i = src[offsetof(Header, param_i)];
+	const uint8_t param_q = src[offsetof(Header, param_q)];
+	const uint8_t valid_bits = param_k_mask | param_delta;
+
+	const bool raw = (param_i == param_raw) && (param_q == param_raw);
+	const bool coded = ((param_i & ~valid_bits) == 0) && ((param_q & ~valid_bits) == 0);
+	if( !(raw ? (words == count) : (coded && (words <= count))) ) {
+		return 0;
+	}
+	if( src[offsetof(Header, shift)] > shift_max ) {
+		return 0;
+	}
+
+	samples = count;
+	return sizeof(Header) + words * sizeof(uint32_t);
+}
+
+size_t decode(const uint8_t* const src, const size_t length, complex16_t* const dst, size_t& consumed) {
+	consumed = 0;
+	if( length < sizeof(Header) ) {
+		return 0;
+	}
+
+	size_t count = 0;
+	const size_t block_bytes = parse_header(src, count);
+	if( block_bytes == 0 ) {
+		consumed = 1;
+		return 0;
+	}
+	if( length < block_bytes ) {
+		return 0;
+	}
+
+	const uint8_t* const payload = &src[sizeof(Header)];
+	const uint8_t param_i = src[offsetof(Header, param_i)];
+	const uint8_t param_q = src[offsetof(Header, param_q)];
+	if( param_i == param_raw ) {
+		memcpy(dst, payload, count * sizeof(complex16_t));
+	} else {
+		const size_t shift = src[offsetof(Header, shift)];
+		BitReader reader { payload, block_bytes - sizeof(Header) };
+		ChannelDecoder decoder_i { param_i };
+		ChannelDecoder decoder_q { param_q };
+		for(size_t n=0; n<count; n++) {
+			const int32_t i = decoder_i.get(reader);
+			const int32_t q = decoder_q.get(reader);
+			dst[n] = { static_cast<int16_t>(i * (1 << shift)), static_cast<int16_t>(q * (1 << shift)) };
+		}
+	}
+
+	consumed = block_bytes;
+	return count;
+}
+
+} /* namespace iq_codec */
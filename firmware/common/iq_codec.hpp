@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __IQ_CODEC_H__
+#define __IQ_CODEC_H__
+
+#include <cstdint>
+#include <cstddef>
+
+#include "complex.hpp"
+
+/* Lossless complex int16 compression for captures (.RIQ files), encoded on
+ * the M4 and decoded on the M0 for replay.
+ *
+ * A file is a sequence of self-contained blocks of up to block_samples_max
+ * samples, each a Header followed by words 32-bit little-endian payload
+ * words. Per block, the samples' common trailing zero bits (shift) are
+ * dropped, and each of I and Q is coded either as is or as the difference
+ * from its previous sample, whichever is smaller, then zigzag mapped and
+ * Rice coded with parameter k, interleaved I, Q, I, Q... LSB first.
+ * Quotients of escape_quotient or more are sent as escape_quotient ones
+ * followed by the 17 bit zigzag value. A block that would not shrink is
+ * stored raw.
+ *
+ * Blocks start with sync_word, so a reader that lost its place (a partial
+ * block, from baseband dropping a write) can scan for the next one.
+ */
+
+namespace iq_codec {
+
+constexpr uint16_t sync_word = 0x5149;		// "IQ"
+constexpr size_t block_samples_max = 256;
+
+struct Header {
+	uint16_t sync;
+	uint16_t words;
+	uint8_t samples_minus_1;
+	uint8_t shift;
+	uint8_t param_i;
+	uint8_t param_q;
+};
+
+static_assert(sizeof(Header) == 8, "iq_codec::Header must be packed");
+
+constexpr uint8_t param_k_mask = 0x0f;
+constexpr uint8_t param_delta = 0x10;
+constexpr uint8_t param_raw = 0xff;
+
+constexpr size_t escape_quotient = 16;
+
+constexpr size_t block_bytes_max = sizeof(Header) + block_samples_max * sizeof(complex16_t);
+
+/* Encodes count (1 to block_samples_max) samples into dst, which must be
+ * word aligned and hold block_bytes_max bytes. Returns the block's size in
+ * bytes, always a multiple of four.
+ */
+size_t encode(const complex16_t* const src, const size_t count, void* const dst);
+
+/* Checks the header at src (any alignment, at least sizeof(Header) bytes).
+ * Returns the block's total size in bytes and its sample count, or zero
+ * if this isn't a plausible block start.
+ */
+size_t parse_header(const uint8_t* const src, size_t& samples);
+
+/* Decodes the block at src into dst, which must hold block_samples_max
+ * samples. Returns the number of samples, setting consumed to the bytes
+ * used. With too few bytes for the block, returns zero and consumed zero;
+ * when src isn't at a block start, returns zero and consumes one byte.
+ */
+size_t decode(const uint8_t* const src, const size_t length, complex16_t* const dst, size_t& consumed);
+
+} /* namespace iq_codec */
+
+#endif/*__IQ_CODEC_H__*/
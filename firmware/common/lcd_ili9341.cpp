@@ -30,23 +30,55 @@ using namespace portapack;
 
 #include "ch.h"
 
+#include <algorithm>
 #include <complex>
 
 namespace lcd {
 
 namespace {
 
-void lcd_reset() {
+/* Long waits are timed from when they start, so callers can do other work
+ * in the meantime rather than sleeping through them.
+ */
+bool reset_pending { false };
+systime_t reset_released { 0 };
+systime_t sleep_out_sent { 0 };
+systime_t sleep_in_sent { 0 };
+
+void wait_since(const systime_t start, const uint32_t ms) {
+	const systime_t elapsed = chTimeNow() - start;
+	if( elapsed < MS2ST(ms) ) {
+		chThdSleep(MS2ST(ms) - elapsed);
+	}
+}
+
+void lcd_reset_start() {
 	io.lcd_reset_state(false);
 	chThdSleepMilliseconds(1);
 	io.lcd_reset_state(true);
 	chThdSleepMilliseconds(10);
 	io.lcd_reset_state(false);
-	chThdSleepMilliseconds(120);
+	reset_released = chTimeNow();
+	reset_pending = true;
+}
+
+void lcd_reset_finish() {
+	wait_since(reset_released, 120);
+	reset_pending = false;
+}
+
+void lcd_reset() {
+	lcd_reset_start();
+	lcd_reset_finish();
 }
 
 void lcd_sleep_in() {
+	// "It will be necessary to wait 120msec after sending Sleep Out
+	// command (when in Sleep In Mode) before Sleep In command can be
+	// sent."
+	wait_since(sleep_out_sent, 120);
 	io.lcd_data_write_command_and_data(0x10, {});
+	sleep_in_sent = chTimeNow();
 	// "It will be necessary to wait 5msec before sending next command,
 	// this is to allow time for the supply voltages and clock circuits
 	// to stabilize."
@@ -54,11 +86,12 @@ void lcd_sleep_in() {
 }
 
 void lcd_sleep_out() {
+	// And the same after Sleep In before Sleep Out.
+	wait_since(sleep_in_sent, 120);
 	io.lcd_data_write_command_and_data(0x11, {});
-	// "It will be necessary to wait 120msec after sending Sleep Out
-	// command (when in Sleep In Mode) before Sleep In command can be
-	// sent."
-	chThdSleepMilliseconds(120);
+	sleep_out_sent = chTimeNow();
+	// Other commands only need the 5msec, the 120msec is Sleep In's.
+	chThdSleepMilliseconds(5);
 }
 
 void lcd_display_on() {
@@ -191,6 +224,63 @@ void lcd_init() {
 	io.lcd_data_write_command_and_data(0x35, { 0b00000000 });
 }
 
+/* Glyph runs drawn recently, so redrawing identical text in the same place
+ * can be skipped. Every RAM write invalidates the runs it overlaps, so an
+ * entry is only kept while its pixels are known to be on the screen.
+ */
+class GlyphRunCache {
+public:
+	bool contains(const ui::Rect& r, const uint32_t key) const {
+		for(const auto& entry : entries) {
+			if( (entry.key == key) && same_rect(entry.rect, r) ) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void insert(const ui::Rect& r, const uint32_t key) {
+		entries[next] = { r, key };
+		next = (next + 1) % entries.size();
+		used = true;
+	}
+
+	void invalidate(const ui::Rect& r) {
+		if( !used ) {
+			return;
+		}
+		for(auto& entry : entries) {
+			if( !entry.rect.intersect(r).is_empty() ) {
+				entry.rect = { };
+			}
+		}
+	}
+
+	void clear() {
+		for(auto& entry : entries) {
+			entry.rect = { };
+		}
+		used = false;
+	}
+
+private:
+	struct Entry {
+		ui::Rect rect;
+		uint32_t key;
+	};
+
+	std::array<Entry, 16> entries { };
+	size_t next { 0 };
+	bool used { false };
+
+	static bool same_rect(const ui::Rect& a, const ui::Rect& b) {
+		return !a.is_empty() && (a.left() == b.left()) && (a.top() == b.top())
+			&& (a.width() == b.width()) && (a.height() == b.height());
+	}
+};
+
+GlyphRunCache glyph_run_cache;
+
 void lcd_set(const uint_fast8_t command, const uint_fast16_t start, const uint_fast16_t end) {
 	io.lcd_data_write_command_and_data(command, {
 		static_cast<uint8_t>(start >> 8), static_cast<uint8_t>(start & 0xff),
@@ -219,6 +309,7 @@ void lcd_start_ram_write(
 	const ui::Point p,
 	const ui::Size s
 ) {
+	glyph_run_cache.invalidate({ p, s });
 	lcd_caset(p.x(), p.x() + s.width()  - 1);
 	lcd_paset(p.y(), p.y() + s.height() - 1);
 	lcd_ramwr_start();
@@ -269,14 +360,98 @@ void lcd_vertical_scrolling_start_address(
 	});
 }
 
+/* Bytes of a ui::Bitmap::Encoding::PackBits stream: a signed count n, then
+ * n + 1 literal bytes if n >= 0, else one byte repeated 1 - n times.
+ */
+class PackBitsReader {
+public:
+	constexpr PackBitsReader(
+		const uint8_t* const data
+	) : p { data }
+	{
+	}
+
+	uint8_t operator()() {
+		if( run == 0 ) {
+			const auto n = static_cast<int8_t>(*(p++));
+			repeat = (n < 0);
+			run = repeat ? (1 - n) : (n + 1);
+			if( repeat ) {
+				value = *(p++);
+			}
+		}
+		run--;
+		return repeat ? value : *(p++);
+	}
+
+private:
+	const uint8_t* p;
+	size_t run { 0 };
+	bool repeat { false };
+	uint8_t value { 0 };
+};
+
+class RawReader {
+public:
+	constexpr RawReader(
+		const uint8_t* const data
+	) : p { data }
+	{
+	}
+
+	uint8_t operator()() {
+		return *(p++);
+	}
+
+private:
+	const uint8_t* p;
+};
+
+/* 1bpp, row-major, LSB first, rows not byte aligned (glyphs aren't). Sent a
+ * row at a time from a line buffer, rather than a pixel per write.
+ */
+template<typename Reader>
+void lcd_write_bitmap(
+	const ui::Size size,
+	Reader next_byte,
+	const ui::Color foreground,
+	const ui::Color background
+) {
+	std::array<ui::Color, 240> line;
+	const size_t width = std::min(static_cast<size_t>(size.width()), line.size());
+	uint32_t bits = 0;
+	size_t bits_left = 0;
+	for(int y=0; y<size.height(); y++) {
+		for(size_t x=0; x<width; x++) {
+			if( bits_left == 0 ) {
+				bits = next_byte();
+				bits_left = 8;
+			}
+			line[x] = (bits & 1) ? foreground : background;
+			bits >>= 1;
+			bits_left--;
+		}
+		io.lcd_write_pixels(line.data(), width);
+	}
+}
+
+}
+
+void ILI9341::reset_start() {
+	lcd_reset_start();
 }
 
 void ILI9341::init() {
-	lcd_reset();
+	glyph_run_cache.clear();
+	if( !reset_pending ) {
+		lcd_reset_start();
+	}
+	lcd_reset_finish();
 	lcd_init();
 }
 
 void ILI9341::shutdown() {
+	glyph_run_cache.clear();
 	lcd_reset();
 }
 
@@ -495,12 +670,18 @@ void ILI9341::draw_bitmap(
 	const ui::Color background
 ) {
 	lcd_start_ram_write(p, size);
+	lcd_write_bitmap(size, RawReader { pixels }, foreground, background);
+}
 
-	const size_t count = size.width() * size.height();
-	for(size_t i=0; i<count; i++) {
-		const auto pixel = pixels[i >> 3] & (1U << (i & 0x7));
-		io.lcd_write_pixel(pixel ? foreground : background);
-	}
+void ILI9341::draw_bitmap_packbits(
+	const ui::Point p,
+	const ui::Size size,
+	const uint8_t* const data,
+	const ui::Color foreground,
+	const ui::Color background
+) {
+	lcd_start_ram_write(p, size);
+	lcd_write_bitmap(size, PackBitsReader { data }, foreground, background);
 }
 
 void ILI9341::draw_glyph(
@@ -512,6 +693,57 @@ void ILI9341::draw_glyph(
 	draw_bitmap(p, glyph.size(), glyph.pixels(), foreground, background);
 }
 
+void ILI9341::draw_glyph_run(
+	const ui::Point p,
+	const ui::Font& font,
+	const char* const text,
+	const size_t length,
+	const ui::Color foreground,
+	const ui::Color background
+) {
+	if( length == 0 ) {
+		return;
+	}
+
+	// Fixed width fonts only, so the run is one rectangle.
+	const auto glyph_size = font.glyph(text[0]).size();
+	const size_t glyphs_max = (p.x() < width()) ? ((width() - p.x()) / glyph_size.width()) : 0;
+	const size_t count = std::min(length, glyphs_max);
+	if( count == 0 ) {
+		return;
+	}
+	const ui::Rect r { p, { static_cast<int>(count * glyph_size.width()), glyph_size.height() } };
+
+	uint32_t key = 2166136261U;
+	const auto hash = [&key](const uint32_t v) { key = (key ^ v) * 16777619U; };
+	hash(reinterpret_cast<uintptr_t>(&font));
+	hash(foreground.v);
+	hash(background.v);
+	for(size_t n=0; n<count; n++) {
+		hash(static_cast<uint8_t>(text[n]));
+	}
+	if( glyph_run_cache.contains(r, key) ) {
+		return;
+	}
+
+	lcd_start_ram_write(r);
+
+	// Glyph bitmaps are row-major, LSB first, rows not byte aligned.
+	std::array<ui::Color, 240> line;
+	for(int y=0; y<glyph_size.height(); y++) {
+		ui::Color* out = line.data();
+		for(size_t n=0; n<count; n++) {
+			const auto pixels = font.glyph(text[n]).pixels();
+			for(int x=0, i=y * glyph_size.width(); x<glyph_size.width(); x++, i++) {
+				*(out++) = (pixels[i >> 3] & (1U << (i & 0x7))) ? foreground : background;
+			}
+		}
+		io.lcd_write_pixels(line.data(), r.width());
+	}
+
+	glyph_run_cache.insert(r, key);
+}
+
 void ILI9341::scroll_set_area(
 	const ui::Coord top_y,
 	const ui::Coord bottom_y
@@ -535,6 +767,21 @@ ui::Coord ILI9341::scroll(const int32_t delta) {
 	return scroll_set_position(scroll_state.current_position + scroll_state.height - delta);
 }
 
+ui::Coord ILI9341::scroll_draw_line(
+	const std::array<uint8_t, 256>& values,
+	const size_t first,
+	const std::array<ui::Color, 256>& lut
+) {
+	// Scroll lines are always full width, colours are looked up as they're
+	// sent rather than staged in a pixel row.
+	const auto y = scroll(1);
+	lcd_start_ram_write({ 0, y }, { width(), 1 });
+	for(size_t i=0; i<width(); i++) {
+		io.lcd_write_pixel(lut[values[(first + i) & 0xff]]);
+	}
+	return y;
+}
+
 ui::Coord ILI9341::scroll_area_y(const ui::Coord y) const {
 	const auto wrapped_y = (scroll_state.current_position + y) % scroll_state.height;
 	return wrapped_y + scroll_state.top_area;
@@ -42,6 +42,10 @@ public:
 	ILI9341(ILI9341&&) = delete;
 	void operator=(const ILI9341&) = delete;
 
+	/* Starts the hardware reset, so its 120ms settle can overlap other
+	 * boot work. init() waits out whatever is left.
+	 */
+	void reset_start();
 	void init();
 	void shutdown();
 
@@ -87,6 +91,14 @@ public:
 		const ui::Color background
 	);
 
+	void draw_bitmap_packbits(
+		const ui::Point p,
+		const ui::Size size,
+		const uint8_t* const data,
+		const ui::Color foreground,
+		const ui::Color background
+	);
+
 	void draw_glyph(
 		const ui::Point p,
 		const ui::Glyph& glyph,
@@ -94,9 +106,37 @@ public:
 		const ui::Color background
 	);
 
+	/* Draws length characters of a fixed width font in one RAM write, a
+	 * scanline at a time. Repeating the last draw of the same run at the
+	 * same place, with nothing drawn over it since, writes nothing.
+	 */
+	void draw_glyph_run(
+		const ui::Point p,
+		const ui::Font& font,
+		const char* const text,
+		const size_t length,
+		const ui::Color foreground,
+		const ui::Color background
+	);
+
 	void scroll_set_area(const ui::Coord top_y, const ui::Coord bottom_y);
 	ui::Coord scroll_set_position(const ui::Coord position);
 	ui::Coord scroll(const int32_t delta);
+	/* Scroll by one line and write the new top line, pixel i being
+	 * lut[values[(first + i) & 0xff]]. Returns the line's y.
+	 */
+	ui::Coord scroll_draw_line(
+		const std::array<uint8_t, 256>& values,
+		const size_t first,
+		const std::array<ui::Color, 256>& lut
+	);
+	/* Scroll by one line and write the new top line as is. */
+	template<size_t N>
+	ui::Coord scroll_draw_line(const std::array<ui::Color, N>& colors) {
+		const auto y = scroll(1);
+		draw_pixels({ 0, y, width(), 1 }, colors.data(), colors.size());
+		return y;
+	}
 	ui::Coord scroll_area_y(const ui::Coord y) const;
 	void scroll_disable();
 
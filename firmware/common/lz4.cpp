@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "lz4.hpp"
+
+namespace lz4 {
+
+namespace {
+
+// Token length fields saturate at 15, then continue in 255-valued bytes.
+bool read_length(const uint8_t*& p, const uint8_t* const end, size_t& length) {
+	if( length != 15 ) {
+		return true;
+	}
+	uint8_t b;
+	do {
+		if( p >= end ) {
+			return false;
+		}
+		b = *(p++);
+		length += b;
+	} while( b == 255 );
+	return true;
+}
+
+} /* namespace */
+
+bool decompress_block(
+	const uint8_t* const src, const size_t src_length,
+	uint8_t* const dst, const size_t dst_length
+) {
+	const uint8_t* p = src;
+	const uint8_t* const p_end = src + src_length;
+	uint8_t* q = dst;
+	uint8_t* const q_end = dst + dst_length;
+
+	while( p < p_end ) {
+		const uint8_t token = *(p++);
+
+		size_t literal_length = token >> 4;
+		if( !read_length(p, p_end, literal_length) ) {
+			return false;
+		}
+		if( (literal_length > static_cast<size_t>(p_end - p)) || (literal_length > static_cast<size_t>(q_end - q)) ) {
+			return false;
+		}
+		for(size_t i=0; i<literal_length; i++) {
+			*(q++) = *(p++);
+		}
+
+		// The last sequence is literals only.
+		if( q == q_end ) {
+			return true;
+		}
+
+		if( (p_end - p) < 2 ) {
+			return false;
+		}
+		const size_t offset = p[0] | (p[1] << 8);
+		p += 2;
+		if( (offset == 0) || (offset > static_cast<size_t>(q - dst)) ) {
+			return false;
+		}
+
+		size_t match_length = token & 15;
+		if( !read_length(p, p_end, match_length) ) {
+			return false;
+		}
+		match_length += 4;
+		if( match_length > static_cast<size_t>(q_end - q) ) {
+			return false;
+		}
+
+		// Byte at a time, matches may overlap their own output.
+		const uint8_t* m = q - offset;
+		for(size_t i=0; i<match_length; i++) {
+			*(q++) = *(m++);
+		}
+	}
+
+	return q == q_end;
+}
+
+} /* namespace lz4 */
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __LZ4_H__
+#define __LZ4_H__
+
+#include <cstdint>
+#include <cstddef>
+
+namespace lz4 {
+
+/* Decodes one LZ4 block (no frame header) of src_length bytes into dst,
+ * stopping once dst_length bytes have been written. Trailing bytes after
+ * that (chunk padding) are ignored. Returns false if the block is malformed
+ * or doesn't decode to dst_length bytes; dst is then partly written.
+ */
+bool decompress_block(
+	const uint8_t* const src, const size_t src_length,
+	uint8_t* const dst, const size_t dst_length
+);
+
+} /* namespace lz4 */
+
+#endif/*__LZ4_H__*/
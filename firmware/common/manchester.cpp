@@ -23,10 +23,55 @@
 
 #include "string_format.hpp"
 
+#include <array>
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+/* Eight chips, MSB first, to four symbols: the first chip of each pair in
+ * the high nibble, and an error (equal chips) flag per pair in the low.
+ */
+constexpr uint8_t decode_chips(const uint8_t chips) {
+	uint8_t values = 0;
+	uint8_t errors = 0;
+	for(size_t n=0; n<4; n++) {
+		const uint8_t pair = (chips >> (6 - n * 2)) & 3;
+		values = (values << 1) | (pair >> 1);
+		errors = (errors << 1) | ((pair == 0) || (pair == 3));
+	}
+	return (values << 4) | errors;
+}
+
+template<size_t... I>
+constexpr std::array<uint8_t, sizeof...(I)> make_decode_table(std::index_sequence<I...>) {
+	return { { decode_chips(I)... } };
+}
+
+constexpr std::array<uint8_t, 256> decode_table = make_decode_table(std::make_index_sequence<256>());
+
+} /* namespace */
+
 size_t ManchesterBase::symbols_count() const {
 	return packet.size() / 2;
 }
 
+uint32_t ManchesterBase::read(const size_t start, const size_t length) const {
+	uint32_t value = 0;
+	for(size_t i=start; i<(start + length); i++) {
+		value = (value << 1) | (*this)[i].value;
+	}
+	return value;
+}
+
+uint32_t ManchesterBase::read_errors(const size_t start, const size_t length) const {
+	uint32_t value = 0;
+	for(size_t i=start; i<(start + length); i++) {
+		value = (value << 1) | (*this)[i].error;
+	}
+	return value;
+}
+
 DecodedSymbol ManchesterDecoder::operator[](const size_t index) const {
 	const size_t encoded_index = index * 2;
 	if( (encoded_index + 1) < packet.size() ) {
@@ -38,6 +83,51 @@ DecodedSymbol ManchesterDecoder::operator[](const size_t index) const {
 	}
 }
 
+uint32_t ManchesterDecoder::read(const size_t start, const size_t length) const {
+	uint32_t values;
+	uint32_t errors;
+	decode(start, length, values, errors);
+	return values;
+}
+
+uint32_t ManchesterDecoder::read_errors(const size_t start, const size_t length) const {
+	uint32_t values;
+	uint32_t errors;
+	decode(start, length, values, errors);
+	return errors;
+}
+
+void ManchesterDecoder::decode(const size_t start, const size_t length, uint32_t& values, uint32_t& errors) const {
+	values = 0;
+	errors = 0;
+	for(size_t n=0; n<length; n+=16) {
+		const size_t count = std::min(length - n, static_cast<size_t>(16));
+		const uint32_t chips = packet.read((start + n) * 2, 32);
+		uint32_t v = 0;
+		uint32_t e = 0;
+		for(size_t b=0; b<4; b++) {
+			const auto entry = decode_table[(chips >> (24 - b * 8)) & 0xff];
+			v = (v << 4) | (entry >> 4);
+			e = (e << 4) | (entry & 0xf);
+		}
+		// Sense 1 takes the second chip, the first inverted unless they match.
+		if( sense ) {
+			v ^= ~e & 0xffff;
+		}
+		values = (values << count) | (v >> (16 - count));
+		errors = (errors << count) | (e >> (16 - count));
+	}
+
+	// Symbols without both chips decode as errors.
+	const size_t available = symbols_count();
+	const size_t invalid = (start >= available) ? length : (((start + length) > available) ? (start + length - available) : 0);
+	if( invalid ) {
+		const uint32_t mask = (invalid >= 32) ? 0xffffffff : ((1U << invalid) - 1);
+		values &= ~mask;
+		errors |= mask;
+	}
+}
+
 DecodedSymbol BiphaseMDecoder::operator[](const size_t index) const {
 	const size_t encoded_index = index * 2;
 	if( (encoded_index + 1) < packet.size() ) {
@@ -61,21 +151,9 @@ FormattedSymbols format_symbols(
 	hex_data.reserve(payload_length_hex_characters);
 	hex_error.reserve(payload_length_hex_characters);
 
-	uint_fast8_t data = 0;
-	uint_fast8_t error = 0;
-	for(size_t i=0; i<payload_length_symbols_rounded; i++) {
-		const auto symbol = decoder[i];
-
-		data <<= 1;
-		data |= symbol.value;
-
-		error <<= 1;
-		error |= symbol.error;
-
-		if( (i & 3) == 3 ) {
-			hex_data += to_string_hex(data & 0xf, 1);
-			hex_error += to_string_hex(error & 0xf, 1);
-		}
+	for(size_t i=0; i<payload_length_symbols_rounded; i+=4) {
+		hex_data += to_string_hex(decoder.read(i, 4), 1);
+		hex_error += to_string_hex(decoder.read_errors(i, 4), 1);
 	}
 
 	return { hex_data, hex_error };
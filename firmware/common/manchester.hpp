@@ -47,6 +47,12 @@ public:
 	virtual DecodedSymbol operator[](const size_t index) const = 0;
 
 	virtual size_t symbols_count() const;
+
+	/* length (up to 32) decoded values or error flags from symbol start,
+	 * the first in the MSB, so FieldReader can take a field at once.
+	 */
+	virtual uint32_t read(const size_t start, const size_t length) const;
+	virtual uint32_t read_errors(const size_t start, const size_t length) const;
 	
 	virtual ~ManchesterBase() { };
 	
@@ -55,10 +61,17 @@ protected:
 	const size_t sense;
 };
 
+/* Decodes a packed byte of chips (four symbols) per table lookup. */
 class ManchesterDecoder : public ManchesterBase {
 public:
 	using ManchesterBase::ManchesterBase;
 	DecodedSymbol operator[](const size_t index) const;
+
+	uint32_t read(const size_t start, const size_t length) const override;
+	uint32_t read_errors(const size_t start, const size_t length) const override;
+
+private:
+	void decode(const size_t start, const size_t length, uint32_t& values, uint32_t& errors) const;
 };
 
 class BiphaseMDecoder : public ManchesterBase {
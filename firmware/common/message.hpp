@@ -34,16 +34,19 @@
 
 #include "acars_packet.hpp"
 #include "adsb_frame.hpp"
+#include "ax25_packet.hpp"
 #include "ert_packet.hpp"
 #include "pocsag_packet.hpp"
 #include "sonde_packet.hpp"
 #include "tpms_packet.hpp"
+#include "spi_image.hpp"
 #include "jammer.hpp"
 #include "dsp_fir_taps.hpp"
 #include "dsp_iir.hpp"
 #include "fifo.hpp"
 
 #include "utility.hpp"
+#include "ui.hpp"
 
 #include "ch.h"
 
@@ -109,6 +112,35 @@ public:
 		AudioLevelReport = 51,
 		CodedSquelch = 52,
 		AudioSpectrum = 53,
+		ProcessorStatistics = 54,
+		ScanDwellConfig = 55,
+		ScanDwellResult = 56,
+		SweepConfig = 57,
+		SweepRetune = 58,
+		SweepRetuned = 59,
+		SweepSpectrum = 60,
+		ProcessorSelect = 61,
+		RDSGroup = 62,
+		BenchmarkResult = 63,
+		ACARSConfigure = 64,
+		ERTConfigure = 65,
+		AX25Packet = 66,
+		CaptureBurst = 67,
+		FrequencyCorrection = 68,
+		FrequencyOffset = 69,
+		FileSourceConfig = 70,
+		SyntheticSourceConfig = 71,
+		ScanGroupConfig = 72,
+		ScanGroupResult = 73,
+		RxGainStep = 74,
+		RxGainControl = 75,
+		SpectrumZoomConfig = 76,
+		TxSequenceConfig = 77,
+		TxSequenceStep = 78,
+		SigGenTones = 79,
+		SigGenSweep = 80,
+		MorseKeyerConfigure = 81,
+		LoadShedding = 82,
 		MAX
 	};
 
@@ -160,15 +192,135 @@ public:
 	BasebandStatistics statistics;
 };
 
+/* From the baseband thread, about once per second of samples, and when a
+ * file or synthetic source ends. Totals since the processor or its sample
+ * source last started, so a report lost to coalescing loses nothing.
+ * Cycles are per buffer; the budget is a buffer's worth at the sampling
+ * rate. decodes counts packets the processor passed on, packets those a
+ * synthetic source sent.
+ */
+struct ProcessorStatistics {
+	uint32_t buffers { 0 };
+	uint32_t cycles_average { 0 };
+	uint32_t cycles_max { 0 };
+	uint32_t cycles_budget { 0 };
+	uint32_t overruns { 0 };
+	uint32_t decodes { 0 };
+	uint32_t packets { 0 };
+	bool ended { false };
+};
+
+class ProcessorStatisticsMessage : public Message {
+public:
+	constexpr ProcessorStatisticsMessage(
+		const ProcessorStatistics& statistics
+	) : Message { ID::ProcessorStatistics },
+		statistics { statistics }
+	{
+	}
+
+	ProcessorStatistics statistics;
+};
+
+/* The baseband thread's load shedding level, 0 (none) to 3, changed:
+ * optional work (the spectrum, audio spectrum, audio statistics) runs one
+ * time in 1 << level. load_percent is the processor's smoothed share of
+ * the buffer period.
+ */
+class LoadSheddingMessage : public Message {
+public:
+	constexpr LoadSheddingMessage(
+		const uint32_t level,
+		const uint32_t load_percent
+	) : Message { ID::LoadShedding },
+		level { level },
+		load_percent { load_percent }
+	{
+	}
+
+	uint32_t level;
+	uint32_t load_percent;
+};
+
+/* One kernel of the benchmark image: DWT cycles for a run over samples
+ * inputs, best and mean of the runs since the previous report.
+ */
+class BenchmarkResultMessage : public Message {
+public:
+	BenchmarkResultMessage(
+		const size_t index,
+		const size_t count,
+		const char* const name,
+		const uint32_t samples,
+		const uint32_t cycles_min,
+		const uint32_t cycles_mean
+	) : Message { ID::BenchmarkResult },
+		index { static_cast<uint8_t>(index) },
+		count { static_cast<uint8_t>(count) },
+		samples { samples },
+		cycles_min { cycles_min },
+		cycles_mean { cycles_mean }
+	{
+		strncpy(this->name, name, sizeof(this->name) - 1);
+	}
+
+	uint8_t index;
+	uint8_t count;
+	char name[8] { };
+	uint32_t samples;
+	uint32_t cycles_min;
+	uint32_t cycles_mean;
+};
+
+struct CodedSquelch {
+	enum class Type : uint8_t {
+		None = 0,
+		CTCSS = 1,
+		DCS = 2,
+		DCSInverted = 3,
+	};
+
+	Type type;
+	/* CTCSS tone in 1/100Hz, or the 9 bit DCS code, named in octal. */
+	uint16_t value;
+
+	constexpr CodedSquelch(
+		Type type = Type::None,
+		uint16_t value = 0
+	) : type { type },
+		value { value }
+	{
+	}
+
+	bool operator==(const CodedSquelch& other) const {
+		return (type == other.type) && (value == other.value);
+	}
+
+	bool operator!=(const CodedSquelch& other) const {
+		return !(*this == other);
+	}
+};
+
 struct ChannelStatistics {
 	int32_t max_db;
 	size_t count;
+	/* Only NFM decodes sub-audible signalling, None elsewhere. */
+	CodedSquelch coded_squelch;
+	/* Mean power, and its height above the tracked noise floor. */
+	int32_t average_db;
+	int32_t snr_db;
 
 	constexpr ChannelStatistics(
 		int32_t max_db = -120,
-		size_t count = 0
+		size_t count = 0,
+		CodedSquelch coded_squelch = { },
+		int32_t average_db = -120,
+		int32_t snr_db = 0
 	) : max_db { max_db },
-		count { count }
+		count { count },
+		coded_squelch { coded_squelch },
+		average_db { average_db },
+		snr_db { snr_db }
 	{
 	}
 };
@@ -185,6 +337,113 @@ public:
 	ChannelStatistics statistics;
 };
 
+/* Sent by the application right after each scanner retune. The baseband
+ * skips settle_buffers (in-flight DMA, PLL lock, filter delay lines), then
+ * reports busy as soon as the channel peak reaches threshold_db (and the FM
+ * noise squelch opens, if noise_threshold is non-zero), or clear after
+ * dwell_buffers. index is the caller's channel number, echoed back.
+ */
+class ScanDwellConfigMessage : public Message {
+public:
+	constexpr ScanDwellConfigMessage(
+		const uint32_t sequence,
+		const uint32_t index,
+		const uint32_t settle_buffers,
+		const uint32_t dwell_buffers,
+		const int32_t threshold_db,
+		const float noise_threshold
+	) : Message { ID::ScanDwellConfig },
+		sequence(sequence),
+		index(index),
+		settle_buffers(settle_buffers),
+		dwell_buffers(dwell_buffers),
+		threshold_db(threshold_db),
+		noise_threshold(noise_threshold)
+	{
+	}
+
+	const uint32_t sequence;
+	const uint32_t index;
+	const uint32_t settle_buffers;
+	const uint32_t dwell_buffers;
+	const int32_t threshold_db;
+	const float noise_threshold;
+};
+
+class ScanDwellResultMessage : public Message {
+public:
+	constexpr ScanDwellResultMessage(
+		const uint32_t sequence,
+		const uint32_t index,
+		const int32_t max_db,
+		const bool busy
+	) : Message { ID::ScanDwellResult },
+		sequence(sequence),
+		index(index),
+		max_db(max_db),
+		busy(busy)
+	{
+	}
+
+	const uint32_t sequence;
+	const uint32_t index;
+	const int32_t max_db;
+	const bool busy;
+};
+
+/* Screens several channels in the current span at once, from FFT bins of
+ * the baseband: offsets are in Hz from the middle of the baseband (the
+ * LO), not from the tuning frequency. Settles and dwells as for
+ * ScanDwellConfigMessage, then reports each channel's peak level.
+ */
+class ScanGroupConfigMessage : public Message {
+public:
+	static constexpr size_t channels_max = 32;
+
+	constexpr ScanGroupConfigMessage(
+		const uint32_t sequence,
+		const uint32_t settle_buffers,
+		const uint32_t dwell_buffers,
+		const size_t count,
+		const std::array<int32_t, channels_max>& offsets
+	) : Message { ID::ScanGroupConfig },
+		sequence(sequence),
+		settle_buffers(settle_buffers),
+		dwell_buffers(dwell_buffers),
+		count(count),
+		offsets(offsets)
+	{
+	}
+
+	const uint32_t sequence;
+	const uint32_t settle_buffers;
+	const uint32_t dwell_buffers;
+	const size_t count;
+	const std::array<int32_t, channels_max> offsets;
+};
+
+/* In dB, on ScanDwellResultMessage's scale give or take the channel
+ * filter's passband: a screen to pick channels for a proper dwell, not
+ * a verdict.
+ */
+class ScanGroupResultMessage : public Message {
+public:
+	constexpr ScanGroupResultMessage(
+		const uint32_t sequence,
+		const size_t count,
+		const std::array<int8_t, ScanGroupConfigMessage::channels_max>& levels_db
+	) : Message { ID::ScanGroupResult },
+		sequence(sequence),
+		count(count),
+		levels_db(levels_db)
+	{
+	}
+
+	const uint32_t sequence;
+	const size_t count;
+	const std::array<int8_t, ScanGroupConfigMessage::channels_max> levels_db;
+};
+
 class DisplayFrameSyncMessage : public Message {
 public:
 	constexpr DisplayFrameSyncMessage(
@@ -197,11 +456,19 @@ struct AudioStatistics {
 	int32_t rms_db;
 	int32_t max_db;
 	size_t count;
+	// Audio output jitter buffer: samples queued ahead of the codec, slips
+	// since the processor started, and resampling ratio less 1.
+	uint32_t playout_fill;
+	uint32_t playout_slips;
+	int32_t playout_ratio_ppm;
 
 	constexpr AudioStatistics(
 	) : rms_db { -120 },
 		max_db { -120 },
-		count { 0 }
+		count { 0 },
+		playout_fill { 0 },
+		playout_slips { 0 },
+		playout_ratio_ppm { 0 }
 	{
 	}
 
@@ -211,7 +478,10 @@ struct AudioStatistics {
 		size_t count
 	) : rms_db { rms_db },
 		max_db { max_db },
-		count { count }
+		count { count },
+		playout_fill { 0 },
+		playout_slips { 0 },
+		playout_ratio_ppm { 0 }
 	{
 	}
 };
@@ -251,29 +521,208 @@ public:
 		Running = 1,
 	};
 
+	enum class FFT : uint32_t {
+		Float = 0,
+		FixedQ15 = 1,
+		Benchmark = 2,		// Run both, report cycles of each, display Q15
+	};
+
+	/* Traces are accumulated on the baseband side, in the same 8-bit dB
+	 * scale as the instantaneous spectrum.
+	 */
+	enum class Trace : uint32_t {
+		Instant = 0,
+		Average = 1,		// Mean of the first trace_param frames, then 1/trace_param smoothing
+		Exponential = 2,	// Smoothing factor 1/2^trace_param
+		PeakHold = 3,		// Restarts every trace_param frames, 0 = never
+		MinHold = 4,		// Restarts every trace_param frames, 0 = never
+	};
+
+	/* Waterfall row colours, computed on the baseband from the trace. The
+	 * spectrum_rgb3_lut scale spans range_db below ref_level_db (dBFS); a
+	 * range of 0 leaves ChannelSpectrum::row out. 0/51 is the db byte scale.
+	 */
+	struct Colors {
+		int32_t ref_level_db;
+		uint32_t range_db;
+	};
+
+	/* What a full ChannelSpectrumFIFO costs; either way the frames lost are
+	 * counted in ChannelSpectrum::dropped.
+	 */
+	enum class Delivery : uint32_t {
+		Latest = 0,		// Displays: the frame waiting for room is replaced by newer ones
+		Lossless = 1,	// Logging: no new frame is started until there is room
+	};
+
 	constexpr SpectrumStreamingConfigMessage(
-		Mode mode
+		Mode mode,
+		FFT fft = FFT::Float,
+		Trace trace = Trace::Instant,
+		uint32_t trace_param = 0,
+		Colors colors = { 0, 0 },
+		Delivery delivery = Delivery::Latest,
+		uint32_t fifo_k = 2
 	) : Message { ID::SpectrumStreamingConfig },
-		mode { mode }
+		mode { mode },
+		fft { fft },
+		trace { trace },
+		trace_param { trace_param },
+		colors { colors },
+		delivery { delivery },
+		fifo_k { fifo_k }
 	{
 	}
 
 	Mode mode { Mode::Stopped };
+	FFT fft { FFT::Float };
+	Trace trace { Trace::Instant };
+	uint32_t trace_param { 0 };
+	Colors colors { 0, 0 };
+	Delivery delivery { Delivery::Latest };
+	uint32_t fifo_k { 2 };		// 2^fifo_k frames, deeper than ChannelSpectrumConfigMessage::fifo_k_max in a shared ring
 };
 
 class WidebandSpectrumConfigMessage : public Message {
 public:
 	constexpr WidebandSpectrumConfigMessage (
 		size_t sampling_rate,
-		size_t trigger
+		size_t trigger,
+		size_t presum_taps
 	) : Message { ID::WidebandSpectrumConfig },
 		sampling_rate { sampling_rate },
-		trigger { trigger }
+		trigger { trigger },
+		presum_taps { presum_taps }
 	{
 	}
 
 	size_t sampling_rate { 0 };
 	size_t trigger { 0 };
+	size_t presum_taps { 0 };
+};
+
+/* Wideband spectrum zoom: the span around offset_hz, translated down to
+ * 0Hz and decimated by decimation (a power of two, 1 for no zoom), then a
+ * fft_size (256 or 1024) point FFT whose middle 256 bins are shown, for
+ * decimation * fft_size / 256 times the resolution. Both together must fit
+ * one 8192 sample buffer.
+ */
+class SpectrumZoomConfigMessage : public Message {
+public:
+	static constexpr size_t window_max = 8192;
+
+	constexpr SpectrumZoomConfigMessage(
+		const int32_t offset_hz,
+		const size_t decimation,
+		const size_t fft_size
+	) : Message { ID::SpectrumZoomConfig },
+		offset_hz { offset_hz },
+		decimation { decimation },
+		fft_size { fft_size }
+	{
+	}
+
+	const int32_t offset_hz;
+	const size_t decimation;
+	const size_t fft_size;
+};
+
+/* Stitched power bins for a whole sweep, lowest frequency first, same
+ * 0-255 scale as ChannelSpectrum. Each slice contributes the middle
+ * bins_per_slice of its 256, so slice centres must be spaced
+ * sampling_rate * bins_per_slice / 256 apart for a gapless result.
+ */
+struct SweepSpectrum {
+	static constexpr size_t slices_max = 32;
+	static constexpr size_t bins_per_slice = 240;
+	static constexpr size_t detections_max = 64;
+
+	/* A run of bins over the CFAR threshold, bins index db. Runs split by
+	 * a dip of a couple of bins are reported as one, runs at slice edges
+	 * are not joined.
+	 */
+	struct Detection {
+		uint16_t first;
+		uint16_t bin;		// Peak
+		uint8_t width;		// In bins
+		uint8_t power;		// Peak
+	};
+
+	uint32_t sequence { 0 };
+	uint32_t slice_count { 0 };
+	uint8_t mean { 0 };
+	uint8_t max { 0 };
+	uint32_t detection_count { 0 };
+	std::array<Detection, detections_max> detections { };
+	std::array<uint8_t, slices_max * bins_per_slice> db { };
+};
+
+/* The baseband owns the slice schedule: it asks for each retune with
+ * SweepRetune, drops settle_buffers once the application answers with
+ * SweepRetuned, holds the peak of ffts_per_slice spectra, and sends
+ * SweepSpectrum when the last slice is in. The application retunes to
+ * slice 0 once it is done with the data, which starts the next sweep.
+ * slice_count of 0 stops sweeping. Bins threshold over their neighbours'
+ * level (same 5 per dB scale as db) are listed in detections.
+ */
+class SweepConfigMessage : public Message {
+public:
+	constexpr SweepConfigMessage(
+		SweepSpectrum* const spectrum,
+		const uint32_t slice_count,
+		const uint32_t settle_buffers,
+		const uint32_t ffts_per_slice,
+		const uint32_t threshold
+	) : Message { ID::SweepConfig },
+		spectrum { spectrum },
+		slice_count { slice_count },
+		settle_buffers { settle_buffers },
+		ffts_per_slice { ffts_per_slice },
+		threshold { threshold }
+	{
+	}
+
+	SweepSpectrum* const spectrum;
+	const uint32_t slice_count;
+	const uint32_t settle_buffers;
+	const uint32_t ffts_per_slice;
+	const uint32_t threshold;
+};
+
+class SweepRetuneMessage : public Message {
+public:
+	constexpr SweepRetuneMessage(
+		const uint32_t slice
+	) : Message { ID::SweepRetune },
+		slice { slice }
+	{
+	}
+
+	const uint32_t slice;
+};
+
+class SweepRetunedMessage : public Message {
+public:
+	constexpr SweepRetunedMessage(
+		const uint32_t slice
+	) : Message { ID::SweepRetuned },
+		slice { slice }
+	{
+	}
+
+	const uint32_t slice;
+};
+
+class SweepSpectrumMessage : public Message {
+public:
+	constexpr SweepSpectrumMessage(
+		const SweepSpectrum* const spectrum
+	) : Message { ID::SweepSpectrum },
+		spectrum { spectrum }
+	{
+	}
+
+	const SweepSpectrum* const spectrum;
 };
 
 struct AudioSpectrum {
@@ -298,6 +747,16 @@ struct ChannelSpectrum {
 	uint32_t sampling_rate { 0 };
 	uint32_t channel_filter_pass_frequency { 0 };
 	uint32_t channel_filter_stop_frequency { 0 };
+	uint32_t fft_cycles { 0 };
+	uint32_t fft_reference_cycles { 0 };	// Float FFT cycles, benchmark mode only
+	SpectrumStreamingConfigMessage::Trace trace { SpectrumStreamingConfigMessage::Trace::Instant };
+	uint32_t trace_frames { 0 };		// Frames accumulated into db since the trace (re)started
+	uint32_t dropped { 0 };			// Frames lost to a full FIFO since streaming started
+	/* Screen width, negative frequency bins (136~255) on the left, then 0~119.
+	 * Only filled in when row_valid, see SpectrumStreamingConfigMessage::Colors.
+	 */
+	bool row_valid { false };
+	std::array<ui::Color, 240> row { };
 };
 
 using ChannelSpectrumFIFO = FIFO<ChannelSpectrum>;
@@ -305,6 +764,7 @@ using ChannelSpectrumFIFO = FIFO<ChannelSpectrum>;
 class ChannelSpectrumConfigMessage : public Message {
 public:
 	static constexpr size_t fifo_k = 2;
+	static constexpr size_t fifo_k_max = 4;
 	
 	constexpr ChannelSpectrumConfigMessage(
 		ChannelSpectrumFIFO* fifo
@@ -316,16 +776,59 @@ public:
 	ChannelSpectrumFIFO* fifo { nullptr };
 };
 
+/* Up to N fixed size packets in one message, for decoders that can
+ * outpace a wakeup of the application per packet. Only size() bytes are
+ * queued, the packets past count are left out.
+ */
+template<typename T, Message::ID Id, size_t N>
+class PacketBatchMessage : public Message {
+public:
+	using packet_t = T;
+	static constexpr size_t packets_max = N;
+
+	PacketBatchMessage(
+	) : Message { Id }
+	{
+	}
+
+	bool add(const T& packet) {
+		if( is_full() ) {
+			return false;
+		}
+		packets[count++] = packet;
+		return true;
+	}
+
+	bool is_full() const {
+		return count >= N;
+	}
+
+	void clear() {
+		count = 0;
+	}
+
+	size_t size() const {
+		return sizeof(*this) - (N - count) * sizeof(T);
+	}
+
+	uint32_t count { 0 };
+	std::array<T, N> packets { };
+};
+
 class AISPacketMessage : public Message {
 public:
 	constexpr AISPacketMessage(
-		const baseband::Packet& packet
+		const baseband::Packet& packet,
+		const uint8_t channel = 0
 	) : Message { ID::AISPacket },
-		packet { packet }
+		packet { packet },
+		channel { channel }
 	{
 	}
 
 	baseband::Packet packet;
+	// 0: 87B (161.975MHz), 1: 88B (162.025MHz)
+	uint8_t channel;
 };
 
 class TPMSPacketMessage : public Message {
@@ -343,42 +846,44 @@ public:
 	baseband::Packet packet;
 };
 
-class POCSAGPacketMessage : public Message {
-public:
-	constexpr POCSAGPacketMessage(
-		const pocsag::POCSAGPacket& packet
-	) : Message { ID::POCSAGPacket },
-		packet { packet }
-	{
-	}
-	
-	pocsag::POCSAGPacket packet;
-};
+using POCSAGPacketMessage = PacketBatchMessage<pocsag::POCSAGPacket, Message::ID::POCSAGPacket, 6>;
 
 class ACARSPacketMessage : public Message {
 public:
 	constexpr ACARSPacketMessage(
-		const baseband::Packet& packet
+		const acars::Packet& packet,
+		const uint8_t channel
 	) : Message { ID::ACARSPacket },
-		packet { packet }
+		packet { packet },
+		channel { channel }
 	{
 	}
 
-	baseband::Packet packet;
+	acars::Packet packet;
+	// Index into the ACARSConfigureMessage offsets
+	uint8_t channel;
 };
 
-class ADSBFrameMessage : public Message {
+class ACARSConfigureMessage : public Message {
 public:
-	constexpr ADSBFrameMessage(
-		const adsb::ADSBFrame& frame
-	) : Message { ID::ADSBFrame },
-		frame { frame }
+	static constexpr size_t channels_max = 3;
+
+	constexpr ACARSConfigureMessage(
+		const std::array<int32_t, channels_max>& offsets_hz,
+		const size_t channel_count
+	) : Message { ID::ACARSConfigure },
+		offsets_hz(offsets_hz),
+		channel_count(channel_count)
 	{
 	}
-	
-	adsb::ADSBFrame frame;
+
+	/* From the FS/4 shifted center of the capture, the first channel_count used. */
+	const std::array<int32_t, channels_max> offsets_hz;
+	const size_t channel_count;
 };
 
+using ADSBFrameMessage = PacketBatchMessage<adsb::ADSBFrame, Message::ID::ADSBFrame, 15>;
+
 class AFSKDataMessage : public Message {
 public:
 	constexpr AFSKDataMessage(
@@ -394,16 +899,100 @@ public:
 	uint32_t value;
 };
 
+class AX25PacketMessage : public Message {
+public:
+	constexpr AX25PacketMessage(
+		const ax25::Packet& packet
+	) : Message { ID::AX25Packet },
+		packet { packet }
+	{
+	}
+
+	ax25::Packet packet;
+};
+
 class CodedSquelchMessage : public Message {
 public:
 	constexpr CodedSquelchMessage(
-		const uint32_t value
+		const CodedSquelch coded_squelch
 	) : Message { ID::CodedSquelch },
-		value { value }
+		coded_squelch { coded_squelch }
 	{
 	}
 	
-	uint32_t value;
+	CodedSquelch coded_squelch;
+};
+
+/* To the NFM processor: fine correction tracking on or off, and how far the
+ * application moved the channel by trimming the reference.
+ */
+class FrequencyCorrectionMessage : public Message {
+public:
+	constexpr FrequencyCorrectionMessage(
+		const bool tracking,
+		const int32_t shift_hz = 0
+	) : Message { ID::FrequencyCorrection },
+		tracking { tracking },
+		shift_hz { shift_hz }
+	{
+	}
+
+	const bool tracking;
+	const int32_t shift_hz;
+};
+
+/* From the NFM processor, while locked: the fine correction applied. */
+class FrequencyOffsetMessage : public Message {
+public:
+	constexpr FrequencyOffsetMessage(
+		const int32_t offset_hz
+	) : Message { ID::FrequencyOffset },
+		offset_hz { offset_hz }
+	{
+	}
+
+	int32_t offset_hz;
+};
+
+/* From the M4's RxGainControl: a MAX2837 receive gain step wanted, -1
+ * down or +1 up, and the peak and mean power (dBFS) of the window that
+ * asked for it.
+ */
+class RxGainStepMessage : public Message {
+public:
+	constexpr RxGainStepMessage(
+		const int8_t direction,
+		const int8_t peak_db,
+		const int8_t rms_db
+	) : Message { ID::RxGainStep },
+		direction { direction },
+		peak_db { peak_db },
+		rms_db { rms_db }
+	{
+	}
+
+	int8_t direction;
+	int8_t peak_db;
+	int8_t rms_db;
+};
+
+/* Turns RxGainControl on or off. While on, each RxGainStepMessage gets
+ * one of these back with the change made, in dB (0 at a limit), which
+ * the M4 takes out of the samples digitally.
+ */
+class RxGainControlMessage : public Message {
+public:
+	constexpr RxGainControlMessage(
+		const bool enabled,
+		const int8_t applied_db = 0
+	) : Message { ID::RxGainControl },
+		enabled { enabled },
+		applied_db { applied_db }
+	{
+	}
+
+	const bool enabled;
+	const int8_t applied_db;
 };
 
 class ShutdownMessage : public Message {
@@ -414,6 +1003,21 @@ public:
 	}
 };
 
+/* Swaps the processor of a multi-processor baseband image, without
+ * restarting the image or RF streaming.
+ */
+class ProcessorSelectMessage : public Message {
+public:
+	constexpr ProcessorSelectMessage(
+		const portapack::spi_flash::image_tag_t tag
+	) : Message { ID::ProcessorSelect },
+		tag { tag }
+	{
+	}
+
+	const portapack::spi_flash::image_tag_t tag;
+};
+
 class ERTPacketMessage : public Message {
 public:
 	constexpr ERTPacketMessage(
@@ -430,20 +1034,40 @@ public:
 	baseband::Packet packet;
 };
 
+class ERTConfigureMessage : public Message {
+public:
+	constexpr ERTConfigureMessage(
+		const bool channelized
+	) : Message { ID::ERTConfigure },
+		channelized(channelized)
+	{
+	}
+
+	/* Four narrow slices around the FS/4 shifted center rather than one
+	 * envelope over the whole capture.
+	 */
+	const bool channelized;
+};
+
 class SondePacketMessage : public Message {
 public:
 	constexpr SondePacketMessage(
 		const sonde::Packet::Type type,
-		const baseband::Packet& packet
+		const baseband::Packet& packet,
+		const int fec_corrected = 0
 	) : Message { ID::SondePacket },
 		type { type },
-		packet { packet }
+		packet { packet },
+		fec_corrected { fec_corrected }
 	{
 	}
 
 	sonde::Packet::Type type;
 
 	baseband::Packet packet;
+
+	// RS41 bytes corrected in packet, -1 if beyond repair.
+	int fec_corrected;
 };
 
 class TestAppPacketMessage : public Message {
@@ -507,14 +1131,16 @@ public:
 		const fir_taps_real<64> audio_filter,
 		const size_t deviation,
 		const iir_biquad_config_t audio_hpf_config,
-		const iir_biquad_config_t audio_deemph_config
+		const iir_biquad_config_t audio_deemph_config,
+		const bool stereo
 	) : Message { ID::WFMConfigure },
 		decim_0_filter(decim_0_filter),
 		decim_1_filter(decim_1_filter),
 		audio_filter(audio_filter),
 		deviation { deviation },
 		audio_hpf_config(audio_hpf_config),
-		audio_deemph_config(audio_deemph_config)
+		audio_deemph_config(audio_deemph_config),
+		stereo { stereo }
 	{
 	}
 
@@ -524,13 +1150,33 @@ public:
 	const size_t deviation;
 	const iir_biquad_config_t audio_hpf_config;
 	const iir_biquad_config_t audio_deemph_config;
+	// Decode L-R when the pilot is present
+	const bool stereo;
+};
+
+class RDSGroupMessage : public Message {
+public:
+	constexpr RDSGroupMessage(
+		const std::array<uint16_t, 4>& blocks,
+		const uint8_t valid
+	) : Message { ID::RDSGroup },
+		blocks(blocks),
+		valid { valid }
+	{
+	}
+
+	// A, B, C (or C'), D
+	const std::array<uint16_t, 4> blocks;
+	// Bit n set when block n passed its checkword
+	const uint8_t valid;
 };
 
 class AMConfigureMessage : public Message {
 public:
 	enum class Modulation : int32_t {
 		DSB = 0,
-		SSB = 1,
+		USB = 1,
+		LSB = 2,
 	};
 
 	constexpr AMConfigureMessage(
@@ -617,21 +1263,95 @@ public:
 	}
 };
 
+/* Capture/replay pipeline health. Buffer drops and FIFO depth are updated
+ * by the baseband (M4) stream; SD card latency by the application thread.
+ */
+struct StreamStatistics {
+	/* Bin n counts transfers taking [2^(n-1), 2^n) ms, bin 0 is < 1ms and
+	 * the last bin catches everything slower.
+	 */
+	static constexpr size_t latency_bins = 8;
+
+	uint32_t buffers_dropped { 0 };
+	uint32_t fifo_high_water { 0 };
+	uint32_t latency_max_ms { 0 };
+	std::array<uint32_t, latency_bins> latency_histogram { };
+
+	void record_fifo_level(const size_t level) {
+		if( level > fifo_high_water ) {
+			fifo_high_water = level;
+		}
+	}
+
+	void record_latency(const uint32_t ms) {
+		latency_max_ms = std::max(latency_max_ms, ms);
+		size_t bin = 0;
+		while( (bin < (latency_bins - 1)) && (ms >= (1U << bin)) ) {
+			bin++;
+		}
+		latency_histogram[bin]++;
+	}
+
+	static constexpr uint32_t latency_bin_limit_ms(const size_t bin) {
+		return 1U << bin;
+	}
+};
+
 struct CaptureConfig {
+	/* What CaptureProcessor streams: complex int16, complex int8 at half
+	 * the card bandwidth, or complex int16 losslessly compressed in
+	 * iq_codec blocks. Audio processors always write int16 audio.
+	 */
+	enum class Format : uint32_t {
+		C16 = 0,
+		C8 = 1,
+		C16Rice = 2,
+	};
+
 	const size_t write_size;
 	const size_t buffer_count;
+	/* Baseband rate over the recorded rate: 8 (both IFIR stages), 4 (image
+	 * reject filter only) or 1 (raw ADC samples, not translated by fs/4).
+	 */
+	const size_t decimation;
+	const Format format;
+	/* Burst mode, with level_db non-zero: only stretches where the channel
+	 * peaks at level_db dBFS or more are streamed, from pre_ms before the
+	 * first such block to post_ms after the last, each announced with a
+	 * CaptureBurstMessage. Otherwise everything is streamed.
+	 */
+	struct Trigger {
+		int32_t level_db;
+		uint32_t pre_ms;
+		uint32_t post_ms;
+	};
+	const Trigger trigger;
+	/* Audio processors: with squelch_gate, nothing is streamed while the
+	 * squelch is closed, otherwise those stretches are silence.
+	 */
+	const bool squelch_gate;
 	uint64_t baseband_bytes_received;
 	uint64_t baseband_bytes_dropped;
+	StreamStatistics statistics;
 	FIFO<StreamBuffer*>* fifo_buffers_empty;
 	FIFO<StreamBuffer*>* fifo_buffers_full;
 
 	constexpr CaptureConfig(
 		const size_t write_size,
-		const size_t buffer_count
+		const size_t buffer_count,
+		const size_t decimation = 8,
+		const Format format = Format::C16,
+		const Trigger trigger = { 0, 0, 0 },
+		const bool squelch_gate = true
 	) : write_size { write_size },
 		buffer_count { buffer_count },
+		decimation { decimation },
+		format { format },
+		trigger { trigger },
+		squelch_gate { squelch_gate },
 		baseband_bytes_received { 0 },
 		baseband_bytes_dropped { 0 },
+		statistics { },
 		fifo_buffers_empty { nullptr },
 		fifo_buffers_full { nullptr }
 	{
@@ -642,7 +1362,7 @@ struct CaptureConfig {
 			return 0;
 		} else {
 			const size_t percent = baseband_bytes_dropped * 100U / baseband_bytes_received;
-			return std::max(1U, percent);
+			return std::max<size_t>(1, percent);
 		}
 	}
 };
@@ -659,19 +1379,53 @@ public:
 	CaptureConfig* const config;
 };
 
+/* A burst that CaptureProcessor has finished streaming: offset and length
+ * in bytes of the stream as the baseband accepted it, which is the file.
+ */
+class CaptureBurstMessage : public Message {
+public:
+	constexpr CaptureBurstMessage(
+		const uint64_t offset,
+		const uint64_t length
+	) : Message { ID::CaptureBurst },
+		offset { offset },
+		length { length }
+	{
+	}
+
+	uint64_t offset;
+	uint64_t length;
+};
+
 struct ReplayConfig {
+	/* What ReplayProcessor reads: complex int16 (.C16, and .RIQ once the
+	 * M0 has decoded it) or complex int8, which at the baseband rate goes
+	 * to the radio without any conversion.
+	 */
+	enum class Format : uint32_t {
+		C16 = 0,
+		C8 = 1,
+	};
+
 	const size_t read_size;
 	const size_t buffer_count;
+	const Format format;
 	uint64_t baseband_bytes_received;
+	uint64_t baseband_bytes_dropped;
+	StreamStatistics statistics;
 	FIFO<StreamBuffer*>* fifo_buffers_empty;
 	FIFO<StreamBuffer*>* fifo_buffers_full;
 
 	constexpr ReplayConfig(
 		const size_t read_size,
-		const size_t buffer_count
+		const size_t buffer_count,
+		const Format format = Format::C16
 	) : read_size { read_size },
 		buffer_count { buffer_count },
+		format { format },
 		baseband_bytes_received { 0 },
+		baseband_bytes_dropped { 0 },
+		statistics { },
 		fifo_buffers_empty { nullptr },
 		fifo_buffers_full { nullptr }
 	{
@@ -690,6 +1444,71 @@ public:
 	ReplayConfig* const config;
 };
 
+/* Feeds the running receive processor from a capture instead of the radio,
+ * as fast as it goes: the config's buffers of samples at its sampling rate,
+ * refilled by a ReplayThread. nullptr goes back to the radio.
+ */
+class FileSourceConfigMessage : public Message {
+public:
+	constexpr FileSourceConfigMessage(
+		ReplayConfig* const config
+	) : Message { ID::FileSourceConfig },
+		config { config }
+	{
+	}
+
+	ReplayConfig* const config;
+};
+
+/* A repeatable test signal in place of the radio, made on the M4, for
+ * benchmarking a receive processor on identical input across firmware
+ * versions. Amplitudes are of complex8 full scale (127), the noise
+ * (roughly gaussian, deterministic from seed) added on top of the signal.
+ *
+ * FSK and OOK send pattern_length bits of pattern, MSB first, already
+ * line coded as the decoder expects, at symbol_rate. Packets repeat after
+ * gap_ms of noise only.
+ */
+struct SyntheticSourceConfig {
+	enum class Mode : uint8_t {
+		Tone,
+		Noise,
+		FSK,
+		OOK,
+	};
+
+	Mode mode { Mode::Tone };
+	uint8_t amplitude { 64 };
+	uint8_t noise { 0 };
+	// Hz from the tuning frequency: the tone, or the packets' centre.
+	int32_t frequency { 0 };
+	// FSK: Hz either side of the centre, a 1 above.
+	uint32_t deviation { 0 };
+	uint32_t symbol_rate { 0 };
+	uint32_t gap_ms { 0 };
+	// Of samples, after which the stream ends. 0 runs until stopped.
+	uint32_t seconds { 0 };
+	uint32_t seed { 1 };
+	uint16_t pattern_length { 0 };
+	std::array<uint8_t, 32> pattern { };
+};
+
+/* Feeds the running receive processor from a SampleGenerator instead of
+ * the radio, as fast as it goes. Copied before the message is released.
+ * nullptr goes back to the radio.
+ */
+class SyntheticSourceConfigMessage : public Message {
+public:
+	constexpr SyntheticSourceConfigMessage(
+		const SyntheticSourceConfig* const config
+	) : Message { ID::SyntheticSourceConfig },
+		config { config }
+	{
+	}
+
+	const SyntheticSourceConfig* const config;
+};
+
 class TXProgressMessage : public Message {
 public:
 	constexpr TXProgressMessage(
@@ -701,25 +1520,93 @@ public:
 	bool done = false;
 };
 
+/* A transmitter's steps, timed on the baseband's sample clock: each step's
+ * payload (the processor's to interpret) for duration samples, or until
+ * the processor ends it when that's 0, then guard samples of silence for
+ * the application to retune. The list runs cycles times, 0 for until
+ * stopped. A count of 0 stops it.
+ */
+struct TxSequenceStep {
+	uint32_t duration;
+	uint32_t payload;
+};
+
+class TxSequenceConfigMessage : public Message {
+public:
+	static constexpr size_t steps_max = 32;
+
+	constexpr TxSequenceConfigMessage(
+		const size_t count,
+		const uint32_t cycles,
+		const uint32_t guard,
+		const std::array<TxSequenceStep, steps_max>& steps
+	) : Message { ID::TxSequenceConfig },
+		count(count),
+		cycles(cycles),
+		guard(guard),
+		steps(steps)
+	{
+	}
+
+	const size_t count;
+	const uint32_t cycles;
+	const uint32_t guard;
+	const std::array<TxSequenceStep, steps_max> steps;
+};
+
+/* Sent as a step ends: index is the step coming next, for the application
+ * to tune to during the guard. done once the last cycle's last step ends.
+ */
+class TxSequenceStepMessage : public Message {
+public:
+	constexpr TxSequenceStepMessage(
+		const uint32_t index,
+		const uint32_t cycle,
+		const bool done
+	) : Message { ID::TxSequenceStep },
+		index(index),
+		cycle(cycle),
+		done(done)
+	{
+	}
+
+	const uint32_t index;
+	const uint32_t cycle;
+	const bool done;
+};
+
 class AFSKRxConfigureMessage : public Message {
 public:
 	constexpr AFSKRxConfigureMessage(
 		const uint32_t baudrate,
+		const uint32_t mark_frequency,
+		const uint32_t space_frequency,
 		const uint32_t word_length,
 		const uint32_t trigger_value,
-		const bool trigger_word
+		const bool trigger_word,
+		const bool hdlc = false
 	) : Message { ID::AFSKRxConfigure },
 		baudrate(baudrate),
+		mark_frequency(mark_frequency),
+		space_frequency(space_frequency),
 		word_length(word_length),
 		trigger_value(trigger_value),
-		trigger_word(trigger_word)
+		trigger_word(trigger_word),
+		hdlc(hdlc)
 	{
 	}
 	
 	const uint32_t baudrate;
+	const uint32_t mark_frequency;
+	const uint32_t space_frequency;
 	const uint32_t word_length;
 	const uint32_t trigger_value;
 	const bool trigger_word;
+	/* NRZI HDLC framing: only checked AX.25 frames are sent back, as
+	 * AX25PacketMessages. The M4 then runs its own bank of tone plans, and
+	 * the tone and word settings are ignored.
+	 */
+	const bool hdlc;
 };
 
 class PitchRSSIConfigureMessage : public Message {
@@ -742,13 +1629,13 @@ public:
 	constexpr TonesConfigureMessage(
 		const uint32_t fm_delta,
 		const uint32_t pre_silence,
-		const uint16_t tone_count,
+		const bool enabled,
 		const bool dual_tone,
 		const bool audio_out
 	) : Message { ID::TonesConfigure },
 		fm_delta(fm_delta),
 		pre_silence(pre_silence),
-		tone_count(tone_count),
+		enabled(enabled),
 		dual_tone(dual_tone),
 		audio_out(audio_out)
 	{
@@ -756,11 +1643,35 @@ public:
 
 	const uint32_t fm_delta;
 	const uint32_t pre_silence;
-	const uint16_t tone_count;
+	const bool enabled;			// Symbols come from ToneData
 	const bool dual_tone;
 	const bool audio_out;
 };
 
+/* TonesProcessor as a Morse keyer: ToneData's ring carries key bits, a
+ * time unit each, MSB first. Delta and unit are for the baseband rate.
+ */
+class MorseKeyerConfigureMessage : public Message {
+public:
+	constexpr MorseKeyerConfigureMessage(
+		const uint32_t fm_delta,
+		const uint32_t tone_delta,
+		const uint32_t unit_samples,
+		const bool audio_out
+	) : Message { ID::MorseKeyerConfigure },
+		fm_delta(fm_delta),
+		tone_delta(tone_delta),
+		unit_samples(unit_samples),
+		audio_out(audio_out)
+	{
+	}
+
+	const uint32_t fm_delta;
+	const uint32_t tone_delta;
+	const uint32_t unit_samples;
+	const bool audio_out;
+};
+
 class RDSConfigureMessage : public Message {
 public:
 	constexpr RDSConfigureMessage(
@@ -787,13 +1698,17 @@ public:
 class SamplerateConfigMessage : public Message {
 public:
 	constexpr SamplerateConfigMessage(
-		const uint32_t sample_rate
+		const uint32_t sample_rate,
+		const size_t interpolation = 1
 	) : Message { ID::SamplerateConfig },
-		sample_rate(sample_rate)
+		sample_rate(sample_rate),
+		interpolation(interpolation)
 	{
 	}
 	
 	const uint32_t sample_rate = 0;
+	/* Replay: baseband samples per file sample. */
+	const size_t interpolation = 1;
 };
 
 class AudioLevelReportMessage : public Message {
@@ -803,23 +1718,35 @@ public:
 	{
 	}
 	
-	uint32_t value = 0;
+	uint32_t value = 0;		// RMS
+	uint32_t peak = 0;		// Same scale
 };
 
 class AudioTXConfigMessage : public Message {
 public:
+	// Only FM for the audio file transmitter
+	enum class Modulation : uint32_t {
+		FM = 0,
+		AM = 1,
+		DSB = 2,
+		USB = 3,
+		LSB = 4,
+	};
+
 	constexpr AudioTXConfigMessage(
 		const uint32_t divider,
 		const float deviation_hz,
 		const float audio_gain,
 		const uint32_t tone_key_delta,
-		const float tone_key_mix_weight
+		const float tone_key_mix_weight,
+		const Modulation modulation = Modulation::FM
 	) : Message { ID::AudioTXConfig },
 		divider(divider),
 		deviation_hz(deviation_hz),
 		audio_gain(audio_gain),
 		tone_key_delta(tone_key_delta),
-		tone_key_mix_weight(tone_key_mix_weight)
+		tone_key_mix_weight(tone_key_mix_weight),
+		modulation(modulation)
 	{
 	}
 
@@ -828,6 +1755,7 @@ public:
 	const float audio_gain;
 	const uint32_t tone_key_delta;
 	const float tone_key_mix_weight;
+	const Modulation modulation;
 };
 
 class SigGenConfigMessage : public Message {
@@ -860,6 +1788,52 @@ public:
 	const uint32_t tone_delta;
 };
 
+/* Summed tones, in place of SigGenTone's one. */
+class SigGenTonesMessage : public Message {
+public:
+	static constexpr size_t tones_max = 4;
+
+	constexpr SigGenTonesMessage(
+		const uint32_t count,
+		const std::array<uint32_t, tones_max> tone_deltas
+	) : Message { ID::SigGenTones },
+		count(count),
+		tone_deltas(tone_deltas)
+	{
+	}
+
+	const uint32_t count;
+	const std::array<uint32_t, tones_max> tone_deltas;
+};
+
+/* One tone swept from start to end in period samples, over and over. */
+class SigGenSweepMessage : public Message {
+public:
+	enum Kind : uint32_t {
+		LINEAR = 1,
+		LOG = 2,
+		CHIRP = 3			// Linear, up then back down
+	};
+
+	constexpr SigGenSweepMessage(
+		const Kind kind,
+		const uint32_t start_delta,
+		const uint32_t end_delta,
+		const uint32_t period
+	) : Message { ID::SigGenSweep },
+		kind(kind),
+		start_delta(start_delta),
+		end_delta(end_delta),
+		period(period)
+	{
+	}
+
+	const Kind kind;
+	const uint32_t start_delta;
+	const uint32_t end_delta;
+	const uint32_t period;
+};
+
 class AFSKTxConfigureMessage : public Message {
 public:
 	constexpr AFSKTxConfigureMessage(
@@ -893,12 +1867,14 @@ public:
 		const uint32_t stream_length,
 		const uint32_t samples_per_bit,
 		const uint8_t repeat,
-		const uint32_t pause_symbols
+		const uint32_t pause_symbols,
+		const bool runs = false
 	) : Message { ID::OOKConfigure },
 		stream_length(stream_length),
 		samples_per_bit(samples_per_bit),
 		repeat(repeat),
-		pause_symbols(pause_symbols)
+		pause_symbols(pause_symbols),
+		runs(runs)
 	{
 	}
 
@@ -906,6 +1882,8 @@ public:
 	const uint32_t samples_per_bit;
 	const uint8_t repeat;
 	const uint32_t pause_symbols;
+	// bb_data holds encoders::make_runs() runs, stream_length of them.
+	const bool runs;
 };
 
 class SSTVConfigureMessage : public Message {
@@ -920,7 +1898,7 @@ public:
 	}
 
 	const uint8_t vis_code;
-	const uint32_t pixel_duration;
+	const uint32_t pixel_duration;		// In 1/65536 samples
 };
 
 class FSKConfigureMessage : public Message {
@@ -23,32 +23,76 @@
 #define __MESSAGE_QUEUE_H__
 
 #include <cstdint>
+#include <algorithm>
 
 #include "message.hpp"
 #include "fifo.hpp"
 
 #include <ch.h>
 
+/* Messages a MessageQueue turned away for want of room, by Message::ID.
+ * Counts only grow.
+ */
+struct MessageDrops {
+	volatile uint32_t total;
+	volatile uint32_t by_id[static_cast<size_t>(Message::ID::MAX)];
+
+	void add(const Message::ID id) {
+		total += 1;
+		if( static_cast<size_t>(id) < static_cast<size_t>(Message::ID::MAX) ) {
+			by_id[static_cast<size_t>(id)] += 1;
+		}
+	}
+};
+
 class MessageQueue {
 public:
 	MessageQueue() = delete;
 	MessageQueue(const MessageQueue&) = delete;
 	MessageQueue(MessageQueue&&) = delete;
 	
+	/* Queues are single-consumer, and the consumer is on a different core
+	 * unless `doorbell` is false (app_local_queue), in which case push()
+	 * leaves waking the consumer to the caller. Messages push() fails
+	 * to queue are counted in `drops`, if given.
+	 */
 	MessageQueue(
 		uint8_t* const data,
-		size_t k
-	) : fifo { data, k }
+		size_t k,
+		const bool doorbell = true,
+		MessageDrops* const drops = nullptr
+	) : fifo { data, k },
+		doorbell { doorbell },
+		drops { drops }
 	{
 		chMtxInit(&mutex_write);
 	}
 
 	template<typename T>
 	bool push(const T& message) {
+		const bool success = try_push(message);
+		if( !success && drops ) {
+			drops->add(message.id);
+		}
+		return success;
+	}
+
+	/* As push(), for callers that keep the message to retry: not counted
+	 * as dropped. Only the first `size` bytes go into the queue, for
+	 * messages with unused space at the end, see PacketBatchMessage.
+	 */
+	template<typename T>
+	bool try_push(const T& message, const size_t size = sizeof(T)) {
 		static_assert(sizeof(T) <= Message::MAX_SIZE, "Message::MAX_SIZE too small for message type");
 		static_assert(std::is_base_of<Message, T>::value, "type is not based on Message");
 
-		return push(&message, sizeof(message));
+		return push(&message, std::min(size, sizeof(T)));
+	}
+
+	void count_drop(const Message::ID id) {
+		if( drops ) {
+			drops->add(id);
+		}
 	}
 
 	template<typename T>
@@ -67,9 +111,39 @@ public:
 		while(Message* const message = peek(message_buffer)) {
 			handler(message);
 			skip();
+			// Publish the read index before looking at the write index again;
+			// pairs with the barrier in push().
+			__DMB();
 		}
 	}
 
+	/* As handle(), but stops once more() returns false after a message, so
+	 * a burst can be spread over several passes. Returns true if the queue
+	 * was drained.
+	 */
+	template<typename HandlerFn, typename PredicateFn>
+	bool handle_while(HandlerFn handler, PredicateFn more) {
+		std::array<uint8_t, Message::MAX_SIZE> message_buffer;
+		while(Message* const message = peek(message_buffer)) {
+			handler(message);
+			skip();
+			__DMB();
+			if( !more() ) {
+				return is_empty();
+			}
+		}
+		return true;
+	}
+
+	/* Non-blocking receive: copies the oldest message into `buf` and
+	 * removes it from the queue, or returns nullptr if the queue is empty.
+	 */
+	Message* try_receive(std::array<uint8_t, Message::MAX_SIZE>& buf) {
+		Message* const message = pop(buf);
+		__DMB();
+		return message;
+	}
+
 	bool is_empty() const {
 		return fifo.is_empty();
 	}
@@ -81,6 +155,8 @@ public:
 private:
 	FIFO<uint8_t> fifo;
 	Mutex mutex_write { };
+	const bool doorbell;
+	MessageDrops* const drops;
 
 	Message* peek(std::array<uint8_t, Message::MAX_SIZE>& buf) {
 		Message* const p = reinterpret_cast<Message*>(buf.data());
@@ -101,12 +177,20 @@ private:
 	}
 
 	bool push(const void* const buf, const size_t len) {
+		// The mutex only orders producers on this core. The FIFO itself is
+		// lock-free between the producing and consuming cores.
 		chMtxLock(&mutex_write);
 		const auto result = fifo.in_r(buf, len);
+		// Publish the write index before sampling the read index.
+		__DMB();
+		// Ring the doorbell only when the consumer had already drained the
+		// queue. Otherwise it is still inside handle() and will see this
+		// message before it stops, so a burst costs one interrupt.
+		const bool consumer_idle = fifo.len() <= fifo.record_size(len);
 		chMtxUnlock();
 
 		const bool success = (result == len);
-		if( success ) {
+		if( success && doorbell && consumer_idle ) {
 			signal();
 		}
 		return success;
@@ -22,67 +22,101 @@
 
 #include "morse.hpp"
 
-#include "baseband_api.hpp"
-#include "portapack.hpp"
-using namespace portapack;
-
 #include "utility.hpp"
 
+#include <algorithm>
+
 namespace morse {
 
-// Returns 0 if message is too long
-size_t morse_encode(std::string& message, const uint32_t time_unit_ms,
-	const uint32_t tone, uint32_t * const time_units) {
+size_t Encoder::read(uint8_t * const dst, const size_t count) {
+	size_t n = 0;
 	
-	size_t i, c;
-	uint16_t code, code_size;
-	uint8_t morse_message[256];
-	uint32_t delta;
+	while (n < count) {
+		// Hold the last symbol back until the next character, a space makes it a word space
+		while (((pending_in - pending_out) < 2) && (index < message_.size()))
+			encode(message_[index++]);
+		
+		if (pending_out == pending_in) break;
+		dst[n++] = pending[pending_out++];
+	}
 	
-	*time_units = 0;
+	return n;
+}
+
+size_t Encoder::read_units(uint8_t * const dst, const size_t count) {
+	size_t n = 0;
+	uint8_t symbol;
 	
-	i = 0;
-	for (char& ch : message) {
-		if (i > 256) return 0;						// Message too long
-		
-		if ((ch >= 'a') && (ch <= 'z'))				// Make uppercase
-			ch -= 32;
-		
-		if ((ch >= '!') && (ch <= '_')) {
-			code = morse_ITU[ch - '!'];
-		} else {								
-			code = 0;								// Default to space char
+	while (n < count) {
+		while ((unit_count < 8) && read(&symbol, 1)) {
+			const auto length = morse_symbols[symbol];
+			const uint32_t key = (symbol < 2) ? ((1U << length) - 1) : 0;	// Down for dot or dash
+			unit_bits = (unit_bits << length) | key;
+			unit_count += length;
 		}
 		
-		if (!code) {
-			if (i)
-				morse_message[i - 1] = 4;			// Word space
+		if (unit_count >= 8) {
+			unit_count -= 8;
+			dst[n++] = unit_bits >> unit_count;
+		} else if (unit_count) {
+			dst[n++] = unit_bits << (8 - unit_count);
+			unit_count = 0;
 		} else {
-			code_size = code & 7;
-			
-			for (c = 0; c < code_size; c++) {
-				morse_message[i++] = ((code << c) & 0x8000) ? 1 : 0;	// Dot/dash
-				morse_message[i++] = 2;				// Symbol space
-			}
-			morse_message[i - 1] = 3;				// Letter space
+			break;
 		}
 	}
 	
-	// Count time units
-	for (c = 0; c < i; c++) {
-		*time_units += morse_symbols[morse_message[c]];
-	}
+	return n;
+}
+
+bool Encoder::done() const {
+	return (index == message_.size()) && (pending_out == pending_in) && !unit_count;
+}
+
+void Encoder::encode(char ch) {
+	uint16_t code, code_size;
+	size_t c;
+	
+	// Keep what's left at the front, a whole character fits behind it
+	std::copy(&pending[pending_out], &pending[pending_in], pending.begin());
+	pending_in -= pending_out;
+	pending_out = 0;
 	
-	memcpy(shared_memory.bb_data.tones_data.message, morse_message, i);
+	if ((ch >= 'a') && (ch <= 'z'))				// Make uppercase
+		ch -= 32;
 	
-	// Setup tone "symbols"
-	for (c = 0; c < 5; c++) {
-		if (c < 2)
-			delta = TONES_F2D(tone, TONES_SAMPLERATE);	// Dot and dash
-		else
-			delta = 0;					// Pause
+	if ((ch >= '!') && (ch <= '_')) {
+		code = morse_ITU[ch - '!'];
+	} else {								
+		code = 0;								// Default to space char
+	}
+	
+	if (!code) {
+		if (pending_in)
+			pending[pending_in - 1] = 4;		// Word space
+	} else {
+		code_size = code & 7;
 		
-		baseband::set_tone(c, delta, (TONES_SAMPLERATE * morse_symbols[c] * time_unit_ms) / 1000);
+		for (c = 0; c < code_size; c++) {
+			pending[pending_in++] = ((code << c) & 0x8000) ? 1 : 0;	// Dot/dash
+			pending[pending_in++] = 2;			// Symbol space
+		}
+		pending[pending_in - 1] = 3;			// Letter space
+	}
+}
+
+size_t morse_encode(const std::string& message, uint32_t * const time_units) {
+	Encoder encoder { message };
+	std::array<uint8_t, 32> symbols;
+	size_t i = 0, n, c;
+	
+	*time_units = 0;
+	
+	// Count symbols and time units
+	while ((n = encoder.read(symbols.data(), symbols.size()))) {
+		for (c = 0; c < n; c++)
+			*time_units += morse_symbols[symbols[c]];
+		i += n;
 	}
 	
 	return i;
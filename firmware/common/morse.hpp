@@ -26,6 +26,9 @@
 #include "tonesets.hpp"
 #include "portapack_shared_memory.hpp"
 
+#include <array>
+#include <string>
+
 #define MORSE_DOT 1
 #define MORSE_DASH 3
 #define MORSE_SYMBOL_SPACE 1
@@ -42,8 +45,38 @@ const uint32_t morse_symbols[5] = {
 	MORSE_WORD_SPACE
 };
 
-size_t morse_encode(std::string& message, const uint32_t time_unit_ms,
-	const uint32_t tone, uint32_t * const time_units);
+/* Symbols of a message, indices into morse_symbols, made a character at a
+ * time so that messages of any length stream out in bounded memory.
+ */
+class Encoder {
+public:
+	Encoder() = default;
+	Encoder(const std::string& message) : message_ { message } { }
+
+	/* Up to count symbols, returns how many. */
+	size_t read(uint8_t * const dst, const size_t count);
+	/* The same as key bits for the baseband keyer, a time unit each, 8 to a
+	 * byte MSB first. The last byte is padded with key up.
+	 */
+	size_t read_units(uint8_t * const dst, const size_t count);
+	bool done() const;
+
+private:
+	std::string message_ { };
+	size_t index { 0 };
+	// Longest character is 7 elements and their spaces
+	std::array<uint8_t, 16> pending { };
+	size_t pending_in { 0 };
+	size_t pending_out { 0 };
+	// Up to 7 units left over and a word space
+	uint32_t unit_bits { 0 };
+	size_t unit_count { 0 };
+
+	void encode(char ch);
+};
+
+// Symbol count of message, 0 if it has nothing to send.
+size_t morse_encode(const std::string& message, uint32_t * const time_units);
 
 constexpr char foxhunt_codes[11][4] = {
 	{ "MOE" },	// -----.
@@ -60,14 +60,17 @@ bool MsgPack::get_u8(const void * buffer, const bool inc, uint8_t * value) {
 	
 	v = ((uint8_t*)buffer)[seek_ptr];
 
-	if (!(v & 0x80))
-		*value = ((uint8_t*)buffer)[seek_ptr];	// Fixnum
-	else if (v == MSGPACK_TYPE_U8)
+	if (!(v & 0x80)) {
+		*value = v;		// Fixnum
+		if (inc) seek_ptr++;
+	} else if (v == MSGPACK_TYPE_U8) {
+		if ((seek_ptr + 1) >= buffer_size) return false;	// End of buffer
 		*value = ((uint8_t*)buffer)[seek_ptr + 1];	// u8
-	else
+		if (inc) seek_ptr += 2;
+	} else {
 		return false;		// Value isn't a u8 or fixnum
+	}
 	
-	if (inc) seek_ptr++;
 	return true;
 }
 
@@ -76,7 +79,7 @@ bool MsgPack::get_u8(const void * buffer, const bool inc, uint8_t * value) {
 bool MsgPack::get_u16(const void * buffer, const bool inc, uint16_t * value) {
 	uint8_t byte;
 	
-	if ((seek_ptr + 1) >= buffer_size) return false;	// End of buffer
+	if ((seek_ptr + 2) >= buffer_size) return false;	// End of buffer
 	if ((get_raw_byte(buffer, true, &byte)) && (byte != MSGPACK_TYPE_U16)) return false;		// Value isn't a u16
 	*value = (((uint8_t*)buffer)[seek_ptr] << 8) | ((uint8_t*)buffer)[seek_ptr + 1];
 	if (inc) seek_ptr += 2;
@@ -86,7 +89,7 @@ bool MsgPack::get_u16(const void * buffer, const bool inc, uint16_t * value) {
 bool MsgPack::get_s32(const void * buffer, const bool inc, int32_t * value) {
 	uint8_t byte;
 	
-	if ((seek_ptr + 3) >= buffer_size) return false;	// End of buffer
+	if ((seek_ptr + 4) >= buffer_size) return false;	// End of buffer
 	if ((get_raw_byte(buffer, true, &byte)) && (byte != MSGPACK_TYPE_S32)) return false;		// Value isn't a s32
 	*value = (((uint8_t*)buffer)[seek_ptr] << 24) | (((uint8_t*)buffer)[seek_ptr + 1] << 16) |
 				(((uint8_t*)buffer)[seek_ptr + 2] << 8) | ((uint8_t*)buffer)[seek_ptr + 3];
@@ -94,24 +97,75 @@ bool MsgPack::get_s32(const void * buffer, const bool inc, int32_t * value) {
 	return true;
 }
 
-bool MsgPack::get_string(const void * buffer, const bool inc, std::string& value) {
-	size_t length;
+bool MsgPack::get_int(const void * buffer, const bool inc, int64_t * value) {
 	uint8_t byte;
+	size_t c, length;
+	bool is_signed = false;
+	uint64_t raw = 0;
+	
+	if (!get_raw_byte(buffer, false, &byte)) return false;	// End of buffer
 	
-	// Todo: Set max length !
-	if ((seek_ptr + 3) >= buffer_size) return false;	// End of buffer
-	if ((get_raw_byte(buffer, true, &byte)) && (byte != MSGPACK_TYPE_STR8)
-			&& (byte != MSGPACK_TYPE_STR16)) return false;		// Value isn't a str8 or str16
+	if (!(byte & 0x80) || ((byte & 0xE0) == 0xE0)) {
+		*value = (int8_t)byte;		// Positive or negative fixnum
+		if (inc) seek_ptr++;
+		return true;
+	}
+	
+	switch (byte) {
+		case MSGPACK_TYPE_U8:	length = 1;	break;
+		case MSGPACK_TYPE_U16:	length = 2;	break;
+		case MSGPACK_TYPE_U32:	length = 4;	break;
+		case MSGPACK_TYPE_U64:	length = 8;	break;
+		case MSGPACK_TYPE_S8:	length = 1;	is_signed = true;	break;
+		case MSGPACK_TYPE_S16:	length = 2;	is_signed = true;	break;
+		case MSGPACK_TYPE_S32:	length = 4;	is_signed = true;	break;
+		case MSGPACK_TYPE_S64:	length = 8;	is_signed = true;	break;
+		default:
+			return false;		// Value isn't an integer
+	}
+	
+	if ((seek_ptr + length) >= buffer_size) return false;	// End of buffer
+	for (c = 0; c < length; c++)
+		raw = (raw << 8) | ((const uint8_t*)buffer)[seek_ptr + 1 + c];
+	if (is_signed && (length < 8) && (raw & (1ULL << (length * 8 - 1))))
+		raw |= ~0ULL << (length * 8);		// Sign extend
+	
+	*value = raw;
+	if (inc) seek_ptr += 1 + length;
+	return true;
+}
 
-	if (byte == MSGPACK_TYPE_STR8) {
-		if (!get_raw_byte(buffer, true, (uint8_t*)&length)) return false;		// Couldn't get str8 length
+bool MsgPack::get_chars(const void * buffer, const bool inc, const char ** chars, size_t * length) {
+	uint8_t byte, length8;
+	uint16_t length16;
+	
+	if (!get_raw_byte(buffer, true, &byte)) return false;	// End of buffer
+	
+	if ((byte & 0xE0) == 0xA0) {
+		*length = byte & 0x1F;		// Fixstr
+	} else if (byte == MSGPACK_TYPE_STR8) {
+		if (!get_raw_byte(buffer, true, &length8)) return false;		// Couldn't get str8 length
+		*length = length8;
 	} else if (byte == MSGPACK_TYPE_STR16) {
-		if (!get_raw_word(buffer, true, (uint16_t*)&length)) return false;		// Couldn't get str16 length
+		if (!get_raw_word(buffer, true, &length16)) return false;		// Couldn't get str16 length
+		*length = length16;
+	} else {
+		return false;		// Value isn't a string
 	}
 	
-	memcpy(&value[0], ((uint8_t*)buffer), length); //std::string(
+	if ((seek_ptr + *length) > buffer_size) return false;	// End of buffer
+	*chars = &((const char*)buffer)[seek_ptr];
 
-	if (inc) seek_ptr += length;
+	if (inc) seek_ptr += *length;
+	return true;
+}
+
+bool MsgPack::get_string(const void * buffer, const bool inc, std::string& value) {
+	const char * chars;
+	size_t length;
+	
+	if (!get_chars(buffer, inc, &chars, &length)) return false;
+	value.assign(chars, length);
 	return true;
 }
 
@@ -130,8 +184,9 @@ bool MsgPack::init_search(const void * buffer, const size_t size) {
 }
 
 bool MsgPack::skip(const void * buffer) {
-	uint8_t byte, c;
-	size_t length;
+	uint8_t byte, length8;
+	uint16_t length16;
+	size_t c, length;
 	
 	if (!get_raw_byte(buffer, true, &byte)) return false;		// Couldn't get type
 	
@@ -139,18 +194,18 @@ bool MsgPack::skip(const void * buffer) {
 	if ((byte & 0xE0) == 0xE0) return true;		// Negative fixnum, already skipped by get_raw_byte
 	if ((byte & 0xE0) == 0xA0) {				// Fixstr
 		seek_ptr += (byte & 0x1F);
-		return true;
+		return seek_ptr <= buffer_size;
 	}
 	if ((byte & 0xF0) == 0x80) {				// Fixmap
 		length = (byte & 0x0F) * 2;
 		for (c = 0; c < length; c++)
-			skip(buffer);
+			if (!skip(buffer)) return false;
 		return true;
 	}
 	if ((byte & 0xF0) == 0x90) {				// Fixarray
 		length = byte & 0x0F;
 		for (c = 0; c < length; c++)
-			skip(buffer);
+			if (!skip(buffer)) return false;
 		return true;
 	}
 	
@@ -177,86 +232,137 @@ bool MsgPack::skip(const void * buffer) {
 			break;
 			
 		case MSGPACK_TYPE_STR8:
-			if (!get_raw_byte(buffer, true, (uint8_t*)&length)) return false;		// Couldn't get str8 length
-			seek_ptr += length;
+			if (!get_raw_byte(buffer, true, &length8)) return false;		// Couldn't get str8 length
+			seek_ptr += length8;
 			break;
 		case MSGPACK_TYPE_STR16:
-			if (!get_raw_word(buffer, true, (uint16_t*)&length)) return false;		// Couldn't get str16 length
-			seek_ptr += length;
+			if (!get_raw_word(buffer, true, &length16)) return false;		// Couldn't get str16 length
+			seek_ptr += length16;
 			break;
 		
 		case MSGPACK_TYPE_ARR16:
-			if (!get_raw_word(buffer, true, (uint16_t*)&length)) return false;		// Couldn't get arr16 length
-			for (c = 0; c < length; c++)
-				skip(buffer);
+			if (!get_raw_word(buffer, true, &length16)) return false;		// Couldn't get arr16 length
+			for (c = 0; c < length16; c++)
+				if (!skip(buffer)) return false;
 			break;
 			
 		case MSGPACK_TYPE_MAP16:
-			if (!get_raw_word(buffer, true, (uint16_t*)&length)) return false;		// Couldn't get map16 length
-			for (c = 0; c < (length * 2); c++)
-				skip(buffer);
+			if (!get_raw_word(buffer, true, &length16)) return false;		// Couldn't get map16 length
+			for (c = 0; c < (length16 * 2U); c++)
+				if (!skip(buffer)) return false;
 			break;
 			
 		default:
 			return false;	// Type unsupported
 	}
 	
-	return true;
+	return seek_ptr <= buffer_size;
 }
 
-bool MsgPack::search_key(const void * buffer, const MsgPack::RecID record_id) {
+bool MsgPack::search_key(const void * buffer, const uint16_t key) {
 	uint8_t byte;
-	uint16_t key;
+	uint16_t record_key;
 	
 	while (get_raw_byte(buffer, false, &byte)) {
-		if (!get_u16(buffer, true, &key)) return false;	// Couldn't get key
-		if (key == record_id) return true;				// Found record
+		if (!get_u16(buffer, true, &record_key)) return false;	// Couldn't get key
+		if (record_key == key) return true;				// Found record
 		if (!skip(buffer)) return false;				// Can't skip to next key
 	};
 	return false;
 }
 
-bool MsgPack::msgpack_get(const void * buffer, const size_t size, const RecID record_id, bool * value) {
-	init_search(buffer, size);
-	if (!search_key(buffer, record_id)) return false;	// Record not found
+bool MsgPack::msgpack_get(const void * buffer, const size_t size, const uint16_t key, bool * value) {
+	if (!init_search(buffer, size)) return false;
+	if (!search_key(buffer, key)) return false;	// Record not found
 	if (!get_bool(buffer, false, value)) return false;	// Value isn't a bool
 	
 	return true;
 }
 
-bool MsgPack::msgpack_get(const void * buffer, const size_t size, const RecID record_id, uint8_t * value) {
+bool MsgPack::msgpack_get(const void * buffer, const size_t size, const uint16_t key, uint8_t * value) {
 	if (!init_search(buffer, size)) return false;
-	if (!search_key(buffer, record_id)) return false;	// Record not found
+	if (!search_key(buffer, key)) return false;	// Record not found
 	if (!get_u8(buffer, false, value)) return false;	// Value isn't a u8
 	
 	return true;
 }
 
-bool MsgPack::msgpack_get(const void * buffer, const size_t size, const RecID record_id, int64_t * value) {
+bool MsgPack::msgpack_get(const void * buffer, const size_t size, const uint16_t key, int64_t * value) {
+	if (!init_search(buffer, size)) return false;
+	if (!search_key(buffer, key)) return false;	// Record not found
+	if (!get_int(buffer, false, value)) return false;	// Value isn't an integer
+	
+	return true;
+}
+
+bool MsgPack::msgpack_get(const void * buffer, const size_t size, const uint16_t key, std::string& value) {
+	if (!init_search(buffer, size)) return false;
+	if (!search_key(buffer, key)) return false;	// Record not found
+	if (!get_string(buffer, false, value)) return false;	// Value isn't a char array
+	
+	return true;
+}
+
+size_t MsgPack::msgpack_length(const void * buffer, const size_t size) {
 	uint8_t byte;
 	
-	init_search(buffer, size);
-	if (!search_key(buffer, record_id)) return false;	// Record not found
+	buffer_size = size;
+	seek_ptr = 0;
+	if (!get_raw_byte(buffer, false, &byte) || (byte != MSGPACK_TYPE_MAP16)) return 0;	// Not a map16
+	if (!skip(buffer)) return 0;			// Truncated
+	
+	return seek_ptr;
+}
+
+bool MsgPack::msgpack_begin(const void * buffer, const size_t size) {
+	uint8_t byte;
+	uint16_t map_size;
 	
-	if ((seek_ptr + 3) >= buffer_size) return false;	// End of buffer
-	if ((get_raw_byte(buffer, true, &byte)) && (byte != MSGPACK_TYPE_S64)) return false;		// Value isn't a s64
-	*value = ((int64_t)((uint8_t*)buffer)[seek_ptr] << 56) | ((int64_t)((uint8_t*)buffer)[seek_ptr + 1] << 48) |
-				((int64_t)((uint8_t*)buffer)[seek_ptr + 2] << 40) | ((int64_t)((uint8_t*)buffer)[seek_ptr + 3] << 32) |
-				(((uint8_t*)buffer)[seek_ptr + 4] << 24) | (((uint8_t*)buffer)[seek_ptr + 5] << 16) |
-				(((uint8_t*)buffer)[seek_ptr + 6] << 8) | ((uint8_t*)buffer)[seek_ptr + 7];
+	buffer_size = size;
+	seek_ptr = 0;
+	entries_left = 0;
+	on_value = false;
+	if (!get_raw_byte(buffer, true, &byte) || (byte != MSGPACK_TYPE_MAP16)) return false;	// Not a map16
+	if (!get_raw_word(buffer, true, &map_size)) return false;		// Couldn't get map16 size
+	entries_left = map_size;
 	
 	return true;
 }
 
-bool MsgPack::msgpack_get(const void * buffer, const size_t size, const RecID record_id, std::string& value) {
-	init_search(buffer, size);
-	if (!search_key(buffer, record_id)) return false;	// Record not found
-	if (!get_string(buffer, false, value)) return false;	// Value isn't a char array
+bool MsgPack::msgpack_next(const void * buffer, uint16_t * key) {
+	if (on_value) {
+		// Past the value whether or not it was read
+		seek_ptr = value_ptr;
+		on_value = false;
+		if (!skip(buffer)) return false;
+	}
+	
+	if (!entries_left) return false;		// End of map
+	if (!get_u16(buffer, true, key)) return false;		// Couldn't get key
+	entries_left--;
+	value_ptr = seek_ptr;
+	on_value = true;
 	
 	return true;
 }
 
+bool MsgPack::msgpack_value(const void * buffer, bool * value) {
+	if (!on_value) return false;
+	seek_ptr = value_ptr;
+	return get_bool(buffer, false, value);
+}
 
+bool MsgPack::msgpack_value(const void * buffer, int64_t * value) {
+	if (!on_value) return false;
+	seek_ptr = value_ptr;
+	return get_int(buffer, false, value);
+}
+
+bool MsgPack::msgpack_value(const void * buffer, const char ** chars, size_t * length) {
+	if (!on_value) return false;
+	seek_ptr = value_ptr;
+	return get_chars(buffer, false, chars, length);
+}
 
 void MsgPack::msgpack_init(const void * buffer, size_t * ptr) {
 	((uint8_t*)buffer)[0] = MSGPACK_TYPE_MAP16;
@@ -266,24 +372,24 @@ void MsgPack::msgpack_init(const void * buffer, size_t * ptr) {
 	*ptr = 3;
 }
 
-void MsgPack::add_key(const void * buffer, size_t * ptr, const RecID record_id) {
-	uint16_t key;
+void MsgPack::add_key(const void * buffer, size_t * ptr, const uint16_t key) {
+	uint16_t map_size;
 	
 	((uint8_t*)buffer)[(*ptr)++] = MSGPACK_TYPE_U16;
-	((uint8_t*)buffer)[(*ptr)++] = record_id >> 8;
-	((uint8_t*)buffer)[(*ptr)++] = record_id & 0xFF;
+	((uint8_t*)buffer)[(*ptr)++] = key >> 8;
+	((uint8_t*)buffer)[(*ptr)++] = key & 0xFF;
 	
 	// Auto-inc MAP16 size which should be at the beginning of the buffer
 	
-	key = (((uint8_t*)buffer)[1] << 8) | ((uint8_t*)buffer)[2];
-	key++;
+	map_size = (((uint8_t*)buffer)[1] << 8) | ((uint8_t*)buffer)[2];
+	map_size++;
 	
-	((uint8_t*)buffer)[1] = key >> 8;
-	((uint8_t*)buffer)[2] = key & 0xFF;
+	((uint8_t*)buffer)[1] = map_size >> 8;
+	((uint8_t*)buffer)[2] = map_size & 0xFF;
 }
 
-void MsgPack::msgpack_add(const void * buffer, size_t * ptr, const RecID record_id, bool value) {
-	add_key(buffer, ptr, record_id);
+void MsgPack::msgpack_add(const void * buffer, size_t * ptr, const uint16_t key, bool value) {
+	add_key(buffer, ptr, key);
 	
 	if (value)
 		((uint8_t*)buffer)[(*ptr)++] = MSGPACK_TRUE;
@@ -291,8 +397,8 @@ void MsgPack::msgpack_add(const void * buffer, size_t * ptr, const RecID record_
 		((uint8_t*)buffer)[(*ptr)++] = MSGPACK_FALSE;
 }
 
-void MsgPack::msgpack_add(const void * buffer, size_t * ptr, const RecID record_id, uint8_t value) {
-	add_key(buffer, ptr, record_id);
+void MsgPack::msgpack_add(const void * buffer, size_t * ptr, const uint16_t key, uint8_t value) {
+	add_key(buffer, ptr, key);
 	
 	if (value < 128) {
 		((uint8_t*)buffer)[(*ptr)++] = value;
@@ -302,40 +408,56 @@ void MsgPack::msgpack_add(const void * buffer, size_t * ptr, const RecID record_
 	}
 }
 
-void MsgPack::msgpack_add(const void * buffer, size_t * ptr, const RecID record_id, int64_t value) {
-	uint8_t c;
+void MsgPack::msgpack_add(const void * buffer, size_t * ptr, const uint16_t key, int64_t value) {
+	uint8_t c, length;
+	
+	add_key(buffer, ptr, key);
 	
-	add_key(buffer, ptr, record_id);
+	if ((value >= -32) && (value < 128)) {
+		((uint8_t*)buffer)[(*ptr)++] = value & 0xFF;		// Positive or negative fixnum
+		return;
+	}
 	
-	((uint8_t*)buffer)[(*ptr)++] = MSGPACK_TYPE_S64;
+	if ((value >= INT8_MIN) && (value <= INT8_MAX)) {
+		((uint8_t*)buffer)[(*ptr)++] = MSGPACK_TYPE_S8;
+		length = 1;
+	} else if ((value >= INT16_MIN) && (value <= INT16_MAX)) {
+		((uint8_t*)buffer)[(*ptr)++] = MSGPACK_TYPE_S16;
+		length = 2;
+	} else if ((value >= INT32_MIN) && (value <= INT32_MAX)) {
+		((uint8_t*)buffer)[(*ptr)++] = MSGPACK_TYPE_S32;
+		length = 4;
+	} else {
+		((uint8_t*)buffer)[(*ptr)++] = MSGPACK_TYPE_S64;
+		length = 8;
+	}
 	
-	for (c = 0; c < 8; c++)
-		((uint8_t*)buffer)[(*ptr)++] = (value >> (8 * (7 - c))) & 0xFF;
+	for (c = 0; c < length; c++)
+		((uint8_t*)buffer)[(*ptr)++] = (value >> (8 * (length - 1 - c))) & 0xFF;
 }
 
-bool MsgPack::msgpack_add(const void * buffer, size_t * ptr, const RecID record_id, std::string value) {
-	uint8_t c;
-	size_t length;
+bool MsgPack::msgpack_add(const void * buffer, size_t * ptr, const uint16_t key, const char * chars, const size_t length) {
+	if (length >= 65536) return false;
 	
-	add_key(buffer, ptr, record_id);
-	
-	length = value.size();
+	add_key(buffer, ptr, key);
 	
 	if (length < 32) {
 		((uint8_t*)buffer)[(*ptr)++] = length | 0xA0;			// Fixstr
 	} else if ((length >= 32) && (length < 256)) {
 		((uint8_t*)buffer)[(*ptr)++] = MSGPACK_TYPE_STR8;
 		((uint8_t*)buffer)[(*ptr)++] = length;
-	} else if ((length >= 256) && (length < 65536)) {
+	} else {
 		((uint8_t*)buffer)[(*ptr)++] = MSGPACK_TYPE_STR16;
 		((uint8_t*)buffer)[(*ptr)++] = length >> 8;
 		((uint8_t*)buffer)[(*ptr)++] = length & 0xFF;
-	} else {
-		return false;
 	}
 	
-	for (c = 0; c < length; c++)
-		((uint8_t*)buffer)[(*ptr)++] = value[c];
+	memcpy(&((uint8_t*)buffer)[*ptr], chars, length);
+	*ptr += length;
 		
 	return true;
 }
+
+bool MsgPack::msgpack_add(const void * buffer, size_t * ptr, const uint16_t key, const std::string& value) {
+	return msgpack_add(buffer, ptr, key, value.data(), value.size());
+}
@@ -24,8 +24,10 @@
 #define __MSGPACK_H__
 
 #include "ui.hpp"
+#include <cstdint>
 #include <memory>
 #include <cstring>
+#include <string>
 
 #define MSGPACK_NIL			0xC0
 
@@ -66,18 +68,34 @@ public:
 		TestListE = 4
 	};
 
-	// Read
-	bool msgpack_get(const void * buffer, const size_t size, const RecID record_id, bool * value);
-	bool msgpack_get(const void * buffer, const size_t size, const RecID record_id, uint8_t * value);
-	bool msgpack_get(const void * buffer, const size_t size, const RecID record_id, int64_t * value);
-	bool msgpack_get(const void * buffer, const size_t size, const RecID record_id, std::string& value);
+	/* Keys are u16, a RecID or any other. Buffers hold one map16. */
+
+	// Read, searching from the start for each key. Integers of any encoding
+	bool msgpack_get(const void * buffer, const size_t size, const uint16_t key, bool * value);
+	bool msgpack_get(const void * buffer, const size_t size, const uint16_t key, uint8_t * value);
+	bool msgpack_get(const void * buffer, const size_t size, const uint16_t key, int64_t * value);
+	bool msgpack_get(const void * buffer, const size_t size, const uint16_t key, std::string& value);
+	
+	/* Read in one pass: msgpack_begin, then msgpack_next to step to each
+	 * key in order and msgpack_value for the one under the cursor, if
+	 * wanted. Strings come back as spans of buffer, nothing is copied.
+	 */
+	bool msgpack_begin(const void * buffer, const size_t size);
+	bool msgpack_next(const void * buffer, uint16_t * key);
+	bool msgpack_value(const void * buffer, bool * value);
+	bool msgpack_value(const void * buffer, int64_t * value);
+	bool msgpack_value(const void * buffer, const char ** chars, size_t * length);
 	
-	// Write
+	// Bytes taken by the map at the start of buffer, 0 if it's truncated or not a map16
+	size_t msgpack_length(const void * buffer, const size_t size);
+	
+	// Write. Integers take their shortest encoding, 9 bytes at most
 	void msgpack_init(const void * buffer, size_t * ptr);
-	void msgpack_add(const void * buffer, size_t * ptr, const RecID record_id, bool value);
-	void msgpack_add(const void * buffer, size_t * ptr, const RecID record_id, uint8_t value);
-	void msgpack_add(const void * buffer, size_t * ptr, const RecID record_id, int64_t value);
-	bool msgpack_add(const void * buffer, size_t * ptr, const RecID record_id, std::string value);
+	void msgpack_add(const void * buffer, size_t * ptr, const uint16_t key, bool value);
+	void msgpack_add(const void * buffer, size_t * ptr, const uint16_t key, uint8_t value);
+	void msgpack_add(const void * buffer, size_t * ptr, const uint16_t key, int64_t value);
+	bool msgpack_add(const void * buffer, size_t * ptr, const uint16_t key, const char * chars, const size_t length);
+	bool msgpack_add(const void * buffer, size_t * ptr, const uint16_t key, const std::string& value);
 
 private:
 	bool get_raw_byte(const void * buffer, const bool inc, uint8_t * byte);
@@ -86,16 +104,23 @@ private:
 	bool get_u8(const void * buffer, const bool inc, uint8_t * value);
 	bool get_u16(const void * buffer, const bool inc, uint16_t * value);
 	bool get_s32(const void * buffer, const bool inc, int32_t * value);
+	bool get_int(const void * buffer, const bool inc, int64_t * value);
+	bool get_chars(const void * buffer, const bool inc, const char ** chars, size_t * length);
 	bool get_string(const void * buffer, const bool inc, std::string& value);
 	
-	void add_key(const void * buffer, size_t * ptr, const RecID record_id);
+	void add_key(const void * buffer, size_t * ptr, const uint16_t key);
 	
 	bool init_search(const void * buffer, const size_t size);
-	bool search_key(const void * buffer, const RecID record_id);
+	bool search_key(const void * buffer, const uint16_t key);
 	bool skip(const void * buffer);
 	
 	size_t seek_ptr = 0;
-	size_t buffer_size;
+	size_t buffer_size = 0;
+	
+	// Cursor
+	size_t entries_left = 0;
+	size_t value_ptr = 0;
+	bool on_value = false;
 };
 
 #endif
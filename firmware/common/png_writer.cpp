@@ -21,6 +21,9 @@
 
 #include "png_writer.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 static constexpr std::array<uint8_t, 8> png_file_header { {
 	0x89, 0x50, 0x4e, 0x47,
 	0x0d, 0x0a, 0x1a, 0x0a,
@@ -49,6 +52,29 @@ static constexpr std::array<uint8_t, 12> png_iend { {
 	0xae, 0x42, 0x60, 0x82,		// CRC
 } };
 
+static constexpr size_t match_length_min = 3;
+static constexpr size_t match_length_max = 258;
+
+static constexpr std::array<uint16_t, 29> length_base { {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+} };
+
+static constexpr std::array<uint8_t, 29> length_extra_bits { {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+} };
+
+static constexpr std::array<uint16_t, 30> distance_base { {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+} };
+
+static constexpr std::array<uint8_t, 30> distance_extra_bits { {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+} };
+
 Optional<File::Error> PNGWriter::create(
 	const std::filesystem::path& filename
 ) {
@@ -60,48 +86,138 @@ Optional<File::Error> PNGWriter::create(
 	file.write(png_file_header);
 	file.write(png_ihdr_screen_capture);
 	
-	write_chunk_header(
-		2 + height * (5 + 1 + width * 3) + 4,
-		png_idat_chunk_type
-	);
+	idat[idat_size++] = 0x78;	// Zlib CM, CINFO, FLG.
+	idat[idat_size++] = 0x01;
 
-	constexpr std::array<uint8_t, 2> zlib_header { 0x78, 0x01 };	// Zlib CM, CINFO, FLG.
-	write_chunk_content(zlib_header);
+	put_bits(1, 1);		// BFINAL, the only block
+	put_bits(1, 2);		// BTYPE = 01, fixed Huffman codes
 
 	return { };
 }
 
 PNGWriter::~PNGWriter() {
-	write_chunk_content(adler_32.bytes());
-	write_chunk_crc();
+	put_code(0, 7);		// End of block
+	if( bit_count ) {
+		put_bits(0, 8 - bit_count);
+	}
+
+	const auto adler = adler_32.bytes();
+	std::copy(adler.begin(), adler.end(), &idat[idat_size]);
+	idat_size += adler.size();
+	flush_idat();
 
 	file.write(png_iend);
 }
 
 void PNGWriter::write_scanline(const std::array<ui::ColorRGB888, 240>& scanline) {
 	constexpr uint8_t scanline_filter_type = 0;
-	constexpr uint32_t deflate_block_length = 1 + sizeof(scanline);
-
-	const std::array<uint8_t, 6> deflate_and_scanline_header {
-		static_cast<uint8_t>((scanline_count == (height - 1)) ? 0x01 : 0x00),	// DEFLATE header bits, bfinal=0, btype=00
-		static_cast<uint8_t>((deflate_block_length >> 0) & 0xff),			// Length LSB
-		static_cast<uint8_t>((deflate_block_length >> 8) & 0xff),			// Length MSB
-		static_cast<uint8_t>((deflate_block_length >> 0) & 0xff) ^ 0xff,	// ~Length LSB
-		static_cast<uint8_t>((deflate_block_length >> 8) & 0xff) ^ 0xff,	// ~Length MSB
-		scanline_filter_type,
-	};
-	write_chunk_content(deflate_and_scanline_header);
-
-	adler_32.feed(scanline_filter_type);
-	adler_32.feed(scanline);
-
-	// Small writes to avoid some sort of large-transfer plus block
-	// boundary FatFs or SDC driver bug?
-	write_chunk_content(&scanline[  0], 80 * sizeof(ui::ColorRGB888));
-	write_chunk_content(&scanline[ 80], 80 * sizeof(ui::ColorRGB888));
-	write_chunk_content(&scanline[160], 80 * sizeof(ui::ColorRGB888));
 
+	std::array<uint8_t, scanline_bytes> current;
+	current[0] = scanline_filter_type;
+	memcpy(&current[1], scanline.data(), sizeof(scanline));
+	adler_32.feed(current);
+
+	// Greedy: the longer of a run of the pixel to the left and a run of the
+	// scanline above, otherwise a literal. Matches stay within the scanline.
+	constexpr size_t pixel_distance = sizeof(ui::ColorRGB888);
+	const bool have_previous = (scanline_count > 0);
+	size_t i = 0;
+	while( i < current.size() ) {
+		const size_t limit = std::min(current.size() - i, match_length_max);
+
+		size_t left_length = 0;
+		if( i >= pixel_distance ) {
+			while( (left_length < limit) && (current[i + left_length] == current[i + left_length - pixel_distance]) ) {
+				left_length++;
+			}
+		}
+
+		size_t up_length = 0;
+		if( have_previous ) {
+			while( (up_length < limit) && (current[i + up_length] == previous_scanline[i + up_length]) ) {
+				up_length++;
+			}
+		}
+
+		if( std::max(left_length, up_length) >= match_length_min ) {
+			if( up_length > left_length ) {
+				put_match(up_length, scanline_bytes);
+				i += up_length;
+			} else {
+				put_match(left_length, pixel_distance);
+				i += left_length;
+			}
+		} else {
+			put_literal(current[i]);
+			i++;
+		}
+	}
+
+	previous_scanline = current;
 	scanline_count++;
+
+	if( idat_size > (idat.size() - scanline_compressed_max) ) {
+		flush_idat();
+	}
+}
+
+void PNGWriter::put_bits(const uint32_t value, const size_t count) {
+	bit_buffer |= value << bit_count;
+	bit_count += count;
+	while( bit_count >= 8 ) {
+		idat[idat_size++] = bit_buffer & 0xff;
+		bit_buffer >>= 8;
+		bit_count -= 8;
+	}
+}
+
+void PNGWriter::put_code(const uint32_t code, const size_t length) {
+	// Huffman codes go out most significant bit first.
+	uint32_t reversed = 0;
+	for(size_t n=0; n<length; n++) {
+		reversed |= ((code >> n) & 1) << (length - 1 - n);
+	}
+	put_bits(reversed, length);
+}
+
+void PNGWriter::put_literal(const uint8_t value) {
+	if( value < 144 ) {
+		put_code(0x30 + value, 8);
+	} else {
+		put_code(0x190 + (value - 144), 9);
+	}
+}
+
+void PNGWriter::put_match(const size_t length, const size_t distance) {
+	size_t l = length_base.size() - 1;
+	while( length_base[l] > length ) {
+		l--;
+	}
+	const uint32_t symbol = 257 + l;
+	if( symbol < 280 ) {
+		put_code(symbol - 256, 7);
+	} else {
+		put_code(0xc0 + (symbol - 280), 8);
+	}
+	put_bits(length - length_base[l], length_extra_bits[l]);
+
+	size_t d = distance_base.size() - 1;
+	while( distance_base[d] > distance ) {
+		d--;
+	}
+	put_code(d, 5);
+	put_bits(distance - distance_base[d], distance_extra_bits[d]);
+}
+
+void PNGWriter::flush_idat() {
+	if( idat_size == 0 ) {
+		return;
+	}
+
+	write_chunk_header(idat_size, png_idat_chunk_type);
+	write_chunk_content(idat.data(), idat_size);
+	write_chunk_crc();
+	idat_size = 0;
 }
 
 void PNGWriter::write_chunk_header(
@@ -31,6 +31,11 @@
 #include "file.hpp"
 #include "crc.hpp"
 
+/* Screen captures as PNG, compressed with a single fixed Huffman deflate
+ * block. Matches are only looked for one pixel back and one scanline up,
+ * which is where nearly all the redundancy of a UI screen is, so there is
+ * no hashing or search window to keep.
+ */
 class PNGWriter {
 public:
 	~PNGWriter();
@@ -44,11 +49,28 @@ private:
 	static constexpr int width { 240 };
 	static constexpr int height { 320 };
 
+	static constexpr size_t scanline_bytes { 1 + width * sizeof(ui::ColorRGB888) };	// Filter type, then pixels
+	static constexpr size_t idat_size_max { 4096 };
+	// A scanline of nothing but 9 bit literals, plus the stream trailer
+	static constexpr size_t scanline_compressed_max { (scanline_bytes * 9 + 7) / 8 + 8 };
+
 	File file { };
 	int scanline_count { 0 };
-	CRC<32, true, true> crc { 0x04c11db7, 0xffffffff, 0xffffffff };
+	TableCRC<32, 0x04c11db7, true, true, 4> crc { 0xffffffff, 0xffffffff };
 	Adler32 adler_32 { };
 
+	std::array<uint8_t, scanline_bytes> previous_scanline { };
+	std::array<uint8_t, idat_size_max> idat { };
+	size_t idat_size { 0 };
+	uint32_t bit_buffer { 0 };
+	size_t bit_count { 0 };
+
+	void put_bits(const uint32_t value, const size_t count);
+	void put_code(const uint32_t code, const size_t length);
+	void put_literal(const uint8_t value);
+	void put_match(const size_t length, const size_t distance);
+	void flush_idat();
+
 	void write_chunk_header(const size_t length, const std::array<uint8_t, 4>& type);
 	void write_chunk_content(const void* const p, const size_t count);
 
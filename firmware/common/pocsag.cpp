@@ -48,32 +48,8 @@ std::string flag_str(PacketFlag packetflag) {
 	}
 }
 
-void insert_BCH(BCHCode& BCH_code, uint32_t * codeword) {
-	uint32_t parity = 0;
-	int data[21];
-	int bit;
-	int * bb;
-	size_t c;
-	
-	for (c = 0; c < 21; c++) {
-		bit = (((*codeword) << c) & 0x80000000U) ? 1 : 0;
-		if (bit) parity++;
-		data[c] = bit;
-	}
-	
-	bb = BCH_code.encode(data);
-	
-	// Make sure ECC bits are cleared
-	(*codeword) &= 0xFFFFF801;
-	
-	for (c = 0; c < 10; c++) {
-		bit = bb[c];
-		(*codeword) |= (bit << (10 - c));
-		if (bit) parity++;
-	}
-	
-	// Even parity
-	(*codeword) |= (parity & 1);
+void insert_BCH(uint32_t * codeword) {
+	*codeword = bch::encode(*codeword);
 }
 
 uint32_t get_digit_code(char code) {
@@ -102,7 +78,7 @@ uint32_t get_digit_code(char code) {
 	return code;
 }
 	
-void pocsag_encode(const MessageType type, BCHCode& BCH_code, const uint32_t function, const std::string message, const uint32_t address,
+void pocsag_encode(const MessageType type, const uint32_t function, const std::string message, const uint32_t address,
 	std::vector<uint32_t>& codewords) {
 	
 	size_t b, c, address_slot;
@@ -123,7 +99,7 @@ void pocsag_encode(const MessageType type, BCHCode& BCH_code, const uint32_t fun
 	// Function
 	codeword |= (function << 11);
 	
-	insert_BCH(BCH_code, &codeword);
+	insert_BCH(&codeword);
 	
 	// Address batch
 	codewords.push_back(POCSAG_SYNCWORD);
@@ -171,7 +147,7 @@ void pocsag_encode(const MessageType type, BCHCode& BCH_code, const uint32_t fun
 					
 					codeword &= 0x7FFFF800;		// Trim data
 					codeword |= 0x80000000;		// Message type
-					insert_BCH(BCH_code, &codeword);
+					insert_BCH(&codeword);
 					
 					codewords.push_back(codeword);
 					
@@ -202,7 +178,7 @@ void pocsag_encode(const MessageType type, BCHCode& BCH_code, const uint32_t fun
 					} while (bit_idx > 11);
 					
 					codeword |= 0x80000000;		// Message type
-					insert_BCH(BCH_code, &codeword);
+					insert_BCH(&codeword);
 					
 					codewords.push_back(codeword);
 					
@@ -219,70 +195,58 @@ void pocsag_encode(const MessageType type, BCHCode& BCH_code, const uint32_t fun
 	} while (char_idx < message_size);
 }
 
-void pocsag_decode_batch(const POCSAGPacket& batch, POCSAGState * const state) {
-	uint32_t codeword;
-	char ascii_char;
-	std::string output_text = "";
-	
-	state->out_type = EMPTY;
-	
-	// For each codeword...
-	for (size_t i = 0; i < 16; i++) {
-		codeword = batch[i];
+uint32_t MessageDecoder::feed(const uint32_t codeword, const size_t index) {
+	uint32_t events = EVENT_NONE;
+	
+	if (!(codeword & 0x80000000U)) {
+		// Address or idle codeword, either ends the open message
+		if (open) {
+			open = false;
+			events |= EVENT_END;
+		}
 		
-		if (!(codeword & 0x80000000U)) {
-			// Address codeword
-			if (state->mode == STATE_CLEAR) {
-				if (codeword != POCSAG_IDLEWORD) {
-					state->function = (codeword >> 11) & 3;
-					state->address = (codeword >> 10) & 0x1FFFF8U;	// 18 MSBs are transmitted
-					state->mode = STATE_HAVE_ADDRESS;
-					state->out_type = ADDRESS;
-					
-					state->ascii_idx = 0;
-					state->ascii_data = 0;
-				}
-			} else {
-				state->mode = STATE_CLEAR;				// New address = new message
-			}
-		} else {
-			// Message codeword
-			if (state->mode == STATE_HAVE_ADDRESS) {
-				// First message codeword: complete address
-				state->address |= (i >> 1);				// Add in the 3 LSBs (frame #)
-				state->mode = STATE_GETTING_MSG;
-			}
-			
-			state->out_type = MESSAGE;
-			
-			state->ascii_data |= ((codeword >> 11) & 0xFFFFF);	// Get 20 message bits
-			state->ascii_idx += 20;
+		if (codeword != POCSAG_IDLEWORD) {
+			function_ = (codeword >> 11) & 3;
+			// 18 MSBs are transmitted, the 3 LSBs are the frame number
+			address_ = ((codeword >> 10) & 0x1FFFF8U) | (index >> 1);
+			open = true;
+			bits = 0;
+			bit_count = 0;
+			events |= EVENT_ADDRESS;
+		}
+	} else if (open) {
+		bits = (bits << 20) | ((codeword >> 11) & 0xFFFFF);	// Get 20 message bits
+		bit_count += 20;
+		
+		// Raw 20 bits to 7 bit reversed ASCII
+		while (bit_count >= 7) {
+			bit_count -= 7;
+			uint8_t c = (bits >> bit_count) & 0x7F;
 			
-			// Raw 20 bits to 7 bit reversed ASCII
-			while (state->ascii_idx >= 7) {
-				state->ascii_idx -= 7;
-				ascii_char = ((state->ascii_data) >> (state->ascii_idx)) & 0x7F;
-				
-				// Bottom's up
-				ascii_char = (ascii_char & 0xF0) >> 4 | (ascii_char & 0x0F) << 4;	// 01234567 -> 45670123
-				ascii_char = (ascii_char & 0xCC) >> 2 | (ascii_char & 0x33) << 2;	// 45670123 -> 67452301
-				ascii_char = (ascii_char & 0xAA) >> 2 | (ascii_char & 0x55);		// 67452301 -> *7654321
-   
-				// Translate non-printable chars
-				if ((ascii_char < 32) || (ascii_char > 126))
-					output_text += "[" + to_string_dec_uint(ascii_char) + "]";
-				else
-					output_text += ascii_char;
-			}
+			// Bottom's up
+			c = (c & 0xF0) >> 4 | (c & 0x0F) << 4;	// 01234567 -> 45670123
+			c = (c & 0xCC) >> 2 | (c & 0x33) << 2;	// 45670123 -> 67452301
+			c = (c & 0xAA) >> 2 | (c & 0x55);		// 67452301 -> *7654321
 			
-			state->ascii_data <<= 20;		// Remaining bits are for next time...
+			text.in(c);
 		}
+		
+		events |= EVENT_TEXT;
 	}
 	
-	state->output = output_text;
-	
-	if (state->mode == STATE_HAVE_ADDRESS)
-		state->mode = STATE_CLEAR;
+	return events;
+}
+
+size_t MessageDecoder::read(char* const dst, const size_t count) {
+	return text.out(dst, count);
+}
+
+std::string char_str(const char c) {
+	// Translate non-printable chars
+	if ((c < 32) || (c > 126))
+		return "[" + to_string_dec_uint(c) + "]";
+	else
+		return std::string(1, c);
 }
 
 } /* namespace pocsag */
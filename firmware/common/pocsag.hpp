@@ -30,39 +30,74 @@
 #define POCSAG_AUDIO_RATE 24000
 #define POCSAG_BATCH_LENGTH (17 * 32)
 
+#include <vector>
+#include <array>
+#include <string>
+
+#include "fifo.hpp"
 #include "pocsag_packet.hpp"
 #include "bch_code.hpp"
 
 namespace pocsag {
 
-// Todo: these enums suck, make a better decode_batch
-
-enum Mode : uint32_t {
-	STATE_CLEAR,
-	STATE_HAVE_ADDRESS,
-	STATE_GETTING_MSG
-};
-
-enum OutputType : uint32_t {
-	EMPTY,
-	ADDRESS,
-	MESSAGE
-};
-
 enum MessageType : uint32_t {
 	ADDRESS_ONLY,
 	NUMERIC_ONLY,
 	ALPHANUMERIC
 };
 
-struct POCSAGState {
-	uint32_t function;
-	uint32_t address;
-	Mode mode = STATE_CLEAR;
-	OutputType out_type = EMPTY;
-	uint32_t ascii_data;
-	uint32_t ascii_idx;
-	std::string output;
+/* Decodes corrected codewords one at a time, in order, across batches.
+ * Message text is unpacked 7 bits at a time as its codewords arrive, into
+ * a fixed ring for the caller to drain, so long pages show up as they are
+ * received and nothing grows with their length.
+ */
+class MessageDecoder {
+public:
+	enum Event : uint32_t {
+		EVENT_NONE = 0,
+		EVENT_END = 1,			// The open message ended, on an idle or address codeword
+		EVENT_ADDRESS = 2,		// A message started, address() and function() are its
+		EVENT_TEXT = 4			// Characters are waiting for read()
+	};
+
+	MessageDecoder() = default;
+
+	MessageDecoder(const MessageDecoder&) = delete;
+	MessageDecoder(MessageDecoder&&) = delete;
+	MessageDecoder& operator=(const MessageDecoder&) = delete;
+	MessageDecoder& operator=(MessageDecoder&&) = delete;
+
+	/* index is the codeword's position in its batch, 0 to 15. Returns Event
+	 * flags; when a codeword gives END and ADDRESS, END is the old message's.
+	 */
+	uint32_t feed(const uint32_t codeword, const size_t index);
+
+	/* Raw 7 bit characters, oldest first. Returns how many were copied. */
+	size_t read(char* const dst, const size_t count);
+
+	bool active() const {
+		return open;
+	}
+
+	uint32_t address() const {
+		return address_;
+	}
+
+	uint32_t function() const {
+		return function_;
+	}
+
+private:
+	// Over the 45 characters of a batch, so draining once a batch is enough
+	static constexpr size_t text_k = 6;
+
+	std::array<char, 1U << text_k> text_data { };
+	FIFO<char> text { text_data.data(), text_k };
+	uint32_t address_ { 0 };
+	uint32_t function_ { 0 };
+	bool open { false };
+	uint32_t bits { 0 };
+	size_t bit_count { 0 };
 };
 
 const pocsag::BitRate pocsag_bitrates[3] = {
@@ -74,11 +109,11 @@ const pocsag::BitRate pocsag_bitrates[3] = {
 std::string bitrate_str(BitRate bitrate);
 std::string flag_str(PacketFlag packetflag);
 
-void insert_BCH(BCHCode& BCH_code, uint32_t * codeword);
+void insert_BCH(uint32_t * codeword);
 uint32_t get_digit_code(char code);
-void pocsag_encode(const MessageType type, BCHCode& BCH_code, const uint32_t function, const std::string message,
+void pocsag_encode(const MessageType type, const uint32_t function, const std::string message,
 					const uint32_t address, std::vector<uint32_t>& codewords);
-void pocsag_decode_batch(const POCSAGPacket& batch, POCSAGState * const state);
+std::string char_str(const char c);
 
 } /* namespace pocsag */
 
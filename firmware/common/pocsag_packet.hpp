@@ -25,6 +25,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <array>
 
 #include "baseband.hpp"
 
@@ -173,9 +173,20 @@ public:
 		}
 	}
 	
-	void lcd_write_pixels(const ui::Color* const pixels, size_t n) {
-		for(size_t i=0; i<n; i++) {
-			lcd_write_pixel(pixels[i]);
+	void lcd_write_pixels(const ui::Color* pixels, size_t n) {
+		/* Unrolled, the loop overhead is otherwise a good part of each
+		 * two-phase data write. The bus is bit-banged (data on GPIO3,
+		 * WRX on GPIO1), so there is no DMA alternative.
+		 */
+		for(size_t i=n>>2; i; i--) {
+			lcd_write_data(pixels[0].v);
+			lcd_write_data(pixels[1].v);
+			lcd_write_data(pixels[2].v);
+			lcd_write_data(pixels[3].v);
+			pixels += 4;
+		}
+		for(size_t i=n&3; i; i--) {
+			lcd_write_data((pixels++)->v);
 		}
 	}
 
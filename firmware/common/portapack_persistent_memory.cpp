@@ -91,6 +91,12 @@ struct data_t {
 	uint32_t pocsag_ignore_address;
 	
 	int32_t tone_mix;
+	
+	// SD cards
+	uint32_t sd_card_high_speed_ids[4];
+
+	// Boot
+	uint16_t boot_times[boot_times_count];
 };
 
 static_assert(sizeof(data_t) <= backup_ram.size(), "Persistent memory structure too large for VBAT-maintained region");
@@ -234,12 +240,26 @@ bool config_login() {
 	return (data->ui_config & 0x40000000UL) ? true : false;
 }
 
+bool config_binary_logs() {
+	return (data->ui_config & 0x10000000UL) ? true : false;
+}
+
+bool config_usb_remote() {
+	return (data->ui_config & 0x08000000UL) ? true : false;
+}
+
 uint32_t config_backlight_timer() {
 	const uint32_t timer_seconds[8] = { 0, 5, 15, 60, 300, 600, 600, 600 };
 
 	return timer_seconds[data->ui_config & 0x00000007UL];
 }
 
+uint32_t config_capture_segment() {
+	const uint32_t segment_seconds[8] = { 0, 60, 300, 900, 3600, 3600, 3600, 3600 };
+
+	return segment_seconds[(data->ui_config >> 3) & 7];
+}
+
 void set_config_splash(bool v) {
 	data->ui_config = (data->ui_config & ~0x80000000UL) | (v << 31);
 }
@@ -248,10 +268,22 @@ void set_config_login(bool v) {
 	data->ui_config = (data->ui_config & ~0x40000000UL) | (v << 30);
 }
 
+void set_config_binary_logs(bool v) {
+	data->ui_config = (data->ui_config & ~0x10000000UL) | (v << 28);
+}
+
+void set_config_usb_remote(bool v) {
+	data->ui_config = (data->ui_config & ~0x08000000UL) | (v << 27);
+}
+
 void set_config_backlight_timer(uint32_t i) {
 	data->ui_config = (data->ui_config & ~0x00000007UL) | (i & 7);
 }
 
+void set_config_capture_segment(uint32_t i) {
+	data->ui_config = (data->ui_config & ~0x00000038UL) | ((i & 7) << 3);
+}
+
 /*void set_config_textentry(uint8_t new_value) {
 	data->ui_config = (data->ui_config & ~0b100) | ((new_value & 1) << 2);
 }
@@ -264,6 +296,32 @@ uint8_t ui_config_textentry() {
 	data->ui_config = new_value;
 }*/
 
+bool sd_card_high_speed(const uint32_t card_id) {
+	const auto& ids = data->sd_card_high_speed_ids;
+	return std::find(std::begin(ids), std::end(ids), card_id) != std::end(ids);
+}
+
+void set_sd_card_high_speed(const uint32_t card_id, const bool v) {
+	auto& ids = data->sd_card_high_speed_ids;
+	auto end = std::remove(std::begin(ids), std::end(ids), card_id);
+	std::fill(end, std::end(ids), 0);
+	if( v ) {
+		// Oldest entry falls off the end.
+		std::copy_backward(std::begin(ids), std::end(ids) - 1, std::end(ids));
+		ids[0] = card_id;
+	}
+}
+
+uint32_t boot_time(const size_t index) {
+	return (index < boot_times_count) ? data->boot_times[index] : 0;
+}
+
+void set_boot_time(const size_t index, const uint32_t ms) {
+	if( index < boot_times_count ) {
+		data->boot_times[index] = (ms > 0xffff) ? 0xffff : ms;
+	}
+}
+
 uint32_t pocsag_last_address() {
 	return data->pocsag_last_address;
 }
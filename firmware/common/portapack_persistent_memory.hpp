@@ -24,6 +24,7 @@
 #define __PORTAPACK_PERSISTENT_MEMORY_H__
 
 #include <cstdint>
+#include <cstddef>
 
 #include "rf_path.hpp"
 #include "touch.hpp"
@@ -76,15 +77,31 @@ void set_stealth_mode(const bool v);
 
 bool config_splash();
 bool config_login();
+bool config_binary_logs();
+bool config_usb_remote();
 uint32_t config_backlight_timer();
+/* Seconds of capture per file when splitting them, 0 for one file. */
+uint32_t config_capture_segment();
 
 void set_config_splash(bool v);
 void set_config_login(bool v);
+void set_config_binary_logs(bool v);
+void set_config_usb_remote(bool v);
 void set_config_backlight_timer(uint32_t i);
+void set_config_capture_segment(uint32_t i);
 
 //uint8_t ui_config_textentry();
 //void set_config_textentry(uint8_t new_value);
 
+/* Cards (by sd_card::card_id()) qualified for high speed, most recent first. */
+bool sd_card_high_speed(const uint32_t card_id);
+void set_sd_card_high_speed(const uint32_t card_id, const bool v);
+
+/* Milliseconds from boot to each boot_timeline::Mark, kept across resets. */
+constexpr size_t boot_times_count = 8;
+uint32_t boot_time(const size_t index);
+void set_boot_time(const size_t index, const uint32_t ms);
+
 uint32_t pocsag_last_address();
 void set_pocsag_last_address(uint32_t address);
 
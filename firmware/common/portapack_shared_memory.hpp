@@ -27,6 +27,13 @@
 #include <cstddef>
 
 #include "message_queue.hpp"
+#include "thread_registry.hpp"
+#include "chibios_cpp.hpp"
+#include "shared_rings.hpp"
+
+namespace trace {
+struct Ring;
+}
 
 struct JammerChannel {
 	bool enabled;
@@ -40,30 +47,133 @@ struct ToneDef {
 	uint32_t duration;
 };
 	
+/* TonesProcessor's program. Symbols index tone_defs (pairs of them for
+ * dual tones), 32 and up are silence. They stream through a ring: the
+ * application writes from symbols_in and the baseband plays from
+ * symbols_out, both only grow. The baseband stops at symbols_end, which is
+ * symbols_open while the application has more to come; running dry before
+ * that keeps the carrier up, quiet, until it catches up. The Morse keyer
+ * reads the symbols as packed key bits instead.
+ */
 struct ToneData {
+	static constexpr size_t symbols_k = 8;
+	static constexpr uint32_t symbols_open = 0xffffffff;
+
 	ToneDef tone_defs[32];
 	uint32_t silence;
-	uint8_t message[256];
+	volatile uint32_t symbols_in;
+	volatile uint32_t symbols_out;
+	volatile uint32_t symbols_end;
+	uint8_t symbols[1 << symbols_k];
+};
+
+struct ProfilerStageStatistics {
+	char name[8];
+	uint32_t count;
+	uint32_t cycles_min;
+	uint32_t cycles_max;
+	uint64_t cycles_total;
+};
+
+/* Written by the baseband's ProfilerStages. The application bumps
+ * reset_sequence to ask for a fresh measurement window.
+ */
+struct ProfilerTable {
+	static constexpr size_t stages_max = 8;
+
+	uint32_t reset_sequence;
+	ProfilerStageStatistics stages[stages_max];
+};
+
+/* The baseband's free running sample count (buffer_t::sample_index), for
+ * the application's sample_clock. While the radio streams, DMA transfer
+ * sequence s starts at sample base + s * transfer_samples; sequence is
+ * the last one completed, written as it completes. generation is odd
+ * while the rest is rewritten, and sampling_rate 0 between streams.
+ */
+struct SampleClockState {
+	volatile uint32_t generation;
+	volatile uint32_t sequence;
+	uint64_t base;
+	uint32_t transfer_samples;
+	uint32_t sampling_rate;
+};
+
+/* Written by the baseband as it shuts down, so the last image's stack
+ * watermarks and CPU time stay readable after it's gone.
+ */
+struct ThreadTable {
+	static constexpr size_t threads_max = 8;
+
+	uint32_t count;
+	thread_registry::Statistics threads[threads_max];
+};
+
+struct RSSIBurst {
+	uint32_t start;		// RSSI samples since RSSIThread started
+	uint32_t length;	// RSSI samples
+	uint32_t peak;		// raw
+};
+
+/* Written by the baseband's RSSIThread at the full RSSI sampling rate,
+ * for what the RSSIStatistics messages average away. The application sets
+ * the first four fields whenever it likes, and bumps peak_sequence to
+ * restart the peak hold once it has read peak_hold. Counts only grow; an
+ * entry is complete once its count covers it.
+ */
+struct RSSITable {
+	static constexpr size_t history_k = 8;
+	static constexpr size_t bursts_max = 8;
+
+	volatile uint32_t statistics_interval_ms;	// between RSSIStatistics
+	volatile uint32_t history_decimation;		// samples per history entry, which is their max
+	volatile uint32_t burst_threshold;			// raw; zero disables burst detection
+	volatile uint32_t peak_sequence;
+
+	volatile uint32_t sampling_rate;
+	volatile uint32_t peak_hold;
+	volatile uint32_t history_count;
+	volatile uint32_t burst_count;
+	uint8_t history[1 << history_k];
+	RSSIBurst bursts[bursts_max];
 };
 
 /* NOTE: These structures must be located in the same location in both M4 and M0 binaries */
 struct SharedMemory {
 	static constexpr size_t application_queue_k = 11;
 	static constexpr size_t app_local_queue_k = 11;
+	static constexpr size_t baseband_queue_k = 10;
 
 	uint8_t application_queue_data[1 << application_queue_k] { 0 };
 	uint8_t app_local_queue_data[1 << app_local_queue_k] { 0 };
+	uint8_t baseband_queue_data[1 << baseband_queue_k] { 0 };
 	const Message* volatile baseband_message { nullptr };
-	MessageQueue application_queue { application_queue_data, application_queue_k };
-	MessageQueue app_local_queue { app_local_queue_data, app_local_queue_k };
+	// What the baseband couldn't queue for the application.
+	MessageDrops application_queue_drops { 0, { 0 } };
+	MessageQueue application_queue { application_queue_data, application_queue_k, true, &application_queue_drops };
+	MessageQueue app_local_queue { app_local_queue_data, app_local_queue_k, false };
+	// M0 -> M4, for messages that don't need to wait for the baseband
+	MessageQueue baseband_queue { baseband_queue_data, baseband_queue_k };
 
 	char m4_panic_msg[32] { 0 };
+
+	ProfilerTable profiler { 0, { } };
+
+	ThreadTable threads { 0, { } };
+	// Written by the baseband as processors start, stop and swap.
+	chibios::RAMLayout m4_ram_layout { 0, 0, 0, 0, 0, 0, 0 };
+	// The running image's trace::ring, in M4 RAM; null between images.
+	const trace::Ring* volatile m4_trace { nullptr };
+	RSSITable rssi { 100, 400, 0, 0, 0, 0, 0, 0, { 0 }, { } };
+	SampleClockState sample_clock { 0, 0, 0, 0, 0 };
+	// Written by the application only while the baseband isn't streaming.
+	shared_rings::Table rings { { } };
 	
 	union {
 		ToneData tones_data;
 		JammerChannel jammer_channels[24];
 		uint8_t data[512];
-	} bb_data { { { { 0, 0 } }, 0, { 0 } } };	// { } ?
+	} bb_data { { { { 0, 0 } }, 0, 0, 0, 0, { 0 } } };	// { } ?
 };
 
 extern SharedMemory& shared_memory;
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "reed_solomon.hpp"
+
+#include <utility>
+
+namespace reed_solomon {
+
+namespace {
+
+constexpr uint16_t field_polynomial = 0x11d;
+
+constexpr uint8_t alpha_power(const size_t n) {
+	uint16_t x = 1;
+	for(size_t i=0; i<(n % 255); i++) {
+		x <<= 1;
+		if( x & 0x100 ) {
+			x ^= field_polynomial;
+		}
+	}
+	return x;
+}
+
+constexpr uint8_t log_of(const size_t value) {
+	for(size_t n=0; n<255; n++) {
+		if( alpha_power(n) == value ) {
+			return n;
+		}
+	}
+	return 0;
+}
+
+template<size_t... I>
+constexpr std::array<uint8_t, sizeof...(I)> make_exp(std::index_sequence<I...>) {
+	return { { alpha_power(I)... } };
+}
+
+template<size_t... I>
+constexpr std::array<uint8_t, sizeof...(I)> make_log(std::index_sequence<I...>) {
+	return { { log_of(I)... } };
+}
+
+// Twice over, so products of two logs need no reduction.
+constexpr std::array<uint8_t, 510> exp_table = make_exp(std::make_index_sequence<510>());
+constexpr std::array<uint8_t, 256> log_table = make_log(std::make_index_sequence<256>());
+
+uint8_t mul(const uint8_t a, const uint8_t b) {
+	return (a && b) ? exp_table[log_table[a] + log_table[b]] : 0;
+}
+
+uint8_t div(const uint8_t a, const uint8_t b) {
+	return a ? exp_table[log_table[a] + 255 - log_table[b]] : 0;
+}
+
+/* p(alpha^n) */
+uint8_t evaluate(const uint8_t* const p, const size_t degree, const size_t n) {
+	uint8_t sum = 0;
+	const size_t l = n % 255;
+	for(size_t k=degree + 1; k>0; k--) {
+		sum = mul(sum, exp_table[l]) ^ p[k - 1];
+	}
+	return sum;
+}
+
+} /* namespace */
+
+int decode(codeword_t& codeword, const size_t parity_count, const size_t used_length) {
+	if( (parity_count == 0) || (parity_count > parity_max) ) {
+		return -1;
+	}
+
+	std::array<uint8_t, parity_max> syndromes { };
+	bool clean = true;
+	for(size_t j=0; j<parity_count; j++) {
+		syndromes[j] = evaluate(codeword.data(), codeword_length - 1, j);
+		clean = clean && (syndromes[j] == 0);
+	}
+	if( clean ) {
+		return 0;
+	}
+
+	// Berlekamp-Massey for the error locator.
+	std::array<uint8_t, parity_max + 1> locator { };
+	std::array<uint8_t, parity_max + 1> previous { };
+	locator[0] = 1;
+	previous[0] = 1;
+	size_t errors = 0;
+	size_t shift = 1;
+	uint8_t previous_discrepancy = 1;
+	for(size_t r=0; r<parity_count; r++) {
+		uint8_t discrepancy = syndromes[r];
+		for(size_t i=1; i<=errors; i++) {
+			discrepancy ^= mul(locator[i], syndromes[r - i]);
+		}
+
+		if( discrepancy == 0 ) {
+			shift++;
+			continue;
+		}
+
+		const auto scale = div(discrepancy, previous_discrepancy);
+		auto updated = locator;
+		for(size_t i=0; (i + shift)<=parity_count; i++) {
+			updated[i + shift] ^= mul(scale, previous[i]);
+		}
+
+		if( 2 * errors <= r ) {
+			previous = locator;
+			previous_discrepancy = discrepancy;
+			errors = r + 1 - errors;
+			shift = 1;
+		} else {
+			shift++;
+		}
+		locator = updated;
+	}
+
+	if( 2 * errors > parity_count ) {
+		return -1;
+	}
+
+	// Error evaluator, syndromes x locator mod x^parity_count.
+	std::array<uint8_t, parity_max> evaluator { };
+	for(size_t i=0; i<parity_count; i++) {
+		for(size_t k=0; (k<=i) && (k<=errors); k++) {
+			evaluator[i] ^= mul(locator[k], syndromes[i - k]);
+		}
+	}
+
+	// Chien search for the roots alpha^-i, then Forney for the values.
+	std::array<uint8_t, parity_max / 2> positions { };
+	std::array<uint8_t, parity_max / 2> values { };
+	size_t found = 0;
+	for(size_t i=0; i<codeword_length; i++) {
+		const size_t inverse = (255 - i) % 255;
+		if( evaluate(locator.data(), errors, inverse) != 0 ) {
+			continue;
+		}
+		if( (found == errors) || (i >= used_length) ) {
+			return -1;
+		}
+
+		uint8_t derivative = 0;
+		for(size_t k=1; k<=errors; k+=2) {
+			derivative ^= mul(locator[k], exp_table[(inverse * (k - 1)) % 255]);
+		}
+		if( derivative == 0 ) {
+			return -1;
+		}
+
+		const auto omega = evaluate(evaluator.data(), parity_count - 1, inverse);
+		positions[found] = i;
+		values[found] = mul(exp_table[i], div(omega, derivative));
+		found++;
+	}
+
+	if( found != errors ) {
+		return -1;
+	}
+
+	for(size_t n=0; n<found; n++) {
+		codeword[positions[n]] ^= values[n];
+	}
+	return found;
+}
+
+} /* namespace reed_solomon */
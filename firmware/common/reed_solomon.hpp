@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __REED_SOLOMON_H__
+#define __REED_SOLOMON_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Reed-Solomon decoding over GF(2^8), field polynomial x^8+x^4+x^3+x^2+1
+ * (0x11d), generator roots alpha^0 to alpha^(parity-1). Codewords are laid out
+ * as Vaisala RS41 frames use them: coefficient of x^i at index i, parity
+ * in the lowest parity_count positions, shortened codes zero-padded up to
+ * codeword_length.
+ */
+
+namespace reed_solomon {
+
+constexpr size_t codeword_length = 255;
+constexpr size_t parity_max = 24;
+
+using codeword_t = std::array<uint8_t, codeword_length>;
+
+/* Corrects up to parity_count / 2 byte errors in place. Returns the number
+ * corrected, or -1 when there are too many (the codeword is left as is).
+ * Errors found past used_length, in the zero padding of a shortened code,
+ * also fail the decode.
+ */
+int decode(codeword_t& codeword, const size_t parity_count, const size_t used_length = codeword_length);
+
+} /* namespace reed_solomon */
+
+#endif/*__REED_SOLOMON_H__*/
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2013 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __SHARED_RINGS_H__
+#define __SHARED_RINGS_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#include "fifo.hpp"
+
+/* FIFOs the application makes for the running image, outside the fixed
+ * SharedMemory layout: baseband::allocate_ring() carves them out of the
+ * application's heap, in AHB RAM, and lists them here. A processor looks
+ * its ring up when it starts streaming and falls back to its own, smaller
+ * one if the application made none. Rings live until baseband::shutdown().
+ */
+namespace shared_rings {
+
+enum class ID : uint8_t {
+	Spectrum = 0,	// ChannelSpectrum frames, M4 -> M0
+	Packets = 1,	// M4 -> M0
+	TXBits = 2,		// M0 -> M4
+	Telemetry = 3,	// M4 -> M0
+};
+
+constexpr size_t id_count = 4;
+
+struct Table {
+	struct Entry {
+		void* fifo;
+		uint16_t element_size;
+		uint8_t k;
+	};
+
+	std::array<Entry, id_count> entries;
+
+	/* nullptr if there is no such ring, or it holds something else. */
+	template<typename T>
+	FIFO<T>* find(const ID id) const {
+		const auto& entry = entries[static_cast<size_t>(id)];
+		if( (entry.fifo == nullptr) || (entry.element_size != sizeof(T)) ) {
+			return nullptr;
+		}
+		return static_cast<FIFO<T>*>(entry.fifo);
+	}
+};
+
+} /* namespace shared_rings */
+
+#endif/*__SHARED_RINGS_H__*/
@@ -109,6 +109,63 @@ static inline int32_t smlad(const vec2_s16 v1, const vec2_s16 v2, const int32_t
 	return __SMLAD(v1.w, v2.w, accum);
 }
 
+static inline int64_t smlald(const vec2_s16 v1, const vec2_s16 v2, const int64_t accum) {
+	return __SMLALD(v1.w, v2.w, accum);
+}
+
+static inline int64_t smlsld(const vec2_s16 v1, const vec2_s16 v2, const int64_t accum) {
+	return __SMLSLD(v1.w, v2.w, accum);
+}
+
+static inline int64_t smlaldx(const vec2_s16 v1, const vec2_s16 v2, const int64_t accum) {
+	return __SMLALDX(v1.w, v2.w, accum);
+}
+
+static inline int64_t smlsldx(const vec2_s16 v1, const vec2_s16 v2, const int64_t accum) {
+	return __SMLSLDX(v1.w, v2.w, accum);
+}
+
+static inline int32_t smusd(const vec2_s16 v1, const vec2_s16 v2) {
+	return __SMUSD(v1.w, v2.w);
+}
+
+static inline int32_t smuadx(const vec2_s16 v1, const vec2_s16 v2) {
+	return __SMUADX(v1.w, v2.w);
+}
+
+static inline vec2_s16 shadd16(const vec2_s16 v1, const vec2_s16 v2) {
+	vec2_s16 result;
+	result.w = __SHADD16(v1.w, v2.w);
+	return result;
+}
+
+static inline vec2_s16 shsub16(const vec2_s16 v1, const vec2_s16 v2) {
+	vec2_s16 result;
+	result.w = __SHSUB16(v1.w, v2.w);
+	return result;
+}
+
+static inline vec2_s16 shasx(const vec2_s16 v1, const vec2_s16 v2) {
+	vec2_s16 result;
+	result.w = __SHASX(v1.w, v2.w);
+	return result;
+}
+
+static inline vec2_s16 shsax(const vec2_s16 v1, const vec2_s16 v2) {
+	vec2_s16 result;
+	result.w = __SHSAX(v1.w, v2.w);
+	return result;
+}
+
+/* Q15 complex multiply, real part in the low halfword. */
+static inline vec2_s16 multiply_q15(const vec2_s16 x, const vec2_s16 w) {
+	const int32_t re = smusd(x, w);
+	const int32_t im = smuadx(x, w);
+	vec2_s16 result;
+	result.w = __PKHBT(re >> 15, im, 1);
+	return result;
+}
+
 #endif /* defined(LPC43XX_M4) */
 
 #endif/*__SIMD_H__*/
@@ -23,9 +23,11 @@
 #ifndef __SINE_TABLE_I8_H__
 #define __SINE_TABLE_I8_H__
 
+#include "utility.hpp"
+
 #include <cmath>
 
-static const int8_t sine_table_i8[256] = {
+LOCATE_IN_DATA_RAM static const int8_t sine_table_i8[256] = {
 	0, 2, 5, 8, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45,
 	48, 51, 54, 57, 59, 62, 65, 67, 70, 73, 75, 78, 80, 83, 85, 87,
 	90, 92, 94, 96, 98, 100, 102, 104, 105, 107, 109, 110, 112, 113, 115, 116,
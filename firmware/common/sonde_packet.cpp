@@ -23,15 +23,22 @@
 #include "sonde_packet.hpp"
 #include "string_format.hpp"
 
+#include "crc.hpp"
+
+#include <cmath>
+
 namespace sonde {
 
 Packet::Packet(
 	const baseband::Packet& packet,
-	const Type type
+	const Type type,
+	const int fec_corrected
 ) : packet_ { packet },
 	decoder_ { packet_ },
 	reader_bi_m { decoder_ },
-	type_ { type }
+	reader_raw { packet_ },
+	type_ { type },
+	fec_corrected_ { fec_corrected }
 {
 	if (type_ == Type::Meteomodem_unknown) {
 		// Right now we're just sure that the sync is from a Meteomodem sonde, differentiate between models now
@@ -60,19 +67,81 @@ Packet::Type Packet::type() const {
 	return type_;
 }
 
-/*uint8_t Packet::vaisala_descramble(const uint32_t pos) {
-	return reader_raw.read(pos * 8, 8) ^ vaisala_mask[pos & 63];
-};*/
+uint32_t Packet::rs41_byte(const size_t position) const {
+	return reader_raw.read(position * 8, 8);
+}
+
+uint32_t Packet::rs41_u32(const size_t position) const {
+	return rs41_byte(position) | (rs41_byte(position + 1) << 8) | (rs41_byte(position + 2) << 16) | (rs41_byte(position + 3) << 24);
+}
+
+bool Packet::rs41_block_ok(const size_t position, const uint8_t id, const uint8_t length) const {
+	if( (rs41_byte(position) != id) || (rs41_byte(position + 1) != length) ) {
+		return false;
+	}
+
+	TableCRC<16, 0x1021> crc { 0xffff };
+	for(size_t i=0; i<length; i++) {
+		crc.process_byte(rs41_byte(position + 2 + i));
+	}
+	const size_t end = position + 2 + length;
+	return crc.checksum() == (rs41_byte(end) | (rs41_byte(end + 1) << 8));
+}
+
+void Packet::rs41_position(double& latitude, double& longitude, double& altitude) const {
+	// ECEF in cm to WGS84, after Bowring.
+	const size_t ecef = rs41::gps_position + 2;
+	const double x = static_cast<int32_t>(rs41_u32(ecef + 0)) / 100.0;
+	const double y = static_cast<int32_t>(rs41_u32(ecef + 4)) / 100.0;
+	const double z = static_cast<int32_t>(rs41_u32(ecef + 8)) / 100.0;
+
+	constexpr double a = 6378137.0;
+	constexpr double b = 6356752.31424518;
+	constexpr double e2 = (a * a - b * b) / (a * a);
+	constexpr double ep2 = (a * a - b * b) / (b * b);
+
+	const double p = std::sqrt(x * x + y * y);
+	const double theta = std::atan2(z * a, p * b);
+	const double st = std::sin(theta);
+	const double ct = std::cos(theta);
+	const double lat = std::atan2(z + ep2 * b * st * st * st, p - e2 * a * ct * ct * ct);
+	const double sl = std::sin(lat);
+
+	latitude = lat * 180.0 / M_PI;
+	longitude = std::atan2(y, x) * 180.0 / M_PI;
+	altitude = p / std::cos(lat) - a / std::sqrt(1.0 - e2 * sl * sl);
+}
+
+bool Packet::status_valid() const {
+	switch(type_) {
+	case Type::Meteomodem_M10:
+	case Type::Meteomodem_M2K2:	return true;
+	case Type::Vaisala_RS41_SG:	return rs41_block_ok(rs41::status_position, rs41::status_id, rs41::status_length);
+	default:					return false;
+	}
+}
+
+bool Packet::GPS_valid() const {
+	switch(type_) {
+	case Type::Meteomodem_M10:
+	case Type::Meteomodem_M2K2:	return true;
+	// Without satellites, the position is all zeros.
+	case Type::Vaisala_RS41_SG:	return rs41_block_ok(rs41::gps_position, rs41::gps_id, rs41::gps_length) && (rs41_byte(0x126) != 0);
+	default:					return false;
+	}
+}
+
+int Packet::fec_corrected() const {
+	return fec_corrected_;
+}
 
 uint32_t Packet::GPS_altitude() const {
 	if ((type_ == Type::Meteomodem_M10) || (type_ == Type::Meteomodem_M2K2))
 		return (reader_bi_m.read(22 * 8, 32) / 1000) - 48;
 	else if (type_ == Type::Vaisala_RS41_SG) {
-		/*uint32_t altitude_ecef = 0;
-		for (uint32_t i = 0; i < 4; i++)
-			altitude_ecef = (altitude_ecef << 8) + vaisala_descramble(0x11C + i);*/
-		// TODO: and a bunch of maths (see ecef2elli() from RS1729)
-		return 0;
+		double latitude, longitude, altitude;
+		rs41_position(latitude, longitude, altitude);
+		return (altitude > 0.0) ? static_cast<uint32_t>(altitude) : 0;
 	} else
 		return 0;	// Unknown
 }
@@ -80,16 +149,22 @@ uint32_t Packet::GPS_altitude() const {
 float Packet::GPS_latitude() const {
 	if ((type_ == Type::Meteomodem_M10) || (type_ == Type::Meteomodem_M2K2))
 		return reader_bi_m.read(14 * 8, 32) / ((1ULL << 32) / 360.0);
-	//else if (type_ == Type::Vaisala_RS41_SG)
-	//	return vaisala_descramble();
-	else
+	else if (type_ == Type::Vaisala_RS41_SG) {
+		double latitude, longitude, altitude;
+		rs41_position(latitude, longitude, altitude);
+		return latitude;
+	} else
 		return 0;	// Unknown
 }
 
 float Packet::GPS_longitude() const {
 	if ((type_ == Type::Meteomodem_M10) || (type_ == Type::Meteomodem_M2K2))
 		return reader_bi_m.read(18 * 8, 32) / ((1ULL << 32) / 360.0);
-	else
+	else if (type_ == Type::Vaisala_RS41_SG) {
+		double latitude, longitude, altitude;
+		rs41_position(latitude, longitude, altitude);
+		return longitude;
+	} else
 		return 0;	// Unknown
 }
 
@@ -98,6 +173,8 @@ uint32_t Packet::battery_voltage() const {
 		return (reader_bi_m.read(69 * 8, 8) + (reader_bi_m.read(70 * 8, 8) << 8)) * 1000 / 150;
 	else if (type_ == Type::Meteomodem_M2K2)
 		return reader_bi_m.read(69 * 8, 8) * 66;	// Actually 65.8
+	else if (type_ == Type::Vaisala_RS41_SG)
+		return rs41_byte(0x045) * 100;	// 0.1V steps
 	else
 		return 0;	// Unknown
 }
@@ -127,6 +204,11 @@ std::string Packet::serial_number() const {
 			to_string_dec_uint(reader_bi_m.read(93 * 8 + 24, 3), 1) +
 			to_string_dec_uint(reader_bi_m.read(93 * 8 + 27, 13), 4, '0');
 	
+	} else if (type() == Type::Vaisala_RS41_SG) {
+		std::string serial;
+		for (size_t i = 0; i < 8; i++)
+			serial += static_cast<char>(rs41_byte(0x03d + i));
+		return serial;
 	} else
 		return "?";
 }
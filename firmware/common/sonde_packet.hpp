@@ -25,6 +25,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <array>
 
 #include "field_reader.hpp"
 #include "baseband_packet.hpp"
@@ -32,6 +33,43 @@
 
 namespace sonde {
 
+/* Vaisala RS41 standard frame layout. The M4 descrambles the frame and
+ * applies the Reed-Solomon correction, so the M0 sees plain bytes.
+ */
+namespace rs41 {
+
+constexpr size_t frame_length = 320;
+
+constexpr std::array<uint8_t, 8> header { { 0x86, 0x35, 0xf4, 0x40, 0x93, 0xdf, 0x1a, 0x60 } };
+
+constexpr std::array<uint8_t, 64> mask { {
+	0x96, 0x83, 0x3E, 0x51, 0xB1, 0x49, 0x08, 0x98, 
+	0x32, 0x05, 0x59, 0x0E, 0xF9, 0x44, 0xC6, 0x26,
+	0x21, 0x60, 0xC2, 0xEA, 0x79, 0x5D, 0x6D, 0xA1,
+	0x54, 0x69, 0x47, 0x0C, 0xDC, 0xE8, 0x5C, 0xF1,
+	0xF7, 0x76, 0x82, 0x7F, 0x07, 0x99, 0xA2, 0x2C,
+	0x93, 0x7C, 0x30, 0x63, 0xF5, 0x10, 0x2E, 0x61,
+	0xD0, 0xBC, 0xB4, 0xB6, 0x06, 0xAA, 0xF4, 0x23,
+	0x78, 0x6E, 0x3B, 0xAE, 0xBF, 0x7B, 0x4C, 0xC1
+} };
+
+// Two interleaved RS(255,231) codewords: parity for each in a row, then the
+// message bytes alternating between them.
+constexpr size_t parity_position = 0x008;
+constexpr size_t parity_length = 24;
+constexpr size_t message_position = 0x038;
+constexpr size_t message_length = (frame_length - message_position) / 2;
+
+// Blocks: ID, length, data, little-endian CRC-16/CCITT of the data.
+constexpr size_t status_position = 0x039;
+constexpr uint8_t status_id = 0x79;
+constexpr uint8_t status_length = 0x28;
+constexpr size_t gps_position = 0x112;
+constexpr uint8_t gps_id = 0x7b;
+constexpr uint8_t gps_length = 0x15;
+
+} /* namespace rs41 */
+
 class Packet {
 public:
 	enum class Type : uint32_t {
@@ -42,7 +80,7 @@ public:
 		Vaisala_RS41_SG = 4,
 	};
 	
-	Packet(const baseband::Packet& packet, const Type type);
+	Packet(const baseband::Packet& packet, const Type type, const int fec_corrected = 0);
 
 	size_t length() const;
 	
@@ -64,26 +102,30 @@ public:
 
 	bool crc_ok() const;
 
-private:
-	static constexpr uint8_t vaisala_mask[64] = { 
-		0x96, 0x83, 0x3E, 0x51, 0xB1, 0x49, 0x08, 0x98, 
-		0x32, 0x05, 0x59, 0x0E, 0xF9, 0x44, 0xC6, 0x26,
-		0x21, 0x60, 0xC2, 0xEA, 0x79, 0x5D, 0x6D, 0xA1,
-		0x54, 0x69, 0x47, 0x0C, 0xDC, 0xE8, 0x5C, 0xF1,
-		0xF7, 0x76, 0x82, 0x7F, 0x07, 0x99, 0xA2, 0x2C,
-		0x93, 0x7C, 0x30, 0x63, 0xF5, 0x10, 0x2E, 0x61,
-		0xD0, 0xBC, 0xB4, 0xB6, 0x06, 0xAA, 0xF4, 0x23,
-		0x78, 0x6E, 0x3B, 0xAE, 0xBF, 0x7B, 0x4C, 0xC1
-	};
-	
-	//uint8_t vaisala_descramble(const uint32_t pos);
+	/* Whether this frame's status (serial, battery) and position fields
+	 * can be used. A frame with a damaged block still updates the others,
+	 * the previous values standing in for the damaged one.
+	 */
+	bool status_valid() const;
+	bool GPS_valid() const;
 
+	/* RS41 bytes corrected by the M4, -1 if there were too many. */
+	int fec_corrected() const;
+
+private:
 	const baseband::Packet packet_;
 	const BiphaseMDecoder decoder_;
 	const FieldReader<BiphaseMDecoder, BitRemapNone> reader_bi_m;
+	const FieldReader<baseband::Packet, BitRemapNone> reader_raw;
 	Type type_;
+	const int fec_corrected_;
 
 	bool crc_ok_M10() const;
+
+	uint32_t rs41_byte(const size_t position) const;
+	uint32_t rs41_u32(const size_t position) const;
+	bool rs41_block_ok(const size_t position, const uint8_t id, const uint8_t length) const;
+	void rs41_position(double& latitude, double& longitude, double& altitude) const;
 };
 
 } /* namespace sonde */
@@ -59,6 +59,16 @@ struct image_tag_t {
 		return (c[0] != 0) || (c[1] != 0) || (c[2] != 0) || (c[3] != 0);
 	}
 
+	// Byte-wise, the order make_spi_image.py sorts the image directory in.
+	bool operator<(const image_tag_t& other) const {
+		for(size_t i=0; i<4; i++) {
+			if( c[i] != other.c[i] ) {
+				return static_cast<uint8_t>(c[i]) < static_cast<uint8_t>(other.c[i]);
+			}
+		}
+		return false;
+	}
+
 private:
 	char c[4];
 };
@@ -71,12 +81,14 @@ constexpr image_tag_t image_tag_am_audio			{ 'P', 'A', 'M', 'A' };
 constexpr image_tag_t image_tag_capture				{ 'P', 'C', 'A', 'P' };
 constexpr image_tag_t image_tag_ert					{ 'P', 'E', 'R', 'T' };
 constexpr image_tag_t image_tag_nfm_audio			{ 'P', 'N', 'F', 'M' };
+constexpr image_tag_t image_tag_narrowband_audio	{ 'P', 'N', 'B', 'A' };
 constexpr image_tag_t image_tag_pocsag				{ 'P', 'P', 'O', 'C' };
 constexpr image_tag_t image_tag_sonde				{ 'P', 'S', 'O', 'N' };
 constexpr image_tag_t image_tag_tpms				{ 'P', 'T', 'P', 'M' };
 constexpr image_tag_t image_tag_wfm_audio			{ 'P', 'W', 'F', 'M' };
 constexpr image_tag_t image_tag_wideband_spectrum	{ 'P', 'S', 'P', 'E' };
 constexpr image_tag_t image_tag_test				{ 'P', 'T', 'S', 'T' };
+constexpr image_tag_t image_tag_benchmark			{ 'P', 'B', 'E', 'N' };
 
 constexpr image_tag_t image_tag_adsb_tx				{ 'P', 'A', 'D', 'T' };
 constexpr image_tag_t image_tag_afsk				{ 'P', 'A', 'F', 'T' };
@@ -95,16 +107,46 @@ constexpr image_tag_t image_tag_noop				{ 'P', 'N', 'O', 'P' };
 
 constexpr image_tag_t image_tag_hackrf				{ 'H', 'R', 'F', '1' };
 
+constexpr image_tag_t image_tag_directory			{ 'P', 'D', 'I', 'R' };
+
 struct chunk_t {
+	/* Set in length for a compressed chunk, whose data is the uncompressed
+	 * length (uint32_t) followed by an LZ4 block, padded to four bytes.
+	 */
+	static constexpr uint32_t length_compressed = 0x80000000U;
+
 	const image_tag_t tag;
 	const uint32_t length;
 	const uint8_t data[];
 
+	bool compressed() const {
+		return length & length_compressed;
+	}
+
+	// Bytes of data in flash.
+	size_t data_length() const {
+		return length & ~length_compressed;
+	}
+
+	// Bytes of data once loaded.
+	size_t image_length() const {
+		return compressed() ? *reinterpret_cast<const uint32_t*>(&data[0]) : length;
+	}
+
 	const chunk_t* next() const {
-		return reinterpret_cast<const chunk_t*>(&data[length]);
+		return reinterpret_cast<const chunk_t*>(&data[data_length()]);
 	}
 };
 
+/* Data of the optional first chunk (image_tag_directory), sorted by tag.
+ * Offsets are from the start of the images region.
+ */
+struct directory_entry_t {
+	const image_tag_t tag;
+	const uint32_t offset;
+	const uint32_t length;
+};
+
 struct region_t {
 	const size_t offset;
 	const size_t size;
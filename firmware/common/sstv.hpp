@@ -30,6 +30,8 @@ namespace sstv {
 
 #define SSTV_F2D(f) (uint32_t)((f) * SSTV_DELTA_COEF)
 #define SSTV_MS2S(d) (uint32_t)((d) / 1000.0 * (float)SSTV_SAMPLERATE)
+// Fractional, in 1/65536 samples, so pixels don't drift along a line
+#define SSTV_MS2S_Q16(d) (uint32_t)((d) / 1000.0 * SSTV_SAMPLERATE * 65536.0)
 
 #define SSTV_VIS_SS SSTV_F2D(1200)
 #define SSTV_VIS_ZERO SSTV_F2D(1300)
@@ -69,7 +71,7 @@ struct sstv_mode {
 	sstv_color_seq color_sequence;
 	uint16_t pixels;
 	uint16_t lines;
-	uint32_t samples_per_pixel;
+	uint32_t samples_per_pixel_q16;
 	bool sync_on_first;
 	uint8_t sync_index;
 	bool gaps;
@@ -79,12 +81,12 @@ struct sstv_mode {
 };
 
 constexpr sstv_mode sstv_modes[SSTV_MODES_NB] = {
-	{ "Scottie 1", 	sstv_parity(60),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S(0.4320),	true, 2, true, SSTV_MS2S(9), SSTV_MS2S(1.5) },
-	{ "Scottie 2", 	sstv_parity(56),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S(0.2752),	true, 2, true, SSTV_MS2S(9), SSTV_MS2S(1.5) },
-	{ "Scottie DX",	sstv_parity(76),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S(1.08), 	true, 2, true, SSTV_MS2S(9), SSTV_MS2S(1.5) },
-	{ "Martin 1",	sstv_parity(44),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S(0.4576),	false, 0, true, SSTV_MS2S(4.862), SSTV_MS2S(0.572) },
-	{ "Martin 2",	sstv_parity(40),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S(0.2288),	false, 0, true, SSTV_MS2S(4.862), SSTV_MS2S(0.572) },
-	{ "SC2-180",	sstv_parity(55),	true, SSTV_COLOR_RGB, 320, 256, SSTV_MS2S(0.7344), 	false, 0, false, SSTV_MS2S(5.5225), SSTV_MS2S(0.5) },
+	{ "Scottie 1", 	sstv_parity(60),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S_Q16(0.4320),	true, 2, true, SSTV_MS2S(9), SSTV_MS2S(1.5) },
+	{ "Scottie 2", 	sstv_parity(56),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S_Q16(0.2752),	true, 2, true, SSTV_MS2S(9), SSTV_MS2S(1.5) },
+	{ "Scottie DX",	sstv_parity(76),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S_Q16(1.08), 	true, 2, true, SSTV_MS2S(9), SSTV_MS2S(1.5) },
+	{ "Martin 1",	sstv_parity(44),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S_Q16(0.4576),	false, 0, true, SSTV_MS2S(4.862), SSTV_MS2S(0.572) },
+	{ "Martin 2",	sstv_parity(40),	true, SSTV_COLOR_GBR, 320, 256, SSTV_MS2S_Q16(0.2288),	false, 0, true, SSTV_MS2S(4.862), SSTV_MS2S(0.572) },
+	{ "SC2-180",	sstv_parity(55),	true, SSTV_COLOR_RGB, 320, 256, SSTV_MS2S_Q16(0.7344), 	false, 0, false, SSTV_MS2S(5.5225), SSTV_MS2S(0.5) },
 	//{ "PASOKON 3",	sstv_parity(113),	true, SSTV_COLOR_RGB, 640, 496, SSTV_MS2S(0.2083), 	{ 1500, 2300 } },
 	//{ "PASOKON 7",	sstv_parity(115),	true, SSTV_COLOR_RGB, 640, 496, SSTV_MS2S(0.4167), 	{ 1500, 2300 } }
 };
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "thread_registry.hpp"
+
+#include "ch.h"
+
+#include <cstring>
+
+extern uint8_t __main_stack_base__[];
+extern uint8_t __main_stack_end__[];
+extern uint8_t __process_stack_base__[];
+extern uint8_t __process_stack_end__[];
+
+namespace thread_registry {
+
+namespace {
+
+/* Stacks grow down, so what was never touched is at the bottom. */
+size_t stack_peak(const uint8_t* const base, const uint8_t* const top) {
+	const uint8_t* p = base;
+	while( (p < top) && (*p == CH_STACK_FILL_VALUE) ) {
+		p++;
+	}
+	return top - p;
+}
+
+void fill(Statistics& entry, const char* const name, const uint8_t* const base, const uint8_t* const top) {
+	strncpy(entry.name, name ? name : "?", sizeof(entry.name) - 1);
+	entry.name[sizeof(entry.name) - 1] = 0;
+	entry.stack_size = top - base;
+	entry.stack_peak = stack_peak(base, top);
+}
+
+} /* namespace */
+
+size_t capture(Statistics* const table, const size_t count_max) {
+	size_t count = 0;
+
+	if( count < count_max ) {
+		auto& entry = table[count++];
+		entry = { };
+		fill(entry, "irq", __main_stack_base__, __main_stack_end__);
+	}
+
+	// Walk the whole registry even when the table is full, the iterator
+	// holds a reference to the thread it stops at.
+	for(auto tp = chRegFirstThread(); tp; tp = chRegNextThread(tp)) {
+		if( count == count_max ) {
+			continue;
+		}
+
+		auto& entry = table[count++];
+		entry = { };
+		entry.id = reinterpret_cast<uintptr_t>(tp);
+		entry.ticks = tp->total_ticks;
+
+		const auto base = reinterpret_cast<const uint8_t*>(tp + 1);
+		if( tp->stack_top > base ) {
+			fill(entry, chRegGetThreadName(tp), base, tp->stack_top);
+			if( (tp->p_flags & THD_MEM_MODE_MASK) == THD_MEM_MODE_HEAP ) {
+				entry.heap = tp->stack_top - reinterpret_cast<const uint8_t*>(tp);
+			}
+		} else {
+			// main() runs on the process stack, outside its Thread.
+			fill(entry, chRegGetThreadName(tp), __process_stack_base__, __process_stack_end__);
+		}
+	}
+
+	return count;
+}
+
+} /* namespace thread_registry */
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __THREAD_REGISTRY_H__
+#define __THREAD_REGISTRY_H__
+
+#include <cstdint>
+#include <cstddef>
+
+/* Per thread stack watermarks and CPU time, from the ChibiOS registry.
+ *
+ * Stacks are painted with CH_STACK_FILL_VALUE as threads are created (and by
+ * crt0 for the main and interrupt stacks), so the peak is whatever the
+ * thread has overwritten since. ticks is the thread's running total of
+ * THREAD_CONTEXT_SWITCH_HOOK timer ticks, free-running and wrapping. heap is
+ * the working area's size for threads created from the heap.
+ */
+
+namespace thread_registry {
+
+struct Statistics {
+	char name[8];
+	uint32_t id;
+	uint32_t stack_size;
+	uint32_t stack_peak;
+	uint32_t ticks;
+	uint32_t heap;
+};
+
+/* Fills up to count_max entries, the interrupt stack ("irq") first, and
+ * returns how many were filled.
+ */
+size_t capture(Statistics* const table, const size_t count_max);
+
+} /* namespace thread_registry */
+
+#endif/*__THREAD_REGISTRY_H__*/
@@ -146,6 +146,7 @@ public:
 
 	SignalType signal_type() const { return signal_type_; }
 	Timestamp received_at() const;
+	const baseband::Packet& raw() const { return packet_; }
 
 	FormattedSymbols symbols_formatted() const;
 
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <cstdint>
+#include <cstddef>
+
+#include "hal.h"
+
+/* A short binary timeline per core, for what a stall looks like from both
+ * sides: a dropped frame, a capture overrun, a late retune. Records are
+ * stamped with LPC_TIMER3's count, the M0's free running halGetCounterValue()
+ * at the core clock, which the M4 reads too, so the two rings line up.
+ *
+ * Each core writes its own ring; the baseband puts the address of its ring
+ * in shared memory as it starts. Debug > Trace writes both to the SD card
+ * (trace_file.hpp), tools/trace_to_json.py makes Chrome trace JSON of that.
+ *
+ * A record is a few stores with interrupts off. Build with TRACE_ENABLED=0
+ * to compile the macros out.
+ */
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+namespace trace {
+
+/* Keep in step with tools/trace_to_json.py. */
+enum class Event : uint8_t {
+	M0Dispatch = 0,		// Scope, arg0: event mask
+	Paint = 1,			// Complete, arg0: start in the frame, us
+	Retune = 2,			// Complete, arg0: 1 if precomputed
+	CaptureWrite = 3,	// Complete, arg0: bytes
+	M4Dispatch = 4,		// Scope, arg0: event mask
+	Baseband = 5,		// Scope, arg0: buffer's sample index, low 32 bits
+	Overrun = 6,		// Instant, arg0: buffers dropped
+};
+
+enum class Phase : uint8_t {
+	Begin = 0,
+	End = 1,
+	Instant = 2,
+	Complete = 3,		// timestamp is the start, arg1 the length in ticks
+};
+
+struct Record {
+	uint32_t timestamp;
+	Event event;
+	Phase phase;
+	uint16_t reserved;
+	uint32_t arg0;
+	uint32_t arg1;
+};
+
+static_assert(sizeof(Record) == 16, "trace::Record layout is shared with the host tool");
+
+struct Ring {
+	static constexpr uint32_t magic_value = 0x43525450;		// "PTRC"
+	static constexpr size_t records_k = 7;
+	static constexpr size_t records_max = 1U << records_k;
+
+	uint32_t magic;
+	volatile uint32_t count;		// Records written, only grows
+	Record records[records_max];
+};
+
+/* This core's. */
+extern Ring ring;
+
+inline uint32_t now() {
+	return LPC_TIMER3->TC;
+}
+
+inline void record(const Event event, const Phase phase, const uint32_t arg0 = 0, const uint32_t arg1 = 0, const uint32_t timestamp = now()) {
+	const auto primask = __get_PRIMASK();
+	__disable_irq();
+	const auto n = ring.count;
+	ring.records[n & (Ring::records_max - 1)] = { timestamp, event, phase, 0, arg0, arg1 };
+	ring.count = n + 1;
+	__set_PRIMASK(primask);
+}
+
+class Scope {
+public:
+	Scope(const Event event, const uint32_t arg0) : event { event } {
+		record(event, Phase::Begin, arg0);
+	}
+
+	~Scope() {
+		record(event, Phase::End);
+	}
+
+	Scope(const Scope&) = delete;
+	Scope& operator=(const Scope&) = delete;
+
+private:
+	const Event event;
+};
+
+} /* namespace trace */
+
+#if TRACE_ENABLED
+/* Begin here, end with the enclosing block. One per block. */
+#define TRACE_SCOPE(event, arg0) const trace::Scope trace_scope { trace::Event::event, (arg0) }
+#define TRACE_INSTANT(event, arg0) trace::record(trace::Event::event, trace::Phase::Instant, (arg0))
+/* From start, a trace::now() taken earlier, until now. */
+#define TRACE_COMPLETE(event, start, arg0) trace::record(trace::Event::event, trace::Phase::Complete, (arg0), trace::now() - (start), (start))
+#else
+#define TRACE_SCOPE(event, arg0) do { } while(0)
+#define TRACE_INSTANT(event, arg0) do { } while(0)
+#define TRACE_COMPLETE(event, start, arg0) do { } while(0)
+#endif
+
+#endif/*__TRACE_H__*/
@@ -313,9 +313,18 @@ public:
 	}
 };
 
+/* 1bpp, LSB first, rows byte aligned. PackBits data is decoded as it's
+ * drawn, see ILI9341::draw_bitmap_packbits().
+ */
 struct Bitmap {
+	enum class Encoding : uint8_t {
+		Raw = 0,
+		PackBits = 1,
+	};
+
 	const Size size;
 	const uint8_t* const data;
+	const Encoding encoding { Encoding::Raw };
 };
 
 enum class KeyEvent {
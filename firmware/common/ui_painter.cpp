@@ -28,6 +28,54 @@ using namespace portapack;
 
 namespace ui {
 
+void DamageRegion::add(Rect r) {
+	if( r.is_empty() ) {
+		return;
+	}
+
+	for(size_t i=0; i<count; ) {
+		if( r.intersect(rects[i]).is_empty() ) {
+			i++;
+		} else {
+			// Absorb and start over, the union may now reach others.
+			r += rects[i];
+			rects[i] = rects[--count];
+			i = 0;
+		}
+	}
+
+	if( count < rects.size() ) {
+		rects[count++] = r;
+		return;
+	}
+
+	size_t best = 0;
+	int32_t best_growth = INT32_MAX;
+	for(size_t i=0; i<count; i++) {
+		Rect merged = rects[i];
+		merged += r;
+		const int32_t growth = merged.width() * merged.height() - rects[i].width() * rects[i].height();
+		if( growth < best_growth ) {
+			best = i;
+			best_growth = growth;
+		}
+	}
+	rects[best] += r;
+}
+
+void DamageRegion::clear() {
+	count = 0;
+}
+
+bool DamageRegion::intersects(const Rect& r) const {
+	for(const auto& d : *this) {
+		if( !d.intersect(r).is_empty() ) {
+			return true;
+		}
+	}
+	return false;
+}
+
 Style Style::invert() const {
 	return {
 		.font = font,
@@ -43,48 +91,73 @@ int Painter::draw_char(const Point p, const Style& style, const char c) {
 }
 
 int Painter::draw_string(Point p, const Font& font, const Color foreground,
-	const Color background, const std::string text) {
+	const Color background, const char* const text, const size_t length) {
 	
 	bool escape = false;
 	size_t width = 0;
 	Color pen = foreground;
+	size_t run_start = 0;
+	size_t run_width = 0;
 	
-	for(const auto c : text) {
+	// Each stretch between colour escapes goes out as one glyph run.
+	const auto flush = [&](const size_t run_end) {
+		display.draw_glyph_run(p, font, &text[run_start], run_end - run_start, pen, background);
+		p += { static_cast<int>(run_width), 0 };
+		width += run_width;
+		run_start = run_end;
+		run_width = 0;
+	};
+	
+	for(size_t i=0; i<length; i++) {
+		const auto c = text[i];
 		if (escape) {
 			if (c <= 15)
 				pen = term_colors[c & 15];
 			else
 				pen = foreground;
 			escape = false;
+			run_start = i + 1;
 		} else {
 			if (c == '\x1B') {
+				flush(i);
 				escape = true;
+				run_start = i + 1;
 			} else {
-				const auto glyph = font.glyph(c);
-				display.draw_glyph(p, glyph, pen, background);
-				const auto advance = glyph.advance();
-				p += advance;
-				width += advance.x();
+				run_width += font.glyph(c).advance().x();
 			}
 		}
 	}
+	flush(length);
 	return width;
 }
 
-int Painter::draw_string(Point p, const Style& style, const std::string text) {
-	return draw_string(p, style.font, style.foreground, style.background, text);
+int Painter::draw_string(Point p, const Font& font, const Color foreground,
+	const Color background, const std::string& text) {
+	return draw_string(p, font, foreground, background, text.data(), text.size());
+}
+
+int Painter::draw_string(Point p, const Style& style, const char* const text, const size_t length) {
+	return draw_string(p, style.font, style.foreground, style.background, text, length);
+}
+
+int Painter::draw_string(Point p, const Style& style, const std::string& text) {
+	return draw_string(p, style.font, style.foreground, style.background, text.data(), text.size());
 }
 
 void Painter::draw_bitmap(const Point p, const Bitmap& bitmap, const Color foreground, const Color background) {
-	display.draw_bitmap(p, bitmap.size, bitmap.data, foreground, background);
+	if( bitmap.encoding == Bitmap::Encoding::PackBits ) {
+		display.draw_bitmap_packbits(p, bitmap.size, bitmap.data, foreground, background);
+	} else {
+		display.draw_bitmap(p, bitmap.size, bitmap.data, foreground, background);
+	}
 }
 
 void Painter::draw_hline(Point p, int width, const Color c) {
-	display.fill_rectangle({ p, { width, 1 } }, c);
+	fill_rectangle({ p, { width, 1 } }, c);
 }
 
 void Painter::draw_vline(Point p, int height, const Color c) {
-	display.fill_rectangle({ p, { 1, height } }, c);
+	fill_rectangle({ p, { 1, height } }, c);
 }
 
 void Painter::draw_rectangle(const Rect r, const Color c) {
@@ -95,18 +168,40 @@ void Painter::draw_rectangle(const Rect r, const Color c) {
 }
 
 void Painter::fill_rectangle(const Rect r, const Color c) {
-	display.fill_rectangle(r, c);
+	const auto clipped = clip.is_empty() ? r : r.intersect(clip);
+	if( !clipped.is_empty() ) {
+		display.fill_rectangle(clipped, c);
+	}
 }
 
 void Painter::fill_rectangle_unrolled8(const Rect r, const Color c) {
-	display.fill_rectangle_unrolled8(r, c);
+	if( clip.is_empty() ) {
+		display.fill_rectangle_unrolled8(r, c);
+	} else {
+		fill_rectangle(r, c);
+	}
 }
 
-void Painter::paint_widget_tree(Widget* const w) {
+bool Painter::paint_widget_tree(Widget* const w, const uint32_t deadline) {
+	deferred = false;
 	if( ui::is_dirty() ) {
+		// Take this frame's damage; painting may report more for the next.
+		damage = ui::damage_region();
+		ui::damage_clear();
+		deadline_ = deadline;
+		painted = false;
 		paint_widget(w);
+		damage.clear();
 		ui::dirty_clear();
+		if( deferred || !ui::damage_region().is_empty() ) {
+			ui::dirty_set();
+		}
 	}
+	return !deferred;
+}
+
+bool Painter::over_budget() const {
+	return painted && (static_cast<int32_t>(halGetCounterValue() - deadline_) > 0);
 }
 
 void Painter::paint_widget(Widget* const w) {
@@ -118,6 +213,12 @@ void Painter::paint_widget(Widget* const w) {
 		w->visible(true);
 
 		if( w->dirty() ) {
+			if( over_budget() ) {
+				// Still dirty, along with the children it would have forced.
+				deferred = true;
+				return;
+			}
+			painted = true;
 			w->paint(*this);
 			// Force-paint all children.
 			for(const auto child : w->children()) {
@@ -126,6 +227,33 @@ void Painter::paint_widget(Widget* const w) {
 			}
 			w->set_clean();
 		} else {
+			// Repaint only where damaged. Containers refill their background
+			// clipped to the damage, leaves just repaint, their pixels being
+			// unchanged outside it.
+			const auto r = w->screen_rect();
+			if( damage.intersects(r) ) {
+				if( over_budget() ) {
+					// Hand its part of the damage, children's too, to the next frame.
+					for(const auto& d : damage) {
+						ui::damage_add(d.intersect(r));
+					}
+					deferred = true;
+					return;
+				}
+				painted = true;
+				if( w->children().empty() ) {
+					w->paint(*this);
+				} else {
+					for(const auto& d : damage) {
+						clip = d.intersect(r);
+						if( !clip.is_empty() ) {
+							w->paint(*this);
+						}
+					}
+					clip = { };
+				}
+			}
+
 			// Selectively paint all children.
 			for(const auto child : w->children()) {
 				paint_widget(child);
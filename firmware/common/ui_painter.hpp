@@ -25,6 +25,7 @@
 #include "ui.hpp"
 #include "ui_text.hpp"
 
+#include <array>
 #include <string>
 
 namespace ui {
@@ -39,6 +40,25 @@ struct Style {
 
 class Widget;
 
+/* Screen areas to repaint on the next frame, on top of dirty widgets.
+ * Overlapping rects are merged as they arrive; once full, a new rect is
+ * merged into whichever existing one grows least.
+ */
+class DamageRegion {
+public:
+	void add(Rect r);
+	void clear();
+	bool intersects(const Rect& r) const;
+	bool is_empty() const { return count == 0; }
+
+	const Rect* begin() const { return &rects[0]; }
+	const Rect* end() const { return &rects[count]; }
+
+private:
+	std::array<Rect, 8> rects { };
+	size_t count { 0 };
+};
+
 class Painter {
 public:
 	Painter() { };
@@ -49,8 +69,11 @@ public:
 	int draw_char(const Point p, const Style& style, const char c);
 
 	int draw_string(Point p, const Font& font, const Color foreground,
-		const Color background, const std::string text);
-	int draw_string(Point p, const Style& style, const std::string text);
+		const Color background, const char* const text, const size_t length);
+	int draw_string(Point p, const Font& font, const Color foreground,
+		const Color background, const std::string& text);
+	int draw_string(Point p, const Style& style, const char* const text, const size_t length);
+	int draw_string(Point p, const Style& style, const std::string& text);
 
 	void draw_bitmap(const Point p, const Bitmap& bitmap, const Color background, const Color foreground);
 
@@ -58,12 +81,28 @@ public:
 	void fill_rectangle(const Rect r, const Color c);
 	void fill_rectangle_unrolled8(const Rect r, const Color c);
 
-	void paint_widget_tree(Widget* const w);
+	/* Paints what's dirty or damaged until deadline, a halGetCounterValue()
+	 * time; at least one widget, so a late start still makes progress. The
+	 * rest stay dirty or damaged for the next call. Returns false if any
+	 * were left.
+	 */
+	bool paint_widget_tree(Widget* const w, const uint32_t deadline);
 	
 	void draw_hline(Point p, int width, const Color c);
 	void draw_vline(Point p, int height, const Color c);
 	
 private:
+	/* While a damaged container repaints, its fills are clipped to the
+	 * damage so children outside it are left untouched. Text and bitmaps
+	 * aren't clipped; containers don't draw any under their children.
+	 */
+	Rect clip { };
+	DamageRegion damage { };
+	uint32_t deadline_ { 0 };
+	bool painted { false };
+	bool deferred { false };
+
+	bool over_budget() const;
 	void paint_widget(Widget* const w);
 };
 
@@ -48,6 +48,21 @@ bool is_dirty() {
 	return ui_dirty;
 }
 
+static DamageRegion ui_damage;
+
+void damage_add(const Rect& r) {
+	ui_damage.add(r);
+	dirty_set();
+}
+
+void damage_clear() {
+	ui_damage.clear();
+}
+
+const DamageRegion& damage_region() {
+	return ui_damage;
+}
+
 /* Widget ****************************************************************/
 
 const std::vector<Widget*> Widget::no_children { };
@@ -69,6 +84,11 @@ Rect Widget::parent_rect() const {
 }
 
 void Widget::set_parent_rect(const Rect new_parent_rect) {
+	const bool moved = (new_parent_rect.left() != _parent_rect.left()) || (new_parent_rect.top() != _parent_rect.top())
+		|| (new_parent_rect.width() != _parent_rect.width()) || (new_parent_rect.height() != _parent_rect.height());
+	if( flags.visible && moved ) {
+		damage_add(screen_rect());
+	}
 	_parent_rect = new_parent_rect;
 	set_dirty();
 }
@@ -84,6 +104,9 @@ void Widget::set_parent(Widget* const widget) {
 
 	if( parent_ && !widget ) {
 		// We have a parent, but are losing it. Update visible status.
+		if( flags.visible ) {
+			damage_add(screen_rect());
+		}
 		dirty_overlapping_children_in_rect(screen_rect());
 		visible(false);
 	}
@@ -112,11 +135,11 @@ void Widget::hidden(bool hide) {
 
 		// If parent is hidden, either of these is a no-op.
 		if( hide ) {
-			// TODO: Instead of dirtying parent entirely, dirty only children
-			// that overlap with this widget.
-			
-			//parent()->dirty_overlapping_children_in_rect(parent_rect());
-			
+			// Uncover whatever is beneath, without dirtying the parent.
+			if( flags.visible ) {
+				damage_add(screen_rect());
+			}
+
 			/* TODO: Notify self and all non-hidden children that they're
 			 * now effectively hidden?
 			 */
@@ -362,11 +385,16 @@ Text::Text(
 {
 }
 
-void Text::set(const std::string value) {
+void Text::set(const std::string& value) {
 	text = value;
 	set_dirty();
 }
 
+void Text::set(const char* const value) {
+	text.assign(value);
+	set_dirty();
+}
+
 void Text::paint(Painter& painter) {
 	const auto rect = screen_rect();
 	const auto s = style();
@@ -571,53 +599,47 @@ Console::Console(
 }
 
 void Console::clear() {
-	display.fill_rectangle(
-		screen_rect(),
-		Color::black()
-	);
+	line_newest = 0;
+	line_count = 1;
+	lines[0].length = 0;
+	scrollback = 0;
 	pos = { 0, 0 };
+	pen = pen_default;
+	drawn_length = 0;
+	drawn_x = 0;
+	drawn_pen = pen_default;
+	if (!hidden() && visible()) {
+		display.fill_rectangle(
+			screen_rect(),
+			style().background
+		);
+	}
+}
+
+bool Console::drawing() {
+	return !hidden() && visible() && (scrollback == 0);
 }
 
 void Console::write(std::string message) {
 	bool escape = false;
-	
-	if (!hidden() && visible()) {
-		const Style& s = style();
-		const Font& font = s.font;
-		const auto rect = screen_rect();
-		ui::Color pen_color = s.foreground;
-		
-		for (const auto c : message) {
-			if (escape) {
-				if (c <= 15)
-					pen_color = term_colors[c & 15];
-				else
-					pen_color = s.foreground;
-				escape = false;
-			} else {
-				if (c == '\n') {
-					crlf();
-				} else if (c == '\x1B') {
-					escape = true;
-				} else {
-					const auto glyph = font.glyph(c);
-					const auto advance = glyph.advance();
-					if( (pos.x() + advance.x()) > rect.width() ) {
-						crlf();
-					}
-					const Point pos_glyph {
-						rect.left() + pos.x(),
-						display.scroll_area_y(pos.y())
-					};
-					display.draw_glyph(pos_glyph, glyph, pen_color, s.background);
-					pos += { advance.x(), 0 };
-				}
-			}
+
+	// Each write starts in the style's colour
+	if (pen != pen_default)
+		append_escape(pen_default);
+
+	for (const auto c : message) {
+		if (escape) {
+			append_escape((c <= 15) ? c : pen_default);
+			escape = false;
+		} else if (c == '\n') {
+			crlf();
+		} else if (c == '\x1B') {
+			escape = true;
+		} else {
+			append(c);
 		}
-		buffer = message;
-	} else {
-		if (buffer.size() < 256) buffer += message;
 	}
+	flush();
 }
 
 void Console::writeln(std::string message) {
@@ -625,16 +647,114 @@ void Console::writeln(std::string message) {
 	crlf();
 }
 
+void Console::append(const char c) {
+	const auto advance = style().font.glyph(c).advance();
+	if( ((pos.x() + advance.x()) > screen_rect().width()) ||
+		(lines[line_newest].length >= line_length_max) ) {
+		crlf();
+	}
+	auto& line = lines[line_newest];
+	line.text[line.length++] = c;
+	pos += { advance.x(), 0 };
+}
+
+void Console::append_escape(const uint8_t code) {
+	if (lines[line_newest].length + 2U > line_length_max)
+		crlf();
+	auto& line = lines[line_newest];
+	line.text[line.length++] = '\x1B';
+	line.text[line.length++] = code;
+	pen = code;
+}
+
+void Console::flush() {
+	const auto& line = lines[line_newest];
+	if (drawing() && (drawn_length < line.length)) {
+		draw_text(line, drawn_length, drawn_x, drawn_pen, display.scroll_area_y(pos.y()));
+	}
+	drawn_length = line.length;
+	drawn_x = pos.x();
+	drawn_pen = pen;
+}
+
+void Console::draw_text(const Line& line, size_t begin, Coord x, uint8_t line_pen, const Coord y) {
+	const Style& s = style();
+	const Font& font = s.font;
+	const auto left = screen_rect().left();
+
+	// Characters of one colour go out as a single glyph run.
+	std::array<char, 40> run;
+	size_t run_length = 0;
+	Coord run_x = x;
+	const auto draw_run = [&]() {
+		if( run_length ) {
+			const auto pen_color = (line_pen == pen_default) ? s.foreground : term_colors[line_pen & 15];
+			display.draw_glyph_run({ left + run_x, y }, font, run.data(), run_length, pen_color, s.background);
+			run_length = 0;
+		}
+	};
+
+	for (size_t i = begin; i < line.length; i++) {
+		const auto c = line.text[i];
+		if (c == '\x1B') {
+			draw_run();
+			line_pen = line.text[++i];
+		} else {
+			if( run_length == run.size() ) {
+				draw_run();
+			}
+			if( run_length == 0 ) {
+				run_x = x;
+			}
+			run[run_length++] = c;
+			x += font.glyph(c).advance().x();
+		}
+	}
+	draw_run();
+}
+
+void Console::set_scrollback(const size_t lines_back) {
+	const size_t rows = screen_rect().height() / style().font.line_height();
+	const size_t scrollback_max = (line_count > rows) ? (line_count - rows) : 0;
+	const auto new_scrollback = std::min(lines_back, scrollback_max);
+	if (new_scrollback != scrollback) {
+		scrollback = new_scrollback;
+		set_dirty();
+	}
+}
+
+bool Console::on_encoder(const EncoderEvent delta) {
+	set_scrollback(std::max<int32_t>(0, static_cast<int32_t>(scrollback) - delta));
+	return true;
+}
+
 void Console::paint(Painter&) {
-	write(buffer);
+	const Style& s = style();
+	const auto sr = screen_rect();
+	const auto line_height = s.font.line_height();
+	const size_t rows = sr.height() / line_height;
+	const size_t shown = std::min(rows, line_count - scrollback);
+
+	display.scroll_set_position(0);
+	display.fill_rectangle(sr, s.background);
+	for (size_t i = 0; i < shown; i++) {
+		const auto n = (line_newest + lines_max - scrollback - (shown - 1) + i) % lines_max;
+		draw_text(lines[n], 0, 0, pen_default, display.scroll_area_y(i * line_height));
+	}
+
+	// New text goes on from the bottom line
+	pos = { pos.x(), static_cast<Coord>((shown - 1) * line_height) };
+	drawn_length = lines[line_newest].length;
+	drawn_x = pos.x();
+	drawn_pen = pen;
 }
 
 void Console::on_show() {
 	const auto screen_r = screen_rect();
 	display.scroll_set_area(screen_r.top(), screen_r.bottom());
 	display.scroll_set_position(0);
-	clear();
-	//visible = true;
+	// paint() redraws what the ring holds
+	set_dirty();
 }
 
 void Console::on_hide() {
@@ -642,24 +762,38 @@ void Console::on_hide() {
 	 * position?
 	 */
 	display.scroll_disable();
-	//visible = false;
 }
 
 void Console::crlf() {
-	if (hidden() || !visible()) return;
+	flush();
+
+	// The colour goes on into the next line, written there as an escape
+	line_newest = (line_newest + 1) % lines_max;
+	line_count = std::min(line_count + 1, lines_max);
+	lines[line_newest].length = 0;
+	pos = { 0, pos.y() };
+	drawn_length = 0;
+	drawn_x = 0;
+	drawn_pen = pen_default;
+	if (pen != pen_default) {
+		const auto line_pen = pen;
+		pen = pen_default;
+		append_escape(line_pen);
+	}
+
+	if (!drawing()) return;
 	
 	const Style& s = style();
 	const auto sr = screen_rect();
 	const auto line_height = s.font.line_height();
-	pos = { 0, pos.y() + line_height };
+	pos = { pos.x(), pos.y() + line_height };
 	const int32_t y_excess = pos.y() + line_height - sr.height();
 	if( y_excess > 0 ) {
 		display.scroll(-y_excess);
 		pos = { pos.x(), pos.y() - y_excess };
-
-		const Rect dirty { sr.left(), display.scroll_area_y(pos.y()), sr.width(), line_height };
-		display.fill_rectangle(dirty, s.background);
 	}
+	const Rect dirty { sr.left(), display.scroll_area_y(pos.y()), sr.width(), line_height };
+	display.fill_rectangle(dirty, s.background);
 }
 
 /* Checkbox **************************************************************/
@@ -1520,7 +1654,101 @@ void Waveform::set_length(const uint32_t new_length) {
 	}
 }
 
+void Waveform::set_spans(const Span* const spans, const size_t count) {
+	spans_ = spans;
+	span_count_ = std::min<size_t>(std::min(count, columns_max), screen_rect().width());
+
+	if( hidden() || !visible() ) {
+		return;
+	}
+	if( !drawn_valid ) {
+		set_dirty();
+		return;
+	}
+
+	// Of each moved column, clear the old span's rows outside the new one,
+	// then fill the new span's outside the old.
+	const auto r = screen_rect();
+	const auto fill = [&r](const Coord x, const int top, const int bottom, const Color color) {
+		if( top <= bottom ) {
+			display.fill_rectangle({ x, r.top() + top, 1, bottom - top + 1 }, color);
+		}
+	};
+	for(size_t i=0; i<span_count_; i++) {
+		const int top = span_y(spans_[i].max);
+		const int bottom = span_y(spans_[i].min);
+		const int old_top = drawn_top[i];
+		const int old_bottom = drawn_bottom[i];
+		if( (top == old_top) && (bottom == old_bottom) ) {
+			continue;
+		}
+		const Coord x = r.left() + i;
+		fill(x, old_top, std::min(old_bottom, top - 1), Color::black());
+		fill(x, std::max(old_top, bottom + 1), old_bottom, Color::black());
+		fill(x, top, std::min(bottom, old_top - 1), color_);
+		fill(x, std::max(top, old_bottom + 1), bottom, color_);
+		drawn_top[i] = top;
+		drawn_bottom[i] = bottom;
+	}
+
+	if( show_cursors ) {
+		Painter painter;
+		draw_cursors(painter);
+	}
+}
+
+void Waveform::on_show() {
+	drawn_valid = false;
+}
+
+void Waveform::on_hide() {
+	drawn_valid = false;
+}
+
+uint8_t Waveform::span_y(const int16_t value) const {
+	// Full scale positive at the top row, negative at the bottom
+	const int32_t h = std::min(screen_rect().height(), 256);
+	return ((32767 - value) * (h - 1)) / 65535;
+}
+
+void Waveform::paint_spans(Painter& painter) {
+	const auto r = screen_rect();
+	painter.fill_rectangle_unrolled8(r, Color::black());
+	for(size_t i=0; i<span_count_; i++) {
+		const auto top = span_y(spans_[i].max);
+		const auto bottom = span_y(spans_[i].min);
+		painter.draw_vline({ static_cast<Coord>(r.left() + i), r.top() + top }, bottom - top + 1, color_);
+		drawn_top[i] = top;
+		drawn_bottom[i] = bottom;
+	}
+	// Columns past span_count_ are blank, drawn as a span that's never matched
+	for(size_t i=span_count_; i<columns_max; i++) {
+		drawn_top[i] = 1;
+		drawn_bottom[i] = 0;
+	}
+	drawn_valid = true;
+	draw_cursors(painter);
+}
+
+void Waveform::draw_cursors(Painter& painter) {
+	if (!show_cursors) return;
+
+	const auto r = screen_rect();
+	for (size_t n = 0; n < 2; n++) {
+		painter.draw_vline(
+			Point(std::min(r.size().width(), (int)cursors[n]), r.location().y()),
+			r.size().height(),
+			cursor_colors[n]
+			);
+	}
+}
+
 void Waveform::paint(Painter& painter) {
+	if (spans_) {
+		paint_spans(painter);
+		return;
+	}
+
 	size_t n;
 	Coord y, y_offset = screen_rect().location().y();
 	Coord prev_x = screen_rect().location().x(), prev_y;
@@ -1568,18 +1796,87 @@ void Waveform::paint(Painter& painter) {
 		}
 	}
 	
-	// Cursors
-	if (show_cursors) {
-		for (n = 0; n < 2; n++) {
-			painter.draw_vline(
-				Point(std::min(screen_rect().size().width(), (int)cursors[n]), y_offset),
-				screen_rect().size().height(),
-				cursor_colors[n]
-				);
+	draw_cursors(painter);
+}
+
+/* BarGraph *************************************************************/
+
+BarGraph::BarGraph(
+	Rect parent_rect,
+	size_t bar_count,
+	Color color
+) : Widget { parent_rect },
+	bar_count_ { std::min(bar_count, bars_max) },
+	color_ { color }
+{
+}
+
+void BarGraph::set_values(const uint8_t* const values, const size_t count) {
+	const size_t n = std::min(count, bar_count_);
+	std::copy(values, values + n, values_.begin());
+
+	if( hidden() || !visible() ) {
+		return;
+	}
+	if( !drawn_valid ) {
+		set_dirty();
+		return;
+	}
+
+	// Straight to the display, as Console does: paint() is left for when
+	// the whole graph needs redrawing.
+	const auto r = screen_rect();
+	for(size_t i=0; i<bar_count_; i++) {
+		const int height = bar_height(i);
+		const int drawn_height = drawn[i];
+		if( height > drawn_height ) {
+			display.fill_rectangle(
+				{ bar_left(i), r.bottom() - height, bar_width(i), height - drawn_height },
+				color_
+			);
+		} else if( height < drawn_height ) {
+			display.fill_rectangle(
+				{ bar_left(i), r.bottom() - drawn_height, bar_width(i), drawn_height - height },
+				Color::black()
+			);
 		}
+		drawn[i] = height;
 	}
 }
 
+void BarGraph::on_show() {
+	drawn_valid = false;
+}
+
+void BarGraph::on_hide() {
+	drawn_valid = false;
+}
+
+void BarGraph::paint(Painter& painter) {
+	const auto r = screen_rect();
+	painter.fill_rectangle(r, Color::black());
+	for(size_t i=0; i<bar_count_; i++) {
+		const int height = bar_height(i);
+		if( height ) {
+			painter.fill_rectangle({ bar_left(i), r.bottom() - height, bar_width(i), height }, color_);
+		}
+		drawn[i] = height;
+	}
+	drawn_valid = true;
+}
+
+int BarGraph::bar_height(const size_t i) const {
+	const int h = std::min(screen_rect().height(), 255);
+	return (values_[i] * h + 127) / 255;
+}
+
+Coord BarGraph::bar_left(const size_t i) const {
+	return screen_rect().left() + (i * screen_rect().width()) / bar_count_;
+}
+
+Dim BarGraph::bar_width(const size_t i) const {
+	return bar_left(i + 1) - bar_left(i);
+}
 
 /* VuMeter **************************************************************/
 
@@ -1592,7 +1889,7 @@ VuMeter::VuMeter(
 	show_max_ { show_max }
 {
 	//set_focusable(false);
-	LED_height = std::max(1UL, parent_rect.size().height() / LEDs);
+	LED_height = std::max<uint32_t>(1, parent_rect.size().height() / LEDs);
 	split = 256 / LEDs;
 }
 
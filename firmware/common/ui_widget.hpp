@@ -44,6 +44,14 @@ void dirty_set();
 void dirty_clear();
 bool is_dirty();
 
+/* Reports a screen area whose pixels need repainting from the widget tree,
+ * e.g. where a widget was hidden or moved away from. Only the widgets under
+ * it repaint, rather than a whole dirty parent and all of its children.
+ */
+void damage_add(const Rect& r);
+void damage_clear();
+const DamageRegion& damage_region();
+
 class Context {
 public:
 	FocusManager& focus_manager() {
@@ -205,7 +213,9 @@ public:
 	Text(Rect parent_rect, std::string text);
 	Text(Rect parent_rect);
 
-	void set(const std::string value);
+	void set(const std::string& value);
+	/* Reuses the existing string's storage where it fits. */
+	void set(const char* const value);
 
 	void paint(Painter& painter) override;
 
@@ -307,6 +317,13 @@ private:
 	uint32_t _max = 100;
 };
 
+/* Text into the display's hardware scroll area, newest line at the
+ * bottom. Lines are kept as written, escapes included, in a ring of
+ * lines_max: appending draws only the new characters, a new line is a
+ * scroll and one cleared row, and paint() redraws from the ring. Text
+ * written while hidden is kept the same way. Made focusable, the encoder
+ * scrolls back through the ring.
+ */
 class Console : public Widget {
 public:
 	Console(Rect parent_rect);
@@ -315,17 +332,45 @@ public:
 	void write(std::string message);
 	void writeln(std::string message);
 
+	/* Lines back from the newest, 0 follows new text. */
+	void set_scrollback(const size_t lines);
+
 	void paint(Painter&) override;
+	bool on_encoder(const EncoderEvent delta) override;
 	
 	void on_show() override;
 	void on_hide() override;
 
 private:
-	//bool visible = false;
-	Point pos { 0, 0 };
-	std::string buffer { };
+	// 40 characters of the 6x8 font, with room for colour escapes
+	static constexpr size_t line_length_max = 56;
+	static constexpr size_t lines_max = 48;
+	static constexpr uint8_t pen_default = 0xff;
+
+	struct Line {
+		std::array<char, line_length_max> text;
+		uint8_t length;
+	};
+
+	std::array<Line, lines_max> lines { };
+	size_t line_newest { 0 };
+	size_t line_count { 1 };
+	size_t scrollback { 0 };
 
+	// pos is in the newest line, pen an escape's colour or pen_default
+	Point pos { 0, 0 };
+	uint8_t pen { pen_default };
+	// How much of the newest line is on screen, and where it ends
+	size_t drawn_length { 0 };
+	Coord drawn_x { 0 };
+	uint8_t drawn_pen { pen_default };
+
+	bool drawing();
+	void append(const char c);
+	void append_escape(const uint8_t code);
+	void flush();
 	void crlf();
+	void draw_text(const Line& line, size_t begin, Coord x, uint8_t line_pen, const Coord y);
 };
 
 class Checkbox : public Widget {
@@ -597,8 +642,20 @@ private:
 	int32_t clip_value(const uint32_t index, const uint32_t value);
 };
 
+/* A line plot of length samples from data, or, once given spans, one
+ * vertical min to max span per column. Spans come decimated by the
+ * caller, so every sample shows however many there are to a column. New
+ * spans only redraw the pixels of the columns that moved, as BarGraph
+ * does, so a streaming scope costs the columns that changed.
+ */
 class Waveform : public Widget {
 public:
+	struct Span {
+		int16_t min;
+		int16_t max;
+	};
+
+	static constexpr size_t columns_max = 240;
 
 	Waveform(Rect parent_rect, int16_t * data, uint32_t length, uint32_t offset, bool digital, Color color);
 
@@ -611,6 +668,13 @@ public:
 	void set_length(const uint32_t new_length);
 	void set_cursor(const uint32_t i, const int16_t position);
 
+	/* count spans, one per column from the left, up to the width. They're
+	 * read again by paint(), so must stay valid.
+	 */
+	void set_spans(const Span* const spans, const size_t count);
+
+	void on_show() override;
+	void on_hide() override;
 	void paint(Painter& painter) override;
 
 private:
@@ -623,6 +687,46 @@ private:
 	Color color_;
 	int16_t cursors[2] { };
 	bool show_cursors { false };
+
+	const Span* spans_ { nullptr };
+	size_t span_count_ { 0 };
+	// Rows of each column's span as drawn, from the top
+	std::array<uint8_t, columns_max> drawn_top { };
+	std::array<uint8_t, columns_max> drawn_bottom { };
+	bool drawn_valid { false };
+
+	uint8_t span_y(const int16_t value) const;
+	void paint_spans(Painter& painter);
+	void draw_cursors(Painter& painter);
+};
+
+/* Bars of 0~255 values, full scale at the widget's height. New values only
+ * fill the part of each bar between its drawn and new heights, so a
+ * spectrum that barely moves costs a few pixels per bar, not a redraw.
+ */
+class BarGraph : public Widget {
+public:
+	BarGraph(Rect parent_rect, size_t bar_count, Color color);
+
+	void set_values(const uint8_t* const values, const size_t count);
+
+	void on_show() override;
+	void on_hide() override;
+	void paint(Painter& painter) override;
+
+private:
+	static constexpr size_t bars_max = 256;
+
+	size_t bar_count_;
+	Color color_;
+	std::array<uint8_t, bars_max> values_ { };
+	// Heights on screen, in pixels. Invalid until the first full paint.
+	std::array<uint8_t, bars_max> drawn { };
+	bool drawn_valid { false };
+
+	int bar_height(const size_t i) const;
+	Coord bar_left(const size_t i) const;
+	Dim bar_width(const size_t i) const;
 };
 
 class VuMeter : public Widget {
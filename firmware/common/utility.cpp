@@ -91,6 +91,46 @@ float mag2_to_dbv_norm(const float mag2) {
 	return (fast_log2(mag2) - mag2_log2_max) * mag2_to_db_factor;
 }
 
+namespace {
+
+// log2(1 + i/32) in Q16
+LOCATE_IN_DATA_RAM const uint32_t log2_mantissa_q16[33] = {
+	    0,  2909,  5732,  8473, 11136, 13727, 16248, 18704,
+	21098, 23433, 25711, 27936, 30109, 32234, 34312, 36346,
+	38336, 40286, 42196, 44068, 45904, 47705, 49472, 51207,
+	52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047,
+	65536,
+};
+
+}
+
+int32_t fast_log2_q16(const uint32_t x) {
+	if( x == 0 ) {
+		return 0;
+	}
+	const int32_t exponent = 31 - __builtin_clz(x);
+	// Leading one at bit 31: five bits of table index, 16 of fraction below it
+	const uint32_t m = x << (31 - exponent);
+	const size_t i = (m >> 26) & 31;
+	const uint32_t fraction = (m >> 10) & 0xffff;
+	const uint32_t a = log2_mantissa_q16[i];
+	const uint32_t b = log2_mantissa_q16[i + 1];
+	return (exponent << 16) + a + (((b - a) * fraction) >> 16);
+}
+
+int32_t mag2_to_db_q8(const uint32_t mag2, const int32_t full_scale_log2) {
+	// 10 * log10(2), dB per octave of power, in Q16
+	constexpr int64_t db_per_octave_q16 = 197283;
+	const int32_t log2_q16 = fast_log2_q16(mag2) - (full_scale_log2 << 16);
+	return (log2_q16 * db_per_octave_q16) >> 24;
+}
+
+int32_t mag2_to_db_q8(const float mag2, const int32_t full_scale_log2) {
+	// The largest float below 2^32
+	const float mag2_max = 4294967040.0f;
+	return mag2_to_db_q8(static_cast<uint32_t>(std::max(0.0f, std::min(mag2, mag2_max))), full_scale_log2);
+}
+
 /* GCD implementation derived from recursive implementation at
  * http://en.wikipedia.org/wiki/Binary_GCD_algorithm
  */
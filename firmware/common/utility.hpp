@@ -31,6 +31,18 @@
 
 #define LOCATE_IN_RAM __attribute__((section(".ramtext")))
 
+/* Read-only tables the M4's DSP loops index every sample. Its .rodata sits
+ * with the code in m4_code (local_sram_1), so every load there competes
+ * with instruction fetch; in .ramdata they're copied to local_sram_0 with
+ * .data at startup, at the cost of their size in RAM. GCC ignores section
+ * attributes on template instantiations. No effect on the M0.
+ */
+#if defined(LPC43XX_M4)
+#define LOCATE_IN_DATA_RAM __attribute__((section(".ramdata")))
+#else
+#define LOCATE_IN_DATA_RAM
+#endif
+
 inline uint16_t fb_to_uint16(const std::string& fb) {
 	return (fb[1] << 8) + fb[0];
 }
@@ -82,6 +94,20 @@ float fast_pow2(const float val);
 
 float mag2_to_dbv_norm(const float mag2);
 
+/* log2(x) in Q16, from the CLZ and a 33 entry table of log2 over
+ * [1, 2], linearly interpolated: within 0.0002 (0.0006dB of power) of
+ * the exact value for any x, against fast_log2()'s 0.005. 0 gives 0.
+ */
+int32_t fast_log2_q16(const uint32_t x);
+
+/* 10 * log10(mag2 / 2^full_scale_log2), in 1/256 dB, for spectrum bins
+ * and power statistics; the float one saturates mag2 at 2^32. Within
+ * 0.005dB of exact over the whole range, mostly the 1/256 dB step;
+ * mag2_to_dbv_norm() on the normalised value is within 0.015dB.
+ */
+int32_t mag2_to_db_q8(const uint32_t mag2, const int32_t full_scale_log2);
+int32_t mag2_to_db_q8(const float mag2, const int32_t full_scale_log2);
+
 inline float magnitude_squared(const std::complex<float> c) {
 	const auto r = c.real();
 	const auto r2 = r * r;
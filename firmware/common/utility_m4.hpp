@@ -42,6 +42,17 @@ static inline complex32_t multiply_conjugate_s16_s32(const complex16_t::rep_type
 	const int32_t i = __QSUB(ir, ri);
 	return { r, i };
 }
+
+/* Same product in two instructions, for the FM discriminator's hot loop.
+ * SMUSDX can't overflow on s16 inputs. SMUAD wraps only when both samples
+ * are exactly (-32768, -32768), the one case summing to +2^31; nothing else
+ * lands on INT32_MIN, so that result is folded back to INT32_MAX.
+ */
+static inline complex32_t multiply_conjugate_s16_s32_fast(const complex16_t::rep_type a, const complex16_t::rep_type b) {
+	const int32_t r = __SMUAD(a, b);
+	const int32_t i = __SMUSDX(b, a);
+	return { (r == INT32_MIN) ? INT32_MAX : r, i };
+}
 #endif /* defined(LPC43XX_M4) */
 
 #endif/*__UTILITY_M4_H__*/
@@ -124,6 +124,15 @@ bool WM8731::write(const address_t reg_address, const reg_t value) {
 	return bus.transmit(bus_address, values.data(), values.size());
 }
 
+void WM8731::write_queued(const Register reg) {
+	const uint16_t word = (toUType(reg) << 9) | map.w[toUType(reg)];
+	const std::array<uint8_t, 2> values {
+		static_cast<uint8_t>(word >> 8),
+		static_cast<uint8_t>(word & 0xff),
+	};
+	bus.transmit_queued(bus_address, values.data(), values.size(), toUType(reg));
+}
+
 uint32_t WM8731::reg_read(const size_t reg_address) {
 	return map.w[reg_address];
 }
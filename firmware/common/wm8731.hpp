@@ -313,12 +313,14 @@ public:
 		const auto normalized = headphone_gain_range().normalize(volume);
 		auto n = normalized.centibel() / 10;
 
-		write(LeftHeadphoneOut {
+		// Queued, the UI sets it as the encoder turns.
+		map.r.left_headphone_out = {
 			.lhpvol = static_cast<reg_t>(n),
 			.lzcen = 0,
 			.lrhpboth = 1,
 			.reserved0 = 0,
-		});
+		};
+		write_queued(Register::LeftHeadphoneOut);
 	}
 
 	volume_range_t headphone_gain_range() const override {
@@ -379,6 +381,7 @@ private:
 	void configure_interface_i2s_master();
 
 	bool write(const Register reg);
+	void write_queued(const Register reg);
 	
 	bool write(const address_t reg_address, const reg_t value);
 
@@ -21,21 +21,37 @@
 import sys
 import struct
 
-outfile = open("airlines.db", "w")
+# airlines.db layout, as binary searched by ui_adsb_rx.cpp:
+#   0x0000: up to 2048 sorted 4-byte ICAO airline codes, NUL padded,
+#           terminated by a zero code
+#   0x2000: one 64-byte record per code, in the same order: 32-byte
+#           NUL padded name, then 32-byte NUL padded country
 
-lines = [line.rstrip('\n') for line in open('../../sdcard/ADSB/airlines.txt', 'r')]
-n = 0
+codes_max = 0x2000 // 4
 
-for line in lines:
+def field(text, length):
+	b = text.encode('ascii', 'replace')[:length - 1]
+	return b + b'\0' * (length - len(b))
+
+airlines = {}
+
+for line in open('../../sdcard/ADSB/airlines.txt', 'r'):
+	line = line.rstrip('\n')
 	if line:
 		nd = line.find('(')
 		if (nd == -1):
-			nd = None
+			name = line[10:]
+			country = ''
 		else:
-			nd -= 1
-		nline = line[4:7] + '\0' + line[10:nd] + '\0'
-		print nline
-		b = bytearray(nline)
-		pad_len = 32 - len(b)
-		b += "\0" * pad_len
-		outfile.write(b)
+			name = line[10:nd - 1]
+			country = line[nd + 1:line.find(')', nd)]
+		airlines[line[4:7]] = (name.strip(), country.strip())
+
+codes = sorted(airlines)[:codes_max - 1]
+
+with open("airlines.db", "wb") as outfile:
+	index = b''.join(field(code, 4) for code in codes)
+	outfile.write(index + b'\0' * (0x2000 - len(index)))
+	for code in codes:
+		name, country = airlines[code]
+		outfile.write(field(name, 32) + field(country, 32))
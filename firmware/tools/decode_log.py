@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+#
+# This file is part of PortaPack.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+# Converts binary decoder logs (AIS.BIN, ERT.BIN, TPMS.BIN, ADSB.BIN, written
+# with the "Binary packet logs" setting on) to CSV or JSON.
+#
+# Record layout, as LogRecordHeader in application/log_file.hpp, little-endian:
+#   uint8 sync (0xa5), uint8 type, uint16 bits, uint32 datetime, uint32 tag,
+#   then (bits + 7) / 8 payload bytes, first bit in the MSB.
+
+import argparse
+import csv
+import json
+import struct
+import sys
+
+sync = 0xa5
+header = struct.Struct('<BBHII')
+
+types = { 1: 'ais', 2: 'ert', 3: 'tpms', 4: 'adsb', 5: 'spectrum' }
+manchester_types = ('ert', 'tpms')
+
+def timestamp(packed):
+	return '%04d%02d%02d%02d%02d%02d' % (
+		(packed >> 26) + 2000, (packed >> 22) & 0xf, (packed >> 17) & 0x1f,
+		(packed >> 12) & 0x1f, (packed >> 6) & 0x3f, packed & 0x3f
+	)
+
+def bits_of(payload, count):
+	return [(payload[i >> 3] >> (7 - (i & 7))) & 1 for i in range(count)]
+
+def to_hex(bits):
+	bits = bits + [0] * (-len(bits) % 4)
+	return ''.join('%X' % int(''.join(map(str, bits[i:i + 4])), 2) for i in range(0, len(bits), 4))
+
+def manchester(bits):
+	# As ManchesterDecoder with sense 0: value is the first of each pair,
+	# error when both halves match.
+	pairs = [bits[i:i + 2] for i in range(0, len(bits) - 1, 2)]
+	return to_hex([p[0] for p in pairs]), to_hex([int(p[0] == p[1]) for p in pairs])
+
+def records(data):
+	offset = 0
+	while offset + header.size <= len(data):
+		if data[offset] != sync:
+			# Resynchronise on a damaged record.
+			offset += 1
+			continue
+		_, type_id, count, packed, tag = header.unpack_from(data, offset)
+		length = (count + 7) // 8
+		payload = data[offset + header.size:offset + header.size + length]
+		offset += header.size + length
+		if len(payload) < length:
+			break
+
+		bits = bits_of(payload, count)
+		record = {
+			'timestamp': timestamp(packed),
+			'type': types.get(type_id, str(type_id)),
+			'bits': count,
+			'raw': to_hex(bits),
+		}
+		if record['type'] == 'tpms':
+			record['signal_type'] = tag >> 24
+			record['frequency'] = (tag & 0xffffff) * 1000
+		if record['type'] in manchester_types:
+			record['data'], record['errors'] = manchester(bits)
+		yield record
+
+def main():
+	parser = argparse.ArgumentParser(description='Convert PortaPack binary decoder logs to CSV or JSON.')
+	parser.add_argument('log', type=argparse.FileType('rb'))
+	parser.add_argument('--json', action='store_true', help='write JSON lines instead of CSV')
+	args = parser.parse_args()
+
+	fields = ('timestamp', 'type', 'bits', 'raw', 'data', 'errors', 'signal_type', 'frequency')
+	writer = None if args.json else csv.DictWriter(sys.stdout, fields)
+	if writer:
+		writer.writeheader()
+
+	for record in records(args.log.read()):
+		if writer:
+			writer.writerow(record)
+		else:
+			print(json.dumps(record))
+
+if __name__ == '__main__':
+	main()
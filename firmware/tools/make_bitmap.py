@@ -25,7 +25,7 @@ from os import listdir
 from os import path
 
 usage_message = """
-1BPP PortaPack bitmap.hpp generator
+1BPP PortaPack bitmap.hpp generator, PackBits compressed
 
 Usage: <directory>
 """
@@ -34,9 +34,36 @@ if len(sys.argv) < 1:
 	print(usage_message)
 	sys.exit(-1)
 
+def packbits(data):
+	# Runs of 2 to 128 bytes as (1 - count, byte), anything else as literals,
+	# (count - 1, bytes...), up to 128 at a time.
+	out = []
+	literal = []
+	i = 0
+	while i < len(data):
+		run = 1
+		while i + run < len(data) and data[i + run] == data[i] and run < 128:
+			run += 1
+		if run > 1:
+			if literal:
+				out += [len(literal) - 1] + literal
+				literal = []
+			out += [(1 - run) & 0xff, data[i]]
+			i += run
+		else:
+			literal.append(data[i])
+			if len(literal) == 128:
+				out += [len(literal) - 1] + literal
+				literal = []
+			i += 1
+	if literal:
+		out += [len(literal) - 1] + literal
+	return out
+
 def convert_png(file):
 	c = 0
 	data = 0
+	pixels = []
 
 	im = Image.open(file)
 	rgb_im = im.convert('RGBA')
@@ -47,9 +74,6 @@ def convert_png(file):
 
 	name = path.basename(file).split(".")[0].lower();
 
-	f.write("static constexpr uint8_t bitmap_" + name + "_data[] = {\n")
-	f.write('	')		# Tab
-
 	for i in range(rgb_im.size[1]):
 		for j in range(rgb_im.size[0]):
 			r, g, b, a = rgb_im.getpixel((j, i))
@@ -60,16 +84,21 @@ def convert_png(file):
 				data += 128
 			
 			if j % 8 == 7:
-				f.write("0x%0.2X, " % data)
+				pixels.append(data)
 				data = 0
-		
-		f.write("\n")
-		if i < rgb_im.size[1] - 1:
-			f.write('	')		# Tab
 
+	# PackBits only where it's smaller, icons with lots of detail aren't.
+	packed = packbits(pixels)
+	encoding = "PackBits" if len(packed) < len(pixels) else "Raw"
+	if encoding == "Raw":
+		packed = pixels
+
+	f.write("static constexpr uint8_t bitmap_" + name + "_data[] = {\n")
+	for i in range(0, len(packed), 16):
+		f.write('	' + ''.join("0x%0.2X, " % v for v in packed[i:i + 16]) + "\n")
 	f.write("};\n")
 	f.write("static constexpr Bitmap bitmap_"  + name + " {\n")
-	f.write("	{ " + str(rgb_im.size[0]) + ", " + str(rgb_im.size[1]) + " }, bitmap_" + name+ "_data\n")
+	f.write("	{ " + str(rgb_im.size[0]) + ", " + str(rgb_im.size[1]) + " }, bitmap_" + name+ "_data, Bitmap::Encoding::" + encoding + "\n")
 	f.write("};\n\n")
 	return
 
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+#
+# This file is part of PortaPack.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+# Compiles a glyph sheet (graphics/font_*.txt) into ui_font_<name>.cpp and
+# .hpp, a ui::Font of fixed size glyphs, in the current directory.
+#
+# Sheet format: a "<width> <height> <first character>" line, then for each
+# character in turn a ": <label>" line followed by height rows of width
+# '#' (set) or '.' (clear) pixels. Lines starting with "//" are ignored.
+#
+# Glyphs are packed row-major, LSB first, rows not byte aligned, as
+# ui::Glyph and ILI9341::draw_glyph_run() expect.
+
+import argparse
+import sys
+
+license = """/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+"""
+
+def read_sheet(f):
+	lines = [l.rstrip('\n') for l in f if not l.startswith('//')]
+	width, height, first = (int(v, 0) for v in lines[0].split())
+	glyphs = []
+	i = 1
+	while i < len(lines):
+		if not lines[i].startswith(':'):
+			i += 1
+			continue
+		rows = lines[i + 1:i + 1 + height]
+		if (len(rows) != height) or any(len(row) != width for row in rows):
+			sys.exit('%s: glyph %d is not %dx%d' % (lines[i], len(glyphs), width, height))
+		glyphs.append(rows)
+		i += 1 + height
+	return width, height, first, glyphs
+
+def pack(rows):
+	bits = [1 if c == '#' else 0 for row in rows for c in row]
+	data = [0] * ((len(bits) + 7) // 8)
+	for i, bit in enumerate(bits):
+		data[i >> 3] |= bit << (i & 7)
+	return data
+
+def main():
+	parser = argparse.ArgumentParser(description='Compile a glyph sheet into a PortaPack ui::Font.')
+	parser.add_argument('sheet', type=argparse.FileType('r'))
+	parser.add_argument('name', help='font name, e.g. fixed_6x8')
+	args = parser.parse_args()
+
+	width, height, first, glyphs = read_sheet(args.sheet)
+	name = args.name
+	guard = '__UI_FONT_%s_H__' % name.upper()
+
+	with open('ui_font_%s.hpp' % name, 'w') as f:
+		f.write(license + '\n')
+		f.write('#ifndef %s\n#define %s\n\n' % (guard, guard))
+		f.write('#include "ui_text.hpp"\n\n')
+		f.write('namespace ui {\nnamespace font {\n\n')
+		f.write('extern const ui::Font %s;\n\n' % name)
+		f.write('} /* namespace font */\n} /* namspace ui */\n\n')
+		f.write('#endif/*%s*/\n' % guard)
+
+	with open('ui_font_%s.cpp' % name, 'w') as f:
+		f.write(license + '\n')
+		f.write('#include "ui_font_%s.hpp"\n\n' % name)
+		f.write('#include <cstdint>\n\n')
+		f.write('namespace ui {\nnamespace font {\n\nnamespace {\n\n')
+		f.write('const uint8_t %s_glyph_data[] = {\n' % name)
+		f.write(',\n'.join('\t' + ', '.join('0x%02x' % v for v in pack(rows)) for rows in glyphs))
+		f.write('\n};\n\n}\n\n')
+		f.write('const ui::Font %s {\n' % name)
+		f.write('\t%d, %d,\n' % (width, height))
+		f.write('\t%s_glyph_data,\n' % name)
+		f.write('\t0x%02x, %d,\n' % (first, len(glyphs)))
+		f.write('};\n\n')
+		f.write('} /* namespace font */\n} /* namespace ui */\n')
+
+	print('%s: %d glyphs, %dx%d' % (name, len(glyphs), width, height))
+
+if __name__ == '__main__':
+	main()
@@ -36,6 +36,54 @@ def read_image(path):
 	f.close()
 	return data
 
+def lz4_sequence(literals, offset, match_length):
+	def extra(length):
+		out = bytearray()
+		length -= 15
+		while length >= 255:
+			out.append(255)
+			length -= 255
+		out.append(length)
+		return out
+
+	literal_length = len(literals)
+	match_code = match_length - 4 if offset else 0
+	out = bytearray()
+	out.append((min(literal_length, 15) << 4) | min(match_code, 15))
+	if literal_length >= 15:
+		out += extra(literal_length)
+	out += literals
+	if offset:
+		out += struct.pack('<H', offset)
+		if match_code >= 15:
+			out += extra(match_code)
+	return out
+
+def lz4_compress_block(data):
+	# Greedy LZ4 block encoder. Per the format, the last five bytes are always
+	# literals and no match starts within the last twelve.
+	out = bytearray()
+	table = {}
+	anchor = 0
+	i = 0
+	limit = len(data) - 12
+	while i < limit:
+		key = bytes(data[i:i + 4])
+		candidate = table.get(key)
+		table[key] = i
+		if candidate is None or (i - candidate) > 0xffff:
+			i += 1
+			continue
+		match_length = 4
+		match_length_max = len(data) - 5 - i
+		while match_length < match_length_max and data[candidate + match_length] == data[i + match_length]:
+			match_length += 1
+		out += lz4_sequence(data[anchor:i], i - candidate, match_length)
+		i += match_length
+		anchor = i
+	out += lz4_sequence(data[anchor:], 0, 0)
+	return out
+
 def write_image(data, path):
 	f = open(path, 'wb')
 	f.write(data)
@@ -63,8 +111,22 @@ if len(input_image) > input_image_max_length:
 if (len(input_image) & 3) != 0:
 	raise RuntimeError('image size of %d is not multiple of four' % (len(input_image,)))
 
+# Compressed chunks have bit 31 of the length set, and hold the uncompressed
+# length followed by an LZ4 block, padded to a multiple of four.
+chunk_length_compressed = 0x80000000
+
+chunk_data = input_image
+chunk_length = len(input_image)
+if len(input_image) > 0:
+	compressed = bytearray(struct.pack('<I', len(input_image)))
+	compressed += lz4_compress_block(bytearray(input_image))
+	compressed += bytearray((0,)) * (-len(compressed) & 3)
+	if len(compressed) < len(input_image):
+		chunk_data = compressed
+		chunk_length = len(compressed) | chunk_length_compressed
+
 output_image = bytearray()
-output_image += struct.pack('<4BI', tag[0], tag[1], tag[2], tag[3], len(input_image))
-output_image += input_image
+output_image += struct.pack('<4BI', tag[0], tag[1], tag[2], tag[3], chunk_length)
+output_image += chunk_data
 
 write_image(output_image, output_path)
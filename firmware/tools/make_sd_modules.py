@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+#
+# This file is part of PortaPack.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+# Packs baseband images (the .bin files next to each .img in the baseband
+# build) for the SD card's /APPS/ directory, where run_image() looks before
+# SPI flash, and writes its INDEX.TXT. See application/sd_modules.hpp.
+#
+# Usage: make_sd_modules.py <output directory> <binary> <tag> [<binary> <tag>...]
+#   e.g. make_sd_modules.py APPS baseband/proc_sonde.bin PSON
+
+import os
+import struct
+import sys
+import zlib
+
+header_size = 512
+version = 3
+image_length_max = 32768
+
+def module(data, tag, name):
+	if len(data) > image_length_max:
+		sys.exit('%s: %d bytes, M4 RAM holds %d' % (name, len(data), image_length_max))
+	header = struct.pack('<4sHI16s4sI', b'PPM ', version, len(data), name.encode()[:16], tag.encode(), zlib.crc32(data) & 0xffffffff)
+	header += bytes(header_size - len(header))
+	# Padded to whole sectors, read straight into M4 RAM.
+	return header + data + bytes(-len(data) % 512)
+
+def main():
+	if (len(sys.argv) < 4) or (len(sys.argv) % 2):
+		sys.exit('usage: %s <output directory> <binary> <tag> [<binary> <tag>...]' % sys.argv[0])
+
+	output = sys.argv[1]
+	os.makedirs(output, exist_ok=True)
+
+	index = ['# <tag> <file>, written by make_sd_modules.py']
+	for path, tag in zip(sys.argv[2::2], sys.argv[3::2]):
+		if len(tag) != 4:
+			sys.exit('%s: tag "%s" is not four characters' % (path, tag))
+		name = os.path.splitext(os.path.basename(path))[0]
+		with open(path, 'rb') as f:
+			data = f.read()
+		filename = name + '.ppm'
+		with open(os.path.join(output, filename), 'wb') as f:
+			f.write(module(data, tag, name))
+		index.append('%s %s' % (tag, filename))
+		print('%s: %s, %d bytes' % (tag, filename, len(data)))
+
+	with open(os.path.join(output, 'INDEX.TXT'), 'w', newline='\r\n') as f:
+		f.write('\n'.join(index) + '\n')
+
+if __name__ == '__main__':
+	main()
@@ -22,6 +22,7 @@
 #
 
 import sys
+import struct
 
 usage_message = """
 PortaPack SPI flash image generator
@@ -41,12 +42,34 @@ def write_image(data, path):
 	f.write(data)
 	f.close()
 
+def add_directory(data):
+	# Prepend a 'PDIR' chunk listing (tag, offset, length) of every baseband
+	# chunk, sorted by tag, so the application can binary search for images.
+	# Offsets are from the start of the images region, directory included.
+	entries = []
+	offset = 0
+	while offset + 8 <= len(data):
+		tag, length = struct.unpack_from('<4sI', data, offset)
+		if tag == b'\x00\x00\x00\x00':
+			break
+		entries.append((tag, offset, length))
+		# Bit 31 flags a compressed chunk, see make_image_chunk.py.
+		offset += 8 + (length & 0x7fffffff)
+
+	entry_format = '<4sII'
+	directory_length = len(entries) * struct.calcsize(entry_format)
+	directory_size = 8 + directory_length
+	directory = bytearray(struct.pack('<4sI', b'PDIR', directory_length))
+	for tag, offset, length in sorted(entries):
+		directory += struct.pack(entry_format, tag, directory_size + offset, length)
+	return bytes(directory) + data
+
 if len(sys.argv) != 5:
 	print(usage_message)
 	sys.exit(-1)
 
 bootstrap_image = read_image(sys.argv[1])
-baseband_image = read_image(sys.argv[2])
+baseband_image = add_directory(read_image(sys.argv[2]))
 application_image = read_image(sys.argv[3])
 output_path = sys.argv[4]
 
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+#
+# This file is part of PortaPack.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+# Reports where an image's sections landed, from the linker map the build
+# writes next to each .elf (baseband_<name>.map, application.map): totals by
+# memory bank, and the input sections put in RAM on purpose, as .ramtext
+# (LOCATE_IN_RAM) and .ramdata (LOCATE_IN_DATA_RAM, see common/utility.hpp).
+#
+# The M4 runs its image from m4_code, in local_sram_1, remapped to address 0;
+# the M0 runs from SPIFI flash, also at 0.
+#
+# --objects adds, per object file, the code and read-only data linked,
+# and what --gc-sections dropped from the map's "Discarded input sections".
+# Every baseband image links all of baseband_shared's objects, so this is
+# where a shared helper an image never calls should show up as dropped:
+#
+#   tools/map_report.py --objects build/baseband/baseband_*.map
+
+import argparse
+import re
+import sys
+
+banks = (
+	(0x00000000, 0x00100000, 'code (m4_code or SPIFI, at 0)'),
+	(0x10000000, 0x10018000, 'local_sram_0'),
+	(0x10080000, 0x1008a000, 'local_sram_1'),
+	(0x20000000, 0x20008000, 'ahb_ram_0'),
+	(0x20008000, 0x2000c000, 'ahb_ram_1'),
+	(0x2000c000, 0x20010000, 'ahb_ram_2'),
+)
+
+placed = ('.ramtext', '.ramdata')
+
+# Input sections that take code RAM (m4_code) or flash, for --objects.
+code_sections = ('.text', '.rodata', '.ramtext', '.ramdata')
+
+# " .name  0xaddr  0xsize  file", the name alone on the line before when long.
+input_re = re.compile(r'^ (\.\S+)?\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$')
+output_re = re.compile(r'^(\.\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)')
+wrapped_re = re.compile(r'^ ?(\.\S+)$')
+
+def bank_of(address):
+	for base, end, name in banks:
+		if base <= address < end:
+			return name
+	return 'other'
+
+def parse(lines):
+	outputs = []
+	inputs = []
+	discarded = []
+	name = None
+	part = None
+	for line in lines:
+		line = line.rstrip('\n')
+		if line.startswith('Discarded input sections'):
+			part = discarded
+			continue
+		if line.startswith('Memory Configuration'):
+			part = None
+			continue
+		if line.startswith('Linker script and memory map'):
+			part = inputs
+			continue
+		if part is None:
+			continue
+		m = output_re.match(line)
+		if m and (part is inputs):
+			outputs.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16)))
+			continue
+		m = wrapped_re.match(line)
+		if m:
+			name = m.group(1)
+			continue
+		m = input_re.match(line)
+		if m:
+			section = m.group(1) or name
+			name = None
+			if section:
+				part.append((section, int(m.group(2), 16), int(m.group(3), 16), m.group(4)))
+	return outputs, inputs, discarded
+
+def is_code(section):
+	return any(section == s or section.startswith(s + '.') for s in code_sections)
+
+def object_sizes(inputs, discarded):
+	sizes = {}
+	for kept, sections in ((True, inputs), (False, discarded)):
+		for section, _, size, source in sections:
+			if size and is_code(section):
+				entry = sizes.setdefault(source.split('/')[-1], [0, 0])
+				entry[0 if kept else 1] += size
+	return sizes
+
+def main():
+	parser = argparse.ArgumentParser(description='Report section placement from a GNU ld map file.')
+	parser.add_argument('--objects', action='store_true', help='code linked and dropped, per object file')
+	parser.add_argument('map', nargs='+', type=argparse.FileType('r'))
+	args = parser.parse_args()
+
+	for f in args.map:
+		outputs, inputs, discarded = parse(f)
+		print(f.name)
+
+		totals = {}
+		for name, address, size in outputs:
+			if size and address:
+				totals.setdefault(bank_of(address), []).append((name, size))
+			elif size:
+				totals.setdefault(bank_of(0), []).append((name, size))
+		for bank, sections in sorted(totals.items()):
+			print('  %-32s %6d  %s' % (bank, sum(s for _, s in sections),
+				' '.join('%s:%d' % (n, s) for n, s in sections)))
+
+		hand_placed = [i for i in inputs if i[0] in placed and i[2]]
+		if not hand_placed:
+			print('  nothing in %s' % ' or '.join(placed))
+		for section, address, size, source in hand_placed:
+			print('  %-9s 0x%08x %5d  %-13s %s' % (section, address, size, bank_of(address), source.split('/')[-1]))
+
+		if args.objects:
+			sizes = object_sizes(inputs, discarded)
+			print('  %-40s %6s %8s' % ('code and rodata by object', 'linked', 'dropped'))
+			for source, (kept, dropped) in sorted(sizes.items(), key=lambda i: -i[1][0]):
+				print('  %-40s %6d %8d' % (source[:40], kept, dropped))
+			print('  %-40s %6d %8d' % ('total', sum(s[0] for s in sizes.values()), sum(s[1] for s in sizes.values())))
+		print()
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+#
+# This file is part of PortaPack.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+# Drives a PortaPack over its USB serial port (the "USB remote control" UI
+# setting; see application/remote_control.hpp). Sends each command, from
+# the arguments or stdin a line at a time, and prints its reply. With
+# --packets, turns packet forwarding on and appends the binary log records
+# that arrive to a file (as the .BIN logs, for decode_log.py) until
+# interrupted. Needs pyserial.
+#
+#   remote.py /dev/ttyACM0 "app ais" "freq 162025000" --packets AIS.BIN
+#
+# "wait" isn't sent: it polls stats until a synthetic source's stream has
+# ended, and prints the last, for benchmarks on repeatable input:
+#
+#   remote.py /dev/ttyACM0 "app ert" "source ook pattern=... baud=32768 secs=10" wait
+
+import argparse
+import sys
+import time
+
+import serial
+
+from decode_log import header, sync
+
+class Remote:
+	def __init__(self, port, packets=None):
+		self.port = serial.Serial(port, timeout=1)
+		self.packets = packets
+
+	def read_record(self, first):
+		rest = self.port.read(header.size - 1)
+		_, _, count, _, _ = header.unpack(first + rest)
+		record = first + rest + self.port.read((count + 7) // 8)
+		if self.packets:
+			self.packets.write(record)
+			self.packets.flush()
+
+	def read_line(self):
+		# Records can arrive between replies; they're set apart by their sync.
+		line = b''
+		while True:
+			c = self.port.read(1)
+			if not c:
+				return None
+			if not line and c[0] == sync:
+				self.read_record(c)
+			elif c == b'\n':
+				return line.rstrip(b'\r').decode('ascii', 'replace')
+			else:
+				line += c
+
+	def command(self, text):
+		self.port.write(text.encode('ascii') + b'\r\n')
+		while True:
+			line = self.read_line()
+			if line is None:
+				return 'ERR no reply'
+			if line.startswith('OK') or line.startswith('ERR'):
+				return line
+
+	def wait_ended(self):
+		while True:
+			reply = self.command('stats')
+			if reply.startswith('ERR') or ' ended=1' in reply:
+				return reply
+			time.sleep(0.5)
+
+def main():
+	parser = argparse.ArgumentParser(description='Send commands to a PortaPack over USB serial.')
+	parser.add_argument('port', help='serial port, e.g. /dev/ttyACM0 or COM3')
+	parser.add_argument('commands', nargs='*', help='commands, or stdin if none')
+	parser.add_argument('--packets', type=argparse.FileType('ab'), help='append forwarded records to this file')
+	args = parser.parse_args()
+
+	remote = Remote(args.port, args.packets)
+	failed = False
+	for text in (args.commands or (l.strip() for l in sys.stdin)):
+		if text:
+			reply = remote.wait_ended() if text == 'wait' else remote.command(text)
+			print(reply)
+			failed |= reply.startswith('ERR')
+
+	if args.packets:
+		print(remote.command('packets on'))
+		try:
+			while True:
+				remote.read_line()
+		except KeyboardInterrupt:
+			remote.command('packets off')
+
+	sys.exit(1 if failed else 0)
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+#
+# This file is part of PortaPack.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+# Renders spectrum logs (SPECTRUM.BIN from the Analog audio app in SPEC mode,
+# SWEEP.BIN from Search) as a waterfall image, one line per row or sweep,
+# oldest at the top. Slices of a sweep are stitched by frequency.
+#
+# Records are LogRecordHeader in application/log_file.hpp with type 5, their
+# payload SpectrumLogRow in application/spectrum_log.hpp, little-endian:
+#   uint8 encoding, uint8 slice, uint8 slice_count, uint8 reserved,
+#   uint16 bins, uint16 reserved, uint32 bin_width, uint32 sequence,
+#   then the row, raw or delta coded.
+
+import argparse
+import struct
+import sys
+
+from decode_log import header, sync, timestamp
+
+spectrum_type = 5
+row_header = struct.Struct('<BBBBHHII')
+
+def delta_decode(data, bins):
+	nibbles = [n for b in data for n in (b >> 4, b & 0xf)]
+	values = []
+	previous = 0
+	i = 0
+	while len(values) < bins:
+		n = nibbles[i]
+		if n == 0x8:
+			previous = (nibbles[i + 1] << 4) | nibbles[i + 2]
+			i += 3
+		else:
+			previous += n - 16 if n & 0x8 else n
+			i += 1
+		values.append(previous)
+	return values
+
+def rows(data):
+	offset = 0
+	while offset + header.size <= len(data):
+		if data[offset] != sync:
+			offset += 1
+			continue
+		_, type_id, count, packed, tag = header.unpack_from(data, offset)
+		length = (count + 7) // 8
+		payload = data[offset + header.size:offset + header.size + length]
+		offset += header.size + length
+		if len(payload) < length:
+			break
+		if (type_id != spectrum_type) or (len(payload) < row_header.size):
+			continue
+
+		encoding, slice_index, slice_count, _, bins, _, bin_width, sequence = row_header.unpack_from(payload)
+		body = payload[row_header.size:]
+		values = list(body[:bins]) if encoding == 0 else delta_decode(body, bins)
+		yield {
+			'timestamp': timestamp(packed),
+			'sequence': sequence,
+			'slice': slice_index,
+			'slice_count': slice_count,
+			'first': tag * 1000 - (bins // 2) * bin_width,
+			'bin_width': bin_width,
+			'db': values,
+		}
+
+def dbfs(value):
+	return (value - 255) / 5.0
+
+def lines(records):
+	# A line per channel row, or per sweep (consecutive slices sharing a sequence).
+	line = []
+	for record in records:
+		if line and ((record['sequence'] != line[0]['sequence']) or (record['slice'] == 0)):
+			yield line
+			line = []
+		line.append(record)
+	if line:
+		yield line
+
+def main():
+	parser = argparse.ArgumentParser(description='Render PortaPack spectrum logs as a waterfall image.')
+	parser.add_argument('log', type=argparse.FileType('rb'))
+	parser.add_argument('output', help='PGM image to write, or - with --csv')
+	parser.add_argument('--width', type=int, default=1024, help='maximum image width')
+	parser.add_argument('--csv', action='store_true', help='write timestamp,frequency,dBFS rows instead')
+	args = parser.parse_args()
+
+	records = list(rows(args.log.read()))
+	if not records:
+		sys.exit('no spectrum rows')
+
+	if args.csv:
+		out = sys.stdout if args.output == '-' else open(args.output, 'w')
+		out.write('timestamp,sequence,frequency,dbfs\n')
+		for r in records:
+			for i, v in enumerate(r['db']):
+				out.write('%s,%d,%d,%.1f\n' % (r['timestamp'], r['sequence'], r['first'] + i * r['bin_width'], dbfs(v)))
+		return
+
+	f_min = min(r['first'] for r in records)
+	f_max = max(r['first'] + len(r['db']) * r['bin_width'] for r in records)
+	step = max(min(r['bin_width'] for r in records), (f_max - f_min + args.width - 1) // args.width)
+	width = max(1, (f_max - f_min) // step)
+
+	image = []
+	for line in lines(records):
+		pixels = [0] * width
+		for r in line:
+			for i, v in enumerate(r['db']):
+				x = (r['first'] + i * r['bin_width'] - f_min) // step
+				if 0 <= x < width:
+					pixels[x] = max(pixels[x], v)
+		image.append(bytes(pixels))
+
+	with open(args.output, 'wb') as out:
+		out.write(b'P5\n%d %d\n255\n' % (width, len(image)))
+		for line in image:
+			out.write(line)
+
+	print('%d lines, %.3f to %.3f MHz, %d Hz per pixel' % (len(image), f_min / 1e6, f_max / 1e6, step))
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+#
+# This file is part of PortaPack.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+# Converts a trace dump (Debug > Trace > Dump, TRC_????.TRC) to Chrome trace
+# JSON, for chrome://tracing or ui.perfetto.dev. Process 0 is the M0
+# (application), 1 the M4 (baseband).
+#
+# File layout, as trace::FileHeader and trace::Record in
+# application/trace_file.hpp and common/trace.hpp, little-endian:
+#   uint32 magic ("PTRC"), version, timer_frequency, now,
+#   m0 record count, m4 record count, then the records, oldest first:
+#   uint32 timestamp, uint8 event, uint8 phase, uint16 reserved,
+#   uint32 arg0, uint32 arg1.
+#
+# Timestamps are a 32-bit count at timer_frequency, which wraps (about 21s at
+# 204MHz): times are taken back from now, so only the last wrap is right.
+
+import argparse
+import json
+import struct
+import sys
+
+header = struct.Struct('<IIIIII')
+record = struct.Struct('<IBBHII')
+
+magic = 0x43525450
+version = 1
+
+# trace::Event: name, arg0 name, thread. Threads are separate tracks, as
+# their begin/end pairs interleave.
+events = {
+	0: ('M0 dispatch', 'events', 0),
+	1: ('Paint', 'start_us', 0),
+	2: ('Retune', 'precomputed', 0),
+	3: ('Capture write', 'bytes', 1),
+	4: ('M4 dispatch', 'events', 0),
+	5: ('Baseband', 'sample_index', 1),
+	6: ('Overrun', 'dropped', 1),
+}
+
+threads = {
+	(0, 0): 'Event loop', (0, 1): 'Capture',
+	(1, 0): 'Event loop', (1, 1): 'Baseband',
+}
+
+# trace::Phase
+phases = { 0: 'B', 1: 'E', 2: 'i', 3: 'X' }
+
+def read_trace(data):
+	if len(data) < header.size:
+		sys.exit('too short for a trace')
+	file_magic, file_version, frequency, now, m0_count, m4_count = header.unpack_from(data)
+	if (file_magic != magic) or (file_version != version):
+		sys.exit('not a version %d trace' % version)
+	if len(data) < header.size + (m0_count + m4_count) * record.size:
+		sys.exit('truncated: %d M0 and %d M4 records expected' % (m0_count, m4_count))
+
+	def us_before_now(ticks):
+		return -((now - ticks) & 0xffffffff) * 1e6 / frequency
+
+	trace_events = []
+	offset = header.size
+	for pid, count in ((0, m0_count), (1, m4_count)):
+		for _ in range(count):
+			timestamp, event, phase, _, arg0, arg1 = record.unpack_from(data, offset)
+			offset += record.size
+
+			name, arg0_name, tid = events.get(event, ('Event %d' % event, 'arg0', 0))
+			entry = {
+				'name': name,
+				'ph': phases.get(phase, 'i'),
+				'ts': us_before_now(timestamp),
+				'pid': pid,
+				'tid': tid,
+			}
+			if phase != 1:
+				entry['args'] = { arg0_name: arg0 }
+			if phase == 2:
+				entry['s'] = 't'
+			if phase == 3:
+				entry['dur'] = arg1 * 1e6 / frequency
+			trace_events.append(entry)
+
+	for pid, name in ((0, 'M0 application'), (1, 'M4 baseband')):
+		trace_events.append({ 'name': 'process_name', 'ph': 'M', 'pid': pid, 'args': { 'name': name } })
+	for (pid, tid), name in threads.items():
+		trace_events.append({ 'name': 'thread_name', 'ph': 'M', 'pid': pid, 'tid': tid, 'args': { 'name': name } })
+
+	return trace_events
+
+def main():
+	parser = argparse.ArgumentParser(description='Convert a PortaPack trace dump to Chrome trace JSON.')
+	parser.add_argument('trace', type=argparse.FileType('rb'))
+	parser.add_argument('-o', '--output', type=argparse.FileType('w'), default=sys.stdout)
+	args = parser.parse_args()
+
+	trace_events = read_trace(args.trace.read())
+	json.dump({ 'traceEvents': trace_events, 'displayTimeUnit': 'ms' }, args.output, indent=1)
+	args.output.write('\n')
+
+if __name__ == '__main__':
+	main()
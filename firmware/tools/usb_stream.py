@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+#
+# This file is part of PortaPack.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+
+# Reads a PortaPack capture stream (Capture app, destination USB) from the
+# device's bulk endpoint into a file, or stdout with -. The samples are as
+# the Capture app's format and decimation were set: C16, C8 or RIQ, at the
+# shown rate divided by the decimation. Needs pyusb.
+#
+# The device enumerates as 1209:0001, the pid.codes test PID, while USB is
+# selected; see application/usb_stream.hpp.
+
+import argparse
+import sys
+import time
+
+import usb.core
+
+vendor_id = 0x1209
+product_id = 0x0001
+endpoint = 0x81
+# Transfers shorter than a read are lost on timeout, so no bigger than the
+# Capture app's buffers.
+read_size = 16384
+
+def main():
+	parser = argparse.ArgumentParser(description='Read a PortaPack USB capture stream.')
+	parser.add_argument('output', help='file to write, or - for stdout')
+	parser.add_argument('--seconds', type=float, default=0, help='stop after this long, 0 to run until interrupted')
+	args = parser.parse_args()
+
+	device = usb.core.find(idVendor=vendor_id, idProduct=product_id)
+	if device is None:
+		sys.exit('no PortaPack stream device, is the Capture app set to USB?')
+	device.set_configuration()
+
+	out = sys.stdout.buffer if args.output == '-' else open(args.output, 'wb')
+	total = 0
+	start = time.monotonic()
+	try:
+		while (args.seconds == 0) or ((time.monotonic() - start) < args.seconds):
+			try:
+				data = device.read(endpoint, read_size, timeout=1000)
+			except usb.core.USBTimeoutError:
+				# Not recording yet, or stopped.
+				continue
+			out.write(data)
+			total += len(data)
+	except KeyboardInterrupt:
+		pass
+
+	elapsed = time.monotonic() - start
+	sys.stderr.write('%d bytes in %.1fs, %.0f kB/s\n' % (total, elapsed, total / elapsed / 1000 if elapsed else 0))
+
+if __name__ == '__main__':
+	main()
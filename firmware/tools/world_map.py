@@ -18,31 +18,62 @@
 # Boston, MA 02110-1301, USA.
 #
 
+# Writes a tiled world_map.bin, see GeoMap::map_header_t:
+#   "PPMT", version, tile_size, level_count, reserved (uint16 each)
+#   per level: width, height (uint16), offset of first tile (uint32)
+#   padding up to one sector, then 16x16 RGB565 tiles row by row.
+# Tiles are exactly one 512 byte sector, each visible row of tiles is a
+# single sequential read on the PortaPack.
+# Level 0 is the full image, each following level halves it, down to the
+# first level that fits the screen width (GeoMap uses at most 8 levels).
+
 from __future__ import print_function
 import sys
 import struct
 from PIL import Image
 
-outfile = open('../../sdcard/world_map.bin', 'wb')
-
-im = Image.open("../../sdcard/world_map.jpg")
-pix = im.load()
-
-outfile.write(struct.pack('H', im.size[0]))
-outfile.write(struct.pack('H', im.size[1]))
-
-for y in range (0, im.size[1]):
-	line = ''
-	for x in range (0, im.size[0]):
-		# RRRRRGGGGGGBBBBB
-		#pixel_lcd = (pix[x, y][0] >> 3) << 11
-		#pixel_lcd |= (pix[x, y][1] >> 2) << 5
-		#pixel_lcd |= (pix[x, y][2] >> 3)
-		#         RRRGGGBB to
-		# RRR00GGG000BB000
-		pixel_lcd = (pix[x, y][0] >> 5) << 5
-		pixel_lcd |= (pix[x, y][1] >> 5) << 2
-		pixel_lcd |= (pix[x, y][2] >> 6)
-		line += struct.pack('B', pixel_lcd)
-	outfile.write(line)
-	print(str(y) + '/' + str(im.size[1]) + '\r', end="")
+TILE_SIZE = 16
+SECTOR_SIZE = 512
+LEVELS_MAX = 8
+SCREEN_WIDTH = 240
+
+Image.MAX_IMAGE_PIXELS = None
+
+outfile = open('../../sdcard/ADSB/world_map.bin', 'wb')
+
+im = Image.open("../../sdcard/ADSB/world_map.jpg").convert('RGB')
+
+levels = [im]
+while (levels[-1].size[0] > SCREEN_WIDTH) and (len(levels) < LEVELS_MAX):
+	prev = levels[-1]
+	levels.append(prev.resize((prev.size[0] // 2, prev.size[1] // 2), Image.LANCZOS))
+
+def tile_count(level):
+	tiles_x = (level.size[0] + TILE_SIZE - 1) // TILE_SIZE
+	tiles_y = (level.size[1] + TILE_SIZE - 1) // TILE_SIZE
+	return tiles_x, tiles_y
+
+header = struct.pack('<4sHHHH', b'PPMT', 1, TILE_SIZE, len(levels), 0)
+offset = SECTOR_SIZE
+for level in levels:
+	header += struct.pack('<HHI', level.size[0], level.size[1], offset)
+	tiles_x, tiles_y = tile_count(level)
+	offset += tiles_x * tiles_y * TILE_SIZE * TILE_SIZE * 2
+outfile.write(header.ljust(SECTOR_SIZE, b'\0'))
+
+for n, level in enumerate(levels):
+	tiles_x, tiles_y = tile_count(level)
+	for ty in range(0, tiles_y):
+		for tx in range(0, tiles_x):
+			# Crop pads edge tiles with black
+			tile = level.crop((tx * TILE_SIZE, ty * TILE_SIZE, (tx + 1) * TILE_SIZE, (ty + 1) * TILE_SIZE))
+			data = b''
+			for pix in tile.getdata():
+				# RRRRRGGGGGGBBBBB
+				pixel_lcd = (pix[0] >> 3) << 11
+				pixel_lcd |= (pix[1] >> 2) << 5
+				pixel_lcd |= (pix[2] >> 3)
+				data += struct.pack('<H', pixel_lcd)
+			outfile.write(data)
+		print('Level ' + str(n) + ': ' + str(ty) + '/' + str(tiles_y) + '\r', end="")
+	print('')
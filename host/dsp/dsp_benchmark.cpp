@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Workstation counterpart of the PBEN baseband image: the same kernels on
+ * the same synthetic buffers, timed with the host clock. Relative costs
+ * track the M4 only loosely (the intrinsics are emulated), so use this to
+ * iterate on a change and check its output, and PBEN for the numbers.
+ *
+ *   dsp_benchmark [capture.C16]
+ *
+ * A capture (interleaved complex int16, as the Capture app records)
+ * replaces the synthetic complex16 input; its top bytes feed the complex8
+ * kernels.
+ */
+
+#include "dsp_decimate.hpp"
+#include "dsp_demodulate.hpp"
+#include "dsp_resample.hpp"
+#include "dsp_fft.hpp"
+#include "dsp_fir_taps.hpp"
+#include "matched_filter.hpp"
+#include "clock_recovery.hpp"
+#include "audio_compressor.hpp"
+#include "fxpt_atan2.hpp"
+#include "ais_baseband.hpp"
+#include "sine_table.hpp"
+
+#include <array>
+#include <chrono>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+
+namespace {
+
+std::array<complex8_t, 2048> c8_in { };
+std::array<complex16_t, 1024> c16_in { };
+std::array<complex16_t, 1024> c16_out { };
+std::array<int16_t, 512> s16_in { };
+std::array<int16_t, 512> s16_out { };
+std::array<float, 256> f32 { };
+std::array<std::complex<float>, 256> fft { };
+
+void fill_synthetic() {
+	uint32_t phase = 0;
+	uint32_t noise = 1;
+	for(auto& s : c8_in) {
+		noise = noise * 1664525 + 1013904223;
+		const int8_t n = static_cast<int8_t>(noise >> 24) >> 4;
+		s = {
+			static_cast<int8_t>(sine_table_f32[(phase + 0x40000000) >> 24] * 100.0f + n),
+			static_cast<int8_t>(sine_table_f32[phase >> 24] * 100.0f + n)
+		};
+		phase += 0x01234567;
+	}
+
+	phase = 0;
+	for(size_t i=0; i<c16_in.size(); i++) {
+		c16_in[i] = {
+			static_cast<int16_t>(sine_table_f32[(phase + 0x40000000) >> 24] * 32767.0f),
+			static_cast<int16_t>(sine_table_f32[phase >> 24] * 32767.0f)
+		};
+		phase += i * (0x80000000U / c16_in.size());
+	}
+}
+
+bool fill_capture(const char* const path) {
+	auto f = std::fopen(path, "rb");
+	if( !f ) {
+		return false;
+	}
+	const auto n = std::fread(c16_in.data(), sizeof(complex16_t), c16_in.size(), f);
+	std::fclose(f);
+	if( n != c16_in.size() ) {
+		return false;
+	}
+
+	for(size_t i=0; i<c8_in.size(); i++) {
+		const auto s = c16_in[i % c16_in.size()];
+		c8_in[i] = { static_cast<int8_t>(s.real() >> 8), static_cast<int8_t>(s.imag() >> 8) };
+	}
+	return true;
+}
+
+void run(const char* const name, const size_t samples, const std::function<void()>& kernel) {
+	constexpr size_t runs = 2000;
+
+	using clock = std::chrono::steady_clock;
+	auto best = clock::duration::max();
+	const auto t_begin = clock::now();
+	for(size_t n=0; n<runs; n++) {
+		const auto t_start = clock::now();
+		kernel();
+		best = std::min(best, clock::now() - t_start);
+	}
+	const auto total = clock::now() - t_begin;
+
+	const double best_ns = std::chrono::duration<double, std::nano>(best).count() / samples;
+	const double mean_ns = std::chrono::duration<double, std::nano>(total).count() / (runs * samples);
+	std::printf("%-8s %8.2f %8.2f %10.2f\n", name, best_ns, mean_ns, 1000.0 / mean_ns);
+}
+
+} /* namespace */
+
+int main(int argc, char* argv[]) {
+	fill_synthetic();
+	if( (argc > 1) && !fill_capture(argv[1]) ) {
+		std::fprintf(stderr, "%s: can't read %zu samples\n", argv[1], c16_in.size());
+		return 1;
+	}
+
+	for(size_t i=0; i<s16_in.size(); i++) {
+		s16_in[i] = c16_in[i].real();
+	}
+	for(size_t i=0; i<f32.size(); i++) {
+		f32[i] = ((c8_in[i / 4].real() >= 0) ? 0.01f : -0.01f);
+	}
+
+	dsp::decimate::Complex8DecimateBy2CIC3 c8_cic3;
+	dsp::decimate::TranslateByFSOver4AndDecimateBy2CIC3 c8_fs4_cic3;
+	dsp::decimate::DecimateBy2CIC3 c16_cic3;
+	dsp::decimate::FIR64AndDecimateBy2Real fir64_real;
+	dsp::decimate::FIRC8xR16x24FS4Decim4 fir_c8_decim4;
+	dsp::decimate::FIRC8xR16x24FS4Decim8 fir_c8_decim8;
+	dsp::decimate::FIRC16xR16x16Decim2 fir_c16_decim2;
+	dsp::decimate::FIRC16xR16x32Decim8 fir_c16_decim8;
+	dsp::decimate::FIRAndDecimateComplex fir_complex;
+	dsp::decimate::DecimateBy2CIC4Real cic4_real;
+
+	fir_c8_decim4.configure(taps_11k0_decim_0.taps, 33554432);
+	fir_c8_decim8.configure(taps_11k0_decim_0.taps, 33554432);
+	fir_c16_decim2.configure(taps_200k_decim_1.taps, 131072);
+	fir_c16_decim8.configure(taps_11k0_decim_1.taps, 131072);
+	fir_complex.configure(taps_11k0_channel.taps, 2);
+	fir64_real.configure(taps_64_lp_025_025.taps);
+
+	static constexpr auto resampler_taps = dsp::resample::design<32, 16>(0.45 * 38400 / 48000);
+	dsp::resample::PolyphaseResampler<32, 16> resampler { resampler_taps };
+	resampler.configure(48000, 38400);
+
+	dsp::matched_filter::MatchedFilter mf { baseband::ais::square_taps_38k4_1t_p, 2 };
+	dsp::matched_filter::MatchedFilterQ15<baseband::ais::square_taps_38k4_1t_p.size()> mf_q15 { baseband::ais::square_taps_38k4_1t_p, 2 };
+
+	size_t symbols = 0;
+	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery {
+		38400, 9600, { 0.0555f },
+		[&symbols](const float) { symbols++; }
+	};
+
+	dsp::demodulate::FM fm_fast;
+	dsp::demodulate::FM fm_precise;
+	fm_fast.configure(2, 1, dsp::demodulate::FM::Precision::Fast);
+	fm_precise.configure(2, 1, dsp::demodulate::FM::Precision::Precise);
+
+	FeedForwardCompressor compressor;
+	CompressorQ15 compressor_q15;
+	compressor_q15.configure({ -30.0f, 10.0f, 27.0f, -0.5f, 0.300f }, 12000);
+
+	const buffer_c8_t c8 { c8_in.data(), c8_in.size() };
+	const buffer_c16_t c16 { c16_in.data(), c16_in.size() };
+	const buffer_c16_t c16_256 { c16_in.data(), 256 };
+	const buffer_c16_t c16_dst { c16_out.data(), c16_out.size() };
+	const buffer_s16_t s16 { s16_in.data(), s16_in.size() };
+	const buffer_s16_t s16_dst { s16_out.data(), s16_out.size() };
+	const buffer_s16_t s16_dst_256 { s16_out.data(), 256 };
+	const buffer_f32_t f32_buffer { f32.data(), f32.size() };
+
+	std::printf("%-8s %8s %8s %10s\n", "kernel", "best ns", "mean ns", "Msamples/s");
+
+	run("c8cic3", c8.count, [&]() { c8_cic3.execute(c8, c16_dst); });
+	run("fs4cic3", c8.count, [&]() { c8_fs4_cic3.execute(c8, c16_dst); });
+	run("c8dec4", c8.count, [&]() { fir_c8_decim4.execute(c8, c16_dst); });
+	run("c8dec8", c8.count, [&]() { fir_c8_decim8.execute(c8, c16_dst); });
+	run("dec64", c8.count, [&]() { dsp::decimate::execute_decim_64(fir_c8_decim8, fir_c16_decim8, c8, c16_dst); });
+	run("c16cic3", c16.count, [&]() { c16_cic3.execute(c16, c16_dst); });
+	run("c16dec2", c16.count, [&]() { fir_c16_decim2.execute(c16, c16_dst); });
+	run("c16dec8", c16.count, [&]() { fir_c16_decim8.execute(c16, c16_dst); });
+	run("firc", c16.count, [&]() { fir_complex.execute(c16, c16_dst); });
+	run("resamp", c16.count, [&]() { resampler.execute(c16, c16_dst); });
+	run("fir64r", s16.count, [&]() { fir64_real.execute(s16, s16_dst); });
+	run("cic4r", s16.count, [&]() { cic4_real.execute(s16, s16_dst); });
+	run("mf", 256, [&]() {
+		for(size_t i=0; i<256; i++) {
+			mf.execute_once({ static_cast<float>(c16_in[i].real()), static_cast<float>(c16_in[i].imag()) });
+		}
+	});
+	run("mf q15", 256, [&]() {
+		for(size_t i=0; i<256; i++) {
+			mf_q15.execute_once(c16_in[i]);
+		}
+	});
+	run("clkrec", f32.size(), [&]() { clock_recovery.execute(f32_buffer); });
+	run("fft256", fft.size(), [&]() {
+		fft_swap(c16_256, fft);
+		fft_c_preswapped(fft, 0, 8);
+	});
+	run("atan2", 256, [&]() {
+		for(size_t i=0; i<256; i++) {
+			s16_out[i] = fxpt_atan2(c16_in[i].imag(), c16_in[i].real());
+		}
+	});
+	run("comp", f32.size(), [&]() { compressor.execute_in_place(f32_buffer); });
+	run("comp q15", s16_dst_256.count, [&]() { compressor_q15.execute_in_place(s16_dst_256); });
+	run("fm s16f", 256, [&]() { fm_fast.execute(c16_256, s16_dst_256); });
+	run("fm s16p", 256, [&]() { fm_precise.execute(c16_256, s16_dst_256); });
+	run("fm f32f", 256, [&]() { fm_fast.execute(c16_256, f32_buffer); });
+	run("fm f32p", 256, [&]() { fm_precise.execute(c16_256, f32_buffer); });
+
+	return 0;
+}
@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Stands in for ChibiOS' hal.h when building the baseband DSP sources on a
+ * workstation. Only the Cortex-M4 intrinsics (CMSIS core_cm4_simd.h plus the
+ * additions in lpc43xx_m4.h) are provided, as plain C++ with the same
+ * results bit for bit, wrapping or saturating as the instruction does.
+ */
+
+#ifndef __HOST_HAL_H__
+#define __HOST_HAL_H__
+
+#include <cstdint>
+
+#define __STATIC_INLINE static inline
+
+#define __SIMD32_TYPE int32_t
+#define __SIMD32(addr)  (*(__SIMD32_TYPE **) & (addr))
+#define _SIMD32_OFFSET(addr) (*(__SIMD32_TYPE *) (addr))
+
+namespace host_simd {
+
+inline int32_t lo(const uint32_t x) { return static_cast<int16_t>(x & 0xffff); }
+inline int32_t hi(const uint32_t x) { return static_cast<int16_t>(x >> 16); }
+
+inline uint32_t pack(const int32_t h, const int32_t l) {
+	return (static_cast<uint32_t>(h) << 16) | (static_cast<uint32_t>(l) & 0xffff);
+}
+
+inline uint32_t ror(const uint32_t x, const uint32_t n) {
+	return n ? ((x >> n) | (x << (32 - n))) : x;
+}
+
+inline int32_t wrap(const int64_t x) {
+	return static_cast<int32_t>(static_cast<uint32_t>(x));
+}
+
+inline int32_t sat(const int64_t x, const uint32_t bits) {
+	const int64_t max = (int64_t(1) << (bits - 1)) - 1;
+	const int64_t min = -(int64_t(1) << (bits - 1));
+	return static_cast<int32_t>((x > max) ? max : ((x < min) ? min : x));
+}
+
+} /* namespace host_simd */
+
+/* Saturation ***********************************************************/
+
+__STATIC_INLINE int32_t __SSAT(const int32_t x, const uint32_t bits) {
+	return host_simd::sat(x, bits);
+}
+
+__STATIC_INLINE uint32_t __USAT(const int32_t x, const uint32_t bits) {
+	const int32_t max = (1 << bits) - 1;
+	return (x < 0) ? 0 : ((x > max) ? max : x);
+}
+
+__STATIC_INLINE int32_t __QADD(const int32_t a, const int32_t b) {
+	return host_simd::sat(int64_t(a) + b, 32);
+}
+
+__STATIC_INLINE int32_t __QSUB(const int32_t a, const int32_t b) {
+	return host_simd::sat(int64_t(a) - b, 32);
+}
+
+/* Parallel halfword add/subtract ***************************************/
+
+__STATIC_INLINE uint32_t __QADD16(const uint32_t x, const uint32_t y) {
+	using namespace host_simd;
+	return pack(sat(hi(x) + hi(y), 16), sat(lo(x) + lo(y), 16));
+}
+
+__STATIC_INLINE uint32_t __QSUB16(const uint32_t x, const uint32_t y) {
+	using namespace host_simd;
+	return pack(sat(hi(x) - hi(y), 16), sat(lo(x) - lo(y), 16));
+}
+
+__STATIC_INLINE uint32_t __SHADD16(const uint32_t x, const uint32_t y) {
+	using namespace host_simd;
+	return pack((hi(x) + hi(y)) >> 1, (lo(x) + lo(y)) >> 1);
+}
+
+__STATIC_INLINE uint32_t __SHSUB16(const uint32_t x, const uint32_t y) {
+	using namespace host_simd;
+	return pack((hi(x) - hi(y)) >> 1, (lo(x) - lo(y)) >> 1);
+}
+
+__STATIC_INLINE uint32_t __SHASX(const uint32_t x, const uint32_t y) {
+	using namespace host_simd;
+	return pack((hi(x) + lo(y)) >> 1, (lo(x) - hi(y)) >> 1);
+}
+
+__STATIC_INLINE uint32_t __SHSAX(const uint32_t x, const uint32_t y) {
+	using namespace host_simd;
+	return pack((hi(x) - lo(y)) >> 1, (lo(x) + hi(y)) >> 1);
+}
+
+/* Dual 16 bit multiplies ***********************************************/
+
+__STATIC_INLINE uint32_t __SMUAD(const uint32_t x, const uint32_t y) {
+	using namespace host_simd;
+	return wrap(int64_t(lo(x)) * lo(y) + int64_t(hi(x)) * hi(y));
+}
+
+__STATIC_INLINE uint32_t __SMUADX(const uint32_t x, const uint32_t y) {
+	using namespace host_simd;
+	return wrap(int64_t(lo(x)) * hi(y) + int64_t(hi(x)) * lo(y));
+}
+
+__STATIC_INLINE uint32_t __SMUSD(const uint32_t x, const uint32_t y) {
+	using namespace host_simd;
+	return wrap(int64_t(lo(x)) * lo(y) - int64_t(hi(x)) * hi(y));
+}
+
+__STATIC_INLINE uint32_t __SMUSDX(const uint32_t x, const uint32_t y) {
+	using namespace host_simd;
+	return wrap(int64_t(lo(x)) * hi(y) - int64_t(hi(x)) * lo(y));
+}
+
+__STATIC_INLINE uint32_t __SMLAD(const uint32_t x, const uint32_t y, const uint32_t acc) {
+	return __SMUAD(x, y) + acc;
+}
+
+__STATIC_INLINE uint32_t __SMLADX(const uint32_t x, const uint32_t y, const uint32_t acc) {
+	return __SMUADX(x, y) + acc;
+}
+
+__STATIC_INLINE uint32_t __SMLSD(const uint32_t x, const uint32_t y, const uint32_t acc) {
+	return __SMUSD(x, y) + acc;
+}
+
+__STATIC_INLINE uint32_t __SMLSDX(const uint32_t x, const uint32_t y, const uint32_t acc) {
+	return __SMUSDX(x, y) + acc;
+}
+
+__STATIC_INLINE uint64_t __SMLALD(const uint32_t x, const uint32_t y, const uint64_t acc) {
+	using namespace host_simd;
+	return acc + int64_t(lo(x)) * lo(y) + int64_t(hi(x)) * hi(y);
+}
+
+__STATIC_INLINE uint64_t __SMLALDX(const uint32_t x, const uint32_t y, const uint64_t acc) {
+	using namespace host_simd;
+	return acc + int64_t(lo(x)) * hi(y) + int64_t(hi(x)) * lo(y);
+}
+
+__STATIC_INLINE uint64_t __SMLSLD(const uint32_t x, const uint32_t y, const uint64_t acc) {
+	using namespace host_simd;
+	return acc + int64_t(lo(x)) * lo(y) - int64_t(hi(x)) * hi(y);
+}
+
+__STATIC_INLINE uint64_t __SMLSLDX(const uint32_t x, const uint32_t y, const uint64_t acc) {
+	using namespace host_simd;
+	return acc + int64_t(lo(x)) * hi(y) - int64_t(hi(x)) * lo(y);
+}
+
+/* Single 16 bit multiplies, B(ottom) or T(op) half of each operand *****/
+
+__STATIC_INLINE int32_t __SMULBB(const uint32_t op1, const uint32_t op2) {
+	return host_simd::lo(op1) * host_simd::lo(op2);
+}
+
+__STATIC_INLINE int32_t __SMULBT(const uint32_t op1, const uint32_t op2) {
+	return host_simd::lo(op1) * host_simd::hi(op2);
+}
+
+__STATIC_INLINE int32_t __SMULTB(const uint32_t op1, const uint32_t op2) {
+	return host_simd::hi(op1) * host_simd::lo(op2);
+}
+
+__STATIC_INLINE int32_t __SMULTT(const uint32_t op1, const uint32_t op2) {
+	return host_simd::hi(op1) * host_simd::hi(op2);
+}
+
+__STATIC_INLINE int32_t __SMLABB(const uint32_t rm, const uint32_t rs, const uint32_t rn) {
+	return host_simd::wrap(int64_t(host_simd::lo(rm)) * host_simd::lo(rs) + int32_t(rn));
+}
+
+__STATIC_INLINE int32_t __SMLATB(const uint32_t rm, const uint32_t rs, const uint32_t rn) {
+	return host_simd::wrap(int64_t(host_simd::hi(rm)) * host_simd::lo(rs) + int32_t(rn));
+}
+
+__STATIC_INLINE int32_t __SMMULR(const int32_t op1, const int32_t op2) {
+	return static_cast<int32_t>((int64_t(op1) * op2 + 0x80000000LL) >> 32);
+}
+
+/* Packing, extension and bit manipulation ******************************/
+
+__STATIC_INLINE uint32_t __PKHBT(const uint32_t a, const uint32_t b, const uint32_t shift) {
+	return (a & 0x0000ffff) | ((b << shift) & 0xffff0000);
+}
+
+__STATIC_INLINE uint32_t __PKHTB(const uint32_t a, const uint32_t b, const uint32_t shift) {
+	return (a & 0xffff0000) | ((static_cast<int32_t>(b) >> shift) & 0x0000ffff);
+}
+
+__STATIC_INLINE int32_t __SXTB16(const uint32_t rm, const uint32_t ror = 0) {
+	const uint32_t x = host_simd::ror(rm, ror);
+	return host_simd::pack(static_cast<int8_t>(x >> 16), static_cast<int8_t>(x));
+}
+
+__STATIC_INLINE int32_t __SXTH(const uint32_t rm, const uint32_t ror) {
+	return static_cast<int16_t>(host_simd::ror(rm, ror));
+}
+
+__STATIC_INLINE int32_t __SXTAH(const uint32_t rn, const uint32_t rm, const uint32_t ror) {
+	return rn + static_cast<int16_t>(host_simd::ror(rm, ror));
+}
+
+__STATIC_INLINE uint32_t __BFI(const uint32_t rd, const uint32_t rn, const uint32_t lsb, const uint32_t width) {
+	const uint32_t mask = ((width >= 32) ? 0xffffffffU : ((1U << width) - 1)) << lsb;
+	return (rd & ~mask) | ((rn << lsb) & mask);
+}
+
+__STATIC_INLINE uint32_t __RBIT(uint32_t x) {
+	uint32_t r = 0;
+	for(int i=0; i<32; i++) {
+		r = (r << 1) | (x & 1);
+		x >>= 1;
+	}
+	return r;
+}
+
+__STATIC_INLINE uint32_t __REV16(const uint32_t x) {
+	return ((x & 0x00ff00ff) << 8) | ((x >> 8) & 0x00ff00ff);
+}
+
+__STATIC_INLINE uint32_t __CLZ(const uint32_t x) {
+	return x ? __builtin_clz(x) : 32;
+}
+
+#endif/*__HOST_HAL_H__*/
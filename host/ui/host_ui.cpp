@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* What the application's portapack.cpp, rtc_time.cpp and event_m0.cpp
+ * would provide the UI sources, for the host UI build.
+ */
+
+#include "portapack.hpp"
+#include "rtc_time.hpp"
+#include "event_m0.hpp"
+
+#include <array>
+
+namespace {
+
+/* portapack_hal.hpp's LCD bus pins; only the GPIO port and pad matter. */
+constexpr PinConfig pin_config { 0, 0, 0, 0, 1, 1 };
+
+constexpr GPIO gpio_io_stbx		{ { 2,  0, pin_config }, 5,  0, 4 };
+constexpr GPIO gpio_addr		{ { 2,  1, pin_config }, 5,  1, 4 };
+constexpr GPIO gpio_lcd_te		{ { 2,  3, pin_config }, 5,  3, 4 };
+constexpr GPIO gpio_lcd_rdx		{ { 2,  4, pin_config }, 5,  4, 4 };
+constexpr GPIO gpio_unused		{ { 2,  8, pin_config }, 5,  7, 4 };
+constexpr GPIO gpio_lcd_wrx		{ { 2,  9, pin_config }, 1, 10, 0 };
+constexpr GPIO gpio_dir			{ { 2, 13, pin_config }, 1, 13, 0 };
+
+std::array<MessageHandler, toUType(Message::ID::MAX)> message_handlers { };
+
+} /* namespace */
+
+namespace portapack {
+
+portapack::IO io {
+	gpio_dir,
+	gpio_lcd_rdx,
+	gpio_lcd_wrx,
+	gpio_io_stbx,
+	gpio_addr,
+	gpio_lcd_te,
+	gpio_unused,
+};
+
+lcd::ILI9341 display;
+
+} /* namespace portapack */
+
+namespace rtc_time {
+
+Signal<> signal_tick_second;
+
+} /* namespace rtc_time */
+
+RTCDriver RTCD1;
+
+MessageHandlerRegistration::MessageHandlerRegistration(
+	const Message::ID message_id,
+	MessageHandler&& callback
+) : message_id { message_id }
+{
+	message_handlers[toUType(message_id)] = std::move(callback);
+}
+
+MessageHandlerRegistration::~MessageHandlerRegistration() {
+	message_handlers[toUType(message_id)] = nullptr;
+}
+
+namespace host {
+
+void dispatch_message(Message* const message) {
+	auto& handler = message_handlers[toUType(message->id)];
+	if( handler ) {
+		handler(message);
+	}
+}
+
+} /* namespace host */
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "ili9341_model.hpp"
+
+#include "hal.h"
+
+#include <chrono>
+#include <cstdio>
+
+HostGPIO host_gpio { };
+HostSCU host_scu { };
+
+void host_pal_write(const ioportid_t port, const iopadid_t pad, const bool value) {
+	host::lcd_model.pad_write(port, pad, value);
+}
+
+bool host_pal_read(const ioportid_t port, const iopadid_t pad) {
+	return host::lcd_model.pad_read(port, pad);
+}
+
+halrtcnt_t host_counter_value() {
+	using namespace std::chrono;
+	return static_cast<halrtcnt_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+namespace host {
+
+ILI9341Model lcd_model;
+
+void ILI9341Model::pad_write(const uint32_t port, const uint32_t pad, const bool value) {
+	const bool was = pin(port, pad);
+	pins[port] = (pins[port] & ~(1U << pad)) | (static_cast<uint32_t>(value) << pad);
+
+	if( (port == port_wrx) && (pad == pad_wrx) && (was != value) ) {
+		const uint32_t byte = (host_gpio.MPIN[data_port] >> data_shift) & 0xff;
+		if( !value ) {
+			word_high = byte;
+		} else {
+			on_word(!pin(port_addr, pad_addr), (word_high << 8) | byte);
+		}
+	}
+
+	if( (port == port_rdx) && (pad == pad_rdx) && !value ) {
+		counters_.reads++;
+	}
+}
+
+bool ILI9341Model::pad_read(const uint32_t port, const uint32_t pad) const {
+	return pin(port, pad);
+}
+
+void ILI9341Model::begin_frame() {
+	counters_ = { };
+	frame++;
+}
+
+void ILI9341Model::on_word(const bool is_command, const uint16_t word) {
+	if( is_command ) {
+		on_command(word & 0xff);
+	} else {
+		on_data(word);
+	}
+}
+
+void ILI9341Model::on_command(const uint8_t new_command) {
+	command = new_command;
+	parameter = 0;
+	counters_.commands++;
+
+	if( command == 0x2c ) {
+		column = column_start;
+		page = page_start;
+		counters_.windows++;
+	}
+}
+
+void ILI9341Model::on_data(const uint16_t word) {
+	if( command == 0x2c ) {
+		on_pixel(word);
+		return;
+	}
+
+	if( parameter < parameters.size() ) {
+		parameters[parameter] = word & 0xff;
+	}
+	parameter++;
+
+	const auto u16 = [this](const size_t i) {
+		return static_cast<uint16_t>((parameters[i] << 8) | parameters[i + 1]);
+	};
+
+	switch(command) {
+	case 0x2a:	// CASET
+		if( parameter == 4 ) {
+			column_start = u16(0);
+			column_end = u16(2);
+		}
+		break;
+
+	case 0x2b:	// PASET
+		if( parameter == 4 ) {
+			page_start = u16(0);
+			page_end = u16(2);
+		}
+		break;
+
+	case 0x33:	// VSCRDEF
+		if( parameter == 6 ) {
+			top_fixed = u16(0);
+			scroll_height = u16(2);
+		}
+		break;
+
+	case 0x37:	// VSCRSADD
+		if( parameter == 2 ) {
+			scroll_start = u16(0);
+			counters_.scrolls++;
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void ILI9341Model::on_pixel(const uint16_t value) {
+	if( (column < width) && (page < height) ) {
+		const size_t i = page * width + column;
+		ram[i] = value;
+		if( written_frame[i] == frame ) {
+			counters_.overdrawn++;
+		}
+		written_frame[i] = frame;
+	}
+	counters_.pixels++;
+
+	if( column < column_end ) {
+		column++;
+	} else {
+		column = column_start;
+		page = (page < page_end) ? (page + 1) : page_start;
+	}
+}
+
+uint16_t ILI9341Model::screen(const size_t x, const size_t y) const {
+	// Lines in the scroll area show memory from scroll_start on, wrapping.
+	size_t line = y;
+	if( (y >= top_fixed) && (y < (size_t)top_fixed + scroll_height) && (scroll_start >= top_fixed) ) {
+		line = top_fixed + ((y - top_fixed) + (scroll_start - top_fixed)) % scroll_height;
+	}
+	return ram[line * width + x];
+}
+
+bool ILI9341Model::write_ppm(const std::string& path) const {
+	const auto f = std::fopen(path.c_str(), "wb");
+	if( !f ) {
+		return false;
+	}
+	std::fprintf(f, "P6\n%zu %zu\n255\n", width, height);
+	for(size_t y=0; y<height; y++) {
+		for(size_t x=0; x<width; x++) {
+			const auto v = screen(x, y);
+			const uint8_t rgb[3] {
+				static_cast<uint8_t>(((v >> 11) & 0x1f) * 255 / 31),
+				static_cast<uint8_t>(((v >> 5) & 0x3f) * 255 / 63),
+				static_cast<uint8_t>((v & 0x1f) * 255 / 31)
+			};
+			std::fwrite(rgb, 1, sizeof(rgb), f);
+		}
+	}
+	return std::fclose(f) == 0;
+}
+
+} /* namespace host */
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __ILI9341_MODEL_H__
+#define __ILI9341_MODEL_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <string>
+
+namespace host {
+
+/* The LCD at the far end of portapack::IO's bus, for the host UI build.
+ * Pin writes from the shim hal.h are decoded the way the CPLD and panel
+ * see them: the high byte of a word latched on WRX falling, the low on
+ * WRX rising, ADDR low for a command. Commands are followed far enough
+ * to count the traffic (RAMWR windows, pixels, scrolls) and keep a copy
+ * of the panel's memory, which screen() shows as the scroll puts it.
+ */
+class ILI9341Model {
+public:
+	static constexpr size_t width = 240;
+	static constexpr size_t height = 320;
+
+	struct Counters {
+		uint32_t commands;		// all of them, window sets included
+		uint32_t windows;		// RAMWR, a CASET/PASET/RAMWR each from the driver
+		uint32_t pixels;		// words written to RAM
+		uint32_t scrolls;		// VSCRSADD
+		uint32_t reads;			// words read back
+		uint32_t overdrawn;		// pixels written again in the same frame
+	};
+
+	void pad_write(const uint32_t port, const uint32_t pad, const bool value);
+	bool pad_read(const uint32_t port, const uint32_t pad) const;
+
+	const Counters& counters() const {
+		return counters_;
+	}
+
+	/* Starts a frame: counters to zero, and what's overdrawn from here. */
+	void begin_frame();
+
+	uint16_t screen(const size_t x, const size_t y) const;
+
+	/* Binary PPM of the screen, RGB565 widened. */
+	bool write_ppm(const std::string& path) const;
+
+private:
+	/* portapack_hal.hpp's pins */
+	static constexpr uint32_t port_addr = 5, pad_addr = 1;
+	static constexpr uint32_t port_rdx = 5, pad_rdx = 4;
+	static constexpr uint32_t port_wrx = 1, pad_wrx = 10;
+	static constexpr uint32_t data_port = 3, data_shift = 8;
+
+	std::array<uint32_t, 8> pins { };
+	uint32_t word_high { 0 };
+
+	uint8_t command { 0 };
+	size_t parameter { 0 };
+	std::array<uint8_t, 8> parameters { };
+
+	uint16_t column_start { 0 }, column_end { width - 1 };
+	uint16_t page_start { 0 }, page_end { height - 1 };
+	uint16_t column { 0 }, page { 0 };
+	uint16_t top_fixed { 0 }, scroll_height { height }, scroll_start { 0 };
+
+	std::array<uint16_t, width * height> ram { };
+	std::array<uint32_t, width * height> written_frame { };
+	uint32_t frame { 1 };
+
+	Counters counters_ { };
+
+	bool pin(const uint32_t port, const uint32_t pad) const {
+		return (pins[port] >> pad) & 1;
+	}
+
+	void on_word(const bool is_command, const uint16_t word);
+	void on_command(const uint8_t new_command);
+	void on_data(const uint16_t word);
+	void on_pixel(const uint16_t value);
+};
+
+extern ILI9341Model lcd_model;
+
+} /* namespace host */
+
+#endif/*__ILI9341_MODEL_H__*/
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* The baseband calls the UI sources make. No baseband runs on the host:
+ * the benchmark writes the spectrum FIFOs itself.
+ */
+
+#ifndef __HOST_BASEBAND_API_H__
+#define __HOST_BASEBAND_API_H__
+
+#include "message.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace baseband {
+
+inline void spectrum_streaming_start(const SpectrumStreamingConfigMessage::FFT = SpectrumStreamingConfigMessage::FFT::Float,
+					const SpectrumStreamingConfigMessage::Trace = SpectrumStreamingConfigMessage::Trace::Instant,
+					const uint32_t = 0,
+					const SpectrumStreamingConfigMessage::Colors = { 0, 0 },
+					const SpectrumStreamingConfigMessage::Delivery = SpectrumStreamingConfigMessage::Delivery::Latest,
+					const size_t = ChannelSpectrumConfigMessage::fifo_k) {
+}
+
+inline void spectrum_streaming_stop() {
+}
+
+} /* namespace baseband */
+
+#endif/*__HOST_BASEBAND_API_H__*/
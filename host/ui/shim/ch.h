@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Stands in for ChibiOS' ch.h in the host UI build: the types the UI
+ * headers name, and no-op timing. Everything runs on one thread.
+ */
+
+#ifndef __HOST_CH_H__
+#define __HOST_CH_H__
+
+#include "hal.h"
+
+#include <cstdint>
+
+using systime_t = uint32_t;
+using eventmask_t = uint32_t;
+using tprio_t = uint32_t;
+
+struct Thread;
+struct Semaphore;
+struct Mutex;
+
+#define ALL_EVENTS ((eventmask_t)-1)
+#define EVENT_MASK(eid) ((eventmask_t)(1 << (eid)))
+#define NORMALPRIO 64
+#define CH_FREQUENCY 1000
+#define MS2ST(msec) ((systime_t)(msec))
+
+inline systime_t chTimeNow() { return host_counter_value() / 1000000U; }
+inline void chThdSleepMilliseconds(const uint32_t) { }
+inline void chThdSleep(const systime_t) { }
+inline void chSysLock() { }
+inline void chSysUnlock() { }
+
+#endif/*__HOST_CH_H__*/
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* The application's event_m0.hpp, less the dispatcher: handlers register
+ * in a table here, and the benchmark delivers messages with
+ * host::dispatch_message() where the event loop would.
+ */
+
+#ifndef __HOST_EVENT_M0_H__
+#define __HOST_EVENT_M0_H__
+
+#include "ui_widget.hpp"
+#include "ui_painter.hpp"
+
+#include "message.hpp"
+
+#include "ch.h"
+
+#include <functional>
+
+constexpr auto EVT_MASK_RTC_TICK        = EVENT_MASK(0);
+constexpr auto EVT_MASK_LCD_FRAME_SYNC  = EVENT_MASK(1);
+constexpr auto EVT_MASK_USB_SERIAL      = EVENT_MASK(2);
+constexpr auto EVT_MASK_SWITCHES		= EVENT_MASK(3);
+constexpr auto EVT_MASK_ENCODER			= EVENT_MASK(4);
+constexpr auto EVT_MASK_TOUCH			= EVENT_MASK(5);
+constexpr auto EVT_MASK_APPLICATION     = EVENT_MASK(6);
+constexpr auto EVT_MASK_LOCAL           = EVENT_MASK(7);
+
+/* The target's is held in place; nothing here counts its cost. */
+class MessageHandler : public std::function<void(Message* const)> {
+public:
+	using std::function<void(Message* const)>::function;
+
+	template<typename T, void (T::*Method)(const Message* const)>
+	static MessageHandler bind(T* const object) {
+		return [object](Message* const p) { (object->*Method)(p); };
+	}
+
+	template<typename M, typename T, void (T::*Method)(const M&)>
+	static MessageHandler bind(T* const object) {
+		return [object](Message* const p) { (object->*Method)(*static_cast<const M*>(p)); };
+	}
+};
+
+class MessageHandlerRegistration {
+public:
+	MessageHandlerRegistration(
+		const Message::ID message_id,
+		MessageHandler&& callback
+	);
+
+	~MessageHandlerRegistration();
+
+private:
+	const Message::ID message_id;
+};
+
+namespace host {
+
+/* To the handler registered for the message's ID, if any. */
+void dispatch_message(Message* const message);
+
+} /* namespace host */
+
+#endif/*__HOST_EVENT_M0_H__*/
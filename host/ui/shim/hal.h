@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Stands in for ChibiOS' hal.h when building the application's UI on a
+ * workstation. The GPIO the PortaPack LCD bus is bit-banged on goes to
+ * the panel model (ili9341_model.hpp) instead of registers, so the real
+ * portapack::IO and lcd::ILI9341 code runs unchanged; the cycle counter
+ * is the host's steady clock.
+ */
+
+#ifndef __HOST_HAL_H__
+#define __HOST_HAL_H__
+
+#include <cstdint>
+
+#define HAL_USE_RTC TRUE
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+using ioportid_t = uint32_t;
+using iopadid_t = uint32_t;
+using ioportmask_t = uint32_t;
+using halrtcnt_t = uint32_t;
+
+#define PAL_MODE_INPUT 1
+#define PAL_MODE_OUTPUT_PUSHPULL 6
+
+/* ili9341_model.cpp */
+void host_pal_write(const ioportid_t port, const iopadid_t pad, const bool value);
+bool host_pal_read(const ioportid_t port, const iopadid_t pad);
+halrtcnt_t host_counter_value();
+
+#define palSetPad(port, pad) host_pal_write((port), (pad), true)
+#define palClearPad(port, pad) host_pal_write((port), (pad), false)
+#define palWritePad(port, pad, value) host_pal_write((port), (pad), (value))
+#define palTogglePad(port, pad) host_pal_write((port), (pad), !host_pal_read((port), (pad)))
+#define palReadPad(port, pad) host_pal_read((port), (pad))
+#define palSetPadMode(port, pad, mode) do { (void)(port); (void)(pad); (void)(mode); } while(0)
+
+struct HostGPIO {
+	uint32_t MASK[8];
+	uint32_t PIN[8];
+	uint32_t MPIN[8];
+	uint32_t SET[8];
+	uint32_t CLR[8];
+	uint32_t NOT[8];
+	uint32_t DIR[8];
+};
+
+struct HostSCU {
+	uint32_t SFSP[16][32];
+};
+
+extern HostGPIO host_gpio;
+extern HostSCU host_scu;
+
+#define LPC_GPIO (&host_gpio)
+#define LPC_SCU (&host_scu)
+
+inline void halPolledDelay(const uint32_t) { }
+
+/* Regions memory_map.hpp names; never dereferenced here. */
+#define LPC_BACKUP_REG_BASE 0x40041000
+#define LPC_SPIFI_DATA_BASE 0x14000000
+#define LPC_SPIFI_DATA_CACHED_BASE 0x80000000
+
+#define __DMB() __sync_synchronize()
+
+#define halGetCounterValue() host_counter_value()
+#define halGetCounterFrequency() 1000000000U
+
+#endif/*__HOST_HAL_H__*/
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* The part of the application's portapack.hpp the UI uses: the display
+ * and the bus it's on, both driven by the host panel model.
+ */
+
+#ifndef __HOST_PORTAPACK_H__
+#define __HOST_PORTAPACK_H__
+
+#include "portapack_io.hpp"
+#include "lcd_ili9341.hpp"
+#include "radio.hpp"
+
+// As portapack_hal.hpp does on the target.
+#include "lpc43xx_cpp.hpp"
+using namespace lpc43xx;
+
+namespace portapack {
+
+extern portapack::IO io;
+
+extern lcd::ILI9341 display;
+
+} /* namespace portapack */
+
+#endif/*__HOST_PORTAPACK_H__*/
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* The application's rtc_time.hpp, and the RTC the clock widgets read:
+ * fixed at the host UI build's epoch, so benchmark output doesn't change
+ * from run to run. The scripts tick the second signal themselves.
+ */
+
+#ifndef __HOST_RTC_TIME_H__
+#define __HOST_RTC_TIME_H__
+
+#include "signal.hpp"
+#include "lpc43xx_cpp.hpp"
+
+namespace rtc_time {
+
+extern Signal<> signal_tick_second;
+
+} /* namespace rtc_time */
+
+struct RTCDriver { };
+extern RTCDriver RTCD1;
+
+inline void rtcGetTime(RTCDriver* const, lpc43xx::rtc::RTC* const datetime) {
+	*datetime = { 2016, 1, 1, 12, 0, 0 };
+}
+
+#endif/*__HOST_RTC_TIME_H__*/
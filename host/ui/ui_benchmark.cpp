@@ -0,0 +1,517 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Paint cost of the application's views, as an LCD bus sees it: pixels
+ * and windows written per frame, and pixels written twice in a frame
+ * (over-painting), from the panel model behind the real display driver.
+ * Counts don't depend on the host's speed, so CI can diff the output.
+ *
+ *   ui_benchmark [-v] [script]
+ *
+ * A script is one command per line, "#" starts a comment:
+ *
+ *   scene <menu|table|waterfall>   starts a view, reporting the last one
+ *   key <up|down|left|right|select>
+ *   encoder <steps>
+ *   tick                           the RTC's second
+ *   frames <n>                     n display frames, feeding the view
+ *   ppm <file>                     the screen as the panel shows it
+ *
+ * Key and encoder events bubble from the focused widget, as on the
+ * device. A frame is the event loop's DisplayFrameSync handling: the
+ * message, then a repaint of whatever is dirty, without a paint budget.
+ * -v prints a line per frame as well.
+ */
+
+#include "ili9341_model.hpp"
+
+#include "portapack.hpp"
+#include "rtc_time.hpp"
+#include "event_m0.hpp"
+
+#include "ui_widget.hpp"
+#include "ui_painter.hpp"
+#include "ui_menu.hpp"
+#include "ui_spectrum.hpp"
+#include "recent_entries.hpp"
+#include "string_format.hpp"
+#include "bitmap.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace ui;
+
+/* An ADS-B receiver's table, less the aircraft: an address, a callsign
+ * and a hit count per row, drawn as ADSBRxView's rows are.
+ */
+struct BenchmarkEntry {
+	using Key = uint32_t;
+
+	static constexpr Key invalid_key = 0xffffffff;
+
+	uint32_t address;
+	uint32_t hits { 0 };
+
+	BenchmarkEntry(const Key key) : address { key } { }
+
+	Key key() const {
+		return address;
+	}
+};
+
+using BenchmarkEntries = RecentEntries<BenchmarkEntry, 64, HashIndex<BenchmarkEntry::Key, 128>>;
+
+namespace ui {
+
+template<>
+void RecentEntriesTable<BenchmarkEntries>::draw(
+	const Entry& entry,
+	const Rect& target_rect,
+	Painter& painter,
+	const Style& style
+) {
+	FixedString<48> entry_string;
+	entry_string += '\x1B';
+	entry_string += static_cast<char>(0x10);
+	entry_string.extend(to_string_hex(entry_string.end(), entry_string.available(), entry.address, 6));
+	entry_string += " BENCH";
+	entry_string.extend(to_string_dec_uint(entry_string.end(), entry_string.available(), entry.address & 0xff, 3));
+	entry_string += "   ";
+	entry_string.extend(to_string_dec_uint(entry_string.end(), entry_string.available(), entry.hits, 4));
+	entry_string.resize(2 + target_rect.width() / style.font.char_width(), ' ');
+
+	painter.draw_string(
+		target_rect.location(),
+		style,
+		entry_string.c_str(),
+		entry_string.size()
+	);
+}
+
+} /* namespace ui */
+
+namespace {
+
+constexpr Style style_default {
+	.font = font::fixed_8x16,
+	.background = Color::black(),
+	.foreground = Color::white(),
+};
+
+/* Below the system status bar, as the navigation view places apps. */
+constexpr Rect app_rect { 0, 16, 240, 304 };
+
+class Scene : public View {
+public:
+	/* What arrives from the baseband in a frame, sent before it's painted. */
+	virtual void on_frame(const uint32_t frame) {
+		(void)frame;
+	}
+};
+
+class MenuScene : public Scene {
+public:
+	MenuScene() {
+		add_children({ &menu_view });
+		menu_view.add_items({
+			{ "ADS-B",        Color::green(),  &bitmap_icon_adsb, nullptr },
+			{ "ACARS",        Color::yellow(), &bitmap_icon_adsb, nullptr },
+			{ "AIS Boats",    Color::green(),  &bitmap_icon_ais,  nullptr },
+			{ "AFSK",         Color::yellow(), &bitmap_icon_codetx, nullptr },
+			{ "Audio",        Color::green(),  &bitmap_icon_speaker, nullptr },
+			{ "ERT Meter",    Color::green(),  &bitmap_icon_ert,  nullptr },
+			{ "POCSAG",       Color::green(),  &bitmap_icon_pocsag, nullptr },
+			{ "Radiosondes",  Color::yellow(), &bitmap_icon_sonde, nullptr },
+			{ "TPMS Cars",    Color::green(),  &bitmap_icon_tpms, nullptr },
+			{ "APRS",         Color::grey(),   &bitmap_icon_aprs, nullptr },
+			{ "Analog TV",    Color::grey(),   &bitmap_icon_sstv, nullptr },
+			{ "LoRa",         Color::grey(),   &bitmap_icon_lora, nullptr },
+			{ "SSTV",         Color::grey(),   &bitmap_icon_sstv, nullptr },
+			{ "Weather Sat",  Color::grey(),   &bitmap_icon_sstv, nullptr },
+		});
+	}
+
+	void set_parent_rect(const Rect new_parent_rect) override {
+		View::set_parent_rect(new_parent_rect);
+		menu_view.set_parent_rect({ { 0, 0 }, new_parent_rect.size() });
+	}
+
+	void focus() override {
+		menu_view.focus();
+	}
+
+private:
+	MenuView menu_view { };
+};
+
+/* 24 aircraft, one packet every other frame from one picked at random,
+ * as a busy ADS-B receiver's table sees them.
+ */
+class TableScene : public Scene {
+public:
+	TableScene() {
+		add_children({ &recent_entries_view });
+		// Straight to the table, as keys from ADSBRxView's fields would go.
+		recent_entries_view.set_focusable(true);
+	}
+
+	void set_parent_rect(const Rect new_parent_rect) override {
+		View::set_parent_rect(new_parent_rect);
+		recent_entries_view.set_parent_rect({ { 0, 0 }, new_parent_rect.size() });
+	}
+
+	void focus() override {
+		recent_entries_view.focus();
+	}
+
+	void on_frame(const uint32_t frame) override {
+		if( frame & 1 ) {
+			return;
+		}
+		random = random * 1664525 + 1013904223;
+		const uint32_t address = 0x3c0000 + ((random >> 16) % 24);
+		auto& entry = ::on_packet(recent, address);
+		entry.hits++;
+		recent_entries_view.update();
+	}
+
+private:
+	const RecentEntriesColumns columns { {
+		{ "ICAO", 6 },
+		{ "Callsign", 9 },
+		{ "Hits", 4 },
+	} };
+	BenchmarkEntries recent { };
+	RecentEntriesView<BenchmarkEntries> recent_entries_view { columns, recent };
+	uint32_t random { 1 };
+};
+
+/* A row a frame, a tone drifting across the spectrum over noise. */
+class WaterfallScene : public Scene {
+public:
+	WaterfallScene() {
+		add_children({ &waterfall });
+		ChannelSpectrumConfigMessage message { &fifo };
+		host::dispatch_message(&message);
+	}
+
+	void set_parent_rect(const Rect new_parent_rect) override {
+		View::set_parent_rect(new_parent_rect);
+		waterfall.set_parent_rect({ { 0, 0 }, new_parent_rect.size() });
+	}
+
+	void on_frame(const uint32_t frame) override {
+		ChannelSpectrum spectrum;
+		spectrum.sampling_rate = 3072000;
+		spectrum.channel_filter_pass_frequency = 100000;
+		spectrum.channel_filter_stop_frequency = 150000;
+		for(auto& db : spectrum.db) {
+			random = random * 1664525 + 1013904223;
+			db = 40 + (random >> 28);
+		}
+		const size_t peak = (frame * 3) & 0xff;
+		spectrum.db[peak] = 200;
+		spectrum.db[(peak + 1) & 0xff] = 160;
+		fifo.in(spectrum);
+	}
+
+private:
+	std::array<ChannelSpectrum, 1U << ChannelSpectrumConfigMessage::fifo_k> fifo_data { };
+	ChannelSpectrumFIFO fifo { fifo_data.data(), ChannelSpectrumConfigMessage::fifo_k };
+
+	spectrum::WaterfallWidget waterfall { };
+	uint32_t random { 1 };
+};
+
+class BenchmarkView : public View {
+public:
+	BenchmarkView(Context& context) : View { { 0, 0, 240, 320 } }, context_ { context } {
+		set_style(&style_default);
+	}
+
+	Context& context() const override {
+		return context_;
+	}
+
+	void set_scene(std::unique_ptr<Scene> new_scene) {
+		if( scene ) {
+			context_.focus_manager().set_focus_widget(nullptr);
+			remove_child(scene.get());
+		}
+		scene = std::move(new_scene);
+		if( scene ) {
+			add_child(scene.get());
+			scene->set_parent_rect(app_rect);
+			scene->focus();
+		}
+		set_dirty();
+	}
+
+	Scene* current_scene() const {
+		return scene.get();
+	}
+
+	void paint(Painter& painter) override {
+		painter.fill_rectangle(screen_rect(), style().background);
+	}
+
+private:
+	Context& context_;
+	std::unique_ptr<Scene> scene { };
+};
+
+std::unique_ptr<Scene> make_scene(const std::string& name) {
+	if( name == "menu" ) {
+		return std::make_unique<MenuScene>();
+	}
+	if( name == "table" ) {
+		return std::make_unique<TableScene>();
+	}
+	if( name == "waterfall" ) {
+		return std::make_unique<WaterfallScene>();
+	}
+	return nullptr;
+}
+
+/* Per scene. The first frame paints the whole view; the rest, what the
+ * scene's input and data changed.
+ */
+struct SceneStatistics {
+	std::string name { };
+	uint32_t frames { 0 };
+	uint32_t painted { 0 };
+	host::ILI9341Model::Counters first { };
+	host::ILI9341Model::Counters total { };
+	host::ILI9341Model::Counters max { };
+
+	void add(const host::ILI9341Model::Counters& c) {
+		if( frames == 0 ) {
+			first = c;
+		} else {
+			total.commands += c.commands;
+			total.windows += c.windows;
+			total.pixels += c.pixels;
+			total.scrolls += c.scrolls;
+			total.reads += c.reads;
+			total.overdrawn += c.overdrawn;
+			max.pixels = std::max(max.pixels, c.pixels);
+			max.windows = std::max(max.windows, c.windows);
+			max.overdrawn = std::max(max.overdrawn, c.overdrawn);
+		}
+		if( c.commands ) {
+			painted++;
+		}
+		frames++;
+	}
+};
+
+void print_header() {
+	std::printf("%-10s %6s %7s | %8s %6s %7s | %8s %8s %6s %6s %8s %8s\n",
+		"scene", "frames", "painted",
+		"first px", "win", "ovr",
+		"px/frame", "px max", "win", "cmd", "ovr", "ovr max"
+	);
+}
+
+void print_statistics(const SceneStatistics& s) {
+	if( s.name.empty() ) {
+		return;
+	}
+	const uint32_t n = (s.frames > 1) ? (s.frames - 1) : 1;
+	std::printf("%-10s %6u %7u | %8u %6u %7u | %8u %8u %6u %6u %8u %8u\n",
+		s.name.c_str(), s.frames, s.painted,
+		s.first.pixels, s.first.windows, s.first.overdrawn,
+		s.total.pixels / n, s.max.pixels, s.total.windows / n, s.total.commands / n,
+		s.total.overdrawn / n, s.max.overdrawn
+	);
+}
+
+const char* const default_script =
+	"scene menu\n"
+	"frames 1\n"
+	"key down\nframes 1\n"
+	"key down\nframes 1\n"
+	"encoder 3\nframes 1\n"
+	"encoder 12\nframes 1\n"
+	"key up\nframes 1\n"
+	"scene table\n"
+	"frames 120\n"
+	"encoder 1\nframes 30\n"
+	"tick\nframes 30\n"
+	"scene waterfall\n"
+	"frames 120\n";
+
+class Benchmark {
+public:
+	explicit Benchmark(const bool verbose) : verbose { verbose } { }
+
+	bool run(std::istream& script) {
+		// As portapack::init() leaves the LCD.
+		portapack::display.init();
+		print_header();
+
+		std::string line;
+		size_t line_number = 0;
+		while( std::getline(script, line) ) {
+			line_number++;
+			line = line.substr(0, line.find('#'));
+			std::istringstream words { line };
+			std::string command;
+			if( !(words >> command) ) {
+				continue;
+			}
+			std::string arg;
+			words >> arg;
+			if( !execute(command, arg) ) {
+				std::fprintf(stderr, "line %zu: bad command \"%s\"\n", line_number, line.c_str());
+				return false;
+			}
+		}
+
+		print_statistics(statistics);
+		top.set_scene(nullptr);
+		return true;
+	}
+
+private:
+	const bool verbose;
+	Context context { };
+	BenchmarkView top { context };
+	Painter painter { };
+	SceneStatistics statistics { };
+	uint32_t frame { 0 };
+
+	bool execute(const std::string& command, const std::string& arg) {
+		if( command == "scene" ) {
+			auto scene = make_scene(arg);
+			if( !scene ) {
+				return false;
+			}
+			print_statistics(statistics);
+			statistics = { };
+			statistics.name = arg;
+			top.set_scene(std::move(scene));
+			return true;
+		}
+		if( !top.current_scene() ) {
+			return false;
+		}
+		if( command == "key" ) {
+			static const std::array<const char*, 5> names { { "right", "left", "down", "up", "select" } };
+			for(size_t i=0; i<names.size(); i++) {
+				if( arg == names[i] ) {
+					bubble_key(static_cast<KeyEvent>(i));
+					return true;
+				}
+			}
+			return false;
+		}
+		if( command == "encoder" ) {
+			bubble_encoder(std::atoi(arg.c_str()));
+			return true;
+		}
+		if( command == "tick" ) {
+			rtc_time::signal_tick_second.emit();
+			return true;
+		}
+		if( command == "frames" ) {
+			const int n = std::atoi(arg.c_str());
+			for(int i=0; i<n; i++) {
+				run_frame();
+			}
+			return n > 0;
+		}
+		if( command == "ppm" ) {
+			return !arg.empty() && host::lcd_model.write_ppm(arg);
+		}
+		return false;
+	}
+
+	void bubble_key(const KeyEvent event) {
+		auto target = context.focus_manager().focus_widget();
+		while( (target != nullptr) && !target->on_key(event) ) {
+			target = target->parent();
+		}
+	}
+
+	void bubble_encoder(const EncoderEvent event) {
+		auto target = context.focus_manager().focus_widget();
+		while( (target != nullptr) && !target->on_encoder(event) ) {
+			target = target->parent();
+		}
+	}
+
+	void run_frame() {
+		top.current_scene()->on_frame(frame);
+
+		host::lcd_model.begin_frame();
+		DisplayFrameSyncMessage message;
+		host::dispatch_message(&message);
+		// No budget: draws all there is to draw, as a long frame would.
+		painter.paint_widget_tree(&top, halGetCounterValue() + halGetCounterFrequency());
+
+		const auto& counters = host::lcd_model.counters();
+		statistics.add(counters);
+		if( verbose ) {
+			std::printf("  %-8s %6u px %6u win %6u cmd %6u ovr %3u scroll\n",
+				statistics.name.c_str(), counters.pixels, counters.windows,
+				counters.commands, counters.overdrawn, counters.scrolls);
+		}
+		frame++;
+	}
+};
+
+} /* namespace */
+
+int main(int argc, char* argv[]) {
+	bool verbose = false;
+	const char* path = nullptr;
+	for(int i=1; i<argc; i++) {
+		if( std::strcmp(argv[i], "-v") == 0 ) {
+			verbose = true;
+		} else {
+			path = argv[i];
+		}
+	}
+
+	static Benchmark benchmark { verbose };
+
+	if( path ) {
+		std::ifstream script { path };
+		if( !script ) {
+			std::fprintf(stderr, "%s: can't open\n", path);
+			return 1;
+		}
+		return benchmark.run(script) ? 0 : 1;
+	}
+
+	std::istringstream script { default_script };
+	return benchmark.run(script) ? 0 : 1;
+}